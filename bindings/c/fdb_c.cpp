@@ -302,6 +302,53 @@ fdb_error_t fdb_future_get_keyvalue_array_v13(FDBFuture* f, FDBKeyValue const**
 	                 *out_count = rrr.size(););
 }
 
+// Packs a range result as [int32 count][int32 more], then [int32 key length][int32 value length][key][value] per pair,
+// in native byte order. Only the pairs that fit in the buffer are packed, in which case more is set.
+static int packKeyValues(RangeResultRef const& rrr,
+                         uint8_t* buffer,
+                         int buffer_length,
+                         int* out_count,
+                         fdb_bool_t* out_more) {
+	const int headerLength = 2 * sizeof(int32_t);
+	if (buffer_length < headerLength) {
+		throw client_invalid_operation();
+	}
+	int32_t count = 0;
+	int32_t more = rrr.more;
+	int offset = headerLength;
+	for (; count < rrr.size(); ++count) {
+		const KeyValueRef& kv = rrr[count];
+		const int32_t keyLength = kv.key.size();
+		const int32_t valueLength = kv.value.size();
+		if (buffer_length - offset < headerLength + keyLength + valueLength) {
+			more = true;
+			break;
+		}
+		memcpy(buffer + offset, &keyLength, sizeof(int32_t));
+		memcpy(buffer + offset + sizeof(int32_t), &valueLength, sizeof(int32_t));
+		offset += headerLength;
+		memcpy(buffer + offset, kv.key.begin(), keyLength);
+		offset += keyLength;
+		memcpy(buffer + offset, kv.value.begin(), valueLength);
+		offset += valueLength;
+	}
+	memcpy(buffer, &count, sizeof(int32_t));
+	memcpy(buffer + sizeof(int32_t), &more, sizeof(int32_t));
+	*out_count = count;
+	*out_more = more;
+	return offset;
+}
+
+extern "C" DLLEXPORT fdb_error_t fdb_future_get_keyvalue_array_packed(FDBFuture* f,
+                                                                      uint8_t* buffer,
+                                                                      int buffer_length,
+                                                                      int* out_count,
+                                                                      fdb_bool_t* out_more,
+                                                                      int* out_packed_length) {
+	CATCH_AND_RETURN(Standalone<RangeResultRef> rrr = TSAV(Standalone<RangeResultRef>, f)->get();
+	                 *out_packed_length = packKeyValues(rrr, buffer, buffer_length, out_count, out_more););
+}
+
 extern "C" DLLEXPORT fdb_error_t fdb_future_get_mappedkeyvalue_array(FDBFuture* f,
                                                                      FDBMappedKeyValue const** out_kvm,
                                                                      int* out_count,
@@ -949,6 +996,55 @@ FDBFuture* fdb_transaction_get_v13(FDBTransaction* tr, uint8_t const* key_name,
 	return fdb_transaction_get_impl(tr, key_name, key_name_length, 0);
 }
 
+namespace {
+// The gets of one fdb_transaction_get_values call. All of them are issued before any is waited on; the results are
+// then collected in key order, one callback per get that was not already ready.
+struct GetValuesState : ThreadSafeReferenceCounted<GetValuesState> {
+	std::vector<ThreadFuture<Optional<Value>>> gets;
+	RangeResult result;
+	VectorRef<KeyRef> keys;
+};
+
+ThreadFuture<RangeResult> collectValues(Reference<GetValuesState> state, int index) {
+	// Ready values are collected inline, so that a batch of cached reads does not recurse once per key
+	const int count = state->gets.size();
+	for (; index < count && state->gets[index].isReady() && !state->gets[index].isError(); ++index) {
+		Optional<Value> const& value = state->gets[index].get();
+		if (value.present()) {
+			state->result.push_back_deep(state->result.arena(), KeyValueRef(state->keys[index], value.get()));
+		}
+	}
+	if (index == count) {
+		state->gets.clear();
+		return state->result;
+	}
+	return flatMapThreadFuture<Optional<Value>, RangeResult>(
+	    state->gets[index], [state, index](ErrorOr<Optional<Value>> value) -> ErrorOr<ThreadFuture<RangeResult>> {
+		    if (value.isError()) {
+			    return value.getError();
+		    }
+		    if (value.get().present()) {
+			    state->result.push_back_deep(state->result.arena(), KeyValueRef(state->keys[index], value.get().get()));
+		    }
+		    return collectValues(state, index + 1);
+	    });
+}
+} // namespace
+
+extern "C" DLLEXPORT FDBFuture* fdb_transaction_get_values(FDBTransaction* tr,
+                                                           FDBKey const* keys,
+                                                           int key_count,
+                                                           fdb_bool_t snapshot) {
+	Reference<GetValuesState> state = makeReference<GetValuesState>();
+	state->gets.reserve(key_count);
+	for (int i = 0; i < key_count; ++i) {
+		KeyRef key(keys[i].key, keys[i].key_length);
+		state->keys.push_back_deep(state->result.arena(), key);
+		state->gets.push_back(TXN(tr)->get(key, snapshot));
+	}
+	return (FDBFuture*)(collectValues(state, 0).extractPtr());
+}
+
 FDBFuture* fdb_transaction_get_key_impl(FDBTransaction* tr,
                                         uint8_t const* key_name,
                                         int key_name_length,
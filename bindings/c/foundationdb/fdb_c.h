@@ -321,6 +321,16 @@ DLLEXPORT WARN_UNUSED_RESULT fdb_error_t fdb_future_get_keyvalue_array(FDBFuture
                                                                        fdb_bool_t* out_more);
 #endif
 
+/* Copies a key-value array into buffer as one contiguous block that can be wrapped without further copies:
+   [int32 count][int32 more] followed by [int32 key length][int32 value length][key][value] for each pair, in native
+   byte order. If not every pair fits, the pairs that fit are packed and more is set. */
+DLLEXPORT WARN_UNUSED_RESULT fdb_error_t fdb_future_get_keyvalue_array_packed(FDBFuture* f,
+                                                                              uint8_t* buffer,
+                                                                              int buffer_length,
+                                                                              int* out_count,
+                                                                              fdb_bool_t* out_more,
+                                                                              int* out_packed_length);
+
 DLLEXPORT WARN_UNUSED_RESULT fdb_error_t fdb_future_get_mappedkeyvalue_array(FDBFuture* f,
                                                                              FDBMappedKeyValue const** out_kv,
                                                                              int* out_count,
@@ -546,6 +556,13 @@ DLLEXPORT WARN_UNUSED_RESULT FDBFuture* fdb_transaction_get(FDBTransaction* tr,
                                                             fdb_bool_t snapshot);
 #endif
 
+/* Reads a batch of keys with one future, whose result is read with fdb_future_get_keyvalue_array (or
+   fdb_future_get_keyvalue_array_packed) and holds the keys that are present, in the order they were given. */
+DLLEXPORT WARN_UNUSED_RESULT FDBFuture* fdb_transaction_get_values(FDBTransaction* tr,
+                                                                   FDBKey const* keys,
+                                                                   int key_count,
+                                                                   fdb_bool_t snapshot);
+
 #if FDB_API_VERSION >= 14
 DLLEXPORT WARN_UNUSED_RESULT FDBFuture* fdb_transaction_get_key(FDBTransaction* tr,
                                                                 uint8_t const* key_name,
@@ -561,6 +561,18 @@ public:
 		return VarTraits::extract(f.get(), out);
 	}
 
+	// Copies a key-value array result into one contiguous buffer; see fdb_future_get_keyvalue_array_packed()
+	Error getPackedKeyValueArrayNothrow(uint8_t* buffer, int length, int& count, bool& more, int& packedLength) const
+	    noexcept {
+		assert(valid());
+		assert(!error());
+		auto out_more_native = native::fdb_bool_t{};
+		auto err = native::fdb_future_get_keyvalue_array_packed(
+		    f.get(), buffer, length, &count, &out_more_native, &packedLength);
+		more = (out_more_native != 0);
+		return Error(err);
+	}
+
 	template <class UserFunc>
 	void then(UserFunc&& fn) {
 		then<Future>(std::forward<UserFunc>(fn));
@@ -712,6 +724,17 @@ public:
 		return native::fdb_transaction_get(tr.get(), key.data(), intSize(key), snapshot);
 	}
 
+	// gets the values of a batch of keys with one future, holding the pairs of the keys that are present
+	TypedFuture<future_var::KeyValueRefArray> getValues(std::vector<KeyRef> const& keys, bool snapshot) {
+		auto native_keys = std::vector<native::FDBKey>{};
+		native_keys.reserve(keys.size());
+		for (auto const& key : keys) {
+			native_keys.push_back(native::FDBKey{ key.data(), intSize(key) });
+		}
+		return native::fdb_transaction_get_values(
+		    tr.get(), native_keys.data(), static_cast<int>(native_keys.size()), snapshot);
+	}
+
 	// Usage: tx.getRange(key_select::firstGreaterOrEqual(firstKey), key_select::lastLessThan(lastKey), ...)
 	// gets key-value pairs in key range [begin, end)
 	TypedFuture<future_var::KeyValueRefArray> getRange(KeySelector first,
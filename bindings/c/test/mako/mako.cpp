@@ -311,7 +311,8 @@ int runOneTransaction(Transaction& tx,
                       WorkflowStatistics& stats,
                       ByteString& key1,
                       ByteString& key2,
-                      ByteString& val) {
+                      ByteString& val,
+                      std::optional<timepoint_t> const& intended_start) {
 	const auto do_sample = (stats.getOpCount(OP_TRANSACTION) % args.sampling) == 0;
 	auto watch_tx = Stopwatch(StartAtCtor{});
 	auto watch_op = Stopwatch{};
@@ -406,6 +407,10 @@ transaction_begin:
 	}
 	// one transaction has completed successfully
 	if (do_sample) {
+		// in open loop, from when the transaction was meant to start, so time spent queued behind earlier
+		// transactions of the thread counts against it
+		if (intended_start)
+			watch_tx = Stopwatch(*intended_start);
 		const auto tx_duration = watch_tx.stop().diff();
 		stats.addLatency(OP_TRANSACTION, tx_duration);
 	}
@@ -413,6 +418,14 @@ transaction_begin:
 	return 0;
 }
 
+/* time until the next arrival of an open loop workload at rate arrivals per second */
+timediff_t nextArrivalInterval(int arrival, double rate) {
+	auto seconds = 1.0 / rate;
+	if (arrival == ARRIVAL_POISSON)
+		seconds = -std::log(1.0 - urand01()) / rate;
+	return std::chrono::duration_cast<timediff_t>(std::chrono::duration<double>(seconds));
+}
+
 int runWorkload(Database db,
                 Arguments const& args,
                 int const thread_tps,
@@ -453,9 +466,26 @@ int runWorkload(Database db,
 
 	std::optional<std::vector<fdb::Tenant>> tenants = args.prepareTenants(db);
 
+	auto next_arrival = steady_clock::now();
+
 	/* main transaction loop */
 	while (1) {
-		if ((thread_tps > 0 /* iff throttling on */) && (xacts >= current_tps)) {
+		auto intended_start = std::optional<timepoint_t>{};
+		if (args.arrival != ARRIVAL_CLOSED) {
+			/* open loop: start transactions as they arrive, catching up without pause if the thread fell behind */
+			const auto rate = thread_tps * throttle_factor.load();
+			current_tps = static_cast<int>(std::ceil(rate));
+			if (rate > 0) {
+				next_arrival += nextArrivalInterval(args.arrival, rate);
+				const auto time_now = steady_clock::now();
+				if (next_arrival > time_now)
+					usleep(toIntegerMicroseconds(next_arrival - time_now));
+				intended_start = next_arrival;
+			} else {
+				usleep(1000);
+				next_arrival = steady_clock::now();
+			}
+		} else if ((thread_tps > 0 /* iff throttling on */) && (xacts >= current_tps)) {
 			/* throttle on */
 			auto time_now = steady_clock::now();
 			while (toDoubleSeconds(time_now - time_prev) < 1.0) {
@@ -509,7 +539,7 @@ int runWorkload(Database db,
 				}
 			}
 
-			rc = runOneTransaction(tx, token, args, workflow_stats, key1, key2, val);
+			rc = runOneTransaction(tx, token, args, workflow_stats, key1, key2, val, intended_start);
 			if (rc) {
 				logr.warn("runOneTransaction failed ({})", rc);
 			}
@@ -849,6 +879,7 @@ Arguments::Arguments() {
 	tpsmin = -1;
 	tpsinterval = 10;
 	tpschange = TPS_SIN;
+	arrival = ARRIVAL_CLOSED;
 	sampling = 1000;
 	key_length = 32;
 	value_length = 16;
@@ -1022,6 +1053,14 @@ int parseTransaction(Arguments& args, char const* optarg) {
 		if (strncmp(ptr, "grv", 3) == 0) {
 			op = OP_GETREADVERSION;
 			ptr += 3;
+		} else if (strncmp(ptr, "grp", 3) == 0) {
+			op = OP_GETRANGEPACKED;
+			rangeop = 1;
+			ptr += 3;
+		} else if (strncmp(ptr, "gb", 2) == 0) {
+			op = OP_GETBATCH;
+			rangeop = 1;
+			ptr += 2;
 		} else if (strncmp(ptr, "gr", 2) == 0) {
 			op = OP_GETRANGE;
 			rangeop = 1;
@@ -1156,7 +1195,10 @@ void usage() {
 	printf("%-24s %s\n", "    --tps|--tpsmax=TPS", "Specify the target max TPS");
 	printf("%-24s %s\n", "    --tpsmin=TPS", "Specify the target min TPS");
 	printf("%-24s %s\n", "    --tpsinterval=SEC", "Specify the TPS change interval (Default: 10 seconds)");
-	printf("%-24s %s\n", "    --tpschange=<sin|square|pulse>", "Specify the TPS change type (Default: sin)");
+	printf("%-24s %s\n", "    --tpschange=<sin|square|pulse|ramp>", "Specify the TPS change type (Default: sin)");
+	printf("%-24s %s\n",
+	       "    --arrival=<closed|uniform|poisson>",
+	       "Start transactions in a closed loop, or open loop at the target TPS (Default: closed)");
 	printf("%-24s %s\n", "    --sampling=RATE", "Specify the sampling rate for latency stats");
 	printf("%-24s %s\n", "-m, --mode=MODE", "Specify the mode (build, run, clean, report)");
 	printf("%-24s %s\n", "-z, --zipf", "Use zipfian distribution instead of uniform distribution");
@@ -1238,6 +1280,7 @@ int parseArguments(int argc, char* argv[], Arguments& args) {
 			{ "tpsmin", required_argument, NULL, ARG_TPSMIN },
 			{ "tpsinterval", required_argument, NULL, ARG_TPSINTERVAL },
 			{ "tpschange", required_argument, NULL, ARG_TPSCHANGE },
+			{ "arrival", required_argument, NULL, ARG_ARRIVAL },
 			{ "sampling", required_argument, NULL, ARG_SAMPLING },
 			{ "verbose", required_argument, NULL, 'v' },
 			{ "mode", required_argument, NULL, 'm' },
@@ -1398,8 +1441,22 @@ int parseArguments(int argc, char* argv[], Arguments& args) {
 				args.tpschange = TPS_SQUARE;
 			else if (strcmp(optarg, "pulse") == 0)
 				args.tpschange = TPS_PULSE;
+			else if (strcmp(optarg, "ramp") == 0)
+				args.tpschange = TPS_RAMP;
 			else {
-				logr.error("--tpschange must be sin, square or pulse");
+				logr.error("--tpschange must be sin, square, pulse or ramp");
+				return -1;
+			}
+			break;
+		case ARG_ARRIVAL:
+			if (strcmp(optarg, "closed") == 0)
+				args.arrival = ARRIVAL_CLOSED;
+			else if (strcmp(optarg, "uniform") == 0)
+				args.arrival = ARRIVAL_UNIFORM;
+			else if (strcmp(optarg, "poisson") == 0)
+				args.arrival = ARRIVAL_POISSON;
+			else {
+				logr.error("--arrival must be closed, uniform or poisson");
 				return -1;
 			}
 			break;
@@ -1666,6 +1723,10 @@ int Arguments::validate() {
 				return -1;
 			}
 		}
+		if (arrival != ARRIVAL_CLOSED && (tpsmax == 0 || async_xacts > 0)) {
+			logr.error("--arrival uniform|poisson needs --tpsmax|--tps and is not supported in async mode");
+			return -1;
+		}
 	}
 
 	// ensure that all of the files provided to mako are valid and exist
@@ -1786,11 +1847,22 @@ void printStats(Arguments const& args, WorkflowStatistics const* stats, double c
 	/* Conflicts */
 	const auto conflicts_diff = (current.getConflictCount() - prev.getConflictCount()) / duration_sec;
 	putFieldFloat(conflicts_diff, 2);
-	fmt::print("\n");
 	if (fp) {
 		fprintf(fp, "\"conflictsPerSec\": %.2f", conflicts_diff);
 	}
 
+	/* Mean transaction latency over the interval, which in open loop shows where it climbs as the rate ramps */
+	if (args.arrival != ARRIVAL_CLOSED) {
+		const auto samples = current.getLatencySampleCount(OP_TRANSACTION) - prev.getLatencySampleCount(OP_TRANSACTION);
+		const auto latency_us =
+		    samples ? (current.getLatencyUsTotal(OP_TRANSACTION) - prev.getLatencyUsTotal(OP_TRANSACTION)) / samples : 0;
+		putField(latency_us);
+		if (fp) {
+			fmt::print(fp, ",\"meanLatencyUs\": {}", latency_us);
+		}
+	}
+	fmt::print("\n");
+
 	if (print_err) {
 		putTitleRight("Errors");
 		for (auto op = 0; op < MAX_OP; op++) {
@@ -1811,7 +1883,11 @@ void printStats(Arguments const& args, WorkflowStatistics const* stats, double c
 	prev = current;
 }
 
-void printStatsHeader(Arguments const& args, bool show_commit, bool is_first_header_empty, bool show_op_stats) {
+void printStatsHeader(Arguments const& args,
+                      bool show_commit,
+                      bool is_first_header_empty,
+                      bool show_op_stats,
+                      bool show_latency = false) {
 	/* header */
 	if (is_first_header_empty)
 		putTitle("");
@@ -1828,6 +1904,8 @@ void printStatsHeader(Arguments const& args, bool show_commit, bool is_first_hea
 	} else {
 		putField("TPS");
 		putField("Conflicts/s");
+		if (show_latency)
+			putField("Latency(us)");
 	}
 	fmt::print("\n");
 
@@ -1851,6 +1929,10 @@ void printStatsHeader(Arguments const& args, bool show_commit, bool is_first_hea
 
 		/* Conflicts */
 		putFieldBar();
+
+		/* Latency */
+		if (show_latency)
+			putFieldBar();
 	}
 	fmt::print("\n");
 }
@@ -2180,8 +2262,13 @@ void printReport(Arguments const& args,
 		case TPS_PULSE:
 			fmt::printf("%8s\n", "PULSE");
 			break;
+		case TPS_RAMP:
+			fmt::printf("%8s\n", "RAMP");
+			break;
 		}
 	}
+	if (args.arrival != ARRIVAL_CLOSED)
+		fmt::printf("Arrival:           %8s\n", args.arrival == ARRIVAL_POISSON ? "POISSON" : "UNIFORM");
 	const auto tps_f = final_worker_stats.getOpCount(OP_TRANSACTION) / duration_sec;
 	const auto tps_i = static_cast<uint64_t>(tps_f);
 
@@ -2202,6 +2289,7 @@ void printReport(Arguments const& args,
 		fmt::fprintf(fp, "\"totalThreads\": %d,", args.num_threads);
 		fmt::fprintf(fp, "\"totalAsyncXacts\": %d,", args.async_xacts);
 		fmt::fprintf(fp, "\"targetTPS\": %d,", args.tpsmax);
+		fmt::fprintf(fp, "\"arrival\": %d,", args.arrival);
 		fmt::fprintf(fp, "\"totalXacts\": %lu,", final_worker_stats.getOpCount(OP_TRANSACTION));
 		fmt::fprintf(fp, "\"totalConflicts\": %lu,", final_worker_stats.getConflictCount());
 		fmt::fprintf(fp, "\"totalErrors\": %lu,", final_worker_stats.getTotalErrorCount());
@@ -2340,7 +2428,7 @@ int statsProcessMain(Arguments const& args,
 	}
 
 	if (args.verbose >= VERBOSE_DEFAULT)
-		printStatsHeader(args, false, true, false);
+		printStatsHeader(args, false, true, false, args.arrival != ARRIVAL_CLOSED);
 
 	FILE* fp = NULL;
 	if (args.json_output_path[0] != '\0') {
@@ -2360,6 +2448,7 @@ int statsProcessMain(Arguments const& args,
 		fmt::fprintf(fp, "\"tpsmin\": %d,", args.tpsmin);
 		fmt::fprintf(fp, "\"tpsinterval\": %d,", args.tpsinterval);
 		fmt::fprintf(fp, "\"tpschange\": %d,", args.tpschange);
+		fmt::fprintf(fp, "\"arrival\": %d,", args.arrival);
 		fmt::fprintf(fp, "\"sampling\": %d,", args.sampling);
 		fmt::fprintf(fp, "\"key_length\": %d,", args.key_length);
 		fmt::fprintf(fp, "\"value_length\": %d,", args.value_length);
@@ -2426,6 +2515,10 @@ int statsProcessMain(Arguments const& args,
 						throttle_factor = tpsmin / tpsmax;
 					}
 					break;
+				case TPS_RAMP:
+					/* rise linearly from min to max, to find the rate past which latency climbs */
+					throttle_factor = (tpsmin + (tpsmax - tpsmin) * pos / tpsinterval) / tpsmax;
+					break;
 				}
 			}
 
@@ -72,6 +72,7 @@ enum ArgKind {
 	ARG_TPSMIN,
 	ARG_TPSINTERVAL,
 	ARG_TPSCHANGE,
+	ARG_ARRIVAL,
 	ARG_TXNTRACE,
 	ARG_TXNTAGGING,
 	ARG_TXNTAGGINGPREFIX,
@@ -115,10 +116,16 @@ enum OpKind {
 	OP_COMMIT,
 	OP_TRANSACTION, /* pseudo-operation - time it takes to run one iteration of ops sequence */
 	OP_READ_BG,
+	OP_GETBATCH,
+	OP_GETRANGEPACKED,
 	MAX_OP /* must be the last item */
 };
 
-enum TPSChangeTypes { TPS_SIN, TPS_SQUARE, TPS_PULSE };
+enum TPSChangeTypes { TPS_SIN, TPS_SQUARE, TPS_PULSE, TPS_RAMP };
+
+/* how worker threads start transactions: closed loop starts one as soon as the previous one finishes, open loop starts
+ * them at a target arrival rate, evenly spaced or as a Poisson process, however long earlier ones take */
+enum ArrivalKind { ARRIVAL_CLOSED, ARRIVAL_UNIFORM, ARRIVAL_POISSON };
 
 enum DistributedTracerClient { DISABLED, NETWORK_LOSSY, LOG_FILE };
 
@@ -169,6 +176,7 @@ struct Arguments {
 	int tpsmin;
 	int tpsinterval;
 	int tpschange;
+	int arrival;
 	int sampling;
 	int key_length;
 	int value_length;
@@ -267,6 +267,57 @@ const std::array<Operation, MAX_OP> opTable{
 	            return tx.onError(err).eraseType();
 	        } } },
 	    1,
+	    false },
+	  { "GETBATCH",
+	    { { StepKind::READ,
+	        [](Transaction& tx, Arguments const& args, ByteString& key, ByteString&, ByteString&) {
+	            // Reads as many random keys as a GET RANGE of the same range would, with one future
+	            static thread_local std::vector<ByteString> batch_keys;
+	            const auto batch = args.txnspec.ops[OP_GETBATCH][OP_RANGE];
+	            batch_keys.resize(batch, key);
+	            auto keys = std::vector<KeyRef>{};
+	            keys.reserve(batch);
+	            for (auto& batch_key : batch_keys) {
+		            genKey(batch_key.data(), KEY_PREFIX, args, nextKey(args));
+		            keys.push_back(batch_key);
+	            }
+	            return tx.getValues(keys, false /*snapshot*/).eraseType();
+	        },
+	        [](Future& f, Transaction&, Arguments const&, ByteString&, ByteString&, ByteString& val) {
+	            if (f && !f.error()) {
+		            f.get<future_var::KeyValueRefArray>();
+	            }
+	        } } },
+	    1,
+	    false },
+	  { "GETRANGEPACKED",
+	    { { StepKind::READ,
+	        [](Transaction& tx, Arguments const& args, ByteString& begin, ByteString& end, ByteString&) {
+	            return tx
+	                .getRange(key_select::firstGreaterOrEqual(begin),
+	                          key_select::lastLessOrEqual(end, 1),
+	                          0 /*limit*/,
+	                          0 /*target_bytes*/,
+	                          args.streaming_mode,
+	                          0 /*iteration*/,
+	                          false /*snapshot*/,
+	                          args.txnspec.ops[OP_GETRANGEPACKED][OP_REVERSE])
+	                .eraseType();
+	        },
+	        [](Future& f, Transaction&, Arguments const& args, ByteString&, ByteString&, ByteString& val) {
+	            // Copies the result into one buffer, as a binding that wraps it without copying each pair would
+	            static thread_local std::vector<uint8_t> packed;
+	            if (f && !f.error()) {
+		            packed.resize(8 + args.txnspec.ops[OP_GETRANGEPACKED][OP_RANGE] *
+		                                  (8 + args.key_length + args.value_length));
+		            auto count = 0;
+		            auto more = false;
+		            auto packed_length = 0;
+		            f.getPackedKeyValueArrayNothrow(
+		                packed.data(), static_cast<int>(packed.size()), count, more, packed_length);
+	            }
+	        } } },
+	    1,
 	    false } }
 };
 
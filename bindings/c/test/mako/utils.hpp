@@ -53,6 +53,11 @@ force_inline int urand(int low, int high) {
 	return (int)((r * range) + low);
 }
 
+/* return a uniform random number in [0, 1) */
+force_inline double urand01() {
+	return rand() / (1.0 + RAND_MAX);
+}
+
 force_inline int nextKey(Arguments const& args) {
 	if (args.zipf)
 		return zipfian_next();
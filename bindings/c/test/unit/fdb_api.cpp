@@ -102,6 +102,14 @@ void Future::cancel() {
 	return fdb_future_get_keyvalue_array(future_, out_kv, out_count, out_more);
 }
 
+[[nodiscard]] fdb_error_t KeyValueArrayFuture::get_packed(uint8_t* buffer,
+                                                          int buffer_length,
+                                                          int* out_count,
+                                                          fdb_bool_t* out_more,
+                                                          int* out_packed_length) {
+	return fdb_future_get_keyvalue_array_packed(future_, buffer, buffer_length, out_count, out_more, out_packed_length);
+}
+
 // MappedKeyValueArrayFuture
 
 [[nodiscard]] fdb_error_t MappedKeyValueArrayFuture::get(const FDBMappedKeyValue** out_kv,
@@ -253,6 +261,14 @@ ValueFuture Transaction::get(std::string_view key, fdb_bool_t snapshot) {
 	return ValueFuture(fdb_transaction_get(tr_, (const uint8_t*)key.data(), key.size(), snapshot));
 }
 
+KeyValueArrayFuture Transaction::get_values(const std::vector<std::string>& keys, fdb_bool_t snapshot) {
+	std::vector<FDBKey> native_keys;
+	for (const std::string& key : keys) {
+		native_keys.push_back(FDBKey{ (const uint8_t*)key.data(), (int)key.size() });
+	}
+	return KeyValueArrayFuture(fdb_transaction_get_values(tr_, native_keys.data(), native_keys.size(), snapshot));
+}
+
 KeyFuture Transaction::get_key(const uint8_t* key_name,
                                int key_name_length,
                                fdb_bool_t or_equal,
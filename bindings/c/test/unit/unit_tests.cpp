@@ -546,6 +546,92 @@ TEST_CASE("fdb_future_get_string_array") {
 	}
 }
 
+TEST_CASE("fdb_future_get_keyvalue_array_packed") {
+	std::map<std::string, std::string> data = create_data({ { "a", "1" }, { "b", "22" }, { "c", "333" } });
+	insert_data(db, data);
+
+	fdb::Transaction tr(db);
+	while (1) {
+		fdb::KeyValueArrayFuture f1 =
+		    tr.get_range(FDB_KEYSEL_FIRST_GREATER_OR_EQUAL((const uint8_t*)key("a").c_str(), key("a").size()),
+		                 FDB_KEYSEL_LAST_LESS_OR_EQUAL((const uint8_t*)key("c").c_str(), key("c").size()) + 1,
+		                 /* limit */ 0,
+		                 /* target_bytes */ 0,
+		                 /* FDBStreamingMode */ FDB_STREAMING_MODE_WANT_ALL,
+		                 /* iteration */ 0,
+		                 /* snapshot */ false,
+		                 /* reverse */ 0);
+
+		fdb_error_t err = wait_future(f1);
+		if (err) {
+			fdb::EmptyFuture f2 = tr.on_error(err);
+			fdb_check(wait_future(f2));
+			continue;
+		}
+
+		std::vector<uint8_t> buffer(1024);
+		int out_count;
+		fdb_bool_t out_more;
+		int out_packed_length;
+		fdb_check(f1.get_packed(buffer.data(), buffer.size(), &out_count, &out_more, &out_packed_length));
+		CHECK(out_count == 3);
+		CHECK(!out_more);
+
+		int32_t header[2];
+		memcpy(header, buffer.data(), sizeof(header));
+		CHECK(header[0] == out_count);
+		CHECK(header[1] == out_more);
+		int offset = sizeof(header);
+		for (int i = 0; i < out_count; ++i) {
+			int32_t lengths[2];
+			memcpy(lengths, buffer.data() + offset, sizeof(lengths));
+			offset += sizeof(lengths);
+			std::string key((const char*)buffer.data() + offset, lengths[0]);
+			offset += lengths[0];
+			std::string value((const char*)buffer.data() + offset, lengths[1]);
+			offset += lengths[1];
+			CHECK(data[key].compare(value) == 0);
+		}
+		CHECK(offset == out_packed_length);
+
+		// A buffer too small for every pair holds the pairs that fit, and sets more
+		fdb_check(f1.get_packed(buffer.data(), out_packed_length - 1, &out_count, &out_more, &out_packed_length));
+		CHECK(out_count == 2);
+		CHECK(out_more);
+		break;
+	}
+}
+
+TEST_CASE("fdb_transaction_get_values") {
+	std::map<std::string, std::string> data = create_data({ { "a", "1" }, { "c", "3" } });
+	insert_data(db, data);
+
+	fdb::Transaction tr(db);
+	while (1) {
+		fdb::KeyValueArrayFuture f1 = tr.get_values({ key("c"), key("b"), key("a") }, /* snapshot */ false);
+
+		fdb_error_t err = wait_future(f1);
+		if (err) {
+			fdb::EmptyFuture f2 = tr.on_error(err);
+			fdb_check(wait_future(f2));
+			continue;
+		}
+
+		FDBKeyValue const* out_kv;
+		int out_count;
+		fdb_bool_t out_more;
+		fdb_check(f1.get(&out_kv, &out_count, &out_more));
+
+		// Only the keys that are present, in the order they were asked for
+		CHECK(out_count == 2);
+		CHECK(std::string((const char*)out_kv[0].key, out_kv[0].key_length) == key("c"));
+		CHECK(std::string((const char*)out_kv[0].value, out_kv[0].value_length) == "3");
+		CHECK(std::string((const char*)out_kv[1].key, out_kv[1].key_length) == key("a"));
+		CHECK(std::string((const char*)out_kv[1].value, out_kv[1].value_length) == "1");
+		break;
+	}
+}
+
 TEST_CASE("fdb_future_get_keyvalue_array") {
 	std::map<std::string, std::string> data = create_data({ { "a", "1" }, { "b", "2" }, { "c", "3" }, { "d", "4" } });
 	insert_data(db, data);
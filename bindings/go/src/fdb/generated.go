@@ -296,6 +296,13 @@ func (o NetworkOptions) SetDisableClientBypass() error {
 	return o.setOpt(72, nil)
 }
 
+// Spreads the transactions of each database created afterwards over this many of the threads spawned by client_threads_per_version, instead of servicing each database with a single thread. Values larger than client_threads_per_version are reduced to it. Must be set before setting up the network.
+//
+// Parameter: Number of client threads each database is spread over.
+func (o NetworkOptions) SetClientThreadsPerDatabase(param int64) error {
+	return o.setOpt(73, int64ToBytes(param))
+}
+
 // Enable client buggify - will make requests randomly fail (intended for client testing)
 func (o NetworkOptions) SetClientBuggifyEnable() error {
 	return o.setOpt(80, nil)
@@ -509,6 +516,20 @@ func (o TransactionOptions) SetReadPriorityHigh() error {
 	return o.setOpt(511, nil)
 }
 
+// Subsequent reads in this transaction may be served by storage servers which lag the read version by at most this many versions, at the latest version they have, instead of waiting for them to catch up. Such reads may not observe commits made just before the read version, so this option should only be used for read-only transactions which tolerate stale data.
+//
+// Parameter: Number of versions, 0 to disable
+func (o TransactionOptions) SetReadMaxStaleVersions(param int64) error {
+	return o.setOpt(512, int64ToBytes(param))
+}
+
+// Subsequent range reads in this transaction whose begin and end are plain keys read up to this many of the shards they span at once, and return the rows of all of them in order. A scan of a large range then waits for the slowest of several shards at a time instead of for each shard in turn. Reads that stop at a row or byte limit may fetch more data than they return.
+//
+// Parameter: Number of shards, 0 or 1 to disable
+func (o TransactionOptions) SetReadParallelShards(param int64) error {
+	return o.setOpt(513, int64ToBytes(param))
+}
+
 // Not yet implemented.
 func (o TransactionOptions) SetDurabilityDatacenter() error {
 	return o.setOpt(110, nil)
@@ -673,6 +694,11 @@ func (o TransactionOptions) SetSpecialKeySpaceEnableWrites() error {
 	return o.setOpt(714, nil)
 }
 
+// Records in process where the time of the transaction goes: waiting for the read version, looking up key locations, each read with the storage team it was sent to, and the phases of the commit. The timeline is read from the transaction timeline range of the special key space, also after a commit, and is kept across retries until the transaction is reset.
+func (o TransactionOptions) SetRecordTimeline() error {
+	return o.setOpt(715, nil)
+}
+
 // Adds a tag to the transaction that can be used to apply manual targeted throttling. At most 5 tags can be set on a transaction.
 //
 // Parameter: String identifier used to associated this transaction with a throttling group. Must not exceed 16 characters.
@@ -170,7 +170,7 @@ set(WITH_ROCKSDB ON CACHE BOOL "Build with experimental RocksDB support")
  # https://github.com/facebook/rocksdb/blob/v8.6.7/CMakeLists.txt#L256
 set(PORTABLE_ROCKSDB 1 CACHE STRING "Minimum CPU arch to support (i.e. skylake, haswell, etc., or 0 = current CPU, 1 = baseline CPU)")
 set(ROCKSDB_TOOLS OFF CACHE BOOL "Compile RocksDB tools")
-set(WITH_LIBURING OFF CACHE BOOL "Build with liburing enabled") # Set this to ON to include liburing
+set(WITH_LIBURING OFF CACHE BOOL "Build with liburing enabled") # Set this to ON to include liburing, used by RocksDB and AsyncFileIOUring
 
 ################################################################################
 # TOML11
@@ -245,6 +245,7 @@ function(print_components)
   message(STATUS "Build Python sdist (make package):    ${WITH_PYTHON_BINDING}")
   message(STATUS "Configure CTest (depends on Python):  ${WITH_PYTHON}")
   message(STATUS "Build with RocksDB:                   ${WITH_ROCKSDB}")
+  message(STATUS "Build with liburing:                  ${WITH_LIBURING}")
   message(STATUS "Build with AWS SDK:                   ${WITH_AWS_BACKUP}")
   message(STATUS "=========================================")
 endfunction()
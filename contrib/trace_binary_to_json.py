@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+#
+# trace_binary_to_json.py
+#
+# This source file is part of the FoundationDB open source project
+#
+# Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+# Converts trace files written with --trace-format binary (see flow/include/flow/BinaryTraceLogFormatter.h) into the
+# trace files --trace-format json would have written.
+
+import argparse
+import sys
+
+HEADER = b"FDBTRACE1\n"
+
+
+def read_varint(data, pos):
+    value = 0
+    shift = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        if byte < 0x80:
+            return value, pos
+        shift += 7
+
+
+def read_string(data, pos):
+    length, pos = read_varint(data, pos)
+    return data[pos:pos + length], pos + length
+
+
+# As JsonTraceLogFormatter escapes strings
+def escape(s):
+    out = []
+    for c in s:
+        if c == ord('"'):
+            out.append('\\"')
+        elif c == ord("\\"):
+            out.append("\\\\")
+        elif c == ord("\n"):
+            out.append("\\n")
+        elif c == ord("\r"):
+            out.append("\\r")
+        elif 0x20 <= c < 0x7F:
+            out.append(chr(c))
+        else:
+            out.append("\\x%02x" % c)
+    return "".join(out)
+
+
+def convert(data, out):
+    if not data.startswith(HEADER):
+        raise ValueError("not a binary trace file")
+    pos = len(HEADER)
+    while pos < len(data):
+        count, pos = read_varint(data, pos)
+        fields = []
+        for _ in range(count):
+            name, pos = read_string(data, pos)
+            value, pos = read_string(data, pos)
+            fields.append('"%s": "%s"' % (escape(name), escape(value)))
+        out.write("{  " + ", ".join(fields) + " }\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert binary FoundationDB trace files to JSON")
+    parser.add_argument("input", help="a trace.*.bin file")
+    parser.add_argument("output", nargs="?", help="where to write the JSON events (default: standard output)")
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as f:
+        data = f.read()
+    if args.output:
+        with open(args.output, "w") as out:
+            convert(data, out)
+    else:
+        convert(data, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
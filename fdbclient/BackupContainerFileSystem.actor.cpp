@@ -28,6 +28,7 @@
 #include "fdbclient/BackupContainerLocalDirectory.h"
 #include "fdbclient/BackupContainerS3BlobStore.h"
 #include "fdbclient/JsonBuilder.h"
+#include "crc32/crc32c.h"
 #include "flow/StreamCipher.h"
 #include "flow/UnitTest.h"
 
@@ -219,8 +220,8 @@ public:
 		state std::vector<LogFile> logs;
 		state std::vector<LogFile> pLogs;
 
-		wait(success(fRanges) && success(fSnapshots) && store(logs, bc->listLogFiles(begin, end, false)) &&
-		     store(pLogs, bc->listLogFiles(begin, end, true)));
+		wait(success(fRanges) && success(fSnapshots) && store(logs, bc->listLogFiles(begin, end, false, false)) &&
+		     store(pLogs, bc->listLogFiles(begin, end, true, false)));
 		logs.insert(logs.end(), std::make_move_iterator(pLogs.begin()), std::make_move_iterator(pLogs.end()));
 
 		return BackupFileList({ fRanges.get(), std::move(logs), fSnapshots.get() });
@@ -530,8 +531,8 @@ public:
 		state std::vector<LogFile> plogs;
 		TraceEvent("BackupContainerListFiles").detail("URL", bc->getURL());
 
-		wait(store(logs, bc->listLogFiles(scanBegin, scanEnd, false)) &&
-		     store(plogs, bc->listLogFiles(scanBegin, scanEnd, true)) &&
+		wait(store(logs, bc->listLogFiles(scanBegin, scanEnd, false, !deepScan)) &&
+		     store(plogs, bc->listLogFiles(scanBegin, scanEnd, true, !deepScan)) &&
 		     store(desc.snapshots, bc->listKeyspaceSnapshots()));
 
 		TraceEvent("BackupContainerListFiles")
@@ -716,9 +717,13 @@ public:
 			progress->step = "Listing files";
 		}
 		// Get log files or range files that contain any data at or before expireEndVersion
-		wait(store(logs, bc->listLogFiles(scanBegin, expireEndVersion - 1, false)) &&
-		     store(pLogs, bc->listLogFiles(scanBegin, expireEndVersion - 1, true)) &&
-		     store(ranges, bc->listRangeFiles(scanBegin, expireEndVersion - 1)));
+		state BackupContainerFileSystem::FilesAndSizesT logManifests;
+		state BackupContainerFileSystem::FilesAndSizesT pLogManifests;
+		wait(store(logs, bc->listLogFiles(scanBegin, expireEndVersion - 1, false, false)) &&
+		     store(pLogs, bc->listLogFiles(scanBegin, expireEndVersion - 1, true, false)) &&
+		     store(ranges, bc->listRangeFiles(scanBegin, expireEndVersion - 1)) &&
+		     store(logManifests, bc->listFiles("logmanifests/")) &&
+		     store(pLogManifests, bc->listFiles("plogmanifests/")));
 		logs.insert(logs.end(), std::make_move_iterator(pLogs.begin()), std::make_move_iterator(pLogs.end()));
 
 		// The new logBeginVersion will be taken from the last log file, if there is one
@@ -772,6 +777,20 @@ public:
 			if (f.endVersion < expireEndVersion)
 				toDelete.push_back(std::move(f.fileName));
 		}
+
+		// Manifests of folders with expired versions are no longer used since those folders are unreliable
+		logManifests.insert(logManifests.end(), pLogManifests.begin(), pLogManifests.end());
+		for (auto const& f : logManifests) {
+			int64_t folder;
+			int len;
+			std::string name = fileNameOnly(f.first);
+			if (sscanf(name.c_str(), "manifest,%" SCNd64 "%n", &folder, &len) == 1 && len == name.size() &&
+			    folder * LOG_FOLDER_VERSIONS < expireEndVersion) {
+				toDelete.push_back(f.first);
+			}
+		}
+		logManifests.clear();
+		pLogManifests.clear();
 		desc = BackupDescription();
 
 		// We are about to start deleting files, at which point all data prior to expireEndVersion is considered
@@ -1104,6 +1123,225 @@ public:
 		return false;
 	}
 
+	// Number of versions covered by each innermost log folder
+	static constexpr Version LOG_FOLDER_VERSIONS = 100000000000LL;
+
+	// A log manifest records the files of one log folder that can no longer change, so that listing log files can
+	// read it instead of listing the folder. It is written the first time the folder is listed after it is sealed.
+	static std::string logManifestFileName(int64_t folder, bool partitioned) {
+		return format("%s/manifest,%" PRId64, (partitioned ? "plogmanifests" : "logmanifests"), folder);
+	}
+
+	static std::string encodeLogManifest(const BackupContainerFileSystem::FilesAndSizesT& files) {
+		std::string body;
+		for (auto& f : files) {
+			body += format("%" PRId64 ",%s\n", f.second, f.first.c_str());
+		}
+		uint32_t checksum = crc32c_append(0, (const uint8_t*)body.data(), body.size());
+		return format("fdb_log_manifest,1,%d,%08x\n", (int)files.size(), checksum) + body;
+	}
+
+	// Returns the files in the manifest, or not present if it is corrupt or lists a file outside of folder
+	static Optional<BackupContainerFileSystem::FilesAndSizesT> decodeLogManifest(const std::string& contents,
+	                                                                              int64_t folder) {
+		size_t headerEnd = contents.find('\n');
+		int formatVersion, count, len;
+		uint32_t checksum;
+		if (headerEnd == std::string::npos ||
+		    sscanf(contents.c_str(), "fdb_log_manifest,%d,%d,%x%n", &formatVersion, &count, &checksum, &len) != 3 ||
+		    len != headerEnd || formatVersion != 1) {
+			return Optional<BackupContainerFileSystem::FilesAndSizesT>();
+		}
+		const char* body = contents.data() + headerEnd + 1;
+		size_t bodySize = contents.size() - headerEnd - 1;
+		if (crc32c_append(0, (const uint8_t*)body, bodySize) != checksum) {
+			return Optional<BackupContainerFileSystem::FilesAndSizesT>();
+		}
+
+		BackupContainerFileSystem::FilesAndSizesT files;
+		size_t pos = headerEnd + 1;
+		while (pos < contents.size()) {
+			size_t lineEnd = contents.find('\n', pos);
+			size_t comma = contents.find(',', pos);
+			int64_t size;
+			LogFile lf;
+			if (lineEnd == std::string::npos || comma >= lineEnd ||
+			    sscanf(contents.c_str() + pos, "%" SCNd64 ",", &size) != 1) {
+				return Optional<BackupContainerFileSystem::FilesAndSizesT>();
+			}
+			std::string path = contents.substr(comma + 1, lineEnd - comma - 1);
+			if (!pathToLogFile(lf, path, size) || lf.beginVersion / LOG_FOLDER_VERSIONS != folder) {
+				return Optional<BackupContainerFileSystem::FilesAndSizesT>();
+			}
+			files.emplace_back(std::move(path), size);
+			pos = lineEnd + 1;
+		}
+		if (files.size() != count) {
+			return Optional<BackupContainerFileSystem::FilesAndSizesT>();
+		}
+		return files;
+	}
+
+	// Lists the files in the log folders which could contain files beginning at any version in [firstVersion,
+	// lastVersion]. Containers are allowed to ignore the folder filter, so files from other folders may be returned.
+	static Future<BackupContainerFileSystem::FilesAndSizesT> listLogFolders(Reference<BackupContainerFileSystem> bc,
+	                                                                      Version firstVersion,
+	                                                                      Version lastVersion,
+	                                                                      bool partitioned) {
+		// Get the cleaned (without slashes) first and last folders that could contain relevant results.
+		std::string firstPath = cleanFolderString(logVersionFolderString(firstVersion, partitioned));
+		std::string lastPath = cleanFolderString(logVersionFolderString(lastVersion, partitioned));
+
+		std::function<bool(std::string const&)> pathFilter = [=](const std::string& folderPath) {
+			// Remove slashes in the given folder path so that the '/' positions in the version folder string do not
+			// matter
+
+			std::string cleaned = cleanFolderString(folderPath);
+			return StringRef(firstPath).startsWith(cleaned) || StringRef(lastPath).startsWith(cleaned) ||
+			       (cleaned > firstPath && cleaned < lastPath);
+		};
+
+		return bc->listFiles((partitioned ? "plogs/" : "logs/"), pathFilter);
+	}
+
+	ACTOR static Future<BackupContainerFileSystem::FilesAndSizesT>
+	readOrWriteLogManifest(Reference<BackupContainerFileSystem> bc, int64_t folder, bool partitioned) {
+		state std::string path = logManifestFileName(folder, partitioned);
+		try {
+			state Reference<IAsyncFile> f = wait(bc->readFile(path));
+			state int64_t size = wait(f->size());
+			state std::string s;
+			s.resize(size);
+			int rs = wait(f->read((uint8_t*)s.data(), size, 0));
+			Optional<BackupContainerFileSystem::FilesAndSizesT> files =
+			    rs == size ? decodeLogManifest(s, folder) : Optional<BackupContainerFileSystem::FilesAndSizesT>();
+			if (files.present()) {
+				return files.get();
+			}
+			TraceEvent(SevWarn, "BackupContainerLogManifestInvalid").detail("URL", bc->getURL()).detail("Path", path);
+		} catch (Error& e) {
+			if (e.code() == error_code_actor_cancelled) {
+				throw;
+			}
+			if (e.code() != error_code_file_not_found) {
+				TraceEvent(SevWarn, "BackupContainerLogManifestReadFailed")
+				    .error(e)
+				    .detail("URL", bc->getURL())
+				    .detail("Path", path);
+			}
+		}
+
+		// Fall back to listing the folder, and replace the manifest with the result
+		state BackupContainerFileSystem::FilesAndSizesT files = wait(listLogFolders(
+		    bc, folder * LOG_FOLDER_VERSIONS, (folder + 1) * LOG_FOLDER_VERSIONS - 1, partitioned));
+		LogFile lf;
+		files.erase(std::remove_if(files.begin(),
+		                           files.end(),
+		                           [&](const std::pair<std::string, int64_t>& f) {
+			                           return !pathToLogFile(lf, f.first, f.second) ||
+			                                  lf.beginVersion / LOG_FOLDER_VERSIONS != folder;
+		                           }),
+		            files.end());
+		try {
+			wait(bc->writeEntireFile(path, encodeLogManifest(files)));
+		} catch (Error& e) {
+			if (e.code() == error_code_actor_cancelled) {
+				throw;
+			}
+			// The container may not be writeable, the listing is still valid
+			TraceEvent(SevWarn, "BackupContainerLogManifestWriteFailed")
+			    .error(e)
+			    .detail("URL", bc->getURL())
+			    .detail("Path", path);
+		}
+		return files;
+	}
+
+	ACTOR static Future<std::vector<LogFile>> listLogFiles(Reference<BackupContainerFileSystem> bc,
+	                                                       Version beginVersion,
+	                                                       Version targetVersion,
+	                                                       bool partitioned,
+	                                                       bool useManifests) {
+		// The first relevant log file could have a begin version less than beginVersion based on the knobs which
+		// determine log file range size, so start at an earlier version adjusted by how many versions a file could
+		// contain.
+		state Version firstVersion = std::max<Version>(
+		    0, beginVersion - CLIENT_KNOBS->BACKUP_MAX_LOG_RANGES * CLIENT_KNOBS->LOG_RANGE_BLOCK_SIZE);
+
+		// Folders in [sealedBegin, sealedEnd) are read from their manifests
+		state int64_t sealedBegin = 0;
+		state int64_t sealedEnd = 0;
+		if (useManifests && CLIENT_KNOBS->BACKUP_CONTAINER_LOG_MANIFESTS) {
+			state Optional<Version> metaLogEnd;
+			state Optional<Version> metaLogType;
+			state Optional<Version> metaUnreliableEnd;
+			state Optional<Version> metaExpiredEnd;
+			try {
+				wait(store(metaLogEnd, bc->logEndVersion().get()) && store(metaLogType, bc->logType().get()) &&
+				     store(metaUnreliableEnd, bc->unreliableEndVersion().get()) &&
+				     store(metaExpiredEnd, bc->expiredEndVersion().get()));
+			} catch (Error& e) {
+				if (e.code() == error_code_actor_cancelled) {
+					throw;
+				}
+				// Without valid metadata no folder is known to be sealed
+				metaLogEnd = Optional<Version>();
+			}
+
+			// A folder is sealed once all of its versions are below the contiguous log end, so no more files that
+			// matter will be written to it, and above the unreliable and expired end versions, so no files will be
+			// deleted from it. Since the log end version is read before listing, a manifest lists at least the
+			// files which the log end version was computed from.
+			if (metaLogEnd.present() && metaLogType.present() &&
+			    metaLogType.get() == (partitioned ? PARTITIONED_MUTATION_LOG : NON_PARTITIONED_MUTATION_LOG)) {
+				Version reliableBegin = std::max(
+				    { firstVersion, metaUnreliableEnd.orDefault(0), metaExpiredEnd.orDefault(0) });
+				sealedBegin = (reliableBegin + LOG_FOLDER_VERSIONS - 1) / LOG_FOLDER_VERSIONS;
+				sealedEnd = std::min(metaLogEnd.get() / LOG_FOLDER_VERSIONS, targetVersion / LOG_FOLDER_VERSIONS + 1);
+			}
+		}
+
+		state std::vector<Future<BackupContainerFileSystem::FilesAndSizesT>> listings;
+		state std::vector<Future<BackupContainerFileSystem::FilesAndSizesT>> manifests;
+		if (sealedBegin < sealedEnd) {
+			if (firstVersion < sealedBegin * LOG_FOLDER_VERSIONS) {
+				listings.push_back(
+				    listLogFolders(bc, firstVersion, sealedBegin * LOG_FOLDER_VERSIONS - 1, partitioned));
+			}
+			for (int64_t folder = sealedBegin; folder < sealedEnd; ++folder) {
+				manifests.push_back(readOrWriteLogManifest(bc, folder, partitioned));
+			}
+			if (sealedEnd * LOG_FOLDER_VERSIONS <= targetVersion) {
+				listings.push_back(listLogFolders(bc, sealedEnd * LOG_FOLDER_VERSIONS, targetVersion, partitioned));
+			}
+		} else {
+			listings.push_back(listLogFolders(bc, firstVersion, targetVersion, partitioned));
+		}
+		wait(waitForAll(listings) && waitForAll(manifests));
+
+		std::vector<LogFile> results;
+		LogFile lf;
+		for (auto& listing : listings) {
+			for (auto& f : listing.get()) {
+				if (pathToLogFile(lf, f.first, f.second) && lf.endVersion > beginVersion &&
+				    lf.beginVersion <= targetVersion &&
+				    (lf.beginVersion < sealedBegin * LOG_FOLDER_VERSIONS ||
+				     lf.beginVersion >= sealedEnd * LOG_FOLDER_VERSIONS)) {
+					results.push_back(lf);
+				}
+			}
+		}
+		for (auto& manifest : manifests) {
+			for (auto& f : manifest.get()) {
+				if (pathToLogFile(lf, f.first, f.second) && lf.endVersion > beginVersion &&
+				    lf.beginVersion <= targetVersion) {
+					results.push_back(lf);
+				}
+			}
+		}
+		return results;
+	}
+
 	static bool pathToKeyspaceSnapshotFile(KeyspaceSnapshotFile& out, const std::string& path) {
 		std::string name = fileNameOnly(path);
 		KeyspaceSnapshotFile f;
@@ -1228,39 +1466,10 @@ Future<Void> BackupContainerFileSystem::writeKeyspaceSnapshotFile(const std::vec
 
 Future<std::vector<LogFile>> BackupContainerFileSystem::listLogFiles(Version beginVersion,
                                                                      Version targetVersion,
-                                                                     bool partitioned) {
-	// The first relevant log file could have a begin version less than beginVersion based on the knobs which
-	// determine log file range size, so start at an earlier version adjusted by how many versions a file could
-	// contain.
-	//
-	// Get the cleaned (without slashes) first and last folders that could contain relevant results.
-	std::string firstPath =
-	    BackupContainerFileSystemImpl::cleanFolderString(BackupContainerFileSystemImpl::logVersionFolderString(
-	        std::max<Version>(0,
-	                          beginVersion - CLIENT_KNOBS->BACKUP_MAX_LOG_RANGES * CLIENT_KNOBS->LOG_RANGE_BLOCK_SIZE),
-	        partitioned));
-	std::string lastPath = BackupContainerFileSystemImpl::cleanFolderString(
-	    BackupContainerFileSystemImpl::logVersionFolderString(targetVersion, partitioned));
-
-	std::function<bool(std::string const&)> pathFilter = [=](const std::string& folderPath) {
-		// Remove slashes in the given folder path so that the '/' positions in the version folder string do not
-		// matter
-
-		std::string cleaned = BackupContainerFileSystemImpl::cleanFolderString(folderPath);
-		return StringRef(firstPath).startsWith(cleaned) || StringRef(lastPath).startsWith(cleaned) ||
-		       (cleaned > firstPath && cleaned < lastPath);
-	};
-
-	return map(listFiles((partitioned ? "plogs/" : "logs/"), pathFilter), [=](const FilesAndSizesT& files) {
-		std::vector<LogFile> results;
-		LogFile lf;
-		for (auto& f : files) {
-			if (BackupContainerFileSystemImpl::pathToLogFile(lf, f.first, f.second) && lf.endVersion > beginVersion &&
-			    lf.beginVersion <= targetVersion)
-				results.push_back(lf);
-		}
-		return results;
-	});
+                                                                     bool partitioned,
+                                                                     bool useManifests) {
+	return BackupContainerFileSystemImpl::listLogFiles(
+	    Reference<BackupContainerFileSystem>::addRef(this), beginVersion, targetVersion, partitioned, useManifests);
 }
 
 Future<std::vector<RangeFile>> BackupContainerFileSystem::old_listRangeFiles(Version beginVersion, Version endVersion) {
@@ -1856,6 +2065,58 @@ TEST_CASE("/backup/containers/localdir/encrypted") {
 	return Void();
 }
 
+static std::vector<std::string> logFileNames(std::vector<LogFile> logs) {
+	std::vector<std::string> names;
+	for (auto& f : logs) {
+		names.push_back(f.fileName);
+	}
+	std::sort(names.begin(), names.end());
+	return names;
+}
+
+TEST_CASE("/backup/containers/localdir/logManifests") {
+	if (!CLIENT_KNOBS->BACKUP_CONTAINER_LOG_MANIFESTS) {
+		return Void();
+	}
+	state Version folderVersions = BackupContainerFileSystemImpl::LOG_FOLDER_VERSIONS;
+	state Reference<BackupContainerFileSystem> bc = BackupContainerFileSystem::openContainerFS(
+	    format("file://%s/fdb_backups/%llx", params.getDataDir().c_str(), timer_int()), {}, {});
+	wait(bc->create());
+
+	// Contiguous logs from the middle of folder 0 to the middle of folder 2
+	state Version v = folderVersions / 2;
+	for (; v < folderVersions * 5 / 2; v += folderVersions / 2) {
+		Reference<IBackupFile> f = wait(bc->writeLogFile(v, v + folderVersions / 2, 10));
+		wait(f->finish());
+	}
+	wait(bc->writeEntireFile("properties/log_end_version", format("%lld", folderVersions * 5 / 2)));
+	wait(bc->writeEntireFile("properties/mutation_log_type",
+	                         format("%lld", BackupContainerFileSystemImpl::NON_PARTITIONED_MUTATION_LOG)));
+
+	// Folders 0 and 1 are sealed, and their manifests are written by the first listing
+	state std::vector<LogFile> listed = wait(bc->listLogFiles(0, std::numeric_limits<Version>::max(), false, false));
+	ASSERT_EQ(listed.size(), 5);
+	std::vector<LogFile> fromManifests = wait(bc->listLogFiles(0, std::numeric_limits<Version>::max(), false));
+	ASSERT(logFileNames(fromManifests) == logFileNames(listed));
+	std::vector<LogFile> partial = wait(bc->listLogFiles(folderVersions + 1, folderVersions * 2, false));
+	ASSERT_EQ(partial.size(), 3);
+
+	// A file added to a sealed folder is only seen once its manifest turns out to be invalid
+	state Reference<IBackupFile> late = wait(bc->writeLogFile(folderVersions, folderVersions + 1, 10));
+	wait(late->finish());
+	std::vector<LogFile> stale = wait(bc->listLogFiles(0, std::numeric_limits<Version>::max(), false));
+	ASSERT(logFileNames(stale) == logFileNames(listed));
+
+	wait(bc->writeEntireFile(BackupContainerFileSystemImpl::logManifestFileName(1, false), "fdb_log_manifest,1,0,0\n1"));
+	std::vector<LogFile> rebuilt = wait(bc->listLogFiles(0, std::numeric_limits<Version>::max(), false));
+	ASSERT_EQ(rebuilt.size(), listed.size() + 1);
+	std::vector<LogFile> rebuiltAgain = wait(bc->listLogFiles(0, std::numeric_limits<Version>::max(), false));
+	ASSERT(logFileNames(rebuiltAgain) == logFileNames(rebuilt));
+
+	wait(bc->deleteContainer());
+	return Void();
+}
+
 TEST_CASE("/backup/containers/url") {
 	if (!g_network->isSimulated()) {
 		const char* url = getenv("FDB_TEST_BACKUP_URL");
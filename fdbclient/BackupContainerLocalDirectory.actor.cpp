@@ -34,7 +34,8 @@ class BackupFile : public IBackupFile, ReferenceCounted<BackupFile> {
 public:
 	BackupFile(const std::string& fileName, Reference<IAsyncFile> file, const std::string& finalFullPath)
 	  : IBackupFile(fileName), m_file(file), m_writeOffset(0), m_finalFullPath(finalFullPath),
-	    m_blockSize(CLIENT_KNOBS->BACKUP_LOCAL_FILE_WRITE_BLOCK) {
+	    m_blockSize(CLIENT_KNOBS->BACKUP_LOCAL_FILE_WRITE_BLOCK),
+	    m_writeBehind(CLIENT_KNOBS->BACKUP_LOCAL_FILE_WRITE_BEHIND) {
 		if (BUGGIFY) {
 			m_blockSize = deterministicRandom()->randomInt(100, 20000);
 		}
@@ -70,11 +71,24 @@ public:
 
 		INJECT_BLOB_FAULT(http_request_failed, "BackupContainerLocalDirectory::flush");
 
-		return r;
+		// Let up to m_writeBehind writes continue while the caller appends more, and otherwise have it wait for the
+		// oldest. A failed write is reported by the flush that would wait for it, or by finish().
+		m_writes.push_back(r);
+		while (!m_writes.empty() && m_writes.front().isReady() && !m_writes.front().isError()) {
+			m_writes.pop_front();
+		}
+		if (m_writes.size() <= (size_t)m_writeBehind) {
+			return Void();
+		}
+		Future<Void> oldest = m_writes.front();
+		m_writes.pop_front();
+		return oldest;
 	}
 
 	ACTOR static Future<Void> finish_impl(Reference<BackupFile> f) {
 		wait(f->flush(f->m_buffer.size()));
+		wait(waitForAll(std::vector<Future<Void>>(f->m_writes.begin(), f->m_writes.end())));
+		f->m_writes.clear();
 		wait(f->m_file->truncate(f->size())); // Some IAsyncFile implementations extend in whole block sizes.
 		wait(f->m_file->sync());
 		std::string name = f->m_file->getFilename();
@@ -99,6 +113,8 @@ private:
 	int64_t m_writeOffset;
 	std::string m_finalFullPath;
 	int m_blockSize;
+	int m_writeBehind;
+	std::deque<Future<Void>> m_writes;
 };
 
 ACTOR static Future<BackupContainerFileSystem::FilesAndSizesT> listFiles_impl(std::string path, std::string m_path) {
@@ -280,7 +296,9 @@ Future<Reference<IAsyncFile>> BackupContainerLocalDirectory::readFile(const std:
 			int readAhead = deterministicRandom()->randomInt(0, 3);
 			int reads = deterministicRandom()->randomInt(1, 3);
 			int cacheSize = deterministicRandom()->randomInt(0, 3);
-			return Reference<IAsyncFile>(new AsyncFileReadAheadCache(fr, blockSize, readAhead, reads, cacheSize));
+			int maxReadAhead = readAhead + deterministicRandom()->randomInt(0, 4);
+			return Reference<IAsyncFile>(
+			    new AsyncFileReadAheadCache(fr, blockSize, readAhead, reads, cacheSize, maxReadAhead));
 		});
 	}
 
@@ -189,11 +189,15 @@ Future<Reference<IAsyncFile>> BackupContainerS3BlobStore::readFile(const std::st
 		f = makeReference<AsyncFileEncrypted>(f, AsyncFileEncrypted::Mode::READ_ONLY);
 	}
 	if (m_bstore->knobs.enable_read_cache) {
-		f = makeReference<AsyncFileReadAheadCache>(f,
-		                                           m_bstore->knobs.read_block_size,
-		                                           m_bstore->knobs.read_ahead_blocks,
-		                                           m_bstore->knobs.concurrent_reads_per_file,
-		                                           m_bstore->knobs.read_cache_blocks_per_file);
+		// Reading further ahead needs the cache to hold the blocks until they are read
+		int maxReadAhead = std::max(m_bstore->knobs.read_ahead_blocks, CLIENT_KNOBS->BLOBSTORE_READ_AHEAD_MAX_BLOCKS);
+		f = makeReference<AsyncFileReadAheadCache>(
+		    f,
+		    m_bstore->knobs.read_block_size,
+		    m_bstore->knobs.read_ahead_blocks,
+		    m_bstore->knobs.concurrent_reads_per_file,
+		    std::max(m_bstore->knobs.read_cache_blocks_per_file, maxReadAhead + 1),
+		    maxReadAhead);
 	}
 	return f;
 }
@@ -348,6 +348,7 @@ BlobCipherMetrics::BlobCipherMetrics()
     cipherKeyCacheExpired("CipherKeyCacheExpired", cc), latestCipherKeyCacheHit("LatestCipherKeyCacheHit", cc),
     latestCipherKeyCacheMiss("LatestCipherKeyCacheMiss", cc),
     latestCipherKeyCacheNeedsRefresh("LatestCipherKeyCacheNeedsRefresh", cc),
+    latestCipherKeyRefreshAhead("LatestCipherKeyRefreshAhead", cc),
     getBlobMetadataLatency("GetBlobMetadataLatency",
                            UID(),
                            FLOW_KNOBS->ENCRYPT_KEY_CACHE_LOGGING_INTERVAL,
@@ -597,7 +598,9 @@ Reference<BlobCipherKey> BlobCipherKeyIdCache::insertBaseCipherKey(const Encrypt
 			    .detail("BaseCipherKCV", baseCipherKCV);
 #endif
 
-			// Key is already present; nothing more to do.
+			// Key is already present; KMS may have extended its lifetime, as happens when the key gets refreshed
+			// ahead of its refreshAt without being rotated.
+			latestCipherKey->extendValidity(refreshAt, expireAt);
 			return latestCipherKey;
 		} else {
 			TraceEvent(SevInfo, "BlobCipherUpdatetBaseCipherKey")
@@ -962,6 +965,39 @@ void EncryptBlobCipherAes265Ctr::init() {
 	}
 }
 
+void EncryptBlobCipherAes265Ctr::resetIV(const uint8_t* cipherIV, const int ivLen) {
+	ASSERT_EQ(ivLen, AES_256_IV_LENGTH);
+	memcpy(&iv[0], cipherIV, ivLen);
+	// A null key keeps the key schedule already expanded in 'ctx'
+	if (EVP_EncryptInit_ex(ctx, nullptr, nullptr, nullptr, iv) != 1) {
+		throw encrypt_ops_error();
+	}
+}
+
+void EncryptBlobCipherAes265Ctr::computeHeaderAuthToken(const std::vector<std::pair<const uint8_t*, size_t>>& payload,
+                                                        uint8_t* digestBuf) {
+	ASSERT(headerCipherKeyOpt.present() && headerCipherKeyOpt.get().isValid());
+
+	const int authTokenSz = getEncryptHeaderAuthTokenSize(authTokenAlgo);
+	if (authTokenAlgo == EncryptAuthTokenAlgo::ENCRYPT_HEADER_AUTH_TOKEN_ALGO_HMAC_SHA) {
+		if (!hmacGen) {
+			hmacGen =
+			    std::make_unique<HmacSha256DigestGen>(headerCipherKeyOpt.get()->rawCipher(), AES_256_KEY_LENGTH);
+		}
+		unsigned int digestLen = hmacGen->digest(payload, digestBuf, authTokenSz);
+		ASSERT_EQ(digestLen, authTokenSz);
+	} else if (authTokenAlgo == EncryptAuthTokenAlgo::ENCRYPT_HEADER_AUTH_TOKEN_ALGO_AES_CMAC) {
+		if (!cmacGen) {
+			cmacGen =
+			    std::make_unique<Aes256CmacDigestGen>(headerCipherKeyOpt.get()->rawCipher(), AES_256_KEY_LENGTH);
+		}
+		size_t digestLen = cmacGen->digest(payload, digestBuf, authTokenSz);
+		ASSERT_EQ(digestLen, authTokenSz);
+	} else {
+		throw not_implemented();
+	}
+}
+
 template <class Params>
 void EncryptBlobCipherAes265Ctr::setCipherAlgoHeaderWithAuthV1(const uint8_t* ciphertext,
                                                                const int ciphertextLen,
@@ -986,12 +1022,8 @@ void EncryptBlobCipherAes265Ctr::setCipherAlgoHeaderWithAuthV1(const uint8_t* ci
 	uint8_t computed[Params::authTokenSize]{
 		0,
 	};
-	computeAuthToken({ { ciphertext, ciphertextLen }, { serialized.begin(), serialized.size() } },
-	                 headerCipherKeyOpt.get()->rawCipher(),
-	                 AES_256_KEY_LENGTH,
-	                 &computed[0],
-	                 (EncryptAuthTokenAlgo)flags.authTokenAlgo,
-	                 AUTH_TOKEN_MAX_SIZE);
+	ASSERT_EQ(flags.authTokenAlgo, authTokenAlgo);
+	computeHeaderAuthToken({ { ciphertext, ciphertextLen }, { serialized.begin(), serialized.size() } }, &computed[0]);
 	memcpy(&algoHeader.authToken[0], &computed[0], Params::authTokenSize);
 
 	// Populate headerRef algorithm specific header details
@@ -1091,13 +1123,9 @@ void EncryptBlobCipherAes265Ctr::updateEncryptHeader(const uint8_t* ciphertext,
 		// Populate header authToken details
 		ASSERT_EQ(header->flags.authTokenMode, EncryptAuthTokenMode::ENCRYPT_HEADER_AUTH_TOKEN_MODE_SINGLE);
 
-		computeAuthToken({ { ciphertext, ciphertextLen },
-		                   { reinterpret_cast<const uint8_t*>(header), sizeof(BlobCipherEncryptHeader) } },
-		                 headerCipherKeyOpt.get()->rawCipher(),
-		                 AES_256_KEY_LENGTH,
-		                 &header->singleAuthToken.authToken[0],
-		                 (EncryptAuthTokenAlgo)header->flags.authTokenAlgo,
-		                 AUTH_TOKEN_MAX_SIZE);
+		computeHeaderAuthToken({ { ciphertext, ciphertextLen },
+		                         { reinterpret_cast<const uint8_t*>(header), sizeof(BlobCipherEncryptHeader) } },
+		                       &header->singleAuthToken.authToken[0]);
 	}
 }
 
@@ -1131,9 +1159,8 @@ StringRef EncryptBlobCipherAes265Ctr::encrypt(const uint8_t* plaintext,
 			throw encrypt_ops_error();
 		}
 
-		// EVP_CIPHER_CTX_reset(ctx) is called after EncryptUpdate() to make sure the same encryptor
-		// `EncryptBlobCipherAes265Ctr` could be reused to encrypt multiple text. Otherwise,
-		// ctx = EVP_CIPHER_CTX_new() is required before calling encrypt().
+		// The counter stream continues past this text, so reusing the encryptor for another text requires
+		// resetIV() first; otherwise the header's IV would not describe the next ciphertext.
 	} else {
 		memcpy(ciphertext, plaintext, plaintextLen);
 	}
@@ -1765,6 +1792,10 @@ unsigned int HmacSha256DigestGen::digest(const std::vector<std::pair<const uint8
 	if (HMAC_Final(ctx, buf, &digestLen) != 1) {
 		throw encrypt_ops_error();
 	}
+	// Re-arm with the same key, so that the generator can produce the next digest
+	if (HMAC_Init_ex(ctx, nullptr, 0, nullptr, nullptr) != 1) {
+		throw encrypt_ops_error();
+	}
 
 	CODE_PROBE(true, "HMAC_SHA Digest generation");
 
@@ -1798,6 +1829,10 @@ size_t Aes256CmacDigestGen::digest(const std::vector<std::pair<const uint8_t*, s
 	if (!CMAC_Final(ctx, digest, &ret)) {
 		throw encrypt_ops_error();
 	}
+	// Re-arm with the same key, so that the generator can produce the next digest
+	if (!CMAC_Init(ctx, nullptr, 0, nullptr, nullptr)) {
+		throw encrypt_ops_error();
+	}
 
 	return ret;
 }
@@ -2215,6 +2250,42 @@ void testKeyCacheRefreshExpireCipherKey(DomainKeyMap& domainKeyMap, const int ma
 	ASSERT_EQ(BlobCipherMetrics::getInstance()->cipherKeyCacheExpired.getValue(), expectedExpiredKeys);
 }
 
+// Re-inserting the latest key of a domain before it needs a refresh, as a refresh ahead of refreshAt does when KMS has
+// not rotated the key, keeps serving the same key and extends its lifetime.
+void testKeyCacheRefreshAheadCipherKey(const int maxDomainId) {
+	TraceEvent("BlobCipherCacheRefreshAheadCipherKey");
+
+	Reference<BlobCipherKeyCache> cipherKeyCache = BlobCipherKeyCache::getInstance();
+	EncryptCipherDomainId domId = maxDomainId + 2;
+
+	Standalone<StringRef> baseCipher = makeString(4);
+	deterministicRandom()->randomBytes(mutateString(baseCipher), 4);
+	EncryptCipherKeyCheckValue baseCipherKCV = Sha256KCV().computeKCV(baseCipher.begin(), baseCipher.size());
+
+	int64_t refreshAt = now() + 20;
+	int64_t expireAt = now() + 100;
+	Reference<BlobCipherKey> inserted = cipherKeyCache->insertCipherKey(
+	    domId, 1, baseCipher.begin(), baseCipher.size(), baseCipherKCV, refreshAt, expireAt);
+	Reference<BlobCipherKey> cipher = cipherKeyCache->getLatestCipherKey(domId);
+	ASSERT(cipher.isValid());
+	ASSERT(!cipher->needsRefresh());
+	ASSERT(cipher->needsRefreshWithin(30));
+	ASSERT(!cipher->needsRefreshWithin(10));
+
+	Reference<BlobCipherKey> refreshed = cipherKeyCache->insertCipherKey(
+	    domId, 1, baseCipher.begin(), baseCipher.size(), baseCipherKCV, refreshAt + 600, expireAt + 600);
+	ASSERT_EQ(refreshed->getSalt(), inserted->getSalt());
+	ASSERT_EQ(refreshed->getRefreshAtTS(), refreshAt + 600);
+	ASSERT_EQ(refreshed->getExpireAtTS(), expireAt + 600);
+	ASSERT(!refreshed->needsRefreshWithin(30));
+
+	// An older reply never shortens the lifetime
+	cipherKeyCache->insertCipherKey(domId, 1, baseCipher.begin(), baseCipher.size(), baseCipherKCV, refreshAt, expireAt);
+	ASSERT_EQ(cipherKeyCache->getLatestCipherKey(domId)->getRefreshAtTS(), refreshAt + 600);
+
+	cipherKeyCache->resetEncryptDomainId(domId);
+}
+
 void testNoAuthMode(const int minDomainId) {
 	TraceEvent("TestNoAuthModeStart");
 
@@ -3055,6 +3126,59 @@ void testEncryptInplaceSingleAuthMode(const int minDomainId) {
 	TraceEvent("BlobCipherTestEncryptInplaceSingleAuthEnd").detail("Mode", authAlgoStr);
 }
 
+template <class Params>
+void testEncryptorReuseSingleAuthMode(const int minDomainId) {
+	constexpr bool isHmac = std::is_same_v<Params, AesCtrWithHmacParams>;
+	const std::string authAlgoStr = isHmac ? "HMAC-SHA" : "AES-CMAC";
+	const EncryptAuthTokenAlgo authAlgo = isHmac ? EncryptAuthTokenAlgo::ENCRYPT_HEADER_AUTH_TOKEN_ALGO_HMAC_SHA
+	                                             : EncryptAuthTokenAlgo::ENCRYPT_HEADER_AUTH_TOKEN_ALGO_AES_CMAC;
+
+	TraceEvent("BlobCipherTestEncryptorReuseSingleAuthStart").detail("Mode", authAlgoStr);
+
+	Reference<BlobCipherKeyCache> cipherKeyCache = BlobCipherKeyCache::getInstance();
+	Reference<BlobCipherKey> cipherKey = cipherKeyCache->getLatestCipherKey(minDomainId);
+	Reference<BlobCipherKey> headerCipherKey = cipherKeyCache->getLatestCipherKey(ENCRYPT_HEADER_DOMAIN_ID);
+	Arena arena;
+
+	// One encryptor for many small buffers, each under an IV of its own, must produce the same ciphertext and header
+	// as an encryptor per buffer
+	EncryptBlobCipherAes265Ctr reused(cipherKey,
+	                                  headerCipherKey,
+	                                  EncryptAuthTokenMode::ENCRYPT_HEADER_AUTH_TOKEN_MODE_SINGLE,
+	                                  authAlgo,
+	                                  BlobCipherMetrics::TEST);
+	for (int i = 0; i < 20; i++) {
+		const int bufLen = deterministicRandom()->randomInt(1, 200);
+		uint8_t orgData[bufLen];
+		deterministicRandom()->randomBytes(&orgData[0], bufLen);
+		uint8_t iv[AES_256_IV_LENGTH];
+		deterministicRandom()->randomBytes(&iv[0], AES_256_IV_LENGTH);
+
+		reused.resetIV(iv, AES_256_IV_LENGTH);
+		BlobCipherEncryptHeaderRef headerRef;
+		StringRef encryptedBuf = reused.encrypt(&orgData[0], bufLen, &headerRef, arena);
+
+		EncryptBlobCipherAes265Ctr fresh(cipherKey,
+		                                 headerCipherKey,
+		                                 iv,
+		                                 AES_256_IV_LENGTH,
+		                                 EncryptAuthTokenMode::ENCRYPT_HEADER_AUTH_TOKEN_MODE_SINGLE,
+		                                 authAlgo,
+		                                 BlobCipherMetrics::TEST);
+		BlobCipherEncryptHeaderRef freshHeaderRef;
+		StringRef freshBuf = fresh.encrypt(&orgData[0], bufLen, &freshHeaderRef, arena);
+		ASSERT(encryptedBuf == freshBuf);
+		ASSERT(BlobCipherEncryptHeaderRef::toStringRef(headerRef) ==
+		       BlobCipherEncryptHeaderRef::toStringRef(freshHeaderRef));
+
+		DecryptBlobCipherAes256Ctr decryptor(cipherKey, headerCipherKey, headerRef.getIV(), BlobCipherMetrics::TEST);
+		StringRef decryptedBuf = decryptor.decrypt(encryptedBuf.begin(), bufLen, headerRef, arena);
+		ASSERT_EQ(memcmp(decryptedBuf.begin(), &orgData[0], bufLen), 0);
+	}
+
+	TraceEvent("BlobCipherTestEncryptorReuseSingleAuthEnd").detail("Mode", authAlgoStr);
+}
+
 void testConfigurableEncryptionInvalidEncryptionKeyNoAuth(const int minDomainId) {
 	TraceEvent("TestConfigurableEncryptionInvalidEncryptKeyNoAuthStart");
 
@@ -3218,6 +3342,7 @@ TEST_CASE("/blobCipher") {
 
 	testKeyCacheEssentials(domainKeyMap, minDomainId, maxDomainId, minBaseCipherKeyId);
 	testKeyCacheRefreshExpireCipherKey(domainKeyMap, maxDomainId);
+	testKeyCacheRefreshAheadCipherKey(maxDomainId);
 
 	testConfigurableEncryptionBlobCipherHeaderFlagsV1Ser();
 	testConfigurableEncryptionAesCtrNoAuthV1Ser(minDomainId);
@@ -3243,6 +3368,8 @@ TEST_CASE("/blobCipher") {
 	testEncryptInplaceNoAuthMode(minDomainId);
 	testEncryptInplaceSingleAuthMode<AesCtrWithHmacParams>(minDomainId);
 	testEncryptInplaceSingleAuthMode<AesCtrWithCmacParams>(minDomainId);
+	testEncryptorReuseSingleAuthMode<AesCtrWithHmacParams>(minDomainId);
+	testEncryptorReuseSingleAuthMode<AesCtrWithCmacParams>(minDomainId);
 
 	testKeyCacheCleanup(minDomainId, maxDomainId);
 
@@ -0,0 +1,223 @@
+/*
+ * BlobGranuleFileCache.actor.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbclient/BlobGranuleFileCache.h"
+#include "fdbclient/Knobs.h"
+#include "flow/IAsyncFile.h"
+#include "flow/Platform.h"
+#include "flow/UnitTest.h"
+#include "flow/xxhash.h"
+#include "flow/actorcompiler.h" // This must be the last #include.
+
+namespace {
+
+ACTOR Future<Void> deleteCachedFile(std::string path) {
+	try {
+		wait(IAsyncFileSystem::filesystem()->deleteFile(path, false));
+	} catch (Error& e) {
+		if (e.code() == error_code_actor_cancelled) {
+			throw;
+		}
+		TraceEvent(SevWarn, "BlobGranuleFileCacheDeleteError").error(e).detail("Path", path);
+	}
+	return Void();
+}
+
+ACTOR Future<Optional<Standalone<StringRef>>> getCachedFile(BlobGranuleFileCache* self, std::string filename) {
+	auto it = self->entries.find(filename);
+	if (it == self->entries.end()) {
+		++self->misses;
+		return Optional<Standalone<StringRef>>();
+	}
+	self->lru.splice(self->lru.end(), self->lru, it->second.lruPosition);
+	state BlobGranuleFileCache::Entry entry = it->second;
+
+	try {
+		state Reference<IAsyncFile> file = wait(IAsyncFileSystem::filesystem()->open(
+		    entry.path, IAsyncFile::OPEN_NO_AIO | IAsyncFile::OPEN_READONLY | IAsyncFile::OPEN_UNCACHED, 0));
+		state Standalone<StringRef> contents = makeString(entry.bytes);
+		int readSize = wait(file->read(mutateString(contents), entry.bytes, 0));
+		if (readSize == entry.bytes && XXH3_64bits(contents.begin(), contents.size()) == entry.checksum) {
+			++self->hits;
+			return contents;
+		}
+		++self->checksumFailures;
+		TraceEvent(SevWarnAlways, "BlobGranuleFileCacheChecksumMismatch")
+		    .detail("File", filename)
+		    .detail("Path", entry.path)
+		    .detail("Bytes", entry.bytes)
+		    .detail("ReadBytes", readSize);
+	} catch (Error& e) {
+		if (e.code() == error_code_actor_cancelled) {
+			throw;
+		}
+		++self->readErrors;
+		TraceEvent(SevWarn, "BlobGranuleFileCacheReadError")
+		    .error(e)
+		    .detail("File", filename)
+		    .detail("Path", entry.path);
+	}
+
+	// don't use a bad copy again, unless it was already replaced while being read
+	++self->misses;
+	auto current = self->entries.find(filename);
+	if (current != self->entries.end() && current->second.path == entry.path) {
+		self->remove(filename);
+	}
+	return Optional<Standalone<StringRef>>();
+}
+
+ACTOR Future<Void> addCachedFile(BlobGranuleFileCache* self, std::string filename, Standalone<StringRef> contents) {
+	state std::string path =
+	    joinPath(self->directory, deterministicRandom()->randomUniqueID().toString() + ".bgfile");
+	try {
+		state Reference<IAsyncFile> file = wait(IAsyncFileSystem::filesystem()->open(
+		    path,
+		    IAsyncFile::OPEN_NO_AIO | IAsyncFile::OPEN_ATOMIC_WRITE_AND_CREATE | IAsyncFile::OPEN_CREATE |
+		        IAsyncFile::OPEN_READWRITE | IAsyncFile::OPEN_UNCACHED,
+		    0600));
+		wait(file->write(contents.begin(), contents.size(), 0));
+		wait(file->sync());
+	} catch (Error& e) {
+		if (e.code() == error_code_actor_cancelled) {
+			throw;
+		}
+		self->adding.erase(filename);
+		TraceEvent(SevWarn, "BlobGranuleFileCacheWriteError").error(e).detail("File", filename).detail("Path", path);
+		return Void();
+	}
+	self->adding.erase(filename);
+
+	while (!self->lru.empty() && self->cachedBytes + contents.size() > self->capacityBytes) {
+		++self->evictions;
+		self->remove(self->lru.front());
+	}
+
+	BlobGranuleFileCache::Entry& entry = self->entries[filename];
+	entry.path = path;
+	entry.bytes = contents.size();
+	entry.checksum = XXH3_64bits(contents.begin(), contents.size());
+	entry.lruPosition = self->lru.insert(self->lru.end(), filename);
+	self->cachedBytes += entry.bytes;
+	++self->filesAdded;
+	self->bytesAdded += entry.bytes;
+
+	return Void();
+}
+
+} // namespace
+
+BlobGranuleFileCache::BlobGranuleFileCache(std::string const& directory, int64_t capacityBytes)
+  : directory(directory), capacityBytes(capacityBytes), cc("BlobGranuleFileCache"), hits("Hits", cc),
+    misses("Misses", cc), checksumFailures("ChecksumFailures", cc), readErrors("ReadErrors", cc),
+    filesAdded("FilesAdded", cc), bytesAdded("BytesAdded", cc), evictions("Evictions", cc) {
+	specialCounter(cc, "CachedFiles", [this]() { return this->entries.size(); });
+	specialCounter(cc, "CachedBytes", [this]() { return this->cachedBytes; });
+	logger = cc.traceCounters("BlobGranuleFileCacheMetrics", UID(), CLIENT_KNOBS->BLOBSTORE_STATS_LOGGING_INTERVAL);
+}
+
+Future<Optional<Standalone<StringRef>>> BlobGranuleFileCache::get(std::string const& filename) {
+	return getCachedFile(this, filename);
+}
+
+void BlobGranuleFileCache::add(std::string const& filename, Standalone<StringRef> const& contents) {
+	if (contents.size() > capacityBytes || entries.count(filename) || !adding.insert(filename).second) {
+		return;
+	}
+	actors.add(addCachedFile(this, filename, contents));
+}
+
+void BlobGranuleFileCache::remove(std::string const& filename) {
+	auto it = entries.find(filename);
+	if (it == entries.end()) {
+		return;
+	}
+	cachedBytes -= it->second.bytes;
+	lru.erase(it->second.lruPosition);
+	actors.add(deleteCachedFile(it->second.path));
+	entries.erase(it);
+}
+
+BlobGranuleFileCache* BlobGranuleFileCache::processCache() {
+	return static_cast<BlobGranuleFileCache*>(g_network->global(INetwork::enBlobGranuleFileCache));
+}
+
+void BlobGranuleFileCache::enableProcessCache(std::string const& directory, int64_t capacityBytes) {
+	if (processCache() != nullptr) {
+		return;
+	}
+	// the index of cached files is only kept in memory, so files from a previous process are unreachable
+	platform::eraseDirectoryRecursive(directory);
+	platform::createDirectory(directory);
+	TraceEvent("BlobGranuleFileCacheEnabled").detail("Directory", directory).detail("CapacityBytes", capacityBytes);
+	g_network->setGlobal(INetwork::enBlobGranuleFileCache, new BlobGranuleFileCache(directory, capacityBytes));
+}
+
+static Standalone<StringRef> testFile(char c, int bytes) {
+	Standalone<StringRef> contents = makeString(bytes);
+	memset(mutateString(contents), c, bytes);
+	return contents;
+}
+
+TEST_CASE("/blobgranule/files/localCache") {
+	state std::string directory = joinPath(params.getDataDir(), "bgfilecache");
+	platform::eraseDirectoryRecursive(directory);
+	platform::createDirectory(directory);
+	state BlobGranuleFileCache cache(directory, 250);
+
+	Optional<Standalone<StringRef>> missing = wait(cache.get("a"));
+	ASSERT(!missing.present());
+
+	cache.add("a", testFile('a', 100));
+	cache.add("b", testFile('b', 100));
+	// larger than the whole cache
+	cache.add("c", testFile('c', 300));
+	loop {
+		if (cache.adding.empty()) {
+			break;
+		}
+		wait(delay(0.1));
+	}
+	ASSERT(cache.entries.size() == 2);
+
+	state Optional<Standalone<StringRef>> a = wait(cache.get("a"));
+	ASSERT(a.present() && a.get() == testFile('a', 100));
+
+	// b is now the least recently used, so it is evicted to make space for d
+	cache.add("d", testFile('d', 100));
+	loop {
+		if (cache.adding.empty()) {
+			break;
+		}
+		wait(delay(0.1));
+	}
+	ASSERT(cache.entries.count("a") && !cache.entries.count("b") && cache.entries.count("d"));
+	ASSERT(cache.cachedBytes == 200);
+	ASSERT(cache.evictions.getValue() == 1);
+
+	// a corrupted copy is detected and dropped
+	cache.entries["d"].checksum++;
+	Optional<Standalone<StringRef>> d = wait(cache.get("d"));
+	ASSERT(!d.present());
+	ASSERT(!cache.entries.count("d"));
+	ASSERT(cache.checksumFailures.getValue() == 1);
+
+	return Void();
+}
@@ -42,6 +42,7 @@
 #include <cstring>
 #include <fstream> // for perf microbenchmark
 #include <limits>
+#include <thread>
 #include <vector>
 
 #define BG_READ_DEBUG false
@@ -53,8 +54,13 @@
 // File Format stuff
 
 // Version info for file format of chunked files.
-uint16_t LATEST_BG_FORMAT_VERSION = 1;
+uint16_t LATEST_BG_FORMAT_VERSION = 2;
 uint16_t MIN_SUPPORTED_BG_FORMAT_VERSION = 1;
+// Files of this version and later end with a fixed size footer holding the size of the index at the head of the file,
+// so a reader can fetch the index and then only the chunks it needs. Earlier readers ignore the trailing bytes.
+uint16_t BG_FORMAT_VERSION_INDEX_FOOTER = 2;
+const uint64_t BG_FILE_FOOTER_MAGIC = 0x7265746f6f664742; // "BGfooter"
+const int BG_FILE_FOOTER_BYTES = sizeof(uint32_t) + sizeof(uint64_t);
 
 // TODO combine with SystemData? These don't actually have to match though
 
@@ -588,7 +594,8 @@ struct IndexedBlobGranuleFile {
 	StringRef fileBytes;
 
 	void init(uint8_t fType, const Optional<BlobGranuleCipherKeysCtx> cipherKeysCtx) {
-		formatVersion = LATEST_BG_FORMAT_VERSION;
+		// Keep writing the previous version until every reader understands the footer
+		formatVersion = CLIENT_KNOBS->BG_WRITE_INDEX_FOOTER ? LATEST_BG_FORMAT_VERSION : 1;
 		fileType = fType;
 		chunkStartOffset = -1;
 	}
@@ -707,7 +714,8 @@ Value serializeFileFromChunks(Standalone<IndexedBlobGranuleFile>& file,
 	// TODO: write this directly to stream to avoid extra copy?
 	Arena ret;
 
-	size_t size = indexSize + previousChunkBytes;
+	bool writeFooter = file.formatVersion >= BG_FORMAT_VERSION_INDEX_FOOTER;
+	size_t size = indexSize + previousChunkBytes + (writeFooter ? BG_FILE_FOOTER_BYTES : 0);
 	uint8_t* buffer = new (ret) uint8_t[size];
 	uint8_t* bufferStart = buffer;
 
@@ -721,11 +729,123 @@ Value serializeFileFromChunks(Standalone<IndexedBlobGranuleFile>& file,
 		}
 		buffer = it.copyTo(buffer);
 	}
+	if (writeFooter) {
+		uint32_t footerIndexSize = indexSize;
+		memcpy(buffer, &footerIndexSize, sizeof(uint32_t));
+		memcpy(buffer + sizeof(uint32_t), &BG_FILE_FOOTER_MAGIC, sizeof(uint64_t));
+		buffer += BG_FILE_FOOTER_BYTES;
+	}
 	ASSERT(size == buffer - bufferStart);
 
 	return Standalone<StringRef>(StringRef(bufferStart, size), ret);
 }
 
+struct SnapshotFileBuilder::Impl {
+	Standalone<StringRef> fileName;
+	int targetChunkBytes;
+	Optional<CompressionFilter> compressFilter;
+	Optional<BlobGranuleCipherKeysCtx> cipherKeysCtx;
+	bool isSnapshotSorted;
+
+	Standalone<IndexedBlobGranuleFile> file;
+	std::vector<Value> chunks;
+	Standalone<GranuleSnapshot> currentChunk;
+	size_t currentChunkBytesEstimate = 0;
+	size_t previousChunkBytes = 0;
+	// exclusive upper bound of the keys in the chunks written so far
+	Key chunksEnd;
+
+	void addChunkToIndex(const KeyRef& firstKey, const Value& chunkBytes) {
+		// TODO remove validation
+		if (!file.indexBlockRef.block.children.empty() && isSnapshotSorted) {
+			ASSERT(file.indexBlockRef.block.children.back().key < firstKey);
+			ASSERT(chunksEnd <= firstKey);
+		}
+		chunks.push_back(chunkBytes);
+		file.indexBlockRef.block.children.emplace_back_deep(file.arena(), firstKey, previousChunkBytes);
+
+		if (BG_ENCRYPT_COMPRESS_DEBUG) {
+			TraceEvent(SevDebug, "ChunkSize")
+			    .detail("ChunkBytes", chunkBytes.size())
+			    .detail("PrvChunkBytes", previousChunkBytes);
+		}
+
+		previousChunkBytes += chunkBytes.size();
+	}
+
+	void flushChunk() {
+		if (currentChunk.empty()) {
+			return;
+		}
+		Value serialized = BinaryWriter::toValue(currentChunk, IncludeVersion(ProtocolVersion::withBlobGranuleFile()));
+		Value chunkBytes =
+		    IndexBlobGranuleFileChunkRef::toBytes(cipherKeysCtx, compressFilter, serialized, file.arena());
+		addChunkToIndex(currentChunk.begin()->key, chunkBytes);
+		chunksEnd = keyAfter(currentChunk.back().key);
+		currentChunkBytesEstimate = 0;
+		currentChunk = Standalone<GranuleSnapshot>();
+	}
+};
+
+SnapshotFileBuilder::SnapshotFileBuilder(const Standalone<StringRef>& fileNameRef,
+                                         int targetChunkBytes,
+                                         Optional<CompressionFilter> compressFilter,
+                                         Optional<BlobGranuleCipherKeysCtx> cipherKeysCtx,
+                                         bool isSnapshotSorted)
+  : impl(std::make_unique<Impl>()) {
+	impl->fileName = fileNameRef;
+	impl->targetChunkBytes = targetChunkBytes;
+	impl->compressFilter = compressFilter;
+	impl->cipherKeysCtx = cipherKeysCtx;
+	impl->isSnapshotSorted = isSnapshotSorted;
+	impl->file.init(SNAPSHOT_FILE_TYPE, cipherKeysCtx);
+	impl->chunks.push_back(Value()); // dummy value for index block
+}
+
+SnapshotFileBuilder::~SnapshotFileBuilder() = default;
+
+void SnapshotFileBuilder::add(const KeyValueRef& kv) {
+	// TODO REMOVE sanity check
+	if (impl->isSnapshotSorted && !impl->currentChunk.empty()) {
+		ASSERT(impl->currentChunk.back().key < kv.key);
+	}
+
+	impl->currentChunk.push_back_deep(impl->currentChunk.arena(), kv);
+	impl->currentChunkBytesEstimate += kv.expectedSize();
+	rows++;
+	logicalBytes += kv.expectedSize();
+
+	if (impl->currentChunkBytesEstimate >= impl->targetChunkBytes) {
+		impl->flushChunk();
+	}
+}
+
+void SnapshotFileBuilder::addSerializedChunk(const KeyRef& firstKey,
+                                             const KeyRef& endKey,
+                                             const StringRef& chunkBytes,
+                                             int64_t chunkLogicalBytes) {
+	ASSERT(!impl->cipherKeysCtx.present());
+	impl->flushChunk();
+	impl->addChunkToIndex(firstKey, Value(chunkBytes));
+	impl->chunksEnd = endKey;
+	logicalBytes += chunkLogicalBytes;
+	serializedChunksReused++;
+}
+
+Value SnapshotFileBuilder::finish() {
+	impl->flushChunk();
+	// push back dummy last chunk to get last chunk size, and to know last key in last block without having to read it
+	if (!impl->file.indexBlockRef.block.children.empty()) {
+		impl->file.indexBlockRef.block.children.emplace_back_deep(
+		    impl->file.arena(), impl->chunksEnd, impl->previousChunkBytes);
+	}
+
+	Value serialized =
+	    serializeFileFromChunks(impl->file, impl->cipherKeysCtx, impl->chunks, impl->previousChunkBytes);
+	impl->chunks.clear();
+	return serialized;
+}
+
 // TODO: this should probably be in actor file with yields? - move writing logic to separate actor file in server?
 // TODO: optimize memory copying
 // TODO: sanity check no oversized files
@@ -745,58 +865,12 @@ Value serializeChunkedSnapshot(const Standalone<StringRef>& fileNameRef,
 
 	CODE_PROBE(compressFilter.present(), "serializing compressed snapshot file");
 	CODE_PROBE(cipherKeysCtx.present(), "serializing encrypted snapshot file");
-	Standalone<IndexedBlobGranuleFile> file;
-
-	file.init(SNAPSHOT_FILE_TYPE, cipherKeysCtx);
-
-	size_t currentChunkBytesEstimate = 0;
-	size_t previousChunkBytes = 0;
-
-	std::vector<Value> chunks;
-	chunks.push_back(Value()); // dummy value for index block
-	Standalone<GranuleSnapshot> currentChunk;
-
-	for (int i = 0; i < snapshot.size(); i++) {
-		// TODO REMOVE sanity check
-		if (i > 0 && isSnapshotSorted) {
-			ASSERT(snapshot[i - 1].key < snapshot[i].key);
-		}
-
-		currentChunk.push_back_deep(currentChunk.arena(), snapshot[i]);
-		currentChunkBytesEstimate += snapshot[i].expectedSize();
-
-		if (currentChunkBytesEstimate >= targetChunkBytes || i == snapshot.size() - 1) {
-			Value serialized =
-			    BinaryWriter::toValue(currentChunk, IncludeVersion(ProtocolVersion::withBlobGranuleFile()));
-			Value chunkBytes =
-			    IndexBlobGranuleFileChunkRef::toBytes(cipherKeysCtx, compressFilter, serialized, file.arena());
-			chunks.push_back(chunkBytes);
-			// TODO remove validation
-			if (!file.indexBlockRef.block.children.empty() && isSnapshotSorted) {
-				ASSERT(file.indexBlockRef.block.children.back().key < currentChunk.begin()->key);
-			}
-			file.indexBlockRef.block.children.emplace_back_deep(
-			    file.arena(), currentChunk.begin()->key, previousChunkBytes);
-
-			if (BG_ENCRYPT_COMPRESS_DEBUG) {
-				TraceEvent(SevDebug, "ChunkSize")
-				    .detail("ChunkBytes", chunkBytes.size())
-				    .detail("PrvChunkBytes", previousChunkBytes);
-			}
 
-			previousChunkBytes += chunkBytes.size();
-			currentChunkBytesEstimate = 0;
-			currentChunk = Standalone<GranuleSnapshot>();
-		}
+	SnapshotFileBuilder builder(fileNameRef, targetChunkBytes, compressFilter, cipherKeysCtx, isSnapshotSorted);
+	for (auto& kv : snapshot) {
+		builder.add(kv);
 	}
-	ASSERT(currentChunk.empty());
-	// push back dummy last chunk to get last chunk size, and to know last key in last block without having to read it
-	if (!snapshot.empty()) {
-		file.indexBlockRef.block.children.emplace_back_deep(
-		    file.arena(), keyAfter(snapshot.back().key), previousChunkBytes);
-	}
-
-	return serializeFileFromChunks(file, cipherKeysCtx, chunks, previousChunkBytes);
+	return builder.finish();
 }
 
 // TODO: use redwood prefix trick to optimize cpu comparison
@@ -868,6 +942,46 @@ static Standalone<VectorRef<ParsedDeltaBoundaryRef>> loadSnapshotFile(
 	return results;
 }
 
+Optional<int64_t> getBlobGranuleFileIndexBytes(const StringRef& footer) {
+	if (footer.size() != BG_FILE_FOOTER_BYTES) {
+		return {};
+	}
+	uint64_t magic;
+	memcpy(&magic, footer.begin() + sizeof(uint32_t), sizeof(uint64_t));
+	if (magic != BG_FILE_FOOTER_MAGIC) {
+		return {};
+	}
+	uint32_t indexBytes;
+	memcpy(&indexBytes, footer.begin(), sizeof(uint32_t));
+	return indexBytes;
+}
+
+Optional<std::pair<int64_t, int64_t>> getBlobGranuleFileChunkRange(const StringRef& indexData,
+                                                                   const KeyRangeRef& keyRange,
+                                                                   Optional<BlobGranuleCipherKeysCtx> cipherKeysCtx) {
+	Standalone<IndexedBlobGranuleFile> file = IndexedBlobGranuleFile::fromFileBytes(indexData, cipherKeysCtx);
+	ASSERT(file.formatVersion >= BG_FORMAT_VERSION_INDEX_FOOTER);
+	ASSERT(file.chunkStartOffset == indexData.size());
+
+	auto& children = file.indexBlockRef.block.children;
+	if (children.empty()) {
+		return {};
+	}
+
+	// same block selection as loadSnapshotFile and loadChunkedDeltaFile. The blocks read are contiguous in the file.
+	ChildBlockPointerRef* startBlock = file.findStartBlock(keyRange.begin);
+	if (startBlock == children.end() - 1 || keyRange.end <= startBlock->key) {
+		return {};
+	}
+	ChildBlockPointerRef* endBlock = startBlock + 1;
+	while (endBlock != children.end() - 1 && endBlock->key < keyRange.end) {
+		endBlock++;
+	}
+
+	return std::pair<int64_t, int64_t>(file.chunkStartOffset + startBlock->offset,
+	                                   file.chunkStartOffset + endBlock->offset);
+}
+
 typedef std::map<Key, Standalone<DeltaBoundaryRef>> SortedDeltasT;
 
 // FIXME: optimize all of this with common prefix comparison stuff
@@ -1320,37 +1434,64 @@ Standalone<VectorRef<ParsedDeltaBoundaryRef>> sortMemoryDeltas(const GranuleDelt
 	return deltas;
 }
 
-// does a sorted merge of the delta streams.
-// In terms of write precedence, streams[i] < streams[i+1]
-// Handles range clears by tracking the active clears when they start
-struct MergeStreamNext {
-	KeyRef key;
-	int16_t streamIdx;
-	int dataIdx;
+// A sorted stream of delta boundaries. Each boundary holds the op for exactly its key, and whether the range from
+// there up to the next boundary is cleared; startClear means the range before the first boundary is cleared.
+struct DeltaStreamSpan {
+	const ParsedDeltaBoundaryRef* begin;
+	const ParsedDeltaBoundaryRef* end;
+	bool startClear;
 };
 
-// the sort order is logically lower by key, and then higher by streamIdx
-// because a priority queue is backwards, we invert that
-struct OrderForPriorityQueue {
-	int commonPrefixLen;
-	OrderForPriorityQueue(int commonPrefixLen) : commonPrefixLen(commonPrefixLen) {}
-
-	bool operator()(MergeStreamNext const& a, MergeStreamNext const& b) const {
-		int keyCmp = a.key.compareSuffix(b.key, commonPrefixLen);
-		if (keyCmp != 0) {
-			return keyCmp > 0; // reverse
-		}
-		return a.streamIdx < b.streamIdx;
+// Walks the union of the boundaries of two streams in a single linear pass, calling emit(boundary, inLower, fromUpper)
+// with the effective boundary at each key: upper's op if it has one there, a clear if upper is clearing over the key,
+// and otherwise lower's op. In terms of write precedence, lower < upper.
+template <class Emit>
+static void mergeTwoDeltaStreams(DeltaStreamSpan lower, DeltaStreamSpan upper, int prefixLen, Emit&& emit) {
+	bool lowerClear = lower.startClear;
+	bool upperClear = upper.startClear;
+	while (lower.begin != lower.end || upper.begin != upper.end) {
+		int keyCmp = lower.begin == lower.end   ? 1
+		             : upper.begin == upper.end ? -1
+		                                        : lower.begin->key.compareSuffix(upper.begin->key, prefixLen);
+		const ParsedDeltaBoundaryRef* l = keyCmp <= 0 ? lower.begin++ : nullptr;
+		const ParsedDeltaBoundaryRef* u = keyCmp >= 0 ? upper.begin++ : nullptr;
+
+		ParsedDeltaBoundaryRef merged(l ? l->key : u->key, false);
+		bool fromUpper = false;
+		if (u && !u->isNoOp()) {
+			merged.op = u->op;
+			merged.value = u->value;
+			fromUpper = true;
+		} else if (!u && upperClear) {
+			merged.op = MutationRef::Type::ClearRange;
+			fromUpper = true;
+		} else if (l && !l->isNoOp()) {
+			merged.op = l->op;
+			merged.value = l->value;
+		} else if (!l && lowerClear) {
+			merged.op = MutationRef::Type::ClearRange;
+		}
+
+		// neither stream has a boundary before the next key, so a clear in either covers the whole range up to it
+		if (l) {
+			lowerClear = l->clearAfter;
+		}
+		if (u) {
+			upperClear = u->clearAfter;
+		}
+		merged.clearAfter = lowerClear || upperClear;
+		emit(merged, l != nullptr, fromUpper);
 	}
-};
-
-typedef std::priority_queue<MergeStreamNext, std::vector<MergeStreamNext>, OrderForPriorityQueue> MergePQ;
+}
 
+// Does a sorted merge of the delta streams. In terms of write precedence, streams[i] < streams[i+1].
+// The streams above streams[0] are folded pairwise, level by level, into contiguous boundary arrays, so each boundary
+// is visited O(log(streams)) times in linear passes, without a heap or per-key nodes. The folded deltas are then merged
+// onto streams[0], usually the snapshot, straight into the result.
 static RangeResult mergeDeltaStreams(const BlobGranuleChunkRef& chunk,
                                      const std::vector<Standalone<VectorRef<ParsedDeltaBoundaryRef>>>& streams,
                                      const std::vector<bool> startClears,
                                      GranuleMaterializeStats& stats) {
-	ASSERT(streams.size() < std::numeric_limits<int16_t>::max());
 	ASSERT(startClears.size() == streams.size());
 
 	if (streams.empty()) {
@@ -1359,102 +1500,65 @@ static RangeResult mergeDeltaStreams(const BlobGranuleChunkRef& chunk,
 
 	int prefixLen = commonPrefixLength(chunk.keyRange.begin, chunk.keyRange.end);
 
-	// next element for each stream
-	MergePQ next = MergePQ(OrderForPriorityQueue(prefixLen));
-
-	// efficiently find the highest stream's active clear
-	std::set<int16_t, std::greater<int16_t>> activeClears;
-	int16_t maxActiveClear = -1;
-
 	// trade off memory for cpu performance by assuming all inserts
 	RangeResult result;
 	int maxExpectedSize = 0;
-
-	// check if a given stream is actively clearing
-	bool clearActive[streams.size()];
-	for (int16_t i = 0; i < streams.size(); i++) {
-		clearActive[i] = startClears[i];
-		if (startClears[i]) {
-			activeClears.insert(i);
-			maxActiveClear = i;
-		}
-		if (streams[i].empty()) {
-			// single clear that entirely encases partial read bounds
-			ASSERT(clearActive[i]);
-		} else {
-			MergeStreamNext item;
-			item.key = streams[i][0].key;
-			item.streamIdx = i;
-			item.dataIdx = 0;
-			next.push(item);
-			maxExpectedSize += streams[i].size();
-			result.arena().dependsOn(streams[i].arena());
-		}
+	for (int i = 0; i < streams.size(); i++) {
+		// an empty stream is a single clear that entirely encases partial read bounds
+		ASSERT(!streams[i].empty() || startClears[i]);
+		maxExpectedSize += streams[i].size();
+		result.arena().dependsOn(streams[i].arena());
 	}
 	result.reserve(result.arena(), maxExpectedSize);
 
-	std::vector<MergeStreamNext> cur;
-	cur.reserve(streams.size());
-	while (!next.empty()) {
-		cur.clear();
-		cur.push_back(next.top());
-		next.pop();
-
-		// next.top().key == cur.front().key but with suffix comparison
-		while (!next.empty() && cur.front().key.compareSuffix(next.top().key, prefixLen) == 0) {
-			cur.push_back(next.top());
-			next.pop();
-		}
-
-		// un-set clears and find latest value for key (if present)
-		bool foundValue = false;
-		bool includesSnapshot = cur.back().streamIdx == 0 && chunk.snapshotFile.present();
-		for (auto& it : cur) {
-			auto& v = streams[it.streamIdx][it.dataIdx];
-			if (clearActive[it.streamIdx]) {
-				clearActive[it.streamIdx] = false;
-				activeClears.erase(it.streamIdx);
-				if (it.streamIdx == maxActiveClear) {
-					// re-get max active clear
-					maxActiveClear = activeClears.empty() ? -1 : *activeClears.begin();
-				}
-			}
-
-			// find value for this key (if any)
-			if (!foundValue && !v.isNoOp()) {
-				foundValue = true;
-				// if it's a clear, or maxActiveClear is higher, no value for this key
-				if (v.isSet() && maxActiveClear < it.streamIdx) {
-					KeyRef finalKey =
-					    chunk.tenantPrefix.present() ? v.key.removePrefix(chunk.tenantPrefix.get()) : v.key;
-					result.push_back(result.arena(), KeyValueRef(finalKey, v.value));
-					if (!includesSnapshot) {
-						stats.rowsInserted++;
-					} else if (it.streamIdx > 0) {
-						stats.rowsUpdated++;
-					}
-				} else if (includesSnapshot) {
-					stats.rowsCleared++;
+	std::vector<DeltaStreamSpan> level;
+	level.reserve(streams.size());
+	for (int i = 1; i < streams.size(); i++) {
+		level.push_back({ streams[i].begin(), streams[i].end(), startClears[i] });
+	}
+	// the folded boundaries reference keys and values in the streams' arenas, so they can live outside of an arena
+	std::vector<std::vector<ParsedDeltaBoundaryRef>> folded;
+	folded.reserve(streams.size());
+	while (level.size() > 1) {
+		std::vector<DeltaStreamSpan> nextLevel;
+		nextLevel.reserve(level.size() / 2 + 1);
+		for (int i = 0; i + 1 < level.size(); i += 2) {
+			folded.emplace_back();
+			std::vector<ParsedDeltaBoundaryRef>& out = folded.back();
+			out.reserve((level[i].end - level[i].begin) + (level[i + 1].end - level[i + 1].begin));
+			bool startClear = level[i].startClear || level[i + 1].startClear;
+			bool prevClearAfter = startClear;
+			mergeTwoDeltaStreams(level[i], level[i + 1], prefixLen, [&](const ParsedDeltaBoundaryRef& b, bool, bool) {
+				// a boundary with no op and no clear on either side changes nothing
+				if (!b.isNoOp() || b.clearAfter || prevClearAfter) {
+					out.push_back(b);
 				}
+				prevClearAfter = b.clearAfter;
+			});
+			nextLevel.push_back({ out.data(), out.data() + out.size(), startClear });
+		}
+		if (level.size() % 2) {
+			nextLevel.push_back(level.back());
+		}
+		level = std::move(nextLevel);
+	}
+
+	DeltaStreamSpan base = { streams[0].begin(), streams[0].end(), startClears[0] };
+	DeltaStreamSpan deltas = level.empty() ? DeltaStreamSpan{ nullptr, nullptr, false } : level.front();
+	mergeTwoDeltaStreams(base, deltas, prefixLen, [&](const ParsedDeltaBoundaryRef& b, bool inBase, bool fromDeltas) {
+		bool includesSnapshot = inBase && chunk.snapshotFile.present();
+		if (b.isSet()) {
+			KeyRef finalKey = chunk.tenantPrefix.present() ? b.key.removePrefix(chunk.tenantPrefix.get()) : b.key;
+			result.push_back(result.arena(), KeyValueRef(finalKey, b.value));
+			if (!includesSnapshot) {
+				stats.rowsInserted++;
+			} else if (fromDeltas) {
+				stats.rowsUpdated++;
 			}
+		} else if (includesSnapshot) {
+			stats.rowsCleared++;
 		}
-
-		// advance streams and start clearAfter
-		for (auto& it : cur) {
-			if (streams[it.streamIdx][it.dataIdx].clearAfter) {
-				clearActive[it.streamIdx] = true;
-				activeClears.insert(it.streamIdx);
-				maxActiveClear = std::max(maxActiveClear, it.streamIdx);
-			}
-			// TODO: implement skipping if large clear!!
-			// if (maxClearIdx > it.streamIdx) - skip
-			it.dataIdx++;
-			if (it.dataIdx < streams[it.streamIdx].size()) {
-				it.key = streams[it.streamIdx][it.dataIdx].key;
-				next.push(it);
-			}
-		}
-	}
+	});
 
 	// FIXME: if memory assumption was wrong and result is significantly smaller than total input size, could copy it
 	// with push_back_deep to a new result. This is rare though
@@ -1464,6 +1568,73 @@ static RangeResult mergeDeltaStreams(const BlobGranuleChunkRef& chunk,
 	return result;
 }
 
+Standalone<VectorRef<ResnapshotPieceRef>> getResnapshotPieces(const BlobGranuleChunkRef& chunk,
+                                                              const KeyRangeRef& keyRange,
+                                                              Optional<StringRef> snapshotData) {
+	ASSERT(!chunk.tenantPrefix.present());
+	Standalone<VectorRef<ResnapshotPieceRef>> pieces;
+	std::vector<KeyRef> boundaries;
+	boundaries.push_back(keyRange.begin);
+
+	Standalone<IndexedBlobGranuleFile> file;
+	bool reusable = false;
+	if (snapshotData.present()) {
+		ASSERT(chunk.snapshotFile.present());
+		file = IndexedBlobGranuleFile::fromFileBytes(snapshotData.get(), chunk.snapshotFile.get().cipherKeysCtx);
+		ASSERT(file.fileType == SNAPSHOT_FILE_TYPE);
+		// encrypted chunks are tied to the keys of their file
+		reusable = !chunk.snapshotFile.get().cipherKeysCtx.present();
+		for (auto& child : file.indexBlockRef.block.children) {
+			if (keyRange.begin < child.key && child.key < keyRange.end) {
+				boundaries.push_back(child.key);
+			}
+		}
+	}
+	boundaries.push_back(keyRange.end);
+
+	auto& children = file.indexBlockRef.block.children;
+	auto child = children.begin();
+	for (int i = 0; i + 1 < boundaries.size(); i++) {
+		ResnapshotPieceRef piece;
+		piece.range = KeyRangeRef(pieces.arena(), KeyRangeRef(boundaries[i], boundaries[i + 1]));
+		while (child != children.end() && child->key < boundaries[i]) {
+			child++;
+		}
+		if (reusable && child != children.end() && child + 1 != children.end() && child->key == boundaries[i] &&
+		    (child + 1)->key == boundaries[i + 1]) {
+			piece.serializedChunk = StringRef(snapshotData.get().begin() + file.chunkStartOffset + child->offset,
+			                                  (child + 1)->offset - child->offset);
+		}
+		pieces.push_back(pieces.arena(), piece);
+	}
+	return pieces;
+}
+
+bool granuleDeltasTouchRange(const BlobGranuleChunkRef& chunk,
+                             const KeyRangeRef& keyRange,
+                             Version readVersion,
+                             const std::vector<StringRef>& deltaFileData) {
+	ASSERT(!chunk.tenantPrefix.present());
+	if (!chunk.newDeltas.empty()) {
+		return true;
+	}
+	ASSERT(chunk.deltaFiles.size() == deltaFileData.size());
+	for (int deltaIdx = 0; deltaIdx < chunk.deltaFiles.size(); deltaIdx++) {
+		bool startClear = false;
+		auto deltaRows = loadChunkedDeltaFile(chunk.deltaFiles[deltaIdx].filename,
+		                                      deltaFileData[deltaIdx],
+		                                      keyRange,
+		                                      0,
+		                                      readVersion,
+		                                      chunk.deltaFiles[deltaIdx].cipherKeysCtx,
+		                                      startClear);
+		if (startClear || !deltaRows.empty()) {
+			return true;
+		}
+	}
+	return false;
+}
+
 RangeResult materializeJustSnapshot(const BlobGranuleChunkRef& chunk,
                                     Optional<StringRef> snapshotData,
                                     const KeyRange& requestRange,
@@ -1638,6 +1809,49 @@ static void startLoad(const ReadBlobGranuleContext* granuleContext,
 	}
 }
 
+struct ChunkMaterializeTask {
+	Optional<StringRef> snapshotData;
+	std::vector<StringRef> deltaData;
+	RangeResult rows;
+	GranuleMaterializeStats stats;
+	Optional<Error> error;
+};
+
+// Materializes a batch of consecutive chunks whose files are loaded, one thread per chunk. A chunk only reads its own
+// loaded files and allocates in its own arenas, so the chunks of a batch are independent.
+static void materializeChunks(const Standalone<VectorRef<BlobGranuleChunkRef>>& files,
+                              int firstChunk,
+                              std::vector<ChunkMaterializeTask>& tasks,
+                              const KeyRangeRef& keyRange,
+                              Version beginVersion,
+                              Version readVersion) {
+	auto materialize = [&](int i) {
+		ChunkMaterializeTask& task = tasks[i];
+		try {
+			task.rows = materializeBlobGranule(files[firstChunk + i],
+			                                   keyRange,
+			                                   beginVersion,
+			                                   readVersion,
+			                                   task.snapshotData,
+			                                   task.deltaData,
+			                                   task.stats);
+		} catch (Error& e) {
+			task.error = e;
+		} catch (...) {
+			task.error = unknown_error();
+		}
+	};
+	std::vector<std::thread> threads;
+	threads.reserve(tasks.size() - 1);
+	for (int i = 1; i < tasks.size(); i++) {
+		threads.emplace_back(materialize, i);
+	}
+	materialize(0);
+	for (auto& t : threads) {
+		t.join();
+	}
+}
+
 ErrorOr<RangeResult> loadAndMaterializeBlobGranules(const Standalone<VectorRef<BlobGranuleChunkRef>>& files,
                                                     const KeyRangeRef& keyRange,
                                                     Version beginVersion,
@@ -1651,6 +1865,8 @@ ErrorOr<RangeResult> loadAndMaterializeBlobGranules(const Standalone<VectorRef<B
 	if (parallelism >= CLIENT_KNOBS->BG_MAX_GRANULE_PARALLELISM) {
 		parallelism = CLIENT_KNOBS->BG_MAX_GRANULE_PARALLELISM;
 	}
+	// Simulation runs every client on the one network thread, so materializing there must stay on it
+	int materializeThreads = g_network->isSimulated() ? 1 : std::max(1, CLIENT_KNOBS->BG_MATERIALIZE_THREADS);
 
 	GranuleLoadIds loadIds[files.size()];
 
@@ -1660,46 +1876,58 @@ ErrorOr<RangeResult> loadAndMaterializeBlobGranules(const Standalone<VectorRef<B
 			startLoad(&granuleContext, files[i], loadIds[i]);
 		}
 		RangeResult results;
+		// Loaded chunks waiting to be materialized together. The load callbacks are only ever called on this thread.
+		std::vector<ChunkMaterializeTask> batch;
+		batch.reserve(std::min<int>(materializeThreads, files.size()));
 		for (int chunkIdx = 0; chunkIdx < files.size(); chunkIdx++) {
 			// Kick off files for this granule if parallelism == 1, or future granule if parallelism > 1
 			if (chunkIdx + parallelism - 1 < files.size()) {
 				startLoad(&granuleContext, files[chunkIdx + parallelism - 1], loadIds[chunkIdx + parallelism - 1]);
 			}
 
-			RangeResult chunkRows;
+			batch.emplace_back();
+			ChunkMaterializeTask& task = batch.back();
 
 			// once all loads kicked off, load data for chunk
-			Optional<StringRef> snapshotData;
 			if (files[chunkIdx].snapshotFile.present()) {
-				snapshotData =
+				task.snapshotData =
 				    StringRef(granuleContext.get_load_f(loadIds[chunkIdx].snapshotId.get(), granuleContext.userContext),
 				              files[chunkIdx].snapshotFile.get().length);
-				if (!snapshotData.get().begin()) {
+				if (!task.snapshotData.get().begin()) {
 					return ErrorOr<RangeResult>(blob_granule_file_load_error());
 				}
 			}
 
-			std::vector<StringRef> deltaData;
-			deltaData.resize(files[chunkIdx].deltaFiles.size());
+			task.deltaData.resize(files[chunkIdx].deltaFiles.size());
 			for (int i = 0; i < files[chunkIdx].deltaFiles.size(); i++) {
-				deltaData[i] =
+				task.deltaData[i] =
 				    StringRef(granuleContext.get_load_f(loadIds[chunkIdx].deltaIds[i], granuleContext.userContext),
 				              files[chunkIdx].deltaFiles[i].length);
 				// null data is error
-				if (!deltaData[i].begin()) {
+				if (!task.deltaData[i].begin()) {
 					return ErrorOr<RangeResult>(blob_granule_file_load_error());
 				}
 			}
 
-			// materialize rows from chunk
-			chunkRows = materializeBlobGranule(
-			    files[chunkIdx], keyRange, beginVersion, readVersion, snapshotData, deltaData, stats);
+			if (batch.size() < materializeThreads && chunkIdx + 1 < files.size()) {
+				continue;
+			}
 
-			results.arena().dependsOn(chunkRows.arena());
-			results.append(results.arena(), chunkRows.begin(), chunkRows.size());
+			// materialize rows from the batch's chunks, and append them in chunk order
+			int firstChunk = chunkIdx + 1 - batch.size();
+			materializeChunks(files, firstChunk, batch, keyRange, beginVersion, readVersion);
+			for (int i = 0; i < batch.size(); i++) {
+				if (batch[i].error.present()) {
+					return ErrorOr<RangeResult>(batch[i].error.get());
+				}
+				results.arena().dependsOn(batch[i].rows.arena());
+				results.append(results.arena(), batch[i].rows.begin(), batch[i].rows.size());
+				stats += batch[i].stats;
 
-			// free once done by forcing FreeHandles to trigger
-			loadIds[chunkIdx].freeHandles.clear();
+				// free once done by forcing FreeHandles to trigger
+				loadIds[firstChunk + i].freeHandles.clear();
+			}
+			batch.clear();
 		}
 		return ErrorOr<RangeResult>(results);
 	} catch (Error& e) {
@@ -2097,6 +2325,26 @@ void checkSnapshotEmpty(const Value& serialized, Key begin, Key end, Optional<Bl
 }
 
 // endIdx is exclusive
+// Returns a copy of the file where every byte a partial read of range wouldn't fetch is garbage
+Standalone<StringRef> partialFileCopy(const Value& serialized,
+                                      const KeyRangeRef& range,
+                                      Optional<BlobGranuleCipherKeysCtx> cipherKeysCtx) {
+	Standalone<StringRef> copy = makeString(serialized.size());
+	memset(mutateString(copy), 0xfe, copy.size());
+	int64_t footerOffset = serialized.size() - BG_FILE_FOOTER_BYTES;
+	Optional<int64_t> indexBytes = getBlobGranuleFileIndexBytes(serialized.substr(footerOffset));
+	ASSERT(indexBytes.present());
+	memcpy(mutateString(copy), serialized.begin(), indexBytes.get());
+	Optional<std::pair<int64_t, int64_t>> chunkRange =
+	    getBlobGranuleFileChunkRange(serialized.substr(0, indexBytes.get()), range, cipherKeysCtx);
+	if (chunkRange.present()) {
+		memcpy(mutateString(copy) + chunkRange.get().first,
+		       serialized.begin() + chunkRange.get().first,
+		       chunkRange.get().second - chunkRange.get().first);
+	}
+	return copy;
+}
+
 void checkSnapshotRead(const Standalone<StringRef>& fileNameRef,
                        const Standalone<GranuleSnapshot>& snapshot,
                        const Value& serialized,
@@ -2145,6 +2393,17 @@ void checkSnapshotRead(const Standalone<StringRef>& fileNameRef,
 		ASSERT(it.value == snapshot[beginIdx].value);
 		beginIdx++;
 	}
+
+	if (serialized.size() > BG_FILE_FOOTER_BYTES &&
+	    getBlobGranuleFileIndexBytes(serialized.substr(serialized.size() - BG_FILE_FOOTER_BYTES)).present()) {
+		Standalone<VectorRef<ParsedDeltaBoundaryRef>> partialResult =
+		    loadSnapshotFile(fileNameRef, partialFileCopy(serialized, range, cipherKeysCtx), range, cipherKeysCtx);
+		ASSERT(partialResult.size() == result.size());
+		for (int i = 0; i < result.size(); i++) {
+			ASSERT(partialResult[i].key == result[i].key);
+			ASSERT(partialResult[i].value == result[i].value);
+		}
+	}
 }
 
 namespace {
@@ -2504,6 +2763,52 @@ TEST_CASE("/blobgranule/files/snapshotFormatUnitTest") {
 	return Void();
 }
 
+TEST_CASE("/blobgranule/files/resnapshotReuseUnitTest") {
+	// chunks can only be reused from unencrypted snapshots
+	KeyValueGen kvGen;
+	kvGen.cipherKeys.reset();
+
+	int targetChunks = deterministicRandom()->randomExp(0, 7);
+	int targetDataBytes = deterministicRandom()->randomExp(0, 20);
+	int targetChunkSize = targetDataBytes / targetChunks;
+	Standalone<StringRef> fnameRef = StringRef(std::string("test"));
+
+	Standalone<GranuleSnapshot> data = genSnapshot(kvGen, targetDataBytes);
+	Value serialized = serializeChunkedSnapshot(fnameRef, data, targetChunkSize, kvGen.compressFilter);
+
+	Standalone<BlobGranuleChunkRef> chunk;
+	chunk.snapshotFile =
+	    BlobFilePointerRef(chunk.arena(), fnameRef.toString(), 0, serialized.size(), serialized.size(), 1);
+	Standalone<VectorRef<ResnapshotPieceRef>> pieces = getResnapshotPieces(chunk, kvGen.allRange, serialized);
+
+	// rebuild the snapshot from the pieces, as a re-snapshot without any deltas would
+	SnapshotFileBuilder builder(fnameRef, targetChunkSize, kvGen.compressFilter);
+	int reusablePieces = 0;
+	for (auto& piece : pieces) {
+		if (piece.serializedChunk.present() && deterministicRandom()->random01() < 0.8) {
+			reusablePieces++;
+			builder.addSerializedChunk(piece.range.begin, piece.range.end, piece.serializedChunk.get(), 0);
+		} else {
+			auto rows = loadSnapshotFile(fnameRef, serialized, piece.range, {});
+			for (auto& row : rows) {
+				builder.add(KeyValueRef(row.key, row.value));
+			}
+		}
+	}
+	Value reserialized = builder.finish();
+	fmt::print("Rebuilt snapshot of {0} rows from {1} pieces reusing {2} chunks\n",
+	           data.size(),
+	           pieces.size(),
+	           reusablePieces);
+
+	ASSERT(builder.serializedChunksReused == reusablePieces);
+	if (!data.empty()) {
+		checkSnapshotRead(fnameRef, data, reserialized, 0, data.size(), {});
+	}
+
+	return Void();
+}
+
 void checkDeltaRead(const KeyValueGen& kvGen,
                     const KeyRangeRef& range,
                     Version beginVersion,
@@ -3259,6 +3564,7 @@ std::pair<int64_t, double> doReadBench(const FileSet& fileSet,
 	}
 
 	int64_t serializedBytes = 0;
+	int64_t rowsRead = 0;
 	double elapsed = -timer_monotonic();
 	for (int runI = 0; runI < READ_RUNS; runI++) {
 		if (!chunked) {
@@ -3278,15 +3584,18 @@ std::pair<int64_t, double> doReadBench(const FileSet& fileSet,
 				actualData.push_back_deep(actualData.arena(), KeyValueRef(it.first, it.second));
 			}
 			serializedBytes += actualData.expectedSize();
+			rowsRead += actualData.size();
 		} else {
 			RangeResult actualData = materializeBlobGranule(
 			    chunk, readRange, 0, readVersion, std::get<2>(fileSet.snapshotFile), deltaPtrs, stats);
 			serializedBytes += actualData.expectedSize();
+			rowsRead += actualData.size();
 		}
 	}
 	elapsed += timer_monotonic();
 	elapsed /= READ_RUNS;
 	serializedBytes /= READ_RUNS;
+	rowsRead /= READ_RUNS;
 
 	if (printStats) {
 		fmt::print("Materialize stats:\n");
@@ -3297,6 +3606,10 @@ std::pair<int64_t, double> doReadBench(const FileSet& fileSet,
 		fmt::print("  Rows Cleared:  {0}\n", stats.rowsCleared / READ_RUNS);
 		fmt::print("  Rows Inserted: {0}\n", stats.rowsInserted / READ_RUNS);
 		fmt::print("  Rows Updated:  {0}\n", stats.rowsUpdated / READ_RUNS);
+		fmt::print("Read throughput:\n");
+		fmt::print("  Input:  {:.6} MB/cpusec\n", (stats.inputBytes / READ_RUNS / 1024.0 / 1024.0) / elapsed);
+		fmt::print("  Output: {:.6} MB/cpusec\n", (serializedBytes / 1024.0 / 1024.0) / elapsed);
+		fmt::print("  Rows:   {:.6} rows/cpusec\n", rowsRead / elapsed);
 	}
 
 	return { serializedBytes, elapsed };
@@ -24,11 +24,13 @@
 #include "fmt/format.h"
 #include "fdbclient/AsyncFileS3BlobStore.actor.h"
 #include "fdbclient/BlobGranuleCommon.h"
+#include "fdbclient/BlobGranuleFileCache.h"
 #include "fdbclient/BlobGranuleFiles.h"
 #include "fdbclient/BlobGranuleReader.actor.h"
 #include "fdbclient/BlobWorkerCommon.h"
 #include "fdbclient/BlobWorkerInterface.h"
 #include "fdbclient/FDBTypes.h"
+#include "fdbclient/Knobs.h"
 #include "flow/actorcompiler.h" // This must be the last #include.
 
 ACTOR Future<Standalone<StringRef>> readFile(Reference<BlobConnectionProvider> bstoreProvider, BlobFilePointerRef f) {
@@ -50,6 +52,117 @@ ACTOR Future<Standalone<StringRef>> readFile(Reference<BlobConnectionProvider> b
 	}
 }
 
+// Reads only the parts of the file needed to read keyRange: its footer and index, then the chunks overlapping keyRange.
+// The returned bytes are laid out at their file offsets, and bytes that weren't needed are left unread.
+ACTOR Future<Standalone<StringRef>> readFileRange(Reference<BlobConnectionProvider> bstoreProvider,
+                                                  BlobFilePointerRef f,
+                                                  KeyRange keyRange) {
+	state BlobGranuleFileCache* cache = BlobGranuleFileCache::processCache();
+	if (cache != nullptr && f.offset == 0 && f.length == f.fullFileLength) {
+		// cached files are read whole, so that later reads of any range of them stay local
+		state std::string cacheName = f.filename.toString();
+		Optional<Standalone<StringRef>> cached = wait(cache->get(cacheName));
+		if (cached.present() && cached.get().size() == f.length) {
+			return cached.get();
+		}
+		Standalone<StringRef> data = wait(readFile(bstoreProvider, f));
+		cache->add(cacheName, data);
+		return data;
+	}
+
+	if (!CLIENT_KNOBS->BG_RANGED_FILE_READS || f.offset != 0 || f.length != f.fullFileLength ||
+	    f.length <= BG_FILE_FOOTER_BYTES) {
+		Standalone<StringRef> data = wait(readFile(bstoreProvider, f));
+		return data;
+	}
+
+	state Arena arena;
+	std::string fname = f.filename.toString();
+	state Reference<BackupContainerFileSystem> bstore = bstoreProvider->getForRead(fname);
+	state Reference<IAsyncFile> reader = wait(bstore->readFile(fname));
+
+	state int64_t fileLength = f.length - BG_FILE_FOOTER_BYTES;
+	state uint8_t* data = new (arena) uint8_t[f.length];
+	state int64_t prefetchBytes = std::min<int64_t>(fileLength, CLIENT_KNOBS->BG_RANGED_READ_PREFETCH_BYTES);
+
+	// the index is at the head of the file, so fetch some of it with the footer to usually avoid another round trip
+	state Future<int> readFooter = reader->read(data + fileLength, BG_FILE_FOOTER_BYTES, fileLength);
+	state Future<int> readPrefix = reader->read(data, prefetchBytes, 0);
+	int footerSize = wait(readFooter);
+	ASSERT(footerSize == BG_FILE_FOOTER_BYTES);
+	int prefixSize = wait(readPrefix);
+	ASSERT(prefixSize == prefetchBytes);
+
+	state Optional<int64_t> indexBytes =
+	    getBlobGranuleFileIndexBytes(StringRef(data + fileLength, BG_FILE_FOOTER_BYTES));
+	state int64_t readBytes = prefetchBytes;
+	state int64_t neededBytes = indexBytes.present() ? indexBytes.get() : fileLength;
+	ASSERT(neededBytes <= fileLength);
+	if (neededBytes > readBytes) {
+		int size = wait(reader->read(data + readBytes, neededBytes - readBytes, readBytes));
+		ASSERT(size == neededBytes - readBytes);
+		readBytes = neededBytes;
+	}
+
+	if (!indexBytes.present()) {
+		// not written with a footer, so the whole file was needed after all
+		return Standalone<StringRef>(StringRef(data, f.length), arena);
+	}
+
+	state Optional<std::pair<int64_t, int64_t>> chunkRange =
+	    getBlobGranuleFileChunkRange(StringRef(data, indexBytes.get()), keyRange, f.cipherKeysCtx);
+	if (chunkRange.present() && chunkRange.get().second > readBytes) {
+		state int64_t chunkBegin = std::max(chunkRange.get().first, readBytes);
+		state int64_t chunkEnd = chunkRange.get().second;
+		ASSERT(chunkEnd <= fileLength);
+		int size = wait(reader->read(data + chunkBegin, chunkEnd - chunkBegin, chunkBegin));
+		ASSERT(size == chunkEnd - chunkBegin);
+		readBytes = chunkEnd;
+	}
+	CODE_PROBE(readBytes < fileLength, "blob granule file read partially");
+
+	return Standalone<StringRef>(StringRef(data, readBytes), arena);
+}
+
+ACTOR Future<BlobGranuleFileData> readBlobGranuleFiles(BlobGranuleChunkRef chunk,
+                                                       KeyRangeRef keyRange,
+                                                       Reference<BlobConnectionProvider> bstore,
+                                                       Optional<BlobWorkerStats*> stats) {
+	state BlobGranuleFileData data;
+	KeyRange requestRange = chunk.tenantPrefix.present() ? keyRange.withPrefix(chunk.tenantPrefix.get()) : keyRange;
+
+	Future<Standalone<StringRef>> readSnapshotFuture;
+	if (chunk.snapshotFile.present()) {
+		readSnapshotFuture = readFileRange(bstore, chunk.snapshotFile.get(), requestRange);
+		if (stats.present()) {
+			++stats.get()->s3GetReqs;
+		}
+	}
+	state std::vector<Future<Standalone<StringRef>>> readDeltaFutures;
+
+	readDeltaFutures.reserve(chunk.deltaFiles.size());
+	for (BlobFilePointerRef deltaFile : chunk.deltaFiles) {
+		readDeltaFutures.push_back(readFileRange(bstore, deltaFile, requestRange));
+		if (stats.present()) {
+			++stats.get()->s3GetReqs;
+		}
+	}
+
+	if (chunk.snapshotFile.present()) {
+		Standalone<StringRef> s = wait(readSnapshotFuture);
+		data.snapshotData = s;
+	}
+
+	state int deltaIdx;
+	data.deltaData.reserve(readDeltaFutures.size());
+	for (deltaIdx = 0; deltaIdx < readDeltaFutures.size(); deltaIdx++) {
+		Standalone<StringRef> d = wait(readDeltaFutures[deltaIdx]);
+		data.deltaData.push_back(d);
+	}
+
+	return data;
+}
+
 // TODO: improve the interface of this function so that it doesn't need
 //       to be passed the entire BlobWorkerStats object
 
@@ -65,51 +178,12 @@ ACTOR Future<RangeResult> readBlobGranule(BlobGranuleChunkRef chunk,
 	// TODO REMOVE with early replying
 	ASSERT(readVersion == chunk.includedVersion);
 
-	state Arena arena;
-
-	try {
-		Future<Standalone<StringRef>> readSnapshotFuture;
-		if (chunk.snapshotFile.present()) {
-			readSnapshotFuture = readFile(bstore, chunk.snapshotFile.get());
-			if (stats.present()) {
-				++stats.get()->s3GetReqs;
-			}
-		}
-		state std::vector<Future<Standalone<StringRef>>> readDeltaFutures;
-
-		readDeltaFutures.reserve(chunk.deltaFiles.size());
-		for (BlobFilePointerRef deltaFile : chunk.deltaFiles) {
-			readDeltaFutures.push_back(readFile(bstore, deltaFile));
-			if (stats.present()) {
-				++stats.get()->s3GetReqs;
-			}
-		}
-
-		state Optional<StringRef> snapshotData; // not present if snapshotFile isn't present
-		if (chunk.snapshotFile.present()) {
-			state Standalone<StringRef> s = wait(readSnapshotFuture);
-			arena.dependsOn(s.arena());
-			snapshotData = s;
-		}
-
-		state int numDeltaFiles = chunk.deltaFiles.size();
-		state std::vector<StringRef> deltaData;
-		state int deltaIdx;
+	BlobGranuleFileData data = wait(readBlobGranuleFiles(chunk, keyRange, bstore, stats));
 
-		deltaData.reserve(numDeltaFiles);
-		for (deltaIdx = 0; deltaIdx < numDeltaFiles; deltaIdx++) {
-			Standalone<StringRef> data = wait(readDeltaFutures[deltaIdx]);
-			deltaData.push_back(data);
-			arena.dependsOn(data.arena());
-		}
-
-		// TODO do something useful with stats?
-		GranuleMaterializeStats stats;
-		return materializeBlobGranule(chunk, keyRange, beginVersion, readVersion, snapshotData, deltaData, stats);
-
-	} catch (Error& e) {
-		throw e;
-	}
+	// TODO do something useful with stats?
+	GranuleMaterializeStats materializeStats;
+	return materializeBlobGranule(
+	    chunk, keyRange, beginVersion, readVersion, data.snapshotRef(), data.deltaRefs(), materializeStats);
 }
 
 // TODO probably should add things like limit/bytelimit at some point?
@@ -134,6 +208,72 @@ ACTOR Future<Void> readBlobGranules(BlobGranuleFileRequest request,
 	return Void();
 }
 
+static void addGranuleMutation(std::vector<std::pair<Version, MutationRef>>& mutations,
+                               Version version,
+                               MutationRef m,
+                               KeyRangeRef keyRange) {
+	if (m.type == MutationRef::ClearRange) {
+		KeyRangeRef cleared = keyRange & KeyRangeRef(m.param1, m.param2);
+		if (!cleared.empty()) {
+			mutations.emplace_back(version, MutationRef(MutationRef::ClearRange, cleared.begin, cleared.end));
+		}
+	} else if (keyRange.contains(m.param1)) {
+		mutations.emplace_back(version, m);
+	}
+}
+
+ACTOR Future<Standalone<VectorRef<MutationsAndVersionRef>>> readBlobGranuleMutations(
+    Standalone<VectorRef<BlobGranuleChunkRef>> chunks,
+    KeyRange keyRange,
+    Version beginVersion,
+    Version readVersion,
+    Reference<BlobConnectionProvider> bstore) {
+	// delta files are parsed whole, so they can't be read partially like for materializing a key range
+	state std::vector<Future<Standalone<StringRef>>> deltaFiles;
+	for (auto& chunk : chunks) {
+		ASSERT(!chunk.snapshotFile.present());
+		for (auto& deltaFile : chunk.deltaFiles) {
+			deltaFiles.push_back(readFile(bstore, deltaFile));
+		}
+	}
+	wait(waitForAll(deltaFiles));
+
+	Standalone<VectorRef<MutationsAndVersionRef>> result;
+	std::vector<std::pair<Version, MutationRef>> mutations;
+	int fileIdx = 0;
+	for (auto& chunk : chunks) {
+		for (auto& deltaFile : chunk.deltaFiles) {
+			Standalone<VectorRef<GranuleMutationRef>> deltas =
+			    bgReadDeltaFile(deltaFiles[fileIdx++].get(), chunk.tenantPrefix, deltaFile.cipherKeysCtx);
+			result.arena().dependsOn(deltas.arena());
+			for (auto& d : deltas) {
+				if (d.version >= beginVersion && d.version <= readVersion) {
+					addGranuleMutation(mutations, d.version, MutationRef(d.type, d.param1, d.param2), keyRange);
+				}
+			}
+		}
+		for (auto& newDelta : chunk.newDeltas) {
+			if (newDelta.version >= beginVersion && newDelta.version <= readVersion) {
+				for (auto& m : newDelta.mutations) {
+					addGranuleMutation(mutations, newDelta.version, m, keyRange);
+				}
+			}
+		}
+	}
+	result.arena().dependsOn(chunks.arena());
+
+	// chunks have disjoint key ranges, and the mutations of one version in a delta file don't overlap, so only the
+	// order of versions matters
+	std::stable_sort(mutations.begin(), mutations.end(), [](auto const& a, auto const& b) { return a.first < b.first; });
+	for (auto& it : mutations) {
+		if (result.empty() || result.back().version != it.first) {
+			result.push_back(result.arena(), MutationsAndVersionRef(it.first, it.first));
+		}
+		result.back().mutations.push_back(result.arena(), it.second);
+	}
+	return result;
+}
+
 // Return true if a given range is fully covered by blob chunks
 bool isRangeFullyCovered(KeyRange range, Standalone<VectorRef<BlobGranuleChunkRef>> blobChunks) {
 	std::vector<KeyRangeRef> blobRanges;
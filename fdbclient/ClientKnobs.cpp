@@ -22,6 +22,7 @@
 #include "fdbclient/FDBTypes.h"
 #include "fdbclient/SystemData.h"
 #include "fdbclient/Tenant.h"
+#include "flow/CompressionUtils.h"
 #include "flow/IRandom.h"
 #include "flow/UnitTest.h"
 #include "flow/flow.h"
@@ -40,6 +41,11 @@ void ClientKnobs::initialize(Randomize randomize) {
 	init( SYSTEM_MONITOR_INTERVAL,                 5.0 );
 	init( NETWORK_BUSYNESS_MONITOR_INTERVAL,       1.0 );
 	init( TSS_METRICS_LOGGING_INTERVAL,          120.0 ); // 2 minutes by default
+	init( TSS_SAMPLE_RATE_GET_VALUE,               1.0 ); if( randomize && BUGGIFY ) TSS_SAMPLE_RATE_GET_VALUE = deterministicRandom()->random01();
+	init( TSS_SAMPLE_RATE_GET_KEY,                 1.0 ); if( randomize && BUGGIFY ) TSS_SAMPLE_RATE_GET_KEY = deterministicRandom()->random01();
+	init( TSS_SAMPLE_RATE_GET_KEY_VALUES,          1.0 ); if( randomize && BUGGIFY ) TSS_SAMPLE_RATE_GET_KEY_VALUES = deterministicRandom()->random01();
+	init( TSS_SAMPLE_RATE_GET_MAPPED_KEY_VALUES,   1.0 ); if( randomize && BUGGIFY ) TSS_SAMPLE_RATE_GET_MAPPED_KEY_VALUES = deterministicRandom()->random01();
+	init( TSS_SAMPLE_RATE_OTHER,                   1.0 ); if( randomize && BUGGIFY ) TSS_SAMPLE_RATE_OTHER = deterministicRandom()->random01();
 
 	init( FAILURE_MAX_DELAY,                       5.0 );
 	init( FAILURE_MIN_DELAY,                       4.0 ); if( randomize && BUGGIFY ) FAILURE_MIN_DELAY = 1.0;
@@ -56,6 +62,7 @@ void ClientKnobs::initialize(Randomize randomize) {
 	init( MAX_GRV_PROXY_CONNECTIONS,                 3 ); if( randomize && BUGGIFY ) MAX_GRV_PROXY_CONNECTIONS = 1;
 	init( STATUS_IDLE_TIMEOUT,                   120.0 );
 	init( SEND_ENTIRE_VERSION_VECTOR,            false );
+	init( SPECIAL_KEY_SPACE_MODULE_CACHE_SECONDS,  1.0 ); if( randomize && BUGGIFY ) SPECIAL_KEY_SPACE_MODULE_CACHE_SECONDS = 0.0;
 
 	// wrong_shard_server sometimes comes from the only nonfailed server, so we need to avoid a fast spin
 
@@ -78,6 +85,8 @@ void ClientKnobs::initialize(Randomize randomize) {
 	init( VALUE_SIZE_LIMIT,                        1e5 );
 	init( SPLIT_KEY_SIZE_LIMIT,                    KEY_SIZE_LIMIT/2 );  if( randomize && BUGGIFY ) SPLIT_KEY_SIZE_LIMIT = KEY_SIZE_LIMIT - 31;//serverKeysPrefixFor(UID()).size() - 1;
 	init( METADATA_VERSION_CACHE_SIZE,            1000 );
+	init( RYW_DEFER_WRITES,                       true ); if( randomize && BUGGIFY ) RYW_DEFER_WRITES = false;
+	init( TRANSACTION_TIMELINE_MAX_EVENTS,        1000 ); if( randomize && BUGGIFY ) TRANSACTION_TIMELINE_MAX_EVENTS = 2;
 	init( CHANGE_FEED_LOCATION_LIMIT,            10000 );
 	init( CHANGE_FEED_CACHE_SIZE,               100000 ); if( randomize && BUGGIFY ) CHANGE_FEED_CACHE_SIZE = 1;
 	init( CHANGE_FEED_POP_TIMEOUT,                10.0 );
@@ -87,9 +96,12 @@ void ClientKnobs::initialize(Randomize randomize) {
 	init( CHANGE_FEED_CACHE_FLUSH_BYTES,          10e6 ); if( randomize && BUGGIFY ) CHANGE_FEED_CACHE_FLUSH_BYTES = deterministicRandom()->randomInt64(1, 1e6);
 	init( CHANGE_FEED_CACHE_EXPIRE_TIME,          60.0 ); if( randomize && BUGGIFY ) CHANGE_FEED_CACHE_EXPIRE_TIME = 1.0;
 	init( CHANGE_FEED_CACHE_LIMIT_BYTES,        500000 ); if( randomize && BUGGIFY ) CHANGE_FEED_CACHE_LIMIT_BYTES = 50000;
+	init( CHANGE_FEED_BLOB_CATCHUP_LAG_VERSIONS,  60e6 ); if( randomize && BUGGIFY ) CHANGE_FEED_BLOB_CATCHUP_LAG_VERSIONS = deterministicRandom()->randomInt64(1, 10e6);
+	init( CHANGE_FEED_BLOB_CATCHUP_BATCH_VERSIONS, 10e6 ); if( randomize && BUGGIFY ) CHANGE_FEED_BLOB_CATCHUP_BATCH_VERSIONS = deterministicRandom()->randomInt64(1, 1e6);
 
 	init( MAX_BATCH_SIZE,                         1000 ); if( randomize && BUGGIFY ) MAX_BATCH_SIZE = 1;
 	init( GRV_BATCH_TIMEOUT,                     0.005 ); if( randomize && BUGGIFY ) GRV_BATCH_TIMEOUT = 0.1;
+	init( SHARE_GRV_BATCHES,                     false ); if( randomize && BUGGIFY ) SHARE_GRV_BATCHES = true;
 	init( BROADCAST_BATCH_SIZE,                     20 ); if( randomize && BUGGIFY ) BROADCAST_BATCH_SIZE = 1;
 	init( TRANSACTION_TIMEOUT_DELAY_INTERVAL,     10.0 ); if( randomize && BUGGIFY ) TRANSACTION_TIMEOUT_DELAY_INTERVAL = 1.0;
 
@@ -97,8 +109,13 @@ void ClientKnobs::initialize(Randomize randomize) {
 	init( LOCATION_CACHE_EVICTION_SIZE_SIM,         10 ); if( randomize && BUGGIFY ) LOCATION_CACHE_EVICTION_SIZE_SIM = 3;
 	init( LOCATION_CACHE_ENDPOINT_FAILURE_GRACE_PERIOD,     60 );
 	init( LOCATION_CACHE_FAILED_ENDPOINT_RETRY_INTERVAL,    60 );
+	init( LOCATION_CACHE_EVICTION_SAMPLES,           5 ); if( randomize && BUGGIFY ) LOCATION_CACHE_EVICTION_SAMPLES = deterministicRandom()->randomInt(1, 10);
+	init( LOCATION_CACHE_PREFETCH_SHARDS,            4 ); if( randomize && BUGGIFY ) LOCATION_CACHE_PREFETCH_SHARDS = deterministicRandom()->randomInt(1, 20);
 
 	init( GET_RANGE_SHARD_LIMIT,                     2 );
+	init( GET_RANGE_PARALLEL_SHARD_LIMIT,          100 );
+	init( GET_VALUES_BATCHING_ENABLED,           false ); if( randomize && BUGGIFY ) GET_VALUES_BATCHING_ENABLED = true;
+	init( GET_VALUES_BATCH_MAX_KEYS,               200 ); if( randomize && BUGGIFY ) GET_VALUES_BATCH_MAX_KEYS = deterministicRandom()->randomInt(1, 10);
 	init( WARM_RANGE_SHARD_LIMIT,                  100 );
 	init( STORAGE_METRICS_SHARD_LIMIT,             100 ); if( randomize && BUGGIFY ) STORAGE_METRICS_SHARD_LIMIT = 10;
 	init( SHARD_COUNT_LIMIT,                        80 ); if( randomize && BUGGIFY ) SHARD_COUNT_LIMIT = 3;
@@ -123,6 +140,8 @@ void ClientKnobs::initialize(Randomize randomize) {
 	init( NO_RECENT_UPDATES_DURATION,             20.0 ); if( randomize && BUGGIFY ) NO_RECENT_UPDATES_DURATION = 0.1;
 	init( FAST_WATCH_TIMEOUT,                     20.0 ); if( randomize && BUGGIFY ) FAST_WATCH_TIMEOUT = 1.0;
 	init( WATCH_TIMEOUT,                          30.0 ); if( randomize && BUGGIFY ) WATCH_TIMEOUT = 20.0;
+	init( WATCH_BATCHING_ENABLED,                false ); if( randomize && BUGGIFY ) WATCH_BATCHING_ENABLED = true;
+	init( WATCH_BATCH_MAX_KEYS,                    500 ); if( randomize && BUGGIFY ) WATCH_BATCH_MAX_KEYS = deterministicRandom()->randomInt(1, 10);
 
 	// Core
 	init( CORE_VERSIONSPERSECOND,		           1e6 );
@@ -148,9 +167,12 @@ void ClientKnobs::initialize(Randomize randomize) {
 
 	//Backup
 	init( BACKUP_LOCAL_FILE_WRITE_BLOCK,     1024*1024 );
+	init( BACKUP_LOCAL_FILE_WRITE_BEHIND,            2 ); if( randomize && BUGGIFY ) BACKUP_LOCAL_FILE_WRITE_BEHIND = deterministicRandom()->randomInt(0, 5);
 	init( BACKUP_CONCURRENT_DELETES,               100 );
+	init( BACKUP_CONTAINER_LOG_MANIFESTS,         true ); if( randomize && BUGGIFY ) BACKUP_CONTAINER_LOG_MANIFESTS = false;
 	init( BACKUP_SIMULATED_LIMIT_BYTES,		       1e6 ); if( randomize && BUGGIFY ) BACKUP_SIMULATED_LIMIT_BYTES = 1000;
 	init( BACKUP_GET_RANGE_LIMIT_BYTES,		       1e6 );
+	init( MUTATION_LOG_READER_PREFETCH_BYTES,      1e8 ); if( randomize && BUGGIFY ) MUTATION_LOG_READER_PREFETCH_BYTES = deterministicRandom()->randomInt(1, 1e7);
 	init( BACKUP_LOCK_BYTES,                       1e8 );
 	init( BACKUP_RANGE_TIMEOUT,   TASKBUCKET_TIMEOUT_VERSIONS/CORE_VERSIONSPERSECOND/2.0 );
 	init( BACKUP_RANGE_MINWAIT,   std::max(1.0, BACKUP_RANGE_TIMEOUT/2.0));
@@ -179,6 +201,7 @@ void ClientKnobs::initialize(Randomize randomize) {
 	init( MAX_WRITE_TRANSACTION_LIFE_VERSIONS, 5 * VERSIONS_PER_SECOND);  // Must be the same as SERVER_KNOBS->MAX_WRITE_TRANSACTION_LIFE_VERSIONS
 	init( SIM_BACKUP_TASKS_PER_AGENT,               10 );
 	init( BACKUP_RANGEFILE_BLOCK_SIZE,      1024 * 1024);
+	init( BACKUP_RANGEFILE_COMPRESSION,         "NONE" ); if( randomize && BUGGIFY ) BACKUP_RANGEFILE_COMPRESSION = CompressionUtils::toString(CompressionUtils::getRandomFilter());
 	init( BACKUP_LOGFILE_BLOCK_SIZE,        1024 * 1024);
 	init( BACKUP_DISPATCH_ADDTASK_SIZE,             50 );
 	init( RESTORE_DISPATCH_ADDTASK_SIZE,           150 );
@@ -232,9 +255,11 @@ void ClientKnobs::initialize(Randomize randomize) {
 	init( BLOBSTORE_READ_BLOCK_SIZE,       1024 * 1024 );
 	init( BLOBSTORE_READ_AHEAD_BLOCKS,               0 );
 	init( BLOBSTORE_READ_CACHE_BLOCKS_PER_FILE,      2 );
+	init( BLOBSTORE_READ_AHEAD_MAX_BLOCKS,           4 );
 	init( BLOBSTORE_MULTIPART_MAX_PART_SIZE,  20000000 );
 	init( BLOBSTORE_MULTIPART_MIN_PART_SIZE,   5242880 );
 	init( BLOBSTORE_GLOBAL_CONNECTION_POOL,      false );
+	init( BLOBSTORE_ADAPTIVE_CONCURRENCY,         true );
 	init( BLOBSTORE_ENABLE_LOGGING,               true );
 	init( BLOBSTORE_STATS_LOGGING_INTERVAL,       10.0 );
 	init( BLOBSTORE_LATENCY_LOGGING_INTERVAL,    120.0 );
@@ -309,6 +334,10 @@ void ClientKnobs::initialize(Randomize randomize) {
 	// Blob granules
 	init( BG_MAX_GRANULE_PARALLELISM,                10 );
 	init( BG_TOO_MANY_GRANULES,                   20000 );
+	init( BG_MATERIALIZE_THREADS,                     1 );
+	init( BG_WRITE_INDEX_FOOTER,                  false ); if ( randomize && BUGGIFY ) { BG_WRITE_INDEX_FOOTER = true; }
+	init( BG_RANGED_FILE_READS,                    true ); if ( randomize && BUGGIFY ) { BG_RANGED_FILE_READS = false; }
+	init( BG_RANGED_READ_PREFETCH_BYTES,          65536 ); if ( randomize && BUGGIFY ) { BG_RANGED_READ_PREFETCH_BYTES = deterministicRandom()->randomInt(16, 4096); }
 	init( BLOB_METADATA_REFRESH_INTERVAL,          3600 ); if ( randomize && BUGGIFY ) { BLOB_METADATA_REFRESH_INTERVAL = deterministicRandom()->randomInt(5, 120); }
 	init( DETERMINISTIC_BLOB_METADATA,            false ); if( randomize && BUGGIFY_WITH_PROB(0.01) ) DETERMINISTIC_BLOB_METADATA = true;
 	init( ENABLE_BLOB_GRANULE_FILE_LOGICAL_SIZE,  false ); if ( randomize && BUGGIFY ) { ENABLE_BLOB_GRANULE_FILE_LOGICAL_SIZE = true; }
@@ -324,8 +353,13 @@ void ClientKnobs::initialize(Randomize randomize) {
 	init( METACLUSTER_ASSIGNMENT_CLUSTERS_TO_CHECK,   5 ); if ( randomize && BUGGIFY ) METACLUSTER_ASSIGNMENT_CLUSTERS_TO_CHECK = 1;
 	init( METACLUSTER_ASSIGNMENT_FIRST_CHOICE_DELAY, 1.0 ); if ( randomize && BUGGIFY ) METACLUSTER_ASSIGNMENT_FIRST_CHOICE_DELAY = deterministicRandom()->random01() * 60;
 	init( METACLUSTER_ASSIGNMENT_AVAILABILITY_TIMEOUT, 10.0 ); if ( randomize && BUGGIFY ) METACLUSTER_ASSIGNMENT_AVAILABILITY_TIMEOUT = 1 + deterministicRandom()->random01() * 59;
+	init( METACLUSTER_LOAD_AWARE_ASSIGNMENT,       true ); if ( randomize && BUGGIFY ) METACLUSTER_LOAD_AWARE_ASSIGNMENT = false;
+	init( METACLUSTER_LOAD_MAX_AGE,               300.0 );
+	init( METACLUSTER_LOAD_STATUS_TIMEOUT,         10.0 );
 	init( METACLUSTER_RESTORE_BATCH_SIZE,          1000 ); if ( randomize && BUGGIFY ) METACLUSTER_RESTORE_BATCH_SIZE = 1 + deterministicRandom()->randomInt(0, 3);
 	init( TENANT_ENTRY_CACHE_LIST_REFRESH_INTERVAL,   2 ); if( randomize && BUGGIFY ) TENANT_ENTRY_CACHE_LIST_REFRESH_INTERVAL = deterministicRandom()->randomInt(1, 10);
+	init( TENANT_ENTRY_CACHE_REFRESH_BATCH_SIZE,  10000 ); if( randomize && BUGGIFY ) TENANT_ENTRY_CACHE_REFRESH_BATCH_SIZE = deterministicRandom()->randomInt(1, 10);
+	init( TENANT_ENTRY_CACHE_METRICS_LOGGING_INTERVAL, 60.0 );
 	init( CLIENT_ENABLE_USING_CLUSTER_ID_KEY,     false );
 
 	init( ENABLE_ENCRYPTION_CPU_TIME_LOGGING,        true );
@@ -342,6 +376,7 @@ void ClientKnobs::initialize(Randomize randomize) {
 	init( ENABLE_MUTATION_CHECKSUM,                  true ); if ( randomize && BUGGIFY ) ENABLE_MUTATION_CHECKSUM = deterministicRandom()->coinflip(); // Enable this after deserialiser is ported to 7.3.
 	init( ENABLE_ACCUMULATIVE_CHECKSUM,              true ); if ( randomize && BUGGIFY ) ENABLE_ACCUMULATIVE_CHECKSUM = deterministicRandom()->coinflip(); // Enable this after deserialiser is ported to 7.3.
 	init( ENABLE_ACCUMULATIVE_CHECKSUM_LOGGING,     false );
+	init( MUTATION_CHECKSUM_REVALIDATE,             false ); if ( randomize && BUGGIFY ) MUTATION_CHECKSUM_REVALIDATE = true;
 	// clang-format on
 }
 
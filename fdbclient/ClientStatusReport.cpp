@@ -41,6 +41,7 @@ public:
 			reportClientInfo();
 			reportStorageServers();
 			reportConnections();
+			reportLatencies();
 			statusObj["Healthy"] = healthy;
 		}
 		return StringRef(json_spirit::write_string(json_spirit::mValue(statusObj)));
@@ -120,6 +121,32 @@ private:
 		}
 	}
 
+	// The latencies of this client's operations since the database logger last cleared them
+	void reportLatencies() {
+		json_spirit::mObject latenciesObj;
+		latenciesObj["GetReadVersion"] = latencyReport(cx.GRVLatencies);
+		latenciesObj["Get"] = latencyReport(cx.readLatencies);
+		latenciesObj["GetRange"] = latencyReport(cx.getRangeLatencies);
+		latenciesObj["LocationLookup"] = latencyReport(cx.locationLatencies);
+		latenciesObj["Commit"] = latencyReport(cx.commitLatencies);
+		latenciesObj["Transaction"] = latencyReport(cx.latencies);
+		latenciesObj["Seconds"] = now() - cx.latenciesStartTime;
+		statusObj["Latencies"] = latenciesObj;
+	}
+
+	static json_spirit::mObject latencyReport(DDSketch<double>& latencies) {
+		json_spirit::mObject latencyObj;
+		latencyObj["Count"] = (int64_t)latencies.getPopulationSize();
+		if (latencies.getPopulationSize() > 0) {
+			latencyObj["Mean"] = latencies.mean();
+			latencyObj["Median"] = latencies.median();
+			latencyObj["P90"] = latencies.percentile(0.90);
+			latencyObj["P99"] = latencies.percentile(0.99);
+			latencyObj["Max"] = latencies.max();
+		}
+		return latencyObj;
+	}
+
 	json_spirit::mObject connectionStatusReport(const NetworkAddress& address) {
 		json_spirit::mObject connStatus;
 		connStatus["Address"] = address.toString();
@@ -0,0 +1,168 @@
+/*
+ * CommitBatchRecording.actor.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbclient/CommitBatchRecording.h"
+#include "flow/IAsyncFile.h"
+#include "flow/ObjectSerializer.h"
+#include "flow/UnitTest.h"
+#include "flow/actorcompiler.h" // This must be the last #include.
+
+Standalone<StringRef> encodeRecordedCommitBatch(RecordedCommitBatchRef const& batch) {
+	Standalone<StringRef> serialized = ObjectWriter::toValue(batch, IncludeVersion());
+	uint32_t length = serialized.size();
+	Standalone<StringRef> record = makeString(sizeof(length) + length);
+	memcpy(mutateString(record), &length, sizeof(length));
+	memcpy(mutateString(record) + sizeof(length), serialized.begin(), length);
+	return record;
+}
+
+Standalone<VectorRef<RecordedCommitBatchRef>> decodeCommitBatchRecording(Standalone<StringRef> const& recording) {
+	Standalone<VectorRef<RecordedCommitBatchRef>> batches;
+	batches.arena().dependsOn(recording.arena());
+	StringRef remaining = recording;
+	while (remaining.size() >= sizeof(uint32_t)) {
+		uint32_t length;
+		memcpy(&length, remaining.begin(), sizeof(length));
+		if (remaining.size() - sizeof(length) < length) {
+			break;
+		}
+		RecordedCommitBatchRef batch;
+		ArenaObjectReader reader(batches.arena(), remaining.substr(sizeof(length), length), IncludeVersion());
+		reader.deserialize(batch);
+		batches.push_back(batches.arena(), batch);
+		remaining = remaining.substr(sizeof(length) + length);
+	}
+	return batches;
+}
+
+namespace {
+
+ACTOR Future<Void> writeCommitBatchRecording(CommitBatchRecorder* self, FutureStream<Standalone<StringRef>> records) {
+	state Reference<IAsyncFile> file;
+	state int64_t offset = 0;
+	try {
+		Reference<IAsyncFile> f = wait(IAsyncFileSystem::filesystem()->open(
+		    self->path,
+		    IAsyncFile::OPEN_NO_AIO | IAsyncFile::OPEN_CREATE | IAsyncFile::OPEN_READWRITE | IAsyncFile::OPEN_UNCACHED,
+		    0600));
+		file = f;
+		wait(file->truncate(0));
+		TraceEvent("CommitBatchRecordingStarted", self->id)
+		    .detail("Path", self->path)
+		    .detail("MaxBytes", self->maxBytes);
+		loop {
+			state Standalone<StringRef> record = waitNext(records);
+			wait(file->write(record.begin(), record.size(), offset));
+			offset += record.size();
+			self->pendingBytes -= record.size();
+		}
+	} catch (Error& e) {
+		if (e.code() == error_code_actor_cancelled) {
+			throw;
+		}
+		self->recording = false;
+		if (e.code() != error_code_end_of_stream) {
+			TraceEvent(SevWarn, "CommitBatchRecordingError", self->id).error(e).detail("Path", self->path);
+			return Void();
+		}
+	}
+
+	try {
+		wait(file->sync());
+	} catch (Error& e) {
+		if (e.code() == error_code_actor_cancelled) {
+			throw;
+		}
+		TraceEvent(SevWarn, "CommitBatchRecordingError", self->id).error(e).detail("Path", self->path);
+		return Void();
+	}
+	TraceEvent("CommitBatchRecordingFinished", self->id)
+	    .detail("Path", self->path)
+	    .detail("Bytes", offset)
+	    .detail("DroppedBatches", self->droppedBatches);
+	return Void();
+}
+
+} // namespace
+
+CommitBatchRecorder::CommitBatchRecorder(UID id, std::string const& path, int64_t maxBytes, int64_t maxPendingBytes)
+  : id(id), path(path), maxBytes(maxBytes), maxPendingBytes(maxPendingBytes) {
+	writer = writeCommitBatchRecording(this, records.getFuture());
+}
+
+void CommitBatchRecorder::record(RecordedCommitBatchRef const& batch) {
+	if (!recording) {
+		return;
+	}
+	if (pendingBytes > maxPendingBytes) {
+		++droppedBatches;
+		return;
+	}
+	Standalone<StringRef> record = encodeRecordedCommitBatch(batch);
+	if (recordedBytes + record.size() > maxBytes) {
+		// the writer finishes the recording once the records before this one are written
+		recording = false;
+		records.sendError(end_of_stream());
+		return;
+	}
+	recordedBytes += record.size();
+	pendingBytes += record.size();
+	records.send(record);
+}
+
+TEST_CASE("/fdbclient/CommitBatchRecording/decode") {
+	Arena arena;
+	RecordedCommitBatchRef batches[2];
+	for (int i = 0; i < 2; i++) {
+		batches[i].prevVersion = i * 10;
+		batches[i].version = (i + 1) * 10;
+		CommitTransactionRef tr;
+		tr.read_snapshot = i * 10 - 5;
+		tr.read_conflict_ranges.push_back(arena, KeyRangeRef("a"_sr, "b"_sr));
+		tr.write_conflict_ranges.push_back(arena, singleKeyRange("c"_sr, arena));
+		tr.mutations.push_back_deep(arena, MutationRef(MutationRef::SetValue, "c"_sr, StringRef(format("v%d", i))));
+		batches[i].transactions.push_back(arena, tr);
+		batches[i].transactions.push_back(arena, CommitTransactionRef());
+	}
+
+	std::string recording;
+	for (auto const& batch : batches) {
+		recording += encodeRecordedCommitBatch(batch).toString();
+	}
+	// a record that was only partially written
+	recording += encodeRecordedCommitBatch(batches[0]).toString().substr(0, 20);
+
+	Standalone<VectorRef<RecordedCommitBatchRef>> decoded =
+	    decodeCommitBatchRecording(Standalone<StringRef>(StringRef(recording)));
+	ASSERT_EQ(decoded.size(), 2);
+	for (int i = 0; i < 2; i++) {
+		ASSERT_EQ(decoded[i].prevVersion, batches[i].prevVersion);
+		ASSERT_EQ(decoded[i].version, batches[i].version);
+		ASSERT_EQ(decoded[i].transactions.size(), 2);
+		CommitTransactionRef const& tr = decoded[i].transactions[0];
+		ASSERT_EQ(tr.read_snapshot, batches[i].transactions[0].read_snapshot);
+		ASSERT(tr.read_conflict_ranges.size() == 1 && tr.read_conflict_ranges[0] == KeyRangeRef("a"_sr, "b"_sr));
+		ASSERT(tr.write_conflict_ranges.size() == 1 && tr.write_conflict_ranges[0].begin == "c"_sr);
+		ASSERT(tr.mutations.size() == 1 && tr.mutations[0].param2 == batches[i].transactions[0].mutations[0].param2);
+		ASSERT(decoded[i].transactions[1].mutations.empty());
+	}
+
+	return Void();
+}
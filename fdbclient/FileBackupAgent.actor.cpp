@@ -26,6 +26,7 @@
 #include "fdbclient/BlobRestoreCommon.h"
 #include "fdbrpc/TenantInfo.h"
 #include "fdbrpc/simulator.h"
+#include "flow/CompressionUtils.h"
 #include "flow/EncryptUtils.h"
 #include "flow/FastRef.h"
 #include "flow/flow.h"
@@ -1049,6 +1050,171 @@ private:
 	Key lastValue;
 };
 
+// CompressedRangeFileWriter writes the same sequence of keys and values as RangeFileWriter, and is used the same way,
+// but each block holds the compressed encoding of a block of RangeFileWriter without its header:
+//
+//   [BACKUP_AGENT_COMPRESSED_SNAPSHOT_FILE_VERSION][uint8_t CompressionFilter][uint32_t length][compressed data][P]
+//
+// Blocks still start at multiples of the block size, so they can be read in parallel as before. Since the compressed
+// size of a block is only known after compressing it, the writer buffers the keys and values of a block until they
+// reach a target uncompressed size, adapted from how well the previous block compressed. If a block doesn't fit when
+// compressed, its second half is moved to the next block. Blocks that don't compress are stored with
+// CompressionFilter::NONE.
+struct CompressedRangeFileWriter : public IRangeFileWriter {
+	static constexpr int blockHeaderSize = sizeof(uint32_t) + sizeof(uint8_t) + sizeof(uint32_t);
+
+	CompressedRangeFileWriter(Reference<IBackupFile> file, int blockSize, CompressionFilter filter)
+	  : file(file), blockSize(blockSize), filter(filter), targetBlockBytes(blockSize - blockHeaderSize) {}
+
+	static int encodedSize(const KeyValue& kv) { return sizeof(uint32_t) * 2 + kv.key.size() + kv.value.size(); }
+
+	static void writeWithLen(BinaryWriter& wr, StringRef s) {
+		wr << bigEndian32(s.size());
+		wr.serializeBytes(s);
+	}
+
+	// Compresses the block buffered so far, or as much of it as fits, and appends it to the file. The keys and values
+	// that didn't fit start the next block, after the last key and value written, like RangeFileWriter does.
+	ACTOR static Future<Void> writeBlock(CompressedRangeFileWriter* self, bool final) {
+		// the first key and value of blocks after the first repeat the last ones of the previous block, and aren't
+		// progress on their own
+		state int minKVs = self->blockEnd > 0 ? 2 : 1;
+		state int count = self->kvs.size();
+		state bool withEndKey = final && self->endKey.present();
+		state Arena arena;
+		state StringRef stored;
+		state CompressionFilter storedFilter;
+		state int uncompressedSize = 0;
+		loop {
+			BinaryWriter wr(Unversioned());
+			writeWithLen(wr, self->blockBegin);
+			for (int i = 0; i < count; i++) {
+				writeWithLen(wr, self->kvs[i].key);
+				writeWithLen(wr, self->kvs[i].value);
+			}
+			if (withEndKey) {
+				writeWithLen(wr, self->endKey.get());
+			}
+			StringRef uncompressed = wr.toValue(arena);
+			uncompressedSize = uncompressed.size();
+			stored = CompressionUtils::compress(self->filter, uncompressed, arena);
+			storedFilter = self->filter;
+			if (stored.size() >= uncompressed.size()) {
+				stored = uncompressed;
+				storedFilter = CompressionFilter::NONE;
+			}
+			if (blockHeaderSize + stored.size() <= self->blockSize) {
+				break;
+			}
+			if (withEndKey) {
+				// end the file with an extra block holding just the end key
+				withEndKey = false;
+			} else if (count > minKVs) {
+				count = std::max(minKVs, count / 2);
+			} else {
+				throw backup_bad_block_size();
+			}
+		}
+
+		// Pad the previous block to its end
+		int bytesLeft = self->blockEnd - self->file->size();
+		if (bytesLeft > 0) {
+			state Value paddingFFs = makePadding(bytesLeft);
+			wait(self->file->append(paddingFFs.begin(), bytesLeft));
+		}
+		self->blockEnd += self->blockSize;
+
+		BinaryWriter header(Unversioned());
+		header << BACKUP_AGENT_COMPRESSED_SNAPSHOT_FILE_VERSION << (uint8_t)storedFilter << (uint32_t)stored.size();
+		state Standalone<StringRef> headerBytes = header.toValue();
+		wait(self->file->append(headerBytes.begin(), headerBytes.size()));
+		wait(self->file->append(stored.begin(), stored.size()));
+
+		if (withEndKey) {
+			self->kvs.clear();
+			self->endKey.reset();
+		} else {
+			// the last key and value written also start the next block
+			if (count > 0) {
+				self->blockBegin = self->kvs[count - 1].key;
+				self->kvs.erase(self->kvs.begin(), self->kvs.begin() + count - 1);
+			}
+			self->bufferedBytes = 0;
+			for (auto& kv : self->kvs) {
+				self->bufferedBytes += encodedSize(kv);
+			}
+		}
+
+		// Aim the next block at the uncompressed size that would have just filled this one
+		if (stored.size() > 0) {
+			double ratio = std::min(16.0, std::max(1.0, (double)uncompressedSize / stored.size()));
+			self->targetBlockBytes = (self->blockSize - blockHeaderSize) * ratio * 0.9;
+		}
+		return Void();
+	}
+
+	ACTOR static Future<Void> writeKV_impl(CompressedRangeFileWriter* self, Key k, Value v) {
+		self->kvs.push_back(KeyValueRef(k, v));
+		self->bufferedBytes += encodedSize(self->kvs.back());
+		if (self->bufferedBytes > self->targetBlockBytes) {
+			wait(writeBlock(self, false));
+		}
+		return Void();
+	}
+
+	Future<Void> writeKV(Key k, Value v) { return writeKV_impl(this, k, v); }
+
+	// Write begin key or end key.
+	Future<Void> writeKey(Key k) {
+		if (!begun) {
+			begun = true;
+			blockBegin = k;
+		} else {
+			endKey = k;
+		}
+		return Void();
+	}
+
+	ACTOR static Future<Void> finish_impl(CompressedRangeFileWriter* self, bool padToBlock) {
+		if (!self->finished) {
+			ASSERT(self->endKey.present());
+			// more than one block is left if the end key doesn't fit in the last one
+			while (self->endKey.present()) {
+				wait(writeBlock(self, true));
+			}
+			self->finished = true;
+		}
+		if (padToBlock) {
+			ASSERT(g_network->isSimulated());
+			int bytesLeft = self->blockEnd - self->file->size();
+			if (bytesLeft > 0) {
+				state Value paddingFFs = makePadding(bytesLeft);
+				wait(self->file->append(paddingFFs.begin(), bytesLeft));
+			}
+		}
+		return Void();
+	}
+
+	// Used in simulation only to create backup file sizes which are an integer multiple of the block size
+	Future<Void> padEnd(bool final) { return finish_impl(this, true); }
+
+	Future<Void> finish() { return finish_impl(this, false); }
+
+	Reference<IBackupFile> file;
+	int blockSize;
+
+private:
+	CompressionFilter filter;
+	int64_t blockEnd = 0;
+	int64_t targetBlockBytes;
+	int64_t bufferedBytes = 0;
+	bool begun = false;
+	bool finished = false;
+	Key blockBegin;
+	std::vector<KeyValue> kvs;
+	Optional<Key> endKey;
+};
+
 ACTOR static Future<Void> decodeKVPairs(StringRefReader* reader,
                                         Standalone<VectorRef<KeyValueRef>>* results,
                                         bool encryptedBlock,
@@ -1141,13 +1307,35 @@ static Reference<IBackupContainer> getBackupContainerWithProxy(Reference<IBackup
 	return bc;
 }
 
+// Reads the rest of the header of a block written by CompressedRangeFileWriter, after the file version, and returns
+// the block decompressed, which is encoded like a block of RangeFileWriter after its file version.
+static StringRef decompressRangeFileBlock(StringRefReader& reader, Arena& arena) {
+	uint8_t filter = reader.consume<uint8_t>();
+	if (filter >= (uint8_t)CompressionFilter::LAST)
+		throw restore_corrupted_data();
+	uint32_t len = reader.consume<uint32_t>();
+	StringRef compressed(reader.consume(len), len);
+
+	// Make sure any remaining bytes in the block are 0xFF
+	for (auto b : reader.remainder())
+		if (b != 0xFF)
+			throw restore_corrupted_data_padding();
+
+	return CompressionUtils::decompress((CompressionFilter)filter, compressed, arena);
+}
+
 Standalone<VectorRef<KeyValueRef>> decodeRangeFileBlock(const Standalone<StringRef>& buf) {
 	Standalone<VectorRef<KeyValueRef>> results({}, buf.arena());
 	StringRefReader reader(buf, restore_corrupted_data());
 
-	// Read header, currently only decoding BACKUP_AGENT_SNAPSHOT_FILE_VERSION
-	if (reader.consume<int32_t>() != BACKUP_AGENT_SNAPSHOT_FILE_VERSION)
+	// Read header, currently only decoding BACKUP_AGENT_SNAPSHOT_FILE_VERSION or
+	// BACKUP_AGENT_COMPRESSED_SNAPSHOT_FILE_VERSION
+	int32_t file_version = reader.consume<int32_t>();
+	if (file_version == BACKUP_AGENT_COMPRESSED_SNAPSHOT_FILE_VERSION) {
+		reader = StringRefReader(decompressRangeFileBlock(reader, results.arena()), restore_corrupted_data());
+	} else if (file_version != BACKUP_AGENT_SNAPSHOT_FILE_VERSION) {
 		throw restore_unsupported_file_version();
+	}
 
 	// Read begin key, if this fails then block was invalid.
 	uint32_t kLen = reader.consumeNetworkUInt32();
@@ -1199,12 +1387,16 @@ ACTOR Future<Standalone<VectorRef<KeyValueRef>>> decodeRangeFileBlock(Reference<
 	state int64_t blockDomainId = TenantInfo::INVALID_TENANT;
 
 	try {
-		// Read header, currently only decoding BACKUP_AGENT_SNAPSHOT_FILE_VERSION or
-		// BACKUP_AGENT_ENCRYPTED_SNAPSHOT_FILE_VERSION
+		// Read header, currently only decoding BACKUP_AGENT_SNAPSHOT_FILE_VERSION,
+		// BACKUP_AGENT_ENCRYPTED_SNAPSHOT_FILE_VERSION or BACKUP_AGENT_COMPRESSED_SNAPSHOT_FILE_VERSION
 		int32_t file_version = reader.consume<int32_t>();
 		ASSERT(!encryptMode.isEncryptionEnabled() || file_version == BACKUP_AGENT_ENCRYPTED_SNAPSHOT_FILE_VERSION);
 		if (file_version == BACKUP_AGENT_SNAPSHOT_FILE_VERSION) {
 			wait(decodeKVPairs(&reader, &results, false, encryptMode, Optional<int64_t>(), tenantCache));
+		} else if (file_version == BACKUP_AGENT_COMPRESSED_SNAPSHOT_FILE_VERSION) {
+			CODE_PROBE(true, "decoding compressed block");
+			reader = StringRefReader(decompressRangeFileBlock(reader, results.arena()), restore_corrupted_data());
+			wait(decodeKVPairs(&reader, &results, false, encryptMode, Optional<int64_t>(), tenantCache));
 		} else if (file_version == BACKUP_AGENT_ENCRYPTED_SNAPSHOT_FILE_VERSION) {
 			CODE_PROBE(true, "decoding encrypted block");
 			// read header size
@@ -1931,6 +2123,12 @@ struct BackupRangeTaskFunc : BackupTaskFuncBase {
 					CODE_PROBE(true, "using encrypted snapshot file writer");
 					rangeFile = std::make_unique<EncryptedRangeFileWriter>(
 					    cx, &arena, encryptMode, tenantCache, outFile, blockSize);
+				} else if (CLIENT_KNOBS->BACKUP_RANGEFILE_COMPRESSION != "NONE") {
+					CODE_PROBE(true, "using compressed snapshot file writer");
+					rangeFile = std::make_unique<CompressedRangeFileWriter>(
+					    outFile,
+					    blockSize,
+					    CompressionUtils::fromFilterString(CLIENT_KNOBS->BACKUP_RANGEFILE_COMPRESSION));
 				} else {
 					rangeFile = std::make_unique<RangeFileWriter>(outFile, blockSize);
 				}
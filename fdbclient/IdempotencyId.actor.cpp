@@ -28,7 +28,11 @@
 struct IdempotencyIdKVBuilderImpl {
 	Optional<Version> commitVersion;
 	Optional<uint8_t> batchIndexHighOrderByte;
-	BinaryWriter value{ IncludeVersion() };
+	bool compactEncoding = false;
+	int64_t timestamp = 0;
+	Arena arena;
+	// The ids and the low order bytes of their batch indexes, in order of batch index
+	std::vector<std::pair<StringRef, uint8_t>> ids;
 };
 
 IdempotencyIdKVBuilder::IdempotencyIdKVBuilder() : impl(PImpl<IdempotencyIdKVBuilderImpl>::create()) {}
@@ -37,18 +41,47 @@ void IdempotencyIdKVBuilder::setCommitVersion(Version commitVersion) {
 	impl->commitVersion = commitVersion;
 }
 
+void IdempotencyIdKVBuilder::setCompactEncoding(bool compactEncoding) {
+	impl->compactEncoding = compactEncoding;
+}
+
 void IdempotencyIdKVBuilder::add(const IdempotencyIdRef& id, uint16_t batchIndex) {
 	ASSERT(id.valid());
 	if (impl->batchIndexHighOrderByte.present()) {
 		ASSERT((batchIndex >> 8) == impl->batchIndexHighOrderByte.get());
+		ASSERT(uint8_t(batchIndex) > impl->ids.back().second);
 	} else {
 		impl->batchIndexHighOrderByte = batchIndex >> 8;
-		impl->value << int64_t(now());
+		impl->timestamp = int64_t(now());
+	}
+	impl->ids.emplace_back(StringRef(impl->arena, id.asStringRefUnsafe()), uint8_t(batchIndex));
+}
+
+// Writes the ids in the compact format if they all have the same length. The low order bytes of their batch indexes
+// are written as runs of consecutive indexes, so they take two bytes in all when every transaction of the key has an
+// id.
+static bool writeCompactIds(BinaryWriter& writer, std::vector<std::pair<StringRef, uint8_t>> const& ids) {
+	const int length = ids.front().first.size();
+	std::vector<std::pair<uint8_t, uint8_t>> runs; // first index and length - 1
+	for (auto const& [id, lowOrderBatchIndex] : ids) {
+		if (id.size() != length) {
+			return false;
+		}
+		if (!runs.empty() && runs.back().first + runs.back().second + 1 == lowOrderBatchIndex) {
+			++runs.back().second;
+		} else {
+			runs.emplace_back(lowOrderBatchIndex, 0);
+		}
+	}
+	// A leading zero cannot be the length of an id in the original format
+	writer << uint8_t(0) << uint8_t(length) << uint8_t(runs.size() - 1);
+	for (auto const& [first, lengthMinusOne] : runs) {
+		writer << first << lengthMinusOne;
 	}
-	StringRef s = id.asStringRefUnsafe();
-	impl->value << uint8_t(s.size());
-	impl->value.serializeBytes(s);
-	impl->value << uint8_t(batchIndex); // Low order byte of batchIndex
+	for (auto const& [id, lowOrderBatchIndex] : ids) {
+		writer.serializeBytes(id);
+	}
+	return true;
 }
 
 Optional<KeyValue> IdempotencyIdKVBuilder::buildAndClear() {
@@ -57,13 +90,23 @@ Optional<KeyValue> IdempotencyIdKVBuilder::buildAndClear() {
 		return {};
 	}
 
-	Value v = impl->value.toValue();
+	BinaryWriter writer{ IncludeVersion() };
+	writer << impl->timestamp;
+	if (!impl->compactEncoding || !writeCompactIds(writer, impl->ids)) {
+		for (auto const& [id, lowOrderBatchIndex] : impl->ids) {
+			writer << uint8_t(id.size());
+			writer.serializeBytes(id);
+			writer << lowOrderBatchIndex;
+		}
+	}
+	Value v = writer.toValue();
 
 	KeyRef key =
 	    makeIdempotencySingleKeyRange(v.arena(), impl->commitVersion.get(), impl->batchIndexHighOrderByte.get()).begin;
 
-	impl->value = BinaryWriter(IncludeVersion());
 	impl->batchIndexHighOrderByte = Optional<uint8_t>();
+	impl->ids.clear();
+	impl->arena = Arena();
 
 	Optional<KeyValue> result = KeyValue();
 	result.get().arena() = v.arena();
@@ -87,15 +130,8 @@ Optional<CommitResult> kvContainsIdempotencyId(const KeyValueRef& kv, const Idem
 #endif
 
 	// Even if id is a substring of value, it may still not actually contain it.
-	BinaryReader reader(kv.value.begin(), kv.value.size(), IncludeVersion());
 	int64_t timestamp; // ignored
-	reader >> timestamp;
-	while (!reader.empty()) {
-		uint8_t length;
-		reader >> length;
-		StringRef candidate{ reinterpret_cast<const uint8_t*>(reader.readBytes(length)), length };
-		uint8_t lowOrderBatchIndex;
-		reader >> lowOrderBatchIndex;
+	for (auto const& [candidate, lowOrderBatchIndex] : decodeIdempotencyValue(kv.value, timestamp)) {
 		if (candidate == needle) {
 			Version commitVersion;
 			uint8_t highOrderBatchIndex;
@@ -108,6 +144,37 @@ Optional<CommitResult> kvContainsIdempotencyId(const KeyValueRef& kv, const Idem
 	return {};
 }
 
+std::vector<std::pair<StringRef, uint8_t>> decodeIdempotencyValue(ValueRef value, int64_t& timestamp) {
+	std::vector<std::pair<StringRef, uint8_t>> ids;
+	BinaryReader reader(value.begin(), value.size(), IncludeVersion());
+	reader >> timestamp;
+	if (!reader.empty() && *reinterpret_cast<const uint8_t*>(reader.peekBytes(1)) == 0) {
+		uint8_t zero, length, runCount;
+		reader >> zero >> length >> runCount;
+		std::vector<std::pair<uint8_t, uint8_t>> runs(int(runCount) + 1);
+		for (auto& [first, lengthMinusOne] : runs) {
+			reader >> first >> lengthMinusOne;
+		}
+		for (auto const& [first, lengthMinusOne] : runs) {
+			for (int i = 0; i <= lengthMinusOne; ++i) {
+				ids.emplace_back(StringRef(reinterpret_cast<const uint8_t*>(reader.readBytes(length)), length),
+				                 uint8_t(first + i));
+			}
+		}
+		ASSERT(reader.empty());
+		return ids;
+	}
+	while (!reader.empty()) {
+		uint8_t length;
+		reader >> length;
+		StringRef id{ reinterpret_cast<const uint8_t*>(reader.readBytes(length)), length };
+		uint8_t lowOrderBatchIndex;
+		reader >> lowOrderBatchIndex;
+		ids.emplace_back(id, lowOrderBatchIndex);
+	}
+	return ids;
+}
+
 void forceLinkIdempotencyIdTests() {}
 
 namespace {
@@ -129,6 +196,7 @@ TEST_CASE("/fdbclient/IdempotencyId/basic") {
 	std::unordered_set<IdempotencyIdRef> idSet; // Make sure hash+equals works
 	IdempotencyIdKVBuilder builder; // Check kv data format
 	builder.setCommitVersion(commitVersion);
+	builder.setCompactEncoding(deterministicRandom()->coinflip());
 
 	for (int i = 0; i < 5; ++i) {
 		auto id = generate(arena);
@@ -155,10 +223,62 @@ TEST_CASE("/fdbclient/IdempotencyId/basic") {
 	ASSERT(idSet.size() == 0);
 
 	ASSERT(!kvContainsIdempotencyId(kv, generate(arena)).present());
+	ASSERT(makeIdempotencyVersionRange(arena, commitVersion).contains(kv.key));
+	ASSERT(!makeIdempotencyVersionRange(arena, commitVersion + 1).contains(kv.key));
 
 	return Void();
 }
 
+TEST_CASE("/fdbclient/IdempotencyId/compact") {
+	Version commitVersion = deterministicRandom()->randomInt64(0, std::numeric_limits<Version>::max());
+	uint8_t highOrderBatchIndex = deterministicRandom()->randomInt(0, 256);
+	for (int i = 0; i < 100; ++i) {
+		Arena arena;
+		int length = deterministicRandom()->coinflip() ? 16 : deterministicRandom()->randomInt(16, 256);
+		bool mixedLengths = deterministicRandom()->random01() < 0.1;
+		std::vector<std::pair<IdempotencyIdRef, uint8_t>> ids;
+		for (int low = 0; low < 256; ++low) {
+			if (deterministicRandom()->random01() < 0.7) {
+				StringRef id = makeString(mixedLengths ? deterministicRandom()->randomInt(16, 256) : length, arena);
+				deterministicRandom()->randomBytes(mutateString(id), id.size());
+				ids.emplace_back(IdempotencyIdRef(id), low);
+			}
+		}
+		if (ids.empty()) {
+			continue;
+		}
+
+		IdempotencyIdKVBuilder compact, original;
+		compact.setCommitVersion(commitVersion);
+		compact.setCompactEncoding(true);
+		original.setCommitVersion(commitVersion);
+		for (auto const& [id, low] : ids) {
+			compact.add(id, (uint16_t(highOrderBatchIndex) << 8) | low);
+			original.add(id, (uint16_t(highOrderBatchIndex) << 8) | low);
+		}
+		KeyValue kv = compact.buildAndClear().get();
+		KeyValue originalKv = original.buildAndClear().get();
+		ASSERT(kv.key == originalKv.key);
+		if (!mixedLengths) {
+			ASSERT_LT(kv.value.size(), originalKv.value.size() + 3);
+		}
+
+		int64_t timestamp;
+		auto decoded = decodeIdempotencyValue(kv.value, timestamp);
+		ASSERT_EQ(decoded.size(), ids.size());
+		for (int j = 0; j < ids.size(); ++j) {
+			ASSERT(decoded[j].first == ids[j].first.asStringRefUnsafe());
+			ASSERT_EQ(decoded[j].second, ids[j].second);
+			auto commitResult = kvContainsIdempotencyId(kv, ids[j].first);
+			ASSERT(commitResult.present());
+			ASSERT_EQ(commitResult.get().commitVersion, commitVersion);
+			ASSERT_EQ(commitResult.get().batchIndex, (uint16_t(highOrderBatchIndex) << 8) | ids[j].second);
+		}
+		ASSERT(!kvContainsIdempotencyId(kv, generate(arena)).present());
+	}
+	return Void();
+}
+
 TEST_CASE("/fdbclient/IdempotencyId/serialization") {
 	ASSERT(ObjectReader::fromStringRef<IdempotencyIdRef>(ObjectWriter::toValue(IdempotencyIdRef(), Unversioned()),
 	                                                     Unversioned()) == IdempotencyIdRef());
@@ -197,6 +317,13 @@ KeyRangeRef makeIdempotencySingleKeyRange(Arena& arena, Version version, uint8_t
 	return KeyRangeRef(second.removeSuffix("\x00"_sr), second);
 }
 
+KeyRangeRef makeIdempotencyVersionRange(Arena& arena, Version version) {
+	ASSERT(version >= 0 && version < std::numeric_limits<Version>::max());
+	return KeyRangeRef(
+	    idempotencyIdKeys.begin.withSuffix(BinaryWriter::toValue(bigEndian64(version), Unversioned()), arena),
+	    idempotencyIdKeys.begin.withSuffix(BinaryWriter::toValue(bigEndian64(version + 1), Unversioned()), arena));
+}
+
 void decodeIdempotencyKey(KeyRef key, Version& commitVersion, uint8_t& highOrderBatchIndex) {
 	BinaryReader reader(key, Unversioned());
 	reader.readBytes(idempotencyIdKeys.begin.size());
@@ -417,4 +417,31 @@ TEST_CASE("/keyrangemap/decoderange/unaligned") {
 	ASSERT(decodedRanges.back().value == keyD);
 
 	return Void();
-}
\ No newline at end of file
+}
+TEST_CASE("/keyrangemap/cursor") {
+	KeyRangeMap<int> map(-1);
+	for (int i = 0; i < 100; i++) {
+		int begin = deterministicRandom()->randomInt(0, 1000);
+		int end = begin + deterministicRandom()->randomInt(1, 50);
+		map.insert(KeyRangeRef(Key(format("%04d", begin)), Key(format("%04d", end))), i);
+	}
+
+	// Keys mostly ascending, with jumps back, repeats and some keys outside the map
+	for (int round = 0; round < 10; round++) {
+		KeyRangeMapCursor<int> cursor(map, deterministicRandom()->randomInt(0, 5));
+		int k = 0;
+		for (int i = 0; i < 1000; i++) {
+			int r = deterministicRandom()->randomInt(0, 100);
+			if (r < 5) {
+				k = deterministicRandom()->randomInt(0, 1100);
+			} else if (r < 80) {
+				k += deterministicRandom()->randomInt(0, 4);
+			}
+			Key key = r == 99 ? allKeys.end : Key(format("%04d", k));
+			auto expected = map.rangeContaining(key);
+			ASSERT(cursor.rangeContaining(key) == expected);
+		}
+	}
+
+	return Void();
+}
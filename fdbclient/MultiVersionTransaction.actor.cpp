@@ -2708,6 +2708,119 @@ void MultiVersionDatabase::LegacyVersionMonitor::close() {
 	}
 }
 
+// MultiThreadDatabase
+MultiThreadDatabase::MultiThreadDatabase(std::vector<Reference<IDatabase>> databases, std::vector<int> threadIds)
+  : databases(std::move(databases)), threadIds(std::move(threadIds)), next(0),
+    transactionsStarted(new std::atomic<int64_t>[this->databases.size()]) {
+	ASSERT(!this->databases.empty() && this->databases.size() == this->threadIds.size());
+	for (int i = 0; i < this->databases.size(); ++i) {
+		transactionsStarted[i] = 0;
+	}
+}
+
+MultiThreadDatabase::~MultiThreadDatabase() {
+	TraceEvent te("MultiThreadDatabaseClosed");
+	te.detail("Threads", databases.size());
+	for (int i = 0; i < databases.size(); ++i) {
+		te.detail(format("Thread%dTransactions", threadIds[i]), transactionsStarted[i].load());
+	}
+}
+
+Reference<IDatabase> const& MultiThreadDatabase::nextDatabase() {
+	int i = next.fetch_add(1, std::memory_order_relaxed) % databases.size();
+	transactionsStarted[i].fetch_add(1, std::memory_order_relaxed);
+	return databases[i];
+}
+
+Reference<ITenant> MultiThreadDatabase::openTenant(TenantNameRef tenantName) {
+	return nextDatabase()->openTenant(tenantName);
+}
+
+Reference<ITransaction> MultiThreadDatabase::createTransaction() {
+	return nextDatabase()->createTransaction();
+}
+
+void MultiThreadDatabase::setOption(FDBDatabaseOptions::Option option, Optional<StringRef> value) {
+	for (auto& db : databases) {
+		db->setOption(option, value);
+	}
+}
+
+double MultiThreadDatabase::getMainThreadBusyness() {
+	double busyness = 0;
+	for (auto& db : databases) {
+		busyness = std::max(busyness, db->getMainThreadBusyness());
+	}
+	return busyness;
+}
+
+ThreadFuture<ProtocolVersion> MultiThreadDatabase::getServerProtocol(Optional<ProtocolVersion> expectedVersion) {
+	return databases[0]->getServerProtocol(expectedVersion);
+}
+
+ThreadFuture<int64_t> MultiThreadDatabase::rebootWorker(const StringRef& address, bool check, int duration) {
+	return databases[0]->rebootWorker(address, check, duration);
+}
+
+ThreadFuture<Void> MultiThreadDatabase::forceRecoveryWithDataLoss(const StringRef& dcid) {
+	return databases[0]->forceRecoveryWithDataLoss(dcid);
+}
+
+ThreadFuture<Void> MultiThreadDatabase::createSnapshot(const StringRef& uid, const StringRef& snapshot_command) {
+	return databases[0]->createSnapshot(uid, snapshot_command);
+}
+
+ThreadFuture<Key> MultiThreadDatabase::purgeBlobGranules(const KeyRangeRef& keyRange,
+                                                         Version purgeVersion,
+                                                         bool force) {
+	return databases[0]->purgeBlobGranules(keyRange, purgeVersion, force);
+}
+
+ThreadFuture<Void> MultiThreadDatabase::waitPurgeGranulesComplete(const KeyRef& purgeKey) {
+	return databases[0]->waitPurgeGranulesComplete(purgeKey);
+}
+
+ThreadFuture<bool> MultiThreadDatabase::blobbifyRange(const KeyRangeRef& keyRange) {
+	return databases[0]->blobbifyRange(keyRange);
+}
+
+ThreadFuture<bool> MultiThreadDatabase::blobbifyRangeBlocking(const KeyRangeRef& keyRange) {
+	return databases[0]->blobbifyRangeBlocking(keyRange);
+}
+
+ThreadFuture<bool> MultiThreadDatabase::unblobbifyRange(const KeyRangeRef& keyRange) {
+	return databases[0]->unblobbifyRange(keyRange);
+}
+
+ThreadFuture<Standalone<VectorRef<KeyRangeRef>>> MultiThreadDatabase::listBlobbifiedRanges(const KeyRangeRef& keyRange,
+                                                                                           int rangeLimit) {
+	return databases[0]->listBlobbifiedRanges(keyRange, rangeLimit);
+}
+
+ThreadFuture<Version> MultiThreadDatabase::verifyBlobRange(const KeyRangeRef& keyRange, Optional<Version> version) {
+	return databases[0]->verifyBlobRange(keyRange, version);
+}
+
+ThreadFuture<bool> MultiThreadDatabase::flushBlobRange(const KeyRangeRef& keyRange,
+                                                       bool compact,
+                                                       Optional<Version> version) {
+	return databases[0]->flushBlobRange(keyRange, compact, version);
+}
+
+ThreadFuture<DatabaseSharedState*> MultiThreadDatabase::createSharedState() {
+	return databases[0]->createSharedState();
+}
+
+void MultiThreadDatabase::setSharedState(DatabaseSharedState* p) {
+	for (auto& db : databases) {
+		db->setSharedState(p);
+	}
+}
+
+ThreadFuture<Standalone<StringRef>> MultiThreadDatabase::getClientStatus() {
+	return databases[0]->getClientStatus();
+}
+
 // MultiVersionApi
 void MultiVersionApi::runOnExternalClientsAllThreads(std::function<void(Reference<ClientInfo>)> func,
                                                      bool runOnFailedClients,
@@ -3035,6 +3148,13 @@ void MultiVersionApi::setNetworkOptionInternal(FDBNetworkOptions::Option option,
 		// multiple client threads are not supported on windows.
 		threadCount = extractIntOption(value, 1, 1);
 #endif
+	} else if (option == FDBNetworkOptions::CLIENT_THREADS_PER_DATABASE) {
+		MutexHolder holder(lock);
+		validateOption(value, true, false, false);
+		if (networkStartSetup) {
+			throw invalid_option();
+		}
+		threadsPerDatabase = extractIntOption(value, 1, 1024);
 	} else if (option == FDBNetworkOptions::CLIENT_TMP_DIR) {
 		validateOption(value, true, false, false);
 		tmpDir = abspath(value.get().toString());
@@ -3097,6 +3217,7 @@ void MultiVersionApi::setupNetwork() {
 			if (threadCount > 1) {
 				disableLocalClient();
 			}
+			threadsPerDatabase = std::min(threadsPerDatabase, std::max(threadCount, 1));
 
 			networkStartSetup = true;
 
@@ -3305,12 +3426,25 @@ Reference<IDatabase> MultiVersionApi::createDatabase(ClusterConnectionRecord con
 		ASSERT(!bypassMultiClientApi);
 
 		int threadIdx = nextThread;
-		nextThread = (nextThread + 1) % threadCount;
+		int databaseThreads = threadsPerDatabase;
+		nextThread = (nextThread + databaseThreads) % threadCount;
 		lock.leave();
 
 		Reference<IDatabase> localDb = connectionRecord.createDatabase(localClient->api);
-		return Reference<IDatabase>(
-		    new MultiVersionDatabase(this, threadIdx, connectionRecord, Reference<IDatabase>(), localDb));
+		if (databaseThreads == 1) {
+			return Reference<IDatabase>(
+			    new MultiVersionDatabase(this, threadIdx, connectionRecord, Reference<IDatabase>(), localDb));
+		}
+
+		// The databases on each thread share the local database that monitors the protocol version
+		std::vector<Reference<IDatabase>> databases;
+		std::vector<int> threadIds;
+		for (int i = 0; i < databaseThreads; ++i) {
+			threadIds.push_back((threadIdx + i) % threadCount);
+			databases.push_back(Reference<IDatabase>(
+			    new MultiVersionDatabase(this, threadIds.back(), connectionRecord, Reference<IDatabase>(), localDb)));
+		}
+		return Reference<IDatabase>(new MultiThreadDatabase(std::move(databases), std::move(threadIds)));
 	}
 
 	lock.leave();
@@ -55,6 +55,16 @@ Standalone<RangeResultRef> RangeResultBlock::consume() {
 	    RangeResultRef(result.slice(startIndex, indexToRead), result.more, result.readThrough), result.arena());
 }
 
+void PipelinedReader::release(const RangeResultBlock& block) {
+	readerLimit.release();
+	if (block.prefetchBytes > 0) {
+		prefetchLimit->release(block.prefetchBytes);
+	}
+	if (--unconsumed == 0) {
+		drained.trigger();
+	}
+}
+
 void PipelinedReader::startReading(Database cx) {
 	reader = getNext(cx);
 }
@@ -78,6 +88,18 @@ ACTOR Future<Void> PipelinedReader::getNext_impl(PipelinedReader* self, Database
 		// Get the lock
 		wait(self->readerLimit.take());
 
+		// Reading ahead of the consumer takes from the shared prefetch budget, unless the consumer catches up with
+		// this reader first, in which case the read is needed to make progress
+		state int64_t prefetchBytes = 0;
+		if (self->unconsumed > 0) {
+			choose {
+				when(wait(self->prefetchLimit->take(TaskPriority::DefaultYield, limits.bytes))) {
+					prefetchBytes = limits.bytes;
+				}
+				when(wait(self->drained.onTrigger())) {}
+			}
+		}
+
 		// Read begin to end forever until successful
 		loop {
 			try {
@@ -88,6 +110,7 @@ ACTOR Future<Void> PipelinedReader::getNext_impl(PipelinedReader* self, Database
 
 				// No more results, send end of stream
 				if (!kvs.empty()) {
+					++self->unconsumed;
 					// Send results to the reads stream
 					self->reads.send(
 					    RangeResultBlock{ .result = kvs,
@@ -95,7 +118,10 @@ ACTOR Future<Void> PipelinedReader::getNext_impl(PipelinedReader* self, Database
 					                      .lastVersion = keyRefToVersion(kvs.back().key, self->prefix.size()),
 					                      .hash = self->hash,
 					                      .prefixLen = self->prefix.size(),
-					                      .indexToRead = 0 });
+					                      .indexToRead = 0,
+					                      .prefetchBytes = prefetchBytes });
+				} else if (prefetchBytes > 0) {
+					self->prefetchLimit->release(prefetchBytes);
 				}
 
 				if (!kvs.more) {
@@ -155,7 +181,7 @@ ACTOR Future<Standalone<RangeResultRef>> MutationLogReader::getNext_impl(Mutatio
 		uint8_t hash = top.hash;
 		state Standalone<RangeResultRef> ret = top.consume();
 		if (top.empty()) {
-			self->pipelinedReaders[(int)hash]->release();
+			self->pipelinedReaders[(int)hash]->release(top);
 			try {
 				mutation_log_reader::RangeResultBlock next =
 				    waitNext(self->pipelinedReaders[(int)hash]->reads.getFuture());
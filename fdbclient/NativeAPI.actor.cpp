@@ -48,6 +48,7 @@
 #include "fdbclient/AnnotateActor.h"
 #include "fdbclient/Atomic.h"
 #include "fdbclient/BlobGranuleCommon.h"
+#include "fdbclient/BlobGranuleReader.actor.h"
 #include "fdbclient/BlobGranuleRequest.actor.h"
 #include "fdbclient/ClusterInterface.h"
 #include "fdbclient/ClusterConnectionFile.h"
@@ -349,6 +350,28 @@ void DatabaseContext::getLatestCommitVersions(const Reference<LocationInfo>& loc
 	}
 }
 
+// With SHARE_GRV_BATCHES, the first of the databases sharing a DatabaseSharedState to ask for a read version batches
+// the requests of all of them, until it is destroyed
+std::unordered_map<DatabaseSharedState*, DatabaseContext*>& grvBatchOwners() {
+	static std::unordered_map<DatabaseSharedState*, DatabaseContext*> owners;
+	return owners;
+}
+
+// The database whose batchers a transaction on cx sends its read version request to. Tagged requests stay on cx, since
+// the replies update cx's throttled tags, as do switchable databases and those using version vectors, which keep
+// state from the replies of their own requests.
+DatabaseContext* grvBatchingDatabase(DatabaseContext* cx, const TransactionOptions& options) {
+	if (!CLIENT_KNOBS->SHARE_GRV_BATCHES || !cx->sharedStatePtr || cx->switchable || !options.tags.empty() ||
+	    cx->ssVersionVectorCache.getMaxVersion() != invalidVersion) {
+		return cx;
+	}
+	DatabaseContext*& owner = grvBatchOwners()[cx->sharedStatePtr];
+	if (!owner) {
+		owner = cx;
+	}
+	return owner->ssVersionVectorCache.getMaxVersion() == invalidVersion ? owner : cx;
+}
+
 void updateCachedReadVersionShared(double t, Version v, DatabaseSharedState* p) {
 	MutexHolder mutex(p->mutexLock);
 	if (v >= p->grvCacheSpace.cachedReadVersion) {
@@ -688,6 +711,10 @@ ACTOR Future<Void> databaseLogger(DatabaseContext* cx) {
 			    .detail("MeanCommitLatency", cx->commitLatencies.mean())
 			    .detail("MedianCommitLatency", cx->commitLatencies.median())
 			    .detail("MaxCommitLatency", cx->commitLatencies.max())
+			    .detail("MedianGetRangeLatency", cx->getRangeLatencies.median())
+			    .detail("MaxGetRangeLatency", cx->getRangeLatencies.max())
+			    .detail("MedianLocationLatency", cx->locationLatencies.median())
+			    .detail("MaxLocationLatency", cx->locationLatencies.max())
 			    .detail("MeanMutationsPerCommit", cx->mutationsPerCommit.mean())
 			    .detail("MedianMutationsPerCommit", cx->mutationsPerCommit.median())
 			    .detail("MaxMutationsPerCommit", cx->mutationsPerCommit.max())
@@ -736,6 +763,9 @@ ACTOR Future<Void> databaseLogger(DatabaseContext* cx) {
 		cx->readLatencies.clear();
 		cx->GRVLatencies.clear();
 		cx->commitLatencies.clear();
+		cx->getRangeLatencies.clear();
+		cx->locationLatencies.clear();
+		cx->latenciesStartTime = now();
 		cx->mutationsPerCommit.clear();
 		cx->bytesPerCommit.clear();
 		cx->bgLatencies.clear();
@@ -1552,6 +1582,8 @@ DatabaseContext::DatabaseContext(Reference<AsyncVar<Reference<IClusterConnection
     transactionsCommitStarted("CommitStarted", cc), transactionsCommitCompleted("CommitCompleted", cc),
     transactionKeyServerLocationRequests("KeyServerLocationRequests", cc),
     transactionKeyServerLocationRequestsCompleted("KeyServerLocationRequestsCompleted", cc),
+    locationCacheHits("LocationCacheHits", cc), locationCacheMisses("LocationCacheMisses", cc),
+    locationCacheInvalidations("LocationCacheInvalidations", cc), locationCacheEvictions("LocationCacheEvictions", cc),
     transactionBlobGranuleLocationRequests("BlobGranuleLocationRequests", cc),
     transactionBlobGranuleLocationRequestsCompleted("BlobGranuleLocationRequestsCompleted", cc),
     transactionStatusRequests("StatusRequests", cc), transactionTenantLookupRequests("TenantLookupRequests", cc),
@@ -1599,6 +1631,7 @@ DatabaseContext::DatabaseContext(Reference<AsyncVar<Reference<IClusterConnection
 	clientDBInfoMonitor = monitorClientDBInfoChange(this, clientInfo, &proxiesChangeTrigger);
 	tssMismatchHandler = handleTssMismatches(this);
 	clientStatusUpdater.actor = clientStatusUpdateActor(this);
+	latenciesStartTime = now();
 	cacheListMonitor = monitorCacheList(this);
 
 	smoothMidShardSize.reset(CLIENT_KNOBS->INIT_MID_SHARD_BYTES);
@@ -1747,6 +1780,9 @@ DatabaseContext::DatabaseContext(Reference<AsyncVar<Reference<IClusterConnection
 		registerSpecialKeysImpl(SpecialKeySpace::MODULE::TRANSACTION,
 		                        SpecialKeySpace::IMPLTYPE::READONLY,
 		                        std::make_unique<WriteConflictRangeImpl>(writeConflictRangeKeysRange));
+		registerSpecialKeysImpl(SpecialKeySpace::MODULE::TRANSACTION,
+		                        SpecialKeySpace::IMPLTYPE::READONLY,
+		                        std::make_unique<TransactionTimelineImpl>(transactionTimelineRange));
 		registerSpecialKeysImpl(SpecialKeySpace::MODULE::METRICS,
 		                        SpecialKeySpace::IMPLTYPE::READONLY,
 		                        std::make_unique<DDStatsRangeImpl>(ddStatsRange));
@@ -1865,6 +1901,8 @@ DatabaseContext::DatabaseContext(const Error& err)
     transactionsCommitStarted("CommitStarted", cc), transactionsCommitCompleted("CommitCompleted", cc),
     transactionKeyServerLocationRequests("KeyServerLocationRequests", cc),
     transactionKeyServerLocationRequestsCompleted("KeyServerLocationRequestsCompleted", cc),
+    locationCacheHits("LocationCacheHits", cc), locationCacheMisses("LocationCacheMisses", cc),
+    locationCacheInvalidations("LocationCacheInvalidations", cc), locationCacheEvictions("LocationCacheEvictions", cc),
     transactionBlobGranuleLocationRequests("BlobGranuleLocationRequests", cc),
     transactionBlobGranuleLocationRequestsCompleted("BlobGranuleLocationRequestsCompleted", cc),
     transactionStatusRequests("StatusRequests", cc), transactionTenantLookupRequests("TenantLookupRequests", cc),
@@ -1924,6 +1962,10 @@ DatabaseContext::~DatabaseContext() {
 		grvUpdateHandler.cancel();
 	}
 	if (sharedStatePtr) {
+		auto owner = grvBatchOwners().find(sharedStatePtr);
+		if (owner != grvBatchOwners().end() && owner->second == this) {
+			grvBatchOwners().erase(owner);
+		}
 		sharedStatePtr->delRef(sharedStatePtr);
 	}
 	for (auto it = server_interf.begin(); it != server_interf.end(); it = server_interf.erase(it))
@@ -1954,9 +1996,12 @@ Optional<KeyRangeLocationInfo> DatabaseContext::getCachedLocation(const TenantIn
 	auto range =
 	    isBackward ? locationCache.rangeContainingKeyBefore(resolvedKey) : locationCache.rangeContaining(resolvedKey);
 	if (range->value()) {
+		++locationCacheHits;
+		range->value()->lastAccessTime = now();
 		return KeyRangeLocationInfo(toPrefixRelativeRange(range->range(), tenant.prefix), range->value());
 	}
 
+	++locationCacheMisses;
 	return Optional<KeyRangeLocationInfo>();
 }
 
@@ -1982,9 +2027,11 @@ bool DatabaseContext::getCachedLocations(const TenantInfo& tenant,
 		auto r = reverse ? end : begin;
 		if (!r->value()) {
 			CODE_PROBE(result.size(), "had some but not all cached locations");
+			++locationCacheMisses;
 			result.clear();
 			return false;
 		}
+		r->value()->lastAccessTime = now();
 		result.emplace_back(toPrefixRelativeRange(r->range() & resolvedRange, tenant.prefix), r->value());
 		if (result.size() == limit || begin == end) {
 			break;
@@ -1996,6 +2043,7 @@ bool DatabaseContext::getCachedLocations(const TenantInfo& tenant,
 			++begin;
 	}
 
+	++locationCacheHits;
 	return true;
 }
 
@@ -2009,12 +2057,24 @@ Reference<LocationInfo> DatabaseContext::setCachedLocation(const KeyRangeRef& ab
 
 	int maxEvictionAttempts = 100, attempts = 0;
 	auto loc = makeReference<LocationInfo>(serverRefs);
+	loc->lastAccessTime = now();
 	while (locationCache.size() > locationCacheSize && attempts < maxEvictionAttempts) {
 		CODE_PROBE(true, "NativeAPI storage server locationCache entry evicted");
 		attempts++;
-		auto r = locationCache.randomRange();
-		Key begin = r.begin(), end = r.end(); // insert invalidates r, so can't be passed a mere reference into it
-		locationCache.insert(KeyRangeRef(begin, end), Reference<LocationInfo>());
+		// Evict the least recently used of a few random entries, which approximates LRU without keeping a list
+		Optional<KeyRange> victim;
+		double victimAccessTime = std::numeric_limits<double>::max();
+		for (int i = 0; i < CLIENT_KNOBS->LOCATION_CACHE_EVICTION_SAMPLES; i++) {
+			auto r = locationCache.randomRange();
+			if (r.value() && r.value()->lastAccessTime < victimAccessTime) {
+				victim = KeyRange(r.range()); // insert invalidates r, so can't be passed a mere reference into it
+				victimAccessTime = r.value()->lastAccessTime;
+			}
+		}
+		if (victim.present()) {
+			++locationCacheEvictions;
+			locationCache.insert(victim.get(), Reference<LocationInfo>());
+		}
 	}
 	locationCache.insert(absoluteKeys, loc);
 	return loc;
@@ -2028,10 +2088,11 @@ void DatabaseContext::invalidateCache(const Optional<KeyRef>& tenantPrefix, cons
 		resolvedKey = resolvedKey.withPrefix(tenantPrefix.get(), arena);
 	}
 
-	if (isBackward) {
-		locationCache.rangeContainingKeyBefore(resolvedKey)->value() = Reference<LocationInfo>();
-	} else {
-		locationCache.rangeContaining(resolvedKey)->value() = Reference<LocationInfo>();
+	auto& location = isBackward ? locationCache.rangeContainingKeyBefore(resolvedKey)->value()
+	                            : locationCache.rangeContaining(resolvedKey)->value();
+	if (location) {
+		++locationCacheInvalidations;
+		location = Reference<LocationInfo>();
 	}
 }
 
@@ -2044,6 +2105,11 @@ void DatabaseContext::invalidateCache(const Optional<KeyRef>& tenantPrefix, cons
 	}
 
 	auto rs = locationCache.intersectingRanges(resolvedKeys);
+	for (auto r = rs.begin(); r != rs.end(); ++r) {
+		if (r->value()) {
+			++locationCacheInvalidations;
+		}
+	}
 	Key begin = rs.begin().begin(),
 	    end = rs.end().begin(); // insert invalidates rs, so can't be passed a mere reference into it
 	locationCache.insert(KeyRangeRef(begin, end), Reference<LocationInfo>());
@@ -3030,24 +3096,51 @@ ACTOR Future<KeyRangeLocationInfo> getKeyLocation_internal(Database cx,
 	if (debugID.present())
 		g_traceBatch.addEvent("TransactionDebug", debugID.get().first(), "NativeAPI.getKeyLocation.Before");
 
+	// A miss is usually followed by misses on the neighbouring shards (by a range read, or by a scan of keys in
+	// order), so the request also fetches the locations of the next shards in the direction of the read. The shard
+	// containing the key is always the first result.
+	state KeyRef begin = key;
+	state Optional<KeyRef> end;
+	state int limit = 100;
+	if (CLIENT_KNOBS->LOCATION_CACHE_PREFETCH_SHARDS > 1) {
+		limit = CLIENT_KNOBS->LOCATION_CACHE_PREFETCH_SHARDS;
+		if (isBackward) {
+			begin = allKeys.begin;
+			end = key;
+		} else {
+			end = allKeys.end;
+		}
+	}
+
 	loop {
 		try {
 			wait(cx->getBackoff());
 			++cx->transactionKeyServerLocationRequests;
 			choose {
 				when(wait(cx->onProxiesChanged())) {}
-				when(GetKeyServerLocationsReply rep = wait(basicLoadBalance(
-				         cx->getCommitProxies(useProvisionalProxies),
-				         &CommitProxyInterface::getKeyServersLocations,
-				         GetKeyServerLocationsRequest(
-				             span.context, tenant, key, Optional<KeyRef>(), 100, isBackward, version, key.arena()),
-				         TaskPriority::DefaultPromiseEndpoint))) {
+				when(GetKeyServerLocationsReply rep =
+				         wait(basicLoadBalance(cx->getCommitProxies(useProvisionalProxies),
+				                               &CommitProxyInterface::getKeyServersLocations,
+				                               GetKeyServerLocationsRequest(span.context,
+				                                                            tenant,
+				                                                            begin,
+				                                                            end,
+				                                                            limit,
+				                                                            isBackward,
+				                                                            version,
+				                                                            key.arena()),
+				                               TaskPriority::DefaultPromiseEndpoint))) {
 					++cx->transactionKeyServerLocationRequestsCompleted;
 					if (debugID.present())
 						g_traceBatch.addEvent(
 						    "TransactionDebug", debugID.get().first(), "NativeAPI.getKeyLocation.After");
-					ASSERT(rep.results.size() == 1);
+					ASSERT(rep.results.size() >= 1);
 
+					// Cache the prefetched shards first, so that evicting to make room for them cannot drop the
+					// location being returned
+					for (int i = rep.results.size() - 1; i > 0; i--) {
+						cx->setCachedLocation(rep.results[i].first, rep.results[i].second);
+					}
 					auto locationInfo = cx->setCachedLocation(rep.results[0].first, rep.results[0].second);
 					updateTssMappings(cx, rep);
 					updateTagMappings(cx, rep);
@@ -3134,6 +3227,18 @@ Future<KeyRangeLocationInfo> getKeyLocation(Database const& cx,
 	return locationInfo.get();
 }
 
+// Measures a location lookup of a transaction that missed the location cache
+ACTOR template <class Locations>
+Future<Locations> recordLocationLookup(Reference<TransactionState> trState, Future<Locations> lookup) {
+	state double startTime = now();
+	Locations locations = wait(lookup);
+	trState->cx->locationLatencies.addSample(now() - startTime);
+	if (trState->timeline) {
+		trState->timeline->add("location_lookup", startTime);
+	}
+	return locations;
+}
+
 template <class F>
 Future<KeyRangeLocationInfo> getKeyLocation(Reference<TransactionState> trState,
                                             Key const& key,
@@ -3141,17 +3246,19 @@ Future<KeyRangeLocationInfo> getKeyLocation(Reference<TransactionState> trState,
                                             Reverse isBackward,
                                             UseTenant useTenant) {
 	CODE_PROBE(!useTenant, "Get key location ignoring tenant");
-	return getKeyLocation(trState->cx,
-	                      useTenant ? trState->getTenantInfo() : TenantInfo(),
-	                      key,
-	                      member,
-	                      trState->spanContext,
-	                      trState->readOptions.present() ? trState->readOptions.get().debugID : Optional<UID>(),
-	                      trState->useProvisionalProxies,
-	                      isBackward,
-	                      trState->readVersionFuture.isValid() && trState->readVersionFuture.isReady()
-	                          ? trState->readVersion()
-	                          : latestVersion);
+	Future<KeyRangeLocationInfo> locationInfo =
+	    getKeyLocation(trState->cx,
+	                   useTenant ? trState->getTenantInfo() : TenantInfo(),
+	                   key,
+	                   member,
+	                   trState->spanContext,
+	                   trState->readOptions.present() ? trState->readOptions.get().debugID : Optional<UID>(),
+	                   trState->useProvisionalProxies,
+	                   isBackward,
+	                   trState->readVersionFuture.isValid() && trState->readVersionFuture.isReady()
+	                       ? trState->readVersion()
+	                       : latestVersion);
+	return locationInfo.isReady() ? locationInfo : recordLocationLookup(trState, locationInfo);
 }
 
 void DatabaseContext::updateBackoff(const Error& err) {
@@ -3299,18 +3406,20 @@ Future<std::vector<KeyRangeLocationInfo>> getKeyRangeLocations(Reference<Transac
                                                                F StorageServerInterface::*member,
                                                                UseTenant useTenant) {
 	CODE_PROBE(!useTenant, "Get key range locations ignoring tenant");
-	return getKeyRangeLocations(trState->cx,
-	                            useTenant ? trState->getTenantInfo(AllowInvalidTenantID::True) : TenantInfo(),
-	                            keys,
-	                            limit,
-	                            reverse,
-	                            member,
-	                            trState->spanContext,
-	                            trState->readOptions.present() ? trState->readOptions.get().debugID : Optional<UID>(),
-	                            trState->useProvisionalProxies,
-	                            trState->readVersionFuture.isValid() && trState->readVersionFuture.isReady()
-	                                ? trState->readVersion()
-	                                : latestVersion);
+	Future<std::vector<KeyRangeLocationInfo>> locations =
+	    getKeyRangeLocations(trState->cx,
+	                         useTenant ? trState->getTenantInfo(AllowInvalidTenantID::True) : TenantInfo(),
+	                         keys,
+	                         limit,
+	                         reverse,
+	                         member,
+	                         trState->spanContext,
+	                         trState->readOptions.present() ? trState->readOptions.get().debugID : Optional<UID>(),
+	                         trState->useProvisionalProxies,
+	                         trState->readVersionFuture.isValid() && trState->readVersionFuture.isReady()
+	                             ? trState->readVersion()
+	                             : latestVersion);
+	return locations.isReady() ? locations : recordLocationLookup(trState, locations);
 }
 
 ACTOR Future<std::vector<std::pair<KeyRange, UID>>> getBlobGranuleLocations_internal(
@@ -3470,11 +3579,11 @@ SpanContext generateSpanID(bool transactionTracingSample, SpanContext parentCont
 		return SpanContext(parentContext.traceID, deterministicRandom()->randomUInt64(), parentContext.m_Flags);
 	}
 	if (transactionTracingSample) {
-		return SpanContext(deterministicRandom()->randomUniqueID(),
+		UID traceID = deterministicRandom()->randomUniqueID();
+		return SpanContext(traceID,
 		                   deterministicRandom()->randomUInt64(),
-		                   deterministicRandom()->random01() <= FLOW_KNOBS->TRACING_SAMPLE_RATE
-		                       ? TraceFlags::sampled
-		                       : TraceFlags::unsampled);
+		                   isTraceSampled(traceID, FLOW_KNOBS->TRACING_SAMPLE_RATE) ? TraceFlags::sampled
+		                                                                            : TraceFlags::unsampled);
 	}
 	return SpanContext(
 	    deterministicRandom()->randomUniqueID(), deterministicRandom()->randomUInt64(), TraceFlags::unsampled);
@@ -3540,6 +3649,7 @@ Reference<TransactionState> TransactionState::cloneAndReset(Reference<Transactio
 	newState->startTime = startTime;
 	newState->committedVersion = committedVersion;
 	newState->conflictingKeys = conflictingKeys;
+	newState->timeline = timeline;
 	newState->tenantSet = tenantSet;
 
 	return newState;
@@ -3631,6 +3741,101 @@ Future<Void> Transaction::warmRange(KeyRange keys) {
 	return warmRange_impl(trState, keys);
 }
 
+// Point reads of a transaction which are sent to the same storage team as one GetValuesRequest. The request is sent
+// once the task that queued the first read yields, so that gets issued together by the client are coalesced.
+struct GetValuesBatch {
+	Reference<LocationInfo> locations;
+	UseTenant useTenant;
+	Standalone<VectorRef<KeyRef>> keys;
+	Promise<GetValuesReply> reply;
+	Future<Void> sender;
+
+	GetValuesBatch(Reference<LocationInfo> locations, UseTenant useTenant) : locations(locations), useTenant(useTenant) {}
+};
+
+ACTOR Future<Void> sendGetValuesBatch(Reference<TransactionState> trState,
+                                      std::shared_ptr<GetValuesBatch> batch,
+                                      SpanContext spanContext) {
+	wait(delay(0, trState->taskID));
+
+	auto it = trState->pendingGetValues.find(std::make_pair(batch->locations.getPtr(), (bool)batch->useTenant));
+	if (it != trState->pendingGetValues.end() && it->second == batch) {
+		trState->pendingGetValues.erase(it);
+	}
+
+	// The storage server returns the values in the order of the keys, which lets the readers binary search the reply
+	std::sort(batch->keys.begin(), batch->keys.end());
+	batch->keys.resize(batch->keys.arena(), std::unique(batch->keys.begin(), batch->keys.end()) - batch->keys.begin());
+
+	try {
+		state VersionVector ssLatestCommitVersions;
+		trState->cx->getLatestCommitVersions(batch->locations, trState, ssLatestCommitVersions);
+
+		GetValuesRequest req;
+		req.spanContext = spanContext;
+		req.tenantInfo = batch->useTenant ? trState->getTenantInfo() : TenantInfo();
+		req.arena.dependsOn(batch->keys.arena());
+		req.keys = batch->keys;
+		req.version = trState->readVersion();
+		req.tags = trState->cx->sampleReadTags() ? trState->options.readTags : Optional<TagSet>();
+		req.options = trState->readOptions;
+		req.ssLatestCommitVersions = ssLatestCommitVersions;
+
+		GetValuesReply reply =
+		    wait(loadBalance(trState->cx.getPtr(),
+		                     batch->locations,
+		                     &StorageServerInterface::getValues,
+		                     req,
+		                     TaskPriority::DefaultPromiseEndpoint,
+		                     AtMostOnce::False,
+		                     trState->cx->enableLocalityLoadBalance ? &trState->cx->queueModel : nullptr,
+		                     trState->options.enableReplicaConsistencyCheck,
+		                     trState->options.requiredReplicas));
+		batch->reply.send(reply);
+	} catch (Error& e) {
+		if (e.code() == error_code_actor_cancelled) {
+			throw;
+		}
+		batch->reply.sendError(e);
+	}
+	return Void();
+}
+
+// Adds a point read to the batch of reads waiting to be sent to the same storage team, and extracts its value from the
+// reply to the batch.
+ACTOR Future<GetValueReply> getBatchedValue(Reference<TransactionState> trState,
+                                            Reference<LocationInfo> locations,
+                                            Key key,
+                                            UseTenant useTenant,
+                                            SpanContext spanContext) {
+	state std::shared_ptr<GetValuesBatch> batch;
+	auto batchKey = std::make_pair(locations.getPtr(), (bool)useTenant);
+	auto it = trState->pendingGetValues.find(batchKey);
+	if (it != trState->pendingGetValues.end()) {
+		batch = it->second;
+	} else {
+		batch = std::make_shared<GetValuesBatch>(locations, useTenant);
+		batch->sender = sendGetValuesBatch(trState, batch, spanContext);
+		trState->pendingGetValues[batchKey] = batch;
+	}
+
+	batch->keys.push_back_deep(batch->keys.arena(), key);
+	if (batch->keys.size() >= CLIENT_KNOBS->GET_VALUES_BATCH_MAX_KEYS) {
+		// Later reads to this team start a new batch
+		trState->pendingGetValues.erase(batchKey);
+	}
+
+	GetValuesReply reply = wait(batch->reply.getFuture());
+	GetValueReply result;
+	result.penalty = reply.penalty;
+	result.cached = reply.cached;
+	auto kv = std::lower_bound(reply.data.begin(), reply.data.end(), key, KeyValueRef::OrderByKey());
+	if (kv != reply.data.end() && kv->key == key) {
+		result.value = Value(kv->value, reply.arena);
+	}
+	return result;
+}
+
 ACTOR Future<Optional<Value>> getValue(Reference<TransactionState> trState,
                                        Key key,
                                        UseTenant useTenant,
@@ -3685,27 +3890,34 @@ ACTOR Future<Optional<Value>> getValue(Reference<TransactionState> trState,
 					throw deterministicRandom()->randomChoice(
 					    std::vector<Error>{ transaction_too_old(), future_version() });
 				}
+				state Future<GetValueReply> valueReply;
+				if (CLIENT_KNOBS->GET_VALUES_BATCHING_ENABLED && !getValueID.present() &&
+				    !locationInfo.locations->hasCaches) {
+					valueReply = getBatchedValue(trState, locationInfo.locations, key, useTenant, span.context);
+				} else {
+					valueReply =
+					    loadBalance(trState->cx.getPtr(),
+					                locationInfo.locations,
+					                &StorageServerInterface::getValue,
+					                GetValueRequest(span.context,
+					                                useTenant ? trState->getTenantInfo() : TenantInfo(),
+					                                key,
+					                                trState->readVersion(),
+					                                trState->cx->sampleReadTags() ? trState->options.readTags
+					                                                              : Optional<TagSet>(),
+					                                readOptions,
+					                                ssLatestCommitVersions),
+					                TaskPriority::DefaultPromiseEndpoint,
+					                AtMostOnce::False,
+					                trState->cx->enableLocalityLoadBalance ? &trState->cx->queueModel : nullptr,
+					                trState->options.enableReplicaConsistencyCheck,
+					                trState->options.requiredReplicas);
+				}
 				choose {
 					when(wait(trState->cx->connectionFileChanged())) {
 						throw transaction_too_old();
 					}
-					when(GetValueReply _reply = wait(
-					         loadBalance(trState->cx.getPtr(),
-					                     locationInfo.locations,
-					                     &StorageServerInterface::getValue,
-					                     GetValueRequest(span.context,
-					                                     useTenant ? trState->getTenantInfo() : TenantInfo(),
-					                                     key,
-					                                     trState->readVersion(),
-					                                     trState->cx->sampleReadTags() ? trState->options.readTags
-					                                                                   : Optional<TagSet>(),
-					                                     readOptions,
-					                                     ssLatestCommitVersions),
-					                     TaskPriority::DefaultPromiseEndpoint,
-					                     AtMostOnce::False,
-					                     trState->cx->enableLocalityLoadBalance ? &trState->cx->queueModel : nullptr,
-					                     trState->options.enableReplicaConsistencyCheck,
-					                     trState->options.requiredReplicas))) {
+					when(GetValueReply _reply = wait(valueReply)) {
 						reply = _reply;
 					}
 				}
@@ -3717,6 +3929,9 @@ ACTOR Future<Optional<Value>> getValue(Reference<TransactionState> trState,
 
 			double latency = now() - startTimeD;
 			trState->cx->readLatencies.addSample(latency);
+			if (trState->timeline) {
+				trState->timeline->add("get_value", startTimeD, locationInfo.locations->description());
+			}
 			if (trState->trLogInfo && recordLogInfo) {
 				int valueSize = reply.value.present() ? reply.value.get().size() : 0;
 				trState->trLogInfo->addLog(FdbClientLogEvents::EventGet(startTimeD,
@@ -3955,6 +4170,129 @@ ACTOR Future<Void> readVersionBatcher(
     FutureStream<std::pair<Promise<GetReadVersionReply>, Optional<UID>>> versionStream,
     uint32_t flags);
 
+// Watches of a database which are registered with the same storage team as one WatchValuesRequest. The request is sent
+// once the task that added the first watch yields, so that watches set together by the client are batched.
+struct WatchValuesBatch {
+	Reference<LocationInfo> locations;
+	TenantInfo tenant;
+	Optional<TagSet> tags;
+	Standalone<VectorRef<WatchedValueRef>> watches;
+	std::vector<Promise<WatchValueReply>> replies;
+	Future<Void> sender;
+
+	WatchValuesBatch(Reference<LocationInfo> locations, TenantInfo tenant, Optional<TagSet> tags)
+	  : locations(locations), tenant(tenant), tags(tags) {}
+};
+
+// watchValue() retries a watch after these errors, so failures of the stream, rather than of the watch, become them
+static Error watchValuesBatchError(Error const& e) {
+	if (e.code() == error_code_end_of_stream) {
+		return timed_out();
+	}
+	if (e.code() == error_code_broken_promise || e.code() == error_code_connection_failed ||
+	    e.code() == error_code_request_maybe_delivered) {
+		return all_alternatives_failed();
+	}
+	return e;
+}
+
+ACTOR Future<Void> sendWatchValuesBatch(Database cx,
+                                        std::shared_ptr<WatchValuesBatch> batch,
+                                        SpanContext spanContext,
+                                        TaskPriority taskID) {
+	wait(delay(0, taskID));
+
+	auto it = cx->pendingWatchValues.find(std::make_pair(batch->locations.getPtr(), batch->tenant.tenantId));
+	if (it != cx->pendingWatchValues.end() && it->second == batch) {
+		cx->pendingWatchValues.erase(it);
+	}
+
+	try {
+		// As for range streams, a replica which is not known to have failed is picked at random
+		int useIdx = -1;
+		int count = 0;
+		for (int i = 0; i < batch->locations->size(); i++) {
+			if (!IFailureMonitor::failureMonitor()
+			         .getState(batch->locations->get(i, &StorageServerInterface::watchValues).getEndpoint())
+			         .failed) {
+				if (deterministicRandom()->random01() <= 1.0 / ++count) {
+					useIdx = i;
+				}
+			}
+		}
+		if (useIdx < 0) {
+			throw all_alternatives_failed();
+		}
+
+		WatchValuesRequest req;
+		req.spanContext = spanContext;
+		req.tenantInfo = batch->tenant;
+		req.arena.dependsOn(batch->watches.arena());
+		req.watches = batch->watches;
+		req.tags = batch->tags;
+		state ReplyPromiseStream<WatchValuesReply> stream =
+		    batch->locations->get(useIdx, &StorageServerInterface::watchValues).getReplyStream(req);
+
+		loop {
+			WatchValuesReply report = waitNext(stream.getFuture());
+			if (report.index < 0 || report.index >= batch->replies.size() ||
+			    !batch->replies[report.index].canBeSet()) {
+				continue;
+			}
+			if (report.error.present()) {
+				batch->replies[report.index].sendError(watchValuesBatchError(report.error.get()));
+			} else {
+				batch->replies[report.index].send(WatchValueReply(report.version));
+			}
+		}
+	} catch (Error& e) {
+		if (e.code() == error_code_actor_cancelled) {
+			throw;
+		}
+		for (auto& reply : batch->replies) {
+			if (reply.canBeSet()) {
+				reply.sendError(watchValuesBatchError(e));
+			}
+		}
+	}
+	return Void();
+}
+
+// Adds a watch to the batch of watches waiting to be registered with the same storage team, and waits for the storage
+// server to report it.
+ACTOR Future<WatchValueReply> watchBatchedValue(Database cx,
+                                                Reference<LocationInfo> locations,
+                                                Reference<const WatchParameters> parameters,
+                                                Version ver,
+                                                SpanContext spanContext) {
+	state std::shared_ptr<WatchValuesBatch> batch;
+	auto batchKey = std::make_pair(locations.getPtr(), parameters->tenant.tenantId);
+	auto it = cx->pendingWatchValues.find(batchKey);
+	if (it != cx->pendingWatchValues.end()) {
+		batch = it->second;
+	} else {
+		batch = std::make_shared<WatchValuesBatch>(
+		    locations, parameters->tenant, cx->sampleReadTags() ? parameters->tags : Optional<TagSet>());
+		batch->sender = sendWatchValuesBatch(cx, batch, spanContext, parameters->taskID);
+		cx->pendingWatchValues[batchKey] = batch;
+	}
+
+	WatchedValueRef watch;
+	watch.key = parameters->key;
+	watch.value = parameters->value.castTo<ValueRef>();
+	watch.version = ver;
+	batch->watches.push_back_deep(batch->watches.arena(), watch);
+	batch->replies.emplace_back();
+	Future<WatchValueReply> reply = batch->replies.back().getFuture();
+	if (batch->replies.size() >= CLIENT_KNOBS->WATCH_BATCH_MAX_KEYS) {
+		// Later watches on this team start a new batch
+		cx->pendingWatchValues.erase(batchKey);
+	}
+
+	WatchValueReply r = wait(reply);
+	return r;
+}
+
 ACTOR Future<Version> watchValue(Database cx, Reference<const WatchParameters> parameters) {
 	state Span span("NAPI:watchValue"_loc, parameters->spanContext);
 	state Version ver = parameters->version;
@@ -3987,17 +4325,20 @@ ACTOR Future<Version> watchValue(Database cx, Reference<const WatchParameters> p
 			state WatchValueReply resp;
 			choose {
 				when(WatchValueReply r = wait(
-				         loadBalance(cx.getPtr(),
-				                     locationInfo.locations,
-				                     &StorageServerInterface::watchValue,
-				                     WatchValueRequest(span.context,
-				                                       parameters->tenant,
-				                                       parameters->key,
-				                                       parameters->value,
-				                                       ver,
-				                                       cx->sampleReadTags() ? parameters->tags : Optional<TagSet>(),
-				                                       watchValueID),
-				                     TaskPriority::DefaultPromiseEndpoint))) {
+				         CLIENT_KNOBS->WATCH_BATCHING_ENABLED
+				             ? watchBatchedValue(cx, locationInfo.locations, parameters, ver, span.context)
+				             : loadBalance(cx.getPtr(),
+				                           locationInfo.locations,
+				                           &StorageServerInterface::watchValue,
+				                           WatchValueRequest(span.context,
+				                                             parameters->tenant,
+				                                             parameters->key,
+				                                             parameters->value,
+				                                             ver,
+				                                             cx->sampleReadTags() ? parameters->tags
+				                                                                  : Optional<TagSet>(),
+				                                             watchValueID),
+				                           TaskPriority::DefaultPromiseEndpoint))) {
 					resp = r;
 				}
 				when(wait(cx->connectionRecord ? cx->connectionRecord->onChange() : Never())) {
@@ -4594,6 +4935,10 @@ void getRangeFinished(Reference<TransactionState> trState,
 	trState->totalCost += getReadOperationCost(bytes);
 	trState->cx->transactionBytesRead += bytes;
 	trState->cx->transactionKeysRead += result.size();
+	trState->cx->getRangeLatencies.addSample(now() - startTime);
+	if (trState->timeline) {
+		trState->timeline->add("get_range", startTime, format("%d rows, %lld bytes", result.size(), (long long)bytes));
+	}
 
 	if (trState->trLogInfo) {
 		trState->trLogInfo->addLog(FdbClientLogEvents::EventGetRange(startTime,
@@ -4637,6 +4982,88 @@ void getRangeFinished(Reference<TransactionState> trState,
 	}
 }
 
+// Reads the range [begin, end) of plain keys for the read_parallel_shards option. Up to readParallelShards of the
+// shards it spans are read at once, each with the whole of the remaining limits, and their rows are returned in order,
+// cut off where the limits are reached. Like getRange, it returns once a batch of shards yields rows when there is a
+// byte limit; without one it carries on until the limits are reached or the range is exhausted.
+ACTOR Future<RangeResult> getRangeParallel(Reference<TransactionState> trState,
+                                           KeySelector begin,
+                                           KeySelector end,
+                                           GetRangeLimits limits,
+                                           Promise<std::pair<Key, Key>> conflictRange,
+                                           Snapshot snapshot,
+                                           Reverse reverse) {
+	state RangeResult output;
+	state KeyRange keys;
+
+	ASSERT(begin.isFirstGreaterOrEqual() && end.isFirstGreaterOrEqual());
+	try {
+		wait(trState->startTransaction());
+		trState->cx->validateVersion(trState->readVersion());
+
+		state double startTime = now();
+		keys = KeyRangeRef(begin.getKey(), end.getKey());
+
+		while (!keys.empty()) {
+			state std::vector<KeyRangeLocationInfo> locations =
+			    wait(getKeyRangeLocations(trState,
+			                              keys,
+			                              trState->options.readParallelShards,
+			                              reverse,
+			                              &StorageServerInterface::getKeyValues,
+			                              UseTenant::True));
+			ASSERT(locations.size());
+
+			state std::vector<Future<RangeResult>> reads;
+			for (const auto& location : locations) {
+				reads.push_back(getExactRange<GetKeyValuesRequest, GetKeyValuesReply, RangeResult>(
+				    trState, location.range & keys, Key(), limits, reverse, UseTenant::True));
+			}
+
+			state int shard = 0;
+			for (; shard < reads.size(); ++shard) {
+				RangeResult rows = wait(reads[shard]);
+				output.arena().dependsOn(rows.arena());
+				int used = 0;
+				while (used < rows.size() && !limits.isReached()) {
+					limits.decrement(rows[used]);
+					++used;
+				}
+				output.append(output.arena(), rows.begin(), used);
+				if (used < rows.size() || rows.more || limits.isReached()) {
+					output.more = true;
+					break;
+				}
+			}
+			if (output.more) {
+				break;
+			}
+
+			const KeyRangeRef& last = locations.back().range;
+			keys = reverse ? KeyRangeRef(keys.begin, std::max(keys.begin, last.begin))
+			               : KeyRangeRef(std::min(keys.end, last.end), keys.end);
+			if (!keys.empty() && limits.hasSatisfiedMinRows() && output.size() > 0) {
+				output.more = true;
+				break;
+			}
+		}
+
+		if (begin.getKey() == allKeys.begin && (!reverse || !output.more)) {
+			output.readToBegin = true;
+		}
+		if (end.getKey() == allKeys.end && (reverse || !output.more)) {
+			output.readThroughEnd = true;
+		}
+		getRangeFinished(trState, startTime, begin, end, snapshot, conflictRange, reverse, output);
+		return output;
+	} catch (Error& e) {
+		if (conflictRange.canBeSet()) {
+			conflictRange.send(std::make_pair(Key(), Key()));
+		}
+		throw;
+	}
+}
+
 ACTOR template <class GetKeyValuesFamilyRequest, // GetKeyValuesRequest or GetMappedKeyValuesRequest
                 class GetKeyValuesFamilyReply, // GetKeyValuesReply or GetMappedKeyValuesReply (It would be nice if
                                                // we could use REPLY_TYPE(GetKeyValuesFamilyRequest) instead of specify
@@ -5104,6 +5531,11 @@ maybeDuplicateTSSStreamFragment(Request& req, QueueModel* model, RequestStream<R
 		Optional<TSSEndpointData> tssData = model->getTssData(ssStream->getEndpoint().token.first());
 
 		if (tssData.present()) {
+			const double sampleRate = TSS_sampleRate(req);
+			if (sampleRate < 1.0 && deterministicRandom()->random01() >= sampleRate) {
+				++tssData.get().metrics->unsampledRequests;
+				return Optional<TSSDuplicateStreamData<REPLYSTREAM_TYPE(Request)>>();
+			}
 			CODE_PROBE(true, "duplicating stream to TSS");
 			resetReply(req);
 			// FIXME: optimize to avoid creating new netNotifiedQueueWithAcknowledgements for each stream duplication
@@ -5526,6 +5958,9 @@ void debugAddTags(Reference<TransactionState> trState) {
 	}
 }
 
+// Sizes the first block of each transaction's commit request arena, which holds its mutations and conflict ranges
+static AdaptiveArenaSize commitRequestArenaSize;
+
 Transaction::Transaction()
   : trState(makeReference<TransactionState>(TaskPriority::DefaultEndpoint, generateSpanID(false))) {}
 
@@ -5536,6 +5971,7 @@ Transaction::Transaction(Database const& cx, Optional<Reference<Tenant>> const&
                                             generateSpanID(cx->transactionTracingSample),
                                             createTrLogInfoProbabilistically(cx))),
     span(trState->spanContext, "Transaction"_loc), backoff(CLIENT_KNOBS->DEFAULT_BACKOFF), tr(trState->spanContext) {
+	tr.arena = commitRequestArenaSize.makeArena();
 	if (DatabaseContext::debugUseTags) {
 		debugAddTags(trState);
 	}
@@ -5544,6 +5980,9 @@ Transaction::Transaction(Database const& cx, Optional<Reference<Tenant>> const&
 Transaction::~Transaction() {
 	flushTrLogsIfEnabled();
 	cancelWatches();
+	if (trState) {
+		commitRequestArenaSize.observe(tr.arena);
+	}
 }
 
 void Transaction::operator=(Transaction&& r) noexcept {
@@ -5902,6 +6341,13 @@ Future<RangeResultFamily> Transaction::getRangeInternal(const KeySelector& begin
 		extraConflictRanges.push_back(conflictRange.getFuture());
 	}
 
+	if constexpr (std::is_same_v<GetKeyValuesFamilyRequest, GetKeyValuesRequest>) {
+		if (trState->options.readParallelShards > 1 && b.isFirstGreaterOrEqual() && e.isFirstGreaterOrEqual()) {
+			CODE_PROBE(true, "Native getRange reads shards in parallel");
+			return getRangeParallel(trState, b, e, limits, conflictRange, snapshot, reverse);
+		}
+	}
+
 	return ::getRange<GetKeyValuesFamilyRequest, GetKeyValuesFamilyReply, RangeResultFamily>(
 	    trState, b, e, mapper, limits, conflictRange, snapshot, reverse);
 }
@@ -6216,6 +6662,7 @@ void TransactionOptions::clear() {
 	bypassStorageQuota = false;
 	enableReplicaConsistencyCheck = false;
 	requiredReplicas = 0;
+	readParallelShards = 0;
 }
 
 TransactionOptions::TransactionOptions() {
@@ -6233,7 +6680,9 @@ void TransactionOptions::reset(Database const& cx) {
 void Transaction::resetImpl(bool generateNewSpan) {
 	flushTrLogsIfEnabled();
 	trState = trState->cloneAndReset(createTrLogInfoProbabilistically(trState->cx), generateNewSpan);
+	commitRequestArenaSize.observe(tr.arena);
 	tr = CommitTransactionRequest(trState->spanContext);
+	tr.arena = commitRequestArenaSize.makeArena();
 	extraConflictRanges.clear();
 	commitResult = Promise<Void>();
 	committing = Future<Void>();
@@ -6250,6 +6699,7 @@ void Transaction::reset() {
 
 void Transaction::fullReset() {
 	resetImpl(true);
+	trState->timeline.clear();
 	span = Span(trState->spanContext, "Transaction"_loc);
 	backoff = CLIENT_KNOBS->DEFAULT_BACKOFF;
 }
@@ -6679,6 +7129,10 @@ ACTOR static Future<Void> tryCommit(Reference<TransactionState> trState, CommitT
 		}
 		CODE_PROBE(trState->skipApplyTenantPrefix, "Tenant prefix prepend skipped for dummy transaction");
 		req.tenantInfo = trState->getTenantInfo();
+		if (trState->timeline) {
+			// Waiting for the read version and estimating the commit cost
+			trState->timeline->add("commit_prepare", startTime);
+		}
 		startTime = now();
 		state Optional<UID> commitID = Optional<UID>();
 
@@ -6752,6 +7206,14 @@ ACTOR static Future<Void> tryCommit(Reference<TransactionState> trState, CommitT
 					double latency = now() - startTime;
 					trState->cx->commitLatencies.addSample(latency);
 					trState->cx->latencies.addSample(now() - trState->startTime);
+					if (trState->timeline) {
+						trState->timeline->add(
+						    "commit",
+						    startTime,
+						    alternativeChosen >= 0
+						        ? proxiesUsed->getInterface(alternativeChosen).address().toString()
+						        : std::string());
+					}
 					if (trState->trLogInfo)
 						trState->trLogInfo->addLog(
 						    FdbClientLogEvents::EventCommit_V2(startTime,
@@ -6800,6 +7262,9 @@ ACTOR static Future<Void> tryCommit(Reference<TransactionState> trState, CommitT
 			}
 		}
 	} catch (Error& e) {
+		if (trState->timeline) {
+			trState->timeline->add("commit", startTime, e.name());
+		}
 		if (e.code() == error_code_request_maybe_delivered || e.code() == error_code_commit_unknown_result) {
 			// We don't know if the commit happened, and it might even still be in flight.
 
@@ -7213,6 +7678,13 @@ void Transaction::setOption(FDBTransactionOptions::Option option, Optional<Strin
 		trState->options.reportConflictingKeys = true;
 		break;
 
+	case FDBTransactionOptions::RECORD_TIMELINE:
+		validateOptionValueNotPresent(value);
+		if (!trState->timeline) {
+			trState->timeline = makeReference<TransactionTimeline>(now());
+		}
+		break;
+
 	case FDBTransactionOptions::EXPENSIVE_CLEAR_COST_ESTIMATION_ENABLE:
 		validateOptionValueNotPresent(value);
 		trState->options.expensiveClearCostEstimation = true;
@@ -7299,6 +7771,23 @@ void Transaction::setOption(FDBTransactionOptions::Option option, Optional<Strin
 		trState->readOptions.withDefault(ReadOptions()).type = ReadType::HIGH;
 		break;
 
+	case FDBTransactionOptions::READ_PARALLEL_SHARDS:
+		validateOptionValuePresent(value);
+		trState->options.readParallelShards =
+		    extractIntOption(value, 0, CLIENT_KNOBS->GET_RANGE_PARALLEL_SHARD_LIMIT);
+		break;
+
+	case FDBTransactionOptions::READ_MAX_STALE_VERSIONS: {
+		validateOptionValuePresent(value);
+		Version maxStaleVersions = extractIntOption(value, 0, std::numeric_limits<int64_t>::max());
+		if (maxStaleVersions > 0) {
+			trState->readOptions.withDefault(ReadOptions()).maxStaleVersions = maxStaleVersions;
+		} else if (trState->readOptions.present()) {
+			trState->readOptions.get().maxStaleVersions.reset();
+		}
+		break;
+	}
+
 	case FDBTransactionOptions::ENABLE_REPLICA_CONSISTENCY_CHECK:
 		validateOptionValueNotPresent(value);
 		trState->options.enableReplicaConsistencyCheck = true;
@@ -7500,6 +7989,9 @@ ACTOR Future<Version> extractReadVersion(Reference<TransactionState> trState,
 		trState->cx->lastRkDefaultThrottleTime = replyTime;
 	}
 	trState->cx->GRVLatencies.addSample(latency);
+	if (trState->timeline) {
+		trState->timeline->add("get_read_version", trState->startTime);
+	}
 	if (trState->trLogInfo)
 		trState->trLogInfo->addLog(FdbClientLogEvents::EventGetVersion_V3(trState->startTime,
 		                                                                  trState->cx->clientLocality.dcId(),
@@ -7566,6 +8058,33 @@ ACTOR Future<Version> extractReadVersion(Reference<TransactionState> trState,
 	return rep.version;
 }
 
+// A read version request sent to another database's batcher fails with broken_promise if that database is destroyed
+// first. It is then sent again through cx.
+ACTOR Future<GetReadVersionReply> retryOnOwnBatcher(Future<GetReadVersionReply> reply,
+                                                    Reference<DatabaseContext> cx,
+                                                    TransactionPriority priority,
+                                                    uint32_t flags,
+                                                    SpanContext spanContext,
+                                                    Optional<UID> debugID) {
+	try {
+		GetReadVersionReply rep = wait(reply);
+		return rep;
+	} catch (Error& e) {
+		if (e.code() != error_code_broken_promise) {
+			throw;
+		}
+	}
+	CODE_PROBE(true, "Shared GRV batcher destroyed, retrying on own batcher");
+	state DatabaseContext::VersionRequest req(spanContext, TagSet(), debugID);
+	auto& batcher = cx->versionBatcher[flags];
+	if (!batcher.actor.isValid()) {
+		batcher.actor = readVersionBatcher(cx.getPtr(), batcher.stream.getFuture(), priority, flags);
+	}
+	batcher.stream.send(req);
+	GetReadVersionReply rep = wait(req.reply.getFuture());
+	return rep;
+}
+
 bool rkThrottlingCooledDown(DatabaseContext* cx, TransactionPriority priority) {
 	if (priority == TransactionPriority::IMMEDIATE) {
 		return true;
@@ -7653,9 +8172,10 @@ Future<Version> TransactionState::getReadVersion(uint32_t flags) {
 		}
 	}
 
-	auto& batcher = cx->versionBatcher[flags];
+	DatabaseContext* batchingDatabase = grvBatchingDatabase(cx.getPtr(), options);
+	auto& batcher = batchingDatabase->versionBatcher[flags];
 	if (!batcher.actor.isValid()) {
-		batcher.actor = readVersionBatcher(cx.getPtr(), batcher.stream.getFuture(), options.priority, flags);
+		batcher.actor = readVersionBatcher(batchingDatabase, batcher.stream.getFuture(), options.priority, flags);
 	}
 
 	Location location = "NAPI:getReadVersion"_loc;
@@ -7664,8 +8184,11 @@ Future<Version> TransactionState::getReadVersion(uint32_t flags) {
 	auto const req = DatabaseContext::VersionRequest(derivedSpanContext, options.tags, versionDebugID);
 	batcher.stream.send(req);
 	startTime = now();
-	return extractReadVersion(
-	    Reference<TransactionState>::addRef(this), location, spanContext, req.reply.getFuture(), metadataVersion);
+	Future<GetReadVersionReply> reply = req.reply.getFuture();
+	if (batchingDatabase != cx.getPtr()) {
+		reply = retryOnOwnBatcher(reply, cx, options.priority, flags, derivedSpanContext, versionDebugID);
+	}
+	return extractReadVersion(Reference<TransactionState>::addRef(this), location, spanContext, reply, metadataVersion);
 }
 
 Optional<Version> Transaction::getCachedReadVersion() const {
@@ -7850,6 +8373,9 @@ Future<Void> Transaction::onError(Error const& e) {
 
 		double backoff = getBackoff(e.code());
 		reset();
+		if (trState->timeline) {
+			trState->timeline->add("on_error", now(), format("%s, backing off %.3fs", e.name(), backoff));
+		}
 		return delay(backoff, trState->taskID);
 	}
 	if (e.code() == error_code_transaction_too_old || e.code() == error_code_future_version) {
@@ -7858,9 +8384,12 @@ Future<Void> Transaction::onError(Error const& e) {
 		else if (e.code() == error_code_future_version)
 			++trState->cx->transactionsFutureVersions;
 
-		double maxBackoff = trState->options.maxBackoff;
+		double backoff = std::min(CLIENT_KNOBS->FUTURE_VERSION_RETRY_DELAY, trState->options.maxBackoff);
 		reset();
-		return delay(std::min(CLIENT_KNOBS->FUTURE_VERSION_RETRY_DELAY, maxBackoff), trState->taskID);
+		if (trState->timeline) {
+			trState->timeline->add("on_error", now(), format("%s, backing off %.3fs", e.name(), backoff));
+		}
+		return delay(backoff, trState->taskID);
 	}
 
 	return e;
@@ -10786,6 +11315,89 @@ ACTOR Future<bool> getChangeFeedStreamFromDisk(Reference<DatabaseContext> db,
 	}
 }
 
+// Sends the mutations of the feed from *begin from the delta files of the blob granules of its range, a batch of
+// versions at a time, until it gets within CHANGE_FEED_BLOB_CATCHUP_LAG_VERSIONS of the latest version. This keeps a
+// consumer that fell far behind from reading its backlog off the storage servers. Any failure to read from blob just
+// ends the catch up early, leaving the rest for the storage servers. Returns whether it reached the end version.
+ACTOR Future<bool> getChangeFeedStreamFromBlob(Reference<DatabaseContext> db,
+                                               Reference<ChangeFeedData> results,
+                                               Key rangeID,
+                                               Version* begin,
+                                               Version end,
+                                               KeyRange range) {
+	state Database cx(db);
+	state Transaction tr(cx);
+	state Version batchEnd = invalidVersion;
+	loop {
+		tr.reset();
+		try {
+			tr.setOption(FDBTransactionOptions::READ_SYSTEM_KEYS);
+			tr.setOption(FDBTransactionOptions::LOCK_AWARE);
+			Version readVersion = wait(tr.getReadVersion());
+			if (readVersion - *begin < CLIENT_KNOBS->CHANGE_FEED_BLOB_CATCHUP_LAG_VERSIONS) {
+				return false;
+			}
+			batchEnd =
+			    std::min({ *begin + CLIENT_KNOBS->CHANGE_FEED_BLOB_CATCHUP_BATCH_VERSIONS, readVersion, end - 1 });
+
+			Optional<Value> feedValue = wait(tr.get(rangeID.withPrefix(changeFeedPrefix)));
+			if (!feedValue.present()) {
+				return false;
+			}
+			KeyRange feedRange;
+			Version popVersion;
+			ChangeFeedStatus status;
+			std::tie(feedRange, popVersion, status) = decodeChangeFeedValue(feedValue.get());
+			// popped versions must get change_feed_popped from the storage servers rather than data from blob
+			if (*begin < popVersion) {
+				return false;
+			}
+
+			state KeyRange keys = feedRange & range;
+			state Standalone<VectorRef<BlobGranuleChunkRef>> chunks =
+			    wait(tr.readBlobGranules(keys, *begin, batchEnd));
+			for (auto& chunk : chunks) {
+				if (chunk.snapshotFile.present()) {
+					// the begin version was collapsed to a snapshot, so the mutations aren't all in delta files
+					CODE_PROBE(true, "change feed blob catch up got snapshot");
+					return false;
+				}
+			}
+			if (!isRangeFullyCovered(keys, chunks)) {
+				return false;
+			}
+
+			Standalone<VectorRef<MutationsAndVersionRef>> mutations =
+			    wait(readBlobGranuleMutations(chunks, keys, *begin, batchEnd, results->catchUpBlobStore));
+			CODE_PROBE(true, "change feed caught up from blob");
+			// end the batch with an empty version, like the storage servers do, so the consumer sees the progress
+			if (mutations.empty() || mutations.back().version < batchEnd) {
+				mutations.push_back(mutations.arena(), MutationsAndVersionRef(batchEnd, batchEnd));
+			}
+			results->mutations.send(mutations);
+			wait(results->mutations.onEmpty());
+			wait(delay(0));
+			if (batchEnd > results->lastReturnedVersion.get()) {
+				results->lastReturnedVersion.set(batchEnd);
+			}
+			*begin = batchEnd + 1;
+			if (*begin >= end) {
+				return true;
+			}
+		} catch (Error& e) {
+			if (e.code() == error_code_actor_cancelled) {
+				throw;
+			}
+			TraceEvent("ChangeFeedBlobCatchUpStopped")
+			    .errorUnsuppressed(e)
+			    .suppressFor(30.0)
+			    .detail("FeedID", rangeID)
+			    .detail("BeginVersion", *begin);
+			return false;
+		}
+	}
+}
+
 ACTOR Future<Void> getChangeFeedStreamActor(Reference<DatabaseContext> db,
                                             Reference<ChangeFeedData> results,
                                             Key rangeID,
@@ -11016,6 +11628,19 @@ ACTOR Future<Void> durableChangeFeedMonitor(Reference<DatabaseContext> db,
 					}
 				}
 			}
+		}
+		state bool caughtUpFromBlob = false;
+		if (results->catchUpBlobStore.isValid()) {
+			state Version blobBegin = begin;
+			bool foundEnd = wait(getChangeFeedStreamFromBlob(db, results, rangeID, &begin, end, range));
+			if (foundEnd) {
+				results->mutations.sendError(end_of_stream());
+				return Void();
+			}
+			caughtUpFromBlob = begin != blobBegin;
+		}
+		// the durable cache doesn't get the mutations read from blob, so it can't record this stream
+		if (db->storage != nullptr && !caughtUpFromBlob) {
 			if (end == MAX_VERSION) {
 				if (!db->changeFeedCaches.count(cacheRange.get())) {
 					data = makeReference<ChangeFeedCacheData>();
@@ -26,6 +26,8 @@
 #include "fdbclient/StatusClient.h"
 #include "fdbclient/MonitorLeader.h"
 #include "flow/Util.h"
+
+#include <unordered_map>
 #include "flow/actorcompiler.h" // This must be the last #include.
 
 class RYWImpl {
@@ -397,6 +399,7 @@ public:
 	static inline Future<typename Req::Result> readWithConflictRange(ReadYourWritesTransaction* ryw,
 	                                                                 Req const& req,
 	                                                                 Snapshot snapshot) {
+		ryw->materializeWrites();
 		if (ryw->options.readYourWritesDisabled) {
 			return readWithConflictRangeThrough(ryw, req, snapshot);
 		} else if (snapshot && ryw->options.snapshotRywEnabled <= 0) {
@@ -1216,6 +1219,7 @@ public:
 	    ReadYourWritesTransaction* ryw,
 	    GetMappedRangeReq<backwards> const& req,
 	    Snapshot snapshot) {
+		ryw->materializeWrites();
 		// For now, getMappedRange requires serializable isolation. (Technically it is trivial to add snapshot
 		// isolation support. But it is not default and is rarely used. So we disallow it until we have thorough test
 		// coverage for it.)
@@ -1389,7 +1393,12 @@ public:
 				return Void();
 			}
 
-			ryw->writeRangeToNativeTransaction(KeyRangeRef(StringRef(), allKeys.end));
+			// The deferred log is kept, so that the conflict ranges can still be read from the special key space
+			if (ryw->deferringWrites) {
+				ryw->writeDeferredToNativeTransaction();
+			} else {
+				ryw->writeRangeToNativeTransaction(KeyRangeRef(StringRef(), allKeys.end));
+			}
 
 			auto conflictRanges = ryw->readConflicts.ranges();
 			for (auto iter = conflictRanges.begin(); iter != conflictRanges.end(); ++iter) {
@@ -1548,8 +1557,9 @@ public:
 };
 
 ReadYourWritesTransaction::ReadYourWritesTransaction(Database const& cx, Optional<Reference<Tenant>> const& tenant)
-  : ISingleThreadTransaction(cx->deferredError), tr(cx, tenant), cache(&arena), writes(&arena), retries(0),
-    approximateSize(0), creationTime(now()), commitStarted(false), versionStampFuture(tr.getVersionstamp()),
+  : ISingleThreadTransaction(cx->deferredError), tr(cx, tenant), cache(&arena), writes(&arena),
+    deferringWrites(CLIENT_KNOBS->RYW_DEFER_WRITES), retries(0), approximateSize(0), creationTime(now()),
+    commitStarted(false), versionStampFuture(tr.getVersionstamp()),
     specialKeySpaceWriteMap(std::make_pair(false, Optional<Value>()), specialKeys.end), options(tr) {
 	std::copy(
 	    cx.getTransactionDefaults().begin(), cx.getTransactionDefaults().end(), std::back_inserter(persistentOptions));
@@ -1980,6 +1990,7 @@ void ReadYourWritesTransaction::addReadConflictRange(KeyRangeRef const& keys) {
 		return;
 	}
 
+	materializeWrites();
 	WriteMap::iterator it(&writes);
 	KeyRangeRef readRange(arena, r);
 	it.skip(readRange.begin);
@@ -1994,6 +2005,82 @@ void ReadYourWritesTransaction::updateConflictMap(KeyRangeRef const& keys, Write
 	RYWImpl::updateConflictMap(this, keys, it);
 }
 
+void ReadYourWritesTransaction::materializeWrites() {
+	if (!deferringWrites) {
+		return;
+	}
+	deferringWrites = false;
+	for (const auto& w : deferredWrites) {
+		if (w.mutation.type == MutationRef::NoOp) {
+			writes.addConflictRange(KeyRangeRef(w.mutation.param1, w.mutation.param2));
+		} else if (w.mutation.type == MutationRef::ClearRange) {
+			writes.clear(KeyRangeRef(w.mutation.param1, w.mutation.param2), w.addConflict);
+		} else {
+			writes.mutate(w.mutation.param1, (MutationRef::Type)w.mutation.type, w.mutation.param2, w.addConflict);
+		}
+	}
+	deferredWrites.clear();
+}
+
+// Unlike writeRangeToNativeTransaction, the writes are sent in the order they were made rather than coalesced
+// Whether consecutive atomic ops of this type on a key can be sent as one, with WriteMap::coalesce combining operands
+static bool canCoalesceDeferredAtomicOp(MutationRef::Type type) {
+	return isAtomicOp(type) && type != MutationRef::SetVersionstampedKey &&
+	       type != MutationRef::SetVersionstampedValue && type != MutationRef::CompareAndClear &&
+	       type != MutationRef::AppendIfFits;
+}
+
+void ReadYourWritesTransaction::writeDeferredToNativeTransaction() {
+	// Atomic ops of one type on a key with no other write to the key in between, such as a counter incremented in a
+	// loop, are sent as a single mutation. The log itself is left intact.
+	std::vector<DeferredWrite> coalesced;
+	coalesced.reserve(deferredWrites.size());
+	std::unordered_map<KeyRef, int> lastAtomicOp;
+	for (const auto& w : deferredWrites) {
+		const auto type = (MutationRef::Type)w.mutation.type;
+		if (type == MutationRef::ClearRange) {
+			lastAtomicOp.clear();
+		} else if (!canCoalesceDeferredAtomicOp(type)) {
+			if (type != MutationRef::NoOp) {
+				lastAtomicOp.erase(w.mutation.param1);
+			}
+		} else {
+			auto last = lastAtomicOp.find(w.mutation.param1);
+			if (last != lastAtomicOp.end()) {
+				DeferredWrite& prev = coalesced[last->second];
+				if (prev.mutation.type == type &&
+				    (!isNonAssociativeOp(type) || prev.mutation.param2.size() == w.mutation.param2.size())) {
+					prev.mutation.param2 =
+					    WriteMap::coalesce(
+					        RYWMutation(prev.mutation.param2, type), RYWMutation(w.mutation.param2, type), arena)
+					        .value.get();
+					prev.addConflict = AddConflictRange{ prev.addConflict || w.addConflict };
+					continue;
+				}
+			}
+			lastAtomicOp[w.mutation.param1] = coalesced.size();
+		}
+		coalesced.push_back(w);
+	}
+
+	for (const auto& w : coalesced) {
+		KeyRangeRef range(w.mutation.param1, w.mutation.param2);
+		switch (w.mutation.type) {
+		case MutationRef::NoOp:
+			tr.addWriteConflictRange(range);
+			break;
+		case MutationRef::ClearRange:
+			tr.clear(range, w.addConflict);
+			break;
+		case MutationRef::SetValue:
+			tr.set(w.mutation.param1, w.mutation.param2, w.addConflict);
+			break;
+		default:
+			tr.atomicOp(w.mutation.param1, w.mutation.param2, (MutationRef::Type)w.mutation.type, w.addConflict);
+		}
+	}
+}
+
 void ReadYourWritesTransaction::writeRangeToNativeTransaction(KeyRangeRef const& keys) {
 	WriteMap::iterator it(&writes);
 	it.skip(keys.begin);
@@ -2089,6 +2176,7 @@ bool ReadYourWritesTransactionOptions::getAndResetWriteConflictDisabled() {
 }
 
 void ReadYourWritesTransaction::getWriteConflicts(KeyRangeMap<bool>* result) {
+	materializeWrites();
 	WriteMap::iterator it(&writes);
 	it.skip(allKeys.begin);
 
@@ -2167,6 +2255,7 @@ RangeResult ReadYourWritesTransaction::getWriteConflictRangeIntersecting(KeyRang
 	CoalescedKeyRefRangeMap<ValueRef> writeConflicts{ "0"_sr, specialKeys.end };
 
 	if (!options.readYourWritesDisabled) {
+		materializeWrites();
 		KeyRangeRef strippedWriteRangePrefix = kr.removePrefix(writeConflictRangeKeysRange.begin);
 		WriteMap::iterator it(&writes);
 		it.skip(strippedWriteRangePrefix.begin);
@@ -2267,6 +2356,7 @@ void ReadYourWritesTransaction::atomicOp(const KeyRef& key, const ValueRef& oper
 		versionStampKeys.push_back(arena, k);
 		addWriteConflict = AddConflictRange::False;
 		if (!options.readYourWritesDisabled) {
+			materializeWrites();
 			writeRangeToNativeTransaction(range);
 			writes.addUnmodifiedAndUnreadableRange(range);
 		}
@@ -2292,6 +2382,11 @@ void ReadYourWritesTransaction::atomicOp(const KeyRef& key, const ValueRef& oper
 		return tr.atomicOp(k, v, (MutationRef::Type)operationType, addWriteConflict);
 	}
 
+	if (deferringWrites) {
+		deferredWrites.push_back({ MutationRef((MutationRef::Type)operationType, k, v), addWriteConflict });
+		return;
+	}
+
 	writes.mutate(k, (MutationRef::Type)operationType, v, addWriteConflict);
 	RYWImpl::triggerWatches(this, k, Optional<ValueRef>(), false);
 }
@@ -2350,6 +2445,11 @@ void ReadYourWritesTransaction::set(const KeyRef& key, const ValueRef& value) {
 	KeyRef k = KeyRef(arena, key);
 	ValueRef v = ValueRef(arena, value);
 
+	if (deferringWrites) {
+		deferredWrites.push_back({ MutationRef(MutationRef::SetValue, k, v), addWriteConflict });
+		return;
+	}
+
 	writes.mutate(k, MutationRef::SetValue, v, addWriteConflict);
 	RYWImpl::triggerWatches(this, key, value);
 }
@@ -2399,6 +2499,11 @@ void ReadYourWritesTransaction::clear(const KeyRangeRef& range) {
 
 	r = KeyRangeRef(arena, r);
 
+	if (deferringWrites) {
+		deferredWrites.push_back({ MutationRef(MutationRef::ClearRange, r.begin, r.end), addWriteConflict });
+		return;
+	}
+
 	writes.clear(r, addWriteConflict);
 	RYWImpl::triggerWatches(this, r, Optional<ValueRef>());
 }
@@ -2431,6 +2536,11 @@ void ReadYourWritesTransaction::clear(const KeyRef& key) {
 	approximateSize +=
 	    r.expectedSize() + sizeof(KeyRangeRef) + (addWriteConflict ? sizeof(KeyRangeRef) + r.expectedSize() : 0);
 
+	if (deferringWrites) {
+		deferredWrites.push_back({ MutationRef(MutationRef::ClearRange, r.begin, r.end), addWriteConflict });
+		return;
+	}
+
 	// SOMEDAY: add an optimized single key clear to write map
 	writes.clear(r, addWriteConflict);
 
@@ -2455,6 +2565,8 @@ Future<Void> ReadYourWritesTransaction::watch(const Key& key) {
 		return key_too_large();
 	}
 
+	// Watches are triggered by later writes, which needs the write map
+	materializeWrites();
 	return RYWImpl::watch(this, key);
 }
 
@@ -2496,6 +2608,10 @@ void ReadYourWritesTransaction::addWriteConflictRange(KeyRangeRef const& keys) {
 	}
 
 	r = KeyRangeRef(arena, r);
+	if (deferringWrites) {
+		deferredWrites.push_back({ MutationRef(MutationRef::NoOp, r.begin, r.end), AddConflictRange::True });
+		return;
+	}
 	writes.addConflictRange(r);
 }
 
@@ -2536,7 +2652,8 @@ void ReadYourWritesTransaction::setOptionImpl(FDBTransactionOptions::Option opti
 	case FDBTransactionOptions::READ_YOUR_WRITES_DISABLE:
 		validateOptionValueNotPresent(value);
 
-		if (reading.getFutureCount() > 0 || !cache.empty() || !writes.empty())
+		if (reading.getFutureCount() > 0 || !cache.empty() || !writes.empty() ||
+		    !deferredWrites.empty())
 			throw client_invalid_operation();
 
 		options.readYourWritesDisabled = true;
@@ -2622,6 +2739,8 @@ void ReadYourWritesTransaction::setOptionImpl(FDBTransactionOptions::Option opti
 void ReadYourWritesTransaction::operator=(ReadYourWritesTransaction&& r) noexcept {
 	cache = std::move(r.cache);
 	writes = std::move(r.writes);
+	deferredWrites = std::move(r.deferredWrites);
+	deferringWrites = r.deferringWrites;
 	arena = std::move(r.arena);
 	tr = std::move(r.tr);
 	readConflicts = std::move(r.readConflicts);
@@ -2645,13 +2764,15 @@ void ReadYourWritesTransaction::operator=(ReadYourWritesTransaction&& r) noexcep
 	nativeWriteRanges = std::move(r.nativeWriteRanges);
 	versionStampKeys = std::move(r.versionStampKeys);
 	specialKeySpaceWriteMap = std::move(r.specialKeySpaceWriteMap);
+	specialKeySpaceReadCache = std::move(r.specialKeySpaceReadCache);
 	debugTraces = std::move(r.debugTraces);
 	debugMessages = std::move(r.debugMessages);
 }
 
 ReadYourWritesTransaction::ReadYourWritesTransaction(ReadYourWritesTransaction&& r) noexcept
   : ISingleThreadTransaction(std::move(r.deferredError)), arena(std::move(r.arena)), cache(std::move(r.cache)),
-    writes(std::move(r.writes)), resetPromise(std::move(r.resetPromise)), reading(std::move(r.reading)),
+    writes(std::move(r.writes)), deferredWrites(std::move(r.deferredWrites)), deferringWrites(r.deferringWrites),
+    resetPromise(std::move(r.resetPromise)), reading(std::move(r.reading)),
     retries(r.retries), approximateSize(r.approximateSize), timeoutActor(std::move(r.timeoutActor)),
     creationTime(r.creationTime), commitStarted(r.commitStarted), transactionDebugInfo(r.transactionDebugInfo),
     options(r.options) {
@@ -2667,6 +2788,7 @@ ReadYourWritesTransaction::ReadYourWritesTransaction(ReadYourWritesTransaction&&
 	nativeWriteRanges = std::move(r.nativeWriteRanges);
 	versionStampKeys = std::move(r.versionStampKeys);
 	specialKeySpaceWriteMap = std::move(r.specialKeySpaceWriteMap);
+	specialKeySpaceReadCache = std::move(r.specialKeySpaceReadCache);
 	debugTraces = std::move(r.debugTraces);
 	debugMessages = std::move(r.debugMessages);
 }
@@ -2704,12 +2826,15 @@ void ReadYourWritesTransaction::resetRyow() {
 	arena = Arena();
 	cache = SnapshotCache(&arena);
 	writes = WriteMap(&arena);
+	deferredWrites.clear();
+	deferringWrites = CLIENT_KNOBS->RYW_DEFER_WRITES;
 	readConflicts = CoalescedKeyRefRangeMap<bool>();
 	versionStampKeys = VectorRef<KeyRef>();
 	nativeReadRanges = Standalone<VectorRef<KeyRangeRef>>();
 	nativeWriteRanges = Standalone<VectorRef<KeyRangeRef>>();
 	specialKeySpaceWriteMap =
 	    KeyRangeMap<std::pair<bool, Optional<Value>>>(std::make_pair(false, Optional<Value>()), specialKeys.end);
+	specialKeySpaceReadCache.clear();
 	specialKeySpaceErrorMsg.reset();
 	watchMap.clear();
 	reading = AndFuture();
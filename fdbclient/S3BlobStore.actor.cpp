@@ -810,6 +810,37 @@ void S3BlobStoreEndpoint::returnConnection(ReusableConnection& rconn) {
 	rconn.conn = Reference<IConnection>();
 }
 
+ACTOR static Future<Void> withholdRequests(S3BlobStoreEndpoint* b, int64_t amount) {
+	wait(b->concurrentRequests.take(TaskPriority::DefaultYield, amount));
+	b->withheldRequests += amount;
+	return Void();
+}
+
+void S3BlobStoreEndpoint::onRequestSucceeded() {
+	if (withheldRequests == 0) {
+		return;
+	}
+	withheldRequestCredit += 1.0 / std::max<int64_t>(1, knobs.concurrent_requests - withheldRequests);
+	if (withheldRequestCredit >= 1.0) {
+		withheldRequestCredit = 0;
+		--withheldRequests;
+		concurrentRequests.release(1);
+	}
+}
+
+void S3BlobStoreEndpoint::onRequestThrottled() {
+	++blobStats->throttledRequests;
+	if (!CLIENT_KNOBS->BLOBSTORE_ADAPTIVE_CONCURRENCY ||
+	    (withholdingRequests.isValid() && !withholdingRequests.isReady())) {
+		return;
+	}
+	int64_t amount = (knobs.concurrent_requests - withheldRequests) / 2;
+	if (amount > 0) {
+		withheldRequestCredit = 0;
+		withholdingRequests = withholdRequests(this, amount);
+	}
+}
+
 std::string awsCanonicalURI(const std::string& resource, std::vector<std::string>& queryParameters, bool isV4) {
 	StringRef resourceRef(resource);
 	resourceRef.eat("/");
@@ -998,6 +1029,7 @@ ACTOR Future<Reference<HTTP::IncomingResponse>> doRequest_impl(Reference<S3BlobS
 		if (!err.present() && successCodes.count(r->code) != 0) {
 			bstore->s_stats.requests_successful++;
 			++bstore->blobStats->requestsSuccessful;
+			bstore->onRequestSucceeded();
 			return r;
 		}
 
@@ -1005,6 +1037,10 @@ ACTOR Future<Reference<HTTP::IncomingResponse>> doRequest_impl(Reference<S3BlobS
 		bstore->s_stats.requests_failed++;
 		++bstore->blobStats->requestsFailed;
 
+		if (!err.present() && (r->code == 429 || r->code == 503)) {
+			bstore->onRequestThrottled();
+		}
+
 		// All errors in err are potentially retryable as well as certain HTTP response codes...
 		bool retryable = err.present() || r->code == 500 || r->code == 502 || r->code == 503 || r->code == 429;
 
@@ -267,6 +267,56 @@ const KeyRef JSONSchemas::statusSchema = R"statusSchema(
                      "p99":0.0,
                      "p99.9":0.0
                   },
+                  "read_phase_latency_statistics":{
+                     "queue_wait":{
+                        "count":0,
+                        "min":0.0,
+                        "max":0.0,
+                        "median":0.0,
+                        "mean":0.0,
+                        "p25":0.0,
+                        "p90":0.0,
+                        "p95":0.0,
+                        "p99":0.0,
+                        "p99.9":0.0
+                     },
+                     "version_wait":{
+                        "count":0,
+                        "min":0.0,
+                        "max":0.0,
+                        "median":0.0,
+                        "mean":0.0,
+                        "p25":0.0,
+                        "p90":0.0,
+                        "p95":0.0,
+                        "p99":0.0,
+                        "p99.9":0.0
+                     },
+                     "versioned_data":{
+                        "count":0,
+                        "min":0.0,
+                        "max":0.0,
+                        "median":0.0,
+                        "mean":0.0,
+                        "p25":0.0,
+                        "p90":0.0,
+                        "p95":0.0,
+                        "p99":0.0,
+                        "p99.9":0.0
+                     },
+                     "storage_engine":{
+                        "count":0,
+                        "min":0.0,
+                        "max":0.0,
+                        "median":0.0,
+                        "mean":0.0,
+                        "p25":0.0,
+                        "p90":0.0,
+                        "p95":0.0,
+                        "p99":0.0,
+                        "p99.9":0.0
+                     }
+                  },
                   "commit_latency_statistics":{
                      "count":0,
                      "min":0.0,
@@ -313,6 +363,36 @@ const KeyRef JSONSchemas::statusSchema = R"statusSchema(
                      "estimated_cost":{
                         "hz": 0.0
                      }
+                  },
+                  "hottest_keys":{
+                     "read_key":{
+                        "key": "",
+                        "fractional_cost": 0.0,
+                        "estimated_cost":{
+                           "hz": 0.0
+                        }
+                     },
+                     "read_prefix":{
+                        "key": "",
+                        "fractional_cost": 0.0,
+                        "estimated_cost":{
+                           "hz": 0.0
+                        }
+                     },
+                     "write_key":{
+                        "key": "",
+                        "fractional_cost": 0.0,
+                        "estimated_cost":{
+                           "hz": 0.0
+                        }
+                     },
+                     "write_prefix":{
+                        "key": "",
+                        "fractional_cost": 0.0,
+                        "estimated_cost":{
+                           "hz": 0.0
+                        }
+                     }
                   }
                }
             ],
@@ -66,6 +66,8 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( LEGACY_TLOG_UPGRADE_ENTRIES_PER_VERSION,               100 );
 	init( VERSION_MESSAGES_OVERHEAD_FACTOR_1024THS,             1072 ); // Based on a naive interpretation of the gcc version of std::deque, we would expect this to be 16 bytes overhead per 512 bytes data. In practice, it seems to be 24 bytes overhead per 512.
 	init( VERSION_MESSAGES_ENTRY_BYTES_WITH_OVERHEAD, std::ceil(16.0 * VERSION_MESSAGES_OVERHEAD_FACTOR_1024THS / 1024) );
+	init( TAG_MESSAGE_INDEX_OVERHEAD_FACTOR_1024THS,            1064 ); // 83 12-byte entries fill each 1024 byte block, which is 1053/1024, plus a pointer per block in the index's directory.
+	init( TAG_MESSAGE_INDEX_ENTRY_BYTES_WITH_OVERHEAD, std::ceil(12.0 * TAG_MESSAGE_INDEX_OVERHEAD_FACTOR_1024THS / 1024) );
 	init( LOG_SYSTEM_PUSHED_DATA_BLOCK_SIZE,                     1e5 );
 	init( MAX_MESSAGE_SIZE,            std::max<int>(LOG_SYSTEM_PUSHED_DATA_BLOCK_SIZE, 1e5 + 2e4 + 1) + 8 ); // VALUE_SIZE_LIMIT + SYSTEM_KEY_SIZE_LIMIT + 9 bytes (4 bytes for length, 4 bytes for sequence number, and 1 byte for mutation type)
 	init( TLOG_MESSAGE_BLOCK_BYTES,                             10e6 );
@@ -73,21 +75,32 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( PEEK_TRACKER_EXPIRATION_TIME,                          600 ); if( randomize && BUGGIFY ) PEEK_TRACKER_EXPIRATION_TIME = 120; // Cannot be buggified lower without changing the following assert in LogSystemPeekCursor.actor.cpp: ASSERT_WE_THINK(e.code() == error_code_operation_obsolete || SERVER_KNOBS->PEEK_TRACKER_EXPIRATION_TIME < 10);
 	init( PEEK_USING_STREAMING,                                false ); if( randomize && isSimulated && BUGGIFY ) PEEK_USING_STREAMING = true;
 	init( PARALLEL_GET_MORE_REQUESTS,                             32 ); if( randomize && BUGGIFY ) PARALLEL_GET_MORE_REQUESTS = 2;
+	init( PEEK_ADAPTIVE_PARALLEL_GET_MORE,                      true ); if( randomize && BUGGIFY ) PEEK_ADAPTIVE_PARALLEL_GET_MORE = false;
 	init( MULTI_CURSOR_PRE_FETCH_LIMIT,                           10 );
 	init( MAX_QUEUE_COMMIT_BYTES,                               15e6 ); if( randomize && BUGGIFY ) MAX_QUEUE_COMMIT_BYTES = 5000;
+	init( TLOG_GROUP_COMMIT_WINDOW_FRACTION,                     0.0 ); if( randomize && BUGGIFY ) TLOG_GROUP_COMMIT_WINDOW_FRACTION = deterministicRandom()->random01();
+	init( TLOG_GROUP_COMMIT_MAX_WINDOW,                        0.001 ); if( randomize && BUGGIFY ) TLOG_GROUP_COMMIT_MAX_WINDOW = 0.01;
 	init( DESIRED_OUTSTANDING_MESSAGES,                         5000 ); if( randomize && BUGGIFY ) DESIRED_OUTSTANDING_MESSAGES = deterministicRandom()->randomInt(0,100);
 	init( DESIRED_GET_MORE_DELAY,                              0.005 );
 	init( CONCURRENT_LOG_ROUTER_READS,                             5 ); if( randomize && BUGGIFY ) CONCURRENT_LOG_ROUTER_READS = 1;
 	init( LOG_ROUTER_PEEK_FROM_SATELLITES_PREFERRED,               1 ); if( randomize && BUGGIFY ) LOG_ROUTER_PEEK_FROM_SATELLITES_PREFERRED = 0;
 	init( LOG_ROUTER_PEEK_SWITCH_DC_TIME,                       60.0 );
+	init( LOG_ROUTER_PREFETCH_BYTES,                            50e6 ); if( randomize && BUGGIFY ) LOG_ROUTER_PREFETCH_BYTES = deterministicRandom()->coinflip() ? 0 : 100000;
 	init( DISK_QUEUE_ADAPTER_MIN_SWITCH_TIME,                    1.0 );
 	init( DISK_QUEUE_ADAPTER_MAX_SWITCH_TIME,                    5.0 );
 	init( TLOG_SPILL_REFERENCE_MAX_PEEK_MEMORY_BYTES,            2e9 ); if ( randomize && BUGGIFY ) TLOG_SPILL_REFERENCE_MAX_PEEK_MEMORY_BYTES = 2e6;
 	init( TLOG_SPILL_REFERENCE_MAX_BATCHES_PER_PEEK,           100 ); if ( randomize && BUGGIFY ) TLOG_SPILL_REFERENCE_MAX_BATCHES_PER_PEEK = 1;
 	init( TLOG_SPILL_REFERENCE_MAX_BYTES_PER_BATCH,           16<<10 ); if ( randomize && BUGGIFY ) TLOG_SPILL_REFERENCE_MAX_BYTES_PER_BATCH = 500;
+	init( TLOG_SPILL_READ_AHEAD_BYTES,                         4<<20 ); if ( randomize && BUGGIFY ) TLOG_SPILL_READ_AHEAD_BYTES = deterministicRandom()->coinflip() ? 0 : 20000;
+	init( TLOG_SPILL_READ_AHEAD_CACHE_BYTES,                    1e8 ); if ( randomize && BUGGIFY ) TLOG_SPILL_READ_AHEAD_CACHE_BYTES = 1e5;
+	init( TLOG_PEEK_COMPRESSION_FILTER,                       "NONE" ); if ( randomize && BUGGIFY ) { TLOG_PEEK_COMPRESSION_FILTER = CompressionUtils::toString(CompressionUtils::getRandomFilter()); }
+	init( TLOG_PEEK_COMPRESSION_MIN_BYTES,                      4096 ); if ( randomize && BUGGIFY ) TLOG_PEEK_COMPRESSION_MIN_BYTES = 0;
 	init( DISK_QUEUE_FILE_EXTENSION_BYTES,                    10<<20 ); // BUGGIFYd per file within the DiskQueue
 	init( DISK_QUEUE_FILE_SHRINK_BYTES,                      100<<20 ); // BUGGIFYd per file within the DiskQueue
 	init( DISK_QUEUE_MAX_TRUNCATE_BYTES,                     2LL<<30 ); if ( randomize && BUGGIFY ) DISK_QUEUE_MAX_TRUNCATE_BYTES = 0;
+	init( TLOG_DISK_QUEUE_STRIPE_FOLDERS,                         "" );
+	init( DISK_QUEUE_STRIPE_UNIT_BYTES,                      128<<10 ); if ( randomize && BUGGIFY ) DISK_QUEUE_STRIPE_UNIT_BYTES = 4096 * deterministicRandom()->randomInt(1, 33);
+	init( DISK_QUEUE_RECOVERY_READS,                               4 ); if ( randomize && BUGGIFY ) DISK_QUEUE_RECOVERY_READS = deterministicRandom()->randomInt(1, 9);
 	init( TLOG_DEGRADED_DURATION,                                5.0 );
 	init( MAX_CACHE_VERSIONS,                                   10e6 );
 	init( TLOG_IGNORE_POP_AUTO_ENABLE_DELAY,                   300.0 );
@@ -144,6 +157,8 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( RELOCATION_PARALLELISM_PER_SOURCE_SERVER,                2 ); if( randomize && BUGGIFY ) RELOCATION_PARALLELISM_PER_SOURCE_SERVER = 1;
 	init( RELOCATION_PARALLELISM_PER_DEST_SERVER,                 10 ); if( randomize && BUGGIFY ) RELOCATION_PARALLELISM_PER_DEST_SERVER = 1; // Note: if this is smaller than FETCH_KEYS_PARALLELISM, this will artificially reduce performance. The current default of 10 is probably too high but is set conservatively for now.
 	init( MERGE_RELOCATION_PARALLELISM_PER_TEAM,                   6 ); if (randomize && BUGGIFY ) MERGE_RELOCATION_PARALLELISM_PER_TEAM = 1;
+	init( DD_ZONE_MOVE_BYTES_PER_SEC,                              0 ); if( randomize && BUGGIFY ) DD_ZONE_MOVE_BYTES_PER_SEC = deterministicRandom()->randomInt(10, 200) * 1000000;
+	init( DATA_MOVE_BUDGET_PRIORITY_THRESHOLD,                   800 ); if( randomize && BUGGIFY ) DATA_MOVE_BUDGET_PRIORITY_THRESHOLD = 700;
 	init( DD_QUEUE_MAX_KEY_SERVERS,                              100 ); // Do not buggify
 	init( DD_REBALANCE_PARALLELISM,                               50 );
 	init( DD_REBALANCE_RESET_AMOUNT,                              30 );
@@ -186,6 +201,14 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	// TODO: choose a meaning value for real cluster
 	init( MAX_DEST_CPU_PERCENT, 		  					   100.0 );
 	init( DD_TEAM_PIVOT_UPDATE_DELAY,                            5.0 );
+	// A team's cost is its load bytes times 1 + the sum of each weight times the utilization of its busiest server
+	bool buggifyTeamCost = randomize && BUGGIFY;
+	init( DD_TEAM_COST_CPU_WEIGHT,                               0.0 ); if( buggifyTeamCost ) DD_TEAM_COST_CPU_WEIGHT = deterministicRandom()->random01() * 2;
+	init( DD_TEAM_COST_DISK_BUSY_WEIGHT,                         0.0 ); if( buggifyTeamCost ) DD_TEAM_COST_DISK_BUSY_WEIGHT = deterministicRandom()->random01() * 2;
+	init( DD_TEAM_COST_READ_OPS_WEIGHT,                          0.0 ); if( buggifyTeamCost ) DD_TEAM_COST_READ_OPS_WEIGHT = deterministicRandom()->random01() * 2;
+	init( DD_TEAM_COST_WRITE_BANDWIDTH_WEIGHT,                   0.0 ); if( buggifyTeamCost ) DD_TEAM_COST_WRITE_BANDWIDTH_WEIGHT = deterministicRandom()->random01() * 2;
+	init( DD_TEAM_COST_MAX_READ_OPS_PER_KSEC,       100000LL * 1000 ); if( buggifyTeamCost ) DD_TEAM_COST_MAX_READ_OPS_PER_KSEC = 1000LL * 1000;
+	init( DD_TEAM_COST_MAX_WRITE_BYTES_PER_KSEC, 100LL*1000000*1000 ); if( buggifyTeamCost ) DD_TEAM_COST_MAX_WRITE_BYTES_PER_KSEC = 1LL*1000000*1000;
 
 	init( ALLOW_LARGE_SHARD,                                   false ); if( randomize && BUGGIFY )  ALLOW_LARGE_SHARD = true;
 	init( MAX_LARGE_SHARD_BYTES,                          1000000000 ); // 1G
@@ -193,6 +216,7 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( ENABLE_DD_PHYSICAL_SHARD,                            false ); // EXPERIMENTAL; If true, SHARD_ENCODE_LOCATION_METADATA must be true; When true, optimization of data move between DCs is disabled
 	init( DD_PHYSICAL_SHARD_MOVE_PROBABILITY,                    0.0 ); if( isSimulated )  DD_PHYSICAL_SHARD_MOVE_PROBABILITY = 0.5;
 	init( ENABLE_PHYSICAL_SHARD_MOVE_EXPERIMENT,               false ); if( isSimulated )  ENABLE_PHYSICAL_SHARD_MOVE_EXPERIMENT = deterministicRandom()->coinflip();
+	init( DD_PHYSICAL_SHARD_MOVE_BY_DEFAULT,                    true ); if( isSimulated )  DD_PHYSICAL_SHARD_MOVE_BY_DEFAULT = deterministicRandom()->coinflip();
 	init( MAX_PHYSICAL_SHARD_BYTES,                         10000000 ); // 10 MB; for ENABLE_DD_PHYSICAL_SHARD; smaller leads to larger number of physicalShard per storage server
  	init( PHYSICAL_SHARD_METRICS_DELAY,                        300.0 ); // 300 seconds; for ENABLE_DD_PHYSICAL_SHARD
 	init( ANONYMOUS_PHYSICAL_SHARD_TRANSITION_TIME,            600.0 ); if( randomize && BUGGIFY )  ANONYMOUS_PHYSICAL_SHARD_TRANSITION_TIME = 0.0; // 600 seconds; for ENABLE_DD_PHYSICAL_SHARD
@@ -235,6 +259,9 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 		Shard with a read bandwidth smaller than this value will never be too busy to handle the reads.
 	*/
 	init( SHARD_MAX_BYTES_READ_PER_KSEC_JITTER,     0.1 );
+	init( STORAGE_CACHE_AUTO_ADMISSION,           false ); if( randomize && BUGGIFY ) STORAGE_CACHE_AUTO_ADMISSION = true;
+	init( STORAGE_CACHE_AUTO_MAX_BYTES,             1e9 ); if( randomize && BUGGIFY ) STORAGE_CACHE_AUTO_MAX_BYTES = 1e6;
+	init( STORAGE_CACHE_AUTO_IDLE_TIMEOUT,        600.0 ); if( randomize && BUGGIFY ) STORAGE_CACHE_AUTO_IDLE_TIMEOUT = 30.0;
 	bool buggifySmallBandwidthSplit = randomize && BUGGIFY;
 	init( SHARD_MAX_BYTES_PER_KSEC,                 1LL*1000000*1000 ); if( buggifySmallBandwidthSplit ) SHARD_MAX_BYTES_PER_KSEC = 10LL*1000*1000;
 	/* 1*1MB/sec * 1000sec/ksec
@@ -275,6 +302,19 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 		*/
 
 	init( ENABLE_WRITE_BASED_SHARD_SPLIT,                      false ); if( randomize && BUGGIFY ) ENABLE_WRITE_BASED_SHARD_SPLIT = true;
+	init( ENABLE_READ_BASED_SHARD_SPLIT,                       false ); if( randomize && BUGGIFY ) ENABLE_READ_BASED_SHARD_SPLIT = true;
+	init( SHARD_READ_SPLIT_BYTES_PER_KSEC,       50LL*1000000*1000 ); if( buggifySmallBandwidthSplit ) SHARD_READ_SPLIT_BYTES_PER_KSEC = 100LL*1000*1000;
+	init( SHARD_READ_SPLIT_OPS_PER_KSEC,                20000 * 1000 ); if( buggifySmallBandwidthSplit ) SHARD_READ_SPLIT_OPS_PER_KSEC = 100 * 1000;
+	/*
+		Shards reading more than either of these are split at the busiest keys, into pieces reading less than half of them.
+		The pieces are moved to the teams with the lowest read load.
+	*/
+	init( SHARD_READ_MERGE_RATIO,                               0.25 );
+	/*
+		Shards reading more than this fraction of SHARD_READ_SPLIT_BYTES_PER_KSEC or SHARD_READ_SPLIT_OPS_PER_KSEC are not merged, so
+		the pieces of a read split are not merged back until their reads have fallen well below the split threshold.
+	*/
+	init( SHARD_READ_SPLIT_MIN_BYTES,                            1e6 ); if( randomize && BUGGIFY ) SHARD_READ_SPLIT_MIN_BYTES = 1e4;
 	init( STORAGE_METRIC_TIMEOUT,         isSimulated ? 60.0 : 600.0 ); if( randomize && BUGGIFY ) STORAGE_METRIC_TIMEOUT = deterministicRandom()->coinflip() ? 10.0 : 30.0;
 	init( METRIC_DELAY,                                          0.1 ); if( randomize && BUGGIFY ) METRIC_DELAY = 1.0;
 	init( ALL_DATA_REMOVED_DELAY,                                1.0 );
@@ -287,6 +327,8 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( PERPETUAL_WIGGLE_MIN_BYTES_BALANCE_RATIO,             0.85 );
 	init( PW_MAX_SS_LESSTHAN_MIN_BYTES_BALANCE_RATIO,              0 );
 	init( PERPETUAL_WIGGLE_DISABLE_REMOVER,                     true );
+	init( PERPETUAL_WIGGLE_REBUILD_IN_PLACE,                   false );
+	init( PERPETUAL_WIGGLE_REBUILD_TIMEOUT,                   3600.0 ); if( randomize && BUGGIFY ) PERPETUAL_WIGGLE_REBUILD_TIMEOUT = 60.0;
 	init( LOG_ON_COMPLETION_DELAY,         DD_QUEUE_LOGGING_INTERVAL );
 	init( BEST_TEAM_MAX_TEAM_TRIES,                               10 );
 	init( BEST_TEAM_OPTION_COUNT,                                  4 );
@@ -452,6 +494,7 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( ROCKSDB_COMPACTION_THREAD_PRIORITY,                      0 );
 	init( ROCKSDB_BACKGROUND_PARALLELISM,                          3 );
 	init( ROCKSDB_READ_PARALLELISM,                isSimulated? 2: 4 );
+	init( ROCKSDB_READER_WORK_STEALING,                        false );
 	init( ROCKSDB_CHECKPOINT_READER_PARALLELISM,                   4 );
 	// If true, do not process and store RocksDB logs
 	init( ROCKSDB_MUTE_LOGS,                                    true );
@@ -466,11 +509,22 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( ROCKSDB_BLOOM_BITS_PER_KEY,                             10 );
 	init( ROCKSDB_BLOOM_WHOLE_KEY_FILTERING,                   false );
 	init( ROCKSDB_MAX_AUTO_READAHEAD_SIZE,                     65536 );
+	// Trims auto readahead of range reads at the iterator upper bound.
+	init( ROCKSDB_READ_RANGE_AUTO_READAHEAD_SIZE,               true ); if( randomize && BUGGIFY ) ROCKSDB_READ_RANGE_AUTO_READAHEAD_SIZE = deterministicRandom()->coinflip();
+	// Forward range reads allowed to return at least this many bytes (e.g. fetchKeys) prefetch up to
+	// ROCKSDB_READ_RANGE_MAX_READAHEAD_BYTES on each read. 0 disables.
+	init( ROCKSDB_READ_RANGE_READAHEAD_MIN_BYTES,            1 << 20 ); if( randomize && BUGGIFY ) ROCKSDB_READ_RANGE_READAHEAD_MIN_BYTES = deterministicRandom()->randomInt(1, 1 << 20);
+	init( ROCKSDB_READ_RANGE_MAX_READAHEAD_BYTES,            2 << 20 );
+	init( ROCKSDB_PARTITIONED_INDEX_FILTERS,                   false ); if( randomize && BUGGIFY ) ROCKSDB_PARTITIONED_INDEX_FILTERS = deterministicRandom()->coinflip();
 	// If rocksdb block cache size is 0, the default 8MB is used.
 	int64_t blockCacheSize = isSimulated ? 16 * 1024 : 4LL * 1024 * 1024 * 1024 /* 4GB */;
 	init( ROCKSDB_BLOCK_CACHE_SIZE,                   blockCacheSize ); /* Datablocks cache + Index&filter blocks cache */
 	init( ROCKSDB_CACHE_HIGH_PRI_POOL_RATIO,                     0.5 ); /* Share of high priority Index&filter blocks in cache */
 	init( ROCKSDB_CACHE_INDEX_AND_FILTER_BLOCKS,                true );
+	// If true, all ssd-rocksdb-v1 stores in a process share one ROCKSDB_BLOCK_CACHE_SIZE block cache.
+	init( ROCKSDB_SHARE_BLOCK_CACHE,                           false ); if( randomize && BUGGIFY ) ROCKSDB_SHARE_BLOCK_CACHE = deterministicRandom()->coinflip();
+	// Size of the compressed in-memory tier behind each block cache. 0 disables it.
+	init( ROCKSDB_COMPRESSED_SECONDARY_CACHE_SIZE,                 0 ); if( randomize && BUGGIFY ) ROCKSDB_COMPRESSED_SECONDARY_CACHE_SIZE = 16 * 1024;
 	init( ROCKSDB_METRICS_DELAY,                                60.0 );
 	// ROCKSDB_READ_VALUE_TIMEOUT, ROCKSDB_READ_VALUE_PREFIX_TIMEOUT, ROCKSDB_READ_RANGE_TIMEOUT knobs:
 	// In simulation, increasing the read operation timeouts to 5 minutes, as some of the tests have
@@ -485,10 +539,13 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( ROCKSDB_READ_QUEUE_SOFT_MAX,                           500 );
 	init( ROCKSDB_FETCH_QUEUE_HARD_MAX,                          100 );
 	init( ROCKSDB_FETCH_QUEUE_SOFT_MAX,                           50 );
+	init( ROCKSDB_READ_VALUE_BATCH_MAX_KEYS,                       0 ); if( randomize && BUGGIFY ) ROCKSDB_READ_VALUE_BATCH_MAX_KEYS = deterministicRandom()->randomInt(1, 100);
+	init( ROCKSDB_READ_VALUE_BATCH_ASYNC_IO,                   false ); if( randomize && BUGGIFY ) ROCKSDB_READ_VALUE_BATCH_ASYNC_IO = deterministicRandom()->coinflip();
 	init( ROCKSDB_HISTOGRAMS_SAMPLE_RATE,                      0.001 ); if( randomize && BUGGIFY ) ROCKSDB_HISTOGRAMS_SAMPLE_RATE = 0;
 	init( ROCKSDB_READ_RANGE_ITERATOR_REFRESH_TIME,             30.0 ); if( randomize && BUGGIFY ) ROCKSDB_READ_RANGE_ITERATOR_REFRESH_TIME = 0.1;
 	init( ROCKSDB_READ_RANGE_REUSE_ITERATORS,                   true ); if( randomize && BUGGIFY ) ROCKSDB_READ_RANGE_REUSE_ITERATORS = deterministicRandom()->coinflip();
-	init( SHARDED_ROCKSDB_REUSE_ITERATORS,                     false );
+	init( SHARDED_ROCKSDB_REUSE_ITERATORS,                     false ); if( randomize && BUGGIFY ) SHARDED_ROCKSDB_REUSE_ITERATORS = deterministicRandom()->coinflip();
+	init( SHARDED_ROCKSDB_MAX_POOLED_ITERATORS,                    8 ); if( randomize && BUGGIFY ) SHARDED_ROCKSDB_MAX_POOLED_ITERATORS = deterministicRandom()->randomInt(1, 4);
 	init( ROCKSDB_READ_RANGE_REUSE_BOUNDED_ITERATORS,          false ); if( randomize && BUGGIFY ) ROCKSDB_READ_RANGE_REUSE_BOUNDED_ITERATORS = deterministicRandom()->coinflip();
 	init( ROCKSDB_READ_RANGE_BOUNDED_ITERATORS_MAX_LIMIT,        200 );
 	// Set to 0 to disable rocksdb write rate limiting. Rate limiter unit: bytes per second.
@@ -496,6 +553,12 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( ROCKSDB_WRITE_RATE_LIMITER_FAIRNESS,                    10 ); // RocksDB default 10
 	// If true, enables dynamic adjustment of ROCKSDB_WRITE_RATE_LIMITER_BYTES according to the recent demand of background IO.
 	init( ROCKSDB_WRITE_RATE_LIMITER_AUTO_TUNE,                 true );
+	init( ROCKSDB_IO_PRESSURE_INTERVAL,                          1.0 );
+	// Set to 0 to keep the background IO rate fixed. Takes effect when the rate limiter isn't auto tuned.
+	init( ROCKSDB_RATE_LIMITER_READ_LATENCY_TARGET,                0 ); if( randomize && BUGGIFY ) ROCKSDB_RATE_LIMITER_READ_LATENCY_TARGET = 0.005;
+	init( ROCKSDB_RATE_LIMITER_MIN_FRACTION,                     0.1 );
+	init( ROCKSDB_RATE_LIMITER_BACKOFF,                          0.8 );
+	init( ROCKSDB_RATE_LIMITER_RECOVERY,                        0.05 );
 	init( DEFAULT_FDB_ROCKSDB_COLUMN_FAMILY,                   "fdb" );
 	init( ROCKSDB_DISABLE_AUTO_COMPACTIONS,                    false ); // RocksDB default
 
@@ -591,6 +654,14 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( SHARDED_ROCKSDB_WRITE_BUFFER_SIZE,                16 << 20 ); // 16MB
 	init( SHARDED_ROCKSDB_TOTAL_WRITE_BUFFER_SIZE,           1 << 30 ); // 1GB
 	init( SHARDED_ROCKSDB_MEMTABLE_BUDGET,                  64 << 20 ); // 64MB
+	init( SHARDED_ROCKSDB_MEMTABLE_MEM_FRACTION_OF_TOTAL,        0.0 ); if( randomize && BUGGIFY ) SHARDED_ROCKSDB_MEMTABLE_MEM_FRACTION_OF_TOTAL = 0.01; // 0 keeps the fixed SHARDED_ROCKSDB_TOTAL_WRITE_BUFFER_SIZE budget.
+	init( SHARDED_ROCKSDB_WRITE_BUFFER_MANAGER_ALLOW_STALL,     false ); if( randomize && BUGGIFY ) SHARDED_ROCKSDB_WRITE_BUFFER_MANAGER_ALLOW_STALL = deterministicRandom()->coinflip();
+	init( SHARDED_ROCKSDB_CHARGE_MEMTABLE_TO_BLOCK_CACHE,       false ); if( randomize && BUGGIFY ) SHARDED_ROCKSDB_CHARGE_MEMTABLE_TO_BLOCK_CACHE = deterministicRandom()->coinflip();
+	init( SHARDED_ROCKSDB_ADAPTIVE_WRITE_BUFFER_SIZE,           false ); if( randomize && BUGGIFY ) SHARDED_ROCKSDB_ADAPTIVE_WRITE_BUFFER_SIZE = deterministicRandom()->coinflip();
+	init( SHARDED_ROCKSDB_MIN_WRITE_BUFFER_SIZE,              1 << 20 ); // 1MB
+	init( SHARDED_ROCKSDB_WRITE_BUFFER_TUNING_INTERVAL,          30.0 ); if( randomize && BUGGIFY ) SHARDED_ROCKSDB_WRITE_BUFFER_TUNING_INTERVAL = 1.0;
+	init( SHARDED_ROCKSDB_INGEST_FETCHED_RANGES,               false ); if( randomize && BUGGIFY ) SHARDED_ROCKSDB_INGEST_FETCHED_RANGES = deterministicRandom()->coinflip();
+	init( SHARDED_ROCKSDB_INGEST_MIN_BYTES,                  1 << 20 ); if( randomize && BUGGIFY ) SHARDED_ROCKSDB_INGEST_MIN_BYTES = deterministicRandom()->randomInt(1, 1 << 16);
 	init( SHARDED_ROCKSDB_MAX_WRITE_BUFFER_NUMBER,                 6 ); // RocksDB default.
 	init( SHARDED_ROCKSDB_TARGET_FILE_SIZE_BASE,            16 << 20 ); // 16MB
 	init( SHARDED_ROCKSDB_TARGET_FILE_SIZE_MULTIPLIER,             1 ); // RocksDB default.
@@ -634,7 +705,10 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( TAG_THROTTLE_RATE_WINDOW,                              2.0 );
 	init( START_TRANSACTION_MAX_EMPTY_QUEUE_BUDGET,             10.0 );
 	init( TAG_THROTTLE_MAX_EMPTY_QUEUE_BUDGET,                1000.0 );
+	init( TAG_THROTTLE_MAX_BURST_DURATION,                       0.0 ); if( randomize && BUGGIFY ) TAG_THROTTLE_MAX_BURST_DURATION = deterministicRandom()->random01();
 	init( START_TRANSACTION_MAX_QUEUE_SIZE,                      1e6 ); if ( randomize && BUGGIFY ) START_TRANSACTION_MAX_QUEUE_SIZE = 1000;
+	init( START_TRANSACTION_DEFAULT_LATENCY_TARGET,            0.005 );
+	init( START_TRANSACTION_BATCH_LATENCY_TARGET,                0.0 ); if ( randomize && BUGGIFY ) START_TRANSACTION_BATCH_LATENCY_TARGET = deterministicRandom()->random01();
 	init( KEY_LOCATION_MAX_QUEUE_SIZE,                           1e6 );
 	init( TENANT_ID_REQUEST_MAX_QUEUE_SIZE,                      1e6 );
 	init( BLOB_GRANULE_LOCATION_MAX_QUEUE_SIZE,                  1e5 ); if ( randomize && BUGGIFY ) BLOB_GRANULE_LOCATION_MAX_QUEUE_SIZE = 100;
@@ -646,11 +720,19 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( COMMIT_TRANSACTION_BATCH_INTERVAL_MAX,                0.020 );
 	init( COMMIT_TRANSACTION_BATCH_INTERVAL_LATENCY_FRACTION,     0.1 );
 	init( COMMIT_TRANSACTION_BATCH_INTERVAL_SMOOTHER_ALPHA,       0.1 );
+	init( COMMIT_BATCH_INTERVAL_CONTROLLER,                     false ); if( randomize && BUGGIFY ) COMMIT_BATCH_INTERVAL_CONTROLLER = true;
+	init( COMMIT_BATCH_TARGET_LATENCY,                          0.025 ); if( randomize && BUGGIFY ) COMMIT_BATCH_TARGET_LATENCY = deterministicRandom()->random01() * 0.1;
+	init( COMMIT_BATCH_CONTROLLER_GAIN,                           0.1 );
+	init( COMMIT_BATCH_CONTROLLER_MAX_BATCHES_IN_FLIGHT,           10 ); if( randomize && BUGGIFY ) COMMIT_BATCH_CONTROLLER_MAX_BATCHES_IN_FLIGHT = 2;
+	init( COMMIT_BATCH_CONTROLLER_WINDOW,                        1000 ); if( randomize && BUGGIFY ) COMMIT_BATCH_CONTROLLER_WINDOW = 10;
 	init( COMMIT_TRANSACTION_BATCH_COUNT_MAX,                   32768 ); if( randomize && BUGGIFY ) COMMIT_TRANSACTION_BATCH_COUNT_MAX = 1000; // Do NOT increase this number beyond 32768, as CommitIds only budget 2 bytes for storing transaction id within each batch
 	init( COMMIT_BATCHES_MEM_BYTES_HARD_LIMIT,              8LL << 30 ); if (randomize && BUGGIFY) COMMIT_BATCHES_MEM_BYTES_HARD_LIMIT = deterministicRandom()->randomInt64(100LL << 20,  8LL << 30);
 	init( COMMIT_BATCHES_MEM_FRACTION_OF_TOTAL,                   0.5 );
 	init( COMMIT_BATCHES_MEM_TO_TOTAL_MEM_SCALE_FACTOR,           5.0 );
 	init( COMMIT_TRIGGER_DELAY,                                  0.01 ); if (randomize && BUGGIFY) COMMIT_TRIGGER_DELAY = deterministicRandom()->random01() * 4;
+	init( COMMIT_BATCH_RECORDING_FILE,                             "" );
+	init( COMMIT_BATCH_RECORDING_MAX_BYTES,                       1e9 );
+	init( COMMIT_BATCH_RECORDING_MAX_PENDING_BYTES,             100e6 );
 
 	// these settings disable batch bytes scaling.  Try COMMIT_TRANSACTION_BATCH_BYTES_MAX=1e6, COMMIT_TRANSACTION_BATCH_BYTES_SCALE_BASE=50000, COMMIT_TRANSACTION_BATCH_BYTES_SCALE_POWER=0.5?
 	init( COMMIT_TRANSACTION_BATCH_BYTES_MIN,                  100000 );
@@ -659,6 +741,11 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( COMMIT_TRANSACTION_BATCH_BYTES_SCALE_POWER,             0.0 );
 
 	init( RESOLVER_COALESCE_TIME,                                1.0 );
+	init( RESOLVER_CONFLICT_SET_PARTITIONS,                        1 ); if( randomize && BUGGIFY ) RESOLVER_CONFLICT_SET_PARTITIONS = deterministicRandom()->randomInt(2, 9);
+	init( RESOLVER_CONFLICT_SET_MIN_PARTITION_RANGES,            500 ); if( randomize && BUGGIFY ) RESOLVER_CONFLICT_SET_MIN_PARTITION_RANGES = deterministicRandom()->randomInt(1, 10);
+	init( RESOLVER_CONFLICT_SET_BTREE,                         false ); if( randomize && BUGGIFY ) RESOLVER_CONFLICT_SET_BTREE = true;
+	init( RESOLVER_IDLE_REMOVAL_INTERVAL,                        0.1 ); if( randomize && BUGGIFY ) RESOLVER_IDLE_REMOVAL_INTERVAL = deterministicRandom()->random01();
+	init( RESOLVER_IDLE_REMOVAL_NODES,                          1000 ); if( randomize && BUGGIFY ) RESOLVER_IDLE_REMOVAL_NODES = deterministicRandom()->randomInt(0, 100);
 	init( BUGGIFIED_ROW_LIMIT,                  APPLY_MUTATION_BYTES ); if( randomize && BUGGIFY ) BUGGIFIED_ROW_LIMIT = deterministicRandom()->randomInt(3, 30);
 	init( PROXY_SPIN_DELAY,                                     0.01 );
 	init( UPDATE_REMOTE_LOG_VERSION_INTERVAL,                    2.0 );
@@ -669,6 +756,7 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( ENFORCED_MIN_RECOVERY_DURATION,                       0.085 ); if( shortRecoveryDuration ) ENFORCED_MIN_RECOVERY_DURATION = 0.01;
 	init( REQUIRED_MIN_RECOVERY_DURATION,                       0.080 ); if( shortRecoveryDuration ) REQUIRED_MIN_RECOVERY_DURATION = 0.01;
 	init( ALWAYS_CAUSAL_READ_RISKY,                             false );
+	init( GRV_PROXY_CAUSAL_READ_RISKY_CACHE_AGE,                  0.0 );
 	init( MAX_COMMIT_UPDATES,                                    2000 ); if( randomize && BUGGIFY ) MAX_COMMIT_UPDATES = 1;
 	init( MAX_PROXY_COMPUTE,                                      2.0 );
 	init( MAX_COMPUTE_PER_OPERATION,                              0.1 );
@@ -678,6 +766,10 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( TXN_STATE_SEND_AMOUNT,                                    4 );
 	init( REPORT_TRANSACTION_COST_ESTIMATION_DELAY,               0.1 );
 	init( PROXY_REJECT_BATCH_QUEUED_TOO_LONG,                    true );
+	init( PROXY_REPLY_CONFLICTS_AFTER_RESOLUTION,                true ); if( randomize && BUGGIFY ) PROXY_REPLY_CONFLICTS_AFTER_RESOLUTION = false;
+	init( PROXY_MUTATION_ENCRYPTION_THREADS,                        0 ); if( randomize && BUGGIFY ) PROXY_MUTATION_ENCRYPTION_THREADS = deterministicRandom()->randomInt(1, 4);
+	init( PROXY_PARALLEL_ENCRYPTION_MIN_MUTATIONS,                500 ); if( randomize && BUGGIFY ) PROXY_PARALLEL_ENCRYPTION_MIN_MUTATIONS = 1;
+	init( PROXY_RESERVE_LOG_MESSAGES_MIN_BYTES,                  1e5 ); if( randomize && BUGGIFY ) PROXY_RESERVE_LOG_MESSAGES_MIN_BYTES = 0;
 
 	bool buggfyUseResolverPrivateMutations = randomize && BUGGIFY && !ENABLE_VERSION_VECTOR_TLOG_UNICAST;
 	init( PROXY_USE_RESOLVER_PRIVATE_MUTATIONS,                 false ); if( buggfyUseResolverPrivateMutations ) PROXY_USE_RESOLVER_PRIVATE_MUTATIONS = deterministicRandom()->coinflip();
@@ -725,6 +817,7 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( BACKUP_FILE_BLOCK_BYTES,                       1024 * 1024 );
 	init( BACKUP_LOCK_BYTES,                                     3e9 ); if(randomize && BUGGIFY) BACKUP_LOCK_BYTES = deterministicRandom()->randomInt(1024, 4096) * 4096;
 	init( BACKUP_UPLOAD_DELAY,                                  10.0 ); if(randomize && BUGGIFY) BACKUP_UPLOAD_DELAY = deterministicRandom()->random01() * 60;
+	init( BACKUP_WORKER_APPEND_BATCH_BYTES,                  8 << 20 ); if(randomize && BUGGIFY) BACKUP_WORKER_APPEND_BATCH_BYTES = deterministicRandom()->randomInt(1, 64 << 10);
 
 	//Cluster Controller
 	init( CLUSTER_CONTROLLER_LOGGING_DELAY,                      5.0 );
@@ -759,6 +852,7 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( REPLACE_INTERFACE_DELAY,                              60.0 );
 	init( REPLACE_INTERFACE_CHECK_DELAY,                         5.0 );
 	init( COORDINATOR_REGISTER_INTERVAL,                         5.0 );
+	init( COORDINATOR_REGISTER_BATCH_SIZE,                        100 ); if( randomize && BUGGIFY ) COORDINATOR_REGISTER_BATCH_SIZE = deterministicRandom()->randomInt(1, 5);
 	init( CLIENT_REGISTER_INTERVAL,                            600.0 );
 	init( CC_ENABLE_WORKER_HEALTH_MONITOR,                     false );
 	init( CC_WORKER_HEALTH_CHECKING_INTERVAL,                   60.0 );
@@ -792,6 +886,7 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( POLICY_GENERATIONS,                                    100 ); if( randomize && BUGGIFY ) POLICY_GENERATIONS = 10;
 	init( DBINFO_SEND_AMOUNT,                                      5 );
 	init( DBINFO_BATCH_DELAY,                                    0.1 );
+	init( DBINFO_SEND_DELTAS,                                   true ); if( randomize && BUGGIFY ) DBINFO_SEND_DELTAS = false;
 	init( SINGLETON_RECRUIT_BME_DELAY,                          10.0 );
 	init( RECORD_RECOVER_AT_IN_CSTATE,                         false );
 	init( TRACK_TLOG_RECOVERY,                                 false );
@@ -822,6 +917,8 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( SMOOTHING_AMOUNT,                                      1.0 ); if( slowRatekeeper ) SMOOTHING_AMOUNT = 5.0;
 	init( SLOW_SMOOTHING_AMOUNT,                                10.0 ); if( slowRatekeeper ) SLOW_SMOOTHING_AMOUNT = 50.0;
 	init( METRIC_UPDATE_RATE,                                     .1 ); if( slowRatekeeper ) METRIC_UPDATE_RATE = 0.5;
+	init( RATEKEEPER_IDLE_STORAGE_METRIC_UPDATE_RATE,             0 ); if( randomize && BUGGIFY ) RATEKEEPER_IDLE_STORAGE_METRIC_UPDATE_RATE = deterministicRandom()->random01();
+	init( RATEKEEPER_BUSY_STORAGE_METRIC_UPDATE_RATE,             0 ); if( randomize && BUGGIFY ) RATEKEEPER_BUSY_STORAGE_METRIC_UPDATE_RATE = 0.025;
 	init( DETAILED_METRIC_UPDATE_RATE,                           5.0 );
 	init( RATEKEEPER_DEFAULT_LIMIT,                              1e6 ); if( randomize && BUGGIFY ) RATEKEEPER_DEFAULT_LIMIT = 0;
 	init( RATEKEEPER_LIMIT_REASON_SAMPLE_RATE,                   0.1 );
@@ -838,6 +935,8 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( AUTO_TAG_THROTTLE_SPRING_BYTES_STORAGE_SERVER,       200e6 ); if( smallStorageTarget ) AUTO_TAG_THROTTLE_SPRING_BYTES_STORAGE_SERVER = 500e3;
 	init( TARGET_BYTES_PER_STORAGE_SERVER_BATCH,               750e6 ); if( smallStorageTarget ) TARGET_BYTES_PER_STORAGE_SERVER_BATCH = 1500e3;
 	init( SPRING_BYTES_STORAGE_SERVER_BATCH,                   100e6 ); if( smallStorageTarget ) SPRING_BYTES_STORAGE_SERVER_BATCH = 150e3;
+	init( RATEKEEPER_IO_PRESSURE_TARGET_REDUCTION,                0 ); if( randomize && BUGGIFY ) RATEKEEPER_IO_PRESSURE_TARGET_REDUCTION = 0.5;
+	init( RATEKEEPER_STORAGE_QUEUE_LOOKAHEAD,                     0 ); if( randomize && BUGGIFY ) RATEKEEPER_STORAGE_QUEUE_LOOKAHEAD = deterministicRandom()->random01() * 10.0;
 	init( STORAGE_HARD_LIMIT_BYTES,                           1500e6 ); if( smallStorageTarget ) STORAGE_HARD_LIMIT_BYTES = 4500e3;
 	init( STORAGE_HARD_LIMIT_BYTES_OVERAGE,                   5000e3 ); if( smallStorageTarget ) STORAGE_HARD_LIMIT_BYTES_OVERAGE = 100e3; // byte+version overage ensures storage server makes enough progress on freeing up storage queue memory at hard limit by ensuring it advances desiredOldestVersion enough per commit cycle.
 	init( STORAGE_HARD_LIMIT_BYTES_SPEED_UP_SIM, STORAGE_HARD_LIMIT_BYTES ); if( smallStorageTarget ) STORAGE_HARD_LIMIT_BYTES_SPEED_UP_SIM *= 10;
@@ -850,6 +949,12 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init (STORAGE_FETCH_KEYS_DELAY,	                             0.0 ); if ( randomize && BUGGIFY ) { STORAGE_FETCH_KEYS_DELAY = deterministicRandom()->random01() * 5.0; }
 	init (STORAGE_FETCH_KEYS_USE_COMMIT_BUDGET,                false ); if (isSimulated) STORAGE_FETCH_KEYS_USE_COMMIT_BUDGET = deterministicRandom()->coinflip();
 	init (STORAGE_FETCH_KEYS_RATE_LIMIT,             			   0 ); if (isSimulated && BUGGIFY) STORAGE_FETCH_KEYS_RATE_LIMIT = 100 * 1024 * deterministicRandom()->randomInt(1, 10);  // In MB/s
+	init( STORAGE_FETCH_SOURCE_BYTES_PER_SEC,                      0 ); if( randomize && BUGGIFY ) STORAGE_FETCH_SOURCE_BYTES_PER_SEC = deterministicRandom()->randomInt(1, 100) * 1000000;
+	init( STORAGE_FETCH_SOURCE_READ_LATENCY_TARGET,             0.01 ); if( randomize && BUGGIFY ) STORAGE_FETCH_SOURCE_READ_LATENCY_TARGET = 0.001;
+	init( STORAGE_FETCH_SOURCE_MIN_FRACTION,                     0.1 );
+	init( STORAGE_FETCH_SOURCE_BACKOFF,                          0.8 );
+	init( STORAGE_FETCH_SOURCE_RECOVERY,                        0.05 );
+	init( STORAGE_FETCH_SOURCE_ADJUST_INTERVAL,                  1.0 );
 	init (STORAGE_ROCKSDB_LOG_CLEAN_UP_DELAY,               3600 * 2 ); if (isSimulated) STORAGE_ROCKSDB_LOG_CLEAN_UP_DELAY = 20.0;
 	init (STORAGE_ROCKSDB_LOG_TTL,                    3600 * 24 * 15 ); if (isSimulated) STORAGE_ROCKSDB_LOG_TTL = 3600.0;
 
@@ -935,6 +1040,7 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( HOT_SHARD_THROTTLING_EXPIRE_AFTER,                      3.0 );
 	init( HOT_SHARD_THROTTLING_TRACKED,                             1 );
 	init( HOT_SHARD_MONITOR_FREQUENCY,                            5.0 );
+	init( HOT_SHARD_THROTTLING_SPARES_CLUSTER,                  false ); if(randomize && BUGGIFY) HOT_SHARD_THROTTLING_SPARES_CLUSTER = true;
 
 	init( GENERATE_DATA_ENABLED,                                false );
 	init( GENERATE_DATA_PER_VERSION_MAX,                        10000 );
@@ -943,6 +1049,8 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( STORAGE_METRICS_AVERAGE_INTERVAL,                    120.0 );
 	init( STORAGE_METRICS_AVERAGE_INTERVAL_PER_KSECONDS,        1000.0 / STORAGE_METRICS_AVERAGE_INTERVAL );  // milliHz!
 	init( SPLIT_JITTER_AMOUNT,                                  0.05 ); if( randomize && BUGGIFY ) SPLIT_JITTER_AMOUNT = 0.2;
+	init( SPLIT_BY_ENGINE_SIZES,                               false ); if( randomize && BUGGIFY ) SPLIT_BY_ENGINE_SIZES = true;
+	init( SPLIT_BY_ENGINE_SIZES_MAX_KEYS,                       1000 ); if( randomize && BUGGIFY ) SPLIT_BY_ENGINE_SIZES_MAX_KEYS = deterministicRandom()->randomInt(1, 100);
 	init( IOPS_UNITS_PER_SAMPLE,                                10000 * 1000 / STORAGE_METRICS_AVERAGE_INTERVAL_PER_KSECONDS / 100 );
 	init( BYTES_WRITTEN_UNITS_PER_SAMPLE,                           SHARD_MIN_BYTES_PER_KSEC / STORAGE_METRICS_AVERAGE_INTERVAL_PER_KSECONDS / 25 );
 	init( BYTES_READ_UNITS_PER_SAMPLE,                          100000 ); // 100K bytes
@@ -966,6 +1074,8 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( FETCH_BLOCK_BYTES,                                     2e6 );
 	init( FETCH_KEYS_PARALLELISM_BYTES,                          4e6 ); if( randomize && BUGGIFY ) FETCH_KEYS_PARALLELISM_BYTES = 3e6;
 	init( FETCH_KEYS_PARALLELISM,                                  2 );
+	init( FETCH_KEYS_PARALLEL_RANGES,                              4 ); if( randomize && BUGGIFY ) FETCH_KEYS_PARALLEL_RANGES = deterministicRandom()->randomInt(1, 9);
+	init( FETCH_KEYS_PARALLEL_RANGE_BYTES,                      50e6 ); if( randomize && BUGGIFY ) FETCH_KEYS_PARALLEL_RANGE_BYTES = deterministicRandom()->randomInt(1e3, 1e6);
 	init( FETCH_KEYS_PARALLELISM_CHANGE_FEED,                      6 );
 	init( FETCH_KEYS_LOWER_PRIORITY,                               0 );
 	init( SERVE_FETCH_CHECKPOINT_PARALLELISM,                      4 );
@@ -977,6 +1087,7 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( AUDIT_DATAMOVE_POST_CHECK,                           false ); if ( isSimulated ) AUDIT_DATAMOVE_POST_CHECK = true;
 	init( AUDIT_DATAMOVE_POST_CHECK_RETRY_COUNT_MAX,              50 );
 	init( AUDIT_STORAGE_RATE_PER_SERVER_MAX,                    50e6 ); // per second
+	init( AUDIT_STORAGE_DIGEST_BYTES,                           10e6 ); if ( randomize && BUGGIFY ) AUDIT_STORAGE_DIGEST_BYTES = deterministicRandom()->coinflip() ? 0 : 1e6;
 	init( ENABLE_AUDIT_VERBOSE_TRACE,                          false );
 	init( LOGGING_STORAGE_COMMIT_WHEN_IO_TIMEOUT,               true );
 	init( LOGGING_RECENT_STORAGE_COMMIT_SIZE,                     20 );
@@ -991,6 +1102,10 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( STORAGE_ROCKSDB_FETCH_BYTES,                       2500000 ); if( randomize && BUGGIFY ) STORAGE_FETCH_BYTES =  500000;
 	init( STORAGE_DURABILITY_LAG_REJECT_THRESHOLD,              0.25 );
 	init( STORAGE_DURABILITY_LAG_MIN_RATE,                       0.1 );
+	init( STORAGE_IO_PRESSURE_PENALTY,                           1.0 );
+	init( STORAGE_ADMISSION_TARGET_READ_QUEUE,                     0 ); if( randomize && BUGGIFY ) STORAGE_ADMISSION_TARGET_READ_QUEUE = deterministicRandom()->randomInt(10, 1000);
+	init( STORAGE_ADMISSION_MIN_WINDOW,                          1.0 );
+	init( STORAGE_ADMISSION_CLIENT_INTERVAL,                     1.0 );
 	init( STORAGE_COMMIT_INTERVAL,                               0.5 ); if( randomize && BUGGIFY ) STORAGE_COMMIT_INTERVAL = 2.0;
 
 	// Constants which affect the fraction of data which is sampled
@@ -1012,29 +1127,44 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( MIN_BYTE_SAMPLING_PROBABILITY,                           0 );
 
 	init( MAX_STORAGE_SERVER_WATCH_BYTES,                      100e6 ); if( randomize && BUGGIFY ) MAX_STORAGE_SERVER_WATCH_BYTES = 10e3;
+	init( WATCH_VALUES_STREAM_LIMIT_BYTES,                       1e5 ); if( randomize && BUGGIFY ) WATCH_VALUES_STREAM_LIMIT_BYTES = 1;
 	init( MAX_BYTE_SAMPLE_CLEAR_MAP_SIZE,                        1e9 ); if( randomize && BUGGIFY ) MAX_BYTE_SAMPLE_CLEAR_MAP_SIZE = 1e3;
 	init( LONG_BYTE_SAMPLE_RECOVERY_DELAY,                      60.0 );
 	init( BYTE_SAMPLE_LOAD_PARALLELISM,                            8 ); if( randomize && BUGGIFY ) BYTE_SAMPLE_LOAD_PARALLELISM = 1;
 	init( BYTE_SAMPLE_LOAD_DELAY,                                0.0 ); if( randomize && BUGGIFY ) BYTE_SAMPLE_LOAD_DELAY = 0.1;
 	init( BYTE_SAMPLE_START_DELAY,                               1.0 ); if( randomize && BUGGIFY ) BYTE_SAMPLE_START_DELAY = 0.0;
+	init( BYTE_SAMPLE_BATCH_UPDATES,                            true ); if( randomize && BUGGIFY ) BYTE_SAMPLE_BATCH_UPDATES = deterministicRandom()->coinflip();
 	init( BEHIND_CHECK_DELAY,                                    2.0 );
 	init( BEHIND_CHECK_COUNT,                                      2 );
 	init( BEHIND_CHECK_VERSIONS,             5 * VERSIONS_PER_SECOND );
 	init( WAIT_METRICS_WRONG_SHARD_CHANCE,   isSimulated ? 1.0 : 0.1 );
 	init( MIN_TAG_READ_PAGES_RATE,                               100 ); if( randomize && BUGGIFY ) MIN_TAG_READ_PAGES_RATE = 0;
 	init( MIN_TAG_WRITE_PAGES_RATE,                              100 ); if( randomize && BUGGIFY ) MIN_TAG_WRITE_PAGES_RATE = 0;
+	init( READ_TAG_COST_PER_ROW,                                   0 ); if( randomize && BUGGIFY ) READ_TAG_COST_PER_ROW = deterministicRandom()->randomInt(1, 1000);
 	init( TAG_MEASUREMENT_INTERVAL,                              5.0 ); if( randomize && BUGGIFY ) TAG_MEASUREMENT_INTERVAL = 10.0;
+	init( HOT_KEY_TRACKING_ENABLED,                             true ); if( randomize && BUGGIFY ) HOT_KEY_TRACKING_ENABLED = false;
+	init( HOT_KEY_MEASUREMENT_INTERVAL,                         30.0 ); if( randomize && BUGGIFY ) HOT_KEY_MEASUREMENT_INTERVAL = 5.0;
+	init( HOT_KEY_SKETCH_DEPTH,                                    4 ); if( randomize && BUGGIFY ) HOT_KEY_SKETCH_DEPTH = deterministicRandom()->randomInt(1, 5);
+	init( HOT_KEY_SKETCH_WIDTH,                                 1024 ); if( randomize && BUGGIFY ) HOT_KEY_SKETCH_WIDTH = deterministicRandom()->randomInt(1, 64);
+	init( HOT_KEYS_TRACKED,                                       10 ); if( randomize && BUGGIFY ) HOT_KEYS_TRACKED = deterministicRandom()->randomInt(0, 3);
+	init( HOT_KEY_PREFIX_BYTES,                                    8 ); if( randomize && BUGGIFY ) HOT_KEY_PREFIX_BYTES = deterministicRandom()->randomInt(1, 20);
 	init( PREFIX_COMPRESS_KVS_MEM_SNAPSHOTS,                    true ); if( randomize && BUGGIFY ) PREFIX_COMPRESS_KVS_MEM_SNAPSHOTS = false;
+	init( KVS_MEM_RECOVERY_BATCH_SETS,                          true ); if( randomize && BUGGIFY ) KVS_MEM_RECOVERY_BATCH_SETS = false;
+	init( KVS_MEM_USE_BTREE_CONTAINER,                         false ); if( randomize && BUGGIFY ) KVS_MEM_USE_BTREE_CONTAINER = deterministicRandom()->coinflip();
 	init( REPORT_DD_METRICS,                                    true );
 	init( DD_METRICS_REPORT_INTERVAL,                           30.0 );
 	init( FETCH_KEYS_TOO_LONG_TIME_CRITERIA,                   300.0 );
 	init( MAX_STORAGE_COMMIT_TIME,                             200.0 ); //The max fsync stall time on the storage server and tlog before marking a disk as failed
 	init( RANGESTREAM_LIMIT_BYTES,                               2e6 ); if( randomize && BUGGIFY ) RANGESTREAM_LIMIT_BYTES = 1;
+	init( RANGESTREAM_CHUNK_BYTES_MAX,                           5e5 ); if( randomize && BUGGIFY ) RANGESTREAM_CHUNK_BYTES_MAX = 1;
 	init( CHANGEFEEDSTREAM_LIMIT_BYTES,                          1e6 ); if( randomize && BUGGIFY ) CHANGEFEEDSTREAM_LIMIT_BYTES = 1;
 	init( BLOBWORKERSTATUSSTREAM_LIMIT_BYTES,                    1e4 ); if( randomize && BUGGIFY ) BLOBWORKERSTATUSSTREAM_LIMIT_BYTES = 1;
 	init( ENABLE_CLEAR_RANGE_EAGER_READS,                       true ); if( randomize && BUGGIFY ) ENABLE_CLEAR_RANGE_EAGER_READS = deterministicRandom()->coinflip();
 	init( CHECKPOINT_TRANSFER_BLOCK_BYTES,                      40e6 );
+	init( CHECKPOINT_TRANSFER_CHUNK_BYTES,                       4e6 ); if( randomize && BUGGIFY ) CHECKPOINT_TRANSFER_CHUNK_BYTES = deterministicRandom()->randomInt(1e3, 1e5);
+	init( SERVE_FETCH_CHECKPOINT_BYTES_PER_SECOND,               1e9 ); if( isSimulated && BUGGIFY ) SERVE_FETCH_CHECKPOINT_BYTES_PER_SECOND = deterministicRandom()->randomInt(1e5, 1e8);
 	init( QUICK_GET_VALUE_FALLBACK,                             true );
+	init( QUICK_GET_VALUES_BATCH_LOCAL,                         true ); if( randomize && BUGGIFY ) QUICK_GET_VALUES_BATCH_LOCAL = false;
 	init( QUICK_GET_KEY_VALUES_FALLBACK,                        true );
 	init( STRICTLY_ENFORCE_BYTE_LIMIT,                          false); if( randomize && BUGGIFY ) STRICTLY_ENFORCE_BYTE_LIMIT = deterministicRandom()->coinflip();
 	init( FRACTION_INDEX_BYTELIMIT_PREFETCH,                      0.2); if( randomize && BUGGIFY ) FRACTION_INDEX_BYTELIMIT_PREFETCH = 0.01 + deterministicRandom()->random01();
@@ -1046,14 +1176,23 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( STORAGESERVER_READ_PRIORITIES,           "120,10,20,40,60" );
 	// The total concurrency which will be shared by active priorities according to their relative weights
 	init( STORAGE_SERVER_READ_CONCURRENCY,                        70 );
+	// Reads queued for longer than this many seconds go ahead of the priority weights, oldest first.  0 disables this.
+	// The weights and this knob are re-read while the storage server runs.
+	init( STORAGE_SERVER_READ_MAX_QUEUE_TIME,                      0 ); if( randomize && BUGGIFY ) STORAGE_SERVER_READ_MAX_QUEUE_TIME = deterministicRandom()->random01();
 	// The priority number which each ReadType maps to in enumeration order
 	// This exists for flexibility but assigning each ReadType to its own unique priority number makes the most sense
 	// The enumeration is currently: eager, fetch, low, normal, high
 	init( STORAGESERVER_READTYPE_PRIORITY_MAP,           "0,1,2,3,4" );
+	// Reads are hashed by tenant, or by shard for reads outside of tenants, into this many lanes which can each hold
+	// at most STORAGE_SERVER_READ_LANE_CONCURRENCY of the read concurrency above, so that one hot shard or tenant cannot
+	// take all of it. 0 disables the lanes.
+	init( STORAGE_SERVER_READ_LANES,                               0 ); if( randomize && BUGGIFY ) STORAGE_SERVER_READ_LANES = deterministicRandom()->randomInt(1, 8);
+	init( STORAGE_SERVER_READ_LANE_CONCURRENCY,                   20 ); if( randomize && BUGGIFY ) STORAGE_SERVER_READ_LANE_CONCURRENCY = deterministicRandom()->randomInt(1, 10);
 	init( SPLIT_METRICS_MAX_ROWS,                              10000 ); if( randomize && BUGGIFY ) SPLIT_METRICS_MAX_ROWS = 10;
 	init( PHYSICAL_SHARD_MOVE_LOG_SEVERITY,                        1 );
 	init( FETCH_SHARD_BUFFER_BYTE_LIMIT,                        20e6 ); if( randomize && BUGGIFY ) FETCH_SHARD_BUFFER_BYTE_LIMIT = 1;
 	init( FETCH_SHARD_UPDATES_BYTE_LIMIT,                    2500000 ); if( randomize && BUGGIFY ) FETCH_SHARD_UPDATES_BYTE_LIMIT = 1;
+	init( STORAGE_SERVER_READ_CACHE_BYTES,                         0 ); if( randomize && BUGGIFY ) STORAGE_SERVER_READ_CACHE_BYTES = deterministicRandom()->randomInt(0, 100000);
 
 	//Wait Failure
 	init( MAX_OUTSTANDING_WAIT_FAILURE_REQUESTS,                 250 ); if( randomize && BUGGIFY ) MAX_OUTSTANDING_WAIT_FAILURE_REQUESTS = 2;
@@ -1086,6 +1225,8 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( STORAGE_DISK_CLEANUP_MAX_RETRIES,                       10 );
 	init( STORAGE_DISK_CLEANUP_RETRY_INTERVAL,  isSimulated ? 2 : 30 );
 	init( WORKER_START_STORAGE_DELAY,                            0.0 ); if ( randomize && BUGGIFY ) WORKER_START_STORAGE_DELAY = 1.0;
+	init( STORAGE_LOCAL_MIGRATION_ENGINE,                         "" );
+	init( STORAGE_LOCAL_MIGRATION_BATCH_BYTES,                   1e7 ); if ( randomize && BUGGIFY ) STORAGE_LOCAL_MIGRATION_BATCH_BYTES = 1e4;
 
 	// Test harness
 	init( WORKER_POLL_DELAY,                                     1.0 );
@@ -1110,6 +1251,7 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	// Status
 	init( STATUS_MIN_TIME_BETWEEN_REQUESTS,                      0.0 );
 	init( MAX_STATUS_REQUESTS_PER_SECOND,                      256.0 );
+	init( STATUS_CACHE_MAX_STALENESS,                            0.0 ); if( randomize && BUGGIFY ) STATUS_CACHE_MAX_STALENESS = deterministicRandom()->random01() * 5.0;
 	init( CONFIGURATION_ROWS_TO_FETCH,                         20000 );
 	init( DISABLE_DUPLICATE_LOG_WARNING,                       false );
 	init( HISTOGRAM_REPORT_INTERVAL,                           300.0 );
@@ -1170,6 +1312,7 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( REDWOOD_DEFAULT_EXTENT_READ_SIZE,              1024 * 1024 );
 	init( REDWOOD_EXTENT_CONCURRENT_READS,                         4 );
 	init( REDWOOD_KVSTORE_RANGE_PREFETCH,                       true );
+	init( REDWOOD_KVSTORE_RANGE_PREFETCH_MAX_PAGES,              256 ); if( randomize && BUGGIFY ) REDWOOD_KVSTORE_RANGE_PREFETCH_MAX_PAGES = deterministicRandom()->randomInt(1, 16);
 	init( REDWOOD_PAGE_REBUILD_MAX_SLACK,                       0.33 );
 	init( REDWOOD_PAGE_REBUILD_SLACK_DISTRIBUTION,              0.50 );
 	init( REDWOOD_LAZY_CLEAR_BATCH_SIZE_PAGES,                    10 );
@@ -1177,18 +1320,32 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( REDWOOD_LAZY_CLEAR_MAX_PAGES,                          1e6 );
 	init( REDWOOD_REMAP_CLEANUP_WINDOW_BYTES, 4LL * 1024 * 1024 * 1024 );
 	init( REDWOOD_REMAP_CLEANUP_TOLERANCE_RATIO,                0.05 );
+	init( REDWOOD_REMAP_CLEANUP_COPY_RATE,                     10000 ); if( randomize && BUGGIFY ) { REDWOOD_REMAP_CLEANUP_COPY_RATE = deterministicRandom()->coinflip() ? 0 : deterministicRandom()->randomInt(100, 2000); }
+	init( REDWOOD_REMAP_CLEANUP_BUSY_RATE_FRACTION,             0.25 ); if( randomize && BUGGIFY ) { REDWOOD_REMAP_CLEANUP_BUSY_RATE_FRACTION = deterministicRandom()->random01() * 0.9 + 0.1; }
+	init( REDWOOD_REMAP_CLEANUP_IO_PRIORITY,                       1 ); if( randomize && BUGGIFY ) { REDWOOD_REMAP_CLEANUP_IO_PRIORITY = deterministicRandom()->randomInt(0, 4); }
 	init( REDWOOD_PAGEFILE_GROWTH_SIZE_PAGES,                  20000 ); if( randomize && BUGGIFY ) { REDWOOD_PAGEFILE_GROWTH_SIZE_PAGES = deterministicRandom()->randomInt(200, 1000); }
 	init( REDWOOD_METRICS_INTERVAL,                              5.0 );
 	init( REDWOOD_HISTOGRAM_INTERVAL,                           30.0 );
 	init( REDWOOD_EVICT_UPDATED_PAGES,                          true ); if( randomize && BUGGIFY ) { REDWOOD_EVICT_UPDATED_PAGES = false; }
+	init( REDWOOD_PAGE_CACHE_PROTECTED_FRACTION,                 0.8 ); if( randomize && BUGGIFY ) { REDWOOD_PAGE_CACHE_PROTECTED_FRACTION = deterministicRandom()->coinflip() ? 0.0 : deterministicRandom()->random01(); }
+	init( REDWOOD_PAGE_CACHE_SCAN_COLD,                         true ); if( randomize && BUGGIFY ) { REDWOOD_PAGE_CACHE_SCAN_COLD = false; }
+	init( REDWOOD_COMMIT_BUILD_THREADS,                            0 ); if( randomize && BUGGIFY ) { REDWOOD_COMMIT_BUILD_THREADS = deterministicRandom()->randomInt(1, 4); }
+	init( REDWOOD_PAGE_CODEC_THREADS,                              0 ); if( randomize && BUGGIFY ) { REDWOOD_PAGE_CODEC_THREADS = deterministicRandom()->randomInt(1, 4); }
+	init( REDWOOD_INTERNAL_PAGE_CACHE_FRACTION,                  0.2 ); if( randomize && BUGGIFY ) { REDWOOD_INTERNAL_PAGE_CACHE_FRACTION = deterministicRandom()->coinflip() ? 0.0 : deterministicRandom()->random01(); }
+	init( REDWOOD_PAGE_COMPRESSION_FILTER,                    "NONE" ); // Not randomized, binaries without compressed node support cannot read them
+	init( REDWOOD_PAGE_COMPRESSION_BLOCKS,                         4 ); if( randomize && BUGGIFY ) { REDWOOD_PAGE_COMPRESSION_BLOCKS = deterministicRandom()->randomInt(1, 8); }
 	init( REDWOOD_DECODECACHE_REUSE_MIN_HEIGHT,                    2 ); if( randomize && BUGGIFY ) { REDWOOD_DECODECACHE_REUSE_MIN_HEIGHT = deterministicRandom()->randomInt(1, 7); }
 	init( REDWOOD_NODE_MAX_UNBALANCE,                              2 );
+	init( REDWOOD_COMPACTION_SCAN_RATE,                            0 ); if( randomize && BUGGIFY ) { REDWOOD_COMPACTION_SCAN_RATE = deterministicRandom()->randomInt(10, 1000); }
+	init( REDWOOD_COMPACTION_MIN_DELETED_FRACTION,              0.25 ); if( randomize && BUGGIFY ) { REDWOOD_COMPACTION_MIN_DELETED_FRACTION = deterministicRandom()->random01(); }
+	init( REDWOOD_COMPACTION_MIN_PASS_INTERVAL,                 60.0 ); if( randomize && BUGGIFY ) { REDWOOD_COMPACTION_MIN_PASS_INTERVAL = deterministicRandom()->random01() * 10; }
 	init( REDWOOD_IO_PRIORITIES,                       "32,32,32,32" );
 
 	// Server request latency measurement
 	init( LATENCY_SKETCH_ACCURACY,                              0.01 );
 	init( FILE_LATENCY_SKETCH_ACCURACY,                         0.01 );
 	init( LATENCY_METRICS_LOGGING_INTERVAL,                     60.0 );
+	init( STORAGE_READ_PHASE_SAMPLE_RATE,                       0.01 ); if( randomize && BUGGIFY ) STORAGE_READ_PHASE_SAMPLE_RATE = 1.0;
 
 	// Cluster recovery
 	init ( CLUSTER_RECOVERY_EVENT_NAME_PREFIX,              "Master" );
@@ -1229,6 +1386,9 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( BG_RDC_BYTES_FACTOR,                                     2 ); if (randomize && BUGGIFY) BG_RDC_BYTES_FACTOR = deterministicRandom()->randomInt(1, 10);
 	init( BG_RDC_READ_FACTOR,                                      3 ); if (randomize && BUGGIFY) BG_RDC_READ_FACTOR = deterministicRandom()->randomInt(1, 10);
 	init( BG_WRITE_MULTIPART,                                  false ); if (randomize && BUGGIFY) BG_WRITE_MULTIPART = true;
+	init( BG_FILE_CACHE_BYTES,                                     0 ); if (randomize && BUGGIFY) BG_FILE_CACHE_BYTES = deterministicRandom()->randomInt(1, 100) * 1e6;
+	init( BG_FILE_CACHE_PREFETCH_DELTAS,                        true ); if (randomize && BUGGIFY) BG_FILE_CACHE_PREFETCH_DELTAS = false;
+	init( BG_RESNAPSHOT_REUSE_CHUNKS,                           true ); if (randomize && BUGGIFY) BG_RESNAPSHOT_REUSE_CHUNKS = false;
 	init( BG_ENABLE_DYNAMIC_WRITE_AMP,                          true ); if (randomize && BUGGIFY) BG_ENABLE_DYNAMIC_WRITE_AMP = false;
 	init( BG_DYNAMIC_WRITE_AMP_MIN_FACTOR,                       0.5 );
 	init( BG_DYNAMIC_WRITE_AMP_DECREASE_FACTOR,                  0.8 );
@@ -1267,6 +1427,9 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( BLOB_MANAGER_MEDIAN_ASSIGNMENT_ALLOWANCE,              2.0 ); if( randomize && BUGGIFY ) BLOB_MANAGER_MEDIAN_ASSIGNMENT_ALLOWANCE = (1.0 + deterministicRandom()->random01() * 2);
 	init( BLOB_MANAGER_MEDIAN_ASSIGNMENT_MIN_SAMPLES_PER_WORKER,   3 );
 	init( BLOB_MANAGER_MEDIAN_ASSIGNMENT_MAX_SAMPLES_PER_WORKER,  10 );
+	init( BLOB_MANAGER_CONCURRENT_ASSIGNMENTS,                 10000 ); if( randomize && BUGGIFY ) BLOB_MANAGER_CONCURRENT_ASSIGNMENTS = deterministicRandom()->randomInt(5, 50);
+	init( BLOB_MANAGER_MAPPING_WRITE_BATCH,                     1000 ); if( randomize && BUGGIFY ) BLOB_MANAGER_MAPPING_WRITE_BATCH = deterministicRandom()->randomInt(2, 5);
+	init( BLOB_MANAGER_RECOVERY_SCAN_PARALLELISM,                  8 ); if( randomize && BUGGIFY ) BLOB_MANAGER_RECOVERY_SCAN_PARALLELISM = deterministicRandom()->randomInt(1, 5);
 	init( BLOB_MANIFEST_BACKUP,                                false );
 	init( BLOB_MANIFEST_BACKUP_INTERVAL,  isSimulated ?  5.0 : 600.0 );
 	init( BLOB_MIGRATOR_CHECK_INTERVAL,    isSimulated ?  1.0 : 60.0 );
@@ -1319,6 +1482,9 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( REST_KMS_STABILITY_CHECK_INTERVAL,                      5.0);
 
 	init( CONSISTENCY_SCAN_ACTIVE_THROTTLE_RATIO,                0.5 ); if( randomize && BUGGIFY ) CONSISTENCY_SCAN_ACTIVE_THROTTLE_RATIO = deterministicRandom()->random01();
+	init( CONSISTENCY_SCAN_COMPARE_DIGESTS,                     true ); if( randomize && BUGGIFY ) CONSISTENCY_SCAN_COMPARE_DIGESTS = false;
+	init( CONSISTENCY_SCAN_TARGET_READ_LATENCY,                  0.05 ); if( randomize && BUGGIFY ) CONSISTENCY_SCAN_TARGET_READ_LATENCY = 0.001;
+	init( CONSISTENCY_SCAN_MIN_RATE_FRACTION,                    0.05 );
 
 
 	init( FLOW_WITH_SWIFT,                                       false);
@@ -1329,6 +1495,9 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	// Drop in-memory state associated with an idempotency id after this many seconds. Once dropped, this id cannot be
 	// expired proactively, but will eventually get cleaned up by the idempotency id cleaner.
 	init( IDEMPOTENCY_ID_IN_MEMORY_LIFETIME,                       10);
+	// Write the idempotency ids of a commit batch without a length per id when they all have the same length. Clients
+	// older than this encoding cannot read it.
+	init( IDEMPOTENCY_ID_COMPACT_ENCODING,                      false );
 	// Attempt to clean old idempotency ids automatically this often
  	init( IDEMPOTENCY_IDS_CLEANER_POLLING_INTERVAL,                10);
 	// Don't clean idempotency ids younger than this
@@ -265,6 +265,47 @@ ACTOR Future<Void> normalizeKeySelectorActor(SpecialKeySpace* sks,
 	return Void();
 }
 
+ACTOR Future<RangeResult> readAsyncModule(const SpecialKeyRangeReadImpl* impl,
+                                          ReadYourWritesTransaction* ryw,
+                                          GetRangeLimits limits) {
+	// A write to the transaction may change what a module reads, and always changes the approximate size
+	state int64_t size = ryw->getApproximateSize();
+	auto& readCache = ryw->getSpecialKeySpaceReadCache();
+	auto cached = readCache.find(impl);
+	if (cached != readCache.end() && cached->second.first == size) {
+		CODE_PROBE(true, "Special key space module read from the transaction's cache");
+		return cached->second.second;
+	}
+
+	state RangeResult result;
+	if (impl->cacheAcrossTransactions() && CLIENT_KNOBS->SPECIAL_KEY_SPACE_MODULE_CACHE_SECONDS > 0) {
+		RangeResult shared = wait(ryw->getDatabase()->specialKeySpace->getSharedModuleRange(impl, ryw, limits));
+		result = shared;
+	} else {
+		RangeResult read = wait(impl->getRange(ryw, impl->getKeyRange(), limits));
+		result = read;
+	}
+	// The transaction is only written to synchronously, so it has not been while the module was read
+	if (ryw->getApproximateSize() == size) {
+		ryw->getSpecialKeySpaceReadCache()[impl] = std::make_pair(size, result);
+	}
+	return result;
+}
+
+Future<RangeResult> SpecialKeySpace::getSharedModuleRange(const SpecialKeyRangeReadImpl* impl,
+                                                          ReadYourWritesTransaction* ryw,
+                                                          GetRangeLimits limits) {
+	auto& [started, result] = sharedModuleResults[impl];
+	if (!result.isValid() || result.isError() ||
+	    now() - started > CLIENT_KNOBS->SPECIAL_KEY_SPACE_MODULE_CACHE_SECONDS) {
+		started = now();
+		result = impl->getRange(ryw, impl->getKeyRange(), limits);
+	} else {
+		CODE_PROBE(true, "Special key space module read shared across transactions");
+	}
+	return result;
+}
+
 SpecialKeySpace::SpecialKeySpace(KeyRef spaceStartKey, KeyRef spaceEndKey, bool testOnly)
   : readImpls(nullptr, spaceEndKey),
     modules(testOnly ? SpecialKeySpace::MODULE::TESTONLY : SpecialKeySpace::MODULE::UNKNOWN, spaceEndKey),
@@ -734,12 +775,51 @@ Future<RangeResult> ConflictingKeysImpl::getRange(ReadYourWritesTransaction* ryw
 	return result;
 }
 
-ACTOR Future<RangeResult> ddMetricsGetRangeActor(ReadYourWritesTransaction* ryw, KeyRangeRef kr) {
+TransactionTimelineImpl::TransactionTimelineImpl(KeyRangeRef kr) : SpecialKeyRangeReadImpl(kr) {}
+
+Future<RangeResult> TransactionTimelineImpl::getRange(ReadYourWritesTransaction* ryw,
+                                                      KeyRangeRef kr,
+                                                      GetRangeLimits limitsHint) const {
+	RangeResult result;
+	Reference<TransactionTimeline> timeline = ryw->getTransactionState()->timeline;
+	if (!timeline) {
+		return result;
+	}
+	// One key per event, in the order they were recorded, and a last key for the events that were not kept
+	const int eventCount = timeline->events.size();
+	for (int i = 0; i <= eventCount; ++i) {
+		json_spirit::mObject eventObj;
+		if (i < eventCount) {
+			const TransactionTimeline::Event& event = timeline->events[i];
+			eventObj["name"] = event.name;
+			eventObj["start"] = event.start;
+			eventObj["duration"] = event.duration;
+			if (!event.detail.empty()) {
+				eventObj["detail"] = event.detail;
+			}
+		} else if (timeline->droppedEvents) {
+			eventObj["name"] = "dropped_events";
+			eventObj["count"] = timeline->droppedEvents;
+		} else {
+			break;
+		}
+		Key key = transactionTimelineRange.begin.withSuffix(format("%08d", i));
+		if (!kr.contains(key)) {
+			continue;
+		}
+		std::string eventString =
+		    json_spirit::write_string(json_spirit::mValue(eventObj), json_spirit::Output_options::raw_utf8);
+		result.push_back_deep(result.arena(), KeyValueRef(key, eventString));
+	}
+	return result;
+}
+
+ACTOR Future<RangeResult> ddMetricsGetRangeActor(Database cx, KeyRangeRef kr) {
 	loop {
 		try {
 			auto keys = kr.removePrefix(ddStatsRange.begin);
 			Standalone<VectorRef<DDMetricsRef>> resultWithoutPrefix =
-			    wait(waitDataDistributionMetricsList(ryw->getDatabase(), keys, CLIENT_KNOBS->TOO_MANY));
+			    wait(waitDataDistributionMetricsList(cx, keys, CLIENT_KNOBS->TOO_MANY));
 			RangeResult result;
 			for (const auto& ddMetricsRef : resultWithoutPrefix) {
 				// each begin key is the previous end key, thus we only encode the begin key in the result
@@ -772,7 +852,7 @@ DDStatsRangeImpl::DDStatsRangeImpl(KeyRangeRef kr) : SpecialKeyRangeAsyncImpl(kr
 Future<RangeResult> DDStatsRangeImpl::getRange(ReadYourWritesTransaction* ryw,
                                                KeyRangeRef kr,
                                                GetRangeLimits limitsHint) const {
-	return ddMetricsGetRangeActor(ryw, kr);
+	return ddMetricsGetRangeActor(ryw->getDatabase(), kr);
 }
 
 Key SpecialKeySpace::getManagementApiCommandOptionSpecialKey(const std::string& command, const std::string& option) {
@@ -21,6 +21,7 @@
 // TODO this should really be renamed "TSSComparison.cpp"
 #include "fdbclient/StorageServerInterface.h"
 #include "fdbclient/BlobWorkerInterface.h"
+#include "fdbclient/Knobs.h"
 #include "crc32/crc32c.h" // for crc32c_append, to checksum values in tss trace events
 
 // Includes template specializations for all tss operations on storage server types.
@@ -55,6 +56,30 @@ void TSS_traceMismatch(TraceEvent& event,
 	    .detail("TSSReply", tss.value.present() ? traceChecksumValue(tss.value.get()) : "missing");
 }
 
+// batched point reads
+template <>
+bool TSS_doCompare(const GetValuesReply& src, const GetValuesReply& tss) {
+	return src.data == tss.data;
+}
+
+template <>
+const char* LB_mismatchTraceName(const GetValuesRequest& req, const ComparisonType& type) {
+	return type == TSS_COMPARISON ? "TSSMismatchGetValues" : "ReplicaMismatchGetValues";
+}
+
+template <>
+void TSS_traceMismatch(TraceEvent& event,
+                       const GetValuesRequest& req,
+                       const GetValuesReply& src,
+                       const GetValuesReply& tss) {
+	event.detail("Keys", req.keys.size())
+	    .detail("FirstKey", req.keys.empty() ? KeyRef() : req.keys.front())
+	    .detail("Tenant", req.tenantInfo.tenantId)
+	    .detail("Version", req.version)
+	    .detail("SSReplySize", src.data.size())
+	    .detail("TSSReplySize", tss.data.size());
+}
+
 // key selector reads
 template <>
 bool TSS_doCompare(const GetKeyReply& src, const GetKeyReply& tss) {
@@ -427,6 +452,12 @@ void TSSMetrics::recordLatency(const GetValueRequest& req, double ssLatency, dou
 	TSSgetValueLatency.addSample(tssLatency);
 }
 
+template <>
+void TSSMetrics::recordLatency(const GetValuesRequest& req, double ssLatency, double tssLatency) {
+	SSgetValueLatency.addSample(ssLatency);
+	TSSgetValueLatency.addSample(tssLatency);
+}
+
 template <>
 void TSSMetrics::recordLatency(const GetKeyRequest& req, double ssLatency, double tssLatency) {
 	SSgetKeyLatency.addSample(ssLatency);
@@ -470,6 +501,73 @@ void TSSMetrics::recordLatency(const OverlappingChangeFeedsRequest& req, double
 template <>
 void TSSMetrics::recordLatency(const BlobGranuleFileRequest& req, double ssLatency, double tssLatency) {}
 
+// sample rates
+
+template <>
+double TSS_sampleRate(const GetValueRequest& req) {
+	return CLIENT_KNOBS->TSS_SAMPLE_RATE_GET_VALUE;
+}
+
+template <>
+double TSS_sampleRate(const GetValuesRequest& req) {
+	return CLIENT_KNOBS->TSS_SAMPLE_RATE_GET_VALUE;
+}
+
+template <>
+double TSS_sampleRate(const GetKeyRequest& req) {
+	return CLIENT_KNOBS->TSS_SAMPLE_RATE_GET_KEY;
+}
+
+template <>
+double TSS_sampleRate(const GetKeyValuesRequest& req) {
+	return CLIENT_KNOBS->TSS_SAMPLE_RATE_GET_KEY_VALUES;
+}
+
+template <>
+double TSS_sampleRate(const GetMappedKeyValuesRequest& req) {
+	return CLIENT_KNOBS->TSS_SAMPLE_RATE_GET_MAPPED_KEY_VALUES;
+}
+
+template <>
+double TSS_sampleRate(const WatchValueRequest& req) {
+	return CLIENT_KNOBS->TSS_SAMPLE_RATE_OTHER;
+}
+
+template <>
+double TSS_sampleRate(const WaitMetricsRequest& req) {
+	return CLIENT_KNOBS->TSS_SAMPLE_RATE_OTHER;
+}
+
+template <>
+double TSS_sampleRate(const SplitMetricsRequest& req) {
+	return CLIENT_KNOBS->TSS_SAMPLE_RATE_OTHER;
+}
+
+template <>
+double TSS_sampleRate(const ReadHotSubRangeRequest& req) {
+	return CLIENT_KNOBS->TSS_SAMPLE_RATE_OTHER;
+}
+
+template <>
+double TSS_sampleRate(const SplitRangeRequest& req) {
+	return CLIENT_KNOBS->TSS_SAMPLE_RATE_OTHER;
+}
+
+template <>
+double TSS_sampleRate(const GetKeyValuesStreamRequest& req) {
+	return CLIENT_KNOBS->TSS_SAMPLE_RATE_GET_KEY_VALUES;
+}
+
+template <>
+double TSS_sampleRate(const OverlappingChangeFeedsRequest& req) {
+	return CLIENT_KNOBS->TSS_SAMPLE_RATE_OTHER;
+}
+
+template <>
+double TSS_sampleRate(const BlobGranuleFileRequest& req) {
+	return CLIENT_KNOBS->TSS_SAMPLE_RATE_OTHER;
+}
+
 // -------------------
 
 TEST_CASE("/StorageServerInterface/TSSCompare/TestComparison") {
@@ -303,6 +303,9 @@ const KeyRangeRef readConflictRangeKeysRange =
 const KeyRangeRef writeConflictRangeKeysRange = KeyRangeRef("\xff\xff/transaction/write_conflict_range/"_sr,
                                                             "\xff\xff/transaction/write_conflict_range/\xff\xff"_sr);
 
+const KeyRangeRef transactionTimelineRange =
+    KeyRangeRef("\xff\xff/transaction/timeline/"_sr, "\xff\xff/transaction/timeline/\xff\xff"_sr);
+
 const KeyRef accumulativeChecksumKey = "\xff\xff/accumulativeChecksum"_sr;
 
 const Value accumulativeChecksumValue(const AccumulativeChecksumState& acsState) {
@@ -223,13 +223,18 @@ private:
 };
 
 #ifndef WIN32
-ACTOR Future<Void> fastTraceLogger(int* unreadyMessages, int* failedMessages, int* totalMessages, bool* sendError) {
+ACTOR Future<Void> fastTraceLogger(int* unreadyMessages,
+                                   int* failedMessages,
+                                   int* droppedMessages,
+                                   int* totalMessages,
+                                   bool* sendError) {
 	state bool sendErrorReset = false;
 
 	loop {
 		TraceEvent("TracingSpanStats")
 		    .detail("UnreadyMessages", *unreadyMessages)
 		    .detail("FailedMessages", *failedMessages)
+		    .detail("DroppedMessages", *droppedMessages)
 		    .detail("TotalMessages", *totalMessages)
 		    .detail("SendError", *sendError);
 
@@ -246,7 +251,8 @@ ACTOR Future<Void> fastTraceLogger(int* unreadyMessages, int* failedMessages, in
 
 struct FastUDPTracer : public UDPTracer {
 	FastUDPTracer()
-	  : unready_socket_messages_(0), failed_messages_(0), total_messages_(0), socket_fd_(-1), send_error_(false) {
+	  : unready_socket_messages_(0), failed_messages_(0), dropped_messages_(0), total_messages_(0), socket_fd_(-1),
+	    send_error_(false), window_start_(0.0), window_messages_(0) {
 		request_ = MsgpackBuffer{ .buffer = std::make_unique<uint8_t[]>(kTraceBufferSize),
 			                      .data_size = 0,
 			                      .buffer_size = kTraceBufferSize };
@@ -257,7 +263,8 @@ struct FastUDPTracer : public UDPTracer {
 	void prepare(int size) {
 		static std::once_flag once;
 		std::call_once(once, [&]() {
-			log_actor_ = fastTraceLogger(&unready_socket_messages_, &failed_messages_, &total_messages_, &send_error_);
+			log_actor_ = fastTraceLogger(
+			    &unready_socket_messages_, &failed_messages_, &dropped_messages_, &total_messages_, &send_error_);
 			std::string destAddr = FLOW_KNOBS->TRACING_UDP_LISTENER_ADDR;
 			if (g_network->isSimulated()) {
 				udp_server_actor_ = simulationStartServer();
@@ -298,8 +305,28 @@ struct FastUDPTracer : public UDPTracer {
 		request_.reset();
 	}
 
+	// Bounds the CPU spent exporting spans to TRACING_MAX_SPANS_PER_SECOND, dropping the rest
+	bool admit() {
+		if (FLOW_KNOBS->TRACING_MAX_SPANS_PER_SECOND <= 0) {
+			return true;
+		}
+		double now = g_network->timer();
+		if (now - window_start_ >= 1.0) {
+			window_start_ = now;
+			window_messages_ = 0;
+		}
+		if (++window_messages_ > FLOW_KNOBS->TRACING_MAX_SPANS_PER_SECOND) {
+			++dropped_messages_;
+			return false;
+		}
+		return true;
+	}
+
 	void trace(Span const& span) override {
 		prepare(span.location.name.size());
+		if (socket_fd_ == -1 || send_error_ || !admit()) {
+			return;
+		}
 		serialize_span(span, request_);
 		write();
 	}
@@ -309,11 +336,15 @@ private:
 
 	int unready_socket_messages_;
 	int failed_messages_;
+	int dropped_messages_;
 	int total_messages_;
 
 	int socket_fd_;
 	bool send_error_;
 
+	double window_start_;
+	int window_messages_;
+
 	Future<Reference<IUDPSocket>> socket_;
 	Future<Void> log_actor_;
 	Future<Void> udp_server_actor_;
@@ -351,11 +382,34 @@ void openTracer(TracerType type) {
 
 ITracer::~ITracer() {}
 
-Span& Span::operator=(Span&& o) {
-	if (begin > 0.0 && context.isSampled()) {
-		end = g_network->now();
-		g_tracer->trace(*this);
+bool isTraceSampled(UID traceID, double sampleRate) {
+	// the top 53 bits of the trace ID as a uniformly distributed double in [0, 1)
+	return (traceID.first() >> 11) * 0x1.0p-53 < sampleRate;
+}
+
+bool isSlowSpan(const SpanContext& context, double duration) {
+	return FLOW_KNOBS->TRACING_SLOW_SPAN_THRESHOLD > 0.0 && context.isValid() &&
+	       duration >= FLOW_KNOBS->TRACING_SLOW_SPAN_THRESHOLD;
+}
+
+// Traces a span which has ended if its trace is sampled, or if it was slow
+static void finishSpan(Span& span) {
+	if (span.begin <= 0.0) {
+		return;
+	}
+	double end = g_network->now();
+	if (!span.context.isSampled()) {
+		if (!isSlowSpan(span.context, end - span.begin)) {
+			return;
+		}
+		span.addAttribute("sampling"_sr, "slow"_sr);
 	}
+	span.end = end;
+	g_tracer->trace(span);
+}
+
+Span& Span::operator=(Span&& o) {
+	finishSpan(*this);
 	arena = std::move(o.arena);
 	// All memory referenced in *Ref fields of Span is now (potentially)
 	// invalid, and o no longer has ownership of any memory referenced by *Ref
@@ -380,10 +434,7 @@ Span& Span::operator=(Span&& o) {
 }
 
 Span::~Span() {
-	if (begin > 0.0 && context.isSampled()) {
-		end = g_network->now();
-		g_tracer->trace(*this);
-	}
+	finishSpan(*this);
 }
 
 TEST_CASE("/flow/Tracing/CreateOTELSpan") {
@@ -406,6 +457,25 @@ TEST_CASE("/flow/Tracing/CreateOTELSpan") {
 	return Void();
 };
 
+TEST_CASE("/flow/Tracing/HeadSampling") {
+	ASSERT(!isTraceSampled(UID(0, 1), 0.0));
+	ASSERT(isTraceSampled(UID(0, 1), 0.01));
+	ASSERT(isTraceSampled(UID(std::numeric_limits<uint64_t>::max(), 1), 1.0));
+	ASSERT(!isTraceSampled(UID(std::numeric_limits<uint64_t>::max(), 1), 0.99));
+
+	// The same trace is always sampled the same way, and roughly sampleRate of traces are sampled
+	int sampled = 0;
+	for (int i = 0; i < 10000; i++) {
+		UID traceID = deterministicRandom()->randomUniqueID();
+		bool isSampled = isTraceSampled(traceID, 0.25);
+		ASSERT(isSampled == isTraceSampled(traceID, 0.25));
+		sampled += isSampled;
+	}
+	ASSERT(sampled > 2000 && sampled < 3000);
+
+	return Void();
+};
+
 TEST_CASE("/flow/Tracing/AddEvents") {
 	// Use helper method to add an OTELEventRef to an OTELSpan.
 	Span span1("span_with_event"_loc);
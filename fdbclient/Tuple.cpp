@@ -38,10 +38,20 @@ static double bigEndianDouble(double orig) {
 	return *(double*)&big;
 }
 
+// Finds the null that ends an encoded string, skipping escaped nulls (\x00\xff). memchr() compares many bytes per
+// instruction, so long strings are scanned much faster than byte by byte.
 static size_t findStringTerminator(const StringRef data, size_t offset) {
 	size_t i = offset;
-	while (i < data.size() - 1 && !(data[i] == '\x00' && data[i + 1] != (uint8_t)'\xff')) {
-		i += (data[i] == '\x00' ? 2 : 1);
+	while (i < data.size() - 1) {
+		const uint8_t* zero = (const uint8_t*)memchr(data.begin() + i, '\x00', data.size() - 1 - i);
+		if (zero == nullptr) {
+			return data.size() - 1;
+		}
+		i = zero - data.begin();
+		if (data[i + 1] != (uint8_t)'\xff') {
+			return i;
+		}
+		i += 2;
 	}
 
 	return i;
@@ -61,33 +71,243 @@ static void adjustFloatingPoint(uint8_t* bytes, size_t size, bool encode) {
 	}
 }
 
+static bool isUserTypeCode(uint8_t code) {
+	return code >= USER_TYPE_START && code <= USER_TYPE_END;
+}
+
+// Returns the offset just past the element that starts at offset i. For a truncated numeric element this is beyond
+// the end of data.
+static size_t elementEnd(StringRef data, size_t i, bool include_user_type) {
+	uint8_t code = data[i];
+	if (code == '\x01' || code == '\x02') {
+		return findStringTerminator(data, i + 1) + 1;
+	} else if (code >= '\x0c' && code <= '\x1c') {
+		return i + abs(code - '\x14') + 1;
+	} else if (code == 0x20) {
+		return i + sizeof(float) + 1;
+	} else if (code == 0x21) {
+		return i + sizeof(double) + 1;
+	} else if (code == 0x26 || code == 0x27) {
+		return i + 1;
+	} else if (code == '\x00') {
+		return i + 1;
+	} else if (code == VERSIONSTAMP_96_CODE) {
+		return i + VERSIONSTAMP_TUPLE_SIZE + 1;
+	} else if (include_user_type && isUserTypeCode(code)) {
+		// User defined codes must come at the end of a Tuple and are not delimited.
+		return data.size();
+	} else {
+		throw invalid_tuple_data_type();
+	}
+}
+
+static Tuple::ElementType elementType(uint8_t code) {
+	if (code == '\x00') {
+		return Tuple::NULL_TYPE;
+	} else if (code == '\x01') {
+		return Tuple::BYTES;
+	} else if (code == '\x02') {
+		return Tuple::UTF8;
+	} else if (code >= '\x0c' && code <= '\x1c') {
+		return Tuple::INT;
+	} else if (code == 0x20) {
+		return Tuple::FLOAT;
+	} else if (code == 0x21) {
+		return Tuple::DOUBLE;
+	} else if (code == 0x26 || code == 0x27) {
+		return Tuple::BOOL;
+	} else if (code == VERSIONSTAMP_96_CODE) {
+		return Tuple::VERSIONSTAMP;
+	} else if (isUserTypeCode(code)) {
+		return Tuple::USER_TYPE;
+	} else {
+		throw invalid_tuple_data_type();
+	}
+}
+
+// Decodes the bytes of a string element between its type code and the end of the element. Each null followed by
+// another byte is an escaped null, and a final null is the terminator. A string without escaped nulls is returned in
+// place unless copy is set, so only escaped strings are rebuilt in arena.
+static StringRef decodeString(StringRef encoded, Arena& arena, bool copy) {
+	const uint8_t* b = encoded.begin();
+	const uint8_t* e = encoded.end();
+	const uint8_t* zero = encoded.size() ? (const uint8_t*)memchr(b, '\x00', e - b) : nullptr;
+	if (zero == nullptr || zero == e - 1) {
+		StringRef unescaped(b, (zero == nullptr ? e : zero) - b);
+		return copy ? StringRef(arena, unescaped) : unescaped;
+	}
+
+	uint8_t* result = new (arena) uint8_t[e - b];
+	uint8_t* out = result;
+	while (zero != nullptr) {
+		memcpy(out, b, zero - b);
+		out += zero - b;
+		if (zero + 1 < e) {
+			*out++ = '\x00';
+		}
+		b = zero + 2;
+		zero = b < e ? (const uint8_t*)memchr(b, '\x00', e - b) : nullptr;
+	}
+	if (b < e) {
+		memcpy(out, b, e - b);
+		out += e - b;
+	}
+	return StringRef(result, out - result);
+}
+
+// element points at the type code of an integer, and available is the number of bytes from there to the end of the
+// packed tuple.
+static int64_t decodeInt(const uint8_t* element, size_t available, bool allow_incomplete) {
+	int64_t swap;
+	bool neg = false;
+
+	uint8_t code = element[0];
+	if (code < '\x0c' || code > '\x1c') {
+		throw invalid_tuple_data_type();
+	}
+
+	int8_t len = code - '\x14';
+
+	if (len < 0) {
+		len = -len;
+		neg = true;
+	}
+
+	memset(&swap, neg ? '\xff' : 0, 8 - len);
+	// presentLen is how many of len bytes are actually present, it will be < len if the encoded tuple was truncated
+	int presentLen = std::min<int8_t>(len, available - 1);
+	ASSERT(len == presentLen || allow_incomplete);
+	memcpy(((uint8_t*)&swap) + 8 - len, element + 1, presentLen);
+	if (presentLen < len) {
+		int suffix = len - presentLen;
+		if (presentLen == 0) {
+			// The first byte in an int would always be at least 1, because if was 0 then a shorter int type would have
+			// been used. So if we don't have the first (most significant) byte in the encoded string, use 1 so that the
+			// decoded result maintains the encoded form's sort order with an encoded value of a shorter and same-signed
+			// type.
+			*(((uint8_t*)&swap) + 8 - len) = 1;
+			--suffix; // The suffix to clear below is now 1 byte shorter.
+		}
+		memset(((uint8_t*)&swap) + 8 - suffix, 0, suffix);
+	}
+
+	swap = bigEndian64(swap);
+
+	if (neg) {
+		swap = -(~swap);
+	}
+
+	return swap;
+}
+
+static bool decodeBool(uint8_t code) {
+	if (code == 0x26) {
+		return false;
+	} else if (code == 0x27) {
+		return true;
+	} else {
+		throw invalid_tuple_data_type();
+	}
+}
+
+static float decodeFloat(const uint8_t* element, size_t available) {
+	if (element[0] != 0x20) {
+		throw invalid_tuple_data_type();
+	}
+
+	float swap;
+	uint8_t* bytes = (uint8_t*)&swap;
+	ASSERT_LE(1 + sizeof(float), available);
+	memcpy(bytes, element + 1, sizeof(float));
+	adjustFloatingPoint(bytes, sizeof(float), false);
+
+	return bigEndianFloat(swap);
+}
+
+static double decodeDouble(const uint8_t* element, size_t available) {
+	if (element[0] != 0x21) {
+		throw invalid_tuple_data_type();
+	}
+
+	double swap;
+	uint8_t* bytes = (uint8_t*)&swap;
+	ASSERT_LE(1 + sizeof(double), available);
+	memcpy(bytes, element + 1, sizeof(double));
+	adjustFloatingPoint(bytes, sizeof(double), false);
+
+	return bigEndianDouble(swap);
+}
+
+// Escapes each null in str as \x00\xff. The unescaped runs between nulls are found with memchr() and copied whole.
+static void encodeString(VectorRef<uint8_t>& out, Arena& arena, StringRef const& str, bool utf8) {
+	out.reserve(arena, out.size() + str.size() + 2);
+	out.push_back(arena, uint8_t(utf8 ? '\x02' : '\x01'));
+
+	const uint8_t* b = str.begin();
+	const uint8_t* e = str.end();
+	const uint8_t* zero;
+	while (b < e && (zero = (const uint8_t*)memchr(b, '\x00', e - b)) != nullptr) {
+		out.append(arena, b, zero - b + 1);
+		out.push_back(arena, (uint8_t)'\xff');
+		b = zero + 1;
+	}
+
+	out.append(arena, b, e - b);
+	out.push_back(arena, (uint8_t)'\x00');
+}
+
+static void encodeInt(VectorRef<uint8_t>& out, Arena& arena, int64_t value) {
+	uint64_t swap = value;
+	bool neg = false;
+
+	if (value < 0) {
+		value = ~(-value);
+		neg = true;
+	}
+
+	swap = bigEndian64(value);
+
+	for (int i = 0; i < 8; i++) {
+		if (((uint8_t*)&swap)[i] != (neg ? 255 : 0)) {
+			out.push_back(arena, (uint8_t)(20 + (8 - i) * (neg ? -1 : 1)));
+			out.append(arena, ((const uint8_t*)&swap) + i, 8 - i);
+			return;
+		}
+	}
+
+	out.push_back(arena, (uint8_t)'\x14');
+}
+
+static void encodeFloat(VectorRef<uint8_t>& out, Arena& arena, float value) {
+	float swap = bigEndianFloat(value);
+	uint8_t* bytes = (uint8_t*)&swap;
+	adjustFloatingPoint(bytes, sizeof(float), true);
+
+	out.push_back(arena, 0x20);
+	out.append(arena, bytes, sizeof(float));
+}
+
+static void encodeDouble(VectorRef<uint8_t>& out, Arena& arena, double value) {
+	double swap = bigEndianDouble(value);
+	uint8_t* bytes = (uint8_t*)&swap;
+	adjustFloatingPoint(bytes, sizeof(double), true);
+
+	out.push_back(arena, 0x21);
+	out.append(arena, bytes, sizeof(double));
+}
+
+static void encodeVersionstamp(VectorRef<uint8_t>& out, Arena& arena, TupleVersionstamp const& vs) {
+	out.push_back(arena, VERSIONSTAMP_96_CODE);
+	out.append(arena, vs.begin(), vs.size());
+}
+
 Tuple::Tuple(StringRef const& str, bool exclude_incomplete, bool include_user_type) {
 	data.append(data.arena(), str.begin(), str.size());
 
 	size_t i = 0;
 	while (i < data.size()) {
 		offsets.push_back(i);
-
-		if (data[i] == '\x01' || data[i] == '\x02') {
-			i = findStringTerminator(str, i + 1) + 1;
-		} else if (data[i] >= '\x0c' && data[i] <= '\x1c') {
-			i += abs(data[i] - '\x14') + 1;
-		} else if (data[i] == 0x20) {
-			i += sizeof(float) + 1;
-		} else if (data[i] == 0x21) {
-			i += sizeof(double) + 1;
-		} else if (data[i] == 0x26 || data[i] == 0x27) {
-			i += 1;
-		} else if (data[i] == '\x00') {
-			i += 1;
-		} else if (data[i] == VERSIONSTAMP_96_CODE) {
-			i += VERSIONSTAMP_TUPLE_SIZE + 1;
-		} else if (include_user_type && isUserType(data[i])) {
-			// User defined codes must come at the end of a Tuple and are not delimited.
-			i = data.size();
-		} else {
-			throw invalid_tuple_data_type();
-		}
+		i = elementEnd(str, i, include_user_type);
 	}
 	// If incomplete tuples are allowed, remove the last offset if i is now beyond size()
 	// Strings will never be considered incomplete due to the way the string end is found.
@@ -146,7 +366,7 @@ Tuple Tuple::unpackUserType(StringRef const& str, bool exclude_incomplete) {
 }
 
 bool Tuple::isUserType(uint8_t code) const {
-	return code >= USER_TYPE_START && code <= USER_TYPE_END;
+	return isUserTypeCode(code);
 }
 
 Tuple& Tuple::append(Tuple const& tuple) {
@@ -161,32 +381,13 @@ Tuple& Tuple::append(Tuple const& tuple) {
 
 Tuple& Tuple::append(TupleVersionstamp const& vs) {
 	offsets.push_back(data.size());
-
-	data.push_back(data.arena(), VERSIONSTAMP_96_CODE);
-	data.append(data.arena(), vs.begin(), vs.size());
-
+	encodeVersionstamp(data, data.arena(), vs);
 	return *this;
 }
 
 Tuple& Tuple::append(StringRef const& str, bool utf8) {
 	offsets.push_back(data.size());
-
-	const uint8_t utfChar = uint8_t(utf8 ? '\x02' : '\x01');
-	data.append(data.arena(), &utfChar, 1);
-
-	size_t lastPos = 0;
-	for (size_t pos = 0; pos < str.size(); ++pos) {
-		if (str[pos] == '\x00') {
-			data.append(data.arena(), str.begin() + lastPos, pos - lastPos);
-			data.push_back(data.arena(), (uint8_t)'\x00');
-			data.push_back(data.arena(), (uint8_t)'\xff');
-			lastPos = pos + 1;
-		}
-	}
-
-	data.append(data.arena(), str.begin() + lastPos, str.size() - lastPos);
-	data.push_back(data.arena(), (uint8_t)'\x00');
-
+	encodeString(data, data.arena(), str, utf8);
 	return *this;
 }
 
@@ -202,27 +403,8 @@ Tuple& Tuple::appendRaw(StringRef const& str) {
 }
 
 Tuple& Tuple::append(int64_t value) {
-	uint64_t swap = value;
-	bool neg = false;
-
 	offsets.push_back(data.size());
-
-	if (value < 0) {
-		value = ~(-value);
-		neg = true;
-	}
-
-	swap = bigEndian64(value);
-
-	for (int i = 0; i < 8; i++) {
-		if (((uint8_t*)&swap)[i] != (neg ? 255 : 0)) {
-			data.push_back(data.arena(), (uint8_t)(20 + (8 - i) * (neg ? -1 : 1)));
-			data.append(data.arena(), ((const uint8_t*)&swap) + i, 8 - i);
-			return *this;
-		}
-	}
-
-	data.push_back(data.arena(), (uint8_t)'\x14');
+	encodeInt(data, data.arena(), value);
 	return *this;
 }
 
@@ -242,24 +424,13 @@ Tuple& Tuple::append(bool value) {
 
 Tuple& Tuple::append(float value) {
 	offsets.push_back(data.size());
-	float swap = bigEndianFloat(value);
-	uint8_t* bytes = (uint8_t*)&swap;
-	adjustFloatingPoint(bytes, sizeof(float), true);
-
-	data.push_back(data.arena(), 0x20);
-	data.append(data.arena(), bytes, sizeof(float));
+	encodeFloat(data, data.arena(), value);
 	return *this;
 }
 
 Tuple& Tuple::append(double value) {
 	offsets.push_back(data.size());
-	double swap = value;
-	swap = bigEndianDouble(swap);
-	uint8_t* bytes = (uint8_t*)&swap;
-	adjustFloatingPoint(bytes, sizeof(double), true);
-
-	data.push_back(data.arena(), 0x21);
-	data.append(data.arena(), bytes, sizeof(double));
+	encodeDouble(data, data.arena(), value);
 	return *this;
 }
 
@@ -287,29 +458,7 @@ Tuple::ElementType Tuple::getType(size_t index) const {
 		throw invalid_tuple_index();
 	}
 
-	uint8_t code = data[offsets[index]];
-
-	if (code == '\x00') {
-		return ElementType::NULL_TYPE;
-	} else if (code == '\x01') {
-		return ElementType::BYTES;
-	} else if (code == '\x02') {
-		return ElementType::UTF8;
-	} else if (code >= '\x0c' && code <= '\x1c') {
-		return ElementType::INT;
-	} else if (code == 0x20) {
-		return ElementType::FLOAT;
-	} else if (code == 0x21) {
-		return ElementType::DOUBLE;
-	} else if (code == 0x26 || code == 0x27) {
-		return ElementType::BOOL;
-	} else if (code == VERSIONSTAMP_96_CODE) {
-		return ElementType::VERSIONSTAMP;
-	} else if (isUserType(code)) {
-		return ElementType::USER_TYPE;
-	} else {
-		throw invalid_tuple_data_type();
-	}
+	return elementType(data[offsets[index]]);
 }
 
 Standalone<StringRef> Tuple::getString(size_t index) const {
@@ -331,25 +480,7 @@ Standalone<StringRef> Tuple::getString(size_t index) const {
 	}
 
 	Standalone<StringRef> result;
-	VectorRef<uint8_t> staging;
-
-	for (size_t i = b; i < e; ++i) {
-		if (data[i] == '\x00') {
-			staging.append(result.arena(), data.begin() + b, i - b);
-			++i;
-			b = i + 1;
-
-			if (i < e) {
-				staging.push_back(result.arena(), '\x00');
-			}
-		}
-	}
-
-	if (b < e) {
-		staging.append(result.arena(), data.begin() + b, e - b);
-	}
-
-	result.StringRef::operator=(StringRef(staging.begin(), staging.size()));
+	result.contents() = decodeString(StringRef(data.begin() + b, e - b), result.arena(), true);
 	return result;
 }
 
@@ -358,47 +489,8 @@ int64_t Tuple::getInt(size_t index, bool allow_incomplete) const {
 		throw invalid_tuple_index();
 	}
 
-	int64_t swap;
-	bool neg = false;
-
 	ASSERT(offsets[index] < data.size());
-	uint8_t code = data[offsets[index]];
-	if (code < '\x0c' || code > '\x1c') {
-		throw invalid_tuple_data_type();
-	}
-
-	int8_t len = code - '\x14';
-
-	if (len < 0) {
-		len = -len;
-		neg = true;
-	}
-
-	memset(&swap, neg ? '\xff' : 0, 8 - len);
-	// presentLen is how many of len bytes are actually present, it will be < len if the encoded tuple was truncated
-	int presentLen = std::min<int8_t>(len, data.size() - offsets[index] - 1);
-	ASSERT(len == presentLen || allow_incomplete);
-	memcpy(((uint8_t*)&swap) + 8 - len, data.begin() + offsets[index] + 1, presentLen);
-	if (presentLen < len) {
-		int suffix = len - presentLen;
-		if (presentLen == 0) {
-			// The first byte in an int would always be at least 1, because if was 0 then a shorter int type would have
-			// been used. So if we don't have the first (most significant) byte in the encoded string, use 1 so that the
-			// decoded result maintains the encoded form's sort order with an encoded value of a shorter and same-signed
-			// type.
-			*(((uint8_t*)&swap) + 8 - len) = 1;
-			--suffix; // The suffix to clear below is now 1 byte shorter.
-		}
-		memset(((uint8_t*)&swap) + 8 - suffix, 0, suffix);
-	}
-
-	swap = bigEndian64(swap);
-
-	if (neg) {
-		swap = -(~swap);
-	}
-
-	return swap;
+	return decodeInt(data.begin() + offsets[index], data.size() - offsets[index], allow_incomplete);
 }
 
 // TODO: Combine with bindings/flow/Tuple.*. This code is copied from there.
@@ -407,14 +499,7 @@ bool Tuple::getBool(size_t index) const {
 		throw invalid_tuple_index();
 	}
 	ASSERT_LT(offsets[index], data.size());
-	uint8_t code = data[offsets[index]];
-	if (code == 0x26) {
-		return false;
-	} else if (code == 0x27) {
-		return true;
-	} else {
-		throw invalid_tuple_data_type();
-	}
+	return decodeBool(data[offsets[index]]);
 }
 
 float Tuple::getFloat(size_t index) const {
@@ -422,18 +507,7 @@ float Tuple::getFloat(size_t index) const {
 		throw invalid_tuple_index();
 	}
 	ASSERT_LT(offsets[index], data.size());
-	uint8_t code = data[offsets[index]];
-	if (code != 0x20) {
-		throw invalid_tuple_data_type();
-	}
-
-	float swap;
-	uint8_t* bytes = (uint8_t*)&swap;
-	ASSERT_LE(offsets[index] + 1 + sizeof(float), data.size());
-	swap = *(float*)(data.begin() + offsets[index] + 1);
-	adjustFloatingPoint(bytes, sizeof(float), false);
-
-	return bigEndianFloat(swap);
+	return decodeFloat(data.begin() + offsets[index], data.size() - offsets[index]);
 }
 
 double Tuple::getDouble(size_t index) const {
@@ -441,18 +515,7 @@ double Tuple::getDouble(size_t index) const {
 		throw invalid_tuple_index();
 	}
 	ASSERT_LT(offsets[index], data.size());
-	uint8_t code = data[offsets[index]];
-	if (code != 0x21) {
-		throw invalid_tuple_data_type();
-	}
-
-	double swap;
-	uint8_t* bytes = (uint8_t*)&swap;
-	ASSERT_LE(offsets[index] + 1 + sizeof(double), data.size());
-	swap = *(double*)(data.begin() + offsets[index] + 1);
-	adjustFloatingPoint(bytes, sizeof(double), false);
-
-	return bigEndianDouble(swap);
+	return decodeDouble(data.begin() + offsets[index], data.size() - offsets[index]);
 }
 
 TupleVersionstamp Tuple::getVersionstamp(size_t index) const {
@@ -529,6 +592,102 @@ StringRef Tuple::subTupleRawString(size_t index) const {
 	return StringRef(data.begin() + offsets[index], endPos - offsets[index]);
 }
 
+TupleReader::TupleReader(StringRef packed, bool include_user_type)
+  : packed(packed), includeUserType(include_user_type) {
+	if (!empty()) {
+		end = elementEnd(packed, pos, includeUserType);
+	}
+}
+
+void TupleReader::next() {
+	pos = end;
+	if (!empty()) {
+		end = elementEnd(packed, pos, includeUserType);
+	}
+}
+
+Tuple::ElementType TupleReader::type() const {
+	ASSERT(!empty());
+	uint8_t code = packed[pos];
+	if (isUserTypeCode(code) && !includeUserType) {
+		throw invalid_tuple_data_type();
+	}
+	return elementType(code);
+}
+
+StringRef TupleReader::getString(Arena& arena) const {
+	ASSERT(!empty());
+	uint8_t code = packed[pos];
+	if (code != '\x01' && code != '\x02') {
+		throw invalid_tuple_data_type();
+	}
+	return decodeString(raw().substr(1), arena, false);
+}
+
+int64_t TupleReader::getInt(bool allow_incomplete) const {
+	ASSERT(!empty());
+	return decodeInt(packed.begin() + pos, packed.size() - pos, allow_incomplete);
+}
+
+bool TupleReader::getBool() const {
+	ASSERT(!empty());
+	return decodeBool(packed[pos]);
+}
+
+float TupleReader::getFloat() const {
+	ASSERT(!empty());
+	return decodeFloat(packed.begin() + pos, packed.size() - pos);
+}
+
+double TupleReader::getDouble() const {
+	ASSERT(!empty());
+	return decodeDouble(packed.begin() + pos, packed.size() - pos);
+}
+
+TupleVersionstamp TupleReader::getVersionstamp() const {
+	ASSERT(!empty());
+	if (packed[pos] != VERSIONSTAMP_96_CODE) {
+		throw invalid_tuple_data_type();
+	}
+	ASSERT_LE(end, packed.size());
+	return TupleVersionstamp(packed.substr(pos + 1, VERSIONSTAMP_TUPLE_SIZE));
+}
+
+TupleWriter& TupleWriter::append(StringRef const& str, bool utf8) {
+	encodeString(out, arena, str, utf8);
+	return *this;
+}
+
+TupleWriter& TupleWriter::append(int64_t value) {
+	encodeInt(out, arena, value);
+	return *this;
+}
+
+TupleWriter& TupleWriter::append(bool value) {
+	out.push_back(arena, value ? 0x27 : 0x26);
+	return *this;
+}
+
+TupleWriter& TupleWriter::append(float value) {
+	encodeFloat(out, arena, value);
+	return *this;
+}
+
+TupleWriter& TupleWriter::append(double value) {
+	encodeDouble(out, arena, value);
+	return *this;
+}
+
+TupleWriter& TupleWriter::append(std::nullptr_t) {
+	out.push_back(arena, (uint8_t)'\x00');
+	return *this;
+}
+
+TupleWriter& TupleWriter::append(TupleVersionstamp const& vs) {
+	encodeVersionstamp(out, arena, vs);
+	return *this;
+}
+
 TEST_CASE("/fdbclient/Tuple/makeTuple") {
 	Tuple t1 = Tuple::makeTuple(1,
 	                            1.0f,
@@ -601,3 +760,73 @@ TEST_CASE("/fdbclient/Tuple/unpack") {
 
 	return Void();
 }
+
+TEST_CASE("/fdbclient/Tuple/escapedStrings") {
+	std::vector<Standalone<StringRef>> strings = {
+		""_sr, "\x00"_sr, "\x00\x00"_sr, "a\x00"_sr, "\x00z"_sr, "a\x00\xffz\x00"_sr, "\xff\x00\xff\x00"_sr
+	};
+	for (int i = 0; i < 100; ++i) {
+		std::string s(deterministicRandom()->randomInt(0, 100), '\x00');
+		for (auto& c : s) {
+			c = deterministicRandom()->coinflip() ? '\x00' : (char)deterministicRandom()->randomInt(0, 256);
+		}
+		strings.push_back(Standalone<StringRef>(StringRef(s)));
+	}
+
+	for (auto const& str : strings) {
+		Tuple t = Tuple::makeTuple(str, 1, Tuple::UnicodeStr(str));
+		Standalone<StringRef> packed = t.pack();
+		Tuple unpacked = Tuple::unpack(packed);
+		ASSERT(unpacked.size() == 3);
+		ASSERT(unpacked.getString(0) == str);
+		ASSERT(unpacked.getInt(1) == 1);
+		ASSERT(unpacked.getString(2) == str);
+	}
+
+	return Void();
+}
+
+TEST_CASE("/fdbclient/Tuple/readerWriter") {
+	Tuple t = Tuple::makeTuple(-7,
+	                           1.5f,
+	                           -2.25,
+	                           true,
+	                           "byteStr"_sr,
+	                           "null\x00str"_sr,
+	                           Tuple::UnicodeStr("str"_sr),
+	                           nullptr,
+	                           TupleVersionstamp("000000000000"_sr));
+
+	Arena arena;
+	VectorRef<uint8_t> buffer;
+	TupleWriter writer(arena, buffer);
+	writer << -7 << 1.5f << -2.25 << true << "byteStr"_sr << "null\x00str"_sr << Tuple::UnicodeStr("str"_sr) << nullptr
+	       << TupleVersionstamp("000000000000"_sr);
+	ASSERT(writer.packed() == t.pack());
+
+	StringRef packed = writer.packed();
+	TupleReader reader(packed);
+	ASSERT(reader.type() == Tuple::INT && reader.getInt() == -7);
+	reader.next();
+	ASSERT(reader.type() == Tuple::FLOAT && reader.getFloat() == 1.5f);
+	reader.next();
+	ASSERT(reader.type() == Tuple::DOUBLE && reader.getDouble() == -2.25);
+	reader.next();
+	ASSERT(reader.type() == Tuple::BOOL && reader.getBool());
+	reader.next();
+	// Strings without escaped nulls are returned in place
+	StringRef str = reader.getString(arena);
+	ASSERT(str == "byteStr"_sr && str.begin() > packed.begin() && str.end() < packed.end());
+	reader.next();
+	ASSERT(reader.getString(arena) == "null\x00str"_sr);
+	reader.next();
+	ASSERT(reader.type() == Tuple::UTF8 && reader.getString(arena) == "str"_sr);
+	reader.next();
+	ASSERT(reader.type() == Tuple::NULL_TYPE && reader.raw() == "\x00"_sr);
+	reader.next();
+	ASSERT(reader.getVersionstamp() == t.getVersionstamp(8));
+	reader.next();
+	ASSERT(reader.empty());
+
+	return Void();
+}
@@ -375,6 +375,52 @@ TEST_CASE("/fdbclient/VersionVector/testI") {
 	return Void();
 }
 
+// Deltas taken from a version vector that tracks its changes, and applied to one that does, must match those of one
+// that doesn't.
+TEST_CASE("/fdbclient/VersionVector/trackedDeltas") {
+	VersionVector tracked, untracked;
+	tracked.trackChanges();
+	VersionVector trackedCache, untrackedCache;
+	trackedCache.trackChanges();
+	Version version = deterministicRandom()->randomInt64(0, 1000000);
+	Version cacheVersion = invalidVersion;
+	const int tagCount = deterministicRandom()->randomInt(1, 200);
+
+	for (int i = 0; i < 2000; i++) {
+		std::set<Tag> tags;
+		int updates = deterministicRandom()->randomInt(1, 4);
+		for (int j = 0; j < updates; j++) {
+			tags.emplace(deterministicRandom()->randomInt(0, 2), deterministicRandom()->randomInt(0, tagCount));
+		}
+		version += deterministicRandom()->randomInt(1, 100);
+		tracked.setVersion(tags, version);
+		untracked.setVersion(tags, version);
+
+		Version refVersion =
+		    deterministicRandom()->coinflip() ? version - deterministicRandom()->randomInt(0, 2000) : cacheVersion;
+		refVersion = std::max(refVersion, invalidVersion);
+		VersionVector trackedDelta, untrackedDelta;
+		tracked.getDelta(refVersion, trackedDelta);
+		untracked.getDelta(refVersion, untrackedDelta);
+		ASSERT(trackedDelta.compare(untrackedDelta));
+
+		if (refVersion == cacheVersion) {
+			trackedCache.applyDelta(trackedDelta);
+			untrackedCache.applyDelta(untrackedDelta);
+			ASSERT(trackedCache.compare(untrackedCache));
+			cacheVersion = trackedCache.getMaxVersion();
+
+			VersionVector cacheDelta, expectedCacheDelta;
+			trackedCache.getDelta(refVersion, cacheDelta);
+			untrackedCache.getDelta(refVersion, expectedCacheDelta);
+			ASSERT(cacheDelta.compare(expectedCacheDelta));
+		}
+	}
+	ASSERT(tracked.compare(untracked));
+
+	return Void();
+}
+
 } // namespace unit_tests
 
 void forceLinkVersionVectorTests() {}
@@ -0,0 +1,321 @@
+/*
+ * VersionedBatchMap.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <map>
+
+#include "fdbclient/VersionedBatchMap.h"
+#include "flow/UnitTest.h"
+
+namespace {
+
+// Applies a sequence of mutations to a set of non overlapping entries, later mutations overriding earlier ones.
+struct EntryResolver {
+	Arena& arena; // Where keys created by splitting clears are allocated
+	std::map<KeyRef, ValueOrClearToRef> entries;
+
+	explicit EntryResolver(Arena& arena) : arena(arena) {}
+
+	void apply(VersionedBatchMap::Entry const& e) {
+		if (e.value.isValue()) {
+			set(e.key, e.value);
+		} else {
+			clear(e.key, e.value.getEndKey());
+		}
+	}
+
+	void set(KeyRef key, ValueOrClearToRef value) {
+		auto it = entries.upper_bound(key);
+		if (it != entries.begin()) {
+			auto prev = std::prev(it);
+			if (prev->second.isClearTo() && prev->second.getEndKey() > key) {
+				// Split the clear containing key around it
+				KeyRef end = prev->second.getEndKey();
+				KeyRef after = keyAfter(key, arena);
+				if (prev->first == key) {
+					entries.erase(prev);
+				} else {
+					prev->second = ValueOrClearToRef::clearTo(key);
+				}
+				if (after < end) {
+					entries.emplace(after, ValueOrClearToRef::clearTo(end));
+				}
+			}
+		}
+		entries.insert_or_assign(key, value);
+	}
+
+	void clear(KeyRef begin, KeyRef end) {
+		if (begin >= end) {
+			return;
+		}
+		auto it = entries.lower_bound(begin);
+		if (it != entries.begin()) {
+			auto prev = std::prev(it);
+			if (prev->second.isClearTo() && prev->second.getEndKey() >= begin) {
+				begin = prev->first;
+				end = std::max(end, prev->second.getEndKey());
+				it = prev;
+			}
+		}
+		// Everything starting in [begin, end) is covered, as is an adjacent clear starting at end
+		while (it != entries.end() && (it->first < end || (it->first == end && it->second.isClearTo()))) {
+			if (it->second.isClearTo()) {
+				end = std::max(end, it->second.getEndKey());
+			}
+			it = entries.erase(it);
+		}
+		entries.emplace(begin, ValueOrClearToRef::clearTo(end));
+	}
+
+	// Writes the resolved entries in key order, copying their bytes into copyTo if it is given
+	void finish(std::vector<VersionedBatchMap::Entry>& out, Arena* copyTo) const {
+		out.clear();
+		out.reserve(entries.size());
+		for (auto const& [key, value] : entries) {
+			if (!copyTo) {
+				out.emplace_back(key, value);
+			} else if (value.isValue()) {
+				out.emplace_back(KeyRef(*copyTo, key), ValueOrClearToRef::value(ValueRef(*copyTo, value.getValue())));
+			} else {
+				out.emplace_back(KeyRef(*copyTo, key), ValueOrClearToRef::clearTo(KeyRef(*copyTo, value.getEndKey())));
+			}
+		}
+		out.shrink_to_fit();
+	}
+};
+
+} // namespace
+
+void VersionedBatchMap::insert(KeyRef key, ValueRef value) {
+	Batch& batch = batches.back();
+	batch.entries.emplace_back(KeyRef(batch.arena, key), ValueOrClearToRef::value(ValueRef(batch.arena, value)));
+}
+
+void VersionedBatchMap::clear(KeyRangeRef range) {
+	Batch& batch = batches.back();
+	batch.entries.emplace_back(KeyRef(batch.arena, range.begin),
+	                           ValueOrClearToRef::clearTo(KeyRef(batch.arena, range.end)));
+}
+
+void VersionedBatchMap::createNewVersion(Version version) {
+	ASSERT(version > getLatestVersion());
+	Batch& latest = batches.back();
+	if (latest.entries.empty()) {
+		// Nothing was written at the latest version, so it can simply become the new one
+		latest.version = version;
+		return;
+	}
+	seal(latest);
+	batches.emplace_back(version);
+}
+
+void VersionedBatchMap::seal(Batch& batch) {
+	if (batch.sorted) {
+		return;
+	}
+	EntryResolver resolver(batch.arena);
+	for (auto const& e : batch.entries) {
+		resolver.apply(e);
+	}
+	resolver.finish(batch.entries, nullptr);
+	batch.sorted = true;
+}
+
+Optional<Optional<ValueRef>> VersionedBatchMap::find(Batch const& batch, KeyRef key) {
+	auto matches = [key](Entry const& e) -> Optional<Optional<ValueRef>> {
+		if (e.value.isValue()) {
+			if (e.key == key) {
+				return Optional<ValueRef>(e.value.getValue());
+			}
+		} else if (e.key <= key && key < e.value.getEndKey()) {
+			return Optional<ValueRef>();
+		}
+		return Optional<Optional<ValueRef>>();
+	};
+
+	if (!batch.sorted) {
+		// The latest version is searched from its most recent mutation backwards
+		for (auto it = batch.entries.rbegin(); it != batch.entries.rend(); ++it) {
+			auto result = matches(*it);
+			if (result.present()) {
+				return result;
+			}
+		}
+		return Optional<Optional<ValueRef>>();
+	}
+
+	// The last entry starting at or before key is the only one which can contain it
+	auto it = std::upper_bound(
+	    batch.entries.begin(), batch.entries.end(), key, [](KeyRef k, Entry const& e) { return k < e.key; });
+	if (it == batch.entries.begin()) {
+		return Optional<Optional<ValueRef>>();
+	}
+	return matches(*std::prev(it));
+}
+
+Optional<Optional<ValueRef>> VersionedBatchMap::get(KeyRef key, Version version) const {
+	ASSERT(version >= oldestVersion);
+	for (auto batch = batches.rbegin(); batch != batches.rend(); ++batch) {
+		if (batch->version > version) {
+			continue;
+		}
+		auto result = find(*batch, key);
+		if (result.present()) {
+			return result;
+		}
+	}
+	return Optional<Optional<ValueRef>>();
+}
+
+void VersionedBatchMap::forgetVersionsBefore(Version version) {
+	ASSERT(version <= getLatestVersion());
+	oldestVersion = std::max(oldestVersion, version);
+
+	// The newest batch which is still needed to read at oldestVersion, and everything before it, can be collapsed. The
+	// latest batch is left alone since it is still being written.
+	int last = 0;
+	while (last + 2 < batches.size() && batches[last + 1].version <= oldestVersion) {
+		++last;
+	}
+	if (last == 0) {
+		return;
+	}
+
+	Batch merged(batches[last].version);
+	Arena scratch;
+	EntryResolver resolver(scratch);
+	for (int i = 0; i <= last; ++i) {
+		for (auto const& e : batches[i].entries) {
+			resolver.apply(e);
+		}
+	}
+	resolver.finish(merged.entries, &merged.arena);
+	merged.sorted = true;
+
+	batches.erase(batches.begin(), batches.begin() + last + 1);
+	batches.push_front(std::move(merged));
+}
+
+int64_t VersionedBatchMap::getBytes() const {
+	int64_t bytes = 0;
+	for (auto const& batch : batches) {
+		bytes += batch.getBytes();
+	}
+	return bytes;
+}
+
+void forceLinkVersionedBatchMapTests() {}
+
+TEST_CASE("/fdbclient/VersionedBatchMap/basic") {
+	VersionedBatchMap map;
+	map.createNewVersion(1);
+	map.insert("a"_sr, "1"_sr);
+	map.insert("b"_sr, "1"_sr);
+	map.insert("c"_sr, "1"_sr);
+	map.createNewVersion(2);
+	map.clear(KeyRangeRef("b"_sr, "d"_sr));
+	map.insert("c"_sr, "2"_sr);
+	map.createNewVersion(3);
+	map.insert("a"_sr, "3"_sr);
+
+	ASSERT(!map.get("a"_sr, 0).present());
+	ASSERT(map.get("a"_sr, 1).get().get() == "1"_sr);
+	ASSERT(map.get("a"_sr, 2).get().get() == "1"_sr);
+	ASSERT(map.get("a"_sr, 3).get().get() == "3"_sr);
+	ASSERT(map.get("b"_sr, 1).get().get() == "1"_sr);
+	ASSERT(!map.get("b"_sr, 2).get().present());
+	ASSERT(map.get("c"_sr, 2).get().get() == "2"_sr);
+	ASSERT(!map.get("bb"_sr, 3).get().present());
+	ASSERT(!map.get("d"_sr, 3).present());
+
+	map.forgetVersionsBefore(2);
+	ASSERT(map.getOldestVersion() == 2);
+	ASSERT(map.getBatchCount() == 2);
+	ASSERT(map.get("a"_sr, 2).get().get() == "1"_sr);
+	ASSERT(!map.get("b"_sr, 2).get().present());
+	ASSERT(map.get("c"_sr, 2).get().get() == "2"_sr);
+	ASSERT(!map.get("cc"_sr, 3).get().present());
+	ASSERT(map.get("a"_sr, 3).get().get() == "3"_sr);
+
+	return Void();
+}
+
+// Checks the map against a std::map of every version, with a small key space so that sets and clears overlap
+TEST_CASE("/fdbclient/VersionedBatchMap/random") {
+	VersionedBatchMap map;
+	std::map<Version, std::map<Key, Optional<Value>>> expected;
+	std::map<Key, Optional<Value>> current;
+	Version version = 0;
+	auto randomKey = []() { return Key(format("%02d", deterministicRandom()->randomInt(0, 30))); };
+
+	for (int i = 0; i < 2000; ++i) {
+		int op = deterministicRandom()->randomInt(0, 10);
+		if (op < 6) {
+			Key key = randomKey();
+			Value value(format("%d", i));
+			map.insert(key, value);
+			current[key] = value;
+		} else if (op < 8) {
+			Key begin = randomKey(), end = randomKey();
+			if (end < begin) {
+				std::swap(begin, end);
+			}
+			map.clear(KeyRangeRef(begin, end));
+			for (int k = 0; k < 30; ++k) {
+				Key key(format("%02d", k));
+				if (begin <= key && key < end) {
+					current[key] = Optional<Value>();
+				}
+			}
+		} else {
+			expected[version] = current;
+			version += deterministicRandom()->randomInt(1, 3);
+			map.createNewVersion(version);
+			if (deterministicRandom()->random01() < 0.1) {
+				Version forget = deterministicRandom()->randomInt64(map.getOldestVersion(), version + 1);
+				map.forgetVersionsBefore(forget);
+				// Keep the newest state at or before forget, which is what is read at the new oldest version
+				expected.erase(expected.begin(), std::prev(expected.upper_bound(forget)));
+			}
+		}
+	}
+	expected[version] = current;
+
+	for (auto const& it : expected) {
+		Version readVersion = std::max(it.first, map.getOldestVersion());
+		auto const& snapshot = std::prev(expected.upper_bound(readVersion))->second;
+		for (int k = 0; k < 30; ++k) {
+			Key key(format("%02d", k));
+			auto result = map.get(key, readVersion);
+			auto expectedValue = snapshot.find(key);
+			if (expectedValue == snapshot.end()) {
+				ASSERT(!result.present());
+			} else {
+				ASSERT(result.present());
+				ASSERT(result.get().present() == expectedValue->second.present());
+				if (expectedValue->second.present()) {
+					ASSERT(result.get().get() == expectedValue->second.get());
+				}
+			}
+		}
+	}
+
+	return Void();
+}
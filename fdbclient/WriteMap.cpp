@@ -125,7 +125,7 @@ void WriteMap::mutate(KeyRef key, MutationRef::Type operation, ValueRef param, b
 		if (!it.is_unreadable() &&
 		    (operation == MutationRef::SetValue || operation == MutationRef::SetVersionstampedValue)) {
 			it.tree.clear();
-			PTreeImpl::remove(writes, ver, key);
+			// Inserting an entry with an existing key replaces it in a single pass down the tree
 			PTreeImpl::insert(writes,
 			                  ver,
 			                  WriteMapEntry(key,
@@ -148,10 +148,6 @@ void WriteMap::mutate(KeyRef key, MutationRef::Type operation, ValueRef param, b
 				e.stack.push(RYWMutation(param, operation));
 
 			it.tree.clear();
-			PTreeImpl::remove(
-			    writes,
-			    ver,
-			    e.key); // FIXME: Make PTreeImpl::insert do this automatically (see also VersionedMap.h FIXME)
 			PTreeImpl::insert(writes, ver, std::move(e));
 		}
 	}
@@ -247,13 +243,10 @@ void WriteMap::addConflictRange(KeyRangeRef keys) {
 	it.reset(writes, ver);
 	it.skip(keys.begin);
 
-	std::vector<ExtStringRef> removals;
+	// Entries whose key is already in the tree replace the existing entry when inserted
 	std::vector<WriteMapEntry> insertions;
 
 	if (!it.entry().following_keys_conflict || !it.entry().is_conflict) {
-		if (it.keyAtBegin() && it.beginKey() == keys.begin) {
-			removals.push_back(keys.begin);
-		}
 		insertions.push_back(WriteMapEntry(keys.begin,
 		                                   it.is_operation() ? OperationStack(it.op()) : OperationStack(),
 		                                   it.entry().following_keys_cleared,
@@ -269,7 +262,6 @@ void WriteMap::addConflictRange(KeyRangeRef keys) {
 			WriteMapEntry e(it.entry());
 			e.following_keys_conflict = true;
 			e.is_conflict = true;
-			removals.push_back(e.key);
 			insertions.push_back(std::move(e));
 		}
 	}
@@ -289,14 +281,7 @@ void WriteMap::addConflictRange(KeyRangeRef keys) {
 
 	it.tree.clear();
 
-	// SOMEDAY: optimize this code by having a PTree removal/insertion that takes and returns an iterator
-	for (int i = 0; i < removals.size(); i++) {
-		PTreeImpl::remove(
-		    writes,
-		    ver,
-		    removals[i]); // FIXME: Make PTreeImpl::insert do this automatically (see also VersionedMap.h FIXME)
-	}
-
+	// SOMEDAY: optimize this code by having a PTree insertion that takes and returns an iterator
 	for (int i = 0; i < insertions.size(); i++) {
 		PTreeImpl::insert(writes, ver, std::move(insertions[i]));
 	}
@@ -72,6 +72,9 @@ static const uint32_t BACKUP_AGENT_SNAPSHOT_FILE_VERSION = 1001;
 // Encrypted Snapshot file version written by FileBackupAgent
 static const uint32_t BACKUP_AGENT_ENCRYPTED_SNAPSHOT_FILE_VERSION = 1002;
 
+// Compressed Snapshot file version written by FileBackupAgent
+static const uint32_t BACKUP_AGENT_COMPRESSED_SNAPSHOT_FILE_VERSION = 1003;
+
 struct LogFile {
 	Version beginVersion;
 	Version endVersion;
@@ -53,6 +53,12 @@
  *     Old backup logs FDB 6.2 and earlier are stored in "logs" directory and are not partitioned.
  *     After FDB 6.3, users can choose to use the new partitioned logs or old logs.
  *
+ *   Log manifests list the files of a log folder which can no longer change, and are at file paths like
+ *       /plogmanifests/manifest,N
+ *       /logmanifests/manifest,N
+ *     where N is the index of the folder. They are written when such a folder is first listed so that later
+ *     listings don't have to list it again, and are ignored and rewritten if missing or corrupt.
+ *
  *
  *   BACKWARD COMPATIBILITY
  *
@@ -130,7 +136,12 @@ public:
 
 	// List log files, unsorted, which contain data at any version >= beginVersion and <= targetVersion.
 	// "partitioned" flag indicates if new partitioned mutation logs or old logs should be listed.
-	Future<std::vector<LogFile>> listLogFiles(Version beginVersion, Version targetVersion, bool partitioned);
+	// If "useManifests" is true, log folders which can no longer change are read from their manifests, which are
+	// written the first time each such folder is listed, instead of being listed again.
+	Future<std::vector<LogFile>> listLogFiles(Version beginVersion,
+	                                          Version targetVersion,
+	                                          bool partitioned,
+	                                          bool useManifests = true);
 
 	// List range files, unsorted, which contain data at or between beginVersion and endVersion
 	// Note: The contents of each top level snapshot.N folder do not necessarily constitute a valid snapshot
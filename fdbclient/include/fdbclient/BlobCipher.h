@@ -101,6 +101,7 @@ public:
 	Counter latestCipherKeyCacheHit;
 	Counter latestCipherKeyCacheMiss;
 	Counter latestCipherKeyCacheNeedsRefresh;
+	Counter latestCipherKeyRefreshAhead;
 	LatencySample getBlobMetadataLatency;
 	LatencySample getCipherKeysLatency;
 	LatencySample getLatestCipherKeysLatency;
@@ -614,8 +615,11 @@ static_assert(sizeof(BlobCipherEncryptHeader) == BlobCipherEncryptHeader::header
 // This interface is in-memory representation of CipherKey used for encryption/decryption information.
 // It caches base encryption key properties as well as caches the 'derived encryption' key obtained by applying
 // HMAC-SHA-256 derivation technique.
+//
+// The reference count is thread safe so that cipher keys can be used to decrypt off the network thread, such as by
+// Redwood's page codec threads.
 
-class BlobCipherKey : public ReferenceCounted<BlobCipherKey>, NonCopyable {
+class BlobCipherKey : public ThreadSafeReferenceCounted<BlobCipherKey>, NonCopyable {
 public:
 	BlobCipherKey(const EncryptCipherDomainId& domainId,
 	              const EncryptCipherBaseKeyId& baseCiphId,
@@ -669,6 +673,22 @@ public:
 		return now() + INetwork::TIME_EPS >= expireAtTS ? true : false;
 	}
 
+	// Returns true if the cipher key will need a refresh within 'window' seconds, allowing callers to refresh it ahead
+	// of time while it is still served from the cache.
+	inline bool needsRefreshWithin(double window) {
+		if (refreshAtTS == std::numeric_limits<int64_t>::max()) {
+			return false;
+		}
+		return now() + window >= refreshAtTS;
+	}
+
+	// Extends the refresh and expiry timestamps when KMS hands out the same base cipher again. Timestamps never move
+	// backwards.
+	void extendValidity(const int64_t refreshAt, const int64_t expireAt) {
+		refreshAtTS = std::max(refreshAtTS, refreshAt);
+		expireAtTS = std::max(expireAtTS, expireAt);
+	}
+
 	BlobCipherDetails details() const { return BlobCipherDetails{ encryptDomainId, baseCipherId, randomSalt }; }
 
 	void reset();
@@ -889,6 +909,10 @@ public:
 	// of FDB process/core dump.
 	static void cleanup() noexcept;
 
+	// Background fetches refreshing the latest cipher key of a domain ahead of its refreshAt, shared by all the roles
+	// of the process so that each domain has at most one refresh-ahead fetch in flight.
+	std::unordered_map<EncryptCipherDomainId, Future<Void>> refreshAheadFetches;
+
 private:
 	BlobCipherDomainCacheMap domainCacheMap;
 	size_t size = 0;
@@ -900,6 +924,13 @@ private:
 // do two things:
 // 1) generate encrypted ciphertext for given plaintext input.
 // 2) generate BlobCipherEncryptHeader (including the 'header authTokens') and persit for decryption on reads.
+//
+// One encryptor can encrypt many small buffers (mutations, pages) under the same cipher keys: call resetIV() with a
+// fresh IV before each encrypt() after the first. That reuses the expanded key schedule and the header authentication
+// context, which for small buffers cost more than encrypting them.
+
+class HmacSha256DigestGen;
+class Aes256CmacDigestGen;
 
 class EncryptBlobCipherAes265Ctr final : NonCopyable, public ReferenceCounted<EncryptBlobCipherAes265Ctr> {
 public:
@@ -929,6 +960,9 @@ public:
 	                           BlobCipherMetrics::UsageType usageType);
 	~EncryptBlobCipherAes265Ctr();
 
+	// Restarts the counter stream at 'iv' for the next encryption
+	void resetIV(const uint8_t* iv, const int ivLen);
+
 	Reference<EncryptBuf> encrypt(const uint8_t* plaintext,
 	                              const int plaintextLen,
 	                              BlobCipherEncryptHeader* header,
@@ -962,6 +996,7 @@ private:
 	                                   const int,
 	                                   const BlobCipherEncryptHeaderFlagsV1&,
 	                                   BlobCipherEncryptHeaderRef*);
+	void computeHeaderAuthToken(const std::vector<std::pair<const uint8_t*, size_t>>& payload, uint8_t* digestBuf);
 
 	EVP_CIPHER_CTX* ctx;
 	Reference<BlobCipherKey> textCipherKey;
@@ -970,6 +1005,9 @@ private:
 	uint8_t iv[AES_256_IV_LENGTH];
 	BlobCipherMetrics::UsageType usageType;
 	EncryptAuthTokenAlgo authTokenAlgo;
+	// Created on the first authenticated encryption, keyed with the header cipher key
+	std::unique_ptr<HmacSha256DigestGen> hmacGen;
+	std::unique_ptr<Aes256CmacDigestGen> cmacGen;
 };
 
 // This interface enable data block decryption. An invocation to decrypt() would generate
@@ -85,6 +85,16 @@ struct GranuleMaterializeStats {
 
 	GranuleMaterializeStats()
 	  : inputBytes(0), outputBytes(0), snapshotRows(0), rowsCleared(0), rowsInserted(0), rowsUpdated(0) {}
+
+	GranuleMaterializeStats& operator+=(const GranuleMaterializeStats& other) {
+		inputBytes += other.inputBytes;
+		outputBytes += other.outputBytes;
+		snapshotRows += other.snapshotRows;
+		rowsCleared += other.rowsCleared;
+		rowsInserted += other.rowsInserted;
+		rowsUpdated += other.rowsUpdated;
+		return *this;
+	}
 };
 
 struct BlobGranuleCipherKeysMeta {
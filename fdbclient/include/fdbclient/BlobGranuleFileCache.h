@@ -0,0 +1,74 @@
+/*
+ * BlobGranuleFileCache.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FDBCLIENT_BLOBGRANULEFILECACHE_H
+#define FDBCLIENT_BLOBGRANULEFILECACHE_H
+#pragma once
+
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "fdbrpc/Stats.h"
+#include "flow/ActorCollection.h"
+#include "flow/flow.h"
+
+// A bounded cache of granule files on local disk, so repeated reads of the same granules don't go back to the blob
+// store. Granule files are immutable and their names are unique, so cached files never need to be invalidated, only
+// evicted, which is done least recently used first. The cache is per process and starts empty.
+struct BlobGranuleFileCache : NonCopyable {
+	struct Entry {
+		std::string path; // local copy of the file
+		int64_t bytes;
+		uint64_t checksum;
+		std::list<std::string>::iterator lruPosition;
+	};
+
+	std::string directory;
+	int64_t capacityBytes;
+	int64_t cachedBytes = 0;
+	std::unordered_map<std::string, Entry> entries;
+	std::list<std::string> lru; // least recently used file first
+	std::unordered_set<std::string> adding;
+
+	CounterCollection cc;
+	Counter hits, misses, checksumFailures, readErrors, filesAdded, bytesAdded, evictions;
+	Future<Void> logger;
+	ActorCollectionNoErrors actors;
+
+	BlobGranuleFileCache(std::string const& directory, int64_t capacityBytes);
+
+	// Returns the contents of the cached file, or not present if it isn't cached or fails its checksum
+	Future<Optional<Standalone<StringRef>>> get(std::string const& filename);
+
+	// Caches the file in the background, evicting other files to make space
+	void add(std::string const& filename, Standalone<StringRef> const& contents);
+
+	// Removes the file from the cache and deletes its local copy
+	void remove(std::string const& filename);
+
+	// The cache of this process, or nullptr if it hasn't been enabled
+	static BlobGranuleFileCache* processCache();
+
+	// Enables the cache of this process, clearing anything left in directory. Does nothing if already enabled.
+	static void enableProcessCache(std::string const& directory, int64_t capacityBytes);
+};
+
+#endif
@@ -34,6 +34,38 @@ Value serializeChunkedSnapshot(const Standalone<StringRef>& fileNameRef,
                                Optional<BlobGranuleCipherKeysCtx> cipherKeysCtx = {},
                                bool isSnapshotSorted = true);
 
+// Builds a chunked snapshot file a row at a time, so the rows of a snapshot don't have to be held in memory all at
+// once. Only the serialized chunks are kept until finish().
+class SnapshotFileBuilder : NonCopyable {
+public:
+	SnapshotFileBuilder(const Standalone<StringRef>& fileNameRef,
+	                    int targetChunkBytes,
+	                    Optional<CompressionFilter> compressFilter,
+	                    Optional<BlobGranuleCipherKeysCtx> cipherKeysCtx = {},
+	                    bool isSnapshotSorted = true);
+	~SnapshotFileBuilder();
+
+	// Keys must be added in ascending order
+	void add(const KeyValueRef& kv);
+
+	// Adds a chunk of another unencrypted snapshot file as is, after the rows added so far. The chunk holds keys in
+	// [firstKey, endKey), and all keys added after it must be at least endKey.
+	void addSerializedChunk(const KeyRef& firstKey,
+	                        const KeyRef& endKey,
+	                        const StringRef& chunkBytes,
+	                        int64_t chunkLogicalBytes);
+
+	Value finish();
+
+	int64_t rows = 0;
+	int64_t logicalBytes = 0;
+	int serializedChunksReused = 0;
+
+private:
+	struct Impl;
+	std::unique_ptr<Impl> impl;
+};
+
 Value serializeChunkedDeltaFile(const Standalone<StringRef>& fileNameRef,
                                 const Standalone<GranuleDeltas>& deltas,
                                 const KeyRangeRef& fileRange,
@@ -56,6 +88,38 @@ RangeResult materializeBlobGranule(const BlobGranuleChunkRef& chunk,
                                    const std::vector<StringRef>& deltaFileData,
                                    GranuleMaterializeStats& stats);
 
+// Files written with an index footer can be read partially: the footer, the last BG_FILE_FOOTER_BYTES of the file,
+// gives the size of the index at the head of the file, and the index gives the byte range of the chunks overlapping a
+// key range. The loaders above never touch file bytes outside of the index and those chunks.
+extern const int BG_FILE_FOOTER_BYTES;
+
+// Not present if the file has no footer
+Optional<int64_t> getBlobGranuleFileIndexBytes(const StringRef& footer);
+
+// Returns the [begin, end) file offsets of the chunks needed to read keyRange, or not present if none are
+Optional<std::pair<int64_t, int64_t>> getBlobGranuleFileChunkRange(const StringRef& indexData,
+                                                                   const KeyRangeRef& keyRange,
+                                                                   Optional<BlobGranuleCipherKeysCtx> cipherKeysCtx);
+
+// A key range of a granule being re-snapshotted. If the range is exactly one chunk of the previous unencrypted
+// snapshot file, serializedChunk points to that chunk in the snapshot file data.
+struct ResnapshotPieceRef {
+	KeyRangeRef range;
+	Optional<StringRef> serializedChunk;
+};
+
+// Splits keyRange at the chunk boundaries of the snapshot file of chunk, so a granule can be re-snapshotted a piece at
+// a time, and pieces no delta touches can reuse the serialized chunks of the previous snapshot.
+Standalone<VectorRef<ResnapshotPieceRef>> getResnapshotPieces(const BlobGranuleChunkRef& chunk,
+                                                              const KeyRangeRef& keyRange,
+                                                              Optional<StringRef> snapshotData);
+
+// Whether any delta of chunk up to readVersion changes a key in keyRange
+bool granuleDeltasTouchRange(const BlobGranuleChunkRef& chunk,
+                             const KeyRangeRef& keyRange,
+                             Version readVersion,
+                             const std::vector<StringRef>& deltaFileData);
+
 std::string randomBGFilename(UID blobWorkerID, UID granuleID, Version version, std::string suffix);
 
 // For benchmark testing only. It should never be called in prod.
@@ -37,6 +37,23 @@
 
 #include "flow/actorcompiler.h" // This must be the last #include.
 
+// The contents of the snapshot and delta files of a chunk, as read for a key range
+struct BlobGranuleFileData {
+	Optional<Standalone<StringRef>> snapshotData; // not present if the chunk has no snapshot file
+	std::vector<Standalone<StringRef>> deltaData;
+
+	Optional<StringRef> snapshotRef() const {
+		return snapshotData.present() ? Optional<StringRef>(snapshotData.get()) : Optional<StringRef>();
+	}
+	std::vector<StringRef> deltaRefs() const { return std::vector<StringRef>(deltaData.begin(), deltaData.end()); }
+};
+
+// Reads the files of chunk needed to read keyRange from the provided blob store
+ACTOR Future<BlobGranuleFileData> readBlobGranuleFiles(BlobGranuleChunkRef chunk,
+                                                       KeyRangeRef keyRange,
+                                                       Reference<BlobConnectionProvider> bstore,
+                                                       Optional<BlobWorkerStats*> stats = Optional<BlobWorkerStats*>());
+
 // Reads the fileset in the reply using the provided blob store, and filters data and mutations by key + version from
 // the request
 ACTOR Future<RangeResult> readBlobGranule(BlobGranuleChunkRef chunk,
@@ -51,6 +68,16 @@ ACTOR Future<Void> readBlobGranules(BlobGranuleFileRequest request,
                                     Reference<BlobConnectionProvider> bstore,
                                     PromiseStream<RangeResult> results);
 
+// Reads the mutations to keyRange from beginVersion through readVersion from the delta files and new deltas of
+// chunks, grouped by version. Versions without mutations are left out. None of the chunks may have a snapshot file,
+// which is the case when they were read with a begin version that wasn't collapsed.
+ACTOR Future<Standalone<VectorRef<MutationsAndVersionRef>>> readBlobGranuleMutations(
+    Standalone<VectorRef<BlobGranuleChunkRef>> chunks,
+    KeyRange keyRange,
+    Version beginVersion,
+    Version readVersion,
+    Reference<BlobConnectionProvider> bstore);
+
 bool isRangeFullyCovered(KeyRange range, Standalone<VectorRef<BlobGranuleChunkRef>> blobChunks);
 
 #include "flow/unactorcompiler.h"
@@ -36,6 +36,12 @@ public:
 	double SYSTEM_MONITOR_INTERVAL;
 	double NETWORK_BUSYNESS_MONITOR_INTERVAL; // The interval in which we should update the network busyness metric
 	double TSS_METRICS_LOGGING_INTERVAL;
+	// The fraction of each type of request to a storage server with a TSS pair that is also sent to the TSS and compared
+	double TSS_SAMPLE_RATE_GET_VALUE;
+	double TSS_SAMPLE_RATE_GET_KEY;
+	double TSS_SAMPLE_RATE_GET_KEY_VALUES;
+	double TSS_SAMPLE_RATE_GET_MAPPED_KEY_VALUES;
+	double TSS_SAMPLE_RATE_OTHER; // watches, metrics, split points, change feeds
 
 	double FAILURE_MAX_DELAY;
 	double FAILURE_MIN_DELAY;
@@ -52,6 +58,7 @@ public:
 	int MAX_GRV_PROXY_CONNECTIONS;
 	double STATUS_IDLE_TIMEOUT;
 	bool SEND_ENTIRE_VERSION_VECTOR;
+	double SPECIAL_KEY_SPACE_MODULE_CACHE_SECONDS; // How long transactions share the result of a cacheable module
 
 	// wrong_shard_server sometimes comes from the only nonfailed server, so we need to avoid a fast spin
 	double WRONG_SHARD_SERVER_DELAY; // SOMEDAY: This delay can limit performance of retrieving data when the cache is
@@ -74,6 +81,8 @@ public:
 	int64_t VALUE_SIZE_LIMIT;
 	int64_t SPLIT_KEY_SIZE_LIMIT;
 	int METADATA_VERSION_CACHE_SIZE;
+	bool RYW_DEFER_WRITES; // log writes and only build the write map once the transaction reads
+	int TRANSACTION_TIMELINE_MAX_EVENTS; // events kept by a transaction that sets RECORD_TIMELINE
 	int64_t CHANGE_FEED_LOCATION_LIMIT;
 	int64_t CHANGE_FEED_CACHE_SIZE;
 	double CHANGE_FEED_POP_TIMEOUT;
@@ -83,9 +92,13 @@ public:
 	int64_t CHANGE_FEED_CACHE_FLUSH_BYTES;
 	double CHANGE_FEED_CACHE_EXPIRE_TIME;
 	int64_t CHANGE_FEED_CACHE_LIMIT_BYTES;
+	int64_t CHANGE_FEED_BLOB_CATCHUP_LAG_VERSIONS; // feeds further behind than this catch up from blob granule files
+	int64_t CHANGE_FEED_BLOB_CATCHUP_BATCH_VERSIONS;
 
 	int MAX_BATCH_SIZE;
 	double GRV_BATCH_TIMEOUT;
+	// Databases opened by the multi-version client on the same cluster batch their untagged GRV requests together
+	bool SHARE_GRV_BATCHES;
 	int BROADCAST_BATCH_SIZE;
 	double TRANSACTION_TIMEOUT_DELAY_INTERVAL;
 
@@ -94,8 +107,14 @@ public:
 	int LOCATION_CACHE_EVICTION_SIZE_SIM;
 	double LOCATION_CACHE_ENDPOINT_FAILURE_GRACE_PERIOD;
 	double LOCATION_CACHE_FAILED_ENDPOINT_RETRY_INTERVAL;
+	int LOCATION_CACHE_EVICTION_SAMPLES; // evict the least recently used of this many random entries
+	int LOCATION_CACHE_PREFETCH_SHARDS; // shard locations fetched on a miss, including the one missed
 
 	int GET_RANGE_SHARD_LIMIT;
+	int GET_RANGE_PARALLEL_SHARD_LIMIT; // the most shards a read_parallel_shards range read reads at once
+	bool GET_VALUES_BATCHING_ENABLED; // Coalesce concurrent point reads of a transaction into one request per storage
+	                                  // team
+	int GET_VALUES_BATCH_MAX_KEYS;
 	int WARM_RANGE_SHARD_LIMIT;
 	int STORAGE_METRICS_SHARD_LIMIT;
 	int SHARD_COUNT_LIMIT;
@@ -121,6 +140,8 @@ public:
 	double NO_RECENT_UPDATES_DURATION;
 	double FAST_WATCH_TIMEOUT;
 	double WATCH_TIMEOUT;
+	bool WATCH_BATCHING_ENABLED; // Register the watches of a database on a storage team with one WatchValuesRequest
+	int WATCH_BATCH_MAX_KEYS;
 
 	double IS_ACCEPTABLE_DELAY;
 
@@ -149,9 +170,12 @@ public:
 
 	// Backup
 	int BACKUP_LOCAL_FILE_WRITE_BLOCK;
+	int BACKUP_LOCAL_FILE_WRITE_BEHIND; // Block writes a local backup file may have in flight while more is appended
 	int BACKUP_CONCURRENT_DELETES;
+	bool BACKUP_CONTAINER_LOG_MANIFESTS; // Read sealed log folders of backup containers from manifests
 	int BACKUP_SIMULATED_LIMIT_BYTES;
 	int BACKUP_GET_RANGE_LIMIT_BYTES;
+	int64_t MUTATION_LOG_READER_PREFETCH_BYTES; // Bytes a MutationLogReader may read ahead of its consumer
 	int BACKUP_LOCK_BYTES;
 	double BACKUP_RANGE_TIMEOUT;
 	double BACKUP_RANGE_MINWAIT;
@@ -179,6 +203,7 @@ public:
 	int64_t MAX_WRITE_TRANSACTION_LIFE_VERSIONS; // Copy of SERVER_KNOBS, as we can't link with it.
 	int SIM_BACKUP_TASKS_PER_AGENT;
 	int BACKUP_RANGEFILE_BLOCK_SIZE;
+	std::string BACKUP_RANGEFILE_COMPRESSION; // compression filter of snapshot range file blocks, or NONE
 	int BACKUP_LOGFILE_BLOCK_SIZE;
 	int BACKUP_DISPATCH_ADDTASK_SIZE;
 	int RESTORE_DISPATCH_ADDTASK_SIZE;
@@ -246,9 +271,11 @@ public:
 	int BLOBSTORE_READ_BLOCK_SIZE;
 	int BLOBSTORE_READ_AHEAD_BLOCKS;
 	int BLOBSTORE_READ_CACHE_BLOCKS_PER_FILE;
+	int BLOBSTORE_READ_AHEAD_MAX_BLOCKS; // Blocks read ahead of a sequential reader when reading is its bottleneck
 	int BLOBSTORE_MAX_SEND_BYTES_PER_SECOND;
 	int BLOBSTORE_MAX_RECV_BYTES_PER_SECOND;
 	bool BLOBSTORE_GLOBAL_CONNECTION_POOL;
+	bool BLOBSTORE_ADAPTIVE_CONCURRENCY; // Reduce concurrent requests to an endpoint while it responds 429 or 503
 	bool BLOBSTORE_ENABLE_LOGGING;
 	double BLOBSTORE_STATS_LOGGING_INTERVAL;
 	double BLOBSTORE_LATENCY_LOGGING_INTERVAL;
@@ -299,6 +326,10 @@ public:
 	// Blob Granules
 	int BG_MAX_GRANULE_PARALLELISM;
 	int BG_TOO_MANY_GRANULES;
+	int BG_MATERIALIZE_THREADS; // Threads a blob granule read materializes its loaded chunks on, outside of simulation
+	bool BG_WRITE_INDEX_FOOTER; // Write granule files in the format whose footer allows reading only the needed chunks
+	bool BG_RANGED_FILE_READS; // Fetch only the index and the chunks overlapping the read range of footer files
+	int BG_RANGED_READ_PREFETCH_BYTES; // Head of the file fetched alongside the footer, in the hope it covers the index
 	int64_t BLOB_METADATA_REFRESH_INTERVAL;
 	bool DETERMINISTIC_BLOB_METADATA;
 	bool ENABLE_BLOB_GRANULE_FILE_LOGICAL_SIZE;
@@ -318,8 +349,13 @@ public:
 	int METACLUSTER_ASSIGNMENT_CLUSTERS_TO_CHECK;
 	double METACLUSTER_ASSIGNMENT_FIRST_CHOICE_DELAY;
 	double METACLUSTER_ASSIGNMENT_AVAILABILITY_TIMEOUT;
+	bool METACLUSTER_LOAD_AWARE_ASSIGNMENT; // Prefer the least loaded of the candidate clusters for new tenants
+	double METACLUSTER_LOAD_MAX_AGE; // Loads older than this are not used for assignment
+	double METACLUSTER_LOAD_STATUS_TIMEOUT; // How long to wait for the status of a data cluster to read its load
 	int METACLUSTER_RESTORE_BATCH_SIZE;
 	int TENANT_ENTRY_CACHE_LIST_REFRESH_INTERVAL; // How often the TenantEntryCache is refreshed
+	int TENANT_ENTRY_CACHE_REFRESH_BATCH_SIZE; // Tenants read per range read when the TenantEntryCache is refreshed
+	double TENANT_ENTRY_CACHE_METRICS_LOGGING_INTERVAL;
 	bool CLIENT_ENABLE_USING_CLUSTER_ID_KEY;
 
 	// Encryption-at-rest
@@ -343,6 +379,8 @@ public:
 	bool ENABLE_ACCUMULATIVE_CHECKSUM;
 	// Enable to logging verbose trace events related to the accumulative checksum
 	bool ENABLE_ACCUMULATIVE_CHECKSUM_LOGGING;
+	bool MUTATION_CHECKSUM_REVALIDATE; // Recompute the checksum of a mutation that already has one when serializing it,
+	                                   // to detect the mutation changing in memory
 
 	ClientKnobs(Randomize randomize);
 	void initialize(Randomize randomize);
@@ -72,6 +72,8 @@ struct ProfilerRequest {
 		GPROF = 1,
 		FLOW = 2,
 		GPROF_HEAP = 3,
+		// The network thread's always-on sampling profiler. RUN with a duration of 0 dumps what it has sampled so far.
+		FLOW_SAMPLED = 4,
 	};
 
 	enum class Action : std::int8_t { DISABLE = 0, ENABLE = 1, RUN = 2 };
@@ -0,0 +1,71 @@
+/*
+ * CommitBatchRecording.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FDBCLIENT_COMMITBATCHRECORDING_H
+#define FDBCLIENT_COMMITBATCHRECORDING_H
+#pragma once
+
+#include "fdbclient/CommitTransaction.h"
+#include "fdbclient/FDBTypes.h"
+#include "flow/flow.h"
+
+// A commit batch as a commit proxy received it, with the versions it was committed between. A recording is a file of
+// batches, each stored as a 4 byte little endian length followed by the batch serialized with IncludeVersion(), so
+// the commit pipeline can be replayed offline (see flowbench/BenchCommitReplay.cpp).
+struct RecordedCommitBatchRef {
+	constexpr static FileIdentifier file_identifier = 2870453;
+
+	Version prevVersion = invalidVersion;
+	Version version = invalidVersion;
+	VectorRef<CommitTransactionRef> transactions;
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, prevVersion, version, transactions);
+	}
+};
+
+// Returns the record of a batch to append to a recording
+Standalone<StringRef> encodeRecordedCommitBatch(RecordedCommitBatchRef const& batch);
+
+// Returns the batches of a recording, in the order they were recorded. A truncated last record, as left by a process
+// that died while recording, is ignored.
+Standalone<VectorRef<RecordedCommitBatchRef>> decodeCommitBatchRecording(Standalone<StringRef> const& recording);
+
+// Appends the batches of a commit proxy to a recording in the background, until the recording reaches maxBytes. Batches
+// that arrive while more than maxPendingBytes are waiting to be written are dropped rather than delaying commits.
+struct CommitBatchRecorder : NonCopyable {
+	UID id;
+	std::string path;
+	int64_t maxBytes;
+	int64_t maxPendingBytes;
+	int64_t recordedBytes = 0; // written or waiting to be written
+	int64_t pendingBytes = 0; // waiting to be written
+	int64_t droppedBatches = 0;
+	bool recording = true;
+	PromiseStream<Standalone<StringRef>> records;
+	Future<Void> writer;
+
+	CommitBatchRecorder(UID id, std::string const& path, int64_t maxBytes, int64_t maxPendingBytes);
+
+	void record(RecordedCommitBatchRef const& batch);
+};
+
+#endif
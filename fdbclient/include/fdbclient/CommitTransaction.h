@@ -275,7 +275,16 @@ struct MutationRef {
 		}
 	}
 
+	// The 32 bits checksum of the type and params
+	uint32_t calculateChecksum() const {
+		uint32_t crc = static_cast<uint32_t>(this->type);
+		crc = crc32c_append(crc, this->param1.begin(), this->param1.size());
+		return crc32c_append(crc, this->param2.begin(), this->param2.size());
+	}
+
 	// Generate 32 bits checksum and set it to this->checksum
+	// A checksum that is already populated is kept as is, as the mutation is serialized once for every tlog it goes
+	// to, unless MUTATION_CHECKSUM_REVALIDATE asks to recompute it to catch the mutation changing in memory.
 	void populateChecksum() {
 		if (!CLIENT_KNOBS->ENABLE_MUTATION_CHECKSUM) {
 			return;
@@ -288,9 +297,10 @@ struct MutationRef {
 			    .detail("Mutation", toString());
 			this->corrupted = true;
 		}
-		uint32_t crc = static_cast<uint32_t>(this->type);
-		crc = crc32c_append(crc, this->param1.begin(), this->param1.size());
-		crc = crc32c_append(crc, this->param2.begin(), this->param2.size());
+		if (this->checksum.present() && !CLIENT_KNOBS->MUTATION_CHECKSUM_REVALIDATE) {
+			return;
+		}
+		uint32_t crc = calculateChecksum();
 		if (this->checksum.present() && this->checksum.get() != crc) {
 			TraceEvent(SevError, "MutationRefUnexpectedError")
 			    .setMaxFieldLength(-1)
@@ -316,9 +326,7 @@ struct MutationRef {
 		if (!this->checksum.present()) {
 			return true;
 		}
-		uint32_t crc = static_cast<uint32_t>(this->type);
-		crc = crc32c_append(crc, this->param1.begin(), this->param1.size());
-		crc = crc32c_append(crc, this->param2.begin(), this->param2.size());
+		uint32_t crc = calculateChecksum();
 		if (crc != static_cast<uint32_t>(this->checksum.get())) {
 			TraceEvent(SevError, "MutationRefUnexpectedError")
 			    .setMaxFieldLength(-1)
@@ -501,6 +509,23 @@ struct MutationRef {
 		return MutationRef(Encrypted, serializedHeader, payload);
 	}
 
+	// Encrypts with an encryptor the caller reuses across the mutations of one encryption domain, under an IV of the
+	// mutation's own
+	MutationRef encrypt(EncryptBlobCipherAes265Ctr& cipher, Arena& arena, double* encryptionTime = nullptr) const {
+		uint8_t iv[AES_256_IV_LENGTH] = { 0 };
+		deterministicRandom()->randomBytes(iv, AES_256_IV_LENGTH);
+		cipher.resetIV(iv, AES_256_IV_LENGTH);
+		BinaryWriter bw(AssumeVersion(ProtocolVersion::withEncryptionAtRest()));
+		bw << *this;
+
+		BlobCipherEncryptHeaderRef header;
+		auto payload =
+		    cipher.encrypt(static_cast<const uint8_t*>(bw.getData()), bw.getLength(), &header, arena, encryptionTime);
+		Standalone<StringRef> serializedHeader = BlobCipherEncryptHeaderRef::toStringRef(header);
+		arena.dependsOn(serializedHeader.arena());
+		return MutationRef(Encrypted, serializedHeader, payload);
+	}
+
 	MutationRef encryptMetadata(const std::unordered_map<EncryptCipherDomainId, Reference<BlobCipherKey>>& cipherKeys,
 	                            Arena& arena,
 	                            BlobCipherMetrics::UsageType usageType,
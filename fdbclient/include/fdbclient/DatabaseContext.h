@@ -72,6 +72,8 @@ struct LocationInfo : MultiInterface<ReferencedInterface<StorageServerInterface>
 	LocationInfo& operator=(const LocationInfo&) = delete;
 	LocationInfo& operator=(LocationInfo&&) = delete;
 	bool hasCaches = false;
+	// When the location cache last returned this location, for choosing what to evict
+	double lastAccessTime = 0;
 	Reference<Locations> locations() { return Reference<Locations>::addRef(this); }
 };
 
@@ -175,6 +177,8 @@ struct ChangeFeedStorageData : ReferenceCounted<ChangeFeedStorageData> {
 	~ChangeFeedStorageData();
 };
 
+struct BlobConnectionProvider;
+
 struct ChangeFeedData : ReferenceCounted<ChangeFeedData> {
 	PromiseStream<Standalone<VectorRef<MutationsAndVersionRef>>> mutations;
 	std::vector<ReplyPromiseStream<ChangeFeedStreamReply>> streams;
@@ -193,6 +197,10 @@ struct ChangeFeedData : ReferenceCounted<ChangeFeedData> {
 	Version popVersion =
 	    invalidVersion; // like TLog pop version, set by SS and client can check it to see if they missed data
 	double created = 0;
+	// If set, a stream that starts far behind the latest version reads the old mutations from the delta files of the
+	// blob granules in this store instead of from the storage servers. Mutations read from delta files have the same
+	// effect once applied, but may not match the committed mutations exactly, e.g. clears can be split or merged.
+	Reference<BlobConnectionProvider> catchUpBlobStore;
 
 	explicit ChangeFeedData(DatabaseContext* context = nullptr);
 	~ChangeFeedData();
@@ -616,6 +624,10 @@ public:
 	Counter transactionsCommitCompleted;
 	Counter transactionKeyServerLocationRequests;
 	Counter transactionKeyServerLocationRequestsCompleted;
+	Counter locationCacheHits;
+	Counter locationCacheMisses;
+	Counter locationCacheInvalidations; // cached locations found stale and dropped
+	Counter locationCacheEvictions;
 	Counter transactionBlobGranuleLocationRequests;
 	Counter transactionBlobGranuleLocationRequestsCompleted;
 	Counter transactionStatusRequests;
@@ -655,6 +667,8 @@ public:
 	Counter feedPopsFallback;
 
 	DDSketch<double> latencies, readLatencies, commitLatencies, GRVLatencies, mutationsPerCommit, bytesPerCommit;
+	DDSketch<double> getRangeLatencies, locationLatencies;
+	double latenciesStartTime = 0; // when the latency sketches were last cleared by the database logger
 
 	int outstandingWatches;
 	int maxOutstandingWatches;
@@ -827,6 +841,10 @@ public:
 	// and the client should back off more significantly than transaction-level errors.
 	void updateBackoff(const Error& err);
 
+	// Watches waiting to be registered together with one storage team as a WatchValuesRequest, keyed by the location of
+	// the team and the tenant
+	std::map<std::pair<struct LocationInfo*, int64_t>, std::shared_ptr<struct WatchValuesBatch>> pendingWatchValues;
+
 private:
 	using WatchMapKey = std::pair<int64_t, Key>;
 	using WatchMapKeyHasher = boost::hash<WatchMapKey>;
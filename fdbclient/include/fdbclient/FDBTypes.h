@@ -1732,6 +1732,8 @@ FDB_BOOLEAN_PARAM(CacheResult);
 // cacheResult determines whether the storage engine cache for this read
 // consistencyCheckStartVersion indicates the consistency check which began at this version
 // debugID helps to trace the path of the read
+// maxStaleVersions lets a storage server lagging the read version by at most this many versions serve the read at its
+// latest version instead of waiting to catch up
 struct ReadOptions {
 	ReadType type;
 	// Once CacheResult is serializable, change type from bool to CacheResult
@@ -1739,6 +1741,7 @@ struct ReadOptions {
 	bool lockAware = false;
 	Optional<UID> debugID;
 	Optional<Version> consistencyCheckStartVersion;
+	Optional<Version> maxStaleVersions;
 
 	ReadOptions(Optional<UID> debugID = Optional<UID>(),
 	            ReadType type = ReadType::NORMAL,
@@ -1750,7 +1753,7 @@ struct ReadOptions {
 
 	template <class Ar>
 	void serialize(Ar& ar) {
-		serializer(ar, type, cacheResult, debugID, consistencyCheckStartVersion, lockAware);
+		serializer(ar, type, cacheResult, debugID, consistencyCheckStartVersion, lockAware, maxStaleVersions);
 	}
 };
 
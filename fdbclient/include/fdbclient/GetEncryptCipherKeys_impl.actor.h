@@ -128,6 +128,42 @@ Future<EKPGetLatestBaseCipherKeysReply> _getUncachedLatestEncryptCipherKeys(Refe
 	}
 }
 
+// Fetches the latest cipher keys of domains whose cached keys are about to need a refresh and puts them in the cache,
+// so that callers keep being served from the cache instead of blocking on EncryptKeyProxy once the keys reach
+// refreshAt. Failures are left to the blocking path to handle.
+ACTOR template <class T>
+Future<Void> _refreshAheadLatestEncryptCipherKeys(Reference<AsyncVar<T> const> db,
+                                                  EKPGetLatestBaseCipherKeysRequest request,
+                                                  BlobCipherMetrics::UsageType usageType) {
+	state Reference<BlobCipherKeyCache> cipherKeyCache = BlobCipherKeyCache::getInstance();
+	try {
+		loop choose {
+			when(EKPGetLatestBaseCipherKeysReply reply =
+			         wait(_getUncachedLatestEncryptCipherKeys(db, request, usageType))) {
+				for (const EKPBaseCipherDetails& details : reply.baseCipherDetails) {
+					cipherKeyCache->insertCipherKey(details.encryptDomainId,
+					                                details.baseCipherId,
+					                                details.baseCipherKey.begin(),
+					                                details.baseCipherKey.size(),
+					                                details.baseCipherKCV,
+					                                details.refreshAt,
+					                                details.expireAt);
+				}
+				break;
+			}
+			when(wait(_onEncryptKeyProxyChange(db))) {}
+		}
+	} catch (Error& e) {
+		if (e.code() == error_code_actor_cancelled) {
+			throw;
+		}
+		TraceEvent(SevWarn, "GetLatestEncryptCipherKeysRefreshAheadFailed")
+		    .error(e)
+		    .detail("UsageType", toString(usageType));
+	}
+	return Void();
+}
+
 ACTOR template <class T>
 Future<std::unordered_map<EncryptCipherDomainId, Reference<BlobCipherKey>>> _getLatestEncryptCipherKeysImpl(
     Reference<AsyncVar<T> const> db,
@@ -142,15 +178,30 @@ Future<std::unordered_map<EncryptCipherDomainId, Reference<BlobCipherKey>>> _get
 		throw encrypt_ops_error();
 	}
 
-	// Collect cached cipher keys.
+	// Collect cached cipher keys. Keys that will need a refresh soon are still used, but get refreshed in the
+	// background unless a refresh of the domain is already in flight.
+	EKPGetLatestBaseCipherKeysRequest refreshAheadRequest;
 	for (auto& domainId : domainIds) {
 		Reference<BlobCipherKey> cachedCipherKey = cipherKeyCache->getLatestCipherKey(domainId);
 		if (cachedCipherKey.isValid()) {
 			cipherKeys[domainId] = cachedCipherKey;
+			if (cachedCipherKey->needsRefreshWithin(FLOW_KNOBS->ENCRYPT_KEY_REFRESH_AHEAD)) {
+				auto itr = cipherKeyCache->refreshAheadFetches.find(domainId);
+				if (itr == cipherKeyCache->refreshAheadFetches.end() || itr->second.isReady()) {
+					refreshAheadRequest.encryptDomainIds.emplace_back(domainId);
+				}
+			}
 		} else {
 			request.encryptDomainIds.emplace_back(domainId);
 		}
 	}
+	if (!refreshAheadRequest.encryptDomainIds.empty()) {
+		BlobCipherMetrics::getInstance()->latestCipherKeyRefreshAhead += refreshAheadRequest.encryptDomainIds.size();
+		Future<Void> refresh = _refreshAheadLatestEncryptCipherKeys(db, refreshAheadRequest, usageType);
+		for (auto domainId : refreshAheadRequest.encryptDomainIds) {
+			cipherKeyCache->refreshAheadFetches[domainId] = refresh;
+		}
+	}
 	if (request.encryptDomainIds.empty()) {
 		return cipherKeys;
 	}
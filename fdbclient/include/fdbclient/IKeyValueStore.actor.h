@@ -110,6 +110,22 @@ public:
 	// Returns the amount of free and total space for this store, in bytes
 	virtual StorageBytes getStorageBytes() const = 0;
 
+	// Returns the bytes of written but not yet flushed data the store holds in memory, e.g. RocksDB memtables.
+	virtual int64_t getWriteBufferBytes() const { return 0; }
+
+	// Returns how much background work (e.g. compaction) is competing with foreground reads, in [0, 1].
+	virtual double getIOPressure() const { return 0.0; }
+
+	// Returns the recent hit rate of the store's page or block cache, in [0, 1], or -1 if it does not know it.
+	virtual double getCacheHitRate() const { return -1.0; }
+
+	// Returns the bytes the store estimates it holds between each of boundaries and the next, from its own structure
+	// rather than by reading the keys, or an empty vector if it cannot. The estimates include the store's overheads and
+	// compression, so only their proportions to each other are meaningful.
+	virtual Future<std::vector<int64_t>> getApproximateRangeSizes(Standalone<VectorRef<KeyRef>> boundaries) {
+		return std::vector<int64_t>();
+	}
+
 	virtual void logRecentRocksDBBackgroundWorkStats(UID ssId, std::string logReason) { throw not_implemented(); }
 
 	virtual void resyncLog() {}
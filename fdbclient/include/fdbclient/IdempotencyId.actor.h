@@ -169,7 +169,11 @@ static_assert(sizeof(IdempotencyIdRef) == 16);
 struct IdempotencyIdKVBuilder : NonCopyable {
 	IdempotencyIdKVBuilder();
 	void setCommitVersion(Version commitVersion);
-	// All calls to add must share the same high order byte of batchIndex (until the next call to buildAndClear)
+	// Write the ids of a kv pair whose ids all have the same length in the compact format described in
+	// design/idempotency_ids.md. Readers older than the compact format cannot decode it.
+	void setCompactEncoding(bool compactEncoding);
+	// All calls to add must share the same high order byte of batchIndex (until the next call to buildAndClear), and be
+	// made in increasing order of batchIndex
 	void add(const IdempotencyIdRef& id, uint16_t batchIndex);
 	// Must call setCommitVersion before calling buildAndClear. After calling buildAndClear, this object is ready to
 	// start a new kv pair for the high order byte of batchIndex.
@@ -184,9 +188,16 @@ private:
 // Check if id is present in kv, and if so return the commit version and batchIndex
 Optional<CommitResult> kvContainsIdempotencyId(const KeyValueRef& kv, const IdempotencyIdRef& id);
 
+// The idempotency ids in the value of an idempotency key and the low order bytes of their batch indexes, in order of
+// batch index. The ids reference value.
+std::vector<std::pair<StringRef, uint8_t>> decodeIdempotencyValue(ValueRef value, int64_t& timestamp);
+
 // Make a range containing only the idempotency key associated with version and highOrderBatchIndex
 KeyRangeRef makeIdempotencySingleKeyRange(Arena& arena, Version version, uint8_t highOrderBatchIndex);
 
+// Make a range containing all the idempotency keys associated with version
+KeyRangeRef makeIdempotencyVersionRange(Arena& arena, Version version);
+
 void decodeIdempotencyKey(KeyRef key, Version& commitVersion, uint8_t& highOrderBatchIndex);
 
 ACTOR Future<JsonBuilderObject> getIdmpKeyStatus(Database db);
@@ -81,6 +81,52 @@ public:
 	Key mapEnd;
 };
 
+// Finds the ranges of a KeyRangeMap containing a series of keys, starting each search from the range the previous key
+// was in. For keys in ascending or nearly ascending order, most lookups then take a comparison or two rather than a
+// search from the root of the map. The map must not change while the cursor is in use.
+template <class Val, class Metric = int, class MetricFunc = ConstantMetric<Metric>>
+class KeyRangeMapCursor {
+public:
+	using Map = KeyRangeMap<Val, Metric, MetricFunc>;
+	using iterator = typename Map::iterator;
+
+	// maxSteps bounds how many ranges the cursor moves forward before searching the map instead
+	explicit KeyRangeMapCursor(Map& map, int maxSteps = 4)
+	  : map(map), last(map.ranges().end()), maxSteps(maxSteps) {}
+
+	// The same as map.rangeContaining(key)
+	iterator rangeContaining(KeyRef key) {
+		if (found && key >= begin) {
+			for (int step = 0; step <= maxSteps; step++) {
+				if (key < end) {
+					return current;
+				}
+				++current;
+				if (current == last) {
+					break;
+				}
+				begin = end;
+				end = current.end();
+			}
+		}
+		current = map.rangeContaining(key);
+		found = current != last;
+		if (found) {
+			begin = current.begin();
+			end = current.end();
+		}
+		return current;
+	}
+
+private:
+	Map& map;
+	const iterator last;
+	const int maxSteps;
+	bool found = false;
+	iterator current;
+	KeyRef begin, end; // Of current, and owned by the map
+};
+
 template <class Val, class Metric = int, class MetricFunc = ConstantMetric<Metric>>
 class CoalescedKeyRefRangeMap : public RangeMap<KeyRef, Val, KeyRangeRef, Metric, MetricFunc>, NonCopyable {
 public:
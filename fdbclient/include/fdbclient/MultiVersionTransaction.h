@@ -1165,6 +1165,61 @@ public:
 	friend class MultiVersionTransaction;
 };
 
+// An implementation of IDatabase that spreads the transactions of one database object over several client threads.
+// It wraps one MultiVersionDatabase per thread and hands out transactions and tenants from each in turn, so that a
+// single database object can use more than one core of client work. Administrative operations go to the first thread.
+// Each thread keeps its own connections and location cache, since the threads run separate copies of the client
+// library; the GRV cache is shared between them through the cluster shared state.
+class MultiThreadDatabase final : public IDatabase, ThreadSafeReferenceCounted<MultiThreadDatabase> {
+public:
+	// threadIds[i] is the client thread that databases[i] runs on
+	MultiThreadDatabase(std::vector<Reference<IDatabase>> databases, std::vector<int> threadIds);
+	~MultiThreadDatabase() override;
+
+	Reference<ITenant> openTenant(TenantNameRef tenantName) override;
+	Reference<ITransaction> createTransaction() override;
+	void setOption(FDBDatabaseOptions::Option option, Optional<StringRef> value = Optional<StringRef>()) override;
+
+	// The busyness of the busiest thread
+	double getMainThreadBusyness() override;
+
+	ThreadFuture<ProtocolVersion> getServerProtocol(
+	    Optional<ProtocolVersion> expectedVersion = Optional<ProtocolVersion>()) override;
+
+	void addref() override { ThreadSafeReferenceCounted<MultiThreadDatabase>::addref(); }
+	void delref() override { ThreadSafeReferenceCounted<MultiThreadDatabase>::delref(); }
+
+	ThreadFuture<int64_t> rebootWorker(const StringRef& address, bool check, int duration) override;
+	ThreadFuture<Void> forceRecoveryWithDataLoss(const StringRef& dcid) override;
+	ThreadFuture<Void> createSnapshot(const StringRef& uid, const StringRef& snapshot_command) override;
+
+	ThreadFuture<Key> purgeBlobGranules(const KeyRangeRef& keyRange, Version purgeVersion, bool force) override;
+	ThreadFuture<Void> waitPurgeGranulesComplete(const KeyRef& purgeKey) override;
+
+	ThreadFuture<bool> blobbifyRange(const KeyRangeRef& keyRange) override;
+	ThreadFuture<bool> blobbifyRangeBlocking(const KeyRangeRef& keyRange) override;
+	ThreadFuture<bool> unblobbifyRange(const KeyRangeRef& keyRange) override;
+	ThreadFuture<Standalone<VectorRef<KeyRangeRef>>> listBlobbifiedRanges(const KeyRangeRef& keyRange,
+	                                                                      int rangeLimit) override;
+	ThreadFuture<Version> verifyBlobRange(const KeyRangeRef& keyRange, Optional<Version> version) override;
+	ThreadFuture<bool> flushBlobRange(const KeyRangeRef& keyRange, bool compact, Optional<Version> version) override;
+
+	ThreadFuture<DatabaseSharedState*> createSharedState() override;
+	void setSharedState(DatabaseSharedState* p) override;
+
+	// Return a JSON string containing the client-side status information of the first thread
+	ThreadFuture<Standalone<StringRef>> getClientStatus() override;
+
+private:
+	// Picks the database of the next thread in turn, and counts the transaction or tenant against it
+	Reference<IDatabase> const& nextDatabase();
+
+	const std::vector<Reference<IDatabase>> databases;
+	const std::vector<int> threadIds;
+	std::atomic<uint32_t> next;
+	std::unique_ptr<std::atomic<int64_t>[]> transactionsStarted;
+};
+
 // An implementation of IClientApi that can choose between multiple different client implementations either provided
 // locally within the primary loaded fdb_c client or through any number of dynamically loaded clients.
 //
@@ -1250,6 +1305,7 @@ private:
 
 	int nextThread = 0;
 	int threadCount;
+	int threadsPerDatabase = 1;
 	std::string tmpDir;
 	bool traceShareBaseNameAmongThreads;
 	std::string traceFileIdentifier;
@@ -45,6 +45,7 @@ struct RangeResultBlock {
 	uint8_t hash; // points back to the PipelinedReader
 	int prefixLen; // size of keyspace, uid, and hash prefix
 	int indexToRead; // index of first unconsumed record
+	int64_t prefetchBytes; // bytes taken from the MutationLogReader's prefetch budget, released once consumed
 
 	// When the consumer reads, provides (partial) RangeResult, from firstVersion to min(lastVersion, firstVersion
 	// rounded up to the nearest 1M), to ensure that no versions out of this RangeResultBlock can be in between.
@@ -59,18 +60,21 @@ struct RangeResultBlock {
 };
 
 // PipelinedReader is the class actually doing range read (getRange). A MutationLogReader has 256 PipelinedReaders, each
-// in charge of one hash value from 0-255.
+// in charge of one hash value from 0-255. A reader can always read the block the consumer needs next from it, but
+// reading ahead of that takes from the prefetch budget shared by all readers, which bounds the memory of a
+// MutationLogReader regardless of its pipeline depth.
 class PipelinedReader {
 public:
-	PipelinedReader(uint8_t h, Version bv, Version ev, unsigned pd, Key p)
+	PipelinedReader(uint8_t h, Version bv, Version ev, unsigned pd, Key p, FlowLock* prefetchLimit)
 	  : readerLimit(pd), hash(h), prefix(StringRef(&hash, sizeof(uint8_t)).withPrefix(p)), beginVersion(bv),
-	    endVersion(ev), currentBeginVersion(bv), pipelineDepth(pd) {}
+	    endVersion(ev), currentBeginVersion(bv), pipelineDepth(pd), prefetchLimit(prefetchLimit) {}
 
 	void startReading(Database cx);
 	Future<Void> getNext(Database cx);
 	ACTOR static Future<Void> getNext_impl(PipelinedReader* self, Database cx);
 
-	void release() { readerLimit.release(); }
+	// Called when the consumer is done with a block read by this reader
+	void release(const RangeResultBlock& block);
 
 	PromiseStream<RangeResultBlock> reads;
 	FlowLock readerLimit;
@@ -83,6 +87,9 @@ private:
 	[[maybe_unused]] Version beginVersion;
 	Version endVersion, currentBeginVersion;
 	[[maybe_unused]] unsigned pipelineDepth;
+	FlowLock* prefetchLimit;
+	int unconsumed = 0; // blocks sent but not yet released
+	AsyncTrigger drained; // triggered when the last unconsumed block is released
 	Future<Void> reader;
 };
 
@@ -98,12 +105,13 @@ class MutationLogReader : public ReferenceCounted<MutationLogReader> {
 public:
 	MutationLogReader() : finished(256) {}
 	MutationLogReader(Database cx, Version bv, Version ev, Key uid, Key beginKey, unsigned pd)
-	  : beginVersion(bv), endVersion(ev), prefix(uid.withPrefix(beginKey)), pipelineDepth(pd), finished(0) {
+	  : prefetchLimit(CLIENT_KNOBS->MUTATION_LOG_READER_PREFETCH_BYTES), beginVersion(bv), endVersion(ev),
+	    prefix(uid.withPrefix(beginKey)), pipelineDepth(pd), finished(0) {
 		pipelinedReaders.reserve(256);
 		if (pipelineDepth > 0) {
 			for (int h = 0; h < 256; ++h) {
 				pipelinedReaders.emplace_back(new mutation_log_reader::PipelinedReader(
-				    (uint8_t)h, beginVersion, endVersion, pipelineDepth, prefix));
+				    (uint8_t)h, beginVersion, endVersion, pipelineDepth, prefix, &prefetchLimit));
 				pipelinedReaders[h]->startReading(cx);
 			}
 		}
@@ -126,6 +134,8 @@ private:
 	ACTOR static Future<Void> initializePQ(MutationLogReader* self);
 	ACTOR static Future<Standalone<RangeResultRef>> getNext_impl(MutationLogReader* self);
 
+	// Declared before the readers so that it outlives their actors
+	FlowLock prefetchLimit;
 	std::vector<std::unique_ptr<mutation_log_reader::PipelinedReader>> pipelinedReaders;
 	std::priority_queue<mutation_log_reader::RangeResultBlock> priorityQueue;
 	Version beginVersion, endVersion;
@@ -166,6 +166,7 @@ struct TransactionOptions {
 	bool bypassStorageQuota : 1;
 	bool enableReplicaConsistencyCheck : 1;
 	int requiredReplicas;
+	int readParallelShards; // range reads read this many shards at once when more than one
 
 	TransactionPriority priority;
 
@@ -223,6 +224,32 @@ struct TransactionLogInfo : public ReferenceCounted<TransactionLogInfo>, NonCopy
 	std::string identifier;
 };
 
+// Where the time of a transaction went, recorded in process when it sets the RECORD_TIMELINE option. Events are kept
+// across retries, and are read back through the special keys in transactionTimelineRange.
+struct TransactionTimeline : public ReferenceCounted<TransactionTimeline>, NonCopyable {
+	struct Event {
+		const char* name;
+		double start; // seconds since the timeline began
+		double duration;
+		std::string detail;
+	};
+
+	explicit TransactionTimeline(double startTime) : startTime(startTime) {}
+
+	// Records an event that began at eventStart and ends now
+	void add(const char* name, double eventStart, std::string detail = std::string()) {
+		if (events.size() >= CLIENT_KNOBS->TRANSACTION_TIMELINE_MAX_EVENTS) {
+			++droppedEvents;
+			return;
+		}
+		events.push_back(Event{ name, eventStart - startTime, now() - eventStart, std::move(detail) });
+	}
+
+	double startTime;
+	std::vector<Event> events;
+	int droppedEvents = 0;
+};
+
 struct Watch : public ReferenceCounted<Watch>, NonCopyable {
 	Key key;
 	Optional<Value> value;
@@ -308,8 +335,15 @@ struct TransactionState : ReferenceCounted<TransactionState> {
 	// prefix/<key2> : '0' - any keys equal or larger than this key are (definitely) not conflicting keys
 	std::shared_ptr<CoalescedKeyRangeMap<Value>> conflictingKeys;
 
+	// Set by FDBTransactionOptions::RECORD_TIMELINE
+	Reference<TransactionTimeline> timeline;
+
 	bool automaticIdempotency = false;
 
+	// Point reads waiting to be sent together to one storage team as a GetValuesRequest, keyed by the location of the
+	// team and whether the reads use the tenant
+	std::map<std::pair<struct LocationInfo*, bool>, std::shared_ptr<struct GetValuesBatch>> pendingGetValues;
+
 	Future<Void> startFuture;
 
 	// Only available so that Transaction can have a default constructor, for use in state variables
@@ -30,6 +30,8 @@
 #include "flow/WipedString.h"
 #include <list>
 
+class SpecialKeyRangeReadImpl;
+
 // SOMEDAY: Optimize getKey to avoid using getRange
 
 struct ReadYourWritesTransactionOptions {
@@ -160,7 +162,7 @@ public:
 	[[nodiscard]] Future<Void> onError(Error const& e) override;
 
 	// These are to permit use as state variables in actors:
-	ReadYourWritesTransaction() : cache(&arena), writes(&arena) {}
+	ReadYourWritesTransaction() : cache(&arena), writes(&arena), deferringWrites(false) {}
 	void operator=(ReadYourWritesTransaction&& r) noexcept;
 	ReadYourWritesTransaction(ReadYourWritesTransaction&& r) noexcept;
 
@@ -199,6 +201,11 @@ public:
 	bool specialKeySpaceChangeConfiguration() const { return options.specialKeySpaceChangeConfiguration; }
 
 	KeyRangeMap<std::pair<bool, Optional<Value>>>& getSpecialKeySpaceWriteMap() { return specialKeySpaceWriteMap; }
+	// The whole results of the asynchronous special key space modules this transaction has read, with the approximate
+	// size of the transaction when they were read, so that paging through a module does not compute it again
+	std::unordered_map<const SpecialKeyRangeReadImpl*, std::pair<int64_t, RangeResult>>& getSpecialKeySpaceReadCache() {
+		return specialKeySpaceReadCache;
+	}
 	bool readYourWritesDisabled() const { return options.readYourWritesDisabled; }
 	const Optional<std::string>& getSpecialKeySpaceErrorMsg() { return specialKeySpaceErrorMsg; }
 	void setSpecialKeySpaceErrorMsg(const std::string& msg) {
@@ -234,6 +241,16 @@ private:
 	Transaction tr;
 	SnapshotCache cache;
 	WriteMap writes;
+
+	// Until the transaction first reads or watches, writes are only logged here (in arena) and the write map is not
+	// built. A write-only transaction is sent to the commit proxy straight from this log.
+	struct DeferredWrite {
+		MutationRef mutation; // NoOp for a write conflict range without a mutation
+		AddConflictRange addConflict;
+	};
+	std::vector<DeferredWrite> deferredWrites;
+	bool deferringWrites;
+
 	CoalescedKeyRefRangeMap<bool> readConflicts;
 	Map<Key, std::vector<Reference<Watch>>> watchMap; // Keys that are being watched in this transaction
 	Promise<Void> resetPromise;
@@ -255,6 +272,7 @@ private:
 	Reference<TransactionDebugInfo> transactionDebugInfo;
 
 	KeyRangeMap<std::pair<bool, Optional<Value>>> specialKeySpaceWriteMap;
+	std::unordered_map<const SpecialKeyRangeReadImpl*, std::pair<int64_t, RangeResult>> specialKeySpaceReadCache;
 	Optional<std::string> specialKeySpaceErrorMsg;
 
 	void resetTimeout();
@@ -263,6 +281,8 @@ private:
 	    KeyRangeRef const& keys,
 	    WriteMap::iterator& it); // pre: it.segmentContains(keys.begin), keys are already inside this->arena
 	void writeRangeToNativeTransaction(KeyRangeRef const& keys);
+	void materializeWrites(); // moves the deferred writes into the write map and stops deferring
+	void writeDeferredToNativeTransaction();
 
 	void resetRyow(); // doesn't reset the encapsulated transaction, or creation time/retry state
 	KeyRef getMaxReadKey();
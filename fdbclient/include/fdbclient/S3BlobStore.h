@@ -94,6 +94,7 @@ public:
 		Counter expiredConnections;
 		Counter reusedConnections;
 		Counter fastRetries;
+		Counter throttledRequests;
 
 		LatencySample requestLatency;
 
@@ -104,7 +105,7 @@ public:
 		    requestsSuccessful("RequestsSuccessful", cc), requestsFailed("RequestsFailed", cc),
 		    newConnections("NewConnections", cc), expiredConnections("ExpiredConnections", cc),
 		    reusedConnections("ReusedConnections", cc), fastRetries("FastRetries", cc),
-		    requestLatency("BlobStoreRequestLatency",
+		    throttledRequests("ThrottledRequests", cc), requestLatency("BlobStoreRequestLatency",
 		                   id,
 		                   CLIENT_KNOBS->BLOBSTORE_LATENCY_LOGGING_INTERVAL,
 		                   CLIENT_KNOBS->BLOBSTORE_LATENCY_LOGGING_ACCURACY) {}
@@ -306,6 +307,14 @@ public:
 	FlowLock concurrentUploads;
 	FlowLock concurrentLists;
 
+	// Permits of concurrentRequests held back while the endpoint throttles requests. Each throttled response holds
+	// back half of the permits still in use, and each window of successful requests gives one back.
+	int64_t withheldRequests = 0;
+	double withheldRequestCredit = 0;
+	Future<Void> withholdingRequests;
+	void onRequestSucceeded();
+	void onRequestThrottled();
+
 	Future<Void> updateSecret();
 
 	// Calculates the authentication string from the secret key
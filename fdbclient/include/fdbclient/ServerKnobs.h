@@ -68,6 +68,9 @@ public:
 	                                              // message (measured in 1/1024ths, e.g. a value of 2048 yields a
 	                                              // factor of 2).
 	int64_t VERSION_MESSAGES_ENTRY_BYTES_WITH_OVERHEAD;
+	int TAG_MESSAGE_INDEX_OVERHEAD_FACTOR_1024THS; // As VERSION_MESSAGES_OVERHEAD_FACTOR_1024THS, for the TagMessageIndex
+	                                               // the current TLog keeps its per-tag messages in.
+	int64_t TAG_MESSAGE_INDEX_ENTRY_BYTES_WITH_OVERHEAD;
 	int64_t TLOG_POPPED_VER_LAG_THRESHOLD_FOR_TLOGPOP_TRACE;
 	bool ENABLE_DETAILED_TLOG_POP_TRACE;
 	double TLOG_MESSAGE_BLOCK_OVERHEAD_FACTOR;
@@ -76,21 +79,35 @@ public:
 	int LOG_SYSTEM_PUSHED_DATA_BLOCK_SIZE;
 	double PEEK_TRACKER_EXPIRATION_TIME;
 	int PARALLEL_GET_MORE_REQUESTS;
+	bool PEEK_ADAPTIVE_PARALLEL_GET_MORE; // Size parallel peeks by reply latency and consumption, up to the above
 	int MULTI_CURSOR_PRE_FETCH_LIMIT;
 	int64_t MAX_QUEUE_COMMIT_BYTES;
+	double TLOG_GROUP_COMMIT_WINDOW_FRACTION; // While disk queue commits run back to back, wait this fraction of the
+	                                          // smoothed commit time before the next one to merge more versions into it
+	double TLOG_GROUP_COMMIT_MAX_WINDOW; // Upper bound in seconds on that wait
 	int DESIRED_OUTSTANDING_MESSAGES;
 	double DESIRED_GET_MORE_DELAY;
 	int CONCURRENT_LOG_ROUTER_READS;
 	int LOG_ROUTER_PEEK_FROM_SATELLITES_PREFERRED; // 0==peek from primary, non-zero==peek from satellites
 	double LOG_ROUTER_PEEK_SWITCH_DC_TIME;
+	int64_t LOG_ROUTER_PREFETCH_BYTES; // How far a log router pulls from the primary ahead of what remote tLogs can take
 	double DISK_QUEUE_ADAPTER_MIN_SWITCH_TIME;
 	double DISK_QUEUE_ADAPTER_MAX_SWITCH_TIME;
 	int64_t TLOG_SPILL_REFERENCE_MAX_PEEK_MEMORY_BYTES;
 	int64_t TLOG_SPILL_REFERENCE_MAX_BATCHES_PER_PEEK;
 	int64_t TLOG_SPILL_REFERENCE_MAX_BYTES_PER_BATCH;
+	int64_t TLOG_SPILL_READ_AHEAD_BYTES; // A peek of data spilled by reference reads commits this close together, and
+	                                     // this far past the last one it needs, in one read. 0 reads each on its own.
+	int64_t TLOG_SPILL_READ_AHEAD_CACHE_BYTES; // Memory for commits read ahead, shared by all tags being peeked
+	std::string TLOG_PEEK_COMPRESSION_FILTER; // Peek cursors ask TLogs to compress replies with this, if not NONE
+	int TLOG_PEEK_COMPRESSION_MIN_BYTES; // TLogs send replies with fewer message bytes than this uncompressed
 	int64_t DISK_QUEUE_FILE_EXTENSION_BYTES; // When we grow the disk queue, by how many bytes should it grow?
 	int64_t DISK_QUEUE_FILE_SHRINK_BYTES; // When we shrink the disk queue, by how many bytes should it shrink?
 	int64_t DISK_QUEUE_MAX_TRUNCATE_BYTES; // A truncate larger than this will cause the file to be replaced instead.
+	std::string TLOG_DISK_QUEUE_STRIPE_FOLDERS; // Comma separated folders, usually on other devices, across which a new
+	                                            // TLog's disk queue is striped along with its data folder
+	int64_t DISK_QUEUE_STRIPE_UNIT_BYTES; // Bytes of a striped disk queue written to one stripe before the next
+	int DISK_QUEUE_RECOVERY_READS; // Reads of up to 1MB a disk queue keeps outstanding while it is being recovered
 	double TLOG_DEGRADED_DURATION;
 	int64_t MAX_CACHE_VERSIONS;
 	double TXS_POPPED_MAX_DELAY;
@@ -133,6 +150,10 @@ public:
 	double RELOCATION_PARALLELISM_PER_SOURCE_SERVER;
 	double RELOCATION_PARALLELISM_PER_DEST_SERVER;
 	double MERGE_RELOCATION_PARALLELISM_PER_TEAM;
+	int64_t DD_ZONE_MOVE_BYTES_PER_SEC; // Bytes/s of relocations DD sends into one zone, 0 for unlimited
+	// Moves at or above this priority are not held back by DD_ZONE_MOVE_BYTES_PER_SEC or
+	// STORAGE_FETCH_SOURCE_BYTES_PER_SEC
+	int DATA_MOVE_BUDGET_PRIORITY_THRESHOLD;
 	int DD_QUEUE_MAX_KEY_SERVERS;
 	int DD_REBALANCE_PARALLELISM;
 	int DD_REBALANCE_RESET_AMOUNT;
@@ -215,6 +236,15 @@ public:
 	// The constant interval DD update pivot values for team selection. It should be >=
 	// min(STORAGE_METRICS_POLLING_DELAY,DETAILED_METRIC_UPDATE_RATE)  otherwise the pivot won't change;
 	double DD_TEAM_PIVOT_UPDATE_DELAY;
+	// Team selection and disk rebalancing compare teams by their load bytes scaled up by how busy their servers are.
+	// Each weight multiplies the utilization, in [0, 1], of the team's busiest server in that dimension. All weights
+	// at 0 compare teams by load bytes alone.
+	double DD_TEAM_COST_CPU_WEIGHT;
+	double DD_TEAM_COST_DISK_BUSY_WEIGHT;
+	double DD_TEAM_COST_READ_OPS_WEIGHT;
+	double DD_TEAM_COST_WRITE_BANDWIDTH_WEIGHT;
+	int64_t DD_TEAM_COST_MAX_READ_OPS_PER_KSEC; // The read ops of a fully utilized storage server
+	int64_t DD_TEAM_COST_MAX_WRITE_BYTES_PER_KSEC; // The write bandwidth of a fully utilized storage server
 
 	bool ALLOW_LARGE_SHARD;
 	int MAX_LARGE_SHARD_BYTES;
@@ -223,6 +253,7 @@ public:
 	bool ENABLE_DD_PHYSICAL_SHARD; // EXPERIMENTAL; If true, SHARD_ENCODE_LOCATION_METADATA must be true.
 	double DD_PHYSICAL_SHARD_MOVE_PROBABILITY; // Percentage of physical shard move, in the range of [0, 1].
 	bool ENABLE_PHYSICAL_SHARD_MOVE_EXPERIMENT;
+	bool DD_PHYSICAL_SHARD_MOVE_BY_DEFAULT; // Move data by physical shard when all storage engines support it
 	int64_t MAX_PHYSICAL_SHARD_BYTES;
 	double PHYSICAL_SHARD_METRICS_DELAY;
 	double ANONYMOUS_PHYSICAL_SHARD_TRANSITION_TIME;
@@ -249,10 +280,18 @@ public:
 	// shard metrics will update immediately
 	int64_t SHARD_READ_OPS_CHANGE_THRESHOLD;
 	bool ENABLE_WRITE_BASED_SHARD_SPLIT; // Experimental. Enable to enforce shard split when write traffic is high
+	bool ENABLE_READ_BASED_SHARD_SPLIT; // Experimental. Enable to split shards when read traffic is high
+	int64_t SHARD_READ_SPLIT_BYTES_PER_KSEC; // Shards reading more bytes than this are split
+	int64_t SHARD_READ_SPLIT_OPS_PER_KSEC; // Shards reading more keys than this are split
+	double SHARD_READ_MERGE_RATIO; // Shards reading more than this fraction of the split thresholds are not merged
+	int SHARD_READ_SPLIT_MIN_BYTES; // The smallest piece a read split creates
 
 	double SHARD_MAX_READ_DENSITY_RATIO;
 	int64_t SHARD_READ_HOT_BANDWIDTH_MIN_PER_KSECONDS;
 	double SHARD_MAX_BYTES_READ_PER_KSEC_JITTER;
+	bool STORAGE_CACHE_AUTO_ADMISSION; // Whether data distribution caches read hot ranges on the storage cache servers
+	int64_t STORAGE_CACHE_AUTO_MAX_BYTES; // Bytes of read hot ranges that may be cached at once, evicting the coldest
+	double STORAGE_CACHE_AUTO_IDLE_TIMEOUT; // Read hot ranges that have not been read hot for this long are uncached
 	double STORAGE_METRIC_TIMEOUT;
 	double METRIC_DELAY;
 	double ALL_DATA_REMOVED_DELAY;
@@ -270,6 +309,10 @@ public:
 	                                                // balanced/filledup before starting the next wiggle.
 	double PERPETUAL_WIGGLE_DELAY; // The max interval between the last wiggle finish and the next wiggle start
 	bool PERPETUAL_WIGGLE_DISABLE_REMOVER; // Whether the start of perpetual wiggle replace team remover
+	bool PERPETUAL_WIGGLE_REBUILD_IN_PLACE; // Wiggle Redwood and RocksDB storage servers of the configured engine by
+	                                        // rebuilding their store on the same disk instead of moving their data
+	double PERPETUAL_WIGGLE_REBUILD_TIMEOUT; // After this long, a storage server rebuilding in place is wiggled by
+	                                         // exclusion instead
 	double LOG_ON_COMPLETION_DELAY;
 	int BEST_TEAM_MAX_TEAM_TRIES;
 	int BEST_TEAM_OPTION_COUNT;
@@ -436,6 +479,9 @@ public:
 	int ROCKSDB_COMPACTION_THREAD_PRIORITY;
 	int ROCKSDB_BACKGROUND_PARALLELISM;
 	int ROCKSDB_READ_PARALLELISM;
+	// Reader threads take reads from a work-stealing pool (see createWorkStealingThreadPool) by read priority, and, in
+	// the sharded engine, keep reads of a physical shard on one thread while it is free
+	bool ROCKSDB_READER_WORK_STEALING;
 	int ROCKSDB_CHECKPOINT_READER_PARALLELISM;
 	int64_t ROCKSDB_MEMTABLE_BYTES;
 	bool ROCKSDB_LEVEL_STYLE_COMPACTION;
@@ -447,9 +493,15 @@ public:
 	int ROCKSDB_BLOOM_BITS_PER_KEY;
 	bool ROCKSDB_BLOOM_WHOLE_KEY_FILTERING;
 	int ROCKSDB_MAX_AUTO_READAHEAD_SIZE;
+	bool ROCKSDB_READ_RANGE_AUTO_READAHEAD_SIZE;
+	int64_t ROCKSDB_READ_RANGE_READAHEAD_MIN_BYTES;
+	int64_t ROCKSDB_READ_RANGE_MAX_READAHEAD_BYTES;
+	bool ROCKSDB_PARTITIONED_INDEX_FILTERS; // Partition index and filter blocks, so only the needed parts are read.
 	int64_t ROCKSDB_BLOCK_CACHE_SIZE;
 	double ROCKSDB_CACHE_HIGH_PRI_POOL_RATIO;
 	bool ROCKSDB_CACHE_INDEX_AND_FILTER_BLOCKS;
+	bool ROCKSDB_SHARE_BLOCK_CACHE;
+	int64_t ROCKSDB_COMPRESSED_SECONDARY_CACHE_SIZE;
 	double ROCKSDB_METRICS_DELAY;
 	double ROCKSDB_READ_VALUE_TIMEOUT;
 	double ROCKSDB_READ_VALUE_PREFIX_TIMEOUT;
@@ -461,17 +513,27 @@ public:
 	int ROCKSDB_READ_QUEUE_HARD_MAX;
 	int ROCKSDB_FETCH_QUEUE_SOFT_MAX;
 	int ROCKSDB_FETCH_QUEUE_HARD_MAX;
+	// Point reads queued in the same run loop iteration are sent to a reader thread together, up to this many, and
+	// read with one MultiGet. 0 reads each key with its own Get.
+	int ROCKSDB_READ_VALUE_BATCH_MAX_KEYS;
+	bool ROCKSDB_READ_VALUE_BATCH_ASYNC_IO; // Lets batched reads use RocksDB's async IO for their block reads
 	// These histograms are in read and write path which can cause performance overhead.
 	// Set to 0 to disable histograms.
 	double ROCKSDB_HISTOGRAMS_SAMPLE_RATE;
 	double ROCKSDB_READ_RANGE_ITERATOR_REFRESH_TIME;
 	bool ROCKSDB_READ_RANGE_REUSE_ITERATORS;
 	bool SHARDED_ROCKSDB_REUSE_ITERATORS;
+	int SHARDED_ROCKSDB_MAX_POOLED_ITERATORS; // Per physical shard cap on idle iterators kept for reuse.
 	bool ROCKSDB_READ_RANGE_REUSE_BOUNDED_ITERATORS;
 	int ROCKSDB_READ_RANGE_BOUNDED_ITERATORS_MAX_LIMIT;
 	int64_t ROCKSDB_WRITE_RATE_LIMITER_BYTES_PER_SEC;
 	int ROCKSDB_WRITE_RATE_LIMITER_FAIRNESS;
 	bool ROCKSDB_WRITE_RATE_LIMITER_AUTO_TUNE;
+	double ROCKSDB_IO_PRESSURE_INTERVAL; // How often the engine samples compaction and stall state.
+	double ROCKSDB_RATE_LIMITER_READ_LATENCY_TARGET; // Mean read latency above which background IO is backed off.
+	double ROCKSDB_RATE_LIMITER_MIN_FRACTION;
+	double ROCKSDB_RATE_LIMITER_BACKOFF;
+	double ROCKSDB_RATE_LIMITER_RECOVERY;
 	std::string DEFAULT_FDB_ROCKSDB_COLUMN_FAMILY;
 	bool ROCKSDB_DISABLE_AUTO_COMPACTIONS;
 	bool ROCKSDB_PERFCONTEXT_ENABLE; // Enable rocks perf context metrics. May cause performance overhead
@@ -556,6 +618,19 @@ public:
 	int64_t SHARDED_ROCKSDB_WRITE_BUFFER_SIZE;
 	int64_t SHARDED_ROCKSDB_TOTAL_WRITE_BUFFER_SIZE;
 	int64_t SHARDED_ROCKSDB_MEMTABLE_BUDGET;
+	// Fraction of SERVER_MEM_LIMIT handed to the shared write buffer manager. 0 uses
+	// SHARDED_ROCKSDB_TOTAL_WRITE_BUFFER_SIZE instead.
+	double SHARDED_ROCKSDB_MEMTABLE_MEM_FRACTION_OF_TOTAL;
+	bool SHARDED_ROCKSDB_WRITE_BUFFER_MANAGER_ALLOW_STALL;
+	bool SHARDED_ROCKSDB_CHARGE_MEMTABLE_TO_BLOCK_CACHE;
+	// Size each physical shard's memtables from its recent write rate instead of uniformly.
+	bool SHARDED_ROCKSDB_ADAPTIVE_WRITE_BUFFER_SIZE;
+	int64_t SHARDED_ROCKSDB_MIN_WRITE_BUFFER_SIZE;
+	double SHARDED_ROCKSDB_WRITE_BUFFER_TUNING_INTERVAL;
+	// Ingest fetched blocks of at least SHARDED_ROCKSDB_INGEST_MIN_BYTES as external sst files instead of writing them
+	// through the write batch.
+	bool SHARDED_ROCKSDB_INGEST_FETCHED_RANGES;
+	int SHARDED_ROCKSDB_INGEST_MIN_BYTES;
 	int64_t SHARDED_ROCKSDB_MAX_WRITE_BUFFER_NUMBER;
 	int SHARDED_ROCKSDB_TARGET_FILE_SIZE_BASE;
 	int SHARDED_ROCKSDB_TARGET_FILE_SIZE_MULTIPLIER;
@@ -596,7 +671,14 @@ public:
 	double TAG_THROTTLE_RATE_WINDOW;
 	double START_TRANSACTION_MAX_EMPTY_QUEUE_BUDGET;
 	double TAG_THROTTLE_MAX_EMPTY_QUEUE_BUDGET;
+	// If positive, a tag idle on a GRV proxy banks at most this many seconds of its quota for a later burst
+	double TAG_THROTTLE_MAX_BURST_DURATION;
 	int START_TRANSACTION_MAX_QUEUE_SIZE;
+	// Seconds a GRV request of each priority should wait at most in the GRV proxy's queue. Requests started later are
+	// counted in GrvProxyStats. If the batch target is positive, the two priorities are scheduled by deadline rather
+	// than strictly, see batchRequestOverdue.
+	double START_TRANSACTION_DEFAULT_LATENCY_TARGET;
+	double START_TRANSACTION_BATCH_LATENCY_TARGET;
 	int KEY_LOCATION_MAX_QUEUE_SIZE;
 	int TENANT_ID_REQUEST_MAX_QUEUE_SIZE;
 	int BLOB_GRANULE_LOCATION_MAX_QUEUE_SIZE;
@@ -608,6 +690,11 @@ public:
 	double COMMIT_TRANSACTION_BATCH_INTERVAL_MAX;
 	double COMMIT_TRANSACTION_BATCH_INTERVAL_LATENCY_FRACTION;
 	double COMMIT_TRANSACTION_BATCH_INTERVAL_SMOOTHER_ALPHA;
+	bool COMMIT_BATCH_INTERVAL_CONTROLLER; // Use CommitBatchController rather than the smoothed latency fraction
+	double COMMIT_BATCH_TARGET_LATENCY; // Seconds; batch interval plus p99 batch latency the controller aims for
+	double COMMIT_BATCH_CONTROLLER_GAIN;
+	int COMMIT_BATCH_CONTROLLER_MAX_BATCHES_IN_FLIGHT;
+	int COMMIT_BATCH_CONTROLLER_WINDOW; // Batches over which the p99 latency is taken
 	int COMMIT_TRANSACTION_BATCH_COUNT_MAX;
 	int COMMIT_TRANSACTION_BATCH_BYTES_MIN;
 	int COMMIT_TRANSACTION_BATCH_BYTES_MAX;
@@ -617,8 +704,20 @@ public:
 	double COMMIT_BATCHES_MEM_FRACTION_OF_TOTAL;
 	double COMMIT_BATCHES_MEM_TO_TOTAL_MEM_SCALE_FACTOR;
 	double COMMIT_TRIGGER_DELAY;
+	// When set, commit proxies record the batches they commit to this path, suffixed with the proxy's id, for replay
+	// by flowbench's commit pipeline benchmarks
+	std::string COMMIT_BATCH_RECORDING_FILE;
+	int64_t COMMIT_BATCH_RECORDING_MAX_BYTES;
+	int64_t COMMIT_BATCH_RECORDING_MAX_PENDING_BYTES; // Batches are dropped while more bytes wait to be written
 
 	double RESOLVER_COALESCE_TIME;
+	int RESOLVER_CONFLICT_SET_PARTITIONS; // Threads a resolver checks and merges conflict ranges with
+	int RESOLVER_CONFLICT_SET_MIN_PARTITION_RANGES; // Smaller batches are handled by one thread
+	bool RESOLVER_CONFLICT_SET_BTREE; // Keep conflict history in a VersionHistoryBTree instead of a SkipList
+	// How often a resolver checks for conflict history older than the version window, and how many boundaries it
+	// examines at a time when removing it between batches; 0 leaves removal to the batches
+	double RESOLVER_IDLE_REMOVAL_INTERVAL;
+	int RESOLVER_IDLE_REMOVAL_NODES;
 	int BUGGIFIED_ROW_LIMIT;
 	double PROXY_SPIN_DELAY;
 	double UPDATE_REMOTE_LOG_VERSION_INTERVAL;
@@ -627,6 +726,9 @@ public:
 	double ENFORCED_MIN_RECOVERY_DURATION;
 	double REQUIRED_MIN_RECOVERY_DURATION;
 	bool ALWAYS_CAUSAL_READ_RISKY;
+	// When positive, a GRV proxy answers causal-read-risky requests with the last read version it got from the master,
+	// if it asked for it no more than this many seconds ago. Such read versions can miss commits from that window.
+	double GRV_PROXY_CAUSAL_READ_RISKY_CACHE_AGE;
 	int MAX_COMMIT_UPDATES;
 	double MAX_PROXY_COMPUTE;
 	double MAX_COMPUTE_PER_OPERATION;
@@ -636,6 +738,15 @@ public:
 	int TXN_STATE_SEND_AMOUNT;
 	double REPORT_TRANSACTION_COST_ESTIMATION_DELAY;
 	bool PROXY_REJECT_BATCH_QUEUED_TOO_LONG;
+	// Reply to transactions the resolvers rejected as soon as they answer, rather than after the batch is logged
+	bool PROXY_REPLY_CONFLICTS_AFTER_RESOLUTION;
+	// Threads besides the network thread that encrypt a commit batch's mutations before they are assigned tags; 0 keeps
+	// encryption inline
+	int PROXY_MUTATION_ENCRYPTION_THREADS;
+	int PROXY_PARALLEL_ENCRYPTION_MIN_MUTATIONS; // Smaller batches are encrypted inline
+	// Commit batches with at least this many bytes of mutations size their TLog messages up front, from the sizes of
+	// earlier batches' messages
+	int PROXY_RESERVE_LOG_MESSAGES_MIN_BYTES;
 	bool PROXY_USE_RESOLVER_PRIVATE_MUTATIONS;
 	bool BURSTINESS_METRICS_ENABLED;
 	// Interval on which to emit burstiness metrics on the commit proxy (in
@@ -678,6 +789,7 @@ public:
 	int BACKUP_FILE_BLOCK_BYTES;
 	int64_t BACKUP_LOCK_BYTES;
 	double BACKUP_UPLOAD_DELAY;
+	int BACKUP_WORKER_APPEND_BATCH_BYTES; // serialized mutation log bytes per append to a backup file
 
 	// Cluster Controller
 	double CLUSTER_CONTROLLER_LOGGING_DELAY;
@@ -715,6 +827,7 @@ public:
 	double REPLACE_INTERFACE_DELAY;
 	double REPLACE_INTERFACE_CHECK_DELAY;
 	double COORDINATOR_REGISTER_INTERVAL;
+	int COORDINATOR_REGISTER_BATCH_SIZE; // Most generation register requests a coordinator makes durable in one commit
 	double CLIENT_REGISTER_INTERVAL;
 	bool CC_ENABLE_WORKER_HEALTH_MONITOR;
 	double CC_WORKER_HEALTH_CHECKING_INTERVAL; // The interval of refreshing the degraded server list.
@@ -766,6 +879,7 @@ public:
 	double RECRUITMENT_TIMEOUT;
 	int DBINFO_SEND_AMOUNT;
 	double DBINFO_BATCH_DELAY;
+	bool DBINFO_SEND_DELTAS; // Leave unchanged client info and log system config out of ServerDBInfo broadcasts
 	double SINGLETON_RECRUIT_BME_DELAY;
 	bool RECORD_RECOVER_AT_IN_CSTATE;
 	bool TRACK_TLOG_RECOVERY;
@@ -796,6 +910,10 @@ public:
 	double SMOOTHING_AMOUNT;
 	double SLOW_SMOOTHING_AMOUNT;
 	double METRIC_UPDATE_RATE;
+	// How often ratekeeper polls storage servers whose queues are below half the batch priority target, and those
+	// above it. 0 uses METRIC_UPDATE_RATE.
+	double RATEKEEPER_IDLE_STORAGE_METRIC_UPDATE_RATE;
+	double RATEKEEPER_BUSY_STORAGE_METRIC_UPDATE_RATE;
 	// The interval of detailed HealthMetric is pushed to GRV proxies
 	double DETAILED_METRIC_UPDATE_RATE;
 	double LAST_LIMITED_RATIO;
@@ -812,6 +930,11 @@ public:
 	int64_t AUTO_TAG_THROTTLE_STORAGE_QUEUE_BYTES;
 	int64_t AUTO_TAG_THROTTLE_SPRING_BYTES_STORAGE_SERVER;
 	int64_t TARGET_BYTES_PER_STORAGE_SERVER_BATCH;
+	// Fraction by which the storage queue target shrinks at full storage engine IO pressure.
+	double RATEKEEPER_IO_PRESSURE_TARGET_REDUCTION;
+	// Seconds ahead at which ratekeeper evaluates storage queues, extrapolating their smoothed input and durable rates.
+	// 0 throttles on the current queue size.
+	double RATEKEEPER_STORAGE_QUEUE_LOOKAHEAD;
 	int64_t SPRING_BYTES_STORAGE_SERVER_BATCH;
 	int64_t STORAGE_HARD_LIMIT_BYTES;
 	int64_t STORAGE_HARD_LIMIT_BYTES_OVERAGE;
@@ -824,6 +947,12 @@ public:
 	double STORAGE_FETCH_KEYS_DELAY;
 	bool STORAGE_FETCH_KEYS_USE_COMMIT_BUDGET;
 	int64_t STORAGE_FETCH_KEYS_RATE_LIMIT; // Unit: MB/s
+	int64_t STORAGE_FETCH_SOURCE_BYTES_PER_SEC; // Most bytes/s a server serves to data moves, 0 for unlimited
+	double STORAGE_FETCH_SOURCE_READ_LATENCY_TARGET; // Mean foreground read latency above which that rate backs off
+	double STORAGE_FETCH_SOURCE_MIN_FRACTION; // The rate never backs off below this fraction of the most
+	double STORAGE_FETCH_SOURCE_BACKOFF;
+	double STORAGE_FETCH_SOURCE_RECOVERY;
+	double STORAGE_FETCH_SOURCE_ADJUST_INTERVAL;
 	double STORAGE_ROCKSDB_LOG_CLEAN_UP_DELAY;
 	double STORAGE_ROCKSDB_LOG_TTL;
 
@@ -897,6 +1026,8 @@ public:
 	double HOT_SHARD_THROTTLING_EXPIRE_AFTER;
 	int64_t HOT_SHARD_THROTTLING_TRACKED;
 	double HOT_SHARD_MONITOR_FREQUENCY;
+	// While a storage server's hot shards are throttled, its write queue does not limit the whole cluster's rate
+	bool HOT_SHARD_THROTTLING_SPARES_CLUSTER;
 
 	// allow generating synthetic data for test clusters
 	bool GENERATE_DATA_ENABLED;
@@ -960,6 +1091,8 @@ public:
 	double STORAGE_METRICS_AVERAGE_INTERVAL;
 	double STORAGE_METRICS_AVERAGE_INTERVAL_PER_KSECONDS;
 	double SPLIT_JITTER_AMOUNT;
+	bool SPLIT_BY_ENGINE_SIZES; // Weigh the byte sample by the sizes the storage engine estimates when splitting ranges
+	int SPLIT_BY_ENGINE_SIZES_MAX_KEYS; // Most sample keys to ask the storage engine for the sizes between
 	int64_t IOPS_UNITS_PER_SAMPLE;
 	int64_t BYTES_WRITTEN_UNITS_PER_SAMPLE;
 	int64_t BYTES_READ_UNITS_PER_SAMPLE;
@@ -984,6 +1117,8 @@ public:
 	int FETCH_BLOCK_BYTES;
 	int FETCH_KEYS_PARALLELISM_BYTES;
 	int FETCH_KEYS_PARALLELISM;
+	int FETCH_KEYS_PARALLEL_RANGES; // Sub-ranges one fetchKeys reads concurrently, 1 to read the range serially
+	int64_t FETCH_KEYS_PARALLEL_RANGE_BYTES; // Target size of those sub-ranges
 	int FETCH_KEYS_PARALLELISM_CHANGE_FEED;
 	int FETCH_KEYS_LOWER_PRIORITY;
 	int SERVE_FETCH_CHECKPOINT_PARALLELISM;
@@ -995,6 +1130,7 @@ public:
 	bool AUDIT_DATAMOVE_POST_CHECK;
 	int AUDIT_DATAMOVE_POST_CHECK_RETRY_COUNT_MAX;
 	int AUDIT_STORAGE_RATE_PER_SERVER_MAX;
+	int AUDIT_STORAGE_DIGEST_BYTES; // Replica audits compare digests of up to this many bytes of rows first, 0 disables
 	bool ENABLE_AUDIT_VERBOSE_TRACE;
 	bool LOGGING_STORAGE_COMMIT_WHEN_IO_TIMEOUT;
 	double LOGGING_COMPLETE_STORAGE_COMMIT_PROBABILITY;
@@ -1006,6 +1142,12 @@ public:
 	int64_t STORAGE_RECOVERY_VERSION_LAG_LIMIT;
 	double STORAGE_DURABILITY_LAG_REJECT_THRESHOLD;
 	double STORAGE_DURABILITY_LAG_MIN_RATE;
+	double STORAGE_IO_PRESSURE_PENALTY; // Extra load balancing penalty at full storage engine IO pressure.
+	// The reads in progress a storage server shares out among its clients as admission windows, which they keep
+	// their outstanding reads to it within. 0 disables admission windows.
+	int STORAGE_ADMISSION_TARGET_READ_QUEUE;
+	double STORAGE_ADMISSION_MIN_WINDOW;
+	double STORAGE_ADMISSION_CLIENT_INTERVAL;
 	int STORAGE_COMMIT_BYTES;
 	int STORAGE_FETCH_BYTES;
 	int STORAGE_ROCKSDB_FETCH_BYTES;
@@ -1015,9 +1157,11 @@ public:
 	double MIN_BYTE_SAMPLING_PROBABILITY; // Adjustable only for test of PhysicalShardMove. Should always be 0 for other
 	                                      // cases
 	int MAX_STORAGE_SERVER_WATCH_BYTES;
+	int64_t WATCH_VALUES_STREAM_LIMIT_BYTES;
 	int MAX_BYTE_SAMPLE_CLEAR_MAP_SIZE;
 	double LONG_BYTE_SAMPLE_RECOVERY_DELAY;
 	int BYTE_SAMPLE_LOAD_PARALLELISM;
+	bool BYTE_SAMPLE_BATCH_UPDATES; // Defer the byte sample updates of the update loop, and sample fetched blocks at once
 	double BYTE_SAMPLE_LOAD_DELAY;
 	double BYTE_SAMPLE_START_DELAY;
 	double BEHIND_CHECK_DELAY;
@@ -1032,33 +1176,52 @@ public:
 	// that a tag must register on a storage server in order for ratekeeper to
 	// track the write throughput of this tag on the storage server.
 	int64_t MIN_TAG_WRITE_PAGES_RATE;
+	// Cost, in bytes, that a storage server charges a tag for each row its range reads return, on top of the bytes
+	// read rounded up to pages
+	int64_t READ_TAG_COST_PER_ROW;
 	double TAG_MEASUREMENT_INTERVAL;
+	bool HOT_KEY_TRACKING_ENABLED; // Track the hottest keys and key prefixes read and written on each storage server
+	double HOT_KEY_MEASUREMENT_INTERVAL;
+	int HOT_KEY_SKETCH_DEPTH; // Rows of the count-min sketch estimating the weight of each key
+	int HOT_KEY_SKETCH_WIDTH; // Counters per row of the count-min sketch
+	int HOT_KEYS_TRACKED; // Hottest keys kept of each kind
+	int HOT_KEY_PREFIX_BYTES; // Length of the key prefixes tracked
 	bool PREFIX_COMPRESS_KVS_MEM_SNAPSHOTS;
+	bool KVS_MEM_RECOVERY_BATCH_SETS; // Insert ascending runs of recovered sets into the memory engine in batches.
+	bool KVS_MEM_USE_BTREE_CONTAINER; // Hold the memory engine's data in a B+tree instead of an IndexedSet.
 	bool REPORT_DD_METRICS;
 	double DD_METRICS_REPORT_INTERVAL;
 	double FETCH_KEYS_TOO_LONG_TIME_CRITERIA;
 	double MAX_STORAGE_COMMIT_TIME;
 	int64_t RANGESTREAM_LIMIT_BYTES;
+	int64_t RANGESTREAM_CHUNK_BYTES_MAX; // Largest range stream chunk, chunks grow up to it while the client has room
 	int64_t CHANGEFEEDSTREAM_LIMIT_BYTES;
 	int64_t BLOBWORKERSTATUSSTREAM_LIMIT_BYTES;
 	bool ENABLE_CLEAR_RANGE_EAGER_READS;
 	bool QUICK_GET_VALUE_FALLBACK;
+	bool QUICK_GET_VALUES_BATCH_LOCAL; // Batch the local point lookups of a mapped range read into one GetValuesRequest
 	bool QUICK_GET_KEY_VALUES_FALLBACK;
 	bool STRICTLY_ENFORCE_BYTE_LIMIT;
 	double FRACTION_INDEX_BYTELIMIT_PREFETCH;
 	int MAX_PARALLEL_QUICK_GET_VALUE;
 	int CHECKPOINT_TRANSFER_BLOCK_BYTES;
+	int CHECKPOINT_TRANSFER_CHUNK_BYTES; // Bytes of a checkpoint file sent in each FetchCheckpointReply
+	int64_t SERVE_FETCH_CHECKPOINT_BYTES_PER_SECOND; // Checkpoint bytes a storage process serves per second, 0 unlimited
 	int QUICK_GET_KEY_VALUES_LIMIT;
 	int QUICK_GET_KEY_VALUES_LIMIT_BYTES;
 	int STORAGE_FEED_QUERY_HARD_LIMIT;
 	std::string STORAGESERVER_READ_PRIORITIES;
 	int STORAGE_SERVER_READ_CONCURRENCY;
+	double STORAGE_SERVER_READ_MAX_QUEUE_TIME;
 	std::string STORAGESERVER_READTYPE_PRIORITY_MAP;
+	int STORAGE_SERVER_READ_LANES;
+	int STORAGE_SERVER_READ_LANE_CONCURRENCY;
 	int SPLIT_METRICS_MAX_ROWS;
 	double STORAGE_SHARD_CONSISTENCY_CHECK_INTERVAL;
 	int PHYSICAL_SHARD_MOVE_LOG_SEVERITY;
 	int FETCH_SHARD_BUFFER_BYTE_LIMIT;
 	int FETCH_SHARD_UPDATES_BYTE_LIMIT;
+	int64_t STORAGE_SERVER_READ_CACHE_BYTES; // Bytes of point reads cached above the storage engine, 0 disables
 
 	// Wait Failure
 	int MAX_OUTSTANDING_WAIT_FAILURE_REQUESTS;
@@ -1103,6 +1266,9 @@ public:
 	int STORAGE_DISK_CLEANUP_MAX_RETRIES; // Max retries to cleanup left-over disk files from last storage server
 	int STORAGE_DISK_CLEANUP_RETRY_INTERVAL; // Sleep interval between cleanup retries
 	double WORKER_START_STORAGE_DELAY;
+	std::string STORAGE_LOCAL_MIGRATION_ENGINE; // If set, a worker copies each storage server's data into this engine on
+	                                            // the same disk before restoring it, instead of it being wiggled.
+	int STORAGE_LOCAL_MIGRATION_BATCH_BYTES; // Bytes read from the old engine per commit to the new one
 
 	// Test harness
 	double WORKER_POLL_DELAY;
@@ -1128,6 +1294,7 @@ public:
 	// Status
 	double STATUS_MIN_TIME_BETWEEN_REQUESTS;
 	double MAX_STATUS_REQUESTS_PER_SECOND;
+	double STATUS_CACHE_MAX_STALENESS; // Status requests are answered with a status generated at most this long ago
 	int CONFIGURATION_ROWS_TO_FETCH;
 	bool DISABLE_DUPLICATE_LOG_WARNING;
 	double HISTOGRAM_REPORT_INTERVAL;
@@ -1194,6 +1361,7 @@ public:
 	int REDWOOD_DEFAULT_EXTENT_READ_SIZE; // Extent read size for Redwood files
 	int REDWOOD_EXTENT_CONCURRENT_READS; // Max number of simultaneous extent disk reads in progress.
 	bool REDWOOD_KVSTORE_RANGE_PREFETCH; // Whether to use range read prefetching
+	int REDWOOD_KVSTORE_RANGE_PREFETCH_MAX_PAGES; // Max pages a single range read will prefetch
 	double REDWOOD_PAGE_REBUILD_MAX_SLACK; // When rebuilding pages, max slack to allow in page before extending it
 	double REDWOOD_PAGE_REBUILD_SLACK_DISTRIBUTION; // When rebuilding pages, use this ratio of slack distribution
 	                                                // between the rightmost (new) page and the previous page. Defaults
@@ -1212,12 +1380,34 @@ public:
 	                                            // remap cleanup
 	double REDWOOD_REMAP_CLEANUP_TOLERANCE_RATIO; // Maximum ratio of the remap cleanup window that remap cleanup is
 	                                              // allowed to be ahead or behind
+	double REDWOOD_REMAP_CLEANUP_COPY_RATE; // Pages per second remap cleanup may copy between commits, 0 is unlimited.
+	                                        // Cleanup is not paced while a commit is waiting for it.
+	double REDWOOD_REMAP_CLEANUP_BUSY_RATE_FRACTION; // Fraction of REDWOOD_REMAP_CLEANUP_COPY_RATE used while other IO
+	                                                 // is waiting for the pager's IO lock
+	int REDWOOD_REMAP_CLEANUP_IO_PRIORITY; // Priority within REDWOOD_IO_PRIORITIES of remap cleanup page reads
 	int REDWOOD_PAGEFILE_GROWTH_SIZE_PAGES; // Number of pages to grow page file by
 	double REDWOOD_METRICS_INTERVAL;
 	double REDWOOD_HISTOGRAM_INTERVAL;
 	bool REDWOOD_EVICT_UPDATED_PAGES; // Whether to prioritize eviction of updated pages from cache.
+	double REDWOOD_PAGE_CACHE_PROTECTED_FRACTION; // Fraction of the page cache reserved for pages hit more than once, 0
+	                                              // makes the cache a plain LRU
+	bool REDWOOD_PAGE_CACHE_SCAN_COLD; // Whether leaf pages read by range scans are cached without being promoted
+	int REDWOOD_COMMIT_BUILD_THREADS; // Number of threads building new BTree pages during commit, 0 builds them on the
+	                                  // network thread
+	int REDWOOD_PAGE_CODEC_THREADS; // Number of threads verifying and decrypting pages read from disk, 0 decodes them on
+	                                // the network thread
+	double REDWOOD_INTERNAL_PAGE_CACHE_FRACTION; // Fraction of the page cache reserved for internal BTree pages, which
+	                                             // are only evicted once no leaf pages are left to evict
+	std::string REDWOOD_PAGE_COMPRESSION_FILTER; // Compression filter for newly written BTree nodes, NONE writes them
+	                                             // uncompressed. Compressed nodes can always be read.
+	int REDWOOD_PAGE_COMPRESSION_BLOCKS; // Number of blocks leaf nodes are sized to when compression is enabled, which
+	                                     // are then stored in fewer blocks if they compress well
 	int REDWOOD_DECODECACHE_REUSE_MIN_HEIGHT; // Minimum height for which to keep and reuse page decode caches
 	int REDWOOD_NODE_MAX_UNBALANCE; // Maximum imbalance in a node before it should be rebuilt instead of updated
+	double REDWOOD_COMPACTION_SCAN_RATE; // Leaf pages per second examined by background compaction, 0 disables it
+	double REDWOOD_COMPACTION_MIN_DELETED_FRACTION; // Ratio of erased to used bytes in a leaf page at which compaction
+	                                                // rewrites it
+	double REDWOOD_COMPACTION_MIN_PASS_INTERVAL; // Minimum seconds between the starts of compaction walks of the tree
 
 	std::string REDWOOD_IO_PRIORITIES;
 
@@ -1225,6 +1415,8 @@ public:
 	double LATENCY_SKETCH_ACCURACY;
 	double FILE_LATENCY_SKETCH_ACCURACY;
 	double LATENCY_METRICS_LOGGING_INTERVAL;
+	double STORAGE_READ_PHASE_SAMPLE_RATE; // Fraction of storage server reads whose versioned data and storage engine
+	                                       // time is sampled
 
 	// Cluster recovery
 	std::string CLUSTER_RECOVERY_EVENT_NAME_PREFIX;
@@ -1269,6 +1461,9 @@ public:
 	int BG_RDC_BYTES_FACTOR;
 	int BG_RDC_READ_FACTOR;
 	bool BG_WRITE_MULTIPART;
+	int64_t BG_FILE_CACHE_BYTES; // Local disk cache of granule files on blob worker processes, disabled if 0
+	bool BG_FILE_CACHE_PREFETCH_DELTAS; // Put newly written delta files in the local cache
+	bool BG_RESNAPSHOT_REUSE_CHUNKS; // Copy snapshot chunks no delta touched into the new snapshot when re-snapshotting
 	bool BG_ENABLE_DYNAMIC_WRITE_AMP;
 	double BG_DYNAMIC_WRITE_AMP_MIN_FACTOR;
 	double BG_DYNAMIC_WRITE_AMP_DECREASE_FACTOR;
@@ -1304,6 +1499,9 @@ public:
 	double BLOB_MANAGER_MEDIAN_ASSIGNMENT_ALLOWANCE;
 	int BLOB_MANAGER_MEDIAN_ASSIGNMENT_MIN_SAMPLES_PER_WORKER;
 	int BLOB_MANAGER_MEDIAN_ASSIGNMENT_MAX_SAMPLES_PER_WORKER;
+	int BLOB_MANAGER_CONCURRENT_ASSIGNMENTS; // outstanding assign requests to blob workers
+	int BLOB_MANAGER_MAPPING_WRITE_BATCH; // granule boundaries written per transaction
+	int BLOB_MANAGER_RECOVERY_SCAN_PARALLELISM; // concurrent reads of the granule mapping on recovery
 	double BGCC_TIMEOUT;
 	double BGCC_MIN_INTERVAL;
 	bool BLOB_MANIFEST_BACKUP;
@@ -1346,9 +1544,13 @@ public:
 	double REST_KMS_STABILITY_CHECK_INTERVAL;
 
 	double CONSISTENCY_SCAN_ACTIVE_THROTTLE_RATIO;
+	bool CONSISTENCY_SCAN_COMPARE_DIGESTS; // Compare digests of each replica's rows, reading the rows only on mismatch
+	double CONSISTENCY_SCAN_TARGET_READ_LATENCY; // The scan slows down while its reads take longer than this
+	double CONSISTENCY_SCAN_MIN_RATE_FRACTION; // The least fraction of the configured rate the scan slows down to
 
 	// Idempotency ids
 	double IDEMPOTENCY_ID_IN_MEMORY_LIFETIME;
+	bool IDEMPOTENCY_ID_COMPACT_ENCODING; // Write same-length idempotency ids without a length byte each
 	double IDEMPOTENCY_IDS_CLEANER_POLLING_INTERVAL;
 	double IDEMPOTENCY_IDS_MIN_AGE_SECONDS;
 
@@ -62,6 +62,12 @@ public:
 
 	virtual bool supportsTenants() const { return false; }
 
+	// true if results up to SPECIAL_KEY_SPACE_MODULE_CACHE_SECONDS old are acceptable, so that the whole range read by
+	// one transaction can be shared by the transactions of the same database that read it soon after, such as
+	// monitoring agents polling the module. Only asynchronous modules are cached, and their getRange must not use ryw
+	// after returning a future, since the transaction may be gone before the future is ready.
+	virtual bool cacheAcrossTransactions() const { return false; }
+
 	virtual ~SpecialKeyRangeReadImpl() {}
 
 protected:
@@ -115,6 +121,12 @@ public:
 	~SpecialKeyRangeRWImpl() override {}
 };
 
+// Reads the whole range of an asynchronous module, at most once per transaction unless the transaction has written in
+// between, and from the results shared across transactions if the module allows it
+ACTOR Future<RangeResult> readAsyncModule(const SpecialKeyRangeReadImpl* impl,
+                                          ReadYourWritesTransaction* ryw,
+                                          GetRangeLimits limits);
+
 class SpecialKeyRangeAsyncImpl : public SpecialKeyRangeReadImpl {
 public:
 	explicit SpecialKeyRangeAsyncImpl(KeyRangeRef kr) : SpecialKeyRangeReadImpl(kr) {}
@@ -145,15 +157,13 @@ public:
 			// For simplicity, every time we need to cache, we read the whole range
 			// Although sometimes the range can be narrowed,
 			// there is not a general way to do it in complicated scenarios
-			RangeResult result_ = wait(skrAyncImpl->getRange(ryw, skrAyncImpl->getKeyRange(), limits));
+			RangeResult result_ = wait(readAsyncModule(skrAyncImpl, ryw, limits));
 			cache->insert(skrAyncImpl->getKeyRange(), result_);
 		}
 		const auto& allResults = (*cache)[kr.begin].get();
-		int start = 0, end = allResults.size();
-		while (start < allResults.size() && allResults[start].key < kr.begin)
-			++start;
-		while (end > 0 && allResults[end - 1].key >= kr.end)
-			--end;
+		auto keyLess = [](const KeyValueRef& kv, const KeyRef& key) { return kv.key < key; };
+		int start = std::lower_bound(allResults.begin(), allResults.end(), kr.begin, keyLess) - allResults.begin();
+		int end = std::lower_bound(allResults.begin(), allResults.end(), kr.end, keyLess) - allResults.begin();
 		if (start < end) {
 			RangeResult result = RangeResultRef(allResults.slice(start, end), false);
 			result.arena().dependsOn(allResults.arena());
@@ -236,6 +246,12 @@ public:
 	static const std::set<std::string>& getManagementApiOptionsSet() { return options; }
 	static const std::set<std::string>& getTracingOptions() { return tracingOptions; }
 
+	// The whole range of a module that caches across transactions, read through ryw unless a read of it started within
+	// the last SPECIAL_KEY_SPACE_MODULE_CACHE_SECONDS. Concurrent readers share the read in flight.
+	Future<RangeResult> getSharedModuleRange(const SpecialKeyRangeReadImpl* impl,
+	                                         ReadYourWritesTransaction* ryw,
+	                                         GetRangeLimits limits);
+
 private:
 	ACTOR static Future<Optional<Value>> getActor(SpecialKeySpace* sks, ReadYourWritesTransaction* ryw, KeyRef key);
 
@@ -256,6 +272,9 @@ private:
 	KeyRangeMap<SpecialKeySpace::MODULE> modules;
 	KeyRangeMap<SpecialKeyRangeRWImpl*> writeImpls;
 
+	// When the read of each cached module started, and its result
+	std::unordered_map<const SpecialKeyRangeReadImpl*, std::pair<double, Future<RangeResult>>> sharedModuleResults;
+
 	// key space range, (\xff\xff, \xff\xff\xff) in prod and (, \xff) in test
 	KeyRange range;
 
@@ -333,12 +352,23 @@ public:
 	};
 };
 
+class TransactionTimelineImpl : public SpecialKeyRangeReadImpl {
+public:
+	explicit TransactionTimelineImpl(KeyRangeRef kr);
+	Future<RangeResult> getRange(ReadYourWritesTransaction* ryw,
+	                             KeyRangeRef kr,
+	                             GetRangeLimits limitsHint) const override;
+	bool supportsTenants() const override { return true; };
+};
+
 class DDStatsRangeImpl : public SpecialKeyRangeAsyncImpl {
 public:
 	explicit DDStatsRangeImpl(KeyRangeRef kr);
 	Future<RangeResult> getRange(ReadYourWritesTransaction* ryw,
 	                             KeyRangeRef kr,
 	                             GetRangeLimits limitsHint) const override;
+	// Shard metrics are themselves an estimate refreshed by data distribution, and reading them is a request to it
+	bool cacheAcrossTransactions() const override { return true; }
 };
 
 class ManagementCommandsOptionsImpl : public SpecialKeyRangeRWImpl {
@@ -125,6 +125,10 @@ struct StorageServerInterface {
 	RequestStream<struct AuditStorageRequest> auditStorage;
 	RequestStream<struct GetHotShardsRequest> getHotShards;
 	RequestStream<struct GetStorageCheckSumRequest> getCheckSum;
+	PublicRequestStream<struct GetValuesRequest> getValues;
+	PublicRequestStream<struct WatchValuesRequest> watchValues;
+	RequestStream<struct RebuildStorageRequest> rebuildStorage;
+	RequestStream<struct ChangeFeedMultiStreamRequest> changeFeedMultiStream;
 
 private:
 	bool acceptingRequests;
@@ -204,6 +208,14 @@ public:
 				    RequestStream<struct GetHotShardsRequest>(getValue.getEndpoint().getAdjustedEndpoint(24));
 				getCheckSum =
 				    RequestStream<struct GetStorageCheckSumRequest>(getValue.getEndpoint().getAdjustedEndpoint(25));
+				getValues =
+				    PublicRequestStream<struct GetValuesRequest>(getValue.getEndpoint().getAdjustedEndpoint(26));
+				watchValues =
+				    PublicRequestStream<struct WatchValuesRequest>(getValue.getEndpoint().getAdjustedEndpoint(27));
+				rebuildStorage =
+				    RequestStream<struct RebuildStorageRequest>(getValue.getEndpoint().getAdjustedEndpoint(28));
+				changeFeedMultiStream = RequestStream<struct ChangeFeedMultiStreamRequest>(
+				    getValue.getEndpoint().getAdjustedEndpoint(29));
 			}
 		} else {
 			ASSERT(Ar::isDeserializing);
@@ -258,6 +270,10 @@ public:
 		streams.push_back(auditStorage.getReceiver());
 		streams.push_back(getHotShards.getReceiver());
 		streams.push_back(getCheckSum.getReceiver());
+		streams.push_back(getValues.getReceiver(TaskPriority::LoadBalancedEndpoint));
+		streams.push_back(watchValues.getReceiver());
+		streams.push_back(rebuildStorage.getReceiver());
+		streams.push_back(changeFeedMultiStream.getReceiver());
 		FlowTransport::transport().addEndpoints(streams);
 	}
 };
@@ -305,7 +321,14 @@ struct GetValueReply : public LoadBalancedReply {
 
 	template <class Ar>
 	void serialize(Ar& ar) {
-		serializer(ar, LoadBalancedReply::penalty, LoadBalancedReply::error, value, cached);
+		serializer(ar,
+		           LoadBalancedReply::penalty,
+		           LoadBalancedReply::error,
+		           value,
+		           cached,
+		           LoadBalancedReply::cacheHitRate,
+		           LoadBalancedReply::readQueueDepth,
+		           LoadBalancedReply::admissionWindow);
 	}
 };
 
@@ -341,6 +364,53 @@ struct GetValueRequest : TimedRequest {
 	}
 };
 
+struct GetValuesReply : public LoadBalancedReply {
+	constexpr static FileIdentifier file_identifier = 1378930;
+	Arena arena;
+	// Only the keys which have a value are returned, in the same order as they appear in the request
+	VectorRef<KeyValueRef, VecSerStrategy::String> data;
+	bool cached = false;
+
+	GetValuesReply() {}
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar,
+		           LoadBalancedReply::penalty,
+		           LoadBalancedReply::error,
+		           data,
+		           cached,
+		           LoadBalancedReply::cacheHitRate,
+		           LoadBalancedReply::readQueueDepth,
+		           LoadBalancedReply::admissionWindow,
+		           arena);
+	}
+};
+
+// Reads a batch of keys at a single version. The keys should all belong to shards served by the same storage team.
+struct GetValuesRequest : TimedRequest {
+	constexpr static FileIdentifier file_identifier = 8454531;
+	SpanContext spanContext;
+	Arena arena;
+	TenantInfo tenantInfo;
+	VectorRef<KeyRef> keys;
+	Version version;
+	Optional<TagSet> tags;
+	ReplyPromise<GetValuesReply> reply;
+	Optional<ReadOptions> options;
+	VersionVector ssLatestCommitVersions; // includes the latest commit versions, as known
+	                                      // to this client, of all storage replicas that
+	                                      // serve the given keys
+	GetValuesRequest() {}
+
+	bool verify() const { return tenantInfo.isAuthorized(); }
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, keys, version, tags, reply, spanContext, tenantInfo, options, ssLatestCommitVersions, arena);
+	}
+};
+
 struct WatchValueReply {
 	constexpr static FileIdentifier file_identifier = 3;
 
@@ -386,6 +456,66 @@ struct WatchValueRequest {
 	}
 };
 
+struct WatchedValueRef {
+	KeyRef key;
+	Optional<ValueRef> value; // The watch fires once the key no longer has this value
+	Version version;
+
+	WatchedValueRef() : version(invalidVersion) {}
+	WatchedValueRef(Arena& a, KeyRef key, Optional<ValueRef> value, Version version)
+	  : key(a, key), value(value.present() ? Optional<ValueRef>(ValueRef(a, value.get())) : Optional<ValueRef>()),
+	    version(version) {}
+	WatchedValueRef(Arena& a, const WatchedValueRef& copyFrom)
+	  : WatchedValueRef(a, copyFrom.key, copyFrom.value, copyFrom.version) {}
+
+	int expectedSize() const { return key.expectedSize() + value.expectedSize(); }
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, key, value, version);
+	}
+};
+
+// Reports one watch of a WatchValuesRequest, which either fired at version or failed with error
+struct WatchValuesReply : public ReplyPromiseStreamReply {
+	constexpr static FileIdentifier file_identifier = 9483214;
+	int index; // of the watch in the request
+	Version version;
+	Optional<Error> error;
+
+	WatchValuesReply() : index(-1), version(invalidVersion) {}
+
+	int expectedSize() const { return sizeof(WatchValuesReply); }
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(
+		    ar, ReplyPromiseStreamReply::acknowledgeToken, ReplyPromiseStreamReply::sequence, index, version, error);
+	}
+};
+
+// Registers a batch of watches, whose keys should all belong to shards served by the same storage team. Each watch is
+// treated as a WatchValueRequest by the storage server, which reports it on the reply stream when it fires or fails and
+// ends the stream once every watch has been reported.
+struct WatchValuesRequest {
+	constexpr static FileIdentifier file_identifier = 4409214;
+	SpanContext spanContext;
+	Arena arena;
+	TenantInfo tenantInfo;
+	VectorRef<WatchedValueRef> watches;
+	Optional<TagSet> tags;
+	ReplyPromiseStream<WatchValuesReply> reply;
+
+	WatchValuesRequest() {}
+
+	bool verify() const { return tenantInfo.isAuthorized(); }
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, watches, tags, reply, spanContext, tenantInfo, arena);
+	}
+};
+
 struct GetKeyValuesReply : public LoadBalancedReply {
 	constexpr static FileIdentifier file_identifier = 1783066;
 	Arena arena;
@@ -393,12 +523,28 @@ struct GetKeyValuesReply : public LoadBalancedReply {
 	Version version; // useful when latestVersion was requested
 	bool more;
 	bool cached = false;
+	// For a request with digestOnly set, a digest of the rows read and their size. data then holds only the key of the
+	// last row, with an empty value, so that the reader can continue after it.
+	Optional<uint64_t> digest;
+	int64_t digestedBytes = 0;
 
 	GetKeyValuesReply() : version(invalidVersion), more(false), cached(false) {}
 
 	template <class Ar>
 	void serialize(Ar& ar) {
-		serializer(ar, LoadBalancedReply::penalty, LoadBalancedReply::error, data, version, more, cached, arena);
+		serializer(ar,
+		           LoadBalancedReply::penalty,
+		           LoadBalancedReply::error,
+		           data,
+		           version,
+		           more,
+		           cached,
+		           LoadBalancedReply::cacheHitRate,
+		           LoadBalancedReply::readQueueDepth,
+		           LoadBalancedReply::admissionWindow,
+		           digest,
+		           digestedBytes,
+		           arena);
 	}
 };
 
@@ -419,6 +565,7 @@ struct GetKeyValuesRequest : TimedRequest {
 	VersionVector ssLatestCommitVersions; // includes the latest commit versions, as known
 	                                      // to this client, of all storage replicas that
 	                                      // serve the given key
+	bool digestOnly = false; // reply with a digest of the rows instead of the rows, for comparing replicas
 
 	GetKeyValuesRequest() {}
 
@@ -438,6 +585,7 @@ struct GetKeyValuesRequest : TimedRequest {
 		           tenantInfo,
 		           options,
 		           ssLatestCommitVersions,
+		           digestOnly,
 		           arena);
 	}
 };
@@ -456,7 +604,17 @@ struct GetMappedKeyValuesReply : public LoadBalancedReply {
 
 	template <class Ar>
 	void serialize(Ar& ar) {
-		serializer(ar, LoadBalancedReply::penalty, LoadBalancedReply::error, data, version, more, cached, arena);
+		serializer(ar,
+		           LoadBalancedReply::penalty,
+		           LoadBalancedReply::error,
+		           data,
+		           version,
+		           more,
+		           cached,
+		           LoadBalancedReply::cacheHitRate,
+		           LoadBalancedReply::readQueueDepth,
+		           LoadBalancedReply::admissionWindow,
+		           arena);
 	}
 };
 
@@ -573,7 +731,14 @@ struct GetKeyReply : public LoadBalancedReply {
 
 	template <class Ar>
 	void serialize(Ar& ar) {
-		serializer(ar, LoadBalancedReply::penalty, LoadBalancedReply::error, sel, cached);
+		serializer(ar,
+		           LoadBalancedReply::penalty,
+		           LoadBalancedReply::error,
+		           sel,
+		           cached,
+		           LoadBalancedReply::cacheHitRate,
+		           LoadBalancedReply::readQueueDepth,
+		           LoadBalancedReply::admissionWindow);
 	}
 };
 
@@ -961,6 +1126,85 @@ struct ChangeFeedStreamRequest {
 	}
 };
 
+// The mutations of one feed of a ChangeFeedMultiStreamRequest, identified by its index in the request
+struct ChangeFeedMultiStreamFeedRef {
+	int feedIndex = -1;
+	VectorRef<MutationsAndVersionRef> mutations; // only versions with mutations
+	Version popVersion = invalidVersion;
+	bool ended = false; // the feed reached its end version, and gets no further entries
+
+	ChangeFeedMultiStreamFeedRef() {}
+	explicit ChangeFeedMultiStreamFeedRef(int feedIndex) : feedIndex(feedIndex) {}
+
+	int expectedSize() const { return mutations.expectedSize(); }
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, feedIndex, mutations, popVersion, ended);
+	}
+};
+
+struct ChangeFeedMultiStreamReply : public ReplyPromiseStreamReply {
+	constexpr static FileIdentifier file_identifier = 9406132;
+	Arena arena;
+	VectorRef<ChangeFeedMultiStreamFeedRef> feeds;
+	bool atLatestVersion = false;
+	// Every feed of the stream that has not ended has had all of its mutations up to this version sent
+	Version minStreamVersion = invalidVersion;
+
+	ChangeFeedMultiStreamReply() {}
+
+	int expectedSize() const { return sizeof(ChangeFeedMultiStreamReply) + feeds.expectedSize(); }
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar,
+		           ReplyPromiseStreamReply::acknowledgeToken,
+		           ReplyPromiseStreamReply::sequence,
+		           feeds,
+		           atLatestVersion,
+		           minStreamVersion,
+		           arena);
+	}
+};
+
+struct ChangeFeedMultiStreamFeed {
+	Key rangeID;
+	KeyRange range;
+	Version begin = 0;
+	Version end = 0;
+
+	ChangeFeedMultiStreamFeed() {}
+	ChangeFeedMultiStreamFeed(Key const& rangeID, KeyRange const& range, Version begin, Version end)
+	  : rangeID(rangeID), range(range), begin(begin), end(end) {}
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, rangeID, range, begin, end);
+	}
+};
+
+// Streams the mutations of many change feeds on one storage server over a single stream, with one minStreamVersion
+// for all of them instead of a stream and version updates per feed. If any of the feeds is moved away or removed, the
+// whole stream fails, and the client should restart the feeds that are still here on a new stream.
+struct ChangeFeedMultiStreamRequest {
+	constexpr static FileIdentifier file_identifier = 3514772;
+	SpanContext spanContext;
+	std::vector<ChangeFeedMultiStreamFeed> feeds;
+	int replyBufferSize = -1;
+	UID id; // This must be globally unique among ChangeFeedStreamRequest and ChangeFeedMultiStreamRequest instances
+	Optional<ReadOptions> options;
+	bool encrypted = false;
+
+	ReplyPromiseStream<ChangeFeedMultiStreamReply> reply;
+
+	ChangeFeedMultiStreamRequest() {}
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, feeds, reply, spanContext, replyBufferSize, id, options, encrypted);
+	}
+};
+
 struct ChangeFeedPopRequest {
 	constexpr static FileIdentifier file_identifier = 10726174;
 	Key rangeID;
@@ -1217,6 +1461,7 @@ struct StorageQueuingMetricsReply {
 	double diskUsage{ 0.0 };
 	double localRateLimit;
 	std::vector<BusyTagInfo> busiestTags;
+	double ioPressure{ 0.0 }; // see IKeyValueStore::getIOPressure()
 
 	template <class Ar>
 	void serialize(Ar& ar) {
@@ -1231,7 +1476,8 @@ struct StorageQueuingMetricsReply {
 		           cpuUsage,
 		           diskUsage,
 		           localRateLimit,
-		           busiestTags);
+		           busiestTags,
+		           ioPressure);
 	}
 };
 
@@ -1325,6 +1571,20 @@ struct GetStorageCheckSumRequest {
 	}
 };
 
+// Asks a storage server to have its engine rebuilt in place. Once it replies, the storage server closes its store and
+// its worker copies the store into a fresh one of the same engine before restarting the storage server from it.
+struct RebuildStorageRequest {
+	constexpr static FileIdentifier file_identifier = 3828145;
+	ReplyPromise<Void> reply;
+
+	RebuildStorageRequest() {}
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, reply);
+	}
+};
+
 // Memory size for storing mutation in the mutation log and the versioned map.
 inline int mvccStorageBytes(int mutationBytes) {
 	// Why * 2:
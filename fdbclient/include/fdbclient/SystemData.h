@@ -227,6 +227,7 @@ extern const KeyRangeRef conflictingKeysRange;
 extern const ValueRef conflictingKeysTrue, conflictingKeysFalse;
 extern const KeyRangeRef writeConflictRangeKeysRange;
 extern const KeyRangeRef readConflictRangeKeysRange;
+extern const KeyRangeRef transactionTimelineRange;
 extern const KeyRangeRef ddStatsRange;
 
 extern const KeyRef cacheKeysPrefix;
@@ -95,20 +95,8 @@ private:
 	Counter refreshByCacheMiss;
 	Counter numRefreshes;
 	Counter refreshByWatchTrigger;
-
-	ACTOR static Future<std::vector<std::pair<int64_t, TenantMapEntry>>> getTenantList(
-	    Reference<ReadYourWritesTransaction> tr) {
-		tr->setOption(FDBTransactionOptions::READ_SYSTEM_KEYS);
-		tr->setOption(FDBTransactionOptions::READ_LOCK_AWARE);
-
-		KeyBackedRangeResult<std::pair<int64_t, TenantMapEntry>> tenantList =
-		    wait(TenantMetadata::tenantMap().getRange(tr, {}, {}, CLIENT_KNOBS->MAX_TENANTS_PER_CLUSTER + 1));
-		ASSERT(tenantList.results.size() <= CLIENT_KNOBS->MAX_TENANTS_PER_CLUSTER && !tenantList.more);
-
-		TraceEvent(SevDebug, "TenantEntryCacheGetTenantList").detail("Count", tenantList.results.size());
-
-		return tenantList.results;
-	}
+	Counter invalidations; // cached entries replaced or dropped by a refresh because the tenant changed
+	Future<Void> metricsLogger;
 
 	ACTOR static Future<Void> refreshCacheById(int64_t tenantId,
 	                                           TenantEntryCache<T>* cache,
@@ -270,22 +258,35 @@ private:
 		}
 	}
 
+	// Brings the cache up to date with the tenant map, which is read in batches of
+	// TENANT_ENTRY_CACHE_REFRESH_BATCH_SIZE tenants in order of id. Entries of tenants that are unchanged are kept as
+	// they are, and entries of tenants between the ones read, which no longer exist, are dropped, so that the cache
+	// serves lookups throughout the refresh and a large tenant map does not have to be read in a single transaction.
 	ACTOR static Future<Void> refreshImpl(TenantEntryCache<T>* cache, TenantEntryCacheRefreshReason reason) {
 		TraceEvent(SevDebug, "TenantEntryCacheRefreshStart", cache->id()).detail("Reason", static_cast<int>(reason));
 
 		state Reference<ReadYourWritesTransaction> tr = cache->getDatabase()->createTransaction();
+		state int64_t beginId = 0;
+		state int64_t tenantsRead = 0;
 		loop {
 			try {
-				state std::vector<std::pair<int64_t, TenantMapEntry>> tenantList = wait(getTenantList(tr));
-
-				// Refresh cache entries reflecting the latest database state
-				cache->clear();
-				for (auto& tenant : tenantList) {
-					cache->put(tenant.second);
+				tr->setOption(FDBTransactionOptions::READ_SYSTEM_KEYS);
+				tr->setOption(FDBTransactionOptions::READ_LOCK_AWARE);
+				state KeyBackedRangeResult<std::pair<int64_t, TenantMapEntry>> tenants =
+				    wait(TenantMetadata::tenantMap().getRange(
+				        tr, beginId, {}, CLIENT_KNOBS->TENANT_ENTRY_CACHE_REFRESH_BATCH_SIZE));
+
+				for (auto& [tenantId, entry] : tenants.results) {
+					cache->removeEntriesInIdRange(beginId, tenantId);
+					cache->putIfChanged(entry);
+					beginId = tenantId + 1;
+				}
+				tenantsRead += tenants.results.size();
+				if (!tenants.more || tenants.results.empty()) {
+					cache->removeEntriesInIdRange(beginId, Optional<int64_t>());
+					updateCacheRefreshMetrics(cache, reason);
+					break;
 				}
-
-				updateCacheRefreshMetrics(cache, reason);
-				break;
 			} catch (Error& e) {
 				if (e.code() != error_code_actor_cancelled) {
 					TraceEvent("TenantEntryCacheRefreshError", cache->id()).errorUnsuppressed(e).suppressFor(1.0);
@@ -294,7 +295,9 @@ private:
 			}
 		}
 
-		TraceEvent(SevDebug, "TenantEntryCacheRefreshEnd", cache->id()).detail("Reason", static_cast<int>(reason));
+		TraceEvent(SevDebug, "TenantEntryCacheRefreshEnd", cache->id())
+		    .detail("Reason", static_cast<int>(reason))
+		    .detail("Count", tenantsRead);
 
 		return Void();
 	}
@@ -314,15 +317,11 @@ private:
 
 		TraceEvent("TenantEntryCacheGetByIdRefresh").detail("TenantId", tenantId);
 
-		if (cache->refreshMode == TenantEntryCacheRefreshMode::WATCH) {
-			// Entry not found. Do a point refresh
-			// TODO: Don't initiate refresh if tenantId < maxTenantId (stored as a system key currently) as we know that
-			// such a tenant does not exist (it has either never existed or has been deleted)
-			wait(refreshCacheById(tenantId, cache, TenantEntryCacheRefreshReason::CACHE_MISS));
-		} else {
-			// Entry not found. Refresh cacheEntries by scanning underlying KeyRange.
-			wait(refreshImpl(cache, TenantEntryCacheRefreshReason::CACHE_MISS));
-		}
+		// Entry not found. Do a point refresh, as init() has already read the whole tenant map and refreshes keep
+		// the cache up to date with it
+		// TODO: Don't initiate refresh if tenantId < maxTenantId (stored as a system key currently) as we know that
+		// such a tenant does not exist (it has either never existed or has been deleted)
+		wait(refreshCacheById(tenantId, cache, TenantEntryCacheRefreshReason::CACHE_MISS));
 
 		cache->misses += 1;
 		return cache->lookupById(tenantId);
@@ -343,13 +342,8 @@ private:
 
 		TraceEvent("TenantEntryCacheGetByNameRefresh").detail("TenantName", name);
 
-		if (cache->refreshMode == TenantEntryCacheRefreshMode::WATCH) {
-			// Entry not found. Do a point refresh
-			wait(refreshCacheByName(name, cache, TenantEntryCacheRefreshReason::CACHE_MISS));
-		} else {
-			// Entry not found. Refresh cacheEntries by scanning underlying KeyRange.
-			wait(refreshImpl(cache, TenantEntryCacheRefreshReason::CACHE_MISS));
-		}
+		// Entry not found. Do a point refresh
+		wait(refreshCacheByName(name, cache, TenantEntryCacheRefreshReason::CACHE_MISS));
 
 		cache->misses += 1;
 		return cache->lookupByName(name);
@@ -377,6 +371,32 @@ private:
 
 	Future<Void> refresh(TenantEntryCacheRefreshReason reason) { return refreshImpl(this, reason); }
 
+	// Drops the entries of the tenants with ids in [beginId, endId), or from beginId on if endId is not present
+	void removeEntriesInIdRange(int64_t beginId, Optional<int64_t> endId) {
+		auto begin = mapByTenantId.lower_bound(beginId);
+		auto end = endId.present() ? mapByTenantId.lower_bound(endId.get()) : mapByTenantId.end();
+		for (auto itr = begin; itr != end; ++itr) {
+			auto nameItr = mapByTenantName.find(itr->value.entry.tenantName);
+			if (nameItr != mapByTenantName.end() && nameItr->value.entry.id == itr->key) {
+				mapByTenantName.erase(nameItr);
+			}
+			invalidations += 1;
+		}
+		mapByTenantId.erase(begin, end);
+	}
+
+	// Caches entry unless the cache already holds the same entry
+	void putIfChanged(const TenantMapEntry& entry) {
+		auto itr = mapByTenantId.find(entry.id);
+		if (itr != mapByTenantId.end()) {
+			if (itr->value.entry == entry) {
+				return;
+			}
+			invalidations += 1;
+		}
+		put(entry);
+	}
+
 	static TenantEntryCachePayload<Void> defaultCreatePayload(const TenantMapEntry& entry) {
 		TenantEntryCachePayload<Void> payload;
 		payload.entry = entry;
@@ -446,7 +466,8 @@ public:
 	    refreshByCacheInit("TenantEntryCacheRefreshInit", metrics),
 	    refreshByCacheMiss("TenantEntryCacheRefreshMiss", metrics),
 	    numRefreshes("TenantEntryCacheNumRefreshes", metrics),
-	    refreshByWatchTrigger("TenantEntryCacheRefreshWatchTrigger", metrics) {
+	    refreshByWatchTrigger("TenantEntryCacheRefreshWatchTrigger", metrics),
+	    invalidations("TenantEntryCacheInvalidations", metrics) {
 		TraceEvent("TenantEntryCacheCreatedDefaultFunc", uid);
 	}
 
@@ -456,7 +477,8 @@ public:
 	    misses("TenantEntryCacheMisses", metrics), refreshByCacheInit("TenantEntryCacheRefreshInit", metrics),
 	    refreshByCacheMiss("TenantEntryCacheRefreshMiss", metrics),
 	    numRefreshes("TenantEntryCacheNumRefreshes", metrics),
-	    refreshByWatchTrigger("TenantEntryCacheRefreshWatchTrigger", metrics) {
+	    refreshByWatchTrigger("TenantEntryCacheRefreshWatchTrigger", metrics),
+	    invalidations("TenantEntryCacheInvalidations", metrics) {
 		TraceEvent("TenantEntryCacheCreatedDefaultFunc", uid);
 	}
 
@@ -467,7 +489,8 @@ public:
 	    refreshByCacheInit("TenantEntryCacheRefreshInit", metrics),
 	    refreshByCacheMiss("TenantEntryCacheRefreshMiss", metrics),
 	    numRefreshes("TenantEntryCacheNumRefreshes", metrics),
-	    refreshByWatchTrigger("TenantEntryCacheRefreshWatchTrigger", metrics) {
+	    refreshByWatchTrigger("TenantEntryCacheRefreshWatchTrigger", metrics),
+	    invalidations("TenantEntryCacheInvalidations", metrics) {
 		TraceEvent("TenantEntryCacheCreated", uid);
 	}
 
@@ -477,7 +500,8 @@ public:
 	    misses("TenantEntryCacheMisses", metrics), refreshByCacheInit("TenantEntryCacheRefreshInit", metrics),
 	    refreshByCacheMiss("TenantEntryCacheRefreshMiss", metrics),
 	    numRefreshes("TenantEntryCacheNumRefreshes", metrics),
-	    refreshByWatchTrigger("TenantEntryCacheRefreshWatchTrigger", metrics) {
+	    refreshByWatchTrigger("TenantEntryCacheRefreshWatchTrigger", metrics),
+	    invalidations("TenantEntryCacheInvalidations", metrics) {
 		TraceEvent("TenantEntryCacheCreated", uid);
 	}
 
@@ -487,7 +511,8 @@ public:
 	    refreshByCacheInit("TenantEntryCacheRefreshInit", metrics),
 	    refreshByCacheMiss("TenantEntryCacheRefreshMiss", metrics),
 	    numRefreshes("TenantEntryCacheNumRefreshes", metrics),
-	    refreshByWatchTrigger("TenantEntryCacheRefreshWatchTrigger", metrics) {
+	    refreshByWatchTrigger("TenantEntryCacheRefreshWatchTrigger", metrics),
+	    invalidations("TenantEntryCacheInvalidations", metrics) {
 		TraceEvent("TenantEntryCacheCreated", uid);
 	}
 
@@ -514,6 +539,8 @@ public:
 		}
 
 		Future<Void> setLastTenant = setLastTenantId(this);
+		metricsLogger = metrics.traceCounters(
+		    "TenantEntryCacheMetrics", uid, CLIENT_KNOBS->TENANT_ENTRY_CACHE_METRICS_LOGGING_INTERVAL);
 
 		return f && initalWatchFuture && setLastTenant;
 	}
@@ -585,6 +612,9 @@ public:
 	Counter::Value numRefreshByMisses() const { return refreshByCacheMiss.getValue(); }
 	Counter::Value numRefreshByInit() const { return refreshByCacheInit.getValue(); }
 	Counter::Value numWatchRefreshes() const { return refreshByWatchTrigger.getValue(); }
+	Counter::Value numHits() const { return hits.getValue(); }
+	Counter::Value numMisses() const { return misses.getValue(); }
+	Counter::Value numInvalidations() const { return invalidations.getValue(); }
 };
 
 #include "flow/unactorcompiler.h"
@@ -64,6 +64,15 @@ struct SpanContext {
 template <>
 struct flow_ref<SpanContext> : std::false_type {};
 
+// Head-based sampling: whether a new trace is sampled at the given rate. This is decided from the trace ID alone, so
+// every process seeing the trace makes the same decision.
+bool isTraceSampled(UID traceID, double sampleRate);
+
+// Tail-based sampling: a span of an unsampled trace is still traced if it took at least
+// FLOW_KNOBS->TRACING_SLOW_SPAN_THRESHOLD seconds. The spans enclosing a slow span are at least as slow, so the slow
+// part of a request is traced from the client down to the role responsible for it.
+bool isSlowSpan(const SpanContext& context, double duration);
+
 // Span
 //
 // Span is a tracing implementation which, for the most part, complies with the W3C Trace Context specification
@@ -126,4 +126,62 @@ private:
 	std::vector<size_t> offsets;
 };
 
+// Reads the elements of a packed tuple in place, without building a Tuple or allocating per element. Strings without
+// escaped nulls are returned as references into the packed bytes; only strings with escaped nulls are copied.
+//
+//	for (TupleReader r(key); !r.empty(); r.next()) { ... r.type() ... r.getInt() ... }
+class TupleReader {
+public:
+	explicit TupleReader(StringRef packed, bool include_user_type = false);
+
+	bool empty() const { return pos >= packed.size(); }
+	void next();
+
+	Tuple::ElementType type() const;
+	// The packed bytes of the current element, including its type code
+	StringRef raw() const { return packed.substr(pos, std::min(end, (size_t)packed.size()) - pos); }
+
+	// The result refers to the packed bytes or, if the string has escaped nulls, to arena
+	StringRef getString(Arena& arena) const;
+	int64_t getInt(bool allow_incomplete = false) const;
+	bool getBool() const;
+	float getFloat() const;
+	double getDouble() const;
+	TupleVersionstamp getVersionstamp() const;
+
+private:
+	StringRef packed;
+	bool includeUserType;
+	size_t pos = 0;
+	size_t end = 0; // Just past the current element, possibly beyond the packed bytes if it is truncated
+};
+
+// Packs elements onto the end of a caller's buffer, without keeping the element offsets a Tuple does. The bytes are
+// the same as Tuple::pack() of the same elements.
+class TupleWriter {
+public:
+	TupleWriter(Arena& arena, VectorRef<uint8_t>& out) : arena(arena), out(out) {}
+
+	TupleWriter& append(StringRef const& str, bool utf8 = false);
+	TupleWriter& append(Tuple::UnicodeStr const& str) { return append(str.str, true); }
+	TupleWriter& append(int32_t value) { return append((int64_t)value); }
+	TupleWriter& append(int64_t);
+	TupleWriter& append(bool);
+	TupleWriter& append(float);
+	TupleWriter& append(double);
+	TupleWriter& append(std::nullptr_t);
+	TupleWriter& append(TupleVersionstamp const&);
+
+	template <typename T>
+	TupleWriter& operator<<(T const& t) {
+		return append(t);
+	}
+
+	StringRef packed() const { return StringRef(out.begin(), out.size()); }
+
+private:
+	Arena& arena;
+	VectorRef<uint8_t>& out;
+};
+
 #endif /* FDBCLIENT_TUPLE_H */
@@ -24,7 +24,9 @@
 #pragma once
 
 #include <boost/container/flat_map.hpp>
+#include <algorithm>
 #include <set>
+#include <vector>
 
 #include "fdbclient/FDBTypes.h"
 #include "fdbclient/Knobs.h"
@@ -46,13 +48,41 @@ struct VersionVector {
 	VersionVector(Version version) : maxVersion(version), cachedEncodedSize(InvalidEncodedSize) {}
 
 private:
-	// Only invoked by getDelta() and applyDelta(), where tag has been validated
+	// Only invoked by deserialization, where tag has been validated
 	// and version is guaranteed to be larger than the existing value.
 	inline void setVersionNoCheck(const Tag& tag, Version version) {
 		versions[tag] = version;
 		invalidateCachedEncodedSize();
 	}
 
+	// When changes are tracked, the <version, tag> of each update in order of
+	// version, so that getDelta() only visits the tags updated after the
+	// reference version rather than every tag. A tag may appear more than once,
+	// in which case only its last entry is current. Every tag in "versions" has
+	// an entry, so the entries after a version are all the updates after it.
+	bool changesTracked = false;
+	std::vector<std::pair<Version, Tag>> changes;
+
+	inline void recordChange(const Tag& tag, Version version) {
+		changes.emplace_back(version, tag);
+	}
+
+	// Drops the stale entries of "changes" once they outnumber the current ones.
+	void compactChangesIfNeeded() {
+		if (changes.size() > 2 * versions.size() + 64) {
+			compactChanges();
+		}
+	}
+
+	void compactChanges() {
+		changes.clear();
+		changes.reserve(versions.size());
+		for (const auto& [tag, version] : versions) {
+			changes.emplace_back(version, tag);
+		}
+		std::sort(changes.begin(), changes.end());
+	}
+
 	inline void invalidateCachedEncodedSize() { cachedEncodedSize = InvalidEncodedSize; }
 
 	// Encoded version vector size. Introduced to help speed up serialization.
@@ -69,6 +99,16 @@ public:
 
 	int size() const { return versions.size(); }
 
+	// Keep an index of the updates in order of version, which makes getDelta()
+	// proportional to the number of tags updated after the reference version.
+	// Worth it for a version vector, such as the sequencer's or a GRV proxy's,
+	// that is only updated through setVersion() and applyDelta() and that many
+	// deltas are taken from.
+	void trackChanges() {
+		changesTracked = true;
+		compactChanges();
+	}
+
 	bool empty() const { return versions.empty(); }
 
 	void setVersion(const Tag& tag, Version version) {
@@ -76,6 +116,10 @@ public:
 		ASSERT(tag.locality > tagLocalityInvalid);
 		ASSERT(version > maxVersion);
 		versions[tag] = version;
+		if (changesTracked) {
+			recordChange(tag, version);
+			compactChangesIfNeeded();
+		}
 		maxVersion = version;
 		invalidateCachedEncodedSize();
 	}
@@ -87,8 +131,14 @@ public:
 			ASSERT(tag.locality > tagLocalityInvalid);
 			if (localityFilter == tagLocalityInvalid || tag.locality == localityFilter) {
 				versions[tag] = version;
+				if (changesTracked) {
+					recordChange(tag, version);
+				}
 			}
 		}
+		if (changesTracked) {
+			compactChangesIfNeeded();
+		}
 		maxVersion = version;
 		invalidateCachedEncodedSize();
 	}
@@ -108,6 +158,7 @@ public:
 
 	void clear() {
 		versions.clear();
+		changes.clear();
 		maxVersion = invalidVersion;
 		invalidateCachedEncodedSize();
 	}
@@ -125,15 +176,26 @@ public:
 		}
 
 		if (CLIENT_KNOBS->SEND_ENTIRE_VERSION_VECTOR) {
-			delta = *this;
+			delta.versions = versions;
+		} else if (changesTracked) {
+			std::vector<std::pair<Tag, Version>> changed;
+			for (auto it = changes.rbegin(); it != changes.rend() && it->first > refVersion; ++it) {
+				if (versions.find(it->second)->second == it->first) {
+					changed.emplace_back(it->second, it->first);
+				}
+			}
+			std::sort(changed.begin(), changed.end());
+			delta.versions.insert(boost::container::ordered_unique_range, changed.begin(), changed.end());
 		} else {
 			for (const auto& [tag, version] : versions) {
 				if (version > refVersion) {
-					delta.setVersionNoCheck(tag, version);
+					// Appending in order of tag
+					delta.versions.emplace_hint(delta.versions.end(), tag, version);
 				}
 			}
-			delta.maxVersion = maxVersion;
 		}
+		delta.maxVersion = maxVersion;
+		delta.invalidateCachedEncodedSize();
 	}
 
 	// @note this method, together with method getDelta(), helps minimize
@@ -149,14 +211,36 @@ public:
 		}
 
 		if (CLIENT_KNOBS->SEND_ENTIRE_VERSION_VECTOR) {
+			bool tracked = changesTracked;
 			*this = delta;
+			if (tracked) {
+				trackChanges();
+			}
 		} else {
+			// Update the tags we have in place and merge in the new ones in a
+			// single pass, rather than inserting them one at a time.
+			std::vector<std::pair<Tag, Version>> added;
+			size_t firstChange = changes.size();
 			for (const auto& [tag, version] : delta.versions) {
 				if (version > maxVersion) {
-					setVersionNoCheck(tag, version);
+					auto it = versions.find(tag);
+					if (it != versions.end()) {
+						it->second = version;
+					} else {
+						added.emplace_back(tag, version);
+					}
+					if (changesTracked) {
+						recordChange(tag, version);
+					}
 				}
 			}
+			versions.insert(boost::container::ordered_unique_range, added.begin(), added.end());
+			if (changesTracked) {
+				std::sort(changes.begin() + firstChange, changes.end());
+				compactChangesIfNeeded();
+			}
 			maxVersion = delta.maxVersion;
+			invalidateCachedEncodedSize();
 		}
 	}
 
@@ -427,6 +511,7 @@ public:
 
 		T tagId;
 		V versionDelta;
+		versions.reserve(versions.size() + pairCount);
 		for (size_t i = 0; i < localities.size(); i++) {
 			for (size_t j = 0; j < localityCounts[i]; j++) {
 				// Deserialize tag id.
@@ -0,0 +1,92 @@
+/*
+ * VersionedBatchMap.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FDBCLIENT_VERSIONEDBATCHMAP_H
+#define FDBCLIENT_VERSIONEDBATCHMAP_H
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "fdbclient/FDBTypes.h"
+#include "fdbclient/VersionedMap.h"
+
+// VersionedBatchMap is a memory compact alternative to VersionedMap<KeyRef, ValueOrClearToRef> for holding a window of
+// recent versions of small values. Instead of a persistent tree, which costs several reference counted nodes per
+// mutation, the mutations of each version are kept together as one batch. The batch of the latest version is an append
+// only log, and older batches are sorted into non overlapping entries. A read at version v searches the batches at or
+// before v from the newest one down, so a lookup costs O(versions * log(mutations per version)) and a mutation costs
+// sizeof(Entry) plus its key and value bytes.
+//
+// Like VersionedMap, the map only holds what was written within the window: get() distinguishes a key which was
+// cleared from one that the map knows nothing about, which the caller must then read from the storage engine.
+class VersionedBatchMap : NonCopyable {
+public:
+	struct Entry {
+		KeyRef key;
+		ValueOrClearToRef value; // Either a set of key, or a clear of [key, value.getEndKey())
+
+		Entry(KeyRef key, ValueOrClearToRef value) : key(key), value(value) {}
+	};
+
+	VersionedBatchMap() : oldestVersion(0) { batches.emplace_back(0); }
+
+	Version getOldestVersion() const { return oldestVersion; }
+	Version getLatestVersion() const { return batches.back().version; }
+
+	// Mutations are applied to the latest version, the key and value bytes are copied into the map
+	void insert(KeyRef key, ValueRef value);
+	void clear(KeyRangeRef range);
+
+	// Creates a new latest version, which must be greater than the current one
+	void createNewVersion(Version version);
+
+	// Returns the value of key at version, an empty inner Optional if the key is cleared at version, or an empty
+	// Optional if no version up to and including version wrote key.
+	Optional<Optional<ValueRef>> get(KeyRef key, Version version) const;
+
+	// Collapses the batches of the versions before version into one so that reads are only valid at version and later.
+	// The memory of mutations overwritten by a later version in the collapsed range is released.
+	void forgetVersionsBefore(Version version);
+
+	int64_t getBytes() const;
+	int getBatchCount() const { return batches.size(); }
+
+private:
+	struct Batch {
+		Version version;
+		Arena arena;
+		std::vector<Entry> entries;
+		bool sorted = false;
+
+		explicit Batch(Version version) : version(version) {}
+		int64_t getBytes() const { return arena.getSize() + entries.capacity() * sizeof(Entry); }
+	};
+
+	// Sorts the log of batch into non overlapping entries, later mutations overriding earlier ones
+	void seal(Batch& batch);
+
+	static Optional<Optional<ValueRef>> find(Batch const& batch, KeyRef key);
+
+	Version oldestVersion;
+	std::deque<Batch> batches; // Ordered by version, the last one being the latest version
+};
+
+#endif
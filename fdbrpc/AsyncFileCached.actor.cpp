@@ -19,6 +19,7 @@
  */
 
 #include "fdbrpc/AsyncFileCached.actor.h"
+#include "flow/UnitTest.h"
 
 // Page caches used in non-simulated environments
 Optional<Reference<EvictablePageCache>> pc4k, pc64k;
@@ -31,7 +32,7 @@ EvictablePage::~EvictablePage() {
 	if (data) {
 		freeFast4kAligned(pageCache->pageSize, data);
 	}
-	if (EvictablePageCache::RANDOM == pageCache->cacheEvictionType) {
+	if (EvictablePageCache::LRU != pageCache->cacheEvictionType) {
 		if (index > -1) {
 			pageCache->pages[index] = pageCache->pages.back();
 			pageCache->pages[index]->index = index;
@@ -254,6 +255,35 @@ Future<Void> AsyncFileCached::flush() {
 
 	std::vector<Future<Void>> unflushed;
 
+	const int maxRunPages = FLOW_KNOBS->FLOW_CACHEDFILE_MAX_COALESCED_WRITE / pageCache->pageSize;
+	if (maxRunPages > 1) {
+		// Write each run of dirty pages at consecutive offsets with a single write, so that a sync after many small
+		// writes, such as a SQLite checkpoint, does a few large sequential I/Os rather than one per page
+		std::vector<AFCPage*> dirtyPages;
+		const std::vector<AFCPage*> snapshot = flushable;
+		for (AFCPage* p : snapshot) {
+			if (p->dirty) {
+				dirtyPages.push_back(p);
+			} else {
+				// A write of the page is in progress
+				unflushed.push_back(p->flush());
+			}
+		}
+		std::sort(dirtyPages.begin(), dirtyPages.end(), [](AFCPage const* a, AFCPage const* b) {
+			return a->pageOffset < b->pageOffset;
+		});
+		std::vector<AFCPage*> run;
+		for (int i = 0; i < dirtyPages.size(); i++) {
+			run.push_back(dirtyPages[i]);
+			if (i + 1 == dirtyPages.size() || run.size() == maxRunPages ||
+			    dirtyPages[i + 1]->pageOffset != dirtyPages[i]->pageOffset + pageCache->pageSize) {
+				unflushed.push_back(run.size() == 1 ? run[0]->flush() : AFCPage::flushRun(run));
+				run.clear();
+			}
+		}
+		return waitForAll(unflushed);
+	}
+
 	int debug_count = flushable.size();
 	for (int i = 0; i < flushable.size();) {
 		auto p = flushable[i];
@@ -289,3 +319,49 @@ AsyncFileCached::~AsyncFileCached() {
 	}
 	openFiles.erase(filename);
 }
+
+namespace {
+
+struct TestPage : EvictablePage {
+	int id;
+	std::set<int>* evicted;
+
+	TestPage(Reference<EvictablePageCache> pageCache, int id, std::set<int>* evicted)
+	  : EvictablePage(pageCache), id(id), evicted(evicted) {
+		pageCache->allocate(this);
+	}
+
+	bool evict() override {
+		evicted->insert(id);
+		delete this;
+		return true;
+	}
+};
+
+} // namespace
+
+TEST_CASE("/fdbrpc/AsyncFileCached/ClockEviction") {
+	auto cache = makeReference<EvictablePageCache>(4096, 4 * 4096, EvictablePageCache::CLOCK);
+	std::set<int> evicted;
+	std::vector<TestPage*> pages;
+	for (int i = 0; i < 4; i++) {
+		pages.push_back(new TestPage(cache, i, &evicted));
+	}
+	ASSERT(evicted.empty());
+
+	// Every page is new, so the hand goes around once and evicts the first
+	pages.push_back(new TestPage(cache, 4, &evicted));
+	ASSERT(evicted == std::set<int>({ 0 }));
+
+	// A page hit since the hand passed it is passed over again
+	cache->updateHit(pages[3]);
+	pages.push_back(new TestPage(cache, 5, &evicted));
+	ASSERT(evicted == std::set<int>({ 0, 1 }));
+	ASSERT_EQ(cache->pages.size(), 4);
+
+	for (int i = 2; i < pages.size(); i++) {
+		delete pages[i];
+	}
+	ASSERT(cache->pages.empty());
+	return Void();
+}
@@ -1,6 +1,7 @@
 #include "fdbrpc/DDSketch.h"
 #include "flow/Error.h"
 #include "flow/IRandom.h"
+#include "flow/serialize.h"
 #include "flow/UnitTest.h"
 #include <limits>
 #include <random>
@@ -60,3 +61,45 @@ TEST_CASE("/fdbrpc/ddsketch/correctness") {
 	ASSERT(p999 > 0 && p999 != std::numeric_limits<double>::infinity());
 	return Void{};
 }
+
+TEST_CASE("/fdbrpc/ddsketch/fastlog") {
+	static_assert(fastLogger::fastlog(1.0) == 0.0 && fastLogger::fastlog(8.0) == 3.0);
+	for (int i = 0; i < 100000; i++) {
+		double value = ldexp(1 + deterministicRandom()->random01(), deterministicRandom()->randomInt(-60, 60));
+		int e;
+		double s = frexp(value, &e) * 2 - 1;
+		ASSERT(fastLogger::fastlog(value) == ((fastLogger::A * s + fastLogger::B) * s + fastLogger::C) * s + e - 1);
+	}
+	return Void();
+}
+
+TEST_CASE("/fdbrpc/ddsketch/serialize") {
+	DDSketch<double> a, b;
+	for (int i = 0; i < 10000; i++) {
+		a.addSample(deterministicRandom()->random01());
+		b.addSample(deterministicRandom()->random01() * 100);
+	}
+	b.addSample(0);
+
+	BinaryWriter wa(Unversioned()), wb(Unversioned());
+	wa << a;
+	wb << b;
+	// Only the non-empty buckets are sent
+	ASSERT(wa.getLength() < a.getBucketSize() * sizeof(uint32_t) / 4);
+
+	Standalone<StringRef> va = wa.toValue(), vb = wb.toValue();
+	DDSketch<double> merged, fromB;
+	BinaryReader ra(va, Unversioned());
+	ra >> merged;
+	BinaryReader rb(vb, Unversioned());
+	rb >> fromB;
+	merged.mergeWith(fromB);
+	a.mergeWith(b);
+
+	ASSERT(merged.getPopulationSize() == a.getPopulationSize());
+	ASSERT(merged.min() == a.min() && merged.max() == a.max() && merged.getSum() == a.getSum());
+	for (double p : { 0.0, 0.01, 0.25, 0.5, 0.9, 0.99, 0.999, 1.0 }) {
+		ASSERT(merged.percentile(p) == a.percentile(p));
+	}
+	return Void();
+}
@@ -40,6 +40,7 @@
 #include "fdbrpc/TokenCache.h"
 #include "fdbrpc/simulator.h"
 #include "flow/ActorCollection.h"
+#include "flow/CompressionUtils.h"
 #include "flow/Error.h"
 #include "flow/flow.h"
 #include "flow/Net2Packet.h"
@@ -67,6 +68,9 @@ Future<Void> g_currentDeliveryPeerDisconnect;
 } // namespace
 
 constexpr int PACKET_LEN_WIDTH = sizeof(uint32_t);
+// Set in the length of a packet whose token and payload are compressed with zstd. The length and checksum are those of
+// the compressed bytes. Only sent to peers whose ConnectPacket accepts compression.
+constexpr uint32_t PACKET_COMPRESSED_FLAG = 0x80000000;
 const uint64_t TOKEN_STREAM_FLAG = 1;
 
 FDB_BOOLEAN_PARAM(InReadSocket);
@@ -392,8 +396,16 @@ ACTOR Future<Void> pingLatencyLogger(TransportData* self) {
 				    .detail("ConnectMaxLatency", peer->connectLatencies.max())
 				    .detail("ConnectMeanLatency", peer->connectLatencies.mean())
 				    .detail("ConnectMedianLatency", peer->connectLatencies.median())
-				    .detail("ConnectP90Latency", peer->connectLatencies.percentile(0.90));
+				    .detail("ConnectP90Latency", peer->connectLatencies.percentile(0.90))
+				    .detail("CompressedPackets", peer->compressedPackets)
+				    .detail("BytesBeforeCompression", peer->bytesBeforeCompression)
+				    .detail("BytesAfterCompression", peer->bytesAfterCompression)
+				    .detail("CompressionSeconds", peer->compressionSeconds);
 				peer->lastLoggedTime = now();
+				peer->compressedPackets = 0;
+				peer->bytesBeforeCompression = 0;
+				peer->bytesAfterCompression = 0;
+				peer->compressionSeconds = 0.0;
 				peer->connectOutgoingCount = 0;
 				peer->connectIncomingCount = 0;
 				peer->connectFailedCount = 0;
@@ -437,7 +449,7 @@ struct ConnectPacket {
 	// IP Address to reconnect to the originating process. Only one of these must be populated.
 	uint32_t canonicalRemoteIp4 = 0;
 
-	enum ConnectPacketFlags { FLAG_IPV6 = 1 };
+	enum ConnectPacketFlags { FLAG_IPV6 = 1, FLAG_BULK_LANE = 2, FLAG_COMPRESSION = 4 };
 	uint16_t flags = 0;
 	uint8_t canonicalRemoteIp6[16] = { 0 };
 
@@ -465,6 +477,11 @@ struct ConnectPacket {
 
 	bool isIPv6() const { return flags & FLAG_IPV6; }
 
+	bool isBulkLane() const { return flags & FLAG_BULK_LANE; }
+
+	// Whether the sender can read compressed packets (see PACKET_COMPRESSED_FLAG)
+	bool acceptsCompression() const { return flags & FLAG_COMPRESSION; }
+
 	uint32_t totalPacketSize() const { return connectPacketLength + sizeof(connectPacketLength); }
 
 	template <class Ar>
@@ -493,9 +510,73 @@ struct ConnectPacket {
 ACTOR static Future<Void> connectionReader(TransportData* transport,
                                            Reference<IConnection> conn,
                                            Reference<struct Peer> peer,
-                                           Promise<Reference<struct Peer>> onConnected);
+                                           Promise<Reference<struct Peer>> onConnected,
+                                           Promise<Reference<struct Peer>> onBulkLane);
 
 static void sendLocal(TransportData* self, ISerializeSource const& what, const Endpoint& destination);
+// Replaces the packet just written to the end of 'queue' by its compressed form. The packet begins at offset
+// 'beginOffset' of 'begin' with a 'packetInfoSize' byte header followed by 'len' bytes of token and payload.
+// Returns the new end of the packet and sets 'len' to its new length, or returns nullptr and leaves the packet alone
+// if it does not shrink.
+static PacketBuffer* compressPacket(Peer* peer,
+                                    UnsentPacketQueue& queue,
+                                    PacketBuffer* begin,
+                                    int beginOffset,
+                                    int packetInfoSize,
+                                    bool checksumEnabled,
+                                    uint32_t& len) {
+	Arena arena;
+	uint8_t* raw = new (arena) uint8_t[len];
+	int skip = packetInfoSize;
+	uint32_t copied = 0;
+	for (PacketBuffer* b = begin; copied < len; b = b->nextPacketBuffer()) {
+		int offset = b == begin ? beginOffset : 0;
+		int available = b->bytes_written - offset;
+		if (skip >= available) {
+			skip -= available;
+			continue;
+		}
+		offset += skip;
+		available -= skip;
+		skip = 0;
+		const uint32_t n = std::min<uint32_t>(available, len - copied);
+		memcpy(raw + copied, b->data() + offset, n);
+		copied += n;
+	}
+
+	const double start = timer_monotonic();
+	StringRef compressed = CompressionUtils::compress(
+	    CompressionFilter::ZSTD, StringRef(raw, len), FLOW_KNOBS->FLOW_TRANSPORT_COMPRESSION_LEVEL, arena);
+	peer->compressionSeconds += timer_monotonic() - start;
+	peer->bytesBeforeCompression += len;
+	if (compressed.size() >= len) {
+		peer->bytesAfterCompression += len;
+		return nullptr;
+	}
+	++peer->compressedPackets;
+	peer->bytesAfterCompression += compressed.size();
+
+	for (PacketBuffer* b = begin->nextPacketBuffer(); b;) {
+		PacketBuffer* next = b->nextPacketBuffer();
+		b->delref();
+		b = next;
+	}
+	begin->bytes_written = beginOffset;
+	begin->next = nullptr;
+	queue.setWriteBuffer(begin);
+
+	PacketWriter wr(begin, nullptr, Unversioned());
+	const uint32_t header = compressed.size() | PACKET_COMPRESSED_FLAG;
+	wr.serializeBytes(&header, sizeof(header));
+	if (checksumEnabled) {
+		const XXH64_hash_t checksum = XXH3_64bits(compressed.begin(), compressed.size());
+		wr.serializeBytes(&checksum, sizeof(checksum));
+	}
+	wr.serializeBytes(compressed);
+	len = compressed.size();
+	return wr.finish();
+}
+
 static ReliablePacket* sendPacket(TransportData* self,
                                   Reference<Peer> peer,
                                   ISerializeSource const& what,
@@ -506,6 +587,8 @@ ACTOR Future<Void> connectionMonitor(Reference<Peer> peer) {
 	state Endpoint remotePingEndpoint({ peer->destination }, Endpoint::wellKnownToken(WLTOKEN_PING_PACKET));
 	// set this to not immediately close the connection as idle if the peer already existed
 	peer->lastDataPacketSentTime = now();
+	state int64_t lastPingBytesReceived = peer->bytesReceived;
+	state int suppressedPings = 0;
 	loop {
 		if (!FlowTransport::isClient() && !peer->destination.isPublic() && peer->compatible) {
 			// Don't send ping messages to clients unless necessary. Instead monitor incoming client pings.
@@ -547,9 +630,21 @@ ACTOR Future<Void> connectionMonitor(Reference<Peer> peer) {
 
 		wait(delayJittered(FLOW_KNOBS->CONNECTION_MONITOR_LOOP_TIME, TaskPriority::ReadSocket));
 
+		// A connection that delivered data since the last check is alive without a ping. Still ping it every so often
+		// to keep sampling its latency.
+		if (peer->bytesReceived > lastPingBytesReceived &&
+		    suppressedPings < FLOW_KNOBS->CONNECTION_MONITOR_MAX_SUPPRESSED_PINGS) {
+			lastPingBytesReceived = peer->bytesReceived;
+			++suppressedPings;
+			++peer->pingsSuppressed;
+			continue;
+		}
+		suppressedPings = 0;
+
 		// TODO: Stop monitoring and close the connection with no onDisconnect requests outstanding
 		state PingRequest pingRequest;
 		FlowTransport::transport().sendUnreliable(SerializeSource<PingRequest>(pingRequest), remotePingEndpoint, true);
+		++peer->pingsSent;
 		state int64_t startingBytes = peer->bytesReceived;
 		state int timeouts = 0;
 		state double startTime = now();
@@ -584,10 +679,14 @@ ACTOR Future<Void> connectionMonitor(Reference<Peer> peer) {
 				}
 			}
 		}
+		// Only bytes received after the ping's reply show that the connection is busy
+		lastPingBytesReceived = peer->bytesReceived;
 	}
 }
 
-ACTOR Future<Void> connectionWriter(Reference<Peer> self, Reference<IConnection> conn) {
+ACTOR Future<Void> connectionWriter(Reference<Peer> self, Reference<IConnection> conn, bool bulkLane = false) {
+	state UnsentPacketQueue* unsent = bulkLane ? &self->bulkUnsent : &self->unsent;
+	state AsyncTrigger* dataToSend = bulkLane ? &self->bulkDataToSend : &self->dataToSend;
 	state double lastWriteTime = now();
 	loop {
 		// wait( delay(0, TaskPriority::WriteSocket) );
@@ -601,14 +700,14 @@ ACTOR Future<Void> connectionWriter(Reference<Peer> self, Reference<IConnection>
 		loop {
 			lastWriteTime = now();
 
-			int sent = conn->write(self->unsent.getUnsent(), /* limit= */ FLOW_KNOBS->MAX_PACKET_SEND_BYTES);
+			int sent = conn->writePackets(unsent->getUnsent(), /* limit= */ FLOW_KNOBS->MAX_PACKET_SEND_BYTES);
 			if (sent) {
 				self->bytesSent += sent;
 				self->transport->bytesSent += sent;
-				self->unsent.sent(sent);
+				unsent->sent(sent);
 			}
 
-			if (self->unsent.empty()) {
+			if (unsent->empty()) {
 				break;
 			}
 
@@ -619,9 +718,100 @@ ACTOR Future<Void> connectionWriter(Reference<Peer> self, Reference<IConnection>
 		}
 
 		// Wait until there is something to send
-		while (self->unsent.empty())
-			wait(self->dataToSend.onTrigger());
+		while (unsent->empty())
+			wait(dataToSend->onTrigger());
+	}
+}
+
+// Runs an open bulk lane until it or the main connection closes. The replies queued on a bulk lane are lost with
+// it, so when it closes on its own it fails the main connection too, which tells whoever waits for them.
+ACTOR Future<Void> runBulkLane(Reference<Peer> self, Reference<IConnection> conn, Future<Void> reader) {
+	state Future<Void> disconnect = self->disconnect.getFuture();
+	state Promise<Void> failed = self->bulkLaneFailed;
+	state bool mainClosed = false;
+	self->bulkLaneConnected = true;
+	try {
+		choose {
+			when(wait(connectionWriter(self, conn, true) || reader)) {}
+			when(wait(disconnect)) {
+				mainClosed = true;
+			}
+		}
+		throw connection_failed();
+	} catch (Error& e) {
+		self->bulkLaneConnected = false;
+		self->bulkUnsent.discardAll();
+		conn->close();
+		if (e.code() == error_code_actor_cancelled) {
+			throw;
+		}
+		if (!mainClosed) {
+			TraceEvent("BulkLaneClosed", conn->getDebugID())
+			    .errorUnsuppressed(e)
+			    .suppressFor(1.0)
+			    .detail("PeerAddr", self->destination);
+			if (failed.canBeSet()) {
+				failed.sendError(connection_failed());
+			}
+		}
+	}
+	return Void();
+}
+
+// Opens a bulk lane for the main connection that connectionKeeper just opened, retrying until the main connection
+// closes. Until it opens, everything goes out on the main connection.
+ACTOR Future<Void> openBulkLane(Reference<Peer> self) {
+	state Future<Void> disconnect = self->disconnect.getFuture();
+	state Reference<IConnection> conn;
+	loop {
+		try {
+			choose {
+				when(Reference<IConnection> _conn = wait(INetworkConnections::net()->connect(self->destination))) {
+					conn = _conn;
+				}
+				when(wait(delay(FLOW_KNOBS->CONNECTION_MONITOR_TIMEOUT))) {
+					throw connection_failed();
+				}
+				when(wait(disconnect)) {
+					return Void();
+				}
+			}
+			choose {
+				when(wait(conn->connectHandshake())) {}
+				when(wait(disconnect)) {
+					conn->close();
+					return Void();
+				}
+			}
+			break;
+		} catch (Error& e) {
+			if (conn) {
+				conn->close();
+				conn = Reference<IConnection>();
+			}
+			if (e.code() == error_code_actor_cancelled) {
+				throw;
+			}
+			TraceEvent("BulkLaneConnectFailed")
+			    .errorUnsuppressed(e)
+			    .suppressFor(1.0)
+			    .detail("PeerAddr", self->destination);
+		}
+		choose {
+			when(wait(delayJittered(FLOW_KNOBS->MAX_RECONNECTION_TIME))) {}
+			when(wait(disconnect)) {
+				return Void();
+			}
+		}
 	}
+
+	TraceEvent("BulkLaneConnected", conn->getDebugID()).suppressFor(1.0).detail("PeerAddr", self->destination);
+	self->prependConnectPacket(true);
+	wait(runBulkLane(
+	    self,
+	    conn,
+	    connectionReader(self->transport, conn, self, Promise<Reference<Peer>>(), Promise<Reference<Peer>>())));
+	return Void();
 }
 
 ACTOR Future<Void> delayedHealthUpdate(NetworkAddress address, bool* tooManyConnectionsClosed) {
@@ -658,10 +848,12 @@ ACTOR Future<Void> connectionKeeper(Reference<Peer> self,
 	state Optional<double> firstConnFailedTime = Optional<double>();
 	state int retryConnect = false;
 	state bool tooManyConnectionsClosed = false;
+	state bool outgoing;
 
 	loop {
 		try {
 			delayedHealthUpdateF = Future<Void>();
+			outgoing = !conn;
 
 			if (!conn) { // Always, except for the first loop with an incoming connection
 				self->outgoingConnectionIdle = true;
@@ -726,7 +918,8 @@ ACTOR Future<Void> connectionKeeper(Reference<Peer> self,
 							    .suppressFor(1.0)
 							    .detail("PeerAddr", self->destination);
 							self->prependConnectPacket();
-							reader = connectionReader(self->transport, conn, self, Promise<Reference<Peer>>());
+							reader = connectionReader(
+							    self->transport, conn, self, Promise<Reference<Peer>>(), Promise<Reference<Peer>>());
 						}
 						when(wait(delay(FLOW_KNOBS->CONNECTION_MONITOR_TIMEOUT))) {
 							throw connection_failed();
@@ -754,8 +947,13 @@ ACTOR Future<Void> connectionKeeper(Reference<Peer> self,
 				if (!delayedHealthUpdateF.isValid())
 					delayedHealthUpdateF = delayedHealthUpdate(self->destination, &tooManyConnectionsClosed);
 				self->connected = true;
+				self->bulkLaneFailed = Promise<Void>();
+				if (outgoing && FLOW_KNOBS->FLOW_TRANSPORT_BULK_LANE) {
+					self->bulkLane.cancel();
+					self->bulkLane = openBulkLane(self);
+				}
 				wait(connectionWriter(self, conn) || reader || connectionMonitor(self) ||
-				     self->resetConnection.onTrigger());
+				     self->resetConnection.onTrigger() || self->bulkLaneFailed.getFuture());
 				TraceEvent("ConnectionReset", conn ? conn->getDebugID() : UID())
 				    .suppressFor(1.0)
 				    .detail("PeerAddr", self->destination);
@@ -772,6 +970,7 @@ ACTOR Future<Void> connectionKeeper(Reference<Peer> self,
 			}
 		} catch (Error& e) {
 			self->connected = false;
+			self->compressionAccepted = false;
 			delayedHealthUpdateF.cancel();
 			if (now() - self->lastConnectTime > FLOW_KNOBS->RECONNECTION_RESET_TIME) {
 				self->reconnectionDelay = FLOW_KNOBS->INITIAL_RECONNECTION_TIME;
@@ -897,7 +1096,9 @@ Peer::Peer(TransportData* transport, NetworkAddress const& destination)
     lastLoggedBytesReceived(0), lastLoggedBytesSent(0), timeoutCount(0),
     protocolVersion(Reference<AsyncVar<Optional<ProtocolVersion>>>(new AsyncVar<Optional<ProtocolVersion>>())),
     connectOutgoingCount(0), connectIncomingCount(0), connectFailedCount(0),
-    connectLatencies(destination.isPublic() ? FLOW_KNOBS->PING_SKETCH_ACCURACY : 0.1) {
+    connectLatencies(destination.isPublic() ? FLOW_KNOBS->PING_SKETCH_ACCURACY : 0.1), bulkLaneConnected(false),
+    compressionAccepted(false), compressedPackets(0), bytesBeforeCompression(0), bytesAfterCompression(0),
+    compressionSeconds(0.0), pingsSent(0), pingsSuppressed(0) {
 	IFailureMonitor::failureMonitor().setStatus(destination, FailureStatus(false));
 }
 
@@ -909,7 +1110,7 @@ void Peer::send(PacketBuffer* pb, ReliablePacket* rp, bool firstUnsent) {
 		dataToSend.trigger();
 }
 
-void Peer::prependConnectPacket() {
+void Peer::prependConnectPacket(bool bulkLane) {
 	// Send the ConnectPacket expected at the beginning of a new connection
 	ConnectPacket pkt;
 	if (transport->localAddresses.getAddressList().address.isTLS() == destination.isTLS()) {
@@ -928,6 +1129,12 @@ void Peer::prependConnectPacket() {
 	pkt.protocolVersion = g_network->protocolVersion();
 	pkt.protocolVersion.addObjectSerializerFlag();
 	pkt.connectionId = transport->transportId;
+	if (bulkLane) {
+		pkt.flags |= ConnectPacket::FLAG_BULK_LANE;
+	}
+	if (CompressionUtils::supportedFilters.count(CompressionFilter::ZSTD)) {
+		pkt.flags |= ConnectPacket::FLAG_COMPRESSION;
+	}
 
 	PacketBuffer *pb_first = PacketBuffer::create(), *pb_end = nullptr;
 	PacketWriter wr(pb_first, nullptr, Unversioned());
@@ -942,7 +1149,7 @@ void Peer::prependConnectPacket() {
 		checkbuf = checkbuf->next;
 	}
 #endif
-	unsent.prependWriteBuffer(pb_first, pb_end);
+	(bulkLane ? bulkUnsent : unsent).prependWriteBuffer(pb_first, pb_end);
 }
 
 void Peer::discardUnreliablePackets() {
@@ -1000,9 +1207,22 @@ void Peer::onIncomingConnection(Reference<Peer> self, Reference<IConnection> con
 	}
 }
 
+void Peer::onIncomingBulkLane(Reference<Peer> self, Reference<IConnection> conn, Future<Void> reader) {
+	TraceEvent("IncomingBulkLane", conn->getDebugID())
+	    .suppressFor(1.0)
+	    .detail("FromAddr", conn->getPeerAddress())
+	    .detail("CanonicalAddr", destination);
+
+	// The peer only opens a new bulk lane for a new main connection, so the old one is done with
+	bulkLane.cancel();
+	prependConnectPacket(true);
+	bulkLane = runBulkLane(self, conn, reader);
+}
+
 TransportData::~TransportData() {
 	for (auto& p : peers) {
 		p.second->connect.cancel();
+		p.second->bulkLane.cancel();
 	}
 }
 
@@ -1128,6 +1348,8 @@ static void scanPackets(TransportData* transport,
 			break;
 		packetLen = *(uint32_t*)p;
 		p += PACKET_LEN_WIDTH;
+		const bool compressed = packetLen & PACKET_COMPRESSED_FLAG;
+		packetLen &= ~PACKET_COMPRESSED_FLAG;
 
 		// Read checksum if present
 		if (checksumEnabled) {
@@ -1148,7 +1370,9 @@ static void scanPackets(TransportData* transport,
 		if (e - p < packetLen)
 			break;
 
-		if (packetLen < sizeof(UID)) {
+		// A compressed packet is smaller than its token and payload, which were at least
+		// FLOW_TRANSPORT_COMPRESSION_MIN_BYTES
+		if (packetLen < sizeof(UID) && !compressed) {
 			if (g_network->isSimulated()) {
 				// Same as ASSERT(false), but prints packet length:
 				ASSERT_GE(packetLen, sizeof(UID));
@@ -1212,7 +1436,13 @@ static void scanPackets(TransportData* transport,
 #endif
 		// remove object serializer flag to account for flat buffer
 		peerProtocolVersion.removeObjectSerializerFlag();
-		ArenaReader reader(arena, StringRef(p, packetLen), AssumeVersion(peerProtocolVersion));
+		Arena packetArena = arena;
+		StringRef packet(p, packetLen);
+		if (compressed) {
+			packetArena = Arena();
+			packet = CompressionUtils::decompress(CompressionFilter::ZSTD, packet, packetArena);
+		}
+		ArenaReader reader(packetArena, packet, AssumeVersion(peerProtocolVersion));
 		UID token;
 		reader >> token;
 
@@ -1260,7 +1490,7 @@ static int getNewBufferSize(const uint8_t* begin,
 	if (len < PACKET_LEN_WIDTH) {
 		return FLOW_KNOBS->MIN_PACKET_BUFFER_BYTES;
 	}
-	const uint32_t packetLen = *(uint32_t*)begin;
+	const uint32_t packetLen = *(uint32_t*)begin & ~PACKET_COMPRESSED_FLAG;
 	if (packetLen > FLOW_KNOBS->PACKET_LIMIT) {
 		TraceEvent(SevError, "PacketLimitExceeded")
 		    .detail("FromPeer", peerAddress.toString())
@@ -1276,7 +1506,8 @@ static int getNewBufferSize(const uint8_t* begin,
 ACTOR static Future<Void> connectionReader(TransportData* transport,
                                            Reference<IConnection> conn,
                                            Reference<Peer> peer,
-                                           Promise<Reference<Peer>> onConnected) {
+                                           Promise<Reference<Peer>> onConnected,
+                                           Promise<Reference<Peer>> onBulkLane) {
 
 	state Arena arena;
 	state uint8_t* unprocessed_begin = nullptr;
@@ -1287,6 +1518,7 @@ ACTOR static Future<Void> connectionReader(TransportData* transport,
 	state bool incompatiblePeerCounted = false;
 	state NetworkAddress peerAddress;
 	state ProtocolVersion peerProtocolVersion;
+	state bool peerAcceptsCompression = false;
 	state bool trusted = transport->allowList(conn->getPeerAddress().ip) && conn->hasTrustedPeer();
 	peerAddress = conn->getPeerAddress();
 
@@ -1396,6 +1628,7 @@ ACTOR static Future<Void> connectionReader(TransportData* transport,
 						}
 						unprocessed_begin += connectPacketSize;
 						expectConnectPacket = false;
+						peerAcceptsCompression = pkt.acceptsCompression();
 
 						if (peer) {
 							peerProtocolVersion = protocolVersion;
@@ -1425,10 +1658,16 @@ ACTOR static Future<Void> connectionReader(TransportData* transport,
 								peer->transport->numIncompatibleConnections++;
 								incompatiblePeerCounted = true;
 							}
-							onConnected.send(peer);
+							if (pkt.isBulkLane()) {
+								onBulkLane.send(peer);
+							} else {
+								onConnected.send(peer);
+							}
 							wait(delay(0)); // Check for cancellation
 						}
 						peer->protocolVersion->set(peerProtocolVersion);
+						// After onConnected, which may have closed the peer's previous connection and so cleared this
+						peer->compressionAccepted = peerAcceptsCompression;
 					}
 				}
 
@@ -1472,7 +1711,8 @@ ACTOR static Future<Void> connectionIncoming(TransportData* self, Reference<ICon
 	try {
 		wait(conn->acceptHandshake());
 		state Promise<Reference<Peer>> onConnected;
-		state Future<Void> reader = connectionReader(self, conn, Reference<Peer>(), onConnected);
+		state Promise<Reference<Peer>> onBulkLane;
+		state Future<Void> reader = connectionReader(self, conn, Reference<Peer>(), onConnected, onBulkLane);
 		choose {
 			when(wait(reader)) {
 				ASSERT(false);
@@ -1481,6 +1721,9 @@ ACTOR static Future<Void> connectionIncoming(TransportData* self, Reference<ICon
 			when(Reference<Peer> p = wait(onConnected.getFuture())) {
 				p->onIncomingConnection(p, conn, reader);
 			}
+			when(Reference<Peer> p = wait(onBulkLane.getFuture())) {
+				p->onIncomingBulkLane(p, conn, reader);
+			}
 			when(wait(delayJittered(FLOW_KNOBS->CONNECTION_MONITOR_TIMEOUT))) {
 				CODE_PROBE(true, "Incoming connection timed out");
 				throw timed_out();
@@ -1775,6 +2018,26 @@ static void sendLocal(TransportData* self, ISerializeSource const& what, const E
 	}
 }
 
+// Moves the packet just written to the end of 'from', which begins at offset 'beginOffset' of 'begin' and ends in
+// 'end', to the end of 'to'. Only its part in 'begin', which may hold earlier packets, is copied.
+static void movePacket(UnsentPacketQueue& from,
+                       UnsentPacketQueue& to,
+                       PacketBuffer* begin,
+                       int beginOffset,
+                       PacketBuffer* end) {
+	PacketWriter wr(to.getWriteBuffer(), nullptr, Unversioned());
+	wr.serializeBytes(begin->data() + beginOffset, begin->bytes_written - beginOffset);
+	PacketBuffer* toEnd = wr.finish();
+	if (begin != end) {
+		toEnd->next = begin->next;
+		toEnd = end;
+	}
+	begin->bytes_written = beginOffset;
+	begin->next = nullptr;
+	from.setWriteBuffer(begin);
+	to.setWriteBuffer(toEnd);
+}
+
 static ReliablePacket* sendPacket(TransportData* self,
                                   Reference<Peer> peer,
                                   ISerializeSource const& what,
@@ -1795,6 +2058,8 @@ static ReliablePacket* sendPacket(TransportData* self,
 	PacketBuffer* pb = peer->unsent.getWriteBuffer();
 	ReliablePacket* rp = reliable ? new ReliablePacket : 0;
 
+	PacketBuffer* const packetBegin = pb;
+	const int packetBeginOffset = pb->bytes_written;
 	int prevBytesWritten = pb->bytes_written;
 	PacketBuffer* checksumPb = pb;
 
@@ -1824,7 +2089,18 @@ static ReliablePacket* sendPacket(TransportData* self,
 	pb = wr.finish();
 	len = wr.size() - packetInfoSize;
 
-	if (checksumEnabled) {
+	// Large replies are compressed for peers which accept it, as they are the bulk of the bytes sent
+	PacketBuffer* compressedEnd = nullptr;
+	if (FLOW_KNOBS->FLOW_TRANSPORT_COMPRESSION && !reliable && peer->compressionAccepted &&
+	    len >= FLOW_KNOBS->FLOW_TRANSPORT_COMPRESSION_MIN_BYTES && len <= FLOW_KNOBS->PACKET_LIMIT &&
+	    !(destination.token.first() & TOKEN_STREAM_FLAG)) {
+		compressedEnd = compressPacket(
+		    peer.getPtr(), peer->unsent, packetBegin, packetBeginOffset, packetInfoSize, checksumEnabled, len);
+	}
+
+	if (compressedEnd) {
+		pb = compressedEnd;
+	} else if (checksumEnabled) {
 		// Find the correct place to start calculating checksum
 		uint32_t checksumUnprocessedLength = len;
 		prevBytesWritten += packetInfoSize;
@@ -1872,9 +2148,11 @@ static ReliablePacket* sendPacket(TransportData* self,
 	}
 
 	// Write packet length and checksum into packet buffer
-	packetInfoBuffer.write(&len, sizeof(len));
-	if (checksumEnabled) {
-		packetInfoBuffer.write(&checksum, sizeof(checksum), sizeof(len));
+	if (!compressedEnd) {
+		packetInfoBuffer.write(&len, sizeof(len));
+		if (checksumEnabled) {
+			packetInfoBuffer.write(&checksum, sizeof(checksum), sizeof(len));
+		}
 	}
 
 	if (len > FLOW_KNOBS->PACKET_LIMIT) {
@@ -1901,7 +2179,18 @@ static ReliablePacket* sendPacket(TransportData* self,
 	}
 #endif
 
-	peer->send(pb, rp, firstUnsent);
+	// Large replies go out on the bulk lane. A reply is the only message to its endpoint, so it can overtake the
+	// messages sent before it, unlike those to a stream.
+	if (!reliable && peer->bulkLaneConnected && len >= FLOW_KNOBS->FLOW_TRANSPORT_BULK_LANE_MIN_PACKET_BYTES &&
+	    !(destination.token.first() & TOKEN_STREAM_FLAG)) {
+		bool firstBulkUnsent = peer->bulkUnsent.empty();
+		movePacket(peer->unsent, peer->bulkUnsent, packetBegin, packetBeginOffset, pb);
+		if (firstBulkUnsent) {
+			peer->bulkDataToSend.trigger();
+		}
+	} else {
+		peer->send(pb, rp, firstUnsent);
+	}
 	if (destination.token != Endpoint::wellKnownToken(WLTOKEN_PING_PACKET)) {
 		peer->lastDataPacketSentTime = now();
 	}
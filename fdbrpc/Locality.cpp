@@ -331,6 +331,11 @@ LBDistance::Type loadBalanceDistance(LocalityData const& loc1, LocalityData cons
 	// FIXME: add this back in when load balancing works with local requests
 	// if ( g_network->isAddressOnThisHost( addr2 ) )
 	//	return LBDistance::SAME_MACHINE;
+	// A data hall is usually an availability zone, and reads within one are cheaper and faster than across them
+	if (FLOW_KNOBS->LOAD_BALANCE_DATA_HALL_LOCALITY_ENABLED && loc1.dataHallId().present() &&
+	    loc1.dataHallId() == loc2.dataHallId() && loc1.dcId() == loc2.dcId()) {
+		return LBDistance::SAME_DATA_HALL;
+	}
 	if (FLOW_KNOBS->LOAD_BALANCE_DC_ID_LOCALITY_ENABLED && loc1.dcId().present() && loc1.dcId() == loc2.dcId()) {
 		return LBDistance::SAME_DC;
 	}
@@ -41,6 +41,7 @@
 #include "fdbrpc/AsyncFileEncrypted.h"
 #include "fdbrpc/AsyncFileWinASIO.actor.h"
 #include "fdbrpc/AsyncFileKAIO.actor.h"
+#include "fdbrpc/AsyncFileIOUring.actor.h"
 #include "flow/AsioReactor.h"
 #include "flow/Platform.h"
 #include "fdbrpc/AsyncFileWriteChecker.actor.h"
@@ -71,10 +72,16 @@ Future<Reference<class IAsyncFile>> Net2FileSystem::open(const std::string& file
 	// cases, DISABLE_POSIX_KERNEL_AIO knob can be enabled to fallback to EIO instead
 	// of Kernel AIO. And EIO_USE_ODIRECT can be used to turn on or off O_DIRECT within
 	// EIO.
+	// When ENABLE_IO_URING is set and the ring could be created, io_uring takes the place of Kernel AIO.
 	if ((flags & IAsyncFile::OPEN_UNBUFFERED) && !(flags & IAsyncFile::OPEN_NO_AIO) &&
-	    !FLOW_KNOBS->DISABLE_POSIX_KERNEL_AIO)
-		f = AsyncFileKAIO::open(filename, flags, mode, nullptr);
-	else
+	    !FLOW_KNOBS->DISABLE_POSIX_KERNEL_AIO) {
+#ifdef WITH_LIBURING
+		if (AsyncFileIOUring::isInitialized())
+			f = AsyncFileIOUring::open(filename, flags, mode, nullptr);
+		else
+#endif
+			f = AsyncFileKAIO::open(filename, flags, mode, nullptr);
+	} else
 #endif
 		f = Net2AsyncFile::open(
 		    filename,
@@ -117,8 +124,18 @@ void Net2FileSystem::newFileSystem(double ioTimeout, const std::string& fileSyst
 Net2FileSystem::Net2FileSystem(double ioTimeout, const std::string& fileSystemPath) {
 	Net2AsyncFile::init();
 #ifdef __linux__
-	if (!FLOW_KNOBS->DISABLE_POSIX_KERNEL_AIO)
-		AsyncFileKAIO::init(Reference<IEventFD>(N2::ASIOReactor::getEventFD()), ioTimeout);
+	if (!FLOW_KNOBS->DISABLE_POSIX_KERNEL_AIO) {
+		bool useIOUring = false;
+		if (FLOW_KNOBS->ENABLE_IO_URING) {
+#ifdef WITH_LIBURING
+			useIOUring = AsyncFileIOUring::init(Reference<IEventFD>(N2::ASIOReactor::getEventFD()), ioTimeout);
+#else
+			TraceEvent(SevWarnAlways, "IOUringUnavailable").detail("Reason", "Not built with liburing");
+#endif
+		}
+		if (!useIOUring)
+			AsyncFileKAIO::init(Reference<IEventFD>(N2::ASIOReactor::getEventFD()), ioTimeout);
+	}
 
 	if (fileSystemPath.empty()) {
 		checkFileSystem = false;
@@ -18,8 +18,11 @@
  * limitations under the License.
  */
 
+#include <cmath>
+
 #include "fdbrpc/QueueModel.h"
 #include "fdbrpc/LoadBalance.h"
+#include "flow/UnitTest.h"
 
 void QueueModel::endRequest(uint64_t id, double latency, double penalty, double delta, bool clean, bool futureVersion) {
 	auto& d = data[id];
@@ -29,6 +32,9 @@ void QueueModel::endRequest(uint64_t id, double latency, double penalty, double
 
 	if (clean) {
 		d.latency = latency;
+		if (FLOW_KNOBS->LOAD_BALANCE_HEDGE_BY_LATENCY) {
+			d.addLatencySample(latency);
+		}
 	} else {
 		d.latency = std::max(d.latency, latency);
 	}
@@ -47,11 +53,37 @@ void QueueModel::endRequest(uint64_t id, double latency, double penalty, double
 
 	if (penalty > 0) {
 		d.penalty = penalty;
+		d.penaltyTime = now();
+	}
+}
+
+void QueueData::addLatencySample(double latency) {
+	if (!latencySketch) {
+		latencySketch = std::make_unique<DDSketch<double>>(FLOW_KNOBS->LOAD_BALANCE_LATENCY_SKETCH_ACCURACY);
+	}
+	latencySketch->addSample(latency);
+	if (latencySketch->getPopulationSize() >= FLOW_KNOBS->LOAD_BALANCE_LATENCY_WINDOW) {
+		latencyP50 = latencySketch->median();
+		latencyP99 = latencySketch->percentile(0.99);
+		hedgeLatency = latencySketch->percentile(FLOW_KNOBS->LOAD_BALANCE_HEDGE_PERCENTILE);
+		latencySketch->clear();
+	}
+}
+
+void QueueData::decay(double t) {
+	if (FLOW_KNOBS->LOAD_BALANCE_PENALTY_HALF_LIFE > 0 && penalty > 1.0 && t > penaltyTime) {
+		penalty = 1.0 + (penalty - 1.0) * std::exp2((penaltyTime - t) / FLOW_KNOBS->LOAD_BALANCE_PENALTY_HALF_LIFE);
+		penaltyTime = t;
+	}
+	if (admissionWindow > 0 && t - admissionWindowTime > FLOW_KNOBS->LOAD_BALANCE_ADMISSION_WINDOW_EXPIRY) {
+		admissionWindow = 0;
 	}
 }
 
 QueueData const& QueueModel::getMeasurement(uint64_t id) {
-	return data[id]; // return smoothed penalty
+	auto& d = data[id];
+	d.decay();
+	return d; // return smoothed penalty
 }
 
 double QueueModel::addRequest(uint64_t id) {
@@ -60,6 +92,14 @@ double QueueModel::addRequest(uint64_t id) {
 	return d.penalty;
 }
 
+void QueueModel::updateReadLoad(uint64_t id, double cacheHitRate, int readQueueDepth, double admissionWindow) {
+	auto& d = data[id];
+	d.cacheHitRate = cacheHitRate;
+	d.readQueueDepth = readQueueDepth;
+	d.admissionWindow = admissionWindow;
+	d.admissionWindowTime = now();
+}
+
 void QueueModel::updateTssEndpoint(uint64_t endpointId, const TSSEndpointData& tssData) {
 	auto& d = data[endpointId];
 	d.tssData = tssData;
@@ -90,6 +130,49 @@ Optional<BasicLoadBalancedReply> getBasicLoadBalancedReply(const void*) {
 	return Optional<BasicLoadBalancedReply>();
 }
 
+TEST_CASE("/fdbrpc/QueueModel/LatencyPercentiles") {
+	QueueData d;
+	const int window = FLOW_KNOBS->LOAD_BALANCE_LATENCY_WINDOW;
+	for (int i = 0; i < window - 1; i++) {
+		d.addLatencySample(0.001);
+	}
+	ASSERT_EQ(d.hedgeLatency, 0);
+	d.addLatencySample(0.001);
+	ASSERT_GT(d.hedgeLatency, 0);
+
+	// A window with a few slow replies at the end
+	const int slow = std::max(2, window * 3 / 100);
+	for (int i = 0; i < window; i++) {
+		d.addLatencySample(i < window - slow ? 0.001 : 0.1);
+	}
+	const double accuracy = 1.0 + 2 * FLOW_KNOBS->LOAD_BALANCE_LATENCY_SKETCH_ACCURACY;
+	ASSERT(d.latencyP50 > 0.001 / accuracy && d.latencyP50 < 0.001 * accuracy);
+	ASSERT(d.latencyP99 > 0.1 / accuracy && d.latencyP99 < 0.1 * accuracy);
+	ASSERT(d.hedgeLatency >= d.latencyP50 && d.hedgeLatency <= d.latencyP99);
+	return Void();
+}
+
+TEST_CASE("/fdbrpc/QueueModel/PenaltyDecay") {
+	QueueData d;
+	d.penalty = 3.0;
+	d.penaltyTime = now();
+	d.admissionWindow = 2.0;
+	d.admissionWindowTime = now();
+
+	const double halfLife = FLOW_KNOBS->LOAD_BALANCE_PENALTY_HALF_LIFE;
+	d.decay(now() + halfLife);
+	if (halfLife > 0) {
+		ASSERT(d.penalty > 1.999 && d.penalty < 2.001);
+	} else {
+		ASSERT_EQ(d.penalty, 3.0);
+	}
+	ASSERT_EQ(d.admissionWindow, halfLife > FLOW_KNOBS->LOAD_BALANCE_ADMISSION_WINDOW_EXPIRY ? 0 : 2.0);
+
+	d.decay(now() + halfLife + FLOW_KNOBS->LOAD_BALANCE_ADMISSION_WINDOW_EXPIRY + 1.0);
+	ASSERT_EQ(d.admissionWindow, 0);
+	return Void();
+}
+
 /*
 void QueueModel::addMeasurement( uint64_t id, QueueDetails qd ){
     if (data[new_index].count(id))
@@ -90,29 +90,47 @@ void Counter::clear() {
 }
 
 void CounterCollection::logToTraceEvent(TraceEvent& te) {
-	NetworkAddress addr = g_network->getLocalAddress();
+	MetricCollection* metrics = MetricCollection::getMetricCollection();
+	std::string ip_str, port_str;
+	if (metrics != nullptr) {
+		NetworkAddress addr = g_network->getLocalAddress();
+		ip_str = addr.ip.toString();
+		port_str = std::to_string(addr.port);
+	}
+	double intervalEnd = now();
 	for (ICounter* c : counters) {
-		MetricCollection* metrics = MetricCollection::getMetricCollection();
 		if (metrics != nullptr) {
-			std::string ip_str = addr.ip.toString();
-			std::string port_str = std::to_string(addr.port);
-			uint64_t val = c->getValue();
+			// The change of a counter since the last interval is exported rather than its total, so the collector
+			// doesn't have to diff consecutive values, and a restart doesn't look like the counter going backwards
+			std::string metricName = name + "." + c->getName();
+			int64_t val = c->isMonotonic() ? c->getIntervalDelta() : c->getValue();
 			switch (c->model) {
 			case MetricsDataModel::OTLP: {
-				if (metrics->sumMap.find(c->id) != metrics->sumMap.end()) {
-					metrics->sumMap[c->id].points.emplace_back(static_cast<int64_t>(val));
+				if (c->isMonotonic()) {
+					auto& sum = metrics->sumMap[c->id];
+					if (sum.name.empty()) {
+						sum = OTEL::OTELSum(metricName);
+						sum.aggregation = OTEL::AGGREGATION_TEMPORALITY_DELTA;
+					}
+					auto& point = sum.points.emplace_back(val);
+					point.addAttribute("ip", ip_str);
+					point.addAttribute("port", port_str);
+					point.addAttribute("id", id);
+					point.startTime = logTime;
 				} else {
-					metrics->sumMap[c->id] = OTEL::OTELSum(name + "." + c->getName(), val);
+					createOtelGauge(c->id, metricName, val, { OTEL::Attribute("id", id) });
 				}
-				metrics->sumMap[c->id].points.back().addAttribute("ip", ip_str);
-				metrics->sumMap[c->id].points.back().addAttribute("port", port_str);
-				metrics->sumMap[c->id].points.back().startTime = logTime;
+				break;
 			}
 			case MetricsDataModel::STATSD: {
 				std::vector<std::pair<std::string, std::string>> statsd_attributes{ { "ip", ip_str },
 					                                                                { "port", port_str } };
-				metrics->statsd_message.push_back(createStatsdMessage(
-				    c->getName(), StatsDMetric::COUNTER, std::to_string(val) /*, statsd_attributes*/));
+				metrics->statsd_message.push_back(
+				    createStatsdMessage(metricName,
+				                        c->isMonotonic() ? StatsDMetric::COUNTER : StatsDMetric::GAUGE,
+				                        std::to_string(val),
+				                        statsd_attributes));
+				break;
 			}
 			case MetricsDataModel::NONE:
 			default: {
@@ -124,6 +142,7 @@ void CounterCollection::logToTraceEvent(TraceEvent& te) {
 		}
 		c->resetInterval();
 	}
+	logTime = intervalEnd;
 }
 
 class CounterCollectionImpl {
@@ -289,20 +308,24 @@ void LatencySample::logSample() {
 			createOtelGauge(p95id, name + "p95", p95);
 			createOtelGauge(p99id, name + "p99", p99);
 			createOtelGauge(p999id, name + "p99_9", p99_9);
+			break;
 		}
 		case MetricsDataModel::STATSD: {
 			std::vector<std::pair<std::string, std::string>> statsd_attributes{ { "ip", ip_str },
 				                                                                { "port", port_str } };
-			auto median_gauge =
-			    createStatsdMessage(name + "p50", StatsDMetric::GAUGE, std::to_string(p50) /*, statsd_attributes*/);
-			auto p90_gauge =
-			    createStatsdMessage(name + "p90", StatsDMetric::GAUGE, std::to_string(p90) /*, statsd_attributes*/);
-			auto p95_gauge =
-			    createStatsdMessage(name + "p95", StatsDMetric::GAUGE, std::to_string(p95) /*, statsd_attributes*/);
-			auto p99_gauge =
-			    createStatsdMessage(name + "p99", StatsDMetric::GAUGE, std::to_string(p99) /*, statsd_attributes*/);
-			auto p999_gauge =
-			    createStatsdMessage(name + "p99.9", StatsDMetric::GAUGE, std::to_string(p99_9) /*, statsd_attributes*/);
+			metrics->statsd_message.push_back(createStatsdMessage(
+			    name + "count", StatsDMetric::COUNTER, std::to_string(sketch.getPopulationSize()), statsd_attributes));
+			metrics->statsd_message.push_back(
+			    createStatsdMessage(name + "p50", StatsDMetric::GAUGE, std::to_string(p50), statsd_attributes));
+			metrics->statsd_message.push_back(
+			    createStatsdMessage(name + "p90", StatsDMetric::GAUGE, std::to_string(p90), statsd_attributes));
+			metrics->statsd_message.push_back(
+			    createStatsdMessage(name + "p95", StatsDMetric::GAUGE, std::to_string(p95), statsd_attributes));
+			metrics->statsd_message.push_back(
+			    createStatsdMessage(name + "p99", StatsDMetric::GAUGE, std::to_string(p99), statsd_attributes));
+			metrics->statsd_message.push_back(
+			    createStatsdMessage(name + "p99.9", StatsDMetric::GAUGE, std::to_string(p99_9), statsd_attributes));
+			break;
 		}
 		case MetricsDataModel::NONE:
 		default: {
@@ -42,37 +42,45 @@ namespace bi = boost::intrusive;
 struct EvictablePage {
 	void* data;
 	int index;
+	bool referenced; // For CLOCK eviction: whether the page has been used since the clock hand last passed it
 	class Reference<struct EvictablePageCache> pageCache;
 	bi::list_member_hook<> member_hook;
 
 	virtual bool evict() = 0; // true if page was evicted, false if it isn't immediately evictable (but will be evicted
 	                          // regardless if possible)
 
-	EvictablePage(Reference<EvictablePageCache> pageCache) : data(0), index(-1), pageCache(pageCache) {}
+	EvictablePage(Reference<EvictablePageCache> pageCache)
+	  : data(0), index(-1), referenced(false), pageCache(pageCache) {}
 	virtual ~EvictablePage();
 };
 
 struct EvictablePageCache : ReferenceCounted<EvictablePageCache> {
 	using List =
 	    bi::list<EvictablePage, bi::member_hook<EvictablePage, bi::list_member_hook<>, &EvictablePage::member_hook>>;
-	enum CacheEvictionType { RANDOM = 0, LRU = 1 };
+	// CLOCK approximates LRU at the cost of RANDOM: a hit only sets the page's referenced bit, where LRU moves the page
+	// in a list, and eviction passes over pages that have been hit since it last looked at them.
+	enum CacheEvictionType { RANDOM = 0, LRU = 1, CLOCK = 2 };
 
 	static CacheEvictionType evictionPolicyStringToEnum(const std::string& policy) {
 		std::string cep = policy;
 		std::transform(cep.begin(), cep.end(), cep.begin(), ::tolower);
-		if (cep != "random" && cep != "lru")
+		if (cep != "random" && cep != "lru" && cep != "clock")
 			throw invalid_cache_eviction_policy();
 
 		if (cep == "random")
 			return RANDOM;
+		if (cep == "clock")
+			return CLOCK;
 		return LRU;
 	}
 
-	EvictablePageCache() : pageSize(0), maxPages(0), cacheEvictionType(RANDOM) {}
+	EvictablePageCache() : pageSize(0), maxPages(0), clockHand(0), cacheEvictionType(RANDOM) {}
 
 	explicit EvictablePageCache(int pageSize, int64_t maxSize)
-	  : pageSize(pageSize), maxPages(maxSize / pageSize),
-	    cacheEvictionType(evictionPolicyStringToEnum(FLOW_KNOBS->CACHE_EVICTION_POLICY)) {
+	  : EvictablePageCache(pageSize, maxSize, evictionPolicyStringToEnum(FLOW_KNOBS->CACHE_EVICTION_POLICY)) {}
+
+	EvictablePageCache(int pageSize, int64_t maxSize, CacheEvictionType cacheEvictionType)
+	  : pageSize(pageSize), maxPages(maxSize / pageSize), clockHand(0), cacheEvictionType(cacheEvictionType) {
 		cacheEvictions.init("EvictablePageCache.CacheEvictions"_sr);
 	}
 
@@ -82,8 +90,9 @@ struct EvictablePageCache : ReferenceCounted<EvictablePageCache> {
 
 		page->data = allocateFast4kAligned(pageSize);
 
-		if (RANDOM == cacheEvictionType) {
+		if (LRU != cacheEvictionType) {
 			page->index = pages.size();
+			page->referenced = true;
 			pages.push_back(page);
 		} else {
 			lruPages.push_back(*page); // new page is considered the most recently used (placed at LRU tail)
@@ -91,7 +100,9 @@ struct EvictablePageCache : ReferenceCounted<EvictablePageCache> {
 	}
 
 	void updateHit(EvictablePage* page) {
-		if (RANDOM != cacheEvictionType) {
+		if (CLOCK == cacheEvictionType) {
+			page->referenced = true;
+		} else if (LRU == cacheEvictionType) {
 			// on a hit, update page's location in the LRU so that it's most recent (tail)
 			lruPages.erase(List::s_iterator_to(*page));
 			lruPages.push_back(*page);
@@ -110,8 +121,28 @@ struct EvictablePageCache : ReferenceCounted<EvictablePageCache> {
 					}
 				}
 			}
+		} else if (CLOCK == cacheEvictionType) {
+			if (pages.size() >= (uint64_t)maxPages && !pages.empty()) {
+				// One turn of the hand clears every referenced bit, so it finds a candidate within a turn. Evicting
+				// moves the last page to the hand, so the hand stays put.
+				int attempts = 0;
+				for (size_t steps = 0; steps <= pages.size() && attempts < FLOW_KNOBS->MAX_EVICT_ATTEMPTS; steps++) {
+					if (clockHand >= pages.size()) {
+						clockHand = 0;
+					}
+					EvictablePage* page = pages[clockHand];
+					if (page->referenced) {
+						page->referenced = false;
+					} else if (page->evict()) {
+						++cacheEvictions;
+						break;
+					} else {
+						++attempts;
+					}
+					++clockHand;
+				}
+			}
 		} else {
-			// For now, LRU is the only other CACHE_EVICTION option
 			if (lruPages.size() >= (uint64_t)maxPages) {
 				int i = 0;
 				// try the least recently used pages first (starting at head of the LRU list)
@@ -126,10 +157,11 @@ struct EvictablePageCache : ReferenceCounted<EvictablePageCache> {
 		}
 	}
 
-	std::vector<EvictablePage*> pages;
+	std::vector<EvictablePage*> pages; // For RANDOM and CLOCK
 	List lruPages;
 	int pageSize;
 	int64_t maxPages;
+	size_t clockHand; // The index in pages at which CLOCK eviction looks next
 	Int64MetricHandle cacheEvictions;
 	const CacheEvictionType cacheEvictionType;
 };
@@ -582,6 +614,88 @@ struct AFCPage : public EvictablePage, public FastAllocated<AFCPage> {
 		return writing.getFuture();
 	}
 
+	// Flushes dirty pages at consecutive offsets of the same file with one write
+	static Future<Void> flushRun(std::vector<AFCPage*> const& run) {
+		CODE_PROBE(true, "Cached file pages flushed with one write");
+		for (AFCPage const* page : run) {
+			ASSERT(page->dirty && (page->valid || !page->notReading.isReady() || page->notReading.isError()));
+		}
+
+		Promise<Void> writing;
+		Future<Void> written = writeThroughRun(run, writing);
+		for (AFCPage* page : run) {
+			page->notFlushing = written;
+			page->clearDirty();
+		}
+		return writing.getFuture();
+	}
+
+	ACTOR static Future<Void> writeThroughRun(std::vector<AFCPage*> run, Promise<Void> writing) {
+		state AsyncFileCached* owner = run[0]->owner;
+		state int pageSize = run[0]->pageCache->pageSize;
+		state int length = 0;
+		state uint8_t* buffer = nullptr;
+		try {
+			std::vector<Future<Void>> idle;
+			for (AFCPage* page : run) {
+				++page->writeThroughCount;
+				page->updateFlushableIndex();
+				idle.push_back(page->notReading && page->notFlushing);
+			}
+			wait(waitForAll(idle));
+
+			if (owner->getRateControl()) {
+				// The same allowance as writing each page by itself
+				int allowance = run.size();
+				if (FLOW_KNOBS->FLOW_CACHEDFILE_WRITE_IO_SIZE > 0) {
+					allowance = (run.size() * pageSize + FLOW_KNOBS->FLOW_CACHEDFILE_WRITE_IO_SIZE - 1) /
+					            FLOW_KNOBS->FLOW_CACHEDFILE_WRITE_IO_SIZE;
+				}
+				wait(owner->getRateControl()->getAllowance(allowance));
+			}
+
+			// The file may have been truncated while waiting, and pages past its end are not written
+			int pages = 0;
+			while (pages < run.size() && !run[pages]->truncated && run[pages]->pageOffset < owner->length) {
+				++pages;
+			}
+			if (pages > 0) {
+				length = pages * pageSize;
+				buffer = static_cast<uint8_t*>(allocateFast4kAligned(length));
+				for (int i = 0; i < pages; i++) {
+					memcpy(buffer + i * pageSize, run[i]->data, pageSize);
+				}
+				const int64_t offset = run[0]->pageOffset;
+				if (offset + length > owner->length) {
+					memset(buffer + owner->length - offset, 0, offset + length - owner->length);
+				}
+				wait(owner->uncached->write(buffer, length, offset));
+				freeFast4kAligned(length, buffer);
+				buffer = nullptr;
+			}
+		} catch (Error& e) {
+			if (buffer != nullptr) {
+				freeFast4kAligned(length, buffer);
+			}
+			for (AFCPage* page : run) {
+				--page->writeThroughCount;
+				page->setDirty();
+			}
+			writing.sendError(e);
+			throw;
+		}
+		for (AFCPage* page : run) {
+			--page->writeThroughCount;
+			page->updateFlushableIndex();
+		}
+
+		writing.send(Void());
+
+		run[0]->pageCache->try_evict();
+
+		return Void();
+	}
+
 	Future<Void> quiesce() {
 		if (dirty)
 			flush();
@@ -0,0 +1,730 @@
+/*
+ * AsyncFileIOUring.actor.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#if defined(__linux__) && defined(WITH_LIBURING)
+
+// When actually compiled (NO_INTELLISENSE), include the generated version of this file.  In intellisense use the source
+// version.
+#if defined(NO_INTELLISENSE) && !defined(FLOW_ASYNCFILEIOURING_ACTOR_G_H)
+#define FLOW_ASYNCFILEIOURING_ACTOR_G_H
+#include "fdbrpc/AsyncFileIOUring.actor.g.h"
+#elif !defined(FLOW_ASYNCFILEIOURING_ACTOR_H)
+#define FLOW_ASYNCFILEIOURING_ACTOR_H
+
+#include "flow/IAsyncFile.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <liburing.h>
+#include "fdbrpc/AsyncFileEIO.actor.h"
+#include "flow/Knobs.h"
+#include "fdbrpc/Stats.h"
+#include "flow/UnitTest.h"
+#include "flow/genericactors.actor.h"
+#include "flow/actorcompiler.h" // This must be the last #include.
+
+// An IAsyncFile for unbuffered files which issues its reads, writes and syncs through a single io_uring shared by all
+// files of the process.  Like AsyncFileKAIO, operations are queued by priority and submitted in one batch per run loop
+// iteration, and completions are reaped when the ring signals the network thread's eventfd.  Open files are entered
+// in the ring's fixed file table so the kernel doesn't have to look up and reference count the fd for every operation.
+class AsyncFileIOUring final : public IAsyncFile, public ReferenceCounted<AsyncFileIOUring> {
+public:
+	virtual StringRef getClassName() override { return "AsyncFileIOUring"_sr; }
+
+	struct AsyncFileIOUringMetrics {
+		LatencySample readLatencySample = { "AsyncFileIOUringReadLatency",
+			                                UID(),
+			                                FLOW_KNOBS->KAIO_LATENCY_LOGGING_INTERVAL,
+			                                FLOW_KNOBS->KAIO_LATENCY_SKETCH_ACCURACY };
+		LatencySample writeLatencySample = { "AsyncFileIOUringWriteLatency",
+			                                 UID(),
+			                                 FLOW_KNOBS->KAIO_LATENCY_LOGGING_INTERVAL,
+			                                 FLOW_KNOBS->KAIO_LATENCY_SKETCH_ACCURACY };
+		LatencySample syncLatencySample = { "AsyncFileIOUringSyncLatency",
+			                                UID(),
+			                                FLOW_KNOBS->KAIO_LATENCY_LOGGING_INTERVAL,
+			                                FLOW_KNOBS->KAIO_LATENCY_SKETCH_ACCURACY };
+	};
+
+	static AsyncFileIOUringMetrics& getMetrics() {
+		static AsyncFileIOUringMetrics metrics;
+		return metrics;
+	}
+
+	static Future<Reference<IAsyncFile>> open(std::string filename, int flags, int mode, void* ignore) {
+		ASSERT(ctx.initialized);
+		ASSERT(flags & OPEN_UNBUFFERED);
+
+		if (flags & OPEN_LOCK)
+			mode |= 02000; // Enable mandatory locking for this file if it is supported by the filesystem
+
+		std::string open_filename = filename;
+		if (flags & OPEN_ATOMIC_WRITE_AND_CREATE) {
+			ASSERT((flags & OPEN_CREATE) && (flags & OPEN_READWRITE) && !(flags & OPEN_EXCLUSIVE));
+			open_filename = filename + ".part";
+		}
+
+		int fd = ::open(open_filename.c_str(), openFlags(flags), mode);
+		if (fd < 0) {
+			Error e = errno == ENOENT ? file_not_found() : io_error();
+			int ecode = errno; // Save errno in case it is modified before it is used below
+			TraceEvent ev("AsyncFileIOUringOpenFailed");
+			ev.error(e)
+			    .detail("Filename", filename)
+			    .detailf("Flags", "%x", flags)
+			    .detailf("OSFlags", "%x", openFlags(flags))
+			    .detailf("Mode", "0%o", mode)
+			    .GetLastError();
+			if (ecode == EINVAL)
+				ev.detail("Description", "Invalid argument - Does the target filesystem support O_DIRECT?");
+			return e;
+		}
+
+		Reference<AsyncFileIOUring> r(new AsyncFileIOUring(fd, flags, filename));
+		TraceEvent("AsyncFileIOUringOpen")
+		    .detail("Filename", filename)
+		    .detail("Flags", flags)
+		    .detail("Mode", mode)
+		    .detail("Fd", fd)
+		    .detail("FixedFileIndex", r->fixedIndex);
+
+		if (flags & OPEN_LOCK) {
+			// Acquire a "write" lock for the entire file
+			flock lockDesc;
+			lockDesc.l_type = F_WRLCK;
+			lockDesc.l_whence = SEEK_SET;
+			lockDesc.l_start = 0;
+			lockDesc.l_len = 0; // Lock all bytes from l_start through to the end of file, no matter how large it grows
+			lockDesc.l_pid = 0;
+			if (fcntl(fd, F_SETLK, &lockDesc) == -1) {
+				TraceEvent(SevWarn, "UnableToLockFile").detail("Filename", filename).GetLastError();
+				return lock_file_failure();
+			}
+		}
+
+		struct stat buf;
+		if (fstat(fd, &buf)) {
+			TraceEvent("AsyncFileIOUringFStatError").detail("Fd", fd).detail("Filename", filename).GetLastError();
+			return io_error();
+		}
+
+		r->lastFileSize = r->nextFileSize = buf.st_size;
+		return Reference<IAsyncFile>(std::move(r));
+	}
+
+	// Sets up the process's ring.  Returns false if the kernel does not support io_uring, in which case the caller
+	// should fall back to another implementation.
+	static bool init(Reference<IEventFD> ev, double ioTimeout) {
+		ASSERT(!ctx.initialized);
+
+		int rc = io_uring_queue_init(FLOW_KNOBS->IO_URING_QUEUE_DEPTH, &ctx.ring, 0);
+		if (rc < 0) {
+			TraceEvent(SevWarnAlways, "IOUringSetupError").detail("ErrorCode", -rc);
+			return false;
+		}
+
+		rc = io_uring_register_eventfd(&ctx.ring, ev->getFD());
+		if (rc < 0) {
+			TraceEvent(SevWarnAlways, "IOUringRegisterEventFDError").detail("ErrorCode", -rc);
+			io_uring_queue_exit(&ctx.ring);
+			return false;
+		}
+
+		// Register a sparse fixed file table.  Files are entered in it as they are opened, and operations on files
+		// which didn't get a slot use their fd.
+		if (FLOW_KNOBS->IO_URING_FIXED_FILES > 0) {
+			std::vector<int> fds(FLOW_KNOBS->IO_URING_FIXED_FILES, -1);
+			rc = io_uring_register_files(&ctx.ring, fds.data(), fds.size());
+			if (rc < 0) {
+				TraceEvent(SevWarn, "IOUringRegisterFilesError").detail("ErrorCode", -rc);
+			} else {
+				for (int i = fds.size() - 1; i >= 0; --i) {
+					ctx.freeFixedFiles.push_back(i);
+				}
+			}
+		}
+
+		if (!g_network->isSimulated()) {
+			ctx.countSubmit.init("AsyncFile.CountIOUringSubmit"_sr);
+			ctx.countCollect.init("AsyncFile.CountIOUringCollect"_sr);
+			ctx.countSubmitted.init("AsyncFile.CountIOUringSubmitted"_sr);
+			ctx.submitMetric.init("AsyncFile.Submit"_sr);
+			ctx.countPreSubmitTruncate.init("AsyncFile.CountPreAIOSubmitTruncate"_sr);
+			ctx.preSubmitTruncateBytes.init("AsyncFile.PreAIOSubmitTruncateBytes"_sr);
+		}
+
+		ctx.initialized = true;
+		setTimeout(ioTimeout);
+		poll(ev);
+
+		g_network->setGlobal(INetwork::enRunCycleFunc, (flowGlobalType)&AsyncFileIOUring::launch);
+
+		TraceEvent("IOUringInit")
+		    .detail("QueueDepth", FLOW_KNOBS->IO_URING_QUEUE_DEPTH)
+		    .detail("FixedFiles", ctx.freeFixedFiles.size());
+		return true;
+	}
+
+	static bool isInitialized() { return ctx.initialized; }
+	static void setTimeout(double ioTimeout) { ctx.setIOTimeout(ioTimeout); }
+
+	void addref() override { ReferenceCounted<AsyncFileIOUring>::addref(); }
+	void delref() override { ReferenceCounted<AsyncFileIOUring>::delref(); }
+
+	Future<int> read(void* data, int length, int64_t offset) override {
+		++countFileLogicalReads;
+		++countLogicalReads;
+
+		if (failed) {
+			return io_timeout();
+		}
+
+		IOBlock* io = new IOBlock(IORING_OP_READ);
+		io->buf = data;
+		io->nbytes = length;
+		io->offset = offset;
+
+		enqueue(io);
+		return io->result.getFuture();
+	}
+
+	Future<Void> write(void const* data, int length, int64_t offset) override {
+		++countFileLogicalWrites;
+		++countLogicalWrites;
+
+		if (failed) {
+			return io_timeout();
+		}
+
+		IOBlock* io = new IOBlock(IORING_OP_WRITE);
+		io->buf = (void*)data;
+		io->nbytes = length;
+		io->offset = offset;
+
+		nextFileSize = std::max(nextFileSize, offset + length);
+
+		enqueue(io);
+		return success(io->result.getFuture());
+	}
+
+#ifndef FALLOC_FL_ZERO_RANGE
+#define FALLOC_FL_ZERO_RANGE 0x10
+#endif
+	Future<Void> zeroRange(int64_t offset, int64_t length) override {
+		bool success = false;
+		if (ctx.fallocateZeroSupported) {
+			int rc = fallocate(fd, FALLOC_FL_ZERO_RANGE, offset, length);
+			if (rc == EOPNOTSUPP) {
+				ctx.fallocateZeroSupported = false;
+			}
+			if (rc == 0) {
+				success = true;
+			}
+		}
+		return success ? Void() : IAsyncFile::zeroRange(offset, length);
+	}
+
+	Future<Void> truncate(int64_t size) override {
+		++countFileLogicalWrites;
+		++countLogicalWrites;
+
+		if (failed) {
+			return io_timeout();
+		}
+
+		int result = -1;
+		bool completed = false;
+		double begin = timer_monotonic();
+
+		if (ctx.fallocateSupported && size >= lastFileSize) {
+			result = fallocate(fd, 0, 0, size);
+			if (result != 0) {
+				int fallocateErrCode = errno;
+				TraceEvent("AsyncFileIOUringAllocateError")
+				    .detail("Fd", fd)
+				    .detail("Filename", filename)
+				    .detail("Size", size)
+				    .GetLastError();
+				if (fallocateErrCode == EOPNOTSUPP) {
+					// Mark fallocate as unsupported. Try again with truncate.
+					ctx.fallocateSupported = false;
+				} else {
+					return io_error();
+				}
+			} else {
+				completed = true;
+			}
+		}
+		if (!completed)
+			result = ftruncate(fd, size);
+
+		double end = timer_monotonic();
+		if (nondeterministicRandom()->random01() < end - begin) {
+			TraceEvent("SlowIOUringTruncate")
+			    .detail("TruncateTime", end - begin)
+			    .detail("TruncateBytes", size - lastFileSize);
+		}
+
+		if (result != 0) {
+			TraceEvent("AsyncFileIOUringTruncateError").detail("Fd", fd).detail("Filename", filename).GetLastError();
+			return io_error();
+		}
+
+		lastFileSize = nextFileSize = size;
+
+		return Void();
+	}
+
+	// Unlike kernel AIO, io_uring implements fdatasync asynchronously so syncs go through the ring as well
+	Future<Void> sync() override {
+		++countFileLogicalWrites;
+		++countLogicalWrites;
+
+		if (failed) {
+			return io_timeout();
+		}
+
+		IOBlock* io = new IOBlock(IORING_OP_FSYNC);
+		enqueue(io);
+		Future<Void> fsync = success(io->result.getFuture());
+
+		if (flags & OPEN_ATOMIC_WRITE_AND_CREATE) {
+			flags &= ~OPEN_ATOMIC_WRITE_AND_CREATE;
+
+			return AsyncFileEIO::waitAndAtomicRename(fsync, filename + ".part", filename);
+		}
+
+		return fsync;
+	}
+
+	Future<int64_t> size() const override { return nextFileSize; }
+	int64_t debugFD() const override { return fd; }
+	std::string getFilename() const override { return filename; }
+
+	~AsyncFileIOUring() override {
+		if (fixedIndex >= 0) {
+			int none = -1;
+			if (io_uring_register_files_update(&ctx.ring, fixedIndex, &none, 1) == 1) {
+				ctx.freeFixedFiles.push_back(fixedIndex);
+			}
+		}
+		close(fd);
+	}
+
+	// Moves queued operations into the submission queue and submits them with a single system call.  Called once per
+	// run loop iteration of the network thread.
+	static void launch() {
+		int n = std::min<int>(FLOW_KNOBS->IO_URING_QUEUE_DEPTH - ctx.outstanding, ctx.queue.size());
+		if (n <= 0 && io_uring_sq_ready(&ctx.ring) == 0) {
+			return;
+		}
+
+		ctx.submitMetric = true;
+		double begin = timer_monotonic();
+		if (!ctx.outstanding)
+			ctx.ioStallBegin = begin;
+
+		double start = timer();
+		int prepared = 0;
+		for (; prepared < n; ++prepared) {
+			io_uring_sqe* sqe = io_uring_get_sqe(&ctx.ring);
+			if (sqe == nullptr) {
+				break;
+			}
+
+			IOBlock* io = ctx.queue.top();
+			ctx.queue.pop();
+			io->startTime = start;
+
+			if (ctx.ioTimeout > 0) {
+				ctx.appendToRequestList(io);
+			}
+
+			if (io->opcode == IORING_OP_WRITE && io->owner->lastFileSize != io->owner->nextFileSize) {
+				++ctx.countPreSubmitTruncate;
+				int64_t truncateSize = io->owner->nextFileSize - io->owner->lastFileSize;
+				ASSERT(truncateSize > 0);
+				ctx.preSubmitTruncateBytes += truncateSize;
+				io->owner->truncate(io->owner->nextFileSize);
+			}
+
+			io->prepare(sqe);
+		}
+		ctx.outstanding += prepared;
+
+		// Operations which the kernel did not consume stay in the submission queue and are submitted on the next call
+		int rc = io_uring_submit(&ctx.ring);
+		if (rc < 0 && rc != -EAGAIN && rc != -EBUSY && rc != -EINTR) {
+			TraceEvent(SevWarnAlways, "IOUringSubmitError").suppressFor(1.0).detail("ErrorCode", -rc);
+		} else if (rc > 0) {
+			ctx.countSubmitted += rc;
+		}
+
+		ctx.submitMetric = false;
+		++ctx.countSubmit;
+
+		double elapsed = timer_monotonic() - begin;
+		g_network->networkInfo.metrics.secSquaredSubmit += elapsed * elapsed / 2;
+	}
+
+	bool failed;
+
+private:
+	int fd, flags;
+	// Index of fd in the ring's fixed file table, or -1 if it has none
+	int fixedIndex;
+	int64_t lastFileSize, nextFileSize;
+	std::string filename;
+	Int64MetricHandle countFileLogicalWrites;
+	Int64MetricHandle countFileLogicalReads;
+
+	Int64MetricHandle countLogicalWrites;
+	Int64MetricHandle countLogicalReads;
+
+	struct IOBlock : FastAllocated<IOBlock> {
+		uint8_t opcode;
+		void* buf;
+		int nbytes;
+		int64_t offset;
+		Promise<int> result;
+		Reference<AsyncFileIOUring> owner;
+		int64_t prio;
+		IOBlock* prev;
+		IOBlock* next;
+		double startTime;
+
+		struct indirect_order_by_priority {
+			bool operator()(IOBlock* a, IOBlock* b) { return a->prio < b->prio; }
+		};
+
+		explicit IOBlock(uint8_t opcode)
+		  : opcode(opcode), buf(nullptr), nbytes(0), offset(0), prev(nullptr), next(nullptr), startTime(0) {}
+
+		TaskPriority getTask() const { return static_cast<TaskPriority>((prio >> 32) + 1); }
+
+		void prepare(io_uring_sqe* sqe) {
+			int target = owner->fixedIndex >= 0 ? owner->fixedIndex : owner->fd;
+			switch (opcode) {
+			case IORING_OP_READ:
+				io_uring_prep_read(sqe, target, buf, nbytes, offset);
+				break;
+			case IORING_OP_WRITE:
+				io_uring_prep_write(sqe, target, buf, nbytes, offset);
+				break;
+			case IORING_OP_FSYNC:
+				io_uring_prep_fsync(sqe, target, IORING_FSYNC_DATASYNC);
+				break;
+			default:
+				UNREACHABLE();
+			}
+			if (owner->fixedIndex >= 0) {
+				sqe->flags |= IOSQE_FIXED_FILE;
+			}
+			io_uring_sqe_set_data(sqe, this);
+		}
+
+		ACTOR static void deliver(Promise<int> result, bool failed, int r, TaskPriority task) {
+			wait(delay(0, task));
+			if (failed)
+				result.sendError(io_timeout());
+			else if (r < 0)
+				result.sendError(io_error());
+			else
+				result.send(r);
+		}
+
+		void setResult(int r) {
+			if (r < 0) {
+				errno = -r;
+				TraceEvent("AsyncFileIOUringIOError")
+				    .GetLastError()
+				    .detail("Fd", owner->fd)
+				    .detail("Op", opcode)
+				    .detail("Nbytes", nbytes)
+				    .detail("Offset", offset)
+				    .detail("Ptr", int64_t(buf))
+				    .detail("Filename", owner->filename);
+			}
+			deliver(result, owner->failed, r, getTask());
+			delete this;
+		}
+
+		void timeout(bool warnOnly) {
+			TraceEvent(SevWarnAlways, "AsyncFileIOUringTimeout")
+			    .detail("Fd", owner->fd)
+			    .detail("Op", opcode)
+			    .detail("Nbytes", nbytes)
+			    .detail("Offset", offset)
+			    .detail("Ptr", int64_t(buf))
+			    .detail("Filename", owner->filename);
+			g_network->setGlobal(INetwork::enASIOTimedOut, (flowGlobalType) true);
+
+			if (!warnOnly)
+				owner->failed = true;
+		}
+	};
+
+	struct Context {
+		io_uring ring;
+		bool initialized;
+		int outstanding;
+		double ioStallBegin;
+		bool fallocateSupported;
+		bool fallocateZeroSupported;
+		std::priority_queue<IOBlock*, std::vector<IOBlock*>, IOBlock::indirect_order_by_priority> queue;
+		std::vector<int> freeFixedFiles;
+		Int64MetricHandle countSubmit;
+		Int64MetricHandle countCollect;
+		Int64MetricHandle countSubmitted;
+		Int64MetricHandle submitMetric;
+
+		double ioTimeout;
+		bool timeoutWarnOnly;
+		IOBlock* submittedRequestList;
+
+		Int64MetricHandle countPreSubmitTruncate;
+		Int64MetricHandle preSubmitTruncateBytes;
+
+		uint32_t opsIssued;
+		Context()
+		  : initialized(false), outstanding(0), ioStallBegin(0), fallocateSupported(true), fallocateZeroSupported(true),
+		    submittedRequestList(nullptr), opsIssued(0) {
+			setIOTimeout(0);
+		}
+
+		void setIOTimeout(double timeout) {
+			ioTimeout = fabs(timeout);
+			timeoutWarnOnly = timeout < 0;
+		}
+
+		// Returns the fixed file table index fd was entered at, or -1 if it could not be
+		int registerFile(int fd) {
+			if (freeFixedFiles.empty()) {
+				return -1;
+			}
+			int index = freeFixedFiles.back();
+			if (io_uring_register_files_update(&ring, index, &fd, 1) != 1) {
+				return -1;
+			}
+			freeFixedFiles.pop_back();
+			return index;
+		}
+
+		void appendToRequestList(IOBlock* io) {
+			ASSERT(!io->next && !io->prev);
+
+			if (submittedRequestList) {
+				io->prev = submittedRequestList->prev;
+				io->prev->next = io;
+
+				submittedRequestList->prev = io;
+				io->next = submittedRequestList;
+			} else {
+				submittedRequestList = io;
+				io->next = io->prev = io;
+			}
+		}
+
+		void removeFromRequestList(IOBlock* io) {
+			if (io->next == nullptr) {
+				ASSERT(io->prev == nullptr);
+				return;
+			}
+
+			ASSERT(io->prev != nullptr);
+
+			if (io == io->next) {
+				ASSERT(io == submittedRequestList && io == io->prev);
+				submittedRequestList = nullptr;
+			} else {
+				io->next->prev = io->prev;
+				io->prev->next = io->next;
+
+				if (submittedRequestList == io) {
+					submittedRequestList = io->next;
+				}
+			}
+
+			io->next = io->prev = nullptr;
+		}
+	};
+	static Context ctx;
+
+	explicit AsyncFileIOUring(int fd, int flags, std::string const& filename)
+	  : failed(false), fd(fd), flags(flags), fixedIndex(ctx.registerFile(fd)), filename(filename) {
+		if (!g_network->isSimulated()) {
+			countFileLogicalWrites.init("AsyncFile.CountFileLogicalWrites"_sr, filename);
+			countFileLogicalReads.init("AsyncFile.CountFileLogicalReads"_sr, filename);
+			countLogicalWrites.init("AsyncFile.CountLogicalWrites"_sr);
+			countLogicalReads.init("AsyncFile.CountLogicalReads"_sr);
+		}
+	}
+
+	void enqueue(IOBlock* io) {
+		ASSERT(int64_t(io->buf) % 4096 == 0 && io->offset % 4096 == 0 && io->nbytes % 4096 == 0);
+
+		io->prio = (int64_t(g_network->getCurrentTask()) << 32) - (++ctx.opsIssued);
+		io->owner = Reference<AsyncFileIOUring>::addRef(this);
+
+		ctx.queue.push(io);
+	}
+
+	static int openFlags(int flags) {
+		int oflags = O_DIRECT | O_CLOEXEC;
+		ASSERT(bool(flags & OPEN_READONLY) != bool(flags & OPEN_READWRITE)); // readonly xor readwrite
+		if (flags & OPEN_EXCLUSIVE)
+			oflags |= O_EXCL;
+		if (flags & OPEN_CREATE)
+			oflags |= O_CREAT;
+		if (flags & OPEN_READONLY)
+			oflags |= O_RDONLY;
+		if (flags & OPEN_READWRITE)
+			oflags |= O_RDWR;
+		if (flags & OPEN_ATOMIC_WRITE_AND_CREATE)
+			oflags |= O_TRUNC;
+		return oflags;
+	}
+
+	ACTOR static void poll(Reference<IEventFD> ev) {
+		loop {
+			wait(success(ev->read()));
+
+			wait(delay(0, TaskPriority::DiskIOComplete));
+
+			double currentTime = timer();
+			++ctx.countCollect;
+
+			// Completions are copied out first so that the completion queue is released before any results are
+			// delivered
+			std::vector<std::pair<IOBlock*, int>> completed;
+			io_uring_cqe* cqe;
+			unsigned head;
+			io_uring_for_each_cqe(&ctx.ring, head, cqe) {
+				completed.emplace_back(static_cast<IOBlock*>(io_uring_cqe_get_data(cqe)), cqe->res);
+			}
+			io_uring_cq_advance(&ctx.ring, completed.size());
+
+			if (!completed.empty()) {
+				double t = timer_monotonic();
+				double elapsed = t - ctx.ioStallBegin;
+				ctx.ioStallBegin = t;
+				g_network->networkInfo.metrics.secSquaredDiskStall += elapsed * elapsed / 2;
+			}
+
+			ctx.outstanding -= completed.size();
+
+			if (ctx.ioTimeout > 0) {
+				while (ctx.submittedRequestList && currentTime - ctx.submittedRequestList->startTime > ctx.ioTimeout) {
+					ctx.submittedRequestList->timeout(ctx.timeoutWarnOnly);
+					ctx.removeFromRequestList(ctx.submittedRequestList);
+				}
+			}
+
+			for (auto& [iob, res] : completed) {
+				if (ctx.ioTimeout > 0) {
+					ctx.removeFromRequestList(iob);
+				}
+
+				switch (iob->opcode) {
+				case IORING_OP_READ:
+					getMetrics().readLatencySample.addMeasurement(currentTime - iob->startTime);
+					break;
+				case IORING_OP_WRITE:
+					getMetrics().writeLatencySample.addMeasurement(currentTime - iob->startTime);
+					break;
+				case IORING_OP_FSYNC:
+					getMetrics().syncLatencySample.addMeasurement(currentTime - iob->startTime);
+					break;
+				}
+
+				iob->setResult(res);
+			}
+		}
+	}
+};
+
+TEST_CASE("/fdbrpc/AsyncFileIOUring/ReadWrite") {
+	// This test does nothing in simulation, or unless the process was started with io_uring enabled
+	if (!g_network->isSimulated() && AsyncFileIOUring::isInitialized()) {
+		state Reference<IAsyncFile> f;
+		state int pageSize = 4096;
+		state int pages = 256;
+		state uint8_t* buf = (uint8_t*)aligned_alloc(pageSize, pageSize * pages);
+		state uint8_t* readBuf = (uint8_t*)aligned_alloc(pageSize, pageSize * pages);
+		try {
+			Reference<IAsyncFile> f_ = wait(AsyncFileIOUring::open(
+			    "/tmp/__IOURING_TEST_FILE__",
+			    IAsyncFile::OPEN_UNBUFFERED | IAsyncFile::OPEN_READWRITE | IAsyncFile::OPEN_CREATE,
+			    0666,
+			    nullptr));
+			f = f_;
+
+			// Write each page with a distinct pattern, all at once so they are submitted together
+			state std::vector<Future<Void>> writes;
+			for (int i = 0; i < pages; ++i) {
+				memset(buf + i * pageSize, i, pageSize);
+				writes.push_back(f->write(buf + i * pageSize, pageSize, (int64_t)i * pageSize));
+			}
+			wait(waitForAll(writes));
+			wait(f->sync());
+
+			state int64_t size = wait(f->size());
+			ASSERT_EQ(size, (int64_t)pages * pageSize);
+
+			// Read the pages back in a random order
+			state std::vector<Future<int>> reads;
+			state std::vector<int> order;
+			for (int i = 0; i < pages; ++i) {
+				order.push_back(i);
+			}
+			deterministicRandom()->randomShuffle(order);
+			for (int i : order) {
+				reads.push_back(f->read(readBuf + i * pageSize, pageSize, (int64_t)i * pageSize));
+			}
+			wait(waitForAll(reads));
+			for (auto& r : reads) {
+				ASSERT_EQ(r.get(), pageSize);
+			}
+			ASSERT(memcmp(buf, readBuf, pageSize * pages) == 0);
+			ASSERT(!((AsyncFileIOUring*)f.getPtr())->failed);
+		} catch (Error& e) {
+			state Error err = e;
+			free(buf);
+			free(readBuf);
+			if (f) {
+				wait(AsyncFileEIO::deleteFile(f->getFilename(), true));
+			}
+			throw err;
+		}
+
+		free(buf);
+		free(readBuf);
+		wait(AsyncFileEIO::deleteFile(f->getFilename(), true));
+	}
+
+	return Void();
+}
+
+AsyncFileIOUring::Context AsyncFileIOUring::ctx;
+
+#include "flow/unactorcompiler.h"
+#endif
+#endif
@@ -39,6 +39,7 @@
 #include "fdbrpc/linux_kaio.h"
 #include "flow/Knobs.h"
 #include "fdbrpc/Stats.h"
+#include "flow/Histogram.h"
 #include "flow/UnitTest.h"
 #include "crc32/crc32c.h"
 #include "flow/genericactors.actor.h"
@@ -195,6 +196,7 @@ public:
 		if (!g_network->isSimulated()) {
 			ctx.countAIOSubmit.init("AsyncFile.CountAIOSubmit"_sr);
 			ctx.countAIOCollect.init("AsyncFile.CountAIOCollect"_sr);
+			ctx.countDeferredSubmit.init("AsyncFile.CountDeferredAIOSubmit"_sr);
 			ctx.submitMetric.init("AsyncFile.Submit"_sr);
 			ctx.countPreSubmitTruncate.init("AsyncFile.CountPreAIOSubmitTruncate"_sr);
 			ctx.preSubmitTruncateBytes.init("AsyncFile.PreAIOSubmitTruncateBytes"_sr);
@@ -213,6 +215,7 @@ public:
 		g_network->setGlobal(INetwork::enRunCycleFunc, (flowGlobalType)&AsyncFileKAIO::launch);
 	}
 
+	static bool isInitialized() { return ctx.iocx != 0; }
 	static int get_eventfd() { return ctx.evfd; }
 	static void setTimeout(double ioTimeout) { ctx.setIOTimeout(ioTimeout); }
 
@@ -402,11 +405,21 @@ public:
 #endif
 	}
 
+	// Called once per run loop turn, so every I/O queued during a turn goes to the kernel in one io_submit
 	static void launch() {
 		if (ctx.queue.size() && ctx.outstanding < FLOW_KNOBS->MAX_OUTSTANDING - FLOW_KNOBS->MIN_SUBMIT) {
+			double begin = timer_monotonic();
+
+			// While I/Os are outstanding their completions will wake the run loop again, so a few queued I/Os can wait
+			// for more to join them instead of costing an io_submit each
+			if (ctx.outstanding && ctx.queue.size() < (size_t)FLOW_KNOBS->KAIO_SUBMIT_BATCH &&
+			    begin - ctx.queueBegin < FLOW_KNOBS->KAIO_SUBMIT_BATCH_DELAY) {
+				++ctx.countDeferredSubmit;
+				return;
+			}
+
 			ctx.submitMetric = true;
 
-			double begin = timer_monotonic();
 			if (!ctx.outstanding)
 				ctx.ioStallBegin = begin;
 
@@ -487,6 +500,7 @@ public:
 				KAIOLogBlockEvent(toStart[i], OpLogEntry::REQUEUE);
 				ctx.queue.push(toStart[i]);
 			}
+			ctx.queueBegin = end;
 		}
 	}
 
@@ -501,6 +515,8 @@ private:
 
 	Int64MetricHandle countLogicalWrites;
 	Int64MetricHandle countLogicalReads;
+	Reference<Histogram> readLatencyHistogram;
+	Reference<Histogram> writeLatencyHistogram;
 
 	struct IOBlock : linux_iocb, FastAllocated<IOBlock> {
 		Promise<int> result;
@@ -583,6 +599,7 @@ private:
 		std::priority_queue<IOBlock*, std::vector<IOBlock*>, IOBlock::indirect_order_by_priority> queue;
 		Int64MetricHandle countAIOSubmit;
 		Int64MetricHandle countAIOCollect;
+		Int64MetricHandle countDeferredSubmit;
 		Int64MetricHandle submitMetric;
 
 		double ioTimeout;
@@ -595,9 +612,10 @@ private:
 		EventMetricHandle<SlowAioSubmit> slowAioSubmitMetric;
 
 		uint32_t opsIssued;
+		double queueBegin; // When the oldest queued I/O was queued or last requeued
 		Context()
 		  : iocx(0), evfd(-1), outstanding(0), ioStallBegin(0), fallocateSupported(true), fallocateZeroSupported(true),
-		    submittedRequestList(nullptr), opsIssued(0) {
+		    submittedRequestList(nullptr), opsIssued(0), queueBegin(0) {
 			setIOTimeout(0);
 		}
 
@@ -654,6 +672,12 @@ private:
 			countFileLogicalReads.init("AsyncFile.CountFileLogicalReads"_sr, filename);
 			countLogicalWrites.init("AsyncFile.CountLogicalWrites"_sr);
 			countLogicalReads.init("AsyncFile.CountLogicalReads"_sr);
+			if (FLOW_KNOBS->KAIO_FILE_LATENCY_HISTOGRAMS) {
+				readLatencyHistogram = Histogram::getHistogram(
+				    "AsyncFileKAIOReadLatency"_sr, StringRef(filename), Histogram::Unit::milliseconds);
+				writeLatencyHistogram = Histogram::getHistogram(
+				    "AsyncFileKAIOWriteLatency"_sr, StringRef(filename), Histogram::Unit::milliseconds);
+			}
 		}
 
 #if KAIO_LOGGING
@@ -701,6 +725,8 @@ private:
 		// io->prio = - (++ctx.opsIssued);
 		io->owner = Reference<AsyncFileKAIO>::addRef(owner);
 
+		if (ctx.queue.empty())
+			ctx.queueBegin = timer_monotonic();
 		ctx.queue.push(io);
 	}
 
@@ -720,70 +746,123 @@ private:
 		return oflags;
 	}
 
+	// The completion ring the kernel maps into the process for each AIO context, which io_getevents reads from. When
+	// it has the layout we know, completions can be collected from it without a system call.
+	struct AIORing {
+		unsigned id;
+		unsigned nr;
+		unsigned head;
+		unsigned tail;
+		unsigned magic;
+		unsigned compatFeatures;
+		unsigned incompatFeatures;
+		unsigned headerLength;
+		linux_ioresult events[0];
+	};
+	static constexpr unsigned AIO_RING_MAGIC = 0xa10a10a1;
+
+	static AIORing* userspaceRing() {
+		AIORing* ring = reinterpret_cast<AIORing*>(ctx.iocx);
+		if (!FLOW_KNOBS->KAIO_USERSPACE_REAP || ring->magic != AIO_RING_MAGIC || ring->incompatFeatures != 0)
+			return nullptr;
+		return ring;
+	}
+
+	// Collects up to max completed I/Os into ev without waiting, returning how many or -1 with errno set
+	static int getEvents(linux_ioresult* ev, int max) {
+		if (AIORing* ring = userspaceRing()) {
+			unsigned head = ring->head;
+			unsigned tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+			int n = 0;
+			while (head != tail && n < max) {
+				ev[n++] = ring->events[head];
+				if (++head == ring->nr)
+					head = 0;
+			}
+			__atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+			return n;
+		}
+
+		timespec tm;
+		tm.tv_sec = 0;
+		tm.tv_nsec = 0;
+
+		int n;
+		loop {
+			n = io_getevents(ctx.iocx, 0, max, ev, &tm);
+			if (n >= 0 || errno != EINTR)
+				break;
+		}
+		return n;
+	}
+
 	ACTOR static void poll(Reference<IEventFD> ev) {
 		loop {
 			wait(success(ev->read()));
 
-			wait(delay(0, TaskPriority::DiskIOComplete));
+			// With many I/Os outstanding, completions arrive faster than the eventfd is worth reading, so keep
+			// collecting them once per run loop turn for as long as there are some
+			loop {
+				wait(delay(0, TaskPriority::DiskIOComplete));
 
-			linux_ioresult ev[FLOW_KNOBS->MAX_OUTSTANDING];
-			timespec tm;
-			tm.tv_sec = 0;
-			tm.tv_nsec = 0;
+				linux_ioresult ev[FLOW_KNOBS->MAX_OUTSTANDING];
+				int n = getEvents(ev, FLOW_KNOBS->MAX_OUTSTANDING);
 
-			int n;
+				double currentTime = timer();
 
-			loop {
-				n = io_getevents(ctx.iocx, 0, FLOW_KNOBS->MAX_OUTSTANDING, ev, &tm);
-				if (n >= 0 || errno != EINTR)
-					break;
-			}
+				++ctx.countAIOCollect;
+				// printf("io_getevents: collected %d/%d in %f us (%d queued)\n", n, ctx.outstanding,
+				// (timer()-before)*1e6, ctx.queue.size());
+				if (n < 0) {
+					// printf("io_getevents failed: %d\n", errno);
+					TraceEvent("IOGetEventsError").GetLastError();
+					throw io_error();
+				}
+				if (n) {
+					double t = timer_monotonic();
+					double elapsed = t - ctx.ioStallBegin;
+					ctx.ioStallBegin = t;
+					g_network->networkInfo.metrics.secSquaredDiskStall += elapsed * elapsed / 2;
+				}
 
-			double currentTime = timer();
+				ctx.outstanding -= n;
 
-			++ctx.countAIOCollect;
-			// printf("io_getevents: collected %d/%d in %f us (%d queued)\n", n, ctx.outstanding, (timer()-before)*1e6,
-			// ctx.queue.size());
-			if (n < 0) {
-				// printf("io_getevents failed: %d\n", errno);
-				TraceEvent("IOGetEventsError").GetLastError();
-				throw io_error();
-			}
-			if (n) {
-				double t = timer_monotonic();
-				double elapsed = t - ctx.ioStallBegin;
-				ctx.ioStallBegin = t;
-				g_network->networkInfo.metrics.secSquaredDiskStall += elapsed * elapsed / 2;
-			}
+				if (ctx.ioTimeout > 0) {
+					while (ctx.submittedRequestList &&
+					       currentTime - ctx.submittedRequestList->startTime > ctx.ioTimeout) {
+						ctx.submittedRequestList->timeout(ctx.timeoutWarnOnly);
+						ctx.removeFromRequestList(ctx.submittedRequestList);
+					}
+				}
 
-			ctx.outstanding -= n;
+				for (int i = 0; i < n; i++) {
+					IOBlock* iob = static_cast<IOBlock*>(ev[i].iocb);
 
-			if (ctx.ioTimeout > 0) {
-				while (ctx.submittedRequestList && currentTime - ctx.submittedRequestList->startTime > ctx.ioTimeout) {
-					ctx.submittedRequestList->timeout(ctx.timeoutWarnOnly);
-					ctx.removeFromRequestList(ctx.submittedRequestList);
-				}
-			}
+					KAIOLogBlockEvent(iob, OpLogEntry::COMPLETE, ev[i].result);
 
-			for (int i = 0; i < n; i++) {
-				IOBlock* iob = static_cast<IOBlock*>(ev[i].iocb);
+					if (ctx.ioTimeout > 0) {
+						ctx.removeFromRequestList(iob);
+					}
 
-				KAIOLogBlockEvent(iob, OpLogEntry::COMPLETE, ev[i].result);
+					switch (iob->aio_lio_opcode) {
+					case IO_CMD_PREAD:
+						getMetrics().readLatencySample.addMeasurement(currentTime - iob->startTime);
+						if (iob->owner->readLatencyHistogram)
+							iob->owner->readLatencyHistogram->sampleSeconds(currentTime - iob->startTime);
+						break;
+					case IO_CMD_PWRITE:
+						getMetrics().writeLatencySample.addMeasurement(currentTime - iob->startTime);
+						if (iob->owner->writeLatencyHistogram)
+							iob->owner->writeLatencyHistogram->sampleSeconds(currentTime - iob->startTime);
+						break;
+					}
 
-				if (ctx.ioTimeout > 0) {
-					ctx.removeFromRequestList(iob);
+					iob->setResult(ev[i].result);
 				}
 
-				switch (iob->aio_lio_opcode) {
-				case IO_CMD_PREAD:
-					getMetrics().readLatencySample.addMeasurement(currentTime - iob->startTime);
-					break;
-				case IO_CMD_PWRITE:
-					getMetrics().writeLatencySample.addMeasurement(currentTime - iob->startTime);
+				// Polling without the eventfd is only cheap when collecting needs no system call
+				if (!n || ctx.outstanding < FLOW_KNOBS->KAIO_POLL_OUTSTANDING || !userspaceRing())
 					break;
-				}
-
-				iob->setResult(ev[i].result);
 			}
 		}
 	}
@@ -896,8 +975,9 @@ ACTOR Future<Void> runTestOps(Reference<IAsyncFile> f, int numIterations, int fi
 }
 
 TEST_CASE("/fdbrpc/AsyncFileKAIO/RequestList") {
-	// This test does nothing in simulation because simulation doesn't support AsyncFileKAIO
-	if (!g_network->isSimulated()) {
+	// This test does nothing in simulation because simulation doesn't support AsyncFileKAIO, nor when the process uses
+	// io_uring instead
+	if (!g_network->isSimulated() && AsyncFileKAIO::isInitialized()) {
 		state Reference<IAsyncFile> f;
 		try {
 			Reference<IAsyncFile> f_ = wait(
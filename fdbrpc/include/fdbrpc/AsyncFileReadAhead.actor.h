@@ -33,7 +33,8 @@
 #include "flow/actorcompiler.h" // This must be the last #include.
 
 // Read-only file type that wraps another file instance, reads in large blocks, and reads ahead of the actual range
-// requested
+// requested. When given a maximum read ahead larger than the base, it reads further ahead while the file is read
+// sequentially: far enough that the blocks in flight cover what the reader consumes during one block's read latency.
 class AsyncFileReadAheadCache final : public IAsyncFile, public ReferenceCounted<AsyncFileReadAheadCache> {
 public:
 	void addref() override { ReferenceCounted<AsyncFileReadAheadCache>::addref(); }
@@ -53,9 +54,12 @@ public:
 		wait(f->m_max_concurrent_reads.take());
 
 		state Reference<CacheBlock> block(new CacheBlock(length));
+		state double start = now();
 		try {
 			int len = wait(uncancellable(holdWhile(block, f->m_f->read(block->data, length, offset))));
 			block->len = len;
+			double latency = now() - start;
+			f->m_block_latency = f->m_block_latency > 0 ? 0.75 * f->m_block_latency + 0.25 * latency : latency;
 		} catch (Error& e) {
 			f->m_max_concurrent_reads.release(1);
 			throw e;
@@ -93,7 +97,8 @@ public:
 		// Start blocks up to the read ahead size beyond the last needed block but don't go past the end of the file
 		state int lastBlockNumInFile = ((fileSize + f->m_block_size - 1) / f->m_block_size) - 1;
 		ASSERT(lastBlockNum <= lastBlockNumInFile);
-		int lastBlockToStart = std::min<int>(lastBlockNum + f->m_read_ahead_blocks, lastBlockNumInFile);
+		f->noteRead(offset, length);
+		int lastBlockToStart = std::min<int>(lastBlockNum + f->readAheadBlocks(), lastBlockNumInFile);
 
 		state int blockNum;
 		for (blockNum = firstBlockNum; blockNum <= lastBlockToStart; ++blockNum) {
@@ -199,21 +204,57 @@ public:
 		}
 	}
 
+	// Tracks whether reads continue where the previous one ended, and how fast a sequential run is consumed
+	void noteRead(int64_t offset, int length) {
+		if (!m_run_reads || offset < m_next_offset - m_block_size || offset > m_next_offset + m_block_size) {
+			m_run_start = now();
+			m_run_reads = 0;
+			m_run_bytes = 0;
+		}
+		++m_run_reads;
+		m_run_bytes += length;
+		m_next_offset = offset + length;
+	}
+
+	int readAheadBlocks() const {
+		if (m_max_read_ahead_blocks <= m_read_ahead_blocks || m_run_reads < 2 || m_block_latency <= 0) {
+			return m_read_ahead_blocks;
+		}
+		// Blocks consumed during one block read, plus one so that the window grows for as long as reading is what
+		// the reader waits on
+		double elapsed = std::max(now() - m_run_start, 1e-6);
+		double blocksPerRead = m_run_bytes / elapsed * m_block_latency / m_block_size;
+		int window = std::min<double>(std::ceil(blocksPerRead) + 1, m_max_read_ahead_blocks);
+		// Blocks read ahead beyond the cache limit would be evicted before they are used
+		return std::max(m_read_ahead_blocks, std::min(window, m_cache_block_limit - 1));
+	}
+
 	Reference<IAsyncFile> m_f;
 	int m_block_size;
 	int m_read_ahead_blocks;
+	int m_max_read_ahead_blocks;
 	int m_cache_block_limit;
 	FlowLock m_max_concurrent_reads;
 
 	// Map block numbers to future
 	std::map<int, Future<Reference<CacheBlock>>> m_blocks;
 
+	// The end of the last read, and the start time and size of the sequential run it belongs to
+	int64_t m_next_offset = 0;
+	double m_run_start = 0;
+	int m_run_reads = 0;
+	int64_t m_run_bytes = 0;
+	// Moving average of the time to read a block from the underlying file
+	double m_block_latency = 0;
+
 	AsyncFileReadAheadCache(Reference<IAsyncFile> f,
 	                        int blockSize,
 	                        int readAheadBlocks,
 	                        int maxConcurrentReads,
-	                        int cacheSizeBlocks)
+	                        int cacheSizeBlocks,
+	                        int maxReadAheadBlocks = 0)
 	  : m_f(f), m_block_size(blockSize), m_read_ahead_blocks(readAheadBlocks),
+	    m_max_read_ahead_blocks(std::max(readAheadBlocks, maxReadAheadBlocks)),
 	    m_cache_block_limit(std::max<int>(1, cacheSizeBlocks)), m_max_concurrent_reads(maxConcurrentReads) {}
 };
 
@@ -23,6 +23,7 @@
 #pragma once
 
 #include "flow/Platform.h"
+#include "flow/FastRandom.h"
 #include "flow/IRandom.h"
 #include <vector>
 #include <algorithm>
@@ -55,8 +56,12 @@ public:
 
 		if (populationSize <= sampleSize) {
 			samples.push_back(sample);
-		} else if (deterministicRandom()->random01() < ((double)sampleSize / populationSize)) {
-			samples[deterministicRandom()->randomInt(0, sampleSize)] = sample;
+		} else {
+			// The sample replaces one picked at random with probability sampleSize / populationSize
+			const int64_t slot = fastRandom().randomInt64(0, static_cast<int64_t>(populationSize));
+			if (slot < sampleSize) {
+				samples[slot] = sample;
+			}
 		}
 
 		_max = std::max(_max, sample);
@@ -20,6 +20,8 @@
 
 #ifndef DDSKETCH_H
 #define DDSKETCH_H
+#include <bit>
+#include <cstdint>
 #include <iterator>
 #include <limits>
 #include <type_traits>
@@ -30,6 +32,7 @@
 #include <cassert>
 #include <cmath>
 #include "flow/Error.h"
+#include "flow/serialize.h"
 #include "flow/UnitTest.h"
 
 // A namespace for fast log() computation.
@@ -42,10 +45,12 @@ namespace fastLogger {
 inline const double correctingFactor = 1.00988652862227438516; // = 7 / (10 * log(2));
 constexpr inline const double A = 6.0 / 35.0, B = -3.0 / 5.0, C = 10.0 / 7.0;
 
-inline double fastlog(double value) {
-	int e;
-	double s = frexp(value, &e);
-	s = s * 2 - 1;
+// Takes e and s from the bits of value rather than calling frexp, which gives the same result for every normal number.
+// DDSketch never calls this with zero, subnormals, infinities or NaN.
+constexpr double fastlog(double value) {
+	const uint64_t bits = std::bit_cast<uint64_t>(value);
+	const int e = int((bits >> 52) & 0x7ff) - 1022; // the exponent frexp would return
+	const double s = double(bits & ((uint64_t(1) << 52) - 1)) / double(uint64_t(1) << 52);
 	return ((A * s + B) * s + C) * s + e - 1;
 }
 
@@ -92,17 +97,8 @@ public:
 			zeroPopulationSize++;
 		} else {
 			size_t index = static_cast<Impl*>(this)->getIndex(sample);
-			ASSERT(index >= 0 && index < buckets.size());
-			try {
-				buckets.at(index)++;
-			} catch (std::out_of_range const& e) {
-				fmt::print(stderr,
-				           "ERROR: Invalid DDSketch bucket index ({}) at {}/{} for sample: {}\n",
-				           e.what(),
-				           index,
-				           buckets.size(),
-				           sample);
-			}
+			ASSERT(index < buckets.size());
+			buckets[index]++;
 		}
 
 		populationSize++;
@@ -203,6 +199,31 @@ public:
 		return *this;
 	}
 
+	// Only the non-empty buckets are written, so that sketches from many processes are cheap to send and merge. A sketch
+	// can only be read into one made with the same error guarantee.
+	template <class Ar>
+	void serialize(Ar& ar) {
+		double guarantee = errorGuarantee;
+		std::vector<uint32_t> indices, counts;
+		if constexpr (!Ar::isDeserializing) {
+			for (size_t i = 0; i < buckets.size(); i++) {
+				if (buckets[i]) {
+					indices.push_back(i);
+					counts.push_back(buckets[i]);
+				}
+			}
+		}
+		serializer(ar, guarantee, populationSize, zeroPopulationSize, minValue, maxValue, sum, indices, counts);
+		if constexpr (Ar::isDeserializing) {
+			ASSERT(fabs(guarantee - errorGuarantee) < EPS && indices.size() == counts.size());
+			std::fill(buckets.begin(), buckets.end(), 0);
+			for (size_t i = 0; i < indices.size(); i++) {
+				ASSERT(indices[i] < buckets.size());
+				buckets[indices[i]] = counts[i];
+			}
+		}
+	}
+
 	constexpr static double EPS = 1e-18; // smaller numbers are considered as 0
 protected:
 	double errorGuarantee; // As defined in the paper
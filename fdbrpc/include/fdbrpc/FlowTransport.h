@@ -179,15 +179,37 @@ struct Peer : public ReferenceCounted<Peer> {
 	DDSketch<double> connectLatencies;
 	Promise<Void> disconnect;
 
+	// The bulk lane is a second connection to the peer, opened by the side that opened the main one, that carries
+	// large replies so that they don't hold up the requests and small replies behind them on the main connection.
+	UnsentPacketQueue bulkUnsent;
+	AsyncTrigger bulkDataToSend; // Triggered when bulkUnsent.empty() becomes false
+	bool bulkLaneConnected;
+	Future<Void> bulkLane;
+	Promise<Void> bulkLaneFailed; // Fails when the bulk lane of the current main connection closes
+
+	// Whether the peer's current connection accepts compressed packets, and the compression of large replies to it.
+	// The stats are cleared every time they are logged.
+	bool compressionAccepted;
+	int64_t compressedPackets;
+	int64_t bytesBeforeCompression;
+	int64_t bytesAfterCompression;
+	double compressionSeconds;
+
+	// Pings sent to the peer, and pings skipped because the connection was busy, since the peer was created
+	int64_t pingsSent;
+	int64_t pingsSuppressed;
+
 	explicit Peer(TransportData* transport, NetworkAddress const& destination);
 
 	void send(PacketBuffer* pb, ReliablePacket* rp, bool firstUnsent);
 
-	void prependConnectPacket();
+	void prependConnectPacket(bool bulkLane = false);
 
 	void discardUnreliablePackets();
 
 	void onIncomingConnection(Reference<Peer> self, Reference<IConnection> conn, Future<Void> reader);
+
+	void onIncomingBulkLane(Reference<Peer> self, Reference<IConnection> conn, Future<Void> reader);
 };
 
 class IPAllowList;
@@ -29,6 +29,7 @@
 #define FLOW_LOADBALANCE_ACTOR_H
 
 #include "flow/BooleanParam.h"
+#include "flow/FastRandom.h"
 #include "flow/flow.h"
 #include "flow/Knobs.h"
 
@@ -76,7 +77,13 @@ struct ModelHolder : NonCopyable, public ReferenceCounted<ModelHolder> {
 struct LoadBalancedReply {
 	double penalty;
 	Optional<Error> error;
-	LoadBalancedReply() : penalty(1.0) {}
+	// The storage engine's recent cache hit rate, or -1 if it does not report one, and the reads the server has in
+	// progress. Servers that predate them leave the defaults.
+	double cacheHitRate;
+	int readQueueDepth;
+	// How many requests the server would have this client keep outstanding to it, or 0 for no limit
+	double admissionWindow;
+	LoadBalancedReply() : penalty(1.0), cacheHitRate(-1.0), readQueueDepth(0), admissionWindow(0) {}
 };
 
 Optional<LoadBalancedReply> getLoadBalancedReply(const LoadBalancedReply* reply);
@@ -123,6 +130,10 @@ Future<Void> tssComparison(Req req,
 	}
 	++tssData.metrics->requests;
 
+	// Both replies are in, but comparing them can take a while for large replies. Let the client handle the storage
+	// server's reply and get on with other work first, comparing only when the network thread has nothing more urgent.
+	wait(delay(0, TaskPriority::Low));
+
 	if (src.isError()) {
 		srcErrorCode = src.getError().code();
 		tssData.metrics->ssError(srcErrorCode);
@@ -429,6 +440,11 @@ struct RequestData : NonCopyable {
 			Optional<TSSEndpointData> tssData = model->getTssData(stream->getEndpoint().token.first());
 
 			if (tssData.present()) {
+				const double sampleRate = TSS_sampleRate(request);
+				if (sampleRate < 1.0 && deterministicRandom()->random01() >= sampleRate) {
+					++tssData.get().metrics->unsampledRequests;
+					return;
+				}
 				CODE_PROBE(true, "duplicating request to TSS");
 				resetReply(request);
 				// FIXME: optimize to avoid creating new netNotifiedQueue for each message
@@ -527,6 +543,12 @@ struct RequestData : NonCopyable {
 		receivedResponse = receivedResponse || (!maybeDelivered && errCode != error_code_process_behind);
 		bool futureVersion = errCode == error_code_future_version || errCode == error_code_process_behind;
 
+		if (loadBalancedReply.present() && modelHolder->model) {
+			modelHolder->model->updateReadLoad(modelHolder->token,
+			                                   loadBalancedReply.get().cacheHitRate,
+			                                   loadBalancedReply.get().readQueueDepth,
+			                                   loadBalancedReply.get().admissionWindow);
+		}
 		modelHolder->release(
 		    receivedResponse, futureVersion, loadBalancedReply.present() ? loadBalancedReply.get().penalty : -1.0);
 
@@ -637,6 +659,7 @@ Future<REPLY_TYPE(Request)> loadBalance(
 
 	state Optional<uint64_t> firstRequestEndpoint;
 	state Future<Void> secondDelay = Never();
+	state bool hedgeByLatency = false;
 
 	state Promise<Void> requestFinished;
 	state double startTime = now();
@@ -649,8 +672,8 @@ Future<REPLY_TYPE(Request)> loadBalance(
 
 	ASSERT(alternatives->size());
 
-	state int bestAlt = deterministicRandom()->randomInt(0, alternatives->countBest());
-	state int nextAlt = deterministicRandom()->randomInt(0, std::max(alternatives->size() - 1, 1));
+	state int bestAlt = fastRandom().randomInt(0, alternatives->countBest());
+	state int nextAlt = fastRandom().randomInt(0, std::max(alternatives->size() - 1, 1));
 	if (nextAlt >= bestAlt)
 		nextAlt++;
 
@@ -659,6 +682,7 @@ Future<REPLY_TYPE(Request)> loadBalance(
 		double nextMetric = 1e9;
 		double bestTime = 1e9; // The latency to the server with the least outstanding requests.
 		double nextTime = 1e9;
+		double bestHedgeLatency = 0; // The latency percentile of the best server at which to send a second request
 		int badServers = 0;
 
 		for (int i = 0; i < alternatives->size(); i++) {
@@ -682,13 +706,23 @@ Future<REPLY_TYPE(Request)> loadBalance(
 			if (!IFailureMonitor::failureMonitor().getState(thisStream->getEndpoint()).failed) {
 				auto const& qd = model->getMeasurement(thisStream->getEndpoint().token.first());
 				if (now() > qd.failedUntil) {
-					double thisMetric = qd.smoothOutstanding.smoothTotal();
+					double thisMetric = qd.smoothOutstanding.smoothTotal() + qd.readLoad();
 					double thisTime = qd.latency;
 					if (FLOW_KNOBS->LOAD_BALANCE_PENALTY_IS_BAD && qd.penalty > 1.001) {
 						// When a server wants to penalize itself (the default
 						// penalty value is 1.0), consider this server as bad.
 						// penalty is sent from server.
 						++badServers;
+					} else if (qd.readQueueDepth > FLOW_KNOBS->LOAD_BALANCE_MAX_READ_QUEUE) {
+						// An overloaded server is bad too, so that a preference for a warm or nearby one
+						// gives way to the others
+						++badServers;
+					}
+					if (qd.admissionWindow > 0 && qd.smoothOutstanding.getTotal() >= qd.admissionWindow) {
+						// The server has asked for no more requests from this client for now. Send it one only
+						// if every other alternative has asked the same.
+						++badServers;
+						thisMetric += 1e6;
 					}
 
 					if (thisMetric < bestMetric) {
@@ -700,6 +734,7 @@ Future<REPLY_TYPE(Request)> loadBalance(
 						bestAlt = i;
 						bestMetric = thisMetric;
 						bestTime = thisTime;
+						bestHedgeLatency = qd.hedgeLatency;
 					} else if (thisMetric < nextMetric) {
 						nextAlt = i;
 						nextMetric = thisMetric;
@@ -721,7 +756,7 @@ Future<REPLY_TYPE(Request)> loadBalance(
 				if (!IFailureMonitor::failureMonitor().getState(thisStream->getEndpoint()).failed) {
 					auto const& qd = model->getMeasurement(thisStream->getEndpoint().token.first());
 					if (now() > qd.failedUntil) {
-						double thisMetric = qd.smoothOutstanding.smoothTotal();
+						double thisMetric = qd.smoothOutstanding.smoothTotal() + qd.readLoad();
 						double thisTime = qd.latency;
 
 						if (thisMetric < nextMetric) {
@@ -736,7 +771,11 @@ Future<REPLY_TYPE(Request)> loadBalance(
 
 		if (nextTime < 1e9) {
 			// Decide when to send the request to the second best choice.
-			if (bestTime > FLOW_KNOBS->INSTANT_SECOND_REQUEST_MULTIPLIER *
+			if (FLOW_KNOBS->LOAD_BALANCE_HEDGE_BY_LATENCY && bestHedgeLatency > 0) {
+				// Once the best choice has taken longer than it does for all but a few requests
+				hedgeByLatency = true;
+				secondDelay = delay(std::max(bestHedgeLatency, FLOW_KNOBS->BASE_SECOND_REQUEST_TIME));
+			} else if (bestTime > FLOW_KNOBS->INSTANT_SECOND_REQUEST_MULTIPLIER *
 			                   (model->secondMultiplier * (nextTime) + FLOW_KNOBS->BASE_SECOND_REQUEST_TIME)) {
 				secondDelay = Void();
 			} else {
@@ -928,7 +967,9 @@ Future<REPLY_TYPE(Request)> loadBalance(
 					when(wait(secondDelay)) {
 						secondDelay = Never();
 						if (model && model->secondBudget >= 1.0) {
-							model->secondMultiplier += FLOW_KNOBS->SECOND_REQUEST_MULTIPLIER_GROWTH;
+							if (!hedgeByLatency) {
+								model->secondMultiplier += FLOW_KNOBS->SECOND_REQUEST_MULTIPLIER_GROWTH;
+							}
 							model->secondBudget -= 1.0;
 							break;
 						}
@@ -981,7 +1022,7 @@ Future<REPLY_TYPE(Request)> basicLoadBalance(Reference<ModelInterface<Multi>> al
 	ASSERT(alternatives->size() && alternatives->alwaysFresh());
 
 	state int bestAlt = alternatives->getBest();
-	state int nextAlt = deterministicRandom()->randomInt(0, std::max(alternatives->size() - 1, 1));
+	state int nextAlt = fastRandom().randomInt(0, std::max(alternatives->size() - 1, 1));
 	if (nextAlt >= bestAlt)
 		nextAlt++;
 
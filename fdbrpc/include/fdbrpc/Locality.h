@@ -461,7 +461,7 @@ struct LBLocalityData<Interface, typename std::enable_if<Interface::LocationAwar
 };
 
 struct LBDistance {
-	enum Type { SAME_MACHINE = 0, SAME_DC = 1, DISTANT = 2 };
+	enum Type { SAME_MACHINE = 0, SAME_DATA_HALL = 1, SAME_DC = 2, DISTANT = 3 };
 };
 
 LBDistance::Type loadBalanceDistance(LocalityData const& localLoc,
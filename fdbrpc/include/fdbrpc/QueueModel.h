@@ -22,7 +22,10 @@
 #define FLOW_QUEUEMODEL_H
 #pragma once
 
+#include <memory>
+
 #include "flow/flow.h"
+#include "fdbrpc/DDSketch.h"
 #include "fdbrpc/Smoother.h"
 #include "flow/Knobs.h"
 #include "flow/ActorCollection.h"
@@ -74,9 +77,46 @@ struct QueueData {
 	// a bit of a hack to store this here, but it's the only centralized place for per-endpoint tracking
 	Optional<TSSEndpointData> tssData;
 
+	// Percentiles of the latencies of the clean replies from this storage server over the last complete window of
+	// LOAD_BALANCE_LATENCY_WINDOW replies, or 0 before the first window completes. Measured only with
+	// LOAD_BALANCE_HEDGE_BY_LATENCY, when hedgeLatency, at LOAD_BALANCE_HEDGE_PERCENTILE, is when a second request
+	// is sent.
+	double latencyP50;
+	double latencyP99;
+	double hedgeLatency;
+
+	// Reported by the storage server with each reply, see LoadBalancedReply
+	double cacheHitRate;
+	int readQueueDepth;
+	double admissionWindow;
+	double admissionWindowTime; // When admissionWindow was reported
+
+	// When penalty was reported. With LOAD_BALANCE_PENALTY_HALF_LIFE, the penalty decays towards 1 from then on, so
+	// that a client which stops sending to a server doesn't keep avoiding it for an old penalty.
+	double penaltyTime;
+
+	// The window being measured. Allocated on the first sample, as a client may talk to thousands of servers.
+	std::unique_ptr<DDSketch<double>> latencySketch;
+
 	QueueData()
 	  : smoothOutstanding(FLOW_KNOBS->QUEUE_MODEL_SMOOTHING_AMOUNT), latency(0.001), penalty(1.0), failedUntil(0),
-	    futureVersionBackoff(FLOW_KNOBS->FUTURE_VERSION_INITIAL_BACKOFF), increaseBackoffTime(0) {}
+	    futureVersionBackoff(FLOW_KNOBS->FUTURE_VERSION_INITIAL_BACKOFF), increaseBackoffTime(0), latencyP50(0),
+	    latencyP99(0), hedgeLatency(0), cacheHitRate(-1.0), readQueueDepth(0), admissionWindow(0),
+	    admissionWindowTime(0), penaltyTime(0) {}
+
+	void addLatencySample(double latency);
+
+	// Ages the penalty and admission window the server last reported
+	void decay(double t = now());
+
+	// What the storage server reports of its load, in units of outstanding requests
+	double readLoad() const {
+		double load = readQueueDepth * FLOW_KNOBS->LOAD_BALANCE_READ_QUEUE_WEIGHT;
+		if (cacheHitRate >= 0) {
+			load += (1.0 - cacheHitRate) * FLOW_KNOBS->LOAD_BALANCE_CACHE_MISS_WEIGHT;
+		}
+		return load;
+	}
 };
 
 typedef double TimeEstimate;
@@ -100,6 +140,9 @@ public:
 	// penalty. The returned penalty should be passed as `delta` to `endRequest`
 	// to make `smoothOutstanding` to reflect the real storage queue size.
 	double addRequest(uint64_t id);
+
+	// Records the load storage server `id` reported with a reply
+	void updateReadLoad(uint64_t id, double cacheHitRate, int readQueueDepth, double admissionWindow);
 	double secondMultiplier;
 	double secondBudget;
 	PromiseStream<Future<Void>> addActor;
@@ -25,9 +25,20 @@
 #include "flow/flow.h"
 #include <boost/range.hpp>
 #include "flow/IndexedSet.h"
+#include "flow/BTreeIndexedSet.h"
 
 using boost::iterator_range;
 
+// The ordered container of range boundaries. The B+tree is more compact and faster to search, but unlike IndexedSet
+// modifying the map invalidates iterators into it.
+#ifdef FLOW_USE_BTREE_RANGE_MAP
+template <class T, class Metric>
+using RangeMapSet = BTreeIndexedSet<T, Metric>;
+#else
+template <class T, class Metric>
+using RangeMapSet = IndexedSet<T, Metric>;
+#endif
+
 template <class Key>
 class RangeMapRange {
 public:
@@ -80,6 +91,7 @@ template <class Key,
 class RangeMap {
 private:
 	typedef MapPair<Key, Val> pair_type;
+	typedef Map<Key, Val, pair_type, Metric, RangeMapSet<pair_type, Metric>> map_type;
 	// Applications may decrement an iterator before ranges begin, or increment after ranges end, but once in this state
 	// cannot do further incrementing or decrementing
 	template <bool isConst>
@@ -87,9 +99,7 @@ private:
 		using self_t = IteratorImpl<isConst>;
 
 	public:
-		using value_type = std::conditional_t<isConst,
-		                                      typename Map<Key, Val, pair_type, Metric>::const_iterator,
-		                                      typename Map<Key, Val, pair_type, Metric>::iterator>;
+		using value_type = std::conditional_t<isConst, typename map_type::const_iterator, typename map_type::iterator>;
 		typedef std::forward_iterator_tag iterator_category;
 		using difference_type = int;
 		using pointer = self_t*;
@@ -233,7 +243,7 @@ public:
 	}
 
 protected:
-	Map<Key, Val, pair_type, Metric> map;
+	map_type map;
 	const MetricFunc mf;
 };
 
@@ -272,7 +282,11 @@ void RangeMap<Key, Val, Range, Metric, MetricFunc>::coalesce(const Range& k) {
 			doCheck = true;
 			auto begin = it;
 			++it;
+			// Erasing can move the entries of the map, so find the next entry and the value before it again
+			Key nextKey = it->key;
 			map.erase(begin, it);
+			it = map.lower_bound(nextKey);
+			lastVal = &map.previous(it)->value;
 		} else {
 			lastVal = &it->value;
 			++it;
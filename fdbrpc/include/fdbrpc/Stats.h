@@ -61,6 +61,11 @@ struct ICounter : public IMetric {
 
 	virtual void resetInterval() = 0;
 
+	// Counters that only grow are exported to the metrics pipeline as their change over each interval, and other
+	// counters, such as special counters, as gauges of their value
+	virtual bool isMonotonic() const { return false; }
+	virtual int64_t getIntervalDelta() const { return 0; }
+
 	virtual void remove() {}
 	virtual bool suppressTrace() const { return false; }
 };
@@ -125,7 +130,8 @@ public:
 
 	std::string const& getName() const override { return name; }
 
-	Value getIntervalDelta() const { return interval_delta; }
+	bool isMonotonic() const override { return true; }
+	Value getIntervalDelta() const override { return interval_delta; }
 	Value getValue() const override { return interval_start_value + interval_delta; }
 
 	// dValue / dt
@@ -41,6 +41,7 @@ struct DetailedTSSMismatch {
 struct TSSMetrics : ReferenceCounted<TSSMetrics>, NonCopyable {
 	CounterCollection cc;
 	Counter requests; // requests is the number of requests attempted, successful or not
+	Counter unsampledRequests; // requests that were not sent to the TSS because they were not sampled
 	Counter streamComparisons;
 	Counter ssErrors;
 	Counter tssErrors;
@@ -104,16 +105,20 @@ struct TSSMetrics : ReferenceCounted<TSSMetrics>, NonCopyable {
 	}
 
 	TSSMetrics()
-	  : cc("TSSClientMetrics"), requests("Requests", cc), streamComparisons("StreamComparisons", cc),
-	    ssErrors("SSErrors", cc), tssErrors("TSSErrors", cc), tssTimeouts("TSSTimeouts", cc),
-	    mismatches("Mismatches", cc), SSgetValueLatency(), SSgetKeyLatency(), SSgetKeyValuesLatency(),
-	    SSgetMappedKeyValuesLatency(), TSSgetValueLatency(), TSSgetKeyLatency(), TSSgetKeyValuesLatency(),
-	    TSSgetMappedKeyValuesLatency() {}
+	  : cc("TSSClientMetrics"), requests("Requests", cc), unsampledRequests("UnsampledRequests", cc),
+	    streamComparisons("StreamComparisons", cc), ssErrors("SSErrors", cc), tssErrors("TSSErrors", cc),
+	    tssTimeouts("TSSTimeouts", cc), mismatches("Mismatches", cc), SSgetValueLatency(), SSgetKeyLatency(),
+	    SSgetKeyValuesLatency(), SSgetMappedKeyValuesLatency(), TSSgetValueLatency(), TSSgetKeyLatency(),
+	    TSSgetKeyValuesLatency(), TSSgetMappedKeyValuesLatency() {}
 };
 
 template <class Rep>
 bool TSS_doCompare(const Rep& src, const Rep& tss);
 
+// The fraction of requests like req that are duplicated to the TSS and compared
+template <class Req>
+double TSS_sampleRate(const Req& req);
+
 template <class Req, class Type>
 const char* LB_mismatchTraceName(const Req& req, const Type& type);
 
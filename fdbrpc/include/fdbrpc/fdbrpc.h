@@ -607,6 +607,13 @@ public:
 	// client
 	void setByteLimit(int64_t byteLimit) { queue->acknowledgements.bytesLimit = byteLimit; }
 
+	// The number of bytes which can still be sent before the client has to acknowledge some of them, which may be
+	// negative if the last send overshot the byte limit
+	int64_t bytesAvailable() const {
+		return queue->acknowledgements.bytesLimit -
+		       (queue->acknowledgements.bytesSent - queue->acknowledgements.bytesAcknowledged);
+	}
+
 	void operator=(const ReplyPromiseStream& rhs) {
 		rhs.queue->addPromiseRef();
 		if (queue)
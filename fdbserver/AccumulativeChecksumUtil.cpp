@@ -74,9 +74,11 @@ void AccumulativeChecksumBuilder::addMutation(const MutationRef& mutation,
 		return;
 	}
 	uint32_t oldAcs = 0;
-	auto it = acsTable.find(tag);
-	if (it != acsTable.end()) {
-		oldAcs = it->second.acs;
+	if (CLIENT_KNOBS->ENABLE_ACCUMULATIVE_CHECKSUM_LOGGING) {
+		auto it = acsTable.find(tag);
+		if (it != acsTable.end()) {
+			oldAcs = it->second.acs;
+		}
 	}
 	uint32_t newAcs = updateTable(tag, mutation.checksum.get(), commitVersion, epoch);
 	if (CLIENT_KNOBS->ENABLE_ACCUMULATIVE_CHECKSUM_LOGGING) {
@@ -97,7 +99,7 @@ uint32_t AccumulativeChecksumBuilder::updateTable(Tag tag, uint32_t checksum, Ve
 	auto it = acsTable.find(tag);
 	if (it == acsTable.end()) {
 		newAcs = checksum;
-		acsTable[tag] = AccumulativeChecksumState(acsIndex, newAcs, version, epoch);
+		acsTable.emplace(tag, AccumulativeChecksumState(acsIndex, newAcs, version, epoch));
 	} else {
 		ASSERT(version >= it->second.version);
 		ASSERT(version >= currentVersion);
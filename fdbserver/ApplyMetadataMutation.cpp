@@ -87,7 +87,8 @@ public:
 	    commit(proxyCommitData_.commit), cx(proxyCommitData_.cx), committedVersion(&proxyCommitData_.committedVersion),
 	    storageCache(&proxyCommitData_.storageCache), tag_popped(&proxyCommitData_.tag_popped),
 	    tssMapping(&proxyCommitData_.tssMapping), tenantMap(&proxyCommitData_.tenantMap),
-	    tenantNameIndex(&proxyCommitData_.tenantNameIndex), lockedTenants(&proxyCommitData_.lockedTenants),
+	    tenantIndex(&proxyCommitData_.tenantIndex), tenantNameIndex(&proxyCommitData_.tenantNameIndex),
+	    lockedTenants(&proxyCommitData_.lockedTenants),
 	    initialCommit(initialCommit_), provisionalCommitProxy(provisionalCommitProxy_),
 	    accumulativeChecksumIndex(getCommitProxyAccumulativeChecksumIndex(proxyCommitData_.commitProxyIndex)),
 	    acsBuilder(proxyCommitData_.acsBuilder), epoch(proxyCommitData_.epoch) {
@@ -160,6 +161,7 @@ private:
 	std::unordered_map<UID, StorageServerInterface>* tssMapping = nullptr;
 
 	std::map<int64_t, TenantName>* tenantMap = nullptr;
+	TenantPrefixIndex* tenantIndex = nullptr;
 	std::unordered_map<TenantName, int64_t>* tenantNameIndex = nullptr;
 	std::set<int64_t>* lockedTenants = nullptr;
 	EncryptionAtRestMode encryptMode;
@@ -836,6 +838,9 @@ private:
 				    .detail("Version", version);
 
 				(*tenantMap)[tenantEntry.id] = tenantEntry.tenantName;
+				if (tenantIndex) {
+					tenantIndex->insert(tenantEntry.id, tenantEntry.tenantLockState, advanceTenantIndexVersion());
+				}
 				if (tenantNameIndex) {
 					(*tenantNameIndex)[tenantEntry.tenantName] = tenantEntry.id;
 				}
@@ -1305,6 +1310,14 @@ private:
 		confChange = true;
 	}
 
+	// The commit proxy only reads the latest tenants from its tenant index, so it changes the index at the latest
+	// version, which this returns, and forgets the versions before
+	Version advanceTenantIndexVersion() {
+		Version v = std::max(version, tenantIndex->getLatestVersion());
+		tenantIndex->forgetVersionsBefore(v);
+		return v;
+	}
+
 	void checkClearTenantMapPrefix(KeyRangeRef range) {
 		KeyRangeRef subspace = TenantMetadata::tenantMap().subspace;
 		if (subspace.intersects(range)) {
@@ -1332,6 +1345,9 @@ private:
 				auto itr = startItr;
 				while (itr != endItr) {
 					tenantNameIndex->erase(itr->second);
+					if (tenantIndex) {
+						tenantIndex->erase(itr->first, advanceTenantIndexVersion());
+					}
 					itr++;
 				}
 
@@ -0,0 +1,145 @@
+/*
+ * BTreeKeyValueContainer.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// At the moment, this file just contains tests. BTreeKeyValueContainer is implemented in its header so that flowbench
+// can use it.
+
+#include "fdbserver/BTreeKeyValueContainer.h"
+#include "flow/IRandom.h"
+#include "flow/UnitTest.h"
+
+namespace {
+
+// Keys with long shared prefixes, short and empty suffixes and embedded zero bytes, which exercise the prefix and head
+// comparisons.
+Key randomContainerKey() {
+	static const char* prefixes[] = { "", "a", "\x15\x01tenant/", "\x15\x01tenant/\x15\x02user/" };
+	std::string key = prefixes[deterministicRandom()->randomInt(0, 4)];
+	int suffix = deterministicRandom()->randomInt(0, 8);
+	for (int i = 0; i < suffix; ++i) {
+		key.push_back("\x00\x01" "ab\xff"[deterministicRandom()->randomInt(0, 5)]);
+	}
+	return Key(key);
+}
+
+void checkSameContents(BTreeKeyValueContainer& tree, IKeyValueContainer& set) {
+	auto t = tree.begin();
+	auto s = set.begin();
+	for (; s != set.end(); ++s, ++t) {
+		ASSERT(t != tree.end());
+		ASSERT(t.getKey(nullptr) == s.getKey(nullptr));
+		ASSERT(t.getValue() == s.getValue());
+	}
+	ASSERT(t == tree.end());
+	ASSERT(tree.empty() == set.empty());
+}
+
+} // namespace
+
+TEST_CASE("/fdbserver/BTreeKeyValueContainer/random ops") {
+	for (int round = 0; round < 20; ++round) {
+		BTreeKeyValueContainer tree;
+		IKeyValueContainer set;
+		int ops = deterministicRandom()->randomInt(0, 20000);
+		for (int op = 0; op < ops; ++op) {
+			Key key = randomContainerKey();
+			int r = deterministicRandom()->randomInt(0, 10);
+			if (r < 5) {
+				Value value(std::string(deterministicRandom()->randomInt(0, 20), 'v'));
+				bool replace = deterministicRandom()->coinflip();
+				auto it = tree.insert(key, value, replace);
+				set.insert(key, value, replace);
+				ASSERT(it.getKey(nullptr) == key);
+			} else if (r < 7) {
+				Key end = randomContainerKey();
+				if (end < key) {
+					std::swap(key, end);
+				}
+				if (deterministicRandom()->random01() < 0.9) {
+					end = keyAfter(key);
+				}
+				tree.erase(tree.lower_bound(key), tree.lower_bound(end));
+				set.erase(set.lower_bound(key), set.lower_bound(end));
+			} else if (r == 7) {
+				auto t = tree.find(key);
+				auto s = set.find(key);
+				ASSERT((t == tree.end()) == (s == set.end()));
+				if (s != set.end()) {
+					ASSERT(t.getValue() == s.getValue());
+				}
+			} else if (r == 8) {
+				auto t = tree.upper_bound(key);
+				auto s = set.upper_bound(key);
+				ASSERT((t == tree.end()) == (s == set.end()));
+				if (s != set.end()) {
+					ASSERT(t.getKey(nullptr) == s.getKey(nullptr));
+				}
+			} else {
+				auto t = tree.previous(tree.lower_bound(key));
+				auto s = set.previous(set.lower_bound(key));
+				ASSERT((t == tree.end()) == (s == set.end()));
+				if (s != set.end()) {
+					ASSERT(t.getKey(nullptr) == s.getKey(nullptr));
+				}
+			}
+		}
+		checkSameContents(tree, set);
+	}
+	return Void();
+}
+
+TEST_CASE("/fdbserver/BTreeKeyValueContainer/bulk insert and erase") {
+	BTreeKeyValueContainer tree;
+	IKeyValueContainer set;
+	std::vector<std::pair<KeyValueMapPair, uint64_t>> pairs;
+	int count = 100000;
+	for (int i = 0; i < count; ++i) {
+		KeyValueMapPair pair(StringRef(format("key/%08d", i)), "value"_sr);
+		pairs.emplace_back(pair, pair.arena.getSize() + set.getElementBytes());
+	}
+	ASSERT(tree.insert(pairs) == count);
+	set.insert(pairs);
+	checkSameContents(tree, set);
+
+	uint64_t bytes = 0;
+	for (auto it = tree.begin(); it != tree.end(); ++it) {
+		bytes += it.getKey(nullptr).size() + it.getValue().size();
+	}
+	ASSERT(tree.sumTo(tree.end()) > bytes);
+	ASSERT(tree.sumTo(tree.begin()) == 0);
+
+	// Clear every other key one at a time, as individual clears would, so that leaves have to merge.
+	for (int i = 0; i < count; i += 2) {
+		Key key(format("key/%08d", i));
+		tree.erase(tree.lower_bound(key), tree.lower_bound(keyAfter(key)));
+		set.erase(set.lower_bound(key), set.lower_bound(keyAfter(key)));
+	}
+	checkSameContents(tree, set);
+
+	tree.erase(tree.lower_bound("key/00050000"_sr), tree.end());
+	set.erase(set.lower_bound("key/00050000"_sr), set.end());
+	checkSameContents(tree, set);
+
+	tree.erase(tree.begin(), tree.end());
+	ASSERT(tree.empty());
+	ASSERT(tree.sumTo(tree.end()) == 0);
+	ASSERT(tree.previous(tree.end()) == tree.end());
+	return Void();
+}
@@ -274,6 +274,8 @@ struct BackupData {
 	AsyncTrigger doneTrigger;
 
 	CounterCollection cc;
+	Counter mutationLogBytesWritten;
+	Counter mutationLogFilesWritten;
 	Future<Void> logger;
 
 	explicit BackupData(UID id, Reference<AsyncVar<ServerDBInfo> const> db, const InitializeBackupRequest& req)
@@ -281,7 +283,8 @@ struct BackupData {
 	    endVersion(req.endVersion), recruitedEpoch(req.recruitedEpoch), backupEpoch(req.backupEpoch),
 	    minKnownCommittedVersion(invalidVersion), savedVersion(req.startVersion - 1), popVersion(req.startVersion - 1),
 	    db(db), pulledVersion(0), paused(false), lock(new FlowLock(SERVER_KNOBS->BACKUP_LOCK_BYTES)),
-	    cc("BackupWorker", myId.toString()) {
+	    cc("BackupWorker", myId.toString()), mutationLogBytesWritten("MutationLogBytesWritten", cc),
+	    mutationLogFilesWritten("MutationLogFilesWritten", cc) {
 		cx = openDBOnServer(db, TaskPriority::DefaultEndpoint, LockAware::True);
 
 		specialCounter(cc, "SavedVersion", [this]() { return this->savedVersion; });
@@ -664,41 +667,76 @@ ACTOR Future<Void> saveProgress(BackupData* self, Version backupVersion) {
 	}
 }
 
-// Write a mutation to a log file. Note the mutation can be different from
-// message.message for clear mutations.
-ACTOR Future<Void> addMutation(Reference<IBackupFile> logFile,
-                               VersionedMessage message,
-                               StringRef mutation,
-                               int64_t* blockEnd,
-                               int blockSize) {
-	state int bytes = sizeof(Version) + sizeof(uint32_t) + sizeof(int) + mutation.size();
-
-	// Convert to big Endianness for version.version, version.sub, and msgSize
-	// The decoder assumes 0xFF is the end, so little endian can easily be
-	// mistaken as the end. In contrast, big endian for version almost guarantee
-	// the first byte is not 0xFF (should always be 0x00).
-	BinaryWriter wr(Unversioned());
-	wr << bigEndian64(message.version.version) << bigEndian32(message.version.sub) << bigEndian32(mutation.size());
-	state Standalone<StringRef> header = wr.toValue();
-
-	// Start a new block if needed
-	if (logFile->size() + bytes > *blockEnd) {
-		// Write padding if needed
-		const int bytesLeft = *blockEnd - logFile->size();
-		if (bytesLeft > 0) {
-			state Value paddingFFs = fileBackup::makePadding(bytesLeft);
-			wait(logFile->append(paddingFFs.begin(), bytesLeft));
+ACTOR static Future<Void> appendToLogFile(Reference<IBackupFile> logFile,
+                                          Future<Void> previousAppend,
+                                          Standalone<StringRef> data) {
+	// backup files can only have one append outstanding
+	wait(previousAppend);
+	wait(logFile->append(data.begin(), data.size()));
+	return Void();
+}
+
+// Serializes mutations into the blocks of a mutation log file, and appends them to the file in batches of
+// BACKUP_WORKER_APPEND_BATCH_BYTES. One batch is appended while the next is being serialized, so writing a file isn't
+// a round trip per mutation and the file can upload several parts of a batch at once.
+struct MutationLogFileWriter {
+	Reference<IBackupFile> logFile;
+	int blockSize;
+	int64_t blockEnd = 0;
+	int64_t bytesSerialized = 0;
+	BinaryWriter batch{ Unversioned() };
+	Future<Void> appending = Void();
+	double startTime = now();
+
+	MutationLogFileWriter(Reference<IBackupFile> logFile, int blockSize) : logFile(logFile), blockSize(blockSize) {}
+
+	// Adds a mutation to the file. Note the mutation can be different from the message for clear mutations.
+	void addMutation(const VersionedMessage& message, StringRef mutation) {
+		const int bytes = sizeof(Version) + sizeof(uint32_t) + sizeof(int) + mutation.size();
+
+		// Start a new block if needed
+		if (bytesSerialized + bytes > blockEnd) {
+			// Write padding if needed
+			const int bytesLeft = blockEnd - bytesSerialized;
+			if (bytesLeft > 0) {
+				Value paddingFFs = fileBackup::makePadding(bytesLeft);
+				batch.serializeBytes(paddingFFs);
+				bytesSerialized += bytesLeft;
+			}
+
+			blockEnd += blockSize;
+			// write block Header
+			batch << PARTITIONED_MLOG_VERSION;
+			bytesSerialized += sizeof(PARTITIONED_MLOG_VERSION);
 		}
 
-		*blockEnd += blockSize;
-		// write block Header
-		wait(logFile->append((uint8_t*)&PARTITIONED_MLOG_VERSION, sizeof(PARTITIONED_MLOG_VERSION)));
+		// Convert to big Endianness for version.version, version.sub, and msgSize
+		// The decoder assumes 0xFF is the end, so little endian can easily be
+		// mistaken as the end. In contrast, big endian for version almost guarantee
+		// the first byte is not 0xFF (should always be 0x00).
+		batch << bigEndian64(message.version.version) << bigEndian32(message.version.sub)
+		      << bigEndian32(mutation.size());
+		batch.serializeBytes(mutation);
+		bytesSerialized += bytes;
 	}
 
-	wait(logFile->append((void*)header.begin(), header.size()));
-	wait(logFile->append(mutation.begin(), mutation.size()));
-	return Void();
-}
+	bool batchFull() const { return batch.getLength() >= SERVER_KNOBS->BACKUP_WORKER_APPEND_BATCH_BYTES; }
+
+	// Starts appending the serialized batch, and returns when the previous batch has been appended
+	Future<Void> appendBatch() {
+		Future<Void> previousAppend = appending;
+		if (batch.getLength() > 0) {
+			appending = appendToLogFile(logFile, appending, batch.toValue());
+			batch = BinaryWriter(Unversioned());
+		}
+		return previousAppend;
+	}
+
+	Future<Void> finish() {
+		appendBatch();
+		return appending;
+	}
+};
 
 ACTOR static Future<Void> updateLogBytesWritten(BackupData* self,
                                                 std::vector<UID> backupUids,
@@ -734,11 +772,10 @@ ACTOR Future<Void> saveMutationsToFile(BackupData* self,
 	state int blockSize = SERVER_KNOBS->BACKUP_FILE_BLOCK_BYTES;
 	state std::vector<Future<Reference<IBackupFile>>> logFileFutures;
 	state std::vector<Reference<IBackupFile>> logFiles;
-	state std::vector<int64_t> blockEnds;
+	state std::vector<MutationLogFileWriter> writers;
 	state std::vector<UID> activeUids; // active Backups' UIDs
 	state std::vector<Version> beginVersions; // logFiles' begin versions
-	state KeyRangeMap<std::set<int>> keyRangeMap; // range to index in logFileFutures, logFiles, & blockEnds
-	state std::vector<Standalone<StringRef>> mutations;
+	state KeyRangeMap<std::set<int>> keyRangeMap; // range to index in logFileFutures, logFiles, & writers
 	state std::unordered_map<BlobCipherDetails, Reference<BlobCipherKey>> cipherKeys;
 	state int idx;
 
@@ -799,7 +836,9 @@ ACTOR Future<Void> saveMutationsToFile(BackupData* self,
 		cipherKeys = getCipherKeysResult;
 	}
 
-	blockEnds = std::vector<int64_t>(logFiles.size(), 0);
+	for (const auto& logFile : logFiles) {
+		writers.emplace_back(logFile, blockSize);
+	}
 	for (idx = 0; idx < numMsg; idx++) {
 		auto& message = self->messages[idx];
 		MutationRef m;
@@ -810,12 +849,10 @@ ACTOR Future<Void> saveMutationsToFile(BackupData* self,
 		    .detail("KCV", self->minKnownCommittedVersion)
 		    .detail("SavedVersion", self->savedVersion);
 
-		std::vector<Future<Void>> adds;
 		if (m.type != MutationRef::Type::ClearRange) {
 			for (int index : keyRangeMap[m.param1]) {
 				if (message.getVersion() >= beginVersions[index]) {
-					adds.push_back(
-					    addMutation(logFiles[index], message, message.message, &blockEnds[index], blockSize));
+					writers[index].addMutation(message, message.message);
 				}
 			}
 		} else {
@@ -829,18 +866,33 @@ ACTOR Future<Void> saveMutationsToFile(BackupData* self,
 				MutationRef subm(MutationRef::Type::ClearRange, intersectionRange.begin, intersectionRange.end);
 				BinaryWriter wr(AssumeVersion(g_network->protocolVersion()));
 				wr << subm;
-				mutations.push_back(wr.toValue());
+				Standalone<StringRef> subMutation = wr.toValue();
 				for (int index : range.value()) {
 					if (message.getVersion() >= beginVersions[index]) {
-						adds.push_back(
-						    addMutation(logFiles[index], message, mutations.back(), &blockEnds[index], blockSize));
+						writers[index].addMutation(message, subMutation);
 					}
 				}
 			}
 		}
-		wait(waitForAll(adds));
-		mutations.clear();
+
+		std::vector<Future<Void>> appends;
+		for (auto& writer : writers) {
+			if (writer.batchFull()) {
+				appends.push_back(writer.appendBatch());
+			}
+		}
+		if (!appends.empty()) {
+			wait(waitForAll(appends));
+		} else if (idx % 1000 == 999) {
+			wait(yield());
+		}
+	}
+
+	std::vector<Future<Void>> appended;
+	for (auto& writer : writers) {
+		appended.push_back(writer.finish());
 	}
+	wait(waitForAll(appended));
 
 	std::vector<Future<Void>> finished;
 	std::transform(logFiles.begin(), logFiles.end(), std::back_inserter(finished), [](const Reference<IBackupFile>& f) {
@@ -849,11 +901,16 @@ ACTOR Future<Void> saveMutationsToFile(BackupData* self,
 
 	wait(waitForAll(finished));
 
-	for (const auto& file : logFiles) {
+	for (const auto& writer : writers) {
+		const double duration = now() - writer.startTime;
+		self->mutationLogBytesWritten += writer.logFile->size();
+		++self->mutationLogFilesWritten;
 		TraceEvent("CloseMutationFile", self->myId)
-		    .detail("FileSize", file->size())
+		    .detail("FileSize", writer.logFile->size())
 		    .detail("TagId", self->tag.id)
-		    .detail("File", file->getFileName());
+		    .detail("File", writer.logFile->getFileName())
+		    .detail("Duration", duration)
+		    .detail("BytesPerSecond", duration > 0 ? writer.logFile->size() / duration : 0);
 	}
 	for (const UID& uid : activeUids) {
 		self->backups[uid].lastSavedVersion = popVersion + 1;
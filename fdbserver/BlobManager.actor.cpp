@@ -297,6 +297,9 @@ struct BlobManagerStats {
 	Counter granulesPartiallyPurged;
 	Counter filesPurged;
 	Counter granulesHitMedianLimit;
+	Counter granulesRecovered;
+
+	LatencySample assignLatencySample;
 
 	Future<Void> logger;
 	int64_t activeMerges;
@@ -307,6 +310,7 @@ struct BlobManagerStats {
 	int64_t lastManifestSeqNo;
 	int64_t lastManifestDumpTs;
 	int64_t manifestSizeInBytes;
+	int64_t lastRecoveryDurationMs;
 
 	// Current stats maintained for a given blob worker process
 	explicit BlobManagerStats(UID id,
@@ -321,9 +325,14 @@ struct BlobManagerStats {
 	    ccBytesChecked("CCBytesChecked", cc), ccMismatches("CCMismatches", cc), ccTimeouts("CCTimeouts", cc),
 	    ccErrors("CCErrors", cc), purgesProcessed("PurgesProcessed", cc),
 	    granulesFullyPurged("GranulesFullyPurged", cc), granulesPartiallyPurged("GranulesPartiallyPurged", cc),
-	    filesPurged("FilesPurged", cc), granulesHitMedianLimit("GranulesHitMedianLimit", cc), activeMerges(0),
-	    blockedAssignments(0), lastFlushVersion(0), lastMLogTruncationVersion(0), lastManifestSeqNo(0),
-	    lastManifestDumpTs(0), manifestSizeInBytes(0) {
+	    filesPurged("FilesPurged", cc), granulesHitMedianLimit("GranulesHitMedianLimit", cc),
+	    granulesRecovered("GranulesRecovered", cc),
+	    assignLatencySample("BlobManagerAssignLatencyMetrics",
+	                        id,
+	                        SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
+	                        SERVER_KNOBS->LATENCY_SKETCH_ACCURACY),
+	    activeMerges(0), blockedAssignments(0), lastFlushVersion(0), lastMLogTruncationVersion(0),
+	    lastManifestSeqNo(0), lastManifestDumpTs(0), manifestSizeInBytes(0), lastRecoveryDurationMs(0) {
 		specialCounter(cc, "WorkerCount", [workers]() { return workers->size(); });
 		specialCounter(cc, "Epoch", [epoch]() { return epoch; });
 		specialCounter(cc, "ActiveMerges", [this]() { return this->activeMerges; });
@@ -335,6 +344,7 @@ struct BlobManagerStats {
 		specialCounter(cc, "LastManifestSeqNo", [this]() { return this->lastManifestSeqNo; });
 		specialCounter(cc, "LastManifestDumpTs", [this]() { return this->lastManifestDumpTs; });
 		specialCounter(cc, "ManifestSizeInBytes", [this]() { return this->manifestSizeInBytes; });
+		specialCounter(cc, "LastRecoveryDurationMs", [this]() { return this->lastRecoveryDurationMs; });
 		logger = cc.traceCounters("BlobManagerMetrics", id, interval, "BlobManagerMetrics");
 	}
 };
@@ -414,6 +424,7 @@ struct BlobManagerData : NonCopyable, ReferenceCounted<BlobManagerData> {
 	CoalescedKeyRangeMap<bool> forcePurgingRanges;
 
 	FlowLock concurrentMergeChecks;
+	FlowLock concurrentAssignments;
 
 	AsyncTrigger startRecruiting;
 	Debouncer restartRecruiting;
@@ -448,6 +459,7 @@ struct BlobManagerData : NonCopyable, ReferenceCounted<BlobManagerData> {
 	    mergeCandidates(MergeCandidateInfo(MergeCandidateUnknown), normalKeys.end),
 	    activeGranuleMerges(invalidVersion, normalKeys.end), forcePurgingRanges(false, normalKeys.end),
 	    concurrentMergeChecks(SERVER_KNOBS->BLOB_MANAGER_CONCURRENT_MERGE_CHECKS),
+	    concurrentAssignments(SERVER_KNOBS->BLOB_MANAGER_CONCURRENT_ASSIGNMENTS),
 	    restartRecruiting(SERVER_KNOBS->DEBOUNCE_RECRUITING_DELAY), recruitingStream(0), exclusionTracker(db),
 	    epoch(epoch), dbInfo(dbInfo) {}
 
@@ -1039,6 +1051,12 @@ ACTOR Future<Void> doRangeAssignment(Reference<BlobManagerData> bmData,
 			req.managerSeqno = seqNo;
 			req.type = assignment.assign.get().type;
 
+			// bound the outstanding assignments, so a recovery that reassigns many granules at once doesn't flood the
+			// workers with granule opens
+			wait(bmData->concurrentAssignments.take());
+			state FlowLock::Releaser holdingAssignLock(bmData->concurrentAssignments);
+			state double assignStartTime = now();
+
 			// if that worker isn't alive anymore, add the range back into the stream
 			if (bmData->workersById.count(workerID.get()) == 0) {
 				throw no_more_servers();
@@ -1054,6 +1072,7 @@ ACTOR Future<Void> doRangeAssignment(Reference<BlobManagerData> bmData,
 			}
 
 			wait(assignFuture);
+			bmData->stats.assignLatencySample.addMeasurement(now() - assignStartTime);
 
 			if (assignment.previousFailure.present()) {
 				// previous assign failed and this one succeeded
@@ -1387,7 +1406,7 @@ ACTOR Future<Void> writeInitialGranuleMapping(Reference<BlobManagerData> bmData,
 	state Reference<ReadYourWritesTransaction> tr = makeReference<ReadYourWritesTransaction>(bmData->db);
 	// don't do too many in one transaction
 	state int i = 0;
-	state int transactionChunkSize = BUGGIFY ? deterministicRandom()->randomInt(2, 5) : 1000;
+	state int transactionChunkSize = SERVER_KNOBS->BLOB_MANAGER_MAPPING_WRITE_BATCH;
 	while (i < splitPoints.keys.size() - 1) {
 		CODE_PROBE(i > 0, "multiple transactions for large granule split");
 		tr->reset();
@@ -3515,6 +3534,109 @@ static void addAssignment(KeyRangeMap<std::tuple<UID, int64_t, int64_t, UID>>& m
 	}
 }
 
+// Splits the granule mapping keys into at most BLOB_MANAGER_RECOVERY_SCAN_PARALLELISM shards of about the same number
+// of granules, using the granules the workers reported as a sample of the mapping.
+static std::vector<Key> granuleMappingScanBoundaries(
+    KeyRangeMap<std::tuple<UID, int64_t, int64_t, UID>>& workerAssignments) {
+	std::vector<Key> granuleBegins;
+	for (auto& it : workerAssignments.ranges()) {
+		if (std::get<1>(it.value()) != 0 || std::get<2>(it.value()) != 0) {
+			granuleBegins.push_back(it.begin());
+		}
+	}
+
+	std::vector<Key> boundaries;
+	boundaries.push_back(blobGranuleMappingKeys.begin);
+	int shards = std::min<int>(SERVER_KNOBS->BLOB_MANAGER_RECOVERY_SCAN_PARALLELISM, granuleBegins.size());
+	for (int i = 1; i < shards; i++) {
+		Key boundary = granuleBegins[i * granuleBegins.size() / shards].withPrefix(blobGranuleMappingKeys.begin);
+		if (boundary > boundaries.back()) {
+			boundaries.push_back(boundary);
+		}
+	}
+	boundaries.push_back(blobGranuleMappingKeys.end);
+	return boundaries;
+}
+
+// Reads all of the granule mapping keys in range
+ACTOR Future<RangeResult> loadGranuleMappingShard(Reference<BlobManagerData> bmData, KeyRange range) {
+	state Reference<ReadYourWritesTransaction> tr = makeReference<ReadYourWritesTransaction>(bmData->db);
+	// FIXME: use range stream instead
+	state int rowLimit = BUGGIFY ? deterministicRandom()->randomInt(2, 10) : 10000;
+	state RangeResult mappings;
+	state Key beginKey = range.begin;
+	loop {
+		try {
+			tr->setOption(FDBTransactionOptions::ACCESS_SYSTEM_KEYS);
+			tr->setOption(FDBTransactionOptions::PRIORITY_SYSTEM_IMMEDIATE);
+			tr->setOption(FDBTransactionOptions::LOCK_AWARE);
+
+			// using the krm functions can produce incorrect behavior here as it does weird stuff with beginKey
+			RangeResult results = wait(tr->getRange(KeyRangeRef(beginKey, range.end),
+			                                        GetRangeLimits(rowLimit, GetRangeLimits::BYTE_LIMIT_UNLIMITED)));
+			mappings.arena().dependsOn(results.arena());
+			mappings.append(mappings.arena(), results.begin(), results.size());
+			if (!results.more || results.empty()) {
+				break;
+			}
+			beginKey = keyAfter(results.back().key);
+		} catch (Error& e) {
+			if (BM_DEBUG) {
+				fmt::print("BM {0} got error reading granule mapping during recovery: {1}\n", bmData->epoch, e.name());
+			}
+			wait(tr->onError(e));
+		}
+	}
+	return mappings;
+}
+
+// Applies the granule mapping keys of one shard on top of the assignments the workers reported. Shards must be applied
+// in key order, and lastMapping carries the last key of the previous shard, whose granule ends in this one.
+static void addGranuleMappings(Reference<BlobManagerData> bmData,
+                               const RangeResult& shard,
+                               KeyRangeMap<std::tuple<UID, int64_t, int64_t, UID>>& workerAssignments,
+                               std::vector<std::pair<UID, KeyRange>>& outOfDateAssignments,
+                               Optional<KeyValue>& lastMapping,
+                               Optional<KeyRange>& knownRun) {
+	for (auto& mapping : shard) {
+		if (lastMapping.present()) {
+			Key granuleStartKey = lastMapping.get().key.removePrefix(blobGranuleMappingKeys.begin);
+			Key granuleEndKey = mapping.key.removePrefix(blobGranuleMappingKeys.begin);
+			if (lastMapping.get().value.size()) {
+				// note: if the old owner is dead, we handle this in rangeAssigner
+				UID existingOwner = decodeBlobGranuleMappingValue(lastMapping.get().value);
+				// use (max int64_t, 0) to be higher than anything that existing workers have
+				addAssignment(workerAssignments,
+				              KeyRangeRef(granuleStartKey, granuleEndKey),
+				              existingOwner,
+				              std::numeric_limits<int64_t>::max(),
+				              0,
+				              outOfDateAssignments);
+
+				if (knownRun.present() && knownRun.get().end == granuleStartKey) {
+					knownRun = KeyRange(KeyRangeRef(knownRun.get().begin, granuleEndKey));
+				} else {
+					if (knownRun.present()) {
+						bmData->knownBlobRanges.insert(knownRun.get(), true);
+					}
+					knownRun = KeyRange(KeyRangeRef(granuleStartKey, granuleEndKey));
+				}
+				if (BM_DEBUG) {
+					fmt::print("  [{0} - {1})={2}\n",
+					           granuleStartKey.printable(),
+					           granuleEndKey.printable(),
+					           existingOwner.toString().substr(0, 5));
+				}
+			} else {
+				if (BM_DEBUG) {
+					fmt::print("  [{0} - {1})\n", granuleStartKey.printable(), granuleEndKey.printable());
+				}
+			}
+		}
+		lastMapping = KeyValue(mapping);
+	}
+}
+
 // essentially just error handling for resumed merge, since doMerge does it for new merge
 ACTOR Future<Void> resumeMerge(Future<Void> finishMergeFuture, KeyRange mergeRange) {
 	try {
@@ -3827,9 +3949,6 @@ ACTOR Future<Void> recoverBlobManager(Reference<BlobManagerData> bmData) {
 	state KeyRangeMap<std::tuple<UID, int64_t, int64_t, UID>> workerAssignments;
 	workerAssignments.insert(normalKeys, std::tuple(UID(), 0, 0, UID()));
 
-	// FIXME: use range stream instead
-	state int rowLimit = BUGGIFY ? deterministicRandom()->randomInt(2, 10) : 10000;
-
 	if (BM_DEBUG) {
 		fmt::print("BM {0} recovering:\n", bmData->epoch);
 	}
@@ -3905,61 +4024,28 @@ ACTOR Future<Void> recoverBlobManager(Reference<BlobManagerData> bmData) {
 	// differences (eg blob manager revoked from worker A, assigned to B, the revoke from A was processed but the assign
 	// to B wasn't, meaning in the snapshot nobody owns the granule). This also handles races with a BM persisting a
 	// boundary change, then dying before notifying the workers
-	state Key beginKey = blobGranuleMappingKeys.begin;
-	loop {
-		try {
-			tr->setOption(FDBTransactionOptions::ACCESS_SYSTEM_KEYS);
-			tr->setOption(FDBTransactionOptions::PRIORITY_SYSTEM_IMMEDIATE);
-			tr->setOption(FDBTransactionOptions::LOCK_AWARE);
-
-			KeyRange nextRange(KeyRangeRef(beginKey, blobGranuleMappingKeys.end));
-			// using the krm functions can produce incorrect behavior here as it does weird stuff with beginKey
-			state GetRangeLimits limits(rowLimit, GetRangeLimits::BYTE_LIMIT_UNLIMITED);
-			limits.minRows = 2;
-			RangeResult results = wait(tr->getRange(nextRange, limits));
-
-			// Add the mappings to our in memory key range map
-			for (int rangeIdx = 0; rangeIdx < results.size() - 1; rangeIdx++) {
-				Key granuleStartKey = results[rangeIdx].key.removePrefix(blobGranuleMappingKeys.begin);
-				Key granuleEndKey = results[rangeIdx + 1].key.removePrefix(blobGranuleMappingKeys.begin);
-				if (results[rangeIdx].value.size()) {
-					// note: if the old owner is dead, we handle this in rangeAssigner
-					UID existingOwner = decodeBlobGranuleMappingValue(results[rangeIdx].value);
-					// use (max int64_t, 0) to be higher than anything that existing workers have
-					addAssignment(workerAssignments,
-					              KeyRangeRef(granuleStartKey, granuleEndKey),
-					              existingOwner,
-					              std::numeric_limits<int64_t>::max(),
-					              0,
-					              outOfDateAssignments);
-
-					bmData->knownBlobRanges.insert(KeyRangeRef(granuleStartKey, granuleEndKey), true);
-					if (BM_DEBUG) {
-						fmt::print("  [{0} - {1})={2}\n",
-						           granuleStartKey.printable(),
-						           granuleEndKey.printable(),
-						           existingOwner.toString().substr(0, 5));
-					}
-				} else {
-					if (BM_DEBUG) {
-						fmt::print("  [{0} - {1})\n", granuleStartKey.printable(), granuleEndKey.printable());
-					}
-				}
-			}
-
-			if (!results.more || results.size() <= 1) {
-				break;
-			}
-
-			// re-read last key to get range that starts there
-			beginKey = results.back().key;
-		} catch (Error& e) {
-			if (BM_DEBUG) {
-				fmt::print("BM {0} got error reading granule mapping during recovery: {1}\n", bmData->epoch, e.name());
-			}
-			wait(tr->onError(e));
-		}
-	}
+	// The mapping is read in parallel shards, split at the boundaries the workers reported, and then applied in key
+	// order. Consecutive assigned granules are added to knownBlobRanges as one range.
+	state double mappingScanStartTime = now();
+	state std::vector<Key> scanBoundaries = granuleMappingScanBoundaries(workerAssignments);
+	state std::vector<Future<RangeResult>> mappingShards;
+	for (int i = 0; i + 1 < scanBoundaries.size(); i++) {
+		mappingShards.push_back(loadGranuleMappingShard(bmData, KeyRangeRef(scanBoundaries[i], scanBoundaries[i + 1])));
+	}
+	state Optional<KeyValue> lastMapping;
+	state Optional<KeyRange> knownRun;
+	state int shardIdx = 0;
+	for (; shardIdx < mappingShards.size(); shardIdx++) {
+		RangeResult shard = wait(mappingShards[shardIdx]);
+		addGranuleMappings(bmData, shard, workerAssignments, outOfDateAssignments, lastMapping, knownRun);
+		// free the shard once it is applied
+		mappingShards[shardIdx] = RangeResult();
+		wait(yield());
+	}
+	if (knownRun.present()) {
+		bmData->knownBlobRanges.insert(knownRun.get(), true);
+	}
+	state double mappingScanDuration = now() - mappingScanStartTime;
 
 	wait(forcePurgedRanges);
 	wait(resumeMergesFuture);
@@ -4084,9 +4170,13 @@ ACTOR Future<Void> recoverBlobManager(Reference<BlobManagerData> bmData) {
 
 	wait(loadBlobGranuleMergeBoundaries(bmData));
 
+	bmData->stats.lastRecoveryDurationMs = (now() - recoveryStartTime) * 1000;
+	bmData->stats.granulesRecovered += totalGranules;
 	TraceEvent("BlobManagerRecovered", bmData->id)
 	    .detail("Epoch", bmData->epoch)
 	    .detail("Duration", now() - recoveryStartTime)
+	    .detail("MappingScanDuration", mappingScanDuration)
+	    .detail("MappingScanShards", scanBoundaries.size() - 1)
 	    .detail("Granules", totalGranules)
 	    .detail("Assigned", explicitAssignments)
 	    .detail("Revoked", outOfDateAssignments.size());
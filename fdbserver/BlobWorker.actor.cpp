@@ -28,6 +28,7 @@
 #include "fdbclient/BackupContainerFileSystem.h"
 #include "fdbclient/BlobConnectionProvider.h"
 #include "fdbclient/BlobGranuleCommon.h"
+#include "fdbclient/BlobGranuleFileCache.h"
 #include "fdbclient/BlobGranuleReader.actor.h"
 #include "fdbclient/BlobMetadataUtils.h"
 #include "fdbclient/BlobWorkerCommon.h"
@@ -739,6 +740,12 @@ ACTOR Future<BlobFileIndex> writeDeltaFile(Reference<BlobWorkerData> bwData,
 	double duration = g_network->timer() - startTimer;
 	bwData->stats.deltaBlobWriteLatencySample.addMeasurement(duration);
 
+	// the newest delta files are the ones every read of the granule needs, so cache them before anyone asks
+	BlobGranuleFileCache* fileCache = BlobGranuleFileCache::processCache();
+	if (fileCache != nullptr && SERVER_KNOBS->BG_FILE_CACHE_PREFETCH_DELTAS) {
+		fileCache->add(fname, serialized);
+	}
+
 	// free serialized since it is persisted in blob
 	serialized = Value();
 
@@ -929,6 +936,121 @@ ACTOR Future<Void> reevaluateInitialSplit(Reference<BlobWorkerData> bwData,
                                           int64_t seqno,
                                           Key proposedSplitKey);
 
+// Writes a serialized snapshot file to blob and records it in the granule's file set
+ACTOR Future<BlobFileIndex> persistSnapshotFile(Reference<BlobWorkerData> bwData,
+                                                Reference<BlobConnectionProvider> bstore,
+                                                KeyRange keyRange,
+                                                UID granuleID,
+                                                int64_t epoch,
+                                                int64_t seqno,
+                                                Version version,
+                                                std::string fileName,
+                                                Value serialized,
+                                                size_t logicalSize,
+                                                Optional<BlobGranuleCipherKeysMeta> cipherKeysMeta,
+                                                bool initialSnapshot) {
+	state size_t serializedSize = serialized.size();
+	bwData->stats.compressionBytesRaw += logicalSize;
+	bwData->stats.compressionBytesFinal += serializedSize;
+
+	if (serializedSize >= 5 * SERVER_KNOBS->BG_SNAPSHOT_FILE_TARGET_BYTES) {
+		// TODO REMOVE key range from log
+		TraceEvent(SevWarn, "BGSnapshotTooBig", bwData->id)
+		    .suppressFor(60)
+		    .detail("GranuleID", granuleID)
+		    .detail("Granule", keyRange)
+		    .detail("Version", version)
+		    .detail("Size", serializedSize);
+	}
+
+	// write to blob using multi part upload
+	state Reference<BackupContainerFileSystem> writeBStore;
+	state std::string fname;
+	std::tie(writeBStore, fname) = bstore->createForWrite(fileName);
+
+	state double writeStartTimer = g_network->timer();
+
+	wait(writeFile(writeBStore, fname, serialized));
+
+	++bwData->stats.s3PutReqs;
+	++bwData->stats.snapshotFilesWritten;
+	bwData->stats.snapshotBytesWritten += serializedSize;
+	double duration = g_network->timer() - writeStartTimer;
+	bwData->stats.snapshotBlobWriteLatencySample.addMeasurement(duration);
+
+	// free serialized since it is persisted in blob
+	serialized = Value();
+
+	wait(delay(0, TaskPriority::BlobWorkerUpdateFDB));
+	// object uploaded successfully, save it to system key space
+
+	state Reference<ReadYourWritesTransaction> tr = makeReference<ReadYourWritesTransaction>(bwData->db);
+	state int numIterations = 0;
+
+	try {
+		loop {
+			tr->setOption(FDBTransactionOptions::ACCESS_SYSTEM_KEYS);
+			tr->setOption(FDBTransactionOptions::PRIORITY_SYSTEM_IMMEDIATE);
+			tr->setOption(FDBTransactionOptions::LOCK_AWARE);
+			try {
+				wait(readAndCheckGranuleLock(tr, keyRange, epoch, seqno));
+				numIterations++;
+				Key snapshotFileKey = blobGranuleFileKeyFor(granuleID, version, 'S');
+				// TODO change once we support file multiplexing
+				Key snapshotFileValue =
+				    blobGranuleFileValueFor(fname, 0, serializedSize, serializedSize, logicalSize, cipherKeysMeta);
+				tr->set(snapshotFileKey, snapshotFileValue);
+				// create granule history at version if this is a new granule with the initial dump from FDB
+				if (initialSnapshot) {
+					Key historyKey = blobGranuleHistoryKeyFor(keyRange, version);
+					Standalone<BlobGranuleHistoryValue> historyValue;
+					historyValue.granuleID = granuleID;
+					tr->set(historyKey, blobGranuleHistoryValueFor(historyValue));
+				}
+				wait(tr->commit());
+				bwData->addGRVHistory(tr->getReadVersion().get());
+				break;
+			} catch (Error& e) {
+				wait(tr->onError(e));
+			}
+		}
+	} catch (Error& e) {
+		// If this actor was cancelled, doesn't own the granule anymore, or got some other error before trying to
+		// commit a transaction, we can and want to safely delete the file we wrote. Otherwise, we may have updated FDB
+		// with file and cannot safely delete it.
+		if (numIterations > 0) {
+			CODE_PROBE(true, "Granule potentially leaving orphaned snapshot file");
+			throw e;
+		}
+		if (BW_DEBUG) {
+			fmt::print("deleting snapshot file {0} after error {1}\n", fname, e.name());
+		}
+		CODE_PROBE(true, "Granule deleting snapshot file after error");
+		++bwData->stats.s3DeleteReqs;
+		bwData->addActor.send(writeBStore->deleteFile(fname));
+		throw e;
+	}
+
+	if (BW_DEBUG) {
+		fmt::print("Granule [{0} - {1}) committed new snapshot file {2} with {3} bytes\n\n",
+		           keyRange.begin.printable(),
+		           keyRange.end.printable(),
+		           fname,
+		           serializedSize);
+	}
+
+	if (BUGGIFY_WITH_PROB(0.1)) {
+		wait(delay(deterministicRandom()->random01()));
+	}
+
+	if (BUGGIFY && bwData->maybeInjectTargetedRestart()) {
+		wait(Never());
+	}
+
+	// FIXME: change when we implement multiplexing
+	return BlobFileIndex(version, fname, 0, serializedSize, serializedSize, logicalSize, cipherKeysMeta);
+}
+
 ACTOR Future<BlobFileIndex> writeSnapshot(Reference<BlobWorkerData> bwData,
                                           Reference<BlobConnectionProvider> bstore,
                                           KeyRange keyRange,
@@ -1027,102 +1149,25 @@ ACTOR Future<BlobFileIndex> writeSnapshot(Reference<BlobWorkerData> bwData,
 	                                                  compressFilter,
 	                                                  cipherKeysCtx);
 	state size_t logicalSize = snapshot.expectedSize();
-	state size_t serializedSize = serialized.size();
-	bwData->stats.compressionBytesRaw += logicalSize;
-	bwData->stats.compressionBytesFinal += serializedSize;
 
 	// free snapshot to reduce memory
 	snapshot = Standalone<GranuleSnapshot>();
 
-	if (serializedSize >= 5 * SERVER_KNOBS->BG_SNAPSHOT_FILE_TARGET_BYTES) {
-		// TODO REMOVE key range from log
-		TraceEvent(SevWarn, "BGSnapshotTooBig", bwData->id)
-		    .suppressFor(60)
-		    .detail("GranuleID", granuleID)
-		    .detail("Granule", keyRange)
-		    .detail("Version", version)
-		    .detail("Size", serializedSize);
-	}
-
-	// write to blob using multi part upload
-	state Reference<BackupContainerFileSystem> writeBStore;
-	state std::string fname;
-	std::tie(writeBStore, fname) = bstore->createForWrite(fileName);
-
-	state double writeStartTimer = g_network->timer();
-
-	wait(writeFile(writeBStore, fname, serialized));
-
-	++bwData->stats.s3PutReqs;
-	++bwData->stats.snapshotFilesWritten;
-	bwData->stats.snapshotBytesWritten += serializedSize;
-	double duration = g_network->timer() - writeStartTimer;
-	bwData->stats.snapshotBlobWriteLatencySample.addMeasurement(duration);
-
-	// free serialized since it is persisted in blob
+	state Future<BlobFileIndex> persisted = persistSnapshotFile(bwData,
+	                                                            bstore,
+	                                                            keyRange,
+	                                                            granuleID,
+	                                                            epoch,
+	                                                            seqno,
+	                                                            version,
+	                                                            fileName,
+	                                                            serialized,
+	                                                            logicalSize,
+	                                                            cipherKeysMeta,
+	                                                            initialSnapshot);
+	// free serialized once it is persisted in blob
 	serialized = Value();
-
-	wait(delay(0, TaskPriority::BlobWorkerUpdateFDB));
-	// object uploaded successfully, save it to system key space
-
-	state Reference<ReadYourWritesTransaction> tr = makeReference<ReadYourWritesTransaction>(bwData->db);
-	state int numIterations = 0;
-
-	try {
-		loop {
-			tr->setOption(FDBTransactionOptions::ACCESS_SYSTEM_KEYS);
-			tr->setOption(FDBTransactionOptions::PRIORITY_SYSTEM_IMMEDIATE);
-			tr->setOption(FDBTransactionOptions::LOCK_AWARE);
-			try {
-				wait(readAndCheckGranuleLock(tr, keyRange, epoch, seqno));
-				numIterations++;
-				Key snapshotFileKey = blobGranuleFileKeyFor(granuleID, version, 'S');
-				// TODO change once we support file multiplexing
-				Key snapshotFileValue =
-				    blobGranuleFileValueFor(fname, 0, serializedSize, serializedSize, logicalSize, cipherKeysMeta);
-				tr->set(snapshotFileKey, snapshotFileValue);
-				// create granule history at version if this is a new granule with the initial dump from FDB
-				if (initialSnapshot) {
-					Key historyKey = blobGranuleHistoryKeyFor(keyRange, version);
-					Standalone<BlobGranuleHistoryValue> historyValue;
-					historyValue.granuleID = granuleID;
-					tr->set(historyKey, blobGranuleHistoryValueFor(historyValue));
-				}
-				wait(tr->commit());
-				bwData->addGRVHistory(tr->getReadVersion().get());
-				break;
-			} catch (Error& e) {
-				wait(tr->onError(e));
-			}
-		}
-	} catch (Error& e) {
-		// If this actor was cancelled, doesn't own the granule anymore, or got some other error before trying to
-		// commit a transaction, we can and want to safely delete the file we wrote. Otherwise, we may have updated FDB
-		// with file and cannot safely delete it.
-		if (numIterations > 0) {
-			CODE_PROBE(true, "Granule potentially leaving orphaned snapshot file");
-			throw e;
-		}
-		if (BW_DEBUG) {
-			fmt::print("deleting snapshot file {0} after error {1}\n", fname, e.name());
-		}
-		CODE_PROBE(true, "Granule deleting snapshot file after error");
-		++bwData->stats.s3DeleteReqs;
-		bwData->addActor.send(writeBStore->deleteFile(fname));
-		throw e;
-	}
-
-	if (BW_DEBUG) {
-		fmt::print("Granule [{0} - {1}) committed new snapshot file {2} with {3} bytes\n\n",
-		           keyRange.begin.printable(),
-		           keyRange.end.printable(),
-		           fname,
-		           serializedSize);
-	}
-
-	if (BUGGIFY_WITH_PROB(0.1)) {
-		wait(delay(deterministicRandom()->random01()));
-	}
+	BlobFileIndex f = wait(persisted);
 
 	if (BW_DEBUG) {
 		TraceEvent(SevDebug, "SnapshotFileWritten")
@@ -1131,12 +1176,7 @@ ACTOR Future<BlobFileIndex> writeSnapshot(Reference<BlobWorkerData> bwData,
 		    .detail("Compressed", compressFilter.present());
 	}
 
-	if (BUGGIFY && bwData->maybeInjectTargetedRestart()) {
-		wait(Never());
-	}
-
-	// FIXME: change when we implement multiplexing
-	return BlobFileIndex(version, fname, 0, serializedSize, serializedSize, logicalSize, cipherKeysMeta);
+	return f;
 }
 
 ACTOR Future<BlobFileIndex> dumpInitialSnapshotFromFDB(Reference<BlobWorkerData> bwData,
@@ -1265,7 +1305,9 @@ ACTOR Future<BlobFileIndex> compactFromBlob(Reference<BlobWorkerData> bwData,
 	}
 
 	state Arena filenameArena;
-	state std::vector<Future<RangeResult>> chunksToRead;
+	state std::vector<BlobGranuleChunkRef> chunks;
+	state std::vector<int64_t> snapshotLogicalBytes;
+	state std::vector<Future<BlobGranuleFileData>> filesToRead;
 	state int64_t compactBytesRead = 0;
 	state double resnapshotStartTimer = g_network->timer();
 
@@ -1338,7 +1380,9 @@ ACTOR Future<BlobFileIndex> compactFromBlob(Reference<BlobWorkerData> bwData,
 		}
 		ASSERT(lastDeltaVersion >= version);
 		chunk.includedVersion = version;
-		chunksToRead.push_back(readBlobGranule(chunk, metadata->keyRange, 0, version, bstore, &bwData->stats));
+		chunks.push_back(chunk);
+		snapshotLogicalBytes.push_back(snapshotF.logicalSize);
+		filesToRead.push_back(readBlobGranuleFiles(chunk, metadata->keyRange, bstore, &bwData->stats));
 	}
 
 	if (BW_DEBUG) {
@@ -1349,26 +1393,82 @@ ACTOR Future<BlobFileIndex> compactFromBlob(Reference<BlobWorkerData> bwData,
 	}
 
 	try {
-		state PromiseStream<RangeResult> rowsStream;
-		state Future<BlobFileIndex> snapshotWriter = writeSnapshot(bwData,
-		                                                           bstore,
-		                                                           metadata->keyRange,
-		                                                           granuleID,
-		                                                           metadata->originalEpoch,
-		                                                           metadata->originalSeqno,
-		                                                           version,
-		                                                           rowsStream,
-		                                                           false);
-		state int resultIdx;
-		for (resultIdx = 0; resultIdx < chunksToRead.size(); resultIdx++) {
-			RangeResult newGranuleChunk = wait(chunksToRead[resultIdx]);
-			rowsStream.send(std::move(newGranuleChunk));
+		state std::string fileName = randomBGFilename(bwData->id, granuleID, version, ".snapshot");
+		state Optional<BlobGranuleCipherKeysCtx> cipherKeysCtx;
+		state Optional<BlobGranuleCipherKeysMeta> cipherKeysMeta;
+		if (bwData->encryptMode.isEncryptionEnabled()) {
+			BlobGranuleCipherKeysCtx ciphKeysCtx =
+			    wait(getLatestGranuleCipherKeys(bwData, metadata->keyRange, &filenameArena));
+			cipherKeysCtx = std::move(ciphKeysCtx);
+			cipherKeysMeta = BlobGranuleCipherKeysCtx::toCipherKeysMeta(cipherKeysCtx.get());
+		}
+		ASSERT(!bwData->encryptMode.isEncryptionEnabled() || cipherKeysCtx.present());
+		state bool reuseChunks = SERVER_KNOBS->BG_RESNAPSHOT_REUSE_CHUNKS && !cipherKeysCtx.present();
+
+		// Merge the previous snapshot with the deltas one snapshot chunk at a time, so only one chunk worth of rows is
+		// materialized at once and the new file is held as serialized chunks. Chunks no delta touches are copied as is.
+		state SnapshotFileBuilder builder(StringRef(fileName),
+		                                  SERVER_KNOBS->BG_SNAPSHOT_FILE_TARGET_CHUNK_BYTES,
+		                                  getBlobFileCompressFilter(),
+		                                  cipherKeysCtx);
+		state int chunkIdx;
+		for (chunkIdx = 0; chunkIdx < chunks.size(); chunkIdx++) {
+			state BlobGranuleFileData data = wait(filesToRead[chunkIdx]);
+			state std::vector<StringRef> deltaData = data.deltaRefs();
+			state Standalone<VectorRef<ResnapshotPieceRef>> pieces =
+			    getResnapshotPieces(chunks[chunkIdx], metadata->keyRange, data.snapshotRef());
+			state int pieceIdx;
+			for (pieceIdx = 0; pieceIdx < pieces.size(); pieceIdx++) {
+				const ResnapshotPieceRef& piece = pieces[pieceIdx];
+				if (reuseChunks && piece.serializedChunk.present() &&
+				    !granuleDeltasTouchRange(chunks[chunkIdx], piece.range, version, deltaData)) {
+					CODE_PROBE(true, "Re-snapshot reusing unchanged snapshot chunk");
+					// the logical size of a chunk isn't recorded, so estimate it from the ratio of the whole file
+					int64_t chunkLogicalBytes = piece.serializedChunk.get().size() * snapshotLogicalBytes[chunkIdx] /
+					                            std::max<int64_t>(1, data.snapshotData.get().size());
+					builder.addSerializedChunk(
+					    piece.range.begin, piece.range.end, piece.serializedChunk.get(), chunkLogicalBytes);
+				} else {
+					GranuleMaterializeStats stats;
+					RangeResult rows = materializeBlobGranule(
+					    chunks[chunkIdx], piece.range, 0, version, data.snapshotRef(), deltaData, stats);
+					for (auto& kv : rows) {
+						builder.add(kv);
+					}
+				}
+				wait(yield(TaskPriority::BlobWorkerUpdateStorage));
+			}
+			// free the files of this granule before reading on
+			filesToRead[chunkIdx] = Future<BlobGranuleFileData>();
+			data = BlobGranuleFileData();
+			deltaData.clear();
+			pieces = Standalone<VectorRef<ResnapshotPieceRef>>();
 		}
 
 		bwData->stats.bytesReadFromS3ForCompaction += compactBytesRead;
-		rowsStream.sendError(end_of_stream());
 
-		BlobFileIndex f = wait(snapshotWriter);
+		if (BW_DEBUG) {
+			fmt::print("Granule [{0} - {1}) re-snapshotted {2} rows ({3} bytes), reusing {4} chunks\n",
+			           metadata->keyRange.begin.printable(),
+			           metadata->keyRange.end.printable(),
+			           builder.rows,
+			           builder.logicalBytes,
+			           builder.serializedChunksReused);
+		}
+
+		state Future<BlobFileIndex> persisted = persistSnapshotFile(bwData,
+		                                                            bstore,
+		                                                            metadata->keyRange,
+		                                                            granuleID,
+		                                                            metadata->originalEpoch,
+		                                                            metadata->originalSeqno,
+		                                                            version,
+		                                                            fileName,
+		                                                            builder.finish(),
+		                                                            builder.logicalBytes,
+		                                                            cipherKeysMeta,
+		                                                            false);
+		BlobFileIndex f = wait(persisted);
 		DEBUG_KEY_RANGE("BlobWorkerBlobSnapshot", version, metadata->keyRange, bwData->id);
 		double duration = g_network->timer() - resnapshotStartTimer;
 		bwData->stats.reSnapshotLatencySample.addMeasurement(duration);
@@ -1455,6 +1455,22 @@ ACTOR Future<Void> timeKeeper(ClusterControllerData* self) {
 	}
 }
 
+// Replies to req with status, or with the fault tolerance part of it if that is all req asked for, which is computed
+// once per status
+static void sendStatusReply(StatusRequest const& req,
+                            StatusReply const& status,
+                            Optional<StatusReply>& faultToleranceRelatedStatus) {
+	if (req.statusField.empty()) {
+		req.reply.send(status);
+		return;
+	}
+	ASSERT(req.statusField == "fault_tolerance");
+	if (!faultToleranceRelatedStatus.present()) {
+		faultToleranceRelatedStatus = clusterGetFaultToleranceStatus(status.statusStr);
+	}
+	req.reply.send(faultToleranceRelatedStatus.get());
+}
+
 ACTOR Future<Void> statusServer(FutureStream<StatusRequest> requests,
                                 ClusterControllerData* self,
                                 ServerCoordinators coordinators,
@@ -1465,11 +1481,23 @@ ACTOR Future<Void> statusServer(FutureStream<StatusRequest> requests,
 	// Place to accumulate a batch of requests to respond to
 	state std::vector<StatusRequest> requests_batch;
 
+	// The last status generated, which requests are answered with while it is no older than
+	// STATUS_CACHE_MAX_STALENESS. Generating status gathers metrics from every worker, which is expensive on large
+	// clusters, so this bounds how often that happens no matter how many clients poll status.
+	state Optional<StatusReply> cachedStatus;
+	state Optional<StatusReply> cachedFaultToleranceStatus;
+	state double cachedStatusTime = 0.0;
+
 	loop {
 		try {
 			// Wait til first request is ready
 			StatusRequest req = waitNext(requests);
 			++self->statusRequests;
+			if (cachedStatus.present() && now() - cachedStatusTime <= SERVER_KNOBS->STATUS_CACHE_MAX_STALENESS) {
+				++self->statusRequestsFromCache;
+				sendStatusReply(req, cachedStatus.get(), cachedFaultToleranceStatus);
+				continue;
+			}
 			requests_batch.push_back(req);
 
 			// Earliest time at which we may begin a new request
@@ -1540,23 +1568,22 @@ ACTOR Future<Void> statusServer(FutureStream<StatusRequest> requests,
 			// requests
 			last_request_time = now();
 
-			state Optional<StatusReply> faultToleranceRelatedStatus;
+			cachedFaultToleranceStatus.reset();
+			if (result.isError()) {
+				cachedStatus.reset();
+			} else {
+				cachedStatus = result.get();
+				cachedStatusTime = last_request_time;
+			}
+
 			while (!requests_batch.empty()) {
 				if (result.isError())
 					requests_batch.back().reply.sendError(result.getError());
-				else if (requests_batch.back().statusField.empty())
-					requests_batch.back().reply.send(result.get());
-				else {
-					ASSERT(requests_batch.back().statusField == "fault_tolerance");
-					if (!faultToleranceRelatedStatus.present()) {
-						faultToleranceRelatedStatus = clusterGetFaultToleranceStatus(result.get().statusStr);
-					}
-					requests_batch.back().reply.send(faultToleranceRelatedStatus.get());
-				}
+				else
+					sendStatusReply(requests_batch.back(), result.get(), cachedFaultToleranceStatus);
 				requests_batch.pop_back();
 				wait(yield());
 			}
-			faultToleranceRelatedStatus.reset();
 		} catch (Error& e) {
 			TraceEvent(SevError, "StatusServerError").error(e);
 			throw e;
@@ -2897,9 +2924,17 @@ ACTOR Future<Void> monitorBlobManager(ClusterControllerData* self) {
 	}
 }
 
+template <class T>
+static bool sameSerialized(T const& a, T const& b) {
+	return BinaryWriter::toValue(a, AssumeVersion(g_network->protocolVersion())) ==
+	       BinaryWriter::toValue(b, AssumeVersion(g_network->protocolVersion()));
+}
+
 ACTOR Future<Void> dbInfoUpdater(ClusterControllerData* self) {
 	state Future<Void> dbInfoChange = self->db.serverInfo->onChange();
 	state Future<Void> updateDBInfo = self->updateDBInfo.onTrigger();
+	// The ServerDBInfo last broadcast to all workers, which the next broadcast to all workers is a delta from
+	state Optional<ServerDBInfo> lastBroadcastInfo;
 	loop {
 		choose {
 			when(wait(updateDBInfo)) {
@@ -2927,11 +2962,35 @@ ACTOR Future<Void> dbInfoUpdater(ClusterControllerData* self) {
 		dbInfoChange = self->db.serverInfo->onChange();
 		updateDBInfo = self->updateDBInfo.onTrigger();
 
-		req.serializedDbInfo =
-		    BinaryWriter::toValue(self->db.serverInfo->get(), AssumeVersion(g_network->protocolVersion()));
+		// A change is broadcast to all workers as a delta from the previous change, which most of them have. Workers
+		// that are being caught up, such as new ones and ones that couldn't apply a delta, get the full ServerDBInfo.
+		ServerDBInfo const& info = self->db.serverInfo->get();
+		if (SERVER_KNOBS->DBINFO_SEND_DELTAS && dbInfoChange.isReady() && lastBroadcastInfo.present() &&
+		    lastBroadcastInfo.get().clusterInterface == info.clusterInterface) {
+			ServerDBInfo delta = info;
+			if (sameSerialized(info.client, lastBroadcastInfo.get().client)) {
+				delta.client = ClientDBInfo();
+				req.omitsClient = true;
+			}
+			if (sameSerialized(info.logSystemConfig, lastBroadcastInfo.get().logSystemConfig)) {
+				delta.logSystemConfig = LogSystemConfig();
+				req.omitsLogSystemConfig = true;
+			}
+			if (req.omitsClient || req.omitsLogSystemConfig) {
+				req.baseInfoGeneration = lastBroadcastInfo.get().infoGeneration;
+			}
+			req.serializedDbInfo = BinaryWriter::toValue(delta, AssumeVersion(g_network->protocolVersion()));
+		} else {
+			req.serializedDbInfo = BinaryWriter::toValue(info, AssumeVersion(g_network->protocolVersion()));
+		}
+		if (dbInfoChange.isReady()) {
+			lastBroadcastInfo = info;
+		}
 
 		TraceEvent("DBInfoStartBroadcast", self->id)
-		    .detail("MasterLifetime", self->db.serverInfo->get().masterLifetime.toString());
+		    .detail("MasterLifetime", self->db.serverInfo->get().masterLifetime.toString())
+		    .detail("Bytes", req.serializedDbInfo.size())
+		    .detail("BaseInfoGeneration", req.baseInfoGeneration);
 		choose {
 			when(std::vector<Endpoint> notUpdated =
 			         wait(broadcastDBInfoRequest(req, SERVER_KNOBS->DBINFO_SEND_AMOUNT, Optional<Endpoint>(), false))) {
@@ -3055,6 +3114,9 @@ ACTOR Future<Void> metaclusterMetricsUpdater(ClusterControllerData* self) {
 				try {
 					wait(store(self->db.metaclusterMetrics,
 					           metacluster::MetaclusterMetrics::getMetaclusterMetrics(self->cx)));
+					if (CLIENT_KNOBS->METACLUSTER_LOAD_AWARE_ASSIGNMENT) {
+						wait(metacluster::updateDataClusterLoads(self->cx));
+					}
 				} catch (Error& e) {
 					// Ignore errors about the cluster changing type
 					if (e.code() != error_code_invalid_metacluster_operation) {
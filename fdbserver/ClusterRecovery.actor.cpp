@@ -971,6 +971,7 @@ ACTOR Future<std::vector<Standalone<CommitTransactionRef>>> recruitEverything(
 		    .setMaxFieldLength(-1)
 		    .detail("StatusCode", RecoveryStatus::recruiting_transaction_servers)
 		    .detail("Status", RecoveryStatus::names[RecoveryStatus::recruiting_transaction_servers])
+		    .detail("PreviousPhaseDuration", self->endRecoveryPhase())
 		    .detail("Conf", self->configuration.toString())
 		    .detail("RequiredCommitProxies", 1)
 		    .detail("RequiredGrvProxies", 1)
@@ -1024,6 +1025,7 @@ ACTOR Future<std::vector<Standalone<CommitTransactionRef>>> recruitEverything(
 	TraceEvent(getRecoveryEventName(ClusterRecoveryEventType::CLUSTER_RECOVERY_STATE_EVENT_NAME).c_str(), self->dbgid)
 	    .detail("StatusCode", RecoveryStatus::initializing_transaction_servers)
 	    .detail("Status", RecoveryStatus::names[RecoveryStatus::initializing_transaction_servers])
+	    .detail("PreviousPhaseDuration", self->endRecoveryPhase())
 	    .detail("CommitProxies", recruits.commitProxies.size())
 	    .detail("GrvProxies", recruits.grvProxies.size())
 	    .detail("TLogs", recruits.tLogs.size())
@@ -1036,13 +1038,16 @@ ACTOR Future<std::vector<Standalone<CommitTransactionRef>>> recruitEverything(
 	    .detail("RemoteDcIds", remoteDcIds)
 	    .trackLatest(self->clusterRecoveryStateEventHolder->trackingKey);
 
+	// The proxies and resolvers don't depend on the seed servers or the new tlogs, so they are initialized while those
+	// are. The tlogs are initialized after the seed servers, whose localities they need.
+	state Future<Void> proxiesAndResolvers =
+	    newCommitProxies(self, recruits) && newGrvProxies(self, recruits) && newResolvers(self, recruits);
+
 	// Actually, newSeedServers does both the recruiting and initialization of the seed servers; so if this is a brand
-	// new database we are sort of lying that we are past the recruitment phase.  In a perfect world we would split that
-	// up so that the recruitment part happens above (in parallel with recruiting the transaction servers?).
-	wait(newSeedServers(self, recruits, seedServers));
+	// new database we are sort of lying that we are past the recruitment phase.
+	wait(newSeedServers(self, recruits, seedServers) || (proxiesAndResolvers && Never()));
 	state std::vector<Standalone<CommitTransactionRef>> confChanges;
-	wait(newCommitProxies(self, recruits) && newGrvProxies(self, recruits) && newResolvers(self, recruits) &&
-	     newTLogServers(self, recruits, oldLogSystem, &confChanges));
+	wait(proxiesAndResolvers && newTLogServers(self, recruits, oldLogSystem, &confChanges));
 
 	// Update recovery related information to the newly elected sequencer (master) process.
 	wait(brokenPromiseToNever(
@@ -1399,6 +1404,7 @@ ACTOR Future<Void> recoverFrom(Reference<ClusterRecoveryData> self,
 	TraceEvent(getRecoveryEventName(ClusterRecoveryEventType::CLUSTER_RECOVERY_STATE_EVENT_NAME).c_str(), self->dbgid)
 	    .detail("StatusCode", RecoveryStatus::reading_transaction_system_state)
 	    .detail("Status", RecoveryStatus::names[RecoveryStatus::reading_transaction_system_state])
+	    .detail("PreviousPhaseDuration", self->endRecoveryPhase())
 	    .trackLatest(self->clusterRecoveryStateEventHolder->trackingKey);
 	self->hasConfiguration = false;
 
@@ -1480,6 +1486,7 @@ ACTOR Future<Void> recoverFrom(Reference<ClusterRecoveryData> self,
 ACTOR Future<Void> clusterRecoveryCore(Reference<ClusterRecoveryData> self) {
 	state TraceInterval recoveryInterval("ClusterRecovery");
 	state double recoverStartTime = now();
+	self->recoveryPhaseStart = recoverStartTime;
 
 	self->addActor.send(waitFailureServer(self->masterInterface.waitFailure.getFuture()));
 
@@ -1508,6 +1515,7 @@ ACTOR Future<Void> clusterRecoveryCore(Reference<ClusterRecoveryData> self) {
 	TraceEvent(getRecoveryEventName(ClusterRecoveryEventType::CLUSTER_RECOVERY_STATE_EVENT_NAME).c_str(), self->dbgid)
 	    .detail("StatusCode", RecoveryStatus::locking_coordinated_state)
 	    .detail("Status", RecoveryStatus::names[RecoveryStatus::locking_coordinated_state])
+	    .detail("PreviousPhaseDuration", self->endRecoveryPhase())
 	    .detail("TLogs", self->cstate.prevDBState.tLogs.size())
 	    .detail("ActiveGenerations", self->cstate.myDBState.oldTLogData.size() + 1)
 	    .detail("MyRecoveryCount", self->cstate.prevDBState.recoveryCount + 2)
@@ -1626,6 +1634,7 @@ ACTOR Future<Void> clusterRecoveryCore(Reference<ClusterRecoveryData> self) {
 	TraceEvent(getRecoveryEventName(ClusterRecoveryEventType::CLUSTER_RECOVERY_STATE_EVENT_NAME).c_str(), self->dbgid)
 	    .detail("StatusCode", RecoveryStatus::recovery_transaction)
 	    .detail("Status", RecoveryStatus::names[RecoveryStatus::recovery_transaction])
+	    .detail("PreviousPhaseDuration", self->endRecoveryPhase())
 	    .detail("PrimaryLocality", self->primaryLocality)
 	    .detail("DcId", self->masterInterface.locality.dcId())
 	    .trackLatest(self->clusterRecoveryStateEventHolder->trackingKey);
@@ -1753,6 +1762,7 @@ ACTOR Future<Void> clusterRecoveryCore(Reference<ClusterRecoveryData> self) {
 	TraceEvent(getRecoveryEventName(ClusterRecoveryEventType::CLUSTER_RECOVERY_STATE_EVENT_NAME).c_str(), self->dbgid)
 	    .detail("StatusCode", RecoveryStatus::writing_coordinated_state)
 	    .detail("Status", RecoveryStatus::names[RecoveryStatus::writing_coordinated_state])
+	    .detail("PreviousPhaseDuration", self->endRecoveryPhase())
 	    .detail("TLogList", self->logSystem->describe())
 	    .trackLatest(self->clusterRecoveryStateEventHolder->trackingKey);
 
@@ -1796,6 +1806,7 @@ ACTOR Future<Void> clusterRecoveryCore(Reference<ClusterRecoveryData> self) {
 	TraceEvent(getRecoveryEventName(ClusterRecoveryEventType::CLUSTER_RECOVERY_STATE_EVENT_NAME).c_str(), self->dbgid)
 	    .detail("StatusCode", RecoveryStatus::accepting_commits)
 	    .detail("Status", RecoveryStatus::names[RecoveryStatus::accepting_commits])
+	    .detail("PreviousPhaseDuration", self->endRecoveryPhase())
 	    .detail("StoreType", self->configuration.storageServerStoreType)
 	    .detail("RecoveryDuration", recoveryDuration)
 	    .trackLatest(self->clusterRecoveryStateEventHolder->trackingKey);
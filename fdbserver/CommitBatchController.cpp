@@ -0,0 +1,151 @@
+/*
+ * CommitBatchController.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+
+#include "fdbserver/CommitBatchController.h"
+#include "flow/Error.h"
+#include "flow/UnitTest.h"
+
+CommitBatchController::CommitBatchController(double initialInterval,
+                                             double minInterval,
+                                             double maxInterval,
+                                             double targetLatency,
+                                             double gain,
+                                             int maxBatchesInFlight,
+                                             int window)
+  : minInterval(minInterval), maxInterval(std::max(minInterval, maxInterval)), targetLatency(targetLatency), gain(gain),
+    maxBatchesInFlight(maxBatchesInFlight) {
+	// As in the default batching, the minimum wins if BUGGIFY put it above the maximum
+	ASSERT(window > 0);
+	currentInterval = std::clamp(initialInterval, this->minInterval, this->maxInterval);
+	recentLatencies.reserve(window);
+}
+
+double CommitBatchController::update(const BatchTiming& timing) {
+	if (recentLatencies.size() < recentLatencies.capacity()) {
+		recentLatencies.push_back(timing.latency);
+	} else {
+		recentLatencies[nextLatency] = timing.latency;
+		nextLatency = (nextLatency + 1) % recentLatencies.size();
+	}
+	std::vector<double> sorted(recentLatencies);
+	auto p99 = sorted.begin() + (sorted.size() - 1) * 99 / 100;
+	std::nth_element(sorted.begin(), p99, sorted.end());
+	latencyP99 = *p99;
+
+	resolutionTime += gain * (timing.resolution - resolutionTime);
+	queuingTime += gain * (timing.queuing - queuingTime);
+	loggingTime += gain * (timing.logging - loggingTime);
+
+	const double slack = targetLatency - (currentInterval + latencyP99);
+	if (timing.batchesInFlight > maxBatchesInFlight) {
+		currentInterval *= 1 + gain;
+	} else if (slack < 0 || timing.batchesInFlight > 1) {
+		currentInterval += gain * slack;
+	} else {
+		currentInterval -= gain * (currentInterval - minInterval);
+	}
+	currentInterval = std::clamp(currentInterval, minInterval, maxInterval);
+	return currentInterval;
+}
+
+CommitBatchController::Stage CommitBatchController::limitingStage() const {
+	Stage stage = Stage::Batching;
+	double longest = currentInterval;
+	for (auto [s, time] : { std::make_pair(Stage::Resolution, resolutionTime),
+	                        std::make_pair(Stage::Queuing, queuingTime),
+	                        std::make_pair(Stage::Logging, loggingTime) }) {
+		if (time > longest) {
+			stage = s;
+			longest = time;
+		}
+	}
+	return stage;
+}
+
+const char* CommitBatchController::stageName(Stage stage) {
+	switch (stage) {
+	case Stage::Batching:
+		return "Batching";
+	case Stage::Resolution:
+		return "Resolution";
+	case Stage::Queuing:
+		return "Queuing";
+	case Stage::Logging:
+		return "Logging";
+	}
+	UNREACHABLE();
+}
+
+TEST_CASE("/fdbserver/CommitBatchController/converges") {
+	CommitBatchController::BatchTiming timing;
+	timing.resolution = 0.002;
+	timing.logging = 0.004;
+
+	// Batches queue up and have latency to spare: the interval grows until interval plus batch latency nears the target
+	CommitBatchController controller(0.001, 0.001, 0.020, 0.025, 0.1, 10, 100);
+	timing.latency = 0.008;
+	timing.batchesInFlight = 3;
+	for (int i = 0; i < 500; i++) {
+		controller.update(timing);
+	}
+	ASSERT(controller.interval() > 0.016 && controller.interval() <= 0.017);
+	ASSERT(controller.batchLatencyP99() == 0.008);
+	ASSERT(controller.limitingStage() == CommitBatchController::Stage::Batching);
+
+	// A few slow batches in the window push the 99th percentile over the target, and the interval shrinks
+	timing.latency = 0.030;
+	for (int i = 0; i < 5; i++) {
+		controller.update(timing);
+	}
+	timing.latency = 0.008;
+	for (int i = 0; i < 50; i++) {
+		controller.update(timing);
+	}
+	ASSERT(controller.batchLatencyP99() == 0.030);
+	ASSERT(controller.interval() == 0.001);
+
+	// Once they leave the window the interval grows again
+	for (int i = 0; i < 500; i++) {
+		controller.update(timing);
+	}
+	ASSERT(controller.interval() > 0.016);
+
+	// Nothing queued: larger batches would not help, so the interval decays to its minimum
+	timing.batchesInFlight = 1;
+	for (int i = 0; i < 500; i++) {
+		controller.update(timing);
+	}
+	ASSERT(controller.interval() < 0.0011);
+
+	// Too many batches in flight: the interval grows even though latency is over the target
+	timing.latency = 0.050;
+	timing.logging = 0.040;
+	timing.batchesInFlight = 20;
+	for (int i = 0; i < 100; i++) {
+		controller.update(timing);
+	}
+	ASSERT(controller.interval() == 0.020);
+	ASSERT(controller.limitingStage() == CommitBatchController::Stage::Logging);
+	ASSERT(std::string(CommitBatchController::stageName(controller.limitingStage())) == "Logging");
+
+	return Void();
+}
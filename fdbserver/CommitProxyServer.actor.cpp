@@ -210,8 +210,18 @@ struct ResolutionRequestBuilder {
 		for (auto& m : trIn.mutations) {
 			DEBUG_MUTATION("AddTr", ver, m, self->dbgid).detail("Idx", transactionNumberInBatch);
 			if (m.type == MutationRef::SetVersionstampedKey) {
+				const bool hasOffset = m.param1.size() >= 4;
 				transformVersionstampMutation(m, &MutationRef::param1, requests[0].version, transactionNumberInBatch);
-				trIn.write_conflict_ranges.push_back(requests[0].arena, singleKeyRange(m.param1, requests[0].arena));
+				if (hasOffset) {
+					// The offset that followed the key is no longer needed, so the key's single key range is made in
+					// place by writing the \x00 of keyAfter over it, rather than by copying the key.
+					mutateString(m.param1)[m.param1.size()] = 0;
+					trIn.write_conflict_ranges.push_back(
+					    requests[0].arena, KeyRangeRef(m.param1, KeyRef(m.param1.begin(), m.param1.size() + 1)));
+				} else {
+					trIn.write_conflict_ranges.push_back(requests[0].arena,
+					                                     singleKeyRange(m.param1, requests[0].arena));
+				}
 			} else if (m.type == MutationRef::SetVersionstampedValue) {
 				transformVersionstampMutation(m, &MutationRef::param2, requests[0].version, transactionNumberInBatch);
 			}
@@ -264,8 +274,7 @@ struct ResolutionRequestBuilder {
 
 bool checkTenantNoWait(ProxyCommitData* commitData, int64_t tenant, const char* context, bool logOnFailure) {
 	if (tenant != TenantInfo::INVALID_TENANT) {
-		auto itr = commitData->tenantMap.find(tenant);
-		if (itr == commitData->tenantMap.end()) {
+		if (!commitData->tenantIndex.contains(tenant)) {
 			if (logOnFailure) {
 				TraceEvent(SevWarn, "CommitProxyTenantNotFound", commitData->dbgid)
 				    .detail("Tenant", tenant)
@@ -669,6 +678,11 @@ struct CommitBatchContext {
 	double computeStart;
 	double computeDuration = 0;
 
+	// Seconds the batch spent in each downstream stage, for the batch interval controller
+	double resolutionDuration = 0;
+	double queuingDuration = 0;
+	double loggingDuration = 0;
+
 	Arena arena;
 
 	/// true if the batch is the 1st batch for this proxy, additional metadata
@@ -682,6 +696,9 @@ struct CommitBatchContext {
 
 	std::vector<uint8_t> committed;
 
+	// Transactions whose clients were answered as soon as the resolvers replied, because they can no longer commit
+	std::vector<bool> repliedAfterResolution;
+
 	Optional<Key> lockedKey;
 	bool locked;
 
@@ -785,13 +802,14 @@ void CommitBatchContext::checkHotShards() {
 std::set<Tag> CommitBatchContext::getWrittenTagsPreResolution() {
 	std::set<Tag> transactionTags;
 	std::vector<Tag> cacheVector = { cacheTag };
+	KeyRangeMapCursor<ServerCacheInfo> keyInfoCursor(pProxyCommitData->keyInfo);
 	for (int transactionNum = 0; transactionNum < trs.size(); transactionNum++) {
 		int mutationNum = 0;
 		VectorRef<MutationRef>* pMutations = &trs[transactionNum].transaction.mutations;
 		for (; mutationNum < pMutations->size(); mutationNum++) {
 			auto& m = (*pMutations)[mutationNum];
 			if (isSingleKeyMutation((MutationRef::Type)m.type)) {
-				auto& tags = pProxyCommitData->tagsForKey(m.param1);
+				auto& tags = pProxyCommitData->tagsForKey(m.param1, keyInfoCursor);
 				transactionTags.insert(tags.begin(), tags.end());
 				if (pProxyCommitData->cacheInfo[m.param1]) {
 					transactionTags.insert(cacheTag);
@@ -978,6 +996,17 @@ ACTOR Future<Void> preresolutionProcessing(CommitBatchContext* self) {
 	self->commitVersion = versionReply.version;
 	self->prevVersion = versionReply.prevVersion;
 
+	if (pProxyCommitData->batchRecorder) {
+		Arena arena;
+		RecordedCommitBatchRef batch;
+		batch.prevVersion = self->prevVersion;
+		batch.version = self->commitVersion;
+		for (const auto& tr : trs) {
+			batch.transactions.push_back(arena, tr.transaction);
+		}
+		pProxyCommitData->batchRecorder->record(batch);
+	}
+
 	//TraceEvent("CPGetVersion", pProxyCommitData->dbgid).detail("Master", pProxyCommitData->master.id().toString()).detail("CommitVersion", self->commitVersion).detail("PrvVersion", self->prevVersion);
 
 	for (auto it : versionReply.resolverChanges) {
@@ -1007,7 +1036,8 @@ EncryptCipherDomainId getEncryptDetailsFromMutationRef(ProxyCommitData* commitDa
 	if (isSystemKey(m.param1)) {
 		// Encryption domain == FDB SystemKeyspace encryption domain
 		domainId = SYSTEM_KEYSPACE_ENCRYPT_DOMAIN_ID;
-	} else if (commitData->tenantMap.empty() || commitData->encryptMode.mode == EncryptionAtRestMode::CLUSTER_AWARE) {
+	} else if (commitData->tenantIndex.empty() ||
+	           commitData->encryptMode.mode == EncryptionAtRestMode::CLUSTER_AWARE) {
 		// Cluster serves no-tenants; use 'default encryption domain'
 	} else if (isSingleKeyMutation((MutationRef::Type)m.type)) {
 		ASSERT_NE((MutationRef::Type)m.type, MutationRef::Type::ClearRange);
@@ -1016,7 +1046,7 @@ EncryptCipherDomainId getEncryptDetailsFromMutationRef(ProxyCommitData* commitDa
 			// Parse mutation key to determine mutation encryption domain
 			StringRef prefix = m.param1.substr(0, TenantAPI::PREFIX_SIZE);
 			int64_t tenantId = TenantAPI::prefixToId(prefix, EnforceValidTenantId::False);
-			if (commitData->tenantMap.count(tenantId)) {
+			if (commitData->tenantIndex.contains(tenantId)) {
 				domainId = tenantId;
 			} else {
 				// Leverage 'default encryption domain'
@@ -1046,6 +1076,78 @@ EncryptCipherDomainId getEncryptDetailsFromMutationRef(ProxyCommitData* commitDa
 
 } // namespace
 
+void recordCommitLatency(CommitBatchContext* self, const CommitTransactionRequest& tr, double endTime) {
+	ProxyCommitData* const pProxyCommitData = self->pProxyCommitData;
+	// TODO: filter if pipelined with large commit
+	const double duration = endTime - tr.requestTime();
+	pProxyCommitData->stats.commitLatencySample.addMeasurement(duration);
+	if (pProxyCommitData->latencyBandConfig.present()) {
+		bool filter = self->maxTransactionBytes >
+		              pProxyCommitData->latencyBandConfig.get().commitConfig.maxCommitBytes.orDefault(
+		                  std::numeric_limits<int>::max());
+		pProxyCommitData->stats.commitLatencyBands.addMeasurement(duration, 1, Filtered(filter));
+	}
+}
+
+// Tells the client of transaction t that it did not commit. nextTr holds the index of the transaction on each resolver.
+void replyNotCommitted(CommitBatchContext* self, int t, uint8_t verdict, const std::vector<int>& nextTr) {
+	auto& tr = self->trs[t];
+	if (verdict == ConflictBatch::TransactionTooOld) {
+		tr.reply.sendError(transaction_too_old());
+	} else if (tr.transaction.report_conflicting_keys) {
+		// If enable the option to report conflicting keys from resolvers, we send back all keyranges' indices
+		// through CommitID
+		Standalone<VectorRef<int>> conflictingKRIndices;
+		for (int resolverInd : self->transactionResolverMap[t]) {
+			auto const& cKRs =
+			    self->resolution[resolverInd]
+			        .conflictingKeyRangeMap[nextTr[resolverInd]]; // nextTr[resolverInd] -> index of
+			                                                      // this trs[t] on the resolver
+			for (auto const& rCRIndex : cKRs)
+				// read_conflict_range can change when sent to resolvers, mapping the index from
+				// resolver-side to original index in commitTransactionRef
+				conflictingKRIndices.push_back(conflictingKRIndices.arena(),
+				                               self->txReadConflictRangeIndexMap[t][resolverInd][rCRIndex]);
+		}
+		// At least one keyRange index should be returned
+		ASSERT(conflictingKRIndices.size());
+		tr.reply.send(CommitID(
+		    invalidVersion, t, Optional<Value>(), Optional<Standalone<VectorRef<int>>>(conflictingKRIndices)));
+	} else {
+		tr.reply.sendError(not_committed());
+	}
+}
+
+// A transaction that any resolver rejected cannot commit whatever happens to the rest of the batch, so its client need
+// not wait for the batch to be processed in order and logged before retrying.
+void replyToRejectedAfterResolution(CommitBatchContext* self) {
+	self->repliedAfterResolution.assign(self->trs.size(), false);
+	if (!SERVER_KNOBS->PROXY_REPLY_CONFLICTS_AFTER_RESOLUTION) {
+		return;
+	}
+
+	// TODO: should be timer_monotonic(), but gets compared to request time, which uses g_network->timer().
+	const double endTime = g_network->timer();
+	std::vector<int> nextTr(self->resolution.size(), 0);
+	int replied = 0;
+	for (int t = 0; t < self->trs.size(); t++) {
+		uint8_t verdict = ConflictBatch::TransactionCommitted;
+		for (int r : self->transactionResolverMap[t]) {
+			verdict = std::min(self->resolution[r].committed[nextTr[r]], verdict);
+		}
+		if (verdict != ConflictBatch::TransactionCommitted) {
+			replyNotCommitted(self, t, verdict, nextTr);
+			recordCommitLatency(self, self->trs[t], endTime);
+			self->repliedAfterResolution[t] = true;
+			++replied;
+		}
+		for (int r : self->transactionResolverMap[t]) {
+			nextTr[r]++;
+		}
+	}
+	CODE_PROBE(replied > 0, "Commit proxy replied to rejected transactions before logging");
+}
+
 ACTOR Future<Void> getResolution(CommitBatchContext* self) {
 	state double resolutionStart = g_network->timer_monotonic();
 	// Sending these requests is the fuzzy border between phase 1 and phase 2; it could conceivably overlap with
@@ -1127,11 +1229,14 @@ ACTOR Future<Void> getResolution(CommitBatchContext* self) {
 	std::vector<ResolveTransactionBatchReply> resolutionResp = wait(getAll(replies));
 	self->resolution.swap(*const_cast<std::vector<ResolveTransactionBatchReply>*>(&resolutionResp));
 
-	self->pProxyCommitData->stats.resolutionDist->sampleSeconds(g_network->timer_monotonic() - resolutionStart);
+	self->resolutionDuration = g_network->timer_monotonic() - resolutionStart;
+	self->pProxyCommitData->stats.resolutionDist->sampleSeconds(self->resolutionDuration);
+	self->pProxyCommitData->stats.resolutionLatency.addMeasurement(self->resolutionDuration);
 	if (self->debugID.present()) {
 		g_traceBatch.addEvent(
 		    "CommitDebug", self->debugID.get().first(), "CommitProxyServer.commitBatch.AfterResolution");
 	}
+	replyToRejectedAfterResolution(self);
 	if (pProxyCommitData->encryptMode.isEncryptionEnabled()) {
 		std::unordered_map<EncryptCipherDomainId, Reference<BlobCipherKey>> cipherKeys = wait(getCipherKeys);
 		self->cipherKeys = cipherKeys;
@@ -1150,10 +1255,10 @@ void assertResolutionStateMutationsSizeConsistent(const std::vector<ResolveTrans
 }
 
 // Return true if a single-key mutation is associated with a valid tenant id or a system key
-bool validTenantAccess(MutationRef m, std::map<int64_t, TenantName> const& tenantMap, Optional<int64_t>& tenantId) {
+bool validTenantAccess(MutationRef m, TenantPrefixIndex const& tenantIndex, Optional<int64_t>& tenantId) {
 	if (isSingleKeyMutation((MutationRef::Type)m.type)) {
 		tenantId = TenantAPI::extractTenantIdFromMutation(m);
-		bool isLegalTenant = tenantMap.count(tenantId.get()) > 0;
+		bool isLegalTenant = tenantIndex.contains(tenantId.get());
 		CODE_PROBE(!isLegalTenant, "Commit proxy access invalid tenant");
 		return isLegalTenant;
 	}
@@ -1480,7 +1585,7 @@ Error validateAndProcessTenantAccess(Arena& arena,
 				    .detail("NewClears", newClearSize);
 			}
 		} else if (!isSystemKey(mutation.param1)) {
-			validAccess = validTenantAccess(mutation, pProxyCommitData->tenantMap, tenantId);
+			validAccess = validTenantAccess(mutation, pProxyCommitData->tenantIndex, tenantId);
 			writeNormalKey = true;
 		}
 
@@ -1585,7 +1690,7 @@ void applyMetadataEffect(CommitBatchContext* self) {
 				// check if all tenant ids are valid if committed == true
 				committed = committed &&
 				            std::all_of(tenantIds.get().begin(), tenantIds.get().end(), [self](const int64_t& tid) {
-					            return self->pProxyCommitData->tenantMap.count(tid);
+					            return self->pProxyCommitData->tenantIndex.contains(tid);
 				            });
 
 				if (self->debugID.present()) {
@@ -1692,7 +1797,10 @@ ACTOR Future<Void> applyMetadataToCommittedTransactions(CommitBatchContext* self
 
 	int t;
 	for (t = 0; t < trs.size() && !self->forceRecovery; t++) {
-		Error e = validateAndProcessTenantAccess(trs[t], pProxyCommitData, rawAccessTenantIds);
+		// Clients already told their transaction was rejected must not get a second reply
+		Error e = self->repliedAfterResolution[t]
+		              ? success()
+		              : validateAndProcessTenantAccess(trs[t], pProxyCommitData, rawAccessTenantIds);
 		if (e.code() != error_code_success) {
 			trs[t].reply.sendError(e);
 			self->committed[t] = ConflictBatch::TransactionTenantFailure;
@@ -1981,6 +2089,123 @@ void addAccumulativeChecksumMutations(CommitBatchContext* self) {
 	}
 }
 
+// The encryption domain of a transaction's mutations, or INVALID_ENCRYPT_DOMAIN_ID if it has to be found per mutation
+int64_t transactionEncryptDomain(CommitBatchContext* self, const CommitTransactionRequest& tr) {
+	int64_t encryptDomain = tr.tenantInfo.tenantId;
+	if (self->pProxyCommitData->encryptMode.mode == EncryptionAtRestMode::CLUSTER_AWARE &&
+	    encryptDomain != SYSTEM_KEYSPACE_ENCRYPT_DOMAIN_ID) {
+		encryptDomain = FDB_DEFAULT_ENCRYPT_DOMAIN_ID;
+	}
+	return encryptDomain;
+}
+
+// Encrypts the mutations of the batch's committed transactions before assignMutationsToStorageServers() writes them,
+// spread by transaction across the proxy's mutation workers, and returns the time spent encrypting. When encryption is
+// on it is most of the work per mutation; the rest, finding tags, sampling costs and writing to toCommit in order,
+// works on state shared by the whole batch and stays on the network thread. The results go where a client's own
+// encrypted mutations would, so writeMutation() uses them as they are.
+double encryptMutationsAhead(CommitBatchContext* self) {
+	ProxyCommitData* const pProxyCommitData = self->pProxyCommitData;
+	std::vector<CommitTransactionRequest>& trs = self->trs;
+
+	std::vector<int> transactions;
+	int mutationCount = 0;
+	for (int t = 0; t < trs.size(); t++) {
+		if (self->committed[t] == ConflictBatch::TransactionCommitted && (!self->locked || trs[t].isLockAware()) &&
+		    trs[t].transaction.encryptedMutations.empty()) {
+			transactions.push_back(t);
+			mutationCount += trs[t].transaction.mutations.size();
+		}
+	}
+	if (mutationCount == 0 || mutationCount < SERVER_KNOBS->PROXY_PARALLEL_ENCRYPTION_MIN_MUTATIONS) {
+		return 0;
+	}
+
+	const int pieces = pProxyCommitData->mutationWorkers
+	                       ? std::min<int>(transactions.size(), SERVER_KNOBS->PROXY_MUTATION_ENCRYPTION_THREADS + 1)
+	                       : 1;
+	// Reference counts are not atomic, so when the pieces run on several threads each uses cipher keys of its own, and
+	// each allocates in an arena of its own
+	std::vector<std::unordered_map<EncryptCipherDomainId, Reference<BlobCipherKey>>> cipherKeys(pieces);
+	std::vector<Arena> arenas(pieces);
+	std::vector<double> encryptionTimes(pieces, 0);
+	if (pieces == 1) {
+		cipherKeys[0] = self->cipherKeys;
+	} else {
+		for (auto& keys : cipherKeys) {
+			for (const auto& [domainId, key] : self->cipherKeys) {
+				keys[domainId] = makeReference<BlobCipherKey>(key->getDomainId(),
+				                                              key->getBaseCipherId(),
+				                                              key->rawBaseCipher(),
+				                                              key->getBaseCipherLen(),
+				                                              key->getBaseCipherKCV(),
+				                                              key->getSalt(),
+				                                              key->getRefreshAtTS(),
+				                                              key->getExpireAtTS());
+			}
+		}
+	}
+	for (int t : transactions) {
+		trs[t].transaction.encryptedMutations.resize(self->arena, trs[t].transaction.mutations.size());
+	}
+
+	std::function<void(int)> encryptPiece = [&](int p) {
+		// One encryptor per domain for the whole piece, so that the key schedule and the header authentication
+		// context are set up once per domain rather than once per mutation
+		std::unordered_map<EncryptCipherDomainId, Reference<EncryptBlobCipherAes265Ctr>> encryptors;
+		auto getEncryptor = [&](EncryptCipherDomainId domainId) -> EncryptBlobCipherAes265Ctr& {
+			Reference<EncryptBlobCipherAes265Ctr>& encryptor = encryptors[domainId];
+			if (!encryptor.isValid()) {
+				ASSERT_NE(domainId, INVALID_ENCRYPT_DOMAIN_ID);
+				auto getCipherKey = [&](EncryptCipherDomainId id) {
+					auto iter = cipherKeys[p].find(id);
+					ASSERT(iter != cipherKeys[p].end() && iter->second.isValid());
+					return iter->second;
+				};
+				Reference<BlobCipherKey> headerCipherKey;
+				if (FLOW_KNOBS->ENCRYPT_HEADER_AUTH_TOKEN_ENABLED) {
+					headerCipherKey = getCipherKey(ENCRYPT_HEADER_DOMAIN_ID);
+				}
+				encryptor = makeReference<EncryptBlobCipherAes265Ctr>(
+				    getCipherKey(domainId),
+				    headerCipherKey,
+				    getEncryptAuthTokenMode(EncryptAuthTokenMode::ENCRYPT_HEADER_AUTH_TOKEN_MODE_SINGLE),
+				    BlobCipherMetrics::TLOG);
+			}
+			return *encryptor;
+		};
+		for (int i = p; i < transactions.size(); i += pieces) {
+			CommitTransactionRef& transaction = trs[transactions[i]].transaction;
+			const int64_t encryptDomain = transactionEncryptDomain(self, trs[transactions[i]]);
+			for (int m = 0; m < transaction.mutations.size(); m++) {
+				const MutationRef& mutation = transaction.mutations[m];
+				if (mutation.type == MutationRef::NoOp) {
+					continue;
+				}
+				const int64_t domainId = encryptDomain == INVALID_ENCRYPT_DOMAIN_ID
+				                             ? getEncryptDetailsFromMutationRef(pProxyCommitData, mutation)
+				                             : encryptDomain;
+				double encryptionTime = 0;
+				transaction.encryptedMutations[m] = mutation.encrypt(getEncryptor(domainId), arenas[p], &encryptionTime);
+				encryptionTimes[p] += encryptionTime;
+			}
+		}
+	};
+	if (pieces > 1) {
+		pProxyCommitData->mutationWorkers->run(pieces, encryptPiece);
+	} else {
+		encryptPiece(0);
+	}
+
+	double totalEncryptionTime = 0;
+	for (int p = 0; p < pieces; p++) {
+		self->arena.dependsOn(arenas[p]);
+		totalEncryptionTime += encryptionTimes[p];
+	}
+	CODE_PROBE(true, "Commit proxy encrypted mutations ahead of assigning tags");
+	return totalEncryptionTime;
+}
+
 /// This second pass through committed transactions assigns the actual mutations to the appropriate storage servers'
 /// tags
 ACTOR Future<Void> assignMutationsToStorageServers(CommitBatchContext* self) {
@@ -1988,6 +2213,19 @@ ACTOR Future<Void> assignMutationsToStorageServers(CommitBatchContext* self) {
 	state std::vector<CommitTransactionRequest>& trs = self->trs;
 	state double curEncryptionTime = 0;
 	state double totalEncryptionTime = 0;
+	// Mutations are often close to sorted by key. All of the batch's metadata mutations were applied to keyInfo in the
+	// first pass, so it does not change while the cursor is in use.
+	state KeyRangeMapCursor<ServerCacheInfo> keyInfoCursor(pProxyCommitData->keyInfo);
+
+	if (self->batchBytes >= SERVER_KNOBS->PROXY_RESERVE_LOG_MESSAGES_MIN_BYTES) {
+		// With an eighth to spare, so that a batch a little over the average still fits
+		int64_t expected = self->batchBytes * pProxyCommitData->logMessagesPerMutationByte * 9 / 8;
+		self->toCommit.reserve(std::min<int64_t>(expected, std::numeric_limits<int>::max() / 2));
+	}
+
+	if (pProxyCommitData->encryptMode.isEncryptionEnabled() && SERVER_KNOBS->PROXY_MUTATION_ENCRYPTION_THREADS > 0) {
+		totalEncryptionTime += encryptMutationsAhead(self);
+	}
 
 	for (; self->transactionNum < trs.size(); self->transactionNum++) {
 		if (!(self->committed[self->transactionNum] == ConflictBatch::TransactionCommitted &&
@@ -2006,11 +2244,7 @@ ACTOR Future<Void> assignMutationsToStorageServers(CommitBatchContext* self) {
 			ASSERT_EQ(encryptedMutations->size(), pMutations->size());
 		}
 
-		state int64_t encryptDomain = trs[self->transactionNum].tenantInfo.tenantId;
-		if (self->pProxyCommitData->encryptMode.mode == EncryptionAtRestMode::CLUSTER_AWARE &&
-		    encryptDomain != SYSTEM_KEYSPACE_ENCRYPT_DOMAIN_ID) {
-			encryptDomain = FDB_DEFAULT_ENCRYPT_DOMAIN_ID;
-		}
+		state int64_t encryptDomain = transactionEncryptDomain(self, trs[self->transactionNum]);
 
 		self->toCommit.addTransactionInfo(trs[self->transactionNum].spanContext);
 
@@ -2036,7 +2270,7 @@ ACTOR Future<Void> assignMutationsToStorageServers(CommitBatchContext* self) {
 			// Determine the set of tags (responsible storage servers) for the mutation, splitting it
 			// if necessary.  Serialize (splits of) the mutation into the message buffer and add the tags.
 			if (isSingleKeyMutation((MutationRef::Type)m.type)) {
-				auto& tags = pProxyCommitData->tagsForKey(m.param1);
+				auto& tags = pProxyCommitData->tagsForKey(m.param1, keyInfoCursor);
 
 				// sample single key mutation based on cost
 				// the expectation of sampling is every COMMIT_SAMPLE_COST sample once
@@ -2048,7 +2282,7 @@ ACTOR Future<Void> assignMutationsToStorageServers(CommitBatchContext* self) {
 					double prob = mul * cost / totalCosts;
 
 					if (deterministicRandom()->random01() < prob) {
-						const auto& storageServers = pProxyCommitData->keyInfo[m.param1].src_info;
+						const auto& storageServers = keyInfoCursor.rangeContaining(m.param1).value().src_info;
 						for (const auto& ssInfo : storageServers) {
 							auto id = ssInfo->interf.id();
 							// scale cost
@@ -2060,7 +2294,7 @@ ACTOR Future<Void> assignMutationsToStorageServers(CommitBatchContext* self) {
 				}
 
 				if (pProxyCommitData->singleKeyMutationEvent->enabled) {
-					KeyRangeRef shard = pProxyCommitData->keyInfo.rangeContaining(m.param1).range();
+					KeyRangeRef shard = keyInfoCursor.rangeContaining(m.param1).range();
 					pProxyCommitData->singleKeyMutationEvent->tag1 = (int64_t)tags[0].id;
 					pProxyCommitData->singleKeyMutationEvent->tag2 = (int64_t)tags[1].id;
 					pProxyCommitData->singleKeyMutationEvent->tag3 = (int64_t)tags[2].id;
@@ -2097,21 +2331,19 @@ ACTOR Future<Void> assignMutationsToStorageServers(CommitBatchContext* self) {
 				writtenMutation = std::get<MutationRef>(var);
 			} else if (m.type == MutationRef::ClearRange) {
 				KeyRangeRef clearRange(KeyRangeRef(m.param1, m.param2));
-				auto ranges = pProxyCommitData->keyInfo.intersectingRanges(clearRange);
-				auto firstRange = ranges.begin();
-				++firstRange;
-				if (firstRange == ranges.end()) {
+				auto firstRange = keyInfoCursor.rangeContaining(clearRange.begin);
+				if (firstRange.end() >= clearRange.end) {
 					// Fast path
 					DEBUG_MUTATION("ProxyCommit", self->commitVersion, m, pProxyCommitData->dbgid)
-					    .detail("To", ranges.begin().value().tags);
-					ranges.begin().value().populateTags();
-					self->toCommit.addTags(ranges.begin().value().tags);
+					    .detail("To", firstRange.value().tags);
+					firstRange.value().populateTags();
+					self->toCommit.addTags(firstRange.value().tags);
 
 					if (pProxyCommitData->acsBuilder != nullptr) {
 						updateMutationWithAcsAndAddMutationToAcsBuilder(
 						    pProxyCommitData->acsBuilder,
 						    m,
-						    ranges.begin().value().tags,
+						    firstRange.value().tags,
 						    getCommitProxyAccumulativeChecksumIndex(pProxyCommitData->commitProxyIndex),
 						    pProxyCommitData->epoch,
 						    self->commitVersion,
@@ -2121,7 +2353,7 @@ ACTOR Future<Void> assignMutationsToStorageServers(CommitBatchContext* self) {
 					// check whether clear is sampled
 					if (checkSample && !trCost->get().clearIdxCosts.empty() &&
 					    trCost->get().clearIdxCosts[0].first == mutationNum) {
-						auto const& ssInfos = ranges.begin().value().src_info;
+						auto const& ssInfos = firstRange.value().src_info;
 						for (auto const& ssInfo : ssInfos) {
 							auto id = ssInfo->interf.id();
 							pProxyCommitData->updateSSTagCost(id,
@@ -2134,7 +2366,7 @@ ACTOR Future<Void> assignMutationsToStorageServers(CommitBatchContext* self) {
 				} else {
 					CODE_PROBE(true, "A clear range extends past a shard boundary");
 					std::set<Tag> allSources;
-					for (auto r : ranges) {
+					for (auto r : pProxyCommitData->keyInfo.intersectingRanges(clearRange)) {
 						r.value().populateTags();
 						allSources.insert(r.value().tags.begin(), r.value().tags.end());
 
@@ -2230,7 +2462,9 @@ ACTOR Future<Void> postResolution(CommitBatchContext* self) {
 	CODE_PROBE(queuedCommits, "Queuing post-resolution commit processing");
 	wait(pProxyCommitData->latestLocalCommitBatchLogging.whenAtLeast(localBatchNumber - 1));
 	state double postResolutionQueuing = g_network->timer_monotonic();
-	pProxyCommitData->stats.postResolutionDist->sampleSeconds(postResolutionQueuing - postResolutionStart);
+	self->queuingDuration = postResolutionQueuing - postResolutionStart;
+	pProxyCommitData->stats.postResolutionDist->sampleSeconds(self->queuingDuration);
+	pProxyCommitData->stats.postResolutionQueuingLatency.addMeasurement(self->queuingDuration);
 	wait(yield(TaskPriority::ProxyCommitYield1));
 
 	self->computeStart = g_network->timer_monotonic();
@@ -2290,6 +2524,7 @@ ACTOR Future<Void> postResolution(CommitBatchContext* self) {
 		                        &self->computeStart));
 	}
 
+	self->idempotencyKVBuilder.setCompactEncoding(SERVER_KNOBS->IDEMPOTENCY_ID_COMPACT_ENCODING);
 	buildIdempotencyIdMutations(
 	    self->trs,
 	    self->idempotencyKVBuilder,
@@ -2449,6 +2684,12 @@ ACTOR Future<Void> postResolution(CommitBatchContext* self) {
 	float ratio = self->toCommit.getEmptyMessageRatio();
 	pProxyCommitData->stats.commitBatchingEmptyMessageRatio.addMeasurement(ratio);
 
+	if (self->batchBytes > 0 && self->batchBytes >= SERVER_KNOBS->PROXY_RESERVE_LOG_MESSAGES_MIN_BYTES) {
+		double& perByte = pProxyCommitData->logMessagesPerMutationByte;
+		double sample = (double)self->toCommit.getLargestMessagesSize() / self->batchBytes;
+		perByte = perByte == 0 ? sample : perByte + 0.1 * (sample - perByte);
+	}
+
 	if (!self->forceRecovery) {
 		ASSERT(pProxyCommitData->latestLocalCommitBatchLogging.get() == self->localBatchNumber - 1);
 		pProxyCommitData->latestLocalCommitBatchLogging.set(self->localBatchNumber);
@@ -2529,7 +2770,9 @@ ACTOR Future<Void> transactionLogging(CommitBatchContext* self) {
 		pProxyCommitData->txsPopVersions.emplace_back(self->commitVersion, self->msg.popTo);
 	}
 	pProxyCommitData->logSystem->popTxs(self->msg.popTo);
-	pProxyCommitData->stats.tlogLoggingDist->sampleSeconds(g_network->timer_monotonic() - tLoggingStart);
+	self->loggingDuration = g_network->timer_monotonic() - tLoggingStart;
+	pProxyCommitData->stats.tlogLoggingDist->sampleSeconds(self->loggingDuration);
+	pProxyCommitData->stats.loggingLatency.addMeasurement(self->loggingDuration);
 	return Void();
 }
 
@@ -2606,60 +2849,33 @@ ACTOR Future<Void> reply(CommitBatchContext* self) {
 	std::unordered_map<uint8_t, int16_t> idCountsForKey;
 	for (int t = 0; t < self->trs.size(); t++) {
 		auto& tr = self->trs[t];
-		if (self->committed[t] == ConflictBatch::TransactionCommitted && (!self->locked || tr.isLockAware())) {
+		if (self->repliedAfterResolution[t]) {
+			// Answered, and its latency recorded, as soon as the resolvers replied
+		} else if (self->committed[t] == ConflictBatch::TransactionCommitted && (!self->locked || tr.isLockAware())) {
 			ASSERT_WE_THINK(self->commitVersion != invalidVersion);
 			if (self->trs[t].idempotencyId.valid()) {
 				idCountsForKey[uint8_t(t >> 8)] += 1;
 			}
 			tr.reply.send(CommitID(self->commitVersion, t, self->metadataVersionAfter));
-		} else if (self->committed[t] == ConflictBatch::TransactionTooOld) {
-			tr.reply.sendError(transaction_too_old());
 		} else if (self->committed[t] == ConflictBatch::TransactionTenantFailure) {
 			// We already sent the error
 			ASSERT(tr.reply.isSet());
 		} else {
-			// If enable the option to report conflicting keys from resolvers, we send back all keyranges' indices
-			// through CommitID
-			if (tr.transaction.report_conflicting_keys) {
-				Standalone<VectorRef<int>> conflictingKRIndices;
-				for (int resolverInd : self->transactionResolverMap[t]) {
-					auto const& cKRs =
-					    self->resolution[resolverInd]
-					        .conflictingKeyRangeMap[self->nextTr[resolverInd]]; // nextTr[resolverInd] -> index of
-					                                                            // this trs[t] on the resolver
-					for (auto const& rCRIndex : cKRs)
-						// read_conflict_range can change when sent to resolvers, mapping the index from
-						// resolver-side to original index in commitTransactionRef
-						conflictingKRIndices.push_back(conflictingKRIndices.arena(),
-						                               self->txReadConflictRangeIndexMap[t][resolverInd][rCRIndex]);
-				}
-				// At least one keyRange index should be returned
-				ASSERT(conflictingKRIndices.size());
-				tr.reply.send(CommitID(
-				    invalidVersion, t, Optional<Value>(), Optional<Standalone<VectorRef<int>>>(conflictingKRIndices)));
-			} else {
-				tr.reply.sendError(not_committed());
-			}
+			replyNotCommitted(self, t, self->committed[t], self->nextTr);
+		}
+		if (!self->repliedAfterResolution[t]) {
+			recordCommitLatency(self, tr, endTime);
 		}
 
 		// Update corresponding transaction indices on each resolver
 		for (int resolverInd : self->transactionResolverMap[t])
 			self->nextTr[resolverInd]++;
-
-		// TODO: filter if pipelined with large commit
-		const double duration = endTime - tr.requestTime();
-		pProxyCommitData->stats.commitLatencySample.addMeasurement(duration);
-		if (pProxyCommitData->latencyBandConfig.present()) {
-			bool filter = self->maxTransactionBytes >
-			              pProxyCommitData->latencyBandConfig.get().commitConfig.maxCommitBytes.orDefault(
-			                  std::numeric_limits<int>::max());
-			pProxyCommitData->stats.commitLatencyBands.addMeasurement(duration, 1, Filtered(filter));
-		}
 	}
 
+	const int16_t keyCount = idCountsForKey.size();
 	for (auto [highOrderBatchIndex, count] : idCountsForKey) {
 		pProxyCommitData->expectedIdempotencyIdCountForKey.send(
-		    ExpectedIdempotencyIdCountForKey{ self->commitVersion, count, highOrderBatchIndex });
+		    ExpectedIdempotencyIdCountForKey{ self->commitVersion, count, highOrderBatchIndex, keyCount });
 	}
 
 	if (self->pProxyCommitData->encryptMode.isEncryptionEnabled() && self->encryptionTime.present()) {
@@ -2700,14 +2916,32 @@ ACTOR Future<Void> reply(CommitBatchContext* self) {
 	}
 
 	// Dynamic batching for commits
-	double target_latency =
-	    (now() - self->startTime) * SERVER_KNOBS->COMMIT_TRANSACTION_BATCH_INTERVAL_LATENCY_FRACTION;
-	pProxyCommitData->commitBatchInterval =
-	    std::max(SERVER_KNOBS->COMMIT_TRANSACTION_BATCH_INTERVAL_MIN,
-	             std::min(SERVER_KNOBS->COMMIT_TRANSACTION_BATCH_INTERVAL_MAX,
-	                      target_latency * SERVER_KNOBS->COMMIT_TRANSACTION_BATCH_INTERVAL_SMOOTHER_ALPHA +
-	                          pProxyCommitData->commitBatchInterval *
-	                              (1 - SERVER_KNOBS->COMMIT_TRANSACTION_BATCH_INTERVAL_SMOOTHER_ALPHA)));
+	if (SERVER_KNOBS->COMMIT_BATCH_INTERVAL_CONTROLLER) {
+		CommitBatchController::BatchTiming timing;
+		timing.latency = now() - self->startTime;
+		timing.resolution = self->resolutionDuration;
+		timing.queuing = self->queuingDuration;
+		timing.logging = self->loggingDuration;
+		timing.batchesInFlight =
+		    pProxyCommitData->localCommitBatchesStarted - pProxyCommitData->latestLocalCommitBatchLogging.get();
+		CommitBatchController& controller = pProxyCommitData->batchController;
+		pProxyCommitData->commitBatchInterval = controller.update(timing);
+		TraceEvent("CommitBatchController", pProxyCommitData->dbgid)
+		    .suppressFor(5.0)
+		    .detail("Interval", controller.interval())
+		    .detail("BatchLatencyP99", controller.batchLatencyP99())
+		    .detail("BatchesInFlight", timing.batchesInFlight)
+		    .detail("LimitingStage", CommitBatchController::stageName(controller.limitingStage()));
+	} else {
+		double target_latency =
+		    (now() - self->startTime) * SERVER_KNOBS->COMMIT_TRANSACTION_BATCH_INTERVAL_LATENCY_FRACTION;
+		pProxyCommitData->commitBatchInterval =
+		    std::max(SERVER_KNOBS->COMMIT_TRANSACTION_BATCH_INTERVAL_MIN,
+		             std::min(SERVER_KNOBS->COMMIT_TRANSACTION_BATCH_INTERVAL_MAX,
+		                      target_latency * SERVER_KNOBS->COMMIT_TRANSACTION_BATCH_INTERVAL_SMOOTHER_ALPHA +
+		                          pProxyCommitData->commitBatchInterval *
+		                              (1 - SERVER_KNOBS->COMMIT_TRANSACTION_BATCH_INTERVAL_SMOOTHER_ALPHA)));
+	}
 
 	pProxyCommitData->stats.commitBatchingWindowSize.addMeasurement(pProxyCommitData->commitBatchInterval);
 	pProxyCommitData->commitBatchesMemBytesCount -= self->currentBatchMemBytesCount;
@@ -3483,63 +3717,55 @@ ACTOR Future<Void> monitorTenantsOverStorageQuota(UID myID,
 }
 
 namespace {
+// The idempotency keys written at a commit version, which are cleared together once every id in them has expired
 struct ExpireServerEntry {
+	struct KeyCounts {
+		int expectedCount = 0;
+		int receivedCount = 0;
+	};
+
 	int64_t timeReceived;
-	int expectedCount = 0;
-	int receivedCount = 0;
+	std::map<uint8_t, KeyCounts> keys; // by the high order byte of their batch index
+	int keyCount = 0; // 0 until the counts of the keys are known
+	int expiredKeyCount = 0;
 	bool initialized = false;
 };
-
-struct IdempotencyKey {
-	Version version;
-	uint8_t highOrderBatchIndex;
-	bool operator==(const IdempotencyKey& other) const {
-		return version == other.version && highOrderBatchIndex == other.highOrderBatchIndex;
-	}
-};
-
 } // namespace
 
-namespace std {
-template <>
-struct hash<IdempotencyKey> {
-	std::size_t operator()(const IdempotencyKey& key) const {
-		std::size_t seed = 0;
-		boost::hash_combine(seed, std::hash<Version>{}(key.version));
-		boost::hash_combine(seed, std::hash<uint8_t>{}(key.highOrderBatchIndex));
-		return seed;
-	}
-};
-
-} // namespace std
-
+// Clears the idempotency keys of a commit version with one clear of the version's range once all of their ids have
+// expired. Keys of a commit version whose ids have not all expired after IDEMPOTENCY_ID_IN_MEMORY_LIFETIME are cleared
+// individually if they have expired, and otherwise left to the idempotency id cleaner.
 ACTOR static Future<Void> idempotencyIdsExpireServer(
     Database db,
     PublicRequestStream<ExpireIdempotencyIdRequest> expireIdempotencyId,
     PromiseStream<ExpectedIdempotencyIdCountForKey> expectedIdempotencyIdCountForKey,
     Standalone<VectorRef<MutationRef>>* idempotencyClears) {
-	state std::unordered_map<IdempotencyKey, ExpireServerEntry> idStatus;
-	state std::unordered_map<IdempotencyKey, ExpireServerEntry>::iterator iter;
+	state std::unordered_map<Version, ExpireServerEntry> idStatus;
+	state std::unordered_map<Version, ExpireServerEntry>::iterator iter;
 	state int64_t purgeBefore;
-	state IdempotencyKey key;
+	state Version version;
 	state ExpireServerEntry* status = nullptr;
+	state ExpireServerEntry::KeyCounts* counts = nullptr;
 	state Future<Void> purgeOld = Void();
 	loop {
 		choose {
 			when(ExpireIdempotencyIdRequest req = waitNext(expireIdempotencyId.getFuture())) {
-				key = IdempotencyKey{ req.commitVersion, req.batchIndexHighByte };
-				status = &idStatus[key];
-				status->receivedCount += 1;
-				CODE_PROBE(status->expectedCount == 0, "ExpireIdempotencyIdRequest received before count is known");
-				if (status->expectedCount > 0) {
-					ASSERT_LE(status->receivedCount, status->expectedCount);
+				version = req.commitVersion;
+				status = &idStatus[version];
+				counts = &status->keys[req.batchIndexHighByte];
+				counts->receivedCount += 1;
+				CODE_PROBE(counts->expectedCount == 0, "ExpireIdempotencyIdRequest received before count is known");
+				if (counts->expectedCount > 0) {
+					ASSERT_LE(counts->receivedCount, counts->expectedCount);
 				}
 			}
 			when(ExpectedIdempotencyIdCountForKey req = waitNext(expectedIdempotencyIdCountForKey.getFuture())) {
-				key = IdempotencyKey{ req.commitVersion, req.batchIndexHighByte };
-				status = &idStatus[key];
-				ASSERT_EQ(status->expectedCount, 0);
-				status->expectedCount = req.idempotencyIdCount;
+				version = req.commitVersion;
+				status = &idStatus[version];
+				counts = &status->keys[req.batchIndexHighByte];
+				ASSERT_EQ(counts->expectedCount, 0);
+				counts->expectedCount = req.idempotencyIdCount;
+				status->keyCount = req.keyCount;
 			}
 			when(wait(purgeOld)) {
 				purgeOld = delay(SERVER_KNOBS->IDEMPOTENCY_ID_IN_MEMORY_LIFETIME);
@@ -3549,6 +3775,15 @@ ACTOR static Future<Void> idempotencyIdsExpireServer(
 					// wait
 					wait(yield());
 					if (iter->second.timeReceived < purgeBefore) {
+						for (auto const& [highOrderBatchIndex, keyCounts] : iter->second.keys) {
+							if (keyCounts.expectedCount > 0 && keyCounts.receivedCount == keyCounts.expectedCount) {
+								auto keyRange = makeIdempotencySingleKeyRange(
+								    idempotencyClears->arena(), iter->first, highOrderBatchIndex);
+								idempotencyClears->push_back(
+								    idempotencyClears->arena(),
+								    MutationRef(MutationRef::ClearRange, keyRange.begin, keyRange.end));
+							}
+						}
 						iter = idStatus.erase(iter);
 					} else {
 						++iter;
@@ -3558,12 +3793,14 @@ ACTOR static Future<Void> idempotencyIdsExpireServer(
 			}
 		}
 		if (status->initialized) {
-			if (status->receivedCount == status->expectedCount) {
-				auto keyRange =
-				    makeIdempotencySingleKeyRange(idempotencyClears->arena(), key.version, key.highOrderBatchIndex);
+			if (counts->receivedCount == counts->expectedCount) {
+				status->expiredKeyCount += 1;
+			}
+			if (status->keyCount > 0 && status->expiredKeyCount == status->keyCount) {
+				auto keyRange = makeIdempotencyVersionRange(idempotencyClears->arena(), version);
 				idempotencyClears->push_back(idempotencyClears->arena(),
 				                             MutationRef(MutationRef::ClearRange, keyRange.begin, keyRange.end));
-				idStatus.erase(key);
+				idStatus.erase(version);
 			}
 		} else {
 			status->timeReceived = now();
@@ -3728,6 +3965,11 @@ ACTOR Future<Void> processTransactionStateRequestPart(TransactionStateResolveCon
 	}
 	pContext->receivedSequences.insert(request.sequence);
 
+	// Pass the part down the broadcast tree before applying it, so that every level applies it at once rather than each
+	// waiting for the one above. Whoever sent it is still only acknowledged once the whole subtree has it.
+	state ReplyPromise<Void> reply = request.reply;
+	state Future<Void> forwarded = broadcastTxnRequest(request, SERVER_KNOBS->TXN_STATE_SEND_AMOUNT, false);
+
 	// Although we may receive the CommitTransactionRequest for the recovery transaction before all of the
 	// TxnStateRequest, we will not get a resolution result from any resolver until the master has submitted its initial
 	// (sequence 0) resolution request, which it doesn't do until we have acknowledged all TxnStateRequests
@@ -3746,7 +3988,8 @@ ACTOR Future<Void> processTransactionStateRequestPart(TransactionStateResolveCon
 		pContext->processed = true;
 	}
 
-	pContext->pActors->send(broadcastTxnRequest(request, SERVER_KNOBS->TXN_STATE_SEND_AMOUNT, true));
+	wait(forwarded);
+	reply.send(Void());
 	wait(yield());
 	return Void();
 }
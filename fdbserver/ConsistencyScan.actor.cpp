@@ -64,6 +64,8 @@ struct ConsistencyScanStats {
 
 	bool waitingBetweenRounds = false;
 	int targetRate = 0;
+	// The fraction of the configured rate that the scan reads at, lowered while its reads are slow
+	double rateFraction = 1.0;
 
 	explicit ConsistencyScanStats(UID id, double interval)
 	  : cc("ConsistencyScanStats", id.toString()), logicalBytesScanned("LogicalBytesScanned", cc),
@@ -72,6 +74,7 @@ struct ConsistencyScanStats {
 	    databasePollSuccesses("DatabasePollSuccesses", cc), databasePollErrors("DatabasePollErrors", cc) {
 		specialCounter(cc, "WaitingBetweenRounds", [this]() { return this->waitingBetweenRounds; });
 		specialCounter(cc, "TargetRate", [this]() { return this->targetRate; });
+		specialCounter(cc, "RateFraction", [this]() { return this->rateFraction; });
 		logger = cc.traceCounters("ConsistencyScanMetrics", id, interval, "ConsistencyScanMetrics");
 	}
 };
@@ -177,6 +180,43 @@ ACTOR Future<std::vector<StorageServerInterface>> loadShardInterfaces(Reference<
 }
 
 // returns error count
+// Halves the fraction of the configured rate that the scan reads at while its reads, which wait behind foreground reads
+// on the storage servers, take longer than CONSISTENCY_SCAN_TARGET_READ_LATENCY, and recovers it gradually once they
+// are fast again
+static void updateRateFraction(ConsistencyScanStats& stats, double readLatency) {
+	if (readLatency > SERVER_KNOBS->CONSISTENCY_SCAN_TARGET_READ_LATENCY) {
+		stats.rateFraction = std::max(SERVER_KNOBS->CONSISTENCY_SCAN_MIN_RATE_FRACTION, stats.rateFraction / 2);
+	} else {
+		stats.rateFraction = std::min(1.0, stats.rateFraction + 0.1);
+	}
+}
+
+// Whether every replica replied with the same digest, and so read the same rows
+static bool digestsAgree(std::vector<Future<ErrorOr<GetKeyValuesReply>>> const& replies) {
+	Optional<GetKeyValuesReply> first;
+	for (auto const& f : replies) {
+		ErrorOr<GetKeyValuesReply> const& reply = f.get();
+		if (!reply.present() || reply.get().error.present() || !reply.get().digest.present()) {
+			// Storage servers that do not compute digests reply with the rows
+			return false;
+		}
+		if (!first.present()) {
+			first = reply.get();
+		} else if (reply.get().digest != first.get().digest || reply.get().more != first.get().more ||
+		           reply.get().data != first.get().data) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// The bytes of rows a reply covers, whether it holds them or only their digest
+static int64_t scannedBytes(GetKeyValuesReply const& reply) {
+	return reply.digest.present() ? reply.digestedBytes : reply.data.expectedSize();
+}
+
+// Compares the rows of range from each of the storage servers. With compareDigests, each replica first sends only a
+// digest of its rows, and the rows themselves are read only if the digests differ.
 ACTOR Future<int> consistencyCheckReadData(UID myId,
                                            Database cx,
                                            KeyRange range,
@@ -185,7 +225,9 @@ ACTOR Future<int> consistencyCheckReadData(UID myId,
                                            std::vector<Future<ErrorOr<GetKeyValuesReply>>>* keyValueFutures,
                                            Optional<int>* firstValidServer,
                                            int64_t* totalReadAmount,
-                                           Optional<Version> consistencyCheckStartVersion) {
+                                           Optional<Version> consistencyCheckStartVersion,
+                                           bool compareDigests,
+                                           double* readLatency) {
 	ASSERT(!range.empty());
 	state GetKeyValuesRequest req;
 	req.begin = firstGreaterOrEqual(range.begin);
@@ -220,9 +262,47 @@ ACTOR Future<int> consistencyCheckReadData(UID myId,
 	    .detail("Version", version)
 	    .detail("Servers", storageServerInterfaces->size());
 
-	// Try getting the entries in the specified range
-
+	state bool expectInjected =
+	    storageServerInterfaces->size() > 1 && g_network->isSimulated() && consistencyCheckStartVersion.present() &&
+	    g_simulator->consistencyScanState == ISimulator::SimConsistencyScanState::Enabled_InjectCorruption &&
+	    g_simulator->consistencyScanCorruptRequestKey.present() && g_simulator->consistencyScanCorruptor.present() &&
+	    g_simulator->consistencyScanCorruptor.get().first == myId &&
+	    range.contains(g_simulator->consistencyScanCorruptRequestKey.get());
+	state double readStart = now();
 	state int j = 0;
+
+	// A simulated corruption is injected into only the first reply to reach it, so it must be found in the rows
+	bool injectingCorruption =
+	    g_network->isSimulated() &&
+	    g_simulator->consistencyScanState == ISimulator::SimConsistencyScanState::Enabled_InjectCorruption;
+	if (compareDigests && storageServerInterfaces->size() > 1 && !injectingCorruption) {
+		state std::vector<Future<ErrorOr<GetKeyValuesReply>>> digestFutures;
+		req.digestOnly = true;
+		for (j = 0; j < storageServerInterfaces->size(); j++) {
+			resetReply(req);
+			if (SERVER_KNOBS->ENABLE_VERSION_VECTOR) {
+				cx->getLatestCommitVersion((*storageServerInterfaces)[j], req.version, req.ssLatestCommitVersions);
+			}
+			digestFutures.push_back((*storageServerInterfaces)[j].getKeyValues.getReplyUnlessFailedFor(req, 2, 0));
+		}
+		wait(waitForAll(digestFutures));
+		if (readLatency != nullptr) {
+			*readLatency = now() - readStart;
+		}
+
+		if (digestsAgree(digestFutures)) {
+			for (auto const& f : digestFutures) {
+				*totalReadAmount += f.get().get().digestedBytes;
+			}
+			*keyValueFutures = digestFutures;
+			*firstValidServer = 0;
+			return 0;
+		}
+		CODE_PROBE(true, "consistency scan digests differ or are unavailable, comparing rows");
+		req.digestOnly = false;
+	}
+
+	// Try getting the entries in the specified range
 	for (j = 0; j < storageServerInterfaces->size(); j++) {
 		resetReply(req);
 		if (SERVER_KNOBS->ENABLE_VERSION_VECTOR) {
@@ -232,13 +312,10 @@ ACTOR Future<int> consistencyCheckReadData(UID myId,
 	}
 
 	wait(waitForAll(*keyValueFutures));
+	if (readLatency != nullptr) {
+		*readLatency = now() - readStart;
+	}
 
-	bool expectInjected =
-	    storageServerInterfaces->size() > 1 && g_network->isSimulated() && consistencyCheckStartVersion.present() &&
-	    g_simulator->consistencyScanState == ISimulator::SimConsistencyScanState::Enabled_InjectCorruption &&
-	    g_simulator->consistencyScanCorruptRequestKey.present() && g_simulator->consistencyScanCorruptor.present() &&
-	    g_simulator->consistencyScanCorruptor.get().first == myId &&
-	    range.contains(g_simulator->consistencyScanCorruptRequestKey.get());
 	if (expectInjected) {
 		TraceEvent(SevWarnAlways, "ConsistencyScanExpectingInjectedCorruption", myId)
 		    .detail("StorageServers", storageServerInterfaces->size())
@@ -661,6 +738,7 @@ ACTOR Future<Void> consistencyScanCore(Database db,
 			}
 
 			configuredRate = std::max<int>(100e3, configuredRate);
+			configuredRate = std::max<int>(1, configuredRate * memState->stats.rateFraction);
 
 			// FIXME: speed up scan if speedUpSimulation set?
 
@@ -847,15 +925,20 @@ ACTOR Future<Void> consistencyScanCore(Database db,
 							state Optional<int> firstValidServer;
 							memState->stats.requests += storageServerInterfaces.size();
 							state int64_t replicatedBytesReadThisLoop = 0;
-							int newErrors = wait(consistencyCheckReadData(memState->csId,
-							                                              db,
-							                                              targetRange,
-							                                              tr->getReadVersion().get(),
-							                                              &storageServerInterfaces,
-							                                              &keyValueFutures,
-							                                              &firstValidServer,
-							                                              &replicatedBytesReadThisLoop,
-							                                              statsCurrentRound.startVersion));
+							state double readLatency = 0;
+							int newErrors =
+							    wait(consistencyCheckReadData(memState->csId,
+							                                  db,
+							                                  targetRange,
+							                                  tr->getReadVersion().get(),
+							                                  &storageServerInterfaces,
+							                                  &keyValueFutures,
+							                                  &firstValidServer,
+							                                  &replicatedBytesReadThisLoop,
+							                                  statsCurrentRound.startVersion,
+							                                  SERVER_KNOBS->CONSISTENCY_SCAN_COMPARE_DIGESTS,
+							                                  &readLatency));
+							updateRateFraction(memState->stats, readLatency);
 							errors += newErrors;
 							memState->stats.inconsistencies += newErrors;
 
@@ -876,7 +959,7 @@ ACTOR Future<Void> consistencyScanCore(Database db,
 							if (!failedRequest.present() && !newErrors) {
 								ASSERT(firstValidServer.present());
 								GetKeyValuesReply rangeResult = keyValueFutures[firstValidServer.get()].get().get();
-								logicalBytesRead += rangeResult.data.expectedSize();
+								logicalBytesRead += scannedBytes(rangeResult);
 								replicatedBytesRead += replicatedBytesReadThisLoop;
 								if (!rangeResult.more) {
 									statsCurrentRound.lastEndKey = targetRange.end;
@@ -1776,7 +1859,9 @@ ACTOR Future<Void> checkDataConsistency(Database cx,
 					                                             &keyValueFutures,
 					                                             &firstValidServer,
 					                                             &totalReadAmount,
-					                                             {}));
+					                                             {},
+					                                             false,
+					                                             nullptr));
 					if (failures > 0) {
 						testFailure("Data inconsistent", performQuiescentChecks, success, true);
 					}
@@ -120,56 +120,98 @@ ServerCoordinators::ServerCoordinators(Reference<IClusterConnectionRecord> ccr,
 	}
 }
 
+// The value of key in the generation register, as changed by the requests of the current batch
+ACTOR static Future<GenerationRegVal> readGenerationRegVal(OnDemandStore* store,
+                                                          std::map<Key, GenerationRegVal>* batchValues,
+                                                          Key key) {
+	auto it = batchValues->find(key);
+	if (it != batchValues->end()) {
+		return it->second;
+	}
+	Optional<Value> rawV = wait((*store)->readValue(key));
+	return rawV.present() ? BinaryReader::fromStringRef<GenerationRegVal>(rawV.get(), IncludeVersion())
+	                      : GenerationRegVal();
+}
+
 ACTOR Future<Void> localGenerationReg(GenerationRegInterface interf, OnDemandStore* pstore) {
-	state GenerationRegVal v;
 	state OnDemandStore& store = *pstore;
-	// SOMEDAY: concurrent access to different keys?
-	loop choose {
-		when(GenerationRegReadRequest _req = waitNext(interf.read.getFuture())) {
+	// Requests that arrive while a batch is being made durable are handled together in the next batch, which is made
+	// durable by a single commit, so a burst of requests during a recovery costs one disk sync rather than one each.
+	// Replies are only sent once the batch is durable, as they may depend on changes made by earlier requests in it.
+	loop {
+		state std::vector<GenerationRegReadRequest> reads;
+		state std::vector<GenerationRegWriteRequest> writes;
+		choose {
+			when(GenerationRegReadRequest req = waitNext(interf.read.getFuture())) {
+				reads.push_back(req);
+			}
+			when(GenerationRegWriteRequest req = waitNext(interf.write.getFuture())) {
+				writes.push_back(req);
+			}
+		}
+		while (reads.size() + writes.size() < SERVER_KNOBS->COORDINATOR_REGISTER_BATCH_SIZE &&
+		       (interf.read.getFuture().isReady() || interf.write.getFuture().isReady())) {
+			if (interf.read.getFuture().isReady()) {
+				reads.push_back(interf.read.getFuture().pop());
+			} else {
+				writes.push_back(interf.write.getFuture().pop());
+			}
+		}
+
+		state std::map<Key, GenerationRegVal> batchValues;
+		state std::vector<GenerationRegReadReply> readReplies;
+		state std::vector<UniqueGeneration> writeReplies;
+		state GenerationRegVal v;
+		state int i = 0;
+		for (i = 0; i < reads.size(); ++i) {
 			TraceEvent("GenerationRegReadRequest")
-			    .detail("From", _req.reply.getEndpoint().getPrimaryAddress())
-			    .detail("K", _req.key);
-			state GenerationRegReadRequest req = _req;
-			Optional<Value> rawV = wait(store->readValue(req.key));
-			v = rawV.present() ? BinaryReader::fromStringRef<GenerationRegVal>(rawV.get(), IncludeVersion())
-			                   : GenerationRegVal();
-			TraceEvent("GenerationRegReadReply")
-			    .detail("RVSize", rawV.present() ? rawV.get().size() : -1)
-			    .detail("VWG", v.writeGen.generation);
-			if (v.readGen < req.gen) {
-				v.readGen = req.gen;
-				store->set(KeyValueRef(
-				    req.key, BinaryWriter::toValue(v, IncludeVersion(ProtocolVersion::withGenerationRegVal()))));
-				wait(store->commit());
-			}
-			req.reply.send(GenerationRegReadReply(v.val, v.writeGen, v.readGen));
-		}
-		when(GenerationRegWriteRequest _wrq = waitNext(interf.write.getFuture())) {
-			state GenerationRegWriteRequest wrq = _wrq;
-			Optional<Value> rawV = wait(store->readValue(wrq.kv.key));
-			v = rawV.present() ? BinaryReader::fromStringRef<GenerationRegVal>(rawV.get(), IncludeVersion())
-			                   : GenerationRegVal();
-			if (v.readGen <= wrq.gen && v.writeGen < wrq.gen) {
-				v.writeGen = wrq.gen;
-				v.val = wrq.kv.value;
-				store->set(KeyValueRef(
-				    wrq.kv.key, BinaryWriter::toValue(v, IncludeVersion(ProtocolVersion::withGenerationRegVal()))));
-				wait(store->commit());
+			    .detail("From", reads[i].reply.getEndpoint().getPrimaryAddress())
+			    .detail("K", reads[i].key);
+			GenerationRegVal _v = wait(readGenerationRegVal(&store, &batchValues, reads[i].key));
+			v = _v;
+			TraceEvent("GenerationRegReadReply").detail("VWG", v.writeGen.generation);
+			if (v.readGen < reads[i].gen) {
+				v.readGen = reads[i].gen;
+				batchValues[reads[i].key] = v;
+			}
+			readReplies.push_back(GenerationRegReadReply(v.val, v.writeGen, v.readGen));
+		}
+		for (i = 0; i < writes.size(); ++i) {
+			GenerationRegVal _v = wait(readGenerationRegVal(&store, &batchValues, writes[i].kv.key));
+			v = _v;
+			if (v.readGen <= writes[i].gen && v.writeGen < writes[i].gen) {
+				v.writeGen = writes[i].gen;
+				v.val = writes[i].kv.value;
+				batchValues[writes[i].kv.key] = v;
 				TraceEvent("GenerationRegWrote")
-				    .detail("From", wrq.reply.getEndpoint().getPrimaryAddress())
-				    .detail("Key", wrq.kv.key)
-				    .detail("ReqGen", wrq.gen.generation)
+				    .detail("From", writes[i].reply.getEndpoint().getPrimaryAddress())
+				    .detail("Key", writes[i].kv.key)
+				    .detail("ReqGen", writes[i].gen.generation)
 				    .detail("Returning", v.writeGen.generation);
-				wrq.reply.send(v.writeGen);
+				writeReplies.push_back(v.writeGen);
 			} else {
 				TraceEvent("GenerationRegWriteFail")
-				    .detail("From", wrq.reply.getEndpoint().getPrimaryAddress())
-				    .detail("Key", wrq.kv.key)
-				    .detail("ReqGen", wrq.gen.generation)
+				    .detail("From", writes[i].reply.getEndpoint().getPrimaryAddress())
+				    .detail("Key", writes[i].kv.key)
+				    .detail("ReqGen", writes[i].gen.generation)
 				    .detail("ReadGen", v.readGen.generation)
 				    .detail("WriteGen", v.writeGen.generation);
-				wrq.reply.send(std::max(v.readGen, v.writeGen));
+				writeReplies.push_back(std::max(v.readGen, v.writeGen));
+			}
+		}
+
+		if (!batchValues.empty()) {
+			for (auto const& [key, val] : batchValues) {
+				store->set(KeyValueRef(
+				    key, BinaryWriter::toValue(val, IncludeVersion(ProtocolVersion::withGenerationRegVal()))));
 			}
+			wait(store->commit());
+		}
+		for (i = 0; i < reads.size(); ++i) {
+			reads[i].reply.send(readReplies[i]);
+		}
+		for (i = 0; i < writes.size(); ++i) {
+			writes[i].reply.send(writeReplies[i]);
 		}
 	}
 }
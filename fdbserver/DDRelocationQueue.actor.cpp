@@ -279,6 +279,12 @@ public:
 		});
 	}
 
+	int64_t getLoadCost(bool includeInFlight = true, double inflightPenalty = 1.0) const override {
+		return sum<int64_t>([includeInFlight, inflightPenalty](IDataDistributionTeam const& team) {
+			return team.getLoadCost(includeInFlight, inflightPenalty);
+		});
+	}
+
 	int64_t getReadInFlightToTeam() const override {
 		return sum<int64_t>([](IDataDistributionTeam const& team) { return team.getReadInFlightToTeam(); });
 	}
@@ -585,6 +591,7 @@ DDQueue::DDQueue(DDQueueInitParams const& params)
     cleanUpDataMoveParallelismLock(SERVER_KNOBS->DD_MOVE_KEYS_PARALLELISM),
     fetchSourceLock(new FlowLock(SERVER_KNOBS->DD_FETCH_SOURCE_PARALLELISM)), activeRelocations(0),
     queuedRelocations(0), bytesWritten(0), teamSize(params.teamSize), singleRegionTeamSize(params.singleRegionTeamSize),
+    physicalShardMoveSupported(params.physicalShardMoveSupported),
     output(params.relocationProducer), input(params.relocationConsumer), getShardMetrics(params.getShardMetrics),
     getTopKMetrics(params.getTopKMetrics), lastInterval(0), suppressIntervals(0),
     rawProcessingUnhealthy(new AsyncVar<bool>(false)), rawProcessingWiggle(new AsyncVar<bool>(false)),
@@ -988,9 +995,13 @@ void DDQueue::launchQueuedWork(RelocateData launchData, const DDEnabledState* dd
 	launchQueuedWork(combined, ddEnabledState);
 }
 
-DataMoveType newDataMoveType() {
+// A physical move falls back to fetchKeys on the destination if the checkpoints of the source cannot be fetched, so
+// choosing it by default is safe wherever the storage engines support checkpoints.
+DataMoveType newDataMoveType(bool physicalShardMoveSupported) {
 	DataMoveType type = DataMoveType::LOGICAL;
-	if (deterministicRandom()->random01() < SERVER_KNOBS->DD_PHYSICAL_SHARD_MOVE_PROBABILITY) {
+	if (physicalShardMoveSupported && SERVER_KNOBS->DD_PHYSICAL_SHARD_MOVE_BY_DEFAULT) {
+		type = DataMoveType::PHYSICAL;
+	} else if (deterministicRandom()->random01() < SERVER_KNOBS->DD_PHYSICAL_SHARD_MOVE_PROBABILITY) {
 		type = DataMoveType::PHYSICAL;
 	}
 	if (type != DataMoveType::PHYSICAL && SERVER_KNOBS->ENABLE_PHYSICAL_SHARD_MOVE_EXPERIMENT) {
@@ -1114,7 +1125,7 @@ void DDQueue::launchQueuedWork(std::set<RelocateData, std::greater<RelocateData>
 					} else {
 						rrs.dataMoveId = newDataMoveId(deterministicRandom()->randomUInt64(),
 						                               AssignEmptyRange::False,
-						                               newDataMoveType(),
+						                               newDataMoveType(physicalShardMoveSupported),
 						                               rrs.dmReason);
 						TraceEvent(SevInfo, "NewDataMoveWithRandomDestID")
 						    .detail("DataMoveID", rrs.dataMoveId.toString())
@@ -1217,6 +1228,31 @@ Future<Void> DDQueue::periodicalRefreshCounter() {
 	return recurring(f, SERVER_KNOBS->DD_QUEUE_COUNTER_REFRESH_INTERVAL);
 }
 
+Future<Void> DDQueue::chargeZoneMoveBudget(
+    const std::vector<std::pair<Reference<IDataDistributionTeam>, bool>>& destTeams,
+    int64_t bytes,
+    int priority) {
+	if (SERVER_KNOBS->DD_ZONE_MOVE_BYTES_PER_SEC <= 0) {
+		return Void();
+	}
+	std::set<Optional<Standalone<StringRef>>> zones;
+	for (const auto& [team, _] : destTeams) {
+		for (const auto& ssi : team->getLastKnownServerInterfaces()) {
+			zones.insert(ssi.locality.zoneId());
+		}
+	}
+	std::vector<Future<Void>> paid;
+	for (const auto& zone : zones) {
+		auto& limiter = zoneMoveLimiters.try_emplace(zone, SERVER_KNOBS->DD_ZONE_MOVE_BYTES_PER_SEC).first->second;
+		limiter.settle();
+		if (priority < SERVER_KNOBS->DATA_MOVE_BUDGET_PRIORITY_THRESHOLD) {
+			paid.push_back(limiter.ready());
+		}
+		limiter.addBytes(bytes);
+	}
+	return waitForAll(paid);
+}
+
 int DDQueue::getUnhealthyRelocationCount() const {
 	return unhealthyRelocations;
 }
@@ -1318,6 +1354,11 @@ void traceRelocateDecision(TraceEvent& ev, const UID& pairId, const RelocateDeci
 		    .detail("ParentShardWriteBytes", decision.parentMetrics.get().bytesWrittenPerKSecond);
 	} else if (decision.rd.reason == RelocateReason::SIZE_SPLIT) {
 		ev.detail("ShardSize", decision.metrics.bytes).detail("ParentShardSize", decision.parentMetrics.get().bytes);
+	} else if (decision.rd.reason == RelocateReason::READ_SPLIT) {
+		ev.detail("ShardReadBytes", decision.metrics.bytesReadPerKSecond)
+		    .detail("ShardReadOps", decision.metrics.opsReadPerKSecond)
+		    .detail("ParentShardReadBytes", decision.parentMetrics.get().bytesReadPerKSecond)
+		    .detail("ParentShardReadOps", decision.parentMetrics.get().opsReadPerKSecond);
 	}
 }
 
@@ -1488,8 +1529,11 @@ ACTOR Future<Void> dataDistributionRelocator(DDQueue* self,
 						} else {
 							destTeamSelect = TeamSelect::ANY;
 						}
+						// The pieces of a read split should land on teams that have read bandwidth to spare
 						PreferLowerReadUtil preferLowerReadTeam =
-						    SERVER_KNOBS->DD_PREFER_LOW_READ_UTIL_TEAM || rd.reason == RelocateReason::REBALANCE_READ
+						    SERVER_KNOBS->DD_PREFER_LOW_READ_UTIL_TEAM ||
+						            rd.reason == RelocateReason::REBALANCE_READ ||
+						            rd.reason == RelocateReason::READ_SPLIT
 						        ? PreferLowerReadUtil::True
 						        : PreferLowerReadUtil::False;
 						auto req = GetTeamRequest(destTeamSelect,
@@ -1709,8 +1753,10 @@ ACTOR Future<Void> dataDistributionRelocator(DDQueue* self,
 					} else {
 						self->moveCreateNewPhysicalShard++;
 					}
-					rd.dataMoveId = newDataMoveId(
-					    physicalShardIDCandidate, AssignEmptyRange::False, newDataMoveType(), rd.dmReason);
+					rd.dataMoveId = newDataMoveId(physicalShardIDCandidate,
+					                              AssignEmptyRange::False,
+					                              newDataMoveType(self->physicalShardMoveSupported),
+					                              rd.dmReason);
 					TraceEvent(SevInfo, "NewDataMoveWithPhysicalShard")
 					    .detail("DataMoveID", rd.dataMoveId.toString())
 					    .detail("Reason", rd.reason.toString())
@@ -1798,6 +1844,16 @@ ACTOR Future<Void> dataDistributionRelocator(DDQueue* self,
 
 			launchDest(rd, bestTeams, self->destBusymap);
 
+			state double zoneBudgetWaitStart = now();
+			wait(self->chargeZoneMoveBudget(bestTeams, metrics.bytes, rd.priority));
+			if (now() > zoneBudgetWaitStart) {
+				TraceEvent(SevDebug, "RelocateShardZoneBudgetWait", distributorId)
+				    .detail("PairId", relocateShardInterval.pairID)
+				    .detail("Priority", rd.priority)
+				    .detail("Bytes", metrics.bytes)
+				    .detail("Delay", now() - zoneBudgetWaitStart);
+			}
+
 			TraceEvent ev(relocateShardInterval.severity, "RelocateShardHasDestination", distributorId);
 			RelocateDecision decision{ rd, destIds, extraIds, metrics, parentMetrics };
 			traceRelocateDecision(ev, relocateShardInterval.pairID, decision);
@@ -2198,11 +2254,17 @@ ACTOR static Future<bool> rebalanceTeams(DDQueue* self,
 
 	int64_t sourceBytes = sourceTeam->getLoadBytes(false);
 	int64_t destBytes = destTeam->getLoadBytes();
+	// The costs are the load bytes scaled up by how busy the servers are, so that moves also even out CPU, disk and
+	// traffic when the DD_TEAM_COST weights are set
+	int64_t sourceCost = sourceTeam->getLoadCost(false);
+	int64_t destCost = destTeam->getLoadCost();
 
 	bool sourceAndDestTooSimilar =
-	    sourceBytes - destBytes <= 3 * std::max<int64_t>(SERVER_KNOBS->MIN_SHARD_BYTES, metrics.bytes);
+	    sourceCost - destCost <= 3 * std::max<int64_t>(SERVER_KNOBS->MIN_SHARD_BYTES, metrics.bytes);
 	traceEvent->detail("SourceBytes", sourceBytes)
 	    .detail("DestBytes", destBytes)
+	    .detail("SourceCost", sourceCost)
+	    .detail("DestCost", destCost)
 	    .detail("ShardBytes", metrics.bytes)
 	    .detail("SourceAndDestTooSimilar", sourceAndDestTooSimilar);
 
@@ -19,6 +19,7 @@
  */
 
 #include "fdbclient/FDBTypes.h"
+#include "fdbclient/ManagementAPI.actor.h"
 #include "fdbclient/StorageServerInterface.h"
 #include "fdbrpc/FailureMonitor.h"
 #include "fdbclient/SystemData.h"
@@ -79,6 +80,23 @@ void restartShardTrackers(DataDistributionTracker* self,
                           Optional<ShardMetrics> startingMetrics = Optional<ShardMetrics>(),
                           bool whenDDInit = false);
 
+// Whether a user shard reads enough to be split by its read traffic
+static bool isReadSplitShard(KeyRangeRef keys, StorageMetrics const& metrics) {
+	return SERVER_KNOBS->ENABLE_READ_BASED_SHARD_SPLIT && keys.begin < keyServersKeys.begin &&
+	       (metrics.bytesReadPerKSecond > SERVER_KNOBS->SHARD_READ_SPLIT_BYTES_PER_KSEC ||
+	        metrics.opsReadPerKSecond > SERVER_KNOBS->SHARD_READ_SPLIT_OPS_PER_KSEC);
+}
+
+// Whether a shard reads too much to be merged. The threshold is well below the split threshold, so that the pieces of
+// a read split are not merged back as soon as their reads dip.
+static bool isReadMergeBlocked(StorageMetrics const& metrics) {
+	return SERVER_KNOBS->ENABLE_READ_BASED_SHARD_SPLIT &&
+	       (metrics.bytesReadPerKSecond >
+	            SERVER_KNOBS->SHARD_READ_SPLIT_BYTES_PER_KSEC * SERVER_KNOBS->SHARD_READ_MERGE_RATIO ||
+	        metrics.opsReadPerKSecond >
+	            SERVER_KNOBS->SHARD_READ_SPLIT_OPS_PER_KSEC * SERVER_KNOBS->SHARD_READ_MERGE_RATIO);
+}
+
 // Gets the permitted size and IO bounds for a shard. A shard that starts at allKeys.begin
 //  (i.e. '') will have a permitted size of 0, since the database can contain no data.
 ShardSizeBounds getShardSizeBounds(KeyRangeRef shard, int64_t maxShardSize) {
@@ -206,6 +224,27 @@ std::pair<ShardSizeBounds, bool> calculateShardSizeBounds(
 		bounds.min.opsReadPerKSecond =
 		    std::max((int64_t)0, currentReadOps - SERVER_KNOBS->SHARD_READ_OPS_CHANGE_THRESHOLD);
 		bounds.permittedError.opsReadPerKSecond = currentReadOps * 0.25;
+
+		// 5. read split and merge thresholds, so that crossing either of them wakes up the shard evaluator
+		if (SERVER_KNOBS->ENABLE_READ_BASED_SHARD_SPLIT) {
+			auto const& metrics = shardMetrics->get()->metrics;
+			const int64_t splitBytes = SERVER_KNOBS->SHARD_READ_SPLIT_BYTES_PER_KSEC;
+			const int64_t splitOps = SERVER_KNOBS->SHARD_READ_SPLIT_OPS_PER_KSEC;
+			const int64_t mergeBytes = splitBytes * SERVER_KNOBS->SHARD_READ_MERGE_RATIO;
+			const int64_t mergeOps = splitOps * SERVER_KNOBS->SHARD_READ_MERGE_RATIO;
+			if (metrics.bytesReadPerKSecond <= splitBytes) {
+				bounds.max.bytesReadPerKSecond = std::min(bounds.max.bytesReadPerKSecond, splitBytes + 1);
+			}
+			if (metrics.bytesReadPerKSecond > mergeBytes) {
+				bounds.min.bytesReadPerKSecond = std::max(bounds.min.bytesReadPerKSecond, mergeBytes);
+			}
+			if (metrics.opsReadPerKSecond <= splitOps) {
+				bounds.max.opsReadPerKSecond = std::min(bounds.max.opsReadPerKSecond, splitOps + 1);
+			}
+			if (metrics.opsReadPerKSecond > mergeOps) {
+				bounds.min.opsReadPerKSecond = std::max(bounds.min.opsReadPerKSecond, mergeOps);
+			}
+		}
 	}
 	return { bounds, readHotShard };
 }
@@ -335,6 +374,9 @@ ACTOR Future<Void> readHotDetector(DataDistributionTracker* self) {
 				    .detail("KeyRangeBegin", keyRange.keys.begin)
 				    .detail("KeyRangeEnd", keyRange.keys.end);
 			}
+			if (SERVER_KNOBS->STORAGE_CACHE_AUTO_ADMISSION && !readHotRanges.empty()) {
+				self->readHotRanges.send(readHotRanges);
+			}
 		}
 	} catch (Error& e) {
 		if (e.code() != error_code_actor_cancelled) {
@@ -346,6 +388,132 @@ ACTOR Future<Void> readHotDetector(DataDistributionTracker* self) {
 	}
 }
 
+// Caches range on the storage cache servers, unless there are none or part of the range is already cached, such as by
+// an operator. Returns whether it was cached, in which case uncaching it later cannot uncache anything else.
+ACTOR Future<bool> cacheReadHotRange(Database cx, KeyRange range) {
+	state Transaction tr(cx);
+	loop {
+		tr.setOption(FDBTransactionOptions::READ_LOCK_AWARE);
+		tr.setOption(FDBTransactionOptions::ACCESS_SYSTEM_KEYS);
+		try {
+			state Future<RangeResult> cacheServers = tr.getRange(storageCacheServerKeys, 1);
+			state Future<RangeResult> before =
+			    tr.getRange(KeyRangeRef(storageCachePrefix, keyAfter(storageCacheKey(range.begin))),
+			                1,
+			                Snapshot::False,
+			                Reverse::True);
+			state Future<RangeResult> within =
+			    tr.getRange(KeyRangeRef(keyAfter(storageCacheKey(range.begin)), storageCacheKey(range.end)), 1);
+			wait(success(cacheServers) && success(before) && success(within));
+			if (cacheServers.get().empty() || !within.get().empty()) {
+				return false;
+			}
+			if (!before.get().empty()) {
+				std::vector<uint16_t> serverIndices;
+				decodeStorageCacheValue(before.get()[0].value, serverIndices);
+				if (!serverIndices.empty()) {
+					return false;
+				}
+			}
+			break;
+		} catch (Error& e) {
+			wait(tr.onError(e));
+		}
+	}
+	wait(ManagementAPI::addCachedRange(cx.getReference(), range));
+	return true;
+}
+
+// The first of the ranges that data distribution has cached that intersects range, if any
+static DataDistributionTracker::AutoCachedRange* findAutoCachedRange(DataDistributionTracker* self, KeyRangeRef range) {
+	auto it = self->autoCachedRanges.lower_bound(range.begin);
+	if (it != self->autoCachedRanges.begin() && std::prev(it)->second.end > range.begin) {
+		--it;
+	}
+	if (it != self->autoCachedRanges.end() && it->first < range.end) {
+		return &it->second;
+	}
+	return nullptr;
+}
+
+// Uncaches the cached range that begins at begin, and forgets it
+ACTOR Future<Void> uncacheReadHotRange(DataDistributionTracker* self, Key begin, std::string reason) {
+	auto it = self->autoCachedRanges.find(begin);
+	ASSERT(it != self->autoCachedRanges.end());
+	state KeyRange range(KeyRangeRef(begin, it->second.end));
+	state int64_t bytes = it->second.bytes;
+	self->autoCachedRanges.erase(it);
+	self->autoCachedBytes -= bytes;
+	TraceEvent("StorageCacheEvictRange", self->distributorId)
+	    .detail("Range", range)
+	    .detail("Bytes", bytes)
+	    .detail("Reason", reason)
+	    .detail("CachedBytes", self->autoCachedBytes);
+	wait(ManagementAPI::removeCachedRange(self->db->context().getReference(), range));
+	return Void();
+}
+
+// Caches the ranges that readHotDetector finds on the storage cache servers, so that clients spread reads of them
+// over the caches as well as the storage servers. The cached ranges are kept within STORAGE_CACHE_AUTO_MAX_BYTES by
+// evicting the ones that were read hot longest ago, and a range that has not been read hot for
+// STORAGE_CACHE_AUTO_IDLE_TIMEOUT is uncached.
+ACTOR Future<Void> storageCacheAdmission(DataDistributionTracker* self) {
+	loop {
+		state Standalone<VectorRef<ReadHotRangeWithMetrics>> readHotRanges;
+		choose {
+			when(Standalone<VectorRef<ReadHotRangeWithMetrics>> ranges = waitNext(self->readHotRanges.getFuture())) {
+				readHotRanges = ranges;
+			}
+			when(wait(delay(SERVER_KNOBS->STORAGE_CACHE_AUTO_IDLE_TIMEOUT / 4))) {}
+		}
+
+		state int i = 0;
+		for (; i < readHotRanges.size(); i++) {
+			state KeyRange range = readHotRanges[i].keys;
+			state int64_t bytes = std::max<int64_t>(readHotRanges[i].bytes, 1);
+
+			// A range that overlaps one already cached only keeps that one from going idle
+			DataDistributionTracker::AutoCachedRange* overlapping = findAutoCachedRange(self, range);
+			if (overlapping != nullptr) {
+				overlapping->lastReadHot = now();
+				continue;
+			}
+			if (bytes > SERVER_KNOBS->STORAGE_CACHE_AUTO_MAX_BYTES) {
+				continue;
+			}
+
+			while (self->autoCachedBytes + bytes > SERVER_KNOBS->STORAGE_CACHE_AUTO_MAX_BYTES) {
+				auto coldest = std::min_element(
+				    self->autoCachedRanges.begin(), self->autoCachedRanges.end(), [](auto const& a, auto const& b) {
+					    return a.second.lastReadHot < b.second.lastReadHot;
+				    });
+				wait(uncacheReadHotRange(self, coldest->first, "MemoryLimit"));
+			}
+
+			bool cached = wait(cacheReadHotRange(self->db->context(), range));
+			if (cached) {
+				self->autoCachedRanges[range.begin] = { range.end, bytes, now() };
+				self->autoCachedBytes += bytes;
+				TraceEvent("StorageCacheAdmitRange", self->distributorId)
+				    .detail("Range", range)
+				    .detail("Bytes", bytes)
+				    .detail("ReadBandwidth", readHotRanges[i].readBandwidthSec)
+				    .detail("CachedBytes", self->autoCachedBytes);
+			}
+		}
+
+		state std::vector<Key> idle;
+		for (auto const& [begin, cachedRange] : self->autoCachedRanges) {
+			if (now() - cachedRange.lastReadHot > SERVER_KNOBS->STORAGE_CACHE_AUTO_IDLE_TIMEOUT) {
+				idle.push_back(begin);
+			}
+		}
+		for (i = 0; i < idle.size(); i++) {
+			wait(uncacheReadHotRange(self, idle[i], "Idle"));
+		}
+	}
+}
+
 /*
 ACTOR Future<Void> extrapolateShardBytes( Reference<AsyncVar<Optional<int64_t>>> inBytes,
 Reference<AsyncVar<Optional<int64_t>>> outBytes ) { state std::deque< std::pair<double,int64_t> > past; loop { wait(
@@ -845,10 +1013,20 @@ ACTOR Future<Void> shardSplitter(DataDistributionTracker* self,
 	splitMetrics.bytesWrittenPerKSecond =
 	    keys.begin >= keyServersKeys.begin ? splitMetrics.infinity : SERVER_KNOBS->SHARD_SPLIT_BYTES_PER_KSEC;
 	splitMetrics.iosPerKSecond = splitMetrics.infinity;
-	splitMetrics.bytesReadPerKSecond = splitMetrics.infinity; // Don't split by readBandwidthSec
+	state int minSplitBytes = SERVER_KNOBS->MIN_SHARD_BYTES;
+	if (reason == RelocateReason::READ_SPLIT) {
+		// Split at the busiest keys, into pieces that each read at most half the split threshold. A hot range is
+		// often small, so the pieces may be much smaller than a shard split by size.
+		splitMetrics.bytesReadPerKSecond = SERVER_KNOBS->SHARD_READ_SPLIT_BYTES_PER_KSEC / 2;
+		splitMetrics.opsReadPerKSecond = SERVER_KNOBS->SHARD_READ_SPLIT_OPS_PER_KSEC / 2;
+		minSplitBytes = SERVER_KNOBS->SHARD_READ_SPLIT_MIN_BYTES;
+	} else {
+		splitMetrics.bytesReadPerKSecond = splitMetrics.infinity; // Don't split by readBandwidthSec
+		splitMetrics.opsReadPerKSecond = splitMetrics.infinity;
+	}
 
 	state Standalone<VectorRef<KeyRef>> splitKeys =
-	    wait(self->db->splitStorageMetrics(keys, splitMetrics, metrics, SERVER_KNOBS->MIN_SHARD_BYTES));
+	    wait(self->db->splitStorageMetrics(keys, splitMetrics, metrics, minSplitBytes));
 	// fprintf(stderr, "split keys:\n");
 	// for( int i = 0; i < splitKeys.size(); i++ ) {
 	//	fprintf(stderr, "   %s\n", printable(splitKeys[i]).c_str());
@@ -866,6 +1044,9 @@ ACTOR Future<Void> shardSplitter(DataDistributionTracker* self,
 	            : bandwidthStatus == BandwidthStatusNormal ? "Normal"
 	                                                       : "Low")
 	    .detail("BytesWrittenPerKSec", metrics.bytesWrittenPerKSecond)
+	    .detail("BytesReadPerKSec", metrics.bytesReadPerKSecond)
+	    .detail("OpsReadPerKSec", metrics.opsReadPerKSecond)
+	    .detail("Reason", reason.toString())
 	    .detail("NumShards", numShards);
 
 	if (numShards > 1) {
@@ -1046,6 +1227,7 @@ Future<Void> shardMerger(DataDistributionTracker* self,
 		// If we just recently get the current shard's metrics (i.e., less than DD_LOW_BANDWIDTH_DELAY ago), it
 		// means the shard's metric may not be stable yet. So we cannot continue merging in this direction.
 		if (endingStats.bytes >= shardBounds.min.bytes || getBandwidthStatus(endingStats) != BandwidthStatusLow ||
+		    isReadMergeBlocked(endingStats) ||
 		    now() - lastLowBandwidthStartTime < SERVER_KNOBS->DD_LOW_BANDWIDTH_DELAY ||
 		    shardsMerged >= SERVER_KNOBS->DD_MERGE_LIMIT) {
 			// The merged range is larger than the min bounds so we cannot continue merging in this direction.
@@ -1129,8 +1311,9 @@ ACTOR Future<Void> shardEvaluator(DataDistributionTracker* self,
 	auto bandwidthStatus = getBandwidthStatus(stats);
 
 	bool sizeSplit = stats.bytes > shardBounds.max.bytes,
-	     writeSplit = bandwidthStatus == BandwidthStatusHigh && keys.begin < keyServersKeys.begin;
-	bool shouldSplit = sizeSplit || writeSplit;
+	     writeSplit = bandwidthStatus == BandwidthStatusHigh && keys.begin < keyServersKeys.begin,
+	     readSplit = isReadSplitShard(keys, stats);
+	bool shouldSplit = sizeSplit || writeSplit || readSplit;
 
 	auto prevIter = self->shards->rangeContaining(keys.begin);
 	if (keys.begin > allKeys.begin)
@@ -1141,6 +1324,7 @@ ACTOR Future<Void> shardEvaluator(DataDistributionTracker* self,
 		++nextIter;
 
 	bool shouldMerge = stats.bytes < shardBounds.min.bytes && bandwidthStatus == BandwidthStatusLow &&
+	                   !isReadMergeBlocked(stats) &&
 	                   (shardForwardMergeFeasible(self, keys, nextIter.range()) ||
 	                    shardBackwardMergeFeasible(self, keys, prevIter.range()));
 
@@ -1173,7 +1357,9 @@ ACTOR Future<Void> shardEvaluator(DataDistributionTracker* self,
 		onChange = onChange || shardMerger(self, keys, shardSize);
 	}
 	if (shouldSplit) {
-		RelocateReason reason = sizeSplit ? RelocateReason::SIZE_SPLIT : RelocateReason::WRITE_SPLIT;
+		RelocateReason reason = sizeSplit    ? RelocateReason::SIZE_SPLIT
+		                        : writeSplit ? RelocateReason::WRITE_SPLIT
+		                                     : RelocateReason::READ_SPLIT;
 		onChange = onChange || shardSplitter(self, keys, shardSize, shardBounds, reason);
 	}
 
@@ -1527,6 +1713,9 @@ struct DataDistributionTrackerImpl {
 	ACTOR static Future<Void> run(DataDistributionTracker* self, Reference<InitialDataDistribution> initData) {
 		state Future<Void> loggingTrigger = Void();
 		state Future<Void> readHotDetect = readHotDetector(self);
+		state Future<Void> cacheAdmission = SERVER_KNOBS->STORAGE_CACHE_AUTO_ADMISSION && !self->db->isMocked()
+		                                        ? storageCacheAdmission(self)
+		                                        : Never();
 		state Reference<EventCacheHolder> ddTrackerStatsEventHolder = makeReference<EventCacheHolder>("DDTrackerStats");
 
 		try {
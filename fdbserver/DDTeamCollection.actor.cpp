@@ -246,7 +246,7 @@ public:
 					continue;
 				}
 
-				int64_t loadBytes = self->teams[currentIndex]->getLoadBytes(true, req.inflightPenalty);
+				int64_t loadBytes = self->teams[currentIndex]->getLoadCost(true, req.inflightPenalty);
 				if (req.storageQueueAware) {
 					Optional<int64_t> storageQueueSize = self->teams[currentIndex]->getLongestStorageQueueSize();
 					if (!storageQueueSize.present()) {
@@ -302,7 +302,7 @@ public:
 		int64_t bestLoadBytes = 0;
 		bool wigglingBestOption = false; // best option contains server in paused wiggle state
 		for (int i = 0; i < candidates.size(); i++) {
-			int64_t loadBytes = candidates[i]->getLoadBytes(true, req.inflightPenalty);
+			int64_t loadBytes = candidates[i]->getLoadCost(true, req.inflightPenalty);
 			if (!bestOption.present() || req.lessCompare(bestOption.get(), candidates[i], bestLoadBytes, loadBytes)) {
 
 				// bestOption doesn't contain wiggling SS while current team does. Don't replace bestOption
@@ -356,7 +356,8 @@ public:
 			}
 
 			// Select the best team
-			// Currently the metric is minimum used disk space (adjusted for data in flight)
+			// Currently the metric is minimum used disk space (adjusted for data in flight), scaled up by how busy
+			// the team's servers are (see TeamUtilization)
 			// Only healthy teams may be selected. The team has to be healthy at the moment we update
 			//   shardsAffectedByTeamFailure or we could be dropping a shard on the floor (since team
 			//   tracking is "edge triggered")
@@ -1771,6 +1772,11 @@ public:
 					    .detail("Status", status->toString());
 				}
 			}
+			if (self->rebuildingStorageId.get().present() && self->rebuildingStorageId.get().get() == interf.id()) {
+				// The server is down while it rebuilds its engine in place, and keeps its shards meanwhile
+				status->isFailed = false;
+				inHealthyZone = true;
+			}
 
 			if (!interf.isTss()) {
 				if (self->server_status.get(interf.id()).initialized) {
@@ -1849,6 +1855,7 @@ public:
 					break;
 				}
 				when(wait(self->healthyZone.onChange())) {}
+				when(wait(self->rebuildingStorageId.onChange())) {}
 			}
 		}
 
@@ -2257,6 +2264,70 @@ public:
 		}
 	}
 
+	// Asks a storage server to rebuild its engine in place instead of moving its data away: it closes its store, its
+	// worker copies the store into a fresh one on the same disk, and the server restarts from that and catches up from
+	// the TLogs. The server keeps its shards meanwhile, and its failure is ignored until it is back with a new
+	// interface or PERPETUAL_WIGGLE_REBUILD_TIMEOUT passes. Returns false if the server was not rebuilt.
+	ACTOR static Future<bool> rebuildStorageServerInPlace(DDTeamCollection* self, UID id) {
+		if (!self->server_info.count(id)) {
+			return false;
+		}
+		state Reference<TCServerInfo> server = self->server_info.at(id);
+		state Future<std::pair<StorageServerInterface, ProcessClass>> interfaceChanged = server->onInterfaceChanged;
+		// Only replacing a server changes its store type, so servers to migrate are left to the exclusion
+		if (server->getStoreType() != self->configuration.storageServerStoreType) {
+			return false;
+		}
+
+		self->rebuildingStorageId.set(id);
+		try {
+			ErrorOr<Void> accepted =
+			    wait(server->getLastKnownInterface().rebuildStorage.tryGetReply(RebuildStorageRequest()));
+			if (accepted.isError()) {
+				TraceEvent(SevWarn, "PerpetualStorageWiggleRebuildRejected", self->distributorId)
+				    .error(accepted.getError())
+				    .detail("Primary", self->primary)
+				    .detail("ServerId", id);
+				self->rebuildingStorageId.set(Optional<UID>());
+				return false;
+			}
+			TraceEvent("PerpetualStorageWiggleRebuildStart", self->distributorId)
+			    .detail("Primary", self->primary)
+			    .detail("ServerId", id);
+
+			state bool rebuilt = true;
+			choose {
+				when(wait(success(interfaceChanged))) {}
+				when(wait(server->onRemoved)) {}
+				when(wait(delay(SERVER_KNOBS->PERPETUAL_WIGGLE_REBUILD_TIMEOUT, TaskPriority::DataDistributionLow))) {
+					rebuilt = false;
+				}
+			}
+			self->rebuildingStorageId.set(Optional<UID>());
+			TraceEvent(rebuilt ? SevInfo : SevWarnAlways, "PerpetualStorageWiggleRebuildFinish", self->distributorId)
+			    .detail("Primary", self->primary)
+			    .detail("ServerId", id)
+			    .detail("TimedOut", !rebuilt);
+			return rebuilt;
+		} catch (Error& e) {
+			self->rebuildingStorageId.set(Optional<UID>());
+			throw;
+		}
+	}
+
+	// Returns when the wiggled storage server has been rebuilt in place, if PERPETUAL_WIGGLE_REBUILD_IN_PLACE is set
+	// and the server supports it, or else once it has been excluded and removed.
+	ACTOR static Future<Void> wiggleStorageServer(DDTeamCollection* self, UID id) {
+		if (SERVER_KNOBS->PERPETUAL_WIGGLE_REBUILD_IN_PLACE) {
+			bool rebuilt = wait(rebuildStorageServerInPlace(self, id));
+			if (rebuilt) {
+				return Void();
+			}
+		}
+		wait(self->excludeStorageServersForWiggle(id));
+		return Void();
+	}
+
 	ACTOR static Future<Void> perpetualStorageWiggler(DDTeamCollection* self,
 	                                                  AsyncVar<bool>* stopSignal,
 	                                                  PromiseStream<Void> finishStorageWiggleSignal) {
@@ -2302,8 +2373,7 @@ public:
 						when(wait(self->waitUntilHealthy())) {
 							CODE_PROBE(true, "start wiggling");
 							wait(self->storageWiggler->startWiggle());
-							auto fv = self->excludeStorageServersForWiggle(id);
-							moveFinishFuture = fv;
+							moveFinishFuture = wiggleStorageServer(self, id);
 							self->storageWiggler->setWiggleState(StorageWiggler::RUN);
 							TraceEvent("PerpetualStorageWiggleStart", self->distributorId)
 							    .detail("Primary", self->primary)
@@ -3497,6 +3567,7 @@ public:
 
 			for (i = 0; i < teams.size(); i++) {
 				const auto& team = teams[i];
+				const TeamUtilization utilization = team->getUtilization();
 
 				TraceEvent("ServerTeamInfo", self->getDistributorId())
 				    .detail("TeamIndex", i)
@@ -3507,6 +3578,11 @@ public:
 				    .detail("TeamID", team->getTeamID())
 				    .detail("InflightDataToTeam", team->getDataInFlightToTeam())
 				    .detail("LoadBytes", team->getLoadBytes())
+				    .detail("LoadCost", team->getLoadCost())
+				    .detail("CpuUtilization", utilization.cpu)
+				    .detail("DiskBusyUtilization", utilization.diskBusy)
+				    .detail("ReadOpsUtilization", utilization.readOps)
+				    .detail("WriteBandwidthUtilization", utilization.writeBandwidth)
 				    .detail("ReadLoad", team->getReadLoad())
 				    .detail("AverageCPU", team->getAverageCPU())
 				    .detail("ReadInFlightToTeam", team->getReadInFlightToTeam())
@@ -6396,6 +6472,74 @@ public:
 		return Void();
 	}
 
+	static void setTeamCostWeights(double cpu, double diskBusy, double readOps, double writeBandwidth) {
+		auto& knobs = IKnobCollection::getMutableGlobalKnobCollection();
+		knobs.setKnob("dd_team_cost_cpu_weight", KnobValueRef::create(double{ cpu }));
+		knobs.setKnob("dd_team_cost_disk_busy_weight", KnobValueRef::create(double{ diskBusy }));
+		knobs.setKnob("dd_team_cost_read_ops_weight", KnobValueRef::create(double{ readOps }));
+		knobs.setKnob("dd_team_cost_write_bandwidth_weight", KnobValueRef::create(double{ writeBandwidth }));
+	}
+
+	ACTOR static Future<Void> GetTeam_TrueBestLowestCost() {
+		Reference<IReplicationPolicy> policy = makeReference<PolicyAcross>(3, "zoneid", makeReference<PolicyOne>());
+		state int processSize = 5;
+		state int teamSize = 3;
+		state std::unique_ptr<DDTeamCollection> collection = testTeamCollection(teamSize, policy, processSize);
+
+		setTeamCostWeights(1.0, 0.0, 0.0, 0.0);
+
+		GetStorageMetricsReply low_load;
+		low_load.capacity.bytes = 1000 * 1024 * 1024;
+		low_load.available.bytes = 800 * 1024 * 1024;
+		low_load.load.bytes = 90 * 1024 * 1024;
+
+		GetStorageMetricsReply high_load;
+		high_load.capacity.bytes = 1000 * 1024 * 1024;
+		high_load.available.bytes = 800 * 1024 * 1024;
+		high_load.load.bytes = 100 * 1024 * 1024;
+
+		HealthMetrics::StorageStats idle, busy;
+		idle.cpuUsage = 10.0;
+		busy.cpuUsage = 90.0;
+
+		collection->addTeam(std::set<UID>({ UID(1, 0), UID(2, 0), UID(3, 0) }), IsInitialTeam::True);
+		collection->addTeam(std::set<UID>({ UID(2, 0), UID(3, 0), UID(4, 0) }), IsInitialTeam::True);
+		collection->disableBuildingTeams();
+		collection->setCheckTeamDelay();
+
+		/*
+		 * The team holding the fewest bytes has a server at 90% CPU, so with the CPU weighted into the team cost the
+		 * other team is the least utilized.
+		 */
+
+		collection->server_info[UID(1, 0)]->setMetrics(low_load);
+		collection->server_info[UID(1, 0)]->setStorageStats(busy);
+		for (int i = 2; i <= 4; ++i) {
+			collection->server_info[UID(i, 0)]->setMetrics(high_load);
+			collection->server_info[UID(i, 0)]->setStorageStats(idle);
+		}
+
+		state GetTeamRequest req(TeamSelect::WANT_TRUE_BEST,
+		                         PreferLowerDiskUtil::True,
+		                         TeamMustHaveShards::False,
+		                         PreferLowerReadUtil::False,
+		                         PreferWithinShardLimit::False);
+		req.completeSources = std::vector<UID>{ UID(1, 0), UID(2, 0), UID(3, 0) };
+
+		wait(collection->getTeam(req));
+
+		const auto [resTeam, srcFound] = req.reply.getFuture().get();
+		setTeamCostWeights(0.0, 0.0, 0.0, 0.0);
+
+		std::set<UID> expectedServers{ UID(2, 0), UID(3, 0), UID(4, 0) };
+		ASSERT(resTeam.present());
+		auto servers = resTeam.get()->getServerIDs();
+		const std::set<UID> selectedServers(servers.begin(), servers.end());
+		ASSERT(expectedServers == selectedServers);
+
+		return Void();
+	}
+
 	ACTOR static Future<Void> GetTeam_TrueBestMostUtilized() {
 		Reference<IReplicationPolicy> policy = makeReference<PolicyAcross>(3, "zoneid", makeReference<PolicyOne>());
 		state int processSize = 5;
@@ -6867,6 +7011,11 @@ TEST_CASE("/DataDistribution/GetTeam/TrueBestLeastUtilized") {
 	return Void();
 }
 
+TEST_CASE("/DataDistribution/GetTeam/TrueBestLowestCost") {
+	wait(DDTeamCollectionUnitTest::GetTeam_TrueBestLowestCost());
+	return Void();
+}
+
 TEST_CASE("/DataDistribution/GetTeam/TrueBestMostUtilized") {
 	wait(DDTeamCollectionUnitTest::GetTeam_TrueBestMostUtilized());
 	return Void();
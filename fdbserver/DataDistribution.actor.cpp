@@ -56,7 +56,8 @@
 #include "flow/actorcompiler.h" // This must be the last #include.
 
 void RelocateShard::setParentRange(KeyRange const& parent) {
-	ASSERT(reason == RelocateReason::WRITE_SPLIT || reason == RelocateReason::SIZE_SPLIT);
+	ASSERT(reason == RelocateReason::WRITE_SPLIT || reason == RelocateReason::SIZE_SPLIT ||
+	       reason == RelocateReason::READ_SPLIT);
 	parent_range = parent;
 }
 
@@ -994,6 +995,15 @@ ACTOR Future<Void> serveBlobMigratorRequests(Reference<DataDistributor> self,
 	}
 }
 
+// Only sharded RocksDB can create and ingest the checkpoints of a physical shard move, so every storage server must
+// run it, including those the perpetual wiggle is migrating to.
+static bool physicalShardMoveSupported(DatabaseConfiguration const& configuration) {
+	auto supported = [](KeyValueStoreType type) { return type == KeyValueStoreType::SSD_SHARDED_ROCKSDB; };
+	return SERVER_KNOBS->SHARD_ENCODE_LOCATION_METADATA && supported(configuration.storageServerStoreType) &&
+	       (configuration.perpetualStoreType == KeyValueStoreType::NONE ||
+	        supported(configuration.perpetualStoreType));
+}
+
 // Runs the data distribution algorithm for FDB, including the DD Queue, DD tracker, and DD team collection
 ACTOR Future<Void> dataDistribution(Reference<DataDistributor> self,
                                     PromiseStream<GetMetricsListRequest> getShardMetricsList,
@@ -1107,7 +1117,8 @@ ACTOR Future<Void> dataDistribution(Reference<DataDistributor> self,
 			                       .relocationProducer = self->relocationProducer,
 			                       .relocationConsumer = self->relocationConsumer.getFuture(),
 			                       .getShardMetrics = getShardMetrics,
-			                       .getTopKMetrics = getTopKShardMetrics });
+			                       .getTopKMetrics = getTopKShardMetrics,
+			                       .physicalShardMoveSupported = physicalShardMoveSupported(self->configuration) });
 			actors.push_back(reportErrorsExcept(DDQueue::run(self->context->ddQueue,
 			                                                 processingUnhealthy,
 			                                                 processingWiggle,
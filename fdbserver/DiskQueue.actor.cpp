@@ -58,6 +58,10 @@ struct StringBuffer {
 		str = Standalone<StringRef>();
 		reserved = 0;
 	}
+	void set(Standalone<StringRef> x) {
+		str = x;
+		reserved = x.size();
+	}
 	void clearReserve(int size) {
 		str = Standalone<StringRef>();
 		reserved = size;
@@ -79,7 +83,7 @@ struct StringBuffer {
 	void alignReserve(int alignment, int size) {
 		ASSERT(alignment && (alignment & (alignment - 1)) == 0); // alignment is a power of two
 
-		if (size >= reserved) {
+		if (size > reserved) {
 			// SOMEDAY: Use a new arena and discard the old one after copying?
 			reserved = std::max(size, reserved * 2);
 			if (reserved > 1e9) {
@@ -161,17 +165,196 @@ private:
 	AsyncVar<bool> actorCountIsZero = true;
 };
 
+// A file whose bytes are striped across several files in units of unitBytes: unit u of the file is unit
+// u / stripes.size() of stripe u % stripes.size(). Reads, writes and syncs are issued to all the stripes they touch
+// at once, so a DiskQueue whose stripes are on different devices can use the bandwidth of all of them, while a commit
+// is still a single sync() of this file.
+class AsyncFileStriped final : public IAsyncFile, public ReferenceCounted<AsyncFileStriped> {
+public:
+	AsyncFileStriped(std::vector<Reference<IAsyncFile>> stripes, int64_t unitBytes)
+	  : stripes(std::move(stripes)), unitBytes(unitBytes) {
+		ASSERT(!this->stripes.empty() && unitBytes > 0 && unitBytes % _PAGE_SIZE == 0);
+	}
+
+	// Opens every stripe. If none of them exist this throws file_not_found(), as opening a single file would. If only
+	// some of them exist the file is damaged or a device is missing, and this throws io_error() rather than letting
+	// the caller create the file again.
+	ACTOR static Future<Reference<IAsyncFile>> open(std::vector<std::string> filenames,
+	                                                int64_t unitBytes,
+	                                                int64_t flags,
+	                                                int64_t mode) {
+		state std::vector<Future<Reference<IAsyncFile>>> opens;
+		opens.reserve(filenames.size());
+		for (const auto& filename : filenames) {
+			opens.push_back(IAsyncFileSystem::filesystem()->open(filename, flags, mode));
+		}
+		wait(waitForAllReady(opens));
+
+		std::vector<Reference<IAsyncFile>> stripes;
+		int missing = 0;
+		for (const auto& f : opens) {
+			if (!f.isError()) {
+				stripes.push_back(f.get());
+			} else if (f.getError().code() == error_code_file_not_found) {
+				++missing;
+			} else {
+				throw f.getError();
+			}
+		}
+		if (missing == filenames.size()) {
+			throw file_not_found();
+		}
+		if (missing) {
+			TraceEvent(SevError, "AsyncFileStripedMissingStripes")
+			    .detail("Filename", filenames[0])
+			    .detail("Stripes", filenames.size())
+			    .detail("Missing", missing);
+			throw io_error();
+		}
+		return Reference<IAsyncFile>(new AsyncFileStriped(std::move(stripes), unitBytes));
+	}
+
+	void addref() override { ReferenceCounted<AsyncFileStriped>::addref(); }
+	void delref() override { ReferenceCounted<AsyncFileStriped>::delref(); }
+
+	StringRef getClassName() override { return "AsyncFileStriped"_sr; }
+
+	Future<int> read(void* data, int length, int64_t offset) override {
+		std::vector<Future<int>> reads;
+		std::vector<std::pair<int, int>> pieces;
+		forEachPiece(offset, length, [&](int stripe, int64_t stripeOffset, int dataOffset, int pieceLength) {
+			reads.push_back(stripes[stripe]->read((uint8_t*)data + dataOffset, pieceLength, stripeOffset));
+			pieces.emplace_back(dataOffset, pieceLength);
+		});
+		return readPieces(Reference<AsyncFileStriped>::addRef(this), (uint8_t*)data, offset, reads, pieces);
+	}
+
+	Future<Void> write(void const* data, int length, int64_t offset) override {
+		std::vector<Future<Void>> writes;
+		forEachPiece(offset, length, [&](int stripe, int64_t stripeOffset, int dataOffset, int pieceLength) {
+			writes.push_back(stripes[stripe]->write((const uint8_t*)data + dataOffset, pieceLength, stripeOffset));
+		});
+		return waitForAll(writes);
+	}
+
+	Future<Void> truncate(int64_t size) override {
+		const int64_t rowBytes = unitBytes * stripes.size();
+		std::vector<Future<Void>> truncates;
+		for (int i = 0; i < stripes.size(); i++) {
+			const int64_t partialRow = std::clamp<int64_t>(size % rowBytes - i * unitBytes, 0, unitBytes);
+			truncates.push_back(stripes[i]->truncate(size / rowBytes * unitBytes + partialRow));
+		}
+		return waitForAll(truncates);
+	}
+
+	Future<Void> sync() override {
+		std::vector<Future<Void>> syncs;
+		for (const auto& stripe : stripes) {
+			syncs.push_back(stripe->sync());
+		}
+		return waitForAll(syncs);
+	}
+
+	Future<Void> flush() override {
+		std::vector<Future<Void>> flushes;
+		for (const auto& stripe : stripes) {
+			flushes.push_back(stripe->flush());
+		}
+		return waitForAll(flushes);
+	}
+
+	Future<int64_t> size() const override {
+		std::vector<Future<int64_t>> sizes;
+		for (const auto& stripe : stripes) {
+			sizes.push_back(stripe->size());
+		}
+		return sizeFromStripes(sizes, unitBytes);
+	}
+
+	std::string getFilename() const override { return stripes[0]->getFilename(); }
+	int64_t debugFD() const override { return stripes[0]->debugFD(); }
+
+private:
+	std::vector<Reference<IAsyncFile>> stripes;
+	int64_t unitBytes;
+
+	// Calls f(stripe, stripeOffset, dataOffset, pieceLength) for each piece of [offset, offset + length) that lies in
+	// a single unit
+	template <class F>
+	void forEachPiece(int64_t offset, int length, F const& f) const {
+		int dataOffset = 0;
+		while (dataOffset < length) {
+			const int64_t unit = offset / unitBytes;
+			const int64_t unitOffset = offset % unitBytes;
+			const int pieceLength = std::min<int64_t>(length - dataOffset, unitBytes - unitOffset);
+			f(unit % stripes.size(), unit / stripes.size() * unitBytes + unitOffset, dataOffset, pieceLength);
+			offset += pieceLength;
+			dataOffset += pieceLength;
+		}
+	}
+
+	// Stripes end at different points, so a piece can be read short where the file has a hole. As for a single file,
+	// the hole reads as zeroes, and the read is only short if it goes past the end of the file.
+	ACTOR static Future<int> readPieces(Reference<AsyncFileStriped> self,
+	                                    uint8_t* data,
+	                                    int64_t offset,
+	                                    std::vector<Future<int>> reads,
+	                                    std::vector<std::pair<int, int>> pieces) {
+		wait(waitForAll(reads));
+		state int length = 0;
+		bool anyShort = false;
+		for (int i = 0; i < reads.size(); i++) {
+			length += pieces[i].second;
+			anyShort = anyShort || reads[i].get() < pieces[i].second;
+		}
+		if (!anyShort) {
+			return length;
+		}
+
+		int64_t size = wait(self->size());
+		const int bytes = std::clamp<int64_t>(size - offset, 0, length);
+		for (int i = 0; i < reads.size() && pieces[i].first < bytes; i++) {
+			const int readEnd = pieces[i].first + reads[i].get();
+			const int pieceEnd = std::min(pieces[i].first + pieces[i].second, bytes);
+			if (readEnd < pieceEnd) {
+				memset(data + readEnd, 0, pieceEnd - readEnd);
+			}
+		}
+		return bytes;
+	}
+
+	// The file ends after the last byte of whichever stripe holds the last unit
+	ACTOR static Future<int64_t> sizeFromStripes(std::vector<Future<int64_t>> sizes, int64_t unitBytes) {
+		wait(waitForAll(sizes));
+		int64_t size = 0;
+		for (int i = 0; i < sizes.size(); i++) {
+			const int64_t stripeSize = sizes[i].get();
+			if (stripeSize > 0) {
+				const int64_t last = stripeSize - 1;
+				size = std::max(size, (last / unitBytes * sizes.size() + i) * unitBytes + last % unitBytes + 1);
+			}
+		}
+		return size;
+	}
+};
+
 // DiskQueue uses two files to implement a dynamically resizable ring buffer, where files only allow append and read
 // operations.
 //    To increase the ring buffer size, it creates a ring buffer in the other file.
 //    After finish reading the current file, it switch to use the other file as the ring buffer.
 class RawDiskQueue_TwoFiles : public Tracked<RawDiskQueue_TwoFiles> {
 public:
-	RawDiskQueue_TwoFiles(std::string basename, std::string fileExtension, UID dbgid, int64_t fileSizeWarningLimit)
-	  : basename(basename), fileExtension(fileExtension), dbgid(dbgid), dbg_file0BeginSeq(0),
+	RawDiskQueue_TwoFiles(std::string basename,
+	                      std::string fileExtension,
+	                      UID dbgid,
+	                      int64_t fileSizeWarningLimit,
+	                      std::vector<std::string> stripeFolders)
+	  : basename(basename), fileExtension(fileExtension), requestedStripeFolders(stripeFolders),
+	    stripeUnitBytes(SERVER_KNOBS->DISK_QUEUE_STRIPE_UNIT_BYTES), dbgid(dbgid), dbg_file0BeginSeq(0),
 	    fileSizeWarningLimit(fileSizeWarningLimit), onError(delayed(error.getFuture())), onStopped(stopped.getFuture()),
 	    readyToPush(Void()), lastCommit(Void()), isFirstCommit(true), readingBuffer(dbgid), readingFile(-1),
-	    readingPage(-1), writingPos(-1), fileExtensionBytes(SERVER_KNOBS->DISK_QUEUE_FILE_EXTENSION_BYTES),
+	    readingPage(-1), readAheadFile(-1), readAheadPage(-1), writingPos(-1),
+	    fileExtensionBytes(SERVER_KNOBS->DISK_QUEUE_FILE_EXTENSION_BYTES),
 	    fileShrinkBytes(SERVER_KNOBS->DISK_QUEUE_FILE_SHRINK_BYTES) {
 		if (BUGGIFY)
 			fileExtensionBytes = _PAGE_SIZE * deterministicRandom()->randomSkewedUInt32(1, 10 << 10);
@@ -212,8 +395,8 @@ public:
 		    .detail("FileNum", file)
 		    .detail("PageNum", page)
 		    .detail("File0Name", files[0].dbgFilename);
-		readingFile = file;
-		readingPage = page;
+		readingFile = readAheadFile = file;
+		readingPage = readAheadPage = page;
 	}
 
 	Future<Void> setPoppedPage(int file, int64_t page, int64_t debugSeq) {
@@ -235,6 +418,18 @@ public:
 		int64_t total;
 
 		g_network->getDiskBytes(parentDirectory(basename), free, total);
+		if (!stripeFolders.empty()) {
+			// The queue fills its stripes evenly, so it can use as much of each device as the fullest one has free
+			for (const auto& folder : stripeFolders) {
+				int64_t stripeFree;
+				int64_t stripeTotal;
+				g_network->getDiskBytes(abspath(folder), stripeFree, stripeTotal);
+				free = std::min(free, stripeFree);
+				total = std::min(total, stripeTotal);
+			}
+			free *= stripeFolders.size() + 1;
+			total *= stripeFolders.size() + 1;
+		}
 
 		return StorageBytes(free,
 		                    total,
@@ -270,6 +465,28 @@ public:
 	std::string fileExtension;
 	std::string filename(int i) const { return basename + format("%d.%s", i, fileExtension.c_str()); }
 
+	// A queue can be striped across files in other folders, to spread its writes over several devices. Each of its two
+	// files is then an AsyncFileStriped: stripe 0 is filename(i), and stripe j > 0 has the same name followed by
+	// ".stripe<j>", in stripeFolders[j - 1]. The folders and unit of a striped queue are kept in stripesFilename(), so
+	// that the queue is always reopened the way it was created.
+	std::vector<std::string> requestedStripeFolders;
+	std::vector<std::string> stripeFolders;
+	int64_t stripeUnitBytes;
+	std::string stripesFilename() const { return basename + format("stripes.%s", fileExtension.c_str()); }
+	std::vector<std::string> stripeFilenames(std::string const& filename) const {
+		std::vector<std::string> filenames(1, filename);
+		for (int i = 0; i < stripeFolders.size(); i++) {
+			filenames.push_back(joinPath(stripeFolders[i], ::basename(filename) + format(".stripe%d", i + 1)));
+		}
+		return filenames;
+	}
+	Future<Reference<IAsyncFile>> openFile(std::string const& filename, int64_t flags, int64_t mode) const {
+		if (stripeFolders.empty()) {
+			return IAsyncFileSystem::filesystem()->open(filename, flags, mode);
+		}
+		return AsyncFileStriped::open(stripeFilenames(filename), stripeUnitBytes, flags, mode);
+	}
+
 	UID dbgid;
 	int64_t dbg_file0BeginSeq;
 	int64_t fileSizeWarningLimit;
@@ -286,6 +503,17 @@ public:
 	                 // files[readingFile]. readingFile = 2 if recovery is complete (all files have been read).
 	int64_t readingPage; // Page within readingFile that is the next page after readingBuffer
 
+	// Reads of the pages after readingBuffer, issued ahead so that recovery is not waiting on one read at a time
+	struct RecoveryRead {
+		int file;
+		int64_t page;
+		int pages;
+		Future<Standalone<StringRef>> data;
+	};
+	Deque<RecoveryRead> recoveryReads;
+	int readAheadFile; // Where the next of recoveryReads will start
+	int64_t readAheadPage;
+
 	int64_t writingPos; // Position within files[1] that will be next written
 
 	int64_t fileExtensionBytes;
@@ -309,16 +537,18 @@ public:
 	}
 
 #if defined(_WIN32)
-	ACTOR static Future<Reference<IAsyncFile>> replaceFile(Reference<IAsyncFile> toReplace) {
+	ACTOR static Future<Reference<IAsyncFile>> replaceFile(RawDiskQueue_TwoFiles* self,
+	                                                       Reference<IAsyncFile> toReplace) {
 		// Windows doesn't support a rename over an open file.
 		wait(toReplace->truncate(4 << 10));
 		return toReplace;
 	}
 #else
-	ACTOR static Future<Reference<IAsyncFile>> replaceFile(Reference<IAsyncFile> toReplace) {
+	ACTOR static Future<Reference<IAsyncFile>> replaceFile(RawDiskQueue_TwoFiles* self,
+	                                                       Reference<IAsyncFile> toReplace) {
 		incrementalTruncate(toReplace);
 
-		Reference<IAsyncFile> _replacement = wait(IAsyncFileSystem::filesystem()->open(
+		Reference<IAsyncFile> _replacement = wait(self->openFile(
 		    toReplace->getFilename(),
 		    IAsyncFile::OPEN_ATOMIC_WRITE_AND_CREATE | IAsyncFile::OPEN_CREATE | IAsyncFile::OPEN_READWRITE |
 		        IAsyncFile::OPEN_UNCACHED | IAsyncFile::OPEN_UNBUFFERED | IAsyncFile::OPEN_LOCK,
@@ -383,7 +613,7 @@ public:
 						    .detail("Filename", self->files[1].f->getFilename())
 						    .detail("OldFileSize", self->files[1].size)
 						    .detail("ElidedTruncateSize", maxShrink);
-						Reference<IAsyncFile> newFile = wait(replaceFile(self->files[1].f));
+						Reference<IAsyncFile> newFile = wait(replaceFile(self, self->files[1].f));
 						self->files[1].setFile(newFile);
 						waitfor.push_back(self->files[1].f->truncate(self->fileExtensionBytes));
 						self->files[1].size = self->fileExtensionBytes;
@@ -534,14 +764,59 @@ public:
 		return Void();
 	}
 
+	// Reads the stripes of a queue that was created striped, returning false if it was not
+	ACTOR static Future<bool> readStripes(RawDiskQueue_TwoFiles* self) {
+		state Reference<IAsyncFile> file;
+		try {
+			Reference<IAsyncFile> f = wait(IAsyncFileSystem::filesystem()->open(
+			    self->stripesFilename(), IAsyncFile::OPEN_READONLY | IAsyncFile::OPEN_UNCACHED, 0));
+			file = f;
+		} catch (Error& e) {
+			if (e.code() != error_code_file_not_found) {
+				throw;
+			}
+			return false;
+		}
+		state int64_t size = wait(file->size());
+		state Standalone<StringRef> data = makeString(size);
+		int bytesRead = wait(file->read(mutateString(data), size, 0));
+		if (bytesRead != size) {
+			throw io_error();
+		}
+		BinaryReader reader(data, IncludeVersion());
+		reader >> self->stripeUnitBytes >> self->stripeFolders;
+		return true;
+	}
+
+	ACTOR static Future<Void> writeStripes(RawDiskQueue_TwoFiles* self) {
+		state BinaryWriter writer(IncludeVersion());
+		writer << self->stripeUnitBytes << self->stripeFolders;
+		state Reference<IAsyncFile> file = wait(IAsyncFileSystem::filesystem()->open(
+		    self->stripesFilename(),
+		    IAsyncFile::OPEN_ATOMIC_WRITE_AND_CREATE | IAsyncFile::OPEN_CREATE | IAsyncFile::OPEN_READWRITE |
+		        IAsyncFile::OPEN_UNCACHED,
+		    0600));
+		wait(file->write(writer.getData(), writer.getLength(), 0));
+		wait(file->sync());
+		return Void();
+	}
+
 	ACTOR static Future<Void> openFiles(RawDiskQueue_TwoFiles* self) {
+		state bool striped = wait(readStripes(self));
+		if (striped && self->stripeFolders != self->requestedStripeFolders) {
+			TraceEvent(SevWarnAlways, "DiskQueueStripesChanged", self->dbgid)
+			    .detail("File0", self->filename(0))
+			    .detail("Stripes", describe(self->stripeFolders))
+			    .detail("RequestedStripes", describe(self->requestedStripeFolders));
+		}
+
 		state std::vector<Future<Reference<IAsyncFile>>> fs;
 		fs.reserve(2);
 		for (int i = 0; i < 2; i++)
-			fs.push_back(IAsyncFileSystem::filesystem()->open(self->filename(i),
-			                                                  IAsyncFile::OPEN_READWRITE | IAsyncFile::OPEN_UNCACHED |
-			                                                      IAsyncFile::OPEN_UNBUFFERED | IAsyncFile::OPEN_LOCK,
-			                                                  0));
+			fs.push_back(self->openFile(self->filename(i),
+			                            IAsyncFile::OPEN_READWRITE | IAsyncFile::OPEN_UNCACHED |
+			                                IAsyncFile::OPEN_UNBUFFERED | IAsyncFile::OPEN_LOCK,
+			                            0));
 		wait(waitForAllReady(fs));
 
 		// Treatment of errors here is important.  If only one of the two files is present
@@ -550,17 +825,30 @@ public:
 
 		if (!fs[0].isError() && !fs[1].isError()) {
 			// Both files were opened OK: success
+			if (!striped && !self->requestedStripeFolders.empty()) {
+				TraceEvent(SevWarnAlways, "DiskQueueNotStriped", self->dbgid)
+				    .detail("File0", self->filename(0))
+				    .detail("RequestedStripes", describe(self->requestedStripeFolders));
+			}
 		} else if (fs[0].isError() && fs[0].getError().code() == error_code_file_not_found && fs[1].isError() &&
 		           fs[1].getError().code() == error_code_file_not_found) {
 			// Neither file was found: we can create a new queue
 			// OPEN_ATOMIC_WRITE_AND_CREATE defers creation (using a .part file) until the calls to sync() below
-			TraceEvent("DiskQueueCreate").detail("File0", self->filename(0));
+			if (!striped && !self->requestedStripeFolders.empty()) {
+				// The stripes must be durable before any file is, so that a queue is never opened with the wrong ones
+				self->stripeFolders = self->requestedStripeFolders;
+				wait(writeStripes(self));
+			}
+			TraceEvent("DiskQueueCreate")
+			    .detail("File0", self->filename(0))
+			    .detail("Stripes", self->stripeFolders.size() + 1)
+			    .detail("StripeUnitBytes", self->stripeUnitBytes);
 			for (int i = 0; i < 2; i++)
-				fs[i] = IAsyncFileSystem::filesystem()->open(
-				    self->filename(i),
-				    IAsyncFile::OPEN_ATOMIC_WRITE_AND_CREATE | IAsyncFile::OPEN_CREATE | IAsyncFile::OPEN_READWRITE |
-				        IAsyncFile::OPEN_UNCACHED | IAsyncFile::OPEN_UNBUFFERED | IAsyncFile::OPEN_LOCK,
-				    0600);
+				fs[i] = self->openFile(self->filename(i),
+				                       IAsyncFile::OPEN_ATOMIC_WRITE_AND_CREATE | IAsyncFile::OPEN_CREATE |
+				                           IAsyncFile::OPEN_READWRITE | IAsyncFile::OPEN_UNCACHED |
+				                           IAsyncFile::OPEN_UNBUFFERED | IAsyncFile::OPEN_LOCK,
+				                       0600);
 
 			// Any error here is fatal
 			wait(waitForAll(fs));
@@ -607,8 +895,18 @@ public:
 				TraceEvent("DiskQueueShutdownDeleting", self->dbgid)
 				    .detail("File0", self->filename(0))
 				    .detail("File1", self->filename(1));
-				wait(IAsyncFileSystem::filesystem()->incrementalDeleteFile(self->filename(0), false));
-				wait(IAsyncFileSystem::filesystem()->incrementalDeleteFile(self->filename(1), true));
+				state std::vector<std::string> filenames = self->stripeFilenames(self->filename(0));
+				for (const auto& filename : self->stripeFilenames(self->filename(1))) {
+					filenames.push_back(filename);
+				}
+				state int fileIndex = 0;
+				for (fileIndex = 0; fileIndex < filenames.size(); fileIndex++) {
+					wait(IAsyncFileSystem::filesystem()->incrementalDeleteFile(filenames[fileIndex],
+					                                                           fileIndex + 1 == filenames.size()));
+				}
+				if (!self->stripeFolders.empty()) {
+					wait(IAsyncFileSystem::filesystem()->deleteFile(self->stripesFilename(), true));
+				}
 			}
 			TraceEvent("DiskQueueShutdownComplete", self->dbgid)
 			    .detail("DeleteFiles", deleteFiles)
@@ -758,31 +1056,41 @@ public:
 		return result;
 	}
 
-	Future<int> fillReadingBuffer() {
-		// If we're right at the end of a file...
-		if (readingPage * sizeof(Page) >= (size_t)files[readingFile].size) {
-			readingFile++;
-			readingPage = 0;
-			if (readingFile >= 2) {
-				// Recovery complete
-				readingBuffer.clear();
-				writingPos = files[1].size;
-				return 0;
+	// Keeps up to DISK_QUEUE_RECOVERY_READS reads of up to 1MB outstanding, until the end of files[1]
+	void readAhead() {
+		while (recoveryReads.size() < SERVER_KNOBS->DISK_QUEUE_RECOVERY_READS) {
+			if (readAheadPage * sizeof(Page) >= (size_t)files[readAheadFile].size) {
+				if (readAheadFile == 1) {
+					return;
+				}
+				readAheadFile++;
+				readAheadPage = 0;
+				continue;
 			}
-		}
 
-		// Read up to 1MB into readingBuffer
-		int len = std::min<int64_t>((files[readingFile].size / sizeof(Page) - readingPage) * sizeof(Page),
-		                            BUGGIFY_WITH_PROB(1.0) ? sizeof(Page) * deterministicRandom()->randomInt(1, 4)
-		                                                   : (1 << 20));
-		readingBuffer.clear();
-		readingBuffer.alignReserve(sizeof(Page), len);
-		void* p = readingBuffer.append(len);
+			int pages = std::min<int64_t>(files[readAheadFile].size / sizeof(Page) - readAheadPage,
+			                              BUGGIFY_WITH_PROB(1.0) ? deterministicRandom()->randomInt(1, 4)
+			                                                     : (1 << 20) / sizeof(Page));
+			recoveryReads.push_back(RecoveryRead{
+			    readAheadFile, readAheadPage, pages, readRecoveryPages(this, readAheadFile, readAheadPage, pages) });
+			readAheadPage += pages;
+		}
+	}
 
-		auto pos = readingPage * sizeof(Page);
-		readingPage += len / sizeof(Page);
+	// The read owns its buffer, so that a read which is no longer wanted can still finish safely
+	ACTOR static UNCANCELLABLE Future<Standalone<StringRef>> readRecoveryPages(RawDiskQueue_TwoFiles* self,
+	                                                                           int file,
+	                                                                           int64_t page,
+	                                                                           int pages) {
+		state TrackMe trackMe(self);
+		state Reference<IAsyncFile> f = self->files[file].f;
+		state StringBuffer buffer(self->dbgid);
+		buffer.alignReserve(sizeof(Page), pages * sizeof(Page));
+		void* p = buffer.append(pages * sizeof(Page));
 		ASSERT(int64_t(p) % sizeof(Page) == 0);
-		return files[readingFile].f->read(p, len, pos);
+		int bytesRead = wait(f->read(p, pages * sizeof(Page), page * sizeof(Page)));
+		ASSERT(bytesRead == pages * sizeof(Page));
+		return buffer.get();
 	}
 
 	ACTOR static UNCANCELLABLE Future<Standalone<StringRef>> readNextPage(RawDiskQueue_TwoFiles* self) {
@@ -793,20 +1101,27 @@ public:
 			ASSERT(self->files[0].f && self->files[1].f);
 
 			if (!self->readingBuffer.size()) {
-				state Future<Void> f = Void();
-				// if (BUGGIFY) f = delay( deterministicRandom()->random01() * 0.1 );
+				self->readAhead();
+				if (self->recoveryReads.empty()) {
+					// Recovery complete
+					self->readingFile = 2;
+					self->writingPos = self->files[1].size;
+					return Standalone<StringRef>();
+				}
 
-				int read = wait(self->fillReadingBuffer());
-				ASSERT(read == self->readingBuffer.size());
+				state RecoveryRead next = self->recoveryReads.front();
+				self->recoveryReads.pop_front();
+				self->readAhead();
 
-				wait(f);
+				Standalone<StringRef> data = wait(next.data);
+				self->readingBuffer.set(data);
+				self->readingFile = next.file;
+				self->readingPage = next.page + next.pages;
 			}
-			if (!self->readingBuffer.size())
-				return Standalone<StringRef>();
 
 			ASSERT(self->readingBuffer.size() >= sizeof(Page));
-			Standalone<StringRef> result = self->readingBuffer.pop_front(sizeof(Page));
-			return result;
+			StringRef page = self->readingBuffer.pop_front(sizeof(Page));
+			return Standalone<StringRef>(page, self->readingBuffer.str.arena());
 		} catch (Error& e) {
 			CODE_PROBE(true, "Read next page error");
 			TraceEvent(SevError, "RDQReadNextPageError", self->dbgid)
@@ -850,6 +1165,14 @@ public:
 			self->readingBuffer.clear();
 			self->writingPos = pos;
 
+			// Reads issued past the invalid page are not needed, but they must not overlap the truncation
+			state std::vector<Future<Standalone<StringRef>>> unneededReads;
+			for (auto& read : self->recoveryReads) {
+				unneededReads.push_back(read.data);
+			}
+			self->recoveryReads.clear();
+			wait(waitForAllReady(unneededReads));
+
 			while (file < 2) {
 				commits.push_back(self->truncateFile(self, file, pos));
 				file++;
@@ -882,8 +1205,10 @@ public:
 	          std::string fileExtension,
 	          UID dbgid,
 	          DiskQueueVersion diskQueueVersion,
-	          int64_t fileSizeWarningLimit)
-	  : rawQueue(new RawDiskQueue_TwoFiles(basename, fileExtension, dbgid, fileSizeWarningLimit)), dbgid(dbgid),
+	          int64_t fileSizeWarningLimit,
+	          std::vector<std::string> stripeFolders)
+	  : rawQueue(new RawDiskQueue_TwoFiles(basename, fileExtension, dbgid, fileSizeWarningLimit, stripeFolders)),
+	    dbgid(dbgid),
 	    diskQueueVersion(diskQueueVersion), anyPopped(false), warnAlwaysForMemory(true), nextPageSeq(0), poppedSeq(0),
 	    lastPoppedSeq(0), lastCommittedSeq(0), pushed_page_buffer(nullptr), recovered(false), initialized(false),
 	    nextReadLocation(-1), readBufPage(nullptr), readBufPos(0) {}
@@ -896,6 +1221,17 @@ public:
 
 		bool pushAtEndOfPage = contents.size() >= 4 && pushedPageCount() && backPage().remainingCapacity() < 4;
 		CODE_PROBE(pushAtEndOfPage, "Push right at the end of a page, possibly splitting size");
+
+		// Reserve all the pages contents needs at once, so that a large push does not regrow (and copy) the pages
+		// already pushed several times over
+		const int available = pushedPageCount() ? backPage().remainingCapacity() : 0;
+		if (contents.size() > available) {
+			const int newPages = (contents.size() - available + Page::maxPayload - 1) / Page::maxPayload;
+			if (!pushed_page_buffer)
+				pushed_page_buffer = new StringBuffer(dbgid);
+			pushed_page_buffer->alignReserve(sizeof(Page), pushed_page_buffer->size() + newPages * sizeof(Page));
+		}
+
 		while (begin != end) {
 			if (!pushedPageCount() || !backPage().remainingCapacity())
 				addEmptyPage();
@@ -1138,8 +1474,10 @@ private:
 
 		ASSERT(nextPageSeq % sizeof(Page) == 0);
 
+		// Only the header needs clearing: push() fills the payload of every page but the last, and commit() zero pads
+		// that one
 		auto& p = backPage();
-		memset(static_cast<void*>(&p), 0, sizeof(Page)); // FIXME: unnecessary?
+		memset(static_cast<void*>(&p), 0, sizeof(PageHeader));
 		p.magic = 0xFDB;
 		switch (diskQueueVersion) {
 		case DiskQueueVersion::V0:
@@ -1573,9 +1911,10 @@ public:
 	                         std::string fileExtension,
 	                         UID dbgid,
 	                         DiskQueueVersion diskQueueVersion,
-	                         int64_t fileSizeWarningLimit)
-	  : queue(new DiskQueue(basename, fileExtension, dbgid, diskQueueVersion, fileSizeWarningLimit)), pushed(0),
-	    popped(0), committed(0){};
+	                         int64_t fileSizeWarningLimit,
+	                         std::vector<std::string> stripeFolders)
+	  : queue(new DiskQueue(basename, fileExtension, dbgid, diskQueueVersion, fileSizeWarningLimit, stripeFolders)),
+	    pushed(0), popped(0), committed(0){};
 
 	// IClosable
 	Future<Void> getError() const override { return queue->getError(); }
@@ -1663,8 +2002,9 @@ IDiskQueue* openDiskQueue(std::string basename,
                           std::string ext,
                           UID dbgid,
                           DiskQueueVersion dqv,
-                          int64_t fileSizeWarningLimit) {
-	return new DiskQueue_PopUncommitted(basename, ext, dbgid, dqv, fileSizeWarningLimit);
+                          int64_t fileSizeWarningLimit,
+                          std::vector<std::string> stripeFolders) {
+	return new DiskQueue_PopUncommitted(basename, ext, dbgid, dqv, fileSizeWarningLimit, stripeFolders);
 }
 
 TEST_CASE("performance/fdbserver/DiskQueue") {
@@ -1706,3 +2046,176 @@ TEST_CASE("performance/fdbserver/DiskQueue") {
 	wait(queue->onClosed());
 	return Void();
 }
+
+TEST_CASE("/fdbserver/DiskQueue/StripedFile") {
+	state int stripeCount = deterministicRandom()->randomInt(1, 5);
+	state int64_t unitBytes = _PAGE_SIZE * deterministicRandom()->randomInt(1, 5);
+	state std::string basename = "test-striped-" + deterministicRandom()->randomUniqueID().toString();
+	state std::vector<std::string> filenames;
+	for (int i = 0; i < stripeCount; i++) {
+		filenames.push_back(basename + format(".stripe%d", i));
+	}
+	state int64_t flags = IAsyncFile::OPEN_READWRITE | IAsyncFile::OPEN_UNCACHED | IAsyncFile::OPEN_UNBUFFERED |
+	                      IAsyncFile::OPEN_LOCK;
+	state Reference<IAsyncFile> file = wait(AsyncFileStriped::open(
+	    filenames, unitBytes, flags | IAsyncFile::OPEN_ATOMIC_WRITE_AND_CREATE | IAsyncFile::OPEN_CREATE, 0600));
+
+	// Write runs of pages at random offsets, keeping what the file should hold in expected
+	state int pages = 64;
+	state Arena arena;
+	state uint8_t* expected = (uint8_t*)arena.allocate4kAlignedBuffer(pages * _PAGE_SIZE);
+	state uint8_t* buffer = (uint8_t*)arena.allocate4kAlignedBuffer(pages * _PAGE_SIZE);
+	state int64_t size = 0;
+	state int i = 0;
+	memset(expected, 0, pages * _PAGE_SIZE);
+	for (i = 0; i < 20; i++) {
+		int first = deterministicRandom()->randomInt(0, pages);
+		int count = deterministicRandom()->randomInt(1, pages - first + 1);
+		deterministicRandom()->randomBytes(expected + first * _PAGE_SIZE, count * _PAGE_SIZE);
+		size = std::max<int64_t>(size, (first + count) * _PAGE_SIZE);
+		wait(file->write(expected + first * _PAGE_SIZE, count * _PAGE_SIZE, first * _PAGE_SIZE));
+	}
+	wait(file->sync());
+	int64_t fileSize = wait(file->size());
+	ASSERT_EQ(fileSize, size);
+
+	for (i = 0; i < 20; i++) {
+		state int readFirst = deterministicRandom()->randomInt(0, pages);
+		state int readCount = deterministicRandom()->randomInt(1, pages - readFirst + 1);
+		int bytesRead = wait(file->read(buffer, readCount * _PAGE_SIZE, readFirst * _PAGE_SIZE));
+		ASSERT_EQ(bytesRead, std::clamp<int64_t>(size - readFirst * _PAGE_SIZE, 0, readCount * _PAGE_SIZE));
+		ASSERT(memcmp(buffer, expected + readFirst * _PAGE_SIZE, bytesRead) == 0);
+	}
+
+	state int64_t truncatedSize = _PAGE_SIZE * deterministicRandom()->randomInt(0, pages + 1);
+	wait(file->truncate(truncatedSize));
+	int64_t truncatedFileSize = wait(file->size());
+	ASSERT_EQ(truncatedFileSize, truncatedSize);
+	file = Reference<IAsyncFile>();
+
+	// A file missing only some of its stripes must not look like one that was never created
+	if (stripeCount > 1) {
+		wait(IAsyncFileSystem::filesystem()->deleteFile(filenames.back(), true));
+		filenames.pop_back();
+		try {
+			wait(success(AsyncFileStriped::open(filenames, unitBytes, flags, 0)));
+			ASSERT(false);
+		} catch (Error& e) {
+			ASSERT_EQ(e.code(), error_code_io_error);
+		}
+	}
+	for (i = 0; i < filenames.size(); i++) {
+		wait(IAsyncFileSystem::filesystem()->deleteFile(filenames[i], true));
+	}
+	try {
+		wait(success(AsyncFileStriped::open(filenames, unitBytes, flags, 0)));
+		ASSERT(false);
+	} catch (Error& e) {
+		ASSERT_EQ(e.code(), error_code_file_not_found);
+	}
+	return Void();
+}
+
+// A striped queue keeps what was pushed to it across a reopen that does not ask for stripes, and removes all of its
+// files when disposed
+TEST_CASE("/fdbserver/DiskQueue/Striped") {
+	state std::string basename = "test-striped-" + deterministicRandom()->randomUniqueID().toString() + "-";
+	state UID dbgid = deterministicRandom()->randomUniqueID();
+	state std::vector<std::string> stripeFolders(deterministicRandom()->randomInt(1, 4), ".");
+	state IDiskQueue* queue = openDiskQueue(basename, "fdq", dbgid, DiskQueueVersion::V2, -1, stripeFolders);
+	state std::string pushed;
+	state int i = 0;
+	bool fullyRecovered = wait(queue->initializeRecovery(0));
+	if (!fullyRecovered) {
+		Standalone<StringRef> initial = wait(queue->readNext(1e6));
+		ASSERT_EQ(initial.size(), 0);
+	}
+	for (i = 0; i < 20; i++) {
+		std::string contents = deterministicRandom()->randomAlphaNumeric(deterministicRandom()->randomInt(1, 100000));
+		queue->push(StringRef(contents));
+		pushed += contents;
+		wait(queue->commit());
+	}
+	state Future<Void> closed = queue->onClosed();
+	queue->close();
+	wait(closed);
+	ASSERT(fileExists(basename + "stripes.fdq"));
+
+	queue = openDiskQueue(basename, "fdq", dbgid, DiskQueueVersion::V2);
+	state std::string recovered;
+	bool reopenedFullyRecovered = wait(queue->initializeRecovery(0));
+	if (!reopenedFullyRecovered) {
+		loop {
+			Standalone<StringRef> bytes = wait(queue->readNext(1e6));
+			recovered += bytes.toString();
+			if (bytes.size() < 1e6) {
+				break;
+			}
+		}
+	}
+	ASSERT(recovered == pushed);
+	closed = queue->onClosed();
+	queue->dispose();
+	wait(closed);
+	ASSERT(!fileExists(basename + "0.fdq") && !fileExists(basename + "0.fdq.stripe1"));
+	ASSERT(!fileExists(basename + "stripes.fdq"));
+	return Void();
+}
+
+// What a DiskQueueWriter pushes is what pushing the same items serialized by a BinaryWriter would have
+TEST_CASE("/fdbserver/DiskQueue/Writer") {
+	state std::string basename = "test-writer-" + deterministicRandom()->randomUniqueID().toString() + "-";
+	state UID dbgid = deterministicRandom()->randomUniqueID();
+	state IDiskQueue* queue = openDiskQueue(basename, "fdq", dbgid, DiskQueueVersion::V2);
+	state std::string expected;
+	state int i = 0;
+	bool fullyRecovered = wait(queue->initializeRecovery(0));
+	if (!fullyRecovered) {
+		Standalone<StringRef> initial = wait(queue->readNext(1e6));
+		ASSERT_EQ(initial.size(), 0);
+	}
+	for (i = 0; i < 50; i++) {
+		std::string message = deterministicRandom()->randomAlphaNumeric(
+		    deterministicRandom()->coinflip() ? deterministicRandom()->randomInt(0, DiskQueueWriter::kBufferBytes * 2)
+		                                      : deterministicRandom()->randomInt(0, 50000));
+		int64_t version = deterministicRandom()->randomInt64(0, std::numeric_limits<int64_t>::max());
+		UID id = deterministicRandom()->randomUniqueID();
+
+		BinaryWriter bw(IncludeVersion());
+		bw << version << StringRef(message) << id << uint8_t(1);
+		expected += bw.toValue().toString();
+
+		const IDiskQueue::location start = queue->getNextPushLocation();
+		DiskQueueWriter wr(queue, IncludeVersion());
+		wr << version << StringRef(message) << id << uint8_t(1);
+		const IDiskQueue::location end = wr.finish();
+		ASSERT_EQ(wr.getLength(), bw.getLength());
+		ASSERT(end == queue->getNextPushLocation());
+		ASSERT(start < end);
+		if (deterministicRandom()->coinflip()) {
+			wait(queue->commit());
+		}
+	}
+	wait(queue->commit());
+	state Future<Void> closed = queue->onClosed();
+	queue->close();
+	wait(closed);
+
+	queue = openDiskQueue(basename, "fdq", dbgid, DiskQueueVersion::V2);
+	state std::string recovered;
+	bool reopenedFullyRecovered = wait(queue->initializeRecovery(0));
+	if (!reopenedFullyRecovered) {
+		loop {
+			Standalone<StringRef> bytes = wait(queue->readNext(1e6));
+			recovered += bytes.toString();
+			if (bytes.size() < 1e6) {
+				break;
+			}
+		}
+	}
+	ASSERT(recovered == expected);
+	closed = queue->onClosed();
+	queue->dispose();
+	wait(closed);
+	return Void();
+}
@@ -228,6 +228,8 @@ public:
 	EncryptBaseDomainIdCache baseCipherDomainIdCache;
 	EncryptBaseCipherDomainIdKeyIdCache baseCipherDomainIdKeyIdCache;
 	BlobMetadataDomainIdCache blobMetadataDomainIdCache;
+	// KMS lookups of the latest cipher keys in flight, by domain, which concurrent requests for the domain wait on
+	std::unordered_map<EncryptCipherDomainId, Future<Void>> latestKeyLookups;
 
 	std::unique_ptr<KmsConnector> kmsConnector;
 
@@ -240,6 +242,7 @@ public:
 	Counter baseCipherKeyIdCacheHits;
 	Counter baseCipherDomainIdCacheMisses;
 	Counter baseCipherDomainIdCacheHits;
+	Counter baseCipherDomainIdLookupsCoalesced;
 	Counter baseCipherKeysRefreshed;
 	Counter numResponseWithErrors;
 	Counter numEncryptionKeyRefreshErrors;
@@ -260,6 +263,7 @@ public:
 	    baseCipherKeyIdCacheHits("EKPCipherIdCacheHits", ekpCacheMetrics),
 	    baseCipherDomainIdCacheMisses("EKPCipherDomainIdCacheMisses", ekpCacheMetrics),
 	    baseCipherDomainIdCacheHits("EKPCipherDomainIdCacheHits", ekpCacheMetrics),
+	    baseCipherDomainIdLookupsCoalesced("EKPCipherDomainIdLookupsCoalesced", ekpCacheMetrics),
 	    baseCipherKeysRefreshed("EKPCipherKeysRefreshed", ekpCacheMetrics),
 	    numResponseWithErrors("EKPNumResponseWithErrors", ekpCacheMetrics),
 	    numEncryptionKeyRefreshErrors("EKPNumEncryptionKeyRefreshErrors", ekpCacheMetrics),
@@ -600,17 +604,34 @@ ACTOR Future<Void> getLatestCipherKeys(Reference<EncryptKeyProxyData> ekpProxyDa
 	state std::unordered_set<EncryptCipherDomainId> lookupCipherDomainIds =
 	    getLookupDetailsLatest(ekpProxyData, dbgTrace, latestCipherReply, numHits, dedupedDomainIds);
 	if (!lookupCipherDomainIds.empty()) {
+		// Domains with a KMS lookup already in flight, such as after a key rotation when every role asks for the new
+		// keys at once, join that lookup instead of issuing their own.
+		state std::vector<EncryptCipherDomainId> coalescedDomainIds;
+		state std::vector<Future<Void>> coalescedLookups;
+		state Promise<Void> lookupDone;
 		try {
 			KmsConnLookupEKsByDomainIdsReq keysByDomainIdReq;
 			for (const auto domainId : lookupCipherDomainIds) {
-				keysByDomainIdReq.encryptDomainIds.emplace_back(domainId);
+				auto itr = ekpProxyData->latestKeyLookups.find(domainId);
+				if (itr != ekpProxyData->latestKeyLookups.end() && !itr->second.isReady()) {
+					coalescedDomainIds.push_back(domainId);
+					coalescedLookups.push_back(itr->second);
+				} else {
+					keysByDomainIdReq.encryptDomainIds.emplace_back(domainId);
+					ekpProxyData->latestKeyLookups[domainId] = lookupDone.getFuture();
+				}
 			}
 			keysByDomainIdReq.debugId = latestKeysReq.debugId;
-
-			state double startTime = now();
-			KmsConnLookupEKsByDomainIdsRep keysByDomainIdRep =
-			    wait(kmsConnectorInf.ekLookupByDomainIds.getReply(keysByDomainIdReq));
-			ekpProxyData->kmsLookupByDomainIdsReqLatency.addMeasurement(now() - startTime);
+			ekpProxyData->baseCipherDomainIdLookupsCoalesced += coalescedDomainIds.size();
+
+			state KmsConnLookupEKsByDomainIdsRep keysByDomainIdRep;
+			if (!keysByDomainIdReq.encryptDomainIds.empty()) {
+				state double startTime = now();
+				KmsConnLookupEKsByDomainIdsRep rep =
+				    wait(kmsConnectorInf.ekLookupByDomainIds.getReply(keysByDomainIdReq));
+				keysByDomainIdRep = rep;
+				ekpProxyData->kmsLookupByDomainIdsReqLatency.addMeasurement(now() - startTime);
+			}
 
 			for (auto& item : keysByDomainIdRep.cipherKeyDetails) {
 				CipherKeyValidityTS validityTS = getCipherKeyValidityTS(item.refreshAfterSec, item.expireAfterSec);
@@ -649,7 +670,28 @@ ACTOR Future<Void> getLatestCipherKeys(Reference<EncryptKeyProxyData> ekpProxyDa
 			if (keysByDomainIdRep.cipherKeyDetails.size() > 0) {
 				ekpProxyData->setKMSHealthiness(true);
 			}
+			lookupDone.send(Void());
+
+			// The lookups joined put their keys in the cache, or fail this request with their error
+			wait(waitForAll(coalescedLookups));
+			for (const auto domainId : coalescedDomainIds) {
+				const auto itr = ekpProxyData->baseCipherDomainIdCache.find(domainId);
+				if (itr == ekpProxyData->baseCipherDomainIdCache.end() || itr->second.isExpired()) {
+					TraceEvent(SevWarn, "GetLatestCipherKeysCoalescedLookupMissing", ekpProxyData->myId)
+					    .detail("DomainId", domainId);
+					throw encrypt_keys_fetch_failed();
+				}
+				latestCipherReply.baseCipherDetails.emplace_back(domainId,
+				                                                 itr->second.baseCipherId,
+				                                                 itr->second.baseCipherKey,
+				                                                 itr->second.baseCipherKCV,
+				                                                 itr->second.refreshAt,
+				                                                 itr->second.expireAt);
+			}
 		} catch (Error& e) {
+			if (lookupDone.canBeSet()) {
+				lookupDone.sendError(canReplyWith(e) ? e : encrypt_keys_fetch_failed());
+			}
 			if (isKmsConnectionError(e)) {
 				ekpProxyData->setKMSHealthiness(false);
 			}
@@ -50,6 +50,9 @@ struct GrvProxyStats {
 	Counter txnTagThrottlerIn, txnTagThrottlerOut;
 	Counter txnThrottled;
 	Counter updatesFromRatekeeper, leaseTimeouts;
+	Counter txnStartCached; // Started with a cached read version, see GRV_PROXY_CAUSAL_READ_RISKY_CACHE_AGE
+	// Started after waiting in queue longer than their priority's START_TRANSACTION_*_LATENCY_TARGET
+	Counter txnDefaultPriorityStartLate, txnBatchPriorityStartLate;
 	int systemGRVQueueSize, defaultGRVQueueSize, batchGRVQueueSize;
 	int tagThrottlerGRVQueueSize;
 	double transactionRateAllowed, batchTransactionRateAllowed;
@@ -70,6 +73,7 @@ struct GrvProxyStats {
 	LatencyBands grvLatencyBands;
 	LatencySample grvLatencySample; // GRV latency metric sample of default priority
 	LatencySample grvBatchLatencySample; // GRV latency metric sample of batched priority
+	LatencySample cachedReadVersionAge; // How long before being handed out cached read versions were asked for
 
 	Future<Void> logger;
 
@@ -131,7 +135,9 @@ struct GrvProxyStats {
 	    txnDefaultPriorityStartIn("TxnDefaultPriorityStartIn", cc),
 	    txnDefaultPriorityStartOut("TxnDefaultPriorityStartOut", cc), txnTagThrottlerIn("TxnTagThrottlerIn", cc),
 	    txnTagThrottlerOut("TxnTagThrottlerOut", cc), txnThrottled("TxnThrottled", cc),
-	    updatesFromRatekeeper("UpdatesFromRatekeeper", cc), leaseTimeouts("LeaseTimeouts", cc), systemGRVQueueSize(0),
+	    updatesFromRatekeeper("UpdatesFromRatekeeper", cc), leaseTimeouts("LeaseTimeouts", cc),
+	    txnStartCached("TxnStartCached", cc), txnDefaultPriorityStartLate("TxnDefaultPriorityStartLate", cc),
+	    txnBatchPriorityStartLate("TxnBatchPriorityStartLate", cc), systemGRVQueueSize(0),
 	    defaultGRVQueueSize(0), batchGRVQueueSize(0), tagThrottlerGRVQueueSize(0), transactionRateAllowed(0),
 	    batchTransactionRateAllowed(0), transactionLimit(0), batchTransactionLimit(0),
 	    percentageOfDefaultGRVQueueProcessed(0), percentageOfBatchGRVQueueProcessed(0), lastBatchQueueThrottled(false),
@@ -153,6 +159,10 @@ struct GrvProxyStats {
 	                          id,
 	                          SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
 	                          SERVER_KNOBS->LATENCY_SKETCH_ACCURACY),
+	    cachedReadVersionAge("CachedReadVersionAge",
+	                         id,
+	                         SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
+	                         SERVER_KNOBS->LATENCY_SKETCH_ACCURACY),
 	    recentRequests(0), lastBucketBegin(now()),
 	    bucketInterval(FLOW_KNOBS->BASIC_LOAD_BALANCE_UPDATE_RATE / FLOW_KNOBS->BASIC_LOAD_BALANCE_BUCKETS),
 	    grvConfirmEpochLiveDist(
@@ -200,6 +210,9 @@ struct GrvProxyData {
 	double lastStartCommit;
 	double lastCommitLatency;
 	LatencySample* versionVectorSizeOnGRVReply = nullptr;
+	// Seconds spent taking the delta of ssVersionVectorCache for a GRV reply, and applying the delta from the master
+	LatencySample* versionVectorLatencyOnGRVReply = nullptr;
+	LatencySample* versionVectorApplyLatency = nullptr;
 	int updateCommitRequests;
 	NotifiedDouble lastCommitTime;
 
@@ -211,6 +224,10 @@ struct GrvProxyData {
 	// Cache of the latest commit versions of storage servers.
 	VersionVector ssVersionVectorCache;
 
+	// The reply to the most recently sent getLiveCommittedVersion request, and when it was sent
+	Optional<GetReadVersionReply> lastLiveCommittedReply;
+	double lastLiveCommittedRequestTime = 0;
+
 	void updateLatencyBandConfig(Optional<LatencyBandConfig> newLatencyBandConfig) {
 		if (newLatencyBandConfig.present() != latencyBandConfig.present() ||
 		    (newLatencyBandConfig.present() &&
@@ -242,6 +259,15 @@ struct GrvProxyData {
 			                                                dbgid,
 			                                                SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
 			                                                SERVER_KNOBS->LATENCY_SKETCH_ACCURACY);
+			versionVectorLatencyOnGRVReply = new LatencySample("VersionVectorLatencyOnGRVReply",
+			                                                   dbgid,
+			                                                   SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
+			                                                   SERVER_KNOBS->LATENCY_SKETCH_ACCURACY);
+			versionVectorApplyLatency = new LatencySample("VersionVectorApplyLatency",
+			                                              dbgid,
+			                                              SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
+			                                              SERVER_KNOBS->LATENCY_SKETCH_ACCURACY);
+			ssVersionVectorCache.trackChanges();
 		}
 	}
 };
@@ -684,7 +710,9 @@ ACTOR Future<GetReadVersionReply> getLiveCommittedVersion(std::vector<SpanContex
 	    std::max(grvProxyData->minKnownCommittedVersion, repFromMaster.minKnownCommittedVersion);
 	if (SERVER_KNOBS->ENABLE_VERSION_VECTOR) {
 		// TODO add to "status json"
+		double applyStart = timer_monotonic();
 		grvProxyData->ssVersionVectorCache.applyDelta(repFromMaster.ssVersionVectorDelta);
+		grvProxyData->versionVectorApplyLatency->addMeasurement(timer_monotonic() - applyStart);
 	}
 	grvProxyData->stats.grvGetCommittedVersionRpcDist->sampleSeconds(now() - grvConfirmEpochLive);
 	GetReadVersionReply rep;
@@ -709,9 +737,39 @@ ACTOR Future<GetReadVersionReply> getLiveCommittedVersion(std::vector<SpanContex
 	grvProxyData->stats.txnDefaultPriorityStartOut += defaultPriTransactionCount;
 	grvProxyData->stats.txnBatchPriorityStartOut += batchPriTransactionCount;
 
+	if (grvStart >= grvProxyData->lastLiveCommittedRequestTime) {
+		grvProxyData->lastLiveCommittedReply = rep;
+		grvProxyData->lastLiveCommittedRequestTime = grvStart;
+	}
+
 	return rep;
 }
 
+// Whether causal-read-risky transactions can be started with the last reply from the master, instead of asking again.
+// Not with version vectors, whose deltas are computed from the latest storage server versions and not the reply's.
+bool canUseCachedReadVersion(GrvProxyData* grvProxyData) {
+	return SERVER_KNOBS->GRV_PROXY_CAUSAL_READ_RISKY_CACHE_AGE > 0 && !SERVER_KNOBS->ENABLE_VERSION_VECTOR &&
+	       grvProxyData->lastLiveCommittedReply.present() &&
+	       now() - grvProxyData->lastLiveCommittedRequestTime <= SERVER_KNOBS->GRV_PROXY_CAUSAL_READ_RISKY_CACHE_AGE;
+}
+
+// The counterpart of getLiveCommittedVersion when canUseCachedReadVersion()
+GetReadVersionReply getCachedReadVersion(GrvProxyData* grvProxyData,
+                                         int transactionCount,
+                                         int systemTransactionCount,
+                                         int defaultPriTransactionCount,
+                                         int batchPriTransactionCount) {
+	grvProxyData->stats.txnStartCached += transactionCount;
+	grvProxyData->stats.cachedReadVersionAge.addMeasurement(now() - grvProxyData->lastLiveCommittedRequestTime);
+
+	grvProxyData->stats.txnStartOut += transactionCount;
+	grvProxyData->stats.txnSystemPriorityStartOut += systemTransactionCount;
+	grvProxyData->stats.txnDefaultPriorityStartOut += defaultPriTransactionCount;
+	grvProxyData->stats.txnBatchPriorityStartOut += batchPriTransactionCount;
+
+	return grvProxyData->lastLiveCommittedReply.get();
+}
+
 // Returns the current read version (or minimum known committed version if requested),
 // to each request in the provided list. Also check if the request should be throttled.
 // Update GRV statistics according to the request's priority.
@@ -741,6 +799,13 @@ ACTOR Future<Void> sendGrvReplies(Future<GetReadVersionReply> replyFuture,
 			stats->grvLatencyBands.addMeasurement(duration);
 		}
 
+		// Covers the time the request spent queued at the proxy as well as getting the version, which
+		// GP:getLiveCommittedVersion alone doesn't show
+		if (request.spanContext.isSampled() || isSlowSpan(request.spanContext, duration)) {
+			Span span("GP:getReadVersion"_loc, request.spanContext);
+			span.begin = g_network->now() - duration;
+		}
+
 		if (request.flags & GetReadVersionRequest::FLAG_USE_MIN_KNOWN_COMMITTED_VERSION) {
 			// Only backup worker may infrequently use this flag.
 			reply.version = minKnownCommittedVersion;
@@ -750,7 +815,9 @@ ACTOR Future<Void> sendGrvReplies(Future<GetReadVersionReply> replyFuture,
 		reply.midShardSize = midShardSize;
 		reply.tagThrottleInfo.clear();
 		if (SERVER_KNOBS->ENABLE_VERSION_VECTOR) {
+			double deltaStart = timer_monotonic();
 			grvProxyData->ssVersionVectorCache.getDelta(request.maxVersion, reply.ssVersionVectorDelta);
+			grvProxyData->versionVectorLatencyOnGRVReply->addMeasurement(timer_monotonic() - deltaStart);
 			grvProxyData->versionVectorSizeOnGRVReply->addMeasurement(reply.ssVersionVectorDelta.size());
 		}
 		reply.proxyId = grvProxyData->dbgid;
@@ -845,6 +912,25 @@ ACTOR Future<Void> monitorDDMetricsChanges(int64_t* midShardSize, Reference<Asyn
 	}
 }
 
+// Whether a request has waited in the GRV queue longer than target, if its priority has one
+static bool isLate(GetReadVersionRequest const& req, double currentTime, double target) {
+	return target > 0 && currentTime - req.requestTime() > target;
+}
+
+// Default priority requests are normally started before any batch priority ones. With
+// START_TRANSACTION_BATCH_LATENCY_TARGET set, each priority's requests have a deadline of their arrival plus their
+// priority's latency target, and the batch priority request at the front of its queue goes first if its deadline is
+// the earlier one. This keeps batch priority work from starving under a steady default priority load, while default
+// priority requests still go first until batch ones have waited the difference between the targets.
+static bool batchRequestOverdue(GetReadVersionRequest const& defaultReq,
+                                Deque<GetReadVersionRequest> const& batchQueue) {
+	if (SERVER_KNOBS->START_TRANSACTION_BATCH_LATENCY_TARGET <= 0 || batchQueue.empty()) {
+		return false;
+	}
+	return batchQueue.front().requestTime() + SERVER_KNOBS->START_TRANSACTION_BATCH_LATENCY_TARGET <
+	       defaultReq.requestTime() + SERVER_KNOBS->START_TRANSACTION_DEFAULT_LATENCY_TARGET;
+}
+
 ACTOR static Future<Void> transactionStarter(GrvProxyInterface proxy,
                                              Reference<AsyncVar<ServerDBInfo> const> db,
                                              PromiseStream<Future<Void>> addActor,
@@ -950,6 +1036,13 @@ ACTOR static Future<Void> transactionStarter(GrvProxyInterface proxy,
 			Deque<GetReadVersionRequest>* transactionQueue;
 			if (!systemQueue.empty()) {
 				transactionQueue = &systemQueue;
+			} else if (!defaultQueue.empty() && batchRequestOverdue(defaultQueue.front(), batchQueue) &&
+			           batchRateInfo.canStart(transactionsStarted[0] + transactionsStarted[1],
+			                                  batchQueue.front().transactionCount)) {
+				// Within the batch rate, a batch priority request that has waited past its target goes ahead of
+				// default priority requests that are still further from theirs
+				CODE_PROBE(true, "GRV proxy starts an overdue batch priority request ahead of default priority ones");
+				transactionQueue = &batchQueue;
 			} else if (!defaultQueue.empty()) {
 				transactionQueue = &defaultQueue;
 			} else if (!batchQueue.empty()) {
@@ -983,10 +1076,16 @@ ACTOR static Future<Void> transactionStarter(GrvProxyInterface proxy,
 			} else if (req.priority >= TransactionPriority::DEFAULT) {
 				defaultPriTransactionsStarted[req.flags & 1] += tc;
 				grvProxyData->stats.defaultTxnGRVTimeInQueue.addMeasurement(currentTime - req.requestTime());
+				if (isLate(req, currentTime, SERVER_KNOBS->START_TRANSACTION_DEFAULT_LATENCY_TARGET)) {
+					grvProxyData->stats.txnDefaultPriorityStartLate += tc;
+				}
 				--grvProxyData->stats.defaultGRVQueueSize;
 			} else {
 				batchPriTransactionsStarted[req.flags & 1] += tc;
 				grvProxyData->stats.batchTxnGRVTimeInQueue.addMeasurement(currentTime - req.requestTime());
+				if (isLate(req, currentTime, SERVER_KNOBS->START_TRANSACTION_BATCH_LATENCY_TARGET)) {
+					grvProxyData->stats.txnBatchPriorityStartLate += tc;
+				}
 				--grvProxyData->stats.batchGRVQueueSize;
 			}
 			for (auto tag : req.tags) {
@@ -1061,14 +1160,23 @@ ACTOR static Future<Void> transactionStarter(GrvProxyInterface proxy,
 					spanContexts.push_back(request.spanContext);
 				}
 
-				Future<GetReadVersionReply> readVersionReply = getLiveCommittedVersion(spanContexts,
-				                                                                       grvProxyData,
-				                                                                       i,
-				                                                                       debugID,
-				                                                                       transactionsStarted[i],
-				                                                                       systemTransactionsStarted[i],
-				                                                                       defaultPriTransactionsStarted[i],
-				                                                                       batchPriTransactionsStarted[i]);
+				Future<GetReadVersionReply> readVersionReply;
+				if (i == 1 && canUseCachedReadVersion(grvProxyData)) {
+					readVersionReply = getCachedReadVersion(grvProxyData,
+					                                        transactionsStarted[i],
+					                                        systemTransactionsStarted[i],
+					                                        defaultPriTransactionsStarted[i],
+					                                        batchPriTransactionsStarted[i]);
+				} else {
+					readVersionReply = getLiveCommittedVersion(spanContexts,
+					                                           grvProxyData,
+					                                           i,
+					                                           debugID,
+					                                           transactionsStarted[i],
+					                                           systemTransactionsStarted[i],
+					                                           defaultPriTransactionsStarted[i],
+					                                           batchPriTransactionsStarted[i]);
+				}
 				addActor.send(sendGrvReplies(readVersionReply,
 				                             start[i],
 				                             grvProxyData,
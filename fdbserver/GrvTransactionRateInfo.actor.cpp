@@ -24,9 +24,12 @@
 #include "flow/UnitTest.h"
 #include "flow/actorcompiler.h" // must be last include
 
-GrvTransactionRateInfo::GrvTransactionRateInfo(double rateWindow, double maxEmptyQueueBudget, double rate)
-  : rateWindow(rateWindow), maxEmptyQueueBudget(maxEmptyQueueBudget), rate(rate), smoothRate(rateWindow),
-    smoothReleased(rateWindow) {
+GrvTransactionRateInfo::GrvTransactionRateInfo(double rateWindow,
+                                               double maxEmptyQueueBudget,
+                                               double rate,
+                                               double maxBurstDuration)
+  : rateWindow(rateWindow), maxEmptyQueueBudget(maxEmptyQueueBudget), maxBurstDuration(maxBurstDuration), rate(rate),
+    smoothRate(rateWindow), smoothReleased(rateWindow) {
 	smoothRate.setTotal(rate);
 }
 
@@ -58,6 +61,9 @@ void GrvTransactionRateInfo::endReleaseWindow(int64_t numStarted, bool queueEmpt
 	// If we did keep accumulating budget, then our responsiveness to changes in workflow could be compromised
 	if (queueEmpty) {
 		budget = std::min(budget, maxEmptyQueueBudget);
+		if (maxBurstDuration > 0) {
+			budget = std::min(budget, rate * maxBurstDuration);
+		}
 	}
 
 	smoothReleased.addDelta(numStarted);
@@ -120,3 +126,35 @@ TEST_CASE("/GrvTransactionRateInfo/Simple") {
 	ASSERT(isNear(60.0 * 10.0, counter));
 	return Void();
 }
+
+ACTOR static Future<int64_t> startBurstAfterIdle(GrvTransactionRateInfo* rateInfo) {
+	state double idleUntil = now() + 60.0;
+	while (now() < idleUntil) {
+		wait(delay(0.01));
+		rateInfo->startReleaseWindow();
+		rateInfo->endReleaseWindow(0, true, 0.01);
+	}
+	rateInfo->startReleaseWindow();
+	int64_t started = 0;
+	while (rateInfo->canStart(started, 1)) {
+		++started;
+	}
+	return started;
+}
+
+// After a minute idle at a rate of 10, a client sends far more than the rate at once. Without a burst limit the
+// whole empty queue budget is released; with a one second limit, only the rate window's limit and one more second.
+TEST_CASE("/GrvTransactionRateInfo/LimitedBurst") {
+	state GrvTransactionRateInfo unlimited(/*rateWindow=*/2.0, /*maxEmptyQueueBudget=*/100, /*rate=*/10);
+	state GrvTransactionRateInfo limited(/*rateWindow=*/2.0, /*maxEmptyQueueBudget=*/100, /*rate=*/10, 1.0);
+	unlimited.setRate(10.0);
+	limited.setRate(10.0);
+	state int64_t unlimitedBurst = wait(startBurstAfterIdle(&unlimited));
+	state int64_t limitedBurst = wait(startBurstAfterIdle(&limited));
+	TraceEvent("GrvTransactionRateInfoBurstTest")
+	    .detail("UnlimitedBurst", unlimitedBurst)
+	    .detail("LimitedBurst", limitedBurst);
+	ASSERT(unlimitedBurst > 100);
+	ASSERT(limitedBurst >= 20 && limitedBurst <= 31);
+	return Void();
+}
@@ -0,0 +1,189 @@
+/*
+ * HotKeyTracker.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbserver/HotKeyTracker.h"
+#include "fdbserver/Knobs.h"
+#include "flow/Trace.h"
+#include "flow/UnitTest.h"
+#include "flow/xxhash.h"
+
+HotKeySketch::HotKeySketch(int depth, int width, int maxHotKeys)
+  : depth(depth), width(width), maxHotKeys(maxHotKeys), counters(depth * width, 0) {
+	ASSERT(depth > 0 && width > 0);
+}
+
+// Calls f with the counter of each row for key. The rows' hash functions are derived from a single 64-bit hash
+// (Kirsch and Mitzenmacher), so the key is only hashed once.
+template <class F>
+void HotKeySketch::forEachCounter(KeyRef key, F f) const {
+	uint64_t hash = XXH3_64bits(key.begin(), key.size());
+	uint32_t h1 = hash, h2 = hash >> 32;
+	for (int i = 0; i < depth; i++) {
+		f(i * width + (h1 + i * h2) % width);
+	}
+}
+
+void HotKeySketch::add(KeyRef key, int64_t weight) {
+	total += weight;
+	int64_t keyWeight = std::numeric_limits<int64_t>::max();
+	forEachCounter(key, [&](int c) { keyWeight = std::min(keyWeight, counters[c] += weight); });
+
+	if (maxHotKeys <= 0) {
+		return;
+	}
+	auto it = candidates.find(key);
+	if (it != candidates.end()) {
+		candidatesByWeight.erase({ it->second, it->first });
+		it->second = keyWeight;
+		candidatesByWeight.emplace(keyWeight, it->first);
+		return;
+	}
+	if (candidates.size() >= maxHotKeys) {
+		auto lightest = candidatesByWeight.begin();
+		if (lightest->first >= keyWeight) {
+			return;
+		}
+		auto evicted = candidates.find(lightest->second);
+		candidatesByWeight.erase(lightest);
+		candidates.erase(evicted);
+	}
+	auto inserted = candidates.emplace(Key(key), keyWeight).first;
+	candidatesByWeight.emplace(keyWeight, inserted->first);
+}
+
+int64_t HotKeySketch::estimate(KeyRef key) const {
+	int64_t keyWeight = std::numeric_limits<int64_t>::max();
+	forEachCounter(key, [&](int c) { keyWeight = std::min(keyWeight, counters[c]); });
+	return keyWeight;
+}
+
+std::vector<HotKeySketch::HotKey> HotKeySketch::getHotKeys() const {
+	std::vector<HotKey> hotKeys;
+	hotKeys.reserve(candidates.size());
+	for (auto it = candidatesByWeight.rbegin(); it != candidatesByWeight.rend(); ++it) {
+		hotKeys.push_back(HotKey{ candidates.find(it->second)->first, it->first });
+	}
+	return hotKeys;
+}
+
+void HotKeySketch::clear() {
+	std::fill(counters.begin(), counters.end(), 0);
+	total = 0;
+	candidatesByWeight.clear();
+	candidates.clear();
+}
+
+HotKeyTracker::HotKeyTracker(UID thisServerID)
+  : thisServerID(thisServerID), isEnabled(SERVER_KNOBS->HOT_KEY_TRACKING_ENABLED),
+    prefixBytes(SERVER_KNOBS->HOT_KEY_PREFIX_BYTES),
+    reads(SERVER_KNOBS->HOT_KEY_SKETCH_DEPTH, SERVER_KNOBS->HOT_KEY_SKETCH_WIDTH, SERVER_KNOBS->HOT_KEYS_TRACKED),
+    readPrefixes(SERVER_KNOBS->HOT_KEY_SKETCH_DEPTH,
+                 SERVER_KNOBS->HOT_KEY_SKETCH_WIDTH,
+                 SERVER_KNOBS->HOT_KEYS_TRACKED),
+    writes(SERVER_KNOBS->HOT_KEY_SKETCH_DEPTH, SERVER_KNOBS->HOT_KEY_SKETCH_WIDTH, SERVER_KNOBS->HOT_KEYS_TRACKED),
+    writePrefixes(SERVER_KNOBS->HOT_KEY_SKETCH_DEPTH,
+                  SERVER_KNOBS->HOT_KEY_SKETCH_WIDTH,
+                  SERVER_KNOBS->HOT_KEYS_TRACKED),
+    hotKeysEventHolder(makeReference<EventCacheHolder>(thisServerID.toString() + "/HotKeys")) {}
+
+static std::vector<HotKeyTracker::HotKeyRate> getHotKeyRates(HotKeySketch const& sketch, double elapsed) {
+	std::vector<HotKeyTracker::HotKeyRate> rates;
+	for (auto const& hotKey : sketch.getHotKeys()) {
+		rates.push_back(HotKeyTracker::HotKeyRate{
+		    hotKey.key, hotKey.weight / elapsed, std::min(1.0, (double)hotKey.weight / sketch.totalWeight()) });
+	}
+	return rates;
+}
+
+void HotKeyTracker::startNewInterval() {
+	if (!isEnabled) {
+		return;
+	}
+	double elapsed = now() - intervalStart;
+	if (intervalStart > 0 && elapsed > 0) {
+		hotReadKeys = getHotKeyRates(reads, elapsed);
+		hotReadPrefixes = getHotKeyRates(readPrefixes, elapsed);
+		hotWriteKeys = getHotKeyRates(writes, elapsed);
+		hotWritePrefixes = getHotKeyRates(writePrefixes, elapsed);
+
+		TraceEvent te("HotKeys", thisServerID);
+		te.detail("Elapsed", elapsed);
+		for (auto const& [name, hotKeys] : { std::make_pair("ReadKey", &hotReadKeys),
+		                                     std::make_pair("ReadPrefix", &hotReadPrefixes),
+		                                     std::make_pair("WriteKey", &hotWriteKeys),
+		                                     std::make_pair("WritePrefix", &hotWritePrefixes) }) {
+			if (!hotKeys->empty()) {
+				te.detail(name, hotKeys->front().key)
+				    .detail(std::string(name) + "Rate", hotKeys->front().rate)
+				    .detail(std::string(name) + "Fraction", hotKeys->front().fraction);
+			}
+			for (auto const& hotKey : *hotKeys) {
+				TraceEvent("HotKey", thisServerID)
+				    .detail("Type", name)
+				    .detail("Key", hotKey.key)
+				    .detail("Rate", hotKey.rate)
+				    .detail("Fraction", hotKey.fraction);
+			}
+		}
+		te.trackLatest(hotKeysEventHolder->trackingKey);
+	}
+
+	reads.clear();
+	readPrefixes.clear();
+	writes.clear();
+	writePrefixes.clear();
+	intervalStart = now();
+}
+
+TEST_CASE("/fdbserver/HotKeyTracker/HotKeySketch") {
+	HotKeySketch sketch(4, 64, 3);
+	// A few heavy keys among many light ones
+	for (int i = 0; i < 1000; i++) {
+		sketch.add(StringRef(format("light%d", i)), 1);
+		if (i % 4 == 0) {
+			sketch.add("heavyA"_sr, 10);
+		}
+		if (i % 8 == 0) {
+			sketch.add("heavyB"_sr, 10);
+		}
+	}
+	sketch.add("heavyC"_sr, 1000);
+
+	ASSERT_EQ(sketch.totalWeight(), 1000 + 2500 + 1250 + 1000);
+	ASSERT(sketch.estimate("heavyA"_sr) >= 2500);
+	ASSERT(sketch.estimate("heavyB"_sr) >= 1250);
+	ASSERT(sketch.estimate("light0"_sr) >= 1);
+
+	auto hotKeys = sketch.getHotKeys();
+	ASSERT_EQ(hotKeys.size(), 3);
+	ASSERT(hotKeys[0].key == "heavyA"_sr);
+	ASSERT(hotKeys[1].key == "heavyB"_sr || hotKeys[1].key == "heavyC"_sr);
+	ASSERT(hotKeys[2].key == "heavyB"_sr || hotKeys[2].key == "heavyC"_sr);
+	for (int i = 1; i < hotKeys.size(); i++) {
+		ASSERT(hotKeys[i - 1].weight >= hotKeys[i].weight);
+	}
+
+	sketch.clear();
+	ASSERT_EQ(sketch.totalWeight(), 0);
+	ASSERT_EQ(sketch.estimate("heavyA"_sr), 0);
+	ASSERT(sketch.getHotKeys().empty());
+
+	return Void();
+}
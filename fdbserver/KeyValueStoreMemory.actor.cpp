@@ -24,6 +24,7 @@
 #include "fdbclient/Notified.h"
 #include "fdbclient/SystemData.h"
 #include "fdbserver/ServerDBInfo.actor.h"
+#include "fdbserver/BTreeKeyValueContainer.h"
 #include "fdbserver/DeltaTree.h"
 #include "fdbclient/GetEncryptCipherKeys.h"
 #include "fdbserver/IDiskQueue.h"
@@ -461,6 +462,43 @@ private:
 		return total;
 	}
 
+	// Applies a transaction read back during recovery. Snapshot items are logged in ascending key order, separated by
+	// clears of the gaps between them, so runs of ascending sets are inserted into the container as one sorted batch
+	// rather than searching from the root for each key. A clear beginning after the last batched key cannot affect
+	// the batch and is applied right away; any other op flushes the batch first, which keeps the replay equivalent to
+	// commit_queue().
+	int64_t replay_queue(OpQueue& ops) {
+		int64_t total = 0;
+		StringRef lastBatchedKey;
+		auto flush = [this]() {
+			if (!dataSets.empty()) {
+				data.insert(dataSets);
+				dataSets.clear();
+			}
+		};
+
+		for (auto o = ops.begin(); o != ops.end(); ++o) {
+			total += o->p1.size() + o->p2.size() + OP_DISK_OVERHEAD;
+			if (!dataSets.empty() && o->p1 <= lastBatchedKey) {
+				flush();
+			}
+			if (o->op == OpSet) {
+				KeyValueMapPair pair(o->p1, o->p2);
+				dataSets.emplace_back(pair, pair.arena.getSize() + data.getElementBytes());
+				lastBatchedKey = o->p1;
+			} else if (o->op == OpClear) {
+				data.erase(data.lower_bound(o->p1), data.lower_bound(o->p2));
+			} else if (o->op == OpClearToEnd) {
+				data.erase(data.lower_bound(o->p1), data.end());
+			} else
+				ASSERT(false);
+		}
+		flush();
+
+		ops.clear();
+		return total;
+	}
+
 	static bool isOpEncrypted(OpHeader* header) { return header->op >> ENCRYPTION_ENABLED_BIT == 1; }
 
 	static void setEncryptFlag(OpHeader* header, bool set) {
@@ -728,7 +766,13 @@ private:
 						} else if (h.op == OpClearToEnd) { // clear all data from begin key to end
 							recoveryQueue.clear_to_end(p1, &data.arena());
 						} else if (h.op == OpCommit) { // commit previous transaction
-							self->commit_queue(recoveryQueue, false);
+							// The radix tree has no bulk insert
+							if (SERVER_KNOBS->KVS_MEM_RECOVERY_BATCH_SETS &&
+							    self->type != KeyValueStoreType::MEMORY_RADIXTREE) {
+								self->replay_queue(recoveryQueue);
+							} else {
+								self->commit_queue(recoveryQueue, false);
+							}
 							++dbgCommitCount;
 							self->recoveredSnapshotKey = uncommittedNextKey;
 							self->previousSnapshotEnd = uncommittedPrevSnapshotEnd;
@@ -1085,6 +1129,10 @@ IKeyValueStore* keyValueStoreMemory(std::string const& basename,
 	if (storeType == KeyValueStoreType::MEMORY_RADIXTREE) {
 		return new KeyValueStoreMemory<radix_tree>(
 		    log, Reference<AsyncVar<ServerDBInfo> const>(), logID, memoryLimit, storeType, false, false, false, false);
+	} else if (storeType == KeyValueStoreType::MEMORY && SERVER_KNOBS->KVS_MEM_USE_BTREE_CONTAINER) {
+		// The on-disk format does not depend on the container, so existing stores can switch in either direction.
+		return new KeyValueStoreMemory<BTreeKeyValueContainer>(
+		    log, Reference<AsyncVar<ServerDBInfo> const>(), logID, memoryLimit, storeType, false, false, false, false);
 	} else {
 		return new KeyValueStoreMemory<IKeyValueContainer>(
 		    log, Reference<AsyncVar<ServerDBInfo> const>(), logID, memoryLimit, storeType, false, false, false, false);
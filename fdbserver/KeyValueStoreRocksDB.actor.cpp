@@ -65,7 +65,9 @@
 
 #include "fdbserver/Knobs.h"
 #include "fdbserver/IKeyValueStore.h"
+#include "fdbserver/RocksDBBlockCache.h"
 #include "fdbserver/RocksDBCheckpointUtils.actor.h"
+#include "fdbserver/RocksDBIOPressure.h"
 
 #include "flow/actorcompiler.h" // has to be last include
 
@@ -105,22 +107,37 @@ public:
 	rocksdb::ColumnFamilyOptions getCfOptions() const { return this->cfOptions; }
 	rocksdb::Options getOptions() const { return rocksdb::Options(this->dbOptions, this->cfOptions); }
 	rocksdb::ReadOptions getReadOptions() { return this->readOptions; }
+	RocksDBIOPressure& getIOPressure() { return this->ioPressure; }
+	std::shared_ptr<rocksdb::Cache> getBlockCache() const { return this->blockCache; }
 
 private:
 	const UID id;
 	rocksdb::ColumnFamilyOptions initialCfOptions();
 	rocksdb::DBOptions initialDbOptions();
 	rocksdb::ReadOptions initialReadOptions();
+	std::shared_ptr<rocksdb::Cache> initialBlockCache();
 
 	bool closing;
+	std::shared_ptr<rocksdb::Cache> blockCache;
 	rocksdb::DBOptions dbOptions;
 	rocksdb::ColumnFamilyOptions cfOptions;
 	rocksdb::ReadOptions readOptions;
+	RocksDBIOPressure ioPressure;
 };
 
 SharedRocksDBState::SharedRocksDBState(UID id)
-  : id(id), closing(false), dbOptions(initialDbOptions()), cfOptions(initialCfOptions()),
-    readOptions(initialReadOptions()) {}
+  : id(id), closing(false), blockCache(initialBlockCache()), dbOptions(initialDbOptions()),
+    cfOptions(initialCfOptions()), readOptions(initialReadOptions()) {}
+
+std::shared_ptr<rocksdb::Cache> SharedRocksDBState::initialBlockCache() {
+	if (SERVER_KNOBS->ROCKSDB_BLOCK_CACHE_SIZE <= 0) {
+		return nullptr;
+	}
+	if (SERVER_KNOBS->ROCKSDB_SHARE_BLOCK_CACHE) {
+		return getProcessRocksDBBlockCache();
+	}
+	return newRocksDBBlockCache(SERVER_KNOBS->ROCKSDB_BLOCK_CACHE_SIZE, SERVER_KNOBS->ROCKSDB_CACHE_HIGH_PRI_POOL_RATIO);
+}
 
 rocksdb::ColumnFamilyOptions SharedRocksDBState::initialCfOptions() {
 	rocksdb::ColumnFamilyOptions options;
@@ -203,12 +220,8 @@ rocksdb::ColumnFamilyOptions SharedRocksDBState::initialCfOptions() {
 		bbOpts.whole_key_filtering = SERVER_KNOBS->ROCKSDB_BLOOM_WHOLE_KEY_FILTERING;
 	}
 
-	if (SERVER_KNOBS->ROCKSDB_BLOCK_CACHE_SIZE > 0) {
-		bbOpts.block_cache =
-		    rocksdb::NewLRUCache(SERVER_KNOBS->ROCKSDB_BLOCK_CACHE_SIZE,
-		                         -1, /* num_shard_bits, default value:-1*/
-		                         false, /* strict_capacity_limit, default value:false */
-		                         SERVER_KNOBS->ROCKSDB_CACHE_HIGH_PRI_POOL_RATIO /* high_pri_pool_ratio */);
+	if (blockCache) {
+		bbOpts.block_cache = blockCache;
 		bbOpts.cache_index_and_filter_blocks = SERVER_KNOBS->ROCKSDB_CACHE_INDEX_AND_FILTER_BLOCKS;
 		bbOpts.pin_l0_filter_and_index_blocks_in_cache = SERVER_KNOBS->ROCKSDB_CACHE_INDEX_AND_FILTER_BLOCKS;
 		bbOpts.cache_index_and_filter_blocks_with_high_priority = SERVER_KNOBS->ROCKSDB_CACHE_INDEX_AND_FILTER_BLOCKS;
@@ -218,6 +231,14 @@ rocksdb::ColumnFamilyOptions SharedRocksDBState::initialCfOptions() {
 		bbOpts.block_size = SERVER_KNOBS->ROCKSDB_BLOCK_SIZE;
 	}
 
+	// Partitioned index and filters are loaded one partition at a time, so a short scan reads the partitions
+	// covering its range rather than the whole index and filter of every file it touches.
+	// https://github.com/facebook/rocksdb/wiki/Partitioned-Index-Filters
+	if (SERVER_KNOBS->ROCKSDB_PARTITIONED_INDEX_FILTERS) {
+		bbOpts.index_type = rocksdb::BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch;
+		bbOpts.partition_filters = bbOpts.filter_policy != nullptr;
+	}
+
 	// The readahead size starts with 8KB and is exponentially increased on each additional sequential IO,
 	// up to a max of BlockBasedTableOptions.max_auto_readahead_size (default 256 KB)
 	if (SERVER_KNOBS->ROCKSDB_MAX_AUTO_READAHEAD_SIZE > 0) {
@@ -482,13 +503,16 @@ struct Counters {
 	Counter convertedDeleteRangeReqs;
 	Counter rocksdbReadRangeQueries;
 	Counter commitDelayed;
+	Counter readValueBatches;
+	Counter readValueBatchKeys;
 
 	Counters()
 	  : cc("RocksDBThrottle"), immediateThrottle("ImmediateThrottle", cc), failedToAcquire("FailedToAcquire", cc),
 	    deleteKeyReqs("DeleteKeyRequests", cc), deleteRangeReqs("DeleteRangeRequests", cc),
 	    convertedDeleteKeyReqs("ConvertedDeleteKeyRequests", cc),
 	    convertedDeleteRangeReqs("ConvertedDeleteRangeRequests", cc),
-	    rocksdbReadRangeQueries("RocksdbReadRangeQueries", cc), commitDelayed("CommitDelayed", cc) {}
+	    rocksdbReadRangeQueries("RocksdbReadRangeQueries", cc), commitDelayed("CommitDelayed", cc),
+	    readValueBatches("ReadValueBatches", cc), readValueBatchKeys("ReadValueBatchKeys", cc) {}
 };
 
 struct ReadIterator {
@@ -500,18 +524,36 @@ struct ReadIterator {
 	std::shared_ptr<rocksdb::Slice> beginSlice, endSlice;
 	ReadIterator(CF& cf, uint64_t index, DB& db, std::shared_ptr<SharedRocksDBState> sharedState)
 	  : index(index), inUse(true), creationTime(now()), iter(db->NewIterator(sharedState->getReadOptions(), cf)) {}
-	ReadIterator(CF& cf, uint64_t index, DB& db, std::shared_ptr<SharedRocksDBState> sharedState, KeyRange keyRange)
+	ReadIterator(CF& cf,
+	             uint64_t index,
+	             DB& db,
+	             std::shared_ptr<SharedRocksDBState> sharedState,
+	             KeyRange keyRange,
+	             size_t readaheadBytes = 0)
 	  : index(index), inUse(true), creationTime(now()), keyRange(keyRange) {
 		rocksdb::ReadOptions readOptions = sharedState->getReadOptions();
 		beginSlice = std::shared_ptr<rocksdb::Slice>(new rocksdb::Slice(toSlice(keyRange.begin)));
 		readOptions.iterate_lower_bound = beginSlice.get();
 		endSlice = std::shared_ptr<rocksdb::Slice>(new rocksdb::Slice(toSlice(keyRange.end)));
 		readOptions.iterate_upper_bound = endSlice.get();
+		readOptions.auto_readahead_size = SERVER_KNOBS->ROCKSDB_READ_RANGE_AUTO_READAHEAD_SIZE;
+		readOptions.readahead_size = readaheadBytes;
 
 		iter = std::shared_ptr<rocksdb::Iterator>(db->NewIterator(readOptions, cf));
 	}
 };
 
+// Returns the readahead for a range read, or 0 to leave it to RocksDB's auto readahead. Only forward reads that may
+// return at least ROCKSDB_READ_RANGE_READAHEAD_MIN_BYTES are worth prefetching for, since short scans would discard
+// most of what was read ahead.
+size_t rangeReadaheadBytes(int rowLimit, int byteLimit) {
+	if (rowLimit <= 0 || SERVER_KNOBS->ROCKSDB_READ_RANGE_READAHEAD_MIN_BYTES <= 0 ||
+	    byteLimit < SERVER_KNOBS->ROCKSDB_READ_RANGE_READAHEAD_MIN_BYTES) {
+		return 0;
+	}
+	return std::min<int64_t>(byteLimit, SERVER_KNOBS->ROCKSDB_READ_RANGE_MAX_READAHEAD_BYTES);
+}
+
 /*
 ReadIteratorPool: Collection of iterators. Reuses iterators on non-concurrent multiple read operations,
 instead of creating and deleting for every read.
@@ -609,6 +651,15 @@ public:
 		}
 	}
 
+	// Returns a new iterator bounded to keyRange that prefetches readaheadBytes at a time, for long scans. It is
+	// never pooled, since the readahead only suits the scan it was sized for.
+	ReadIterator getReadaheadIterator(KeyRange keyRange, size_t readaheadBytes) {
+		mutex.lock();
+		uint64_t readIteratorIndex = ++index;
+		mutex.unlock();
+		return ReadIterator(cf, readIteratorIndex, db, sharedState, keyRange, readaheadBytes);
+	}
+
 	// Called on every read operation, after the keys are collected.
 	void returnIterator(ReadIterator& iter) {
 		if (SERVER_KNOBS->ROCKSDB_READ_RANGE_REUSE_ITERATORS ||
@@ -957,6 +1008,46 @@ ACTOR Future<Void> flowLockLogger(UID id, const FlowLock* readLock, const FlowLo
 	}
 }
 
+// Samples compaction and stall state into the shared IO pressure, and backs the background IO rate off while foreground
+// reads are slow.
+ACTOR Future<Void> ioPressureMonitor(UID id,
+                                     std::shared_ptr<SharedRocksDBState> sharedState,
+                                     rocksdb::DB* db,
+                                     std::shared_ptr<rocksdb::RateLimiter> rateLimiter) {
+	state rocksdb::ColumnFamilyOptions cfOptions = sharedState->getCfOptions();
+	state bool tuneRateLimiter = rateLimiter && !SERVER_KNOBS->ROCKSDB_WRITE_RATE_LIMITER_AUTO_TUNE &&
+	                             SERVER_KNOBS->ROCKSDB_RATE_LIMITER_READ_LATENCY_TARGET > 0;
+	loop {
+		wait(delay(SERVER_KNOBS->ROCKSDB_IO_PRESSURE_INTERVAL));
+		if (sharedState->isClosing()) {
+			break;
+		}
+		uint64_t pendingCompactionBytes = 0, delayedWriteRate = 0, writeStopped = 0;
+		db->GetIntProperty(rocksdb::DB::Properties::kEstimatePendingCompactionBytes, &pendingCompactionBytes);
+		db->GetIntProperty(rocksdb::DB::Properties::kActualDelayedWriteRate, &delayedWriteRate);
+		db->GetIntProperty(rocksdb::DB::Properties::kIsWriteStopped, &writeStopped);
+		std::string l0Files;
+		if (!db->GetProperty(rocksdb::DB::Properties::kNumFilesAtLevelPrefix + "0", &l0Files) || l0Files.empty()) {
+			l0Files = "0";
+		}
+		const double pressure = RocksDBIOPressure::compute(pendingCompactionBytes,
+		                                                   cfOptions.soft_pending_compaction_bytes_limit,
+		                                                   cfOptions.hard_pending_compaction_bytes_limit,
+		                                                   std::stoull(l0Files),
+		                                                   cfOptions.level0_slowdown_writes_trigger,
+		                                                   cfOptions.level0_stop_writes_trigger,
+		                                                   delayedWriteRate > 0,
+		                                                   writeStopped > 0);
+		sharedState->getIOPressure().setPressure(pressure);
+		if (tuneRateLimiter) {
+			const int64_t rate = sharedState->getIOPressure().adjustRateLimiter(
+			    rateLimiter.get(), SERVER_KNOBS->ROCKSDB_WRITE_RATE_LIMITER_BYTES_PER_SEC);
+			TraceEvent(SevDebug, "RocksDBIOPressure", id).detail("Pressure", pressure).detail("RateLimit", rate);
+		}
+	}
+	return Void();
+}
+
 ACTOR Future<Void> rocksDBMetricLogger(UID id,
                                        std::shared_ptr<SharedRocksDBState> sharedState,
                                        std::shared_ptr<rocksdb::Statistics> statistics,
@@ -1061,6 +1152,7 @@ ACTOR Future<Void> rocksDBMetricLogger(UID id,
 		{ "BaseLevel", rocksdb::DB::Properties::kBaseLevel },
 		{ "EstPendCompactBytes", rocksdb::DB::Properties::kEstimatePendingCompactionBytes },
 		{ "BlockCacheUsage", rocksdb::DB::Properties::kBlockCacheUsage },
+		{ "BlockCacheCapacity", rocksdb::DB::Properties::kBlockCacheCapacity },
 		{ "BlockCachePinnedUsage", rocksdb::DB::Properties::kBlockCachePinnedUsage },
 		{ "LiveSstFilesSize", rocksdb::DB::Properties::kLiveSstFilesSize },
 	};
@@ -1086,6 +1178,8 @@ ACTOR Future<Void> rocksDBMetricLogger(UID id,
 		}
 		TraceEvent e("RocksDBMetrics", id);
 		e.trackLatest(rocksdbMetricsTrackingKey);
+		// With a shared block cache the usage and capacity are those of the whole process.
+		e.detail("BlockCacheShared", SERVER_KNOBS->ROCKSDB_SHARE_BLOCK_CACHE);
 
 		uint64_t stat;
 		for (auto& [name, ticker, cum] : tickerStats) {
@@ -1305,7 +1399,8 @@ struct RocksDBKeyValueStore : IKeyValueStore {
 				a.metrics =
 				    rocksDBMetricLogger(
 				        id, sharedState, options.statistics, perfContextMetrics, db, readIterPool, &a.counters, cf) &&
-				    flowLockLogger(id, a.readLock, a.fetchLock) && refreshReadIteratorPool(readIterPool);
+				    flowLockLogger(id, a.readLock, a.fetchLock) && refreshReadIteratorPool(readIterPool) &&
+				    ioPressureMonitor(id, sharedState, db, rateLimiter);
 			} else {
 				onMainThread([&] {
 					a.metrics = rocksDBMetricLogger(id,
@@ -1316,7 +1411,8 @@ struct RocksDBKeyValueStore : IKeyValueStore {
 					                                readIterPool,
 					                                &a.counters,
 					                                cf) &&
-					            flowLockLogger(id, a.readLock, a.fetchLock) && refreshReadIteratorPool(readIterPool);
+					            flowLockLogger(id, a.readLock, a.fetchLock) && refreshReadIteratorPool(readIterPool) &&
+					            ioPressureMonitor(id, sharedState, db, rateLimiter);
 					return Future<bool>(true);
 				}).blockUntilReady();
 			}
@@ -1612,6 +1708,7 @@ struct RocksDBKeyValueStore : IKeyValueStore {
 			}
 
 			const double endTime = timer_monotonic();
+			sharedState->getIOPressure().addReadLatency(endTime - readBeginTime);
 			if (a.getHistograms) {
 				metricPromiseStream->send(
 				    std::make_pair(ROCKSDB_READVALUE_ACTION_HISTOGRAM.toString(), endTime - readBeginTime));
@@ -1623,6 +1720,111 @@ struct RocksDBKeyValueStore : IKeyValueStore {
 			}
 		}
 
+		// Point reads queued together by RocksDBKeyValueStore::enqueueReadValue(), which are read with one MultiGet so
+		// that RocksDB can coalesce their block reads
+		struct ReadValuesAction : TypedAction<Reader, ReadValuesAction> {
+			std::vector<std::unique_ptr<ReadValueAction>> reads;
+			double getTimeEstimate() const override { return SERVER_KNOBS->READ_VALUE_TIME_ESTIMATE * reads.size(); }
+		};
+		void action(ReadValuesAction& a) {
+			ASSERT(cf != nullptr);
+			bool doPerfContextMetrics =
+			    SERVER_KNOBS->ROCKSDB_PERFCONTEXT_ENABLE &&
+			    (deterministicRandom()->random01() < SERVER_KNOBS->ROCKSDB_PERFCONTEXT_SAMPLE_RATE);
+			if (doPerfContextMetrics) {
+				perfContextMetrics->reset();
+			}
+			const double readBeginTime = timer_monotonic();
+
+			// Reads which already waited longer than their timeout fail on their own, the rest are read together.  The
+			// batch gets a deadline only if all of its reads can be throttled, from the one which has waited longest.
+			std::vector<ReadValueAction*> reads;
+			std::vector<rocksdb::Slice> keys;
+			Optional<TraceBatch> traceBatch;
+			bool throttled = true;
+			double oldestStartTime = readBeginTime;
+			for (auto& r : a.reads) {
+				if (r->getHistograms) {
+					metricPromiseStream->send(
+					    std::make_pair(ROCKSDB_READVALUE_QUEUEWAIT_HISTOGRAM.toString(), readBeginTime - r->startTime));
+				}
+				if (r->debugID.present()) {
+					if (!traceBatch.present()) {
+						traceBatch = { TraceBatch{} };
+					}
+					traceBatch.get().addEvent("GetValueDebug", r->debugID.get().first(), "Reader.Before");
+				}
+				if (shouldThrottle(r->type, r->key)) {
+					if (SERVER_KNOBS->ROCKSDB_SET_READ_TIMEOUT && readBeginTime - r->startTime > readValueTimeout) {
+						TraceEvent(SevWarn, "KVSTimeout", id)
+						    .detail("Error", "Read value request timedout")
+						    .detail("Method", "ReadValuesAction")
+						    .detail("TimeoutValue", readValueTimeout);
+						r->result.sendError(transaction_too_old());
+						continue;
+					}
+					oldestStartTime = std::min(oldestStartTime, r->startTime);
+				} else {
+					throttled = false;
+				}
+				reads.push_back(r.get());
+				keys.push_back(toSlice(r->key));
+			}
+			if (reads.empty()) {
+				if (traceBatch.present()) {
+					traceBatch.get().dump();
+				}
+				return;
+			}
+
+			rocksdb::ReadOptions readOptions = sharedState->getReadOptions();
+			readOptions.async_io = SERVER_KNOBS->ROCKSDB_READ_VALUE_BATCH_ASYNC_IO;
+			if (throttled && SERVER_KNOBS->ROCKSDB_SET_READ_TIMEOUT) {
+				uint64_t deadlineMircos =
+				    db->GetEnv()->NowMicros() + (readValueTimeout - (readBeginTime - oldestStartTime)) * 1000000;
+				std::chrono::seconds deadlineSeconds(deadlineMircos / 1000000);
+				readOptions.deadline = std::chrono::duration_cast<std::chrono::microseconds>(deadlineSeconds);
+			}
+
+			std::vector<rocksdb::PinnableSlice> values(reads.size());
+			std::vector<rocksdb::Status> statuses(reads.size());
+			double dbGetBeginTime = timer_monotonic();
+			db->MultiGet(readOptions, cf, keys.size(), keys.data(), values.data(), statuses.data());
+			const double endTime = timer_monotonic();
+			sharedState->getIOPressure().addReadLatency(endTime - dbGetBeginTime);
+
+			for (int i = 0; i < reads.size(); ++i) {
+				ReadValueAction* r = reads[i];
+				const rocksdb::Status& s = statuses[i];
+				if (r->getHistograms) {
+					metricPromiseStream->send(
+					    std::make_pair(ROCKSDB_READVALUE_GET_HISTOGRAM.toString(), endTime - dbGetBeginTime));
+					metricPromiseStream->send(
+					    std::make_pair(ROCKSDB_READVALUE_ACTION_HISTOGRAM.toString(), endTime - readBeginTime));
+					metricPromiseStream->send(
+					    std::make_pair(ROCKSDB_READVALUE_LATENCY_HISTOGRAM.toString(), endTime - r->startTime));
+				}
+				if (r->debugID.present()) {
+					traceBatch.get().addEvent("GetValueDebug", r->debugID.get().first(), "Reader.After");
+				}
+				if (s.ok()) {
+					r->result.send(Value(toStringRef(values[i])));
+				} else if (s.IsNotFound()) {
+					r->result.send(Optional<Value>());
+				} else {
+					logRocksDBError(id, s, "ReadValues");
+					r->result.sendError(statusToError(s));
+				}
+			}
+			if (traceBatch.present()) {
+				traceBatch.get().dump();
+			}
+
+			if (doPerfContextMetrics) {
+				perfContextMetrics->set(threadIndex);
+			}
+		}
+
 		struct ReadValuePrefixAction : TypedAction<Reader, ReadValuePrefixAction> {
 			Key key;
 			int maxLength;
@@ -1753,7 +1955,9 @@ struct RocksDBKeyValueStore : IKeyValueStore {
 			rocksdb::Status s;
 			if (a.rowLimit >= 0) {
 				double iterCreationBeginTime = a.getHistograms ? timer_monotonic() : 0;
-				ReadIterator readIter = readIterPool->getIterator(a.keys);
+				const size_t readaheadBytes = rangeReadaheadBytes(a.rowLimit, a.byteLimit);
+				ReadIterator readIter = readaheadBytes > 0 ? readIterPool->getReadaheadIterator(a.keys, readaheadBytes)
+				                                           : readIterPool->getIterator(a.keys);
 				if (a.getHistograms) {
 					metricPromiseStream->send(std::make_pair(ROCKSDB_READRANGE_NEWITERATOR_HISTOGRAM.toString(),
 					                                         timer_monotonic() - iterCreationBeginTime));
@@ -1831,6 +2035,7 @@ struct RocksDBKeyValueStore : IKeyValueStore {
 				    std::make_pair(ROCKSDB_READ_RANGE_KV_PAIRS_RETURNED_HISTOGRAM.toString(), result.size()));
 			}
 			const double endTime = timer_monotonic();
+			sharedState->getIOPressure().addReadLatency(endTime - readBeginTime);
 			if (a.getHistograms) {
 				metricPromiseStream->send(
 				    std::make_pair(ROCKSDB_READRANGE_ACTION_HISTOGRAM.toString(), endTime - readBeginTime));
@@ -1867,7 +2072,10 @@ struct RocksDBKeyValueStore : IKeyValueStore {
 			readThreads = CoroThreadPool::createThreadPool();
 		} else {
 			writeThread = createGenericThreadPool(/*stackSize=*/0, SERVER_KNOBS->ROCKSDB_WRITER_THREAD_PRIORITY);
-			readThreads = createGenericThreadPool(/*stackSize=*/0, SERVER_KNOBS->ROCKSDB_READER_THREAD_PRIORITY);
+			readThreads = SERVER_KNOBS->ROCKSDB_READER_WORK_STEALING
+			                  ? createWorkStealingThreadPool(
+			                        "RocksDBReaders", /*stackSize=*/0, SERVER_KNOBS->ROCKSDB_READER_THREAD_PRIORITY)
+			                  : createGenericThreadPool(/*stackSize=*/0, SERVER_KNOBS->ROCKSDB_READER_THREAD_PRIORITY);
 		}
 		if (SERVER_KNOBS->ROCKSDB_HISTOGRAMS_SAMPLE_RATE > 0) {
 			collection = actorCollection(addActor.getFuture());
@@ -2016,6 +2224,9 @@ struct RocksDBKeyValueStore : IKeyValueStore {
 		// The metrics future retains a reference to the DB, so stop it before we delete it.
 		self->metrics.reset();
 
+		// Reads in a batch which was not yet posted fail with broken_promise
+		self->readValueBatchFlush.cancel();
+		self->readValueBatch.reset();
 		wait(self->readThreads->stop());
 		self->readIterPool.reset();
 		auto a = new Writer::CloseAction(self->path, deleteOnClose);
@@ -2204,7 +2415,55 @@ struct RocksDBKeyValueStore : IKeyValueStore {
 		state FlowLock::Releaser release(*semaphore);
 
 		auto fut = a->result.getFuture();
-		pool->post(a.release());
+		ThreadActionHint hint = readActionHint(a->type);
+		pool->postWithHint(a.release(), hint);
+		Optional<Value> result = wait(fut);
+
+		return result;
+	}
+
+	// Sends the pending batch of point reads, if any, to a reader thread
+	void postReadValueBatch() {
+		if (readValueBatch) {
+			++counters.readValueBatches;
+			counters.readValueBatchKeys += readValueBatch->reads.size();
+			readThreads->post(readValueBatch.release());
+		}
+	}
+
+	ACTOR static Future<Void> flushReadValueBatch(RocksDBKeyValueStore* self) {
+		// Let the rest of this run loop iteration add to the batch
+		wait(delay(0));
+		self->postReadValueBatch();
+		return Void();
+	}
+
+	// Adds a point read to the pending batch, which is posted when it is full or at the end of the run loop iteration
+	void enqueueReadValue(Reader::ReadValueAction* a) {
+		if (!readValueBatch) {
+			readValueBatch = std::make_unique<Reader::ReadValuesAction>();
+			readValueBatchFlush = flushReadValueBatch(this);
+		}
+		readValueBatch->reads.emplace_back(a);
+		if (readValueBatch->reads.size() >= SERVER_KNOBS->ROCKSDB_READ_VALUE_BATCH_MAX_KEYS) {
+			postReadValueBatch();
+		}
+	}
+
+	ACTOR static Future<Optional<Value>> readBatched(RocksDBKeyValueStore* self,
+	                                                 Reader::ReadValueAction* action,
+	                                                 FlowLock* semaphore) {
+		state std::unique_ptr<Reader::ReadValueAction> a(action);
+		state Optional<Void> slot = wait(timeout(semaphore->take(), SERVER_KNOBS->ROCKSDB_READ_QUEUE_WAIT));
+		if (!slot.present()) {
+			++self->counters.failedToAcquire;
+			throw server_overloaded();
+		}
+
+		state FlowLock::Releaser release(*semaphore);
+
+		auto fut = a->result.getFuture();
+		self->enqueueReadValue(a.release());
 		Optional<Value> result = wait(fut);
 
 		return result;
@@ -2219,10 +2478,16 @@ struct RocksDBKeyValueStore : IKeyValueStore {
 			debugID = options.get().debugID;
 		}
 
+		bool batched = SERVER_KNOBS->ROCKSDB_READ_VALUE_BATCH_MAX_KEYS > 0;
+
 		if (!shouldThrottle(type, key)) {
 			auto a = new Reader::ReadValueAction(key, type, debugID);
 			auto res = a->result.getFuture();
-			readThreads->post(a);
+			if (batched) {
+				enqueueReadValue(a);
+			} else {
+				readThreads->postWithHint(a, readActionHint(type));
+			}
 			return res;
 		}
 
@@ -2231,6 +2496,9 @@ struct RocksDBKeyValueStore : IKeyValueStore {
 
 		checkWaiters(semaphore, maxWaiters);
 		auto a = std::make_unique<Reader::ReadValueAction>(key, type, debugID);
+		if (batched) {
+			return readBatched(this, a.release(), &semaphore);
+		}
 		return read(a.release(), &semaphore, readThreads.getPtr(), &counters.failedToAcquire);
 	}
 
@@ -2246,7 +2514,7 @@ struct RocksDBKeyValueStore : IKeyValueStore {
 		if (!shouldThrottle(type, key)) {
 			auto a = new Reader::ReadValuePrefixAction(key, maxLength, type, debugID);
 			auto res = a->result.getFuture();
-			readThreads->post(a);
+			readThreads->postWithHint(a, readActionHint(type));
 			return res;
 		}
 
@@ -2272,7 +2540,8 @@ struct RocksDBKeyValueStore : IKeyValueStore {
 		state FlowLock::Releaser release(*semaphore);
 
 		auto fut = a->result.getFuture();
-		pool->post(a.release());
+		ThreadActionHint hint = readActionHint(a->type);
+		pool->postWithHint(a.release(), hint);
 		Standalone<RangeResultRef> result = wait(fut);
 
 		return result;
@@ -2291,7 +2560,7 @@ struct RocksDBKeyValueStore : IKeyValueStore {
 		if (!shouldThrottle(type, keys.begin)) {
 			auto a = new Reader::ReadRangeAction(keys, rowLimit, byteLimit, type, counters);
 			auto res = a->result.getFuture();
-			readThreads->post(a);
+			readThreads->postWithHint(a, readActionHint(type));
 			return res;
 		}
 
@@ -2303,6 +2572,30 @@ struct RocksDBKeyValueStore : IKeyValueStore {
 		return read(a.release(), &semaphore, readThreads.getPtr(), &counters.failedToAcquire);
 	}
 
+	double getIOPressure() const override { return sharedState->getIOPressure().getPressure(); }
+
+	Future<std::vector<int64_t>> getApproximateRangeSizes(Standalone<VectorRef<KeyRef>> boundaries) override {
+		if (db == nullptr) {
+			return std::vector<int64_t>();
+		}
+		std::vector<rocksdb::Range> ranges;
+		for (int i = 0; i + 1 < boundaries.size(); i++) {
+			ranges.emplace_back(toSlice(boundaries[i]), toSlice(boundaries[i + 1]));
+		}
+		// Like getStorageBytes(), this only reads the metadata of the files and memtables, so it is done here rather
+		// than on a read thread
+		rocksdb::SizeApproximationOptions options;
+		options.include_memtables = true;
+		options.include_files = true;
+		std::vector<uint64_t> sizes(ranges.size());
+		rocksdb::Status s = db->GetApproximateSizes(options, defaultFdbCF, ranges.data(), ranges.size(), sizes.data());
+		if (!s.ok()) {
+			logRocksDBError(id, s, "GetApproximateSizes", SevWarn);
+			return std::vector<int64_t>();
+		}
+		return std::vector<int64_t>(sizes.begin(), sizes.end());
+	}
+
 	StorageBytes getStorageBytes() const override {
 		uint64_t live = 0;
 		ASSERT(db->GetAggregatedIntProperty(rocksdb::DB::Properties::kLiveSstFilesSize, &live));
@@ -2385,6 +2678,9 @@ struct RocksDBKeyValueStore : IKeyValueStore {
 	int numReadWaiters;
 	FlowLock fetchSemaphore;
 	int numFetchWaiters;
+	// Point reads waiting to be posted together, see enqueueReadValue()
+	std::unique_ptr<Reader::ReadValuesAction> readValueBatch;
+	Future<Void> readValueBatchFlush;
 	std::shared_ptr<ReadIteratorPool> readIterPool;
 	std::vector<std::unique_ptr<ThreadReturnPromiseStream<std::pair<std::string, double>>>> metricPromiseStreams;
 	// ThreadReturnPromiseStream pair.first stores the histogram name and
@@ -2596,7 +2892,7 @@ IKeyValueStore* keyValueStoreRocksDB(std::string const& path,
 namespace {
 
 TEST_CASE("noSim/fdbserver/KeyValueStoreRocksDB/RocksDBBasic") {
-	state const std::string rocksDBTestDir = "rocksdb-kvstore-basic-test-db";
+	state std::string rocksDBTestDir = "rocksdb-kvstore-basic-test-db";
 	platform::eraseDirectoryRecursive(rocksDBTestDir);
 
 	state IKeyValueStore* kvStore = new RocksDBKeyValueStore(rocksDBTestDir, deterministicRandom()->randomUniqueID());
@@ -2652,7 +2948,7 @@ TEST_CASE("noSim/fdbserver/KeyValueStoreRocksDB/RocksDBBasic") {
 }
 
 TEST_CASE("noSim/fdbserver/KeyValueStoreRocksDB/RocksDBReopen") {
-	state const std::string rocksDBTestDir = "rocksdb-kvstore-reopen-test-db";
+	state std::string rocksDBTestDir = "rocksdb-kvstore-reopen-test-db";
 	platform::eraseDirectoryRecursive(rocksDBTestDir);
 
 	state IKeyValueStore* kvStore = new RocksDBKeyValueStore(rocksDBTestDir, deterministicRandom()->randomUniqueID());
@@ -2688,6 +2984,89 @@ TEST_CASE("noSim/fdbserver/KeyValueStoreRocksDB/RocksDBReopen") {
 	return Void();
 }
 
+TEST_CASE("noSim/fdbserver/KeyValueStoreRocksDB/ReadValueBatch") {
+	state std::string rocksDBTestDir = "rocksdb-kvstore-read-batch-test-db";
+	platform::eraseDirectoryRecursive(rocksDBTestDir);
+	IKnobCollection::getMutableGlobalKnobCollection().setKnob("rocksdb_read_value_batch_max_keys",
+	                                                          KnobValueRef::create(int{ 16 }));
+
+	state IKeyValueStore* kvStore = new RocksDBKeyValueStore(rocksDBTestDir, deterministicRandom()->randomUniqueID());
+	wait(kvStore->init());
+
+	// Write the even keys, then read all of them at once so that they are batched, both full and partial batches
+	state int numKeys = 100;
+	for (int i = 0; i < numKeys; i += 2) {
+		kvStore->set({ Key(format("key%04d", i)), Value(format("value%d", i)) });
+	}
+	wait(kvStore->commit(false));
+
+	state std::vector<Future<Optional<Value>>> reads;
+	for (int i = 0; i < numKeys; ++i) {
+		ReadOptions options;
+		options.type = deterministicRandom()->coinflip() ? ReadType::NORMAL : ReadType::EAGER;
+		reads.push_back(kvStore->readValue(Key(format("key%04d", i)), options));
+	}
+	wait(waitForAll(reads));
+	for (int i = 0; i < numKeys; ++i) {
+		if (i % 2 == 0) {
+			ASSERT(reads[i].get() == Optional<Value>(Value(format("value%d", i))));
+		} else {
+			ASSERT(!reads[i].get().present());
+		}
+	}
+
+	Future<Void> closed = kvStore->onClosed();
+	kvStore->dispose();
+	wait(closed);
+
+	IKnobCollection::getMutableGlobalKnobCollection().setKnob("rocksdb_read_value_batch_max_keys",
+	                                                          KnobValueRef::create(int{ 0 }));
+	platform::eraseDirectoryRecursive(rocksDBTestDir);
+	return Void();
+}
+
+TEST_CASE("noSim/fdbserver/KeyValueStoreRocksDB/ReadRangeReadahead") {
+	state std::string rocksDBTestDir = "rocksdb-kvstore-read-range-readahead-test-db";
+	platform::eraseDirectoryRecursive(rocksDBTestDir);
+	IKnobCollection::getMutableGlobalKnobCollection().setKnob("rocksdb_read_range_readahead_min_bytes",
+	                                                          KnobValueRef::create(int64_t{ 1000 }));
+	ASSERT(rangeReadaheadBytes(100, 999) == 0);
+	ASSERT(rangeReadaheadBytes(-100, 1 << 20) == 0);
+	ASSERT(rangeReadaheadBytes(100, 1000) == 1000);
+	ASSERT_EQ((int64_t)rangeReadaheadBytes(100, std::numeric_limits<int>::max()),
+	          SERVER_KNOBS->ROCKSDB_READ_RANGE_MAX_READAHEAD_BYTES);
+
+	state IKeyValueStore* kvStore = new RocksDBKeyValueStore(rocksDBTestDir, deterministicRandom()->randomUniqueID());
+	wait(kvStore->init());
+	state int numKeys = 1000;
+	for (int i = 0; i < numKeys; ++i) {
+		kvStore->set({ Key(format("key%04d", i)), Value(std::string(100, 'v')) });
+	}
+	wait(kvStore->commit(false));
+
+	// Long scans use a readahead iterator, short and reverse ones the pooled iterators. All must return the same data.
+	state KeyRange range = KeyRangeRef("key0100"_sr, "key0900"_sr);
+	RangeResult longScan = wait(kvStore->readRange(range, 1 << 30, 1 << 30));
+	ASSERT_EQ(longScan.size(), 800);
+	ASSERT(!longScan.more);
+	ASSERT(longScan.front().key == "key0100"_sr && longScan.back().key == "key0899"_sr);
+	RangeResult shortScan = wait(kvStore->readRange(range, 1 << 30, 500));
+	ASSERT(shortScan.more);
+	ASSERT(shortScan.size() < 10 && shortScan.front().key == "key0100"_sr);
+	RangeResult reverseScan = wait(kvStore->readRange(range, -(1 << 30), 1 << 30));
+	ASSERT_EQ(reverseScan.size(), 800);
+	ASSERT(reverseScan.front().key == "key0899"_sr);
+
+	Future<Void> closed = kvStore->onClosed();
+	kvStore->dispose();
+	wait(closed);
+
+	IKnobCollection::getMutableGlobalKnobCollection().setKnob("rocksdb_read_range_readahead_min_bytes",
+	                                                          KnobValueRef::create(int64_t{ 1 << 20 }));
+	platform::eraseDirectoryRecursive(rocksDBTestDir);
+	return Void();
+}
+
 TEST_CASE("noSim/fdbserver/KeyValueStoreRocksDB/CheckpointRestoreColumnFamily") {
 	state std::string cwd = platform::getWorkingDirectory() + "/";
 	state std::string rocksDBTestDir = "rocksdb-kvstore-br-test-db";
@@ -2798,7 +3177,7 @@ TEST_CASE("noSim/fdbserver/KeyValueStoreRocksDB/CheckpointRestoreKeyValues") {
 }
 
 TEST_CASE("noSim/RocksDB/RangeClear") {
-	state const std::string rocksDBTestDir = "rocksdb-perf-db";
+	state std::string rocksDBTestDir = "rocksdb-perf-db";
 	platform::eraseDirectoryRecursive(rocksDBTestDir);
 
 	state IKeyValueStore* kvStore = new RocksDBKeyValueStore(rocksDBTestDir, deterministicRandom()->randomUniqueID());
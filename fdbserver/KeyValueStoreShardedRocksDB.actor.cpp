@@ -17,11 +17,13 @@
 #include <rocksdb/rate_limiter.h>
 #include <rocksdb/advanced_options.h>
 #include <rocksdb/slice_transform.h>
+#include <rocksdb/sst_file_writer.h>
 #include <rocksdb/statistics.h>
 #include <rocksdb/table.h>
 #include <rocksdb/utilities/checkpoint.h>
 #include <rocksdb/utilities/table_properties_collectors.h>
 #include <rocksdb/version.h>
+#include <rocksdb/write_buffer_manager.h>
 #if defined __has_include
 #if __has_include(<liburing.h>)
 #include <liburing.h>
@@ -44,7 +46,9 @@
 
 #include "fdbserver/Knobs.h"
 #include "fdbserver/IKeyValueStore.h"
+#include "fdbserver/RocksDBBlockCache.h"
 #include "fdbserver/RocksDBCheckpointUtils.actor.h"
+#include "fdbserver/RocksDBIOPressure.h"
 #include "flow/actorcompiler.h" // has to be last include
 
 #ifdef WITH_ROCKSDB
@@ -560,12 +564,21 @@ rocksdb::ColumnFamilyOptions getCFOptions() {
 		bbOpts.whole_key_filtering = false;
 	}
 
+	// Partitioned index and filters are loaded one partition at a time, so a short scan reads the partitions
+	// covering its range rather than the whole index and filter of every file it touches.
+	// https://github.com/facebook/rocksdb/wiki/Partitioned-Index-Filters
+	if (SERVER_KNOBS->ROCKSDB_PARTITIONED_INDEX_FILTERS) {
+		bbOpts.index_type = rocksdb::BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch;
+		bbOpts.partition_filters = bbOpts.filter_policy != nullptr;
+	}
+
 	options.level0_file_num_compaction_trigger = SERVER_KNOBS->SHARDED_ROCKSDB_LEVEL0_FILENUM_COMPACTION_TRIGGER;
 	options.level0_slowdown_writes_trigger = SERVER_KNOBS->SHARDED_ROCKSDB_LEVEL0_SLOWDOWN_WRITES_TRIGGER;
 	options.level0_stop_writes_trigger = SERVER_KNOBS->SHARDED_ROCKSDB_LEVEL0_STOP_WRITES_TRIGGER;
 
 	if (rocksdb_block_cache == nullptr && SERVER_KNOBS->SHARDED_ROCKSDB_BLOCK_CACHE_SIZE > 0) {
-		rocksdb_block_cache = rocksdb::NewLRUCache(SERVER_KNOBS->SHARDED_ROCKSDB_BLOCK_CACHE_SIZE);
+		rocksdb_block_cache = newRocksDBBlockCache(SERVER_KNOBS->SHARDED_ROCKSDB_BLOCK_CACHE_SIZE,
+		                                           SERVER_KNOBS->ROCKSDB_CACHE_HIGH_PRI_POOL_RATIO);
 	}
 	bbOpts.block_cache = rocksdb_block_cache;
 
@@ -600,6 +613,16 @@ rocksdb::ColumnFamilyOptions getCFOptionsForInactiveShard() {
 	return options;
 }
 
+// Memory all memtables of the instance may use, across all physical shards.
+int64_t getWriteBufferBudget() {
+	if (SERVER_KNOBS->SHARDED_ROCKSDB_MEMTABLE_MEM_FRACTION_OF_TOTAL > 0 && SERVER_KNOBS->SERVER_MEM_LIMIT > 0) {
+		return std::min<int64_t>(
+		    SERVER_KNOBS->SHARDED_ROCKSDB_TOTAL_WRITE_BUFFER_SIZE,
+		    SERVER_KNOBS->SERVER_MEM_LIMIT * SERVER_KNOBS->SHARDED_ROCKSDB_MEMTABLE_MEM_FRACTION_OF_TOTAL);
+	}
+	return SERVER_KNOBS->SHARDED_ROCKSDB_TOTAL_WRITE_BUFFER_SIZE;
+}
+
 rocksdb::DBOptions getOptions() {
 	rocksdb::DBOptions options;
 	options.avoid_unnecessary_blocking_io = true;
@@ -631,7 +654,19 @@ rocksdb::DBOptions getOptions() {
 	options.WAL_ttl_seconds = SERVER_KNOBS->ROCKSDB_WAL_TTL_SECONDS;
 	options.WAL_size_limit_MB = SERVER_KNOBS->ROCKSDB_WAL_SIZE_LIMIT_MB;
 
-	options.db_write_buffer_size = SERVER_KNOBS->SHARDED_ROCKSDB_TOTAL_WRITE_BUFFER_SIZE;
+	// All column families share one write buffer manager, so the memtable budget holds no matter how many physical
+	// shards are hosted. Optionally the memtables are charged to the block cache, making the block cache size the
+	// single bound on RocksDB's memory.
+	std::shared_ptr<rocksdb::Cache> chargedCache;
+	if (SERVER_KNOBS->SHARDED_ROCKSDB_CHARGE_MEMTABLE_TO_BLOCK_CACHE) {
+		if (rocksdb_block_cache == nullptr && SERVER_KNOBS->SHARDED_ROCKSDB_BLOCK_CACHE_SIZE > 0) {
+			rocksdb_block_cache = newRocksDBBlockCache(SERVER_KNOBS->SHARDED_ROCKSDB_BLOCK_CACHE_SIZE,
+			                                           SERVER_KNOBS->ROCKSDB_CACHE_HIGH_PRI_POOL_RATIO);
+		}
+		chargedCache = rocksdb_block_cache;
+	}
+	options.write_buffer_manager = std::make_shared<rocksdb::WriteBufferManager>(
+	    getWriteBufferBudget(), chargedCache, SERVER_KNOBS->SHARDED_ROCKSDB_WRITE_BUFFER_MANAGER_ALLOW_STALL);
 	options.statistics = rocksdb::CreateDBStatistics();
 	options.statistics->set_stats_level(rocksdb::kExceptHistogramOrTimers);
 	options.db_log_dir = g_network->isSimulated() ? "" : SERVER_KNOBS->LOG_DIRECTORY;
@@ -667,22 +702,40 @@ struct ReadIterator {
 	bool inUse;
 	std::shared_ptr<rocksdb::Iterator> iter;
 	double creationTime;
+	uint64_t generation = 0; // pool generation (shard commit count) the iterator was created at.
 	KeyRange keyRange;
 	std::shared_ptr<rocksdb::Slice> beginSlice, endSlice;
 
 	ReadIterator(rocksdb::ColumnFamilyHandle* cf, uint64_t index, rocksdb::DB* db)
 	  : index(index), inUse(true), creationTime(now()), iter(db->NewIterator(getReadOptions(), cf)) {}
-	ReadIterator(rocksdb::ColumnFamilyHandle* cf, uint64_t index, rocksdb::DB* db, const KeyRange& range)
+	ReadIterator(rocksdb::ColumnFamilyHandle* cf,
+	             uint64_t index,
+	             rocksdb::DB* db,
+	             const KeyRange& range,
+	             size_t readaheadBytes = 0)
 	  : index(index), inUse(true), creationTime(now()), keyRange(range) {
 		auto options = getReadOptions();
 		beginSlice = std::shared_ptr<rocksdb::Slice>(new rocksdb::Slice(toSlice(keyRange.begin)));
 		options.iterate_lower_bound = beginSlice.get();
 		endSlice = std::shared_ptr<rocksdb::Slice>(new rocksdb::Slice(toSlice(keyRange.end)));
 		options.iterate_upper_bound = endSlice.get();
+		options.auto_readahead_size = SERVER_KNOBS->ROCKSDB_READ_RANGE_AUTO_READAHEAD_SIZE;
+		options.readahead_size = readaheadBytes;
 		iter = std::shared_ptr<rocksdb::Iterator>(db->NewIterator(options, cf));
 	}
 };
 
+// Returns the readahead for a range read, or 0 to leave it to RocksDB's auto readahead. Only forward reads that may
+// return at least ROCKSDB_READ_RANGE_READAHEAD_MIN_BYTES are worth prefetching for, since short scans would discard
+// most of what was read ahead.
+size_t rangeReadaheadBytes(int rowLimit, int byteLimit) {
+	if (rowLimit <= 0 || SERVER_KNOBS->ROCKSDB_READ_RANGE_READAHEAD_MIN_BYTES <= 0 ||
+	    byteLimit < SERVER_KNOBS->ROCKSDB_READ_RANGE_READAHEAD_MIN_BYTES) {
+		return 0;
+	}
+	return std::min<int64_t>(byteLimit, SERVER_KNOBS->ROCKSDB_READ_RANGE_MAX_READAHEAD_BYTES);
+}
+
 /*
 ReadIteratorPool: Collection of iterators. Reuses iterators on non-concurrent multiple read operations,
 instead of creating and deleting for every read.
@@ -698,20 +751,24 @@ gets deleted as the ref count becomes 0.
 class ReadIteratorPool {
 public:
 	ReadIteratorPool(rocksdb::DB* db, rocksdb::ColumnFamilyHandle* cf, const std::string& path)
-	  : db(db), cf(cf), index(0), iteratorsReuseCount(0) {
+	  : db(db), cf(cf), index(0), iteratorsReuseCount(0), generation(0), statsCreated(0), statsReused(0),
+	    statsCreateTime(0) {
 		ASSERT(db);
 		ASSERT(cf);
 		TraceEvent(SevVerbose, "ShardedRocksReadIteratorPool")
 		    .detail("Path", path)
 		    .detail("KnobRocksDBReadRangeReuseIterators", SERVER_KNOBS->SHARDED_ROCKSDB_REUSE_ITERATORS)
-		    .detail("KnobRocksDBPrefixLen", SERVER_KNOBS->SHARDED_ROCKSDB_PREFIX_LEN);
+		    .detail("KnobRocksDBPrefixLen", SERVER_KNOBS->SHARDED_ROCKSDB_PREFIX_LEN)
+		    .detail("KnobMaxPooledIterators", SERVER_KNOBS->SHARDED_ROCKSDB_MAX_POOLED_ITERATORS);
 	}
 
-	// Called on every db commit.
+	// Called on every commit that touches this shard. Iterators handed out before the commit carry the previous
+	// generation and are dropped when they are returned.
 	void update() {
 		if (SERVER_KNOBS->SHARDED_ROCKSDB_REUSE_ITERATORS) {
 			std::lock_guard<std::mutex> lock(mutex);
 			iteratorsMap.clear();
+			generation++;
 		}
 	}
 
@@ -720,22 +777,42 @@ public:
 		// Shared iterators are not bounded.
 		if (SERVER_KNOBS->SHARDED_ROCKSDB_REUSE_ITERATORS) {
 			std::lock_guard<std::mutex> lock(mutex);
-			for (it = iteratorsMap.begin(); it != iteratorsMap.end(); it++) {
-				if (!it->second.inUse) {
+			const double expireTime = now() - SERVER_KNOBS->ROCKSDB_READ_RANGE_ITERATOR_REFRESH_TIME;
+			it = iteratorsMap.begin();
+			while (it != iteratorsMap.end()) {
+				if (it->second.inUse) {
+					it++;
+				} else if (it->second.creationTime < expireTime) {
+					// Don't hand out an iterator that the refresh loop hasn't gotten to yet, it pins old
+					// memtables and sst files.
+					it = iteratorsMap.erase(it);
+				} else {
 					it->second.inUse = true;
 					iteratorsReuseCount++;
+					statsReused++;
 					return it->second;
 				}
 			}
-			index++;
-			ReadIterator iter(cf, index, db);
-			iteratorsMap.insert({ index, iter });
+			ReadIterator iter = newIterator(++index, nullptr);
+			iter.generation = generation;
+			if (iteratorsMap.size() < (size_t)SERVER_KNOBS->SHARDED_ROCKSDB_MAX_POOLED_ITERATORS) {
+				iteratorsMap.insert({ index, iter });
+			}
 			return iter;
 		} else {
-			index++;
-			ReadIterator iter(cf, index, db, range);
-			return iter;
+			return newIterator(++index, &range);
+		}
+	}
+
+	// Returns a new iterator bounded to range that prefetches readaheadBytes at a time, for long scans. It is never
+	// pooled, since the readahead only suits the scan it was sized for.
+	ReadIterator getReadaheadIterator(const KeyRange& range, size_t readaheadBytes) {
+		uint64_t idx;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			idx = ++index;
 		}
+		return newIterator(idx, &range, readaheadBytes);
 	}
 
 	// Called on every read operation, after the keys are collected.
@@ -744,9 +821,11 @@ public:
 			std::lock_guard<std::mutex> lock(mutex);
 			it = iteratorsMap.find(iter.index);
 			// iterator found: put the iterator back to the pool(inUse=false).
-			// iterator not found: update would have removed the iterator from pool, so nothing to do.
+			// iterator not found: update would have removed the iterator from pool, or the pool was full when it was
+			// created, so nothing to do.
 			if (it != iteratorsMap.end()) {
 				ASSERT(it->second.inUse);
+				ASSERT(it->second.generation == generation);
 				it->second.inUse = false;
 			}
 		}
@@ -769,7 +848,24 @@ public:
 
 	uint64_t numTimesReadIteratorsReused() { return iteratorsReuseCount; }
 
+	// Adds the number of iterators created and reused, and the time spent creating iterators, since the last call
+	// to the given totals, then resets them. Called from the metrics logger.
+	void takeStats(uint64_t& created, uint64_t& reused, uint64_t& createTimeNs) {
+		created += statsCreated.exchange(0);
+		reused += statsReused.exchange(0);
+		createTimeNs += statsCreateTime.exchange(0);
+	}
+
 private:
+	ReadIterator newIterator(uint64_t idx, const KeyRange* range, size_t readaheadBytes = 0) {
+		const double startTime = timer_monotonic();
+		ReadIterator iter =
+		    range == nullptr ? ReadIterator(cf, idx, db) : ReadIterator(cf, idx, db, *range, readaheadBytes);
+		statsCreated++;
+		statsCreateTime += (uint64_t)((timer_monotonic() - startTime) * 1e9);
+		return iter;
+	}
+
 	std::unordered_map<int, ReadIterator> iteratorsMap;
 	std::unordered_map<int, ReadIterator>::iterator it;
 	rocksdb::DB* db;
@@ -778,6 +874,11 @@ private:
 	// incrementing counter for every new iterator creation, to uniquely identify the iterator in returnIterator().
 	uint64_t index;
 	uint64_t iteratorsReuseCount;
+	// Bumped on every update(), so pooled iterators are only ever shared within one commit of this shard.
+	uint64_t generation;
+	std::atomic<uint64_t> statsCreated;
+	std::atomic<uint64_t> statsReused;
+	std::atomic<uint64_t> statsCreateTime;
 };
 
 ACTOR Future<Void> flowLockLogger(const FlowLock* readLock, const FlowLock* fetchLock) {
@@ -965,8 +1066,33 @@ struct PhysicalShard {
 	uint64_t numRangeDeletions = 0;
 	double deleteTimeSec = 0.0;
 	double lastCompactionTime = 0.0;
+	// Write rate tracking for adaptive memtable sizing, only touched on the main thread.
+	int64_t recentWriteBytes = 0;
+	double writeRate = 0.0;
+	int64_t writeBufferSize = SERVER_KNOBS->SHARDED_ROCKSDB_WRITE_BUFFER_SIZE;
 };
 
+// Returns the memtable size for a physical shard taking `rate` of the `totalRate` bytes/s written to the instance.
+// Shards get a share of the write buffer budget proportional to their write rate, rounded down to a power of two
+// so that small rate changes do not cause option changes.
+int64_t targetWriteBufferSize(double rate, double totalRate, int64_t budget) {
+	const int64_t minSize = SERVER_KNOBS->SHARDED_ROCKSDB_MIN_WRITE_BUFFER_SIZE;
+	const int64_t maxSize = std::max(minSize, SERVER_KNOBS->SHARDED_ROCKSDB_WRITE_BUFFER_SIZE);
+	if (rate <= 0 || totalRate <= 0) {
+		return minSize;
+	}
+	const double size =
+	    budget * std::min(1.0, rate / totalRate) / std::max<int64_t>(1, SERVER_KNOBS->SHARDED_ROCKSDB_MAX_WRITE_BUFFER_NUMBER);
+	if (size <= minSize) {
+		return minSize;
+	}
+	if (size >= maxSize) {
+		return maxSize;
+	}
+	int64_t rounded = 1LL << (63 - __builtin_clzll((uint64_t)size));
+	return std::max(minSize, rounded);
+}
+
 int readRangeInDb(PhysicalShard* shard, const KeyRangeRef range, int rowLimit, int byteLimit, RangeResult* result) {
 	if (rowLimit == 0 || byteLimit == 0) {
 		return 0;
@@ -978,7 +1104,9 @@ int readRangeInDb(PhysicalShard* shard, const KeyRangeRef range, int rowLimit, i
 	// When using a prefix extractor, ensure that keys are returned in order even if they cross
 	// a prefix boundary.
 	if (rowLimit >= 0) {
-		ReadIterator readIter = shard->readIterPool->getIterator(range);
+		const size_t readaheadBytes = rangeReadaheadBytes(rowLimit, byteLimit);
+		ReadIterator readIter = readaheadBytes > 0 ? shard->readIterPool->getReadaheadIterator(range, readaheadBytes)
+		                                           : shard->readIterPool->getIterator(range);
 		auto cursor = readIter.iter;
 		cursor->Seek(toSlice(range.begin));
 		while (cursor->Valid() && toStringRef(cursor->key()) < range.end) {
@@ -1028,10 +1156,14 @@ struct Counters {
 	Counter immediateThrottle;
 	Counter failedToAcquire;
 	Counter convertedRangeDeletions;
+	Counter ingestedRanges;
+	Counter ingestedBytes;
+	Counter ingestFallbacks;
 
 	Counters()
 	  : cc("RocksDBCounters"), immediateThrottle("ImmediateThrottle", cc), failedToAcquire("FailedToAcquire", cc),
-	    convertedRangeDeletions("ConvertedRangeDeletions", cc) {}
+	    convertedRangeDeletions("ConvertedRangeDeletions", cc), ingestedRanges("IngestedRanges", cc),
+	    ingestedBytes("IngestedBytes", cc), ingestFallbacks("IngestFallbacks", cc) {}
 };
 
 // Manages physical shards and maintains logical shard mapping.
@@ -1356,6 +1488,26 @@ public:
 		return result;
 	}
 
+	// Returns the physical shard `range` can be ingested into as an external sst file, or nullptr. The whole range
+	// must belong to one initialized physical shard that has no uncommitted writes, since the ingested file becomes
+	// visible ahead of the pending write batch.
+	std::shared_ptr<PhysicalShard> getIngestTarget(KeyRangeRef range) {
+		PhysicalShard* target = nullptr;
+		auto rangeIterator = dataShardMap.intersectingRanges(range);
+		for (auto it = rangeIterator.begin(); it != rangeIterator.end(); ++it) {
+			if (it.value() == nullptr || (target != nullptr && it.value()->physicalShard != target)) {
+				return nullptr;
+			}
+			target = it.value()->physicalShard;
+		}
+		if (target == nullptr || !target->initialized() || target->deletePending || target->id == METADATA_SHARD_ID ||
+		    dirtyShards->count(target)) {
+			return nullptr;
+		}
+		auto it = physicalShards.find(target->id);
+		return it == physicalShards.end() ? nullptr : it->second;
+	}
+
 	std::vector<DataShard*> getDataShardsByRange(KeyRangeRef range) {
 		std::vector<DataShard*> result;
 		auto rangeIterator = dataShardMap.intersectingRanges(range);
@@ -1580,6 +1732,7 @@ public:
 		ASSERT(dirtyShards != nullptr);
 		writeBatch->Put(it.value()->physicalShard->cf, toSlice(key), toSlice(value));
 		dirtyShards->insert(it.value()->physicalShard);
+		it.value()->physicalShard->recentWriteBytes += key.size() + value.size();
 		TraceEvent(SevVerbose, "ShardedRocksShardManagerPutEnd", this->logId)
 		    .detail("WriteKey", key)
 		    .detail("Value", value);
@@ -1592,6 +1745,7 @@ public:
 		}
 		writeBatch->Delete(it.value()->physicalShard->cf, toSlice(key));
 		dirtyShards->insert(it.value()->physicalShard);
+		it.value()->physicalShard->recentWriteBytes += key.size();
 	}
 
 	void clearRange(KeyRangeRef range, std::set<Key>* keysSet) {
@@ -1773,6 +1927,8 @@ public:
 
 	std::unordered_map<std::string, std::shared_ptr<PhysicalShard>>* getAllShards() { return &physicalShards; }
 
+	rocksdb::RateLimiter* getRateLimiter() const { return dbOptions.rate_limiter.get(); }
+
 	std::unordered_map<uint32_t, rocksdb::ColumnFamilyHandle*>* getColumnFamilyMap() { return &columnFamilyMap; }
 
 	std::vector<rocksdb::ColumnFamilyHandle*> getColumnFamilies() {
@@ -1892,7 +2048,11 @@ public:
 	Reference<Histogram> getDeleteCompactRangeHistogram();
 	// Stat for Memory Usage
 	void logMemUsage(rocksdb::DB* db);
+	// Stat for the per-shard read iterator pools
+	void logReadIteratorPoolStats(std::unordered_map<std::string, std::shared_ptr<PhysicalShard>>* physicalShards);
 	std::vector<std::pair<std::string, int64_t>> getManifestBytes(std::string manifestDirectory);
+	// Compaction pressure and foreground read latency, shared by the Readers and the IO pressure monitor.
+	RocksDBIOPressure& getIOPressure() { return ioPressure; }
 
 private:
 	const UID debugID;
@@ -1903,6 +2063,7 @@ private:
 	std::vector<std::pair<const char*, std::string>> intPropertyStats;
 	// Iterator Pool Stats
 	std::unordered_map<std::string, uint64_t> readIteratorPoolStats;
+	RocksDBIOPressure ioPressure;
 	// PerfContext
 	std::vector<std::tuple<const char*, int, std::vector<uint64_t>>> perfContextMetrics;
 	// Readers Histogram
@@ -2211,6 +2372,26 @@ void RocksDBMetrics::logStats(rocksdb::DB* db, std::string manifestDirectory) {
 	}
 }
 
+void RocksDBMetrics::logReadIteratorPoolStats(
+    std::unordered_map<std::string, std::shared_ptr<PhysicalShard>>* physicalShards) {
+	uint64_t created = 0, reused = 0, createTimeNs = 0;
+	for (auto& [_, shard] : *physicalShards) {
+		if (shard->initialized()) {
+			shard->readIterPool->takeStats(created, reused, createTimeNs);
+		}
+	}
+	readIteratorPoolStats["NumReadIteratorsCreated"] += created;
+	readIteratorPoolStats["NumTimesReadIteratorsReused"] += reused;
+
+	TraceEvent e(SevInfo, "ShardedRocksDBReadIteratorPool", debugID);
+	e.detail("NumReadIteratorsCreated", created);
+	e.detail("NumTimesReadIteratorsReused", reused);
+	e.detail("PoolHitRate", created + reused > 0 ? (double)reused / (created + reused) : 0.0);
+	e.detail("AvgNewIteratorLatencyUs", created > 0 ? createTimeNs / created / 1000.0 : 0.0);
+	e.detail("TotalReadIteratorsCreated", readIteratorPoolStats["NumReadIteratorsCreated"]);
+	e.detail("TotalTimesReadIteratorsReused", readIteratorPoolStats["NumTimesReadIteratorsReused"]);
+}
+
 void RocksDBMetrics::logMemUsage(rocksdb::DB* db) {
 	TraceEvent e(SevInfo, "ShardedRocksDBMemMetrics", debugID);
 	uint64_t stat;
@@ -2409,6 +2590,7 @@ ACTOR Future<Void> rocksDBAggregatedMetricsLogger(std::shared_ptr<ShardedRocksDB
 			}
 			rocksDBMetrics->logStats(db, manifestDirectory);
 			rocksDBMetrics->logMemUsage(db);
+			rocksDBMetrics->logReadIteratorPoolStats(shardManager->getAllShards());
 			if (SERVER_KNOBS->ROCKSDB_PERFCONTEXT_SAMPLE_RATE != 0) {
 				rocksDBMetrics->logPerfContext(true);
 			}
@@ -2421,6 +2603,64 @@ ACTOR Future<Void> rocksDBAggregatedMetricsLogger(std::shared_ptr<ShardedRocksDB
 	return Void();
 }
 
+// Samples compaction and stall state into the shared IO pressure, and backs the background IO rate off while foreground
+// reads are slow. L0 files are counted on the most loaded shard, since each column family stalls on its own.
+ACTOR Future<Void> rocksDBIOPressureMonitor(std::shared_ptr<ShardedRocksDBState> rState,
+                                            Future<Void> openFuture,
+                                            std::shared_ptr<RocksDBMetrics> rocksDBMetrics,
+                                            ShardManager* shardManager) {
+	state rocksdb::ColumnFamilyOptions cfOptions = getCFOptions();
+	try {
+		wait(openFuture);
+		state rocksdb::DB* db = shardManager->getDb();
+		state rocksdb::RateLimiter* rateLimiter = shardManager->getRateLimiter();
+		state bool tuneRateLimiter = rateLimiter != nullptr &&
+		                             !SERVER_KNOBS->ROCKSDB_WRITE_RATE_LIMITER_AUTO_TUNE &&
+		                             SERVER_KNOBS->ROCKSDB_RATE_LIMITER_READ_LATENCY_TARGET > 0;
+		loop {
+			wait(delay(SERVER_KNOBS->ROCKSDB_IO_PRESSURE_INTERVAL));
+			if (rState->closing) {
+				break;
+			}
+			uint64_t pendingCompactionBytes = 0, delayedWriteRate = 0, writeStopped = 0;
+			db->GetAggregatedIntProperty(rocksdb::DB::Properties::kEstimatePendingCompactionBytes,
+			                             &pendingCompactionBytes);
+			db->GetIntProperty(rocksdb::DB::Properties::kActualDelayedWriteRate, &delayedWriteRate);
+			db->GetIntProperty(rocksdb::DB::Properties::kIsWriteStopped, &writeStopped);
+			uint64_t l0Files = 0;
+			for (auto& [id, shard] : *shardManager->getAllShards()) {
+				if (!shard->initialized()) {
+					continue;
+				}
+				std::string files;
+				if (db->GetProperty(shard->cf, rocksdb::DB::Properties::kNumFilesAtLevelPrefix + "0", &files) &&
+				    !files.empty()) {
+					l0Files = std::max<uint64_t>(l0Files, std::stoull(files));
+				}
+			}
+			const double pressure = RocksDBIOPressure::compute(pendingCompactionBytes,
+			                                                   cfOptions.soft_pending_compaction_bytes_limit,
+			                                                   cfOptions.hard_pending_compaction_bytes_limit,
+			                                                   l0Files,
+			                                                   cfOptions.level0_slowdown_writes_trigger,
+			                                                   cfOptions.level0_stop_writes_trigger,
+			                                                   delayedWriteRate > 0,
+			                                                   writeStopped > 0);
+			rocksDBMetrics->getIOPressure().setPressure(pressure);
+			if (tuneRateLimiter) {
+				const int64_t rate = rocksDBMetrics->getIOPressure().adjustRateLimiter(
+				    rateLimiter, SERVER_KNOBS->SHARDED_ROCKSDB_WRITE_RATE_LIMITER_BYTES_PER_SEC);
+				TraceEvent(SevDebug, "ShardedRocksDBIOPressure").detail("Pressure", pressure).detail("RateLimit", rate);
+			}
+		}
+	} catch (Error& e) {
+		if (e.code() != error_code_actor_cancelled) {
+			TraceEvent(SevError, "ShardedRocksDBIOPressureError").errorUnsuppressed(e);
+		}
+	}
+	return Void();
+}
+
 struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 	using CF = rocksdb::ColumnFamilyHandle*;
 
@@ -2524,6 +2764,51 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 		return Void();
 	}
 
+	// Writes fetched key ranges into external sst files off the writer thread.
+	struct SstFileBuilder : IThreadPoolReceiver {
+		const UID logId;
+		explicit SstFileBuilder(UID logId) : logId(logId) {}
+
+		void init() override {}
+		~SstFileBuilder() override {}
+
+		struct BuildSstAction : TypedAction<SstFileBuilder, BuildSstAction> {
+			std::string file;
+			KeyRange range;
+			Standalone<VectorRef<KeyValueRef>> data;
+			ThreadReturnPromise<bool> done;
+
+			BuildSstAction(std::string file, KeyRange range, Standalone<VectorRef<KeyValueRef>> data)
+			  : file(file), range(range), data(data) {}
+			double getTimeEstimate() const override { return SERVER_KNOBS->COMMIT_TIME_ESTIMATE; }
+		};
+
+		void action(BuildSstAction& a) {
+			rocksdb::SstFileWriter writer(rocksdb::EnvOptions(), rocksdb::Options(rocksdb::DBOptions(), getCFOptions()));
+			auto s = writer.Open(a.file);
+			// The range tombstone clears whatever the shard held in the range before. Tombstones in an ingested file
+			// don't cover point keys of the same file.
+			if (s.ok()) {
+				s = writer.DeleteRange(toSlice(a.range.begin), toSlice(a.range.end));
+			}
+			for (auto kv = a.data.begin(); s.ok() && kv != a.data.end(); ++kv) {
+				s = writer.Put(toSlice(kv->key), toSlice(kv->value));
+			}
+			if (s.ok()) {
+				s = writer.Finish();
+			}
+			if (!s.ok()) {
+				TraceEvent(SevWarn, "ShardedRocksDBBuildSstError", logId)
+				    .detail("File", a.file)
+				    .detail("Range", a.range)
+				    .detail("Status", s.ToString());
+				a.done.send(false);
+				return;
+			}
+			a.done.send(true);
+		}
+	};
+
 	struct CompactionWorker : IThreadPoolReceiver {
 		const UID logId;
 		explicit CompactionWorker(UID logId) : logId(logId) {}
@@ -2677,6 +2962,61 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 			double getTimeEstimate() const override { return SERVER_KNOBS->COMMIT_TIME_ESTIMATE; }
 		};
 
+		struct IngestAction : TypedAction<Writer, IngestAction> {
+			std::shared_ptr<PhysicalShard> shard;
+			std::string file;
+			ThreadReturnPromise<bool> done;
+
+			IngestAction(std::shared_ptr<PhysicalShard> shard, std::string file) : shard(shard), file(file) {}
+			double getTimeEstimate() const override { return SERVER_KNOBS->COMMIT_TIME_ESTIMATE; }
+		};
+
+		void action(IngestAction& a) {
+			if (!a.shard->initialized() || a.shard->deletePending) {
+				a.done.send(false);
+				return;
+			}
+			rocksdb::IngestExternalFileOptions ingestOptions;
+			ingestOptions.move_files = true;
+			ingestOptions.verify_checksums_before_ingest = SERVER_KNOBS->ROCKSDB_VERIFY_CHECKSUM_BEFORE_RESTORE;
+			auto s = a.shard->db->IngestExternalFile(a.shard->cf, { a.file }, ingestOptions);
+			if (!s.ok()) {
+				// The caller falls back to writing the range through the write batch.
+				TraceEvent(SevWarnAlways, "ShardedRocksDBIngestError", logId)
+				    .detail("ShardId", a.shard->id)
+				    .detail("File", a.file)
+				    .detail("Status", s.ToString());
+				a.done.send(false);
+				return;
+			}
+			if (SERVER_KNOBS->SHARDED_ROCKSDB_REUSE_ITERATORS) {
+				a.shard->readIterPool->update();
+			}
+			a.done.send(true);
+		}
+
+		struct SetWriteBufferSizeAction : TypedAction<Writer, SetWriteBufferSizeAction> {
+			std::vector<std::pair<std::shared_ptr<PhysicalShard>, int64_t>> shards;
+			ThreadReturnPromise<Void> done;
+
+			SetWriteBufferSizeAction(std::vector<std::pair<std::shared_ptr<PhysicalShard>, int64_t>>&& shards)
+			  : shards(std::move(shards)) {}
+			double getTimeEstimate() const override { return SERVER_KNOBS->COMMIT_TIME_ESTIMATE; }
+		};
+
+		void action(SetWriteBufferSizeAction& a) {
+			for (auto& [shard, size] : a.shards) {
+				if (!shard->initialized() || shard->deletePending) {
+					continue;
+				}
+				auto s = shard->db->SetOptions(shard->cf, { { "write_buffer_size", std::to_string(size) } });
+				if (!s.ok()) {
+					logRocksDBError(s, "SetWriteBufferSize");
+				}
+			}
+			a.done.send(Void());
+		}
+
 		void action(RemoveShardAction& a) {
 			auto start = now();
 			for (auto& shard : a.shards) {
@@ -3348,8 +3688,9 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 				a.result.sendError(statusToError(s));
 			}
 
+			double currTime = timer_monotonic();
+			rocksDBMetrics->getIOPressure().addReadLatency(currTime - readBeginTime);
 			if (a.getHistograms) {
-				double currTime = timer_monotonic();
 				rocksDBMetrics->getReadValueActionHistogram(threadIndex)->sampleSeconds(currTime - readBeginTime);
 				rocksDBMetrics->getReadValueLatencyHistogram(threadIndex)->sampleSeconds(currTime - a.startTime);
 			}
@@ -3552,8 +3893,9 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 			result.more =
 			    (result.size() == a.rowLimit) || (result.size() == -a.rowLimit) || (accumulatedBytes >= a.byteLimit);
 			a.result.send(result);
+			double currTime = timer_monotonic();
+			rocksDBMetrics->getIOPressure().addReadLatency(currTime - readBeginTime);
 			if (a.getHistograms) {
-				double currTime = timer_monotonic();
 				rocksDBMetrics->getReadRangeActionHistogram(threadIndex)->sampleSeconds(currTime - readBeginTime);
 				rocksDBMetrics->getReadRangeLatencyHistogram(threadIndex)->sampleSeconds(currTime - a.startTime);
 				if (a.shardRanges.size() > 1) {
@@ -3592,14 +3934,20 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 			TraceEvent(SevDebug, "ShardedRocksDB").detail("Info", "Use Coro threads in simulation.");
 			writeThread = CoroThreadPool::createThreadPool();
 			compactionThread = CoroThreadPool::createThreadPool();
+			ingestThread = CoroThreadPool::createThreadPool();
 			readThreads = CoroThreadPool::createThreadPool();
 		} else {
 			writeThread = createGenericThreadPool(/*stackSize=*/0, SERVER_KNOBS->ROCKSDB_WRITER_THREAD_PRIORITY);
 			compactionThread = createGenericThreadPool(0, SERVER_KNOBS->ROCKSDB_COMPACTION_THREAD_PRIORITY);
-			readThreads = createGenericThreadPool(/*stackSize=*/0, SERVER_KNOBS->ROCKSDB_READER_THREAD_PRIORITY);
+			ingestThread = createGenericThreadPool(0, SERVER_KNOBS->ROCKSDB_COMPACTION_THREAD_PRIORITY);
+			readThreads = SERVER_KNOBS->ROCKSDB_READER_WORK_STEALING
+			                  ? createWorkStealingThreadPool(
+			                        "ShardedRocksDBReaders", 0, SERVER_KNOBS->ROCKSDB_READER_THREAD_PRIORITY)
+			                  : createGenericThreadPool(/*stackSize=*/0, SERVER_KNOBS->ROCKSDB_READER_THREAD_PRIORITY);
 		}
 		writeThread->addThread(new Writer(id, 0, shardManager.getColumnFamilyMap(), rocksDBMetrics), "fdb-rocksdb-wr");
 		compactionThread->addThread(new CompactionWorker(id), "fdb-rocksdb-cw");
+		ingestThread->addThread(new SstFileBuilder(id), "fdb-rocksdb-sst");
 		TraceEvent("ShardedRocksDBReadThreads", id)
 		    .detail("KnobRocksDBReadParallelism", SERVER_KNOBS->ROCKSDB_READ_PARALLELISM);
 		for (unsigned i = 0; i < SERVER_KNOBS->ROCKSDB_READ_PARALLELISM; ++i) {
@@ -3616,6 +3964,7 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 		self->refreshHolder.cancel();
 		self->refreshRocksDBBackgroundWorkHolder.cancel();
 		self->cleanUpJob.cancel();
+		self->writeBufferTuner.cancel();
 		self->counterLogger.cancel();
 
 		try {
@@ -3635,6 +3984,7 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 		}
 
 		try {
+			wait(self->ingestThread->stop());
 			wait(self->writeThread->stop());
 			wait(self->compactionThread->stop());
 		} catch (Error& e) {
@@ -3669,16 +4019,20 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 			// of opening and closing multiple rocksdb instances, we reconcile the shard map using persist shard
 			// mapping data.
 		} else {
+			platform::eraseDirectoryRecursive(joinPath(path, "ingest"));
 			auto a = std::make_unique<Writer::OpenAction>(&shardManager, metrics, &readSemaphore, &fetchSemaphore);
 			openFuture = a->done.getFuture();
 			this->metrics =
 			    ShardManager::shardMetricsLogger(this->rState, openFuture, &shardManager) &&
-			    rocksDBAggregatedMetricsLogger(this->rState, openFuture, rocksDBMetrics, &shardManager, this->path);
+			    rocksDBAggregatedMetricsLogger(this->rState, openFuture, rocksDBMetrics, &shardManager, this->path) &&
+			    rocksDBIOPressureMonitor(this->rState, openFuture, rocksDBMetrics, &shardManager);
 			this->compactionJob = compactShards(this->rState, openFuture, &shardManager, compactionThread);
 			this->refreshHolder = refreshReadIteratorPools(this->rState, openFuture, shardManager.getAllShards());
 			this->refreshRocksDBBackgroundWorkHolder =
 			    refreshRocksDBBackgroundEventCounter(this->id, this->eventListener);
 			this->cleanUpJob = emptyShardCleaner(this->rState, openFuture, &shardManager, writeThread);
+			this->writeBufferTuner = tuneWriteBufferSizes(
+			    this->id, this->rState, openFuture, &shardManager, dbOptions.write_buffer_manager, writeThread);
 			writeThread->post(a.release());
 			counterLogger = counters.cc.traceCounters("RocksDBCounters", id, SERVER_KNOBS->ROCKSDB_METRICS_DELAY);
 			return openFuture;
@@ -3714,6 +4068,64 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 		}
 	}
 
+	// Large fetched blocks are written into an sst file on the ingest thread and ingested into the target column
+	// family, skipping the memtable and the WAL. Anything that can't be ingested safely goes through the write batch.
+	Future<Void> replaceRange(KeyRange range, Standalone<VectorRef<KeyValueRef>> data) override {
+		if (SERVER_KNOBS->SHARDED_ROCKSDB_INGEST_FETCHED_RANGES && !range.empty() && !data.empty() &&
+		    data.expectedSize() >= SERVER_KNOBS->SHARDED_ROCKSDB_INGEST_MIN_BYTES) {
+			std::shared_ptr<PhysicalShard> shard = shardManager.getIngestTarget(range);
+			if (shard) {
+				return ingestRange(this, shard, range, data);
+			}
+		}
+		return IKeyValueStore::replaceRange(range, data);
+	}
+
+	ACTOR static Future<Void> ingestRange(ShardedRocksDBKeyValueStore* self,
+	                                      std::shared_ptr<PhysicalShard> shard,
+	                                      KeyRange range,
+	                                      Standalone<VectorRef<KeyValueRef>> data) {
+		state std::string dir = joinPath(self->path, "ingest");
+		state std::string file = joinPath(dir, deterministicRandom()->randomUniqueID().toString() + ".sst");
+		state bool ingested = false;
+		state bool posted = false;
+		try {
+			platform::createDirectory(dir);
+			auto build = new SstFileBuilder::BuildSstAction(file, range, data);
+			Future<bool> buildDone = build->done.getFuture();
+			self->ingestThread->post(build);
+			bool built = wait(buildDone);
+
+			// Writes may have reached the shard while the file was built, in which case ingesting now would put the
+			// fetched data on top of them.
+			if (built && self->shardManager.getIngestTarget(range) == shard) {
+				auto a = new Writer::IngestAction(shard, file);
+				Future<bool> f = a->done.getFuture();
+				self->writeThread->post(a);
+				posted = true;
+				bool ok = wait(f);
+				ingested = ok;
+			}
+		} catch (Error& e) {
+			// Leave the file to a posted ingest, leftovers are removed when the store is next opened.
+			if (!posted) {
+				deleteFile(file);
+			}
+			throw;
+		}
+		// With move_files the ingested file is linked into the db, so this only removes our name for it.
+		deleteFile(file);
+
+		if (ingested) {
+			++self->counters.ingestedRanges;
+			self->counters.ingestedBytes += data.expectedSize();
+			return Void();
+		}
+		++self->counters.ingestFallbacks;
+		wait(self->IKeyValueStore::replaceRange(range, data));
+		return Void();
+	}
+
 	// Checks and waits for few seconds if rocskdb is overloaded.
 	ACTOR Future<Void> checkRocksdbState(rocksdb::DB* db) {
 		state uint64_t estPendCompactBytes;
@@ -3757,6 +4169,15 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 		return type != ReadType::EAGER && !(key.startsWith(systemKeys.begin));
 	}
 
+	// Reads of a physical shard go to the same reader thread while it is free, where the shard's blocks and iterators
+	// are more likely to be in cache
+	static ThreadActionHint readHint(ReadType type, const PhysicalShard* shard) {
+		return readActionHint(type, reinterpret_cast<uintptr_t>(shard));
+	}
+	static ThreadActionHint readHint(const Reader::ReadRangeAction& a) {
+		return readHint(a.type, a.shardRanges.size() == 1 ? a.shardRanges[0].first : nullptr);
+	}
+
 	ACTOR template <class Action>
 	static Future<Optional<Value>> read(Action* action, FlowLock* semaphore, IThreadPool* pool, Counter* counter) {
 		state std::unique_ptr<Action> a(action);
@@ -3769,7 +4190,8 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 		state FlowLock::Releaser release(*semaphore);
 
 		auto fut = a->result.getFuture();
-		pool->post(a.release());
+		ThreadActionHint hint = readHint(a->type, a->shard);
+		pool->postWithHint(a.release(), hint);
 		Optional<Value> result = wait(fut);
 
 		return result;
@@ -3796,7 +4218,7 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 		if (!shouldThrottle(type, key)) {
 			auto a = new Reader::ReadValueAction(key, shard->physicalShard, type, debugID);
 			auto res = a->result.getFuture();
-			readThreads->post(a);
+			readThreads->postWithHint(a, readHint(type, a->shard));
 			return res;
 		}
 
@@ -3829,7 +4251,7 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 		if (!shouldThrottle(type, key)) {
 			auto a = new Reader::ReadValuePrefixAction(key, maxLength, shard->physicalShard, type, debugID);
 			auto res = a->result.getFuture();
-			readThreads->post(a);
+			readThreads->postWithHint(a, readHint(type, a->shard));
 			return res;
 		}
 
@@ -3855,7 +4277,8 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 		state FlowLock::Releaser release(*semaphore);
 
 		auto fut = a->result.getFuture();
-		pool->post(a.release());
+		ThreadActionHint hint = readHint(*a);
+		pool->postWithHint(a.release(), hint);
 		Standalone<RangeResultRef> result = wait(fut);
 
 		return result;
@@ -3876,7 +4299,7 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 		if (!shouldThrottle(type, keys.begin)) {
 			auto a = new Reader::ReadRangeAction(keys, shards, rowLimit, byteLimit, type);
 			auto res = a->result.getFuture();
-			readThreads->post(a);
+			readThreads->postWithHint(a, readHint(*a));
 			return res;
 		}
 
@@ -3983,6 +4406,81 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 		return Void();
 	}
 
+	// Periodically resizes the memtables of each physical shard from its recent write rate, so that cold shards
+	// don't hold as much memtable memory as hot ones under the shared write buffer manager budget.
+	ACTOR static Future<Void> tuneWriteBufferSizes(UID id,
+	                                               std::shared_ptr<ShardedRocksDBState> rState,
+	                                               Future<Void> openFuture,
+	                                               ShardManager* shardManager,
+	                                               std::shared_ptr<rocksdb::WriteBufferManager> writeBufferManager,
+	                                               Reference<IThreadPool> writeThread) {
+		state double lastTuneTime;
+		if (!SERVER_KNOBS->SHARDED_ROCKSDB_ADAPTIVE_WRITE_BUFFER_SIZE) {
+			return Void();
+		}
+		try {
+			wait(openFuture);
+			lastTuneTime = now();
+			loop {
+				wait(delay(SERVER_KNOBS->SHARDED_ROCKSDB_WRITE_BUFFER_TUNING_INTERVAL));
+				if (rState->closing) {
+					break;
+				}
+				const double elapsed = std::max(now() - lastTuneTime, 1e-3);
+				lastTuneTime = now();
+				const int64_t budget = getWriteBufferBudget();
+
+				double totalRate = 0;
+				for (auto& [_, shard] : *shardManager->getAllShards()) {
+					shard->writeRate = 0.5 * shard->writeRate + 0.5 * shard->recentWriteBytes / elapsed;
+					shard->recentWriteBytes = 0;
+					if (shard->initialized()) {
+						totalRate += shard->writeRate;
+					}
+				}
+
+				std::vector<std::pair<std::shared_ptr<PhysicalShard>, int64_t>> resized;
+				int64_t totalSize = 0;
+				for (auto& [_, shard] : *shardManager->getAllShards()) {
+					if (!shard->initialized()) {
+						continue;
+					}
+					const int64_t size = targetWriteBufferSize(shard->writeRate, totalRate, budget);
+					if (size != shard->writeBufferSize) {
+						shard->writeBufferSize = size;
+						resized.emplace_back(shard, size);
+					}
+					totalSize += size;
+				}
+
+				TraceEvent(SevDebug, "ShardedRocksDBWriteBufferTuning", id)
+				    .detail("Budget", budget)
+				    .detail("MemtableUsage", writeBufferManager ? writeBufferManager->memory_usage() : 0)
+				    .detail("WriteRate", totalRate)
+				    .detail("TotalWriteBufferSize", totalSize)
+				    .detail("ResizedShards", resized.size());
+
+				if (!resized.empty()) {
+					auto a = new Writer::SetWriteBufferSizeAction(std::move(resized));
+					Future<Void> f = a->done.getFuture();
+					writeThread->post(a);
+					wait(f);
+				}
+			}
+		} catch (Error& e) {
+			if (e.code() != error_code_actor_cancelled) {
+				TraceEvent(SevError, "ShardedRocksDBWriteBufferTuningError", id).errorUnsuppressed(e);
+			}
+		}
+		return Void();
+	}
+
+	double getIOPressure() const override { return rocksDBMetrics->getIOPressure().getPressure(); }
+
+	int64_t getWriteBufferBytes() const override {
+		return dbOptions.write_buffer_manager ? dbOptions.write_buffer_manager->memory_usage() : 0;
+	}
+
 	StorageBytes getStorageBytes() const override {
 		uint64_t live = 0;
 		ASSERT(shardManager.getDb()->GetAggregatedIntProperty(rocksdb::DB::Properties::kLiveSstFilesSize, &live));
@@ -4037,6 +4535,7 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 	std::set<Key> keysSet;
 	Reference<IThreadPool> writeThread;
 	Reference<IThreadPool> compactionThread;
+	Reference<IThreadPool> ingestThread;
 	Reference<IThreadPool> readThreads;
 	Future<Void> errorFuture;
 	Promise<Void> closePromise;
@@ -4051,6 +4550,7 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 	Future<Void> refreshHolder;
 	Future<Void> refreshRocksDBBackgroundWorkHolder;
 	Future<Void> cleanUpJob;
+	Future<Void> writeBufferTuner;
 	Future<Void> counterLogger;
 };
 
@@ -4126,7 +4626,7 @@ IKeyValueStore* keyValueStoreShardedRocksDB(std::string const& path,
 
 namespace {
 TEST_CASE("noSim/ShardedRocksDB/Initialization") {
-	state const std::string rocksDBTestDir = "sharded-rocksdb-test-db";
+	state std::string rocksDBTestDir = "sharded-rocksdb-test-db";
 	platform::eraseDirectoryRecursive(rocksDBTestDir);
 
 	state IKeyValueStore* kvStore =
@@ -4141,7 +4641,7 @@ TEST_CASE("noSim/ShardedRocksDB/Initialization") {
 }
 
 TEST_CASE("noSim/ShardedRocksDB/SingleShardRead") {
-	state const std::string rocksDBTestDir = "sharded-rocksdb-test-db";
+	state std::string rocksDBTestDir = "sharded-rocksdb-test-db";
 	platform::eraseDirectoryRecursive(rocksDBTestDir);
 
 	state IKeyValueStore* kvStore =
@@ -4169,6 +4669,51 @@ TEST_CASE("noSim/ShardedRocksDB/SingleShardRead") {
 	return Void();
 }
 
+TEST_CASE("noSim/ShardedRocksDB/IngestReplaceRange") {
+	state std::string rocksDBTestDir = "sharded-rocksdb-test-db";
+	platform::eraseDirectoryRecursive(rocksDBTestDir);
+	IKnobCollection::getMutableGlobalKnobCollection().setKnob("sharded_rocksdb_ingest_fetched_ranges",
+	                                                          KnobValueRef::create(bool{ true }));
+	IKnobCollection::getMutableGlobalKnobCollection().setKnob("sharded_rocksdb_ingest_min_bytes",
+	                                                          KnobValueRef::create(int{ 1 }));
+
+	state ShardedRocksDBKeyValueStore* rocksdbStore =
+	    new ShardedRocksDBKeyValueStore(rocksDBTestDir, deterministicRandom()->randomUniqueID());
+	state IKeyValueStore* kvStore = rocksdbStore;
+	wait(kvStore->init());
+
+	wait(kvStore->addRange(KeyRangeRef("a"_sr, "b"_sr), "shard-1"));
+	kvStore->set({ "a"_sr, "stale"_sr });
+	kvStore->set({ "az"_sr, "stale"_sr });
+	wait(kvStore->commit(false));
+
+	// A range with no pending writes is ingested, and replaces what the shard had.
+	state Standalone<VectorRef<KeyValueRef>> data;
+	data.push_back_deep(data.arena(), KeyValueRef("a"_sr, "1"_sr));
+	data.push_back_deep(data.arena(), KeyValueRef("ab"_sr, "2"_sr));
+	wait(kvStore->replaceRange(KeyRangeRef("a"_sr, "b"_sr), data));
+	ASSERT_EQ(rocksdbStore->counters.ingestedRanges.getValue(), 1);
+
+	RangeResult result = wait(kvStore->readRange(KeyRangeRef("a"_sr, "b"_sr), 1000, 10000));
+	ASSERT_EQ(result.size(), 2);
+	ASSERT(result[0] == KeyValueRef("a"_sr, "1"_sr));
+	ASSERT(result[1] == KeyValueRef("ab"_sr, "2"_sr));
+
+	// A range whose shard has uncommitted writes goes through the write batch.
+	kvStore->set({ "ac"_sr, "3"_sr });
+	wait(kvStore->replaceRange(KeyRangeRef("a"_sr, "b"_sr), data));
+	ASSERT_EQ(rocksdbStore->counters.ingestedRanges.getValue(), 1);
+	wait(kvStore->commit(false));
+
+	IKnobCollection::getMutableGlobalKnobCollection().setKnob("sharded_rocksdb_ingest_fetched_ranges",
+	                                                          KnobValueRef::create(bool{ false }));
+	Future<Void> closed = kvStore->onClosed();
+	kvStore->dispose();
+	wait(closed);
+	ASSERT(!directoryExists(rocksDBTestDir));
+	return Void();
+}
+
 TEST_CASE("noSim/ShardedRocksDB/RangeOps") {
 	state std::string rocksDBTestDir = "sharded-rocksdb-kvs-test-db";
 	platform::eraseDirectoryRecursive(rocksDBTestDir);
@@ -4585,6 +5130,31 @@ TEST_CASE("noSim/ShardedRocksDB/Metadata") {
 	return Void();
 }
 
+TEST_CASE("noSim/ShardedRocksDB/AdaptiveWriteBufferSize") {
+	IKnobCollection::getMutableGlobalKnobCollection().setKnob("sharded_rocksdb_min_write_buffer_size",
+	                                                          KnobValueRef::create(int64_t{ 1 << 20 }));
+	IKnobCollection::getMutableGlobalKnobCollection().setKnob("sharded_rocksdb_write_buffer_size",
+	                                                          KnobValueRef::create(int64_t{ 16 << 20 }));
+	IKnobCollection::getMutableGlobalKnobCollection().setKnob("sharded_rocksdb_max_write_buffer_number",
+	                                                          KnobValueRef::create(int64_t{ 4 }));
+	const int64_t budget = 256 << 20;
+
+	// Idle shards get the minimum.
+	ASSERT_EQ(targetWriteBufferSize(0, 0, budget), 1 << 20);
+	ASSERT_EQ(targetWriteBufferSize(0, 100, budget), 1 << 20);
+	// A shard taking all writes is capped at the configured write buffer size.
+	ASSERT_EQ(targetWriteBufferSize(100, 100, budget), 16 << 20);
+	// 5% of a 256MB budget over 4 memtables is 3.2MB, rounded down to 2MB.
+	ASSERT_EQ(targetWriteBufferSize(5, 100, budget), 2 << 20);
+	// Sizes never exceed the budget share, so the sum over all shards stays within it.
+	int64_t total = 0;
+	for (int i = 0; i < 20; ++i) {
+		total += targetWriteBufferSize(1, 20, budget) * 4;
+	}
+	ASSERT_LE(total, budget);
+	return Void();
+}
+
 TEST_CASE("noSim/ShardedRocksDB/CheckpointBasic") {
 	state std::string rocksDBTestDir = "sharded-rocks-checkpoint-restore";
 	state std::map<Key, Value> kvs({ { "a"_sr, "TestValueA"_sr },
@@ -41,17 +41,29 @@ struct LogRouterData {
 		Version durableKnownCommittedVersion;
 		Tag tag;
 
+		// The messages last serialized for a peek of this tag. A later peek from the same begin version is sent the
+		// same buffer, as long as it would not get anything more.
+		struct SerializedPeek {
+			Version begin = invalidVersion;
+			Version end = invalidVersion;
+			Version atVersion = invalidVersion; // The log router's version when the messages were serialized
+			Standalone<StringRef> messages;
+		};
+		SerializedPeek lastPeek;
+
 		TagData(Tag tag, Version popped, Version durableKnownCommittedVersion)
 		  : popped(popped), durableKnownCommittedVersion(durableKnownCommittedVersion), tag(tag) {}
 
 		TagData(TagData&& r) noexcept
 		  : version_messages(std::move(r.version_messages)), popped(r.popped),
-		    durableKnownCommittedVersion(r.durableKnownCommittedVersion), tag(r.tag) {}
+		    durableKnownCommittedVersion(r.durableKnownCommittedVersion), tag(r.tag),
+		    lastPeek(std::move(r.lastPeek)) {}
 		void operator=(TagData&& r) noexcept {
 			version_messages = std::move(r.version_messages);
 			tag = r.tag;
 			popped = r.popped;
 			durableKnownCommittedVersion = r.durableKnownCommittedVersion;
+			lastPeek = std::move(r.lastPeek);
 		}
 
 		// Erase messages not needed to update *from* versions >= before (thus, messages with toversion <= before)
@@ -90,6 +102,22 @@ struct LogRouterData {
 	                                  // popped by remote tLog.
 	Version poppedVersion;
 	Deque<std::pair<Version, Standalone<VectorRef<uint8_t>>>> messageBlocks;
+
+	// A version pulled from the primary which remote tLogs have not yet popped enough to make room for
+	struct PrefetchedVersion {
+		Version version;
+		Arena arena; // Holds the tags, and the peek replies the messages point into
+		std::vector<TagsAndMessage> messages;
+		int64_t bytes = 0;
+
+		explicit PrefetchedVersion(Version version) : version(version) {}
+	};
+	// Pulling from the primary runs up to LOG_ROUTER_PREFETCH_BYTES ahead of what remote tLogs can take, so that a
+	// burst is already across the WAN by the time the slowest of them catches up.
+	Deque<PrefetchedVersion> prefetched;
+	int64_t prefetchedBytes = 0;
+	NotifiedVersion fetchedVersion; // The largest version pulled from the primary, which may not be in version yet
+	AsyncTrigger prefetchedCommitted;
 	Tag routerTag;
 	bool allowPops;
 	LogSet logSet;
@@ -112,6 +140,7 @@ struct LogRouterData {
 	Counter getMoreCount; // Increase by 1 when LR tries to pull data from satellite tLog.
 	Counter
 	    getMoreBlockedCount; // Increase by 1 if data is not available when LR tries to pull data from satellite tLog.
+	Counter peekRepliesShared; // Peeks sent messages already serialized for an earlier peek from the same version
 	Future<Void> logger;
 	Reference<EventCacheHolder> eventCacheHolder;
 	int activePeekStreams = 0;
@@ -135,11 +164,12 @@ struct LogRouterData {
 
 	LogRouterData(UID dbgid, const InitializeLogRouterRequest& req)
 	  : dbgid(dbgid), logSystem(new AsyncVar<Reference<ILogSystem>>()), version(req.startVersion - 1), minPopped(0),
-	    startVersion(req.startVersion), minKnownCommittedVersion(0), poppedVersion(0), routerTag(req.routerTag),
-	    allowPops(false), foundEpochEnd(false), generation(req.recoveryCount),
+	    startVersion(req.startVersion), minKnownCommittedVersion(0), poppedVersion(0),
+	    fetchedVersion(req.startVersion - 1), routerTag(req.routerTag), allowPops(false), foundEpochEnd(false),
+	    generation(req.recoveryCount),
 	    peekLatencyDist(Histogram::getHistogram("LogRouter"_sr, "PeekTLogLatency"_sr, Histogram::Unit::milliseconds)),
 	    cc("LogRouter", dbgid.toString()), getMoreCount("GetMoreCount", cc),
-	    getMoreBlockedCount("GetMoreBlockedCount", cc) {
+	    getMoreBlockedCount("GetMoreBlockedCount", cc), peekRepliesShared("PeekRepliesShared", cc) {
 		// setup just enough of a logSet to be able to call getPushLocations
 		logSet.logServers.resize(req.tLogLocalities.size());
 		logSet.tLogPolicy = req.tLogPolicy;
@@ -190,6 +220,8 @@ struct LogRouterData {
 		});
 		specialCounter(cc, "Generation", [this]() { return this->generation; });
 		specialCounter(cc, "ActivePeekStreams", [this]() { return this->activePeekStreams; });
+		specialCounter(cc, "FetchedVersion", [this]() { return this->fetchedVersion.get(); });
+		specialCounter(cc, "PrefetchedBytes", [this]() { return this->prefetchedBytes; });
 		logger = cc.traceCounters("LogRouterMetrics",
 		                          dbgid,
 		                          SERVER_KNOBS->WORKER_LOGGING_INTERVAL,
@@ -380,64 +412,97 @@ ACTOR Future<Reference<ILogSystem::IPeekCursor>> getPeekCursorData(LogRouterData
 
 // Log router (LR) asynchronously pull data from satellite tLogs (preferred) or primary tLogs at tag (self->routerTag)
 // for the version range from the LR's current version (exclusive) to its epoch's end version or recovery version.
+// Versions pulled are queued in self->prefetched, up to LOG_ROUTER_PREFETCH_BYTES, for commitPrefetchedData.
 ACTOR Future<Void> pullAsyncData(LogRouterData* self) {
 	state Reference<ILogSystem::IPeekCursor> r;
-	state Version tagAt = self->version.get() + 1;
+	state Version tagAt = self->fetchedVersion.get() + 1;
 	state Version lastVer = 0;
 	state std::vector<int> tags; // an optimization to avoid reallocating vector memory in every loop
 
 	loop {
+		while (self->prefetchedBytes > SERVER_KNOBS->LOG_ROUTER_PREFETCH_BYTES) {
+			wait(self->prefetchedCommitted.onTrigger());
+		}
+
 		Reference<ILogSystem::IPeekCursor> _r = wait(getPeekCursorData(self, r, tagAt));
 		r = _r;
 
 		self->minKnownCommittedVersion = std::max(self->minKnownCommittedVersion, r->getMinKnownCommittedVersion());
 
 		state Version ver = 0;
-		state std::vector<TagsAndMessage> messages;
-		state Arena arena;
+		state LogRouterData::PrefetchedVersion fetched(0);
+		state Arena lastReplyArena;
 		while (true) {
 			state bool foundMessage = r->hasMessage();
 			if (!foundMessage || r->version().version != ver) {
 				ASSERT(r->version().version > lastVer);
 				if (ver) {
-					wait(waitForVersionAndLog(self, ver));
-
-					commitMessages(self, ver, messages);
-					self->version.set(ver);
-					wait(yield(TaskPriority::TLogCommit));
-					//TraceEvent("LogRouterVersion").detail("Ver",ver);
+					self->prefetchedBytes += fetched.bytes;
+					self->prefetched.emplace_back(std::move(fetched));
+					self->fetchedVersion.set(ver);
 				}
 				lastVer = ver;
 				ver = r->version().version;
-				messages.clear();
-				arena = Arena();
+				fetched = LogRouterData::PrefetchedVersion(ver);
+				lastReplyArena = Arena();
 
 				if (!foundMessage) {
 					ver--; // ver is the next possible version we will get data for
-					if (ver > self->version.get() && ver >= r->popped()) {
-						wait(waitForVersionAndLog(self, ver));
-
-						self->version.set(ver);
-						wait(yield(TaskPriority::TLogCommit));
+					if (ver > self->fetchedVersion.get() && ver >= r->popped()) {
+						// Empty versions queued behind each other only need the last of them. The front one may be
+						// being committed, so it is left alone.
+						if (self->prefetched.size() > 1 && self->prefetched.back().messages.empty()) {
+							self->prefetched.back().version = ver;
+						} else {
+							self->prefetched.emplace_back(ver);
+						}
+						self->fetchedVersion.set(ver);
 					}
 					break;
 				}
 			}
 
+			// The messages stay in the cursor's peek replies, which are kept alive rather than copied
+			if (!lastReplyArena.sameArena(r->arena())) {
+				lastReplyArena = r->arena();
+				fetched.arena.dependsOn(lastReplyArena);
+			}
 			TagsAndMessage tagAndMsg;
 			tagAndMsg.message = r->getMessageWithTags();
 			tags.clear();
 			self->logSet.getPushLocations(r->getTags(), tags, 0);
-			tagAndMsg.tags.reserve(arena, tags.size());
+			tagAndMsg.tags.reserve(fetched.arena, tags.size());
 			for (const auto& t : tags) {
-				tagAndMsg.tags.push_back(arena, Tag(tagLocalityRemoteLog, t));
+				tagAndMsg.tags.push_back(fetched.arena, Tag(tagLocalityRemoteLog, t));
 			}
-			messages.push_back(std::move(tagAndMsg));
+			fetched.bytes += tagAndMsg.message.size();
+			fetched.messages.push_back(std::move(tagAndMsg));
 
 			r->nextMessage();
 		}
 
-		tagAt = std::max(r->version().version, self->version.get() + 1);
+		tagAt = std::max(r->version().version, self->fetchedVersion.get() + 1);
+	}
+}
+
+// Moves versions pulled by pullAsyncData into the log router's memory as remote tLogs pop enough to make room.
+ACTOR Future<Void> commitPrefetchedData(LogRouterData* self) {
+	loop {
+		wait(self->fetchedVersion.whenAtLeast(self->version.get() + 1));
+		while (!self->prefetched.empty()) {
+			state Version ver = self->prefetched.front().version;
+			if (ver > self->version.get()) {
+				wait(waitForVersionAndLog(self, ver));
+
+				commitMessages(self, ver, self->prefetched.front().messages);
+				self->version.set(ver);
+			}
+			self->prefetchedBytes -= self->prefetched.front().bytes;
+			self->prefetched.pop_front();
+			self->prefetchedCommitted.trigger();
+			wait(yield(TaskPriority::TLogCommit));
+			//TraceEvent("LogRouterVersion").detail("Ver",ver);
+		}
 	}
 }
 
@@ -478,6 +543,29 @@ void peekMessagesFromMemory(LogRouterData* self, Tag tag, Version begin, BinaryW
 	}
 }
 
+// Serializes the messages of tag from begin for a peek reply, and sets endVersion. Remote tLogs peeking a tag again from
+// the same version, as parallel and retried peeks do, are sent the buffer serialized for the first of them.
+Standalone<StringRef> peekSerializedMessages(LogRouterData* self, Tag tag, Version begin, Version& endVersion) {
+	auto tagData = self->getTagData(tag);
+	if (tagData && tagData->lastPeek.begin == begin &&
+	    (tagData->lastPeek.end <= tagData->lastPeek.atVersion || tagData->lastPeek.atVersion == self->version.get())) {
+		++self->peekRepliesShared;
+		endVersion = tagData->lastPeek.end;
+		return tagData->lastPeek.messages;
+	}
+
+	BinaryWriter messages(Unversioned());
+	peekMessagesFromMemory(self, tag, begin, messages, endVersion);
+	Standalone<StringRef> messagesValue = messages.toValue();
+	if (tagData && messagesValue.size()) {
+		tagData->lastPeek.begin = begin;
+		tagData->lastPeek.end = endVersion;
+		tagData->lastPeek.atVersion = self->version.get();
+		tagData->lastPeek.messages = messagesValue;
+	}
+	return messagesValue;
+}
+
 Version poppedVersion(LogRouterData* self, Tag tag) {
 	auto tagData = self->getTagData(tag);
 	if (!tagData)
@@ -494,7 +582,7 @@ Future<Void> logRouterPeekMessages(PromiseType replyPromise,
                                    bool reqReturnIfBlocked = false,
                                    bool reqOnlySpilled = false,
                                    Optional<std::pair<UID, int>> reqSequence = Optional<std::pair<UID, int>>()) {
-	state BinaryWriter messages(Unversioned());
+	state Standalone<StringRef> messages;
 	state int sequence = -1;
 	state UID peekId;
 
@@ -609,13 +697,13 @@ Future<Void> logRouterPeekMessages(PromiseType replyPromise,
 		ASSERT(reqBegin >= poppedVersion(self, reqTag) && reqBegin >= self->startVersion);
 
 		endVersion = self->version.get() + 1;
-		peekMessagesFromMemory(self, reqTag, reqBegin, messages, endVersion);
+		messages = peekSerializedMessages(self, reqTag, reqBegin, endVersion);
 
 		// Reply the peek request when
 		//   - Have data return to the caller, or
 		//   - Batching empty peek is disabled, or
 		//   - Batching empty peek interval has been reached.
-		if (messages.getLength() > 0 || !SERVER_KNOBS->PEEK_BATCHING_EMPTY_MSG ||
+		if (messages.size() > 0 || !SERVER_KNOBS->PEEK_BATCHING_EMPTY_MSG ||
 		    now() - startTime > SERVER_KNOBS->PEEK_BATCHING_EMPTY_MSG_INTERVAL) {
 			break;
 		}
@@ -635,9 +723,8 @@ Future<Void> logRouterPeekMessages(PromiseType replyPromise,
 	TLogPeekReply reply;
 	reply.maxKnownVersion = self->version.get();
 	reply.minKnownCommittedVersion = self->poppedVersion;
-	auto messagesValue = messages.toValue();
-	reply.arena.dependsOn(messagesValue.arena());
-	reply.messages = messagesValue;
+	reply.arena.dependsOn(messages.arena());
+	reply.messages = messages;
 	reply.popped = self->minPopped.get() >= self->startVersion ? self->minPopped.get() : 0;
 	reply.end = endVersion;
 	reply.onlySpilled = false;
@@ -746,6 +833,9 @@ ACTOR Future<Void> logRouterPop(LogRouterData* self, TLogPopRequest req) {
 		DebugLogTraceEvent("LogRouterPop", self->dbgid).detail("Tag", req.tag.toString()).detail("PopVersion", req.to);
 		tagData->popped = req.to;
 		tagData->durableKnownCommittedVersion = req.durableKnownCommittedVersion;
+		if (tagData->lastPeek.begin < req.to) {
+			tagData->lastPeek = LogRouterData::TagData::SerializedPeek();
+		}
 		wait(tagData->eraseMessagesBefore(req.to, self, TaskPriority::TLogPop));
 	}
 
@@ -782,6 +872,7 @@ ACTOR Future<Void> logRouterCore(TLogInterface interf,
 	state Future<Void> dbInfoChange = Void();
 
 	addActor.send(pullAsyncData(&logRouterData));
+	addActor.send(commitPrefetchedData(&logRouterData));
 	addActor.send(cleanupPeekTrackers(&logRouterData));
 	addActor.send(traceRole(Role::LOG_ROUTER, interf.id()));
 
@@ -802,6 +893,9 @@ ACTOR Future<Void> logRouterCore(TLogInterface interf,
 			    .detail("Token", interf.peekStreamMessages.getEndpoint().token);
 			addActor.send(logRouterPeekStream(&logRouterData, req));
 		}
+		when(TLogPeekTagsRequest req = waitNext(interf.peekTagsMessages.getFuture())) {
+			req.reply.sendError(unsupported_operation());
+		}
 		when(TLogPopRequest req = waitNext(interf.popMessages.getFuture())) {
 			// Request from remote tLog to pop data from LR
 			addActor.send(logRouterPop(&logRouterData, req));
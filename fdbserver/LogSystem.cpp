@@ -321,6 +321,20 @@ void LogPushData::writeMessage(StringRef rawMessageWithoutLength, bool usePrevio
 	}
 }
 
+void LogPushData::reserve(int bytes) {
+	for (auto& wr : messagesWriter) {
+		wr.reserve(bytes);
+	}
+}
+
+int LogPushData::getLargestMessagesSize() const {
+	int largest = 0;
+	for (const auto& wr : messagesWriter) {
+		largest = std::max(largest, wr.getLength());
+	}
+	return largest;
+}
+
 std::vector<Standalone<StringRef>> LogPushData::getAllMessages() const {
 	std::vector<Standalone<StringRef>> results;
 	results.reserve(messagesWriter.size());
@@ -27,6 +27,16 @@
 #include "flow/actorcompiler.h" // has to be last include
 
 // create a peek stream for cursor when it's possible
+// The compression peek requests ask TLogs for, which they only use if it makes a reply smaller. A filter this process
+// can't decompress is never asked for.
+Optional<CompressionFilter> peekCompression() {
+	CompressionFilter filter = CompressionUtils::fromFilterString(SERVER_KNOBS->TLOG_PEEK_COMPRESSION_FILTER);
+	if (filter == CompressionFilter::NONE || !CompressionUtils::supportedFilters.count(filter)) {
+		return Optional<CompressionFilter>();
+	}
+	return filter;
+}
+
 ACTOR Future<Void> tryEstablishPeekStream(ILogSystem::ServerPeekCursor* self) {
 	if (self->peekReplyStream.present())
 		return Void();
@@ -37,8 +47,11 @@ ACTOR Future<Void> tryEstablishPeekStream(ILogSystem::ServerPeekCursor* self) {
 	wait(IFailureMonitor::failureMonitor().onStateEqual(self->interf->get().interf().peekStreamMessages.getEndpoint(),
 	                                                    FailureStatus(false)));
 
-	auto req = TLogPeekStreamRequest(
-	    self->messageVersion.version, self->tag, self->returnIfBlocked, std::numeric_limits<int>::max());
+	auto req = TLogPeekStreamRequest(self->messageVersion.version,
+	                                 self->tag,
+	                                 self->returnIfBlocked,
+	                                 std::numeric_limits<int>::max(),
+	                                 peekCompression());
 	self->peekReplyStream = self->interf->get().interf().peekStreamMessages.getReplyStream(req);
 	DebugLogTraceEvent(SevDebug, "SPC_StreamCreated", self->randomID)
 	    .detail("Tag", self->tag)
@@ -57,7 +70,7 @@ ILogSystem::ServerPeekCursor::ServerPeekCursor(Reference<AsyncVar<OptionalInterf
     poppedVersion(0), hasMsg(false), randomID(deterministicRandom()->randomUniqueID()),
     returnIfBlocked(returnIfBlocked), onlySpilled(false), parallelGetMore(parallelGetMore),
     usePeekStream(SERVER_KNOBS->PEEK_USING_STREAMING), sequence(0), lastReset(0), resetCheck(Void()), slowReplies(0),
-    fastReplies(0), unknownReplies(0) {
+    fastReplies(0), unknownReplies(0), replyLatency(0), replyConsumeTime(0), lastReplyTime(0) {
 	this->results.maxKnownVersion = 0;
 	this->results.minKnownCommittedVersion = 0;
 	DebugLogTraceEvent(SevDebug, "SPC_Starting", randomID)
@@ -80,7 +93,7 @@ ILogSystem::ServerPeekCursor::ServerPeekCursor(TLogPeekReply const& results,
     end(end), poppedVersion(poppedVersion), messageAndTags(message), hasMsg(hasMsg),
     randomID(deterministicRandom()->randomUniqueID()), returnIfBlocked(false), onlySpilled(false),
     parallelGetMore(false), usePeekStream(false), sequence(0), lastReset(0), resetCheck(Void()), slowReplies(0),
-    fastReplies(0), unknownReplies(0) {
+    fastReplies(0), unknownReplies(0), replyLatency(0), replyConsumeTime(0), lastReplyTime(0) {
 	//TraceEvent("SPC_Clone", randomID);
 	this->results.maxKnownVersion = 0;
 	this->results.minKnownCommittedVersion = 0;
@@ -190,6 +203,7 @@ void ILogSystem::ServerPeekCursor::advanceTo(LogMessageVersion n) {
 // in getMore helper functions.
 void updateCursorWithReply(ILogSystem::ServerPeekCursor* self, const TLogPeekReply& res) {
 	self->results = res;
+	self->results.decompress();
 	self->onlySpilled = res.onlySpilled;
 	if (res.popped.present())
 		self->poppedVersion = std::min(std::max(self->poppedVersion, res.popped.get()), self->end.version);
@@ -225,12 +239,32 @@ ACTOR Future<Void> resetChecker(ILogSystem::ServerPeekCursor* self, NetworkAddre
 	return Void();
 }
 
+// Weight of the newest sample in the cursor's smoothed reply latency and consumption time
+static constexpr double kPeekReplySmoothing = 0.25;
+
+void smoothPeekReplySample(double& smoothed, double sample) {
+	smoothed = smoothed == 0 ? sample : smoothed + kPeekReplySmoothing * (sample - smoothed);
+}
+
+int ILogSystem::ServerPeekCursor::parallelGetMoreDepth() const {
+	const int maxDepth = SERVER_KNOBS->PARALLEL_GET_MORE_REQUESTS;
+	if (!SERVER_KNOBS->PEEK_ADAPTIVE_PARALLEL_GET_MORE || replyLatency == 0 || replyConsumeTime == 0) {
+		return maxDepth;
+	}
+	// One request more than are needed to keep replies arriving as fast as they are consumed
+	return std::clamp<double>(std::ceil(replyLatency / replyConsumeTime) + 1, 1, maxDepth);
+}
+
 ACTOR Future<TLogPeekReply> recordRequestMetrics(ILogSystem::ServerPeekCursor* self,
                                                  NetworkAddress addr,
                                                  Future<TLogPeekReply> in) {
 	try {
 		state double startTime = now();
 		TLogPeekReply t = wait(in);
+		if (t.messages.size() && t.end <= t.maxKnownVersion) {
+			// A reply the TLog cut short has the latency of a peek with nothing to wait for
+			smoothPeekReplySample(self->replyLatency, now() - startTime);
+		}
 		if (now() - self->lastReset > SERVER_KNOBS->PEEK_RESET_INTERVAL) {
 			if (now() - startTime > SERVER_KNOBS->PEEK_MAX_LATENCY) {
 				if (t.messages.size() >= SERVER_KNOBS->DESIRED_TOTAL_BYTES || SERVER_KNOBS->PEEK_COUNT_SMALL_MESSAGES) {
@@ -265,6 +299,11 @@ ACTOR Future<Void> serverPeekParallelGetMore(ILogSystem::ServerPeekCursor* self,
 		self->interfaceChanged = self->interf->onChange();
 	}
 
+	if (self->lastReplyTime != 0 && !self->hasMessage()) {
+		smoothPeekReplySample(self->replyConsumeTime, now() - self->lastReplyTime);
+		self->lastReplyTime = 0;
+	}
+
 	loop {
 		DebugLogTraceEvent("SPC_GetMoreP", self->randomID)
 		    .detail("Tag", self->tag.toString())
@@ -277,8 +316,7 @@ ACTOR Future<Void> serverPeekParallelGetMore(ILogSystem::ServerPeekCursor* self,
 		state Version expectedBegin = self->messageVersion.version;
 		try {
 			if (self->parallelGetMore || self->onlySpilled) {
-				while (self->futureResults.size() < SERVER_KNOBS->PARALLEL_GET_MORE_REQUESTS &&
-				       self->interf->get().present()) {
+				while (self->futureResults.size() < self->parallelGetMoreDepth() && self->interf->get().present()) {
 					self->futureResults.push_back(recordRequestMetrics(
 					    self,
 					    self->interf->get().interf().peekMessages.getEndpoint().getPrimaryAddress(),
@@ -287,7 +325,8 @@ ACTOR Future<Void> serverPeekParallelGetMore(ILogSystem::ServerPeekCursor* self,
 					                        self->tag,
 					                        self->returnIfBlocked,
 					                        self->onlySpilled,
-					                        std::make_pair(self->randomID, self->sequence++)),
+					                        std::make_pair(self->randomID, self->sequence++),
+					                        peekCompression()),
 					        taskID)));
 				}
 				if (self->sequence == std::numeric_limits<decltype(self->sequence)>::max()) {
@@ -308,6 +347,7 @@ ACTOR Future<Void> serverPeekParallelGetMore(ILogSystem::ServerPeekCursor* self,
 					expectedBegin = res.end;
 					self->futureResults.pop_front();
 					updateCursorWithReply(self, res);
+					self->lastReplyTime = now();
 					DebugLogTraceEvent("SPC_GetMoreReply", self->randomID)
 					    .detail("Has", self->hasMessage())
 					    .detail("Tag", self->tag.toString())
@@ -443,7 +483,9 @@ ACTOR Future<Void> serverPeekGetMore(ILogSystem::ServerPeekCursor* self, TaskPri
 				                        TLogPeekRequest(self->messageVersion.version,
 				                                        self->tag,
 				                                        self->returnIfBlocked,
-				                                        self->onlySpilled),
+				                                        self->onlySpilled,
+				                                        Optional<std::pair<UID, int>>(),
+				                                        peekCompression()),
 				                        taskID))
 				                  : Never())) {
 					updateCursorWithReply(self, res);
@@ -50,7 +50,9 @@ UDPMetricClient::UDPMetricClient()
 // ifndef guard here to avoid any compilation issues
 void UDPMetricClient::send_packet(int fd, const void* data, size_t len) {
 #ifndef WIN32
-	::send(fd, data, len, MSG_DONTWAIT);
+	if (::send(fd, data, len, MSG_DONTWAIT) < 0) {
+		TraceEvent(SevWarn, "MetricsUdpSendError").suppressFor(60.0).detail("Errno", errno).detail("Bytes", len);
+	}
 #endif
 }
 
@@ -62,9 +64,6 @@ void UDPMetricClient::send(MetricCollection* metrics) {
 	if (socket_fd == -1)
 		return;
 	if (model == OTLP) {
-		std::vector<std::vector<OTEL::OTELSum>> sums;
-		std::vector<OTEL::OTELGauge> gauges;
-
 		// Define custom serialize functions
 		auto f_sums = [](const std::vector<OTEL::OTELSum>& vec, MsgpackBuffer& buf) {
 			typedef void (*func_ptr)(const OTEL::OTELSum&, MsgpackBuffer&);
@@ -84,28 +83,33 @@ void UDPMetricClient::send(MetricCollection* metrics) {
 			serialize_vector(vec, buf, f);
 		};
 
-		std::vector<OTEL::OTELSum> currentSums;
-		size_t current_msgpack = 0;
-		for (const auto& [_, s] : metrics->sumMap) {
-			if (current_msgpack < MAX_OTELSUM_PACKET_SIZE) {
-				currentSums.push_back(std::move(s));
-				current_msgpack += s.getMsgpackBytes();
-			} else {
-				sums.push_back(std::move(currentSums));
-				currentSums.clear();
-				current_msgpack = 0;
-			}
-		}
-		if (!sums.empty()) {
-			for (const auto& currSums : sums) {
-				serialize_ext(currSums, buf, OTEL::OTELMetricType::Sum, f_sums);
-				send_packet(socket_fd, buf.buffer.get(), buf.data_size);
-				int error = errno;
-				TraceEvent("MetricsSumUdpErrno", UID()).detail("Errno", error);
-				buf.reset();
+		// Sums and gauges are packed into as few packets as possible, starting a new packet whenever the next
+		// metric would take the current one over MAX_OTEL_PACKET_SIZE
+		auto sendBatches = [this](auto& metricMap, OTEL::OTELMetricType type, auto serializeBatch) {
+			std::vector<typename std::decay_t<decltype(metricMap)>::mapped_type> batch;
+			uint32_t batchBytes = 0;
+			auto flush = [&]() {
+				if (!batch.empty()) {
+					serialize_ext(batch, buf, type, serializeBatch);
+					send_packet(socket_fd, buf.buffer.get(), buf.data_size);
+					buf.reset();
+					batch.clear();
+					batchBytes = 0;
+				}
+			};
+			for (auto& [_, m] : metricMap) {
+				uint32_t bytes = m.getMsgpackBytes();
+				if (batchBytes + bytes > MAX_OTEL_PACKET_SIZE) {
+					flush();
+				}
+				batchBytes += bytes;
+				batch.push_back(std::move(m));
 			}
-			metrics->sumMap.clear();
-		}
+			flush();
+			metricMap.clear();
+		};
+
+		sendBatches(metrics->sumMap, OTEL::OTELMetricType::Sum, f_sums);
 
 		// Each histogram should be in a separate because of their large sizes
 		// Expected DDSketch size is ~4200 entries * 9 bytes = 37800
@@ -113,33 +117,25 @@ void UDPMetricClient::send(MetricCollection* metrics) {
 			const std::vector<OTEL::OTELHistogram> singleHist{ std::move(h) };
 			serialize_ext(singleHist, buf, OTEL::OTELMetricType::Hist, f_hists);
 			send_packet(socket_fd, buf.buffer.get(), buf.data_size);
-			int error = errno;
-			TraceEvent("MetricsHistUdpErrno", UID()).detail("Errno", error);
 			buf.reset();
 		}
 
 		metrics->histMap.clear();
 
-		for (const auto& [_, g] : metrics->gaugeMap) {
-			gauges.push_back(std::move(g));
-		}
-		if (!gauges.empty()) {
-			serialize_ext(gauges, buf, OTEL::OTELMetricType::Gauge, f_gauge);
-			send_packet(socket_fd, buf.buffer.get(), buf.data_size);
-			int error = errno;
-			TraceEvent("MetricsGaugeUdpErrno", UID()).detail("Errno", error);
-			metrics->gaugeMap.clear();
-			buf.reset();
-		}
+		sendBatches(metrics->gaugeMap, OTEL::OTELMetricType::Gauge, f_gauge);
 	} else if (model == MetricsDataModel::STATSD) {
+		// Messages are separated by '\n', and a packet never ends with one, since the collector would read it as an
+		// empty message
 		std::string messages;
 		for (const auto& msg : metrics->statsd_message) {
-			// Account for max udp packet size (+1 since we add '\n')
-			if (messages.size() + msg.size() + 1 < IUDPSocket::MAX_PACKET_SIZE) {
-				messages += (std::move(msg) + '\n');
-			} else {
-				send_packet(socket_fd, buf.buffer.get(), buf.data_size);
+			if (!messages.empty() && messages.size() + msg.size() + 1 > IUDPSocket::MAX_PACKET_SIZE) {
+				send_packet(socket_fd, messages.data(), messages.size());
+				messages.clear();
+			}
+			if (!messages.empty()) {
+				messages += '\n';
 			}
+			messages += msg;
 		}
 		if (!messages.empty()) {
 			send_packet(socket_fd, messages.data(), messages.size());
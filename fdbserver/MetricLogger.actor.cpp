@@ -427,8 +427,10 @@ ACTOR Future<Void> startMetricsSimulationServer(MetricsDataModel model) {
 	switch (model) {
 	case MetricsDataModel::STATSD:
 		port = FLOW_KNOBS->STATSD_UDP_EMISSION_PORT;
+		break;
 	case MetricsDataModel::OTLP:
 		port = FLOW_KNOBS->OTEL_UDP_EMISSION_PORT;
+		break;
 	case MetricsDataModel::NONE:
 		port = 0;
 	}
@@ -1011,6 +1011,18 @@ ACTOR static Future<Void> startMoveKeys(Database occ,
 						loadedTssMapping = true;
 					}
 
+					// Get all existing shards overlapping keys (exclude any that have been processed in a previous
+					// iteration of the outer loop). The shards, the server tags and the server list are read
+					// together, so that a batch takes one round of reads rather than three and holds its conflict
+					// ranges for less time.
+					state KeyRange currentKeys = KeyRangeRef(begin, keys.end);
+					state Future<RangeResult> fOld = krmGetRanges(tr,
+					                                              keyServersPrefix,
+					                                              currentKeys,
+					                                              SERVER_KNOBS->MOVE_KEYS_KRM_LIMIT,
+					                                              SERVER_KNOBS->MOVE_KEYS_KRM_LIMIT_BYTES);
+					state Future<RangeResult> fUIDtoTagMap = tr->getRange(serverTagKeys, CLIENT_KNOBS->TOO_MANY);
+
 					std::vector<Future<Optional<Value>>> serverListEntries;
 					serverListEntries.reserve(servers.size());
 					for (int s = 0; s < servers.size(); s++)
@@ -1025,15 +1037,7 @@ ACTOR static Future<Void> startMoveKeys(Database occ,
 						}
 					}
 
-					// Get all existing shards overlapping keys (exclude any that have been processed in a previous
-					// iteration of the outer loop)
-					state KeyRange currentKeys = KeyRangeRef(begin, keys.end);
-
-					state RangeResult old = wait(krmGetRanges(tr,
-					                                          keyServersPrefix,
-					                                          currentKeys,
-					                                          SERVER_KNOBS->MOVE_KEYS_KRM_LIMIT,
-					                                          SERVER_KNOBS->MOVE_KEYS_KRM_LIMIT_BYTES));
+					state RangeResult old = wait(fOld);
 
 					// Determine the last processed key (which will be the beginning for the next iteration)
 					state Key endKey = old.end()[-1].key;
@@ -1048,7 +1052,7 @@ ACTOR static Future<Void> startMoveKeys(Database occ,
 					// 	printf("'%s': '%s'\n", old[i].key.toString().c_str(), old[i].value.toString().c_str());
 
 					// Check that enough servers for each shard are in the correct state
-					state RangeResult UIDtoTagMap = wait(tr->getRange(serverTagKeys, CLIENT_KNOBS->TOO_MANY));
+					state RangeResult UIDtoTagMap = wait(fUIDtoTagMap);
 					ASSERT(!UIDtoTagMap.more && UIDtoTagMap.size() < CLIENT_KNOBS->TOO_MANY);
 					std::vector<std::vector<UID>> addAsSource = wait(additionalSources(
 					    old, tr, servers.size(), SERVER_KNOBS->MAX_ADDED_SOURCES_MULTIPLIER * servers.size()));
@@ -1130,7 +1134,12 @@ ACTOR static Future<Void> startMoveKeys(Database occ,
 					state Error err = e;
 					if (err.code() == error_code_move_to_removed_server)
 						throw;
+					// A conflict usually means a move of a neighboring range committed first. Let other moves use
+					// the permit while this one backs off.
+					releaser.release();
 					wait(tr->onError(e));
+					wait(startMoveKeysLock->take(TaskPriority::DataDistributionLaunch));
+					releaser = FlowLock::Releaser(*startMoveKeysLock);
 
 					if (retries % 10 == 0) {
 						TraceEvent(
@@ -1309,13 +1318,15 @@ ACTOR static Future<Void> finishMoveKeys(Database occ,
 					wait(checkMoveKeysLock(&tr, lock, ddEnabledState));
 
 					state KeyRange currentKeys = KeyRangeRef(begin, keys.end);
-					state RangeResult UIDtoTagMap = wait(tr.getRange(serverTagKeys, CLIENT_KNOBS->TOO_MANY));
+					state Future<RangeResult> fUIDtoTagMap = tr.getRange(serverTagKeys, CLIENT_KNOBS->TOO_MANY);
+					state Future<RangeResult> fKeyServers = krmGetRanges(&tr,
+					                                                     keyServersPrefix,
+					                                                     currentKeys,
+					                                                     SERVER_KNOBS->MOVE_KEYS_KRM_LIMIT,
+					                                                     SERVER_KNOBS->MOVE_KEYS_KRM_LIMIT_BYTES);
+					state RangeResult UIDtoTagMap = wait(fUIDtoTagMap);
 					ASSERT(!UIDtoTagMap.more && UIDtoTagMap.size() < CLIENT_KNOBS->TOO_MANY);
-					state RangeResult keyServers = wait(krmGetRanges(&tr,
-					                                                 keyServersPrefix,
-					                                                 currentKeys,
-					                                                 SERVER_KNOBS->MOVE_KEYS_KRM_LIMIT,
-					                                                 SERVER_KNOBS->MOVE_KEYS_KRM_LIMIT_BYTES));
+					state RangeResult keyServers = wait(fKeyServers);
 
 					// Determine the last processed key (which will be the beginning for the next iteration)
 					endKey = keyServers.end()[-1].key;
@@ -1551,13 +1562,12 @@ ACTOR static Future<Void> finishMoveKeys(Database occ,
 
 					if (count == dest.size()) {
 						// update keyServers, serverKeys
-						// SOMEDAY: Doing these in parallel is safe because none of them overlap or touch (one per
-						// server)
-						wait(krmSetRangeCoalescing(
+						// Doing these in parallel is safe because none of them overlap or touch (one per server)
+						std::vector<Future<Void>> actors;
+						actors.push_back(krmSetRangeCoalescing(
 						    &tr, keyServersPrefix, currentKeys, keys, keyServersValue(UIDtoTagMap, dest)));
 
 						std::set<UID>::iterator asi = allServers.begin();
-						std::vector<Future<Void>> actors;
 						while (asi != allServers.end()) {
 							bool destHasServer = std::find(dest.begin(), dest.end(), *asi) != dest.end();
 							actors.push_back(krmSetRangeCoalescing(&tr,
@@ -1579,6 +1589,8 @@ ACTOR static Future<Void> finishMoveKeys(Database occ,
 					if (error.code() == error_code_actor_cancelled)
 						throw;
 					state Error err = error;
+					// Let other moves use the permit while this one backs off
+					releaser.release();
 					wait(tr.onError(error));
 					retries++;
 					if (retries % 10 == 0) {
@@ -1895,7 +1907,11 @@ ACTOR static Future<Void> startMoveShards(Database occ,
 					    .detail("DataMoveRange", keys)
 					    .detail("CurrentDataMoveMetaData", dataMove.toString());
 					runPreCheck = false;
+					// Let other moves use the permit while this one backs off
+					releaser.release();
 					wait(tr.onError(e));
+					wait(startMoveKeysLock->take(TaskPriority::DataDistributionLaunch));
+					releaser = FlowLock::Releaser(*startMoveKeysLock);
 				}
 			}
 		}
@@ -1330,6 +1330,9 @@ ACTOR Future<Void> serveTLogInterface(TLogData* self,
 			    .detail("Token", tli.peekStreamMessages.getEndpoint().token);
 			logData->addActor.send(tLogPeekStream(self, req, logData));
 		}
+		when(TLogPeekTagsRequest req = waitNext(tli.peekTagsMessages.getFuture())) {
+			req.reply.sendError(unsupported_operation());
+		}
 		when(TLogPopRequest req = waitNext(tli.popMessages.getFuture())) {
 			logData->addActor.send(tLogPop(self, req, logData));
 		}
@@ -1493,6 +1496,7 @@ ACTOR Future<Void> restorePersistentState(TLogData* self, LocalityData locality)
 
 		DUMPTOKEN(recruited.peekMessages);
 		DUMPTOKEN(recruited.peekStreamMessages);
+		DUMPTOKEN(recruited.peekTagsMessages);
 		DUMPTOKEN(recruited.popMessages);
 		DUMPTOKEN(recruited.commit);
 		DUMPTOKEN(recruited.lock);
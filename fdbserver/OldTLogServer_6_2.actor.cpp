@@ -2422,6 +2422,9 @@ ACTOR Future<Void> serveTLogInterface(TLogData* self,
 			    .detail("Token", tli.peekStreamMessages.getEndpoint().token);
 			logData->addActor.send(tLogPeekStream(self, req, logData));
 		}
+		when(TLogPeekTagsRequest req = waitNext(tli.peekTagsMessages.getFuture())) {
+			req.reply.sendError(unsupported_operation());
+		}
 		when(TLogPopRequest req = waitNext(tli.popMessages.getFuture())) {
 			logData->addActor.send(tLogPop(self, req, logData));
 		}
@@ -2859,6 +2862,7 @@ ACTOR Future<Void> restorePersistentState(TLogData* self,
 
 		DUMPTOKEN(recruited.peekMessages);
 		DUMPTOKEN(recruited.peekStreamMessages);
+		DUMPTOKEN(recruited.peekTagsMessages);
 		DUMPTOKEN(recruited.popMessages);
 		DUMPTOKEN(recruited.commit);
 		DUMPTOKEN(recruited.lock);
@@ -3095,6 +3099,7 @@ ACTOR Future<Void> tLogStart(TLogData* self, InitializeTLogRequest req, Locality
 
 	DUMPTOKEN(recruited.peekMessages);
 	DUMPTOKEN(recruited.peekStreamMessages);
+	DUMPTOKEN(recruited.peekTagsMessages);
 	DUMPTOKEN(recruited.popMessages);
 	DUMPTOKEN(recruited.commit);
 	DUMPTOKEN(recruited.lock);
@@ -155,6 +155,21 @@ public:
 		}
 	}
 
+	// Storage servers nowhere near being throttled can be polled less often than those that are, which saves RPCs in
+	// large clusters and lets ratekeeper catch a growing queue sooner where it matters
+	static double storageMetricsPollingDelay(StorageQueueInfo const& ss) {
+		double delay = 0;
+		if (!ss.valid) {
+			delay = SERVER_KNOBS->METRIC_UPDATE_RATE;
+		} else if (ss.getStorageQueueBytes() < SERVER_KNOBS->TARGET_BYTES_PER_STORAGE_SERVER_BATCH / 2 &&
+		           ss.getDurabilityLag() < SERVER_KNOBS->TARGET_DURABILITY_LAG_VERSIONS_BATCH / 2) {
+			delay = SERVER_KNOBS->RATEKEEPER_IDLE_STORAGE_METRIC_UPDATE_RATE;
+		} else {
+			delay = SERVER_KNOBS->RATEKEEPER_BUSY_STORAGE_METRIC_UPDATE_RATE;
+		}
+		return delay > 0 ? delay : SERVER_KNOBS->METRIC_UPDATE_RATE;
+	}
+
 	ACTOR static Future<Void> trackStorageServerQueueInfo(ActorWeakSelfRef<Ratekeeper> self,
 	                                                      StorageServerInterface ssi) {
 		self->storageQueueInfo.insert(mapPair(ssi.id(), StorageQueueInfo(self->id, ssi.id(), ssi.locality)));
@@ -187,7 +202,7 @@ public:
 					myQueueInfo->value.valid = false;
 				}
 
-				wait(delayJittered(SERVER_KNOBS->METRIC_UPDATE_RATE) &&
+				wait(delayJittered(storageMetricsPollingDelay(myQueueInfo->value)) &&
 				     IFailureMonitor::failureMonitor().onStateEqual(ssi.getQueuingMetrics.getEndpoint(),
 				                                                    FailureStatus(false)));
 			} catch (Error& e) {
@@ -378,6 +393,7 @@ public:
 			for (const auto& cpi : dbInfo->get().client.commitProxies) {
 				cpi.setThrottledShard.send(setReq);
 			}
+			self->hotShardThrottledServers[ssi] = setReq.expirationTime;
 		}
 	}
 
@@ -896,6 +912,14 @@ void Ratekeeper::updateRate(RatekeeperLimits* limits) {
 			}
 		}
 
+		// A storage engine busy with compaction drains its queue more slowly, so start throttling earlier.
+		if (SERVER_KNOBS->RATEKEEPER_IO_PRESSURE_TARGET_REDUCTION > 0 && ss.lastReply.ioPressure > 0) {
+			targetBytes = std::max<int64_t>(
+			    1,
+			    targetBytes * (1.0 - SERVER_KNOBS->RATEKEEPER_IO_PRESSURE_TARGET_REDUCTION *
+			                             std::min(ss.lastReply.ioPressure, 1.0)));
+		}
+
 		int64_t storageQueue = ss.getStorageQueueBytes();
 		worstStorageQueueStorageServer = std::max(worstStorageQueueStorageServer, storageQueue);
 
@@ -904,7 +928,17 @@ void Ratekeeper::updateRate(RatekeeperLimits* limits) {
 
 		storageDurabilityLagReverseIndex.insert(std::make_pair(-1 * storageDurabilityLag, &ss));
 
-		double targetRateRatio = std::min((storageQueue - targetBytes + springBytes) / (double)springBytes, 2.0);
+		// Throttle on where the queue is heading rather than where it is, so that a queue growing toward its target is
+		// slowed before it gets there and one draining quickly is released early, rather than overshooting both ways.
+		int64_t projectedStorageQueue = storageQueue;
+		if (SERVER_KNOBS->RATEKEEPER_STORAGE_QUEUE_LOOKAHEAD > 0) {
+			projectedStorageQueue = ss.getProjectedStorageQueueBytes(SERVER_KNOBS->RATEKEEPER_STORAGE_QUEUE_LOOKAHEAD);
+			CODE_PROBE(projectedStorageQueue > targetBytes && storageQueue <= targetBytes,
+			           "Ratekeeper throttles a storage queue projected to pass its target");
+		}
+
+		double targetRateRatio =
+		    std::min((projectedStorageQueue - targetBytes + springBytes) / (double)springBytes, 2.0);
 
 		if (limits->priority == TransactionPriority::DEFAULT) {
 			addActor.send(tagThrottler->tryUpdateAutoThrottling(ss));
@@ -964,6 +998,7 @@ void Ratekeeper::updateRate(RatekeeperLimits* limits) {
 						    .detail("SSLastReplyBytesInput", ss.lastReply.bytesInput)
 						    .detail("SSSmoothDurableBytes", ss.getSmoothDurableBytes())
 						    .detail("StorageQueue", storageQueue)
+						    .detail("ProjectedStorageQueue", projectedStorageQueue)
 						    .detail("TargetBytes", targetBytes)
 						    .detail("SpringBytes", springBytes)
 						    .detail("SSVerySmoothDurableBytesRate", ss.getVerySmoothDurableBytesRate())
@@ -995,10 +1030,32 @@ void Ratekeeper::updateRate(RatekeeperLimits* limits) {
 
 	tagThrottler->updateThrottling(storageQueueInfo);
 
+	for (auto it = hotShardThrottledServers.begin(); it != hotShardThrottledServers.end();) {
+		if (now() > it->second) {
+			it = hotShardThrottledServers.erase(it);
+		} else {
+			++it;
+		}
+	}
+
 	std::set<Optional<Standalone<StringRef>>> ignoredMachines;
+	Optional<UID> sparedHotShardServer;
 	for (auto ss = storageTpsLimitReverseIndex.begin();
 	     ss != storageTpsLimitReverseIndex.end() && ss->first < limits->tpsLimit;
 	     ++ss) {
+		if (SERVER_KNOBS->HOT_SHARD_THROTTLING_SPARES_CLUSTER &&
+		    ssReasons[ss->second->id] == limitReason_t::storage_server_write_queue_size &&
+		    hotShardThrottledServers.count(ss->second->id) &&
+		    ss->second->getStorageQueueBytes() < limits->storageTargetBytes + limits->storageSpringBytes) {
+			// The commit proxies are already rejecting writes to this server's hot shards, so the rest of the
+			// cluster need not be slowed down for it as long as its queue stays short of the point where the
+			// write queue limit would halve throughput
+			CODE_PROBE(true, "Ratekeeper leaves a hot shard throttled server to the commit proxies");
+			if (!sparedHotShardServer.present()) {
+				sparedHotShardServer = ss->second->id;
+			}
+			continue;
+		}
 		if (ignoredMachines.size() <
 		    std::min(configuration.storageTeamSize - 1, SERVER_KNOBS->MAX_MACHINES_FALLING_BEHIND)) {
 			ignoredMachines.insert(ss->second->locality.zoneId());
@@ -1443,6 +1500,9 @@ void Ratekeeper::updateRate(RatekeeperLimits* limits) {
 	ssHighWriteQueue.reset();
 	if (limitReason == limitReason_t::storage_server_write_queue_size) {
 		ssHighWriteQueue = reasonID;
+	} else if (sparedHotShardServer.present()) {
+		// Keep its hot shards throttled, or its queue would limit the cluster again when the throttle expires
+		ssHighWriteQueue = sparedHotShardServer;
 	}
 }
 
@@ -1564,6 +1624,11 @@ UpdateCommitCostRequest StorageQueueInfo::refreshCommitCost(double elapsed) {
 	return updateCommitCostRequest;
 }
 
+int64_t StorageQueueInfo::getProjectedStorageQueueBytes(double seconds) const {
+	double growthRate = smoothInputBytes.smoothRate() - smoothDurableBytes.smoothRate();
+	return std::max<int64_t>(0, getStorageQueueBytes() + growthRate * seconds);
+}
+
 Optional<double> StorageQueueInfo::getTagThrottlingRatio(int64_t storageTargetBytes, int64_t storageSpringBytes) const {
 	auto const storageQueue = getStorageQueueBytes();
 	// TODO: Remove duplicate calculation from Ratekeeper::updateRate
@@ -191,7 +191,11 @@ struct Resolver : ReferenceCounted<Resolver> {
 
 	Resolver(UID dbgid, int commitProxyCount, int resolverCount, EncryptionAtRestMode encryptMode)
 	  : dbgid(dbgid), commitProxyCount(commitProxyCount), resolverCount(resolverCount), encryptMode(encryptMode),
-	    version(-1), conflictSet(newConflictSet()), iopsSample(SERVER_KNOBS->KEY_BYTES_PER_SAMPLE),
+	    version(-1), conflictSet(SERVER_KNOBS->RESOLVER_CONFLICT_SET_BTREE
+	                                 ? newBTreeConflictSet()
+	                                 : newConflictSet(SERVER_KNOBS->RESOLVER_CONFLICT_SET_PARTITIONS,
+	                                                  SERVER_KNOBS->RESOLVER_CONFLICT_SET_MIN_PARTITION_RANGES)),
+	    iopsSample(SERVER_KNOBS->KEY_BYTES_PER_SAMPLE),
 	    cc("Resolver", dbgid.toString()), resolveBatchIn("ResolveBatchIn", cc),
 	    resolveBatchStart("ResolveBatchStart", cc), resolvedTransactions("ResolvedTransactions", cc),
 	    resolvedBytes("ResolvedBytes", cc), resolvedReadConflictRanges("ResolvedReadConflictRanges", cc),
@@ -679,6 +683,11 @@ ACTOR Future<Void> processTransactionStateRequestPart(Reference<Resolver> self,
 	}
 	pContext->receivedSequences.insert(request.sequence);
 
+	// Pass the part down the broadcast tree before applying it, so that every level applies it at once rather than each
+	// waiting for the one above. Whoever sent it is still only acknowledged once the whole subtree has it.
+	state ReplyPromise<Void> reply = request.reply;
+	state Future<Void> forwarded = broadcastTxnRequest(request, SERVER_KNOBS->TXN_STATE_SEND_AMOUNT, false);
+
 	// ASSERT(!pContext->pResolverData->validState.isSet());
 
 	for (auto& kv : request.data) {
@@ -704,13 +713,25 @@ ACTOR Future<Void> processTransactionStateRequestPart(Reference<Resolver> self,
 		pContext->processed = true;
 	}
 
-	pContext->pActors->send(broadcastTxnRequest(request, SERVER_KNOBS->TXN_STATE_SEND_AMOUNT, true));
+	wait(forwarded);
+	reply.send(Void());
 	wait(yield());
 	return Void();
 }
 
 } // anonymous namespace
 
+// Batches remove history that has left the version window in proportion to the writes they add, so a resolver whose
+// load drops keeps the history of its busiest time. This removes the rest at low priority, in between batches.
+ACTOR Future<Void> removeOldConflictHistory(Reference<Resolver> self) {
+	loop {
+		wait(delay(SERVER_KNOBS->RESOLVER_IDLE_REMOVAL_INTERVAL, TaskPriority::Low));
+		while (removeOldVersions(self->conflictSet, SERVER_KNOBS->RESOLVER_IDLE_REMOVAL_NODES)) {
+			wait(delay(0, TaskPriority::Low));
+		}
+	}
+}
+
 ACTOR Future<Void> resolverCore(ResolverInterface resolver,
                                 InitializeResolverRequest initReq,
                                 Reference<AsyncVar<ServerDBInfo> const> db) {
@@ -721,6 +742,9 @@ ACTOR Future<Void> resolverCore(ResolverInterface resolver,
 	state PromiseStream<Future<Void>> addActor;
 	actors.add(waitFailureServer(resolver.waitFailure.getFuture()));
 	actors.add(traceRole(Role::RESOLVER, resolver.id()));
+	if (SERVER_KNOBS->RESOLVER_IDLE_REMOVAL_NODES > 0) {
+		actors.add(removeOldConflictHistory(self));
+	}
 
 	TraceEvent("ResolverInit", resolver.id())
 	    .detail("RecoveryCount", initReq.recoveryCount)
@@ -0,0 +1,67 @@
+/*
+ * RocksDBBlockCache.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef WITH_ROCKSDB
+
+#include "fdbserver/RocksDBBlockCache.h"
+
+#include <mutex>
+
+#include "fdbserver/Knobs.h"
+#include "flow/Trace.h"
+#include "flow/UnitTest.h"
+
+std::shared_ptr<rocksdb::Cache> newRocksDBBlockCache(size_t capacity, double highPriPoolRatio) {
+	rocksdb::LRUCacheOptions options(capacity,
+	                                 -1, /* num_shard_bits, default value:-1*/
+	                                 false, /* strict_capacity_limit, default value:false */
+	                                 highPriPoolRatio);
+	if (SERVER_KNOBS->ROCKSDB_COMPRESSED_SECONDARY_CACHE_SIZE > 0) {
+		rocksdb::CompressedSecondaryCacheOptions secondaryOptions;
+		secondaryOptions.capacity = SERVER_KNOBS->ROCKSDB_COMPRESSED_SECONDARY_CACHE_SIZE;
+		options.secondary_cache = rocksdb::NewCompressedSecondaryCache(secondaryOptions);
+	}
+	return rocksdb::NewLRUCache(options);
+}
+
+std::shared_ptr<rocksdb::Cache> getProcessRocksDBBlockCache() {
+	// Column family options may be built on the RocksDB threads, so creation has to be synchronized.
+	static std::mutex mutex;
+	static std::shared_ptr<rocksdb::Cache> cache;
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!cache) {
+		cache = newRocksDBBlockCache(SERVER_KNOBS->ROCKSDB_BLOCK_CACHE_SIZE,
+		                             SERVER_KNOBS->ROCKSDB_CACHE_HIGH_PRI_POOL_RATIO);
+		TraceEvent("RocksDBProcessBlockCache")
+		    .detail("Capacity", SERVER_KNOBS->ROCKSDB_BLOCK_CACHE_SIZE)
+		    .detail("SecondaryCapacity", SERVER_KNOBS->ROCKSDB_COMPRESSED_SECONDARY_CACHE_SIZE);
+	}
+	return cache;
+}
+
+TEST_CASE("/fdbserver/RocksDBBlockCache/processCache") {
+	std::shared_ptr<rocksdb::Cache> cache = getProcessRocksDBBlockCache();
+	ASSERT(cache != nullptr);
+	ASSERT(cache == getProcessRocksDBBlockCache());
+	ASSERT(cache != newRocksDBBlockCache(1 << 20, 0.5));
+	return Void();
+}
+
+#endif // WITH_ROCKSDB
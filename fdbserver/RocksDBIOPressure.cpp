@@ -0,0 +1,139 @@
+/*
+ * RocksDBIOPressure.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef WITH_ROCKSDB
+
+#include "fdbserver/RocksDBIOPressure.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "fdbserver/Knobs.h"
+#include "flow/UnitTest.h"
+
+namespace {
+
+// Linear ramp from 0 at `begin` to 1 at `end`.
+double ramp(double value, double begin, double end) {
+	if (end <= begin) {
+		return 0.0;
+	}
+	return std::clamp((value - begin) / (end - begin), 0.0, 1.0);
+}
+
+} // namespace
+
+double RocksDBIOPressure::compute(uint64_t pendingCompactionBytes,
+                                  uint64_t softPendingCompactionBytesLimit,
+                                  uint64_t hardPendingCompactionBytesLimit,
+                                  uint64_t l0Files,
+                                  int l0SlowdownTrigger,
+                                  int l0StopTrigger,
+                                  bool writeDelayed,
+                                  bool writeStopped) {
+	if (writeStopped) {
+		return 1.0;
+	}
+	double p = 0.0;
+	// Start ramping at half the soft limit, so reads move away before RocksDB starts delaying writes.
+	if (softPendingCompactionBytesLimit > 0 && hardPendingCompactionBytesLimit > 0) {
+		p = std::max(p, ramp(pendingCompactionBytes, softPendingCompactionBytesLimit / 2.0, hardPendingCompactionBytesLimit));
+	}
+	if (l0SlowdownTrigger > 0 && l0StopTrigger > 0) {
+		p = std::max(p, ramp(l0Files, l0SlowdownTrigger / 2.0, l0StopTrigger));
+	}
+	if (writeDelayed) {
+		p = std::max(p, 0.5);
+	}
+	return p;
+}
+
+int64_t RocksDBIOPressure::nextRateLimit(int64_t current, int64_t maxBytesPerSec, double readLatency) {
+	const int64_t minBytesPerSec =
+	    std::max<int64_t>(1, maxBytesPerSec * SERVER_KNOBS->ROCKSDB_RATE_LIMITER_MIN_FRACTION);
+	int64_t next;
+	if (readLatency > SERVER_KNOBS->ROCKSDB_RATE_LIMITER_READ_LATENCY_TARGET) {
+		next = current * SERVER_KNOBS->ROCKSDB_RATE_LIMITER_BACKOFF;
+	} else {
+		next = current + maxBytesPerSec * SERVER_KNOBS->ROCKSDB_RATE_LIMITER_RECOVERY;
+	}
+	return std::clamp(next, minBytesPerSec, maxBytesPerSec);
+}
+
+double RocksDBIOPressure::takeReadLatency() {
+	const uint64_t count = readCount.exchange(0, std::memory_order_relaxed);
+	const uint64_t latencyNs = readLatencyNs.exchange(0, std::memory_order_relaxed);
+	return count > 0 ? latencyNs / 1e9 / count : -1.0;
+}
+
+int64_t RocksDBIOPressure::adjustRateLimiter(rocksdb::RateLimiter* limiter, int64_t maxBytesPerSec) {
+	const int64_t next = nextRateLimit(limiter->GetBytesPerSecond(), maxBytesPerSec, takeReadLatency());
+	if (next != limiter->GetBytesPerSecond()) {
+		limiter->SetBytesPerSecond(next);
+	}
+	return next;
+}
+
+TEST_CASE("/fdbserver/RocksDBIOPressure/compute") {
+	// Idle.
+	ASSERT_EQ(RocksDBIOPressure::compute(0, 64 << 20, 256 << 20, 0, 20, 36, false, false), 0.0);
+	// Limits of 0 disable the corresponding signal.
+	ASSERT_EQ(RocksDBIOPressure::compute(1 << 30, 0, 0, 100, 0, 0, false, false), 0.0);
+	// Pending compaction bytes ramp from half the soft limit to the hard limit.
+	ASSERT_EQ(RocksDBIOPressure::compute(32 << 20, 64 << 20, 256 << 20, 0, 20, 36, false, false), 0.0);
+	ASSERT(std::abs(RocksDBIOPressure::compute(144 << 20, 64 << 20, 256 << 20, 0, 20, 36, false, false) - 0.5) <
+	       1e-9);
+	ASSERT_EQ(RocksDBIOPressure::compute(512 << 20, 64 << 20, 256 << 20, 0, 20, 36, false, false), 1.0);
+	// L0 files ramp from half the slowdown trigger to the stop trigger.
+	ASSERT(std::abs(RocksDBIOPressure::compute(0, 64 << 20, 256 << 20, 23, 20, 36, false, false) - 0.5) < 1e-9);
+	// Stall state.
+	ASSERT_EQ(RocksDBIOPressure::compute(0, 64 << 20, 256 << 20, 0, 20, 36, true, false), 0.5);
+	ASSERT_EQ(RocksDBIOPressure::compute(0, 64 << 20, 256 << 20, 0, 20, 36, false, true), 1.0);
+	return Void();
+}
+
+TEST_CASE("/fdbserver/RocksDBIOPressure/nextRateLimit") {
+	IKnobCollection::getMutableGlobalKnobCollection().setKnob("rocksdb_rate_limiter_read_latency_target",
+	                                                          KnobValueRef::create(double{ 0.01 }));
+	IKnobCollection::getMutableGlobalKnobCollection().setKnob("rocksdb_rate_limiter_min_fraction",
+	                                                          KnobValueRef::create(double{ 0.1 }));
+	IKnobCollection::getMutableGlobalKnobCollection().setKnob("rocksdb_rate_limiter_backoff",
+	                                                          KnobValueRef::create(double{ 0.5 }));
+	IKnobCollection::getMutableGlobalKnobCollection().setKnob("rocksdb_rate_limiter_recovery",
+	                                                          KnobValueRef::create(double{ 0.1 }));
+	const int64_t max = 1000000;
+
+	// Slow reads back off down to the floor.
+	ASSERT_EQ(RocksDBIOPressure::nextRateLimit(max, max, 0.02), 500000);
+	ASSERT_EQ(RocksDBIOPressure::nextRateLimit(150000, max, 0.02), 100000);
+	// Fast reads, or no reads, recover up to the configured rate.
+	ASSERT_EQ(RocksDBIOPressure::nextRateLimit(500000, max, 0.001), 600000);
+	ASSERT_EQ(RocksDBIOPressure::nextRateLimit(950000, max, -1.0), max);
+
+	RocksDBIOPressure pressure;
+	ASSERT_EQ(pressure.takeReadLatency(), -1.0);
+	pressure.addReadLatency(0.001);
+	pressure.addReadLatency(0.003);
+	ASSERT(std::abs(pressure.takeReadLatency() - 0.002) < 1e-6);
+	ASSERT_EQ(pressure.takeReadLatency(), -1.0);
+	return Void();
+}
+
+#endif // WITH_ROCKSDB
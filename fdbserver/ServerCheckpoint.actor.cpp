@@ -19,6 +19,7 @@
  */
 
 #include "fdbserver/ServerCheckpoint.actor.h"
+#include "fdbclient/BackupAgent.actor.h"
 #include "fdbserver/RocksDBCheckpointUtils.actor.h"
 
 #include "flow/actorcompiler.h" // has to be last include
@@ -101,6 +102,91 @@ ACTOR Future<CheckpointMetaData> fetchCheckpointRanges(Database cx,
 	return result;
 }
 
+ACTOR Future<CheckpointMetaData> buildCheckpointFromBackup(Database cx,
+                                                           Reference<IBackupContainer> bc,
+                                                           RestorableFileSet restoreSet,
+                                                           KeyRange range,
+                                                           std::string dir) {
+	state double startTime = now();
+	state std::vector<RangeFile> files;
+	for (const RangeFile& file : restoreSet.ranges) {
+		auto it = restoreSet.keyRanges.find(file.fileName);
+		// Backups from before 6.3 don't record the key range of each range file, so their order is unknown
+		if (it == restoreSet.keyRanges.end()) {
+			throw not_implemented();
+		}
+		if (it->second.intersects(range)) {
+			files.push_back(file);
+		}
+	}
+	// SST files must not overlap, which holds for range files of a single snapshot
+	std::sort(files.begin(), files.end(), [&](const RangeFile& a, const RangeFile& b) {
+		return restoreSet.keyRanges[a.fileName].begin < restoreSet.keyRanges[b.fileName].begin;
+	});
+
+	TraceEvent("BuildCheckpointFromBackupBegin")
+	    .detail("Range", range)
+	    .detail("Files", files.size())
+	    .detail("SnapshotVersion", restoreSet.snapshot.endVersion)
+	    .detail("Dir", dir);
+
+	platform::createDirectory(dir);
+	state RocksDBCheckpointKeyValues rkv = RocksDBCheckpointKeyValues({ range });
+	state int64_t totalBytes = 0;
+	state int64_t totalKeys = 0;
+	state int fileIndex = 0;
+	for (; fileIndex < files.size(); ++fileIndex) {
+		state RangeFile file = files[fileIndex];
+		state KeyRange fileRange = restoreSet.keyRanges[file.fileName] & range;
+		state std::string localFile = joinPath(dir, format("%d.sst", fileIndex));
+		state std::unique_ptr<IRocksDBSstFileWriter> writer = newRocksDBSstFileWriter();
+		if (writer == nullptr) {
+			throw not_implemented();
+		}
+		writer->open(localFile);
+
+		state Reference<IAsyncFile> inFile = wait(bc->readFile(file.fileName));
+		state int64_t fileBytes = 0;
+		state int64_t offset = 0;
+		for (; offset < file.fileSize; offset += file.blockSize) {
+			int len = std::min<int64_t>(file.blockSize, file.fileSize - offset);
+			Standalone<VectorRef<KeyValueRef>> blockData =
+			    wait(fileBackup::decodeRangeFileBlock(inFile, offset, len, cx));
+			// The first and last keys are the block's boundaries, not data
+			for (int i = 1; i < (int)blockData.size() - 1; ++i) {
+				if (fileRange.contains(blockData[i].key)) {
+					writer->write(blockData[i].key, blockData[i].value);
+					fileBytes += blockData[i].expectedSize();
+					++totalKeys;
+				}
+			}
+			wait(yield(TaskPriority::FetchKeys));
+		}
+
+		if (writer->finish()) {
+			rkv.fetchedFiles.emplace_back(localFile, fileRange, fileBytes);
+			totalBytes += fileBytes;
+		}
+	}
+	if (rkv.fetchedFiles.empty()) {
+		rkv.fetchedFiles.emplace_back(emptySstFilePath, range, 0);
+	}
+
+	state CheckpointMetaData result = CheckpointMetaData(
+	    { range }, restoreSet.snapshot.endVersion, RocksDBKeyValues, deterministicRandom()->randomUniqueID());
+	result.dir = dir;
+	result.serializedCheckpoint = ObjectWriter::toValue(rkv, IncludeVersion());
+	result.setState(CheckpointMetaData::Complete);
+
+	TraceEvent("BuildCheckpointFromBackupEnd", result.checkpointID)
+	    .detail("Range", range)
+	    .detail("Files", rkv.fetchedFiles.size())
+	    .detail("Keys", totalKeys)
+	    .detail("Bytes", totalBytes)
+	    .detail("Duration", now() - startTime);
+	return result;
+}
+
 std::string serverCheckpointDir(const std::string& baseDir, const UID& checkpointId) {
 	return joinPath(baseDir, checkpointId.toString());
 }
@@ -22,6 +22,8 @@
 #include <memory.h>
 #include <stdio.h>
 #include <algorithm>
+#include <functional>
+#include <memory>
 #include <numeric>
 #include <string>
 #include <vector>
@@ -33,6 +35,9 @@
 #include "fdbclient/KeyRangeMap.h"
 #include "fdbclient/SystemData.h"
 #include "fdbserver/ConflictSet.h"
+#include "fdbserver/VersionHistoryBTree.h"
+#include "fdbserver/WorkerThreads.h"
+#include "flow/UnitTest.h"
 
 static std::vector<PerfDoubleCounter*> skc;
 
@@ -490,7 +495,6 @@ public:
 	//   partitions.  In between, operations on each partition must not touch any keys outside
 	//   the partition.  Specifically, the partition to the left of 'key' must not have a range
 	//	 [...,key) inserted, since that would insert an entry at 'key'.
-	// Note this function is not used.
 	void partition(StringRef* begin, int splitCount, SkipList* output) {
 		for (int i = splitCount - 1; i >= 0; i--) {
 			Finger f(header, begin[i]);
@@ -501,8 +505,7 @@ public:
 		swap(output[0]);
 	}
 
-	// Concatenates multiple SkipList objects into one and stores in input[0].
-	// Note this function is not used.
+	// Concatenates multiple SkipList objects into one and stores it in this SkipList.
 	void concatenate(SkipList* input, int count) {
 		std::vector<Finger> ends(count - 1);
 		for (int i = 0; i < ends.size(); i++)
@@ -767,6 +770,12 @@ private:
 			right.header->setNext(l, f.finger[l]->getNext(l));
 			f.finger[l]->setNext(l, nullptr);
 		}
+		// The last nodes on the left still summarize versions of nodes which are now on the right, and right's header
+		// summarizes none of them. Left alone, reads of the left would see false conflicts and the right would miss some.
+		for (int l = 1; l < MaxLevels; l++) {
+			f.finger[l]->calcVersionForLevel(l);
+			right.header->calcVersionForLevel(l);
+		}
 	}
 
 	// Sets end's finger to the last nodes at all levels.
@@ -783,19 +792,85 @@ private:
 };
 
 struct ConflictSet {
-	ConflictSet() : removalKey(makeString(0)), oldestVersion(0) {}
+	ConflictSet(int partitions, int minPartitionRanges)
+	  : removalKey(makeString(0)), oldestVersion(0), partitions(std::max(partitions, 1)),
+	    minPartitionRanges(minPartitionRanges) {
+		// Simulation must stay on one thread, so there the partitions take turns
+		if (this->partitions > 1 && !g_network->isSimulated())
+			workers = std::make_unique<WorkerThreads>(this->partitions - 1);
+	}
 	~ConflictSet() {}
 
+	// Splits versionHistory at splitKeys, calls f(part, i) for each of the resulting partitions and joins them again.
+	// f may only touch keys inside its partition.
+	void forEachPartition(std::vector<StringRef>& splitKeys, const std::function<void(SkipList&, int)>& f) {
+		std::vector<SkipList> parts(splitKeys.size() + 1);
+		versionHistory.partition(splitKeys.data(), splitKeys.size(), parts.data());
+		std::function<void(int)> job = [&](int i) { f(parts[i], i); };
+		if (workers) {
+			workers->run(parts.size(), job);
+		} else {
+			for (int i = 0; i < parts.size(); i++)
+				job(i);
+		}
+		versionHistory.concatenate(parts.data(), parts.size());
+	}
+
+	// Examines up to nodeCount more boundaries, from removalKey on, and removes those which, along with the one before
+	// them, are older than oldestVersion
+	void removeOldVersions(int nodeCount) {
+		if (removalKey.size() == 0) {
+			passVersion = oldestVersion;
+		}
+		if (btree) {
+			removalKey = btree->removeBefore(oldestVersion, removalKey, nodeCount);
+		} else {
+			SkipList::Finger finger;
+			int temp;
+			versionHistory.find(&removalKey, &finger, &temp, 1);
+			versionHistory.removeBefore(oldestVersion, finger, nodeCount);
+			removalKey = finger.getValue();
+		}
+		if (removalKey.size() == 0) {
+			removedBefore = passVersion;
+		}
+	}
+
 	SkipList versionHistory;
+	// When present, the history is kept here instead of in versionHistory
+	std::unique_ptr<VersionHistoryBTree> btree;
 	Key removalKey;
 	Version oldestVersion;
+	// Removal goes round the history in passes. Everything older than removedBefore is gone, since a whole pass has
+	// been made since oldestVersion was that; passVersion was oldestVersion when the current pass started.
+	Version passVersion = 0;
+	Version removedBefore = 0;
+
+	// Batches with at least partitions * minPartitionRanges read or write ranges are checked and merged with
+	// versionHistory split into this many key ranges, each on its own thread.
+	int partitions;
+	int minPartitionRanges;
+	std::unique_ptr<WorkerThreads> workers;
 };
 
-ConflictSet* newConflictSet() {
-	return new ConflictSet;
+ConflictSet* newConflictSet(int partitions, int minPartitionRanges) {
+	return new ConflictSet(partitions, minPartitionRanges);
+}
+ConflictSet* newBTreeConflictSet() {
+	ConflictSet* cs = new ConflictSet(1, 0);
+	cs->btree = std::make_unique<VersionHistoryBTree>();
+	return cs;
 }
 void clearConflictSet(ConflictSet* cs, Version v) {
 	SkipList(v).swap(cs->versionHistory);
+	if (cs->btree)
+		cs->btree = std::make_unique<VersionHistoryBTree>(v);
+}
+bool removeOldVersions(ConflictSet* cs, int nodeCount) {
+	if (cs->removedBefore >= cs->oldestVersion)
+		return false;
+	cs->removeOldVersions(nodeCount);
+	return cs->removedBefore < cs->oldestVersion;
 }
 void destroyConflictSet(ConflictSet* cs) {
 	delete cs;
@@ -971,11 +1046,7 @@ void ConflictBatch::detectConflicts(Version now,
 	t = timer();
 	if (newOldestVersion > cs->oldestVersion) {
 		cs->oldestVersion = newOldestVersion;
-		SkipList::Finger finger;
-		int temp;
-		cs->versionHistory.find(&cs->removalKey, &finger, &temp, 1);
-		cs->versionHistory.removeBefore(cs->oldestVersion, finger, combinedWriteConflictRanges.size() * 3 + 10);
-		cs->removalKey = finger.getValue();
+		cs->removeOldVersions(combinedWriteConflictRanges.size() * 3 + 10);
 	}
 	g_removeBefore += timer() - t;
 }
@@ -984,8 +1055,73 @@ void ConflictBatch::checkReadConflictRanges() {
 	if (combinedReadConflictRanges.empty())
 		return;
 
-	cs->versionHistory.detectConflicts(
-	    &combinedReadConflictRanges[0], combinedReadConflictRanges.size(), transactionConflictStatus);
+	if (cs->btree) {
+		for (const ReadConflictRange& range : combinedReadConflictRanges) {
+			if (cs->btree->newerThan(range.begin, range.end, range.version)) {
+				transactionConflictStatus[range.transaction] = true;
+				if (range.conflictingKeyRange != nullptr)
+					range.conflictingKeyRange->push_back(*range.cKRArena, range.indexInTx);
+			}
+		}
+		return;
+	}
+
+	// Any keys will do to split reads, so take them evenly from the sorted points of the batch
+	std::vector<StringRef> splitKeys;
+	if (cs->partitions > 1 && combinedReadConflictRanges.size() >= cs->partitions * cs->minPartitionRanges) {
+		for (int i = 1; i < cs->partitions; i++) {
+			const StringRef& key = points[points.size() * i / cs->partitions].key;
+			if (key.size() && (splitKeys.empty() || splitKeys.back() < key))
+				splitKeys.push_back(key);
+		}
+	}
+	if (splitKeys.empty()) {
+		cs->versionHistory.detectConflicts(
+		    &combinedReadConflictRanges[0], combinedReadConflictRanges.size(), transactionConflictStatus);
+		return;
+	}
+
+	// A range crossing split keys is checked piecewise, and conflicts if any of its pieces does. A piece's transaction
+	// is its index within the partition, so that each partition sets only its own flags.
+	const int partCount = splitKeys.size() + 1;
+	std::vector<std::vector<ReadConflictRange>> pieces(partCount);
+	std::vector<std::vector<int>> pieceRanges(partCount);
+	for (int r = 0; r < combinedReadConflictRanges.size(); r++) {
+		const ReadConflictRange& range = combinedReadConflictRanges[r];
+		int p = std::upper_bound(splitKeys.begin(), splitKeys.end(), range.begin) - splitKeys.begin();
+		StringRef begin = range.begin;
+		while (true) {
+			const bool last = p == splitKeys.size() || !(splitKeys[p] < range.end);
+			pieces[p].emplace_back(begin, last ? range.end : splitKeys[p], range.version, pieces[p].size(), 0);
+			pieceRanges[p].push_back(r);
+			if (last)
+				break;
+			begin = splitKeys[p++];
+		}
+	}
+
+	std::vector<std::unique_ptr<bool[]>> pieceConflicts(partCount);
+	cs->forEachPartition(splitKeys, [&](SkipList& part, int p) {
+		pieceConflicts[p].reset(new bool[pieces[p].size()]());
+		if (!pieces[p].empty())
+			part.detectConflicts(&pieces[p][0], pieces[p].size(), pieceConflicts[p].get());
+	});
+
+	std::vector<bool> rangeConflicts(combinedReadConflictRanges.size());
+	for (int p = 0; p < partCount; p++) {
+		for (int i = 0; i < pieces[p].size(); i++) {
+			if (pieceConflicts[p][i])
+				rangeConflicts[pieceRanges[p][i]] = true;
+		}
+	}
+	for (int r = 0; r < combinedReadConflictRanges.size(); r++) {
+		if (!rangeConflicts[r])
+			continue;
+		const ReadConflictRange& range = combinedReadConflictRanges[r];
+		transactionConflictStatus[range.transaction] = true;
+		if (range.conflictingKeyRange != nullptr)
+			range.conflictingKeyRange->push_back(*range.cKRArena, range.indexInTx);
+	}
 }
 
 void ConflictBatch::addConflictRanges(Version now,
@@ -1015,7 +1151,39 @@ void ConflictBatch::mergeWriteConflictRanges(Version now) {
 	if (combinedWriteConflictRanges.empty())
 		return;
 
-	addConflictRanges(now, combinedWriteConflictRanges.begin(), combinedWriteConflictRanges.end(), &cs->versionHistory);
+	if (cs->btree) {
+		for (const auto& range : combinedWriteConflictRanges)
+			cs->btree->set(range.first, range.second, now);
+		return;
+	}
+
+	// Writes may only be split at the beginning of a range which does not touch the range before it, because the
+	// partition to the left of a split key must not insert an entry at it
+	const int rangeCount = combinedWriteConflictRanges.size();
+	std::vector<StringRef> splitKeys;
+	std::vector<int> partBegins = { 0 };
+	if (cs->partitions > 1 && rangeCount >= cs->partitions * cs->minPartitionRanges) {
+		for (int i = 1; i < cs->partitions; i++) {
+			const int r = rangeCount * i / cs->partitions;
+			if (r > partBegins.back() && combinedWriteConflictRanges[r - 1].second < combinedWriteConflictRanges[r].first) {
+				splitKeys.push_back(combinedWriteConflictRanges[r].first);
+				partBegins.push_back(r);
+			}
+		}
+	}
+	if (splitKeys.empty()) {
+		addConflictRanges(
+		    now, combinedWriteConflictRanges.begin(), combinedWriteConflictRanges.end(), &cs->versionHistory);
+		return;
+	}
+
+	partBegins.push_back(rangeCount);
+	cs->forEachPartition(splitKeys, [&](SkipList& part, int p) {
+		addConflictRanges(now,
+		                  combinedWriteConflictRanges.begin() + partBegins[p],
+		                  combinedWriteConflictRanges.begin() + partBegins[p + 1],
+		                  &part);
+	});
 }
 
 void ConflictBatch::combineWriteConflictRanges() {
@@ -1200,3 +1368,89 @@ void skipListTest() {
 
 	printf("%d entries in version history\n", cs->versionHistory.count());
 }
+
+namespace {
+// Runs the same batches through both conflict sets, and expects the same verdicts and conflicting ranges from each.
+// With removeBetweenBatches, old versions are also removed from `actual` between batches, as an idle resolver does.
+void checkSameVerdicts(ConflictSet* expected, ConflictSet* actual, bool removeBetweenBatches = false) {
+	const int keys = deterministicRandom()->randomInt(50, 5000);
+
+	Version version = 0;
+	for (int b = 0; b < 200; b++) {
+		Arena arena;
+		std::vector<CommitTransactionRef> trs(deterministicRandom()->randomInt(1, 200));
+		for (auto& tr : trs) {
+			tr.read_snapshot = std::max<Version>(0, version - deterministicRandom()->randomInt(0, 10));
+			tr.report_conflicting_keys = deterministicRandom()->coinflip();
+			for (int r = deterministicRandom()->randomInt(0, 4); r > 0; r--) {
+				const int begin = deterministicRandom()->randomInt(0, keys);
+				const int end = begin + deterministicRandom()->randomInt(0, 20);
+				tr.read_conflict_ranges.push_back(arena, KeyRangeRef(setK(arena, begin), setK(arena, end)));
+			}
+			for (int w = deterministicRandom()->randomInt(0, 4); w > 0; w--) {
+				const int begin = deterministicRandom()->randomInt(0, keys);
+				const int end = begin + deterministicRandom()->randomInt(1, 20);
+				tr.write_conflict_ranges.push_back(arena, KeyRangeRef(setK(arena, begin), setK(arena, end)));
+			}
+		}
+
+		version += deterministicRandom()->randomInt(1, 3);
+		const Version oldest = std::max<Version>(0, version - 8);
+		std::vector<int> committed[2], tooOld[2];
+		std::map<int, VectorRef<int>> conflictingRanges[2];
+		Arena replyArena[2];
+		ConflictSet* sets[2] = { expected, actual };
+		for (int s = 0; s < 2; s++) {
+			ConflictBatch batch(sets[s], &conflictingRanges[s], &replyArena[s]);
+			for (const auto& tr : trs)
+				batch.addTransaction(tr, oldest);
+			batch.detectConflicts(version, oldest, committed[s], &tooOld[s]);
+		}
+
+		ASSERT(committed[0] == committed[1]);
+		ASSERT(tooOld[0] == tooOld[1]);
+		ASSERT(conflictingRanges[0].size() == conflictingRanges[1].size());
+		for (auto& [t, ranges] : conflictingRanges[0]) {
+			ASSERT(conflictingRanges[1].count(t));
+			std::vector<int> expectedRanges(ranges.begin(), ranges.end());
+			std::vector<int> actualRanges(conflictingRanges[1][t].begin(), conflictingRanges[1][t].end());
+			std::sort(expectedRanges.begin(), expectedRanges.end());
+			std::sort(actualRanges.begin(), actualRanges.end());
+			ASSERT(expectedRanges == actualRanges);
+		}
+
+		if (removeBetweenBatches) {
+			for (int r = deterministicRandom()->randomInt(0, 10); r > 0; r--)
+				removeOldVersions(actual, deterministicRandom()->randomInt(1, 100));
+		}
+	}
+
+	if (removeBetweenBatches) {
+		// At most two passes over fewer than 5100 boundaries: the rest of the one under way, and one begun at the current
+		// oldest version
+		for (int calls = 0; removeOldVersions(actual, 10); calls++)
+			ASSERT(calls < 2 * 5100 / 10 + 2);
+		ASSERT(!removeOldVersions(actual, 10));
+	}
+
+	destroyConflictSet(expected);
+	destroyConflictSet(actual);
+}
+} // namespace
+
+TEST_CASE("/fdbserver/ConflictSet/Partitioned") {
+	checkSameVerdicts(newConflictSet(),
+	                  newConflictSet(deterministicRandom()->randomInt(2, 9), deterministicRandom()->randomInt(1, 10)));
+	return Void();
+}
+
+TEST_CASE("/fdbserver/ConflictSet/BTree") {
+	checkSameVerdicts(newConflictSet(), newBTreeConflictSet());
+	return Void();
+}
+
+TEST_CASE("/fdbserver/ConflictSet/RemoveOldVersions") {
+	checkSameVerdicts(newConflictSet(), newConflictSet(), true);
+	checkSameVerdicts(newConflictSet(), newBTreeConflictSet(), true);
+	return Void();
+}
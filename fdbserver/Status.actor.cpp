@@ -570,6 +570,20 @@ struct RolesInfo {
 				obj["read_latency_statistics"] = addLatencyStatistics(readLatencyMetrics);
 			}
 
+			JsonBuilderObject readPhases;
+			for (auto const& [eventName, phase] : { std::make_pair("ReadQueueWaitMetrics", "queue_wait"),
+			                                        std::make_pair("ReadVersionWaitMetrics", "version_wait"),
+			                                        std::make_pair("ReadVersionedDataMetrics", "versioned_data"),
+			                                        std::make_pair("ReadEngineMetrics", "storage_engine") }) {
+				TraceEventFields const& phaseMetrics = metrics.at(eventName);
+				if (phaseMetrics.size()) {
+					readPhases[phase] = addLatencyStatistics(phaseMetrics);
+				}
+			}
+			if (!readPhases.empty()) {
+				obj["read_phase_latency_statistics"] = readPhases;
+			}
+
 			TraceEventFields const& readLatencyBands = metrics.at("ReadLatencyBands");
 			if (readLatencyBands.size()) {
 				obj["read_latency_bands"] = addLatencyBandInfo(readLatencyBands);
@@ -615,6 +629,29 @@ struct RolesInfo {
 				}
 			}
 
+			TraceEventFields const& hotKeys = metrics.at("HotKeys");
+			if (hotKeys.size()) {
+				JsonBuilderObject hotKeysObj;
+				for (auto const& [eventName, field] : { std::make_pair("ReadKey", "read_key"),
+				                                        std::make_pair("ReadPrefix", "read_prefix"),
+				                                        std::make_pair("WriteKey", "write_key"),
+				                                        std::make_pair("WritePrefix", "write_prefix") }) {
+					std::string key;
+					if (hotKeys.tryGetValue(eventName, key)) {
+						JsonBuilderObject hotKeyObj;
+						hotKeyObj["key"] = key;
+						hotKeyObj["fractional_cost"] = hotKeys.getDouble(std::string(eventName) + "Fraction");
+						JsonBuilderObject estimatedCostObj;
+						estimatedCostObj["hz"] = hotKeys.getDouble(std::string(eventName) + "Rate");
+						hotKeyObj["estimated_cost"] = estimatedCostObj;
+						hotKeysObj[field] = hotKeyObj;
+					}
+				}
+				if (!hotKeysObj.empty()) {
+					obj["hottest_keys"] = hotKeysObj;
+				}
+			}
+
 			TraceEventFields const& rocksdbMetrics = metrics.at("RocksDBMetrics");
 			if (rocksdbMetrics.size()) {
 				JsonBuilderObject rocksdbMetricsObj;
@@ -1994,8 +2031,12 @@ static Future<std::vector<std::pair<iface, EventMap>>> getServerMetrics(
 
 namespace {
 
-const std::vector<std::string> STORAGE_SERVER_METRICS_LIST{ "StorageMetrics", "ReadLatencyMetrics", "ReadLatencyBands",
-	                                                        "BusiestReadTag", "BusiestWriteTag",    "RocksDBMetrics" };
+const std::vector<std::string> STORAGE_SERVER_METRICS_LIST{ "StorageMetrics",           "ReadLatencyMetrics",
+	                                                        "ReadLatencyBands",         "BusiestReadTag",
+	                                                        "BusiestWriteTag",          "RocksDBMetrics",
+	                                                        "ReadQueueWaitMetrics",     "ReadVersionWaitMetrics",
+	                                                        "ReadVersionedDataMetrics", "ReadEngineMetrics",
+	                                                        "HotKeys" };
 
 } // namespace
 
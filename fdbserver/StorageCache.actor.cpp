@@ -2255,7 +2255,11 @@ ACTOR Future<Void> storageCacheServer(StorageServerInterface ssi,
 				actors.add(getValueQ(&self, req));
 			}
 			when(WatchValueRequest req = waitNext(ssi.watchValue.getFuture())) {
-				ASSERT(false);
+				// Clients load balance reads of cached ranges over the caches and the storage servers, so requests the
+				// cache cannot serve are answered as if the endpoint were not found, and the client tries a storage
+				// server instead
+				++self.counters.readsRejected;
+				req.reply.sendError(broken_promise());
 			}
 			when(GetKeyRequest req = waitNext(ssi.getKey.getFuture())) {
 				actors.add(getKey(&self, req));
@@ -2277,7 +2281,9 @@ ACTOR Future<Void> storageCacheServer(StorageServerInterface ssi,
 			}
 
 			when(GetMappedKeyValuesRequest req = waitNext(ssi.getMappedKeyValues.getFuture())) {
-				ASSERT(false);
+				// The secondary reads of a mapped range read may fall outside the cached ranges
+				++self.counters.readsRejected;
+				req.reply.sendError(broken_promise());
 			}
 			when(WaitMetricsRequest req = waitNext(ssi.waitMetrics.getFuture())) {
 				ASSERT(false);
@@ -2295,7 +2301,8 @@ ACTOR Future<Void> storageCacheServer(StorageServerInterface ssi,
 				ASSERT(false);
 			}
 			when(GetKeyValuesStreamRequest req = waitNext(ssi.getKeyValuesStream.getFuture())) {
-				ASSERT(false);
+				++self.counters.readsRejected;
+				req.reply.sendError(broken_promise());
 			}
 			when(ChangeFeedStreamRequest req = waitNext(ssi.changeFeedStream.getFuture())) {
 				ASSERT(false);
@@ -18,6 +18,8 @@
  * limitations under the License.
  */
 
+#include <numeric>
+
 #include "flow/UnitTest.h"
 #include "fdbserver/StorageMetrics.actor.h"
 #include "flow/actorcompiler.h" // This must be the last #include.
@@ -282,21 +284,36 @@ KeyRef StorageServerMetrics::getSplitKey(int64_t remaining,
 	return key;
 }
 
-void StorageServerMetrics::splitMetrics(SplitMetricsRequest req) const {
+void StorageServerMetrics::splitMetrics(SplitMetricsRequest req, StorageMetricSample const& bytes) const {
 	int minSplitBytes = req.minSplitBytes.present() ? req.minSplitBytes.get() : SERVER_KNOBS->MIN_SHARD_BYTES;
 	int minSplitWriteTraffic = SERVER_KNOBS->SHARD_SPLIT_BYTES_PER_KSEC;
+	// Read limits are 0 in requests from before read based splits, and infinite when reads should not split
+	auto splitsByRead = [&req](int64_t limit) { return limit > 0 && limit < req.limits.infinity / 2; };
+	auto wantsReadSplit = [&](StorageMetrics const& remaining) {
+		return (splitsByRead(req.limits.bytesReadPerKSecond) &&
+		        remaining.bytesReadPerKSecond > req.limits.bytesReadPerKSecond) ||
+		       (splitsByRead(req.limits.opsReadPerKSecond) &&
+		        remaining.opsReadPerKSecond > req.limits.opsReadPerKSecond);
+	};
+	auto metricsOf = [&](KeyRangeRef keys) {
+		StorageMetrics m = getMetrics(keys);
+		m.bytes = bytes.getEstimate(keys);
+		return m;
+	};
 	try {
 		SplitMetricsReply reply;
 		KeyRef lastKey = req.keys.begin;
 		StorageMetrics used = req.used;
 		StorageMetrics estimated = req.estimated;
-		StorageMetrics remaining = getMetrics(req.keys) + used;
+		StorageMetrics remaining = metricsOf(req.keys) + used;
 
 		//TraceEvent("SplitMetrics").detail("Begin", req.keys.begin).detail("End", req.keys.end).detail("Remaining", remaining.bytes).detail("Used", used.bytes).detail("MinSplitBytes", minSplitBytes);
 
 		while (true) {
-			if (remaining.bytes < 2 * minSplitBytes && (!SERVER_KNOBS->ENABLE_WRITE_BASED_SHARD_SPLIT ||
-			                                            remaining.bytesWrittenPerKSecond < minSplitWriteTraffic))
+			if (remaining.bytes < 2 * minSplitBytes &&
+			    (!SERVER_KNOBS->ENABLE_WRITE_BASED_SHARD_SPLIT ||
+			     remaining.bytesWrittenPerKSecond < minSplitWriteTraffic) &&
+			    !wantsReadSplit(remaining))
 				break;
 			KeyRef key = req.keys.end;
 			bool hasUsed = used.bytes != 0 || used.bytesWrittenPerKSecond != 0 || used.iosPerKSecond != 0;
@@ -306,14 +323,14 @@ void StorageServerMetrics::splitMetrics(SplitMetricsRequest req) const {
 			                  used.bytes,
 			                  req.limits.infinity,
 			                  req.isLastShard,
-			                  byteSample,
+			                  bytes,
 			                  1,
 			                  lastKey,
 			                  key,
 			                  hasUsed);
 			if (used.bytes < minSplitBytes)
 				key = std::max(
-				    key, byteSample.splitEstimate(KeyRangeRef(lastKey, req.keys.end), minSplitBytes - used.bytes));
+				    key, bytes.splitEstimate(KeyRangeRef(lastKey, req.keys.end), minSplitBytes - used.bytes));
 			key = getSplitKey(remaining.iosPerKSecond,
 			                  estimated.iosPerKSecond,
 			                  req.limits.iosPerKSecond,
@@ -336,6 +353,33 @@ void StorageServerMetrics::splitMetrics(SplitMetricsRequest req) const {
 			                  lastKey,
 			                  key,
 			                  hasUsed);
+			// The read samples put the split points around the busiest keys
+			if (splitsByRead(req.limits.bytesReadPerKSecond)) {
+				key = getSplitKey(remaining.bytesReadPerKSecond,
+				                  estimated.bytesReadPerKSecond,
+				                  req.limits.bytesReadPerKSecond,
+				                  used.bytesReadPerKSecond,
+				                  req.limits.infinity,
+				                  req.isLastShard,
+				                  bytesReadSample,
+				                  SERVER_KNOBS->STORAGE_METRICS_AVERAGE_INTERVAL_PER_KSECONDS,
+				                  lastKey,
+				                  key,
+				                  hasUsed);
+			}
+			if (splitsByRead(req.limits.opsReadPerKSecond)) {
+				key = getSplitKey(remaining.opsReadPerKSecond,
+				                  estimated.opsReadPerKSecond,
+				                  req.limits.opsReadPerKSecond,
+				                  used.opsReadPerKSecond,
+				                  req.limits.infinity,
+				                  req.isLastShard,
+				                  opsReadSample,
+				                  SERVER_KNOBS->STORAGE_METRICS_AVERAGE_INTERVAL_PER_KSECONDS,
+				                  lastKey,
+				                  key,
+				                  hasUsed);
+			}
 			ASSERT(key != lastKey || hasUsed);
 			if (key == req.keys.end)
 				break;
@@ -345,7 +389,7 @@ void StorageServerMetrics::splitMetrics(SplitMetricsRequest req) const {
 				break;
 			}
 
-			StorageMetrics diff = (getMetrics(KeyRangeRef(lastKey, key)) + used);
+			StorageMetrics diff = (metricsOf(KeyRangeRef(lastKey, key)) + used);
 			remaining -= diff;
 			estimated -= diff;
 
@@ -353,7 +397,7 @@ void StorageServerMetrics::splitMetrics(SplitMetricsRequest req) const {
 			lastKey = key;
 		}
 
-		reply.used = reply.more ? StorageMetrics() : getMetrics(KeyRangeRef(lastKey, req.keys.end)) + used;
+		reply.used = reply.more ? StorageMetrics() : metricsOf(KeyRangeRef(lastKey, req.keys.end)) + used;
 		req.reply.send(reply);
 	} catch (Error& e) {
 		req.reply.sendError(e);
@@ -538,13 +582,15 @@ void StorageServerMetrics::getReadHotRanges(ReadHotSubRangeRequest req) const {
 	req.reply.send(reply);
 }
 
-void StorageServerMetrics::getSplitPoints(SplitRangeRequest req, Optional<KeyRef> prefix) const {
+void StorageServerMetrics::getSplitPoints(SplitRangeRequest req,
+                                          Optional<KeyRef> prefix,
+                                          StorageMetricSample const& bytes) const {
 	SplitRangeReply reply;
 	KeyRangeRef range = req.keys;
 	if (prefix.present()) {
 		range = range.withPrefix(prefix.get(), req.arena);
 	}
-	std::vector<KeyRef> points = getSplitPoints(range, req.chunkSize, prefix);
+	std::vector<KeyRef> points = getSplitPoints(range, req.chunkSize, prefix, bytes);
 
 	reply.splitPoints.append_deep(reply.splitPoints.arena(), points.data(), points.size());
 	req.reply.send(reply);
@@ -552,12 +598,13 @@ void StorageServerMetrics::getSplitPoints(SplitRangeRequest req, Optional<KeyRef
 
 std::vector<KeyRef> StorageServerMetrics::getSplitPoints(KeyRangeRef range,
                                                          int64_t chunkSize,
-                                                         Optional<KeyRef> prefixToRemove) const {
+                                                         Optional<KeyRef> prefixToRemove,
+                                                         StorageMetricSample const& bytes) const {
 	std::vector<KeyRef> toReturn;
 	KeyRef beginKey = range.begin;
 	IndexedSet<Key, int64_t>::const_iterator endKey =
-	    byteSample.sample.index(byteSample.sample.sumTo(byteSample.sample.lower_bound(beginKey)) + chunkSize);
-	while (endKey != byteSample.sample.end()) {
+	    bytes.sample.index(bytes.sample.sumTo(bytes.sample.lower_bound(beginKey)) + chunkSize);
+	while (endKey != bytes.sample.end()) {
 		if (*endKey > range.end) {
 			break;
 		}
@@ -571,11 +618,58 @@ std::vector<KeyRef> StorageServerMetrics::getSplitPoints(KeyRangeRef range,
 		}
 		toReturn.push_back(splitPoint);
 		beginKey = *endKey;
-		endKey = byteSample.sample.index(byteSample.sample.sumTo(byteSample.sample.lower_bound(beginKey)) + chunkSize);
+		endKey = bytes.sample.index(bytes.sample.sumTo(bytes.sample.lower_bound(beginKey)) + chunkSize);
 	}
 	return toReturn;
 }
 
+Standalone<VectorRef<KeyRef>> StorageServerMetrics::getByteSampleBoundaries(KeyRangeRef range, int maxKeys) const {
+	Standalone<VectorRef<KeyRef>> boundaries;
+	boundaries.push_back_deep(boundaries.arena(), range.begin);
+	const IndexedSet<Key, int64_t>& sample = byteSample.sample;
+	auto it = sample.lower_bound(range.begin);
+	const int64_t step = std::max<int64_t>(1, byteSample.getEstimate(range) / std::max(1, maxKeys));
+	while (it != sample.end() && *it < range.end) {
+		if (*it > boundaries.back()) {
+			boundaries.push_back_deep(boundaries.arena(), *it);
+		}
+		// The key whose sampled bytes contain the bytes step past this one, skipping keys with less
+		auto next = sample.index(sample.sumTo(it) + step);
+		if (next == it) {
+			++next;
+		}
+		it = next;
+	}
+	if (range.end > boundaries.back()) {
+		boundaries.push_back_deep(boundaries.arena(), range.end);
+	}
+	return boundaries;
+}
+
+StorageMetricSample StorageServerMetrics::weighByEngineSizes(VectorRef<KeyRef> boundaries,
+                                                             std::vector<int64_t> const& sizes) const {
+	ASSERT(boundaries.size() == sizes.size() + 1);
+	const int64_t engineBytes = std::accumulate(sizes.begin(), sizes.end(), int64_t(0));
+	ASSERT(engineBytes > 0);
+	const int64_t sampledBytes = byteSample.getEstimate(KeyRangeRef(boundaries.front(), boundaries.back()));
+	const double scale = double(sampledBytes) / engineBytes;
+
+	// The bytes between each boundary and the next are put on the boundary, except that the first boundary may not be
+	// a sample key, and then the bytes before the first sample key are put on it
+	StorageMetricSample result(byteSample.metricUnitsPerSample);
+	bool firstIsSampled = byteSample.sample.find(boundaries[0]) != byteSample.sample.end();
+	double carried = 0;
+	for (int i = 0; i < sizes.size(); i++) {
+		carried += sizes[i] * scale;
+		if (i == 0 && !firstIsSampled) {
+			continue;
+		}
+		result.sample.insert(Key(boundaries[i]), int64_t(carried));
+		carried = 0;
+	}
+	return result;
+}
+
 void StorageServerMetrics::collapse(KeyRangeMap<int>& map, KeyRef const& key) {
 	auto range = map.rangeContaining(key);
 	if (range == map.ranges().begin() || range == map.ranges().end())
@@ -782,6 +876,33 @@ TEST_CASE("/fdbserver/StorageMetricSample/rangeSplitPoints/chunkTooLarge") {
 	return Void();
 }
 
+TEST_CASE("/fdbserver/StorageMetricSample/rangeSplitPoints/engineSizes") {
+
+	int64_t sampleUnit = SERVER_KNOBS->BYTES_READ_UNITS_PER_SAMPLE;
+	StorageServerMetrics ssm;
+
+	ssm.byteSample.sample.insert("A"_sr, 100 * sampleUnit);
+	ssm.byteSample.sample.insert("B"_sr, 100 * sampleUnit);
+	ssm.byteSample.sample.insert("C"_sr, 100 * sampleUnit);
+	ssm.byteSample.sample.insert("D"_sr, 100 * sampleUnit);
+
+	Standalone<VectorRef<KeyRef>> boundaries = ssm.getByteSampleBoundaries(KeyRangeRef("A"_sr, "E"_sr), 1000);
+	ASSERT(boundaries.size() == 5 && boundaries[0] == "A"_sr && boundaries[4] == "E"_sr);
+	ASSERT(ssm.getByteSampleBoundaries(KeyRangeRef("A"_sr, "E"_sr), 2).size() == 3);
+
+	// The engine finds most of the bytes between A and B, which the byte sample spread evenly
+	StorageMetricSample weighted = ssm.weighByEngineSizes(boundaries, { 700, 100, 100, 100 });
+	ASSERT(weighted.getEstimate(KeyRangeRef("A"_sr, "E"_sr)) == 400 * sampleUnit);
+	ASSERT(weighted.getEstimate(KeyRangeRef("A"_sr, "B"_sr)) == 280 * sampleUnit);
+
+	std::vector<KeyRef> t = ssm.getSplitPoints(KeyRangeRef("A"_sr, "E"_sr), 200 * sampleUnit, {});
+	ASSERT(t.size() == 1 && t[0] == "C"_sr);
+	t = ssm.getSplitPoints(KeyRangeRef("A"_sr, "E"_sr), 200 * sampleUnit, {}, weighted);
+	ASSERT(t.size() == 1 && t[0] == "B"_sr);
+
+	return Void();
+}
+
 TEST_CASE("/fdbserver/StorageMetricSample/readHotDetect/simple") {
 
 	int64_t sampleUnit = SERVER_KNOBS->BYTES_READ_UNITS_PER_SAMPLE;
@@ -0,0 +1,142 @@
+/*
+ * StorageServerReadCache.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbserver/StorageServerReadCache.h"
+#include "flow/UnitTest.h"
+
+Optional<Optional<Value>> StorageServerReadCache::get(KeyRef key) {
+	auto it = entries.find(key);
+	if (it == entries.end()) {
+		return Optional<Optional<Value>>();
+	}
+	lru.splice(lru.begin(), lru, it->second.lruPosition);
+	return it->second.value;
+}
+
+void StorageServerReadCache::insert(KeyRef key, Optional<Value> const& value, ReadToken token) {
+	if (!enabled() || token.writesPending || token.generation != generation) {
+		return;
+	}
+	int64_t size = entryBytes(key, value);
+	if (size > capacityBytes) {
+		return;
+	}
+
+	auto it = entries.find(key);
+	if (it != entries.end()) {
+		erase(it);
+	}
+	while (bytes + size > capacityBytes) {
+		erase(entries.find(lru.back()));
+	}
+
+	// Copy the value so the entry does not keep the (possibly much larger) arena of the engine's result alive
+	Optional<Value> ownedValue;
+	if (value.present()) {
+		ownedValue = Value(value.get().contents());
+	}
+	auto [inserted, _] = entries.emplace(Key(key), Entry{ ownedValue, std::list<KeyRef>::iterator() });
+	lru.push_front(inserted->first);
+	inserted->second.lruPosition = lru.begin();
+	bytes += size;
+}
+
+void StorageServerReadCache::invalidate(KeyRef key) {
+	onWrite();
+	auto it = entries.find(key);
+	if (it != entries.end()) {
+		erase(it);
+	}
+}
+
+void StorageServerReadCache::invalidate(KeyRangeRef range) {
+	onWrite();
+	auto it = entries.lower_bound(range.begin);
+	while (it != entries.end() && it->first < range.end) {
+		erase(it++);
+	}
+}
+
+void StorageServerReadCache::clear() {
+	onWrite();
+	entries.clear();
+	lru.clear();
+	bytes = 0;
+}
+
+void StorageServerReadCache::onCommit() {
+	++generation;
+	writesPending = false;
+}
+
+void StorageServerReadCache::erase(std::map<Key, Entry, std::less<>>::iterator it) {
+	bytes -= entryBytes(it->first, it->second.value);
+	lru.erase(it->second.lruPosition);
+	entries.erase(it);
+}
+
+TEST_CASE("/fdbserver/StorageServerReadCache/basic") {
+	StorageServerReadCache cache(1000);
+
+	cache.insert("a"_sr, Optional<Value>("1"_sr), cache.beginRead());
+	cache.insert("b"_sr, Optional<Value>(), cache.beginRead());
+	ASSERT(cache.get("a"_sr).present() && cache.get("a"_sr).get().get() == "1"_sr);
+	ASSERT(cache.get("b"_sr).present() && !cache.get("b"_sr).get().present());
+	ASSERT(!cache.get("c"_sr).present());
+
+	// A read which races with a write is not cached
+	StorageServerReadCache::ReadToken token = cache.beginRead();
+	cache.invalidate("c"_sr);
+	cache.insert("c"_sr, Optional<Value>("3"_sr), token);
+	ASSERT(!cache.get("c"_sr).present());
+
+	// Nor is a read which starts while writes are not yet committed
+	token = cache.beginRead();
+	cache.insert("c"_sr, Optional<Value>("3"_sr), token);
+	ASSERT(!cache.get("c"_sr).present());
+	cache.onCommit();
+	cache.insert("c"_sr, Optional<Value>("3"_sr), cache.beginRead());
+	ASSERT(cache.get("c"_sr).present());
+
+	cache.invalidate(KeyRangeRef("a"_sr, "c"_sr));
+	ASSERT(!cache.get("a"_sr).present() && !cache.get("b"_sr).present() && cache.get("c"_sr).present());
+
+	cache.clear();
+	ASSERT(cache.getEntries() == 0 && cache.getBytes() == 0);
+
+	return Void();
+}
+
+TEST_CASE("/fdbserver/StorageServerReadCache/eviction") {
+	std::string value(100, 'v');
+	StorageServerReadCache cache(2000);
+
+	for (int i = 0; i < 100; ++i) {
+		cache.insert(StringRef(format("key%03d", i)), Optional<Value>(StringRef(value)), cache.beginRead());
+		// Keep the first key hot, so that it is never the least recently used
+		ASSERT(cache.get("key000"_sr).present());
+		ASSERT(cache.getBytes() <= 2000);
+	}
+	ASSERT(cache.get("key099"_sr).present());
+	ASSERT(!cache.get("key001"_sr).present());
+	ASSERT(cache.getEntries() > 1 && cache.getEntries() < 100);
+
+	return Void();
+}
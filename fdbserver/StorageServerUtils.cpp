@@ -19,6 +19,8 @@
  */
 
 #include "fdbserver/StorageServerUtils.h"
+#include "fdbserver/Knobs.h"
+#include "flow/UnitTest.h"
 
 #define PERSIST_PREFIX "\xff\xff"
 
@@ -58,6 +60,37 @@ void ThroughputLimiter::settle() {
 	this->lastSettleSec = ts;
 }
 
+FetchSourceBudget::FetchSourceBudget(int64_t maxBytesPerSec)
+  : maxBytesPerSec(maxBytesPerSec), limiter(maxBytesPerSec) {}
+
+Future<Void> FetchSourceBudget::ready() {
+	limiter.settle();
+	return limiter.ready();
+}
+
+int64_t FetchSourceBudget::adjust() {
+	if (!enabled()) {
+		return 0;
+	}
+	const double readLatency = readCount > 0 ? readLatencySum / readCount : -1.0;
+	readLatencySum = 0;
+	readCount = 0;
+	limiter.setCap(nextRate(limiter.getCap(), maxBytesPerSec, readLatency));
+	return limiter.getCap();
+}
+
+int64_t FetchSourceBudget::nextRate(int64_t current, int64_t maxBytesPerSec, double readLatency) {
+	const int64_t minBytesPerSec =
+	    std::max<int64_t>(1, maxBytesPerSec * SERVER_KNOBS->STORAGE_FETCH_SOURCE_MIN_FRACTION);
+	int64_t next;
+	if (readLatency > SERVER_KNOBS->STORAGE_FETCH_SOURCE_READ_LATENCY_TARGET) {
+		next = current * SERVER_KNOBS->STORAGE_FETCH_SOURCE_BACKOFF;
+	} else {
+		next = current + maxBytesPerSec * SERVER_KNOBS->STORAGE_FETCH_SOURCE_RECOVERY;
+	}
+	return std::clamp(next, minBytesPerSec, maxBytesPerSec);
+}
+
 KeyRange persistMoveInShardsKeyRange() {
 	return persistMoveInShardKeys;
 }
@@ -111,4 +144,24 @@ MoveInShardMetaData decodeMoveInShardValue(const ValueRef& value) {
 	ObjectReader reader(value.begin(), IncludeVersion());
 	reader.deserialize(shard);
 	return shard;
-}
\ No newline at end of file
+}
+TEST_CASE("/fdbserver/StorageServerUtils/FetchSourceBudget/nextRate") {
+	IKnobCollection::getMutableGlobalKnobCollection().setKnob("storage_fetch_source_read_latency_target",
+	                                                          KnobValueRef::create(double{ 0.01 }));
+	IKnobCollection::getMutableGlobalKnobCollection().setKnob("storage_fetch_source_min_fraction",
+	                                                          KnobValueRef::create(double{ 0.1 }));
+	IKnobCollection::getMutableGlobalKnobCollection().setKnob("storage_fetch_source_backoff",
+	                                                          KnobValueRef::create(double{ 0.5 }));
+	IKnobCollection::getMutableGlobalKnobCollection().setKnob("storage_fetch_source_recovery",
+	                                                          KnobValueRef::create(double{ 0.1 }));
+
+	const int64_t max = 1000000;
+	// Slow foreground reads halve the rate, down to the floor.
+	ASSERT_EQ(FetchSourceBudget::nextRate(max, max, 0.02), max / 2);
+	ASSERT_EQ(FetchSourceBudget::nextRate(max / 8, max, 0.02), max / 10);
+	// Fast reads, or none at all, recover a tenth of the maximum at a time, up to the maximum.
+	ASSERT_EQ(FetchSourceBudget::nextRate(max / 2, max, 0.005), max / 2 + max / 10);
+	ASSERT_EQ(FetchSourceBudget::nextRate(max / 2, max, -1.0), max / 2 + max / 10);
+	ASSERT_EQ(FetchSourceBudget::nextRate(max, max, 0.005), max);
+	return Void();
+}
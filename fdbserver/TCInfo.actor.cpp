@@ -466,6 +466,41 @@ int64_t TCTeamInfo::getLoadBytes(bool includeInFlight, double inflightPenalty) c
 	return (physicalBytes + (inflightPenalty * inFlightBytes)) * availableSpaceMultiplier;
 }
 
+double TeamUtilization::busyness() const {
+	return SERVER_KNOBS->DD_TEAM_COST_CPU_WEIGHT * cpu + SERVER_KNOBS->DD_TEAM_COST_DISK_BUSY_WEIGHT * diskBusy +
+	       SERVER_KNOBS->DD_TEAM_COST_READ_OPS_WEIGHT * readOps +
+	       SERVER_KNOBS->DD_TEAM_COST_WRITE_BANDWIDTH_WEIGHT * writeBandwidth;
+}
+
+TeamUtilization TCTeamInfo::getUtilization() const {
+	TeamUtilization utilization;
+	for (const auto& server : servers) {
+		// Like getAverageCPU(), a server without health metrics is assumed to be too busy to report them
+		auto& stats = server->getStorageStats();
+		utilization.cpu = std::max(utilization.cpu, stats.present() ? stats.get().cpuUsage / 100.0 : 1.0);
+		utilization.diskBusy = std::max(utilization.diskBusy, stats.present() ? stats.get().diskUsage / 100.0 : 1.0);
+		if (server->metricsPresent()) {
+			auto const& load = server->getMetrics().load;
+			utilization.readOps = std::max(
+			    utilization.readOps, (double)load.opsReadPerKSecond / SERVER_KNOBS->DD_TEAM_COST_MAX_READ_OPS_PER_KSEC);
+			utilization.writeBandwidth =
+			    std::max(utilization.writeBandwidth,
+			             (double)load.bytesWrittenPerKSecond / SERVER_KNOBS->DD_TEAM_COST_MAX_WRITE_BYTES_PER_KSEC);
+		}
+	}
+	utilization.cpu = std::min(utilization.cpu, 1.0);
+	utilization.diskBusy = std::min(utilization.diskBusy, 1.0);
+	utilization.readOps = std::min(utilization.readOps, 1.0);
+	utilization.writeBandwidth = std::min(utilization.writeBandwidth, 1.0);
+	return utilization;
+}
+
+int64_t TCTeamInfo::getLoadCost(bool includeInFlight, double inflightPenalty) const {
+	int64_t loadBytes = getLoadBytes(includeInFlight, inflightPenalty);
+	double busyness = getUtilization().busyness();
+	return busyness > 0 ? loadBytes * (1.0 + busyness) : loadBytes;
+}
+
 // average read bandwidth within a team
 double TCTeamInfo::getReadLoad(bool includeInFlight, double inflightPenalty) const {
 	// FIXME: consider team load variance
@@ -40,6 +40,7 @@
 #include "fdbrpc/Stats.h"
 #include "fdbserver/ServerDBInfo.h"
 #include "fdbserver/LogSystem.h"
+#include "fdbserver/TagMessageIndex.h"
 #include "fdbserver/WaitFailure.h"
 #include "fdbserver/RecoveryState.h"
 #include "fdbserver/FDBExecHelper.actor.h"
@@ -285,6 +286,41 @@ struct SpilledData {
 	uint32_t mutationBytes = 0;
 };
 
+// Disk queue entries read ahead of the peeks that need them, keyed by the location they start at. A peek of data spilled
+// by reference reads runs of nearby commits, and a little more after the last commit it needs, sequentially rather than
+// one commit at a time. Every entry it reads is kept here, so that later peeks of the same region, whether by the same
+// lagging tag or by others catching up alongside it, are served from memory.
+struct SpilledReadAheadCache {
+	std::map<int64_t, Standalone<StringRef>> entries;
+	std::deque<int64_t> insertionOrder;
+	int64_t bytes = 0;
+
+	Optional<Standalone<StringRef>> get(IDiskQueue::location start) const {
+		auto it = entries.find(start.lo);
+		if (it == entries.end()) {
+			return Optional<Standalone<StringRef>>();
+		}
+		return it->second;
+	}
+
+	// Entries are evicted in the order they were added, which is roughly the order of their locations
+	void add(IDiskQueue::location start, Standalone<StringRef> entry) {
+		if (!entries.emplace(start.lo, entry).second) {
+			return;
+		}
+		bytes += entry.size();
+		insertionOrder.push_back(start.lo);
+		while (bytes > SERVER_KNOBS->TLOG_SPILL_READ_AHEAD_CACHE_BYTES && !insertionOrder.empty()) {
+			auto it = entries.find(insertionOrder.front());
+			insertionOrder.pop_front();
+			if (it != entries.end()) {
+				bytes -= it->second.size();
+				entries.erase(it);
+			}
+		}
+	}
+};
+
 struct TLogData : NonCopyable {
 	AsyncTrigger newLogData;
 	// A process has only 1 SharedTLog, which holds data for multiple logs, so that it obeys its assigned memory limit.
@@ -329,6 +365,11 @@ struct TLogData : NonCopyable {
 	NotifiedVersion queueCommitEnd;
 	Version queueCommitBegin;
 
+	// Group commit state: the smoothed time a disk queue commit takes, and the number of tLogCommit batches pushed
+	// since the last commit began.
+	double smoothedQueueCommitTime = 0.0;
+	int64_t queueCommitPushes = 0;
+
 	int64_t instanceID;
 	int64_t bytesInput;
 	int64_t bytesDurable;
@@ -339,6 +380,7 @@ struct TLogData : NonCopyable {
 
 	WorkerCache<TLogInterface> tlogCache;
 	FlowLock peekMemoryLimiter;
+	SpilledReadAheadCache spilledReadAhead;
 
 	PromiseStream<Future<Void>> sharedActors;
 	Promise<Void> terminated;
@@ -404,7 +446,7 @@ struct TLogData : NonCopyable {
 
 struct LogData : NonCopyable, public ReferenceCounted<LogData> {
 	struct TagData : NonCopyable, public ReferenceCounted<TagData> {
-		std::deque<std::pair<Version, LengthPrefixedStringRef>> versionMessages;
+		TagMessageIndex versionMessages;
 		bool
 		    nothingPersistent; // true means tag is *known* to have no messages in persistentData.  false means nothing.
 		bool poppedRecently; // `popped` has changed since last updatePersistentData
@@ -448,25 +490,24 @@ struct LogData : NonCopyable, public ReferenceCounted<LogData> {
 		                                       TLogData* tlogData,
 		                                       Reference<LogData> logData,
 		                                       TaskPriority taskID) {
-			while (!self->versionMessages.empty() && self->versionMessages.front().first < before) {
-				Version version = self->versionMessages.front().first;
+			while (!self->versionMessages.empty() && self->versionMessages.frontVersion() < before) {
+				Version version = self->versionMessages.frontVersion();
 				std::pair<int, int>& sizes = logData->version_sizes[version];
 				int64_t messagesErased = 0;
 
-				while (!self->versionMessages.empty() && self->versionMessages.front().first == version) {
-					auto const& m = self->versionMessages.front();
+				while (!self->versionMessages.empty() && self->versionMessages.frontVersion() == version) {
 					++messagesErased;
 
 					if (self->tag.locality != tagLocalityTxs && self->tag != txsTag) {
-						sizes.first -= m.second.expectedSize();
+						sizes.first -= self->versionMessages.frontMessage().expectedSize();
 					} else {
-						sizes.second -= m.second.expectedSize();
+						sizes.second -= self->versionMessages.frontMessage().expectedSize();
 					}
 
 					self->versionMessages.pop_front();
 				}
 
-				int64_t bytesErased = messagesErased * SERVER_KNOBS->VERSION_MESSAGES_ENTRY_BYTES_WITH_OVERHEAD;
+				int64_t bytesErased = messagesErased * SERVER_KNOBS->TAG_MESSAGE_INDEX_ENTRY_BYTES_WITH_OVERHEAD;
 				logData->bytesDurable += bytesErased;
 				tlogData->bytesDurable += bytesErased;
 				tlogData->overheadBytesDurable += bytesErased;
@@ -569,6 +610,16 @@ struct LogData : NonCopyable, public ReferenceCounted<LogData> {
 	Counter blockingPeekTimeouts;
 	Counter emptyPeeks;
 	Counter nonEmptyPeeks;
+	Counter queueCommits;
+	Counter queueCommitPushes; // Divided by queueCommits, the number of commit batches made durable per fsync
+	Counter groupCommitWindows;
+	Counter peekTagsRequests;
+	Counter spilledCommitsReadAhead; // Spilled commits peeks found already read
+	Counter spilledCommitsRead; // Spilled commits peeks had to read
+	Counter peekBytesCompressed; // Message bytes of replies whose peeker asked for compression
+	Counter peekBytesAfterCompression; // What those replies sent, which is the original size if compression didn't help
+	LatencySample groupCommitWindowLatency; // Latency added by waiting for more batches to merge into a commit
+	LatencySample peekCompressionTime; // CPU time spent compressing each peek reply
 	std::map<Tag, LatencySample> blockingPeekLatencies;
 	std::map<Tag, LatencySample> peekVersionCounts;
 
@@ -658,7 +709,20 @@ struct LogData : NonCopyable, public ReferenceCounted<LogData> {
 	    unpoppedRecoveredTagCount(0), cc("TLog", interf.id().toString()), bytesInput("BytesInput", cc),
 	    bytesDurable("BytesDurable", cc), blockingPeeks("BlockingPeeks", cc),
 	    blockingPeekTimeouts("BlockingPeekTimeouts", cc), emptyPeeks("EmptyPeeks", cc),
-	    nonEmptyPeeks("NonEmptyPeeks", cc), logId(interf.id()), protocolVersion(protocolVersion),
+	    nonEmptyPeeks("NonEmptyPeeks", cc), queueCommits("QueueCommits", cc),
+	    queueCommitPushes("QueueCommitPushes", cc), groupCommitWindows("GroupCommitWindows", cc),
+	    peekTagsRequests("PeekTagsRequests", cc), spilledCommitsReadAhead("SpilledCommitsReadAhead", cc),
+	    spilledCommitsRead("SpilledCommitsRead", cc), peekBytesCompressed("PeekBytesCompressed", cc),
+	    peekBytesAfterCompression("PeekBytesAfterCompression", cc),
+	    groupCommitWindowLatency("TLogGroupCommitWindowLatency",
+	                             interf.id(),
+	                             SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
+	                             SERVER_KNOBS->LATENCY_SKETCH_ACCURACY),
+	    peekCompressionTime("TLogPeekCompressionTime",
+	                        interf.id(),
+	                        SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
+	                        SERVER_KNOBS->LATENCY_SKETCH_ACCURACY),
+	    logId(interf.id()), protocolVersion(protocolVersion),
 	    newPersistentDataVersion(invalidVersion), tLogData(tLogData), unrecoveredBefore(1), recoveredAt(1),
 	    recoveryTxnVersion(1), logSystem(new AsyncVar<Reference<ILogSystem>>()), remoteTag(remoteTag),
 	    isPrimary(isPrimary), logRouterTags(logRouterTags), logRouterPoppedVersion(0), logRouterPopToVersion(0),
@@ -695,6 +759,7 @@ struct LogData : NonCopyable, public ReferenceCounted<LogData> {
 		specialCounter(cc, "SharedOverheadBytesDurable", [tLogData]() { return tLogData->overheadBytesDurable; });
 		specialCounter(cc, "PeekMemoryReserved", [tLogData]() { return tLogData->peekMemoryLimiter.activePermits(); });
 		specialCounter(cc, "PeekMemoryRequestsStalled", [tLogData]() { return tLogData->peekMemoryLimiter.waiters(); });
+		specialCounter(cc, "SpilledReadAheadBytes", [tLogData]() { return tLogData->spilledReadAhead.bytes; });
 		specialCounter(cc, "Generation", [this]() { return this->recoveryCount; });
 		specialCounter(cc, "ActivePeekStreams", [tLogData]() { return tLogData->activePeekStreams; });
 	}
@@ -780,15 +845,17 @@ struct LogData : NonCopyable, public ReferenceCounted<LogData> {
 
 template <class T>
 void TLogQueue::push(T const& qe, Reference<LogData> logData) {
-	BinaryWriter wr(Unversioned()); // outer framing is not versioned
-	wr << uint32_t(0);
-	IncludeVersion(ProtocolVersion::withTLogQueueEntryRef()).write(wr); // payload is versioned
+	// The entry is serialized straight into the queue's pages, so that its messages are copied only once. Its length,
+	// which comes first, is found by serializing it into a writer that only counts.
+	DiskQueueWriter payload(nullptr, IncludeVersion(ProtocolVersion::withTLogQueueEntryRef())); // payload is versioned
+	payload << qe;
+	const IDiskQueue::location startloc = queue->getNextPushLocation();
+	DiskQueueWriter wr(queue, Unversioned()); // outer framing is not versioned
+	wr << uint32_t(payload.getLength());
+	IncludeVersion(ProtocolVersion::withTLogQueueEntryRef()).write(wr);
 	wr << qe;
 	wr << uint8_t(1);
-	*(uint32_t*)wr.getData() = wr.getLength() - sizeof(uint32_t) - sizeof(uint8_t);
-	const IDiskQueue::location startloc = queue->getNextPushLocation();
-	// FIXME: push shouldn't return anything.  We should call getNextPushLocation() again.
-	const IDiskQueue::location endloc = queue->push(wr.toValue());
+	const IDiskQueue::location endloc = wr.finish();
 	//TraceEvent("TLogQueueVersionWritten", dbgid).detail("Size", wr.getLength() - sizeof(uint32_t) - sizeof(uint8_t)).detail("Loc", loc);
 	logData->versionLocation[qe.version] = std::make_pair(startloc, endloc);
 }
@@ -1027,21 +1094,20 @@ ACTOR Future<Void> updatePersistentData(TLogData* self, Reference<LogData> logDa
 				state Version lastVersion = std::numeric_limits<Version>::min();
 				state IDiskQueue::location firstLocation = std::numeric_limits<IDiskQueue::location>::max();
 				// Transfer unpopped messages with version numbers less than newPersistentDataVersion to persistentData
-				state std::deque<std::pair<Version, LengthPrefixedStringRef>>::iterator msg =
-				    tagData->versionMessages.begin();
+				state TagMessageIndex::iterator msg = tagData->versionMessages.begin();
 				state int refSpilledTagCount = 0;
 				wr = BinaryWriter(AssumeVersion(logData->protocolVersion));
 				// We prefix our spilled locations with a count, so that we can read this back out as a VectorRef.
 				wr << uint32_t(0);
-				while (msg != tagData->versionMessages.end() && msg->first <= newPersistentDataVersion) {
-					currentVersion = msg->first;
+				while (msg != tagData->versionMessages.end() && msg.version() <= newPersistentDataVersion) {
+					currentVersion = msg.version();
 					anyData = true;
 					tagData->nothingPersistent = false;
 
 					if (logData->shouldSpillByValue(tagData->tag)) {
 						wr = BinaryWriter(Unversioned());
-						for (; msg != tagData->versionMessages.end() && msg->first == currentVersion; ++msg) {
-							wr << msg->second.toStringRef();
+						for (; msg != tagData->versionMessages.end() && msg.version() == currentVersion; ++msg) {
+							wr << msg.message().toStringRef();
 						}
 						self->persistentData->set(KeyValueRef(
 						    persistTagMessagesKey(logData->logId, tagData->tag, currentVersion), wr.toValue()));
@@ -1054,9 +1120,9 @@ ACTOR Future<Void> updatePersistentData(TLogData* self, Reference<LogData> logDa
 						refSpilledTagCount++;
 
 						uint32_t size = 0;
-						for (; msg != tagData->versionMessages.end() && msg->first == currentVersion; ++msg) {
+						for (; msg != tagData->versionMessages.end() && msg.version() == currentVersion; ++msg) {
 							// Fast forward until we find a new version.
-							size += msg->second.expectedSize();
+							size += msg.message().expectedSize();
 						}
 
 						SpilledData spilledData(currentVersion, begin, length, size);
@@ -1079,11 +1145,7 @@ ACTOR Future<Void> updatePersistentData(TLogData* self, Reference<LogData> logDa
 						Future<Void> f = yield(TaskPriority::UpdateStorage);
 						if (!f.isReady()) {
 							wait(f);
-							msg = std::upper_bound(
-							    tagData->versionMessages.begin(),
-							    tagData->versionMessages.end(),
-							    std::make_pair(currentVersion, LengthPrefixedStringRef()),
-							    [](const auto& l, const auto& r) -> bool { return l.first < r.first; });
+							msg = tagData->versionMessages.upper_bound(currentVersion);
 						}
 					}
 				}
@@ -1565,16 +1627,15 @@ void commitMessages(TLogData* self,
 			}
 
 			if (version >= tagData->popped) {
-				tagData->versionMessages.emplace_back(
-				    version, LengthPrefixedStringRef((uint32_t*)(block.end() - msg.message.size())));
-				if (tagData->versionMessages.back().second.expectedSize() > SERVER_KNOBS->MAX_MESSAGE_SIZE) {
-					TraceEvent(SevWarnAlways, "LargeMessage")
-					    .detail("Size", tagData->versionMessages.back().second.expectedSize());
+				LengthPrefixedStringRef message((uint32_t*)(block.end() - msg.message.size()));
+				tagData->versionMessages.push_back(version, message);
+				if (message.expectedSize() > SERVER_KNOBS->MAX_MESSAGE_SIZE) {
+					TraceEvent(SevWarnAlways, "LargeMessage").detail("Size", message.expectedSize());
 				}
 				if (tag.locality != tagLocalityTxs && tag != txsTag) {
-					expectedBytes += tagData->versionMessages.back().second.expectedSize();
+					expectedBytes += message.expectedSize();
 				} else {
-					txsBytes += tagData->versionMessages.back().second.expectedSize();
+					txsBytes += message.expectedSize();
 				}
 				if (SERVER_KNOBS->ENABLE_VERSION_VECTOR) {
 					auto iter = logData->waitingTags.find(tag);
@@ -1585,12 +1646,11 @@ void commitMessages(TLogData* self,
 					}
 				}
 
-				// The factor of VERSION_MESSAGES_OVERHEAD is intended to be an overestimate of the actual memory used
-				// to store this data in a std::deque. In practice, this number is probably something like 528/512
-				// ~= 1.03, but this could vary based on the implementation. There will also be a fixed overhead per
-				// std::deque, but its size should be trivial relative to the size of the TLog queue and can be thought
-				// of as increasing the capacity of the queue slightly.
-				overheadBytes += SERVER_KNOBS->VERSION_MESSAGES_ENTRY_BYTES_WITH_OVERHEAD;
+				// The factor of TAG_MESSAGE_INDEX_OVERHEAD is intended to be an overestimate of the actual memory used
+				// to store this data in a TagMessageIndex, whose blocks are full except at either end. The partially
+				// filled blocks are a fixed overhead per tag, which should be trivial relative to the size of the TLog
+				// queue and can be thought of as increasing the capacity of the queue slightly.
+				overheadBytes += SERVER_KNOBS->TAG_MESSAGE_INDEX_ENTRY_BYTES_WITH_OVERHEAD;
 			}
 		}
 
@@ -1630,10 +1690,10 @@ Version poppedVersion(Reference<LogData> self, Tag tag) {
 	return tagData->popped;
 }
 
-std::deque<std::pair<Version, LengthPrefixedStringRef>>& getVersionMessages(Reference<LogData> self, Tag tag) {
+TagMessageIndex& getVersionMessages(Reference<LogData> self, Tag tag) {
 	auto tagData = self->getTagData(tag);
 	if (!tagData) {
-		static std::deque<std::pair<Version, LengthPrefixedStringRef>> empty;
+		static TagMessageIndex empty;
 		return empty;
 	}
 	return tagData->versionMessages;
@@ -1642,7 +1702,7 @@ std::deque<std::pair<Version, LengthPrefixedStringRef>>& getVersionMessages(Refe
 ACTOR Future<Void> waitForMessagesForTag(Reference<LogData> self, Tag reqTag, Version reqBegin, double timeout) {
 	self->blockingPeeks += 1;
 	auto tagData = self->getTagData(reqTag);
-	if (tagData.isValid() && !tagData->versionMessages.empty() && tagData->versionMessages.back().first >= reqBegin) {
+	if (tagData.isValid() && !tagData->versionMessages.empty() && tagData->versionMessages.backVersion() >= reqBegin) {
 		return Void();
 	}
 	choose {
@@ -1665,32 +1725,29 @@ void peekMessagesFromMemory(Reference<LogData> self,
 	ASSERT(!messages.getLength());
 
 	int versionCount = 0;
-	auto& deque = getVersionMessages(self, tag);
+	auto& versionMessages = getVersionMessages(self, tag);
 	//TraceEvent("TLogPeekMem", self->dbgid).detail("Tag", req.tag1).detail("PDS", self->persistentDataSequence).detail("PDDS", self->persistentDataDurableSequence).detail("Oldest", map1.empty() ? 0 : map1.begin()->key ).detail("OldestMsgCount", map1.empty() ? 0 : map1.begin()->value.size());
 
 	begin = std::max(begin, self->persistentDataDurableVersion + 1);
-	auto it = std::lower_bound(deque.begin(),
-	                           deque.end(),
-	                           std::make_pair(begin, LengthPrefixedStringRef()),
-	                           [](const auto& l, const auto& r) -> bool { return l.first < r.first; });
+	auto it = versionMessages.lower_bound(begin);
 
 	Version currentVersion = -1;
-	for (; it != deque.end(); ++it) {
-		if (it->first != currentVersion) {
+	for (; it != versionMessages.end(); ++it) {
+		if (it.version() != currentVersion) {
 			if (messages.getLength() >= SERVER_KNOBS->DESIRED_TOTAL_BYTES) {
 				endVersion = currentVersion + 1;
 				//TraceEvent("TLogPeekMessagesReached2", self->dbgid);
 				break;
 			}
 
-			currentVersion = it->first;
+			currentVersion = it.version();
 			messages << VERSION_HEADER << currentVersion;
 		}
 
 		// We need the 4 byte length prefix to be a TagsAndMessage format, but that prefix is added as part of StringRef
 		// serialization.
 		int offset = messages.getLength();
-		messages << it->second.toStringRef();
+		messages << it.message().toStringRef();
 		void* data = messages.getData();
 		DEBUG_TAGS_AND_MESSAGE(
 		    "TLogPeek", currentVersion, StringRef((uint8_t*)data + offset, messages.getLength() - offset), self->logId)
@@ -1715,19 +1772,100 @@ void peekMessagesFromMemory(Reference<LogData> self,
 	}
 }
 
-ACTOR Future<std::vector<StringRef>> parseMessagesForTag(StringRef commitBlob, Tag tag, int logRouters) {
+// As peekMessagesFromMemory, for several tags at once. The tags' messages are merged by version, and a message with
+// more than one of the tags is only written once. Within a version, messages are written in subsequence order, which
+// is the order they were committed in.
+void peekTagsFromMemory(Reference<LogData> self,
+                        std::vector<Tag> const& tags,
+                        Version begin,
+                        BinaryWriter& messages,
+                        Version& endVersion) {
+	ASSERT(!messages.getLength());
+
+	begin = std::max(begin, self->persistentDataDurableVersion + 1);
+	std::vector<TagMessageIndex::iterator> cursors;
+	std::vector<TagMessageIndex::iterator> cursorEnds;
+	// A min-heap of (next version, cursor)
+	std::vector<std::pair<Version, int>> heap;
+	for (Tag const& tag : tags) {
+		auto& versionMessages = getVersionMessages(self, tag);
+		auto it = versionMessages.lower_bound(begin);
+		if (it != versionMessages.end()) {
+			heap.emplace_back(it.version(), cursors.size());
+			cursors.push_back(it);
+			cursorEnds.push_back(versionMessages.end());
+		}
+	}
+	auto later = [](std::pair<Version, int> const& l, std::pair<Version, int> const& r) { return l > r; };
+	std::make_heap(heap.begin(), heap.end(), later);
+
+	int versionCount = 0;
+	Version currentVersion = -1;
+	std::vector<uint32_t*> versionMessages;
+	while (!heap.empty()) {
+		if (messages.getLength() >= SERVER_KNOBS->DESIRED_TOTAL_BYTES) {
+			endVersion = currentVersion + 1;
+			break;
+		}
+		currentVersion = heap.front().first;
+		versionMessages.clear();
+		while (!heap.empty() && heap.front().first == currentVersion) {
+			std::pop_heap(heap.begin(), heap.end(), later);
+			int c = heap.back().second;
+			heap.pop_back();
+			for (; cursors[c] != cursorEnds[c] && cursors[c].version() == currentVersion; ++cursors[c]) {
+				versionMessages.push_back(cursors[c].message().getLengthPtr());
+			}
+			if (cursors[c] != cursorEnds[c]) {
+				heap.emplace_back(cursors[c].version(), c);
+				std::push_heap(heap.begin(), heap.end(), later);
+			}
+		}
+
+		// The subsequence follows each message's length. Copies of a message share its storage, so they sort next to
+		// each other.
+		std::sort(versionMessages.begin(), versionMessages.end(), [](uint32_t* l, uint32_t* r) {
+			return std::make_pair(l[1], l) < std::make_pair(r[1], r);
+		});
+		versionMessages.erase(std::unique(versionMessages.begin(), versionMessages.end()), versionMessages.end());
+
+		messages << VERSION_HEADER << currentVersion;
+		for (uint32_t* message : versionMessages) {
+			messages << LengthPrefixedStringRef(message).toStringRef();
+		}
+		versionCount++;
+	}
+
+	if (versionCount == 0) {
+		++self->emptyPeeks;
+	} else {
+		++self->nonEmptyPeeks;
+	}
+}
+
+// Returns the messages in commitBlob which have any of the given tags
+ACTOR Future<std::vector<StringRef>> parseMessagesForTags(StringRef commitBlob,
+                                                          std::vector<Tag> tags,
+                                                          int logRouters) {
 	// See the comment in LogSystem.cpp for the binary format of commitBlob.
 	state std::vector<StringRef> relevantMessages;
 	state BinaryReader rd(commitBlob, AssumeVersion(g_network->protocolVersion()));
 	while (!rd.empty()) {
 		TagsAndMessage tagsAndMessage;
 		tagsAndMessage.loadFromArena(&rd, nullptr);
+		bool relevant = false;
 		for (Tag t : tagsAndMessage.tags) {
-			if (t == tag || (tag.locality == tagLocalityLogRouter && t.locality == tagLocalityLogRouter &&
-			                 t.id % logRouters == tag.id)) {
-				// Mutations that are in the partially durable span between known committed version and
-				// recovery version get copied to the new log generation.  These commits might have had more
-				// log router tags than what now exist, so we mod them down to what we have.
+			for (Tag const& tag : tags) {
+				if (t == tag || (tag.locality == tagLocalityLogRouter && t.locality == tagLocalityLogRouter &&
+				                 t.id % logRouters == tag.id)) {
+					// Mutations that are in the partially durable span between known committed version and
+					// recovery version get copied to the new log generation.  These commits might have had more
+					// log router tags than what now exist, so we mod them down to what we have.
+					relevant = true;
+					break;
+				}
+			}
+			if (relevant) {
 				relevantMessages.push_back(tagsAndMessage.getRawMessage());
 				break;
 			}
@@ -1737,6 +1875,158 @@ ACTOR Future<std::vector<StringRef>> parseMessagesForTag(StringRef commitBlob, T
 	return relevantMessages;
 }
 
+// The disk queue reads needed for the spilled commits a peek wants, planned before the peek reserves memory for them
+struct SpilledReadPlan {
+	std::vector<std::pair<IDiskQueue::location, IDiskQueue::location>> commits;
+	std::vector<Optional<Standalone<StringRef>>> cached; // For each commit, its entry if it had already been read
+	std::vector<std::pair<IDiskQueue::location, IDiskQueue::location>> reads;
+	uint64_t readBytes = 0; // The bytes read beyond the commits themselves, when reading ahead
+};
+
+// Plans reads for commits, which are in location order and end with the commit of lastVersion. With read ahead enabled,
+// each read covers a run of commits with gaps of at most TLOG_SPILL_READ_AHEAD_BYTES between them, and the last also
+// covers up to TLOG_SPILL_READ_AHEAD_BYTES of spilled commits after lastVersion.
+SpilledReadPlan planSpilledReads(TLogData* self,
+                                 Reference<LogData> logData,
+                                 std::vector<std::pair<IDiskQueue::location, IDiskQueue::location>> commits,
+                                 Version lastVersion) {
+	SpilledReadPlan plan;
+	plan.commits = std::move(commits);
+	const int64_t readAhead = SERVER_KNOBS->TLOG_SPILL_READ_AHEAD_BYTES;
+	if (readAhead <= 0) {
+		plan.cached.resize(plan.commits.size());
+		plan.reads = plan.commits;
+		logData->spilledCommitsRead += plan.commits.size();
+		return plan;
+	}
+
+	for (const auto& commit : plan.commits) {
+		plan.cached.push_back(self->spilledReadAhead.get(commit.first));
+		if (plan.cached.back().present()) {
+			++logData->spilledCommitsReadAhead;
+			continue;
+		}
+		++logData->spilledCommitsRead;
+		if (!plan.reads.empty() && commit.first.lo - plan.reads.back().second.lo <= readAhead) {
+			plan.reads.back().second = commit.second;
+		} else {
+			plan.reads.push_back(commit);
+		}
+	}
+
+	if (!plan.reads.empty()) {
+		const IDiskQueue::location lastCommitEnd = plan.commits.back().second;
+		if (plan.reads.back().second == lastCommitEnd) {
+			for (auto it = logData->versionLocation.upper_bound(lastVersion);
+			     it != logData->versionLocation.end() && it->key <= logData->persistentDataDurableVersion &&
+			     it->value.second.lo - lastCommitEnd.lo <= readAhead;
+			     ++it) {
+				plan.reads.back().second = it->value.second;
+			}
+		}
+		uint64_t commitBytes = 0;
+		for (const auto& commit : plan.commits) {
+			commitBytes += commit.second.lo - commit.first.lo;
+		}
+		for (const auto& read : plan.reads) {
+			plan.readBytes += read.second.lo - read.first.lo;
+		}
+		plan.readBytes -= std::min(plan.readBytes, commitBytes);
+	}
+	return plan;
+}
+
+// Returns the disk queue entry of each commit in plan, in the format IDiskQueue::read() returns a single entry in.
+// Entries of logData that were read, including ones no peek has asked for yet, are added to self->spilledReadAhead.
+ACTOR Future<std::vector<Standalone<StringRef>>> readSpilledCommits(TLogData* self,
+                                                                    Reference<LogData> logData,
+                                                                    SpilledReadPlan plan) {
+	state std::vector<Future<Standalone<StringRef>>> reads;
+	reads.reserve(plan.reads.size());
+	for (const auto& read : plan.reads) {
+		reads.push_back(self->rawPersistentQueue->read(read.first, read.second, CheckHashes::True));
+	}
+	wait(waitForAll(reads));
+
+	if (SERVER_KNOBS->TLOG_SPILL_READ_AHEAD_BYTES <= 0) {
+		std::vector<Standalone<StringRef>> entries;
+		entries.reserve(reads.size());
+		for (const auto& read : reads) {
+			entries.push_back(read.get());
+		}
+		return entries;
+	}
+
+	// Each read holds whole entries back to back: a 4 byte length, the entry, and a byte that is 1 if the entry is
+	// valid. Entries of other logs sharing the queue and the remains of partial commits are skipped.
+	state int i = 0;
+	for (i = 0; i < reads.size(); i++) {
+		Standalone<StringRef> data = reads[i].get();
+		int offset = 0;
+		while (offset + (int)sizeof(uint32_t) <= data.size()) {
+			const uint32_t length = *(const uint32_t*)(data.begin() + offset);
+			if (length >= data.size() || offset + sizeof(uint32_t) + length + sizeof(uint8_t) > data.size()) {
+				break;
+			}
+			const int entryBytes = sizeof(uint32_t) + length + sizeof(uint8_t);
+			if (data[offset + entryBytes - 1] == 1) {
+				ArenaReader rd(data.arena(), data.substr(offset + sizeof(uint32_t), length), IncludeVersion());
+				TLogQueueEntryRef entry;
+				rd >> entry;
+				auto location = logData->versionLocation.find(entry.version);
+				if (entry.id == logData->logId && location != logData->versionLocation.end()) {
+					// Copy the entry out, so that caching it does not keep the whole read in memory
+					self->spilledReadAhead.add(location->value.first,
+					                           Standalone<StringRef>(data.substr(offset, entryBytes)));
+				}
+			}
+			offset += entryBytes;
+		}
+		wait(yield(TaskPriority::TLogSpilledPeekReply));
+	}
+	reads.clear();
+
+	// The cache may have evicted an entry, or a read may have ended early, so read any commits that are still missing
+	state std::vector<Future<Standalone<StringRef>>> entryReads;
+	for (i = 0; i < plan.commits.size(); i++) {
+		if (!plan.cached[i].present()) {
+			plan.cached[i] = self->spilledReadAhead.get(plan.commits[i].first);
+		}
+		entryReads.push_back(plan.cached[i].present() ? Future<Standalone<StringRef>>(plan.cached[i].get())
+		                                           : self->rawPersistentQueue->read(plan.commits[i].first,
+		                                                                            plan.commits[i].second,
+		                                                                            CheckHashes::True));
+	}
+	wait(waitForAll(entryReads));
+
+	std::vector<Standalone<StringRef>> entries;
+	entries.reserve(entryReads.size());
+	for (const auto& entry : entryReads) {
+		entries.push_back(entry.get());
+	}
+	return entries;
+}
+
+// Compresses the messages of a peek reply with the filter its peeker asked for, if this process supports it and there
+// are enough messages for it to be worthwhile. The reply goes out uncompressed if compressing doesn't make it smaller.
+void compressPeekReply(LogData* logData, TLogPeekReply& reply, CompressionFilter filter) {
+	if (filter == CompressionFilter::NONE || reply.messages.size() < SERVER_KNOBS->TLOG_PEEK_COMPRESSION_MIN_BYTES ||
+	    !CompressionUtils::supportedFilters.count(filter)) {
+		return;
+	}
+	const double start = g_network->timer();
+	Arena arena;
+	StringRef compressed = CompressionUtils::compress(filter, reply.messages, arena);
+	logData->peekCompressionTime.addMeasurement(g_network->timer() - start);
+	logData->peekBytesCompressed += reply.messages.size();
+	if (compressed.size() < reply.messages.size()) {
+		reply.arena.dependsOn(arena);
+		reply.messages = compressed;
+		reply.compression = filter;
+	}
+	logData->peekBytesAfterCompression += reply.messages.size();
+}
+
 // Common logics to peek TLog and create TLogPeekReply that serves both streaming peek or normal peek request
 ACTOR template <typename PromiseType>
 Future<Void> tLogPeekMessages(PromiseType replyPromise,
@@ -1746,7 +2036,8 @@ Future<Void> tLogPeekMessages(PromiseType replyPromise,
                               Tag reqTag,
                               bool reqReturnIfBlocked = false,
                               bool reqOnlySpilled = false,
-                              Optional<std::pair<UID, int>> reqSequence = Optional<std::pair<UID, int>>()) {
+                              Optional<std::pair<UID, int>> reqSequence = Optional<std::pair<UID, int>>(),
+                              Optional<CompressionFilter> reqCompression = Optional<CompressionFilter>()) {
 	state BinaryWriter messages(Unversioned());
 	state BinaryWriter messages2(Unversioned());
 	state int sequence = -1;
@@ -1996,6 +2287,7 @@ Future<Void> tLogPeekMessages(PromiseType replyPromise,
 				uint32_t mutationBytes = 0;
 				state uint64_t commitBytes = 0;
 				state Version firstVersion = std::numeric_limits<Version>::max();
+				state Version lastVersion = invalidVersion;
 				for (int i = 0; i < kvrefs.size() && i < SERVER_KNOBS->TLOG_SPILL_REFERENCE_MAX_BATCHES_PER_PEEK; i++) {
 					auto& kv = kvrefs[i];
 					VectorRef<SpilledData> spilledData;
@@ -2008,6 +2300,7 @@ Future<Void> tLogPeekMessages(PromiseType replyPromise,
 						}
 						if (sd.version >= reqBegin) {
 							firstVersion = std::min(firstVersion, sd.version);
+							lastVersion = std::max(lastVersion, sd.version);
 							const IDiskQueue::location end = sd.start.lo + sd.length;
 							commitLocations.emplace_back(sd.start, end);
 							// This isn't perfect, because we aren't accounting for page boundaries, but should be
@@ -2020,22 +2313,20 @@ Future<Void> tLogPeekMessages(PromiseType replyPromise,
 						break;
 				}
 				earlyEnd = earlyEnd || (kvrefs.size() >= SERVER_KNOBS->TLOG_SPILL_REFERENCE_MAX_BATCHES_PER_PEEK + 1);
+				state SpilledReadPlan readPlan =
+				    planSpilledReads(self, logData, std::move(commitLocations), lastVersion);
+				commitBytes += readPlan.readBytes;
 				wait(self->peekMemoryLimiter.take(TaskPriority::TLogSpilledPeekReply, commitBytes));
 				state FlowLock::Releaser memoryReservation(self->peekMemoryLimiter, commitBytes);
-				state std::vector<Future<Standalone<StringRef>>> messageReads;
-				messageReads.reserve(commitLocations.size());
-				for (const auto& pair : commitLocations) {
-					messageReads.push_back(self->rawPersistentQueue->read(pair.first, pair.second, CheckHashes::True));
-				}
-				commitLocations.clear();
-				wait(waitForAll(messageReads));
+				state std::vector<Standalone<StringRef>> messageReads;
+				wait(store(messageReads, readSpilledCommits(self, logData, std::move(readPlan))));
 
 				state Version lastRefMessageVersion = 0;
 				state int index = 0;
 				loop {
 					if (index >= messageReads.size())
 						break;
-					Standalone<StringRef> queueEntryData = messageReads[index].get();
+					Standalone<StringRef> queueEntryData = messageReads[index];
 					uint8_t valid;
 					const uint32_t length = *(uint32_t*)queueEntryData.begin();
 					queueEntryData = queueEntryData.substr(4, queueEntryData.size() - 4);
@@ -2048,7 +2339,7 @@ Future<Void> tLogPeekMessages(PromiseType replyPromise,
 					messages << VERSION_HEADER << entry.version;
 
 					std::vector<StringRef> rawMessages =
-					    wait(parseMessagesForTag(entry.messages, reqTag, logData->logRouterTags));
+					    wait(parseMessagesForTags(entry.messages, std::vector<Tag>(1, reqTag), logData->logRouterTags));
 					for (const StringRef& msg : rawMessages) {
 						messages.serializeBytes(msg);
 						DEBUG_TAGS_AND_MESSAGE("TLogPeekFromDisk", entry.version, msg, logData->logId)
@@ -2117,6 +2408,10 @@ Future<Void> tLogPeekMessages(PromiseType replyPromise,
 	    .detail("EndVer", reply.end)
 	    .detail("MsgBytes", reply.messages.expectedSize());
 
+	if (reqCompression.present()) {
+		compressPeekReply(logData.getPtr(), reply, reqCompression.get());
+	}
+
 	if (reqSequence.present()) {
 		auto& trackerData = logData->peekTracker[peekId];
 		trackerData.lastUpdate = now();
@@ -2181,7 +2476,15 @@ ACTOR Future<Void> tLogPeekStream(TLogData* self, TLogPeekStreamRequest req, Ref
 		state Future<TLogPeekReply> future(promise.getFuture());
 		try {
 			wait(req.reply.onReady() && store(reply.rep, future) &&
-			     tLogPeekMessages(promise, self, logData, begin, req.tag, req.returnIfBlocked, onlySpilled));
+			     tLogPeekMessages(promise,
+			                      self,
+			                      logData,
+			                      begin,
+			                      req.tag,
+			                      req.returnIfBlocked,
+			                      onlySpilled,
+			                      Optional<std::pair<UID, int>>(),
+			                      req.compression));
 
 			reply.rep.begin = begin;
 			req.reply.send(reply);
@@ -2209,14 +2512,209 @@ ACTOR Future<Void> tLogPeekStream(TLogData* self, TLogPeekStreamRequest req, Ref
 	}
 }
 
+// Serves a TLogPeekTagsRequest. This follows tLogPeekMessages, but scans memory once for all of the tags, and reads
+// each spilled commit from the disk queue once however many of the tags it has messages for. Sequenced peeks, empty
+// peek batching and version vector's blocking peeks are not supported; the caller decides when to ask again.
+ACTOR Future<Void> tLogPeekTagsMessages(TLogData* self, TLogPeekTagsRequest req, Reference<LogData> logData) {
+	state BinaryWriter messages(Unversioned());
+	state BinaryWriter messages2(Unversioned());
+	state Version endVersion;
+	state bool onlySpilled = false;
+	state bool hasLogRouterTag = false;
+	state TLogPeekTagsReply reply;
+
+	++logData->peekTagsRequests;
+	for (Tag const& tag : req.tags) {
+		// Spilled by value data is stored per tag, so there is nothing to share for it, and txsTag is only peeked
+		// during recovery.
+		if (logData->shouldSpillByValue(tag)) {
+			req.reply.sendError(unsupported_operation());
+			return Void();
+		}
+		hasLogRouterTag = hasLogRouterTag || tag.locality == tagLocalityLogRouter;
+	}
+	if (req.tags.empty()) {
+		req.reply.sendError(unsupported_operation());
+		return Void();
+	}
+
+	if (req.returnIfBlocked && logData->version.get() < req.begin) {
+		req.reply.sendError(end_of_stream());
+		return Void();
+	}
+
+	// Wait until we have something to return that the caller doesn't already have
+	if (logData->version.get() < req.begin) {
+		wait(logData->version.whenAtLeast(req.begin));
+		wait(delay(SERVER_KNOBS->TLOG_PEEK_DELAY, g_network->getCurrentTask()));
+	}
+	if (!logData->stopped() && logData->version.get() < logData->recoveryTxnVersion) {
+		// Make sure the peek reply has the recovery txn for the current TLog.
+		wait(logData->version.whenAtLeast(logData->recoveryTxnVersion) || logData->stoppedPromise.getFuture());
+	}
+
+	if (logData->locality != tagLocalitySatellite && hasLogRouterTag) {
+		wait(self->concurrentLogRouterReads.take());
+		state FlowLock::Releaser globalReleaser(self->concurrentLogRouterReads);
+		wait(delay(0.0, TaskPriority::Low));
+	}
+
+	if (req.begin <= logData->persistentDataDurableVersion) {
+		// As for a single tag, helping a lagging storage server catch up should not come before the rest of the
+		// cluster.
+		wait(delay(0, TaskPriority::TLogSpilledPeekReply));
+	}
+
+	for (Tag const& tag : req.tags) {
+		Version popped = poppedVersion(logData, tag);
+		if (popped > req.begin) {
+			reply.popped.emplace_back(tag, popped);
+		}
+	}
+
+	endVersion = logData->version.get() + 1;
+	if (req.begin <= logData->persistentDataDurableVersion) {
+		// Just in case the durable version changes while we are waiting for the read, we grab this data from memory.
+		if (req.onlySpilled) {
+			endVersion = logData->persistentDataDurableVersion + 1;
+		} else {
+			peekTagsFromMemory(logData, req.tags, req.begin, messages2, endVersion);
+		}
+
+		state std::vector<Future<RangeResult>> refReads;
+		for (Tag const& tag : req.tags) {
+			refReads.push_back(self->persistentData->readRange(
+			    KeyRangeRef(persistTagMessageRefsKey(logData->logId, tag, req.begin),
+			                persistTagMessageRefsKey(logData->logId, tag, logData->persistentDataDurableVersion + 1)),
+			    SERVER_KNOBS->TLOG_SPILL_REFERENCE_MAX_BATCHES_PER_PEEK + 1));
+		}
+		wait(waitForAll(refReads));
+
+		// Commits with messages for several of the tags are referenced by each of them. Only read each one once. If a
+		// tag had more spilled batches than one peek reads, versions after the last one read for it are left for the
+		// next peek, since they may be missing its messages.
+		state std::map<Version, std::pair<IDiskQueue::location, IDiskQueue::location>> commitLocations;
+		state std::map<Version, uint32_t> commitMutationBytes;
+		state Version lastCompleteVersion = std::numeric_limits<Version>::max();
+		state bool earlyEnd = false;
+		for (auto const& f : refReads) {
+			RangeResult const& kvrefs = f.get();
+			Version lastTagVersion = invalidVersion;
+			for (int i = 0; i < kvrefs.size() && i < SERVER_KNOBS->TLOG_SPILL_REFERENCE_MAX_BATCHES_PER_PEEK; i++) {
+				VectorRef<SpilledData> spilledData;
+				BinaryReader r(kvrefs[i].value, AssumeVersion(logData->protocolVersion));
+				r >> spilledData;
+				for (const SpilledData& sd : spilledData) {
+					if (sd.version >= req.begin) {
+						commitLocations.try_emplace(sd.version, sd.start, sd.start.lo + sd.length);
+						commitMutationBytes[sd.version] += sd.mutationBytes;
+						lastTagVersion = std::max(lastTagVersion, sd.version);
+					}
+				}
+			}
+			if (kvrefs.size() >= SERVER_KNOBS->TLOG_SPILL_REFERENCE_MAX_BATCHES_PER_PEEK + 1) {
+				earlyEnd = true;
+				lastCompleteVersion = std::min(lastCompleteVersion, lastTagVersion);
+			}
+		}
+		refReads.clear();
+
+		state std::vector<std::pair<IDiskQueue::location, IDiskQueue::location>> readLocations;
+		state uint64_t commitBytes = 0;
+		state Version lastReadVersion = invalidVersion;
+		uint32_t mutationBytes = 0;
+		for (auto const& [version, location] : commitLocations) {
+			if (version > lastCompleteVersion || mutationBytes >= SERVER_KNOBS->DESIRED_TOTAL_BYTES) {
+				earlyEnd = true;
+				break;
+			}
+			readLocations.push_back(location);
+			lastReadVersion = version;
+			// This isn't perfect, because we aren't accounting for page boundaries, but should be close enough.
+			commitBytes += location.second.lo - location.first.lo;
+			mutationBytes += commitMutationBytes[version];
+		}
+		commitLocations.clear();
+		commitMutationBytes.clear();
+		state SpilledReadPlan readPlan = planSpilledReads(self, logData, std::move(readLocations), lastReadVersion);
+		commitBytes += readPlan.readBytes;
+		wait(self->peekMemoryLimiter.take(TaskPriority::TLogSpilledPeekReply, commitBytes));
+		state FlowLock::Releaser memoryReservation(self->peekMemoryLimiter, commitBytes);
+		state std::vector<Standalone<StringRef>> messageReads;
+		wait(store(messageReads, readSpilledCommits(self, logData, std::move(readPlan))));
+
+		state Version lastRefMessageVersion = 0;
+		state int index = 0;
+		for (index = 0; index < messageReads.size(); index++) {
+			Standalone<StringRef> queueEntryData = messageReads[index];
+			uint8_t valid;
+			const uint32_t length = *(uint32_t*)queueEntryData.begin();
+			queueEntryData = queueEntryData.substr(4, queueEntryData.size() - 4);
+			BinaryReader rd(queueEntryData, IncludeVersion());
+			state TLogQueueEntry entry;
+			rd >> entry >> valid;
+			ASSERT(valid == 0x01);
+			ASSERT(length + sizeof(valid) == queueEntryData.size());
+
+			messages << VERSION_HEADER << entry.version;
+
+			std::vector<StringRef> rawMessages =
+			    wait(parseMessagesForTags(entry.messages, req.tags, logData->logRouterTags));
+			for (const StringRef& msg : rawMessages) {
+				messages.serializeBytes(msg);
+			}
+
+			lastRefMessageVersion = entry.version;
+		}
+
+		messageReads.clear();
+		memoryReservation.release();
+
+		if (earlyEnd) {
+			endVersion = lastRefMessageVersion + 1;
+			onlySpilled = true;
+		} else {
+			messages.serializeBytes(messages2.toValue());
+		}
+	} else {
+		if (req.onlySpilled) {
+			endVersion = logData->persistentDataDurableVersion + 1;
+		} else {
+			peekTagsFromMemory(logData, req.tags, req.begin, messages, endVersion);
+		}
+	}
+
+	reply.maxKnownVersion = logData->version.get();
+	reply.minKnownCommittedVersion = logData->minKnownCommittedVersion;
+	auto messagesValue = messages.toValue();
+	reply.arena.dependsOn(messagesValue.arena());
+	reply.messages = messagesValue;
+	reply.end = endVersion;
+	reply.onlySpilled = onlySpilled;
+
+	DebugLogTraceEvent("TLogPeekTagsMessages", self->dbgid)
+	    .detail("LogId", logData->logId)
+	    .detail("Tags", req.tags.size())
+	    .detail("ReqBegin", req.begin)
+	    .detail("EndVer", reply.end)
+	    .detail("MsgBytes", reply.messages.expectedSize());
+
+	req.reply.send(reply);
+	return Void();
+}
+
 ACTOR Future<Void> doQueueCommit(TLogData* self,
                                  Reference<LogData> logData,
                                  std::vector<Reference<LogData>> missingFinalCommit) {
 	state Version ver = logData->version.get();
 	state Version commitNumber = self->queueCommitBegin + 1;
 	state Version knownCommittedVersion = logData->knownCommittedVersion;
+	state double commitStart = now();
 	self->queueCommitBegin = commitNumber;
 	logData->queueCommittingVersion = ver;
+	++logData->queueCommits;
+	logData->queueCommitPushes += self->queueCommitPushes;
+	self->queueCommitPushes = 0;
 
 	g_network->setCurrentTask(TaskPriority::TLogCommitReply);
 	Future<Void> c = self->persistentQueue->commit();
@@ -2225,6 +2723,7 @@ ACTOR Future<Void> doQueueCommit(TLogData* self,
 
 	wait(ioDegradedOrTimeoutError(
 	    c, SERVER_KNOBS->MAX_STORAGE_COMMIT_TIME, self->degraded, SERVER_KNOBS->TLOG_DEGRADED_DURATION, "TLogCommit"));
+	self->smoothedQueueCommitTime += 0.1 * (now() - commitStart - self->smoothedQueueCommitTime);
 	if (g_network->isSimulated() && !g_simulator->speedUpSimulation && BUGGIFY_WITH_PROB(0.0001)) {
 		wait(delay(6.0));
 	}
@@ -2274,6 +2773,8 @@ ACTOR Future<Void> doQueueCommit(TLogData* self,
 ACTOR Future<Void> commitQueue(TLogData* self) {
 	state Reference<LogData> logData;
 	state std::vector<Reference<LogData>> missingFinalCommit;
+	state bool diskBusy;
+	state double windowStart;
 
 	loop {
 		int foundCount = 0;
@@ -2322,11 +2823,26 @@ ACTOR Future<Void> commitQueue(TLogData* self) {
 			choose {
 				when(wait(logData->version.whenAtLeast(
 				    std::max(logData->queueCommittingVersion, logData->queueCommittedVersion.get()) + 1))) {
+					// A commit still in flight when new versions arrive means fsyncs, not pushes, are the limit
+					diskBusy = self->queueCommitBegin != self->queueCommitEnd.get();
 					while (self->queueCommitBegin != self->queueCommitEnd.get() &&
 					       !self->largeDiskQueueCommitBytes.get()) {
 						wait(self->queueCommitEnd.whenAtLeast(self->queueCommitBegin) ||
 						     self->largeDiskQueueCommitBytes.onChange());
 					}
+					// Commits already merge everything pushed while the previous one ran. When the disk is the
+					// bottleneck, also hold the next commit open for part of a commit time, so that batches from more
+					// proxies share its fsync.
+					if (diskBusy && SERVER_KNOBS->TLOG_GROUP_COMMIT_WINDOW_FRACTION > 0 &&
+					    !self->largeDiskQueueCommitBytes.get()) {
+						windowStart = now();
+						wait(delay(std::min(SERVER_KNOBS->TLOG_GROUP_COMMIT_MAX_WINDOW,
+						                    SERVER_KNOBS->TLOG_GROUP_COMMIT_WINDOW_FRACTION *
+						                        self->smoothedQueueCommitTime)) ||
+						     self->largeDiskQueueCommitBytes.onChange());
+						++logData->groupCommitWindows;
+						logData->groupCommitWindowLatency.addMeasurement(now() - windowStart);
+					}
 					if (logData->queueCommittedVersion.get() == std::numeric_limits<Version>::max()) {
 						break;
 					}
@@ -2399,6 +2915,7 @@ ACTOR Future<Void> tLogCommit(TLogData* self,
 		qe.messages = req.messages;
 		qe.id = logData->logId;
 		self->persistentQueue->push(qe, logData);
+		++self->queueCommitPushes;
 
 		self->diskQueueCommitBytes += qe.expectedSize();
 		if (self->diskQueueCommitBytes > SERVER_KNOBS->MAX_QUEUE_COMMIT_BYTES) {
@@ -2805,8 +3322,18 @@ ACTOR Future<Void> serveTLogInterface(TLogData* self,
 			logData->addActor.send(tLogPeekStream(self, req, logData));
 		}
 		when(TLogPeekRequest req = waitNext(tli.peekMessages.getFuture())) {
-			logData->addActor.send(tLogPeekMessages(
-			    req.reply, self, logData, req.begin, req.tag, req.returnIfBlocked, req.onlySpilled, req.sequence));
+			logData->addActor.send(tLogPeekMessages(req.reply,
+			                                        self,
+			                                        logData,
+			                                        req.begin,
+			                                        req.tag,
+			                                        req.returnIfBlocked,
+			                                        req.onlySpilled,
+			                                        req.sequence,
+			                                        req.compression));
+		}
+		when(TLogPeekTagsRequest req = waitNext(tli.peekTagsMessages.getFuture())) {
+			logData->addActor.send(tLogPeekTagsMessages(self, req, logData));
 		}
 		when(TLogPopRequest req = waitNext(tli.popMessages.getFuture())) {
 			logData->addActor.send(tLogPop(self, req, logData));
@@ -3271,6 +3798,7 @@ ACTOR Future<Void> restorePersistentState(TLogData* self,
 
 		DUMPTOKEN(recruited.peekMessages);
 		DUMPTOKEN(recruited.peekStreamMessages);
+		DUMPTOKEN(recruited.peekTagsMessages);
 		DUMPTOKEN(recruited.popMessages);
 		DUMPTOKEN(recruited.commit);
 		DUMPTOKEN(recruited.lock);
@@ -3539,6 +4067,7 @@ ACTOR Future<Void> tLogStart(TLogData* self, InitializeTLogRequest req, Locality
 
 	DUMPTOKEN(recruited.peekMessages);
 	DUMPTOKEN(recruited.peekStreamMessages);
+	DUMPTOKEN(recruited.peekTagsMessages);
 	DUMPTOKEN(recruited.popMessages);
 	DUMPTOKEN(recruited.commit);
 	DUMPTOKEN(recruited.lock);
@@ -3833,70 +4362,123 @@ ACTOR Future<Void> tLog(IKeyValueStore* persistentData,
 }
 
 // UNIT TESTS
-struct DequeAllocatorStats {
-	static int64_t allocatedBytes;
-};
-
-int64_t DequeAllocatorStats::allocatedBytes = 0;
-
-template <class T>
-struct DequeAllocator : std::allocator<T> {
-	template <typename U>
-	struct rebind {
-		typedef DequeAllocator<U> other;
-	};
-
-	DequeAllocator() {}
+TEST_CASE("/fdbserver/tlogserver/TagMessageIndex") {
+	// Compare against the std::deque that TagMessageIndex replaced
+	std::vector<uint32_t> lengths(1000);
+	for (int i = 0; i < lengths.size(); ++i) {
+		lengths[i] = i;
+	}
+	for (int round = 0; round < 20; ++round) {
+		TagMessageIndex index;
+		std::deque<std::pair<Version, LengthPrefixedStringRef>> expected;
+		Version version = deterministicRandom()->randomInt64(0, 1e12);
+		int ops = deterministicRandom()->randomInt(0, 10000);
+		for (int op = 0; op < ops; ++op) {
+			int r = deterministicRandom()->randomInt(0, 10);
+			if (r < 6) {
+				if (deterministicRandom()->random01() < 0.01) {
+					version += int64_t(std::numeric_limits<uint32_t>::max()) + deterministicRandom()->randomInt(-1, 2);
+				} else {
+					version += deterministicRandom()->randomInt(0, 3);
+				}
+				LengthPrefixedStringRef message(&lengths[deterministicRandom()->randomInt(0, lengths.size())]);
+				index.push_back(version, message);
+				expected.emplace_back(version, message);
+			} else if (r < 8) {
+				if (!expected.empty()) {
+					ASSERT(index.frontVersion() == expected.front().first);
+					ASSERT(index.frontMessage().getLengthPtr() == expected.front().second.getLengthPtr());
+					index.pop_front();
+					expected.pop_front();
+				}
+			} else {
+				Version v = version - deterministicRandom()->randomInt(-2, 100);
+				auto compare = [](const auto& l, const auto& r) -> bool { return l.first < r.first; };
+				auto e = std::lower_bound(
+				    expected.begin(), expected.end(), std::make_pair(v, LengthPrefixedStringRef()), compare);
+				auto it = index.lower_bound(v);
+				for (int i = 0; i < 3 && e != expected.end(); ++i, ++e, ++it) {
+					ASSERT(it.version() == e->first && it.message().getLengthPtr() == e->second.getLengthPtr());
+				}
+				ASSERT((e == expected.end()) == (it == index.end()));
+
+				e = std::upper_bound(
+				    expected.begin(), expected.end(), std::make_pair(v, LengthPrefixedStringRef()), compare);
+				it = index.upper_bound(v);
+				ASSERT((e == expected.end()) == (it == index.end()));
+				if (e != expected.end()) {
+					ASSERT(it.version() == e->first);
+				}
+			}
+			ASSERT(index.size() == expected.size());
+			ASSERT(index.empty() || index.backVersion() == expected.back().first);
+		}
 
-	template <typename U>
-	DequeAllocator(DequeAllocator<U> const& u) : std::allocator<T>(u) {}
+		auto it = index.begin();
+		for (auto const& e : expected) {
+			ASSERT(it != index.end() && it.version() == e.first);
+			++it;
+		}
+		ASSERT(it == index.end());
 
-	T* allocate(std::size_t n) {
-		DequeAllocatorStats::allocatedBytes += n * sizeof(T);
-		// fprintf(stderr, "Allocating %lld objects for %lld bytes (total allocated: %lld)\n", n, n * sizeof(T),
-		// DequeAllocatorStats::allocatedBytes);
-		return std::allocator<T>::allocate(n);
-	}
-	void deallocate(T* p, std::size_t n) {
-		DequeAllocatorStats::allocatedBytes -= n * sizeof(T);
-		// fprintf(stderr, "Deallocating %lld objects for %lld bytes (total allocated: %lld)\n", n, n * sizeof(T),
-		// DequeAllocatorStats::allocatedBytes);
-		return std::allocator<T>::deallocate(p, n);
+		TagMessageIndex moved(std::move(index));
+		ASSERT(index.empty() && index.begin() == index.end() && moved.size() == expected.size());
 	}
-};
-
-TEST_CASE("Lfdbserver/tlogserver/VersionMessagesOverheadFactor") {
 
-	typedef std::pair<Version, LengthPrefixedStringRef> TestType; // type used by versionMessages
+	return Void();
+}
 
-	for (int i = 1; i < 9; ++i) {
+TEST_CASE("/fdbserver/tlogserver/TagMessageIndexOverheadFactor") {
+	for (int i = 1; i < 7; ++i) {
 		for (int j = 0; j < 20; ++j) {
-			DequeAllocatorStats::allocatedBytes = 0;
-			DequeAllocator<TestType> allocator;
-			std::deque<TestType, DequeAllocator<TestType>> d(allocator);
-
+			TagMessageIndex index;
 			int numElements = deterministicRandom()->randomInt(pow(10, i - 1), pow(10, i));
 			for (int k = 0; k < numElements; ++k) {
-				d.push_back(TestType());
+				index.push_back(k / 4, LengthPrefixedStringRef());
 			}
-
-			int removedElements = 0; // deterministicRandom()->randomInt(0, numElements); // FIXME: the overhead factor
-			                         // does not accurately account for removal!
+			int removedElements = deterministicRandom()->randomInt(0, numElements);
 			for (int k = 0; k < removedElements; ++k) {
-				d.pop_front();
+				index.pop_front();
 			}
 
-			int64_t dequeBytes = DequeAllocatorStats::allocatedBytes + sizeof(std::deque<TestType>);
-			int64_t insertedBytes = (numElements - removedElements) * sizeof(TestType);
-			double overheadFactor =
-			    std::max<double>(insertedBytes, dequeBytes - 10000) /
-			    insertedBytes; // We subtract 10K here as an estimated upper bound for the fixed cost of an std::deque
-			// fprintf(stderr, "%d elements (%d inserted, %d removed):\n", numElements-removedElements, numElements,
-			// removedElements); fprintf(stderr, "Allocated %lld bytes to store %lld bytes (%lf overhead factor)\n",
-			// dequeBytes, insertedBytes, overheadFactor);
-			ASSERT(overheadFactor * 1024 <= SERVER_KNOBS->VERSION_MESSAGES_OVERHEAD_FACTOR_1024THS);
+			// The partially filled blocks at either end are a fixed cost per tag, which the accounting ignores. Each
+			// block also costs a pointer in the index's directory.
+			int64_t indexBytes = index.allocatedBytes() - 2 * TagMessageIndex::kBlockBytes +
+			                     index.allocatedBytes() / TagMessageIndex::kBlockBytes * sizeof(void*) * 1.1;
+			const int entryBytes = sizeof(uint32_t) + sizeof(LengthPrefixedStringRef);
+			int64_t insertedBytes = (numElements - removedElements) * entryBytes;
+			double overheadFactor = std::max<double>(insertedBytes, indexBytes) / std::max<int64_t>(insertedBytes, 1);
+			ASSERT(overheadFactor * 1024 <= SERVER_KNOBS->TAG_MESSAGE_INDEX_OVERHEAD_FACTOR_1024THS);
+			ASSERT(overheadFactor * entryBytes <= SERVER_KNOBS->TAG_MESSAGE_INDEX_ENTRY_BYTES_WITH_OVERHEAD);
 		}
 	}
 
 	return Void();
 }
+
+TEST_CASE("/fdbserver/tlogserver/CompressedPeekReply") {
+	std::string original;
+	while (original.size() < 100000) {
+		original += format("mutation %d of a commit to the same few keys, ", deterministicRandom()->randomInt(0, 10));
+	}
+	for (auto filter : CompressionUtils::supportedFilters) {
+		TLogPeekReply reply;
+		reply.messages = StringRef(reply.arena, original);
+		reply.end = 1;
+		if (filter != CompressionFilter::NONE) {
+			reply.messages = CompressionUtils::compress(filter, reply.messages, reply.arena);
+			reply.compression = filter;
+			ASSERT(reply.messages.size() < original.size());
+		}
+
+		Value wire = ObjectWriter::toValue(reply, Unversioned());
+		TLogPeekReply received = ObjectReader::fromStringRef<TLogPeekReply>(wire, Unversioned());
+		ASSERT(received.compression == reply.compression);
+		received.decompress();
+		ASSERT(!received.compression.present());
+		ASSERT(received.messages == StringRef(original));
+		ASSERT(received.end == 1);
+	}
+
+	return Void();
+}
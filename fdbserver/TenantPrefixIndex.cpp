@@ -0,0 +1,311 @@
+/*
+ * TenantPrefixIndex.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbserver/TenantPrefixIndex.h"
+#include "flow/UnitTest.h"
+
+// Histories are merged into the arrays once this many of them, or a sixteenth of the tenants if that is more, have
+// settled, so the cost of rewriting the arrays is spread over many changes
+static constexpr int64_t MIN_SETTLED_HISTORIES_TO_COMPACT = 1000;
+static constexpr int64_t TENANTS_PER_SETTLED_HISTORY_TO_COMPACT = 16;
+
+int TenantPrefixIndex::lowerBound(std::vector<int64_t> const& ids, int64_t id) {
+	int n = ids.size();
+	if (n == 0) {
+		return 0;
+	}
+	// Halving the range with a conditional move rather than a branch avoids a misprediction at every step
+	const int64_t* base = ids.data();
+	while (n > 1) {
+		int half = n / 2;
+		base = base[half] < id ? base + half : base;
+		n -= half;
+	}
+	return (base - ids.data()) + (*base < id);
+}
+
+TenantPrefixIndex::Change const* TenantPrefixIndex::changeAt(History const& history, Version version) {
+	for (auto c = history.changes.rbegin(); c != history.changes.rend(); ++c) {
+		if (c->version <= version) {
+			return &*c;
+		}
+	}
+	return nullptr;
+}
+
+Optional<TenantPrefixIndex::LockState> TenantPrefixIndex::findAt(int64_t id, Version version) const {
+	if (!histories.empty()) {
+		auto h = histories.find(id);
+		if (h != histories.end()) {
+			Change const* change = changeAt(h->second, version);
+			if (change != nullptr) {
+				return change->lockState;
+			}
+		}
+	}
+	int i = lowerBound(ids, id);
+	if (i < ids.size() && ids[i] == id) {
+		return lockStates[i];
+	}
+	return Optional<LockState>();
+}
+
+bool TenantPrefixIndex::containsAny(int64_t beginId, int64_t endId, Version version) const {
+	for (int i = lowerBound(ids, beginId); i < ids.size() && ids[i] <= endId; ++i) {
+		auto h = histories.find(ids[i]);
+		if (h == histories.end()) {
+			return true;
+		}
+		Change const* change = changeAt(h->second, version);
+		if (change == nullptr || change->lockState.present()) {
+			return true;
+		}
+	}
+	// Tenants in the arrays were all checked above, so a history without a change as of version is not a tenant
+	for (auto h = histories.lower_bound(beginId); h != histories.end() && h->first <= endId; ++h) {
+		Change const* change = changeAt(h->second, version);
+		if (change != nullptr && change->lockState.present()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void TenantPrefixIndex::addChange(int64_t id, Version version, Optional<LockState> lockState) {
+	ASSERT_GE(version, latestVersion);
+	latestVersion = version;
+	History& history = histories[id];
+	if (history.settled) {
+		history.settled = false;
+		--settledHistories;
+	}
+	if (!history.changes.empty() && history.changes.back().version == version) {
+		history.changes.back().lockState = lockState;
+	} else {
+		history.changes.push_back(Change{ version, lockState });
+		changeLog.emplace_back(version, id);
+	}
+}
+
+void TenantPrefixIndex::insert(int64_t id, LockState lockState, Version version) {
+	if (!findAt(id, latestVersion).present()) {
+		++count;
+	}
+	addChange(id, version, lockState);
+}
+
+void TenantPrefixIndex::erase(int64_t id, Version version) {
+	if (!findAt(id, latestVersion).present()) {
+		return;
+	}
+	--count;
+	addChange(id, version, Optional<LockState>());
+}
+
+void TenantPrefixIndex::forgetVersionsBefore(Version version) {
+	if (version <= oldestVersion) {
+		return;
+	}
+	oldestVersion = version;
+	latestVersion = std::max(latestVersion, version);
+	while (!changeLog.empty() && changeLog.front().first <= version) {
+		auto h = histories.find(changeLog.front().second);
+		changeLog.pop_front();
+		if (h == histories.end() || h->second.settled) {
+			// The history was settled by an earlier change to the same tenant
+			continue;
+		}
+		// Only the last change at or before the oldest version is needed to read the oldest version
+		std::vector<Change>& changes = h->second.changes;
+		auto later = std::find_if(changes.begin(), changes.end(), [version](Change const& c) {
+			return c.version > version;
+		});
+		if (later - changes.begin() > 1) {
+			changes.erase(changes.begin(), later - 1);
+		}
+		if (changes.size() == 1 && changes[0].version <= version) {
+			h->second.settled = true;
+			++settledHistories;
+		}
+	}
+	if (settledHistories >= std::max<int64_t>(MIN_SETTLED_HISTORIES_TO_COMPACT,
+	                                          ids.size() / TENANTS_PER_SETTLED_HISTORY_TO_COMPACT)) {
+		compact();
+	}
+}
+
+void TenantPrefixIndex::restore(std::vector<int64_t>&& restoredIds, std::vector<LockState>&& restoredLockStates) {
+	ASSERT(emptyAtAllVersions());
+	ASSERT_EQ(restoredIds.size(), restoredLockStates.size());
+	ASSERT(std::is_sorted(restoredIds.begin(), restoredIds.end()));
+	ids = std::move(restoredIds);
+	lockStates = std::move(restoredLockStates);
+	count = ids.size();
+}
+
+void TenantPrefixIndex::compact() {
+	std::vector<int64_t> newIds;
+	std::vector<LockState> newLockStates;
+	newIds.reserve(ids.size() + settledHistories);
+	newLockStates.reserve(ids.size() + settledHistories);
+	int i = 0;
+	for (auto h = histories.begin(); h != histories.end();) {
+		if (!h->second.settled) {
+			++h;
+			continue;
+		}
+		for (; i < ids.size() && ids[i] < h->first; ++i) {
+			newIds.push_back(ids[i]);
+			newLockStates.push_back(lockStates[i]);
+		}
+		if (i < ids.size() && ids[i] == h->first) {
+			++i;
+		}
+		Optional<LockState> const& lockState = h->second.changes[0].lockState;
+		if (lockState.present()) {
+			newIds.push_back(h->first);
+			newLockStates.push_back(lockState.get());
+		}
+		h = histories.erase(h);
+	}
+	newIds.insert(newIds.end(), ids.begin() + i, ids.end());
+	newLockStates.insert(newLockStates.end(), lockStates.begin() + i, lockStates.end());
+	newIds.shrink_to_fit();
+	newLockStates.shrink_to_fit();
+	ids = std::move(newIds);
+	lockStates = std::move(newLockStates);
+	settledHistories = 0;
+}
+
+int64_t TenantPrefixIndex::memoryUsage() const {
+	// A map node holds the key, the history and three pointers and a color, and a history holds at least one change
+	constexpr int64_t historyBytes = sizeof(std::pair<const int64_t, History>) + 4 * sizeof(void*) + sizeof(Change);
+	return ids.capacity() * sizeof(int64_t) + lockStates.capacity() * sizeof(LockState) +
+	       histories.size() * historyBytes + changeLog.size() * (sizeof(Change) + sizeof(changeLog.front()));
+}
+
+TEST_CASE("/fdbserver/TenantPrefixIndex/versions") {
+	using LockState = TenantAPI::TenantLockState;
+	TenantPrefixIndex index;
+	index.insert(1, LockState::UNLOCKED, 10);
+	index.insert(2, LockState::UNLOCKED, 10);
+	index.insert(2, LockState::LOCKED, 20);
+	index.erase(1, 30);
+	index.insert(3, LockState::READ_ONLY, 30);
+
+	ASSERT_EQ(index.size(), 2);
+	ASSERT(!index.contains(1, 9));
+	ASSERT(index.find(1, 29) == LockState::UNLOCKED);
+	ASSERT(!index.contains(1, 30));
+	ASSERT(index.find(2, 19) == LockState::UNLOCKED);
+	ASSERT(index.find(2, 20) == LockState::LOCKED);
+	ASSERT(!index.containsAny(3, 10, 29));
+	ASSERT(index.containsAny(3, 10, 30));
+	ASSERT(index.containsAny(1, 1, 20));
+	ASSERT(!index.containsAny(1, 1, 30));
+
+	std::vector<int64_t> tenants;
+	index.forEachTenant(0, 3, [&](int64_t id, LockState) { tenants.push_back(id); });
+	ASSERT(tenants == std::vector<int64_t>({ 2 }));
+
+	// Forgetting versions keeps the state as of the oldest version and after
+	index.forgetVersionsBefore(25);
+	ASSERT(index.find(2, 25) == LockState::LOCKED);
+	ASSERT(index.find(1, 25) == LockState::UNLOCKED);
+	ASSERT(!index.contains(1, 30));
+	ASSERT(index.find(3, 30) == LockState::READ_ONLY);
+	return Void();
+}
+
+TEST_CASE("/fdbserver/TenantPrefixIndex/restore") {
+	using LockState = TenantAPI::TenantLockState;
+	TenantPrefixIndex index;
+	index.restore({ 1, 5, 9 }, { LockState::UNLOCKED, LockState::LOCKED, LockState::UNLOCKED });
+	ASSERT_EQ(index.size(), 3);
+	ASSERT(index.find(5, 0) == LockState::LOCKED);
+	ASSERT(!index.contains(4, 0));
+
+	// Restored tenants change like any others
+	index.erase(5, 10);
+	index.insert(4, LockState::READ_ONLY, 10);
+	ASSERT(index.find(5, 9) == LockState::LOCKED);
+	ASSERT(!index.contains(5, 10));
+	ASSERT(index.find(4, 10) == LockState::READ_ONLY);
+	ASSERT_EQ(index.size(), 3);
+	return Void();
+}
+
+TEST_CASE("/fdbserver/TenantPrefixIndex/random") {
+	using LockState = TenantAPI::TenantLockState;
+	TenantPrefixIndex index;
+	// The state of every tenant as of every version since the oldest version
+	std::map<Version, std::map<int64_t, LockState>> expected;
+	std::map<int64_t, LockState> latest;
+	expected[0] = latest;
+	Version version = 0;
+	Version oldest = 0;
+	const int64_t maxId = deterministicRandom()->randomInt(10, 5000);
+
+	for (int step = 0; step < 2000; ++step) {
+		version += deterministicRandom()->randomInt(0, 3);
+		for (int m = deterministicRandom()->randomInt(0, 20); m > 0; --m) {
+			int64_t id = deterministicRandom()->randomInt64(0, maxId);
+			if (deterministicRandom()->coinflip()) {
+				LockState lockState = static_cast<LockState>(deterministicRandom()->randomInt(0, 3));
+				index.insert(id, lockState, version);
+				latest[id] = lockState;
+			} else {
+				index.erase(id, version);
+				latest.erase(id);
+			}
+		}
+		expected[version] = latest;
+		ASSERT_EQ(index.size(), static_cast<int64_t>(latest.size()));
+
+		if (deterministicRandom()->random01() < 0.1) {
+			oldest = deterministicRandom()->randomInt64(oldest, version + 1);
+			index.forgetVersionsBefore(oldest);
+			// Keep the last version at or before the oldest version, which describes the oldest version
+			auto keep = std::prev(expected.upper_bound(oldest));
+			expected.erase(expected.begin(), keep);
+		}
+
+		Version readVersion = deterministicRandom()->randomInt64(oldest, version + 1);
+		auto const& tenants = std::prev(expected.upper_bound(readVersion))->second;
+		for (int r = 0; r < 10; ++r) {
+			int64_t id = deterministicRandom()->randomInt64(0, maxId);
+			auto t = tenants.find(id);
+			Optional<LockState> lockState = index.find(id, readVersion);
+			ASSERT_EQ(lockState.present(), t != tenants.end());
+			ASSERT(!lockState.present() || lockState.get() == t->second);
+
+			int64_t endId = id + deterministicRandom()->randomInt64(0, maxId / 10 + 1);
+			auto a = tenants.lower_bound(id);
+			ASSERT_EQ(index.containsAny(id, endId, readVersion), a != tenants.end() && a->first <= endId);
+		}
+	}
+
+	std::vector<std::pair<int64_t, LockState>> tenants;
+	index.forEachTenant(0, std::numeric_limits<int64_t>::max(), [&](int64_t id, LockState lockState) {
+		tenants.emplace_back(id, lockState);
+	});
+	ASSERT(tenants == std::vector<std::pair<int64_t, LockState>>(latest.begin(), latest.end()));
+	return Void();
+}
@@ -62,8 +62,10 @@ public:
 	  : thisServerID(thisServerID), maxTagsTracked(maxTagsTracked), minRateTracked(minRateTracked),
 	    busiestReadTagEventHolder(makeReference<EventCacheHolder>(thisServerID.toString() + "/BusiestReadTag")) {}
 
-	void addRequest(Optional<TagSet> const& tags, int64_t bytes) {
-		auto const cost = getReadOperationCost(bytes);
+	void addRequest(Optional<TagSet> const& tags, int64_t bytes, int64_t rows) {
+		// A range read's bytes are mostly contiguous, so rounding them up to pages undercharges a scan of many small
+		// rows compared with point reads of the same rows. Each row is a step of the storage engine's cursor.
+		double const cost = getReadOperationCost(bytes) + rows * SERVER_KNOBS->READ_TAG_COST_PER_ROW;
 		intervalTotalCost += cost;
 		if (tags.present()) {
 			for (auto const& tag : tags.get()) {
@@ -117,8 +119,8 @@ TransactionTagCounter::TransactionTagCounter(UID thisServerID, int maxTagsTracke
 
 TransactionTagCounter::~TransactionTagCounter() = default;
 
-void TransactionTagCounter::addRequest(Optional<TagSet> const& tags, int64_t bytes) {
-	return impl->addRequest(tags, bytes);
+void TransactionTagCounter::addRequest(Optional<TagSet> const& tags, int64_t bytes, int64_t rows) {
+	return impl->addRequest(tags, bytes, rows);
 }
 
 void TransactionTagCounter::startNewInterval() {
@@ -183,3 +185,30 @@ TEST_CASE("/fdbserver/TransactionTagCounter/IgnoreBelowMinRate") {
 	}
 	return Void();
 }
+
+TEST_CASE("/fdbserver/TransactionTagCounter/ChargeRowsRead") {
+	state TransactionTagCounter counter(UID(), /*maxTagsTracked=*/2, /*minRateTracked=*/0.0);
+	counter.startNewInterval();
+	state double start = now();
+	{
+		wait(delay(1.0));
+		counter.addRequest(getTagSet("scan"_sr), 10 * CLIENT_KNOBS->TAG_THROTTLING_PAGE_SIZE, 1000);
+		counter.addRequest(getTagSet("point"_sr), 10 * CLIENT_KNOBS->TAG_THROTTLING_PAGE_SIZE);
+		double const elapsed = now() - start;
+		counter.startNewInterval();
+		auto const busiestTags = counter.getBusiestTags();
+		ASSERT_EQ(busiestTags.size(), 2);
+		double scanRate = 0, pointRate = 0;
+		for (auto const& tagInfo : busiestTags) {
+			if (tagInfo.tag == "scan"_sr) {
+				scanRate = tagInfo.rate;
+			} else {
+				pointRate = tagInfo.rate;
+			}
+		}
+		// Both read the same bytes, and the scan also pays for its rows
+		double const rowsCost = 1000.0 * SERVER_KNOBS->READ_TAG_COST_PER_ROW / CLIENT_KNOBS->READ_TAG_SAMPLE_RATE;
+		ASSERT(std::abs(scanRate - pointRate - rowsCost / elapsed) <= 1e-6 * scanRate);
+	}
+	return Void();
+}
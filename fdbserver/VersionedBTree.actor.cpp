@@ -25,6 +25,7 @@
 #include "fdbclient/Tuple.h"
 #include "fdbrpc/DDSketch.h"
 #include "fdbrpc/simulator.h"
+#include "fdbserver/CoroFlow.h"
 #include "fdbserver/DeltaTree.h"
 #include "fdbserver/IKeyValueStore.h"
 #include "fdbserver/IPager.h"
@@ -33,6 +34,7 @@
 #include "fdbserver/VersionedBTreeDebug.h"
 #include "fdbserver/WorkerInterface.actor.h"
 #include "flow/ActorCollection.h"
+#include "flow/CompressionUtils.h"
 #include "flow/Error.h"
 #include "flow/FastRef.h"
 #include "flow/flow.h"
@@ -40,6 +42,7 @@
 #include "flow/Histogram.h"
 #include "flow/IAsyncFile.h"
 #include "flow/IRandom.h"
+#include "flow/IThreadPool.h"
 #include "flow/Knobs.h"
 #include "flow/ObjectSerializer.h"
 #include "flow/PriorityMultiLock.actor.h"
@@ -1445,6 +1448,8 @@ struct RedwoodMetrics {
 		unsigned int opSetValueBytes;
 		unsigned int opClear;
 		unsigned int opClearKey;
+		unsigned int opReplaceRange;
+		unsigned int opReplaceRangeRecords;
 		unsigned int opCommit;
 		unsigned int opGet;
 		unsigned int opGetRange;
@@ -1453,15 +1458,34 @@ struct RedwoodMetrics {
 		unsigned int pagerRemapFree;
 		unsigned int pagerRemapCopy;
 		unsigned int pagerRemapSkip;
+		unsigned int pagerRemapThrottle;
+		unsigned int pagerRemapThrottleMS;
 		unsigned int pagerCacheHit;
 		unsigned int pagerCacheMiss;
 		unsigned int pagerProbeHit;
 		unsigned int pagerProbeMiss;
 		unsigned int pagerEvictUnhit;
 		unsigned int pagerEvictFail;
+		unsigned int pagerCacheHitProtected;
+		unsigned int pagerCacheHitProbation;
+		unsigned int pagerCacheHitInternal;
+		unsigned int pagerCachePromote;
+		unsigned int pagerCacheColdInsert;
 		unsigned int btreeLeafPreload;
 		unsigned int btreeLeafPreloadExt;
 		unsigned int readRequestDecryptTimeNS;
+		unsigned int pageDecode;
+		unsigned int pageDecodeTimeNS;
+		unsigned int pageEncode;
+		unsigned int pageEncodeTimeNS;
+		unsigned int pageCompress;
+		unsigned int pageCompressRawBytes;
+		unsigned int pageCompressBytes;
+		unsigned int pageDecompress;
+		unsigned int pageDecompressTimeNS;
+		unsigned int compactPageScan;
+		unsigned int compactPageRewrite;
+		unsigned int compactDeletedBytes;
 	};
 
 	RedwoodMetrics() {
@@ -1474,6 +1498,9 @@ struct RedwoodMetrics {
 		    new Histogram(Reference<HistogramRegistry>(), "kvSize", "ReadByGetRange", Histogram::Unit::bytes));
 
 		ioLock = nullptr;
+		internalPageCacheSize = nullptr;
+		remapQueueEntries = 0;
+		remapQueueLagEntries = 0;
 
 		// These histograms are used for Btree events, hence level > 0
 		unsigned int levelCounter = 0;
@@ -1519,6 +1546,12 @@ struct RedwoodMetrics {
 	metrics metric;
 	// pointer to the priority multi lock used in pager
 	PriorityMultiLock* ioLock;
+	// returns the bytes, count and budget of the internal pages in the pager's page cache
+	std::function<std::tuple<int64_t, int64_t, int64_t>()> internalPageCacheSize;
+	// Remap queue entries left after the last remap cleanup, and how many of them are beyond the cleanup window.
+	// These are gauges so clear() does not reset them.
+	int64_t remapQueueEntries;
+	int64_t remapQueueLagEntries;
 
 	Reference<Histogram> kvSizeWritten;
 	Reference<Histogram> kvSizeReadByGet;
@@ -1574,11 +1607,15 @@ struct RedwoodMetrics {
 	void getFields(TraceEvent* e, std::string* s = nullptr, bool skipZeroes = false);
 
 	void getIOLockFields(TraceEvent* e, std::string* s = nullptr);
+	void getPageCacheFields(TraceEvent* e, std::string* s = nullptr);
+	void getRemapCleanupFields(TraceEvent* e, std::string* s = nullptr);
 
 	std::string toString(bool clearAfter) {
 		std::string s;
 		getFields(nullptr, &s);
 		getIOLockFields(nullptr, &s);
+		getPageCacheFields(nullptr, &s);
+		getRemapCleanupFields(nullptr, &s);
 
 		if (clearAfter) {
 			clear();
@@ -1614,11 +1651,25 @@ ACTOR Future<Void> redwoodMetricsLogger() {
 		e.detail("Elapsed", elapsed);
 		g_redwoodMetrics.getFields(&e);
 		g_redwoodMetrics.getIOLockFields(&e);
+		g_redwoodMetrics.getPageCacheFields(&e);
+		g_redwoodMetrics.getRemapCleanupFields(&e);
 		g_redwoodMetrics.clear();
 	}
 }
 
 // Holds an index of recently used objects.
+//
+// Eviction is a segmented LRU, which keeps a single scan from flushing the working set. New objects enter a probation
+// segment and are promoted to a protected segment when they are hit again. The protected segment is limited to
+// REDWOOD_PAGE_CACHE_PROTECTED_FRACTION of the cache and demotes its least recently used objects back to probation,
+// and objects are only evicted from the protected segment when probation is empty. Accesses made as cold (such as
+// range scans) neither promote nor are counted as protected hits, so a scan can only displace other probation objects.
+//
+// Objects accessed as internal (BTree pages above the leaf level) are kept in a third, internal segment budgeted by
+// REDWOOD_INTERNAL_PAGE_CACHE_FRACTION of the cache, which is only evicted from once both other segments are empty.
+// Objects beyond the internal budget are demoted to probation. This keeps the internal nodes resident under leaf
+// cache pressure, so a point read costs at most one leaf read.
+//
 // ObjectType must have these methods
 //
 //   // Returns true iff the entry can be evicted
@@ -1635,13 +1686,17 @@ class ObjectCache : NonCopyable {
 	struct Entry;
 	typedef std::unordered_map<IndexType, Entry> CacheT;
 
+	enum class Segment : uint8_t { Probation, Protected, Internal };
+
 	struct Entry : public boost::intrusive::list_base_hook<> {
-		Entry() : hits(0), size(0) {}
+		Entry() : hits(0), size(0), segment(Segment::Probation) {}
 		IndexType index;
 		ObjectType item;
 		int hits;
 		int size;
 		bool ownedByEvictor;
+		// The evictor segment holding the entry, only valid while ownedByEvictor
+		Segment segment;
 		CacheT* pCache;
 	};
 
@@ -1672,15 +1727,49 @@ public:
 		// but the entry size is still counted against the evictor
 		void moveOut(Entry& e, EvictionOrderT& dest) {
 			ASSERT(e.ownedByEvictor);
-			dest.splice(dest.end(), evictionOrder, EvictionOrderT::s_iterator_to(e));
+			dest.splice(dest.end(), segmentOf(e), EvictionOrderT::s_iterator_to(e));
+			leaveSegment(e);
 			e.ownedByEvictor = false;
 			++movedOutCount;
 		}
 
-		// Move an entry to the back of the eviction order if it is in the eviction order
-		void moveToBack(Entry& e) {
+		// Record a hit on an entry in the eviction order. An internal access moves the entry into the internal
+		// segment. A probation entry hit by a non cold access is promoted to the protected segment, otherwise the
+		// entry moves to the back of its segment.
+		void hit(Entry& e, bool cold, bool internal) {
 			ASSERT(e.ownedByEvictor);
-			evictionOrder.splice(evictionOrder.end(), evictionOrder, EvictionOrderT::s_iterator_to(e));
+			if (e.segment == Segment::Internal) {
+				++g_redwoodMetrics.metric.pagerCacheHitInternal;
+				internalOrder.splice(internalOrder.end(), internalOrder, EvictionOrderT::s_iterator_to(e));
+				return;
+			}
+
+			if (e.segment == Segment::Protected) {
+				++g_redwoodMetrics.metric.pagerCacheHitProtected;
+			} else {
+				++g_redwoodMetrics.metric.pagerCacheHitProbation;
+			}
+
+			if (internal && e.size <= internalLimit()) {
+				internalOrder.splice(internalOrder.end(), segmentOf(e), EvictionOrderT::s_iterator_to(e));
+				leaveSegment(e);
+				enterSegment(e, Segment::Internal);
+				return;
+			}
+
+			if (e.segment == Segment::Protected) {
+				protectedOrder.splice(protectedOrder.end(), protectedOrder, EvictionOrderT::s_iterator_to(e));
+				return;
+			}
+
+			if (cold || e.size > protectedLimit()) {
+				evictionOrder.splice(evictionOrder.end(), evictionOrder, EvictionOrderT::s_iterator_to(e));
+				return;
+			}
+
+			++g_redwoodMetrics.metric.pagerCachePromote;
+			protectedOrder.splice(protectedOrder.end(), evictionOrder, EvictionOrderT::s_iterator_to(e));
+			enterSegment(e, Segment::Protected);
 		}
 
 		// Move entire contents of an external eviction order containing entries whose size is part of
@@ -1694,11 +1783,18 @@ public:
 			evictionOrder.splice(evictionOrder.begin(), otherOrder);
 		}
 
-		// Add a new item to the back of the eviction order
-		void addNew(Entry& e) {
+		// Add a new item to the back of the probation segment of the eviction order, or of the internal segment if
+		// it is internal and fits in its budget
+		void addNew(Entry& e, bool internal = false) {
 			sizeUsed += e.size;
-			evictionOrder.push_back(e);
 			e.ownedByEvictor = true;
+			e.segment = Segment::Probation;
+			if (internal && e.size <= internalLimit()) {
+				internalOrder.push_back(e);
+				enterSegment(e, Segment::Internal);
+			} else {
+				evictionOrder.push_back(e);
+			}
 		}
 
 		// Claim ownership of an entry, removing its size from the current size and removing it
@@ -1707,7 +1803,8 @@ public:
 			sizeUsed -= e.size;
 			// If e is in evictionOrder then remove it
 			if (e.ownedByEvictor) {
-				evictionOrder.erase(EvictionOrderT::s_iterator_to(e));
+				segmentOf(e).erase(EvictionOrderT::s_iterator_to(e));
+				leaveSegment(e);
 				e.ownedByEvictor = false;
 			} else {
 				// Otherwise, it wasn't so it had to be a movedOut item so decrement the count
@@ -1718,9 +1815,14 @@ public:
 		void trim(int additionalSpaceNeeded = 0) {
 			int attemptsLeft = FLOW_KNOBS->MAX_EVICT_ATTEMPTS;
 			// While the cache is too big, evict the oldest entry until the oldest entry can't be evicted.
+			// Probation entries are evicted first, protected entries only once probation is empty, and internal
+			// entries only once both are empty.
 			while (attemptsLeft-- > 0 && sizeUsed > (sizeLimit - reservedSize - additionalSpaceNeeded) &&
-			       !evictionOrder.empty()) {
-				Entry& toEvict = evictionOrder.front();
+			       (!evictionOrder.empty() || !protectedOrder.empty() || !internalOrder.empty())) {
+				EvictionOrderT& segment = !evictionOrder.empty()    ? evictionOrder
+				                          : !protectedOrder.empty() ? protectedOrder
+				                                                    : internalOrder;
+				Entry& toEvict = segment.front();
 
 				debug_printf("Evictor count=%d sizeUsed=%" PRId64 " sizeLimit=%" PRId64 " sizePenalty=%" PRId64
 				             " needed=%d  Trying to evict %s evictable %d\n",
@@ -1734,7 +1836,7 @@ public:
 
 				if (!toEvict.item.evictable()) {
 					// shift the front to the back
-					evictionOrder.shift_forward(1);
+					segment.shift_forward(1);
 					++g_redwoodMetrics.metric.pagerEvictFail;
 					break;
 				} else {
@@ -1743,32 +1845,45 @@ public:
 					}
 					sizeUsed -= toEvict.size;
 					debug_printf("Evicting %s\n", ::toString(toEvict.index).c_str());
-					evictionOrder.pop_front();
+					segment.pop_front();
+					leaveSegment(toEvict);
 					toEvict.pCache->erase(toEvict.index);
 				}
 			}
 		}
 
-		int64_t getCountUsed() const { return evictionOrder.size() + movedOutCount; }
+		int64_t getCountUsed() const {
+			return evictionOrder.size() + protectedOrder.size() + internalOrder.size() + movedOutCount;
+		}
 		int64_t getCountMoved() const { return movedOutCount; }
 		int64_t getSizeUsed() const { return sizeUsed + reservedSize; }
+		int64_t getProtectedSize() const { return protectedSize; }
+		int64_t getInternalSize() const { return internalSize; }
+		int64_t getInternalCount() const { return internalOrder.size(); }
+		int64_t getInternalLimit() const { return internalLimit(); }
 
 		// Only to be used in tests at a point where all ObjectCache instances should be destroyed.
 		bool empty() const { return reservedSize == 0 && sizeUsed == 0 && getCountUsed() == 0; }
 
 		std::string toString() const {
 			std::string s = format("Evictor {sizeLimit=%" PRId64 " sizeUsed=%" PRId64 " countUsed=%" PRId64
-			                       " sizePenalty=%" PRId64 " movedOutCount=%" PRId64,
+			                       " sizePenalty=%" PRId64 " movedOutCount=%" PRId64 " protectedSize=%" PRId64
+			                       " internalSize=%" PRId64,
 			                       sizeLimit,
 			                       sizeUsed,
 			                       getCountUsed(),
 			                       reservedSize,
-			                       movedOutCount);
-			for (auto& entry : evictionOrder) {
-				s += format("\n\tindex %s  size %d  evictable %d\n",
-				            ::toString(entry.index).c_str(),
-				            entry.size,
-				            entry.item.evictable());
+			                       movedOutCount,
+			                       protectedSize,
+			                       internalSize);
+			for (auto* segment : { &evictionOrder, &protectedOrder, &internalOrder }) {
+				for (auto& entry : *segment) {
+					s += format("\n\tindex %s  size %d  evictable %d  segment %d\n",
+					            ::toString(entry.index).c_str(),
+					            entry.size,
+					            entry.item.evictable(),
+					            (int)entry.segment);
+				}
 			}
 			s += "}\n";
 			return s;
@@ -1780,7 +1895,53 @@ public:
 		int64_t sizeLimit;
 
 	private:
+		int64_t protectedLimit() const { return sizeLimit * SERVER_KNOBS->REDWOOD_PAGE_CACHE_PROTECTED_FRACTION; }
+		int64_t internalLimit() const { return sizeLimit * SERVER_KNOBS->REDWOOD_INTERNAL_PAGE_CACHE_FRACTION; }
+
+		EvictionOrderT& segmentOf(Entry& e) {
+			switch (e.segment) {
+			case Segment::Protected:
+				return protectedOrder;
+			case Segment::Internal:
+				return internalOrder;
+			default:
+				return evictionOrder;
+			}
+		}
+
+		// Must be called after removing e from the segment it was in
+		void leaveSegment(Entry& e) {
+			if (e.segment == Segment::Protected) {
+				protectedSize -= e.size;
+			} else if (e.segment == Segment::Internal) {
+				internalSize -= e.size;
+			}
+			e.segment = Segment::Probation;
+		}
+
+		// Must be called after linking e to the back of the list of segment, demotes the least recently used entries
+		// of the segment to the most recently used end of probation while it is over its budget
+		void enterSegment(Entry& e, Segment segment) {
+			e.segment = segment;
+			EvictionOrderT& order = segmentOf(e);
+			int64_t& size = segment == Segment::Protected ? protectedSize : internalSize;
+			int64_t limit = segment == Segment::Protected ? protectedLimit() : internalLimit();
+			size += e.size;
+			while (size > limit) {
+				Entry& demoted = order.front();
+				evictionOrder.splice(evictionOrder.end(), order, order.begin());
+				leaveSegment(demoted);
+			}
+		}
+
+		// The probation segment, where new entries are added
 		EvictionOrderT evictionOrder;
+		// Entries which were hit while in probation, evicted only when probation is empty
+		EvictionOrderT protectedOrder;
+		int64_t protectedSize = 0;
+		// Internal entries, evicted only when probation and protected are empty
+		EvictionOrderT internalOrder;
+		int64_t internalSize = 0;
 		// Size of all entries in the eviction order or held in external eviction orders
 		int64_t sizeUsed = 0;
 		// Number of items that have been moveOut()'d to other evictionOrders and aren't back yet
@@ -1819,10 +1980,11 @@ public:
 	}
 
 	// Get the object for i or create a new one.
-	// After a get(), the object for i is the last in evictionOrder.
+	// After a get(), the object for i is the last in its segment of the eviction order.
 	// If noHit is set, do not consider this access to be cache hit if the object is present
-	// If noMiss is set, do not consider this access to be a cache miss if the object is not present
-	ObjectType& get(const IndexType& index, int size, bool noHit = false) {
+	// If cold is set, a hit does not promote the object to the protected segment
+	// If internal is set, the object is kept in the internal segment
+	ObjectType& get(const IndexType& index, int size, bool noHit = false, bool cold = false, bool internal = false) {
 		Entry& entry = cache[index];
 
 		// If entry is linked into an evictionOrder
@@ -1832,7 +1994,7 @@ public:
 				++entry.hits;
 				// If item eviction is not prioritized, move to end of eviction order
 				if (entry.ownedByEvictor) {
-					pEvictor->moveToBack(entry);
+					pEvictor->hit(entry, cold, internal);
 				}
 			}
 		} else {
@@ -1843,9 +2005,12 @@ public:
 			entry.pCache = &cache;
 			entry.hits = 0;
 			entry.size = size;
+			if (cold) {
+				++g_redwoodMetrics.metric.pagerCacheColdInsert;
+			}
 
 			pEvictor->trim(entry.size);
-			pEvictor->addNew(entry);
+			pEvictor->addNew(entry, internal);
 		}
 
 		return entry.item;
@@ -2030,10 +2195,23 @@ public:
 		pageCache.evictor().sizeLimit = pageCacheBytes;
 
 		g_redwoodMetrics.ioLock = ioLock.getPtr();
+		// The evictor is shared by all pagers of the process and outlives them
+		PageCacheT::Evictor* evictor = &pageCache.evictor();
+		g_redwoodMetrics.internalPageCacheSize = [evictor]() {
+			return std::make_tuple(evictor->getInternalSize(), evictor->getInternalCount(), evictor->getInternalLimit());
+		};
 		if (!g_redwoodMetricsActor.isValid()) {
 			g_redwoodMetricsActor = redwoodMetricsLogger();
 		}
 
+		if (SERVER_KNOBS->REDWOOD_PAGE_CODEC_THREADS > 0 && !memoryOnly) {
+			// In simulation page decodes run in coroutines on the network thread so they stay deterministic
+			pageCodecs = g_network->isSimulated() ? CoroThreadPool::createThreadPool() : createGenericThreadPool();
+			for (int i = 0; i < SERVER_KNOBS->REDWOOD_PAGE_CODEC_THREADS; ++i) {
+				pageCodecs->addThread(new PageCodec(), "fdb-redwood-codec");
+			}
+		}
+
 		commitFuture = Void();
 		recoverFuture = forwardError(recover(this), errorPromise);
 	}
@@ -2582,7 +2760,10 @@ public:
 			page = page->clone();
 		}
 
+		double encodeStart = timer();
 		page->preWrite(pageIDs.front());
+		++g_redwoodMetrics.metric.pageEncode;
+		g_redwoodMetrics.metric.pageEncodeTimeNS += int64_t((timer() - encodeStart) * 1e9);
 
 		int blockSize = header ? smallestPhysicalBlock : physicalPageSize;
 		Future<Void> f;
@@ -2614,7 +2795,8 @@ public:
 		// or as a cache miss because there is no benefit to the page already being in cache
 		// Similarly, this does not count as a point lookup for reason.
 		ASSERT(pageIDs.front() != invalidLogicalPageID);
-		PageCacheEntry& cacheEntry = pageCache.get(pageIDs.front(), pageIDs.size() * physicalPageSize, true);
+		PageCacheEntry& cacheEntry =
+		    pageCache.get(pageIDs.front(), pageIDs.size() * physicalPageSize, true, false, isInternalPage(level));
 		debug_printf("DWALPager(%s) op=write %s cached=%d reading=%d writing=%d\n",
 		             filename.c_str(),
 		             toString(pageIDs).c_str(),
@@ -2795,6 +2977,63 @@ public:
 		return bytes;
 	}
 
+	// Verifies and decrypts the payloads of pages read from disk off the network thread, so that checksums and AES
+	// decryption of read-heavy workloads use more than one core.
+	struct PageCodec : IThreadPoolReceiver {
+		void init() override {}
+
+		struct DecodeAction : TypedAction<PageCodec, DecodeAction> {
+			DecodeAction(ArenaPage* page, PhysicalPageID pageID) : page(page), pageID(pageID) {}
+
+			double getTimeEstimate() const override { return 0; }
+
+			ArenaPage* page;
+			PhysicalPageID pageID;
+			// The time spent decoding and the part of it spent decrypting
+			ThreadReturnPromise<std::pair<double, double>> times;
+		};
+
+		void action(DecodeAction& a) {
+			try {
+				double start = timer();
+				double decryptTime = 0;
+				a.page->postReadPayload(a.pageID, &decryptTime);
+				a.times.send(std::make_pair(timer() - start, decryptTime));
+			} catch (Error& e) {
+				a.times.sendError(e);
+			}
+		}
+	};
+
+	// Decodes the payload of a page on a codec thread. The page must not be touched by anything else until the
+	// decode is done, and the decode must not be cancelled as it holds the only reference to the page the codec
+	// thread is writing to once the reader goes away.
+	ACTOR static Future<std::pair<double, double>> decodePayloadOffThread(Reference<IThreadPool> pageCodecs,
+	                                                                      Reference<ArenaPage> page,
+	                                                                      PhysicalPageID pageID) {
+		auto* action = new PageCodec::DecodeAction(page.getPtr(), pageID);
+		state Future<std::pair<double, double>> decoded = action->times.getFuture();
+		pageCodecs->post(action);
+		std::pair<double, double> times = wait(decoded);
+		return times;
+	}
+
+	// Verifies and decrypts the payload of a page after postReadHeader, and records how long that took. Returns the
+	// time spent decrypting.
+	ACTOR static Future<double> decodePayload(DWALPager* self, Reference<ArenaPage> page, PhysicalPageID pageID) {
+		state std::pair<double, double> times;
+		if (self->pageCodecs) {
+			wait(store(times, uncancellable(decodePayloadOffThread(self->pageCodecs, page, pageID))));
+		} else {
+			double start = timer();
+			page->postReadPayload(pageID, &times.second);
+			times.first = timer() - start;
+		}
+		++g_redwoodMetrics.metric.pageDecode;
+		g_redwoodMetrics.metric.pageDecodeTimeNS += int64_t(times.first * 1e9);
+		return times.second;
+	}
+
 	// Read a physical page from the page file.  Note that header pages use a page size of smallestPhysicalBlock.
 	// If the user chosen physical page size is larger, then there will be a gap of unused space after the header pages
 	// and before the user-chosen sized pages.
@@ -2838,8 +3077,7 @@ public:
 				ArenaPage::EncryptionKey k = wait(self->keyProvider->getEncryptionKey(page->getEncodingHeader()));
 				page->encryptionKey = k;
 			}
-			double decryptTime = 0;
-			page->postReadPayload(pageID, &decryptTime);
+			double decryptTime = wait(decodePayload(self, page, pageID));
 			if (isReadRequest(reason)) {
 				g_redwoodMetrics.metric.readRequestDecryptTimeNS += int64_t(decryptTime * 1e9);
 			}
@@ -2848,6 +3086,9 @@ public:
 			             toString(pageID).c_str(),
 			             page->rawData());
 		} catch (Error& e) {
+			if (e.code() == error_code_actor_cancelled) {
+				throw;
+			}
 			Error err = e;
 			if (g_network->isSimulated() && g_simulator->checkInjectedCorruption()) {
 				err = err.asInjectedFault();
@@ -2922,8 +3163,7 @@ public:
 				ArenaPage::EncryptionKey k = wait(self->keyProvider->getEncryptionKey(page->getEncodingHeader()));
 				page->encryptionKey = k;
 			}
-			double decryptTime = 0;
-			page->postReadPayload(pageIDs.front(), &decryptTime);
+			double decryptTime = wait(decodePayload(self, page, pageIDs.front()));
 			if (reason.present() && isReadRequest(reason.get())) {
 				g_redwoodMetrics.metric.readRequestDecryptTimeNS += int64_t(decryptTime * 1e9);
 			}
@@ -2934,6 +3174,9 @@ public:
 			             page->rawData(),
 			             pageIDs.size() * blockSize);
 		} catch (Error& e) {
+			if (e.code() == error_code_actor_cancelled) {
+				throw;
+			}
 			// For header pages, error is a warning because recovery may still be possible
 			TraceEvent(SevError, "RedwoodPageError")
 			    .error(e)
@@ -2962,6 +3205,17 @@ public:
 		       reason == PagerEventReasons::RangeRead || reason == PagerEventReasons::RangePrefetch;
 	}
 
+	// Leaf pages read by scans are inserted into the page cache at cold priority so they cannot displace the point read
+	// working set. Internal pages are shared by all reads of their subtree so they are left eligible for promotion.
+	static bool isColdRead(PagerEventReasons reason, unsigned int level) {
+		return SERVER_KNOBS->REDWOOD_PAGE_CACHE_SCAN_COLD && level <= 1 &&
+		       (reason == PagerEventReasons::FetchRange || reason == PagerEventReasons::RangeRead ||
+		        reason == PagerEventReasons::RangePrefetch);
+	}
+
+	// BTree pages above the leaf level are kept in the page cache's internal segment
+	static bool isInternalPage(unsigned int level) { return level > 1; }
+
 	// Reads the most recent version of pageID, either previously committed or written using updatePage()
 	// in the current commit
 	Future<Reference<ArenaPage>> readPage(PagerEventReasons reason,
@@ -2991,7 +3245,8 @@ public:
 			debug_printf("DWALPager(%s) op=readUncachedMiss %s\n", filename.c_str(), toString(pageID).c_str());
 			return forwardError(readPhysicalPage(this, pageID, priority, false, reason), errorPromise);
 		}
-		PageCacheEntry& cacheEntry = pageCache.get(pageID, physicalPageSize, noHit);
+		PageCacheEntry& cacheEntry =
+		    pageCache.get(pageID, physicalPageSize, noHit, isColdRead(reason, level), isInternalPage(level));
 		debug_printf("DWALPager(%s) op=read %s cached=%d reading=%d writing=%d noHit=%d\n",
 		             filename.c_str(),
 		             toString(pageID).c_str(),
@@ -3041,7 +3296,12 @@ public:
 			return forwardError(readPhysicalMultiPage(this, pageIDs, priority, reason), errorPromise);
 		}
 
-		PageCacheEntry& cacheEntry = pageCache.get(pageIDs.front(), pageIDs.size() * physicalPageSize, noHit);
+		PageCacheEntry& cacheEntry =
+		    pageCache.get(pageIDs.front(),
+		                  pageIDs.size() * physicalPageSize,
+		                  noHit,
+		                  isColdRead(reason, level),
+		                  isInternalPage(level));
 		debug_printf("DWALPager(%s) op=read %s cached=%d reading=%d writing=%d noHit=%d\n",
 		             filename.c_str(),
 		             toString(pageIDs).c_str(),
@@ -3350,8 +3610,9 @@ public:
 			debug_printf("DWALPager(%s) remapCleanup copy %s\n", self->filename.c_str(), p.toString().c_str());
 
 			// Read the data from the page that the original was mapped to
+			int priority = std::clamp(SERVER_KNOBS->REDWOOD_REMAP_CLEANUP_IO_PRIORITY, ioMinPriority, ioMaxPriority);
 			Reference<ArenaPage> data = wait(
-			    self->readPage(PagerEventReasons::MetaData, nonBtreeLevel, p.newPageID, ioLeafPriority, false, true));
+			    self->readPage(PagerEventReasons::MetaData, nonBtreeLevel, p.newPageID, priority, false, true));
 
 			// Write the data to the original page so it can be read using its original pageID
 			self->updatePage(
@@ -3437,7 +3698,7 @@ public:
 		double toleranceRatio = BUGGIFY ? deterministicRandom()->randomInt(0, 10) / 100.0
 		                                : SERVER_KNOBS->REDWOOD_REMAP_CLEANUP_TOLERANCE_RATIO;
 		// For simplicity, we assume each entry in the remap queue corresponds to one remapped page.
-		uint64_t remapCleanupWindowEntries =
+		state uint64_t remapCleanupWindowEntries =
 		    static_cast<uint64_t>(self->remapCleanupWindowBytes / self->header.pageSize);
 		state uint64_t minRemapEntries = static_cast<uint64_t>(remapCleanupWindowEntries * (1.0 - toleranceRatio));
 		state uint64_t maxRemapEntries = static_cast<uint64_t>(remapCleanupWindowEntries * (1.0 + toleranceRatio));
@@ -3457,6 +3718,14 @@ public:
 			self->remapDestinationsSimOnly.clear();
 		}
 
+		// Copies are paced by a token bucket holding up to a tenth of a second of copies, so that cleanup between
+		// commits is spread out instead of competing with foreground IO in bursts.  The rate is reduced while other IO
+		// is waiting for the IO lock, and pacing stops once a commit is waiting for cleanup to finish.
+		state double copyRate = SERVER_KNOBS->REDWOOD_REMAP_CLEANUP_COPY_RATE;
+		state double copyBurst = std::max(1.0, copyRate / 10);
+		state double copyTokens = copyBurst;
+		state double lastRefill = now();
+
 		state int sinceYield = 0;
 		loop {
 			// Stop if we have cleanup enough remap entries, or if the stop flag is set and the remaining remap
@@ -3487,6 +3756,25 @@ public:
 				break;
 			}
 
+			if (copyRate > 0 && p.get().getType() == RemappedPage::REMAP) {
+				loop {
+					double rate = copyRate;
+					if (self->ioLock->getWaitersCount() > 0) {
+						rate *= std::max(SERVER_KNOBS->REDWOOD_REMAP_CLEANUP_BUSY_RATE_FRACTION, 0.01);
+					}
+					copyTokens = std::min(copyBurst, copyTokens + (now() - lastRefill) * rate);
+					lastRefill = now();
+					if (copyTokens >= 1 || self->remapCleanupStop) {
+						break;
+					}
+					state double throttleStart = now();
+					wait(delay((1 - copyTokens) / rate));
+					++g_redwoodMetrics.metric.pagerRemapThrottle;
+					g_redwoodMetrics.metric.pagerRemapThrottleMS += int64_t((now() - throttleStart) * 1e3);
+				}
+				copyTokens -= 1;
+			}
+
 			Future<Void> task = removeRemapEntry(self, p.get(), oldestRetainedVersion);
 			if (!task.isReady()) {
 				tasks.add(task);
@@ -3506,6 +3794,9 @@ public:
 		             self->remapQueue.numEntries,
 		             self->freeList.numEntries,
 		             self->delayedFreeList.numEntries);
+		g_redwoodMetrics.remapQueueEntries = self->remapQueue.numEntries;
+		g_redwoodMetrics.remapQueueLagEntries =
+		    std::max<int64_t>(0, self->remapQueue.numEntries - (int64_t)remapCleanupWindowEntries);
 		signal.send(Void());
 		wait(tasks.getResult());
 		return Void();
@@ -3666,6 +3957,11 @@ public:
 		}
 		self->operations.clear();
 
+		// Decodes in progress hold their own references to their pages, so the pool only needs to stop taking more
+		if (self->pageCodecs) {
+			self->pageCodecs->stop();
+		}
+
 		debug_printf("DWALPager(%s) shutdown cancel queues\n", self->filename.c_str());
 		self->freeList.cancel();
 		self->delayedFreeList.cancel();
@@ -3882,6 +4178,9 @@ private:
 	Reference<IPageEncryptionKeyProvider> keyProvider;
 	Promise<Void> keyProviderInitialized;
 
+	// Null unless REDWOOD_PAGE_CODEC_THREADS is positive
+	Reference<IThreadPool> pageCodecs;
+
 	Reference<PriorityMultiLock> ioLock;
 
 	int64_t pageCacheBytes;
@@ -5031,6 +5330,30 @@ public:
 		m_pBuffer->erase(iBegin, iEnd);
 	}
 
+	// Replace range with records, which must be sorted by key and within range, as of the next commit.
+	// The records are not copied or inserted into the mutation buffer one by one.  The mutation buffer holds a
+	// reference to them and the commit merges them into the leaves covering range, writing fully packed pages.
+	void replaceRange(KeyRangeRef range, const Standalone<VectorRef<KeyValueRef>>& records) {
+		++g_redwoodMetrics.metric.opReplaceRange;
+		g_redwoodMetrics.metric.opReplaceRangeRecords += records.size();
+		if (range.singleKeyRange() || records.empty()) {
+			clear(range);
+			for (auto const& kv : records) {
+				set(kv);
+			}
+			return;
+		}
+
+		ASSERT(range.contains(records.front().key) && range.contains(records.back().key));
+		clear(range);
+		++m_mutationCount;
+		RangeMutation& m = m_pBuffer->insert(range.begin).mutation();
+		m.bulkRecords = m_pBuffer->holdInArena(records);
+		if (records.front().key == range.begin) {
+			m.setBoundaryValue(records.front().value);
+		}
+	}
+
 	void setOldestReadableVersion(Version v) { m_newOldestVersion = v; }
 
 	Version getOldestReadableVersion() const { return m_pager->getOldestReadableVersion(); }
@@ -5052,6 +5375,15 @@ public:
 	    m_pBoundaryVerifier(DecodeBoundaryVerifier::getVerifier(name)) {
 		m_pDecodeCacheMemory = m_pager->getPageCachePenaltySource();
 		m_lazyClearActor = 0;
+		m_pageCompression = CompressionUtils::fromFilterString(SERVER_KNOBS->REDWOOD_PAGE_COMPRESSION_FILTER);
+		CompressionUtils::checkFilterSupported(m_pageCompression);
+		if (SERVER_KNOBS->REDWOOD_COMMIT_BUILD_THREADS > 0) {
+			// In simulation page builds run in coroutines on the network thread so they stay deterministic
+			m_pageBuilders = g_network->isSimulated() ? CoroThreadPool::createThreadPool() : createGenericThreadPool();
+			for (int i = 0; i < SERVER_KNOBS->REDWOOD_COMMIT_BUILD_THREADS; ++i) {
+				m_pageBuilders->addThread(new PageBuilder(), "fdb-redwood-build");
+			}
+		}
 		m_init = init_impl(this);
 		m_latestCommit = m_init;
 	}
@@ -5367,6 +5699,10 @@ public:
 		             self->m_pager->getLastCommittedVersion(),
 		             self->m_header.toString().c_str());
 
+		if (SERVER_KNOBS->REDWOOD_COMPACTION_SCAN_RATE > 0) {
+			self->m_compactionActor = forwardError(compactPages(self), self->m_errorPromise);
+		}
+
 		return Void();
 	}
 
@@ -5382,11 +5718,18 @@ public:
 			m_pBoundaryVerifier->setKeyProvider(Reference<IPageEncryptionKeyProvider>());
 		}
 
+		// Page builds in progress write into pages and read records owned by the commit, so they must finish and any
+		// queued ones must be discarded before the commit is cancelled.
+		if (m_pageBuilders) {
+			m_pageBuilders->stop();
+		}
+
 		// This probably shouldn't be called directly (meaning deleting an instance directly) but it should be safe,
 		// it will cancel init and commit and leave the pager alive but with potentially an incomplete set of
 		// uncommitted writes so it should not be committed.
 		m_latestCommit.cancel();
 		m_lazyClearActor.cancel();
+		m_compactionActor.cancel();
 		m_init.cancel();
 	}
 
@@ -5477,17 +5820,22 @@ private:
 	};
 
 	struct RangeMutation {
-		RangeMutation() : boundaryChanged(false), clearAfterBoundary(false) {}
+		RangeMutation() : boundaryChanged(false), clearAfterBoundary(false), rewritePage(false), bulkRecords(nullptr) {}
 
 		bool boundaryChanged;
 		Optional<ValueRef> boundaryValue; // Not present means cleared
 		bool clearAfterBoundary;
+		// The leaf page containing the boundary key must be rebuilt even if no records change, see compactPages()
+		bool rewritePage;
+		// Sorted records which replace the cleared range after the boundary, from replaceRange().  Only those after the
+		// boundary key and before the next boundary key apply, the one at the boundary key is its boundary value.
+		const VectorRef<KeyValueRef>* bulkRecords;
 
 		bool boundaryCleared() const { return boundaryChanged && !boundaryValue.present(); }
 		bool boundarySet() const { return boundaryChanged && boundaryValue.present(); }
 
 		// Returns true if this RangeMutation doesn't actually mutate anything
-		bool noChanges() const { return !boundaryChanged && !clearAfterBoundary; }
+		bool noChanges() const { return !boundaryChanged && !clearAfterBoundary && !rewritePage; }
 
 		void clearBoundary() {
 			boundaryChanged = true;
@@ -5497,6 +5845,35 @@ private:
 		void clearAll() {
 			clearBoundary();
 			clearAfterBoundary = true;
+			bulkRecords = nullptr;
+		}
+
+		// Called on a new boundary which divides the cleared range after previous, so that it also replaces the part
+		// of the range after it with previous's bulk records.
+		void divideBulkRecords(const RangeMutation& previous, KeyRef boundary) {
+			bulkRecords = previous.bulkRecords;
+			if (bulkRecords != nullptr) {
+				auto i =
+				    std::lower_bound(bulkRecords->begin(), bulkRecords->end(), boundary, KeyValueRef::OrderByKey());
+				if (i != bulkRecords->end() && i->key == boundary) {
+					setBoundaryValue(i->value);
+				}
+			}
+		}
+
+		// Returns the bulk records of the range after boundary which are within [begin, end)
+		std::pair<const KeyValueRef*, const KeyValueRef*> bulkRecordsWithin(KeyRef boundary,
+		                                                                    KeyRef begin,
+		                                                                    KeyRef end) const {
+			if (bulkRecords == nullptr) {
+				return { nullptr, nullptr };
+			}
+			const KeyValueRef* first = bulkRecords->begin();
+			const KeyValueRef* last = bulkRecords->end();
+			KeyValueRef::OrderByKey byKey;
+			const KeyValueRef* b = begin > boundary ? std::lower_bound(first, last, begin, byKey)
+			                                        : std::upper_bound(first, last, boundary, byKey);
+			return { b, std::lower_bound(b, last, end, byKey) };
 		}
 
 		void setBoundaryValue(ValueRef v) {
@@ -5505,10 +5882,12 @@ private:
 		}
 
 		std::string toString() const {
-			return format("boundaryChanged=%d clearAfterBoundary=%d boundaryValue=%s",
+			return format("boundaryChanged=%d clearAfterBoundary=%d rewritePage=%d boundaryValue=%s bulkRecords=%d",
 			              boundaryChanged,
 			              clearAfterBoundary,
-			              ::toString(boundaryValue).c_str());
+			              rewritePage,
+			              ::toString(boundaryValue).c_str(),
+			              bulkRecords == nullptr ? 0 : bulkRecords->size());
 		}
 	};
 
@@ -5557,6 +5936,12 @@ public:
 			return T(arena, object);
 		}
 
+		// Return a pointer to records, which stay valid for the lifetime of arena without being copied
+		const VectorRef<KeyValueRef>* holdInArena(const Standalone<VectorRef<KeyValueRef>>& records) {
+			arena.dependsOn(records.arena());
+			return new (arena) VectorRef<KeyValueRef>(records);
+		}
+
 		const_iterator upper_bound(const KeyRef& k) const { return mutations.upper_bound(k); }
 
 		const_iterator lower_bound(const KeyRef& k) const { return mutations.lower_bound(k); }
@@ -5590,6 +5975,7 @@ public:
 			// also be cleared
 			if (iPrevious.mutation().clearAfterBoundary) {
 				ib.mutation().clearAll();
+				ib.mutation().divideBulkRecords(iPrevious.mutation(), boundary);
 			}
 
 			return ib;
@@ -5692,30 +6078,174 @@ private:
 	BTreeCommitHeader m_header;
 	LazyClearQueueT m_lazyClearQueue;
 	Future<int> m_lazyClearActor;
+	Future<Void> m_compactionActor;
 	bool m_lazyClearStop;
 
+	// Builds the DeltaTrees of new pages off the network thread so that the independent subtree rewrites of a commit
+	// use multiple cores.
+	struct PageBuilder : IThreadPoolReceiver {
+		void init() override {}
+
+		struct BuildAction : TypedAction<PageBuilder, BuildAction> {
+			BuildAction(BTreePage::BinaryTree* tree,
+			            int spaceAvailable,
+			            const RedwoodRecordRef* begin,
+			            const RedwoodRecordRef* end,
+			            const RedwoodRecordRef* lowerBound,
+			            const RedwoodRecordRef* upperBound)
+			  : tree(tree), spaceAvailable(spaceAvailable), begin(begin), end(end), lowerBound(lowerBound),
+			    upperBound(upperBound) {}
+
+			double getTimeEstimate() const override { return 0; }
+
+			BTreePage::BinaryTree* tree;
+			int spaceAvailable;
+			const RedwoodRecordRef* begin;
+			const RedwoodRecordRef* end;
+			const RedwoodRecordRef* lowerBound;
+			const RedwoodRecordRef* upperBound;
+			ThreadReturnPromise<int> written;
+		};
+
+		void action(BuildAction& a) {
+			a.written.send(a.tree->build(a.spaceAvailable, a.begin, a.end, a.lowerBound, a.upperBound));
+		}
+	};
+
+	// Null unless REDWOOD_COMMIT_BUILD_THREADS is positive
+	Reference<IThreadPool> m_pageBuilders;
+
+	// The pageFormat of BTree nodes whose BTreePage is stored compressed.  The payload of such a node is a
+	// CompressedNodeHeader followed by the compressed bytes.
+	static constexpr uint8_t compressedNodeFormat = 1;
+
+#pragma pack(push, 1)
+	struct CompressedNodeHeader {
+		uint8_t filter; // CompressionFilter used to compress the BTreePage
+		uint16_t logicalBlocks; // Number of blocks of the page the BTreePage was built in
+		uint32_t compressedSize;
+	};
+#pragma pack(pop)
+
+	// Compression filter for newly written nodes
+	CompressionFilter m_pageCompression;
+
+	// Returns the page to write for a BTree node which was built in page, a page of logicalBlocks blocks.  If
+	// compression is enabled and the node compresses to fewer blocks, a smaller page holding the compressed node is
+	// returned instead, which readPage() decompresses back into a page of logicalBlocks blocks.
+	Reference<ArenaPage> compressPage(Reference<ArenaPage> page, int logicalBlocks) {
+		if (m_pageCompression == CompressionFilter::NONE || logicalBlocks < 2) {
+			return page;
+		}
+
+		const BTreePage* btPage = (const BTreePage*)page->data();
+		Arena arena;
+		StringRef compressed =
+		    CompressionUtils::compress(m_pageCompression, StringRef(page->data(), btPage->size()), arena);
+		++g_redwoodMetrics.metric.pageCompress;
+		g_redwoodMetrics.metric.pageCompressRawBytes += btPage->size();
+
+		int requiredSize = sizeof(CompressedNodeHeader) + compressed.size();
+		int blocks = 1;
+		while (blocks < logicalBlocks &&
+		       ArenaPage::getUsableSize(blocks * m_blockSize, m_encodingType) < requiredSize) {
+			++blocks;
+		}
+		if (blocks == logicalBlocks) {
+			// Nothing would be saved, so the node is written as it is
+			g_redwoodMetrics.metric.pageCompressBytes += btPage->size();
+			return page;
+		}
+		g_redwoodMetrics.metric.pageCompressBytes += compressed.size();
+
+		Reference<ArenaPage> compressedPage = m_pager->newPageBuffer(blocks);
+		compressedPage->init(m_encodingType,
+		                     (blocks == 1) ? PageType::BTreeNode : PageType::BTreeSuperNode,
+		                     btPage->height,
+		                     compressedNodeFormat);
+		compressedPage->encryptionKey = page->encryptionKey;
+
+		CompressedNodeHeader* h = (CompressedNodeHeader*)compressedPage->mutateData();
+		h->filter = (uint8_t)m_pageCompression;
+		h->logicalBlocks = logicalBlocks;
+		h->compressedSize = compressed.size();
+		memcpy(h + 1, compressed.begin(), compressed.size());
+		memset(compressedPage->mutateData() + requiredSize, 0, compressedPage->dataSize() - requiredSize);
+
+		// Where readPage() would keep the uncompressed page with the cached page, keep the one just built
+		if (btPage->height >= SERVER_KNOBS->REDWOOD_DECODECACHE_REUSE_MIN_HEIGHT) {
+			compressedPage->extra = page;
+		}
+		return compressedPage;
+	}
+
+	// Returns the uncompressed page of the BTree node read into page.  For heights at which decode caches are reused
+	// the uncompressed page is kept with page, so a cached node is only decompressed once.
+	Reference<const ArenaPage> decompressPage(Reference<const ArenaPage> page) {
+		if (page->getPageFormat() != compressedNodeFormat) {
+			return page;
+		}
+		if (page->extra.valid()) {
+			return page->extra.getReference<ArenaPage>();
+		}
+
+		double startTime = timer();
+		const CompressedNodeHeader* h = (const CompressedNodeHeader*)page->data();
+		ASSERT(sizeof(CompressedNodeHeader) + h->compressedSize <= page->dataSize());
+		Arena arena;
+		StringRef raw = CompressionUtils::decompress(
+		    (CompressionFilter)h->filter, StringRef((const uint8_t*)(h + 1), h->compressedSize), arena);
+		unsigned int height = ((const BTreePage*)raw.begin())->height;
+
+		Reference<ArenaPage> decompressed = m_pager->newPageBuffer(h->logicalBlocks);
+		decompressed->init(page->getEncodingType(), PageType::BTreeSuperNode, height);
+		decompressed->encryptionKey = page->encryptionKey;
+		ASSERT(raw.size() <= decompressed->dataSize());
+		memcpy(decompressed->mutateData(), raw.begin(), raw.size());
+		memset(decompressed->mutateData() + raw.size(), 0, decompressed->dataSize() - raw.size());
+
+		++g_redwoodMetrics.metric.pageDecompress;
+		g_redwoodMetrics.metric.pageDecompressTimeNS += int64_t((timer() - startTime) * 1e9);
+
+		if (height >= SERVER_KNOBS->REDWOOD_DECODECACHE_REUSE_MIN_HEIGHT) {
+			page->extra = decompressed;
+		}
+		return decompressed;
+	}
+
+	// Number of blocks of the uncompressed form of a page returned by readPage()
+	int logicalBlockCount(const ArenaPage* page) const { return page->rawSize() / m_pager->getPhysicalPageSize(); }
+
 	// Describes a range of a vector of records that should be built into a single BTreePage
 	struct PageToBuild {
 		PageToBuild(int index,
 		            int blockSize,
+		            int initialBlocks,
 		            EncodingType encodingType,
 		            unsigned int height,
 		            bool enableEncryptionDomain,
 		            bool splitByDomain,
 		            IPageEncryptionKeyProvider* keyProvider)
-		  : startIndex(index), count(0), pageSize(blockSize),
-		    largeDeltaTree(pageSize > BTreePage::BinaryTree::SmallSizeLimit), blockSize(blockSize), blockCount(1),
-		    kvBytes(0), encodingType(encodingType), height(height), enableEncryptionDomain(enableEncryptionDomain),
-		    splitByDomain(splitByDomain), keyProvider(keyProvider) {
+		  : startIndex(index), count(0), pageSize(blockSize * initialBlocks),
+		    largeDeltaTree(pageSize > BTreePage::BinaryTree::SmallSizeLimit), blockSize(blockSize),
+		    blockCount(initialBlocks), initialBlocks(initialBlocks), kvBytes(0), encodingType(encodingType),
+		    height(height), enableEncryptionDomain(enableEncryptionDomain), splitByDomain(splitByDomain),
+		    keyProvider(keyProvider) {
 
 			// Subtrace Page header overhead, BTreePage overhead, and DeltaTree (BTreePage::BinaryTree) overhead.
 			bytesLeft =
-			    ArenaPage::getUsableSize(blockSize, encodingType) - sizeof(BTreePage) - sizeof(BTreePage::BinaryTree);
+			    ArenaPage::getUsableSize(pageSize, encodingType) - sizeof(BTreePage) - sizeof(BTreePage::BinaryTree);
 		}
 
 		PageToBuild next() {
-			return PageToBuild(
-			    endIndex(), blockSize, encodingType, height, enableEncryptionDomain, splitByDomain, keyProvider);
+			return PageToBuild(endIndex(),
+			                   blockSize,
+			                   initialBlocks,
+			                   encodingType,
+			                   height,
+			                   enableEncryptionDomain,
+			                   splitByDomain,
+			                   keyProvider);
 		}
 
 		int startIndex; // Index of the first record
@@ -5726,6 +6256,7 @@ private:
 		bool largeDeltaTree; // Whether or not the tree in the generated page is in the 'large' size range
 		int blockSize; // Base block size by which pageSize can be incremented
 		int blockCount; // The number of blocks in pageSize
+		int initialBlocks; // The number of blocks pageSize starts at before any records are added
 		int kvBytes; // The amount of user key/value bytes added to the page
 
 		EncodingType encodingType;
@@ -5933,8 +6464,19 @@ private:
 			deltaSizes[i] = records[i].deltaSize(records[i - 1], prefixLen, true);
 		}
 
-		PageToBuild p(
-		    0, m_blockSize, m_encodingType, height, enableEncryptionDomain, splitByDomain, m_keyProvider.getPtr());
+		// Compressed leaves are built larger than a block so that they can be stored in fewer blocks than they would
+		// have taken uncompressed.
+		int initialBlocks = (m_pageCompression != CompressionFilter::NONE && height == 1)
+		                        ? std::max(1, SERVER_KNOBS->REDWOOD_PAGE_COMPRESSION_BLOCKS)
+		                        : 1;
+		PageToBuild p(0,
+		              m_blockSize,
+		              initialBlocks,
+		              m_encodingType,
+		              height,
+		              enableEncryptionDomain,
+		              splitByDomain,
+		              m_keyProvider.getPtr());
 
 		for (int i = 0; i < records.size();) {
 			bool force = p.count < minRecords || p.slackFraction() > maxSlack;
@@ -6129,13 +6671,28 @@ private:
 			             pageLowerBound.toString(false).c_str(),
 			             pageUpperBound.toString(false).c_str());
 
-			int deltaTreeSpace = page->dataSize() - sizeof(BTreePage);
+			state int deltaTreeSpace = page->dataSize() - sizeof(BTreePage);
 			debug_printf("Building tree at %p deltaTreeSpace %d p.usedBytes=%d\n",
 			             btPage->tree(),
 			             deltaTreeSpace,
 			             p->usedBytes());
-			state int written = btPage->tree()->build(
-			    deltaTreeSpace, &entries[p->startIndex], &entries[p->endIndex()], &pageLowerBound, &pageUpperBound);
+			state int written;
+			if (self->m_pageBuilders) {
+				// Everything the build reads or writes is kept alive by this actor or its caller, and the destructor
+				// stops the pool before cancelling the commit.
+				auto* action = new PageBuilder::BuildAction(btPage->tree(),
+				                                            deltaTreeSpace,
+				                                            &entries[p->startIndex],
+				                                            &entries[p->endIndex()],
+				                                            &pageLowerBound,
+				                                            &pageUpperBound);
+				Future<int> built = action->written.getFuture();
+				self->m_pageBuilders->post(action);
+				wait(store(written, built));
+			} else {
+				written = btPage->tree()->build(
+				    deltaTreeSpace, &entries[p->startIndex], &entries[p->endIndex()], &pageLowerBound, &pageUpperBound);
+			}
 
 			if (written > deltaTreeSpace) {
 				debug_printf("ERROR:  Wrote %d bytes to page %s deltaTreeSpace=%d\n",
@@ -6157,10 +6714,12 @@ private:
 
 			// Write this btree page, which is made of 1 or more pager pages.
 			state BTreeNodeLinkRef childPageID;
+			page = self->compressPage(page, p->blockCount);
+			state int physicalBlocks = page->rawSize() / self->m_pager->getPhysicalPageSize();
 
 			// If we are only writing 1 BTree node and its block count is 1 and the original node also had 1 block
 			// then try to update the page atomically so its logical page ID does not change
-			if (pagesToBuild.size() == 1 && p->blockCount == 1 && previousID.size() == 1) {
+			if (pagesToBuild.size() == 1 && physicalBlocks == 1 && previousID.size() == 1) {
 				page->setLogicalPageInfo(previousID.front(), parentID);
 				LogicalPageID id = wait(
 				    self->m_pager->atomicUpdatePage(PagerEventReasons::Commit, height, previousID.front(), page, v));
@@ -6194,7 +6753,7 @@ private:
 					self->freeBTreePage(height, previousID, v);
 				}
 
-				childPageID.resize(records.arena(), p->blockCount);
+				childPageID.resize(records.arena(), physicalBlocks);
 				state int i = 0;
 				for (i = 0; i < childPageID.size(); ++i) {
 					LogicalPageID id = wait(self->m_pager->newPageID());
@@ -6318,6 +6877,7 @@ private:
 			page = std::move(p);
 		}
 		debug_printf("readPage() op=readComplete %s @%" PRId64 " \n", toString(id).c_str(), snapshot->getVersion());
+		page = self->decompressPage(std::move(page));
 		const BTreePage* btPage = (const BTreePage*)page->data();
 		auto& metrics = g_redwoodMetrics.level(btPage->height).metrics;
 		metrics.pageRead += 1;
@@ -6403,9 +6963,6 @@ private:
 	                                                      Arena* arena,
 	                                                      Reference<ArenaPage> page,
 	                                                      Version writeVersion) {
-		state BTreeNodeLinkRef newID;
-		newID.resize(*arena, oldID.size());
-
 		if (REDWOOD_DEBUG) {
 			const BTreePage* btPage = (const BTreePage*)page->mutateData();
 			BTreePage::BinaryTree::DecodeCache* cache = page->extra.getPtr<BTreePage::BinaryTree::DecodeCache>();
@@ -6421,7 +6978,11 @@ private:
 		}
 
 		state unsigned int height = (unsigned int)((const BTreePage*)page->data())->height;
-		if (oldID.size() == 1) {
+		page = self->compressPage(page, self->logicalBlockCount(page.getPtr()));
+		state BTreeNodeLinkRef newID;
+		newID.resize(*arena, page->rawSize() / self->m_pager->getPhysicalPageSize());
+
+		if (oldID.size() == 1 && newID.size() == 1) {
 			page->setLogicalPageInfo(oldID.front(), parentID);
 			LogicalPageID id = wait(
 			    self->m_pager->atomicUpdatePage(PagerEventReasons::Commit, height, oldID.front(), page, writeVersion));
@@ -6430,7 +6991,7 @@ private:
 		}
 
 		state int i = 0;
-		for (i = 0; i < oldID.size(); ++i) {
+		for (i = 0; i < newID.size(); ++i) {
 			LogicalPageID id = wait(self->m_pager->newPageID());
 			newID[i] = id;
 		}
@@ -6894,6 +7455,20 @@ private:
 
 			state Standalone<VectorRef<RedwoodRecordRef>> merged;
 
+			// Switch from modifying the existing DeltaTree to a linear merge of existing data and mutations, which
+			// accumulates the new record set in the merge vector to build new pages from it.  First, the merged vector
+			// must be populated with all the records before the cursor.
+			auto switchToMerge = [&]() {
+				auto c = cursor;
+				c.moveFirst();
+				while (c != cursor) {
+					debug_printf("%s catch-up adding %s\n", context.c_str(), c.get().toString().c_str());
+					merged.push_back(merged.arena(), c.get());
+					c.moveNext();
+				}
+				updatingDeltaTree = false;
+			};
+
 			// The first mutation buffer boundary has a key <= the first key in the page.
 
 			cursor.moveFirst();
@@ -6919,6 +7494,17 @@ private:
 				             boundaryExists,
 				             updatingDeltaTree);
 
+				// A page being compacted is rebuilt from its live records, which are all before the cursor or after
+				// the boundary key at this point.
+				if (mBegin.mutation().rewritePage &&
+				    (!firstMutationBoundary || mBegin.key() == update->subtreeLowerBound.key)) {
+					debug_printf("%s Rewriting page for compaction\n", context.c_str());
+					changesMade = true;
+					if (updatingDeltaTree) {
+						switchToMerge();
+					}
+				}
+
 				firstMutationBoundary = false;
 
 				if (applyBoundaryChange) {
@@ -6989,19 +7575,9 @@ private:
 								             context.c_str(),
 								             rec.toString().c_str());
 
-								// Since the insert failed we must switch to a linear merge of existing data and
-								// mutations, accumulating the new record set in the merge vector and build new pages
-								// from it. First, we must populate the merged vector with all the records up to but not
-								// including the current mutation boundary key.
-								auto c = cursor;
-								c.moveFirst();
-								while (c != cursor) {
-									debug_printf(
-									    "%s catch-up adding %s\n", context.c_str(), c.get().toString().c_str());
-									merged.push_back(merged.arena(), c.get());
-									c.moveNext();
-								}
-								updatingDeltaTree = false;
+								// Since the insert failed we must switch to a linear merge, the records before the
+								// cursor are those up to but not including the current mutation boundary key.
+								switchToMerge();
 							}
 						}
 
@@ -7028,6 +7604,8 @@ private:
 
 				// Before advancing the iterator, get whether or not the records in the following range must be removed
 				bool remove = mBegin.mutation().clearAfterBoundary;
+				const RangeMutation& rangeMutation = mBegin.mutation();
+				KeyRef rangeBegin = mBegin.key();
 				// Advance to the next boundary because we need to know the end key for the current range.
 				++mBegin;
 				if (mBegin == mEnd) {
@@ -7075,6 +7653,25 @@ private:
 						}
 					}
 				}
+
+				// The existing records of a replaced range are gone, so add the bulk records which fall in this
+				// subtree.  They are always merged, so that a large bulk load produces fully packed new pages.
+				auto bulk = rangeMutation.bulkRecordsWithin(
+				    rangeBegin, update->subtreeLowerBound.key, std::min(end.key, update->subtreeUpperBound.key));
+				if (bulk.first != bulk.second) {
+					changesMade = true;
+					// Every record before the cursor precedes the replaced range
+					if (updatingDeltaTree) {
+						switchToMerge();
+					}
+					debug_printf("%s Adding %d bulk records from %s [mutation, middle]\n",
+					             context.c_str(),
+					             (int)(bulk.second - bulk.first),
+					             bulk.first->key.printable().c_str());
+					for (const KeyValueRef* kv = bulk.first; kv != bulk.second; ++kv) {
+						merged.push_back(merged.arena(), RedwoodRecordRef(kv->key, kv->value));
+					}
+				}
 			}
 
 			// If there are still more records, they have the same key as the end boundary
@@ -7156,7 +7753,8 @@ private:
 					                                       update->decodeLowerBound,
 					                                       update->decodeUpperBound)));
 
-					update->updatedInPlace(newID, btPage, newID.size() * self->m_blockSize);
+					update->updatedInPlace(
+					    newID, btPage, self->logicalBlockCount(pageCopy.getPtr()) * self->m_blockSize);
 					debug_printf("%s Leaf node updated in-place, returning slice:\n", context.c_str());
 					debug_print(addPrefix(context, update->toString()));
 				}
@@ -7271,9 +7869,17 @@ private:
 						uniform = range.boundaryCleared() || mutationBoundaryKey != u.subtreeLowerBound.key;
 					} else {
 						// If the mutation range after the boundary key is unchanged, then the mutation boundary key
-						// must be also unchanged or must be different than the subtree lower bound key so that it
-						// doesn't matter
-						uniform = !range.boundaryChanged || mutationBoundaryKey != u.subtreeLowerBound.key;
+						// must be also unchanged, and not mark its page for rewriting, or must be different than the
+						// subtree lower bound key so that it doesn't matter
+						uniform = (!range.boundaryChanged && !range.rewritePage) ||
+						          mutationBoundaryKey != u.subtreeLowerBound.key;
+					}
+
+					// A replaced range is only uniformly cleared where it has no bulk records to add
+					if (uniform && range.bulkRecords != nullptr) {
+						auto bulk = range.bulkRecordsWithin(
+						    mutationBoundaryKey, u.subtreeLowerBound.key, u.subtreeUpperBound.key);
+						uniform = bulk.first == bulk.second;
 					}
 
 					// If u's subtree is either all cleared or all unchanged
@@ -7282,7 +7888,8 @@ private:
 						// include sibling subtrees also covered by (mBegin, mEnd) so we can not recurse to those, too.
 						// If the cursor is valid, u.subtreeUpperBound is the cursor's position, which is >= mEnd.key().
 						// If equal, no range expansion is possible.
-						if (cursor.valid() && mEnd.key() != u.subtreeUpperBound.key) {
+						// Sibling subtrees of a replaced range could have bulk records to add, so it is not expanded.
+						if (cursor.valid() && mEnd.key() != u.subtreeUpperBound.key && range.bulkRecords == nullptr) {
 							// TODO:  If cursor hints are available, use (cursor, 1)
 							cursor.seekLessThanOrEqual(mEnd.key(), update->skipLen);
 
@@ -7506,7 +8113,8 @@ private:
 						                                       update->decodeLowerBound,
 						                                       update->decodeUpperBound)));
 
-						update->updatedInPlace(newID, btPage, newID.size() * self->m_blockSize);
+						update->updatedInPlace(
+						    newID, btPage, self->logicalBlockCount(pageCopy.getPtr()) * self->m_blockSize);
 						debug_printf("%s Internal node updated in-place, returning slice:\n", context.c_str());
 						debug_print(addPrefix(context, update->toString()));
 					} else {
@@ -7683,6 +8291,9 @@ public:
 		Reference<IPagerSnapshot> pager;
 		bool valid;
 		std::vector<PathEntry> path;
+		// The height 2 page whose children were last prefetched, and the number of pages prefetched so far
+		const ArenaPage* prefetchedParent;
+		int prefetchedPages;
 
 	public:
 		BTreeCursor() : reason(PagerEventReasons::MAXEVENTREASONS) {}
@@ -7690,6 +8301,9 @@ public:
 		bool initialized() const { return pager.isValid(); }
 		bool isValid() const { return valid; }
 
+		// The leaf page the cursor is positioned in, only usable if the cursor is valid
+		const PathEntry& leaf() const { return path.back(); }
+
 		// path entries at dumpHeight or below will have their entire pages printed
 		std::string toString(int dumpHeight = 0) const {
 			std::string r = format("{ptr=%p reason=%s %s ",
@@ -7795,6 +8409,8 @@ public:
 			path.clear();
 			path.reserve(6);
 			valid = false;
+			prefetchedParent = nullptr;
+			prefetchedPages = 0;
 			return root.empty() ? Void() : pushPage(root);
 		}
 
@@ -7856,12 +8472,22 @@ public:
 		Future<Void> seekGTE(RedwoodRecordRef query) { return seekGTE_impl(this, query); }
 
 		// Start fetching sibling nodes in the forward or backward direction, stopping after recordLimit or byteLimit
+		// or REDWOOD_KVSTORE_RANGE_PREFETCH_MAX_PAGES pages for this cursor. If the siblings run out before that, the
+		// next page at level 2 is fetched as well so that the scan does not stall on it when it crosses over.
+		// A scan can call this each time it moves to a new leaf, the siblings under a parent are only fetched once.
 		void prefetch(KeyRef rangeEnd, bool directionForward, int recordLimit, int byteLimit) {
 			// Prefetch scans level 2 so if there are less than 2 nodes in the path there is no level 2
 			if (path.size() < 2) {
 				return;
 			}
 
+			const ArenaPage* parent = path[path.size() - 2].page.getPtr();
+			if (parent == prefetchedParent) {
+				return;
+			}
+			prefetchedParent = parent;
+			const int maxPages = SERVER_KNOBS->REDWOOD_KVSTORE_RANGE_PREFETCH_MAX_PAGES;
+
 			auto firstLeaf = path.back().btPage();
 
 			// We know the first leaf's record count, so assume they are all relevant to the query,
@@ -7880,21 +8506,32 @@ public:
 			BTreePage::BinaryTree::Cursor c = path[path.size() - 2].cursor;
 			ASSERT(path[path.size() - 2].btPage()->height == 2);
 
+			// Whether the siblings ran out before the end of the range
+			bool parentExhausted = false;
+
 			// The loop conditions are split apart into different if blocks for readability.
 			// While query limits are not exceeded
-			while (recordsRead < recordLimit && bytesRead < byteLimit) {
+			while (recordsRead < recordLimit && bytesRead < byteLimit && prefetchedPages < maxPages) {
 				// If prefetching right siblings
 				if (directionForward) {
 					// If there is no right sibling or its lower boundary is greater
 					// or equal to than the range end then stop.
-					if (!c.moveNext() || c.get().key >= rangeEnd) {
+					if (!c.moveNext()) {
+						parentExhausted = true;
+						break;
+					}
+					if (c.get().key >= rangeEnd) {
 						break;
 					}
 				} else {
 					// Prefetching left siblings
 					// If the current leaf lower boundary is less than or equal to the range end
 					// or there is no left sibling then stop
-					if (c.get().key <= rangeEnd || !c.movePrev()) {
+					if (c.get().key <= rangeEnd) {
+						break;
+					}
+					if (!c.movePrev()) {
+						parentExhausted = true;
 						break;
 					}
 				}
@@ -7905,10 +8542,27 @@ public:
 					if (childPage.size() > 0)
 						preLoadPage(pager.getPtr(), childPage, ioLeafPriority);
 					recordsRead += estRecordsPerPage;
+					prefetchedPages += childPage.size();
 					// Use sibling node capacity as an estimate of bytes read.
 					bytesRead += childPage.size() * this->btree->m_blockSize;
 				}
 			}
+
+			// Look ahead across the boundary of the parent, its children will be prefetched once the scan gets there
+			if (parentExhausted && path.size() >= 3 && recordsRead < recordLimit && bytesRead < byteLimit &&
+			    prefetchedPages < maxPages) {
+				BTreePage::BinaryTree::Cursor up = path[path.size() - 3].cursor;
+				bool moved = directionForward ? up.moveNext() : up.get().key > rangeEnd && up.movePrev();
+				// There should never be two internal page entries without child pages in a row
+				if (moved && !up.get().value.present()) {
+					moved = directionForward ? up.moveNext() : up.movePrev();
+				}
+				if (moved && up.get().value.present() && (!directionForward || up.get().key < rangeEnd)) {
+					BTreeNodeLinkRef parentPage = up.get().getChildPage();
+					preLoadPage(pager.getPtr(), parentPage, ioLeafPriority);
+					prefetchedPages += parentPage.size();
+				}
+			}
 		}
 
 		ACTOR Future<Void> seekLT_impl(BTreeCursor* self, RedwoodRecordRef query) {
@@ -7983,6 +8637,32 @@ public:
 
 		Future<Void> moveNext() { return path.empty() ? Void() : move_impl(this, true); }
 		Future<Void> movePrev() { return path.empty() ? Void() : move_impl(this, false); }
+
+		// The approximate fraction of the tree before the cursor, from the position of each page on its path among
+		// its siblings, assuming sibling subtrees are about the same size. An invalid cursor is past the end.
+		double approximatePosition() const {
+			if (!valid) {
+				return 1.0;
+			}
+			double position = 0;
+			double scale = 1;
+			for (const PathEntry& entry : path) {
+				int count = entry.btPage()->tree()->numItems;
+				if (count == 0) {
+					break;
+				}
+				int index = 0;
+				BTreePage::BinaryTree::Cursor c = entry.cursor;
+				c.moveFirst();
+				while (c.valid() && !(c == entry.cursor)) {
+					++index;
+					c.moveNext();
+				}
+				position += scale * std::min(index, count) / count;
+				scale /= count;
+			}
+			return position;
+		}
 	};
 
 	Future<Void> initBTreeCursor(BTreeCursor* cursor,
@@ -8007,6 +8687,65 @@ public:
 
 		return cursor->init(this, reason, options, snapshot, root);
 	}
+
+	// Walks the leaf pages of the latest committed version in key order, at most REDWOOD_COMPACTION_SCAN_RATE pages per
+	// second, and marks those in which erased records take up too much space to be rewritten by the next commit.
+	// In-place page updates only flag records as erased, so without a rewrite the space stays allocated in every later
+	// version of the page and is paid for by every read and scan of it.
+	ACTOR static Future<Void> compactPages(VersionedBTree* self) {
+		state Key position;
+		state double passStart = now();
+		state int64_t passScanned = 0;
+		state int64_t passRewritten = 0;
+		state int64_t passDeletedBytes = 0;
+
+		loop {
+			wait(delay(1.0 / SERVER_KNOBS->REDWOOD_COMPACTION_SCAN_RATE));
+
+			state BTreeCursor cur;
+			wait(self->initBTreeCursor(&cur, self->getLastCommittedVersion(), PagerEventReasons::LazyClear));
+			wait(cur.seekGTE(RedwoodRecordRef(position)));
+
+			if (!cur.isValid()) {
+				TraceEvent("RedwoodCompactionPass", self->m_logID)
+				    .detail("Name", self->m_name)
+				    .detail("PagesScanned", passScanned)
+				    .detail("PagesRewritten", passRewritten)
+				    .detail("DeletedBytes", passDeletedBytes)
+				    .detail("Elapsed", now() - passStart);
+				// Small trees are not walked again more often than the minimum pass interval
+				wait(delay(std::max(0.0, passStart + SERVER_KNOBS->REDWOOD_COMPACTION_MIN_PASS_INTERVAL - now())));
+				position = Key();
+				passStart = now();
+				passScanned = passRewritten = passDeletedBytes = 0;
+				continue;
+			}
+
+			const BTreePage* btPage = cur.leaf().btPage();
+			const auto* tree = btPage->tree();
+			BTreePage::BinaryTree::Cursor c = cur.leaf().cursor;
+			++passScanned;
+			++g_redwoodMetrics.metric.compactPageScan;
+
+			if (tree->nodeBytesDeleted > 0 &&
+			    tree->nodeBytesDeleted >= SERVER_KNOBS->REDWOOD_COMPACTION_MIN_DELETED_FRACTION * tree->nodeBytesUsed) {
+				c.moveFirst();
+				debug_printf("Compaction: marking leaf starting at %s with %d of %d bytes deleted\n",
+				             c.get().key.printable().c_str(),
+				             tree->nodeBytesDeleted,
+				             tree->nodeBytesUsed);
+				self->m_pBuffer->insert(c.get().key).mutation().rewritePage = true;
+				++passRewritten;
+				passDeletedBytes += tree->nodeBytesDeleted;
+				++g_redwoodMetrics.metric.compactPageRewrite;
+				g_redwoodMetrics.metric.compactDeletedBytes += tree->nodeBytesDeleted;
+			}
+
+			// Continue after the last record of this leaf
+			c.moveLast();
+			position = keyAfter(c.get().key);
+		}
+	}
 };
 
 #include "fdbserver/art_impl.h"
@@ -8131,6 +8870,39 @@ public:
 
 	StorageBytes getStorageBytes() const override { return m_tree->getStorageBytes(); }
 
+	Future<std::vector<int64_t>> getApproximateRangeSizes(Standalone<VectorRef<KeyRef>> boundaries) override {
+		return catchError(getApproximateRangeSizes_impl(this, boundaries));
+	}
+
+	// Each range is the fraction of the tree between the positions of its boundaries, times the space the tree uses.
+	// This costs a seek per boundary, which is mostly cached since the upper levels of the tree are.
+	ACTOR static Future<std::vector<int64_t>> getApproximateRangeSizes_impl(
+	    KeyValueStoreRedwood* self,
+	    Standalone<VectorRef<KeyRef>> boundaries) {
+		state VersionedBTree::BTreeCursor cur;
+		wait(self->m_tree->initBTreeCursor(&cur, self->m_tree->getLastCommittedVersion(), PagerEventReasons::MetaData));
+
+		state std::vector<double> positions;
+		state int i = 0;
+		for (; i < boundaries.size(); i++) {
+			wait(cur.seekGTE(boundaries[i]));
+			positions.push_back(cur.approximatePosition());
+		}
+
+		const int64_t used = self->getStorageBytes().used;
+		std::vector<int64_t> sizes;
+		for (int j = 0; j + 1 < positions.size(); j++) {
+			sizes.push_back(std::max(0.0, positions[j + 1] - positions[j]) * used);
+		}
+		return sizes;
+	}
+
+	// Over the current metrics interval, once it has seen enough lookups to mean something
+	double getCacheHitRate() const override {
+		const double lookups = double(g_redwoodMetrics.metric.pagerCacheHit) + g_redwoodMetrics.metric.pagerCacheMiss;
+		return lookups >= 100 ? g_redwoodMetrics.metric.pagerCacheHit / lookups : -1.0;
+	}
+
 	Future<Void> getError() const override { return delayed(getErrorNoDelay()); }
 
 	Future<Void> getErrorNoDelay() const { return m_errorPromise.getFuture() || m_tree->getError(); };
@@ -8145,6 +8917,15 @@ public:
 		m_tree->set(keyValue);
 	}
 
+	// Unlike the default implementation, data is handed to the tree as a whole and merged into leaf pages on commit
+	Future<Void> replaceRange(KeyRange range, Standalone<VectorRef<KeyValueRef>> data) override {
+		debug_printf("REPLACERANGE %s records=%d\n", printable(range).c_str(), data.size());
+		if (!range.empty()) {
+			m_tree->replaceRange(range, data);
+		}
+		return Void();
+	}
+
 	Future<RangeResult> readRange(KeyRangeRef keys,
 	                              int rowLimit,
 	                              int byteLimit,
@@ -8231,6 +9012,9 @@ public:
 				}
 				cur.popPath();
 				wait(cur.moveNext());
+				if (self->prefetch && cur.isValid()) {
+					cur.prefetch(keys.end, true, rowLimit, byteLimit - accumulatedBytes);
+				}
 			}
 		} else {
 			f = cur.seekLT(keys.end);
@@ -8286,6 +9070,9 @@ public:
 				}
 				cur.popPath();
 				wait(cur.movePrev());
+				if (self->prefetch && cur.isValid()) {
+					cur.prefetch(keys.begin, false, -rowLimit, byteLimit - accumulatedBytes);
+				}
 			}
 		}
 
@@ -8863,6 +9650,8 @@ void RedwoodMetrics::getFields(TraceEvent* e, std::string* s, bool skipZeroes) {
 		                                               { "OpSetValueBytes", metric.opSetValueBytes },
 		                                               { "OpClear", metric.opClear },
 		                                               { "OpClearKey", metric.opClearKey },
+		                                               { "OpReplaceRange", metric.opReplaceRange },
+		                                               { "OpReplaceRangeRecords", metric.opReplaceRangeRecords },
 		                                               { "", 0 },
 		                                               { "OpGet", metric.opGet },
 		                                               { "OpGetRange", metric.opGetRange },
@@ -8878,11 +9667,33 @@ void RedwoodMetrics::getFields(TraceEvent* e, std::string* s, bool skipZeroes) {
 		                                               { "PagerEvictUnhit", metric.pagerEvictUnhit },
 		                                               { "PagerEvictFail", metric.pagerEvictFail },
 		                                               { "", 0 },
+		                                               { "PagerCacheHitProtected", metric.pagerCacheHitProtected },
+		                                               { "PagerCacheHitProbation", metric.pagerCacheHitProbation },
+		                                               { "PagerCacheHitInternal", metric.pagerCacheHitInternal },
+		                                               { "PagerCachePromote", metric.pagerCachePromote },
+		                                               { "PagerCacheColdInsert", metric.pagerCacheColdInsert },
+		                                               { "", 0 },
 		                                               { "PagerRemapFree", metric.pagerRemapFree },
 		                                               { "PagerRemapCopy", metric.pagerRemapCopy },
 		                                               { "PagerRemapSkip", metric.pagerRemapSkip },
+		                                               { "PagerRemapThrottle", metric.pagerRemapThrottle },
+		                                               { "PagerRemapThrottleMS", metric.pagerRemapThrottleMS },
 		                                               { "", 0 },
 		                                               { "ReadRequestDecryptTimeNS", metric.readRequestDecryptTimeNS },
+		                                               { "PageDecode", metric.pageDecode },
+		                                               { "PageDecodeTimeNS", metric.pageDecodeTimeNS },
+		                                               { "PageEncode", metric.pageEncode },
+		                                               { "PageEncodeTimeNS", metric.pageEncodeTimeNS },
+		                                               { "", 0 },
+		                                               { "PageCompress", metric.pageCompress },
+		                                               { "PageCompressRawBytes", metric.pageCompressRawBytes },
+		                                               { "PageCompressBytes", metric.pageCompressBytes },
+		                                               { "PageDecompress", metric.pageDecompress },
+		                                               { "PageDecompressTimeNS", metric.pageDecompressTimeNS },
+		                                               { "", 0 },
+		                                               { "CompactPageScan", metric.compactPageScan },
+		                                               { "CompactPageRewrite", metric.compactPageRewrite },
+		                                               { "CompactDeletedBytes", metric.compactDeletedBytes },
 		                                               { "", 0 } };
 
 	double elapsed = now() - startTime;
@@ -9016,6 +9827,39 @@ void RedwoodMetrics::getIOLockFields(TraceEvent* e, std::string* s) {
 	}
 }
 
+void RedwoodMetrics::getPageCacheFields(TraceEvent* e, std::string* s) {
+	if (!internalPageCacheSize)
+		return;
+
+	auto [bytes, count, limit] = internalPageCacheSize();
+
+	if (e != nullptr) {
+		e->detail("PageCacheInternalBytes", bytes);
+		e->detail("PageCacheInternalPages", count);
+		e->detail("PageCacheInternalLimit", limit);
+	}
+
+	if (s != nullptr) {
+		*s += "\n";
+		*s += format("%-15s %-8" PRId64 "    ", "PageCacheInternalBytes", bytes);
+		*s += format("%-15s %-8" PRId64 "    ", "PageCacheInternalPages", count);
+		*s += format("%-15s %-8" PRId64 "    ", "PageCacheInternalLimit", limit);
+	}
+}
+
+void RedwoodMetrics::getRemapCleanupFields(TraceEvent* e, std::string* s) {
+	if (e != nullptr) {
+		e->detail("RemapQueueEntries", remapQueueEntries);
+		e->detail("RemapQueueLagEntries", remapQueueLagEntries);
+	}
+
+	if (s != nullptr) {
+		*s += "\n";
+		*s += format("%-15s %-8" PRId64 "    ", "RemapQueueEntries", remapQueueEntries);
+		*s += format("%-15s %-8" PRId64 "    ", "RemapQueueLagEntries", remapQueueLagEntries);
+	}
+}
+
 TEST_CASE("/redwood/correctness/unit/RedwoodRecordRef") {
 	ASSERT(RedwoodRecordRef::Delta::LengthFormatSizes[0] == 3);
 	ASSERT(RedwoodRecordRef::Delta::LengthFormatSizes[1] == 4);
@@ -10108,6 +10952,84 @@ TEST_CASE(":/redwood/pager/ArenaPage") {
 
 namespace {
 
+struct TestCacheObject {
+	bool evictable() const { return true; }
+	Future<Void> onEvictable() const { return Void(); }
+	Future<Void> cancel() const { return Void(); }
+};
+
+} // namespace
+
+// Pages hit more than once by point reads must survive a scan much larger than the cache
+TEST_CASE("/redwood/pager/ObjectCache/scanResistance") {
+	typedef ObjectCache<int, TestCacheObject> CacheT;
+	const int cacheSize = 100;
+	const int hotCount = 5;
+	CacheT::Evictor evictor(cacheSize);
+	CacheT cache(&evictor);
+
+	for (int pass = 0; pass < 2; ++pass) {
+		for (int i = 0; i < hotCount; ++i) {
+			cache.get(i, 1);
+		}
+	}
+
+	const bool cold = deterministicRandom()->coinflip();
+	for (int i = hotCount; i < hotCount + 10 * cacheSize; ++i) {
+		cache.get(i, 1, false, cold);
+		// Scans can visit the same page twice, such as when a prefetched page is then read
+		cache.get(i, 1, false, cold);
+		ASSERT(evictor.getSizeUsed() <= cacheSize);
+	}
+
+	if (cold && SERVER_KNOBS->REDWOOD_PAGE_CACHE_PROTECTED_FRACTION * cacheSize >= hotCount) {
+		for (int i = 0; i < hotCount; ++i) {
+			ASSERT(cache.getIfExists(i) != nullptr);
+		}
+		ASSERT(evictor.getProtectedSize() == hotCount);
+	}
+	ASSERT(evictor.getProtectedSize() <= SERVER_KNOBS->REDWOOD_PAGE_CACHE_PROTECTED_FRACTION * cacheSize);
+
+	Future<Void> cleared = cache.clear();
+	ASSERT(cleared.isReady());
+	ASSERT(evictor.empty());
+	return Void();
+}
+
+// Internal pages within the internal budget must survive any amount of leaf page traffic
+TEST_CASE("/redwood/pager/ObjectCache/internalSegment") {
+	typedef ObjectCache<int, TestCacheObject> CacheT;
+	const int cacheSize = 100;
+	const int internalCount = 5;
+	CacheT::Evictor evictor(cacheSize);
+	CacheT cache(&evictor);
+
+	for (int i = 0; i < internalCount; ++i) {
+		cache.get(i, 1, false, false, true);
+	}
+
+	for (int i = internalCount; i < internalCount + 10 * cacheSize; ++i) {
+		cache.get(i, 1);
+		cache.get(i, 1);
+		ASSERT(evictor.getSizeUsed() <= cacheSize);
+	}
+
+	ASSERT(evictor.getInternalSize() <= evictor.getInternalLimit());
+	if (evictor.getInternalLimit() >= internalCount) {
+		for (int i = 0; i < internalCount; ++i) {
+			ASSERT(cache.getIfExists(i) != nullptr);
+		}
+		ASSERT(evictor.getInternalCount() == internalCount);
+	}
+
+	Future<Void> cleared = cache.clear();
+	ASSERT(cleared.isReady());
+	ASSERT(evictor.empty());
+	return Void();
+}
+
+namespace {
+
 RandomKeyGenerator getDefaultKeyGenerator(int maxKeySize) {
 	ASSERT(maxKeySize > 0);
 	RandomKeyGenerator keyGen;
@@ -10183,6 +11105,8 @@ TEST_CASE("Lredwood/correctness/btree") {
 	    params.getDouble("clearKnownNodeBoundaryProbability").orDefault(deterministicRandom()->random01() * .1);
 	state double clearPostSetProbability =
 	    params.getDouble("clearPostSetProbability").orDefault(deterministicRandom()->random01() * .1);
+	state double replaceRangeProbability =
+	    params.getDouble("replaceRangeProbability").orDefault(deterministicRandom()->random01() * .5);
 	state double coldStartProbability =
 	    params.getDouble("coldStartProbability").orDefault(pagerMemoryOnly ? 0 : (deterministicRandom()->random01()));
 	state double advanceOldVersionProbability =
@@ -10253,6 +11177,15 @@ TEST_CASE("Lredwood/correctness/btree") {
 		keyProvider = makeReference<XOREncryptionKeyProvider_TestOnly>(file);
 	}
 
+	state std::string pageCompression =
+	    params.get("pageCompression").orDefault(CompressionUtils::toString(CompressionUtils::getRandomFilter()));
+	g_knobs.setKnob("redwood_page_compression_filter", KnobValueRef::create(pageCompression));
+	state double compactionScanRate =
+	    params.getDouble("compactionScanRate")
+	        .orDefault(deterministicRandom()->coinflip() ? 0 : deterministicRandom()->randomInt(1, 1000));
+	g_knobs.setKnob("redwood_compaction_scan_rate", KnobValueRef::create(compactionScanRate));
+	g_knobs.setKnob("redwood_compaction_min_pass_interval", KnobValueRef::create(double(0)));
+
 	printf("\n");
 	printf("file: %s\n", file.c_str());
 	printf("maxPageOps: %" PRId64 "\n", maxPageOps);
@@ -10263,6 +11196,8 @@ TEST_CASE("Lredwood/correctness/btree") {
 	printf("shortTest: %d\n", shortTest);
 	printf("encodingType: %d\n", encodingType);
 	printf("domainMode: %d\n", encryptionDomainMode);
+	printf("pageCompression: %s\n", pageCompression.c_str());
+	printf("compactionScanRate: %f\n", compactionScanRate);
 	printf("pageSize: %d\n", pageSize);
 	printf("extentSize: %d\n", extentSize);
 	printf("keyGenerator: %s\n", keyGen.toString().c_str());
@@ -10274,6 +11209,7 @@ TEST_CASE("Lredwood/correctness/btree") {
 	printf("clearKnownNodeBoundaryProbability: %f\n", clearKnownNodeBoundaryProbability);
 	printf("clearSingleKeyProbability: %f\n", clearSingleKeyProbability);
 	printf("clearPostSetProbability: %f\n", clearPostSetProbability);
+	printf("replaceRangeProbability: %f\n", replaceRangeProbability);
 	printf("coldStartProbability: %f\n", coldStartProbability);
 	printf("maxColdStarts: %d\n", maxColdStarts);
 	printf("advanceOldVersionProbability: %f\n", advanceOldVersionProbability);
@@ -10420,7 +11356,36 @@ TEST_CASE("Lredwood/correctness/btree") {
 				}
 			}
 
-			btree->clear(range);
+			// Sometimes replace the range with new records instead of just clearing it
+			if (!range.singleKeyRange() && deterministicRandom()->random01() < replaceRangeProbability) {
+				std::set<Key> newKeys;
+				int count = deterministicRandom()->randomInt(0, 100);
+				for (int i = 0; i < count; ++i) {
+					Key k = deterministicRandom()->coinflip()
+					            ? keyGen.next()
+					            : range.begin.withSuffix(deterministicRandom()->randomAlphaNumeric(
+					                  deterministicRandom()->randomInt(1, 8)));
+					if (range.contains(k)) {
+						newKeys.insert(k);
+					}
+				}
+				Standalone<VectorRef<KeyValueRef>> records;
+				for (auto const& k : newKeys) {
+					records.push_back_deep(records.arena(), KeyValueRef(k, valGen.next()));
+					written[std::make_pair(k.toString(), version)] = records.back().value.toString();
+					keys.insert(k);
+					mutationBytes += records.back().expectedSize();
+					mutationBytesThisCommit += records.back().expectedSize();
+				}
+				debug_printf("      Mutation:  Replace '%s' to '%s' with %d records @%" PRId64 "\n",
+				             start.toString().c_str(),
+				             end.toString().c_str(),
+				             records.size(),
+				             version);
+				btree->replaceRange(range, records);
+			} else {
+				btree->clear(range);
+			}
 
 			// Sometimes set the range start after the clear
 			if (deterministicRandom()->random01() < clearPostSetProbability) {
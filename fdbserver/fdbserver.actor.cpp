@@ -106,6 +106,9 @@
 #define NOMINMAX
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
+#else
+#include <sys/wait.h>
+#include <unistd.h>
 #endif
 
 #if __has_include("SwiftModules/FDBServer")
@@ -134,7 +137,8 @@ enum {
 	OPT_METRICSPREFIX, OPT_LOGGROUP, OPT_LOCALITY, OPT_IO_TRUST_SECONDS, OPT_IO_TRUST_WARN_ONLY, OPT_FILESYSTEM, OPT_PROFILER_RSS_SIZE, OPT_KVFILE,
 	OPT_TRACE_FORMAT, OPT_WHITELIST_BINPATH, OPT_BLOB_CREDENTIAL_FILE, OPT_CONFIG_PATH, OPT_USE_TEST_CONFIG_DB, OPT_NO_CONFIG_DB, OPT_FAULT_INJECTION, OPT_PROFILER, OPT_PRINT_SIMTIME,
 	OPT_FLOW_PROCESS_NAME, OPT_FLOW_PROCESS_ENDPOINT, OPT_IP_TRUSTED_MASK, OPT_KMS_CONN_DISCOVERY_URL_FILE, OPT_KMS_CONNECTOR_TYPE, OPT_KMS_REST_ALLOW_NOT_SECURE_CONECTION, OPT_KMS_CONN_VALIDATION_TOKEN_DETAILS,
-	OPT_KMS_CONN_GET_ENCRYPTION_KEYS_ENDPOINT, OPT_KMS_CONN_GET_LATEST_ENCRYPTION_KEYS_ENDPOINT, OPT_KMS_CONN_GET_BLOB_METADATA_ENDPOINT, OPT_NEW_CLUSTER_KEY, OPT_AUTHZ_PUBLIC_KEY_FILE, OPT_USE_FUTURE_PROTOCOL_VERSION
+	OPT_KMS_CONN_GET_ENCRYPTION_KEYS_ENDPOINT, OPT_KMS_CONN_GET_LATEST_ENCRYPTION_KEYS_ENDPOINT, OPT_KMS_CONN_GET_BLOB_METADATA_ENDPOINT, OPT_NEW_CLUSTER_KEY, OPT_AUTHZ_PUBLIC_KEY_FILE, OPT_USE_FUTURE_PROTOCOL_VERSION,
+	OPT_SEED_COUNT, OPT_SEED_JOBS
 };
 
 CSimpleOpt::SOption g_rgOptions[] = {
@@ -176,6 +180,8 @@ CSimpleOpt::SOption g_rgOptions[] = {
 	{ OPT_RESTARTING,            "--restarting",                SO_NONE },
 	{ OPT_RANDOMSEED,            "-s",                          SO_REQ_SEP },
 	{ OPT_RANDOMSEED,            "--seed",                      SO_REQ_SEP },
+	{ OPT_SEED_COUNT,            "--seed-count",                SO_REQ_SEP },
+	{ OPT_SEED_JOBS,             "--seed-jobs",                 SO_REQ_SEP },
 	{ OPT_KEY,                   "-k",                          SO_REQ_SEP },
 	{ OPT_KEY,                   "--key",                       SO_REQ_SEP },
 	{ OPT_MEMLIMIT,              "-m",                          SO_REQ_SEP },
@@ -664,8 +670,8 @@ static void printUsage(const char* name, bool devhelp) {
 	                 " Sets the LogGroup field with the specified value for all"
 	                 " events in the trace output (defaults to `default').");
 	printOptionUsage("--trace-format FORMAT",
-	                 " Select the format of the log files. xml (the default) and json"
-	                 " are supported.");
+	                 " Select the format of the log files. xml (the default), json"
+	                 " and binary are supported.");
 	printOptionUsage("--tracer       TRACER",
 	                 " Select a tracer for transaction tracing. Currently disabled"
 	                 " (the default) and log_file are supported.");
@@ -721,6 +727,10 @@ static void printUsage(const char* name, bool devhelp) {
 		                 "unit tests to run as a search prefix.");
 		printOptionUsage("-R, --restarting", " Restart a previous simulation that was cleanly shut down.");
 		printOptionUsage("-s SEED, --seed SEED", " Random seed.");
+		printOptionUsage("--seed-count COUNT",
+		                 " Simulate COUNT consecutive seeds starting at SEED, each in its own subdirectory `seed-N' of "
+		                 "the working directory. Defaults to 1.");
+		printOptionUsage("--seed-jobs JOBS", " Number of seeds simulated at the same time. Defaults to 1.");
 		printOptionUsage("-k KEY, --key KEY", "Target key for search role.");
 		printOptionUsage("--kvfile FILE",
 		                 "Input file (SQLite database file) for use by the 'kvfilegeneratesums', "
@@ -1068,6 +1078,8 @@ struct CLIOptions {
 
 	ServerRole role = ServerRole::FDBD;
 	uint32_t randomSeed = platform::getRandomSeed();
+	int seedCount = 1;
+	int seedJobs = 1;
 
 	const char* testFile = "tests/default.txt";
 	std::string kvFile;
@@ -1520,6 +1532,18 @@ private:
 				}
 				break;
 			}
+			case OPT_SEED_COUNT:
+			case OPT_SEED_JOBS: {
+				char* end;
+				int n = strtol(args.OptionArg(), &end, 0);
+				if (*end || n < 1) {
+					fprintf(stderr, "ERROR: Could not parse %s `%s'\n", args.OptionText(), args.OptionArg());
+					printHelpTeaser(argv[0]);
+					flushAndExit(FDB_EXIT_ERROR);
+				}
+				(args.OptionId() == OPT_SEED_COUNT ? seedCount : seedJobs) = n;
+				break;
+			}
 			case OPT_MACHINEID: {
 				zoneId = std::string(args.OptionArg());
 				break;
@@ -1923,6 +1947,76 @@ private:
 };
 
 // Returns true iff validation is successful
+// Simulates opts.seedCount consecutive seeds, at most opts.seedJobs at a time, each in a child forked before any seed
+// dependent state (knobs, the simulator, trace files) is set up, so that the children share the cost of starting the
+// process. Each child returns from here with its seed and the working directory `seed-N'; the parent exits once all
+// of them have finished, with an error if any of them failed.
+void forkSimulationSeeds(CLIOptions& opts) {
+#ifdef _WIN32
+	fprintf(stderr, "ERROR: --seed-count is not supported on Windows\n");
+	flushAndExit(FDB_EXIT_ERROR);
+#else
+	// The test file is usually given relative to the working directory the children leave
+	static std::string testFile;
+	testFile = abspath(opts.testFile);
+
+	std::map<pid_t, uint32_t> running;
+	std::vector<uint32_t> failed;
+	int started = 0;
+	while (started < opts.seedCount || !running.empty()) {
+		if (started < opts.seedCount && running.size() < (size_t)opts.seedJobs) {
+			uint32_t seed = opts.randomSeed + started++;
+			std::string directory = format("seed-%u", seed);
+			platform::createDirectory(directory);
+			fflush(stdout);
+			fflush(stderr);
+			pid_t pid = fork();
+			if (pid == 0) {
+				if (chdir(directory.c_str()) != 0) {
+					fprintf(stderr, "ERROR: Could not change to directory `%s'\n", directory.c_str());
+					_exit(FDB_EXIT_ERROR);
+				}
+				opts.randomSeed = seed;
+				opts.testFile = testFile.c_str();
+				return;
+			}
+			if (pid < 0) {
+				fprintf(stderr, "ERROR: Could not fork to simulate seed %u: %s\n", seed, strerror(errno));
+				flushAndExit(FDB_EXIT_ERROR);
+			}
+			running[pid] = seed;
+			continue;
+		}
+
+		int status;
+		pid_t pid = waitpid(-1, &status, 0);
+		if (pid < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			fprintf(stderr, "ERROR: Could not wait for simulated seeds: %s\n", strerror(errno));
+			flushAndExit(FDB_EXIT_ERROR);
+		}
+		auto seed = running.find(pid);
+		if (seed == running.end()) {
+			continue;
+		}
+		bool passed = WIFEXITED(status) && WEXITSTATUS(status) == FDB_EXIT_SUCCESS;
+		printf("Seed %u %s\n", seed->second, passed ? "passed" : "FAILED");
+		if (!passed) {
+			failed.push_back(seed->second);
+		}
+		running.erase(seed);
+	}
+
+	printf("%d seeds simulated, %zu failed\n", opts.seedCount, failed.size());
+	for (uint32_t seed : failed) {
+		printf("  seed-%u\n", seed);
+	}
+	flushAndExit(failed.empty() ? FDB_EXIT_SUCCESS : FDB_EXIT_ERROR);
+#endif
+}
+
 bool validateSimulationDataFiles(std::string const& dataFolder, bool isRestarting) {
 	std::vector<std::string> files = platform::listFiles(dataFolder);
 	if (!isRestarting) {
@@ -1976,6 +2070,14 @@ int main(int argc, char* argv[]) {
 		auto opts = CLIOptions::parseArgs(argc, argv);
 		const auto role = opts.role;
 
+		if (opts.seedCount > 1) {
+			if (role != ServerRole::Simulation) {
+				fprintf(stderr, "ERROR: --seed-count can only be used with the simulation role\n");
+				flushAndExit(FDB_EXIT_ERROR);
+			}
+			forkSimulationSeeds(opts);
+		}
+
 		if (role == ServerRole::Simulation) {
 			printf("Random seed is %u...\n", opts.randomSeed);
 			bindDeterministicRandomToOpenssl();
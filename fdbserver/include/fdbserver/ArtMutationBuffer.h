@@ -112,6 +112,12 @@ public:
 		return T(arena, object);
 	}
 
+	// Return a pointer to records, which stay valid for the lifetime of arena without being copied
+	const VectorRef<KeyValueRef>* holdInArena(const Standalone<VectorRef<KeyValueRef>>& records) {
+		arena.dependsOn(records.arena());
+		return new (arena) VectorRef<KeyValueRef>(records);
+	}
+
 	const_iterator upper_bound(const KeyRef& k) const { return const_iterator(mutations->upper_bound(k)); }
 
 	const_iterator lower_bound(const KeyRef& k) const { return const_iterator(mutations->lower_bound(k)); }
@@ -140,6 +146,7 @@ public:
 		--iPrevious;
 		if (iPrevious.mutation().clearAfterBoundary) {
 			ib.mutation().clearAll();
+			ib.mutation().divideBulkRecords(iPrevious.mutation(), boundary);
 		}
 		return ib;
 	}
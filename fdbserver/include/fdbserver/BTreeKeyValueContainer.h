@@ -0,0 +1,562 @@
+/*
+ * BTreeKeyValueContainer.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FDBSERVER_BTREEKEYVALUECONTAINER_H
+#define FDBSERVER_BTREEKEYVALUECONTAINER_H
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "fdbserver/IKeyValueContainer.h"
+#include "flow/Arena.h"
+#include "flow/FastAlloc.h"
+
+// An in-memory B+tree with the same interface as IKeyValueContainer, used by KeyValueStoreMemory when
+// KVS_MEM_USE_BTREE_CONTAINER is set.
+//
+// The tree is laid out for cache locality rather than pointer chasing. Nodes are wide, and every node keeps the
+// length of a prefix shared by all of its keys plus, in a contiguous array, the next four bytes of each key after that
+// prefix ("heads"). Most comparisons during a search are therefore integer compares within a couple of cache lines,
+// and only ties on the head dereference a key. Separators in inner nodes are truncated to the shortest prefix that
+// still divides their children. Each key-value pair is a single allocation holding both strings, and leaves are
+// linked so that range iteration walks arrays instead of the tree.
+class BTreeKeyValueContainer : NonCopyable {
+public:
+	static constexpr int LeafCapacity = 64;
+	static constexpr int InnerCapacity = 64;
+
+private:
+	// A key-value pair stored in one allocation: the two lengths followed by the key and value bytes.
+	struct Entry {
+		int keySize;
+		int valueSize;
+
+		KeyRef key() const { return KeyRef(reinterpret_cast<const uint8_t*>(this + 1), keySize); }
+		ValueRef value() const { return ValueRef(reinterpret_cast<const uint8_t*>(this + 1) + keySize, valueSize); }
+		int allocatedSize() const { return sizeof(Entry) + keySize + valueSize; }
+
+		static Entry* create(StringRef key, StringRef value) {
+			Entry* e = static_cast<Entry*>(allocateFast(sizeof(Entry) + key.size() + value.size()));
+			e->keySize = key.size();
+			e->valueSize = value.size();
+			uint8_t* bytes = reinterpret_cast<uint8_t*>(e + 1);
+			if (key.size()) {
+				memcpy(bytes, key.begin(), key.size());
+			}
+			if (value.size()) {
+				memcpy(bytes + key.size(), value.begin(), value.size());
+			}
+			return e;
+		}
+		void destroy() { freeFast(allocatedSize(), this); }
+	};
+
+	// The bytes following the first prefixLen bytes of key, as a big endian integer padded with zeroes. If the head of
+	// a is less than the head of b then a < b, so only equal heads need a full key comparison.
+	static uint32_t keyHead(StringRef key, int prefixLen) {
+		uint8_t b[4] = { 0, 0, 0, 0 };
+		int n = std::min(4, key.size() - prefixLen);
+		if (n > 0) {
+			memcpy(b, key.begin() + prefixLen, n);
+		}
+		return (uint32_t(b[0]) << 24) | (uint32_t(b[1]) << 16) | (uint32_t(b[2]) << 8) | uint32_t(b[3]);
+	}
+
+	// Returns the index of the first of the n sorted keys returned by keyAt() which is >= key, or > key if upper is
+	// true. All of the keys must share their first prefixLen bytes, and heads[i] must be keyHead(keyAt(i), prefixLen).
+	template <class KeyAt>
+	static int searchKeys(StringRef key, bool upper, int n, int prefixLen, const uint32_t* heads, KeyAt const& keyAt) {
+		if (n == 0) {
+			return 0;
+		}
+		if (prefixLen > 0) {
+			int len = std::min(key.size(), prefixLen);
+			int c = len ? memcmp(key.begin(), keyAt(0).begin(), len) : 0;
+			if (c < 0 || (c == 0 && key.size() < prefixLen)) {
+				return 0;
+			}
+			if (c > 0) {
+				return n;
+			}
+		}
+		uint32_t head = keyHead(key, prefixLen);
+		int lo = 0, hi = n;
+		while (lo < hi) {
+			int mid = (lo + hi) / 2;
+			int c = heads[mid] != head ? (heads[mid] < head ? -1 : 1) : keyAt(mid).compare(key);
+			if (c < 0 || (upper && c == 0)) {
+				lo = mid + 1;
+			} else {
+				hi = mid;
+			}
+		}
+		return lo;
+	}
+
+	static bool hasPrefix(StringRef key, StringRef other, int prefixLen) {
+		return key.size() >= prefixLen && (prefixLen == 0 || memcmp(key.begin(), other.begin(), prefixLen) == 0);
+	}
+
+	struct Inner;
+
+	struct Node {
+		Inner* parent = nullptr;
+		bool isLeaf;
+
+		explicit Node(bool isLeaf) : isLeaf(isLeaf) {}
+	};
+
+	struct Leaf : Node, FastAllocated<Leaf> {
+		Leaf* prev = nullptr;
+		Leaf* next = nullptr;
+		int count = 0;
+		int prefixLen = 0; // The length of a prefix shared by every key in the leaf
+		uint32_t heads[LeafCapacity];
+		Entry* entries[LeafCapacity];
+
+		Leaf() : Node(true) {}
+
+		KeyRef keyAt(int i) const { return entries[i]->key(); }
+		int search(StringRef key, bool upper) const {
+			return searchKeys(key, upper, count, prefixLen, heads, [this](int i) { return keyAt(i); });
+		}
+
+		// Recomputes prefixLen as the longest prefix shared by the first and last (and so every) key, and the heads.
+		void rebuildHeads() {
+			prefixLen = count ? commonPrefixLength(keyAt(0), keyAt(count - 1)) : 0;
+			for (int i = 0; i < count; ++i) {
+				heads[i] = keyHead(keyAt(i), prefixLen);
+			}
+		}
+
+		void insertAt(int pos, Entry* e) {
+			memmove(entries + pos + 1, entries + pos, (count - pos) * sizeof(Entry*));
+			memmove(heads + pos + 1, heads + pos, (count - pos) * sizeof(uint32_t));
+			entries[pos] = e;
+			++count;
+			// A key inserted between two others shares their prefix; only a new first or last key can shorten it.
+			bool atEdge = pos == 0 || pos == count - 1;
+			if (count == 1 || (atEdge && !hasPrefix(e->key(), keyAt(pos == 0 ? 1 : 0), prefixLen))) {
+				rebuildHeads();
+			} else {
+				heads[pos] = keyHead(e->key(), prefixLen);
+			}
+		}
+
+		// Destroys the entries in [from, to) and returns the bytes they accounted for. The prefix remains valid.
+		int64_t eraseRange(int from, int to) {
+			int64_t bytes = 0;
+			for (int i = from; i < to; ++i) {
+				bytes += entries[i]->allocatedSize() + getElementBytes();
+				entries[i]->destroy();
+			}
+			memmove(entries + from, entries + to, (count - to) * sizeof(Entry*));
+			memmove(heads + from, heads + to, (count - to) * sizeof(uint32_t));
+			count -= to - from;
+			return bytes;
+		}
+	};
+
+	struct Inner : Node {
+		int count = 0; // The number of children
+		int prefixLen = 0; // The length of a prefix shared by every separator
+		// separators[i] is greater than every key in children[i] and no greater than any key in children[i + 1]
+		uint32_t heads[InnerCapacity - 1];
+		Key separators[InnerCapacity - 1];
+		Node* children[InnerCapacity];
+
+		Inner() : Node(false) {}
+
+		int childIndex(StringRef key) const {
+			return searchKeys(
+			    key, true, count - 1, prefixLen, heads, [this](int i) -> StringRef { return separators[i]; });
+		}
+		int indexOf(Node const* child) const {
+			for (int i = 0; i < count; ++i) {
+				if (children[i] == child) {
+					return i;
+				}
+			}
+			UNREACHABLE();
+		}
+
+		void rebuildHeads() {
+			int n = count - 1;
+			prefixLen = n > 0 ? commonPrefixLength(separators[0], separators[n - 1]) : 0;
+			for (int i = 0; i < n; ++i) {
+				heads[i] = keyHead(separators[i], prefixLen);
+			}
+		}
+
+		// Inserts child at pos >= 1, with separator as its lower bound.
+		void insertChild(int pos, Key separator, Node* child) {
+			int n = count - 1;
+			std::move_backward(separators + pos - 1, separators + n, separators + n + 1);
+			memmove(heads + pos, heads + pos - 1, (n - pos + 1) * sizeof(uint32_t));
+			memmove(children + pos + 1, children + pos, (count - pos) * sizeof(Node*));
+			separators[pos - 1] = std::move(separator);
+			children[pos] = child;
+			child->parent = this;
+			++count;
+			++n;
+			int s = pos - 1;
+			bool atEdge = s == 0 || s == n - 1;
+			if (n == 1 || (atEdge && !hasPrefix(separators[s], separators[s == 0 ? 1 : 0], prefixLen))) {
+				rebuildHeads();
+			} else {
+				heads[s] = keyHead(separators[s], prefixLen);
+			}
+		}
+
+		// Removes children[pos] along with the separator bounding it from below (or above, for the first child).
+		void removeChild(int pos) {
+			int n = count - 1;
+			if (n > 0) {
+				int s = pos > 0 ? pos - 1 : 0;
+				std::move(separators + s + 1, separators + n, separators + s);
+				separators[n - 1] = Key();
+				memmove(heads + s, heads + s + 1, (n - s - 1) * sizeof(uint32_t));
+			}
+			memmove(children + pos, children + pos + 1, (count - pos - 1) * sizeof(Node*));
+			--count;
+		}
+	};
+
+public:
+	class iterator {
+	public:
+		iterator() = default;
+
+		KeyRef getKey(uint8_t* unused) const { return leaf->keyAt(index); }
+		ValueRef getValue() const { return leaf->entries[index]->value(); }
+
+		iterator& operator++() {
+			if (++index == leaf->count) {
+				leaf = leaf->next;
+				index = 0;
+			}
+			return *this;
+		}
+
+		bool operator==(iterator const& r) const { return leaf == r.leaf && index == r.index; }
+		bool operator!=(iterator const& r) const { return !(*this == r); }
+
+	private:
+		friend class BTreeKeyValueContainer;
+		iterator(Leaf* leaf, int index) : leaf(leaf), index(index) {}
+
+		Leaf* leaf = nullptr;
+		int index = 0;
+	};
+	using const_iterator = iterator;
+
+	BTreeKeyValueContainer() = default;
+	~BTreeKeyValueContainer() { clear(); }
+
+	bool empty() const { return root == nullptr; }
+	void clear() {
+		if (root) {
+			destroyNode(root);
+		}
+		root = nullptr;
+		first = last = nullptr;
+		totalBytes = 0;
+	}
+
+	std::tuple<size_t, size_t, size_t> size() const { return std::make_tuple(0, 0, 0); }
+
+	iterator find(const StringRef& key) const {
+		iterator it = lower_bound(key);
+		return it != end() && it.getKey(nullptr) == key ? it : end();
+	}
+	iterator begin() const { return iterator(first, 0); }
+	iterator cbegin() const { return begin(); }
+	iterator end() const { return iterator(); }
+	iterator cend() const { return end(); }
+
+	iterator lower_bound(const StringRef& key) const { return bound(key, false); }
+	iterator upper_bound(const StringRef& key) const { return bound(key, true); }
+
+	// Like IndexedSet, the entry before begin() is end() and the entry before end() is the last one.
+	iterator previous(iterator i) const {
+		if (i == end()) {
+			return last ? iterator(last, last->count - 1) : end();
+		}
+		if (i.index > 0) {
+			return iterator(i.leaf, i.index - 1);
+		}
+		return i.leaf->prev ? iterator(i.leaf->prev, i.leaf->prev->count - 1) : end();
+	}
+
+	void erase(iterator begin, iterator end) {
+		if (begin == end) {
+			return;
+		}
+		Leaf* leaf = begin.leaf;
+		int from = begin.index;
+		Leaf* survivor = nullptr;
+		while (true) {
+			bool lastLeaf = leaf == end.leaf;
+			Leaf* next = leaf->next;
+			totalBytes -= leaf->eraseRange(from, lastLeaf ? end.index : leaf->count);
+			if (leaf->count == 0) {
+				removeLeaf(leaf);
+			} else if (!survivor) {
+				survivor = leaf;
+			}
+			if (lastLeaf || !next) {
+				break;
+			}
+			leaf = next;
+			from = 0;
+		}
+		if (survivor) {
+			mergeIfUnderfull(survivor);
+		}
+	}
+
+	iterator insert(const StringRef& key, const StringRef& val, bool replaceExisting = true) {
+		if (!root) {
+			Leaf* leaf = new Leaf();
+			root = first = last = leaf;
+		}
+		Leaf* leaf = findLeaf(key);
+		int pos = leaf->search(key, false);
+		if (pos < leaf->count && leaf->keyAt(pos) == key) {
+			if (replaceExisting) {
+				Entry* e = Entry::create(key, val);
+				totalBytes += e->allocatedSize() - leaf->entries[pos]->allocatedSize();
+				leaf->entries[pos]->destroy();
+				leaf->entries[pos] = e;
+			}
+			return iterator(leaf, pos);
+		}
+
+		Entry* e = Entry::create(key, val);
+		totalBytes += e->allocatedSize() + getElementBytes();
+		if (leaf->count == LeafCapacity) {
+			// The truncated separator may fall either side of key, so look the leaf up again rather than by position.
+			splitLeaf(leaf);
+			leaf = findLeaf(key);
+			pos = leaf->search(key, false);
+		}
+		leaf->insertAt(pos, e);
+		return iterator(leaf, pos);
+	}
+
+	// The metric in pairs is ignored; the container accounts for its own element sizes.
+	int insert(const std::vector<std::pair<KeyValueMapPair, uint64_t>>& pairs, bool replaceExisting = true) {
+		for (auto const& p : pairs) {
+			insert(p.first.key, p.first.value, replaceExisting);
+		}
+		return pairs.size();
+	}
+
+	// Only the total is maintained, so a sum to anything but end() walks the leaves in front of it.
+	uint64_t sumTo(iterator to) const {
+		if (to == end()) {
+			return totalBytes;
+		}
+		uint64_t bytes = 0;
+		for (Leaf* leaf = first; leaf; leaf = leaf->next) {
+			int n = leaf == to.leaf ? to.index : leaf->count;
+			for (int i = 0; i < n; ++i) {
+				bytes += leaf->entries[i]->allocatedSize() + getElementBytes();
+			}
+			if (leaf == to.leaf) {
+				break;
+			}
+		}
+		return bytes;
+	}
+
+	// Per element overhead beyond the entry allocation: a slot and a head in a leaf, which is at least half full.
+	static constexpr int getElementBytes() { return 2 * (sizeof(Entry*) + sizeof(uint32_t)); }
+
+private:
+	Node* root = nullptr;
+	Leaf* first = nullptr;
+	Leaf* last = nullptr;
+	int64_t totalBytes = 0;
+
+	Leaf* findLeaf(StringRef key) const {
+		Node* node = root;
+		while (!node->isLeaf) {
+			Inner* inner = static_cast<Inner*>(node);
+			node = inner->children[inner->childIndex(key)];
+		}
+		return static_cast<Leaf*>(node);
+	}
+
+	iterator bound(StringRef key, bool upper) const {
+		if (!root) {
+			return end();
+		}
+		Leaf* leaf = findLeaf(key);
+		int pos = leaf->search(key, upper);
+		if (pos < leaf->count) {
+			return iterator(leaf, pos);
+		}
+		return leaf->next ? iterator(leaf->next, 0) : end();
+	}
+
+	// The shortest prefix of right which is still greater than left.
+	static Key separatorBetween(StringRef left, StringRef right) {
+		return Key(right.substr(0, std::min(right.size(), commonPrefixLength(left, right) + 1)));
+	}
+
+	// Moves the upper half of a full leaf into a new leaf following it.
+	void splitLeaf(Leaf* leaf) {
+		Leaf* right = new Leaf();
+		int half = leaf->count / 2;
+		right->count = leaf->count - half;
+		memcpy(right->entries, leaf->entries + half, right->count * sizeof(Entry*));
+		leaf->count = half;
+		leaf->rebuildHeads();
+		right->rebuildHeads();
+
+		right->prev = leaf;
+		right->next = leaf->next;
+		if (leaf->next) {
+			leaf->next->prev = right;
+		} else {
+			last = right;
+		}
+		leaf->next = right;
+
+		insertIntoParent(leaf, separatorBetween(leaf->keyAt(half - 1), right->keyAt(0)), right);
+	}
+
+	void insertIntoParent(Node* left, Key separator, Node* right) {
+		if (!left->parent) {
+			Inner* inner = new Inner();
+			inner->children[0] = left;
+			inner->count = 1;
+			left->parent = inner;
+			root = inner;
+		}
+		if (left->parent->count == InnerCapacity) {
+			splitInner(left->parent);
+		}
+		Inner* parent = left->parent;
+		parent->insertChild(parent->indexOf(left) + 1, std::move(separator), right);
+	}
+
+	void splitInner(Inner* inner) {
+		Inner* right = new Inner();
+		int half = inner->count / 2;
+		right->count = inner->count - half;
+		for (int i = 0; i < right->count; ++i) {
+			right->children[i] = inner->children[half + i];
+			right->children[i]->parent = right;
+		}
+		for (int i = 0; i < right->count - 1; ++i) {
+			right->separators[i] = std::move(inner->separators[half + i]);
+		}
+		Key promoted = std::move(inner->separators[half - 1]);
+		for (int i = half - 1; i < InnerCapacity - 1; ++i) {
+			inner->separators[i] = Key();
+		}
+		inner->count = half;
+		inner->rebuildHeads();
+		right->rebuildHeads();
+		insertIntoParent(inner, std::move(promoted), right);
+	}
+
+	// Unlinks and frees an empty leaf, removing any inner nodes left without children.
+	void removeLeaf(Leaf* leaf) {
+		if (leaf->prev) {
+			leaf->prev->next = leaf->next;
+		} else {
+			first = leaf->next;
+		}
+		if (leaf->next) {
+			leaf->next->prev = leaf->prev;
+		} else {
+			last = leaf->prev;
+		}
+		removeNode(leaf);
+	}
+
+	void removeNode(Node* node) {
+		Inner* parent = node->parent;
+		if (node->isLeaf) {
+			delete static_cast<Leaf*>(node);
+		} else {
+			delete static_cast<Inner*>(node);
+		}
+		if (!parent) {
+			root = nullptr;
+			return;
+		}
+		parent->removeChild(parent->indexOf(node));
+		if (parent->count == 0) {
+			removeNode(parent);
+		} else if (parent == root && parent->count == 1) {
+			root = parent->children[0];
+			root->parent = nullptr;
+			delete parent;
+		}
+	}
+
+	// Folds a sparsely populated leaf into a neighbour under the same parent, so that point clears do not leave the
+	// tree full of nearly empty leaves.
+	void mergeIfUnderfull(Leaf* leaf) {
+		if (leaf->count >= LeafCapacity / 4) {
+			return;
+		}
+		Leaf* left = leaf;
+		Leaf* right = leaf->next;
+		if (!right || right->parent != leaf->parent || leaf->count + right->count > LeafCapacity * 3 / 4) {
+			right = leaf;
+			left = leaf->prev;
+			if (!left || left->parent != leaf->parent || leaf->count + left->count > LeafCapacity * 3 / 4) {
+				return;
+			}
+		}
+		memcpy(left->entries + left->count, right->entries, right->count * sizeof(Entry*));
+		left->count += right->count;
+		left->rebuildHeads();
+		right->count = 0;
+		removeLeaf(right);
+	}
+
+	static void destroyNode(Node* node) {
+		if (node->isLeaf) {
+			Leaf* leaf = static_cast<Leaf*>(node);
+			for (int i = 0; i < leaf->count; ++i) {
+				leaf->entries[i]->destroy();
+			}
+			delete leaf;
+		} else {
+			Inner* inner = static_cast<Inner*>(node);
+			for (int i = 0; i < inner->count; ++i) {
+				destroyNode(inner->children[i]);
+			}
+			delete inner;
+		}
+	}
+};
+
+#endif
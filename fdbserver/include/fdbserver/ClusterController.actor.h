@@ -3405,6 +3405,7 @@ public:
 	Counter getClientWorkersRequests;
 	Counter registerMasterRequests;
 	Counter statusRequests;
+	Counter statusRequestsFromCache;
 
 	Reference<EventCacheHolder> recruitedMasterWorkerEventHolder;
 
@@ -3427,6 +3428,7 @@ public:
 	    getClientWorkersRequests("GetClientWorkersRequests", clusterControllerMetrics),
 	    registerMasterRequests("RegisterMasterRequests", clusterControllerMetrics),
 	    statusRequests("StatusRequests", clusterControllerMetrics),
+	    statusRequestsFromCache("StatusRequestsFromCache", clusterControllerMetrics),
 	    recruitedMasterWorkerEventHolder(makeReference<EventCacheHolder>("RecruitedMasterWorker")) {
 		auto serverInfo = ServerDBInfo();
 		serverInfo.id = deterministicRandom()->randomUniqueID();
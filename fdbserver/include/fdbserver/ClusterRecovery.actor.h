@@ -240,6 +240,14 @@ struct ClusterRecoveryData : NonCopyable, ReferenceCounted<ClusterRecoveryData>
 	int64_t registrationCount; // Number of different MasterRegistrationRequests sent to clusterController
 
 	RecoveryState recoveryState;
+	double recoveryPhaseStart = 0; // when the recovery state last changed
+
+	// Returns how long recovery spent in the phase that is ending, and starts timing the next one
+	double endRecoveryPhase() {
+		double duration = now() - recoveryPhaseStart;
+		recoveryPhaseStart = now();
+		return duration;
+	}
 
 	PromiseStream<Future<Void>> addActor;
 	Reference<AsyncVar<bool>> recruitmentStalled;
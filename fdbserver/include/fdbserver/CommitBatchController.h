@@ -0,0 +1,91 @@
+/*
+ * CommitBatchController.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FDBSERVER_COMMITBATCHCONTROLLER_H
+#define FDBSERVER_COMMITBATCHCONTROLLER_H
+#pragma once
+
+#include <vector>
+
+// Chooses how long commitBatcher waits to fill a commit batch, from what the batches it produced went through
+// downstream. Used by the commit proxy when COMMIT_BATCH_INTERVAL_CONTROLLER is set.
+//
+// A longer interval makes batches bigger, which spreads the fixed cost of a batch (getting a version, a round trip to
+// the resolvers, a tLog push) over more transactions, but every transaction pays the wait in latency. A transaction's
+// commit latency is roughly the interval plus the latency of its batch, and the controller keeps the interval plus the
+// 99th percentile of recent batch latencies near a target:
+//  - Over the target, the interval shrinks by a fraction of the excess.
+//  - Under it, while batches are queued behind one another, the interval grows by a fraction of the slack, since larger
+//    batches are how the downstream stages get more throughput.
+//  - Under it with nothing queued, bigger batches buy nothing, and the interval decays toward its minimum.
+//  - With more batches in flight than allowed, the downstream stages cannot keep up with the number of batches, and a
+//    shorter interval would only lengthen the queue, so the interval grows whatever the latency.
+class CommitBatchController {
+public:
+	enum class Stage { Batching, Resolution, Queuing, Logging };
+
+	// What one batch went through, in seconds, and how many batches were in flight when it was replied to
+	struct BatchTiming {
+		double latency = 0; // From the batch being formed to its replies
+		double resolution = 0;
+		double queuing = 0; // Waiting for earlier batches' post-resolution processing
+		double logging = 0;
+		int batchesInFlight = 0;
+	};
+
+	CommitBatchController(double initialInterval,
+	                      double minInterval,
+	                      double maxInterval,
+	                      double targetLatency,
+	                      double gain,
+	                      int maxBatchesInFlight,
+	                      int window);
+
+	// Returns the interval to use from now on
+	double update(const BatchTiming& timing);
+
+	double interval() const { return currentInterval; }
+
+	// The 99th percentile of the latencies of the last `window` batches
+	double batchLatencyP99() const { return latencyP99; }
+
+	// The stage that, on average, takes longest per batch
+	Stage limitingStage() const;
+	static const char* stageName(Stage stage);
+
+private:
+	double currentInterval;
+	const double minInterval;
+	const double maxInterval;
+	const double targetLatency;
+	const double gain;
+	const int maxBatchesInFlight;
+
+	std::vector<double> recentLatencies; // Ring buffer
+	int nextLatency = 0;
+	double latencyP99 = 0;
+
+	// Smoothed per-batch time in each stage
+	double resolutionTime = 0;
+	double queuingTime = 0;
+	double loggingTime = 0;
+};
+
+#endif
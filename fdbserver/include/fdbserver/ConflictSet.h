@@ -29,8 +29,14 @@
 #include "fdbserver/ResolverBug.h"
 
 struct ConflictSet;
-ConflictSet* newConflictSet();
+// With partitions > 1, large batches are checked and merged by that many threads, each owning a key range
+ConflictSet* newConflictSet(int partitions = 1, int minPartitionRanges = 0);
+// Keeps the history in a VersionHistoryBTree rather than a SkipList
+ConflictSet* newBTreeConflictSet();
 void clearConflictSet(ConflictSet*, Version);
+// Each batch removes a little of the history that has fallen out of the version window, in proportion to what it adds.
+// This removes up to nodeCount more, and returns whether any may be left.
+bool removeOldVersions(ConflictSet*, int nodeCount);
 void destroyConflictSet(ConflictSet*);
 
 struct ConflictBatch {
@@ -24,6 +24,7 @@
 
 #include "fdbserver/DataDistribution.actor.h"
 #include "fdbserver/MovingWindow.h"
+#include "fdbserver/StorageServerUtils.h"
 
 // send request/signal to DDRelocationQueue through interface
 // call synchronous method from components outside DDRelocationQueue
@@ -116,6 +117,8 @@ struct DDQueueInitParams {
 	FutureStream<RelocateShard> const& relocationConsumer;
 	PromiseStream<GetMetricsRequest> const& getShardMetrics;
 	PromiseStream<GetTopKMetricsRequest> const& getTopKMetrics;
+	// True when every storage engine of the configuration can move data by physical shard checkpoints
+	bool physicalShardMoveSupported = false;
 };
 
 // DDQueue receives RelocateShard from any other DD components and schedules the actual movements
@@ -254,9 +257,12 @@ public:
 	int64_t bytesWritten;
 	int teamSize;
 	int singleRegionTeamSize;
+	bool physicalShardMoveSupported;
 
 	std::map<UID, Busyness> busymap; // UID is serverID
 	std::map<UID, Busyness> destBusymap; // UID is serverID
+	// Paces the bytes relocated into each zone to DD_ZONE_MOVE_BYTES_PER_SEC. Key is the zone id.
+	std::map<Optional<Standalone<StringRef>>, ThroughputLimiter> zoneMoveLimiters;
 
 	KeyRangeMap<RelocateData> queueMap;
 	std::set<RelocateData, std::greater<RelocateData>> fetchingSourcesQueue;
@@ -356,6 +362,12 @@ public:
 
 	Future<Void> periodicalRefreshCounter();
 
+	// Charges a move of `bytes` to the zones of the destination teams. Returns when those zones have paid off the
+	// moves before it, or right away for moves at or above DATA_MOVE_BUDGET_PRIORITY_THRESHOLD.
+	Future<Void> chargeZoneMoveBudget(const std::vector<std::pair<Reference<IDataDistributionTeam>, bool>>& destTeams,
+	                                  int64_t bytes,
+	                                  int priority);
+
 	int getUnhealthyRelocationCount() const override;
 
 	Future<SrcDestTeamPair> getSrcDestTeams(const int& teamCollectionIndex,
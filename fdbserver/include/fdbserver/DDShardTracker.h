@@ -79,6 +79,16 @@ public:
 	// Read hot detection
 	PromiseStream<KeyRange> readHotShard;
 
+	// The read hot ranges that data distribution has cached on the storage cache servers, by begin key
+	struct AutoCachedRange {
+		Key end;
+		int64_t bytes;
+		double lastReadHot; // when the range was last reported read hot
+	};
+	PromiseStream<Standalone<VectorRef<ReadHotRangeWithMetrics>>> readHotRanges;
+	std::map<Key, AutoCachedRange> autoCachedRanges;
+	int64_t autoCachedBytes = 0;
+
 	// The reference to trackerCancelled must be extracted by actors,
 	// because by the time (trackerCancelled == true) this memory cannot
 	// be accessed
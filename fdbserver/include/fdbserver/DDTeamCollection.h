@@ -234,6 +234,7 @@ protected:
 	Reference<StorageWiggler> storageWiggler;
 	std::vector<AddressExclusion> wiggleAddresses; // collection of wiggling servers' address
 	Optional<UID> wigglingId; // Process id of current wiggling storage server;
+	AsyncVar<Optional<UID>> rebuildingStorageId; // wiggling storage server rebuilding its engine in place, if any
 	Reference<AsyncVar<bool>> pauseWiggle;
 	Reference<AsyncVar<bool>> processingWiggle; // track whether wiggling relocation is being processed
 	PromiseStream<StorageWiggleValue> nextWiggleInfo;
@@ -59,6 +59,7 @@ public:
 		SIZE_SPLIT,
 		WRITE_SPLIT,
 		TENANT_SPLIT,
+		READ_SPLIT,
 		__COUNT
 	};
 	RelocateReason(Value v) : value(v) { ASSERT(value != __COUNT); }
@@ -81,6 +82,8 @@ public:
 			return "WriteSplit";
 		case TENANT_SPLIT:
 			return "TenantSplit";
+		case READ_SPLIT:
+			return "ReadSplit";
 		case __COUNT:
 			ASSERT(false);
 		}
@@ -58,7 +58,8 @@ class GrvProxyTagThrottler {
 		explicit TagQueue(double rate)
 		  : rateInfo(GrvTransactionRateInfo(SERVER_KNOBS->TAG_THROTTLE_RATE_WINDOW,
 		                                    SERVER_KNOBS->TAG_THROTTLE_MAX_EMPTY_QUEUE_BUDGET,
-		                                    rate)) {}
+		                                    rate,
+		                                    SERVER_KNOBS->TAG_THROTTLE_MAX_BURST_DURATION)) {}
 
 		void setRate(double rate);
 		bool isMaxThrottled(double maxThrottleDuration) const;
@@ -36,6 +36,7 @@
 class GrvTransactionRateInfo {
 	double rateWindow{ 1.0 };
 	double maxEmptyQueueBudget{ 0.0 };
+	double maxBurstDuration{ 0.0 };
 	double rate{ 0.0 };
 	double limit{ 0.0 };
 	double budget{ 0.0 };
@@ -44,7 +45,9 @@ class GrvTransactionRateInfo {
 	Smoother smoothReleased;
 
 public:
-	GrvTransactionRateInfo(double rateWindow, double maxEmptyQueueBudget, double rate);
+	// If maxBurstDuration is positive, an idle queue also carries forward at most maxBurstDuration seconds' worth of
+	// its rate, so that a burst after a quiet period cannot exceed the rate by more than that.
+	GrvTransactionRateInfo(double rateWindow, double maxEmptyQueueBudget, double rate, double maxBurstDuration = 0.0);
 
 	// Determines the number of transactions that this proxy is allowed to release
 	// in this release window.
@@ -0,0 +1,118 @@
+/*
+ * HotKeyTracker.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FDBSERVER_HOTKEYTRACKER_H
+#define FDBSERVER_HOTKEYTRACKER_H
+#pragma once
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "fdbclient/FDBTypes.h"
+#include "flow/flow.h"
+
+// Finds the heaviest keys of a stream of weighted keys in bounded memory. A count-min sketch of depth x width
+// counters estimates the total weight of any key, never underestimating it, and the maxHotKeys keys with the largest
+// estimates so far are kept as the candidates. Adding a key costs depth counter updates and O(log maxHotKeys) key
+// comparisons, and only copies the key if it becomes a candidate.
+class HotKeySketch {
+public:
+	struct HotKey {
+		Key key;
+		int64_t weight; // estimated
+	};
+
+	HotKeySketch(int depth, int width, int maxHotKeys);
+
+	void add(KeyRef key, int64_t weight);
+
+	// Estimated total weight of key, which is at least its actual total weight
+	int64_t estimate(KeyRef key) const;
+
+	int64_t totalWeight() const { return total; }
+
+	// The heaviest keys, heaviest first
+	std::vector<HotKey> getHotKeys() const;
+
+	void clear();
+
+private:
+	int depth, width, maxHotKeys;
+	std::vector<int64_t> counters; // depth rows of width counters
+	int64_t total = 0;
+	std::map<Key, int64_t, std::less<>> candidates;
+	std::set<std::pair<int64_t, KeyRef>> candidatesByWeight; // keys point into candidates
+
+	template <class F>
+	void forEachCounter(KeyRef key, F f) const;
+};
+
+// Hot keys and hot key prefixes of the reads and writes of a storage server, measured over intervals of
+// HOT_KEY_MEASUREMENT_INTERVAL. At the end of each interval the hottest of each are logged, the hottest as the
+// HotKeys event which status reports, and the sketches start over.
+class HotKeyTracker : NonCopyable {
+public:
+	struct HotKeyRate {
+		Key key;
+		double rate; // estimated weight per second
+		double fraction; // estimated fraction of the total weight
+	};
+
+	explicit HotKeyTracker(UID thisServerID);
+
+	bool enabled() const { return isEnabled; }
+
+	// Reads are weighed by the bytes they read, and writes by the size of the mutation
+	void addRead(KeyRef key, int64_t bytes) {
+		if (isEnabled) {
+			add(reads, readPrefixes, key, bytes);
+		}
+	}
+	void addWrite(KeyRef key, int64_t bytes) {
+		if (isEnabled) {
+			add(writes, writePrefixes, key, bytes);
+		}
+	}
+
+	void startNewInterval();
+
+	// As of the end of the last interval, hottest first
+	std::vector<HotKeyRate> const& getHotReadKeys() const { return hotReadKeys; }
+	std::vector<HotKeyRate> const& getHotReadPrefixes() const { return hotReadPrefixes; }
+	std::vector<HotKeyRate> const& getHotWriteKeys() const { return hotWriteKeys; }
+	std::vector<HotKeyRate> const& getHotWritePrefixes() const { return hotWritePrefixes; }
+
+private:
+	UID thisServerID;
+	bool isEnabled;
+	int prefixBytes;
+	HotKeySketch reads, readPrefixes, writes, writePrefixes;
+	double intervalStart = 0;
+	std::vector<HotKeyRate> hotReadKeys, hotReadPrefixes, hotWriteKeys, hotWritePrefixes;
+	Reference<EventCacheHolder> hotKeysEventHolder;
+
+	void add(HotKeySketch& keys, HotKeySketch& prefixes, KeyRef key, int64_t bytes) {
+		keys.add(key, bytes);
+		prefixes.add(key.substr(0, std::min(key.size(), prefixBytes)), bytes);
+	}
+};
+
+#endif
@@ -119,6 +119,78 @@ struct numeric_limits<IDiskQueue::location> {
 };
 } // namespace std
 
+// An archive that serializes straight into an IDiskQueue, for callers that would otherwise serialize an entry into a
+// BinaryWriter and push() the result. Byte strings of at least kBufferBytes, such as the messages of a TLog commit, are
+// pushed from where they already are, so they are copied only once, into the queue's pages. Smaller items are gathered
+// in a small buffer, which is pushed when it fills and by finish().
+//
+// A writer without a queue only counts the bytes it is given, so that a caller can find the length of an entry before
+// pushing it.
+class DiskQueueWriter : NonCopyable {
+public:
+	static const int isDeserializing = 0;
+	static constexpr bool isSerializing = true;
+	typedef DiskQueueWriter WRITER;
+
+	static constexpr int kBufferBytes = 256;
+
+	template <class VersionOptions>
+	DiskQueueWriter(IDiskQueue* queue, VersionOptions vo) : queue(queue), buffered(0), length(0) {
+		vo.write(*this);
+	}
+
+	void serializeBytes(StringRef bytes) { serializeBytes(bytes.begin(), bytes.size()); }
+	void serializeBytes(const void* data, int bytes) {
+		length += bytes;
+		if (!queue || bytes <= 0) {
+			return;
+		}
+		if (bytes > kBufferBytes - buffered) {
+			flush();
+			if (bytes >= kBufferBytes) {
+				end = queue->push(StringRef((const uint8_t*)data, bytes));
+				return;
+			}
+		}
+		memcpy(buffer + buffered, data, bytes);
+		buffered += bytes;
+	}
+	template <class T>
+	void serializeBinaryItem(const T& t) {
+		static_assert(is_binary_serializable<T>::value,
+		              "Object must be binary serializable, see BINARY_SERIALIZABLE macro");
+		serializeBytes(&t, sizeof(T));
+	}
+
+	// The number of bytes written so far
+	int64_t getLength() const { return length; }
+
+	// Pushes anything still buffered, and returns the location of the end of what was written, as push() does. It
+	// must be called before anything else is pushed to the queue.
+	IDiskQueue::location finish() {
+		flush();
+		return end.present() ? end.get() : queue->getNextPushLocation();
+	}
+
+	ProtocolVersion protocolVersion() const { return m_protocolVersion; }
+	void setProtocolVersion(ProtocolVersion pv) { m_protocolVersion = pv; }
+
+private:
+	IDiskQueue* queue;
+	uint8_t buffer[kBufferBytes];
+	int buffered;
+	int64_t length;
+	Optional<IDiskQueue::location> end;
+	ProtocolVersion m_protocolVersion;
+
+	void flush() {
+		if (buffered) {
+			end = queue->push(StringRef(buffer, buffered));
+			buffered = 0;
+		}
+	}
+};
+
 // Specify which hash function to use for checksum of pages in DiskQueue
 enum class DiskQueueVersion : uint16_t {
 	V0 = 0, // Use hashlittle
@@ -126,10 +198,13 @@ enum class DiskQueueVersion : uint16_t {
 	V2 = 2, // Use xxhash3
 };
 
+// Opens basename+"0."+ext and basename+"1."+ext. A new queue with stripeFolders stripes each of these files across
+// them as well, see DISK_QUEUE_STRIPE_UNIT_BYTES; an existing queue is opened the way it was created.
 IDiskQueue* openDiskQueue(std::string basename,
                           std::string ext,
                           UID dbgid,
                           DiskQueueVersion diskQueueVersion,
-                          int64_t fileSizeWarningLimit = -1); // opens basename+"0."+ext and basename+"1."+ext
+                          int64_t fileSizeWarningLimit = -1,
+                          std::vector<std::string> stripeFolders = std::vector<std::string>());
 
 #endif
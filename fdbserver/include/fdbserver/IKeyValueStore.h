@@ -26,6 +26,17 @@
 #include "fdbclient/FDBTypes.h"
 #include "fdbclient/IKeyValueStore.actor.h"
 #include "flow/BooleanParam.h"
+#include "flow/IThreadPool.h"
+
+// The hint with which storage engines post a read of the given type to their reader threads
+inline ThreadActionHint readActionHint(ReadType type, uint64_t affinity = 0) {
+	ThreadActionHint hint;
+	hint.affinity = affinity;
+	hint.priority = type == ReadType::HIGH                            ? ThreadActionHint::Priority::High
+	                : type == ReadType::FETCH || type == ReadType::LOW ? ThreadActionHint::Priority::Low
+	                                                                   : ThreadActionHint::Priority::Normal;
+	return hint;
+}
 
 extern IKeyValueStore* keyValueStoreSQLite(std::string const& filename,
                                            UID logID,
@@ -27,6 +27,7 @@
 
 #include "fdbserver/SpanContextMessage.h"
 #include "fdbserver/OTELSpanContextMessage.h"
+#include "fdbserver/TagMessageIndex.h"
 #include "fdbserver/TLogInterface.h"
 #include "fdbserver/WorkerInterface.actor.h"
 #include "fdbclient/DatabaseConfiguration.h"
@@ -226,6 +227,13 @@ struct ILogSystem {
 		int fastReplies;
 		int unknownReplies;
 
+		// Parallel peeks keep enough requests outstanding to cover a request's latency at the rate replies are being
+		// consumed, up to PARALLEL_GET_MORE_REQUESTS. Both are smoothed over recent replies.
+		double replyLatency; // Of replies the TLog had more data for than it returned
+		double replyConsumeTime; // From a reply being handed out to the cursor running out of its messages
+		double lastReplyTime;
+		int parallelGetMoreDepth() const;
+
 		ServerPeekCursor(Reference<AsyncVar<OptionalInterface<TLogInterface>>> const& interf,
 		                 Tag tag,
 		                 Version begin,
@@ -705,28 +713,6 @@ struct ILogSystem {
 	virtual void setOldestBackupEpoch(LogEpoch epoch) = 0;
 };
 
-struct LengthPrefixedStringRef {
-	// Represents a pointer to a string which is prefixed by a 4-byte length
-	// A LengthPrefixedStringRef is only pointer-sized (8 bytes vs 12 bytes for StringRef), but the corresponding string
-	// is 4 bytes bigger, and substring operations aren't efficient as they are with StringRef.  It's a good choice when
-	// there might be lots of references to the same exact string.
-
-	uint32_t* length;
-
-	StringRef toStringRef() const {
-		ASSERT(length);
-		return StringRef((uint8_t*)(length + 1), *length);
-	}
-	int expectedSize() const {
-		ASSERT(length);
-		return *length;
-	}
-	uint32_t* getLengthPtr() const { return length; }
-
-	LengthPrefixedStringRef() : length(nullptr) {}
-	LengthPrefixedStringRef(uint32_t* length) : length(length) {}
-};
-
 // Structure to store serialized mutations sent from the proxy to the
 // transaction logs. The serialization repeats with the following format:
 //
@@ -789,6 +775,13 @@ struct LogPushData : NonCopyable {
 
 	Standalone<StringRef> getMessages(int loc) const { return messagesWriter[loc].toValue(); }
 
+	// Makes room for `bytes` of messages at every location, so that mutations up to that size are serialized straight
+	// into their final buffers instead of being copied again each time a buffer grows.
+	void reserve(int bytes);
+
+	// The size of the messages for the location with the most
+	int getLargestMessagesSize() const;
+
 	// Returns all locations' messages, including empty ones.
 	std::vector<Standalone<StringRef>> getAllMessages() const;
 
@@ -131,6 +131,9 @@ struct SWIFT_CXX_REF_MASTERDATA MasterData : NonCopyable, ReferenceCounted<Maste
 	CounterValue waitForPrevCommitRequests;
 	CounterValue nonWaitForPrevCommitRequests;
 	LatencySample* versionVectorSizeOnCVReply = nullptr;
+	// Seconds spent updating ssVersionVector for a commit, and taking its delta for a reply to a GRV proxy
+	LatencySample* versionVectorUpdateLatency = nullptr;
+	LatencySample* versionVectorLatencyOnCVReply = nullptr;
 	LatencySample* waitForPrevLatencies = nullptr;
 
 	PromiseStream<Future<Void>> addActor;
@@ -200,6 +200,9 @@ public:
 
 	HealthMetrics::StorageStats getStorageStats() const;
 
+	// total bytes this server has fetched from other servers during data moves
+	int64_t getBytesFetched() const { return counters.bytesFetched.getValue(); }
+
 protected:
 	PromiseStream<FetchKeysParams> fetchKeysRequests;
 
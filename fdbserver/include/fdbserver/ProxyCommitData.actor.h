@@ -25,16 +25,20 @@
 #elif !defined(FDBSERVER_PROXYCOMMITDATA_ACTOR_H)
 #define FDBSERVER_PROXYCOMMITDATA_ACTOR_H
 
+#include "fdbclient/CommitBatchRecording.h"
 #include "fdbclient/FDBTypes.h"
 #include "fdbclient/GetEncryptCipherKeys.h"
 #include "fdbclient/Tenant.h"
 #include "fdbrpc/Stats.h"
 #include "fdbserver/AccumulativeChecksumUtil.h"
+#include "fdbserver/CommitBatchController.h"
 #include "fdbserver/Knobs.h"
 #include "fdbserver/LogSystem.h"
 #include "fdbserver/LogSystemDiskQueueAdapter.h"
 #include "fdbserver/MasterInterface.h"
 #include "fdbserver/ResolverInterface.h"
+#include "fdbserver/TenantPrefixIndex.h"
+#include "fdbserver/WorkerThreads.h"
 #include "flow/IRandom.h"
 
 #include "flow/actorcompiler.h" // This must be the last #include.
@@ -82,6 +86,13 @@ struct ProxyStats {
 
 	LatencySample computeLatency;
 
+	// Per-batch time in the downstream stages of a commit, to see which one limits throughput
+	LatencySample resolutionLatency;
+	LatencySample postResolutionQueuingLatency;
+	LatencySample loggingLatency;
+
+	LatencySample tenantLookupLatency; // Samples lookups of tenants in the tenant index
+
 	Future<Void> logger;
 
 	int64_t maxComputeNS;
@@ -124,7 +135,8 @@ struct ProxyStats {
 	                    NotifiedVersion* pVersion,
 	                    NotifiedVersion* pCommittedVersion,
 	                    int64_t* commitBatchesMemBytesCountPtr,
-	                    std::map<int64_t, TenantName>* pTenantMap)
+	                    std::map<int64_t, TenantName>* pTenantMap,
+	                    TenantPrefixIndex* pTenantIndex)
 	  : cc("ProxyStats", id.toString()), txnCommitIn("TxnCommitIn", cc),
 	    txnCommitVersionAssigned("TxnCommitVersionAssigned", cc), txnCommitResolving("TxnCommitResolving", cc),
 	    txnCommitResolved("TxnCommitResolved", cc), txnCommitOut("TxnCommitOut", cc),
@@ -159,6 +171,22 @@ struct ProxyStats {
 	                   id,
 	                   SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
 	                   SERVER_KNOBS->LATENCY_SKETCH_ACCURACY),
+	    resolutionLatency("CommitResolutionLatency",
+	                      id,
+	                      SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
+	                      SERVER_KNOBS->LATENCY_SKETCH_ACCURACY),
+	    postResolutionQueuingLatency("CommitPostResolutionQueuingLatency",
+	                                 id,
+	                                 SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
+	                                 SERVER_KNOBS->LATENCY_SKETCH_ACCURACY),
+	    loggingLatency("CommitLoggingLatency",
+	                   id,
+	                   SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
+	                   SERVER_KNOBS->LATENCY_SKETCH_ACCURACY),
+	    tenantLookupLatency("TenantLookupMetrics",
+	                        id,
+	                        SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
+	                        SERVER_KNOBS->LATENCY_SKETCH_ACCURACY),
 	    maxComputeNS(0), minComputeNS(1e12),
 	    commitBatchQueuingDist(
 	        Histogram::getHistogram("CommitProxy"_sr, "CommitBatchQueuing"_sr, Histogram::Unit::milliseconds)),
@@ -178,6 +206,8 @@ struct ProxyStats {
 			return *commitBatchesMemBytesCountPtr;
 		});
 		specialCounter(cc, "NumTenants", [pTenantMap]() { return pTenantMap ? pTenantMap->size() : 0; });
+		specialCounter(cc, "TenantIndexBytes", [pTenantIndex]() { return pTenantIndex->memoryUsage(); });
+		pTenantIndex->setLookupLatencySample(&tenantLookupLatency);
 		specialCounter(cc, "MaxCompute", [this]() { return this->getAndResetMaxCompute(); });
 		specialCounter(cc, "MinCompute", [this]() { return this->getAndResetMinCompute(); });
 		logger = cc.traceCounters("ProxyMetrics", id, SERVER_KNOBS->WORKER_LOGGING_INTERVAL, "ProxyMetrics");
@@ -188,10 +218,15 @@ struct ExpectedIdempotencyIdCountForKey {
 	Version commitVersion = invalidVersion;
 	int16_t idempotencyIdCount = 0;
 	uint8_t batchIndexHighByte = 0;
+	int16_t keyCount = 0; // The number of idempotency keys written at commitVersion
 
 	ExpectedIdempotencyIdCountForKey() {}
-	ExpectedIdempotencyIdCountForKey(Version commitVersion, int16_t idempotencyIdCount, uint8_t batchIndexHighByte)
-	  : commitVersion(commitVersion), idempotencyIdCount(idempotencyIdCount), batchIndexHighByte(batchIndexHighByte) {}
+	ExpectedIdempotencyIdCountForKey(Version commitVersion,
+	                                 int16_t idempotencyIdCount,
+	                                 uint8_t batchIndexHighByte,
+	                                 int16_t keyCount)
+	  : commitVersion(commitVersion), idempotencyIdCount(idempotencyIdCount), batchIndexHighByte(batchIndexHighByte),
+	    keyCount(keyCount) {}
 };
 
 struct ProxyCommitData {
@@ -199,6 +234,8 @@ struct ProxyCommitData {
 	int64_t commitBatchesMemBytesCount;
 	std::unordered_map<TenantName, int64_t> tenantNameIndex;
 	std::map<int64_t, TenantName> tenantMap;
+	// The ids of the tenants in tenantMap, for the checks of every mutation and transaction, which only need the id
+	TenantPrefixIndex tenantIndex;
 	std::set<int64_t> lockedTenants;
 	std::unordered_set<int64_t> tenantsOverStorageQuota;
 	ProxyStats stats;
@@ -229,6 +266,7 @@ struct ProxyCommitData {
 	bool locked;
 	Optional<Value> metadataVersion;
 	double commitBatchInterval;
+	CommitBatchController batchController; // Sets commitBatchInterval if COMMIT_BATCH_INTERVAL_CONTROLLER
 	bool provisional;
 
 	int64_t localCommitBatchesStarted;
@@ -258,6 +296,13 @@ struct ProxyCommitData {
 	NotifiedDouble lastCommitTime;
 
 	std::vector<double> commitComputePerOperation;
+
+	// Threads to encrypt a batch's mutations on, when PROXY_MUTATION_ENCRYPTION_THREADS is set
+	std::unique_ptr<WorkerThreads> mutationWorkers;
+
+	// Smoothed ratio of the largest TLog message of a batch to the batch's mutation bytes, for sizing message buffers
+	double logMessagesPerMutationByte = 0;
+
 	UIDTransactionTagMap<TransactionCommitCostEstimation> ssTrTagCommitCost;
 	double lastMasterReset;
 	double lastResolverReset;
@@ -288,6 +333,15 @@ struct ProxyCommitData {
 		return tags;
 	}
 
+	// The same as tagsForKey(key), finding key's range with a cursor over keyInfo
+	const std::vector<Tag>& tagsForKey(StringRef key, KeyRangeMapCursor<ServerCacheInfo>& keyInfoCursor) {
+		auto& info = keyInfoCursor.rangeContaining(key).value();
+		if (!info.tags.size()) {
+			info.populateTags();
+		}
+		return info.tags;
+	}
+
 	bool needsCacheTag(KeyRangeRef range) {
 		auto ranges = cacheInfo.intersectingRanges(range);
 		for (auto r : ranges) {
@@ -344,12 +398,20 @@ struct ProxyCommitData {
 	                uint16_t commitProxyIndex,
 	                LogEpoch epoch)
 	  : dbgid(dbgid), commitBatchesMemBytesCount(0),
-	    stats(dbgid, &version, &committedVersion, &commitBatchesMemBytesCount, &tenantMap), master(master),
+	    stats(dbgid, &version, &committedVersion, &commitBatchesMemBytesCount, &tenantMap, &tenantIndex),
+	    master(master),
 	    logAdapter(nullptr), txnStateStore(nullptr), committedVersion(recoveryTransactionVersion),
 	    minKnownCommittedVersion(0), version(0), lastVersionTime(0), commitVersionRequestNumber(1),
 	    mostRecentProcessedRequestNumber(0), firstProxy(firstProxy), encryptMode(encryptMode),
 	    encryptionMonitor(makeReference<GetEncryptCipherKeysMonitor>()), provisional(provisional), lastCoalesceTime(0),
 	    locked(false), commitBatchInterval(SERVER_KNOBS->COMMIT_TRANSACTION_BATCH_INTERVAL_MIN),
+	    batchController(SERVER_KNOBS->COMMIT_TRANSACTION_BATCH_INTERVAL_MIN,
+	                    SERVER_KNOBS->COMMIT_TRANSACTION_BATCH_INTERVAL_MIN,
+	                    SERVER_KNOBS->COMMIT_TRANSACTION_BATCH_INTERVAL_MAX,
+	                    SERVER_KNOBS->COMMIT_BATCH_TARGET_LATENCY,
+	                    SERVER_KNOBS->COMMIT_BATCH_CONTROLLER_GAIN,
+	                    SERVER_KNOBS->COMMIT_BATCH_CONTROLLER_MAX_BATCHES_IN_FLIGHT,
+	                    SERVER_KNOBS->COMMIT_BATCH_CONTROLLER_WINDOW),
 	    localCommitBatchesStarted(0), getConsistentReadVersion(getConsistentReadVersion), commit(commit),
 	    cx(openDBOnServer(db, TaskPriority::DefaultEndpoint, LockAware::True)), db(db),
 	    singleKeyMutationEvent("SingleKeyMutation"_sr), lastTxsPop(0), popRemoteTxs(false), lastStartCommit(0),
@@ -362,6 +424,18 @@ struct ProxyCommitData {
 	                   : nullptr),
 	    epoch(epoch) {
 		commitComputePerOperation.resize(SERVER_KNOBS->PROXY_COMPUTE_BUCKETS, 0.0);
+		// Simulation must stay on one thread, so there the network thread encrypts ahead by itself
+		if (SERVER_KNOBS->PROXY_MUTATION_ENCRYPTION_THREADS > 0 && encryptMode.isEncryptionEnabled() &&
+		    !g_network->isSimulated()) {
+			mutationWorkers = std::make_unique<WorkerThreads>(SERVER_KNOBS->PROXY_MUTATION_ENCRYPTION_THREADS);
+		}
+		if (!SERVER_KNOBS->COMMIT_BATCH_RECORDING_FILE.empty()) {
+			batchRecorder =
+			    std::make_unique<CommitBatchRecorder>(dbgid,
+			                                          SERVER_KNOBS->COMMIT_BATCH_RECORDING_FILE + "." + dbgid.toString(),
+			                                          SERVER_KNOBS->COMMIT_BATCH_RECORDING_MAX_BYTES,
+			                                          SERVER_KNOBS->COMMIT_BATCH_RECORDING_MAX_PENDING_BYTES);
+		}
 	}
 };
 
@@ -79,6 +79,8 @@ public:
 	// Summarizes up the commit cost per storage server. Returns the UpdateCommitCostRequest for corresponding SS.
 	UpdateCommitCostRequest refreshCommitCost(double elapsed);
 	int64_t getStorageQueueBytes() const { return lastReply.bytesInput - smoothDurableBytes.smoothTotal(); }
+	// The storage queue `seconds` from now if input and durable bytes keep their current smoothed rates
+	int64_t getProjectedStorageQueueBytes(double seconds) const;
 	int64_t getDurabilityLag() const { return smoothLatestVersion.smoothTotal() - smoothDurableVersion.smoothTotal(); }
 	void update(StorageQueuingMetricsReply const&, Smoother& smoothTotalDurableBytes);
 	void addCommitCost(TransactionTagRef tagName, TransactionCommitCostEstimation const& cost);
@@ -88,6 +90,7 @@ public:
 	double getSmoothTotalSpace() const { return smoothTotalSpace.smoothTotal(); }
 	double getSmoothDurableBytes() const { return smoothDurableBytes.smoothTotal(); }
 	double getSmoothInputBytesRate() const { return smoothInputBytes.smoothRate(); }
+	double getSmoothDurableBytesRate() const { return smoothDurableBytes.smoothRate(); }
 	double getVerySmoothDurableBytesRate() const { return verySmoothDurableBytes.smoothRate(); }
 
 	Version getLatestVersion() const { return lastReply.version; }
@@ -211,6 +214,8 @@ class Ratekeeper {
 	bool anyBlobRanges;
 	Optional<Key> remoteDC;
 	Optional<UID> ssHighWriteQueue;
+	// Storage servers whose hot shards the commit proxies are throttling, and until when
+	std::map<UID, double> hotShardThrottledServers;
 
 	double getRecoveryDuration(Version ver) const {
 		auto it = version_recovery.lower_bound(ver);
@@ -0,0 +1,42 @@
+/*
+ * RocksDBBlockCache.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FDBSERVER_ROCKSDB_BLOCK_CACHE_H
+#define FDBSERVER_ROCKSDB_BLOCK_CACHE_H
+#pragma once
+
+#ifdef WITH_ROCKSDB
+
+#include <cstddef>
+#include <memory>
+
+#include <rocksdb/cache.h>
+
+// Returns a new LRU block cache of the given capacity. If ROCKSDB_COMPRESSED_SECONDARY_CACHE_SIZE is set, blocks
+// evicted from it are kept LZ4 compressed in a secondary tier, so the same memory holds several times as many blocks.
+std::shared_ptr<rocksdb::Cache> newRocksDBBlockCache(size_t capacity, double highPriPoolRatio);
+
+// Returns the block cache shared by all ssd-rocksdb-v1 stores of this process, creating it on first use. Sharing
+// avoids a process hosting several storage servers (or a storage server and its TSS) splitting ROCKSDB_BLOCK_CACHE_SIZE
+// into caches that each hold their own copy of hot blocks.
+std::shared_ptr<rocksdb::Cache> getProcessRocksDBBlockCache();
+
+#endif // WITH_ROCKSDB
+#endif // FDBSERVER_ROCKSDB_BLOCK_CACHE_H
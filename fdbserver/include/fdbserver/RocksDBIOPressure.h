@@ -0,0 +1,79 @@
+/*
+ * RocksDBIOPressure.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FDBSERVER_ROCKSDB_IO_PRESSURE_H
+#define FDBSERVER_ROCKSDB_IO_PRESSURE_H
+#pragma once
+
+#ifdef WITH_ROCKSDB
+
+#include <atomic>
+#include <cstdint>
+
+#include <rocksdb/rate_limiter.h>
+
+// Tracks how much RocksDB background work competes with foreground reads, for the RocksDB storage engines.
+//
+// The engines periodically sample their compaction and stall state into setPressure(), which the storage server
+// reports to load balancing and Ratekeeper through IKeyValueStore::getIOPressure(). Reader threads report foreground
+// read latencies with addReadLatency(), and adjustRateLimiter() uses them to back background IO off while reads are
+// slower than ROCKSDB_RATE_LIMITER_READ_LATENCY_TARGET.
+class RocksDBIOPressure {
+public:
+	// Returns a pressure in [0, 1]. It ramps up as pending compaction bytes approach the hard limit and as L0 files
+	// approach the stop trigger, and is at least 0.5 while writes are delayed and 1 while they are stopped. Limits
+	// and triggers of 0 are treated as disabled.
+	static double compute(uint64_t pendingCompactionBytes,
+	                      uint64_t softPendingCompactionBytesLimit,
+	                      uint64_t hardPendingCompactionBytesLimit,
+	                      uint64_t l0Files,
+	                      int l0SlowdownTrigger,
+	                      int l0StopTrigger,
+	                      bool writeDelayed,
+	                      bool writeStopped);
+
+	// Returns the next background IO rate given the mean foreground read latency since the last adjustment, or a
+	// negative latency if there were no reads. The rate is cut multiplicatively while reads are slow and recovers
+	// additively otherwise, staying within [ROCKSDB_RATE_LIMITER_MIN_FRACTION * maxBytesPerSec, maxBytesPerSec].
+	static int64_t nextRateLimit(int64_t current, int64_t maxBytesPerSec, double readLatency);
+
+	// Thread safe.
+	void addReadLatency(double seconds) {
+		readLatencyNs.fetch_add((uint64_t)(seconds * 1e9), std::memory_order_relaxed);
+		readCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	double getPressure() const { return pressure.load(std::memory_order_relaxed); }
+	void setPressure(double p) { pressure.store(p, std::memory_order_relaxed); }
+
+	// Returns the mean read latency since the last call, or -1 if there were no reads.
+	double takeReadLatency();
+
+	// Applies nextRateLimit() to the limiter. Returns the new rate.
+	int64_t adjustRateLimiter(rocksdb::RateLimiter* limiter, int64_t maxBytesPerSec);
+
+private:
+	std::atomic<uint64_t> readLatencyNs{ 0 };
+	std::atomic<uint64_t> readCount{ 0 };
+	std::atomic<double> pressure{ 0.0 };
+};
+
+#endif // WITH_ROCKSDB
+#endif // FDBSERVER_ROCKSDB_IO_PRESSURE_H
@@ -25,6 +25,7 @@
 #elif !defined(FDBSERVER_SERVER_CHECKPOINT_ACTOR_H)
 #define FDBSERVER_SERVER_CHECKPOINT_ACTOR_H
 
+#include "fdbclient/BackupContainer.h"
 #include "fdbclient/NativeAPI.actor.h"
 #include "fdbclient/StorageCheckpoint.h"
 #include "flow/flow.h"
@@ -87,6 +88,16 @@ ACTOR Future<CheckpointMetaData> fetchCheckpointRanges(
     std::vector<KeyRange> ranges,
     std::function<Future<Void>(const CheckpointMetaData&)> cFun = nullptr);
 
+// Converts the snapshot of `restoreSet` within `range` into SST files under the local `dir`, one per range file, so a
+// storage engine can ingest it with IKeyValueStore::restore() instead of committing every key through transactions.
+// Returns a complete RocksDBKeyValues checkpoint at the snapshot's end version. Only the snapshot is converted: the
+// mutation logs of `restoreSet` must still be applied over it through the normal restore path.
+ACTOR Future<CheckpointMetaData> buildCheckpointFromBackup(Database cx,
+                                                           Reference<IBackupContainer> bc,
+                                                           RestorableFileSet restoreSet,
+                                                           KeyRange range,
+                                                           std::string dir);
+
 std::string serverCheckpointDir(const std::string& baseDir, const UID& checkpointId);
 std::string fetchedCheckpointDir(const std::string& baseDir, const UID& checkpointId);
 #include "flow/unactorcompiler.h"
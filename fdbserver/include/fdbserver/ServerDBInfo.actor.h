@@ -105,9 +105,17 @@ struct UpdateServerDBInfoRequest {
 	std::vector<Endpoint> broadcastInfo;
 	ReplyPromise<std::vector<Endpoint>> reply;
 
+	// If present, serializedDbInfo is a delta from the ServerDBInfo with this infoGeneration: the client info and log
+	// system config flagged as omitted are left out of it and are the same as in that ServerDBInfo. A worker that
+	// doesn't have that ServerDBInfo can't apply the delta, and reports that it wasn't updated so it is sent the full
+	// ServerDBInfo.
+	Optional<int64_t> baseInfoGeneration;
+	bool omitsClient = false;
+	bool omitsLogSystemConfig = false;
+
 	template <class Ar>
 	void serialize(Ar& ar) {
-		serializer(ar, serializedDbInfo, broadcastInfo, reply);
+		serializer(ar, serializedDbInfo, broadcastInfo, reply, baseInfoGeneration, omitsClient, omitsLogSystemConfig);
 	}
 };
 
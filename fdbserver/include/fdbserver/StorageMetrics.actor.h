@@ -124,7 +124,9 @@ struct StorageServerMetrics {
 	                   KeyRef const& key,
 	                   bool hasUsed) const;
 
-	void splitMetrics(SplitMetricsRequest req) const;
+	// Splits by the bytes of the given sample instead of byteSample, which must agree with it on the bytes in req.keys
+	void splitMetrics(SplitMetricsRequest req, StorageMetricSample const& bytes) const;
+	void splitMetrics(SplitMetricsRequest req) const { splitMetrics(req, byteSample); }
 
 	void getStorageMetrics(GetStorageMetricsRequest req,
 	                       StorageBytes sb,
@@ -142,9 +144,29 @@ struct StorageServerMetrics {
 
 	int64_t getHotShards(const KeyRange& range) const;
 
-	std::vector<KeyRef> getSplitPoints(KeyRangeRef range, int64_t chunkSize, Optional<KeyRef> prefixToRemove) const;
+	std::vector<KeyRef> getSplitPoints(KeyRangeRef range,
+	                                   int64_t chunkSize,
+	                                   Optional<KeyRef> prefixToRemove,
+	                                   StorageMetricSample const& bytes) const;
+	std::vector<KeyRef> getSplitPoints(KeyRangeRef range, int64_t chunkSize, Optional<KeyRef> prefixToRemove) const {
+		return getSplitPoints(range, chunkSize, prefixToRemove, byteSample);
+	}
+
+	void getSplitPoints(SplitRangeRequest req, Optional<KeyRef> prefix, StorageMetricSample const& bytes) const;
+	void getSplitPoints(SplitRangeRequest req, Optional<KeyRef> prefix) const {
+		getSplitPoints(req, prefix, byteSample);
+	}
+
+	// The keys of the byte sample in range, spaced to at most about maxKeys by their sampled bytes, between range.begin
+	// and range.end
+	Standalone<VectorRef<KeyRef>> getByteSampleBoundaries(KeyRangeRef range, int maxKeys) const;
 
-	void getSplitPoints(SplitRangeRequest req, Optional<KeyRef> prefix) const;
+	// A byte sample of the range from the first to the last of boundaries, whose bytes are distributed like sizes, the
+	// bytes a storage engine estimates it holds between each boundary and the next, and add up to the bytes of the byte
+	// sample in the range. Split points chosen from it are still keys of the byte sample, but they divide the range by
+	// what the engine holds rather than by the few keys that happened to be sampled. The engine must estimate some
+	// bytes in the range.
+	StorageMetricSample weighByEngineSizes(VectorRef<KeyRef> boundaries, std::vector<int64_t> const& sizes) const;
 
 	[[maybe_unused]] std::vector<ReadHotRangeWithMetrics> _getReadHotRanges(
 	    KeyRangeRef shard,
@@ -0,0 +1,95 @@
+/*
+ * StorageServerReadCache.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FDBSERVER_STORAGESERVERREADCACHE_H
+#define FDBSERVER_STORAGESERVERREADCACHE_H
+#pragma once
+
+#include <list>
+#include <map>
+
+#include "fdbclient/FDBTypes.h"
+#include "flow/flow.h"
+
+// A byte bounded LRU cache of point reads served by the storage engine of a storage server. Entries mirror what the
+// engine would return, so every write to the engine must invalidate the keys it touches. A value read from the engine
+// is only inserted if the engine did not change while the read was in flight, which is tracked with a generation that
+// is advanced by every write and every commit:
+//
+//   ReadToken token = cache.beginRead();
+//   Optional<Value> v = wait(engine->readValue(key));
+//   cache.insert(key, v, token);
+class StorageServerReadCache : NonCopyable {
+public:
+	struct ReadToken {
+		uint64_t generation;
+		bool writesPending;
+	};
+
+	explicit StorageServerReadCache(int64_t capacityBytes) : capacityBytes(capacityBytes) {}
+
+	bool enabled() const { return capacityBytes > 0; }
+
+	// Returns the cached engine result for key (which may itself be an empty Optional for a missing key), or an empty
+	// Optional if key is not cached.
+	Optional<Optional<Value>> get(KeyRef key);
+
+	ReadToken beginRead() const { return ReadToken{ generation, writesPending }; }
+
+	// Caches the result of an engine read which started at token, unless the engine has been written to since then or
+	// had uncommitted writes.
+	void insert(KeyRef key, Optional<Value> const& value, ReadToken token);
+
+	// Must be called before the corresponding write is issued to the engine
+	void invalidate(KeyRef key);
+	void invalidate(KeyRangeRef range);
+	void clear();
+
+	// Must be called once the engine has committed all writes issued so far
+	void onCommit();
+
+	int64_t getBytes() const { return bytes; }
+	int64_t getEntries() const { return entries.size(); }
+
+private:
+	struct Entry {
+		Optional<Value> value;
+		std::list<KeyRef>::iterator lruPosition;
+	};
+
+	static int64_t entryBytes(KeyRef key, Optional<Value> const& value) {
+		return key.size() + (value.present() ? value.get().size() : 0) + sizeof(Entry) + 2 * sizeof(KeyRef);
+	}
+
+	void erase(std::map<Key, Entry, std::less<>>::iterator it);
+	void onWrite() {
+		++generation;
+		writesPending = true;
+	}
+
+	int64_t capacityBytes;
+	int64_t bytes = 0;
+	uint64_t generation = 0;
+	bool writesPending = false;
+	std::map<Key, Entry, std::less<>> entries;
+	std::list<KeyRef> lru; // Most recently used key at the front, the keys point into entries
+};
+
+#endif
@@ -101,6 +101,8 @@ public:
 	Future<Void> ready();
 	void addBytes(int64_t bytes);
 	void settle();
+	void setCap(int64_t cap) { this->cap = cap; }
+	int64_t getCap() const { return cap; }
 
 private:
 	int64_t cap;
@@ -110,6 +112,37 @@ private:
 	Future<Void> readyFuture;
 };
 
+// The byte rate at which a storage server serves data movement, i.e. fetchKeys reads of ReadType::FETCH and checkpoint
+// transfers, to other servers. The rate starts at STORAGE_FETCH_SOURCE_BYTES_PER_SEC and adapts to the latency of this
+// server's foreground reads, which report it through addReadLatency(), so that moves slow down while they hurt clients.
+class FetchSourceBudget {
+public:
+	explicit FetchSourceBudget(int64_t maxBytesPerSec);
+
+	bool enabled() const { return maxBytesPerSec > 0; }
+	Future<Void> ready();
+	void addBytes(int64_t bytes) { limiter.addBytes(bytes); }
+	void addReadLatency(double seconds) {
+		readLatencySum += seconds;
+		++readCount;
+	}
+	int64_t getBytesPerSec() const { return limiter.getCap(); }
+
+	// Applies nextRate() with the mean foreground read latency since the last call. Returns the new rate.
+	int64_t adjust();
+
+	// Returns the next rate given the mean foreground read latency, or a negative latency if there were no reads. The
+	// rate is cut multiplicatively while reads are slower than STORAGE_FETCH_SOURCE_READ_LATENCY_TARGET and recovers
+	// additively otherwise, staying within [STORAGE_FETCH_SOURCE_MIN_FRACTION * maxBytesPerSec, maxBytesPerSec].
+	static int64_t nextRate(int64_t current, int64_t maxBytesPerSec, double readLatency);
+
+private:
+	int64_t maxBytesPerSec;
+	ThroughputLimiter limiter;
+	double readLatencySum = 0;
+	int64_t readCount = 0;
+};
+
 KeyRange persistMoveInShardsKeyRange();
 
 KeyRange persistUpdatesKeyRange(const UID& id);
@@ -180,6 +180,17 @@ public:
 	bool operator==(TCMachineTeamInfo& rhs) const { return this->machineIDs == rhs.machineIDs; }
 };
 
+// The utilization of a team's busiest server in each dimension of the team cost, each in [0, 1]
+struct TeamUtilization {
+	double cpu = 0;
+	double diskBusy = 0;
+	double readOps = 0;
+	double writeBandwidth = 0;
+
+	// The factor by which the team cost exceeds its load bytes, minus 1
+	double busyness() const;
+};
+
 // TeamCollection's server team info.
 class TCTeamInfo final : public ReferenceCounted<TCTeamInfo>, public IDataDistributionTeam {
 	friend class TCTeamInfoImpl;
@@ -228,6 +239,10 @@ public:
 
 	int64_t getLoadBytes(bool includeInFlight = true, double inflightPenalty = 1.0) const override;
 
+	int64_t getLoadCost(bool includeInFlight = true, double inflightPenalty = 1.0) const override;
+
+	TeamUtilization getUtilization() const;
+
 	double getReadLoad(bool includeInFlight = true, double inflightPenalty = 1.0) const override;
 
 	double getAverageCPU() const override;
@@ -27,6 +27,7 @@
 #include "fdbclient/MutationList.h"
 #include "fdbclient/StorageServerInterface.h"
 #include "fdbrpc/TimedRequest.h"
+#include "flow/CompressionUtils.h"
 #include <iterator>
 
 struct TLogInterface {
@@ -53,6 +54,8 @@ struct TLogInterface {
 	RequestStream<struct TLogEnablePopRequest> enablePopRequest;
 	RequestStream<struct TLogSnapRequest> snapRequest;
 	RequestStream<struct TrackTLogRecoveryRequest> trackRecovery;
+	RequestStream<struct TLogPeekTagsRequest>
+	    peekTagsMessages; // peek several tags at once, e.g. for a storage server with many tags
 
 	TLogInterface() {}
 	explicit TLogInterface(const LocalityData& locality)
@@ -87,6 +90,7 @@ struct TLogInterface {
 		streams.push_back(snapRequest.getReceiver());
 		streams.push_back(peekStreamMessages.getReceiver(TaskPriority::TLogPeek));
 		streams.push_back(trackRecovery.getReceiver());
+		streams.push_back(peekTagsMessages.getReceiver(TaskPriority::TLogPeek));
 		FlowTransport::transport().addEndpoints(streams);
 	}
 
@@ -117,6 +121,8 @@ struct TLogInterface {
 			    RequestStream<struct TLogPeekStreamRequest>(peekMessages.getEndpoint().getAdjustedEndpoint(11));
 			trackRecovery =
 			    RequestStream<struct TrackTLogRecoveryRequest>(peekMessages.getEndpoint().getAdjustedEndpoint(12));
+			peekTagsMessages =
+			    RequestStream<struct TLogPeekTagsRequest>(peekMessages.getEndpoint().getAdjustedEndpoint(13));
 		}
 	}
 };
@@ -191,10 +197,29 @@ struct TLogPeekReply {
 	Version minKnownCommittedVersion;
 	Optional<Version> begin;
 	bool onlySpilled = false;
+	// Set if messages were compressed with this filter, which the peeker asked for in its request
+	Optional<CompressionFilter> compression;
+
+	// Replaces compressed messages with the original ones
+	void decompress() {
+		if (compression.present()) {
+			messages = CompressionUtils::decompress(compression.get(), messages, arena);
+			compression.reset();
+		}
+	}
 
 	template <class Ar>
 	void serialize(Ar& ar) {
-		serializer(ar, messages, end, popped, maxKnownVersion, minKnownCommittedVersion, begin, onlySpilled, arena);
+		serializer(ar,
+		           messages,
+		           end,
+		           popped,
+		           maxKnownVersion,
+		           minKnownCommittedVersion,
+		           begin,
+		           onlySpilled,
+		           compression,
+		           arena);
 	}
 };
 
@@ -206,18 +231,22 @@ struct TLogPeekRequest {
 	bool onlySpilled;
 	Optional<std::pair<UID, int>> sequence;
 	ReplyPromise<TLogPeekReply> reply;
+	// The reply's messages may be compressed with this filter. TLogs which don't know the field never compress.
+	Optional<CompressionFilter> compression;
 
 	TLogPeekRequest(Version begin,
 	                Tag tag,
 	                bool returnIfBlocked,
 	                bool onlySpilled,
-	                Optional<std::pair<UID, int>> sequence = Optional<std::pair<UID, int>>())
-	  : begin(begin), tag(tag), returnIfBlocked(returnIfBlocked), onlySpilled(onlySpilled), sequence(sequence) {}
+	                Optional<std::pair<UID, int>> sequence = Optional<std::pair<UID, int>>(),
+	                Optional<CompressionFilter> compression = Optional<CompressionFilter>())
+	  : begin(begin), tag(tag), returnIfBlocked(returnIfBlocked), onlySpilled(onlySpilled), sequence(sequence),
+	    compression(compression) {}
 	TLogPeekRequest() {}
 
 	template <class Ar>
 	void serialize(Ar& ar) {
-		serializer(ar, begin, tag, returnIfBlocked, onlySpilled, sequence, reply);
+		serializer(ar, begin, tag, returnIfBlocked, onlySpilled, sequence, reply, compression);
 	}
 };
 
@@ -243,14 +272,59 @@ struct TLogPeekStreamRequest {
 	bool returnIfBlocked;
 	int limitBytes;
 	ReplyPromiseStream<TLogPeekStreamReply> reply;
+	// As for TLogPeekRequest, applied to every reply on the stream
+	Optional<CompressionFilter> compression;
 
 	TLogPeekStreamRequest() {}
-	TLogPeekStreamRequest(Version version, Tag tag, bool returnIfBlocked, int limitBytes)
-	  : begin(version), tag(tag), returnIfBlocked(returnIfBlocked), limitBytes(limitBytes) {}
+	TLogPeekStreamRequest(Version version,
+	                      Tag tag,
+	                      bool returnIfBlocked,
+	                      int limitBytes,
+	                      Optional<CompressionFilter> compression = Optional<CompressionFilter>())
+	  : begin(version), tag(tag), returnIfBlocked(returnIfBlocked), limitBytes(limitBytes), compression(compression) {}
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, begin, tag, returnIfBlocked, limitBytes, reply, compression);
+	}
+};
+
+struct TLogPeekTagsReply {
+	constexpr static FileIdentifier file_identifier = 10072849;
+	Arena arena;
+	// Formatted as TLogPeekReply::messages, with each message that has any of the requested tags appearing once
+	StringRef messages;
+	Version end;
+	// The requested tags which had been popped past the request's begin version, and what they were popped to
+	std::vector<std::pair<Tag, Version>> popped;
+	Version maxKnownVersion;
+	Version minKnownCommittedVersion;
+	bool onlySpilled = false;
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, messages, end, popped, maxKnownVersion, minKnownCommittedVersion, onlySpilled, arena);
+	}
+};
+
+// Peeks the messages for a set of tags in one request, rather than one request per tag. The TLog scans its memory and
+// reads each spilled commit once for all of the tags. Only the current TLog version serves this; older TLogs and log
+// routers reply with unsupported_operation.
+struct TLogPeekTagsRequest {
+	constexpr static FileIdentifier file_identifier = 10072822;
+	Version begin;
+	std::vector<Tag> tags;
+	bool returnIfBlocked;
+	bool onlySpilled;
+	ReplyPromise<TLogPeekTagsReply> reply;
+
+	TLogPeekTagsRequest(Version begin, std::vector<Tag> tags, bool returnIfBlocked, bool onlySpilled)
+	  : begin(begin), tags(std::move(tags)), returnIfBlocked(returnIfBlocked), onlySpilled(onlySpilled) {}
+	TLogPeekTagsRequest() {}
 
 	template <class Ar>
 	void serialize(Ar& ar) {
-		serializer(ar, begin, tag, returnIfBlocked, limitBytes, reply);
+		serializer(ar, begin, tags, returnIfBlocked, onlySpilled, reply);
 	}
 };
 
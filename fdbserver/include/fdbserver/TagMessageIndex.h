@@ -0,0 +1,229 @@
+/*
+ * TagMessageIndex.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FDBSERVER_TAGMESSAGEINDEX_H
+#define FDBSERVER_TAGMESSAGEINDEX_H
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <new>
+
+#include "flow/Arena.h"
+#include "flow/Error.h"
+#include "flow/FastAlloc.h"
+
+struct LengthPrefixedStringRef {
+	// Represents a pointer to a string which is prefixed by a 4-byte length
+	// A LengthPrefixedStringRef is only pointer-sized (8 bytes vs 12 bytes for StringRef), but the corresponding string
+	// is 4 bytes bigger, and substring operations aren't efficient as they are with StringRef.  It's a good choice when
+	// there might be lots of references to the same exact string.
+
+	uint32_t* length;
+
+	StringRef toStringRef() const {
+		ASSERT(length);
+		return StringRef((uint8_t*)(length + 1), *length);
+	}
+	int expectedSize() const {
+		ASSERT(length);
+		return *length;
+	}
+	uint32_t* getLengthPtr() const { return length; }
+
+	LengthPrefixedStringRef() : length(nullptr) {}
+	LengthPrefixedStringRef(uint32_t* length) : length(length) {}
+};
+
+// The messages a TLog holds in memory for one tag, in version order. Messages are appended as versions are committed
+// and removed from the front as the tag is popped or spilled.
+//
+// A std::deque<std::pair<Version, LengthPrefixedStringRef>> spends 16 bytes on every message, plus the deque's own
+// overhead. Here messages live in fixed size blocks from FastAllocator, and each version is stored as a 32-bit delta
+// from the first version in its block, so a message costs a little over 12 bytes. The versions and messages of a block
+// are kept in separate arrays so that searching by version only touches the deltas.
+//
+// As with std::deque, appending and popping may invalidate iterators; callers which hold an iterator across a wait
+// should find their place again with lower_bound() or upper_bound().
+class TagMessageIndex {
+public:
+	static constexpr int kBlockBytes = 1024;
+	static constexpr int kBlockEntries = 83; // The most that fit in kBlockBytes
+
+private:
+	struct Block {
+		Version baseVersion;
+		Block* next;
+		int begin;
+		int end;
+		uint32_t versionDeltas[kBlockEntries];
+		LengthPrefixedStringRef messages[kBlockEntries];
+
+		Version version(int i) const { return baseVersion + versionDeltas[i]; }
+		Version lastVersion() const { return version(end - 1); }
+	};
+	static_assert(sizeof(Block) <= kBlockBytes);
+
+public:
+	class iterator {
+	public:
+		iterator() : block(nullptr), index(0) {}
+
+		Version version() const { return block->version(index); }
+		LengthPrefixedStringRef message() const { return block->messages[index]; }
+
+		iterator& operator++() {
+			if (++index == block->end) {
+				block = block->next;
+				index = block ? block->begin : 0;
+			}
+			return *this;
+		}
+		bool operator==(iterator const& r) const { return block == r.block && index == r.index; }
+		bool operator!=(iterator const& r) const { return !(*this == r); }
+
+	private:
+		friend class TagMessageIndex;
+		iterator(Block* block, int index) : block(block), index(index) {}
+
+		Block* block;
+		int index;
+	};
+
+	TagMessageIndex() : count(0) {}
+	~TagMessageIndex() { clear(); }
+	TagMessageIndex(TagMessageIndex const&) = delete;
+	TagMessageIndex& operator=(TagMessageIndex const&) = delete;
+	TagMessageIndex(TagMessageIndex&& r) noexcept : blocks(std::move(r.blocks)), count(r.count) {
+		r.blocks.clear();
+		r.count = 0;
+	}
+	TagMessageIndex& operator=(TagMessageIndex&& r) noexcept {
+		if (this != &r) {
+			clear();
+			blocks = std::move(r.blocks);
+			count = r.count;
+			r.blocks.clear();
+			r.count = 0;
+		}
+		return *this;
+	}
+
+	bool empty() const { return count == 0; }
+	size_t size() const { return count; }
+
+	// Bytes allocated for blocks, which is what the TLog's memory accounting has to cover
+	int64_t allocatedBytes() const { return int64_t(blocks.size()) * kBlockBytes; }
+
+	iterator begin() const { return empty() ? end() : iterator(blocks.front(), blocks.front()->begin); }
+	iterator end() const { return iterator(); }
+
+	Version frontVersion() const { return blocks.front()->version(blocks.front()->begin); }
+	LengthPrefixedStringRef frontMessage() const { return blocks.front()->messages[blocks.front()->begin]; }
+	Version backVersion() const { return blocks.back()->lastVersion(); }
+	LengthPrefixedStringRef backMessage() const { return blocks.back()->messages[blocks.back()->end - 1]; }
+
+	// Versions must not decrease
+	void push_back(Version version, LengthPrefixedStringRef message) {
+		Block* tail = blocks.empty() ? nullptr : blocks.back();
+		ASSERT(!tail || version >= tail->lastVersion());
+		if (!tail || tail->end == kBlockEntries ||
+		    version - tail->baseVersion > std::numeric_limits<uint32_t>::max()) {
+			Block* block = new (FastAllocator<kBlockBytes>::allocate()) Block;
+			block->baseVersion = version;
+			block->next = nullptr;
+			block->begin = block->end = 0;
+			if (tail) {
+				tail->next = block;
+			}
+			blocks.push_back(block);
+			tail = block;
+		}
+		tail->versionDeltas[tail->end] = version - tail->baseVersion;
+		tail->messages[tail->end] = message;
+		++tail->end;
+		++count;
+	}
+
+	void pop_front() {
+		Block* head = blocks.front();
+		if (++head->begin == head->end) {
+			blocks.pop_front();
+			freeBlock(head);
+		}
+		--count;
+	}
+
+	// First message with a version >= version
+	iterator lower_bound(Version version) const {
+		auto b = std::partition_point(
+		    blocks.begin(), blocks.end(), [version](Block* block) { return block->lastVersion() < version; });
+		if (b == blocks.end()) {
+			return end();
+		}
+		Block* block = *b;
+		if (version <= block->baseVersion) {
+			return iterator(block, block->begin);
+		}
+		uint32_t delta = version - block->baseVersion;
+		return iterator(block,
+		                std::lower_bound(block->versionDeltas + block->begin, block->versionDeltas + block->end, delta) -
+		                    block->versionDeltas);
+	}
+
+	// First message with a version > version
+	iterator upper_bound(Version version) const {
+		auto b = std::partition_point(
+		    blocks.begin(), blocks.end(), [version](Block* block) { return block->lastVersion() <= version; });
+		if (b == blocks.end()) {
+			return end();
+		}
+		Block* block = *b;
+		if (version < block->baseVersion) {
+			return iterator(block, block->begin);
+		}
+		uint32_t delta = version - block->baseVersion;
+		return iterator(block,
+		                std::upper_bound(block->versionDeltas + block->begin, block->versionDeltas + block->end, delta) -
+		                    block->versionDeltas);
+	}
+
+	void clear() {
+		for (Block* block : blocks) {
+			freeBlock(block);
+		}
+		blocks.clear();
+		count = 0;
+	}
+
+private:
+	static void freeBlock(Block* block) {
+		block->~Block();
+		FastAllocator<kBlockBytes>::release(block);
+	}
+
+	// Blocks in version order. They are also linked to each other, so that iterating does not need to index this.
+	std::deque<Block*> blocks;
+	size_t count;
+};
+
+#endif
@@ -0,0 +1,159 @@
+/*
+ * TenantPrefixIndex.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FDBSERVER_TENANTPREFIXINDEX_H
+#define FDBSERVER_TENANTPREFIXINDEX_H
+#pragma once
+
+#include <deque>
+#include <map>
+#include <vector>
+
+#include "fdbclient/FDBTypes.h"
+#include "fdbclient/Tenant.h"
+#include "fdbrpc/Stats.h"
+#include "flow/flow.h"
+
+// The tenants known to a storage server or commit proxy and their lock states, as of each version from the oldest
+// readable version to the latest. A tenant's prefix is its id encoded big endian, so tenants are ordered by id in the
+// same order as their key ranges.
+//
+// The tenants as of the oldest version that has been compacted are kept in flat arrays sorted by id, 9 bytes per
+// tenant, and the changes since then in per-tenant histories. Once enough histories have fallen entirely before the
+// oldest readable version they are merged into the arrays in a single pass, so the histories stay a small fraction of
+// the tenants. Compared to a VersionedMap, whose tree nodes cost tens of bytes each, this keeps the memory of a million
+// tenants to around 10MB, and a lookup is a branchless binary search over contiguous ids rather than a walk through
+// pointers.
+class TenantPrefixIndex : NonCopyable {
+public:
+	using LockState = TenantAPI::TenantLockState;
+
+	// The lock state of the tenant with the given id as of version, if it exists then
+	Optional<LockState> find(int64_t id, Version version) const {
+		if (lookupLatency != nullptr && (++lookupCount % LOOKUP_SAMPLE_INTERVAL) == 0) {
+			double start = timer_monotonic();
+			Optional<LockState> result = findAt(id, version);
+			lookupLatency->addMeasurement(timer_monotonic() - start);
+			return result;
+		}
+		return findAt(id, version);
+	}
+	bool contains(int64_t id, Version version) const { return find(id, version).present(); }
+	bool contains(int64_t id) const { return contains(id, latestVersion); }
+
+	// Whether a tenant with an id in [beginId, endId] exists as of version
+	bool containsAny(int64_t beginId, int64_t endId, Version version) const;
+
+	// Calls f(id, lockState) for each tenant with an id in [beginId, endId) as of the latest version, in order of id
+	template <class F>
+	void forEachTenant(int64_t beginId, int64_t endId, F f) const;
+
+	// Changes must be made at versions no older than the latest version so far
+	void insert(int64_t id, LockState lockState, Version version);
+	void erase(int64_t id, Version version);
+
+	// Versions before version can no longer be read
+	void forgetVersionsBefore(Version version);
+
+	// Loads the tenants of an empty index, such as when restoring it from disk, directly into the arrays. The ids must
+	// be sorted.
+	void restore(std::vector<int64_t>&& ids, std::vector<LockState>&& lockStates);
+
+	Version getOldestVersion() const { return oldestVersion; }
+	Version getLatestVersion() const { return latestVersion; }
+
+	// The number of tenants as of the latest version
+	int64_t size() const { return count; }
+	bool empty() const { return count == 0; }
+	// Whether there are no tenants as of any version that can be read, which is cheaper to check than reading
+	bool emptyAtAllVersions() const { return ids.empty() && histories.empty(); }
+
+	// Approximate bytes used by the index
+	int64_t memoryUsage() const;
+
+	// Samples the latency of one in LOOKUP_SAMPLE_INTERVAL lookups into sample
+	void setLookupLatencySample(LatencySample* sample) { lookupLatency = sample; }
+
+private:
+	static constexpr int LOOKUP_SAMPLE_INTERVAL = 64;
+
+	// The state of a tenant from a version on, where an absent lock state means the tenant does not exist
+	struct Change {
+		Version version;
+		Optional<LockState> lockState;
+	};
+
+	// The changes to a tenant after the arrays were compacted, in order of version
+	struct History {
+		std::vector<Change> changes;
+		bool settled = false; // only one change is left and it is at or before the oldest version
+	};
+
+	Version oldestVersion = 0;
+	Version latestVersion = 0;
+	int64_t count = 0;
+
+	std::vector<int64_t> ids; // sorted
+	std::vector<LockState> lockStates; // of the tenant at the same index in ids
+	std::map<int64_t, History> histories;
+	std::deque<std::pair<Version, int64_t>> changeLog; // the version and tenant of each change, in order of version
+	int64_t settledHistories = 0;
+
+	mutable int64_t lookupCount = 0;
+	LatencySample* lookupLatency = nullptr;
+
+	// The index of the first of ids that is not less than id
+	static int lowerBound(std::vector<int64_t> const& ids, int64_t id);
+
+	// The last change in history at or before version, or nullptr if it was made after version
+	static Change const* changeAt(History const& history, Version version);
+
+	Optional<LockState> findAt(int64_t id, Version version) const;
+	void addChange(int64_t id, Version version, Optional<LockState> lockState);
+	void compact();
+};
+
+template <class F>
+void TenantPrefixIndex::forEachTenant(int64_t beginId, int64_t endId, F f) const {
+	int i = lowerBound(ids, beginId);
+	auto h = histories.lower_bound(beginId);
+	loop {
+		bool inArrays = i < ids.size() && ids[i] < endId;
+		bool inHistories = h != histories.end() && h->first < endId;
+		if (!inArrays && !inHistories) {
+			break;
+		}
+		if (inHistories && (!inArrays || h->first <= ids[i])) {
+			Optional<LockState> const& lockState = h->second.changes.back().lockState;
+			if (lockState.present()) {
+				f(h->first, lockState.get());
+			}
+			if (inArrays && ids[i] == h->first) {
+				++i;
+			}
+			++h;
+		} else {
+			f(ids[i], lockStates[i]);
+			++i;
+		}
+	}
+}
+
+#endif
@@ -31,8 +31,9 @@ public:
 	TransactionTagCounter(UID thisServerID, int maxTagsTracked, double minRateTracked);
 	~TransactionTagCounter();
 
-	// Update counters tracking the busyness of each tag in the current interval
-	void addRequest(Optional<TagSet> const& tags, int64_t bytes);
+	// Update counters tracking the busyness of each tag in the current interval. Range reads pass the number of rows
+	// they read, each of which costs READ_TAG_COST_PER_ROW on top of the bytes read.
+	void addRequest(Optional<TagSet> const& tags, int64_t bytes, int64_t rows = 0);
 
 	// Save current set of busy tags and reset counters for next interval
 	void startNewInterval();
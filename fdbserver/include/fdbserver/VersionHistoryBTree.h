@@ -0,0 +1,556 @@
+/*
+ * VersionHistoryBTree.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FDBSERVER_VERSIONHISTORYBTREE_H
+#define FDBSERVER_VERSIONHISTORYBTREE_H
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "flow/Arena.h"
+#include "flow/Error.h"
+#include "flow/FastAlloc.h"
+#include "flow/Platform.h"
+
+// The write history of a resolver's ConflictSet, as an alternative to its SkipList. Like the SkipList it maps each key
+// in a sorted set of boundaries to the last version written in the range from that key up to the next one, and the
+// empty key is always a boundary.
+//
+// Boundaries live in a B+tree whose nodes keep the first 8 bytes of each key as a big-endian integer, in one array,
+// so finding a key in a node compares fixed-width integers without following pointers and the compiler can vectorize
+// it. Keys of up to 8 bytes are held entirely in that array. Longer keys are also stored out of line and only read to
+// order keys with the same first 8 bytes, so this does best when keys are short or differ early. Each internal node
+// keeps the largest version below each child, which lets read checks skip whole subtrees.
+//
+// Nodes are not merged as boundaries are removed. Empty nodes are dropped, and once the tree is mostly empty space it
+// is rebuilt.
+class VersionHistoryBTree : NonCopyable {
+public:
+	static constexpr int kFanout = 16;
+
+	explicit VersionHistoryBTree(Version version = 0) : root(newNode(true)), entryCount(1), leafCount(1) {
+		setKey(root, 0, StringRef());
+		root->version[0] = version;
+		root->count = 1;
+	}
+	~VersionHistoryBTree() { destroy(root); }
+
+	// The number of boundaries, including the empty key
+	int count() const { return entryCount; }
+
+	// Returns true if anything in [begin, end) was written after version. An empty range is checked against the range
+	// before begin, as SkipList::detectConflicts does.
+	bool newerThan(StringRef begin, StringRef end, Version version) const {
+		const uint64_t beginPrefix = prefixOf(begin);
+		const Node* leaf;
+		int i;
+		if (!(begin < end)) {
+			lessThan(beginPrefix, begin, leaf, i);
+			return leaf->version[i] > version;
+		}
+		atOrBefore(beginPrefix, begin, leaf, i);
+		if (leaf->version[i] > version)
+			return true;
+		return newerInside(root, beginPrefix, begin, prefixOf(end), end, version, false, false);
+	}
+
+	// Records that [begin, end) was written at version, replacing any history inside it
+	void set(StringRef begin, StringRef end, Version version) {
+		ASSERT(begin < end);
+		const uint64_t endPrefix = prefixOf(end);
+		const Node* leaf;
+		int i;
+		atOrBefore(endPrefix, end, leaf, i);
+		if (compare(endPrefix, end, leaf, i) != 0)
+			insert(endPrefix, end, leaf->version[i]);
+		erase(prefixOf(begin), begin, endPrefix, end);
+		insert(prefixOf(begin), begin, version);
+	}
+
+	// Examines up to nodeCount boundaries, starting at the first one >= from, and removes those which, along with the
+	// boundary before them, are older than version. Returns where the next call should start, which is the empty key
+	// once the end is reached.
+	Key removeBefore(Version version, StringRef from, int nodeCount) {
+		const uint64_t fromPrefix = prefixOf(from);
+		Node* leaf = findLeaf(fromPrefix, from);
+		int i = lowerBound(leaf, fromPrefix, from);
+		bool wasAbove = true;
+		bool changed = false;
+		while (leaf) {
+			if (i == leaf->count) {
+				if (changed)
+					updateVersions(leaf);
+				leaf = leaf->next;
+				i = 0;
+				changed = false;
+				continue;
+			}
+			if (!leaf->prev && i == 0) {
+				// The empty key, which like the SkipList's header is always kept and not counted
+				i++;
+				continue;
+			}
+			if (!nodeCount--)
+				break;
+			const bool isAbove = leaf->version[i] >= version;
+			if (isAbove || wasAbove) {
+				i++;
+			} else {
+				eraseEntries(leaf, i, i + 1);
+				changed = true;
+				if (!leaf->count && leaf != root) {
+					Node* next = leaf->next;
+					removeLeaf(leaf);
+					leaf = next;
+					changed = false;
+				}
+			}
+			wasAbove = isAbove;
+		}
+		Key resume;
+		if (leaf) {
+			if (changed)
+				updateVersions(leaf);
+			resume = keyOf(leaf, i);
+		}
+		if (leafCount > 2 && entryCount < leafCount * kFanout / 4)
+			rebuild();
+		return resume;
+	}
+
+private:
+	struct alignas(64) Node {
+		// Only prefix is read while searching a node. Unused slots hold the largest prefix, so that counting the
+		// prefixes below a key gives its position.
+		uint64_t prefix[kFanout];
+		// In leaves, the version of the range starting at each key. In internal nodes, the largest version below
+		// each child.
+		Version version[kFanout];
+		int length[kFanout];
+		uint8_t* data[kFanout]; // The whole key, for keys longer than 8 bytes
+		Node* children[kFanout]; // In internal nodes, and each key is a lower bound for its child's keys
+		Node* parent;
+		Node* prev; // Leaves are linked in key order
+		Node* next;
+		int count;
+		bool leaf;
+	};
+
+	Node* root;
+	int entryCount;
+	int leafCount;
+
+	static uint64_t prefixOf(StringRef key) {
+		uint64_t p = 0;
+		if (key.size())
+			memcpy(&p, key.begin(), std::min(key.size(), 8));
+		return bigEndian64(p);
+	}
+
+	static Node* newNode(bool leaf) {
+		Node* n = new Node;
+		std::fill(n->prefix, n->prefix + kFanout, std::numeric_limits<uint64_t>::max());
+		n->parent = n->prev = n->next = nullptr;
+		n->count = 0;
+		n->leaf = leaf;
+		return n;
+	}
+
+	static void setKey(Node* n, int i, StringRef key) {
+		n->prefix[i] = prefixOf(key);
+		n->length[i] = key.size();
+		if (key.size() > 8) {
+			n->data[i] = (uint8_t*)allocateFast(key.size());
+			memcpy(n->data[i], key.begin(), key.size());
+		}
+	}
+
+	static void freeKey(Node* n, int i) {
+		if (n->length[i] > 8)
+			freeFast(n->length[i], n->data[i]);
+	}
+
+	// Moves entries [begin, count) of n to the end of to
+	static void moveEntries(Node* n, int begin, Node* to) {
+		for (int i = begin; i < n->count; i++) {
+			const int j = to->count++;
+			to->prefix[j] = n->prefix[i];
+			to->version[j] = n->version[i];
+			to->length[j] = n->length[i];
+			to->data[j] = n->data[i];
+			if (!n->leaf) {
+				to->children[j] = n->children[i];
+				to->children[j]->parent = to;
+			}
+			n->prefix[i] = std::numeric_limits<uint64_t>::max();
+		}
+		n->count = begin;
+	}
+
+	static Key keyOf(const Node* n, int i) {
+		if (n->length[i] > 8)
+			return Key(StringRef(n->data[i], n->length[i]));
+		const uint64_t p = bigEndian64(n->prefix[i]);
+		return Key(StringRef((const uint8_t*)&p, n->length[i]));
+	}
+
+	// Compares key with entry i of n
+	static int compare(uint64_t keyPrefix, StringRef key, const Node* n, int i) {
+		if (keyPrefix != n->prefix[i])
+			return keyPrefix < n->prefix[i] ? -1 : 1;
+		const int length = n->length[i];
+		if (key.size() > 8 && length > 8) {
+			const int c = memcmp(key.begin() + 8, n->data[i] + 8, std::min(key.size(), length) - 8);
+			if (c)
+				return c;
+		}
+		return key.size() < length ? -1 : key.size() > length;
+	}
+
+	// The number of entries of n which are < key
+	static int lowerBound(const Node* n, uint64_t keyPrefix, StringRef key) {
+		int i = 0;
+		for (int j = 0; j < kFanout; j++)
+			i += n->prefix[j] < keyPrefix;
+		while (i < n->count && n->prefix[i] == keyPrefix && compare(keyPrefix, key, n, i) > 0)
+			i++;
+		return i;
+	}
+
+	// The number of entries of n which are <= key
+	static int upperBound(const Node* n, uint64_t keyPrefix, StringRef key) {
+		int i = 0;
+		for (int j = 0; j < kFanout; j++)
+			i += n->prefix[j] <= keyPrefix;
+		i = std::min(i, n->count);
+		while (i > 0 && n->prefix[i - 1] == keyPrefix && compare(keyPrefix, key, n, i - 1) < 0)
+			i--;
+		return i;
+	}
+
+	static Version maxVersion(const Node* n) {
+		Version v = n->version[0];
+		for (int i = 1; i < n->count; i++)
+			v = std::max(v, n->version[i]);
+		return v;
+	}
+
+	static int childIndex(const Node* parent, const Node* child) {
+		int i = 0;
+		while (parent->children[i] != child)
+			i++;
+		return i;
+	}
+
+	Node* findLeaf(uint64_t keyPrefix, StringRef key) const {
+		Node* n = root;
+		while (!n->leaf)
+			n = n->children[std::max(upperBound(n, keyPrefix, key) - 1, 0)];
+		return n;
+	}
+
+	// Finds the last entry <= key
+	void atOrBefore(uint64_t keyPrefix, StringRef key, const Node*& leaf, int& i) const {
+		leaf = findLeaf(keyPrefix, key);
+		i = upperBound(leaf, keyPrefix, key) - 1;
+		if (i < 0) {
+			leaf = leaf->prev;
+			i = leaf->count - 1;
+		}
+	}
+
+	// Finds the last entry < key, or the empty key if there is none
+	void lessThan(uint64_t keyPrefix, StringRef key, const Node*& leaf, int& i) const {
+		leaf = findLeaf(keyPrefix, key);
+		i = lowerBound(leaf, keyPrefix, key) - 1;
+		if (i < 0) {
+			if (leaf->prev) {
+				leaf = leaf->prev;
+				i = leaf->count - 1;
+			} else {
+				i = 0;
+			}
+		}
+	}
+
+	// Returns true if an entry of n's subtree which is > begin and < end has a version newer than version.
+	// aboveBegin and belowEnd say whether all of n's keys are known to be past that bound.
+	bool newerInside(const Node* n,
+	                 uint64_t beginPrefix,
+	                 StringRef begin,
+	                 uint64_t endPrefix,
+	                 StringRef end,
+	                 Version version,
+	                 bool aboveBegin,
+	                 bool belowEnd) const {
+		const int first = aboveBegin ? 0 : upperBound(n, beginPrefix, begin);
+		const int last = belowEnd ? n->count : lowerBound(n, endPrefix, end);
+		if (n->leaf) {
+			Version v = std::numeric_limits<Version>::min();
+			for (int i = first; i < last; i++)
+				v = std::max(v, n->version[i]);
+			return v > version;
+		}
+		// Child i has keys > begin if i >= first - 1, and all of them if i >= first. Likewise it has keys < end if
+		// i < last, and all of them if i + 1 < last.
+		for (int i = std::max(first - 1, 0); i < last; i++) {
+			const bool childAboveBegin = aboveBegin || i >= first;
+			const bool childBelowEnd = belowEnd || i + 1 < last;
+			if (childAboveBegin && childBelowEnd) {
+				if (n->version[i] > version)
+					return true;
+			} else if (newerInside(n->children[i],
+			                       beginPrefix,
+			                       begin,
+			                       endPrefix,
+			                       end,
+			                       version,
+			                       childAboveBegin,
+			                       childBelowEnd)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Brings the largest versions kept by n's ancestors up to date with n
+	void updateVersions(Node* n) {
+		while (n->parent) {
+			const Version v = maxVersion(n);
+			const int i = childIndex(n->parent, n);
+			if (n->parent->version[i] == v)
+				return;
+			n->parent->version[i] = v;
+			n = n->parent;
+		}
+	}
+
+	void insert(uint64_t keyPrefix, StringRef key, Version version) {
+		Node* leaf = findLeaf(keyPrefix, key);
+		int i = lowerBound(leaf, keyPrefix, key);
+		if (i < leaf->count && compare(keyPrefix, key, leaf, i) == 0) {
+			leaf->version[i] = version;
+			updateVersions(leaf);
+			return;
+		}
+		if (leaf->count == kFanout) {
+			Node* right = split(leaf);
+			if (i > leaf->count) {
+				i -= leaf->count;
+				leaf = right;
+			}
+		}
+		insertEntry(leaf, i, key);
+		leaf->version[i] = version;
+		entryCount++;
+		updateVersions(leaf);
+	}
+
+	// Makes room at i in n, which must not be full, and puts key there
+	static void insertEntry(Node* n, int i, StringRef key) {
+		const int moved = n->count - i;
+		memmove(n->prefix + i + 1, n->prefix + i, moved * sizeof(n->prefix[0]));
+		memmove(n->version + i + 1, n->version + i, moved * sizeof(n->version[0]));
+		memmove(n->length + i + 1, n->length + i, moved * sizeof(n->length[0]));
+		memmove(n->data + i + 1, n->data + i, moved * sizeof(n->data[0]));
+		if (!n->leaf)
+			memmove(n->children + i + 1, n->children + i, moved * sizeof(n->children[0]));
+		setKey(n, i, key);
+		n->count++;
+	}
+
+	// Moves the upper half of n, which is full, into a new node after it and returns that node
+	Node* split(Node* n) {
+		Node* right = newNode(n->leaf);
+		moveEntries(n, kFanout / 2, right);
+		if (n->leaf) {
+			right->prev = n;
+			right->next = n->next;
+			if (n->next)
+				n->next->prev = right;
+			n->next = right;
+			leafCount++;
+		}
+
+		if (!n->parent) {
+			Node* newRoot = newNode(false);
+			setKey(newRoot, 0, StringRef());
+			newRoot->children[0] = n;
+			newRoot->count = 1;
+			n->parent = newRoot;
+			root = newRoot;
+		}
+		Node* parent = n->parent;
+		int i = childIndex(parent, n) + 1;
+		if (parent->count == kFanout) {
+			Node* parentRight = split(parent);
+			if (i > parent->count) {
+				i -= parent->count;
+				parent = parentRight;
+			}
+		}
+		const Key first = keyOf(right, 0);
+		insertEntry(parent, i, first);
+		parent->children[i] = right;
+		right->parent = parent;
+		parent->version[i - 1] = maxVersion(n);
+		parent->version[i] = maxVersion(right);
+		return right;
+	}
+
+	// Removes entries [begin, end) of n, which must not include all of an internal node's children
+	void eraseEntries(Node* n, int begin, int end) {
+		for (int i = begin; i < end; i++)
+			freeKey(n, i);
+		const int moved = n->count - end;
+		memmove(n->prefix + begin, n->prefix + end, moved * sizeof(n->prefix[0]));
+		memmove(n->version + begin, n->version + end, moved * sizeof(n->version[0]));
+		memmove(n->length + begin, n->length + end, moved * sizeof(n->length[0]));
+		memmove(n->data + begin, n->data + end, moved * sizeof(n->data[0]));
+		if (!n->leaf)
+			memmove(n->children + begin, n->children + end, moved * sizeof(n->children[0]));
+		std::fill(n->prefix + n->count - (end - begin), n->prefix + n->count, std::numeric_limits<uint64_t>::max());
+		n->count -= end - begin;
+		if (n->leaf)
+			entryCount -= end - begin;
+	}
+
+	// Removes the entries in [begin, end)
+	void erase(uint64_t beginPrefix, StringRef begin, uint64_t endPrefix, StringRef end) {
+		Node* leaf = findLeaf(beginPrefix, begin);
+		int i = lowerBound(leaf, beginPrefix, begin);
+		while (leaf) {
+			const int last = lowerBound(leaf, endPrefix, end);
+			Node* next = last == leaf->count ? leaf->next : nullptr;
+			if (i < last) {
+				eraseEntries(leaf, i, last);
+				if (!leaf->count && leaf != root)
+					removeLeaf(leaf);
+				else
+					updateVersions(leaf);
+			}
+			leaf = next;
+			i = 0;
+		}
+	}
+
+	// Drops leaf, which is empty, from the tree along with any ancestors it leaves empty
+	void removeLeaf(Node* leaf) {
+		if (leaf->prev)
+			leaf->prev->next = leaf->next;
+		if (leaf->next)
+			leaf->next->prev = leaf->prev;
+		leafCount--;
+
+		Node* n = leaf;
+		Node* parent = n->parent;
+		while (parent->count == 1 && parent != root) {
+			delete n;
+			n = parent;
+			parent = n->parent;
+			freeKey(n, 0);
+		}
+		ASSERT(parent->count > 1);
+		const int i = childIndex(parent, n);
+		delete n;
+		// The remaining children cover the removed child's keys. If it was the first, the next child takes its lower
+		// bound, so that keys before the next child's still lead somewhere.
+		if (i == 0) {
+			parent->children[0] = parent->children[1];
+			parent->version[0] = parent->version[1];
+			eraseEntries(parent, 1, 2);
+		} else {
+			eraseEntries(parent, i, i + 1);
+		}
+		updateVersions(parent);
+		while (!root->leaf && root->count == 1) {
+			Node* child = root->children[0];
+			freeKey(root, 0);
+			delete root;
+			root = child;
+			root->parent = nullptr;
+		}
+	}
+
+	// Rebuilds the tree with leaves three quarters full
+	void rebuild() {
+		Node* oldRoot = root;
+		std::vector<Node*> level;
+		Node* leaf = newNode(true);
+		level.push_back(leaf);
+		for (Node* from = leftmostLeaf(oldRoot); from; from = from->next) {
+			for (int i = 0; i < from->count; i++) {
+				if (leaf->count == kFanout * 3 / 4) {
+					Node* next = newNode(true);
+					next->prev = leaf;
+					leaf->next = next;
+					level.push_back(next);
+					leaf = next;
+				}
+				const int j = leaf->count++;
+				leaf->prefix[j] = from->prefix[i];
+				leaf->version[j] = from->version[i];
+				leaf->length[j] = from->length[i];
+				leaf->data[j] = from->data[i];
+			}
+			// The keys now belong to the new leaves
+			std::fill(from->length, from->length + from->count, 0);
+		}
+		destroy(oldRoot);
+		leafCount = level.size();
+
+		while (level.size() > 1) {
+			std::vector<Node*> parents;
+			for (int c = 0; c < level.size(); c++) {
+				if (c % (kFanout * 3 / 4) == 0)
+					parents.push_back(newNode(false));
+				Node* parent = parents.back();
+				const int j = parent->count++;
+				setKey(parent, j, c ? keyOf(leftmostLeaf(level[c]), 0) : Key());
+				parent->version[j] = maxVersion(level[c]);
+				parent->children[j] = level[c];
+				level[c]->parent = parent;
+			}
+			level = std::move(parents);
+		}
+		root = level[0];
+	}
+
+	static Node* leftmostLeaf(Node* n) {
+		while (!n->leaf)
+			n = n->children[0];
+		return n;
+	}
+
+	static void destroy(Node* n) {
+		for (int i = 0; i < n->count; i++) {
+			freeKey(n, i);
+			if (!n->leaf)
+				destroy(n->children[i]);
+		}
+		delete n;
+	}
+};
+
+#endif
@@ -0,0 +1,113 @@
+/*
+ * WorkerThreads.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FDBSERVER_WORKERTHREADS_H
+#define FDBSERVER_WORKERTHREADS_H
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "flow/Arena.h"
+#include "flow/Error.h"
+
+// A fixed set of threads for splitting CPU-bound work on the network thread into pieces. The thread calling run() works
+// alongside them and returns once every piece is done, so to its caller the work is still synchronous.
+//
+// Pieces may only share flow objects that are read and never copied: Reference counts and Arenas are not thread safe.
+// Simulation must stay on one thread, so there callers should run the pieces themselves rather than create
+// WorkerThreads.
+class WorkerThreads : NonCopyable {
+public:
+	explicit WorkerThreads(int threadCount) {
+		for (int i = 0; i < threadCount; i++)
+			threads.emplace_back([this] { work(); });
+	}
+	~WorkerThreads() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		wake.notify_all();
+		for (auto& thread : threads)
+			thread.join();
+	}
+
+	// Calls f(i) for each i in [0, count) and waits for all of them
+	void run(int count, const std::function<void(int)>& f) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			job = &f;
+			next = 0;
+			jobCount = remaining = count;
+			error = Optional<Error>();
+		}
+		wake.notify_all();
+
+		std::unique_lock<std::mutex> lock(mutex);
+		while (next < jobCount)
+			runOne(lock);
+		done.wait(lock, [this] { return remaining == 0; });
+		job = nullptr;
+		if (error.present())
+			throw error.get();
+	}
+
+private:
+	void work() {
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true) {
+			wake.wait(lock, [this] { return stopping || (job && next < jobCount); });
+			if (stopping)
+				return;
+			runOne(lock);
+		}
+	}
+
+	// pre: lock is held and next < jobCount
+	void runOne(std::unique_lock<std::mutex>& lock) {
+		int i = next++;
+		lock.unlock();
+		Optional<Error> e;
+		try {
+			(*job)(i);
+		} catch (Error& err) {
+			e = err;
+		}
+		lock.lock();
+		if (e.present() && !error.present())
+			error = e;
+		if (--remaining == 0)
+			done.notify_all();
+	}
+
+	std::mutex mutex;
+	std::condition_variable wake, done;
+	std::vector<std::thread> threads;
+	const std::function<void(int)>* job = nullptr;
+	int next = 0, jobCount = 0, remaining = 0;
+	Optional<Error> error;
+	bool stopping = false;
+};
+
+#endif
@@ -85,6 +85,9 @@ struct TransactionWrapper : public ReferenceCounted<TransactionWrapper> {
 	// Prints debugging messages for a transaction; not implemented for all transaction types
 	virtual void debugTransaction(UID debugId) {}
 
+	// Sets an option on the transaction
+	virtual void setOption(FDBTransactionOptions::Option option, Optional<StringRef> value = Optional<StringRef>()) = 0;
+
 	virtual void addReadConflictRange(KeyRangeRef const& keys) = 0;
 };
 
@@ -166,6 +169,10 @@ struct FlowTransactionWrapper : public TransactionWrapper {
 	// Prints debugging messages for a transaction
 	void debugTransaction(UID debugId) override { transaction.debugTransaction(debugId); }
 
+	void setOption(FDBTransactionOptions::Option option, Optional<StringRef> value) override {
+		transaction.setOption(option, value);
+	}
+
 	void addReadConflictRange(KeyRangeRef const& keys) override { transaction.addReadConflictRange(keys); }
 };
 
@@ -233,6 +240,10 @@ struct ThreadTransactionWrapper : public TransactionWrapper {
 	// Gets the spanContext of a transaction
 	Future<SpanContext> getSpanContext() override { return unsafeThreadFutureToFuture(transaction->getSpanContext()); }
 
+	void setOption(FDBTransactionOptions::Option option, Optional<StringRef> value) override {
+		transaction->setOption(option, value);
+	}
+
 	void addReadConflictRange(KeyRangeRef const& keys) override { transaction->addReadConflictRange(keys); }
 };
 
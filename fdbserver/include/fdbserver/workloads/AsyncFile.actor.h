@@ -28,6 +28,7 @@
 #elif !defined(WORKLOADS_ASYNCFILE_ACTOR_H)
 #define WORKLOADS_ASYNCFILE_ACTOR_H
 
+#include "fdbrpc/DDSketch.h"
 #include "fdbserver/workloads/workloads.actor.h"
 #include "flow/IAsyncFile.h"
 #include "flow/actorcompiler.h" // This must be the last #include.
@@ -76,12 +77,30 @@ struct AsyncFileWorkload : TestWorkload {
 
 	std::string path;
 
+	// The class of the opened IAsyncFile and the latencies of operations timed with timeIO(), so that runs with
+	// different file implementations (such as with and without ENABLE_IO_URING) can be compared
+	std::string fileClass;
+	DDSketch<double> latencies;
+
 	AsyncFileWorkload(WorkloadContext const&);
 	~AsyncFileWorkload() override {}
 
 	// Allocates a buffer of a given size.  If necessary, the buffer will be aligned to 4K
 	Reference<AsyncFileBuffer> allocateBuffer(size_t size);
 
+	// Returns io, recording its latency when it completes
+	template <class T>
+	Future<T> timeIO(Future<T> io) {
+		double start = timer();
+		return map(io, [this, start](T r) {
+			latencies.addSample(timer() - start);
+			return r;
+		});
+	}
+
+	// Adds the latency percentiles of the timed operations to m
+	void getLatencyMetrics(std::vector<PerfMetric>& m);
+
 	Future<bool> check(Database const& cx) override;
 
 	// Opens a file for AsyncFile operations.  If the path is empty, then creates a file and fills it with random data
@@ -114,6 +133,8 @@ struct AsyncFileWorkload : TestWorkload {
 
 		try {
 			state Reference<IAsyncFile> file = wait(IAsyncFileSystem::filesystem()->open(self->path, flags, 0666));
+			self->fileClass = file->getClassName().toString();
+			TraceEvent("AsyncFileWorkloadOpen").detail("Filename", self->path).detail("Class", self->fileClass);
 			if (self->fileHandle.getPtr() == nullptr)
 				self->fileHandle = makeReference<AsyncFileHandle>(file, self->path, fileCreated);
 			else
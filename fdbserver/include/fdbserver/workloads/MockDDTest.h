@@ -62,6 +62,9 @@ protected:
 
 	explicit MockDDTestWorkload(WorkloadContext const& wcx);
 
+	// the single region cluster configuration the mock workloads run against
+	BasicSimulationConfig generateSimulationConfig() const;
+
 	virtual void populateRandomStrategy();
 	virtual void populateLinearStrategy();
 	virtual void populateFixedStrategy();
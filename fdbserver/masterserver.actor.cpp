@@ -281,6 +281,15 @@ MasterData::MasterData(Reference<AsyncVar<ServerDBInfo> const> const& dbInfo,
 		                                               dbgid,
 		                                               SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
 		                                               SERVER_KNOBS->LATENCY_SKETCH_ACCURACY);
+		versionVectorUpdateLatency = new LatencySample("VersionVectorUpdateLatency",
+		                                               dbgid,
+		                                               SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
+		                                               SERVER_KNOBS->LATENCY_SKETCH_ACCURACY);
+		versionVectorLatencyOnCVReply = new LatencySample("VersionVectorLatencyOnCVReply",
+		                                                  dbgid,
+		                                                  SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
+		                                                  SERVER_KNOBS->LATENCY_SKETCH_ACCURACY);
+		ssVersionVector.trackChanges();
 		waitForPrevLatencies = new LatencySample("WaitForPrevLatencies",
 		                                         dbgid,
 		                                         SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
@@ -352,7 +361,9 @@ void updateLiveCommittedVersionCxx(Reference<MasterData> self, ReportRawCommitte
 			// TraceEvent("Received ReportRawCommittedVersionRequest").detail("Version",req.version);
 			int8_t primaryLocality =
 			    SERVER_KNOBS->ENABLE_VERSION_VECTOR_HA_OPTIMIZATION ? self->locality : tagLocalityInvalid;
+			double updateStart = timer_monotonic();
 			self->ssVersionVector.setVersion(req.writtenTags.get(), req.version, primaryLocality);
+			self->versionVectorUpdateLatency->addMeasurement(timer_monotonic() - updateStart);
 			self->versionVectorTagUpdates->addMeasurement(req.writtenTags.get().size());
 		}
 		auto curTime = now();
@@ -409,7 +420,9 @@ ACTOR Future<Void> serveLiveCommittedVersionCxx(Reference<MasterData> self) {
 				reply.metadataVersion = self->proxyMetadataVersion;
 				reply.minKnownCommittedVersion = self->minKnownCommittedVersion;
 				if (SERVER_KNOBS->ENABLE_VERSION_VECTOR) {
+					double deltaStart = timer_monotonic();
 					self->ssVersionVector.getDelta(req.maxVersion, reply.ssVersionVectorDelta);
+					self->versionVectorLatencyOnCVReply->addMeasurement(timer_monotonic() - deltaStart);
 					self->versionVectorSizeOnCVReply->addMeasurement(reply.ssVersionVectorDelta.size());
 				}
 				req.reply.send(reply);
@@ -22,8 +22,10 @@
 #include <functional>
 #include <iterator>
 #include <limits>
+#include <numeric>
 #include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "fdbclient/BlobCipher.h"
 #include "fdbclient/BlobGranuleCommon.h"
@@ -49,6 +51,7 @@
 #include "flow/Trace.h"
 #include "fdbclient/Tracing.h"
 #include "flow/Util.h"
+#include "flow/xxhash.h"
 #include "fdbclient/Atomic.h"
 #include "fdbclient/AuditUtils.actor.h"
 #include "fdbclient/BlobConnectionProvider.h"
@@ -73,6 +76,7 @@
 #include "fdbserver/AccumulativeChecksumUtil.h"
 #include "fdbserver/DataDistribution.actor.h"
 #include "fdbserver/FDBExecHelper.actor.h"
+#include "fdbserver/HotKeyTracker.h"
 #include "fdbclient/GetEncryptCipherKeys.h"
 #include "fdbserver/IKeyValueStore.h"
 #include "fdbserver/Knobs.h"
@@ -89,6 +93,8 @@
 #include "fdbserver/ServerDBInfo.h"
 #include "fdbserver/SpanContextMessage.h"
 #include "fdbserver/StorageMetrics.actor.h"
+#include "fdbserver/StorageServerReadCache.h"
+#include "fdbserver/TenantPrefixIndex.h"
 #include "fdbserver/TLogInterface.h"
 #include "fdbserver/TransactionTagCounter.h"
 #include "fdbserver/WaitFailure.h"
@@ -557,7 +563,8 @@ public:
 };
 
 struct StorageServerDisk {
-	explicit StorageServerDisk(struct StorageServer* data, IKeyValueStore* storage) : data(data), storage(storage) {}
+	explicit StorageServerDisk(struct StorageServer* data, IKeyValueStore* storage)
+	  : data(data), storage(storage), readCache(SERVER_KNOBS->STORAGE_SERVER_READ_CACHE_BYTES) {}
 
 	IKeyValueStore* getKeyValueStore() const { return this->storage; }
 
@@ -579,14 +586,19 @@ struct StorageServerDisk {
 	void clearRange(KeyRangeRef keys);
 
 	Future<Void> addRange(KeyRangeRef range, std::string id) {
+		readCache.invalidate(range);
 		return storage->addRange(range, id, !SERVER_KNOBS->SHARDED_ROCKSDB_DELAY_COMPACTION_FOR_DATA_MOVE);
 	}
 
-	std::vector<std::string> removeRange(KeyRangeRef range) { return storage->removeRange(range); }
+	std::vector<std::string> removeRange(KeyRangeRef range) {
+		readCache.invalidate(range);
+		return storage->removeRange(range);
+	}
 
 	void markRangeAsActive(KeyRangeRef range) { storage->markRangeAsActive(range); }
 
 	Future<Void> replaceRange(KeyRange range, Standalone<VectorRef<KeyValueRef>> data) {
+		readCache.invalidate(range);
 		return storage->replaceRange(range, data);
 	}
 
@@ -597,7 +609,12 @@ struct StorageServerDisk {
 	Future<Void> getError() { return storage->getError(); }
 	Future<Void> init() { return storage->init(); }
 	Future<Void> canCommit() { return storage->canCommit(); }
-	Future<Void> commit() { return storage->commit(); }
+	Future<Void> commit() {
+		return map(storage->commit(), [this](Void) {
+			readCache.onCommit();
+			return Void();
+		});
+	}
 
 	void logRecentRocksDBBackgroundWorkStats(UID ssId, std::string logReason) {
 		return storage->logRecentRocksDBBackgroundWorkStats(ssId, logReason);
@@ -614,9 +631,29 @@ struct StorageServerDisk {
 		return readFirstKey(storage, KeyRangeRef(key, allKeys.end), options);
 	}
 	Future<Optional<Value>> readValue(KeyRef key, Optional<ReadOptions> options = Optional<ReadOptions>()) {
+		if (readCache.enabled()) {
+			Optional<Optional<Value>> cached = readCache.get(key);
+			if (cached.present()) {
+				++(*readCacheHits);
+				return cached.get();
+			}
+			++(*readCacheMisses);
+			++(*kvGets);
+			return readValueAndCache(&readCache, storage, key, options);
+		}
 		++(*kvGets);
 		return storage->readValue(key, options);
 	}
+	// Issues all the reads together so that the storage engine can overlap them
+	Future<std::vector<Optional<Value>>> readValues(const std::vector<KeyRef>& keys,
+	                                                Optional<ReadOptions> options = Optional<ReadOptions>()) {
+		std::vector<Future<Optional<Value>>> values;
+		values.reserve(keys.size());
+		for (const auto& key : keys) {
+			values.push_back(readValue(key, options));
+		}
+		return getAll(values);
+	}
 	Future<Optional<Value>> readValuePrefix(KeyRef key,
 	                                        int maxLength,
 	                                        Optional<ReadOptions> options = Optional<ReadOptions>()) {
@@ -633,11 +670,17 @@ struct StorageServerDisk {
 
 	Future<CheckpointMetaData> checkpoint(const CheckpointRequest& request) { return storage->checkpoint(request); }
 
-	Future<Void> restore(const std::vector<CheckpointMetaData>& checkpoints) { return storage->restore(checkpoints); }
+	Future<Void> restore(const std::vector<CheckpointMetaData>& checkpoints) {
+		readCache.clear();
+		return storage->restore(checkpoints);
+	}
 
 	Future<Void> restore(const std::string& shardId,
 	                     const std::vector<KeyRange>& ranges,
 	                     const std::vector<CheckpointMetaData>& checkpoints) {
+		for (const auto& range : ranges) {
+			readCache.invalidate(range);
+		}
 		return storage->restore(shardId, ranges, checkpoints);
 	}
 
@@ -648,6 +691,15 @@ struct StorageServerDisk {
 	KeyValueStoreType getKeyValueStoreType() const { return storage->getType(); }
 	StorageBytes getStorageBytes() const { return storage->getStorageBytes(); }
 	std::tuple<size_t, size_t, size_t> getSize() const { return storage->getSize(); }
+	int64_t getWriteBufferBytes() const { return storage->getWriteBufferBytes(); }
+	double getIOPressure() const { return storage->getIOPressure(); }
+	double getCacheHitRate() const { return storage->getCacheHitRate(); }
+	Future<std::vector<int64_t>> getApproximateRangeSizes(Standalone<VectorRef<KeyRef>> const& boundaries) {
+		return storage->getApproximateRangeSizes(boundaries);
+	}
+
+	int64_t getReadCacheBytes() const { return readCache.getBytes(); }
+	int64_t getReadCacheEntries() const { return readCache.getEntries(); }
 
 	Future<EncryptionAtRestMode> encryptionMode() { return storage->encryptionMode(); }
 
@@ -658,10 +710,13 @@ struct StorageServerDisk {
 	Counter* kvGets;
 	Counter* kvScans;
 	Counter* kvCommits;
+	Counter* readCacheHits;
+	Counter* readCacheMisses;
 
 private:
 	struct StorageServer* data;
 	IKeyValueStore* storage;
+	StorageServerReadCache readCache;
 	void writeMutations(const VectorRef<MutationRef>& mutations, Version debugVersion, const char* debugContext);
 	void writeMutationsBuggy(const VectorRef<MutationRef>& mutations, Version debugVersion, const char* debugContext);
 
@@ -672,6 +727,16 @@ private:
 		else
 			return range.end;
 	}
+
+	ACTOR static Future<Optional<Value>> readValueAndCache(StorageServerReadCache* readCache,
+	                                                       IKeyValueStore* storage,
+	                                                       Key key,
+	                                                       Optional<ReadOptions> options) {
+		state StorageServerReadCache::ReadToken token = readCache->beginRead();
+		Optional<Value> value = wait(storage->readValue(key, options));
+		readCache->insert(key, value, token);
+		return value;
+	}
 };
 
 struct UpdateEagerReadInfo {
@@ -1033,7 +1098,7 @@ public:
 	std::map<Version, std::vector<CheckpointMetaData>> pendingCheckpoints; // Pending checkpoint requests
 	std::unordered_map<UID, CheckpointMetaData> checkpoints; // Existing and deleting checkpoints
 	std::unordered_map<UID, ICheckpointReader*> liveCheckpointReaders; // Active checkpoint readers
-	VersionedMap<int64_t, TenantSSInfo> tenantMap;
+	TenantPrefixIndex tenantMap;
 	std::map<Version, std::vector<PendingNewShard>>
 	    pendingAddRanges; // Pending requests to add ranges to physical shards
 	std::map<Version, std::vector<KeyRange>>
@@ -1185,6 +1250,10 @@ public:
 	void byteSampleApplyMutation(MutationRef const& m, Version ver);
 	void byteSampleApplySet(KeyValueRef kv, Version ver);
 	void byteSampleApplyClear(KeyRangeRef range, Version ver);
+	// Like byteSampleApplySet for every key of a block written to storage by fetchKeys, which replaced range
+	void byteSampleApplyFetchedBlock(KeyRangeRef range, VectorRef<KeyValueRef> block);
+	// Applies the byte sample updates deferred while deferByteSampleUpdates was set
+	void flushByteSampleUpdates();
 
 	void popVersion(Version v, bool popAllTags = false) {
 		if (logSystem && !isTss()) {
@@ -1229,8 +1298,14 @@ public:
 	}
 
 	MutationRef addMutationToMutationLog(Standalone<VerUpdateRef>& mLV, MutationRef const& m) {
-		byteSampleApplyMutation(m, mLV.version);
 		counters.bytesInput += mvccStorageBytes(m);
+		if (deferByteSampleUpdates) {
+			// The logged copy lives as long as mLV, which cannot become durable before the update is flushed
+			MutationRef logged = mLV.push_back_deep(mLV.arena(), m);
+			pendingByteSampleUpdates.emplace_back(logged, mLV.version);
+			return logged;
+		}
+		byteSampleApplyMutation(m, mLV.version);
 		return mLV.push_back_deep(mLV.arena(), m);
 	}
 
@@ -1278,6 +1353,10 @@ public:
 	Deque<std::pair<std::vector<Key>, Version>> changeFeedVersions;
 	std::map<UID, PromiseStream<Key>> changeFeedDestroys;
 	std::set<Key> currentChangeFeeds;
+	// Change feed entries created for a version while applying it share this arena, so a mutation written to many
+	// feeds is only copied once
+	Arena feedMutationArena;
+	Version feedMutationArenaVersion = invalidVersion;
 	std::set<Key> fetchingChangeFeeds;
 	std::unordered_map<NetworkAddress, std::unordered_map<UID, Version>> changeFeedClientVersions;
 	std::unordered_map<Key, Version> changeFeedCleanupDurable;
@@ -1342,6 +1421,10 @@ public:
 	CoalescedKeyRangeMap<bool, int64_t, KeyBytesMetric<int64_t>> byteSampleClears;
 	AsyncVar<bool> byteSampleClearsTooLarge;
 	Future<Void> byteSampleRecovery;
+	// Set by update() while it applies mutations without yielding, so that their byte sample updates are applied in one
+	// batch once the new versions are visible rather than inline with every mutation
+	bool deferByteSampleUpdates = false;
+	std::vector<std::pair<MutationRef, Version>> pendingByteSampleUpdates;
 	Future<Void> durableInProgress;
 
 	AsyncMap<Key, bool> watches;
@@ -1369,6 +1452,10 @@ public:
 	std::vector<Promise<FetchInjectionInfo*>> readyFetchKeys;
 
 	ThroughputLimiter fetchKeysLimiter;
+	// Shared by all the checkpoint transfers this server serves
+	ThroughputLimiter fetchCheckpointLimiter;
+	// Shared by everything this server serves to data moves: fetchKeys reads and checkpoint transfers
+	FetchSourceBudget fetchSourceBudget;
 
 	FlowLock serveFetchCheckpointParallelismLock;
 
@@ -1383,6 +1470,66 @@ public:
 		return ssLock->lock(readPriorityRanks[readType]);
 	}
 
+	// Gates reads into ssLock by the lane of their tenant, or of the shard containing key, so that each lane holds at
+	// most STORAGE_SERVER_READ_LANE_CONCURRENCY slots of ssLock and reads queued behind a hot lane do not hold up the
+	// others. key is only used for reads outside of tenants.
+	std::vector<Reference<FlowLock>> readLanes;
+
+	Future<PriorityMultiLock::Lock> getReadLock(const Optional<ReadOptions>& options,
+	                                            const TenantInfo& tenantInfo,
+	                                            KeyRef key) {
+		if (readLanes.empty()) {
+			return getReadLock(options);
+		}
+		size_t laneHash = tenantInfo.hasTenant() ? std::hash<int64_t>()(tenantInfo.tenantId)
+		                                         : std::hash<StringRef>()(shards.rangeContaining(key).begin());
+		return getLaneReadLock(this, options, readLanes[laneHash % readLanes.size()]);
+	}
+
+	ACTOR static Future<Void> holdReadLane(Reference<FlowLock> lane, Future<Void> readLockReleased) {
+		try {
+			wait(readLockReleased);
+		} catch (Error& e) {
+			if (e.code() == error_code_actor_cancelled) {
+				throw;
+			}
+		}
+		lane->release();
+		return Void();
+	}
+
+	ACTOR static Future<PriorityMultiLock::Lock> getLaneReadLock(StorageServer* self,
+	                                                            Optional<ReadOptions> options,
+	                                                            Reference<FlowLock> lane) {
+		state double start = now();
+		wait(lane->take());
+		try {
+			self->counters.readLaneWaitSample.addMeasurement(now() - start);
+			PriorityMultiLock::Lock lock = wait(self->getReadLock(options));
+			self->actors.add(holdReadLane(lane, lock.promise.getFuture()));
+			return lock;
+		} catch (Error& e) {
+			lane->release();
+			throw;
+		}
+	}
+
+	std::pair<int64_t, int> getMaxReadLaneUsage() const {
+		int64_t maxActive = 0;
+		int maxWaiting = 0;
+		for (const auto& lane : readLanes) {
+			maxActive = std::max(maxActive, lane->activePermits());
+			maxWaiting = std::max(maxWaiting, lane->waiters());
+		}
+		return { maxActive, maxWaiting };
+	}
+
+	// Whether a read should record the time of its phases in readVersionedDataSample and readEngineSample. This does not
+	// influence the read, so it doesn't draw from the deterministic random source.
+	bool sampleReadPhases() const {
+		return nondeterministicRandom()->random01() < SERVER_KNOBS->STORAGE_READ_PHASE_SAMPLE_RATE;
+	}
+
 	FlowLock serveAuditStorageParallelismLock;
 
 	int64_t instanceID;
@@ -1412,6 +1559,7 @@ public:
 
 	TransactionTagCounter transactionTagCounter;
 	BusiestWriteTagContext busiestWriteTagContext;
+	HotKeyTracker hotKeys;
 
 	Optional<LatencyBandConfig> latencyBandConfig;
 
@@ -1424,6 +1572,9 @@ public:
 		    getRangeStreamQueries, lowPriorityQueries, rowsQueried, watchQueries, emptyQueries, feedRowsQueried,
 		    feedBytesQueried, feedStreamQueries, rejectedFeedStreamQueries, feedVersionQueries;
 
+		// counters related to batched getValues queries, getValuesKeys counts the keys across all the batches
+		Counter getValuesQueries, getValuesKeys;
+
 		// counters related to getMappedRange queries
 		Counter getMappedRangeBytesQueried, finishedGetMappedRangeSecondaryQueries, getMappedRangeQueries,
 		    finishedGetMappedRangeQueries;
@@ -1452,7 +1603,11 @@ public:
 		Counter feedBytesFetched;
 
 		Counter sampledBytesCleared;
+		// Byte sample updates skipped because the key was set again in the same version
+		Counter byteSampleUpdatesCoalesced;
 		Counter atomicMutations, changeFeedMutations, changeFeedMutationsDurable;
+		// Bytes of change feed mutations not copied because another feed already holds a copy
+		Counter changeFeedMutationBytesShared;
 		Counter updateBatches, updateVersions;
 		Counter loops;
 		Counter fetchWaitingMS, fetchWaitingCount, fetchExecutingMS, fetchExecutingCount;
@@ -1464,6 +1619,8 @@ public:
 		// means fallback if fallback is enabled, otherwise means failure (so that another layer could implement
 		// fallback).
 		Counter quickGetValueHit, quickGetValueMiss, quickGetKeyValuesHit, quickGetKeyValuesMiss;
+		// Reads served at this server's latest version, older than their read version, because they tolerate staleness
+		Counter staleVersionReads;
 
 		// The number of logical bytes returned from storage engine, in response to readRange operations.
 		Counter kvScanBytes;
@@ -1477,6 +1634,8 @@ public:
 		Counter kvScans;
 		// The count of commit operation to the storage engine.
 		Counter kvCommits;
+		// The count of readValue operations served from, or missed in, the storage server read cache.
+		Counter readCacheHits, readCacheMisses;
 		// The count of change feed reads that hit disk
 		Counter changeFeedDiskReads;
 		// The count of ChangeServerKeys actions.
@@ -1491,13 +1650,20 @@ public:
 		// If set is within a range of clear, the clear is split. It's tracking the number of splits, the split could be
 		// expensive.
 		Counter pTreeClearSplits;
+		// Microseconds update() spent on the eager reads of a batch (including decoding it to find them), on applying
+		// the mutations of the batch, and on making the new version readable
+		Counter updateEagerReadsMicros, updateApplyMicros, updateNewVersionMicros;
 
 		LatencySample readLatencySample;
 		LatencySample readKeyLatencySample;
 		LatencySample readValueLatencySample;
+		LatencySample readValuesLatencySample;
 		LatencySample readRangeLatencySample;
 		LatencySample readVersionWaitSample;
 		LatencySample readQueueWaitSample;
+		LatencySample readLaneWaitSample;
+		LatencySample readVersionedDataSample; // Samples time spent reading the versioned data of a read
+		LatencySample readEngineSample; // Samples time spent waiting for the storage engine of a read
 		LatencySample kvReadRangeLatencySample;
 		LatencySample updateLatencySample;
 		LatencySample updateEncryptionLatencySample;
@@ -1506,6 +1672,7 @@ public:
 		LatencySample mappedRangeSample; // Samples getMappedRange latency
 		LatencySample mappedRangeRemoteSample; // Samples getMappedRange remote subquery latency
 		LatencySample mappedRangeLocalSample; // Samples getMappedRange local subquery latency
+		LatencySample tenantLookupLatencySample; // Samples lookups of tenants in tenantMap
 
 		explicit Counters(StorageServer* self)
 		  : CommonStorageCounters("StorageServer", self->thisServerID.toString(), &self->metrics),
@@ -1517,28 +1684,35 @@ public:
 		    watchQueries("WatchQueries", cc), emptyQueries("EmptyQueries", cc), feedRowsQueried("FeedRowsQueried", cc),
 		    feedBytesQueried("FeedBytesQueried", cc), feedStreamQueries("FeedStreamQueries", cc),
 		    rejectedFeedStreamQueries("RejectedFeedStreamQueries", cc), feedVersionQueries("FeedVersionQueries", cc),
+		    getValuesQueries("GetValuesQueries", cc), getValuesKeys("GetValuesKeys", cc),
 		    logicalBytesInput("LogicalBytesInput", cc), logicalBytesMoveInOverhead("LogicalBytesMoveInOverhead", cc),
 		    kvCommitLogicalBytes("KVCommitLogicalBytes", cc), kvClearRanges("KVClearRanges", cc),
 		    kvClearSingleKey("KVClearSingleKey", cc), kvSystemClearRanges("KVSystemClearRanges", cc),
 		    bytesDurable("BytesDurable", cc), feedBytesFetched("FeedBytesFetched", cc),
-		    sampledBytesCleared("SampledBytesCleared", cc), atomicMutations("AtomicMutations", cc),
+		    sampledBytesCleared("SampledBytesCleared", cc), byteSampleUpdatesCoalesced("ByteSampleUpdatesCoalesced", cc),
+		    atomicMutations("AtomicMutations", cc),
 		    changeFeedMutations("ChangeFeedMutations", cc),
-		    changeFeedMutationsDurable("ChangeFeedMutationsDurable", cc), updateBatches("UpdateBatches", cc),
+		    changeFeedMutationsDurable("ChangeFeedMutationsDurable", cc),
+		    changeFeedMutationBytesShared("ChangeFeedMutationBytesShared", cc), updateBatches("UpdateBatches", cc),
 		    updateVersions("UpdateVersions", cc), loops("Loops", cc), fetchWaitingMS("FetchWaitingMS", cc),
 		    fetchWaitingCount("FetchWaitingCount", cc), fetchExecutingMS("FetchExecutingMS", cc),
 		    fetchExecutingCount("FetchExecutingCount", cc), readsRejected("ReadsRejected", cc),
 		    wrongShardServer("WrongShardServer", cc), fetchedVersions("FetchedVersions", cc),
 		    fetchesFromLogs("FetchesFromLogs", cc), quickGetValueHit("QuickGetValueHit", cc),
 		    quickGetValueMiss("QuickGetValueMiss", cc), quickGetKeyValuesHit("QuickGetKeyValuesHit", cc),
-		    quickGetKeyValuesMiss("QuickGetKeyValuesMiss", cc), kvScanBytes("KVScanBytes", cc),
+		    quickGetKeyValuesMiss("QuickGetKeyValuesMiss", cc), staleVersionReads("StaleVersionReads", cc),
+		    kvScanBytes("KVScanBytes", cc),
 		    kvGetBytes("KVGetBytes", cc), eagerReadsKeys("EagerReadsKeys", cc), kvGets("KVGets", cc),
-		    kvScans("KVScans", cc), kvCommits("KVCommits", cc), changeFeedDiskReads("ChangeFeedDiskReads", cc),
+		    kvScans("KVScans", cc), kvCommits("KVCommits", cc), readCacheHits("ReadCacheHits", cc),
+		    readCacheMisses("ReadCacheMisses", cc), changeFeedDiskReads("ChangeFeedDiskReads", cc),
 		    getMappedRangeBytesQueried("GetMappedRangeBytesQueried", cc),
 		    finishedGetMappedRangeQueries("FinishedGetMappedRangeQueries", cc),
 		    finishedGetMappedRangeSecondaryQueries("FinishedGetMappedRangeSecondaryQueries", cc),
 		    pTreeSets("PTreeSets", cc), pTreeClears("PTreeClears", cc), pTreeClearSplits("PTreeClearSplits", cc),
 		    changeServerKeysAssigned("ChangeServerKeysAssigned", cc),
 		    changeServerKeysUnassigned("ChangeServerKeysUnassigned", cc),
+		    updateEagerReadsMicros("UpdateEagerReadsMicros", cc), updateApplyMicros("UpdateApplyMicros", cc),
+		    updateNewVersionMicros("UpdateNewVersionMicros", cc),
 		    readLatencySample("ReadLatencyMetrics",
 		                      self->thisServerID,
 		                      SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
@@ -1551,6 +1725,10 @@ public:
 		                           self->thisServerID,
 		                           SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
 		                           SERVER_KNOBS->LATENCY_SKETCH_ACCURACY),
+		    readValuesLatencySample("GetValuesMetrics",
+		                            self->thisServerID,
+		                            SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
+		                            SERVER_KNOBS->LATENCY_SKETCH_ACCURACY),
 		    readRangeLatencySample("GetRangeMetrics",
 		                           self->thisServerID,
 		                           SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
@@ -1563,6 +1741,18 @@ public:
 		                        self->thisServerID,
 		                        SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
 		                        SERVER_KNOBS->LATENCY_SKETCH_ACCURACY),
+		    readLaneWaitSample("ReadLaneWaitMetrics",
+		                       self->thisServerID,
+		                       SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
+		                       SERVER_KNOBS->LATENCY_SKETCH_ACCURACY),
+		    readVersionedDataSample("ReadVersionedDataMetrics",
+		                            self->thisServerID,
+		                            SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
+		                            SERVER_KNOBS->LATENCY_SKETCH_ACCURACY),
+		    readEngineSample("ReadEngineMetrics",
+		                     self->thisServerID,
+		                     SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
+		                     SERVER_KNOBS->LATENCY_SKETCH_ACCURACY),
 		    readLatencyBands("ReadLatencyBands", self->thisServerID, SERVER_KNOBS->STORAGE_LOGGING_DELAY),
 		    mappedRangeSample("GetMappedRangeMetrics",
 		                      self->thisServerID,
@@ -1576,6 +1766,10 @@ public:
 		                           self->thisServerID,
 		                           SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
 		                           SERVER_KNOBS->LATENCY_SKETCH_ACCURACY),
+		    tenantLookupLatencySample("TenantLookupMetrics",
+		                              self->thisServerID,
+		                              SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
+		                              SERVER_KNOBS->LATENCY_SKETCH_ACCURACY),
 		    kvReadRangeLatencySample("KVGetRangeMetrics",
 		                             self->thisServerID,
 		                             SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
@@ -1611,6 +1805,7 @@ public:
 			specialCounter(cc, "ServeFetchCheckpointWaiting", [self]() {
 				return self->serveFetchCheckpointParallelismLock.waiters();
 			});
+			specialCounter(cc, "FetchSourceBytesPerSec", [self]() { return self->fetchSourceBudget.getBytesPerSec(); });
 			specialCounter(cc, "ServeValidateStorageActive", [self]() {
 				return self->serveAuditStorageParallelismLock.activePermits();
 			});
@@ -1623,9 +1818,17 @@ public:
 			specialCounter(cc, "KvstoreSizeTotal", [self]() { return std::get<0>(self->storage.getSize()); });
 			specialCounter(cc, "KvstoreNodeTotal", [self]() { return std::get<1>(self->storage.getSize()); });
 			specialCounter(cc, "KvstoreInlineKey", [self]() { return std::get<2>(self->storage.getSize()); });
+			specialCounter(cc, "KvstoreWriteBufferBytes", [self]() { return self->storage.getWriteBufferBytes(); });
+			specialCounter(cc, "KvstoreIOPressurePercent", [self]() {
+				return static_cast<int64_t>(self->storage.getIOPressure() * 100);
+			});
+			specialCounter(cc, "ReadCacheBytes", [self]() { return self->storage.getReadCacheBytes(); });
+			specialCounter(cc, "ReadCacheEntries", [self]() { return self->storage.getReadCacheEntries(); });
 			specialCounter(cc, "ActiveChangeFeeds", [self]() { return self->uidChangeFeed.size(); });
 			specialCounter(cc, "ActiveChangeFeedQueries", [self]() { return self->activeFeedQueries; });
 			specialCounter(cc, "ChangeFeedMemoryBytes", [self]() { return self->changeFeedMemoryBytes; });
+			specialCounter(cc, "Tenants", [self]() { return self->tenantMap.size(); });
+			specialCounter(cc, "TenantIndexBytes", [self]() { return self->tenantMap.memoryUsage(); });
 		}
 	} counters;
 
@@ -1687,6 +1890,8 @@ public:
 	    fetchKeysParallelismChangeFeedLock(SERVER_KNOBS->FETCH_KEYS_PARALLELISM_CHANGE_FEED),
 	    fetchKeysBytesBudget(SERVER_KNOBS->STORAGE_FETCH_BYTES), fetchKeysBudgetUsed(false),
 	    fetchKeysTotalCommitBytes(0), fetchKeysLimiter(SERVER_KNOBS->STORAGE_FETCH_KEYS_RATE_LIMIT),
+	    fetchCheckpointLimiter(SERVER_KNOBS->SERVE_FETCH_CHECKPOINT_BYTES_PER_SECOND),
+	    fetchSourceBudget(SERVER_KNOBS->STORAGE_FETCH_SOURCE_BYTES_PER_SEC),
 	    serveFetchCheckpointParallelismLock(SERVER_KNOBS->SERVE_FETCH_CHECKPOINT_PARALLELISM),
 	    ssLock(makeReference<PriorityMultiLock>(SERVER_KNOBS->STORAGE_SERVER_READ_CONCURRENCY,
 	                                            SERVER_KNOBS->STORAGESERVER_READ_PRIORITIES)),
@@ -1698,8 +1903,8 @@ public:
 	                          /*maxTagsTracked=*/SERVER_KNOBS->SS_THROTTLE_TAGS_TRACKED,
 	                          /*minRateTracked=*/SERVER_KNOBS->MIN_TAG_READ_PAGES_RATE *
 	                              CLIENT_KNOBS->TAG_THROTTLING_PAGE_SIZE),
-	    busiestWriteTagContext(ssi.id()), getEncryptCipherKeysMonitor(encryptionMonitor), counters(this),
-	    storageServerSourceTLogIDEventHolder(
+	    busiestWriteTagContext(ssi.id()), hotKeys(ssi.id()), getEncryptCipherKeysMonitor(encryptionMonitor),
+	    counters(this), storageServerSourceTLogIDEventHolder(
 	        makeReference<EventCacheHolder>(ssi.id().toString() + "/StorageServerSourceTLogID")),
 	    tenantData(db),
 	    acsValidator(CLIENT_KNOBS->ENABLE_MUTATION_CHECKSUM && CLIENT_KNOBS->ENABLE_ACCUMULATIVE_CHECKSUM
@@ -1707,6 +1912,11 @@ public:
 	                     : nullptr) {
 		readPriorityRanks = parseStringToVector<int>(SERVER_KNOBS->STORAGESERVER_READTYPE_PRIORITY_MAP, ',');
 		ASSERT(readPriorityRanks.size() > (int)ReadType::MAX);
+		ssLock->setMaxQueueTime(SERVER_KNOBS->STORAGE_SERVER_READ_MAX_QUEUE_TIME);
+		ssLock->enableQueueWaitHistograms(STORAGESERVER_HISTOGRAM_GROUP, "ReadQueueWait");
+		for (int i = 0; i < SERVER_KNOBS->STORAGE_SERVER_READ_LANES; ++i) {
+			readLanes.push_back(makeReference<FlowLock>(SERVER_KNOBS->STORAGE_SERVER_READ_LANE_CONCURRENCY));
+		}
 		version.initMetric("StorageServer.Version"_sr, counters.cc.getId());
 		oldestVersion.initMetric("StorageServer.OldestVersion"_sr, counters.cc.getId());
 		durableVersion.initMetric("StorageServer.DurableVersion"_sr, counters.cc.getId());
@@ -1728,6 +1938,9 @@ public:
 		this->storage.kvGets = &counters.kvGets;
 		this->storage.kvScans = &counters.kvScans;
 		this->storage.kvCommits = &counters.kvCommits;
+		this->storage.readCacheHits = &counters.readCacheHits;
+		this->storage.readCacheMisses = &counters.readCacheMisses;
+		tenantMap.setLookupLatencySample(&counters.tenantLookupLatencySample);
 	}
 
 	//~StorageServer() { fclose(log); }
@@ -1839,13 +2052,15 @@ public:
 
 	Counter::Value queueSize() const { return counters.bytesInput.getValue() - counters.bytesDurable.getValue(); }
 
-	// penalty used by loadBalance() to balance requests among SSes. We prefer SS with less write queue size.
+	// penalty used by loadBalance() to balance requests among SSes. We prefer SS with less write queue size, and
+	// whose storage engine is less busy with compaction.
 	double getPenalty() const override {
 		return std::max(std::max(1.0,
 		                         (queueSize() - (SERVER_KNOBS->TARGET_BYTES_PER_STORAGE_SERVER -
 		                                         2.0 * SERVER_KNOBS->SPRING_BYTES_STORAGE_SERVER)) /
 		                             SERVER_KNOBS->SPRING_BYTES_STORAGE_SERVER),
-		                (currentRate() < 1e-6 ? 1e6 : 1.0 / currentRate()));
+		                (currentRate() < 1e-6 ? 1e6 : 1.0 / currentRate())) *
+		       (1.0 + storage.getIOPressure() * SERVER_KNOBS->STORAGE_IO_PRESSURE_PENALTY);
 	}
 
 	// Normally the storage server prefers to serve read requests over making mutations
@@ -1863,6 +2078,40 @@ public:
 	template <class Reply>
 	using isLoadBalancedReply = std::is_base_of<LoadBalancedReply, Reply>;
 
+	// The reads in progress
+	int readQueueDepth() const { return counters.allQueries.getValue() - counters.finishedQueries.getValue(); }
+
+	// The clients that sent reads in the current and the last STORAGE_ADMISSION_CLIENT_INTERVAL, which share the
+	// admission window
+	std::unordered_set<NetworkAddress> admissionClients;
+	int lastAdmissionClientCount = 0;
+	double admissionIntervalStart = 0;
+
+	// How many reads a client may have in progress here: an even share of STORAGE_ADMISSION_TARGET_READ_QUEUE
+	// among the recent clients, shrunk in proportion when more reads than that are in progress.
+	double getAdmissionWindow(NetworkAddress const& client) {
+		if (now() - admissionIntervalStart > SERVER_KNOBS->STORAGE_ADMISSION_CLIENT_INTERVAL) {
+			lastAdmissionClientCount = admissionClients.size();
+			admissionClients.clear();
+			admissionIntervalStart = now();
+		}
+		admissionClients.insert(client);
+		const int clients = std::max<int>(lastAdmissionClientCount, admissionClients.size());
+		const double target = SERVER_KNOBS->STORAGE_ADMISSION_TARGET_READ_QUEUE;
+		return std::max(SERVER_KNOBS->STORAGE_ADMISSION_MIN_WINDOW,
+		                target / clients * std::min(1.0, target / std::max(readQueueDepth(), 1)));
+	}
+
+	// Fills in what loadBalance() balances reads on
+	void setLoadBalanceInfo(LoadBalancedReply& reply, NetworkAddress const& client) {
+		reply.penalty = getPenalty();
+		reply.cacheHitRate = storage.getCacheHitRate();
+		reply.readQueueDepth = readQueueDepth();
+		if (SERVER_KNOBS->STORAGE_ADMISSION_TARGET_READ_QUEUE > 0) {
+			reply.admissionWindow = getAdmissionWindow(client);
+		}
+	}
+
 	template <class Reply>
 	typename std::enable_if<isLoadBalancedReply<Reply>::value, void>::type
 	sendErrorWithPenalty(const ReplyPromise<Reply>& promise, const Error& err, double penalty) {
@@ -1872,6 +2121,7 @@ public:
 		Reply reply;
 		reply.error = err;
 		reply.penalty = penalty;
+		reply.readQueueDepth = readQueueDepth();
 		promise.send(reply);
 	}
 
@@ -1934,14 +2184,7 @@ public:
 		}
 	}
 
-	void getSplitPoints(SplitRangeRequest const& req) override {
-		try {
-			checkTenantEntry(version.get(), req.tenantInfo, true);
-			metrics.getSplitPoints(req, req.tenantInfo.prefix);
-		} catch (Error& e) {
-			req.reply.sendError(e);
-		}
-	}
+	void getSplitPoints(SplitRangeRequest const& req) override;
 
 	void maybeInjectTargetedRestart(Version v) {
 		// inject an SS restart at most once per test
@@ -1980,7 +2223,7 @@ public:
 		                          counters.bytesInput.getValue());
 	}
 
-	void getSplitMetrics(const SplitMetricsRequest& req) override { this->metrics.splitMetrics(req); }
+	void getSplitMetrics(const SplitMetricsRequest& req) override;
 
 	void getHotRangeMetrics(const ReadHotSubRangeRequest& req) override { this->metrics.getReadHotRanges(req); }
 
@@ -2346,6 +2589,26 @@ Future<Version> waitForVersion(StorageServer* data,
 	return waitForVersionActor(data, std::max(commitVersion, data->oldestVersion.get()), spanContext);
 }
 
+// As above, but a read whose options tolerate staleness is served at this server's latest version without waiting when
+// the server lags readVersion by no more than ReadOptions::maxStaleVersions. Servers paired with a TSS always wait, so
+// the pair keeps serving identical results.
+Future<Version> waitForVersion(StorageServer* data,
+                               Version commitVersion,
+                               Version readVersion,
+                               Optional<ReadOptions> const& options,
+                               SpanContext spanContext) {
+	if (options.present() && options.get().maxStaleVersions.present() && readVersion != latestVersion &&
+	    !data->isTss() && !data->isSSWithTSSPair()) {
+		Version latest = data->version.get();
+		if (readVersion > latest && readVersion - latest <= options.get().maxStaleVersions.get() && latest > 0 &&
+		    latest >= data->oldestVersion.get()) {
+			++data->counters.staleVersionReads;
+			return latest;
+		}
+	}
+	return waitForVersion(data, commitVersion, readVersion, spanContext);
+}
+
 ACTOR Future<Version> waitForVersionNoTooOld(StorageServer* data, Version version) {
 	// This could become an Actor transparently, but for now it just does the lookup
 	if (version == latestVersion)
@@ -2393,16 +2656,17 @@ ACTOR Future<Version> waitForMinVersion(StorageServer* data, Version version) {
 
 void StorageServer::checkTenantEntry(Version version, TenantInfo tenantInfo, bool lockAware) {
 	if (tenantInfo.hasTenant()) {
-		ASSERT(version == latestVersion || (version >= tenantMap.oldestVersion && version <= this->version.get()));
-		auto view = tenantMap.at(version);
-		auto itr = view.find(tenantInfo.tenantId);
-		if (itr == view.end()) {
+		ASSERT(version == latestVersion ||
+		       (version >= tenantMap.getOldestVersion() && version <= this->version.get()));
+		Optional<TenantAPI::TenantLockState> lockState =
+		    tenantMap.find(tenantInfo.tenantId, version == latestVersion ? tenantMap.getLatestVersion() : version);
+		if (!lockState.present()) {
 			TraceEvent(SevWarn, "StorageTenantNotFound", thisServerID)
 			    .detail("Tenant", tenantInfo.tenantId)
 			    .backtrace();
 			CODE_PROBE(true, "Storage server tenant not found");
 			throw tenant_not_found();
-		} else if (!lockAware && itr->lockState == TenantAPI::TenantLockState::LOCKED) {
+		} else if (!lockAware && lockState.get() == TenantAPI::TenantLockState::LOCKED) {
 			CODE_PROBE(true, "Storage server access locked tenant without lock awareness");
 			throw tenant_locked();
 		}
@@ -2450,7 +2714,7 @@ ACTOR Future<Void> getValueQ(StorageServer* data, GetValueRequest req) {
 		// Active load balancing runs at a very high priority (to obtain accurate queue lengths)
 		// so we need to downgrade here
 		wait(data->getQueryDelay());
-		state PriorityMultiLock::Lock readLock = wait(data->getReadLock(req.options));
+		state PriorityMultiLock::Lock readLock = wait(data->getReadLock(req.options, req.tenantInfo, req.key));
 
 		// Track time from requestTime through now as read queueing wait time
 		state double queueWaitEnd = g_network->timer();
@@ -2463,7 +2727,7 @@ ACTOR Future<Void> getValueQ(StorageServer* data, GetValueRequest req) {
 
 		state Optional<Value> v;
 		Version commitVersion = getLatestCommitVersion(req.ssLatestCommitVersions, data->tag);
-		state Version version = wait(waitForVersion(data, commitVersion, req.version, req.spanContext));
+		state Version version = wait(waitForVersion(data, commitVersion, req.version, req.options, req.spanContext));
 		data->counters.readVersionWaitSample.addMeasurement(g_network->timer() - queueWaitEnd);
 
 		if (req.options.present() && req.options.get().debugID.present())
@@ -2483,13 +2747,22 @@ ACTOR Future<Void> getValueQ(StorageServer* data, GetValueRequest req) {
 		}
 
 		state int path = 0;
+		state bool samplePhases = data->sampleReadPhases();
+		double lookupStart = samplePhases ? g_network->timer() : 0;
 		auto i = data->data().at(version).lastLessOrEqual(req.key);
+		if (samplePhases) {
+			data->counters.readVersionedDataSample.addMeasurement(g_network->timer() - lookupStart);
+		}
 		if (i && i->isValue() && i.key() == req.key) {
 			v = (Value)i->getValue();
 			path = 1;
 		} else if (!i || !i->isClearTo() || i->getEndKey() <= req.key) {
 			path = 2;
+			state double engineStart = g_network->timer();
 			Optional<Value> vv = wait(data->storage.readValue(req.key, req.options));
+			if (samplePhases) {
+				data->counters.readEngineSample.addMeasurement(g_network->timer() - engineStart);
+			}
 			data->counters.kvGetBytes += vv.expectedSize();
 			// Validate that while we were reading the data we didn't lose the version or shard
 			if (version < data->storageVersion()) {
@@ -2547,7 +2820,7 @@ ACTOR Future<Void> getValueQ(StorageServer* data, GetValueRequest req) {
 		//	TraceEvent(SevDebug, "SSGetValueCached").detail("Key", req.key);
 
 		GetValueReply reply(v, cached);
-		reply.penalty = data->getPenalty();
+		data->setLoadBalanceInfo(reply, req.reply.getEndpoint().getPrimaryAddress());
 		req.reply.send(reply);
 	} catch (Error& e) {
 		if (!canReplyWith(e))
@@ -2558,12 +2831,145 @@ ACTOR Future<Void> getValueQ(StorageServer* data, GetValueRequest req) {
 	// Key size is not included in "BytesQueried", but still contributes to cost,
 	// so it must be accounted for here.
 	data->transactionTagCounter.addRequest(req.tags, req.key.size() + resultSize);
+	data->hotKeys.addRead(req.key, req.key.size() + resultSize);
 
 	++data->counters.finishedQueries;
 
 	double duration = g_network->timer() - req.requestTime();
 	data->counters.readLatencySample.addMeasurement(duration);
 	data->counters.readValueLatencySample.addMeasurement(duration);
+	data->fetchSourceBudget.addReadLatency(duration);
+	if (data->latencyBandConfig.present()) {
+		int maxReadBytes =
+		    data->latencyBandConfig.get().readConfig.maxReadBytes.orDefault(std::numeric_limits<int>::max());
+		data->counters.readLatencyBands.addMeasurement(duration, 1, Filtered(resultSize > maxReadBytes));
+	}
+
+	return Void();
+}
+
+// Serves a batch of point reads at a single version. The whole batch shares one read lock, one waitForVersion and one
+// reply, and the keys that are not found in the versioned data are read from the storage engine together.
+ACTOR Future<Void> getValuesQ(StorageServer* data, GetValuesRequest req) {
+	state int64_t resultSize = 0;
+	state int64_t keysSize = 0;
+	Span span("SS:getValues"_loc, req.spanContext);
+
+	try {
+		++data->counters.getValuesQueries;
+		++data->counters.allQueries;
+		data->counters.getValuesKeys += req.keys.size();
+		data->maxQueryQueue = std::max<int>(
+		    data->maxQueryQueue, data->counters.allQueries.getValue() - data->counters.finishedQueries.getValue());
+
+		// Active load balancing runs at a very high priority (to obtain accurate queue lengths)
+		// so we need to downgrade here
+		wait(data->getQueryDelay());
+		state PriorityMultiLock::Lock readLock =
+		    wait(data->getReadLock(req.options, req.tenantInfo, req.keys.empty() ? KeyRef() : req.keys[0]));
+
+		// Track time from requestTime through now as read queueing wait time
+		state double queueWaitEnd = g_network->timer();
+		data->counters.readQueueWaitSample.addMeasurement(queueWaitEnd - req.requestTime());
+
+		if (req.options.present() && req.options.get().debugID.present())
+			g_traceBatch.addEvent("GetValuesDebug", req.options.get().debugID.get().first(), "getValuesQ.DoRead");
+
+		Version commitVersion = getLatestCommitVersion(req.ssLatestCommitVersions, data->tag);
+		state Version version = wait(waitForVersion(data, commitVersion, req.version, req.options, req.spanContext));
+		data->counters.readVersionWaitSample.addMeasurement(g_network->timer() - queueWaitEnd);
+
+		data->checkTenantEntry(version, req.tenantInfo, req.options.present() ? req.options.get().lockAware : false);
+
+		// The keys in the request are left untouched so that the reply can be matched against them by the client
+		state std::vector<KeyRef> keys;
+		keys.reserve(req.keys.size());
+		for (const auto& key : req.keys) {
+			keys.push_back(req.tenantInfo.hasTenant() ? key.withPrefix(req.tenantInfo.prefix.get(), req.arena) : key);
+		}
+		state uint64_t changeCounter = data->shardChangeCounter;
+
+		state GetValuesReply reply;
+		state std::vector<Optional<ValueRef>> values(keys.size());
+		state std::vector<int> diskIndexes;
+		state std::vector<KeyRef> diskKeys;
+		auto view = data->data().at(version);
+		for (int i = 0; i < keys.size(); ++i) {
+			if (!data->shards[keys[i]]->isReadable()) {
+				throw wrong_shard_server();
+			}
+			auto it = view.lastLessOrEqual(keys[i]);
+			if (it && it->isValue() && it.key() == keys[i]) {
+				values[i] = ValueRef(reply.arena, it->getValue());
+			} else if (!it || !it->isClearTo() || it->getEndKey() <= keys[i]) {
+				diskIndexes.push_back(i);
+				diskKeys.push_back(keys[i]);
+			}
+		}
+
+		if (!diskKeys.empty()) {
+			std::vector<Optional<Value>> diskValues = wait(data->storage.readValues(diskKeys, req.options));
+			// Validate that while we were reading the data we didn't lose the version or shard
+			if (version < data->storageVersion()) {
+				CODE_PROBE(true, "transaction_too_old after readValues");
+				throw transaction_too_old();
+			}
+			for (int i = 0; i < diskIndexes.size(); ++i) {
+				data->checkChangeCounter(changeCounter, diskKeys[i]);
+				if (diskValues[i].present()) {
+					data->counters.kvGetBytes += diskValues[i].expectedSize();
+					values[diskIndexes[i]] = ValueRef(reply.arena, diskValues[i].get());
+				}
+			}
+		}
+
+		bool cached = false;
+		reply.data.reserve(reply.arena, keys.size());
+		for (int i = 0; i < keys.size(); ++i) {
+			keysSize += keys[i].size();
+			if (values[i].present()) {
+				reply.data.push_back(reply.arena, KeyValueRef(req.keys[i], values[i].get()));
+				++data->counters.rowsQueried;
+				resultSize += values[i].get().size();
+			} else {
+				++data->counters.emptyQueries;
+			}
+
+			if (SERVER_KNOBS->READ_SAMPLING_ENABLED) {
+				// If the read yields no value, randomly sample the empty read.
+				int64_t bytesReadPerKSecond =
+				    values[i].present()
+				        ? std::max((int64_t)(keys[i].size() + values[i].get().size()), SERVER_KNOBS->EMPTY_READ_PENALTY)
+				        : SERVER_KNOBS->EMPTY_READ_PENALTY;
+				data->metrics.notifyBytesReadPerKSecond(keys[i], bytesReadPerKSecond);
+			}
+
+			// Check if the desired key might be cached
+			cached = cached || data->cachedRangeMap[keys[i]];
+		}
+		data->counters.bytesQueried += resultSize;
+
+		if (req.options.present() && req.options.get().debugID.present())
+			g_traceBatch.addEvent("GetValuesDebug", req.options.get().debugID.get().first(), "getValuesQ.AfterRead");
+
+		reply.cached = cached;
+		data->setLoadBalanceInfo(reply, req.reply.getEndpoint().getPrimaryAddress());
+		req.reply.send(reply);
+	} catch (Error& e) {
+		if (!canReplyWith(e))
+			throw;
+		data->sendErrorWithPenalty(req.reply, e, data->getPenalty());
+	}
+
+	// Key size is not included in "BytesQueried", but still contributes to cost,
+	// so it must be accounted for here.
+	data->transactionTagCounter.addRequest(req.tags, keysSize + resultSize);
+
+	++data->counters.finishedQueries;
+
+	double duration = g_network->timer() - req.requestTime();
+	data->counters.readLatencySample.addMeasurement(duration);
+	data->counters.readValuesLatencySample.addMeasurement(duration);
 	if (data->latencyBandConfig.present()) {
 		int maxReadBytes =
 		    data->latencyBandConfig.get().readConfig.maxReadBytes.orDefault(std::numeric_limits<int>::max());
@@ -2603,8 +3009,7 @@ ACTOR Future<Version> watchWaitForValueChange(StorageServer* data, SpanContext p
 	loop {
 		try {
 			if (tenantId != TenantInfo::INVALID_TENANT) {
-				auto view = data->tenantMap.at(latestVersion);
-				if (view.find(tenantId) == view.end()) {
+				if (!data->tenantMap.contains(tenantId, data->tenantMap.getLatestVersion())) {
 					CODE_PROBE(true, "Watched tenant removed");
 					throw tenant_removed();
 				}
@@ -2861,11 +3266,14 @@ ACTOR Future<Void> fetchCheckpointQ(StorageServer* self, FetchCheckpointRequest
 		wait(reader->init(req.token));
 
 		loop {
-			state Standalone<StringRef> data = wait(reader->nextChunk(CLIENT_KNOBS->REPLY_BYTE_LIMIT));
-			wait(req.reply.onReady());
+			state Standalone<StringRef> data = wait(reader->nextChunk(SERVER_KNOBS->CHECKPOINT_TRANSFER_CHUNK_BYTES));
+			self->fetchCheckpointLimiter.settle();
+			wait(req.reply.onReady() && self->fetchCheckpointLimiter.ready() && self->fetchSourceBudget.ready());
 			FetchCheckpointReply reply(req.token);
 			reply.data = data;
 			req.reply.send(reply);
+			self->fetchCheckpointLimiter.addBytes(data.size());
+			self->fetchSourceBudget.addBytes(data.size());
 			totalSize += data.size();
 		}
 	} catch (Error& e) {
@@ -2943,7 +3351,7 @@ ACTOR Future<Void> fetchCheckpointKeyValuesQ(StorageServer* self, FetchCheckpoin
 				    .detail("CheckpointID", req.checkpointID);
 			}
 
-			wait(req.reply.onReady());
+			wait(req.reply.onReady() && self->fetchSourceBudget.ready());
 			FetchCheckpointKeyValuesStreamReply reply;
 			reply.arena.dependsOn(res.arena());
 			for (int i = 0; i < res.size(); ++i) {
@@ -2951,6 +3359,7 @@ ACTOR Future<Void> fetchCheckpointKeyValuesQ(StorageServer* self, FetchCheckpoin
 			}
 
 			req.reply.send(reply);
+			self->fetchSourceBudget.addBytes(res.expectedSize());
 		}
 	} catch (Error& e) {
 		if (e.code() == error_code_end_of_stream || e.code() == error_code_checkpoint_not_found) {
@@ -3220,6 +3629,7 @@ enum FeedDiskReadState { STARTING, NORMAL, DISK_CATCHUP };
 ACTOR Future<std::pair<ChangeFeedStreamReply, bool>> getChangeFeedMutations(StorageServer* data,
                                                                             Reference<ChangeFeedInfo> feedInfo,
                                                                             ChangeFeedStreamRequest req,
+                                                                            NetworkAddress peer,
                                                                             bool atLatest,
                                                                             bool doFilterMutations,
                                                                             int commonFeedPrefixLength,
@@ -3237,7 +3647,7 @@ ACTOR Future<std::pair<ChangeFeedStreamReply, bool>> getChangeFeedMutations(Stor
 		    .detail("Range", req.range)
 		    .detail("Begin", req.begin)
 		    .detail("End", req.end)
-		    .detail("PeerAddr", req.reply.getEndpoint().getPrimaryAddress());
+		    .detail("PeerAddr", peer);
 	}
 
 	if (data->version.get() < req.begin) {
@@ -3284,7 +3694,7 @@ ACTOR Future<std::pair<ChangeFeedStreamReply, bool>> getChangeFeedMutations(Stor
 		    .detail("FetchVersion", feedInfo->fetchVersion)
 		    .detail("DurableFetchVersion", feedInfo->durableFetchVersion.get())
 		    .detail("DurableValidationVersion", durableValidationVersion)
-		    .detail("PeerAddr", req.reply.getEndpoint().getPrimaryAddress());
+		    .detail("PeerAddr", peer);
 	}
 
 	if (req.end > emptyVersion + 1) {
@@ -3616,7 +4026,7 @@ ACTOR Future<std::pair<ChangeFeedStreamReply, bool>> getChangeFeedMutations(Stor
 		// was popped. We can check by confirming that the client was sent empty versions as part of another feed's
 		// response's minStorageVersion, or a ChangeFeedUpdateRequest. If this was the case, we know no updates could
 		// have happened between req.begin and minVersion.
-		Version minVersion = data->minFeedVersionForAddress(req.reply.getEndpoint().getPrimaryAddress());
+		Version minVersion = data->minFeedVersionForAddress(peer);
 		bool ok = atLatest && minVersion > feedInfo->emptyVersion;
 		CODE_PROBE(ok, "feed popped while valid read waiting");
 		CODE_PROBE(!ok, "feed popped while invalid read waiting");
@@ -3711,7 +4121,7 @@ ACTOR Future<std::pair<ChangeFeedStreamReply, bool>> getChangeFeedMutations(Stor
 		    .detail("PopVersion", reply.popVersion)
 		    .detail("Count", reply.mutations.size())
 		    .detail("GotAll", gotAll)
-		    .detail("PeerAddr", req.reply.getEndpoint().getPrimaryAddress());
+		    .detail("PeerAddr", peer);
 	}
 
 	// If the SS's version advanced at all during any of the waits, the read from memory may have missed some
@@ -3859,8 +4269,15 @@ ACTOR Future<Void> changeFeedStreamQ(StorageServer* data, ChangeFeedStreamReques
 			wait(onReady);
 
 			// keep this as not state variable so it is freed after sending to reduce memory
-			Future<std::pair<ChangeFeedStreamReply, bool>> feedReplyFuture = getChangeFeedMutations(
-			    data, feedInfo, req, atLatest, doFilterMutations, commonFeedPrefixLength, &feedDiskReadState);
+			Future<std::pair<ChangeFeedStreamReply, bool>> feedReplyFuture =
+			    getChangeFeedMutations(data,
+			                           feedInfo,
+			                           req,
+			                           req.reply.getEndpoint().getPrimaryAddress(),
+			                           atLatest,
+			                           doFilterMutations,
+			                           commonFeedPrefixLength,
+			                           &feedDiskReadState);
 			if (atLatest && !removeUID && !feedReplyFuture.isReady()) {
 				data->changeFeedClientVersions[req.reply.getEndpoint().getPrimaryAddress()][req.id] =
 				    blockedVersion.present() ? blockedVersion.get() : data->prevVersion;
@@ -3959,6 +4376,304 @@ ACTOR Future<Void> changeFeedStreamQ(StorageServer* data, ChangeFeedStreamReques
 	return Void();
 }
 
+static Version changeFeedMultiStreamMinBegin(ChangeFeedMultiStreamRequest const& req) {
+	Version minBegin = MAX_VERSION;
+	for (auto& feed : req.feeds) {
+		minBegin = std::min(minBegin, feed.begin);
+	}
+	return minBegin;
+}
+
+static UID changeFeedMultiStreamFeedID(UID streamID, int feedIndex) {
+	return UID(streamID.first(), streamID.second() + feedIndex);
+}
+
+// Removes the move triggers of the first count feeds of the stream, skipping any that were already fired
+static void removeChangeFeedMultiStreamMoveTriggers(StorageServer* data,
+                                                    ChangeFeedMultiStreamRequest const& req,
+                                                    int count) {
+	for (int i = 0; i < count; i++) {
+		auto feed = data->uidChangeFeed.find(req.feeds[i].rangeID);
+		if (feed == data->uidChangeFeed.end()) {
+			continue;
+		}
+		auto triggers = feed->second->moveTriggers.modify(req.feeds[i].range);
+		for (auto triggerRange = triggers.begin(); triggerRange != triggers.end(); ++triggerRange) {
+			triggerRange->value().erase(changeFeedMultiStreamFeedID(req.id, i));
+		}
+	}
+}
+
+// Like stopChangeFeedOnMove, the multi stream is failed as soon as any of its feeds is moved away
+ACTOR Future<Void> stopChangeFeedMultiStreamOnMove(StorageServer* data, ChangeFeedMultiStreamRequest req) {
+	state Promise<Void> moved;
+	for (int i = 0; i < req.feeds.size(); i++) {
+		auto feed = data->uidChangeFeed.find(req.feeds[i].rangeID);
+		if (feed == data->uidChangeFeed.end() || feed->second->removing) {
+			removeChangeFeedMultiStreamMoveTriggers(data, req, i);
+			req.reply.sendError(unknown_change_feed());
+			return Void();
+		}
+		feed->second->triggerOnMove(req.feeds[i].range, changeFeedMultiStreamFeedID(req.id, i), moved);
+	}
+	try {
+		wait(moved.getFuture());
+	} catch (Error& e) {
+		ASSERT(e.code() == error_code_operation_cancelled);
+		removeChangeFeedMultiStreamMoveTriggers(data, req, req.feeds.size());
+		return Void();
+	}
+	CODE_PROBE(true, "Change feed moved away cancelling multi stream");
+	removeChangeFeedMultiStreamMoveTriggers(data, req, req.feeds.size());
+	req.reply.sendError(wrong_shard_server());
+	return Void();
+}
+
+// Serves many feeds over one stream. Each round reads, with getChangeFeedMutations, only the feeds that have not been
+// sent everything up to the storage server's version, and replies once for all of them with a shared minStreamVersion.
+// Once every feed has caught up, the stream waits for any of them to get new mutations.
+ACTOR Future<Void> changeFeedMultiStreamQ(StorageServer* data, ChangeFeedMultiStreamRequest req) {
+	state Span span("SS:getChangeFeedMultiStream"_loc, req.spanContext);
+	state NetworkAddress peer = req.reply.getEndpoint().getPrimaryAddress();
+	state std::vector<Reference<ChangeFeedInfo>> feedInfos;
+	state std::vector<ChangeFeedStreamRequest> feedReqs;
+	state std::vector<bool> doFilterMutations;
+	state std::vector<int> commonFeedPrefixLengths;
+	state std::vector<FeedDiskReadState> feedDiskReadStates;
+	state std::vector<bool> atLatest;
+	state std::vector<Version> lastSentVersions;
+	state std::vector<Version> popVersions;
+	state std::vector<int> activeFeeds; // feeds that have not reached their end version
+	state std::vector<int> readFeeds;
+	state std::vector<Future<std::pair<ChangeFeedStreamReply, bool>>> reads;
+	state Version sentMinVersion = invalidVersion;
+	state bool streamAtLatest = false;
+	state bool removeUID = false;
+	state int activeQueries = 0;
+
+	try {
+		++data->counters.feedStreamQueries;
+
+		if (req.feeds.empty()) {
+			req.reply.sendError(end_of_stream());
+			return Void();
+		}
+
+		// every feed counts towards the limit, as each is as much work as a stream of its own
+		if (data->activeFeedQueries + (int)req.feeds.size() > SERVER_KNOBS->STORAGE_FEED_QUERY_HARD_LIMIT ||
+		    (g_network->isSimulated() && BUGGIFY_WITH_PROB(0.005))) {
+			req.reply.sendError(storage_too_many_feed_streams());
+			++data->counters.rejectedFeedStreamQueries;
+			return Void();
+		}
+
+		activeQueries = req.feeds.size();
+		data->activeFeedQueries += activeQueries;
+
+		if (req.replyBufferSize <= 0) {
+			req.reply.setByteLimit(SERVER_KNOBS->CHANGEFEEDSTREAM_LIMIT_BYTES);
+		} else {
+			req.reply.setByteLimit(std::min((int64_t)req.replyBufferSize, SERVER_KNOBS->CHANGEFEEDSTREAM_LIMIT_BYTES));
+		}
+
+		wait(delay(0, TaskPriority::SSSpilledChangeFeedReply));
+
+		if (DEBUG_CF_TRACE) {
+			TraceEvent(SevDebug, "TraceChangeFeedMultiStreamStart", data->thisServerID)
+			    .detail("StreamUID", req.id)
+			    .detail("Feeds", req.feeds.size())
+			    .detail("PeerAddr", peer);
+		}
+
+		wait(success(waitForVersionNoTooOld(data, changeFeedMultiStreamMinBegin(req))));
+
+		for (int i = 0; i < req.feeds.size(); i++) {
+			auto feed = data->uidChangeFeed.find(req.feeds[i].rangeID);
+			if (feed == data->uidChangeFeed.end() || feed->second->removing) {
+				throw unknown_change_feed();
+			}
+			feedInfos.push_back(feed->second);
+
+			ChangeFeedStreamRequest feedReq;
+			feedReq.spanContext = req.spanContext;
+			feedReq.rangeID = req.feeds[i].rangeID;
+			feedReq.begin = req.feeds[i].begin;
+			feedReq.end = req.feeds[i].end;
+			feedReq.range = req.feeds[i].range;
+			feedReq.canReadPopped = false;
+			feedReq.id = changeFeedMultiStreamFeedID(req.id, i);
+			feedReq.options = req.options;
+			feedReq.encrypted = req.encrypted;
+			feedReqs.push_back(feedReq);
+
+			doFilterMutations.push_back(!feedReq.range.contains(feed->second->range));
+			commonFeedPrefixLengths.push_back(
+			    doFilterMutations.back() ? commonPrefixLength(feed->second->range.begin, feed->second->range.end) : 0);
+			feedDiskReadStates.push_back(STARTING);
+			atLatest.push_back(false);
+			lastSentVersions.push_back(feedReq.begin - 1);
+			popVersions.push_back(invalidVersion);
+			activeFeeds.push_back(i);
+		}
+
+		// send an empty reply to establish the stream quickly
+		req.reply.send(ChangeFeedMultiStreamReply());
+
+		loop {
+			bool caughtUp = true;
+			streamAtLatest = true;
+			for (int idx : activeFeeds) {
+				caughtUp = caughtUp && lastSentVersions[idx] >= data->version.get();
+				streamAtLatest = streamAtLatest && atLatest[idx];
+			}
+
+			if (caughtUp) {
+				// Every new mutation for one of the feeds triggers it, so the client can be sent version updates
+				// without this stream until then
+				if (removeUID) {
+					data->changeFeedClientVersions[peer].erase(req.id);
+					removeUID = false;
+				}
+				std::vector<Future<Void>> wakeUp;
+				Version streamEnd = MAX_VERSION;
+				for (int idx : activeFeeds) {
+					if (feedInfos[idx]->removing) {
+						throw unknown_change_feed();
+					}
+					wakeUp.push_back(feedInfos[idx]->newMutations.onTrigger());
+					streamEnd = std::min(streamEnd, feedReqs[idx].end);
+				}
+				if (streamEnd != MAX_VERSION) {
+					wakeUp.push_back(data->version.whenAtLeast(streamEnd));
+				}
+				wait(waitForAny(wakeUp));
+
+				// This runs synchronously from the trigger in the storage update loop, so nothing at or after the
+				// version being applied has been sent to the client yet
+				if (streamAtLatest) {
+					data->changeFeedClientVersions[peer][req.id] = data->prevVersion;
+					removeUID = true;
+				}
+				// let the update loop finish applying the version to all of the feeds before reading any of them
+				wait(delay(0));
+				continue;
+			}
+
+			wait(req.reply.onReady());
+
+			readFeeds.clear();
+			for (int idx : activeFeeds) {
+				if (lastSentVersions[idx] < data->version.get()) {
+					readFeeds.push_back(idx);
+					reads.push_back(getChangeFeedMutations(data,
+					                                       feedInfos[idx],
+					                                       feedReqs[idx],
+					                                       peer,
+					                                       atLatest[idx],
+					                                       doFilterMutations[idx],
+					                                       commonFeedPrefixLengths[idx],
+					                                       &feedDiskReadStates[idx]));
+				}
+			}
+			wait(waitForAll(reads));
+
+			ChangeFeedMultiStreamReply reply;
+			int endedFeeds = 0;
+			for (int r = 0; r < readFeeds.size(); r++) {
+				int idx = readFeeds[r];
+				ChangeFeedStreamReply const& feedReply = reads[r].get().first;
+				ASSERT(feedReply.mutations.size() > 0);
+				lastSentVersions[idx] = feedReply.mutations.back().version;
+				feedReqs[idx].begin = lastSentVersions[idx] + 1;
+				if (reads[r].get().second) {
+					atLatest[idx] = true;
+				}
+				data->counters.feedRowsQueried += feedReply.mutations.size();
+				data->counters.feedBytesQueried += feedReply.mutations.expectedSize();
+
+				// empty versions are covered by minStreamVersion instead
+				ChangeFeedMultiStreamFeedRef feed(idx);
+				for (auto& m : feedReply.mutations) {
+					if (m.mutations.size()) {
+						feed.mutations.push_back(reply.arena, m);
+					}
+				}
+				feed.ended = feedReqs[idx].begin == feedReqs[idx].end;
+				endedFeeds += feed.ended;
+				if (feed.mutations.size() || feed.ended || feedReply.popVersion != popVersions[idx]) {
+					reply.arena.dependsOn(feedReply.arena);
+					feed.popVersion = feedReply.popVersion;
+					popVersions[idx] = feedReply.popVersion;
+					reply.feeds.push_back(reply.arena, feed);
+				}
+			}
+			reads.clear();
+
+			if (endedFeeds) {
+				std::vector<int> stillActive;
+				for (int idx : activeFeeds) {
+					if (feedReqs[idx].begin != feedReqs[idx].end) {
+						stillActive.push_back(idx);
+					}
+				}
+				activeFeeds = stillActive;
+				data->activeFeedQueries -= endedFeeds;
+				activeQueries -= endedFeeds;
+			}
+
+			Version minVersion = data->version.get();
+			streamAtLatest = true;
+			for (int idx : activeFeeds) {
+				minVersion = std::min(minVersion, lastSentVersions[idx]);
+				streamAtLatest = streamAtLatest && atLatest[idx];
+			}
+			auto& clientVersions = data->changeFeedClientVersions[peer];
+			if (streamAtLatest && !activeFeeds.empty()) {
+				clientVersions[req.id] = minVersion;
+				removeUID = true;
+			}
+			for (auto& it : clientVersions) {
+				minVersion = std::min(minVersion, it.second);
+			}
+
+			if (reply.feeds.size() || minVersion > sentMinVersion) {
+				reply.atLatestVersion = streamAtLatest;
+				reply.minStreamVersion = minVersion;
+				sentMinVersion = minVersion;
+				req.reply.send(reply);
+			}
+
+			if (activeFeeds.empty()) {
+				if (removeUID) {
+					clientVersions.erase(req.id);
+					removeUID = false;
+				}
+				req.reply.sendError(end_of_stream());
+				break;
+			}
+		}
+	} catch (Error& e) {
+		data->activeFeedQueries -= activeQueries;
+		activeQueries = 0;
+		auto it = data->changeFeedClientVersions.find(peer);
+		if (it != data->changeFeedClientVersions.end()) {
+			if (removeUID) {
+				it->second.erase(req.id);
+			}
+			if (it->second.empty()) {
+				data->changeFeedClientVersions.erase(it);
+			}
+		}
+		if (e.code() != error_code_operation_obsolete) {
+			if (!canReplyWith(e))
+				throw;
+			req.reply.sendError(e);
+		}
+	}
+	data->activeFeedQueries -= activeQueries;
+	return Void();
+}
+
 ACTOR Future<Void> changeFeedVersionUpdateQ(StorageServer* data, ChangeFeedVersionUpdateRequest req) {
 	++data->counters.feedVersionQueries;
 	wait(data->version.whenAtLeast(req.minVersion));
@@ -4062,6 +4777,7 @@ void merge(Arena& arena,
 // Combines data from base (at an older version) with sets from newer versions in [start, end) and appends the first (up
 // to) |limit| rows to output If limit<0, base and output are in descending order, and start->key()>end->key(), but
 // start is still inclusive and end is exclusive
+// The rows of vm_output must already be owned by arena (see materializeVersionedRows), so neither input is copied.
 {
 	ASSERT(limit != 0);
 	// Add a dependency of the new arena on the result from the KVS so that we don't have to copy any of the KVS
@@ -4072,6 +4788,8 @@ void merge(Arena& arena,
 	if (!forward)
 		limit = -limit;
 	int adjustedLimit = limit + output.size();
+	// Size the output once for the most rows this merge can produce, rather than growing it row by row
+	output.reserve(arena, output.size() + std::min(limit, base.size() + vCount));
 	int accumulatedBytes = 0;
 	KeyValueRef const* baseStart = base.begin();
 	KeyValueRef const* baseEnd = base.end();
@@ -4079,7 +4797,7 @@ void merge(Arena& arena,
 		if (forward ? baseStart->key < vm_output[pos].key : baseStart->key > vm_output[pos].key) {
 			output.push_back(arena, removePrefix(*baseStart++, tenantPrefix));
 		} else {
-			output.push_back_deep(arena, removePrefix(vm_output[pos], tenantPrefix));
+			output.push_back(arena, removePrefix(vm_output[pos], tenantPrefix));
 			if (baseStart->key == vm_output[pos].key)
 				++baseStart;
 			++pos;
@@ -4093,7 +4811,7 @@ void merge(Arena& arena,
 	}
 	if (!stopAtEndOfBase) {
 		while (vCount > 0 && output.size() < adjustedLimit && accumulatedBytes < limitBytes) {
-			output.push_back_deep(arena, removePrefix(vm_output[pos], tenantPrefix));
+			output.push_back(arena, removePrefix(vm_output[pos], tenantPrefix));
 			accumulatedBytes += sizeof(KeyValueRef) + output.end()[-1].expectedSize();
 			++pos;
 			vCount--;
@@ -4101,6 +4819,54 @@ void merge(Arena& arena,
 	}
 }
 
+// Copies the keys and values of rows[begin, rows.size()), which point into the versioned map, into a single contiguous
+// allocation in arena of dataBytes, the sum of their key and value sizes. The rows then stay valid across waits and can
+// be merged into a reply in the same arena without being copied again.
+void materializeVersionedRows(Arena& arena, VectorRef<KeyValueRef>& rows, int begin, int dataBytes) {
+	if (begin == rows.size()) {
+		return;
+	}
+	uint8_t* buffer = new (arena) uint8_t[dataBytes];
+	for (int i = begin; i < rows.size(); ++i) {
+		KeyValueRef& row = rows[i];
+		memcpy(buffer, row.key.begin(), row.key.size());
+		row.key = KeyRef(buffer, row.key.size());
+		buffer += row.key.size();
+		memcpy(buffer, row.value.begin(), row.value.size());
+		row.value = ValueRef(buffer, row.value.size());
+		buffer += row.value.size();
+	}
+}
+
+TEST_CASE("/fdbserver/storageserver/mergeVersionedRows") {
+	state Arena arena;
+	state RangeResult base;
+	for (const auto& k : { "a"_sr, "c"_sr, "e"_sr }) {
+		base.push_back_deep(base.arena(), KeyValueRef(k, "disk"_sr));
+	}
+	state VectorRef<KeyValueRef> vmRows;
+	{
+		Standalone<StringRef> memKeyB = "b"_sr, memKeyC = "c"_sr, memValue = "mem"_sr;
+		vmRows.emplace_back(arena, memKeyB, memValue);
+		vmRows.emplace_back(arena, memKeyC, memValue);
+		materializeVersionedRows(arena, vmRows, 0, 2 * (1 + memValue.size()));
+	}
+	// The rows must no longer reference the (now freed) memory of the versioned map
+	ASSERT(vmRows[0].key == "b"_sr && vmRows[1].key == "c"_sr && vmRows[1].value == "mem"_sr);
+
+	VectorRef<KeyValueRef, VecSerStrategy::String> output;
+	int vCount = vmRows.size();
+	int pos = 0;
+	merge(arena, output, vmRows, base, vCount, 10, false, pos, 1 << 20, Optional<KeyRef>());
+	ASSERT(output.size() == 4 && vCount == 0 && pos == 2);
+	ASSERT(output[0].key == "a"_sr && output[0].value == "disk"_sr);
+	ASSERT(output[1].key == "b"_sr && output[1].value == "mem"_sr);
+	ASSERT(output[2].key == "c"_sr && output[2].value == "mem"_sr);
+	ASSERT(output[3].key == "e"_sr && output[3].value == "disk"_sr);
+
+	return Void();
+}
+
 static inline void copyOptionalValue(Arena* a,
                                      GetValueReqAndResultRef& getValue,
                                      const Optional<Value>& optionalValue) {
@@ -4169,6 +4935,65 @@ ACTOR Future<GetValueReqAndResultRef> quickGetValue(StorageServer* data,
 	}
 }
 
+// Looks up keys, which must all be readable on this server, with a single local GetValuesRequest so that their storage
+// engine reads are issued together, and fills in results[i] for keys[i]. If the batch fails each key is retried through
+// quickGetValue, which can fall back to reading from other servers.
+ACTOR Future<Void> quickGetValues(StorageServer* data,
+                                  std::vector<Key> keys,
+                                  Version version,
+                                  Arena* a,
+                                  GetMappedKeyValuesRequest* pOriginalReq,
+                                  std::vector<MappedKeyValueRef*> results) {
+	state double getValuesStart = g_network->timer();
+	try {
+		state GetValuesRequest req;
+		req.spanContext = pOriginalReq->spanContext;
+		req.tenantInfo = pOriginalReq->tenantInfo;
+		req.version = version;
+		req.tags = pOriginalReq->tags;
+		req.options = pOriginalReq->options;
+		req.keys.reserve(req.arena, keys.size());
+		for (const auto& key : keys) {
+			req.keys.push_back(req.arena, key);
+		}
+		// Like quickGetValue, this does not use readGuard, throttling is enforced on the original request.
+		data->actors.add(getValuesQ(data, req));
+		GetValuesReply reply = wait(req.reply.getFuture());
+		if (!reply.error.present()) {
+			// The reply holds the keys which were found, in request order
+			a->dependsOn(reply.arena);
+			int found = 0;
+			for (int i = 0; i < keys.size(); ++i) {
+				GetValueReqAndResultRef getValue;
+				getValue.key = keys[i];
+				if (found < reply.data.size() && reply.data[found].key == keys[i]) {
+					getValue.result = reply.data[found++].value;
+				}
+				results[i]->reqAndResult = getValue;
+			}
+			data->counters.quickGetValueHit += keys.size();
+			data->counters.mappedRangeLocalSample.addMeasurement(g_network->timer() - getValuesStart);
+			return Void();
+		}
+		// Otherwise fallback.
+	} catch (Error& e) {
+		if (e.code() == error_code_actor_cancelled) {
+			throw;
+		}
+		// Fallback.
+	}
+
+	state std::vector<Future<GetValueReqAndResultRef>> getValues;
+	for (const auto& key : keys) {
+		getValues.push_back(quickGetValue(data, key, version, a, pOriginalReq));
+	}
+	wait(waitForAll(getValues));
+	for (int i = 0; i < keys.size(); ++i) {
+		results[i]->reqAndResult = getValues[i].get();
+	}
+	return Void();
+}
+
 // If limit>=0, it returns the first rows in the range (sorted ascending), otherwise the last rows (sorted descending).
 // readRange has O(|result|) + O(log |data|) cost
 ACTOR Future<GetKeyValuesReply> readRange(StorageServer* data,
@@ -4196,6 +5021,12 @@ ACTOR Future<GetKeyValuesReply> readRange(StorageServer* data,
 	// for remembering the position in the resultCache
 	state int pos = 0;
 
+	// The time not spent waiting for the storage engine is spent merging the versioned data
+	state bool samplePhases = data->sampleReadPhases();
+	state double readStart = g_network->timer();
+	state double engineStart;
+	state double engineTime = 0;
+
 	// Check if the desired key-range is cached
 	auto containingRange = data->cachedRangeMap.rangeContaining(range.begin);
 	if (containingRange.value() && containingRange->range().end >= range.end) {
@@ -4240,21 +5071,27 @@ ACTOR Future<GetKeyValuesReply> readRange(StorageServer* data,
 
 				// Read up to limit items from the view, stopping at the next clear (or the end of the range)
 				int vSize = 0;
+				int vDataBytes = 0;
+				int firstNew = resultCache.size();
 				while (vCurrent && vCurrent.key() < range.end && !vCurrent->isClearTo() && vCount < limit &&
 				       vSize < *pLimitBytes) {
 					// Store the versionedData results in resultCache
 					resultCache.emplace_back(result.arena, vCurrent.key(), vCurrent->getValue());
+					vDataBytes += resultCache.cback().expectedSize();
 					vSize += sizeof(KeyValueRef) + resultCache.cback().expectedSize() -
 					         (tenantPrefix.present() ? tenantPrefix.get().size() : 0);
 					++vCount;
 					++vCurrent;
 				}
+				materializeVersionedRows(result.arena, resultCache, firstNew, vDataBytes);
 			}
 
 			// Read the data on disk up to vCurrent (or the end of the range)
 			readEnd = vCurrent ? std::min(vCurrent.key(), range.end) : range.end;
+			engineStart = g_network->timer();
 			RangeResult atStorageVersion =
 			    wait(data->storage.readRange(KeyRangeRef(readBegin, readEnd), limit, *pLimitBytes, options));
+			engineTime += g_network->timer() - engineStart;
 			logicalSize = atStorageVersion.logicalSize();
 			data->counters.kvScanBytes += logicalSize;
 			resultLogicalSize += logicalSize;
@@ -4342,21 +5179,27 @@ ACTOR Future<GetKeyValuesReply> readRange(StorageServer* data,
 
 				vCount = 0;
 				int vSize = 0;
+				int vDataBytes = 0;
+				int firstNew = resultCache.size();
 				while (vCurrent && vCurrent.key() >= range.begin && !vCurrent->isClearTo() && vCount < -limit &&
 				       vSize < *pLimitBytes) {
 					// Store the versionedData results in resultCache
 					resultCache.emplace_back(result.arena, vCurrent.key(), vCurrent->getValue());
+					vDataBytes += resultCache.cback().expectedSize();
 					vSize += sizeof(KeyValueRef) + resultCache.cback().expectedSize() -
 					         (tenantPrefix.present() ? tenantPrefix.get().size() : 0);
 					++vCount;
 					--vCurrent;
 				}
+				materializeVersionedRows(result.arena, resultCache, firstNew, vDataBytes);
 			}
 
 			readBegin = vCurrent ? std::max(vCurrent->isClearTo() ? vCurrent->getEndKey() : vCurrent.key(), range.begin)
 			                     : range.begin;
+			engineStart = g_network->timer();
 			RangeResult atStorageVersion =
 			    wait(data->storage.readRange(KeyRangeRef(readBegin, readEnd), limit, *pLimitBytes, options));
+			engineTime += g_network->timer() - engineStart;
 			logicalSize = atStorageVersion.logicalSize();
 			data->counters.kvScanBytes += logicalSize;
 			resultLogicalSize += logicalSize;
@@ -4417,6 +5260,10 @@ ACTOR Future<GetKeyValuesReply> readRange(StorageServer* data,
 	ASSERT(result.data.size() == 0 || *pLimitBytes + result.data.end()[-1].expectedSize() + sizeof(KeyValueRef) > 0);
 	result.more = limit == 0 || *pLimitBytes <= 0; // FIXME: Does this have to be exact?
 	result.version = version;
+	if (samplePhases) {
+		data->counters.readEngineSample.addMeasurement(engineTime);
+		data->counters.readVersionedDataSample.addMeasurement(g_network->timer() - readStart - engineTime);
+	}
 	return result;
 }
 
@@ -4552,6 +5399,24 @@ KeyRange getShardKeyRange(StorageServer* data, const KeySelectorRef& sel)
 	return KeyRangeRef(begin, end);
 }
 
+// Replaces the rows of a reply to a digestOnly request with their digest, keeping the key of the last row
+void digestKeyValuesReply(GetKeyValuesReply& reply) {
+	uint64_t digest = 0;
+	int64_t bytes = 0;
+	for (auto const& kv : reply.data) {
+		digest = XXH3_64bits_withSeed(kv.key.begin(), kv.key.size(), digest);
+		digest = XXH3_64bits_withSeed(kv.value.begin(), kv.value.size(), digest);
+		bytes += kv.expectedSize();
+	}
+	reply.digest = digest;
+	reply.digestedBytes = bytes;
+	if (!reply.data.empty()) {
+		KeyRef lastKey = reply.data.back().key;
+		reply.data = VectorRef<KeyValueRef, VecSerStrategy::String>();
+		reply.data.push_back(reply.arena, KeyValueRef(lastKey, ValueRef()));
+	}
+}
+
 void maybeInjectConsistencyScanCorruption(UID thisServerID, GetKeyValuesRequest const& req, GetKeyValuesReply& reply) {
 	if (g_simulator->consistencyScanState != ISimulator::SimConsistencyScanState::Enabled_InjectCorruption ||
 	    !req.options.present() || !req.options.get().consistencyCheckStartVersion.present() ||
@@ -4630,6 +5495,7 @@ ACTOR Future<Void> getKeyValuesQ(StorageServer* data, GetKeyValuesRequest req)
 {
 	state Span span("SS:getKeyValues"_loc, req.spanContext);
 	state int64_t resultSize = 0;
+	state int64_t rowsRead = 0;
 
 	getCurrentLineage()->modify(&TransactionLineage::txID) = req.spanContext.traceID;
 
@@ -4645,7 +5511,12 @@ ACTOR Future<Void> getKeyValuesQ(StorageServer* data, GetKeyValuesRequest req)
 	// Active load balancing runs at a very high priority (to obtain accurate queue lengths)
 	// so we need to downgrade here
 	wait(data->getQueryDelay());
-	state PriorityMultiLock::Lock readLock = wait(data->getReadLock(req.options));
+	// Data movement reads wait for the source budget before taking a read permit, so they never hold one while waiting
+	state bool isFetch = req.options.present() && req.options.get().type == ReadType::FETCH;
+	if (isFetch && data->fetchSourceBudget.enabled()) {
+		wait(data->fetchSourceBudget.ready());
+	}
+	state PriorityMultiLock::Lock readLock = wait(data->getReadLock(req.options, req.tenantInfo, req.begin.getKey()));
 
 	// Track time from requestTime through now as read queueing wait time
 	state double queueWaitEnd = g_network->timer();
@@ -4657,7 +5528,7 @@ ACTOR Future<Void> getKeyValuesQ(StorageServer* data, GetKeyValuesRequest req)
 			    "TransactionDebug", req.options.get().debugID.get().first(), "storageserver.getKeyValues.Before");
 
 		Version commitVersion = getLatestCommitVersion(req.ssLatestCommitVersions, data->tag);
-		state Version version = wait(waitForVersion(data, commitVersion, req.version, span.context));
+		state Version version = wait(waitForVersion(data, commitVersion, req.version, req.options, span.context));
 		DisabledTraceEvent("VVV", data->thisServerID)
 		    .detail("Version", version)
 		    .detail("ReqVersion", req.version)
@@ -4736,12 +5607,15 @@ ACTOR Future<Void> getKeyValuesQ(StorageServer* data, GetKeyValuesRequest req)
 			GetKeyValuesReply none;
 			none.version = version;
 			none.more = false;
-			none.penalty = data->getPenalty();
+			data->setLoadBalanceInfo(none, req.reply.getEndpoint().getPrimaryAddress());
 
 			data->checkChangeCounter(changeCounter,
 			                         KeyRangeRef(std::min<KeyRef>(req.begin.getKey(), req.end.getKey()),
 			                                     std::max<KeyRef>(req.begin.getKey(), req.end.getKey())));
 
+			if (req.digestOnly) {
+				digestKeyValuesReply(none);
+			}
 			if (g_network->isSimulated()) {
 				maybeInjectConsistencyScanCorruption(data->thisServerID, req, none);
 			}
@@ -4795,8 +5669,15 @@ ACTOR Future<Void> getKeyValuesQ(StorageServer* data, GetKeyValuesRequest req)
 				data->metrics.notifyBytesReadPerKSecond(
 				    addPrefix(r.data[r.data.size() - 1].key, req.tenantInfo.prefix, req.arena), bytesReadPerKSecond);
 			}
+			if (totalByteSize > 0 && data->hotKeys.enabled()) {
+				data->hotKeys.addRead(addPrefix(r.data[0].key, req.tenantInfo.prefix, req.arena), totalByteSize);
+			}
 
-			r.penalty = data->getPenalty();
+			data->setLoadBalanceInfo(r, req.reply.getEndpoint().getPrimaryAddress());
+			rowsRead = r.data.size();
+			if (req.digestOnly) {
+				digestKeyValuesReply(r);
+			}
 			if (g_network->isSimulated()) {
 				maybeInjectConsistencyScanCorruption(data->thisServerID, req, r);
 			}
@@ -4804,8 +5685,8 @@ ACTOR Future<Void> getKeyValuesQ(StorageServer* data, GetKeyValuesRequest req)
 
 			resultSize = req.limitBytes - remainingLimitBytes;
 			data->counters.bytesQueried += resultSize;
-			data->counters.rowsQueried += r.data.size();
-			if (r.data.size() == 0) {
+			data->counters.rowsQueried += rowsRead;
+			if (rowsRead == 0) {
 				++data->counters.emptyQueries;
 			}
 		}
@@ -4815,12 +5696,17 @@ ACTOR Future<Void> getKeyValuesQ(StorageServer* data, GetKeyValuesRequest req)
 		data->sendErrorWithPenalty(req.reply, e, data->getPenalty());
 	}
 
-	data->transactionTagCounter.addRequest(req.tags, resultSize);
+	data->transactionTagCounter.addRequest(req.tags, resultSize, rowsRead);
 	++data->counters.finishedQueries;
 
 	double duration = g_network->timer() - req.requestTime();
 	data->counters.readLatencySample.addMeasurement(duration);
 	data->counters.readRangeLatencySample.addMeasurement(duration);
+	if (isFetch) {
+		data->fetchSourceBudget.addBytes(resultSize);
+	} else {
+		data->fetchSourceBudget.addReadLatency(duration);
+	}
 	if (data->latencyBandConfig.present()) {
 		int maxReadBytes =
 		    data->latencyBandConfig.get().readConfig.maxReadBytes.orDefault(std::numeric_limits<int>::max());
@@ -5515,6 +6401,65 @@ ACTOR Future<Void> auditStorageServerShardQ(StorageServer* data, AuditStorageReq
 	return Void();
 }
 
+// Reads range at version from each of the remote servers and then from the local server, replying in that order. With
+// digestOnly, each replies with a digest of its rows instead of the rows.
+ACTOR Future<std::vector<ErrorOr<GetKeyValuesReply>>> readAuditReplicas(StorageServer* data,
+                                                                       AuditStorageRequest req,
+                                                                       std::vector<Optional<Value>> serverListValues,
+                                                                       KeyRange range,
+                                                                       Version version,
+                                                                       int limit,
+                                                                       int limitBytes,
+                                                                       bool digestOnly) {
+	state std::vector<Future<ErrorOr<GetKeyValuesReply>>> fs;
+	for (const auto& v : serverListValues) {
+		if (!v.present()) {
+			TraceEvent(SevWarn, "SSAuditStorageShardReplicaRemoteServerNotFound", data->thisServerID)
+			    .detail("AuditID", req.id)
+			    .detail("AuditRange", req.range)
+			    .detail("AuditType", req.type);
+			throw audit_storage_failed();
+		}
+		StorageServerInterface remoteServer = decodeServerListValue(v.get());
+
+		GetKeyValuesRequest req;
+		req.begin = firstGreaterOrEqual(range.begin);
+		req.end = firstGreaterOrEqual(range.end);
+		req.limit = limit;
+		req.limitBytes = limitBytes;
+		req.version = version;
+		req.tags = TagSet();
+		req.digestOnly = digestOnly;
+		fs.push_back(remoteServer.getKeyValues.getReplyUnlessFailedFor(req, 2, 0));
+	}
+
+	GetKeyValuesRequest localReq;
+	localReq.begin = firstGreaterOrEqual(range.begin);
+	localReq.end = firstGreaterOrEqual(range.end);
+	localReq.limit = limit;
+	localReq.limitBytes = limitBytes;
+	localReq.version = version;
+	localReq.tags = TagSet();
+	localReq.digestOnly = digestOnly;
+	data->actors.add(getKeyValuesQ(data, localReq));
+	fs.push_back(errorOr(localReq.reply.getFuture()));
+	std::vector<ErrorOr<GetKeyValuesReply>> reps = wait(getAll(fs));
+	return reps;
+}
+
+// Whether replies to a digestOnly read all have the same digest and end at the same key, so that comparing them
+// validates the range up to that key just as comparing the rows would
+static bool auditDigestsAgree(std::vector<ErrorOr<GetKeyValuesReply>> const& reps) {
+	for (auto const& rep : reps) {
+		if (!rep.present() || rep.get().error.present() || !rep.get().digest.present() ||
+		    rep.get().digest != reps.back().get().digest || rep.get().more != reps.back().get().more ||
+		    rep.get().data != reps.back().get().data) {
+			return false;
+		}
+	}
+	return true;
+}
+
 ACTOR Future<Void> auditStorageShardReplicaQ(StorageServer* data, AuditStorageRequest req) {
 	ASSERT(req.getType() == AuditType::ValidateHA || req.getType() == AuditType::ValidateReplica);
 	wait(data->serveAuditStorageParallelismLock.take(TaskPriority::DefaultYield));
@@ -5528,7 +6473,7 @@ ACTOR Future<Void> auditStorageShardReplicaQ(StorageServer* data, AuditStorageRe
 
 	state AuditStorageState res(req.id, req.getType()); // we will set range of audit later
 	state std::vector<Optional<Value>> serverListValues;
-	state std::vector<Future<ErrorOr<GetKeyValuesReply>>> fs;
+	state std::vector<ErrorOr<GetKeyValuesReply>> reps;
 	state std::vector<std::string> errors;
 	state Version version;
 	state Transaction tr(data->cx);
@@ -5537,6 +6482,9 @@ ACTOR Future<Void> auditStorageShardReplicaQ(StorageServer* data, AuditStorageRe
 	state KeyRange claimRange;
 	state int limit = 1e4;
 	state int limitBytes = CLIENT_KNOBS->REPLY_BYTE_LIMIT;
+	// The replicas first compare digests of up to digestBytes of rows, and compare the rows themselves only once
+	// digests of ever smaller ranges have narrowed a mismatch down to limitBytes
+	state int digestBytes = SERVER_KNOBS->AUDIT_STORAGE_DIGEST_BYTES;
 	state int64_t readBytes = 0;
 	state int64_t numValidatedKeys = 0;
 	state int64_t validatedBytes = 0;
@@ -5563,7 +6511,7 @@ ACTOR Future<Void> auditStorageShardReplicaQ(StorageServer* data, AuditStorageRe
 				    .detail("ReadRangeEnd", req.range.end);
 				serverListValues.clear();
 				errors.clear();
-				fs.clear();
+				reps.clear();
 				tr.reset();
 				tr.setOption(FDBTransactionOptions::PRIORITY_SYSTEM_IMMEDIATE);
 				tr.setOption(FDBTransactionOptions::ACCESS_SYSTEM_KEYS);
@@ -5581,39 +6529,38 @@ ACTOR Future<Void> auditStorageShardReplicaQ(StorageServer* data, AuditStorageRe
 				// Decide version to compare
 				wait(store(version, tr.getReadVersion()));
 
-				// Read remote servers
-				for (const auto& v : serverListValues) {
-					if (!v.present()) {
-						TraceEvent(SevWarn, "SSAuditStorageShardReplicaRemoteServerNotFound", data->thisServerID)
-						    .detail("AuditID", req.id)
-						    .detail("AuditRange", req.range)
-						    .detail("AuditType", req.type);
-						throw audit_storage_failed();
+				// Digest replies carry only the last key read, which the validation below compares like any other
+				while (digestBytes > limitBytes && !serverListValues.empty()) {
+					wait(store(reps,
+					           readAuditReplicas(data,
+					                             req,
+					                             serverListValues,
+					                             rangeToRead,
+					                             version,
+					                             limit * (digestBytes / limitBytes),
+					                             digestBytes,
+					                             true)));
+					if (auditDigestsAgree(reps)) {
+						break;
 					}
-					StorageServerInterface remoteServer = decodeServerListValue(v.get());
-
-					GetKeyValuesRequest req;
-					req.begin = firstGreaterOrEqual(rangeToRead.begin);
-					req.end = firstGreaterOrEqual(rangeToRead.end);
-					req.limit = limit;
-					req.limitBytes = limitBytes;
-					req.version = version;
-					req.tags = TagSet();
-					fs.push_back(remoteServer.getKeyValues.getReplyUnlessFailedFor(req, 2, 0));
-				}
-
-				// Read local server
-				GetKeyValuesRequest localReq;
-				localReq.begin = firstGreaterOrEqual(rangeToRead.begin);
-				localReq.end = firstGreaterOrEqual(rangeToRead.end);
-				localReq.limit = limit;
-				localReq.limitBytes = limitBytes;
-				localReq.version = version;
-				localReq.tags = TagSet();
-				data->actors.add(getKeyValuesQ(data, localReq));
-				fs.push_back(errorOr(localReq.reply.getFuture()));
-				std::vector<ErrorOr<GetKeyValuesReply>> reps = wait(getAll(fs));
-				// Note: getAll() must keep the order of fs
+					bool failed = std::any_of(reps.begin(), reps.end(), [](auto const& rep) {
+						return !rep.present() || rep.get().error.present();
+					});
+					reps.clear();
+					if (failed) {
+						break; // the read of the rows reports the error
+					}
+					CODE_PROBE(true, "Audit replica digests differ");
+					digestBytes = std::max(limitBytes, digestBytes / 8);
+				}
+				if (reps.empty()) {
+					wait(store(reps,
+					           readAuditReplicas(
+					               data, req, serverListValues, rangeToRead, version, limit, limitBytes, false)));
+				}
+				// Search for the next mismatch with large digests again
+				digestBytes = std::min(SERVER_KNOBS->AUDIT_STORAGE_DIGEST_BYTES, digestBytes * 8);
+				// Note: readAuditReplicas() keeps the order of serverListValues
 
 				// Check read result
 				for (int i = 0; i < reps.size(); ++i) {
@@ -5637,8 +6584,10 @@ ACTOR Future<Void> auditStorageShardReplicaQ(StorageServer* data, AuditStorageRe
 						    .detail("RangeRead", rangeToRead);
 						throw reps[i].get().error.get();
 					}
-					readBytes = readBytes + reps[i].get().data.expectedSize();
-					validatedBytes = validatedBytes + reps[i].get().data.expectedSize();
+					const int64_t repBytes = reps[i].get().digest.present() ? reps[i].get().digestedBytes
+					                                                        : reps[i].get().data.expectedSize();
+					readBytes = readBytes + repBytes;
+					validatedBytes = validatedBytes + repBytes;
 					// If any of reps finishes read, we think we complete
 					// Even some rep does not finish read, this unfinished rep has more key than
 					// the complete rep, which will lead to missKey inconsistency in
@@ -6038,6 +6987,46 @@ ACTOR Future<Void> mapSubquery(StorageServer* data,
 	return Void();
 }
 
+// Issues the secondary queries for the index entries [begin, end), filling results into the corresponding kvms. Point
+// reads of keys which are readable locally are batched into a single quickGetValues.
+Future<Void> mapSubqueries(StorageServer* data,
+                           Version version,
+                           GetMappedKeyValuesRequest* pOriginalReq,
+                           Arena* pArena,
+                           bool isRangeQuery,
+                           std::vector<Optional<Tuple>>& vt,
+                           Tuple& mappedKeyFormatTuple,
+                           KeyValueRef* begin,
+                           KeyValueRef* end,
+                           MappedKeyValueRef* kvms) {
+	std::vector<Future<Void>> subqueries;
+	std::vector<Key> localKeys;
+	std::vector<MappedKeyValueRef*> localKvms;
+	for (KeyValueRef* it = begin; it != end; ++it) {
+		MappedKeyValueRef* kvm = &kvms[it - begin];
+		// Clear key value to the default.
+		kvm->key = ""_sr;
+		kvm->value = ""_sr;
+		Key mappedKey = constructMappedKey(it, vt, mappedKeyFormatTuple);
+		// Make sure the mappedKey is always available, so that it's good even we want to get key asynchronously.
+		pArena->dependsOn(mappedKey.arena());
+
+		if (!isRangeQuery && SERVER_KNOBS->QUICK_GET_VALUES_BATCH_LOCAL && data->shards[mappedKey]->isReadable()) {
+			localKeys.push_back(mappedKey);
+			localKvms.push_back(kvm);
+		} else {
+			subqueries.push_back(
+			    mapSubquery(data, version, pOriginalReq, pArena, isRangeQuery, it, kvm, mappedKey));
+		}
+	}
+	if (localKeys.size() == 1) {
+		subqueries.push_back(mapSubquery(data, version, pOriginalReq, pArena, false, nullptr, localKvms[0], localKeys[0]));
+	} else if (!localKeys.empty()) {
+		subqueries.push_back(quickGetValues(data, localKeys, version, pArena, pOriginalReq, localKvms));
+	}
+	return waitForAll(subqueries);
+}
+
 int getMappedKeyValueSize(MappedKeyValueRef mappedKeyValue) {
 	auto& reqAndResult = mappedKeyValue.reqAndResult;
 	int bytes = 0;
@@ -6081,42 +7070,52 @@ ACTOR Future<GetMappedKeyValuesReply> mapKeyValues(StorageServer* data,
 	preprocessMappedKey(mappedKeyFormatTuple, vt, isRangeQuery);
 
 	state int sz = input.data.size();
-	const int k = std::min(sz, SERVER_KNOBS->MAX_PARALLEL_QUICK_GET_VALUE);
-	state std::vector<MappedKeyValueRef> kvms(k);
-	state std::vector<Future<Void>> subqueries;
+	state int batchSize = SERVER_KNOBS->MAX_PARALLEL_QUICK_GET_VALUE;
+	state std::vector<MappedKeyValueRef> kvms(sz);
 	state int offset = 0;
+	state int batchEnd;
+	state Future<Void> batch;
+	state Future<Void> nextBatch;
 	if (pOriginalReq->options.present() && pOriginalReq->options.get().debugID.present())
 		g_traceBatch.addEvent("TransactionDebug",
 		                      pOriginalReq->options.get().debugID.get().first(),
 		                      "storageserver.mapKeyValues.BeforeLoop");
 
-	for (; offset<sz&& * remainingLimitBytes> 0; offset += SERVER_KNOBS->MAX_PARALLEL_QUICK_GET_VALUE) {
-		// Divide into batches of MAX_PARALLEL_QUICK_GET_VALUE subqueries
-		for (int i = 0; i + offset < sz && i < SERVER_KNOBS->MAX_PARALLEL_QUICK_GET_VALUE; i++) {
-			KeyValueRef* it = &input.data[i + offset];
-			MappedKeyValueRef* kvm = &kvms[i];
-			// Clear key value to the default.
-			kvm->key = ""_sr;
-			kvm->value = ""_sr;
-			Key mappedKey = constructMappedKey(it, vt, mappedKeyFormatTuple);
-			// Make sure the mappedKey is always available, so that it's good even we want to get key asynchronously.
-			result.arena.dependsOn(mappedKey.arena());
-
-			// std::cout << "key:" << printable(kvm->key) << ", value:" << printable(kvm->value)
-			//          << ", mappedKey:" << printable(mappedKey) << std::endl;
-
-			subqueries.push_back(
-			    mapSubquery(data, input.version, pOriginalReq, &result.arena, isRangeQuery, it, kvm, mappedKey));
-		}
-		wait(waitForAll(subqueries));
+	// Divide into batches of MAX_PARALLEL_QUICK_GET_VALUE subqueries, and issue the subqueries of the next batch while
+	// waiting for the current one, so that the lookups are pipelined rather than stalling on the slowest of each batch.
+	if (sz > 0) {
+		batch = mapSubqueries(data,
+		                      input.version,
+		                      pOriginalReq,
+		                      &result.arena,
+		                      isRangeQuery,
+		                      vt,
+		                      mappedKeyFormatTuple,
+		                      &input.data[0],
+		                      &input.data[0] + std::min(sz, batchSize),
+		                      &kvms[0]);
+	}
+	for (; offset<sz&& * remainingLimitBytes> 0; offset += batchSize) {
+		batchEnd = std::min(sz, offset + batchSize);
+		nextBatch = batchEnd < sz ? mapSubqueries(data,
+		                                          input.version,
+		                                          pOriginalReq,
+		                                          &result.arena,
+		                                          isRangeQuery,
+		                                          vt,
+		                                          mappedKeyFormatTuple,
+		                                          &input.data[batchEnd],
+		                                          &input.data[0] + std::min(sz, batchEnd + batchSize),
+		                                          &kvms[batchEnd])
+		                          : Future<Void>(Void());
+		wait(batch);
 		if (pOriginalReq->options.present() && pOriginalReq->options.get().debugID.present())
 			g_traceBatch.addEvent("TransactionDebug",
 			                      pOriginalReq->options.get().debugID.get().first(),
 			                      "storageserver.mapKeyValues.AfterBatch");
-		subqueries.clear();
-		for (int i = 0; i + offset < sz && i < SERVER_KNOBS->MAX_PARALLEL_QUICK_GET_VALUE; i++) {
+		for (int i = offset; i < batchEnd; i++) {
 			// since we always read the index, so always consider the index size
-			int indexSize = sizeof(KeyValueRef) + input.data[i + offset].expectedSize();
+			int indexSize = sizeof(KeyValueRef) + input.data[i].expectedSize();
 			int size = indexSize + getMappedKeyValueSize(kvms[i]);
 			*remainingLimitBytes -= size;
 			result.data.push_back(result.arena, kvms[i]);
@@ -6124,6 +7123,7 @@ ACTOR Future<GetMappedKeyValuesReply> mapKeyValues(StorageServer* data,
 				break;
 			}
 		}
+		batch = nextBatch;
 	}
 
 	int resultSize = result.data.size();
@@ -6143,11 +7143,9 @@ ACTOR Future<GetMappedKeyValuesReply> mapKeyValues(StorageServer* data,
 	return result;
 }
 
-bool rangeIntersectsAnyTenant(VersionedMap<int64_t, TenantSSInfo>& tenantMap, KeyRangeRef range, Version ver) {
-	auto view = tenantMap.at(ver);
-
+bool rangeIntersectsAnyTenant(TenantPrefixIndex const& tenantMap, KeyRangeRef range, Version ver) {
 	// There are no tenants, so we don't need to do any work
-	if (view.begin() == view.end()) {
+	if (tenantMap.emptyAtAllVersions()) {
 		return false;
 	}
 
@@ -6184,19 +7182,16 @@ bool rangeIntersectsAnyTenant(VersionedMap<int64_t, TenantSSInfo>& tenantMap, Ke
 		endId = TenantAPI::prefixToId(prefix) - 1;
 	}
 
-	auto beginItr = view.lower_bound(beginId);
-
-	// If beginItr has a value less than or equal to endId, then it points to a tenant intersecting the range
-	return beginItr != view.end() && beginItr.key() <= endId;
+	// Whether any tenant's id is in [beginId, endId]
+	return tenantMap.containsAny(beginId, endId, ver);
 }
 
 TEST_CASE("/fdbserver/storageserver/rangeIntersectsAnyTenant") {
 	std::set<int64_t> entries = { 0, 2, 3, 4, 6 };
 
-	VersionedMap<int64_t, TenantSSInfo> tenantMap;
-	tenantMap.createNewVersion(1);
+	TenantPrefixIndex tenantMap;
 	for (auto entry : entries) {
-		tenantMap.insert(entry, TenantSSInfo{ TenantAPI::TenantLockState::UNLOCKED });
+		tenantMap.insert(entry, TenantAPI::TenantLockState::UNLOCKED, 1);
 	}
 
 	// Before all tenants
@@ -6281,13 +7276,12 @@ TEST_CASE("/fdbserver/storageserver/rangeIntersectsAnyTenant") {
 }
 
 TEST_CASE("/fdbserver/storageserver/randomRangeIntersectsAnyTenant") {
-	VersionedMap<int64_t, TenantSSInfo> tenantMap;
+	TenantPrefixIndex tenantMap;
 	std::set<Key> tenantPrefixes;
-	tenantMap.createNewVersion(1);
 	int numEntries = deterministicRandom()->randomInt(0, 20);
 	for (int i = 0; i < numEntries; ++i) {
 		int64_t tenantId = deterministicRandom()->randomInt64(0, std::numeric_limits<int64_t>::max());
-		tenantMap.insert(tenantId, TenantSSInfo{ TenantAPI::TenantLockState::UNLOCKED });
+		tenantMap.insert(tenantId, TenantAPI::TenantLockState::UNLOCKED, 1);
 		tenantPrefixes.insert(TenantAPI::idToPrefix(tenantId));
 	}
 
@@ -6326,6 +7320,7 @@ ACTOR Future<Void> getMappedKeyValuesQ(StorageServer* data, GetMappedKeyValuesRe
 {
 	state Span span("SS:getMappedKeyValues"_loc, req.spanContext);
 	state int64_t resultSize = 0;
+	state int64_t rowsRead = 0;
 
 	getCurrentLineage()->modify(&TransactionLineage::txID) = req.spanContext.traceID;
 
@@ -6340,7 +7335,7 @@ ACTOR Future<Void> getMappedKeyValuesQ(StorageServer* data, GetMappedKeyValuesRe
 	// Active load balancing runs at a very high priority (to obtain accurate queue lengths)
 	// so we need to downgrade here
 	wait(data->getQueryDelay());
-	state PriorityMultiLock::Lock readLock = wait(data->getReadLock(req.options));
+	state PriorityMultiLock::Lock readLock = wait(data->getReadLock(req.options, req.tenantInfo, req.begin.getKey()));
 
 	// Track time from requestTime through now as read queueing wait time
 	state double queueWaitEnd = g_network->timer();
@@ -6352,11 +7347,10 @@ ACTOR Future<Void> getMappedKeyValuesQ(StorageServer* data, GetMappedKeyValuesRe
 			    "TransactionDebug", req.options.get().debugID.get().first(), "storageserver.getMappedKeyValues.Before");
 		// VERSION_VECTOR change
 		Version commitVersion = getLatestCommitVersion(req.ssLatestCommitVersions, data->tag);
-		state Version version = wait(waitForVersion(data, commitVersion, req.version, span.context));
+		state Version version = wait(waitForVersion(data, commitVersion, req.version, req.options, span.context));
 		data->counters.readVersionWaitSample.addMeasurement(g_network->timer() - queueWaitEnd);
 
-		data->checkTenantEntry(
-		    req.version, req.tenantInfo, req.options.present() ? req.options.get().lockAware : false);
+		data->checkTenantEntry(version, req.tenantInfo, req.options.present() ? req.options.get().lockAware : false);
 		if (req.tenantInfo.hasTenant()) {
 			req.begin.setKeyUnlimited(req.begin.getKey().withPrefix(req.tenantInfo.prefix.get(), req.arena));
 			req.end.setKeyUnlimited(req.end.getKey().withPrefix(req.tenantInfo.prefix.get(), req.arena));
@@ -6405,7 +7399,7 @@ ACTOR Future<Void> getMappedKeyValuesQ(StorageServer* data, GetMappedKeyValuesRe
 				throw tenant_name_required();
 			}
 
-			if (rangeIntersectsAnyTenant(data->tenantMap, KeyRangeRef(begin, end), req.version)) {
+			if (rangeIntersectsAnyTenant(data->tenantMap, KeyRangeRef(begin, end), version)) {
 				throw tenant_name_required();
 			}
 		}
@@ -6440,7 +7434,7 @@ ACTOR Future<Void> getMappedKeyValuesQ(StorageServer* data, GetMappedKeyValuesRe
 			GetMappedKeyValuesReply none;
 			none.version = version;
 			none.more = false;
-			none.penalty = data->getPenalty();
+			data->setLoadBalanceInfo(none, req.reply.getEndpoint().getPrimaryAddress());
 
 			data->checkChangeCounter(changeCounter,
 			                         KeyRangeRef(std::min<KeyRef>(req.begin.getKey(), req.end.getKey()),
@@ -6492,10 +7486,11 @@ ACTOR Future<Void> getMappedKeyValuesQ(StorageServer* data, GetMappedKeyValuesRe
 				//                ASSERT(r.data.size() <= std::abs(req.limit));
 			}
 
-			r.penalty = data->getPenalty();
+			data->setLoadBalanceInfo(r, req.reply.getEndpoint().getPrimaryAddress());
 			req.reply.send(r);
 
 			resultSize = req.limitBytes - remainingLimitBytes;
+			rowsRead = r.data.size();
 			data->counters.getMappedRangeBytesQueried += resultSize;
 			data->counters.finishedGetMappedRangeSecondaryQueries += r.data.size();
 			if (r.data.size() == 0) {
@@ -6508,7 +7503,7 @@ ACTOR Future<Void> getMappedKeyValuesQ(StorageServer* data, GetMappedKeyValuesRe
 		data->sendErrorWithPenalty(req.reply, e, data->getPenalty());
 	}
 
-	data->transactionTagCounter.addRequest(req.tags, resultSize);
+	data->transactionTagCounter.addRequest(req.tags, resultSize, rowsRead);
 	++data->counters.finishedQueries;
 	++data->counters.finishedGetMappedRangeQueries;
 
@@ -6556,7 +7551,7 @@ ACTOR Future<Void> getKeyValuesStreamQ(StorageServer* data, GetKeyValuesStreamRe
 			    "TransactionDebug", req.options.get().debugID.get().first(), "storageserver.getKeyValuesStream.Before");
 
 		Version commitVersion = getLatestCommitVersion(req.ssLatestCommitVersions, data->tag);
-		state Version version = wait(waitForVersion(data, commitVersion, req.version, span.context));
+		state Version version = wait(waitForVersion(data, commitVersion, req.version, req.options, span.context));
 
 		data->checkTenantEntry(version, req.tenantInfo, req.options.present() ? req.options.get().lockAware : false);
 		if (req.tenantInfo.hasTenant()) {
@@ -6635,21 +7630,27 @@ ACTOR Future<Void> getKeyValuesStreamQ(StorageServer* data, GetKeyValuesStreamRe
 			req.reply.send(none);
 			req.reply.sendError(end_of_stream());
 		} else {
+			state bool isFetch = req.options.present() && req.options.get().type == ReadType::FETCH;
 			loop {
-				wait(req.reply.onReady());
-				state PriorityMultiLock::Lock readLock = wait(data->getReadLock(req.options));
+				if (isFetch && data->fetchSourceBudget.enabled()) {
+					wait(data->fetchSourceBudget.ready());
+				}
+				state PriorityMultiLock::Lock readLock = wait(data->getReadLock(req.options, req.tenantInfo, begin));
 
 				if (version < data->oldestVersion.get()) {
 					throw transaction_too_old();
 				}
 
-				// Even if TSS mode is Disabled, this may be the second test in a restarting test where the first run
-				// had it enabled.
+				// Each chunk re-seeks the storage engine, so while the client has room for more than a normal reply,
+				// read up to that much at once. Even if TSS mode is Disabled, this may be the second test in a
+				// restarting test where the first run had it enabled.
 				state int byteLimit =
 				    (BUGGIFY && g_network->isSimulated() && g_simulator->tssMode == ISimulator::TSSMode::Disabled &&
 				     !data->isTss() && !data->isSSWithTSSPair())
 				        ? 1
-				        : CLIENT_KNOBS->REPLY_BYTE_LIMIT;
+				        : std::max<int64_t>(
+				              CLIENT_KNOBS->REPLY_BYTE_LIMIT,
+				              std::min(req.reply.bytesAvailable(), SERVER_KNOBS->RANGESTREAM_CHUNK_BYTES_MAX));
 				TraceEvent(SevDebug, "SSGetKeyValueStreamLimits")
 				    .detail("ByteLimit", byteLimit)
 				    .detail("ReqLimit", req.limit)
@@ -6665,7 +7666,7 @@ ACTOR Future<Void> getKeyValuesStreamQ(StorageServer* data, GetKeyValuesStreamRe
 				                                      req.options,
 				                                      req.tenantInfo.prefix));
 				readLock.release();
-				GetKeyValuesStreamReply r(_r);
+				state GetKeyValuesStreamReply r(_r);
 
 				if (req.options.present() && req.options.get().debugID.present())
 					g_traceBatch.addEvent("TransactionDebug",
@@ -6690,12 +7691,12 @@ ACTOR Future<Void> getKeyValuesStreamQ(StorageServer* data, GetKeyValuesStreamRe
 
 				// For performance concerns, the cost of a range read is billed to the start key and end key of the
 				// range.
-				int64_t totalByteSize = 0;
+				state int64_t totalByteSize = 0;
 				for (int i = 0; i < r.data.size(); i++) {
 					totalByteSize += r.data[i].expectedSize();
 				}
 
-				KeyRef lastKey;
+				state KeyRef lastKey;
 				if (!r.data.empty()) {
 					lastKey = addPrefix(r.data.back().key, req.tenantInfo.prefix, req.arena);
 				}
@@ -6706,7 +7707,13 @@ ACTOR Future<Void> getKeyValuesStreamQ(StorageServer* data, GetKeyValuesStreamRe
 					data->metrics.notifyBytesReadPerKSecond(lastKey, bytesReadPerKSecond);
 				}
 
+				// The chunk is read while the client is still consuming the previous one, and only sent once the
+				// client has acknowledged enough of the stream.
+				wait(req.reply.onReady());
 				req.reply.send(r);
+				if (isFetch) {
+					data->fetchSourceBudget.addBytes(totalByteSize);
+				}
 
 				data->counters.rowsQueried += r.data.size();
 				if (r.data.size() == 0) {
@@ -6724,7 +7731,7 @@ ACTOR Future<Void> getKeyValuesStreamQ(StorageServer* data, GetKeyValuesStreamRe
 					end = lastKey;
 				}
 
-				data->transactionTagCounter.addRequest(req.tags, resultSize);
+				data->transactionTagCounter.addRequest(req.tags, totalByteSize, r.data.size());
 				// lock.release();
 			}
 		}
@@ -6756,7 +7763,7 @@ ACTOR Future<Void> getKeyQ(StorageServer* data, GetKeyRequest req) {
 	// Active load balancing runs at a very high priority (to obtain accurate queue lengths)
 	// so we need to downgrade here
 	wait(data->getQueryDelay());
-	state PriorityMultiLock::Lock readLock = wait(data->getReadLock(req.options));
+	state PriorityMultiLock::Lock readLock = wait(data->getReadLock(req.options, req.tenantInfo, req.sel.getKey()));
 
 	// Track time from requestTime through now as read queueing wait time
 	state double queueWaitEnd = g_network->timer();
@@ -6764,7 +7771,7 @@ ACTOR Future<Void> getKeyQ(StorageServer* data, GetKeyRequest req) {
 
 	try {
 		Version commitVersion = getLatestCommitVersion(req.ssLatestCommitVersions, data->tag);
-		state Version version = wait(waitForVersion(data, commitVersion, req.version, req.spanContext));
+		state Version version = wait(waitForVersion(data, commitVersion, req.version, req.options, req.spanContext));
 		data->counters.readVersionWaitSample.addMeasurement(g_network->timer() - queueWaitEnd);
 
 		data->checkTenantEntry(version, req.tenantInfo, req.options.map(&ReadOptions::lockAware).orDefault(false));
@@ -6810,7 +7817,7 @@ ACTOR Future<Void> getKeyQ(StorageServer* data, GetKeyRequest req) {
 		// shard.begin).detail("End", shard.end);
 
 		GetKeyReply reply(updated, cached);
-		reply.penalty = data->getPenalty();
+		data->setLoadBalanceInfo(reply, req.reply.getEndpoint().getPrimaryAddress());
 
 		req.reply.send(reply);
 	} catch (Error& e) {
@@ -6859,6 +7866,7 @@ void getQueuingMetrics(StorageServer* self, StorageQueuingMetricsRequest const&
 	reply.durableVersion = self->durableVersion.get();
 
 	reply.busiestTags = self->transactionTagCounter.getBusiestTags();
+	reply.ioPressure = self->storage.getIOPressure();
 
 	req.reply.send(reply);
 }
@@ -7154,29 +8162,54 @@ void applyChangeFeedMutation(StorageServer* self,
 	ASSERT(self->encryptionMode.present());
 	ASSERT(!self->encryptionMode.get().isEncryptionEnabled() || encryptedMutation.mutation.isEncrypted() ||
 	       isBackupLogMutation(m) || mutationForKey(m, lastEpochEndPrivateKey));
+	if (self->feedMutationArenaVersion != version) {
+		self->feedMutationArena = Arena();
+		self->feedMutationArenaVersion = version;
+	}
+	// m and encryptedMutation are copied into the shared arena the first time a feed using it needs them
+	Optional<MutationRef> sharedMutation;
+	Optional<MutationRef> sharedEncrypted;
+	auto pushFeedMutation = [self](Standalone<EncryptedMutationsAndVersionRef>& entry,
+	                               VectorRef<MutationRef>& to,
+	                               MutationRef const& mutation,
+	                               Optional<MutationRef>& shared) {
+		if (!entry.arena().sameArena(self->feedMutationArena)) {
+			to.push_back_deep(entry.arena(), mutation);
+			return (int64_t)mutation.totalSize();
+		}
+		if (shared.present()) {
+			self->counters.changeFeedMutationBytesShared += mutation.expectedSize();
+			to.push_back(entry.arena(), shared.get());
+			return (int64_t)sizeof(MutationRef);
+		}
+		shared = MutationRef(self->feedMutationArena, mutation);
+		to.push_back(entry.arena(), shared.get());
+		return (int64_t)mutation.totalSize();
+	};
 	if (m.type == MutationRef::SetValue) {
 		for (auto& it : self->keyChangeFeed[m.param1]) {
 			if (version < it->stopVersion && !it->removing && version > it->emptyVersion) {
 				if (it->mutations.empty() || it->mutations.back().version != version) {
-					it->mutations.push_back(
-					    EncryptedMutationsAndVersionRef(version, self->knownCommittedVersion.get()));
+					it->mutations.emplace_back(
+					    EncryptedMutationsAndVersionRef(version, self->knownCommittedVersion.get()),
+					    self->feedMutationArena);
 				}
+				auto& entry = it->mutations.back();
 				if (encryptedMutation.mutation.isValid()) {
-					if (!it->mutations.back().encrypted.present()) {
-						it->mutations.back().encrypted = it->mutations.back().mutations;
-						it->mutations.back().cipherKeys.resize(it->mutations.back().mutations.size());
+					if (!entry.encrypted.present()) {
+						entry.encrypted = entry.mutations;
+						entry.cipherKeys.resize(entry.mutations.size());
 					}
-					it->mutations.back().encrypted.get().push_back_deep(it->mutations.back().arena(),
-					                                                    encryptedMutation.mutation);
-					it->mutations.back().cipherKeys.push_back(encryptedMutation.cipherKeys);
-				} else if (it->mutations.back().encrypted.present()) {
-					it->mutations.back().encrypted.get().push_back_deep(it->mutations.back().arena(), m);
-					it->mutations.back().cipherKeys.push_back(TextAndHeaderCipherKeys());
+					pushFeedMutation(entry, entry.encrypted.get(), encryptedMutation.mutation, sharedEncrypted);
+					entry.cipherKeys.push_back(encryptedMutation.cipherKeys);
+				} else if (entry.encrypted.present()) {
+					pushFeedMutation(entry, entry.encrypted.get(), m, sharedMutation);
+					entry.cipherKeys.push_back(TextAndHeaderCipherKeys());
 				}
-				it->mutations.back().mutations.push_back_deep(it->mutations.back().arena(), m);
+				int64_t bytes = pushFeedMutation(entry, entry.mutations, m, sharedMutation);
 
 				self->currentChangeFeeds.insert(it->id);
-				self->addFeedBytesAtVersion(m.totalSize(), version);
+				self->addFeedBytesAtVersion(bytes, version);
 
 				DEBUG_MUTATION("ChangeFeedWriteSet", version, m, self->thisServerID)
 				    .detail("Range", it->range)
@@ -7217,33 +8250,39 @@ void applyChangeFeedMutation(StorageServer* self,
 						modified = true;
 					}
 					if (it->mutations.empty() || it->mutations.back().version != version) {
-						it->mutations.push_back(
-						    EncryptedMutationsAndVersionRef(version, self->knownCommittedVersion.get()));
+						it->mutations.emplace_back(
+						    EncryptedMutationsAndVersionRef(version, self->knownCommittedVersion.get()),
+						    self->feedMutationArena);
 					}
+					auto& entry = it->mutations.back();
 					if (encryptedMutation.mutation.isEncrypted()) {
-						if (!it->mutations.back().encrypted.present()) {
-							it->mutations.back().encrypted = it->mutations.back().mutations;
-							it->mutations.back().cipherKeys.resize(it->mutations.back().mutations.size());
+						if (!entry.encrypted.present()) {
+							entry.encrypted = entry.mutations;
+							entry.cipherKeys.resize(entry.mutations.size());
 						}
 						if (modified) {
-							it->mutations.back().encrypted.get().push_back_deep(
-							    it->mutations.back().arena(),
-							    clearMutation.encrypt(encryptedMutation.cipherKeys,
-							                          it->mutations.back().arena(),
-							                          BlobCipherMetrics::TLOG));
+							entry.encrypted.get().push_back_deep(
+							    entry.arena(),
+							    clearMutation.encrypt(
+							        encryptedMutation.cipherKeys, entry.arena(), BlobCipherMetrics::TLOG));
 						} else {
-							it->mutations.back().encrypted.get().push_back_deep(it->mutations.back().arena(),
-							                                                    encryptedMutation.mutation);
+							pushFeedMutation(entry, entry.encrypted.get(), encryptedMutation.mutation, sharedEncrypted);
 						}
-						it->mutations.back().cipherKeys.push_back(encryptedMutation.cipherKeys);
-					} else if (it->mutations.back().encrypted.present()) {
-						it->mutations.back().encrypted.get().push_back_deep(it->mutations.back().arena(), m);
-						it->mutations.back().cipherKeys.push_back(TextAndHeaderCipherKeys());
+						entry.cipherKeys.push_back(encryptedMutation.cipherKeys);
+					} else if (entry.encrypted.present()) {
+						pushFeedMutation(entry, entry.encrypted.get(), m, sharedMutation);
+						entry.cipherKeys.push_back(TextAndHeaderCipherKeys());
 					}
 
-					it->mutations.back().mutations.push_back_deep(it->mutations.back().arena(), clearMutation);
+					// a clamped clear is specific to this feed, so it is not shared
+					int64_t bytes = m.totalSize();
+					if (clearMutation.param1 == m.param1 && clearMutation.param2 == m.param2) {
+						bytes = pushFeedMutation(entry, entry.mutations, m, sharedMutation);
+					} else {
+						entry.mutations.push_back_deep(entry.arena(), clearMutation);
+					}
 					self->currentChangeFeeds.insert(it->id);
-					self->addFeedBytesAtVersion(m.totalSize(), version);
+					self->addFeedBytesAtVersion(bytes, version);
 
 					DEBUG_MUTATION("ChangeFeedWriteClear", version, m, self->thisServerID)
 					    .detail("Range", it->range)
@@ -7516,6 +8555,93 @@ ACTOR Future<Void> tryGetRange(PromiseStream<RangeResult> results, Transaction*
 	}
 }
 
+struct FetchRangeStats {
+	int ranges = 1; // The number of sub-ranges the fetch was split into
+	int maxConcurrent = 1; // The most sub-ranges that were read at once
+};
+
+// Reads keys as sub-ranges of roughly FETCH_KEYS_PARALLEL_RANGE_BYTES (by the source's byte sample), several at once,
+// and sends their blocks to results in key order while the consumer writes earlier blocks, so results looks just like
+// the stream of tryGetRange() over all of keys. Concurrent reads are load balanced across the replicas of the source
+// team. Beyond the first, each sub-range read in parallel takes a permit of parallelismLock when one is free and no
+// other fetch is waiting for it, so parallel reads back off when other fetches are queued.
+ACTOR Future<Void> tryGetRangeParallel(PromiseStream<RangeResult> results,
+                                       Transaction* tr,
+                                       KeyRange keys,
+                                       FlowLock* parallelismLock,
+                                       FetchRangeStats* stats) {
+	state std::vector<KeyRange> ranges;
+	state std::deque<PromiseStream<RangeResult>> streams;
+	state std::deque<Future<Void>> fetches;
+	state std::deque<FlowLock::Releaser> permits;
+	state int current = 0;
+
+	try {
+		try {
+			Standalone<VectorRef<KeyRef>> splitPoints =
+			    wait(tr->getRangeSplitPoints(keys, SERVER_KNOBS->FETCH_KEYS_PARALLEL_RANGE_BYTES));
+			for (int i = 0; i + 1 < splitPoints.size(); ++i) {
+				ranges.push_back(KeyRangeRef(splitPoints[i], splitPoints[i + 1]));
+			}
+		} catch (Error& e) {
+			if (e.code() == error_code_actor_cancelled) {
+				throw;
+			}
+			// Without split points, read the whole range as one
+			ranges.clear();
+		}
+		if (ranges.empty()) {
+			ranges.push_back(keys);
+		}
+		stats->ranges = ranges.size();
+
+		loop {
+			// Start more sub-ranges, the first in the window on the permit the fetch already holds
+			while (current + (int)fetches.size() < (int)ranges.size() &&
+			       (fetches.empty() ||
+			        ((int)fetches.size() < SERVER_KNOBS->FETCH_KEYS_PARALLEL_RANGES &&
+			         parallelismLock->available() > 0 && parallelismLock->waiters() == 0))) {
+				if (!fetches.empty()) {
+					wait(parallelismLock->take(TaskPriority::FetchKeys));
+					permits.emplace_back(*parallelismLock);
+				}
+				streams.emplace_back();
+				fetches.push_back(tryGetRange(streams.back(), tr, ranges[current + fetches.size()]));
+				stats->maxConcurrent = std::max<int>(stats->maxConcurrent, fetches.size());
+			}
+
+			try {
+				RangeResult block = waitNext(streams.front().getFuture());
+				if (!block.more && current + 1 < (int)ranges.size()) {
+					// Continue into the next sub-range
+					block.more = true;
+					block.readThrough = KeyRef(block.arena(), ranges[current].end);
+				}
+				results.send(block);
+			} catch (Error& e) {
+				if (e.code() != error_code_end_of_stream) {
+					throw;
+				}
+				streams.pop_front();
+				fetches.pop_front();
+				if (!permits.empty()) {
+					permits.pop_front();
+				}
+				if (++current == (int)ranges.size()) {
+					results.sendError(end_of_stream());
+					return Void();
+				}
+			}
+		}
+	} catch (Error& e) {
+		if (e.code() == error_code_actor_cancelled) {
+			throw;
+		}
+		results.sendError(e);
+		throw;
+	}
+}
+
 // Read blob granules metadata. It keeps retrying until reaching maxRetryCount.
 // The key range should not cross tenant boundary.
 ACTOR Future<Standalone<VectorRef<BlobGranuleChunkRef>>> tryReadBlobGranuleChunks(Transaction* tr,
@@ -8412,6 +9538,7 @@ ACTOR Future<Void> fetchKeys(StorageServer* data, AddingShard* shard) {
 	state Version fetchVersion = invalidVersion;
 	state int64_t totalBytes = 0;
 	state int priority = dataMovementPriority(shard->reason);
+	state FetchRangeStats fetchRangeStats;
 
 	state PromiseStream<Key> destroyedFeeds;
 	state FetchKeysMetricReporter metricReporter(fetchKeysID,
@@ -8423,9 +9550,15 @@ ACTOR Future<Void> fetchKeys(StorageServer* data, AddingShard* shard) {
 	                                             data->counters.kvFetched);
 
 	// Set read options to use non-caching reads and set Fetch type unless low priority data fetching is disabled by
-	// a knob
-	state ReadOptions readOptions = ReadOptions(
-	    {}, SERVER_KNOBS->FETCH_KEYS_LOWER_PRIORITY ? ReadType::FETCH : ReadType::NORMAL, CacheResult::False);
+	// a knob. Reads of moves under the source servers' byte budget are Fetch reads as well, so the sources can tell them
+	// apart from client reads.
+	state bool budgetedFetch = SERVER_KNOBS->STORAGE_FETCH_SOURCE_BYTES_PER_SEC > 0 &&
+	                           priority < SERVER_KNOBS->DATA_MOVE_BUDGET_PRIORITY_THRESHOLD;
+	state ReadOptions readOptions = ReadOptions({},
+	                                            SERVER_KNOBS->FETCH_KEYS_LOWER_PRIORITY || budgetedFetch
+	                                                ? ReadType::FETCH
+	                                                : ReadType::NORMAL,
+	                                            CacheResult::False);
 
 	// need to set this at the very start of the fetch, to handle any private change feed destroy mutations we get
 	// for this key range, that apply to change feeds we don't know about yet because their metadata hasn't been
@@ -8598,11 +9731,16 @@ ACTOR Future<Void> fetchKeys(StorageServer* data, AddingShard* shard) {
 					hold = tryGetRangeFromBlob(results, &tr, data->cx, range, version, &data->tenantData);
 					rangeEnd = range.end;
 				} else {
-					hold = tryGetRange(results, &tr, keys);
+					hold = SERVER_KNOBS->FETCH_KEYS_PARALLEL_RANGES > 1
+					           ? tryGetRangeParallel(
+					                 results, &tr, keys, &data->fetchKeysParallelismLock, &fetchRangeStats)
+					           : tryGetRange(results, &tr, keys);
 					rangeEnd = keys.end;
 				}
 			} else {
-				hold = tryGetRange(results, &tr, keys);
+				hold = SERVER_KNOBS->FETCH_KEYS_PARALLEL_RANGES > 1
+				           ? tryGetRangeParallel(results, &tr, keys, &data->fetchKeysParallelismLock, &fetchRangeStats)
+				           : tryGetRange(results, &tr, keys);
 				rangeEnd = keys.end;
 			}
 
@@ -8660,17 +9798,19 @@ ACTOR Future<Void> fetchKeys(StorageServer* data, AddingShard* shard) {
 
 					// Write this_block to storage
 					state Standalone<VectorRef<KeyValueRef>> blockData(this_block, this_block.arena());
-					state Key blockEnd =
-					    this_block.size() > 0 && this_block.more ? keyAfter(this_block.back().key) : keys.end;
+					state Key blockEnd = keys.end;
+					if (this_block.more && this_block.readThrough.present()) {
+						// A parallel fetch ends each sub-range with a block, possibly empty, read through to its end
+						blockEnd = this_block.readThrough.get();
+					} else if (this_block.more && this_block.size() > 0) {
+						blockEnd = keyAfter(this_block.back().key);
+					}
 					state KeyRange blockRange(KeyRangeRef(blockBegin, blockEnd));
 					wait(data->storage.replaceRange(blockRange, blockData));
 
 					data->fetchKeysLimiter.addBytes(expectedBlockSize);
 
-					state KeyValueRef* kvItr = this_block.begin();
-					for (; kvItr != this_block.end(); ++kvItr) {
-						data->byteSampleApplySet(*kvItr, invalidVersion);
-					}
+					data->byteSampleApplyFetchedBlock(blockRange, this_block);
 					if (this_block.more) {
 						blockBegin = this_block.getReadThrough();
 					} else {
@@ -8766,10 +9906,15 @@ ACTOR Future<Void> fetchKeys(StorageServer* data, AddingShard* shard) {
 			data->storage.markRangeAsActive(keys);
 		}
 		const double duration = now() - startTime;
+		const double fetchDuration = now() - executeStart;
 		TraceEvent(SevInfo, "FetchKeysStats", data->thisServerID)
 		    .detail("TotalBytes", totalBytes)
 		    .detail("Duration", duration)
-		    .detail("Rate", static_cast<double>(totalBytes) / duration);
+		    .detail("Rate", static_cast<double>(totalBytes) / duration)
+		    .detail("FetchDuration", fetchDuration)
+		    .detail("FetchRate", fetchDuration > 0 ? static_cast<double>(totalBytes) / fetchDuration : 0.0)
+		    .detail("Ranges", fetchRangeStats.ranges)
+		    .detail("MaxConcurrentRanges", fetchRangeStats.maxConcurrent);
 
 		TraceEvent(SevDebug, "FKBeforeFinalCommit", data->thisServerID)
 		    .detail("FKID", interval.pairID)
@@ -10493,6 +11638,8 @@ void StorageServer::addMutation(Version version,
 	    .detail("ShardEnd", shard.end);
 
 	if (!fromFetch) {
+		hotKeys.addWrite(mutation.param1, mutation.expectedSize());
+
 		// have to do change feed before applyMutation because nonExpanded wasn't copied into the mutation log
 		// arena, and thus would go out of scope if it wasn't copied into the change feed arena
 
@@ -11041,8 +12188,7 @@ void StorageServer::insertTenant(TenantMapEntry const& tenant, Version version,
 	if (version >= tenantMap.getLatestVersion()) {
 		TenantSSInfo tenantSSInfo{ tenant.tenantLockState };
 		int64_t tenantId = TenantAPI::prefixToId(tenant.prefix);
-		tenantMap.createNewVersion(version);
-		tenantMap.insert(tenant.id, tenantSSInfo);
+		tenantMap.insert(tenant.id, tenant.tenantLockState, version);
 
 		if (persist) {
 			auto& mLV = addVersionToMutationLog(version);
@@ -11058,21 +12204,21 @@ void StorageServer::insertTenant(TenantMapEntry const& tenant, Version version,
 
 void StorageServer::clearTenants(StringRef startTenant, StringRef endTenant, Version version) {
 	if (version >= tenantMap.getLatestVersion()) {
-		tenantMap.createNewVersion(version);
-
-		auto view = tenantMap.at(version);
 		auto& mLV = addVersionToMutationLog(version);
-		std::set<int64_t> tenantsToClear;
+		std::vector<int64_t> tenantsToClear;
 		Optional<int64_t> startId = TenantIdCodec::lowerBound(startTenant);
 		Optional<int64_t> endId = TenantIdCodec::lowerBound(endTenant);
-		auto startItr = startId.present() ? view.lower_bound(startId.get()) : view.end();
-		auto endItr = endId.present() ? view.lower_bound(endId.get()) : view.end();
-		for (auto itr = startItr; itr != endItr; ++itr) {
-			auto mapKey = itr.key();
-			// Trigger any watches on the prefix associated with the tenant.
-			TraceEvent("EraseTenant", thisServerID).detail("TenantID", mapKey).detail("Version", version);
-			tenantWatches.sendError(mapKey, mapKey + 1, tenant_removed());
-			tenantsToClear.insert(mapKey);
+		if (startId.present()) {
+			tenantMap.forEachTenant(startId.get(),
+			                        endId.orDefault(std::numeric_limits<int64_t>::max()),
+			                        [&](int64_t tenantId, TenantAPI::TenantLockState) {
+				                        // Trigger any watches on the prefix associated with the tenant.
+				                        TraceEvent("EraseTenant", thisServerID)
+				                            .detail("TenantID", tenantId)
+				                            .detail("Version", version);
+				                        tenantWatches.sendError(tenantId, tenantId + 1, tenant_removed());
+				                        tenantsToClear.push_back(tenantId);
+			                        });
 		}
 		addMutationToMutationLog(mLV,
 		                         MutationRef(MutationRef::ClearRange,
@@ -11080,7 +12226,7 @@ void StorageServer::clearTenants(StringRef startTenant, StringRef endTenant, Ver
 		                                     endTenant.withPrefix(persistTenantMapKeys.begin)));
 
 		for (auto tenantId : tenantsToClear) {
-			tenantMap.erase(tenantId);
+			tenantMap.erase(tenantId, version);
 		}
 	}
 }
@@ -11098,6 +12244,7 @@ ACTOR Future<Void> update(StorageServer* data, bool* pReceivedUpdate) {
 	state double updateStart = g_network->timer();
 	state double decryptionTime = 0;
 	state double start;
+	state double phaseStart;
 	state bool enableClearRangeEagerReads =
 	    (data->storage.getKeyValueStoreType() == KeyValueStoreType::SSD_ROCKSDB_V1 ||
 	     data->storage.getKeyValueStoreType() == KeyValueStoreType::SSD_SHARDED_ROCKSDB)
@@ -11213,6 +12360,7 @@ ACTOR Future<Void> update(StorageServer* data, bool* pReceivedUpdate) {
 
 		// Collect eager read keys.
 		// If encrypted mutation is encountered, we collect cipher details and fetch cipher keys, then start over.
+		phaseStart = g_network->timer();
 		loop {
 			state uint64_t changeCounter = data->shardChangeCounter;
 			bool epochEnd = false;
@@ -11260,7 +12408,8 @@ ACTOR Future<Void> update(StorageServer* data, bool* pReceivedUpdate) {
 							decryptionTime += decryptionTimeV;
 						}
 					} else {
-						if (!msg.validateChecksum()) {
+						// Deserializing the mutation validated its checksum and marked it corrupted on a mismatch
+						if (msg.corrupted) {
 							TraceEvent(SevError, "ValidateChecksumError", data->thisServerID)
 							    .setMaxFieldLength(-1)
 							    .setMaxEventLength(-1)
@@ -11326,6 +12475,7 @@ ACTOR Future<Void> update(StorageServer* data, bool* pReceivedUpdate) {
 			}
 		}
 		data->eagerReadsLatencyHistogram->sampleSeconds(now() - start);
+		data->counters.updateEagerReadsMicros += (g_network->timer() - phaseStart) * 1e6;
 
 		if (now() - start > 0.1)
 			TraceEvent("SSSlowTakeLock2", data->thisServerID)
@@ -11369,11 +12519,19 @@ ACTOR Future<Void> update(StorageServer* data, bool* pReceivedUpdate) {
 		state SpanContext spanContext = SpanContext();
 		state double beforeTLogMsgsUpdates = now();
 		state std::set<Key> updatedChangeFeeds;
+		data->deferByteSampleUpdates = SERVER_KNOBS->BYTE_SAMPLE_BATCH_UPDATES;
+		phaseStart = g_network->timer();
 		for (; cloneCursor2->hasMessage(); cloneCursor2->nextMessage()) {
 			if (mutationBytes > SERVER_KNOBS->DESIRED_UPDATE_BYTES) {
 				mutationBytes = 0;
+				// Other actors may make versions durable while we wait, so nothing can stay deferred across it
+				data->deferByteSampleUpdates = false;
+				data->flushByteSampleUpdates();
+				data->counters.updateApplyMicros += (g_network->timer() - phaseStart) * 1e6;
 				// Instead of just yielding, leave time for the storage server to respond to reads
 				wait(delay(SERVER_KNOBS->UPDATE_DELAY));
+				data->deferByteSampleUpdates = SERVER_KNOBS->BYTE_SAMPLE_BATCH_UPDATES;
+				phaseStart = g_network->timer();
 			}
 
 			if (cloneCursor2->version().version > ver) {
@@ -11527,6 +12685,7 @@ ACTOR Future<Void> update(StorageServer* data, bool* pReceivedUpdate) {
 		}
 
 		data->tLogMsgsPTreeUpdatesLatencyHistogram->sampleSeconds(now() - beforeTLogMsgsUpdates);
+		data->counters.updateApplyMicros += (g_network->timer() - phaseStart) * 1e6;
 		if (data->currentChangeFeeds.size()) {
 			data->changeFeedVersions.emplace_back(
 			    std::vector<Key>(data->currentChangeFeeds.begin(), data->currentChangeFeeds.end()), ver);
@@ -11549,6 +12708,7 @@ ACTOR Future<Void> update(StorageServer* data, bool* pReceivedUpdate) {
 			ver = updater.currentVersion;
 		}
 
+		phaseStart = g_network->timer();
 		if (ver != invalidVersion && ver > data->version.get()) {
 			// TODO(alexmiller): Update to version tracking.
 			// DEBUG_KEY_RANGE("SSUpdate", ver, KeyRangeRef());
@@ -11575,6 +12735,10 @@ ACTOR Future<Void> update(StorageServer* data, bool* pReceivedUpdate) {
 
 			data->prevVersion = data->version.get();
 			data->version.set(ver); // Triggers replies to waiting gets for new version(s)
+			// The deferred byte sample updates only have to be in the mutation log before desiredOldestVersion lets
+			// updateStorage make these versions durable
+			data->deferByteSampleUpdates = false;
+			data->flushByteSampleUpdates();
 
 			for (auto& it : updatedChangeFeeds) {
 				auto feed = data->uidChangeFeed.find(it);
@@ -11619,6 +12783,9 @@ ACTOR Future<Void> update(StorageServer* data, bool* pReceivedUpdate) {
 			}
 			data->desiredOldestVersion.set(proposedOldestVersion);
 		}
+		data->deferByteSampleUpdates = false;
+		data->flushByteSampleUpdates();
+		data->counters.updateNewVersionMicros += (g_network->timer() - phaseStart) * 1e6;
 
 		validate(data);
 
@@ -11660,6 +12827,199 @@ ACTOR Future<Void> update(StorageServer* data, bool* pReceivedUpdate) {
 	}
 }
 
+// Serves prebuilt peek replies in place of a tlog, one reply per getMore(), so that update() can be driven without a
+// log system
+class SyntheticPeekCursor final : public ILogSystem::IPeekCursor, public ReferenceCounted<SyntheticPeekCursor> {
+public:
+	SyntheticPeekCursor(std::vector<TLogPeekReply> replies, Tag tag, Version begin)
+	  : replies(std::move(replies)), tag(tag), knownVersion(begin),
+	    current(makeReference<ILogSystem::ServerPeekCursor>(TLogPeekReply(),
+	                                                        LogMessageVersion(begin),
+	                                                        LogMessageVersion(begin),
+	                                                        TagsAndMessage(),
+	                                                        false,
+	                                                        0,
+	                                                        tag)) {}
+
+	Future<Void> getMore(TaskPriority taskID) override {
+		if (next == replies.size()) {
+			return Never();
+		}
+		TLogPeekReply const& reply = replies[next++];
+		current = makeReference<ILogSystem::ServerPeekCursor>(reply,
+		                                                      LogMessageVersion(reply.begin.get()),
+		                                                      LogMessageVersion(reply.end),
+		                                                      TagsAndMessage(),
+		                                                      true,
+		                                                      0,
+		                                                      tag);
+		knownVersion = reply.end - 1;
+		return Void();
+	}
+
+	Reference<IPeekCursor> cloneNoMore() override { return current->cloneNoMore(); }
+	void setProtocolVersion(ProtocolVersion version) override { current->setProtocolVersion(version); }
+	bool hasMessage() const override { return current->hasMessage(); }
+	VectorRef<Tag> getTags() const override { return current->getTags(); }
+	Arena& arena() override { return current->arena(); }
+	ArenaReader* reader() override { return current->reader(); }
+	StringRef getMessage() override { return current->getMessage(); }
+	StringRef getMessageWithTags() override { return current->getMessageWithTags(); }
+	void nextMessage() override { current->nextMessage(); }
+	void advanceTo(LogMessageVersion n) override { current->advanceTo(n); }
+	Future<Void> onFailed() const override { return Never(); }
+	bool isActive() const override { return true; }
+	bool isExhausted() const override { return current->isExhausted(); }
+	const LogMessageVersion& version() const override { return current->version(); }
+	Version popped() const override { return 0; }
+	Version getMaxKnownVersion() const override { return knownVersion; }
+	Version getMinKnownCommittedVersion() const override { return knownVersion; }
+	Optional<UID> getPrimaryPeekLocation() const override { return Optional<UID>(); }
+	Optional<UID> getCurrentPeekLocation() const override { return Optional<UID>(); }
+	void addref() override { ReferenceCounted<SyntheticPeekCursor>::addref(); }
+	void delref() override { ReferenceCounted<SyntheticPeekCursor>::delref(); }
+
+private:
+	std::vector<TLogPeekReply> replies;
+	size_t next = 0;
+	Tag tag;
+	Version knownVersion;
+	Reference<ILogSystem::ServerPeekCursor> current;
+};
+
+// Feeds a synthetic tlog stream of sets, atomic ops and clears, some of them into change feeds, through update() of a
+// storage server with a memory engine, and reports the rate mutations are applied at and the time spent in each part
+// of the update loop. Nothing is made durable, so the stream has to fit in memory and in STORAGE_HARD_LIMIT_BYTES.
+TEST_CASE(":/fdbserver/storageserver/performance/update") {
+	state int versions = params.getInt("versions").orDefault(10000);
+	state int mutationsPerVersion = params.getInt("mutationsPerVersion").orDefault(100);
+	state int keyCount = params.getInt("keyCount").orDefault(1000000);
+	state int valueBytes = params.getInt("valueBytes").orDefault(100);
+	state int atomicPercent = params.getInt("atomicPercent").orDefault(10);
+	state int clearPercent = params.getInt("clearPercent").orDefault(1);
+	state int changeFeeds = params.getInt("changeFeeds").orDefault(1);
+	state int replyBytes = params.getInt("replyBytes").orDefault(SERVER_KNOBS->DESIRED_TOTAL_BYTES);
+	state std::string folder = params.get("folder").orDefault(".");
+
+	printf("versions: %d\n", versions);
+	printf("mutationsPerVersion: %d\n", mutationsPerVersion);
+	printf("keyCount: %d\n", keyCount);
+	printf("valueBytes: %d\n", valueBytes);
+	printf("atomicPercent: %d\n", atomicPercent);
+	printf("clearPercent: %d\n", clearPercent);
+	printf("changeFeeds: %d\n", changeFeeds);
+	printf("replyBytes: %d\n", replyBytes);
+
+	// The stream, as replies of whole versions in the format the tlog sends them
+	state Tag tag(tagLocalityPrimary, 0);
+	state Version beginVersion = 1000;
+	state std::vector<TLogPeekReply> replies;
+	state int64_t mutationCount = 0;
+	state int64_t mutationBytes = 0;
+	{
+		std::string value(valueBytes, 'v');
+		uint64_t one = 1;
+		StringRef atomicOperand((const uint8_t*)&one, sizeof(one));
+		for (int v = 0; v < versions;) {
+			BinaryWriter wr(AssumeVersion(g_network->protocolVersion()));
+			TLogPeekReply reply;
+			reply.begin = beginVersion + 1 + v;
+			for (; v < versions && wr.getLength() < replyBytes; v++) {
+				wr << VERSION_HEADER << Version(beginVersion + 1 + v);
+				for (int i = 0; i < mutationsPerVersion; i++) {
+					int k = deterministicRandom()->randomInt(0, keyCount);
+					std::string begin = format("%016d", k);
+					std::string end = format("%016d", k + 10);
+					int type = deterministicRandom()->randomInt(0, 100);
+					MutationRef m(MutationRef::SetValue, StringRef(begin), StringRef(value));
+					if (type < clearPercent) {
+						m = MutationRef(MutationRef::ClearRange, StringRef(begin), StringRef(end));
+					} else if (type < clearPercent + atomicPercent) {
+						m = MutationRef(MutationRef::AddValue, StringRef(begin), atomicOperand);
+					}
+					// As LogPushData writes messages: length, subsequence, tags, then the mutation
+					int start = wr.getLength();
+					wr << uint32_t(0) << uint32_t(i + 1) << uint16_t(1) << tag << m;
+					*(uint32_t*)((uint8_t*)wr.getData() + start) = wr.getLength() - start - sizeof(uint32_t);
+					++mutationCount;
+					mutationBytes += m.totalSize();
+				}
+			}
+			reply.end = beginVersion + 1 + v;
+			Standalone<StringRef> messages = wr.toValue();
+			reply.arena = messages.arena();
+			reply.messages = messages;
+			replies.push_back(reply);
+		}
+	}
+	state int replyCount = replies.size();
+
+	state UID id = deterministicRandom()->randomUniqueID();
+	state IKeyValueStore* kvStore =
+	    keyValueStoreMemory(joinPath(folder, "storageserver-update-perf-" + id.toString() + "-"), id, 2e9);
+	state StorageServerInterface ssi;
+	ssi.uniqueID = id;
+	state std::unique_ptr<StorageServer> data = std::make_unique<StorageServer>(
+	    kvStore, makeReference<AsyncVar<ServerDBInfo>>(), ssi, makeReference<GetEncryptCipherKeysMonitor>());
+	wait(data->storage.init());
+	EncryptionAtRestMode encryptionMode = wait(data->storage.encryptionMode());
+	data->encryptionMode = encryptionMode;
+	data->logProtocol = g_network->protocolVersion();
+	data->tag = tag;
+	data->setInitialVersion(beginVersion);
+	data->addShard(ShardInfo::newReadWrite(normalKeys, data.get()));
+	// There is no cluster to register the interface with once update() has caught up
+	data->registerInterfaceAcceptingRequests.send(Void());
+	data->logCursor = makeReference<SyntheticPeekCursor>(std::move(replies), tag, beginVersion + 1);
+	for (int i = 0; i < changeFeeds; i++) {
+		auto feed = makeReference<ChangeFeedInfo>();
+		feed->id = StringRef(format("feed%d", i));
+		feed->range = KeyRangeRef(StringRef(format("%016d", keyCount * i / changeFeeds / 2)),
+		                          StringRef(format("%016d", keyCount * (i + 1) / changeFeeds / 2)));
+		data->uidChangeFeed[feed->id] = feed;
+		auto rs = data->keyChangeFeed.modify(feed->range);
+		for (auto r = rs.begin(); r != rs.end(); ++r) {
+			r->value().push_back(feed);
+		}
+		data->keyChangeFeed.coalesce(feed->range);
+	}
+
+	state double start = g_network->timer();
+	state int batch = 0;
+	for (; batch < replyCount; batch++) {
+		state bool receivedUpdate = false;
+		wait(update(data.get(), &receivedUpdate));
+	}
+	state double elapsed = g_network->timer() - start;
+	ASSERT_EQ(data->version.get(), beginVersion + versions);
+
+	printf("\nApplied %" PRId64 " mutations (%.1f MB) in %d batches in %.3f s: %.0f mutations/sec, %.1f MB/sec\n",
+	       mutationCount,
+	       mutationBytes / 1e6,
+	       replyCount,
+	       elapsed,
+	       mutationCount / elapsed,
+	       mutationBytes / 1e6 / elapsed);
+	printf("Eager reads: %.3f s (%" PRId64 " keys)\n",
+	       data->counters.updateEagerReadsMicros.getValue() / 1e6,
+	       data->counters.eagerReadsKeys.getValue());
+	printf("Apply mutations: %.3f s (%" PRId64 " sets, %" PRId64 " clears, %" PRId64 " clear splits, %" PRId64
+	       " change feed mutations)\n",
+	       data->counters.updateApplyMicros.getValue() / 1e6,
+	       data->counters.pTreeSets.getValue(),
+	       data->counters.pTreeClears.getValue(),
+	       data->counters.pTreeClearSplits.getValue(),
+	       data->counters.changeFeedMutations.getValue());
+	printf("New version: %.3f s\n", data->counters.updateNewVersionMicros.getValue() / 1e6);
+
+	data->shuttingDown = true;
+	data->addShard(ShardInfo::newNotAssigned(allKeys));
+	data.reset();
+	kvStore->dispose();
+	wait(kvStore->onClosed());
+	return Void();
+}
+
 ACTOR Future<bool> createSstFileForCheckpointShardBytesSample(StorageServer* data,
                                                               CheckpointMetaData metaData,
                                                               std::string bytesSampleFile) {
@@ -12000,15 +13360,12 @@ ACTOR Future<Void> updateStorage(StorageServer* data) {
 		loop {
 			state bool done = data->storage.makeVersionMutationsDurable(
 			    newOldestVersion, desiredVersion, bytesLeft, unlimitedCommitBytes);
-			if (data->tenantMap.getLatestVersion() < newOldestVersion) {
-				data->tenantMap.createNewVersion(newOldestVersion);
-			}
 			// We want to forget things from these data structures atomically with changing oldestVersion (and
 			// "before", since oldestVersion.set() may trigger waiting actors) forgetVersionsBeforeAsync visibly
 			// forgets immediately (without waiting) but asynchronously frees memory.
 			Future<Void> finishedForgetting =
-			    data->mutableData().forgetVersionsBeforeAsync(newOldestVersion, TaskPriority::UpdateStorage) &&
-			    data->tenantMap.forgetVersionsBeforeAsync(newOldestVersion, TaskPriority::UpdateStorage);
+			    data->mutableData().forgetVersionsBeforeAsync(newOldestVersion, TaskPriority::UpdateStorage);
+			data->tenantMap.forgetVersionsBefore(newOldestVersion);
 			data->oldestVersion.set(newOldestVersion);
 			wait(finishedForgetting);
 			wait(yield(TaskPriority::UpdateStorage));
@@ -12384,6 +13741,7 @@ ACTOR Future<Void> updateStorage(StorageServer* data) {
 #endif
 
 void StorageServerDisk::makeNewStorageServerDurable(const bool shardAware) {
+	readCache.clear();
 	if (shardAware) {
 		storage->set(persistShardAwareFormat);
 	} else {
@@ -12403,11 +13761,11 @@ void StorageServerDisk::makeNewStorageServerDurable(const bool shardAware) {
 		storage->set(KeyValueRef(persistShardAvailableKeys.begin.toString(), "0"_sr));
 	}
 
-	auto view = data->tenantMap.atLatest();
-	for (auto itr = view.begin(); itr != view.end(); ++itr) {
-		auto val = ObjectWriter::toValue(*itr, IncludeVersion());
-		storage->set(KeyValueRef(TenantAPI::idToPrefix(itr.key()).withPrefix(persistTenantMapKeys.begin), val));
-	}
+	data->tenantMap.forEachTenant(
+	    0, std::numeric_limits<int64_t>::max(), [&](int64_t tenantId, TenantAPI::TenantLockState lockState) {
+		    auto val = ObjectWriter::toValue(TenantSSInfo{ lockState }, IncludeVersion());
+		    storage->set(KeyValueRef(TenantAPI::idToPrefix(tenantId).withPrefix(persistTenantMapKeys.begin), val));
+	    });
 }
 
 void setAvailableStatus(StorageServer* self, KeyRangeRef keys, bool available) {
@@ -12487,6 +13845,7 @@ void setAssignedStatus(StorageServer* self, KeyRangeRef keys, bool nowAssigned)
 }
 
 void StorageServerDisk::clearRange(KeyRangeRef keys) {
+	readCache.invalidate(keys);
 	storage->clear(keys);
 	++(*kvClearRanges);
 	if (keys.singleKeyRange()) {
@@ -12495,15 +13854,18 @@ void StorageServerDisk::clearRange(KeyRangeRef keys) {
 }
 
 void StorageServerDisk::writeKeyValue(KeyValueRef kv) {
+	readCache.invalidate(kv.key);
 	storage->set(kv);
 	*kvCommitLogicalBytes += kv.expectedSize();
 }
 
 void StorageServerDisk::writeMutation(MutationRef mutation) {
 	if (mutation.type == MutationRef::SetValue) {
+		readCache.invalidate(mutation.param1);
 		storage->set(KeyValueRef(mutation.param1, mutation.param2));
 		*kvCommitLogicalBytes += mutation.expectedSize();
 	} else if (mutation.type == MutationRef::ClearRange) {
+		readCache.invalidate(KeyRangeRef(mutation.param1, mutation.param2));
 		storage->clear(KeyRangeRef(mutation.param1, mutation.param2));
 		++(*kvClearRanges);
 		if (KeyRangeRef(mutation.param1, mutation.param2).singleKeyRange()) {
@@ -12543,9 +13905,11 @@ void StorageServerDisk::writeMutations(const VectorRef<MutationRef>& mutations,
 		DEBUG_MUTATION(debugContext, debugVersion, m, data->thisServerID);
 		ASSERT(m.validateChecksum());
 		if (m.type == MutationRef::SetValue) {
+			readCache.invalidate(m.param1);
 			storage->set(KeyValueRef(m.param1, m.param2));
 			*kvCommitLogicalBytes += m.expectedSize();
 		} else if (m.type == MutationRef::ClearRange) {
+			readCache.invalidate(KeyRangeRef(m.param1, m.param2));
 			storage->clear(KeyRangeRef(m.param1, m.param2));
 			++(*kvClearRanges);
 			if (KeyRangeRef(m.param1, m.param2).singleKeyRange()) {
@@ -12586,6 +13950,7 @@ bool StorageServerDisk::makeVersionMutationsDurable(Version& prevStorageVersion,
 
 // Update data->storage to persist the changes from (data->storageVersion(),version]
 void StorageServerDisk::makeVersionDurable(Version version) {
+	readCache.invalidate(persistVersion);
 	storage->set(KeyValueRef(persistVersion, BinaryWriter::toValue(version, Unversioned())));
 	*kvCommitLogicalBytes += persistVersion.expectedSize() + sizeof(Version);
 
@@ -12596,6 +13961,7 @@ void StorageServerDisk::makeVersionDurable(Version version) {
 
 // Update data->storage to persist tss quarantine state
 void StorageServerDisk::makeTssQuarantineDurable() {
+	readCache.invalidate(persistTssQuarantine);
 	storage->set(KeyValueRef(persistTssQuarantine, "1"_sr));
 }
 
@@ -12680,6 +14046,7 @@ ACTOR Future<Void> restoreByteSample(StorageServer* data,
 	byteSampleSampleRecovered.send(Void());
 	wait(startRestore);
 	wait(delay(SERVER_KNOBS->BYTE_SAMPLE_START_DELAY));
+	state double start = now();
 
 	size_t bytes_per_fetch = 0;
 	// Since the expected size also includes (as of now) the space overhead of the container, we calculate our own
@@ -12710,7 +14077,9 @@ ACTOR Future<Void> restoreByteSample(StorageServer* data,
 	sampleRanges.push_back(applyByteSampleResult(data, storage, lastStart, persistByteSampleKeys.end));
 
 	wait(waitForAll(sampleRanges));
-	TraceEvent("RecoveredByteSampleChunkedRead", data->thisServerID).detail("Ranges", sampleRanges.size());
+	TraceEvent("RecoveredByteSampleChunkedRead", data->thisServerID)
+	    .detail("Ranges", sampleRanges.size())
+	    .detail("Duration", now() - start);
 
 	if (BUGGIFY)
 		wait(delay(deterministicRandom()->random01() * 10.0));
@@ -12718,7 +14087,20 @@ ACTOR Future<Void> restoreByteSample(StorageServer* data,
 	return Void();
 }
 
+// Records the time since stepStart as the time taken by step, and starts the next step
+static void endRestoreStep(std::vector<std::pair<const char*, double>>& stepTimes,
+                           double& stepStart,
+                           const char* step) {
+	stepTimes.emplace_back(step, now() - stepStart);
+	stepStart = now();
+}
+
 ACTOR Future<bool> restoreDurableState(StorageServer* data, IKeyValueStore* storage) {
+	// The time spent in each step of the restore, reported when it is done
+	state double restoreStart = now();
+	state double stepStart = restoreStart;
+	state std::vector<std::pair<const char*, double>> stepTimes;
+
 	state Future<Optional<Value>> fFormat = storage->readValue(persistFormat.key);
 	state Future<Optional<Value>> fID = storage->readValue(persistID);
 	state Future<Optional<Value>> ftssPairID = storage->readValue(persistTssPairID);
@@ -12754,7 +14136,9 @@ ACTOR Future<bool> restoreDurableState(StorageServer* data, IKeyValueStore* stor
 	                             fTenantMap,
 	                             fStorageShards,
 	                             fAccumulativeChecksum }));
+	endRestoreStep(stepTimes, stepStart, "ReadMetadata");
 	wait(byteSampleSampleRecovered.getFuture());
+	endRestoreStep(stepTimes, stepStart, "ReadByteSampleSample");
 	TraceEvent("RestoringDurableState", data->thisServerID).log();
 
 	if (!fFormat.get().present()) {
@@ -12833,6 +14217,7 @@ ACTOR Future<bool> restoreDurableState(StorageServer* data, IKeyValueStore* stor
 		}
 		wait(yield());
 	}
+	endRestoreStep(stepTimes, stepStart, "Checkpoints");
 
 	state RangeResult available = fShardAvailable.get();
 	data->bytesRestored += available.logicalSize();
@@ -12850,6 +14235,7 @@ ACTOR Future<bool> restoreDurableState(StorageServer* data, IKeyValueStore* stor
 		data->newestAvailableVersion.insert(keys, nowAvailable ? latestVersion : invalidVersion);
 		wait(yield());
 	}
+	endRestoreStep(stepTimes, stepStart, "AvailableShards");
 
 	// Restore acs validator from persisted disk
 	if (data->acsValidator != nullptr) {
@@ -12888,6 +14274,7 @@ ACTOR Future<bool> restoreDurableState(StorageServer* data, IKeyValueStore* stor
 			wait(yield());
 		}
 	}
+	endRestoreStep(stepTimes, stepStart, "AssignedShards");
 
 	state RangeResult changeFeeds = fChangeFeeds.get();
 	data->bytesRestored += changeFeeds.logicalSize();
@@ -12920,21 +14307,26 @@ ACTOR Future<bool> restoreDurableState(StorageServer* data, IKeyValueStore* stor
 		wait(yield());
 	}
 	data->keyChangeFeed.coalesce(allKeys);
+	endRestoreStep(stepTimes, stepStart, "ChangeFeeds");
 
+	// The tenants are persisted in order of id, so they are loaded straight into the index's arrays rather than
+	// inserted one at a time
 	state RangeResult tenantMap = fTenantMap.get();
+	state std::vector<int64_t> tenantIds;
+	state std::vector<TenantAPI::TenantLockState> tenantLockStates;
 	state int tenantMapLoc;
+	tenantIds.reserve(tenantMap.size());
+	tenantLockStates.reserve(tenantMap.size());
 	for (tenantMapLoc = 0; tenantMapLoc < tenantMap.size(); tenantMapLoc++) {
 		auto const& result = tenantMap[tenantMapLoc];
-		int64_t tenantId = TenantAPI::prefixToId(result.key.substr(persistTenantMapKeys.begin.size()));
-
-		data->tenantMap.insert(tenantId, ObjectReader::fromStringRef<TenantSSInfo>(result.value, IncludeVersion()));
-
-		TraceEvent("RestoringTenant", data->thisServerID)
-		    .detail("Key", tenantMap[tenantMapLoc].key)
-		    .detail("Tenant", tenantId);
-
+		tenantIds.push_back(TenantAPI::prefixToId(result.key.substr(persistTenantMapKeys.begin.size())));
+		tenantLockStates.push_back(ObjectReader::fromStringRef<TenantSSInfo>(result.value, IncludeVersion()).lockState);
 		wait(yield());
 	}
+	data->tenantMap.restore(std::move(tenantIds), std::move(tenantLockStates));
+	data->bytesRestored += tenantMap.logicalSize();
+	TraceEvent("RestoredTenants", data->thisServerID).detail("Tenants", data->tenantMap.size());
+	endRestoreStep(stepTimes, stepStart, "Tenants");
 
 	// TODO: why is this seemingly random delay here?
 	wait(delay(0.0001));
@@ -12958,6 +14350,13 @@ ACTOR Future<bool> restoreDurableState(StorageServer* data, IKeyValueStore* stor
 
 	validate(data, true);
 	startByteSampleRestore.send(Void());
+	endRestoreStep(stepTimes, stepStart, "ClearUnavailable");
+
+	TraceEvent restoreTimes("StorageServerRestoreDurableStateTimes", data->thisServerID);
+	for (auto const& [step, seconds] : stepTimes) {
+		restoreTimes.detail(step, seconds);
+	}
+	restoreTimes.detail("Total", now() - restoreStart);
 
 	return true;
 }
@@ -13036,6 +14435,9 @@ void StorageServer::addMutationToMutationLogOrStorage(Version ver, MutationRef m
 
 void StorageServer::byteSampleApplySet(KeyValueRef kv, Version ver) {
 	// Update byteSample in memory and (eventually) on disk and notify waiting metrics
+	if (!pendingByteSampleUpdates.empty()) {
+		flushByteSampleUpdates();
+	}
 
 	ByteSampleInfo sampleInfo = isKeyValueInSample(kv);
 	auto& byteSample = metrics.byteSample.sample;
@@ -13078,6 +14480,9 @@ void StorageServer::byteSampleApplySet(KeyValueRef kv, Version ver) {
 
 void StorageServer::byteSampleApplyClear(KeyRangeRef range, Version ver) {
 	// Update byteSample in memory and (eventually) on disk via the mutationLog and notify waiting metrics
+	if (!pendingByteSampleUpdates.empty()) {
+		flushByteSampleUpdates();
+	}
 
 	auto& byteSample = metrics.byteSample.sample;
 	bool any = false;
@@ -13119,6 +14524,77 @@ void StorageServer::byteSampleApplyClear(KeyRangeRef range, Version ver) {
 	}
 }
 
+void StorageServer::byteSampleApplyFetchedBlock(KeyRangeRef range, VectorRef<KeyValueRef> block) {
+	auto& byteSample = metrics.byteSample.sample;
+	if (!pendingByteSampleUpdates.empty()) {
+		flushByteSampleUpdates();
+	}
+	if (!SERVER_KNOBS->BYTE_SAMPLE_BATCH_UPDATES || !byteSampleRecovery.isReady() ||
+	    byteSample.sumRange(range.begin, range.end) > 0) {
+		for (auto const& kv : block) {
+			byteSampleApplySet(kv, invalidVersion);
+		}
+		return;
+	}
+
+	// Nothing in range is sampled, so only the sampled keys of the block have to be written. The block is sorted, so
+	// they are inserted in one pass and the notifications are summed per waitMetricsMap range.
+	std::vector<std::pair<Key, int64_t>> sampled;
+	for (auto const& kv : block) {
+		ByteSampleInfo sampleInfo = isKeyValueInSample(kv);
+		if (sampleInfo.inSample) {
+			sampled.emplace_back(kv.key, sampleInfo.sampledSize);
+			addMutationToMutationLogOrStorage(invalidVersion,
+			                                  MutationRef(MutationRef::SetValue,
+			                                              kv.key.withPrefix(persistByteSampleKeys.begin),
+			                                              BinaryWriter::toValue(sampleInfo.sampledSize, Unversioned())));
+		}
+	}
+	byteSample.insert(sampled);
+
+	for (int i = 0; i < sampled.size() && sampled[i].first < allKeys.end;) {
+		auto shard = metrics.waitMetricsMap.rangeContaining(sampled[i].first);
+		int64_t delta = 0;
+		for (; i < sampled.size() && sampled[i].first < shard.end(); ++i) {
+			delta += sampled[i].second;
+		}
+		metrics.notifyBytes(shard, delta);
+	}
+}
+
+void StorageServer::flushByteSampleUpdates() {
+	if (pendingByteSampleUpdates.empty()) {
+		return;
+	}
+	std::vector<std::pair<MutationRef, Version>> pending;
+	std::swap(pending, pendingByteSampleUpdates);
+	bool defer = deferByteSampleUpdates;
+	deferByteSampleUpdates = false;
+
+	// A set is superseded by a later set of the same key in the same version, as long as there is no clear in between
+	std::vector<bool> superseded(pending.size());
+	std::unordered_set<StringRef> laterSets;
+	for (int i = pending.size() - 1; i >= 0; --i) {
+		if (i + 1 < pending.size() && pending[i + 1].second != pending[i].second) {
+			laterSets.clear();
+		}
+		if (pending[i].first.type == MutationRef::SetValue) {
+			superseded[i] = !laterSets.insert(pending[i].first.param1).second;
+		} else {
+			laterSets.clear();
+		}
+	}
+
+	for (int i = 0; i < pending.size(); ++i) {
+		if (superseded[i]) {
+			++counters.byteSampleUpdatesCoalesced;
+		} else {
+			byteSampleApplyMutation(pending[i].first, pending[i].second);
+		}
+	}
+	deferByteSampleUpdates = defer;
+}
+
 ACTOR Future<Void> waitMetrics(StorageServerMetrics* self, WaitMetricsRequest req, Future<Void> timeout) {
 	state PromiseStream<StorageMetrics> change;
 	state StorageMetrics metrics = self->getMetrics(req.keys);
@@ -13262,6 +14738,73 @@ Future<Void> StorageServer::waitMetricsTenantAware(const WaitMetricsRequest& req
 	return waitMetricsTenantAware_internal(this, req);
 }
 
+// The sizes the storage engine estimates it holds between boundaries, or an empty vector if it cannot estimate them
+ACTOR Future<std::vector<int64_t>> getEngineRangeSizes(StorageServer* self, Standalone<VectorRef<KeyRef>> boundaries) {
+	try {
+		std::vector<int64_t> sizes = wait(self->storage.getApproximateRangeSizes(boundaries));
+		if (sizes.size() + 1 == boundaries.size() && std::accumulate(sizes.begin(), sizes.end(), int64_t(0)) > 0) {
+			return sizes;
+		}
+	} catch (Error& e) {
+		if (e.code() == error_code_actor_cancelled) {
+			throw;
+		}
+		TraceEvent(SevWarn, "StorageEngineRangeSizesError", self->thisServerID).suppressFor(60.0).error(e);
+	}
+	return std::vector<int64_t>();
+}
+
+ACTOR Future<Void> splitMetricsByEngineSizes(StorageServer* self, SplitMetricsRequest req) {
+	state Standalone<VectorRef<KeyRef>> boundaries =
+	    self->metrics.getByteSampleBoundaries(req.keys, SERVER_KNOBS->SPLIT_BY_ENGINE_SIZES_MAX_KEYS);
+	std::vector<int64_t> sizes = wait(getEngineRangeSizes(self, boundaries));
+	if (!self->isReadable(req.keys)) {
+		self->sendErrorWithPenalty(req.reply, wrong_shard_server(), self->getPenalty());
+	} else if (!sizes.empty()) {
+		CODE_PROBE(true, "Shard split by the sizes the storage engine estimates");
+		self->metrics.splitMetrics(req, self->metrics.weighByEngineSizes(boundaries, sizes));
+	} else {
+		self->metrics.splitMetrics(req);
+	}
+	return Void();
+}
+
+ACTOR Future<Void> getSplitPointsByEngineSizes(StorageServer* self, SplitRangeRequest req) {
+	state KeyRangeRef range =
+	    req.tenantInfo.prefix.present() ? req.keys.withPrefix(req.tenantInfo.prefix.get(), req.arena) : req.keys;
+	state Standalone<VectorRef<KeyRef>> boundaries =
+	    self->metrics.getByteSampleBoundaries(range, SERVER_KNOBS->SPLIT_BY_ENGINE_SIZES_MAX_KEYS);
+	std::vector<int64_t> sizes = wait(getEngineRangeSizes(self, boundaries));
+	if (!sizes.empty()) {
+		CODE_PROBE(true, "Range split points chosen by the sizes the storage engine estimates");
+		self->metrics.getSplitPoints(req, req.tenantInfo.prefix, self->metrics.weighByEngineSizes(boundaries, sizes));
+	} else {
+		self->metrics.getSplitPoints(req, req.tenantInfo.prefix);
+	}
+	return Void();
+}
+
+void StorageServer::getSplitMetrics(const SplitMetricsRequest& req) {
+	if (SERVER_KNOBS->SPLIT_BY_ENGINE_SIZES) {
+		addActor(splitMetricsByEngineSizes(this, req));
+	} else {
+		metrics.splitMetrics(req);
+	}
+}
+
+void StorageServer::getSplitPoints(SplitRangeRequest const& req) {
+	try {
+		checkTenantEntry(version.get(), req.tenantInfo, true);
+		if (SERVER_KNOBS->SPLIT_BY_ENGINE_SIZES) {
+			addActor(getSplitPointsByEngineSizes(this, req));
+		} else {
+			metrics.getSplitPoints(req, req.tenantInfo.prefix);
+		}
+	} catch (Error& e) {
+		req.reply.sendError(e);
+	}
+}
+
 ACTOR Future<Void> metricsCore(StorageServer* self, StorageServerInterface ssi) {
 
 	wait(self->byteSampleRecovery);
@@ -13291,6 +14834,11 @@ ACTOR Future<Void> metricsCore(StorageServer* self, StorageServerInterface ssi)
 		    type = (int)ReadType::HIGH;
 		    te.detail("ReadHighActive", self->ssLock->getRunnersCount(rpr[type]));
 		    te.detail("ReadHighWaiting", self->ssLock->getWaitersCount(rpr[type]));
+		    if (!self->readLanes.empty()) {
+			    auto [laneActive, laneWaiting] = self->getMaxReadLaneUsage();
+			    te.detail("ReadLaneMaxActive", laneActive);
+			    te.detail("ReadLaneMaxWaiting", laneWaiting);
+		    }
 		    StorageBytes sb = self->storage.getStorageBytes();
 		    te.detail("KvstoreBytesUsed", sb.used);
 		    te.detail("KvstoreBytesFree", sb.free);
@@ -13356,6 +14904,44 @@ ACTOR Future<Void> checkBehind(StorageServer* self) {
 	}
 }
 
+// Applies changes to the read priority weights and the read queue time limit, which can be changed at runtime through
+// the configuration database
+ACTOR Future<Void> updateFetchSourceBudget(StorageServer* self) {
+	state int64_t lastBytesPerSec = self->fetchSourceBudget.getBytesPerSec();
+	loop {
+		wait(delay(SERVER_KNOBS->STORAGE_FETCH_SOURCE_ADJUST_INTERVAL));
+		int64_t bytesPerSec = self->fetchSourceBudget.adjust();
+		if (bytesPerSec != lastBytesPerSec) {
+			TraceEvent(SevDebug, "FetchSourceBudgetChanged", self->thisServerID)
+			    .detail("From", lastBytesPerSec)
+			    .detail("To", bytesPerSec);
+			lastBytesPerSec = bytesPerSec;
+		}
+	}
+}
+
+ACTOR Future<Void> updateReadLockConfig(StorageServer* self) {
+	state std::string weights = SERVER_KNOBS->STORAGESERVER_READ_PRIORITIES;
+	loop {
+		wait(delay(SERVER_KNOBS->STORAGE_LOGGING_DELAY));
+		self->ssLock->setMaxQueueTime(SERVER_KNOBS->STORAGE_SERVER_READ_MAX_QUEUE_TIME);
+		if (SERVER_KNOBS->STORAGESERVER_READ_PRIORITIES == weights) {
+			continue;
+		}
+		weights = SERVER_KNOBS->STORAGESERVER_READ_PRIORITIES;
+		std::vector<int> weightsByPriority = parseStringToVector<int>(weights, ',');
+		if (weightsByPriority.size() != self->ssLock->maxPriority() + 1 ||
+		    std::any_of(weightsByPriority.begin(), weightsByPriority.end(), [](int w) { return w <= 0; })) {
+			TraceEvent(SevWarnAlways, "StorageServerReadPrioritiesInvalid", self->thisServerID)
+			    .detail("Weights", weights)
+			    .detail("Priorities", self->ssLock->maxPriority() + 1);
+			continue;
+		}
+		self->ssLock->setWeights(weightsByPriority);
+		TraceEvent("StorageServerReadPrioritiesChanged", self->thisServerID).detail("Weights", weights);
+	}
+}
+
 ACTOR Future<Void> serveGetValueRequests(StorageServer* self, FutureStream<GetValueRequest> getValue) {
 	getCurrentLineage()->modify(&TransactionLineage::operation) = TransactionLineage::Operation::GetValue;
 	loop {
@@ -13374,6 +14960,19 @@ ACTOR Future<Void> serveGetValueRequests(StorageServer* self, FutureStream<GetVa
 	}
 }
 
+ACTOR Future<Void> serveGetValuesRequests(StorageServer* self, FutureStream<GetValuesRequest> getValues) {
+	getCurrentLineage()->modify(&TransactionLineage::operation) = TransactionLineage::Operation::GetValue;
+	loop {
+		GetValuesRequest req = waitNext(getValues);
+		// Warning: This code is executed at extremely high priority (TaskPriority::LoadBalancedEndpoint), so
+		// downgrade before doing real work
+		if (req.options.present() && req.options.get().debugID.present())
+			g_traceBatch.addEvent("GetValuesDebug", req.options.get().debugID.get().first(), "storageServer.received");
+
+		self->actors.add(self->readGuard(req, getValuesQ));
+	}
+}
+
 ACTOR Future<Void> serveGetKeyValuesRequests(StorageServer* self, FutureStream<GetKeyValuesRequest> getKeyValues) {
 	getCurrentLineage()->modify(&TransactionLineage::operation) = TransactionLineage::Operation::GetKeyValues;
 	loop {
@@ -13440,6 +15039,59 @@ ACTOR Future<Void> watchValueWaitForVersion(StorageServer* self,
 	return Void();
 }
 
+ACTOR Future<Void> reportWatchValue(int index, Future<WatchValueReply> reply, PromiseStream<WatchValuesReply> reports) {
+	state WatchValuesReply report;
+	report.index = index;
+	try {
+		WatchValueReply r = wait(reply);
+		report.version = r.version;
+	} catch (Error& e) {
+		if (e.code() == error_code_actor_cancelled) {
+			throw;
+		}
+		report.error = e;
+	}
+	reports.send(report);
+	return Void();
+}
+
+// Each watch of the batch goes through the same path as a WatchValueRequest, so watches of a key are shared with those
+// of other clients. Only the request and the reports are batched.
+ACTOR Future<Void> watchValuesQ(StorageServer* self, WatchValuesRequest req, PromiseStream<WatchValueRequest> stream) {
+	state Span span("SS:watchValues"_loc, req.spanContext);
+	state PromiseStream<WatchValuesReply> reports;
+	state std::vector<Future<Void>> watches;
+	state int remaining = req.watches.size();
+	req.reply.setByteLimit(SERVER_KNOBS->WATCH_VALUES_STREAM_LIMIT_BYTES);
+
+	watches.reserve(req.watches.size());
+	for (int i = 0; i < req.watches.size(); ++i) {
+		const WatchedValueRef& w = req.watches[i];
+		WatchValueRequest watchReq(
+		    span.context, req.tenantInfo, Key(w.key), w.value.castTo<Value>(), w.version, req.tags, Optional<UID>());
+		watches.push_back(reportWatchValue(i, watchReq.reply.getFuture(), reports));
+		if (self->shouldRead(watchReq)) {
+			self->actors.add(watchValueWaitForVersion(self, watchReq, stream));
+		}
+	}
+
+	try {
+		while (remaining > 0) {
+			state WatchValuesReply report = waitNext(reports.getFuture());
+			wait(req.reply.onReady());
+			req.reply.send(report);
+			--remaining;
+		}
+		req.reply.sendError(end_of_stream());
+	} catch (Error& e) {
+		if (e.code() == error_code_actor_cancelled) {
+			throw;
+		}
+		// The client has gone away. The watches are left to time out like those of an abandoned WatchValueRequest.
+	}
+	return Void();
+}
+
 ACTOR Future<Void> serveWatchValueRequestsImpl(StorageServer* self, FutureStream<WatchValueRequest> stream) {
 	loop {
 		getCurrentLineage()->modify(&TransactionLineage::txID) = UID();
@@ -13548,16 +15200,24 @@ ACTOR Future<Void> serveWatchValueRequestsImpl(StorageServer* self, FutureStream
 	}
 }
 
-ACTOR Future<Void> serveWatchValueRequests(StorageServer* self, FutureStream<WatchValueRequest> watchValue) {
+ACTOR Future<Void> serveWatchValueRequests(StorageServer* self,
+                                           FutureStream<WatchValueRequest> watchValue,
+                                           FutureStream<WatchValuesRequest> watchValues) {
 	state PromiseStream<WatchValueRequest> stream;
 	getCurrentLineage()->modify(&TransactionLineage::operation) = TransactionLineage::Operation::WatchValue;
 	self->actors.add(serveWatchValueRequestsImpl(self, stream.getFuture()));
 
 	loop {
-		WatchValueRequest req = waitNext(watchValue);
-		// TODO: fast load balancing?
-		if (self->shouldRead(req)) {
-			self->actors.add(watchValueWaitForVersion(self, req, stream));
+		choose {
+			when(WatchValueRequest req = waitNext(watchValue)) {
+				// TODO: fast load balancing?
+				if (self->shouldRead(req)) {
+					self->actors.add(watchValueWaitForVersion(self, req, stream));
+				}
+			}
+			when(WatchValuesRequest req = waitNext(watchValues)) {
+				self->actors.add(watchValuesQ(self, req, stream));
+			}
 		}
 	}
 }
@@ -13571,6 +15231,15 @@ ACTOR Future<Void> serveChangeFeedStreamRequests(StorageServer* self,
 	}
 }
 
+ACTOR Future<Void> serveChangeFeedMultiStreamRequests(
+    StorageServer* self,
+    FutureStream<ChangeFeedMultiStreamRequest> changeFeedMultiStream) {
+	loop {
+		ChangeFeedMultiStreamRequest req = waitNext(changeFeedMultiStream);
+		self->actors.add(changeFeedMultiStreamQ(self, req) || stopChangeFeedMultiStreamOnMove(self, req));
+	}
+}
+
 ACTOR Future<Void> serveOverlappingChangeFeedsRequests(
     StorageServer* self,
     FutureStream<OverlappingChangeFeedsRequest> overlappingChangeFeeds) {
@@ -13706,13 +15375,19 @@ ACTOR Future<Void> storageServerCore(StorageServer* self, StorageServerInterface
 	self->actors.add(metricsCore(self, ssi));
 	self->actors.add(logLongByteSampleRecovery(self->byteSampleRecovery));
 	self->actors.add(checkBehind(self));
+	self->actors.add(updateReadLockConfig(self));
+	if (self->fetchSourceBudget.enabled()) {
+		self->actors.add(updateFetchSourceBudget(self));
+	}
 	self->actors.add(serveGetValueRequests(self, ssi.getValue.getFuture()));
+	self->actors.add(serveGetValuesRequests(self, ssi.getValues.getFuture()));
 	self->actors.add(serveGetKeyValuesRequests(self, ssi.getKeyValues.getFuture()));
 	self->actors.add(serveGetMappedKeyValuesRequests(self, ssi.getMappedKeyValues.getFuture()));
 	self->actors.add(serveGetKeyValuesStreamRequests(self, ssi.getKeyValuesStream.getFuture()));
 	self->actors.add(serveGetKeyRequests(self, ssi.getKey.getFuture()));
-	self->actors.add(serveWatchValueRequests(self, ssi.watchValue.getFuture()));
+	self->actors.add(serveWatchValueRequests(self, ssi.watchValue.getFuture(), ssi.watchValues.getFuture()));
 	self->actors.add(serveChangeFeedStreamRequests(self, ssi.changeFeedStream.getFuture()));
+	self->actors.add(serveChangeFeedMultiStreamRequests(self, ssi.changeFeedMultiStream.getFuture()));
 	self->actors.add(serveOverlappingChangeFeedsRequests(self, ssi.overlappingChangeFeeds.getFuture()));
 	self->actors.add(serveChangeFeedPopRequests(self, ssi.changeFeedPop.getFuture()));
 	self->actors.add(serveChangeFeedVersionUpdateRequests(self, ssi.changeFeedVersionUpdate.getFuture()));
@@ -13723,6 +15398,11 @@ ACTOR Future<Void> storageServerCore(StorageServer* self, StorageServerInterface
 	self->transactionTagCounter.startNewInterval();
 	self->actors.add(
 	    recurring([&]() { self->transactionTagCounter.startNewInterval(); }, SERVER_KNOBS->TAG_MEASUREMENT_INTERVAL));
+	if (self->hotKeys.enabled()) {
+		self->hotKeys.startNewInterval();
+		self->actors.add(
+		    recurring([&]() { self->hotKeys.startNewInterval(); }, SERVER_KNOBS->HOT_KEY_MEASUREMENT_INTERVAL));
+	}
 
 	self->coreStarted.send(Void());
 
@@ -13911,6 +15591,22 @@ ACTOR Future<Void> storageServerCore(StorageServer* self, StorageServerInterface
 				TraceEvent(SevError, "GetStorageCheckSumHasNotImplemented", ssi.id());
 				req.reply.sendError(not_implemented());
 			}
+			when(RebuildStorageRequest req = waitNext(ssi.rebuildStorage.getFuture())) {
+				// The worker copies the store by key, which only the single-store engines support
+				KeyValueStoreType storeType = self->storage.getKeyValueStoreType();
+				if (self->isTss() || (storeType != KeyValueStoreType::SSD_REDWOOD_V1 &&
+				                      storeType != KeyValueStoreType::SSD_ROCKSDB_V1)) {
+					req.reply.sendError(unsupported_operation());
+					continue;
+				}
+				// Mutations after the durable version stay in the TLogs until the rebuilt server pulls them again
+				TraceEvent("StorageServerRebuildRequested", self->thisServerID)
+				    .detail("StoreType", storeType)
+				    .detail("Version", self->version.get())
+				    .detail("DurableVersion", self->durableVersion.get());
+				req.reply.send(Void());
+				throw please_rebuild_kv_store();
+			}
 			when(wait(self->actors.getResult())) {}
 		}
 	}
@@ -23,6 +23,7 @@
 #include <boost/lexical_cast.hpp>
 #include <unordered_map>
 
+#include "fdbclient/BlobGranuleFileCache.h"
 #include "fdbclient/FDBTypes.h"
 #include "fdbserver/BlobMigratorInterface.h"
 #include "flow/ApiVersion.h"
@@ -345,6 +346,8 @@ StringRef fileVersionedLogDataPrefix = "log2-"_sr;
 StringRef fileLogQueuePrefix = "logqueue-"_sr;
 StringRef tlogQueueExtension = "fdq"_sr;
 StringRef fileBlobWorkerPrefix = "bw-"_sr;
+StringRef fileStorageMigrationPrefix = "storagemigration-"_sr;
+StringRef fileStorageRebuildPrefix = "storagerebuild-"_sr;
 
 enum class FilesystemCheck {
 	FILES_ONLY,
@@ -473,6 +476,19 @@ struct TLogOptions {
 	}
 };
 
+// The folders that TLOG_DISK_QUEUE_STRIPE_FOLDERS asks TLog disk queues to be striped across
+std::vector<std::string> tLogQueueStripeFolders() {
+	std::vector<std::string> folders;
+	StringRef remaining(SERVER_KNOBS->TLOG_DISK_QUEUE_STRIPE_FOLDERS);
+	while (remaining.size()) {
+		StringRef folder = remaining.eat(","_sr);
+		if (folder.size()) {
+			folders.push_back(folder.toString());
+		}
+	}
+	return folders;
+}
+
 TLogFn tLogFnForOptions(TLogOptions options) {
 	switch (options.version) {
 	case TLogVersion::V2:
@@ -1483,9 +1499,36 @@ void runHeapProfiler(const char* msg) {
 #endif
 }
 
+// RUN dumps the sampling profiler, after sampling for req.duration seconds from scratch if it is positive
+ACTOR Future<Void> runSamplingProfiler(ProfilerRequest req) {
+	state std::string outputFile = req.outputFile.toString();
+	state bool wasRunning = isSamplingProfilerRunning();
+	if (req.action == ProfilerRequest::Action::ENABLE) {
+		startSamplingProfiler(g_network, FLOW_KNOBS->NETWORK_THREAD_SAMPLING_PROFILER_PERIOD);
+	} else if (req.action == ProfilerRequest::Action::DISABLE) {
+		dumpSamplingProfile(outputFile);
+		stopSamplingProfiler();
+	} else if (req.duration > 0) {
+		startSamplingProfiler(g_network, FLOW_KNOBS->NETWORK_THREAD_SAMPLING_PROFILER_PERIOD);
+		clearSamplingProfile();
+		wait(delay(req.duration));
+		dumpSamplingProfile(outputFile);
+		if (!wasRunning) {
+			stopSamplingProfiler();
+		}
+	} else if (wasRunning) {
+		dumpSamplingProfile(outputFile);
+	} else {
+		TraceEvent("ProfilerError").detail("Message", "Sampling profiler not running");
+	}
+	return Void();
+}
+
 ACTOR Future<Void> runProfiler(ProfilerRequest req) {
 	if (req.type == ProfilerRequest::Type::GPROF_HEAP) {
 		runHeapProfiler("User triggered heap dump");
+	} else if (req.type == ProfilerRequest::Type::FLOW_SAMPLED) {
+		wait(runSamplingProfiler(req));
 	} else {
 		wait(runCpuProfiler(req));
 	}
@@ -1593,6 +1636,13 @@ struct TrackRunningStorage {
 	};
 };
 
+ACTOR Future<Void> rebuildStorageEngineLocally(KeyValueStoreType storeType,
+                                               std::string filename,
+                                               UID storeID,
+                                               std::string folder,
+                                               int64_t memoryLimit,
+                                               Reference<AsyncVar<ServerDBInfo> const> dbInfo);
+
 ACTOR Future<Void> storageServerRollbackRebooter(std::set<std::pair<UID, KeyValueStoreType>>* runningStorages,
                                                  std::unordered_map<UID, StorageDiskCleaner>* storageCleaners,
                                                  Future<Void> prevStorageServer,
@@ -1615,17 +1665,24 @@ ACTOR Future<Void> storageServerRollbackRebooter(std::set<std::pair<UID, KeyValu
 		if (!e.isError())
 			return Void();
 		else if (e.getError().code() != error_code_please_reboot &&
-		         e.getError().code() != error_code_please_reboot_kv_store)
+		         e.getError().code() != error_code_please_reboot_kv_store &&
+		         e.getError().code() != error_code_please_rebuild_kv_store)
 			throw e.getError();
 
+		state bool rebuildKVStore = e.getError().code() == error_code_please_rebuild_kv_store;
 		TraceEvent("StorageServerRequestedReboot", id)
-		    .detail("RebootStorageEngine", e.getError().code() == error_code_please_reboot_kv_store)
+		    .detail("RebootStorageEngine", e.getError().code() != error_code_please_reboot)
+		    .detail("RebuildStorageEngine", rebuildKVStore)
 		    .log();
 
-		if (e.getError().code() == error_code_please_reboot_kv_store) {
+		if (e.getError().code() != error_code_please_reboot) {
 			// Add the to actorcollection to make sure filesClosed not return
 			filesClosed->add(rebootKVStore->getFuture());
 			wait(delay(SERVER_KNOBS->REBOOT_KV_STORE_DELAY));
+			// The storage server closed the store before rethrowing, and its mutations since are kept by the TLogs
+			if (rebuildKVStore) {
+				wait(rebuildStorageEngineLocally(storeType, filename, id, folder, memoryLimit, db));
+			}
 			// reopen KV store
 			store = openKVStore(
 			    storeType,
@@ -2067,6 +2124,352 @@ void cleanupStorageDisks(Reference<AsyncVar<ServerDBInfo>> dbInfo,
 	}
 }
 
+// A local storage engine migration records its progress in a marker file, so that a worker restarted part way through
+// knows which of the two stores holding a storage server's data is complete. While copying, the marker names the
+// target type and the target is incomplete. Once the target is closed, the marker names the source type, which is
+// only waiting to be deleted.
+static const std::string migrationCopying = "copying";
+static const std::string migrationCopied = "copied";
+// An in-place rebuild copies into a store of the same type under fileStorageRebuildPrefix, which is renamed over the
+// original once that is deleted. Its marker always names the store type.
+static const std::string rebuildCopying = "rebuilding";
+static const std::string rebuildCopied = "rebuilt";
+
+std::string storageMigrationMarker(std::string folder, UID storeID) {
+	return joinPath(folder, fileStorageMigrationPrefix.toString() + storeID.toString());
+}
+
+void writeStorageMigrationMarker(std::string const& marker, std::string const& phase, KeyValueStoreType storeType) {
+	atomicReplace(marker, phase + " " + storeType.toString() + "\n");
+}
+
+ACTOR Future<Void> disposeStorageFile(KeyValueStoreType storeType,
+                                      std::string filename,
+                                      UID storeID,
+                                      int64_t memoryLimit,
+                                      Reference<AsyncVar<ServerDBInfo> const> dbInfo) {
+	state IKeyValueStore* kvs = openKVStore(storeType, filename, storeID, memoryLimit, false, false, false, dbInfo, {});
+	wait(ready(kvs->init()));
+	kvs->dispose();
+	wait(kvs->onClosed());
+	return Void();
+}
+
+// Finishes or rolls back an in-place rebuild interrupted by a restart. While copying, the rebuilt store is incomplete
+// and is dropped. Once copied, it replaces the original store, which may not have been deleted yet.
+ACTOR Future<Void> resolveStorageRebuild(std::vector<DiskStore>* stores,
+                                         std::string folder,
+                                         UID storeID,
+                                         KeyValueStoreType storeType,
+                                         bool copied,
+                                         int64_t memoryLimit,
+                                         Reference<AsyncVar<ServerDBInfo>> dbInfo) {
+	state std::string rebuilt = filenameFromId(storeType, folder, fileStorageRebuildPrefix.toString(), storeID);
+	state std::string original = filenameFromId(storeType, folder, fileStoragePrefix.toString(), storeID);
+	// Without the rebuilt store, the rebuild either never started copying or was already renamed into place
+	state bool rebuiltFound = fileExists(rebuilt) || directoryExists(rebuilt);
+	state bool originalFound = false;
+	for (auto const& s : *stores) {
+		originalFound |= s.storedComponent == DiskStore::Storage && s.storeID == storeID && s.storeType == storeType;
+	}
+	TraceEvent(SevWarnAlways, "LocalStorageRebuildInterrupted")
+	    .detail("StoreID", storeID)
+	    .detail("StoreType", storeType)
+	    .detail("Copied", copied)
+	    .detail("RebuiltStoreFound", rebuiltFound)
+	    .detail("OriginalStoreFound", originalFound);
+	if (!rebuiltFound) {
+		return Void();
+	}
+	if (!copied) {
+		wait(disposeStorageFile(storeType, rebuilt, storeID, memoryLimit, dbInfo));
+		return Void();
+	}
+	if (originalFound) {
+		wait(disposeStorageFile(storeType, original, storeID, memoryLimit, dbInfo));
+	} else {
+		DiskStore store;
+		store.storeID = storeID;
+		store.filename = original;
+		store.storedComponent = DiskStore::Storage;
+		store.storeType = storeType;
+		stores->push_back(store);
+	}
+	renameFile(rebuilt, original);
+	return Void();
+}
+
+// Finishes or rolls back local storage engine migrations interrupted by a restart, removing the store that has to be
+// deleted from stores.
+ACTOR Future<Void> resolveStorageMigrations(std::vector<DiskStore>* stores,
+                                            std::string folder,
+                                            int64_t memoryLimit,
+                                            Reference<AsyncVar<ServerDBInfo>> dbInfo) {
+	state std::vector<std::string> markers;
+	for (auto const& file : platform::listFiles(folder)) {
+		if (StringRef(file).startsWith(fileStorageMigrationPrefix)) {
+			markers.push_back(file);
+		}
+	}
+
+	state int i = 0;
+	for (; i < markers.size(); ++i) {
+		state std::string marker = joinPath(folder, markers[i]);
+		state UID storeID = UID::fromString(markers[i].substr(fileStorageMigrationPrefix.size(), 32));
+		std::string content = readFileBytes(marker, 100);
+		std::string phase = content.substr(0, content.find(' '));
+		std::string typeName = content.substr(phase.size() + 1);
+		typeName.erase(typeName.find_last_not_of("\n") + 1);
+		KeyValueStoreType storeType = KeyValueStoreType::fromString(typeName);
+
+		if (phase == rebuildCopying || phase == rebuildCopied) {
+			wait(resolveStorageRebuild(stores, folder, storeID, storeType, phase == rebuildCopied, memoryLimit, dbInfo));
+			deleteFile(marker);
+			continue;
+		}
+
+		// While copying, the target is incomplete; once copied, the source is the one to delete
+		state Optional<DiskStore> stale;
+		for (auto s = stores->begin(); s != stores->end(); ++s) {
+			if (s->storedComponent == DiskStore::Storage && s->storeID == storeID && s->storeType == storeType) {
+				stale = *s;
+				stores->erase(s);
+				break;
+			}
+		}
+		TraceEvent(SevWarnAlways, "LocalStorageMigrationInterrupted")
+		    .detail("StoreID", storeID)
+		    .detail("Phase", phase)
+		    .detail("StaleStoreType", storeType)
+		    .detail("StaleStoreFound", stale.present());
+		ASSERT(phase == migrationCopying || phase == migrationCopied);
+		if (stale.present()) {
+			wait(deleteStorageFile(stale.get().storeType, stale.get().filename, storeID, memoryLimit, dbInfo));
+		}
+		deleteFile(marker);
+	}
+	return Void();
+}
+
+// Copies every key of source, including a storage server's persisted metadata, into target in batches of
+// STORAGE_LOCAL_MIGRATION_BATCH_BYTES, committing each batch.
+ACTOR Future<Void> copyKeyValueStore(IKeyValueStore* source, IKeyValueStore* target, int64_t* rows, int64_t* bytes) {
+	state Key begin;
+	// Only an empty read ends the copy, so a store that stops short of its limits cannot truncate it
+	loop {
+		RangeResult batch = wait(source->readRange(
+		    KeyRangeRef(begin, "\xff\xff\xff\xff"_sr), 1 << 30, SERVER_KNOBS->STORAGE_LOCAL_MIGRATION_BATCH_BYTES));
+		if (batch.empty()) {
+			return Void();
+		}
+		for (auto const& kv : batch) {
+			target->set(kv);
+			*bytes += kv.expectedSize();
+		}
+		*rows += batch.size();
+		begin = keyAfter(batch.back().key);
+		wait(target->commit());
+	}
+}
+
+// Copies a storage server's data, including its persisted metadata and durable version, into a new store of
+// STORAGE_LOCAL_MIGRATION_ENGINE on the same disk, and deletes the old store. The storage server is then restored from
+// the new store and catches up from the TLogs like after any restart, so no data has to be re-replicated. Returns the
+// store to restore from, which is the original one if it could not be migrated.
+ACTOR Future<DiskStore> migrateStorageEngineLocally(DiskStore source,
+                                                    std::string folder,
+                                                    int64_t memoryLimit,
+                                                    Reference<AsyncVar<ServerDBInfo>> dbInfo) {
+	state KeyValueStoreType targetType = KeyValueStoreType::fromString(SERVER_KNOBS->STORAGE_LOCAL_MIGRATION_ENGINE);
+	if (source.storeType == targetType) {
+		return source;
+	}
+	// The sharded RocksDB engine keeps its own shard metadata, which a key by key copy cannot carry over
+	if (source.storeType == KeyValueStoreType::SSD_SHARDED_ROCKSDB ||
+	    targetType == KeyValueStoreType::SSD_SHARDED_ROCKSDB || targetType == KeyValueStoreType::SSD_BTREE_V1) {
+		TraceEvent(SevWarnAlways, "LocalStorageMigrationUnsupported")
+		    .detail("StoreID", source.storeID)
+		    .detail("StoreType", source.storeType)
+		    .detail("TargetStoreType", targetType);
+		return source;
+	}
+
+	state DiskStore target = source;
+	bool isTss = basename(source.filename).find(testingStoragePrefix.toString()) == 0;
+	target.storeType = targetType;
+	target.filename = filenameFromId(
+	    targetType, folder, (isTss ? testingStoragePrefix : fileStoragePrefix).toString(), source.storeID);
+	state std::string marker = storageMigrationMarker(folder, source.storeID);
+	state Reference<GetEncryptCipherKeysMonitor> encryptionMonitor = makeReference<GetEncryptCipherKeysMonitor>();
+	state IKeyValueStore* sourceStore = openKVStore(source.storeType,
+	                                                source.filename,
+	                                                source.storeID,
+	                                                memoryLimit,
+	                                                false,
+	                                                false,
+	                                                false,
+	                                                dbInfo,
+	                                                {},
+	                                                0,
+	                                                encryptionMonitor);
+	state IKeyValueStore* targetStore = nullptr;
+	state EncryptionAtRestMode encryptionMode;
+	state double startTime = now();
+	state int64_t rows = 0;
+	state int64_t bytes = 0;
+	state Optional<Error> err;
+
+	try {
+		wait(sourceStore->init());
+		wait(store(encryptionMode, sourceStore->encryptionMode()));
+		if (encryptionMode.isEncryptionEnabled() && targetType != KeyValueStoreType::SSD_REDWOOD_V1) {
+			TraceEvent(SevWarnAlways, "LocalStorageMigrationUnsupported")
+			    .detail("StoreID", source.storeID)
+			    .detail("StoreType", source.storeType)
+			    .detail("TargetStoreType", targetType)
+			    .detail("EncryptionMode", encryptionMode.toString());
+			sourceStore->close();
+			wait(sourceStore->onClosed());
+			return source;
+		}
+
+		TraceEvent("LocalStorageMigrationStart")
+		    .detail("StoreID", source.storeID)
+		    .detail("StoreType", source.storeType)
+		    .detail("TargetStoreType", targetType);
+		writeStorageMigrationMarker(marker, migrationCopying, targetType);
+		targetStore = openKVStore(targetType,
+		                          target.filename,
+		                          source.storeID,
+		                          memoryLimit,
+		                          false,
+		                          false,
+		                          false,
+		                          dbInfo,
+		                          encryptionMode,
+		                          0,
+		                          encryptionMonitor);
+		wait(targetStore->init());
+
+		wait(copyKeyValueStore(sourceStore, targetStore, &rows, &bytes));
+
+		targetStore->close();
+		wait(targetStore->onClosed());
+		targetStore = nullptr;
+		writeStorageMigrationMarker(marker, migrationCopied, source.storeType);
+		sourceStore->dispose();
+		wait(sourceStore->onClosed());
+		deleteFile(marker);
+	} catch (Error& e) {
+		if (e.code() == error_code_actor_cancelled) {
+			throw;
+		}
+		err = e;
+	}
+
+	if (err.present()) {
+		// Put things back as they were; if this fails too, the marker lets the next restart clean up
+		TraceEvent(SevWarnAlways, "LocalStorageMigrationFailed")
+		    .errorUnsuppressed(err.get())
+		    .detail("StoreID", source.storeID)
+		    .detail("TargetStoreType", targetType);
+		if (targetStore) {
+			targetStore->dispose();
+			wait(targetStore->onClosed());
+		}
+		sourceStore->close();
+		wait(sourceStore->onClosed());
+		deleteFile(marker);
+		return source;
+	}
+
+	TraceEvent("LocalStorageMigrationDone")
+	    .detail("StoreID", source.storeID)
+	    .detail("StoreType", source.storeType)
+	    .detail("TargetStoreType", targetType)
+	    .detail("Rows", rows)
+	    .detail("Bytes", bytes)
+	    .detail("Duration", now() - startTime);
+	return target;
+}
+
+// Rebuilds a storage server's store in place for the perpetual wiggle: copies it into a fresh store of the same type,
+// which leaves behind the fragmentation and free space the old one accumulated, deletes the old store and renames the
+// copy over it. The storage server keeps its shards and catches up from the TLogs once it is restored. If the copy
+// fails, the original store is kept; past the copy, the marker lets the next restart finish the rebuild.
+ACTOR Future<Void> rebuildStorageEngineLocally(KeyValueStoreType storeType,
+                                               std::string filename,
+                                               UID storeID,
+                                               std::string folder,
+                                               int64_t memoryLimit,
+                                               Reference<AsyncVar<ServerDBInfo> const> dbInfo) {
+	state std::string rebuilt = filenameFromId(storeType, folder, fileStorageRebuildPrefix.toString(), storeID);
+	state std::string marker = storageMigrationMarker(folder, storeID);
+	state Reference<GetEncryptCipherKeysMonitor> encryptionMonitor = makeReference<GetEncryptCipherKeysMonitor>();
+	state IKeyValueStore* sourceStore = openKVStore(
+	    storeType, filename, storeID, memoryLimit, false, false, false, dbInfo, {}, 0, encryptionMonitor);
+	state IKeyValueStore* targetStore = nullptr;
+	state EncryptionAtRestMode encryptionMode;
+	state double startTime = now();
+	state int64_t rows = 0;
+	state int64_t bytes = 0;
+	state Optional<Error> err;
+
+	try {
+		wait(sourceStore->init());
+		wait(store(encryptionMode, sourceStore->encryptionMode()));
+
+		TraceEvent("LocalStorageRebuildStart").detail("StoreID", storeID).detail("StoreType", storeType);
+		writeStorageMigrationMarker(marker, rebuildCopying, storeType);
+		targetStore = openKVStore(
+		    storeType, rebuilt, storeID, memoryLimit, false, false, false, dbInfo, encryptionMode, 0, encryptionMonitor);
+		wait(targetStore->init());
+		wait(copyKeyValueStore(sourceStore, targetStore, &rows, &bytes));
+		targetStore->close();
+		wait(targetStore->onClosed());
+		targetStore = nullptr;
+	} catch (Error& e) {
+		if (e.code() == error_code_actor_cancelled) {
+			throw;
+		}
+		err = e;
+	}
+
+	if (err.present()) {
+		TraceEvent(SevWarnAlways, "LocalStorageRebuildFailed").errorUnsuppressed(err.get()).detail("StoreID", storeID);
+		if (targetStore) {
+			targetStore->dispose();
+			wait(targetStore->onClosed());
+		}
+		sourceStore->close();
+		wait(sourceStore->onClosed());
+		deleteFile(marker);
+		return Void();
+	}
+
+	writeStorageMigrationMarker(marker, rebuildCopied, storeType);
+	sourceStore->dispose();
+	wait(sourceStore->onClosed());
+	renameFile(rebuilt, filename);
+	deleteFile(marker);
+
+	TraceEvent("LocalStorageRebuildDone")
+	    .detail("StoreID", storeID)
+	    .detail("StoreType", storeType)
+	    .detail("Rows", rows)
+	    .detail("Bytes", bytes)
+	    .detail("Duration", now() - startTime);
+	return Void();
+}
+
+// Blob workers share one local cache of granule files per process
+void enableBlobGranuleFileCache(std::string const& folder) {
+	if (SERVER_KNOBS->BG_FILE_CACHE_BYTES > 0) {
+		BlobGranuleFileCache::enableProcessCache(joinPath(folder, "blobgranulefiles"),
+		                                         SERVER_KNOBS->BG_FILE_CACHE_BYTES);
+	}
+}
+
 ACTOR Future<Void> workerServer(Reference<IClusterConnectionRecord> connRecord,
                                 Reference<AsyncVar<Optional<ClusterControllerFullInterface>> const> ccInterface,
                                 LocalityData locality,
@@ -2219,6 +2622,7 @@ ACTOR Future<Void> workerServer(Reference<IClusterConnectionRecord> connRecord,
 	try {
 		state std::vector<DiskStore> stores = getDiskStores(folder);
 		state bool validateDataFiles = deleteFile(joinPath(folder, validationFilename));
+		wait(resolveStorageMigrations(&stores, folder, memoryLimit, dbInfo));
 		state int index = 0;
 		for (; index < stores.size(); ++index) {
 			state DiskStore s = stores[index];
@@ -2229,6 +2633,10 @@ ACTOR Future<Void> workerServer(Reference<IClusterConnectionRecord> connRecord,
 				if (index >= 2 && SERVER_KNOBS->WORKER_START_STORAGE_DELAY > 0.0) {
 					wait(delay(SERVER_KNOBS->WORKER_START_STORAGE_DELAY));
 				}
+				if (!SERVER_KNOBS->STORAGE_LOCAL_MIGRATION_ENGINE.empty()) {
+					DiskStore migrated = wait(migrateStorageEngineLocally(s, folder, memoryLimit, dbInfo));
+					s = migrated;
+				}
 				LocalLineage _;
 				getCurrentLineage()->modify(&RoleLineage::role) = ProcessClass::ClusterRole::Storage;
 
@@ -2347,7 +2755,8 @@ ACTOR Future<Void> workerServer(Reference<IClusterConnectionRecord> connRecord,
 				                                  tlogQueueExtension.toString(),
 				                                  s.storeID,
 				                                  dqv,
-				                                  diskQueueWarnSize);
+				                                  diskQueueWarnSize,
+				                                  tLogQueueStripeFolders());
 				filesClosed.add(kv->onClosed());
 				filesClosed.add(queue->onClosed());
 
@@ -2417,6 +2826,7 @@ ACTOR Future<Void> workerServer(Reference<IClusterConnectionRecord> connRecord,
 					                                   FLOW_KNOBS->BLOB_WORKER_PAGE_CACHE);
 					filesClosed.add(data->onClosed());
 
+					enableBlobGranuleFileCache(folder);
 					Promise<Void> recovery;
 					Future<Void> bw = blobWorker(recruited, recovery, dbInfo, data);
 					recoveries.push_back(recovery.getFuture());
@@ -2523,6 +2933,22 @@ ACTOR Future<Void> workerServer(Reference<IClusterConnectionRecord> connRecord,
 				    req.serializedDbInfo, AssumeVersion(g_network->protocolVersion()));
 				localInfo.myLocality = locality;
 
+				// Fill in what a delta left out from the ServerDBInfo it is based on, if this worker has it
+				bool missingDeltaBase = false;
+				if (req.baseInfoGeneration.present()) {
+					if (dbInfo->get().infoGeneration == req.baseInfoGeneration.get() &&
+					    dbInfo->get().clusterInterface == localInfo.clusterInterface) {
+						if (req.omitsClient) {
+							localInfo.client = dbInfo->get().client;
+						}
+						if (req.omitsLogSystemConfig) {
+							localInfo.logSystemConfig = dbInfo->get().logSystemConfig;
+						}
+					} else {
+						missingDeltaBase = true;
+					}
+				}
+
 				if (localInfo.infoGeneration < dbInfo->get().infoGeneration &&
 				    localInfo.clusterInterface == dbInfo->get().clusterInterface) {
 					std::vector<Endpoint> rep = req.broadcastInfo;
@@ -2532,6 +2958,11 @@ ACTOR Future<Void> workerServer(Reference<IClusterConnectionRecord> connRecord,
 					Optional<Endpoint> notUpdated;
 					if (!ccInterface->get().present() || localInfo.clusterInterface != ccInterface->get().get()) {
 						notUpdated = interf.updateServerDBInfo.getEndpoint();
+					} else if ((localInfo.infoGeneration > dbInfo->get().infoGeneration ||
+					            dbInfo->get().clusterInterface != ccInterface->get().get()) &&
+					           missingDeltaBase) {
+						CODE_PROBE(true, "Worker missing the base of a ServerDBInfo delta");
+						notUpdated = interf.updateServerDBInfo.getEndpoint();
 					} else if (localInfo.infoGeneration > dbInfo->get().infoGeneration ||
 					           dbInfo->get().clusterInterface != ccInterface->get().get()) {
 						TraceEvent("GotServerDBInfoChange")
@@ -2912,7 +3343,9 @@ ACTOR Future<Void> workerServer(Reference<IClusterConnectionRecord> connRecord,
 					             fileLogQueuePrefix.toString() + tLogOptions.toPrefix() + logId.toString() + "-"),
 					    tlogQueueExtension.toString(),
 					    logId,
-					    dqv);
+					    dqv,
+					    -1,
+					    tLogQueueStripeFolders());
 					filesClosed.add(data->onClosed());
 					filesClosed.add(queue->onClosed());
 
@@ -3125,6 +3558,7 @@ ACTOR Future<Void> workerServer(Reference<IClusterConnectionRecord> connRecord,
 						filesClosed.add(data->onClosed());
 					}
 
+					enableBlobGranuleFileCache(folder);
 					ReplyPromise<InitializeBlobWorkerReply> blobWorkerReady = req.reply;
 					Future<Void> bw = blobWorker(recruited, blobWorkerReady, dbInfo, data);
 					if (SERVER_KNOBS->BLOB_WORKER_DISK_ENABLED && req.storeType != KeyValueStoreType::END) {
@@ -3215,6 +3649,7 @@ ACTOR Future<Void> workerServer(Reference<IClusterConnectionRecord> connRecord,
 
 				DUMPTOKEN(recruited.peekMessages);
 				DUMPTOKEN(recruited.peekStreamMessages);
+				DUMPTOKEN(recruited.peekTagsMessages);
 				DUMPTOKEN(recruited.popMessages);
 				DUMPTOKEN(recruited.commit);
 				DUMPTOKEN(recruited.lock);
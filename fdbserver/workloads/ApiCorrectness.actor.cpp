@@ -475,6 +475,9 @@ public:
 		// Generate a random maximum number of results
 		state int limit = deterministicRandom()->randomInt(0, 101);
 
+		// Sometimes read the shards of the range in parallel
+		state int64_t parallelShards = deterministicRandom()->coinflip() ? deterministicRandom()->randomInt(2, 10) : 0;
+
 		// Get the range from memory
 		state RangeResult storeResults = self->store.getRange(KeyRangeRef(start, end), limit, reverse);
 
@@ -486,6 +489,10 @@ public:
 
 		loop {
 			try {
+				if (parallelShards) {
+					transaction->setOption(FDBTransactionOptions::READ_PARALLEL_SHARDS,
+					                       StringRef((uint8_t*)&parallelShards, sizeof(int64_t)));
+				}
 				Version version = wait(transaction->getReadVersion());
 				readVersion = version;
 
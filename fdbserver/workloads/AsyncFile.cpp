@@ -77,6 +77,20 @@ Future<bool> AsyncFileWorkload::check(Database const& cx) {
 	return true;
 }
 
+void AsyncFileWorkload::getLatencyMetrics(std::vector<PerfMetric>& m) {
+	TraceEvent("AsyncFileWorkloadLatency")
+	    .detail("Class", fileClass)
+	    .detail("Count", latencies.getPopulationSize())
+	    .detail("Mean", latencies.mean())
+	    .detail("P99", latencies.percentile(0.99))
+	    .detail("Max", latencies.max());
+	m.emplace_back("Mean Latency (ms)", 1000 * latencies.mean(), Averaged::False);
+	m.emplace_back("Median Latency (ms)", 1000 * latencies.median(), Averaged::False);
+	m.emplace_back("99% Latency (ms)", 1000 * latencies.percentile(0.99), Averaged::False);
+	m.emplace_back("99.9% Latency (ms)", 1000 * latencies.percentile(0.999), Averaged::False);
+	m.emplace_back("Max Latency (ms)", 1000 * latencies.max(), Averaged::False);
+}
+
 // Allocates a buffer of a given size.  If necessary, the buffer will be aligned to 4K
 AsyncFileBuffer::AsyncFileBuffer(size_t size, bool aligned) {
 	if (aligned) {
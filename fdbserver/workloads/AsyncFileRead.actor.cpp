@@ -255,11 +255,11 @@ struct AsyncFileReadWorkload : public AsyncFileWorkload {
 			if (writeFlag)
 				self->rbg.writeRandomBytesToBuffer((char*)self->readBuffers[bufferIndex]->buffer, self->readSize);
 
-			auto r =
+			auto r = self->timeIO(
 			    writeFlag
 			        ? tag(self->fileHandle->file->write(self->readBuffers[bufferIndex]->buffer, self->readSize, offset),
 			              self->readSize)
-			        : self->fileHandle->file->read(self->readBuffers[bufferIndex]->buffer, self->readSize, offset);
+			        : self->fileHandle->file->read(self->readBuffers[bufferIndex]->buffer, self->readSize, offset));
 			begin = now();
 			if (self->ioLog)
 				self->ioLog->logIOIssue(writeFlag, begin);
@@ -308,7 +308,8 @@ struct AsyncFileReadWorkload : public AsyncFileWorkload {
 				self->readFutures.push_back(uncancellable(holdWhile(
 				    self->fileHandle,
 				    holdWhile(self->readBuffers[i],
-				              self->fileHandle->file->read(self->readBuffers[i]->buffer, self->readSize, offset)))));
+				              self->timeIO(self->fileHandle->file->read(
+				                  self->readBuffers[i]->buffer, self->readSize, offset))))));
 			}
 
 			wait(waitForAll(self->readFutures));
@@ -323,7 +324,9 @@ struct AsyncFileReadWorkload : public AsyncFileWorkload {
 	void getMetrics(std::vector<PerfMetric>& m) override {
 		if (enabled) {
 			m.emplace_back("Bytes read/sec", bytesRead.getValue() / testDuration, Averaged::False);
+			m.emplace_back("IOPS", latencies.getPopulationSize() / testDuration, Averaged::False);
 			m.emplace_back("Average CPU Utilization (Percentage)", averageCpuUtilization * 100, Averaged::False);
+			getLatencyMetrics(m);
 		}
 	}
 };
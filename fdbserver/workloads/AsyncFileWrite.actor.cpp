@@ -116,9 +116,10 @@ struct AsyncFileWriteWorkload : public AsyncFileWorkload {
 				self->writeFutures.push_back(uncancellable(holdWhile(
 				    self->fileHandle,
 				    holdWhile(self->writeBuffer,
-				              self->fileHandle->file->write(self->writeBuffer->buffer,
-				                                            std::min((int64_t)self->writeSize, self->fileSize - offset),
-				                                            offset)))));
+				              self->timeIO(self->fileHandle->file->write(
+				                  self->writeBuffer->buffer,
+				                  std::min((int64_t)self->writeSize, self->fileSize - offset),
+				                  offset))))));
 
 				if (self->sequential) {
 					offset += self->writeSize;
@@ -148,6 +149,7 @@ struct AsyncFileWriteWorkload : public AsyncFileWorkload {
 		if (enabled) {
 			m.emplace_back("Bytes written/sec", bytesWritten.getValue() / testDuration, Averaged::False);
 			m.emplace_back("Average CPU Utilization (Percentage)", averageCpuUtilization * 100, Averaged::False);
+			getLatencyMetrics(m);
 		}
 	}
 };
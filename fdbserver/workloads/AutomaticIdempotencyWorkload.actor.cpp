@@ -162,15 +162,8 @@ struct AutomaticIdempotencyWorkload : TestWorkload {
 			Version commitVersion;
 			uint8_t highOrderBatchIndex;
 			decodeIdempotencyKey(k, commitVersion, highOrderBatchIndex);
-			BinaryReader valReader(v, IncludeVersion());
 			int64_t timestamp; // ignored
-			valReader >> timestamp;
-			while (!valReader.empty()) {
-				uint8_t length;
-				valReader >> length;
-				StringRef id{ reinterpret_cast<const uint8_t*>(valReader.readBytes(length)), length };
-				uint8_t lowOrderBatchIndex;
-				valReader >> lowOrderBatchIndex;
+			for (auto const& [id, lowOrderBatchIndex] : decodeIdempotencyValue(v, timestamp)) {
 				TraceEvent("IdempotencyIdWorkloadIdCommitted")
 				    .detail("CommitVersion", commitVersion)
 				    .detail("HighOrderBatchIndex", highOrderBatchIndex)
@@ -217,17 +210,8 @@ struct AutomaticIdempotencyWorkload : TestWorkload {
 		uint8_t highOrderBatchIndex;
 		decodeIdempotencyKey(kv.key, *commitVersion, highOrderBatchIndex);
 
-		BinaryReader valReader(kv.value.begin(), kv.value.size(), IncludeVersion());
-		valReader >> *timestamp;
-
 		std::vector<Key> keys;
-		while (!valReader.empty()) {
-			uint8_t length;
-			valReader >> length;
-			StringRef id{ reinterpret_cast<const uint8_t*>(valReader.readBytes(length)), length };
-			uint8_t lowOrderBatchIndex;
-			valReader >> lowOrderBatchIndex;
-
+		for (auto const& [id, lowOrderBatchIndex] : decodeIdempotencyValue(kv.value, *timestamp)) {
 			// Recover the key written in the transaction associated with this idempotency id
 			BinaryWriter keyWriter(Unversioned());
 			keyWriter.serializeBytes(keyPrefix);
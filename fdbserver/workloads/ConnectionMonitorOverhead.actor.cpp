@@ -0,0 +1,87 @@
+/*
+ * ConnectionMonitorOverhead.actor.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbrpc/FlowTransport.h"
+#include "fdbserver/QuietDatabase.h"
+#include "fdbserver/ServerDBInfo.h"
+#include "fdbserver/workloads/workloads.actor.h"
+#include "flow/actorcompiler.h" // This must be the last #include.
+
+// Measures the connection monitor pings this client sends while other workloads run, so that the background message
+// rate can be compared across cluster sizes and with CONNECTION_MONITOR_MAX_SUPPRESSED_PINGS.
+struct ConnectionMonitorOverheadWorkload : TestWorkload {
+	static constexpr auto NAME = "ConnectionMonitorOverhead";
+
+	double testDuration;
+	int workers = 0;
+	int peers = 0;
+	int64_t pingsSent = 0;
+	int64_t pingsSuppressed = 0;
+
+	ConnectionMonitorOverheadWorkload(WorkloadContext const& wcx) : TestWorkload(wcx) {
+		testDuration = getOption(options, "testDuration"_sr, 30.0);
+	}
+
+	Future<Void> setup(Database const& cx) override { return Void(); }
+	Future<Void> start(Database const& cx) override { return _start(this); }
+	Future<bool> check(Database const& cx) override { return true; }
+
+	// The pings sent and suppressed over the connections to all current peers
+	std::pair<int64_t, int64_t> pingCounts() {
+		std::pair<int64_t, int64_t> counts;
+		peers = 0;
+		for (auto const& [address, peer] : FlowTransport::transport().getAllPeers()) {
+			counts.first += peer->pingsSent;
+			counts.second += peer->pingsSuppressed;
+			peers += peer->connected;
+		}
+		return counts;
+	}
+
+	ACTOR static Future<Void> _start(ConnectionMonitorOverheadWorkload* self) {
+		std::vector<WorkerDetails> workers = wait(getWorkers(self->dbInfo));
+		self->workers = workers.size();
+
+		state std::pair<int64_t, int64_t> begin = self->pingCounts();
+		wait(delay(self->testDuration));
+		std::pair<int64_t, int64_t> end = self->pingCounts();
+		// Counts are lost with peers that are removed during the test
+		self->pingsSent = std::max<int64_t>(0, end.first - begin.first);
+		self->pingsSuppressed = std::max<int64_t>(0, end.second - begin.second);
+
+		TraceEvent("ConnectionMonitorOverhead")
+		    .detail("Workers", self->workers)
+		    .detail("Peers", self->peers)
+		    .detail("PingsSent", self->pingsSent)
+		    .detail("PingsSuppressed", self->pingsSuppressed)
+		    .detail("Duration", self->testDuration);
+		return Void();
+	}
+
+	void getMetrics(std::vector<PerfMetric>& m) override {
+		m.emplace_back("Workers", workers, Averaged::False);
+		m.emplace_back("Connected peers", peers, Averaged::True);
+		m.emplace_back("Pings/sec", pingsSent / testDuration, Averaged::False);
+		m.emplace_back("Suppressed pings/sec", pingsSuppressed / testDuration, Averaged::False);
+		m.emplace_back("Pings/sec/peer", peers ? pingsSent / testDuration / peers : 0.0, Averaged::True);
+	}
+};
+
+WorkloadFactory<ConnectionMonitorOverheadWorkload> ConnectionMonitorOverheadWorkloadFactory;
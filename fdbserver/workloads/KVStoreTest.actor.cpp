@@ -20,7 +20,9 @@
 
 #include <ctime>
 #include <cinttypes>
+#include <fstream>
 #include "fdbclient/FDBTypes.h"
+#include "fdbclient/zipf.h"
 #include "fmt/format.h"
 #include "fdbserver/ServerDBInfo.actor.h"
 #include "fdbserver/workloads/workloads.actor.h"
@@ -111,10 +113,15 @@ struct KVTest {
 	Map<Key, IndexedSet<Version, NoMetric>> allSets;
 	int nodeCount, keyBytes;
 	bool dispose;
+	bool zipfian;
 
-	explicit KVTest(int nodeCount, bool dispose, int keyBytes)
+	explicit KVTest(int nodeCount, bool dispose, int keyBytes, bool zipfian = false)
 	  : store(nullptr), startVersion(Version(time(nullptr)) << 30), lastSet(startVersion), lastCommit(startVersion),
-	    lastDurable(startVersion), nodeCount(nodeCount), keyBytes(keyBytes), dispose(dispose) {}
+	    lastDurable(startVersion), nodeCount(nodeCount), keyBytes(keyBytes), dispose(dispose), zipfian(zipfian) {
+		if (zipfian) {
+			zipfian_generator3(0, nodeCount - 1, ZIPFIAN_CONSTANT);
+		}
+	}
 	~KVTest() { close(); }
 	void close() {
 		if (store) {
@@ -145,7 +152,7 @@ struct KVTest {
 		s->value.insert(lastSet, NoMetric());
 	}
 
-	Key randomKey() { return makeKey(deterministicRandom()->randomInt(0, nodeCount)); }
+	Key randomKey() { return makeKey(zipfian ? zipfian_next() : deterministicRandom()->randomInt(0, nodeCount)); }
 	Key makeKey(Version value) {
 		Key k;
 		((KeyRef&)k) = KeyRef(new (k.arena()) uint8_t[keyBytes], keyBytes);
@@ -184,6 +191,14 @@ ACTOR Future<Void> testKVReadSaturation(KVTest* test, TestHistogram<float>* late
 	}
 }
 
+ACTOR Future<Void> testKVReadRange(KVTest* test, int rows, TestHistogram<float>* latency, PerfIntCounter* count) {
+	state double begin = timer();
+	RangeResult kv = wait(test->store->readRange(KeyRangeRef(test->randomKey(), "\xff\xff\xff\xff"_sr), rows));
+	latency->addSample(timer() - begin);
+	++*count;
+	return Void();
+}
+
 ACTOR Future<Void> testKVCommit(KVTest* test, TestHistogram<float>* latency, PerfIntCounter* count) {
 	state Version v = test->lastSet;
 	test->lastCommit = v;
@@ -197,26 +212,52 @@ ACTOR Future<Void> testKVCommit(KVTest* test, TestHistogram<float>* latency, Per
 
 Future<Void> testKVStore(struct KVStoreTestWorkload* const&);
 
+// Bytes this process has caused to be written to storage devices, or 0 if that isn't known
+static int64_t getProcessDiskWriteBytes() {
+#if defined(__linux__)
+	std::ifstream io("/proc/self/io");
+	std::string name;
+	int64_t value;
+	while (io >> name >> value) {
+		if (name == "write_bytes:") {
+			return value;
+		}
+	}
+#endif
+	return 0;
+}
+
 struct KVStoreTestWorkload : TestWorkload {
 	static constexpr auto NAME = "KVStoreTest";
 	bool enabled, saturation;
 	double testDuration, operationsPerSecond;
-	double commitFraction, setFraction;
-	int nodeCount, keyBytes, valueBytes;
+	double commitFraction, setFraction, rangeReadFraction;
+	int nodeCount, keyBytes, valueBytes, rangeReadRows;
+	bool zipfian;
 	bool doSetup, doClear, doCount;
 	std::string filename;
-	PerfIntCounter reads, sets, commits;
-	TestHistogram<float> readLatency, commitLatency;
+	PerfIntCounter reads, rangeReads, sets, commits;
+	TestHistogram<float> readLatency, rangeReadLatency, commitLatency;
 	double setupTook;
 	KeyValueStoreType storeType;
 
+	// Measured over the timed part of the test, for write amplification and the engine's memory and space overhead
+	int64_t diskWriteBytes = 0;
+	int64_t residentMemoryBytes = 0;
+	StorageBytes storageBytes;
+
 	KVStoreTestWorkload(WorkloadContext const& wcx)
-	  : TestWorkload(wcx), reads("Reads"), sets("Sets"), commits("Commits"), setupTook(0) {
+	  : TestWorkload(wcx), reads("Reads"), rangeReads("RangeReads"), sets("Sets"), commits("Commits"), setupTook(0) {
 		enabled = !clientId; // only do this on the "first" client
 		testDuration = getOption(options, "testDuration"_sr, 10.0);
 		operationsPerSecond = getOption(options, "operationsPerSecond"_sr, 100e3);
 		commitFraction = getOption(options, "commitFraction"_sr, .001);
 		setFraction = getOption(options, "setFraction"_sr, .1);
+		// Of the remaining operations, the fraction which read rangeReadRows rows rather than a single key
+		rangeReadFraction = getOption(options, "rangeReadFraction"_sr, 0.0);
+		rangeReadRows = getOption(options, "rangeReadRows"_sr, 100);
+		// uniform or zipfian
+		zipfian = getOption(options, "keyDistribution"_sr, "uniform"_sr) == "zipfian"_sr;
 		nodeCount = getOption(options, "nodeCount"_sr, 100000);
 		keyBytes = getOption(options, "keyBytes"_sr, 8);
 		valueBytes = getOption(options, "valueBytes"_sr, 8);
@@ -239,6 +280,7 @@ struct KVStoreTestWorkload : TestWorkload {
 		m.emplace_back("Average " + name, 1000.0 * h.mean(), Averaged::True);
 		m.emplace_back("Median " + name, 1000.0 * h.medianEstimate(), Averaged::True);
 		m.emplace_back("95%% " + name, 1000.0 * h.percentileEstimate(0.95), Averaged::True);
+		m.emplace_back("99%% " + name, 1000.0 * h.percentileEstimate(0.99), Averaged::True);
 		m.emplace_back("Max " + name, 1000.0 * h.max(), Averaged::True);
 	}
 	void getMetrics(std::vector<PerfMetric>& m) override {
@@ -246,10 +288,25 @@ struct KVStoreTestWorkload : TestWorkload {
 			m.emplace_back("SetupTook", setupTook, Averaged::False);
 
 		m.push_back(reads.getMetric());
+		m.push_back(rangeReads.getMetric());
 		m.push_back(sets.getMetric());
 		m.push_back(commits.getMetric());
+		if (testDuration > 0) {
+			m.emplace_back("Reads/sec", reads.getValue() / testDuration, Averaged::False);
+			m.emplace_back("RangeReads/sec", rangeReads.getValue() / testDuration, Averaged::False);
+			m.emplace_back("Sets/sec", sets.getValue() / testDuration, Averaged::False);
+			m.emplace_back("Commits/sec", commits.getValue() / testDuration, Averaged::False);
+		}
 		metricsFromHistogram(m, "Read Latency (ms)", readLatency);
+		metricsFromHistogram(m, "Range Read Latency (ms)", rangeReadLatency);
 		metricsFromHistogram(m, "Commit Latency (ms)", commitLatency);
+
+		int64_t logicalBytesWritten = sets.getValue() * (keyBytes + valueBytes);
+		if (logicalBytesWritten > 0 && diskWriteBytes > 0) {
+			m.emplace_back("Write Amplification", (double)diskWriteBytes / logicalBytesWritten, Averaged::False);
+		}
+		m.emplace_back("Resident Memory (MB)", residentMemoryBytes / 1e6, Averaged::False);
+		m.emplace_back("Storage Used (MB)", storageBytes.used / 1e6, Averaged::False);
 	}
 };
 
@@ -304,6 +361,7 @@ ACTOR Future<Void> testKVStoreMain(KVStoreTestWorkload* workload, KVTest* ptest)
 		TraceEvent("KVStoreSetup").detail("Count", workload->nodeCount).detail("Took", workload->setupTook);
 	}
 
+	state int64_t diskWriteBytesBegin = getProcessDiskWriteBytes();
 	state double t = now();
 	state double stopAt = t + workload->testDuration;
 	if (workload->saturation) {
@@ -347,6 +405,10 @@ ACTOR Future<Void> testKVStoreMain(KVStoreTestWorkload* workload, KVTest* ptest)
 					wr.serializeBytes(extraValue, extraBytes);
 					test.set(KeyValueRef(test.randomKey(), wr.toValue()));
 					++workload->sets;
+				} else if (deterministicRandom()->random01() < workload->rangeReadFraction) {
+					// Range read
+					ac.add(testKVReadRange(
+					    &test, workload->rangeReadRows, &workload->rangeReadLatency, &workload->rangeReads));
 				} else {
 					// Read
 					ac.add(testKVRead(&test, test.randomKey(), &workload->readLatency, &workload->reads));
@@ -358,6 +420,17 @@ ACTOR Future<Void> testKVStoreMain(KVStoreTestWorkload* workload, KVTest* ptest)
 		}
 	}
 
+	// Sets which haven't been committed don't count towards write amplification
+	while (workload->commits.getValue() < commitsStarted) {
+		wait(delay(0.001));
+	}
+	if (workload->sets.getValue()) {
+		wait(testKVCommit(&test, &workload->commitLatency, &workload->commits));
+	}
+	workload->diskWriteBytes = getProcessDiskWriteBytes() - diskWriteBytesBegin;
+	workload->residentMemoryBytes = getResidentMemoryUsage();
+	workload->storageBytes = test.store->getStorageBytes();
+
 	if (workload->doClear) {
 		state int chunk = 1000000;
 		t = timer();
@@ -372,7 +445,7 @@ ACTOR Future<Void> testKVStoreMain(KVStoreTestWorkload* workload, KVTest* ptest)
 }
 
 ACTOR Future<Void> testKVStore(KVStoreTestWorkload* workload) {
-	state KVTest test(workload->nodeCount, !workload->filename.size(), workload->keyBytes);
+	state KVTest test(workload->nodeCount, !workload->filename.size(), workload->keyBytes, workload->zipfian);
 	state Error err;
 
 	// wait( delay(1) );
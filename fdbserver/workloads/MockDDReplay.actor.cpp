@@ -0,0 +1,425 @@
+/*
+ * MockDDReplay.actor.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbclient/JSONDoc.h"
+#include "fdbclient/ManagementAPI.actor.h"
+#include "fdbclient/Status.h"
+#include "fdbserver/workloads/MockDDTest.h"
+#include "fdbserver/MockDataDistributor.h"
+#include "fdbserver/DDTxnProcessor.h"
+#include "flow/actorcompiler.h" // This must be the last #include.
+
+// Replays a cluster snapshot against the mock data distributor, so DD tuning can be benchmarked offline. The storage
+// servers, their localities and disk capacity come from a `status json` snapshot. The shards come from an export of the
+// form
+//   { "shards": [ { "begin": "<printable key>", "end": "<printable key>", "shard_bytes": N, "servers": [ids] } ] }
+// where ids are matched on the first 64 bits, which is all `status json` reports. Ranges the export does not cover
+// stay with the team of the shard before them. Without a snapshot, the workload replays the generated cluster and data
+// of MockDDTestWorkload instead.
+//
+// The simulator runs DD on virtual time, so a replay covering hours of cluster time takes minutes. The workload reports
+// how long data movement takes to settle, how many bytes it moved and how balanced the servers end up.
+
+struct ReplayServer {
+	StorageServerInterface ssi;
+	int64_t usedBytes = 0;
+	int64_t availableBytes = 0;
+};
+
+struct ReplayShard {
+	KeyRange range;
+	int64_t bytes = 0;
+	std::vector<UID> servers;
+};
+
+struct ClusterSnapshot {
+	std::string redundancyMode;
+	std::vector<ReplayServer> servers;
+	std::vector<ReplayShard> shards;
+};
+
+static UID parseReplayServerId(const std::string& id) {
+	return UID(std::stoull(id.substr(0, 16), nullptr, 16), 0);
+}
+
+static int64_t jsonToInt64(const json_spirit::mValue& v) {
+	return v.type() == json_spirit::real_type ? static_cast<int64_t>(v.get_real()) : v.get_int64();
+}
+
+// Reads the redundancy mode and the storage servers out of a `status json` document
+static void parseStatusSnapshot(const std::string& text, ClusterSnapshot& snapshot) {
+	try {
+		json_spirit::mObject status = readJSONStrictly(text).get_obj();
+		JSONDoc doc(status);
+		doc.tryGet("cluster.configuration.redundancy_mode", snapshot.redundancyMode);
+		if (!doc.has("cluster.processes")) {
+			return;
+		}
+		for (const auto& [_, processValue] : doc.last().get_obj()) {
+			JSONDoc process(processValue);
+			LocalityData locality;
+			if (process.has("locality")) {
+				for (const auto& [key, value] : process.last().get_obj()) {
+					if (value.type() == json_spirit::str_type) {
+						locality.set(StringRef(key), Standalone<StringRef>(StringRef(value.get_str())));
+					}
+				}
+			}
+			if (!process.has("roles")) {
+				continue;
+			}
+			for (const auto& roleValue : process.last().get_array()) {
+				JSONDoc role(roleValue);
+				std::string roleName, id;
+				if (!role.tryGet("role", roleName) || roleName != "storage" || !role.tryGet("id", id)) {
+					continue;
+				}
+				ReplayServer server;
+				server.ssi = StorageServerInterface(parseReplayServerId(id));
+				server.ssi.locality = locality;
+				if (role.has("kvstore_used_bytes")) {
+					server.usedBytes = jsonToInt64(role.last());
+				}
+				if (role.has("kvstore_available_bytes")) {
+					server.availableBytes = jsonToInt64(role.last());
+				}
+				snapshot.servers.push_back(server);
+			}
+		}
+	} catch (Error&) {
+		throw;
+	} catch (std::exception&) {
+		throw json_malformed();
+	}
+}
+
+// Reads the shard boundaries, sizes and teams out of a shard metrics export
+static void parseShardSnapshot(const std::string& text, ClusterSnapshot& snapshot) {
+	try {
+		json_spirit::mObject shards = readJSONStrictly(text).get_obj();
+		JSONDoc doc(shards);
+		if (!doc.has("shards")) {
+			return;
+		}
+		for (const auto& shardValue : doc.last().get_array()) {
+			JSONDoc shardDoc(shardValue);
+			std::string begin, end;
+			if (!shardDoc.tryGet("begin", begin) || !shardDoc.tryGet("end", end)) {
+				throw json_malformed();
+			}
+			ReplayShard shard;
+			shard.range = KeyRangeRef(KeyRef(unprintable(begin)), KeyRef(unprintable(end)));
+			if (shardDoc.has("shard_bytes")) {
+				shard.bytes = jsonToInt64(shardDoc.last());
+			}
+			if (shardDoc.has("servers")) {
+				for (const auto& id : shardDoc.last().get_array()) {
+					shard.servers.push_back(parseReplayServerId(id.get_str()));
+				}
+			}
+			snapshot.shards.push_back(shard);
+		}
+	} catch (Error&) {
+		throw;
+	} catch (std::exception&) {
+		throw json_malformed();
+	}
+}
+
+// Makes `mgs` hold the servers and shards of the snapshot. Each shard's bytes are written as up to `maxKeysPerShard`
+// keys of at least `minKeyBytes`, so that DD's byte sample sees the shard at its real size and can still split it.
+static void loadClusterSnapshot(MockGlobalState& mgs,
+                                const ClusterSnapshot& snapshot,
+                                int maxKeysPerShard,
+                                int64_t minKeyBytes) {
+	if (!snapshot.redundancyMode.empty()) {
+		std::map<std::string, std::string> conf;
+		if (buildConfiguration(snapshot.redundancyMode, conf) != ConfigurationResult::SUCCESS) {
+			TraceEvent(SevError, "MockDDReplayUnknownRedundancyMode").detail("Mode", snapshot.redundancyMode);
+			throw invalid_option_value();
+		}
+		for (const auto& [key, value] : conf) {
+			mgs.configuration.set(key, value);
+		}
+	}
+
+	for (const auto& server : snapshot.servers) {
+		uint64_t diskSpace = server.usedBytes + server.availableBytes;
+		mgs.addStorageServer(server.ssi, diskSpace > 0 ? diskSpace : MockStorageServer::DEFAULT_DISK_SPACE);
+	}
+
+	auto assignShard = [&](KeyRangeRef range, const std::vector<UID>& team, int64_t bytes) {
+		mgs.shardMapping->assignRangeToTeams(range, { MockGlobalState::Team(team, true) });
+		for (const auto& id : team) {
+			mgs.allServers.at(id)->serverKeys.insert(range, { MockShardStatus::COMPLETED, 0 });
+		}
+		if (bytes <= 0) {
+			return;
+		}
+		int64_t keyCount = std::clamp<int64_t>(bytes / std::max<int64_t>(minKeyBytes, 1), 1, maxKeysPerShard);
+		int valueBytes = std::min<int64_t>(bytes / keyCount, std::numeric_limits<int>::max());
+		for (int64_t i = 0; i < keyCount; ++i) {
+			Key key = randomKeyBetween(range);
+			if (!range.contains(key)) {
+				key = range.begin;
+			}
+			mgs.set(key, valueBytes, true);
+		}
+	};
+
+	std::vector<ReplayShard> shards = snapshot.shards;
+	std::sort(shards.begin(), shards.end(), [](const ReplayShard& a, const ReplayShard& b) {
+		return a.range.begin < b.range.begin;
+	});
+
+	std::vector<UID> lastTeam;
+	for (auto& shard : shards) {
+		std::vector<UID> team;
+		for (const auto& id : shard.servers) {
+			if (mgs.allServers.count(id)) {
+				team.push_back(id);
+			} else {
+				TraceEvent(SevWarnAlways, "MockDDReplayUnknownServer")
+				    .detail("Server", id)
+				    .detail("Range", shard.range);
+			}
+		}
+		std::sort(team.begin(), team.end());
+		team.erase(std::unique(team.begin(), team.end()), team.end());
+		shard.servers = team;
+		if (lastTeam.empty()) {
+			lastTeam = team;
+		}
+	}
+	if (lastTeam.empty()) {
+		TraceEvent(SevError, "MockDDReplayNoShardTeam").detail("Shards", shards.size());
+		throw invalid_option_value();
+	}
+
+	Key cursor = allKeys.begin;
+	for (const auto& shard : shards) {
+		KeyRange range = shard.range & allKeys;
+		if (range.begin < cursor) {
+			range = KeyRangeRef(std::min<KeyRef>(cursor, range.end), range.end);
+		}
+		if (range.empty()) {
+			continue;
+		}
+		if (cursor < range.begin) {
+			assignShard(KeyRangeRef(cursor, range.begin), lastTeam, 0);
+		}
+		if (!shard.servers.empty()) {
+			lastTeam = shard.servers;
+		}
+		assignShard(range, lastTeam, shard.bytes);
+		cursor = range.end;
+	}
+	if (cursor < allKeys.end) {
+		assignShard(KeyRangeRef(cursor, allKeys.end), lastTeam, 0);
+	}
+
+	TraceEvent("MockDDReplaySnapshotLoaded")
+	    .detail("RedundancyMode", snapshot.redundancyMode)
+	    .detail("Servers", snapshot.servers.size())
+	    .detail("Shards", shards.size());
+}
+
+class MockDDReplayWorkload : public MockDDTestWorkload {
+public:
+	static constexpr auto NAME = "MockDDReplay";
+	Reference<DDSharedContext> ddcx;
+	Reference<DDMockTxnProcessor> mock;
+	MockDataDistributor dataDistributor;
+	ActorCollection actors;
+
+	// --- test configs ---
+
+	std::string statusJsonFile; // `status json` of the cluster to replay
+	std::string shardMetricsFile; // shard boundaries, sizes and teams of the cluster to replay
+	int maxKeysPerShard = 16;
+	int64_t minKeyBytes = 1 << 20;
+	double reportInterval = 10.0;
+	// data movement counts as settled once fewer bytes than this move in a report interval
+	int64_t settledBytesPerInterval = 0;
+
+	// --- results ---
+
+	double startTime = 0;
+	double convergenceTime = -1;
+	int64_t bytesMoved = 0;
+	double initialImbalance = 0, finalImbalance = 0;
+
+	explicit MockDDReplayWorkload(WorkloadContext const& wcx)
+	  : MockDDTestWorkload(wcx),
+	    ddcx(makeReference<DDSharedContext>(
+	        DataDistributorInterface(LocalityData(), deterministicRandom()->randomUniqueID()))) {
+		statusJsonFile = getOption(options, "statusJsonFile"_sr, ""_sr).toString();
+		shardMetricsFile = getOption(options, "shardMetricsFile"_sr, ""_sr).toString();
+		maxKeysPerShard = getOption(options, "maxKeysPerShard"_sr, maxKeysPerShard);
+		minKeyBytes = getOption(options, "minKeyBytes"_sr, minKeyBytes);
+		reportInterval = getOption(options, "reportInterval"_sr, reportInterval);
+		settledBytesPerInterval = getOption(options, "settledBytesPerInterval"_sr, settledBytesPerInterval);
+	}
+
+	Future<Void> setup(Database const& cx) override {
+		if (!enabled)
+			return Void();
+		if (statusJsonFile.empty() || shardMetricsFile.empty()) {
+			MockDDTestWorkload::setup(cx);
+			populateMgs();
+		} else {
+			ClusterSnapshot snapshot;
+			parseStatusSnapshot(readFileBytes(statusJsonFile, std::numeric_limits<int>::max()), snapshot);
+			parseShardSnapshot(readFileBytes(shardMetricsFile, std::numeric_limits<int>::max()), snapshot);
+
+			sharedMgs = std::make_shared<MockGlobalState>();
+			sharedMgs->maxByteSize = maxByteSize;
+			sharedMgs->minByteSize = minByteSize;
+			sharedMgs->configuration = generateSimulationConfig().db;
+			loadClusterSnapshot(*sharedMgs, snapshot, maxKeysPerShard, minKeyBytes);
+		}
+		mock = makeReference<DDMockTxnProcessor>(sharedMgs);
+		return Void();
+	}
+
+	// the fullest server's bytes over the mean, 1.0 being perfectly balanced
+	double imbalance() const {
+		int64_t total = 0, maxBytes = 0;
+		for (const auto& [_, server] : sharedMgs->allServers) {
+			total += server->usedDiskSpace;
+			maxBytes = std::max<int64_t>(maxBytes, server->usedDiskSpace);
+		}
+		if (total == 0) {
+			return 1.0;
+		}
+		return maxBytes * static_cast<double>(sharedMgs->allServers.size()) / total;
+	}
+
+	int64_t totalBytesFetched() const {
+		int64_t total = 0;
+		for (const auto& [_, server] : sharedMgs->allServers) {
+			total += server->getBytesFetched();
+		}
+		return total;
+	}
+
+	ACTOR static Future<Void> reportProgress(MockDDReplayWorkload* self) {
+		state int64_t lastFetched = 0;
+		loop {
+			wait(delay(self->reportInterval));
+			int64_t fetched = self->totalBytesFetched();
+			double elapsed = now() - self->startTime;
+			if (fetched - lastFetched > self->settledBytesPerInterval) {
+				// still moving, so whatever balance we had before did not hold
+				self->convergenceTime = -1;
+			} else if (self->convergenceTime < 0) {
+				self->convergenceTime = elapsed - self->reportInterval;
+			}
+			lastFetched = fetched;
+			self->bytesMoved = fetched;
+			self->finalImbalance = self->imbalance();
+
+			TraceEvent("MockDDReplayProgress")
+			    .detail("Elapsed", elapsed)
+			    .detail("BytesMoved", fetched)
+			    .detail("Imbalance", self->finalImbalance)
+			    .detail("ConvergenceTime", self->convergenceTime);
+		}
+	}
+
+	Future<Void> start(Database const& cx) override {
+		if (!enabled)
+			return Void();
+
+		startTime = now();
+		initialImbalance = finalImbalance = imbalance();
+		// start mock servers
+		actors.add(waitForAll(sharedMgs->runAllMockServers()));
+		// start data distributor
+		actors.add(dataDistributor.run(ddcx, mock));
+		actors.add(reportProgress(this));
+
+		return delay(testDuration);
+	}
+
+	Future<bool> check(Database const& cx) override { return true; }
+
+	void getMetrics(std::vector<PerfMetric>& m) override {
+		if (!enabled)
+			return;
+		// -1 means data was still moving when the test ended
+		m.emplace_back("Convergence Time (s)", convergenceTime, Averaged::False);
+		m.emplace_back("Bytes Moved", bytesMoved, Averaged::False);
+		m.emplace_back("Initial Imbalance", initialImbalance, Averaged::False);
+		m.emplace_back("Final Imbalance", finalImbalance, Averaged::False);
+	}
+};
+
+WorkloadFactory<MockDDReplayWorkload> MockDDReplayWorkloadFactory;
+
+TEST_CASE("/MockDDReplay/LoadClusterSnapshot") {
+	const std::string status = R"({"cluster": {
+		"configuration": {"redundancy_mode": "double"},
+		"processes": {
+			"p1": {"locality": {"processid": "p1", "zoneid": "z1", "machineid": "m1"},
+			       "roles": [{"role": "storage", "id": "0000000000000001",
+			                  "kvstore_used_bytes": 1000, "kvstore_available_bytes": 9000}]},
+			"p2": {"locality": {"processid": "p2", "zoneid": "z2", "machineid": "m2"},
+			       "roles": [{"role": "storage", "id": "0000000000000002",
+			                  "kvstore_used_bytes": 1000, "kvstore_available_bytes": 9000},
+			                 {"role": "log", "id": "0000000000000009"}]},
+			"p3": {"locality": {"processid": "p3", "zoneid": "z3", "machineid": "m3"},
+			       "roles": [{"role": "storage", "id": "00000000000000030000000000000003"}]}
+		}}})";
+	const std::string shards = R"({"shards": [
+		{"begin": "b", "end": "m", "shard_bytes": 3000000, "servers": ["0000000000000002", "0000000000000001"]},
+		{"begin": "m", "end": "\\xff", "shard_bytes": 1000, "servers": ["0000000000000003", "0000000000000004"]}
+	]})";
+
+	ClusterSnapshot snapshot;
+	parseStatusSnapshot(status, snapshot);
+	parseShardSnapshot(shards, snapshot);
+	ASSERT(snapshot.redundancyMode == "double");
+	ASSERT_EQ(snapshot.servers.size(), 3);
+	ASSERT_EQ(snapshot.shards.size(), 2);
+	ASSERT(snapshot.shards[1].range.end == "\xff"_sr);
+
+	MockGlobalState mgs;
+	loadClusterSnapshot(mgs, snapshot, 4, 1 << 20);
+	ASSERT_EQ(mgs.configuration.storageTeamSize, 2);
+	ASSERT_EQ(mgs.allServers.size(), 3);
+
+	UID s1(1, 0), s2(2, 0), s3(3, 0);
+	ASSERT(mgs.allServers.at(s2)->ssi.locality.zoneId().get() == "z2"_sr);
+	ASSERT_EQ(mgs.allServers.at(s1)->totalDiskSpace, 10000);
+
+	// the range before the first shard goes to the first team, the unknown server is dropped
+	std::vector<UID> firstTeam{ s1, s2 };
+	ASSERT(mgs.shardMapping->getSourceServerIdsFor(""_sr) == firstTeam);
+	ASSERT(mgs.shardMapping->getSourceServerIdsFor("c"_sr) == firstTeam);
+	ASSERT(mgs.shardMapping->getSourceServerIdsFor("x"_sr) == std::vector<UID>{ s3 });
+
+	KeyRangeRef shardRange("b"_sr, "m"_sr);
+	ASSERT_GE(mgs.allServers.at(s1)->sumRangeSize(shardRange), 3000000);
+	ASSERT_GE(mgs.allServers.at(s2)->sumRangeSize(shardRange), 3000000);
+	ASSERT_EQ(mgs.allServers.at(s3)->sumRangeSize(shardRange), 0);
+	ASSERT(mgs.allServers.at(s1)->allShardStatusEqual(shardRange, MockShardStatus::COMPLETED));
+	return Void();
+}
@@ -104,16 +104,20 @@ void MockDDTestWorkload::populateMgs() {
 	fmt::print("MGS Populated.\n");
 }
 
-Future<Void> MockDDTestWorkload::setup(Database const& cx) {
-	if (!enabled)
-		return Void();
-	// initialize configuration
+BasicSimulationConfig MockDDTestWorkload::generateSimulationConfig() const {
 	BasicTestConfig testConfig;
 	testConfig.simpleConfig = simpleConfig;
 	testConfig.minimumReplication = 1;
 	testConfig.logAntiQuorum = 0;
 	testConfig.singleRegion = true;
-	BasicSimulationConfig dbConfig = generateBasicSimulationConfig(testConfig);
+	return generateBasicSimulationConfig(testConfig);
+}
+
+Future<Void> MockDDTestWorkload::setup(Database const& cx) {
+	if (!enabled)
+		return Void();
+	// initialize configuration
+	BasicSimulationConfig dbConfig = generateSimulationConfig();
 
 	// initialize sharedMgs
 	sharedMgs = std::make_shared<MockGlobalState>();
@@ -122,7 +122,7 @@ struct SpecialKeySpaceCorrectnessWorkload : TestWorkload {
 		testRywLifetime(cx);
 		wait(timeout(self->testSpecialKeySpaceErrors(cx, self) && self->getRangeCallActor(cx, self) &&
 		                 testConflictRanges(cx, /*read*/ true, self) && testConflictRanges(cx, /*read*/ false, self) &&
-		                 self->metricsApiCorrectnessActor(cx, self),
+		                 self->metricsApiCorrectnessActor(cx, self) && testTransactionTimeline(cx, self),
 		             self->testDuration,
 		             Void()));
 		// Only use one client to avoid potential conflicts on changing cluster configuration
@@ -792,6 +792,38 @@ struct SpecialKeySpaceCorrectnessWorkload : TestWorkload {
 		return true;
 	}
 
+	ACTOR static Future<Void> testTransactionTimeline(Database cx_, SpecialKeySpaceCorrectnessWorkload* self) {
+		state Database cx = cx_->clone();
+		state Reference<ReadYourWritesTransaction> tx = makeReference<ReadYourWritesTransaction>(cx);
+		state Key key = "specialKeySpaceTimeline/"_sr.withSuffix(std::to_string(self->clientId));
+		loop {
+			try {
+				tx->setOption(FDBTransactionOptions::RAW_ACCESS);
+				tx->setOption(FDBTransactionOptions::RECORD_TIMELINE);
+				wait(success(tx->get(key)));
+				tx->set(key, "1"_sr);
+				wait(tx->commit());
+				break;
+			} catch (Error& e) {
+				wait(tx->onError(e));
+			}
+		}
+		// The timeline is still readable once the transaction has committed
+		RangeResult timeline = wait(tx->getRange(transactionTimelineRange, CLIENT_KNOBS->TOO_MANY));
+		ASSERT(!timeline.empty());
+		std::set<std::string> names;
+		for (const auto& kv : timeline) {
+			auto eventObj = readJSONStrictly(kv.value.toString()).get_obj();
+			names.insert(eventObj["name"].get_str());
+		}
+		if (!names.count("dropped_events")) {
+			ASSERT(names.count("get_read_version"));
+			ASSERT(names.count("get_value"));
+			ASSERT(names.count("commit"));
+		}
+		return Void();
+	}
+
 	ACTOR Future<Void> managementApiCorrectnessActor(Database cx_, SpecialKeySpaceCorrectnessWorkload* self) {
 		// All management api related tests that cannot run with failure injections
 		state Database cx = cx_->clone();
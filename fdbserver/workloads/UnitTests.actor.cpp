@@ -24,9 +24,12 @@
 
 void forceLinkIndexedSetTests();
 void forceLinkDequeTests();
+void forceLinkTimerWheelTests();
+void forceLinkBinaryTraceLogFormatterTests();
 void forceLinkFlowTests();
 void forceLinkCoroTests();
 void forceLinkVersionedMapTests();
+void forceLinkVersionedBatchMapTests();
 void forceLinkMemcpyTests();
 void forceLinkMemcpyPerfTests();
 void forceLinkStreamCipherTests();
@@ -95,9 +98,12 @@ struct UnitTestWorkload : TestWorkload {
 
 		forceLinkIndexedSetTests();
 		forceLinkDequeTests();
+		forceLinkTimerWheelTests();
+		forceLinkBinaryTraceLogFormatterTests();
 		forceLinkFlowTests();
 		forceLinkCoroTests();
 		forceLinkVersionedMapTests();
+		forceLinkVersionedBatchMapTests();
 		forceLinkMemcpyTests();
 		forceLinkMemcpyPerfTests();
 		forceLinkStreamCipherTests();
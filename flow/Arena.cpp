@@ -152,6 +152,16 @@ size_t Arena::getSize(FastInaccurateEstimate fastInaccurateEstimate) const {
 	return 0;
 }
 
+size_t Arena::getUsedEstimate() const {
+	if (impl) {
+		allowAccess(impl.getPtr());
+		size_t result = impl->estimatedTotalSize() - impl->unused();
+		disallowAccess(impl.getPtr());
+		return result;
+	}
+	return 0;
+}
+
 bool Arena::hasFree(size_t size, const void* address) {
 	if (impl) {
 		allowAccess(impl.getPtr());
@@ -344,6 +354,13 @@ void* ArenaBlock::allocate(Reference<ArenaBlock>& self, int bytes, IsSecureMem i
 	return result;
 }
 
+// Tiny blocks are left out of the arena profile: they have no room to be marked as sampled.
+static void maybeSampleArenaBlock(ArenaBlock* b) {
+	if (arenaProfilerShouldSample(b->size()) && arenaProfilerRecordAllocation(b)) {
+		b->tinyUsed = ArenaBlock::NOT_TINY_SAMPLED;
+	}
+}
+
 // Return an appropriately-sized ArenaBlock to store the given data
 ArenaBlock* ArenaBlock::create(int dataSize, Reference<ArenaBlock>& next) {
 	ArenaBlock* b;
@@ -434,6 +451,7 @@ ArenaBlock* ArenaBlock::create(int dataSize, Reference<ArenaBlock>& next) {
 			// If the new block has less free space than the old block, make the old block depend on it
 			if (next && !next->isTiny() && next->unused() >= reqSize - dataSize) {
 				b->nextBlockOffset = 0;
+				maybeSampleArenaBlock(b);
 				b->setrefCountUnsafe(1);
 				next->makeReference(b);
 				return b;
@@ -442,6 +460,7 @@ ArenaBlock* ArenaBlock::create(int dataSize, Reference<ArenaBlock>& next) {
 		b->nextBlockOffset = 0;
 		if (next)
 			b->makeReference(next.getPtr());
+		maybeSampleArenaBlock(b);
 	}
 	b->setrefCountUnsafe(1);
 	next.setPtrUnsafe(b);
@@ -490,6 +509,9 @@ void ArenaBlock::destroyLeaf() {
 	if (secure) {
 		wipeUsed();
 	}
+	if (!isTiny() && tinyUsed == NOT_TINY_SAMPLED) {
+		arenaProfilerRecordRelease(this);
+	}
 	if (isTiny()) {
 		if (tinySize <= 32) {
 			FastAllocator<32>::release(this);
@@ -1039,3 +1061,87 @@ TEST_CASE("/flow/Arena/Secure") {
 	}
 	return Void();
 }
+
+#if defined(FLOW_DISPATCH_AVX2)
+const bool g_cpuHasAVX2 = []() {
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+}();
+
+__attribute__((target("avx2"))) int commonPrefixLengthAVX2(uint8_t const* ap, uint8_t const* bp, int cl) {
+	int i = 0;
+	for (; i + 32 <= cl; i += 32) {
+		__m256i a = _mm256_loadu_si256((const __m256i*)(ap + i));
+		__m256i b = _mm256_loadu_si256((const __m256i*)(bp + i));
+		uint32_t diff = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b));
+		if (diff != 0) {
+			return i + ctzll(diff);
+		}
+	}
+	// Less than 32 bytes are left, which the inline version compares without dispatching again
+	return i + commonPrefixLength(ap + i, bp + i, cl - i);
+}
+#endif
+
+// Checks the vectorized common prefix against a byte at a time comparison, with mismatches in every lane position
+TEST_CASE("/flow/Arena/commonPrefixLength") {
+	std::vector<uint8_t> a(300), b(300);
+	for (int iter = 0; iter < 10000; ++iter) {
+		int len = deterministicRandom()->randomInt(0, a.size());
+		int offset = deterministicRandom()->randomInt(0, a.size() - len + 1);
+		for (int i = 0; i < len; ++i) {
+			a[offset + i] = b[offset + i] = deterministicRandom()->randomInt(0, 256);
+		}
+		int expected = len;
+		if (len > 0 && deterministicRandom()->coinflip()) {
+			expected = deterministicRandom()->randomInt(0, len);
+			b[offset + expected] = a[offset + expected] ^ (1 << deterministicRandom()->randomInt(0, 8));
+		}
+		ASSERT_EQ(commonPrefixLength(a.data() + offset, b.data() + offset, len), expected);
+
+		StringRef sa(a.data() + offset, len);
+		StringRef sb(b.data() + offset, deterministicRandom()->randomInt(0, len + 1));
+		ASSERT_EQ(commonPrefixLength(sa, sb), std::min(expected, sb.size()));
+	}
+	return Void();
+}
+
+TEST_CASE("/flow/Arena/AdaptiveArenaSize") {
+	AdaptiveArenaSize arenaSize;
+	auto fill = [](Arena& arena, int bytes) {
+		for (int i = 0; i < bytes; i += 100) {
+			new (arena) uint8_t[100];
+		}
+	};
+
+	for (int i = 0; i < 20; ++i) {
+		Arena arena = arenaSize.makeArena();
+		fill(arena, 3000);
+		arenaSize.observe(arena);
+	}
+	ASSERT_GE(arenaSize.reserved(), 3000);
+
+	// Once the size is learned, everything fits in the first block
+	Arena arena = arenaSize.makeArena();
+	const size_t reserved = arena.getSize();
+	fill(arena, 3000);
+	ASSERT_EQ(arena.getSize(), reserved);
+
+	// Smaller arenas bring the estimate down, slowly
+	const int learned = arenaSize.reserved();
+	for (int i = 0; i < 100; ++i) {
+		Arena small = arenaSize.makeArena();
+		fill(small, 100);
+		arenaSize.observe(small);
+	}
+	ASSERT_LT(arenaSize.reserved(), learned / 2);
+
+	// Very large arenas are left to grow as before, rather than reserving huge blocks
+	for (int i = 0; i < 20; ++i) {
+		Arena large = arenaSize.makeArena();
+		fill(large, 100000);
+		arenaSize.observe(large);
+	}
+	ASSERT_LT(arenaSize.reserved(), (int)ArenaBlock::LARGE);
+	return Void();
+}
@@ -0,0 +1,91 @@
+/*
+ * BinaryTraceLogFormatter.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flow/flow.h"
+#include "flow/BinaryTraceLogFormatter.h"
+#include "flow/UnitTest.h"
+
+void BinaryTraceLogFormatter::addref() {
+	ReferenceCounted<BinaryTraceLogFormatter>::addref();
+}
+
+void BinaryTraceLogFormatter::delref() {
+	ReferenceCounted<BinaryTraceLogFormatter>::delref();
+}
+
+const char* BinaryTraceLogFormatter::getExtension() const {
+	return "bin";
+}
+
+const char* BinaryTraceLogFormatter::getHeader() const {
+	return "FDBTRACE1\n";
+}
+
+const char* BinaryTraceLogFormatter::getFooter() const {
+	return "";
+}
+
+namespace {
+
+void appendVarint(std::string& out, size_t value) {
+	while (value >= 0x80) {
+		out.push_back(char(0x80 | (value & 0x7f)));
+		value >>= 7;
+	}
+	out.push_back(char(value));
+}
+
+void appendString(std::string& out, const std::string& s) {
+	appendVarint(out, s.size());
+	out.append(s);
+}
+
+} // namespace
+
+std::string BinaryTraceLogFormatter::formatEvent(const TraceEventFields& fields) const {
+	std::string out;
+	// Two bytes of lengths per field is enough for all but the longest names and values
+	out.reserve(1 + fields.sizeBytes() + 2 * 2 * fields.size());
+	appendVarint(out, fields.size());
+	for (const auto& [name, value] : fields) {
+		appendString(out, name);
+		appendString(out, value);
+	}
+	return out;
+}
+
+void forceLinkBinaryTraceLogFormatterTests() {}
+
+TEST_CASE("/flow/BinaryTraceLogFormatter/formatEvent") {
+	TraceEventFields fields;
+	fields.addField("Type", "Test");
+	fields.addField("Empty", "");
+	fields.addField("Long", std::string(200, 'x'));
+
+	const std::string event = BinaryTraceLogFormatter().formatEvent(fields);
+	ASSERT(event.size() == 1 + (1 + 4 + 1 + 4) + (1 + 5 + 1) + (1 + 4 + 2 + 200));
+	ASSERT(event.substr(0, 11) == std::string("\x03\x04Type\x04Test", 11));
+	ASSERT(event.substr(11, 7) == std::string("\x05" "Empty\x00", 7));
+	// 200 is 0b1'1001000: its low seven bits with the continuation bit, then 1
+	ASSERT(event.substr(18, 7) == std::string("\x04Long\xc8\x01", 7));
+	ASSERT(event.substr(25) == std::string(200, 'x'));
+
+	return Void();
+}
@@ -25,13 +25,29 @@
 #include "flow/IRandom.h"
 #include "flow/UnitTest.h"
 
+#include <memory>
+
 #ifdef ZSTD_LIB_SUPPORTED
 #define ZSTD_STATIC_LINKING_ONLY
 #include <zstd.h>
+#include <zdict.h>
 static constexpr int ZSTD_COMPRESSION_LEVEL_1 = 1;
 #endif
 
 namespace {
+#ifdef ZSTD_LIB_SUPPORTED
+// Setting up a context takes longer than compressing a small record, so each thread reuses one of each
+ZSTD_CCtx* threadCompressionContext() {
+	static thread_local std::unique_ptr<ZSTD_CCtx, size_t (*)(ZSTD_CCtx*)> cctx(ZSTD_createCCtx(), ZSTD_freeCCtx);
+	return cctx.get();
+}
+
+ZSTD_DCtx* threadDecompressionContext() {
+	static thread_local std::unique_ptr<ZSTD_DCtx, size_t (*)(ZSTD_DCtx*)> dctx(ZSTD_createDCtx(), ZSTD_freeDCtx);
+	return dctx.get();
+}
+#endif
+
 std::unordered_set<CompressionFilter> getSupportedFilters() {
 	std::unordered_set<CompressionFilter> filters;
 
@@ -72,7 +88,7 @@ StringRef CompressionUtils::compress(const CompressionFilter filter, const Strin
 		const char* src = reinterpret_cast<const char*>(data.begin());
 		size_t destSize = ZSTD_compressBound(data.size());
 		std::unique_ptr<uint8_t[]> dest = std::make_unique<uint8_t[]>(destSize);
-		size_t bytes = ZSTD_compress(dest.get(), destSize, src, data.size(), level);
+		size_t bytes = ZSTD_compressCCtx(threadCompressionContext(), dest.get(), destSize, src, data.size(), level);
 		if (ZSTD_isError(bytes)) {
 			throw internal_error();
 		}
@@ -93,7 +109,7 @@ StringRef CompressionUtils::decompress(const CompressionFilter filter, const Str
 		const char* src = reinterpret_cast<const char*>(data.begin());
 		size_t destSize = ZSTD_decompressBound(src, data.size());
 		std::unique_ptr<uint8_t[]> dest = std::make_unique<uint8_t[]>(destSize);
-		size_t bytes = ZSTD_decompress(dest.get(), destSize, src, data.size());
+		size_t bytes = ZSTD_decompressDCtx(threadDecompressionContext(), dest.get(), destSize, src, data.size());
 		if (ZSTD_isError(bytes)) {
 			throw internal_error();
 		}
@@ -103,6 +119,104 @@ StringRef CompressionUtils::decompress(const CompressionFilter filter, const Str
 	throw internal_error(); // We should never get here
 }
 
+StringRef CompressionUtils::compress(const CompressionDictionary& dictionary, const StringRef& data, Arena& arena) {
+#ifdef ZSTD_LIB_SUPPORTED
+	size_t destSize = ZSTD_compressBound(data.size());
+	std::unique_ptr<uint8_t[]> dest = std::make_unique<uint8_t[]>(destSize);
+	size_t bytes = ZSTD_compress_usingCDict(threadCompressionContext(),
+	                                        dest.get(),
+	                                        destSize,
+	                                        data.begin(),
+	                                        data.size(),
+	                                        static_cast<const ZSTD_CDict*>(dictionary.cdict));
+	if (ZSTD_isError(bytes)) {
+		throw internal_error();
+	}
+	return StringRef(arena, StringRef(dest.get(), bytes));
+#else
+	throw not_implemented();
+#endif
+}
+
+StringRef CompressionUtils::decompress(const CompressionDictionary& dictionary, const StringRef& data, Arena& arena) {
+#ifdef ZSTD_LIB_SUPPORTED
+	size_t destSize = ZSTD_decompressBound(data.begin(), data.size());
+	std::unique_ptr<uint8_t[]> dest = std::make_unique<uint8_t[]>(destSize);
+	size_t bytes = ZSTD_decompress_usingDDict(threadDecompressionContext(),
+	                                          dest.get(),
+	                                          destSize,
+	                                          data.begin(),
+	                                          data.size(),
+	                                          static_cast<const ZSTD_DDict*>(dictionary.ddict));
+	if (ZSTD_isError(bytes)) {
+		throw internal_error();
+	}
+	return StringRef(arena, StringRef(dest.get(), bytes));
+#else
+	throw not_implemented();
+#endif
+}
+
+uint32_t CompressionUtils::getDictionaryId(const StringRef& data) {
+#ifdef ZSTD_LIB_SUPPORTED
+	return ZSTD_getDictID_fromFrame(data.begin(), data.size());
+#else
+	throw not_implemented();
+#endif
+}
+
+Reference<CompressionDictionary> CompressionDictionary::train(const std::vector<StringRef>& samples,
+                                                              int maxSize,
+                                                              int level) {
+#ifdef ZSTD_LIB_SUPPORTED
+	std::string concatenated;
+	std::vector<size_t> sizes;
+	sizes.reserve(samples.size());
+	for (const auto& sample : samples) {
+		concatenated.append(reinterpret_cast<const char*>(sample.begin()), sample.size());
+		sizes.push_back(sample.size());
+	}
+	std::unique_ptr<uint8_t[]> buffer = std::make_unique<uint8_t[]>(maxSize);
+	size_t size = ZDICT_trainFromBuffer(buffer.get(), maxSize, concatenated.data(), sizes.data(), sizes.size());
+	if (ZDICT_isError(size)) {
+		return Reference<CompressionDictionary>();
+	}
+	return Reference<CompressionDictionary>(new CompressionDictionary(StringRef(buffer.get(), size), level));
+#else
+	throw not_implemented();
+#endif
+}
+
+Reference<CompressionDictionary> CompressionDictionary::load(const StringRef& bytes, int level) {
+	return Reference<CompressionDictionary>(new CompressionDictionary(bytes, level));
+}
+
+CompressionDictionary::CompressionDictionary(const StringRef& content, int level) : content(content) {
+#ifdef ZSTD_LIB_SUPPORTED
+	dictId = ZDICT_getDictID(content.begin(), content.size());
+	if (dictId == 0) {
+		// Not a dictionary zstd trained
+		throw internal_error();
+	}
+	cdict = ZSTD_createCDict(content.begin(), content.size(), level);
+	ddict = ZSTD_createDDict(content.begin(), content.size());
+	if (!cdict || !ddict) {
+		ZSTD_freeCDict(static_cast<ZSTD_CDict*>(cdict));
+		ZSTD_freeDDict(static_cast<ZSTD_DDict*>(ddict));
+		throw internal_error();
+	}
+#else
+	throw not_implemented();
+#endif
+}
+
+CompressionDictionary::~CompressionDictionary() {
+#ifdef ZSTD_LIB_SUPPORTED
+	ZSTD_freeCDict(static_cast<ZSTD_CDict*>(cdict));
+	ZSTD_freeDDict(static_cast<ZSTD_DDict*>(ddict));
+#endif
+}
+
 int CompressionUtils::getDefaultCompressionLevel(CompressionFilter filter) {
 	checkFilterSupported(filter);
 
@@ -206,4 +320,49 @@ TEST_CASE("/CompressionUtils/zstdCompression2") {
 
 	return Void();
 }
+
+TEST_CASE("/CompressionUtils/zstdDictionary") {
+	// Small records that share most of their structure, like JSON values under one key prefix
+	auto record = []() {
+		return format("{\"id\":%d,\"name\":\"user_%s\",\"status\":\"%s\",\"score\":%d,\"tags\":[\"%s\"]}",
+		              deterministicRandom()->randomInt(0, 1000000),
+		              deterministicRandom()->randomAlphaNumeric(8).c_str(),
+		              deterministicRandom()->coinflip() ? "active" : "suspended",
+		              deterministicRandom()->randomInt(0, 100),
+		              deterministicRandom()->coinflip() ? "standard" : "premium");
+	};
+	std::vector<Standalone<StringRef>> samples;
+	std::vector<StringRef> sampleRefs;
+	for (int i = 0; i < 2000; ++i) {
+		samples.push_back(Standalone<StringRef>(record()));
+		sampleRefs.push_back(samples.back());
+	}
+	Reference<CompressionDictionary> dictionary = CompressionDictionary::train(sampleRefs, 4096, 3);
+	ASSERT(dictionary.isValid());
+	ASSERT_NE(dictionary->id(), 0);
+
+	// A dictionary loaded from the stored bytes decompresses what the trained one compressed
+	Reference<CompressionDictionary> loaded = CompressionDictionary::load(dictionary->bytes(), 3);
+	ASSERT_EQ(loaded->id(), dictionary->id());
+
+	Arena arena;
+	int plainBytes = 0, dictionaryBytes = 0;
+	for (int i = 0; i < 100; ++i) {
+		Standalone<StringRef> uncompressed(record());
+		StringRef plain = CompressionUtils::compress(CompressionFilter::ZSTD, uncompressed, 3, arena);
+		StringRef compressed = CompressionUtils::compress(*dictionary, uncompressed, arena);
+		plainBytes += plain.size();
+		dictionaryBytes += compressed.size();
+		ASSERT_EQ(CompressionUtils::getDictionaryId(plain), 0);
+		ASSERT_EQ(CompressionUtils::getDictionaryId(compressed), dictionary->id());
+		ASSERT(CompressionUtils::decompress(*loaded, compressed, arena) == uncompressed);
+		ASSERT(CompressionUtils::decompress(CompressionFilter::ZSTD, plain, arena) == uncompressed);
+	}
+	ASSERT_LT(dictionaryBytes * 2, plainBytes);
+
+	// Too few samples to train from
+	ASSERT(!CompressionDictionary::train(std::vector<StringRef>(sampleRefs.begin(), sampleRefs.begin() + 2), 4096, 3)
+	            .isValid());
+	return Void();
+}
 #endif
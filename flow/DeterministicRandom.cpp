@@ -21,6 +21,9 @@
 #include "fmt/format.h"
 #include "flow/Arena.h"
 #include "flow/DeterministicRandom.h"
+#include "flow/FastRandom.h"
+#include "flow/Platform.h"
+#include "flow/UnitTest.h"
 
 #include <cstring>
 
@@ -151,3 +154,56 @@ void DeterministicRandom::addref() {
 void DeterministicRandom::delref() {
 	ReferenceCounted<DeterministicRandom>::delref();
 }
+
+uint64_t FastRandom::unseeded() {
+	return (uint64_t(platform::getRandomSeed()) << 32) ^ uint32_t(platform::getRandomSeed());
+}
+
+TEST_CASE("/flow/FastRandom") {
+	const uint64_t seed = deterministicRandom()->randomUInt64();
+	FastRandom a(seed), b(seed);
+
+	// The same seed gives the same sequence, and the batch forms continue it
+	uint64_t batch[17];
+	for (int i = 0; i < 100; ++i) {
+		ASSERT_EQ(a.randomUInt64(), b.randomUInt64());
+	}
+	a.randomUInt64s(batch, 17);
+	for (int i = 0; i < 17; ++i) {
+		ASSERT_EQ(batch[i], b.randomUInt64());
+	}
+	double batch01[5];
+	a.random01s(batch01, 5);
+	for (int i = 0; i < 5; ++i) {
+		ASSERT(batch01[i] == b.random01());
+	}
+	FastRandom c(seed + 1);
+	ASSERT_NE(a.randomUInt64(), c.randomUInt64());
+
+	for (int i = 0; i < 10000; ++i) {
+		const double d = a.random01();
+		ASSERT(d >= 0 && d < 1);
+		const int n = a.randomInt(-5, 3);
+		ASSERT(n >= -5 && n < 3);
+		ASSERT_EQ(a.randomInt(7, 8), 7);
+		const int extreme = a.randomInt(std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+		ASSERT_LT(extreme, std::numeric_limits<int>::max());
+		const int64_t n64 = a.randomInt64(-1000000000000LL, 5);
+		ASSERT(n64 >= -1000000000000LL && n64 < 5);
+	}
+
+	// Every value of a small range comes up about equally often
+	int counts[10] = {};
+	for (int i = 0; i < 100000; ++i) {
+		counts[a.randomInt(0, 10)]++;
+	}
+	for (int count : counts) {
+		ASSERT(count > 9000 && count < 11000);
+	}
+
+	uint8_t bytes[13] = {};
+	a.randomBytes(bytes, 13);
+	ASSERT(std::any_of(bytes + 8, bytes + 13, [](uint8_t x) { return x != 0; }));
+
+	return Void();
+}
@@ -28,8 +28,10 @@
 #include "crc32/crc32c.h"
 #include "flow/flow.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
+#include <mutex>
 #include <unordered_map>
 
 #ifdef WIN32
@@ -135,6 +137,119 @@ void hugeArenaSample(int size) {
 	}
 }
 
+thread_local int64_t g_arenaProfilerBytesUntilSample = 0;
+
+namespace {
+struct ArenaProfileSite {
+	int64_t allocations = 0; // Sampled since the profile was last logged
+	int64_t live = 0; // Sampled and not yet released
+};
+
+struct ArenaProfile {
+	std::mutex mutex;
+	std::unordered_map<std::string, ArenaProfileSite> sites; // By raw backtrace
+	std::unordered_map<const void*, ArenaProfileSite*> sampledBlocks;
+	int64_t sampleBytes = 0; // What each sample stood for when it was taken
+	double lastLogged = 0;
+};
+
+ArenaProfile& arenaProfile() {
+	static ArenaProfile* profile = new ArenaProfile();
+	return *profile;
+}
+} // namespace
+
+bool arenaProfilerRecordAllocation(const void* block) {
+	const int64_t sampleBytes = FLOW_KNOBS ? FLOW_KNOBS->ARENA_PROFILER_SAMPLE_BYTES : 0;
+	if (sampleBytes <= 0 || g_allocation_tracing_disabled > 0) {
+		// Look at the knob again after a while, in case it is changed at runtime
+		g_arenaProfilerBytesUntilSample = 100e6;
+		return false;
+	}
+	// Varying the interval keeps allocations that come in a fixed pattern from always or never being sampled
+	g_arenaProfilerBytesUntilSample = sampleBytes * (0.5 + nondeterministicRandom()->random01());
+
+	void* frames[30];
+	const size_t depth = platform::raw_backtrace(frames, 30);
+	std::string key(reinterpret_cast<const char*>(frames), depth * sizeof(void*));
+
+	auto& profile = arenaProfile();
+	std::lock_guard<std::mutex> lock(profile.mutex);
+	if (profile.sampleBytes != sampleBytes) {
+		// Samples taken at another rate would be scaled wrongly
+		for (auto& [_, site] : profile.sites) {
+			site.allocations = 0;
+		}
+		profile.sampleBytes = sampleBytes;
+	}
+	ArenaProfileSite& site = profile.sites[key];
+	++site.allocations;
+	++site.live;
+	profile.sampledBlocks[block] = &site;
+	return true;
+}
+
+void arenaProfilerRecordRelease(const void* block) {
+	auto& profile = arenaProfile();
+	std::lock_guard<std::mutex> lock(profile.mutex);
+	auto it = profile.sampledBlocks.find(block);
+	ASSERT(it != profile.sampledBlocks.end());
+	--it->second->live;
+	profile.sampledBlocks.erase(it);
+}
+
+void logArenaProfile() {
+	struct LoggedSite {
+		std::string backtrace;
+		ArenaProfileSite counts;
+	};
+	std::vector<LoggedSite> logged;
+	int64_t sampleBytes;
+	double elapsed;
+
+	auto& profile = arenaProfile();
+	{
+		std::lock_guard<std::mutex> lock(profile.mutex);
+		sampleBytes = profile.sampleBytes;
+		elapsed = now() - profile.lastLogged;
+		profile.lastLogged = now();
+		for (auto it = profile.sites.begin(); it != profile.sites.end();) {
+			logged.push_back({ it->first, it->second });
+			it->second.allocations = 0;
+			if (it->second.live == 0) {
+				it = profile.sites.erase(it);
+			} else {
+				++it;
+			}
+		}
+	}
+	if (logged.empty() || !FLOW_KNOBS) {
+		return;
+	}
+
+	// The sites holding the most memory, then those allocating the most
+	auto byLiveBytes = [](LoggedSite const& a, LoggedSite const& b) { return a.counts.live > b.counts.live; };
+	auto byAllocations = [](LoggedSite const& a, LoggedSite const& b) {
+		return a.counts.allocations > b.counts.allocations;
+	};
+	const size_t top = std::min<size_t>(logged.size(), FLOW_KNOBS->ARENA_PROFILER_LOGGED_SITES);
+	std::partial_sort(logged.begin(), logged.begin() + top, logged.end(), byLiveBytes);
+	const size_t end = std::min(logged.size(), 2 * top);
+	std::partial_sort(logged.begin() + top, logged.begin() + end, logged.end(), byAllocations);
+
+	++g_allocation_tracing_disabled;
+	for (size_t i = 0; i < end; ++i) {
+		auto& site = logged[i];
+		TraceEvent("ArenaProfile")
+		    .detail("LiveBytes", site.counts.live * sampleBytes)
+		    .detail("AllocatedBytesPerSecond", elapsed > 0 ? site.counts.allocations * sampleBytes / elapsed : 0.0)
+		    .detail("Samples", site.counts.live)
+		    .detail("Backtrace",
+		            platform::format_backtrace((void**)site.backtrace.data(), site.backtrace.size() / sizeof(void*)));
+	}
+	--g_allocation_tracing_disabled;
+}
+
 #ifdef ALLOC_INSTRUMENTATION
 INIT_SEG std::map<const char*, AllocInstrInfo> allocInstr;
 INIT_SEG std::unordered_map<int64_t, std::pair<uint32_t, size_t>> memSample;
@@ -592,10 +707,29 @@ void FastAllocator<Size>::getMagazine() {
 #else
 	const bool includeGuardPages = true;
 #endif
-	block = (void**)::allocate(magazine_size * Size, /*allowLargePages*/ false, includeGuardPages);
+	if (FLOW_KNOBS && FLOW_KNOBS->FAST_ALLOC_HUGE_PAGES) {
+		// A huge page holds several magazines. This thread takes the first, and the rest go to the global list, so
+		// the memory is first touched here and lands on this thread's NUMA node.
+		uint8_t* hugePage = (uint8_t*)allocateHugePageBacked(kFastAllocHugePageBytes);
+		constexpr int magazinesPerHugePage = kFastAllocHugePageBytes / kFastAllocMagazineBytes;
+		globalData()->totalMemory.fetch_add((magazinesPerHugePage - 1) * magazine_size * Size);
+		for (int m = 1; m < magazinesPerHugePage; m++) {
+			void** magazine = (void**)(hugePage + m * kFastAllocMagazineBytes);
+			linkMagazine(magazine);
+			releaseMagazine(magazine);
+		}
+		block = (void**)hugePage;
+	} else {
+		block = (void**)::allocate(magazine_size * Size, /*allowLargePages*/ false, includeGuardPages);
+	}
 #endif
 
-	// void** block = new void*[ magazine_size * PSize ];
+	linkMagazine(block);
+	thr.freelist = block;
+	thr.count = magazine_size;
+}
+template <int Size>
+void FastAllocator<Size>::linkMagazine(void** block) {
 	for (int i = 0; i < magazine_size - 1; i++) {
 		block[i * PSize + 1] = block[i * PSize] = &block[(i + 1) * PSize];
 		check(&block[i * PSize], false);
@@ -603,8 +737,6 @@ void FastAllocator<Size>::getMagazine() {
 
 	block[(magazine_size - 1) * PSize + 1] = block[(magazine_size - 1) * PSize] = nullptr;
 	check(&block[(magazine_size - 1) * PSize], false);
-	thr.freelist = block;
-	thr.count = magazine_size;
 }
 template <int Size>
 void FastAllocator<Size>::releaseMagazine(void* mag) {
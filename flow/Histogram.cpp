@@ -205,6 +205,10 @@ std::string Histogram::drawHistogram() {
 
 #pragma endregion // Histogram
 
+static_assert(Histogram::bucketIndex(0) == 0 && Histogram::bucketIndex(1) == 0 && Histogram::bucketIndex(2) == 1 &&
+              Histogram::bucketIndex(3) == 1 && Histogram::bucketIndex(1024) == 10 &&
+              Histogram::bucketIndex(UINT32_MAX) == 31);
+
 TEST_CASE("/flow/histogram/smoke_test") {
 	{
 		Reference<Histogram> h = Histogram::getHistogram("smoke_test"_sr, "counts"_sr, Histogram::Unit::bytes);
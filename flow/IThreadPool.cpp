@@ -21,6 +21,10 @@
 #include "flow/IThreadPool.h"
 
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
 // The ifndef's allow us to compile with pre-built boost.  Otherwise, we get
 // errors about double-defines.  As of this writing, the automatically downloaded
 // build of boost doesn't define these, but the pre-built version does.  (The old
@@ -130,3 +134,204 @@ Reference<IThreadPool> createGenericThreadPool(int stackSize, int pri) {
 }
 
 thread_local IThreadPoolReceiver* ThreadPool::Thread::threadUserObject;
+
+class WorkStealingThreadPool final : public IThreadPool, public ReferenceCounted<WorkStealingThreadPool> {
+	static constexpr int kMaxThreads = 64;
+
+	struct Worker {
+		WorkStealingThreadPool* pool;
+		IThreadPoolReceiver* userObject;
+		int index;
+		THREAD_HANDLE handle; // Owned by main thread
+		std::mutex mutex;
+		std::deque<PThreadAction> queues[ThreadActionHint::kPriorities]; // Guarded by mutex
+		std::atomic<int> queued = 0; // Lets other threads pass over empty queues without locking them
+
+		Worker(WorkStealingThreadPool* pool, IThreadPoolReceiver* userObject, int index)
+		  : pool(pool), userObject(userObject), index(index) {}
+		~Worker() { ASSERT_ABORT(!userObject); }
+	};
+	THREAD_FUNC start(void* p) {
+		Worker* worker = (Worker*)p;
+		worker->pool->run(*worker);
+		THREAD_RETURN;
+	}
+
+	const std::string name;
+	const int stackSize;
+	const int pri;
+	// Workers are only added, and never moved, so that threads can look at those before workerCount without locking
+	std::unique_ptr<Worker> workers[kMaxThreads];
+	std::atomic<int> workerCount = 0;
+	std::atomic<uint64_t> nextWorker = 0; // For actions without affinity
+	std::atomic<bool> stopping = false;
+
+	// Threads with nothing to do sleep on wake until pending, the number of actions posted and not yet taken, is
+	// positive. post() only takes sleepMutex when some thread is asleep.
+	std::atomic<int64_t> pending = 0;
+	std::atomic<int> sleepers = 0;
+	std::mutex sleepMutex;
+	std::condition_variable wake;
+
+	// Reset each time they are traced
+	std::atomic<int64_t> posted = 0;
+	std::atomic<int64_t> stolen = 0;
+	std::atomic<int64_t> contended = 0; // Times a thread found a queue's lock held by another
+	std::atomic<int64_t> sleeps = 0;
+	std::atomic<double> nextMetricsTime;
+
+	void run(Worker& self) {
+		setThreadPriority(pri);
+		try {
+			self.userObject->init();
+			while (!stopping.load()) {
+				if (PThreadAction action = take(self)) {
+					pending.fetch_sub(1);
+					(*action)(self.userObject);
+					maybeTraceMetrics();
+					continue;
+				}
+				std::unique_lock<std::mutex> lock(sleepMutex);
+				sleepers.fetch_add(1);
+				++sleeps;
+				wake.wait(lock, [this] { return pending.load() > 0 || stopping.load(); });
+				sleepers.fetch_sub(1);
+			}
+		} catch (Error& e) {
+			TraceEvent(SevError, "ThreadPoolError").error(e);
+		}
+		delete self.userObject;
+		self.userObject = nullptr;
+	}
+
+	// Each priority in turn, the thread's own queue and then the others', so that no thread runs an action while one
+	// of a higher priority waits
+	PThreadAction take(Worker& self) {
+		const int count = workerCount.load();
+		for (int priority = 0; priority < ThreadActionHint::kPriorities; ++priority) {
+			if (PThreadAction action = pop(self, priority, true)) {
+				return action;
+			}
+			for (int i = 1; i < count; ++i) {
+				if (PThreadAction action = pop(*workers[(self.index + i) % count], priority, false)) {
+					++stolen;
+					return action;
+				}
+			}
+		}
+		return nullptr;
+	}
+
+	// A thread waits for its own queue's lock, but passes over another's that is held; it comes back to it if pending
+	// says an action is still there
+	PThreadAction pop(Worker& worker, int priority, bool own) {
+		if (worker.queued.load() == 0) {
+			return nullptr;
+		}
+		std::unique_lock<std::mutex> lock(worker.mutex, std::try_to_lock);
+		if (!lock.owns_lock()) {
+			++contended;
+			if (!own) {
+				return nullptr;
+			}
+			lock.lock();
+		}
+		auto& queue = worker.queues[priority];
+		if (queue.empty()) {
+			return nullptr;
+		}
+		PThreadAction action = queue.front();
+		queue.pop_front();
+		worker.queued.fetch_sub(1);
+		return action;
+	}
+
+	void maybeTraceMetrics() {
+		const double now = timer_monotonic();
+		double next = nextMetricsTime.load();
+		if (now < next ||
+		    !nextMetricsTime.compare_exchange_strong(next, now + FLOW_KNOBS->WORK_STEALING_POOL_METRICS_INTERVAL)) {
+			return;
+		}
+		TraceEvent("WorkStealingThreadPoolMetrics")
+		    .detail("Name", name)
+		    .detail("Threads", workerCount.load())
+		    .detail("Posted", posted.exchange(0))
+		    .detail("Stolen", stolen.exchange(0))
+		    .detail("Contended", contended.exchange(0))
+		    .detail("Sleeps", sleeps.exchange(0))
+		    .detail("Queued", pending.load());
+	}
+
+public:
+	WorkStealingThreadPool(const char* name, int stackSize, int pri)
+	  : name(name), stackSize(stackSize), pri(pri),
+	    nextMetricsTime(timer_monotonic() + FLOW_KNOBS->WORK_STEALING_POOL_METRICS_INTERVAL) {}
+	~WorkStealingThreadPool() override {}
+	Future<Void> stop(Error const& e = success()) override {
+		if (stopping.exchange(true))
+			return Void();
+		ReferenceCounted<WorkStealingThreadPool>::addref();
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex);
+			wake.notify_all();
+		}
+		const int count = workerCount.load();
+		for (int i = 0; i < count; i++) {
+			waitThread(workers[i]->handle);
+		}
+		for (int i = 0; i < count; i++) {
+			for (auto& queue : workers[i]->queues) {
+				for (PThreadAction action : queue) {
+					action->cancel();
+				}
+			}
+			workers[i].reset();
+		}
+		ReferenceCounted<WorkStealingThreadPool>::delref();
+		return Void();
+	}
+
+	Future<Void> getError() const override { return Never(); }
+	void addref() override { ReferenceCounted<WorkStealingThreadPool>::addref(); }
+	void delref() override {
+		if (ReferenceCounted<WorkStealingThreadPool>::delref_no_destroy()) {
+			stop();
+			delete this;
+		}
+	}
+	void addThread(IThreadPoolReceiver* userData, const char* name) override {
+		const int index = workerCount.load();
+		ASSERT(index < kMaxThreads);
+		workers[index] = std::make_unique<Worker>(this, userData, index);
+		workers[index]->handle = g_network->startThread(start, workers[index].get(), stackSize, name);
+		workerCount.store(index + 1);
+	}
+	void post(PThreadAction action) override { postWithHint(action, ThreadActionHint()); }
+	void postWithHint(PThreadAction action, ThreadActionHint const& hint) override {
+		const int count = workerCount.load();
+		ASSERT(count > 0);
+		// Affinities are often pointers, whose low bits are all the same
+		const uint64_t affinity = hint.affinity * 0x9E3779B97F4A7C15ULL >> 32;
+		Worker& worker = *workers[(hint.affinity != 0 ? affinity : nextWorker.fetch_add(1)) % count];
+		{
+			std::unique_lock<std::mutex> lock(worker.mutex, std::try_to_lock);
+			if (!lock.owns_lock()) {
+				++contended;
+				lock.lock();
+			}
+			worker.queues[static_cast<int>(hint.priority)].push_back(action);
+			worker.queued.fetch_add(1);
+		}
+		++posted;
+		pending.fetch_add(1);
+		if (sleepers.load() > 0) {
+			std::lock_guard<std::mutex> lock(sleepMutex);
+			wake.notify_one();
+		}
+	}
+};
+
+Reference<IThreadPool> createWorkStealingThreadPool(const char* name, int stackSize, int pri) {
+	return Reference<IThreadPool>(new WorkStealingThreadPool(name, stackSize, pri));
+}
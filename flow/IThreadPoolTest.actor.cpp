@@ -162,6 +162,57 @@ TEST_CASE("/flow/IThreadPool/ThreadReturnPromiseStream") {
 	return Void();
 }
 
+struct BlockingReceiver final : IThreadPoolReceiver {
+	void init() override {}
+
+	struct BlockAction final : TypedAction<BlockingReceiver, BlockAction> {
+		std::atomic<bool>* released;
+		ThreadReturnPromise<Void> done;
+		explicit BlockAction(std::atomic<bool>* released) : released(released) {}
+		double getTimeEstimate() const override { return 3.; }
+	};
+
+	void action(BlockAction& a) {
+		while (!a.released->load()) {
+			threadYield();
+		}
+		a.done.send(Void());
+	}
+};
+
+TEST_CASE("/flow/IThreadPool/WorkStealing") {
+	noUnseed = true;
+
+	state Reference<IThreadPool> pool = createWorkStealingThreadPool("Test");
+	pool->addThread(new BlockingReceiver(), "thread-foo");
+	pool->addThread(new BlockingReceiver(), "thread-foo");
+
+	// Actions with the same affinity as one that blocks its thread are taken by the other
+	state std::atomic<bool> released = false;
+	ThreadActionHint hint;
+	hint.affinity = 1;
+	auto* blocker = new BlockingReceiver::BlockAction(&released);
+	state Future<Void> blocked = blocker->done.getFuture();
+	pool->postWithHint(blocker, hint);
+
+	state std::atomic<bool> alwaysReleased = true;
+	state std::vector<Future<Void>> stolen;
+	for (int i = 0; i < 100; ++i) {
+		hint.priority = static_cast<ThreadActionHint::Priority>(i % ThreadActionHint::kPriorities);
+		auto* a = new BlockingReceiver::BlockAction(&alwaysReleased);
+		stolen.push_back(a->done.getFuture());
+		pool->postWithHint(a, hint);
+	}
+	wait(waitForAll(stolen));
+	ASSERT(!blocked.isReady());
+
+	released = true;
+	wait(blocked);
+	wait(pool->stop());
+
+	return Void();
+}
+
 #else
 void forceLinkIThreadPoolTests() {}
 #endif
@@ -23,6 +23,7 @@
 
 #include "fmt/format.h"
 #include "flow/IndexedSet.h"
+#include "flow/BTreeIndexedSet.h"
 #include "flow/IRandom.h"
 #include "flow/ThreadPrimitives.h"
 #include <cinttypes>
@@ -218,9 +219,9 @@ TEST_CASE("/flow/IndexedSet/strings") {
 	return Void();
 }
 
-template <typename K>
+template <typename K, class Set = IndexedSet<K, int>>
 struct IndexedSetHarness {
-	using map = IndexedSet<K, int>;
+	using map = Set;
 	using const_result = typename map::const_iterator;
 	using result = typename map::iterator;
 	using key_type = K;
@@ -252,6 +253,15 @@ TEST_CASE("performance/map/StringRef/IndexedSet") {
 	return Void();
 }
 
+TEST_CASE("performance/map/StringRef/BTreeIndexedSet") {
+	Arena arena;
+
+	IndexedSetHarness<StringRef, BTreeIndexedSet<StringRef, int>> is;
+	treeBenchmark(is, [&arena]() { return randomStr(arena); });
+
+	return Void();
+}
+
 TEST_CASE("performance/map/StringRef/StdMap") {
 	Arena arena;
 
@@ -268,6 +278,13 @@ TEST_CASE("performance/map/int/IndexedSet") {
 	return Void();
 }
 
+TEST_CASE("performance/map/int/BTreeIndexedSet") {
+	IndexedSetHarness<int, BTreeIndexedSet<int, int>> is;
+	treeBenchmark(is, &randomInt);
+
+	return Void();
+}
+
 TEST_CASE("performance/map/int/StdMap") {
 	MapHarness<int> is;
 	treeBenchmark(is, &randomInt);
@@ -580,4 +597,139 @@ TEST_CASE("/flow/IndexedSet/const_iterator") {
 
 	return Void();
 }
+// Checks that a BTreeIndexedSet holds the same elements and metrics as an IndexedSet
+static void checkSameAs(BTreeIndexedSet<int, int64_t> const& bs, IndexedSet<int, int64_t> const& is) {
+	bs.testonly_assertValid();
+	ASSERT(bs.sumTo(bs.end()) == is.sumTo(is.end()));
+	ASSERT(bs.empty() == is.empty());
+
+	auto b = bs.begin();
+	for (auto i = is.begin(); i != is.end(); ++i, ++b) {
+		ASSERT(b != bs.end() && *b == *i && bs.getMetric(b) == is.getMetric(i));
+	}
+	ASSERT(b == bs.end());
+
+	b = bs.lastItem();
+	for (auto i = is.lastItem(); i != is.end(); i.decrementNonEnd(), b.decrementNonEnd()) {
+		ASSERT(b != bs.end() && *b == *i);
+	}
+	ASSERT(b == bs.end());
+}
+
+TEST_CASE("/flow/BTreeIndexedSet/random ops") {
+	for (int t = 0; t < 20; t++) {
+		BTreeIndexedSet<int, int64_t> bs;
+		IndexedSet<int, int64_t> is;
+		int keys = deterministicRandom()->randomInt(1, 100000);
+		int ops = deterministicRandom()->randomInt(0, 50000);
+		for (int n = 0; n < ops; n++) {
+			int k = deterministicRandom()->randomInt(0, keys);
+			int64_t m = deterministicRandom()->randomInt(0, 100);
+			double op = deterministicRandom()->random01();
+			if (op < 0.6) {
+				bool replace = deterministicRandom()->coinflip();
+				bs.insert(k, m, replace);
+				is.insert(k, m, replace);
+			} else if (op < 0.7) {
+				ASSERT(bs.addMetric(k, m).first == is.addMetric(k, m).first);
+			} else if (op < 0.95) {
+				bs.erase(k);
+				is.erase(k);
+			} else {
+				int e = k + deterministicRandom()->randomInt(0, keys / 10 + 1);
+				bs.erase(k, e);
+				is.erase(is.lower_bound(k), is.lower_bound(e));
+			}
+
+			if (deterministicRandom()->random01() < 0.01) {
+				int64_t total = is.sumTo(is.end());
+				int64_t m = total ? deterministicRandom()->randomInt64(0, total) : 0;
+				auto bi = bs.index(m);
+				auto ii = is.index(m);
+				ASSERT((bi == bs.end()) == (ii == is.end()) && (bi == bs.end() || *bi == *ii));
+				ASSERT(bs.sumTo(bi) == is.sumTo(ii));
+
+				int q = deterministicRandom()->randomInt(-1, keys + 1);
+				auto bl = bs.lower_bound(q);
+				auto il = is.lower_bound(q);
+				ASSERT((bl == bs.end()) == (il == is.end()) && (bl == bs.end() || *bl == *il));
+				ASSERT(bs.sumTo(bl) == is.sumTo(il));
+				auto bu = bs.upper_bound(q);
+				auto iu = is.upper_bound(q);
+				ASSERT((bu == bs.end()) == (iu == is.end()) && (bu == bs.end() || *bu == *iu));
+				auto ble = bs.lastLessOrEqual(q);
+				auto ile = is.lastLessOrEqual(q);
+				ASSERT((ble == bs.end()) == (ile == is.end()) && (ble == bs.end() || *ble == *ile));
+				ASSERT(bs.count(q) == is.count(q));
+			}
+			if (deterministicRandom()->random01() < 0.0005) {
+				checkSameAs(bs, is);
+			}
+		}
+		checkSameAs(bs, is);
+
+		int b = deterministicRandom()->randomInt(0, keys);
+		int e = deterministicRandom()->randomInt(b, keys + 1);
+		bs.erase(bs.lower_bound(b), bs.lower_bound(e));
+		is.erase(is.lower_bound(b), is.lower_bound(e));
+		checkSameAs(bs, is);
+
+		bs.erase(bs.begin(), bs.end());
+		ASSERT(bs.empty() && bs.begin() == bs.end() && bs.sumTo(bs.end()) == 0);
+		bs.testonly_assertValid();
+	}
+	return Void();
+}
+
+TEST_CASE("/flow/BTreeIndexedSet/sequential") {
+	BTreeIndexedSet<int, int64_t> bs;
+	for (int i = 0; i < 100000; i++) {
+		bs.insert(i, i);
+	}
+	bs.testonly_assertValid();
+	ASSERT(bs.sumTo(bs.end()) == int64_t(100000) * 99999 / 2);
+	ASSERT(bs.sumRange(1000, 2000) == int64_t(1000) * 2999 / 2);
+	ASSERT(*bs.index(int64_t(500) * 499 / 2) == 500);
+
+	// Erasing from the front one element at a time keeps merging the first leaves
+	for (int i = 0; i < 90000; i++) {
+		bs.erase(bs.begin());
+	}
+	bs.testonly_assertValid();
+	ASSERT(*bs.begin() == 90000);
+
+	for (int i = 99999; i >= 95000; i--) {
+		bs.erase(i);
+	}
+	bs.testonly_assertValid();
+	ASSERT(*bs.lastItem() == 94999);
+	return Void();
+}
+
+TEST_CASE("/flow/BTreeIndexedSet/data constructor and destructor calls match") {
+	static int count;
+	count = 0;
+	struct Counter {
+		int value;
+		Counter(int value) : value(value) { count++; }
+		~Counter() { count--; }
+		Counter(const Counter& r) : value(r.value) { count++; }
+		void operator=(const Counter& r) { value = r.value; }
+		int compare(const Counter& r) const { return ::compare(value, r.value); }
+		bool operator<(const Counter& r) const { return value < r.value; }
+	};
+	BTreeIndexedSet<Counter, NoMetric> mySet;
+	for (int i = 0; i < 200000; i++) {
+		mySet.insert(Counter(deterministicRandom()->randomInt(0, 200000)), NoMetric());
+		mySet.erase(Counter(deterministicRandom()->randomInt(0, 200000)));
+	}
+	int count2 = 0;
+	for (int i = 0; i < 200000; i++)
+		count2 += mySet.count(Counter(i));
+	ASSERT(count == count2);
+	mySet.clear();
+	ASSERT(count == 0);
+	return Void();
+}
+
 void forceLinkIndexedSetTests() {}
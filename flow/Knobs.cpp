@@ -70,11 +70,16 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	init( SATURATION_PROFILING_LOG_INTERVAL,                   0.5 ); // A value of 0 means use RUN_LOOP_PROFILING_INTERVAL
 	init( SATURATION_PROFILING_MAX_LOG_INTERVAL,               5.0 );
 	init( SATURATION_PROFILING_LOG_BACKOFF,                    2.0 );
+	init( NETWORK_THREAD_SAMPLING_PROFILER_ENABLED,          false );
+	init( NETWORK_THREAD_SAMPLING_PROFILER_PERIOD,           10000 ); // microseconds of network thread CPU time
 
 	init( FAST_ALLOC_LOGGING_BYTES,                           10e6 );
 	init( FAST_ALLOC_ALLOW_GUARD_PAGES,                      false );
+	init( FAST_ALLOC_HUGE_PAGES,                             false );
 	init( HUGE_ARENA_LOGGING_BYTES,                          100e6 );
 	init( HUGE_ARENA_LOGGING_INTERVAL,                         5.0 );
+	init( ARENA_PROFILER_SAMPLE_BYTES,                           0 ); if( randomize && BUGGIFY ) ARENA_PROFILER_SAMPLE_BYTES = 1e6;
+	init( ARENA_PROFILER_LOGGED_SITES,                          20 );
 	init( ABORT_ON_FAILURE,                                  false );
 
 	init( MEMORY_USAGE_CHECK_INTERVAL,                         1.0 );
@@ -88,6 +93,8 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	init( TRACING_SAMPLE_RATE,                                 0.0 ); if (randomize && BUGGIFY) TRACING_SAMPLE_RATE = 0.01; // Fraction of distributed traces (not spans) to sample (0 means ignore all traces)
 	init( TRACING_UDP_LISTENER_ADDR,                   "127.0.0.1" ); // Only applicable if TracerType is set to a network option
 	init( TRACING_UDP_LISTENER_PORT,                          8889 ); // Only applicable if TracerType is set to a network option
+	init( TRACING_SLOW_SPAN_THRESHOLD,                         0.0 ); if (randomize && BUGGIFY) TRACING_SLOW_SPAN_THRESHOLD = deterministicRandom()->random01(); // Spans of unsampled traces taking at least this many seconds are traced anyway (0 means never)
+	init( TRACING_MAX_SPANS_PER_SECOND,                      10000 ); if (randomize && BUGGIFY) TRACING_MAX_SPANS_PER_SECOND = 10; // Only applicable if TracerType is set to a network option (0 means unlimited)
 
 	// Native metrics
 	init( METRICS_DATA_MODEL,                                "none"); if (randomize && BUGGIFY) METRICS_DATA_MODEL="otel";
@@ -104,6 +111,7 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	init( CONNECTION_MONITOR_IDLE_TIMEOUT,                   180.0 ); if( randomize && BUGGIFY ) CONNECTION_MONITOR_IDLE_TIMEOUT = 5.0;
 	init( CONNECTION_MONITOR_INCOMING_IDLE_MULTIPLIER,         1.2 );
 	init( CONNECTION_MONITOR_UNREFERENCED_CLOSE_DELAY,         2.0 );
+	init( CONNECTION_MONITOR_MAX_SUPPRESSED_PINGS,               0 ); if( randomize && BUGGIFY ) CONNECTION_MONITOR_MAX_SUPPRESSED_PINGS = deterministicRandom()->randomInt(1, 10);
 
 	//FlowTransport
 	init( CONNECTION_REJECTED_MESSAGE_DELAY,                   1.0 );
@@ -121,6 +129,11 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	init( INCOMPATIBLE_PEER_DELAY_BEFORE_LOGGING,              5.0 );
 	init( PING_LOGGING_INTERVAL,                               3.0 );
 	init( PING_SKETCH_ACCURACY,                                0.1 );
+	init( FLOW_TRANSPORT_BULK_LANE,                          false ); // Enable only once all processes and clients accept bulk lanes
+	init( FLOW_TRANSPORT_BULK_LANE_MIN_PACKET_BYTES,         16384 );
+	init( FLOW_TRANSPORT_COMPRESSION,                        false ); if( randomize && BUGGIFY ) FLOW_TRANSPORT_COMPRESSION = true;
+	init( FLOW_TRANSPORT_COMPRESSION_MIN_BYTES,              65536 ); if( randomize && BUGGIFY ) FLOW_TRANSPORT_COMPRESSION_MIN_BYTES = 1000;
+	init( FLOW_TRANSPORT_COMPRESSION_LEVEL,                      1 );
 
 	init( TLS_CERT_REFRESH_DELAY_SECONDS,                 12*60*60 );
 	init( TLS_SERVER_CONNECTION_THROTTLE_TIMEOUT,              9.0 );
@@ -133,6 +146,8 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	init( TLS_MALLOC_ARENA_MAX,                                  6 );
 	init( TLS_HANDSHAKE_LIMIT,                                1000 );
 
+	init( WORK_STEALING_POOL_METRICS_INTERVAL,                 5.0 );
+
 	init( NETWORK_TEST_CLIENT_COUNT,                            30 );
 	init( NETWORK_TEST_REPLY_SIZE,                           600e3 );
 	init( NETWORK_TEST_REQUEST_COUNT,                            0 ); // 0 -> run forever
@@ -157,13 +172,14 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	init( BUGGIFY_SIM_PAGE_CACHE_64K,                          1e6 );
 	init( BLOB_WORKER_PAGE_CACHE,                            500e6 );
 	init( MAX_EVICT_ATTEMPTS,                                  100 ); if( randomize && BUGGIFY ) MAX_EVICT_ATTEMPTS = 2;
-	init( CACHE_EVICTION_POLICY,                          "random" );
+	init( CACHE_EVICTION_POLICY,                          "random" ); if( randomize && BUGGIFY ) CACHE_EVICTION_POLICY = deterministicRandom()->coinflip() ? "lru" : "clock";
 	init( PAGE_CACHE_TRUNCATE_LOOKUP_FRACTION,                 0.1 ); if( randomize && BUGGIFY ) PAGE_CACHE_TRUNCATE_LOOKUP_FRACTION = 0.0; else if( randomize && BUGGIFY ) PAGE_CACHE_TRUNCATE_LOOKUP_FRACTION = 1.0;
 	init( FLOW_CACHEDFILE_WRITE_IO_SIZE,                         0 );
 	if ( randomize && BUGGIFY) {
 		// Choose 16KB to 64KB as I/O size
 		FLOW_CACHEDFILE_WRITE_IO_SIZE = deterministicRandom()->randomInt(16384, 65537);
 	}
+	init( FLOW_CACHEDFILE_MAX_COALESCED_WRITE,             1 << 20 ); if( randomize && BUGGIFY ) FLOW_CACHEDFILE_MAX_COALESCED_WRITE = deterministicRandom()->coinflip() ? 0 : deterministicRandom()->randomInt(4096, 1 << 20);
 
 	//AsyncFileEIO
 	init( EIO_MAX_PARALLELISM,                                  4  );
@@ -179,10 +195,20 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	init( SQLITE_DISK_METRIC_LOGGING_INTERVAL,                 5.0 );
 	init( KAIO_LATENCY_LOGGING_INTERVAL,                      30.0 );
 	init( KAIO_LATENCY_SKETCH_ACCURACY,                       0.01 );
+	init( KAIO_SUBMIT_BATCH,                                     1 );
+	init( KAIO_SUBMIT_BATCH_DELAY,                          0.0005 );
+	init( KAIO_USERSPACE_REAP,                                true );
+	init( KAIO_POLL_OUTSTANDING,                                32 );
+	init( KAIO_FILE_LATENCY_HISTOGRAMS,                      false );
 
 	init( PAGE_WRITE_CHECKSUM_HISTORY,                           0 ); if( randomize && BUGGIFY ) PAGE_WRITE_CHECKSUM_HISTORY = 10000000;
 	init( DISABLE_POSIX_KERNEL_AIO,                              0 );
 
+	//AsyncFileIOUring
+	init( ENABLE_IO_URING,                                   false );
+	init( IO_URING_QUEUE_DEPTH,                                256 );
+	init( IO_URING_FIXED_FILES,                                 64 );
+
 	//AsyncFileNonDurable
 	init( NON_DURABLE_MAX_WRITE_DELAY,                         2.0 ); if( randomize && BUGGIFY ) NON_DURABLE_MAX_WRITE_DELAY = 5.0;
 	init( MAX_PRIOR_MODIFICATION_DELAY,                        1.0 ); if( randomize && BUGGIFY ) MAX_PRIOR_MODIFICATION_DELAY = 10.0;
@@ -217,6 +243,9 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	init( CERT_FILE_MAX_SIZE,                      5 * 1024 * 1024 );
 	init( READY_QUEUE_RESERVED_SIZE,                          8192 );
 	init( TASKS_PER_REACTOR_CHECK,                             100 );
+	init( NETWORK_THREAD_CPU,                                   -1 );
+	init( NETWORK_THREAD_SPIN_BEFORE_SLEEP,                      0 );
+	init( TIMER_WHEEL_TICK,                                      0 ); if( randomize && BUGGIFY ) TIMER_WHEEL_TICK = deterministicRandom()->randomChoice(std::vector<double>{ 1e-6, 0.001, 0.1 });
 
 	//Network
 	init( PACKET_LIMIT,                                  100LL<<20 );
@@ -227,6 +256,7 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	init( MIN_PACKET_BUFFER_FREE_BYTES,                        256 );
 	init( FLOW_TCP_NODELAY,                                      1 );
 	init( FLOW_TCP_QUICKACK,                                     0 );
+	init( FLOW_TCP_ZERO_COPY_SEND_BYTES,                         0 ); // Writes of at least this many bytes use MSG_ZEROCOPY on Linux; 0 disables it
 	init( RESOLVE_PREFER_IPV4_ADDR,                          false );  // Default to prefer IPv6 addresses. Set to true to prefer IPv4 addresses.
 
 	//Sim2
@@ -271,6 +301,7 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	//Load Balancing
 	init( LOAD_BALANCE_ZONE_ID_LOCALITY_ENABLED,                 0 );
 	init( LOAD_BALANCE_DC_ID_LOCALITY_ENABLED,                   1 );
+	init( LOAD_BALANCE_DATA_HALL_LOCALITY_ENABLED,               0 ); if( randomize && BUGGIFY ) LOAD_BALANCE_DATA_HALL_LOCALITY_ENABLED = 1;
 	init( LOAD_BALANCE_MAX_BACKOFF,                            5.0 );
 	init( LOAD_BALANCE_START_BACKOFF,                         0.01 );
 	init( LOAD_BALANCE_BACKOFF_RATE,                           2.0 );
@@ -281,6 +312,15 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	init( SECOND_REQUEST_MULTIPLIER_DECAY,                 0.00025 );
 	init( SECOND_REQUEST_BUDGET_GROWTH,                       0.05 );
 	init( SECOND_REQUEST_MAX_BUDGET,                         100.0 );
+	init( LOAD_BALANCE_HEDGE_BY_LATENCY,                     false ); if( randomize && BUGGIFY ) LOAD_BALANCE_HEDGE_BY_LATENCY = true;
+	init( LOAD_BALANCE_HEDGE_PERCENTILE,                      0.95 );
+	init( LOAD_BALANCE_LATENCY_WINDOW,                         200 ); if( randomize && BUGGIFY ) LOAD_BALANCE_LATENCY_WINDOW = 10;
+	init( LOAD_BALANCE_LATENCY_SKETCH_ACCURACY,               0.05 );
+	init( LOAD_BALANCE_READ_QUEUE_WEIGHT,                      0.0 ); if( randomize && BUGGIFY ) LOAD_BALANCE_READ_QUEUE_WEIGHT = 0.1;
+	init( LOAD_BALANCE_CACHE_MISS_WEIGHT,                      0.0 ); if( randomize && BUGGIFY ) LOAD_BALANCE_CACHE_MISS_WEIGHT = 10.0;
+	init( LOAD_BALANCE_MAX_READ_QUEUE,                        1000 ); if( randomize && BUGGIFY ) LOAD_BALANCE_MAX_READ_QUEUE = 10;
+	init( LOAD_BALANCE_PENALTY_HALF_LIFE,                      0.0 ); if( randomize && BUGGIFY ) LOAD_BALANCE_PENALTY_HALF_LIFE = 1.0;
+	init( LOAD_BALANCE_ADMISSION_WINDOW_EXPIRY,                1.0 );
 	init( ALTERNATIVES_FAILURE_RESET_TIME,                     5.0 );
 	init( ALTERNATIVES_FAILURE_MIN_DELAY,                     0.05 );
 	init( ALTERNATIVES_FAILURE_DELAY_RATIO,                    0.2 );
@@ -319,6 +359,8 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	if ( randomize && BUGGIFY) { ENCRYPT_CIPHER_KEY_CACHE_TTL = deterministicRandom()->randomInt(2, 10) * 60; }
 	init( ENCRYPT_KEY_REFRESH_INTERVAL,   isSimulated ? 60 : 8 * 60 );
 	if ( randomize && BUGGIFY) { ENCRYPT_KEY_REFRESH_INTERVAL = deterministicRandom()->randomInt(2, 10); }
+	init( ENCRYPT_KEY_REFRESH_AHEAD,       isSimulated ? 10 : 60 );
+	if ( randomize && BUGGIFY) { ENCRYPT_KEY_REFRESH_AHEAD = deterministicRandom()->random01() * 30; }
 	init( ENCRYPT_KEY_HEALTH_CHECK_INTERVAL,                    10 );
 	if ( randomize && BUGGIFY) { ENCRYPT_KEY_HEALTH_CHECK_INTERVAL = deterministicRandom()->randomInt(10, 60); }
 	init( EKP_HEALTH_CHECK_REQUEST_TIMEOUT,                    10.0);
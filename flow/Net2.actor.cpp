@@ -69,6 +69,14 @@
 #include <sanitizer/lsan_interface.h>
 #endif
 
+#if defined(__linux__)
+#include <sys/socket.h>
+#include <linux/errqueue.h>
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+#define FLOW_ZERO_COPY_SEND 1
+#endif
+#endif
+
 #ifdef WIN32
 #include <mmsystem.h>
 #endif
@@ -306,6 +314,8 @@ public:
 	Int64MetricHandle countUDPReads;
 	Int64MetricHandle countWouldBlock;
 	Int64MetricHandle countWrites;
+	Int64MetricHandle bytesSentZeroCopy;
+	Int64MetricHandle countZeroCopySendsCopied;
 	Int64MetricHandle countUDPWrites;
 	Int64MetricHandle countRunLoop;
 	Int64MetricHandle countTasks;
@@ -415,6 +425,8 @@ public:
 	explicit Connection(boost::asio::io_service& io_service)
 	  : id(nondeterministicRandom()->randomUniqueID()), socket(io_service) {}
 
+	~Connection() { releaseZeroCopyBuffers(); }
+
 	// This is not part of the IConnection interface, because it is wrapped by INetwork::connect()
 	ACTOR static Future<Reference<IConnection>> connect(boost::asio::io_service* ios, NetworkAddress addr) {
 		state Reference<Connection> self(new Connection(*ios));
@@ -470,6 +482,8 @@ public:
 		boost::system::error_code err;
 		++g_net2->countReads;
 		size_t toRead = end - begin;
+		// Completions of zero copy sends wake up readers, so collect them here
+		reapZeroCopyCompletions();
 		size_t size = socket.read_some(boost::asio::mutable_buffers_1(begin, toRead), err);
 		g_net2->bytesReceived += size;
 		//TraceEvent("ConnRead", this->id).detail("Bytes", size);
@@ -520,6 +534,33 @@ public:
 		return sent;
 	}
 
+	int writePackets(PacketBuffer* data, int limit) override {
+#ifdef FLOW_ZERO_COPY_SEND
+		reapZeroCopyCompletions();
+		if (zeroCopySend) {
+			iovec iov[64];
+			int count = 0;
+			int bytes = 0;
+			for (PacketBuffer* p = data; p && count < 64 && bytes < limit; p = p->nextPacketBuffer()) {
+				int len = std::min(p->bytes_unsent(), limit - bytes);
+				if (len > 0) {
+					iov[count].iov_base = p->data() + p->bytes_sent;
+					iov[count].iov_len = len;
+					++count;
+					bytes += len;
+				}
+			}
+			if (bytes >= FLOW_KNOBS->FLOW_TCP_ZERO_COPY_SEND_BYTES) {
+				int sent = writeZeroCopy(data, iov, count);
+				if (sent >= 0) {
+					return sent;
+				}
+			}
+		}
+#endif
+		return write(data, limit);
+	}
+
 	NetworkAddress getPeerAddress() const override { return peer_address; }
 
 	bool hasTrustedPeer() const override { return true; }
@@ -533,6 +574,102 @@ private:
 	tcp::socket socket;
 	NetworkAddress peer_address;
 
+	// Buffers of zero copy sends that the kernel may still be sending from, by the id it gave the send
+	std::unordered_map<uint32_t, std::vector<PacketBuffer*>> zeroCopyBuffers;
+	uint32_t nextZeroCopyId = 0;
+	bool zeroCopySend = false;
+
+#ifdef FLOW_ZERO_COPY_SEND
+	// Returns the number of bytes sent, or -1 if the data should be written by copying it instead
+	int writeZeroCopy(PacketBuffer* data, iovec* iov, int count) {
+		++g_net2->countWrites;
+		msghdr msg = {};
+		msg.msg_iov = iov;
+		msg.msg_iovlen = count;
+		ssize_t sent = ::sendmsg(socket.native_handle(), &msg, MSG_ZEROCOPY | MSG_DONTWAIT | MSG_NOSIGNAL);
+		if (sent < 0) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				++g_net2->countWouldBlock;
+				return 0;
+			}
+			if (errno == ENOBUFS) {
+				// Out of socket option memory for completions
+				return -1;
+			}
+			onWriteError(boost::system::error_code(errno, boost::system::system_category()));
+			throw connection_failed();
+		}
+		ASSERT(sent > 0);
+
+		// The send holds on to what it sent until the kernel reports it complete
+		std::vector<PacketBuffer*>& buffers = zeroCopyBuffers[nextZeroCopyId++];
+		int unreferenced = sent;
+		for (PacketBuffer* p = data; unreferenced > 0; p = p->nextPacketBuffer()) {
+			int len = std::min(p->bytes_unsent(), unreferenced);
+			if (len > 0) {
+				p->addref();
+				buffers.push_back(p);
+				unreferenced -= len;
+			}
+		}
+		g_net2->bytesSentZeroCopy += sent;
+		return sent;
+	}
+#endif
+
+	void reapZeroCopyCompletions() {
+#ifdef FLOW_ZERO_COPY_SEND
+		while (!zeroCopyBuffers.empty()) {
+			char control[128];
+			msghdr msg = {};
+			msg.msg_control = control;
+			msg.msg_controllen = sizeof(control);
+			if (::recvmsg(socket.native_handle(), &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+				break;
+			}
+			for (cmsghdr* cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm)) {
+				if (!(cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR) &&
+				    !(cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR)) {
+					continue;
+				}
+				const sock_extended_err* err = reinterpret_cast<const sock_extended_err*>(CMSG_DATA(cm));
+				if (err->ee_errno != 0 || err->ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+					continue;
+				}
+				if (err->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+					// The kernel copied after all, as it does over loopback, so zero copy only adds overhead here
+					++g_net2->countZeroCopySendsCopied;
+					zeroCopySend = false;
+				}
+				// Completions cover a range of ids, which may wrap around
+				for (uint32_t completed = err->ee_info;; ++completed) {
+					auto it = zeroCopyBuffers.find(completed);
+					if (it != zeroCopyBuffers.end()) {
+						for (PacketBuffer* p : it->second) {
+							p->delref();
+						}
+						zeroCopyBuffers.erase(it);
+					}
+					if (completed == err->ee_data) {
+						break;
+					}
+				}
+			}
+		}
+#endif
+	}
+
+	// Once the socket is closed there are no more completions. The kernel keeps its own references to the pages it
+	// has yet to send, so the buffers can be freed.
+	void releaseZeroCopyBuffers() {
+		for (auto& [id, buffers] : zeroCopyBuffers) {
+			for (PacketBuffer* p : buffers) {
+				p->delref();
+			}
+		}
+		zeroCopyBuffers.clear();
+	}
+
 	void init() {
 		// Socket settings that have to be set after connect or accept succeeds
 		socket.non_blocking(true);
@@ -544,12 +681,24 @@ private:
 			socket.set_option(boost::asio::detail::socket_option::boolean<IPPROTO_TCP, TCP_QUICKACK>(true));
 #else
 			TraceEvent(SevWarn, "N2_InitWarn").detail("Message", "TCP_QUICKACK not supported");
+#endif
+		}
+		if (FLOW_KNOBS->FLOW_TCP_ZERO_COPY_SEND_BYTES > 0) {
+#ifdef FLOW_ZERO_COPY_SEND
+			int one = 1;
+			zeroCopySend = setsockopt(socket.native_handle(), SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) == 0;
+			if (!zeroCopySend) {
+				TraceEvent(SevWarn, "N2_InitWarn").suppressFor(60.0).detail("Message", "SO_ZEROCOPY not supported");
+			}
+#else
+			TraceEvent(SevWarn, "N2_InitWarn").suppressFor(60.0).detail("Message", "MSG_ZEROCOPY not supported");
 #endif
 		}
 		platform::setCloseOnExec(socket.native_handle());
 	}
 
 	void closeSocket() {
+		releaseZeroCopyBuffers();
 		boost::system::error_code error;
 		socket.close(error);
 		if (error)
@@ -1424,6 +1573,8 @@ void Net2::initMetrics() {
 	countReads.init("Net2.CountReads"_sr);
 	countWouldBlock.init("Net2.CountWouldBlock"_sr);
 	countWrites.init("Net2.CountWrites"_sr);
+	bytesSentZeroCopy.init("Net2.BytesSentZeroCopy"_sr);
+	countZeroCopySendsCopied.init("Net2.CountZeroCopySendsCopied"_sr);
 	countRunLoop.init("Net2.CountRunLoop"_sr);
 	countTasks.init("Net2.CountTasks"_sr);
 	countYields.init("Net2.CountYields"_sr);
@@ -1463,6 +1614,13 @@ void Net2::run() {
 		TraceEvent(SevError, "TimeBeginPeriodError").log();
 #endif
 
+	// Running several processes per host is how a host's cores are put to use, and with each one's network thread
+	// pinned to its own core they don't migrate between cores or crowd onto the same ones
+	if (FLOW_KNOBS->NETWORK_THREAD_CPU >= 0) {
+		setAffinity(FLOW_KNOBS->NETWORK_THREAD_CPU);
+		TraceEvent("Net2PinnedNetworkThread").detail("CPU", FLOW_KNOBS->NETWORK_THREAD_CPU);
+	}
+
 	timeOffsetLogger = logTimeOffset();
 	const char* flow_profiler_enabled = getenv("FLOW_PROFILER_ENABLED");
 	if (flow_profiler_enabled != nullptr && *flow_profiler_enabled != '\0') {
@@ -1470,6 +1628,9 @@ void Net2::run() {
 		// profiling at startup.
 		startProfiling(this);
 	}
+	if (FLOW_KNOBS->NETWORK_THREAD_SAMPLING_PROFILER_ENABLED) {
+		startSamplingProfiler(this, FLOW_KNOBS->NETWORK_THREAD_SAMPLING_PROFILER_PERIOD);
+	}
 
 	// Get the address to the launch function
 	typedef void (*runCycleFuncPtr)();
@@ -1494,6 +1655,18 @@ void Net2::run() {
 			checkForSlowTask(tscBegin, timestampCounter(), taskEnd - taskBegin, TaskPriority::RunCycleFunction);
 		}
 
+		if (FLOW_KNOBS->NETWORK_THREAD_SPIN_BEFORE_SLEEP > 0 && !taskQueue.hasReadyTask()) {
+			// Once canSleep() has been called, every task pushed from another thread wakes the reactor, which costs
+			// both threads a system call. Poll for such tasks for a little while first, but no longer than until the
+			// next timer. Network events wait for the spin to end.
+			double spinStart = timer_monotonic();
+			double spinEnd = spinStart + std::min(FLOW_KNOBS->NETWORK_THREAD_SPIN_BEFORE_SLEEP,
+			                                      taskQueue.getSleepTime(spinStart));
+			while (!taskQueue.hasReadyTask() && timer_monotonic() < spinEnd) {
+				taskQueue.processThreadReady();
+			}
+		}
+
 		double sleepTime = 0;
 		if (taskQueue.canSleep()) {
 			sleepTime = 1e99;
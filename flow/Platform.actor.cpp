@@ -2205,6 +2205,27 @@ void* allocate(size_t length, bool allowLargePages, bool includeGuardPages) {
 	return block;
 }
 
+void* allocateHugePageBacked(size_t length) {
+#if defined(__linux__)
+	// Map twice as much as asked for, and keep the part of it that is aligned to length
+	uint8_t* mapped =
+	    (uint8_t*)mmapSafe(nullptr, 2 * length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	uint8_t* aligned = (uint8_t*)(((uintptr_t)mapped + length - 1) & ~(uintptr_t)(length - 1));
+	if (aligned != mapped) {
+		munmap(mapped, aligned - mapped);
+	}
+	munmap(aligned + length, mapped + length - aligned);
+#ifdef MADV_HUGEPAGE
+	// Unlike MAP_HUGETLB, this needs no pages reserved up front. Where transparent huge pages are disabled it fails, and
+	// the range keeps normal pages.
+	madvise(aligned, length, MADV_HUGEPAGE);
+#endif
+	return aligned;
+#else
+	return allocate(length, /*allowLargePages*/ false, /*includeGuardPages*/ false);
+#endif
+}
+
 #if 0
 void* numaAllocate(size_t size) {
 	void* thePtr = (void*)0xA00000000LL;
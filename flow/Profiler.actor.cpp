@@ -54,6 +54,33 @@ struct SignalClosure {
 	}
 };
 
+// Sends 'signo', carrying 'closure', to the calling thread every 'periodUs' microseconds of its CPU time
+static bool startProfilingTimer(int signo, SignalClosure* closure, int periodUs, timer_t* timer) {
+	const int64_t periodNs = int64_t(periodUs) * 1000;
+	const int64_t firstNs = nondeterministicRandom()->randomInt64(periodNs / 2, periodNs + 1);
+	itimerspec tv;
+	tv.it_interval.tv_sec = periodNs / 1000000000;
+	tv.it_interval.tv_nsec = periodNs % 1000000000;
+	tv.it_value.tv_sec = firstNs / 1000000000;
+	tv.it_value.tv_nsec = firstNs % 1000000000;
+
+	sigevent sev;
+	sev.sigev_notify = SIGEV_THREAD_ID;
+	sev.sigev_signo = signo;
+	sev.sigev_value.sival_ptr = closure;
+	sev._sigev_un._tid = sys_gettid();
+	if (timer_create(CLOCK_THREAD_CPUTIME_ID, &sev, timer) != 0) {
+		TraceEvent(SevWarn, "FailedToCreateProfilingTimer").GetLastError();
+		return false;
+	}
+	if (timer_settime(*timer, 0, &tv, nullptr) != 0) {
+		TraceEvent(SevWarn, "FailedToSetProfilingTimer").GetLastError();
+		timer_delete(*timer);
+		return false;
+	}
+	return true;
+}
+
 struct SyncFileForSim : ReferenceCounted<SyncFileForSim> {
 	FILE* f;
 	SyncFileForSim(std::string const& filename) { f = fopen(filename.c_str(), "wb"); }
@@ -216,27 +243,10 @@ struct Profiler {
 		sigaction(SIGPROF, &act, nullptr);
 
 		// Set up periodic profiling timer
-		int period_ns = period * 1000;
-		itimerspec tv;
-		tv.it_interval.tv_sec = 0;
-		tv.it_interval.tv_nsec = period_ns;
-		tv.it_value.tv_sec = 0;
-		tv.it_value.tv_nsec = nondeterministicRandom()->randomInt(period_ns / 2, period_ns + 1);
-
-		sigevent sev;
-		sev.sigev_notify = SIGEV_THREAD_ID;
-		sev.sigev_signo = SIGPROF;
-		sev.sigev_value.sival_ptr = &(self->signalClosure);
-		sev._sigev_un._tid = sys_gettid();
-		if (timer_create(CLOCK_THREAD_CPUTIME_ID, &sev, &self->periodicTimer) != 0) {
-			TraceEvent(SevWarn, "FailedToCreateProfilingTimer").GetLastError();
+		if (!startProfilingTimer(SIGPROF, &self->signalClosure, period, &self->periodicTimer)) {
 			return Void();
 		}
 		self->timerInitialized = true;
-		if (timer_settime(self->periodicTimer, 0, &tv, nullptr) != 0) {
-			TraceEvent(SevWarn, "FailedToSetProfilingTimer").GetLastError();
-			return Void();
-		}
 
 		state int64_t outOffset = 0;
 		wait(outFile->truncate(outOffset));
@@ -261,6 +271,210 @@ struct Profiler {
 // Outlives main
 Profiler* Profiler::active_profiler = nullptr;
 
+// Continuous sampling of the network thread, aggregated in memory: each distinct stack is counted along with the
+// TaskPriority that was running when it was sampled. Unlike Profiler, which streams every sample to a file, it is cheap
+// enough to leave on, and writes pprof CPU profiles on demand. It uses a signal of its own, so that it runs alongside
+// Profiler and the slow task profiler, which share SIGPROF.
+struct SamplingProfiler {
+	enum { MAX_STACK_DEPTH = 64, MAX_DISTINCT_STACKS = 100000 };
+
+	// A sample in the buffers is its TaskPriority, its stack from the interrupted frame outwards, and -1
+	using Stack = std::pair<TaskPriority, std::vector<void*>>;
+
+	void* addresses[MAX_STACK_DEPTH];
+	SignalClosure signalClosure;
+	Profiler::OutputBuffer* outputBuffer;
+	Profiler::OutputBuffer* otherBuffer;
+	sigset_t profilingSignals;
+	INetwork* network;
+	int period;
+	timer_t periodicTimer;
+	bool timerInitialized;
+	std::map<Stack, int64_t> stacks;
+	int64_t samples;
+	int64_t droppedSamples;
+	Future<Void> actor;
+	static SamplingProfiler* active_profiler;
+
+	static int signalNumber() { return SIGRTMIN + 4; }
+
+	SamplingProfiler(int period, INetwork* network)
+	  : signalClosure(signal_handler_for_closure, this), outputBuffer(new Profiler::OutputBuffer),
+	    otherBuffer(new Profiler::OutputBuffer), network(network), period(period), timerInitialized(false), samples(0),
+	    droppedSamples(0) {
+		sigemptyset(&profilingSignals);
+		sigaddset(&profilingSignals, signalNumber());
+
+		// Calling this once before the signal handler can makes it async signal safe in practice
+		platform::raw_backtrace(addresses, MAX_STACK_DEPTH);
+
+		struct sigaction act;
+		act.sa_sigaction = SignalClosure::signal_handler;
+		sigemptyset(&act.sa_mask);
+		act.sa_flags = SA_SIGINFO | SA_RESTART;
+		sigaction(signalNumber(), &act, nullptr);
+		enableSignal(true);
+
+		timerInitialized = startProfilingTimer(signalNumber(), &signalClosure, period, &periodicTimer);
+		if (timerInitialized) {
+			actor = aggregate(this);
+		}
+	}
+
+	~SamplingProfiler() {
+		if (timerInitialized) {
+			timer_delete(periodicTimer);
+		}
+		enableSignal(false);
+		delete outputBuffer;
+		delete otherBuffer;
+	}
+
+	void enableSignal(bool enabled) { sigprocmask(enabled ? SIG_UNBLOCK : SIG_BLOCK, &profilingSignals, nullptr); }
+
+	void signal_handler(void* ucontext) { // async signal safe!
+		if (!flowProfilingEnabled) {
+			return;
+		}
+		int n = platform::raw_backtrace(addresses, MAX_STACK_DEPTH);
+
+		// Skip the frames of this handler, which end where the interrupted code was
+		void* interrupted = nullptr;
+#if defined(__x86_64__)
+		interrupted = (void*)((ucontext_t*)ucontext)->uc_mcontext.gregs[REG_RIP];
+#elif defined(__aarch64__)
+		interrupted = (void*)((ucontext_t*)ucontext)->uc_mcontext.pc;
+#endif
+		int first = 0;
+		while (first < n && addresses[first] != interrupted) {
+			++first;
+		}
+		if (first == n) {
+			first = 0;
+		}
+
+		std::vector<void*>& output = outputBuffer->output;
+		if (output.size() + (n - first) + 2 > output.capacity()) {
+			return;
+		}
+		output.push_back((void*)(intptr_t)network->getCurrentTask());
+		for (int i = first; i < n; i++) {
+			output.push_back(addresses[i]);
+		}
+		output.push_back((void*)-1LL);
+	}
+
+	static void signal_handler_for_closure(int, siginfo_t*, void* ucontext, void* self) { // async signal safe!
+		((SamplingProfiler*)self)->signal_handler(ucontext);
+	}
+
+	// Moves the samples taken since the last call from the signal handler's buffer into 'stacks'
+	void collect() {
+		enableSignal(false);
+		std::swap(outputBuffer, otherBuffer);
+		enableSignal(true);
+
+		const std::vector<void*>& output = otherBuffer->output;
+		Stack stack;
+		for (size_t i = 0; i < output.size();) {
+			stack.first = (TaskPriority)(intptr_t)output[i++];
+			stack.second.clear();
+			while (output[i] != (void*)-1LL) {
+				stack.second.push_back(output[i++]);
+			}
+			++i;
+			++samples;
+			auto it = stacks.find(stack);
+			if (it != stacks.end()) {
+				++it->second;
+			} else if (stacks.size() < MAX_DISTINCT_STACKS) {
+				stacks.emplace(stack, 1);
+			} else {
+				++droppedSamples;
+			}
+		}
+		otherBuffer->clear();
+	}
+
+	void clear() {
+		collect();
+		stacks.clear();
+		samples = 0;
+		droppedSamples = 0;
+	}
+
+	// Writes the stacks of the given TaskPriority, or of all of them, in the legacy binary CPU profile format of
+	// gperftools, which pprof reads. It is made of machine words: a header, a record per stack (count, depth and its
+	// addresses), a trailer, and then the text of /proc/self/maps for symbolization.
+	bool writeProfile(std::string const& filename, Optional<TaskPriority> priority) const {
+		FILE* f = fopen(filename.c_str(), "wb");
+		if (f == nullptr) {
+			TraceEvent(SevWarn, "FailedToOpenProfilingOutputFile").detail("Filename", filename).GetLastError();
+			return false;
+		}
+		std::vector<uintptr_t> words = { 0, 3, 0, uintptr_t(period), 0 };
+		for (const auto& [stack, count] : stacks) {
+			if (priority.present() && stack.first != priority.get()) {
+				continue;
+			}
+			words.push_back(count);
+			words.push_back(stack.second.size());
+			for (void* address : stack.second) {
+				words.push_back((uintptr_t)address);
+			}
+		}
+		words.insert(words.end(), { 0, 1, 0 });
+		bool ok = fwrite(words.data(), sizeof(uintptr_t), words.size(), f) == words.size();
+
+		FILE* maps = fopen("/proc/self/maps", "r");
+		if (maps != nullptr) {
+			char buf[4096];
+			size_t n;
+			while (ok && (n = fread(buf, 1, sizeof(buf), maps)) > 0) {
+				ok = fwrite(buf, 1, n, f) == n;
+			}
+			fclose(maps);
+		}
+		ok = fclose(f) == 0 && ok;
+		if (!ok) {
+			TraceEvent(SevWarn, "FailedToWriteProfilingOutputFile").detail("Filename", filename).GetLastError();
+		}
+		return ok;
+	}
+
+	// Writes all samples to 'filename', and those of each TaskPriority to 'filename'.<priority>
+	void dump(std::string const& filename) {
+		collect();
+		std::map<TaskPriority, int64_t> samplesByPriority;
+		for (const auto& [stack, count] : stacks) {
+			samplesByPriority[stack.first] += count;
+		}
+
+		TraceEvent ev("NetworkThreadSamplingProfile");
+		ev.detail("Filename", filename)
+		    .detail("Period", period)
+		    .detail("Samples", samples)
+		    .detail("DroppedSamples", droppedSamples)
+		    .detail("DistinctStacks", stacks.size());
+		if (!writeProfile(filename, {})) {
+			return;
+		}
+		for (const auto& [priority, count] : samplesByPriority) {
+			ev.detail(format("Priority%d", (int)priority), count);
+			writeProfile(format("%s.%d", filename.c_str(), (int)priority), priority);
+		}
+	}
+
+	ACTOR static Future<Void> aggregate(SamplingProfiler* self) {
+		loop {
+			wait(self->network->delay(1.0, TaskPriority::Min) || self->network->delay(2.0, TaskPriority::Max));
+			self->collect();
+		}
+	}
+};
+
+SamplingProfiler* SamplingProfiler::active_profiler = nullptr;
+
 std::string findAndReplace(std::string const& fn, std::string const& symbol, std::string const& value) {
 	auto i = fn.find(symbol);
 	if (i == std::string::npos)
@@ -305,9 +519,47 @@ void stopProfiling() {
 	}
 }
 
+void startSamplingProfiler(INetwork* network, int period) {
+	if (!SamplingProfiler::active_profiler) {
+		TraceEvent("StartingNetworkThreadSamplingProfiler").detail("Period", period);
+		SamplingProfiler::active_profiler = new SamplingProfiler(period, network);
+	}
+}
+
+void stopSamplingProfiler() {
+	if (SamplingProfiler::active_profiler) {
+		SamplingProfiler* p = SamplingProfiler::active_profiler;
+		SamplingProfiler::active_profiler = nullptr;
+		delete p;
+	}
+}
+
+bool isSamplingProfilerRunning() {
+	return SamplingProfiler::active_profiler != nullptr;
+}
+
+void clearSamplingProfile() {
+	if (SamplingProfiler::active_profiler) {
+		SamplingProfiler::active_profiler->clear();
+	}
+}
+
+void dumpSamplingProfile(std::string const& outputFile) {
+	if (SamplingProfiler::active_profiler) {
+		SamplingProfiler::active_profiler->dump(outputFile);
+	}
+}
+
 #else
 
 void startProfiling(INetwork* network, Optional<int> period, Optional<StringRef> outputFile) {}
 void stopProfiling() {}
+void startSamplingProfiler(INetwork* network, int period) {}
+void stopSamplingProfiler() {}
+bool isSamplingProfilerRunning() {
+	return false;
+}
+void clearSamplingProfile() {}
+void dumpSamplingProfile(std::string const& outputFile) {}
 
 #endif
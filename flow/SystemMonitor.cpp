@@ -230,6 +230,8 @@ SystemStatistics customSystemMonitor(std::string const& eventName, StatisticsSta
 			unused_memory += FastAllocator<8192>::getApproximateMemoryUnused();
 			unused_memory += FastAllocator<16384>::getApproximateMemoryUnused();
 
+			logArenaProfile();
+
 			if (total_memory > 0) {
 				TraceEvent("FastAllocMemoryUsage")
 				    .detail("TotalMemory", total_memory)
@@ -253,6 +255,9 @@ SystemStatistics customSystemMonitor(std::string const& eventName, StatisticsSta
 			    .detail("ASIOEventsProcessed", netData.countASIOEvents - statState->networkState.countASIOEvents)
 			    .detail("ReadCalls", netData.countReads - statState->networkState.countReads)
 			    .detail("WriteCalls", netData.countWrites - statState->networkState.countWrites)
+			    .detail("BytesSentZeroCopy", netData.bytesSentZeroCopy - statState->networkState.bytesSentZeroCopy)
+			    .detail("ZeroCopySendsCopied",
+			            netData.countZeroCopySendsCopied - statState->networkState.countZeroCopySendsCopied)
 			    .detail("ReadProbes", netData.countReadProbes - statState->networkState.countReadProbes)
 			    .detail("WriteProbes", netData.countWriteProbes - statState->networkState.countWriteProbes)
 			    .detail("PacketsRead", netData.countPacketsReceived - statState->networkState.countPacketsReceived)
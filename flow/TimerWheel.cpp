@@ -0,0 +1,98 @@
+/*
+ * TimerWheel.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <set>
+
+#include "flow/UnitTest.h"
+#include "flow/TimerWheel.h"
+
+namespace {
+struct TestTimer {
+	double at;
+	int id;
+};
+} // namespace
+
+TEST_CASE("/flow/TimerWheel/expire") {
+	TimerWheel<TestTimer> wheel(0.001);
+	wheel.add({ 5.0, 0 });
+	wheel.add({ 1.0005, 1 });
+	wheel.add({ 1.0001, 2 });
+	ASSERT(wheel.size() == 3 && wheel.nextAt() == 1.0001);
+
+	// Part of a tick: only the timer due in it that is due
+	std::vector<int> expired;
+	auto collect = [&](TestTimer const& t) { expired.push_back(t.id); };
+	wheel.expire(1.0002, collect);
+	ASSERT(expired == std::vector<int>{ 2 });
+	ASSERT(wheel.nextAt() == 1.0005);
+
+	// A timer added after its time goes out with the next call
+	wheel.add({ 0.5, 3 });
+	ASSERT(wheel.nextAt() == 0.5);
+	expired.clear();
+	wheel.expire(4.0, collect);
+	std::sort(expired.begin(), expired.end());
+	ASSERT(expired == (std::vector<int>{ 1, 3 }));
+	ASSERT(wheel.size() == 1 && wheel.nextAt() == 5.0);
+
+	wheel.clear();
+	ASSERT(wheel.empty());
+	return Void();
+}
+
+// Checks the wheel against a set ordered by time over random timers, some of them beyond what the wheel covers
+TEST_CASE("/flow/TimerWheel/random") {
+	const double tick = deterministicRandom()->randomChoice(std::vector<double>{ 1e-6, 0.001, 0.1 });
+	TimerWheel<TestTimer> wheel(tick);
+	std::set<std::pair<double, int>> expected;
+	double now = deterministicRandom()->random01() * 1000;
+	int nextId = 0;
+	for (int step = 0; step < 10000; ++step) {
+		const int adds = deterministicRandom()->randomInt(0, 10);
+		for (int i = 0; i < adds; ++i) {
+			double at = now - 1 + deterministicRandom()->random01() * 2;
+			if (deterministicRandom()->random01() < 0.1) {
+				at = now + deterministicRandom()->random01() * std::pow(10, deterministicRandom()->randomInt(0, 9));
+			}
+			wheel.add({ at, nextId });
+			expected.emplace(at, nextId);
+			++nextId;
+		}
+		ASSERT(wheel.size() == expected.size());
+		if (!expected.empty()) {
+			ASSERT(wheel.nextAt() == expected.begin()->first);
+		}
+
+		if (deterministicRandom()->random01() < 0.01 && !expected.empty()) {
+			now = expected.rbegin()->first;
+		} else {
+			now += deterministicRandom()->random01() * std::pow(10, deterministicRandom()->randomInt(-4, 2));
+		}
+		wheel.expire(now, [&](TestTimer const& t) {
+			ASSERT(t.at <= now);
+			ASSERT(expected.erase(std::make_pair(t.at, t.id)) == 1);
+		});
+		ASSERT(expected.empty() || expected.begin()->first > now);
+	}
+	return Void();
+}
+
+void forceLinkTimerWheelTests() {}
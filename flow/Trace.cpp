@@ -24,6 +24,7 @@
 #include "flow/Knobs.h"
 #include "flow/XmlTraceLogFormatter.h"
 #include "flow/JsonTraceLogFormatter.h"
+#include "flow/BinaryTraceLogFormatter.h"
 #include "flow/flow.h"
 #include "flow/DeterministicRandom.h"
 #include "flow/ProcessEvents.h"
@@ -260,7 +261,7 @@ public:
 		struct WriteBuffer final : TypedAction<WriterThread, WriteBuffer> {
 			std::vector<TraceEventFields> events;
 
-			WriteBuffer(std::vector<TraceEventFields> events) : events(events) {}
+			WriteBuffer(std::vector<TraceEventFields> events) : events(std::move(events)) {}
 			double getTimeEstimate() const override { return .001; }
 		};
 		void action(WriteBuffer& a) {
@@ -401,10 +402,17 @@ public:
 			return;
 		}
 
+		if (trackError) {
+			latestEventCache.setLatestError(fields);
+		}
+		if (!trackLatestKey.empty()) {
+			latestEventCache.set(trackLatestKey, fields);
+		}
+
 		// FIXME: What if we are using way too much memory for buffer?
 		ASSERT(!isOpen() || fields.isAnnotated());
-		eventBuffer.push_back(fields);
 		bufferLength += fields.sizeBytes();
+		eventBuffer.push_back(std::move(fields));
 
 		if (g_network && g_network->isSimulated()) {
 			// Throw an error if we have queued up a large number of events in simulation. This makes it easier to
@@ -413,7 +421,7 @@ public:
 			// identify where the process is actually stuck.
 			if (bufferLength > 1e8) {
 				fprintf(stderr, "Trace log buffer overflow\n");
-				fprintf(stderr, "Last event: %s\n", fields.toString().c_str());
+				fprintf(stderr, "Last event: %s\n", eventBuffer.back().toString().c_str());
 				// Setting this to 0 avoids a recurse from the assertion trace event and also prevents a situation where
 				// we roll the trace log only to log the single assertion event when using --crash.
 				bufferLength = 0;
@@ -423,13 +431,6 @@ public:
 				failedLineOverflow = 1; // we only want to do this once
 			}
 		}
-
-		if (trackError) {
-			latestEventCache.setLatestError(fields);
-		}
-		if (!trackLatestKey.empty()) {
-			latestEventCache.set(trackLatestKey, fields);
-		}
 	}
 
 	void logMetrics(int severity, const char* name, UID id, uint64_t event_ts) {
@@ -693,6 +694,11 @@ bool traceFormatImpl(std::string& format) {
 			g_traceLog.formatter = Reference<ITraceLogFormatter>(new JsonTraceLogFormatter());
 		}
 		return true;
+	} else if (format == "binary") {
+		if (!validate) {
+			g_traceLog.formatter = Reference<ITraceLogFormatter>(new BinaryTraceLogFormatter());
+		}
+		return true;
 	} else {
 		if (!validate) {
 			g_traceLog.formatter = Reference<ITraceLogFormatter>(new XmlTraceLogFormatter());
@@ -384,7 +384,7 @@ namespace actorcompiler
 
             string callback_base_classes = string.Join(", ", callbacks.Select(c=>string.Format("public {0}", c.type)));
             if (callback_base_classes != "") callback_base_classes += ", ";
-            writer.WriteLine("class {0} final : public Actor<{2}>, {3}public FastAllocated<{1}>, public {4} {{",
+            writer.WriteLine("class {0} final : public Actor<{2}>, {3}public ActorAllocated<{1}>, public {4} {{",
                 className,
                 fullClassName,
                 actor.returnType == null ? "void" : actor.returnType,
@@ -392,8 +392,8 @@ namespace actorcompiler
                 fullStateClassName
                 );
             writer.WriteLine("public:");
-            writer.WriteLine("\tusing FastAllocated<{0}>::operator new;", fullClassName);
-            writer.WriteLine("\tusing FastAllocated<{0}>::operator delete;", fullClassName);
+            writer.WriteLine("\tusing ActorAllocated<{0}>::operator new;", fullClassName);
+            writer.WriteLine("\tusing ActorAllocated<{0}>::operator delete;", fullClassName);
 
             var actorIdentifierKey = this.sourceFile + ":" + this.actor.name;
             var actorIdentifier = GetUidFromString(actorIdentifierKey);
@@ -5,6 +5,7 @@
 # define FDB_CLEAN_BUILD
 #endif // FDB_RELEASE
 #cmakedefine OPEN_FOR_IDE
+#cmakedefine FLOW_USE_BTREE_RANGE_MAP
 #define FDB_SOURCE_DIR "${CMAKE_SOURCE_DIR}"
 #define FDB_BINARY_DIR "${CMAKE_BINARY_DIR}"
 #ifdef WIN32
@@ -441,6 +441,53 @@ TEST_CASE("/flow/FlatBuffers/struct") {
 	return Void();
 }
 
+struct FixedNested {
+	uint8_t a;
+	double b;
+	template <class Archiver>
+	void serialize(Archiver& ar) {
+		serializer(ar, a, b);
+	}
+};
+
+struct Fixed {
+	int64_t a;
+	std::tuple<int16_t, bool, int64_t> b;
+	FixedNested c;
+	uint16_t d;
+	template <class Archiver>
+	void serialize(Archiver& ar) {
+		serializer(ar, a, b, c, d);
+	}
+};
+
+TEST_CASE("/flow/FlatBuffers/fixedLayout") {
+	Arena arena;
+	TestContext context{ arena };
+	Fixed x1{ 1, { 2, true, 3 }, { 4, 5.5 }, 6 };
+
+	// The first message works out the layout, and the second reuses it
+	const uint8_t* first = save_members(context, FileIdentifier{}, x1);
+	const uint8_t* second = save_members(context, FileIdentifier{}, x1);
+	ASSERT(arena.get_size(first) == arena.get_size(second));
+	ASSERT(memcmp(first, second, arena.get_size(first)) == 0);
+
+	x1 = { -7, { 8, false, -9 }, { 10, -11.5 }, 12 };
+	Fixed x2;
+	load_members(save_members(context, FileIdentifier{}, x1), context, x2);
+	ASSERT(x1.a == x2.a && x1.b == x2.b && x1.c.a == x2.c.a && x1.c.b == x2.c.b && x1.d == x2.d);
+
+	// A vector makes for a different layout each time
+	Nested2 n1{ 1, { "a" }, 2 };
+	Nested2 n2;
+	load_members(save_members(context, FileIdentifier{}, n1), context, n2);
+	ASSERT(n1 == n2);
+	n1.b = { "bc", "def", "ghij" };
+	load_members(save_members(context, FileIdentifier{}, n1), context, n2);
+	ASSERT(n1 == n2);
+	return Void();
+}
+
 TEST_CASE("/flow/FlatBuffers/file_identifier") {
 	Arena arena;
 	TestContext context{ arena };
@@ -510,6 +557,32 @@ TEST_CASE("/flow/FlatBuffers/Standalone") {
 	return Void();
 }
 
+// FlowTransport deserializes each packet with an ArenaObjectReader over the arena of its receive buffer. Strings in the
+// message must point into that buffer, with the buffer kept alive by the message's arena, rather than be copied out:
+// for messages carrying large values the copy would cost more than everything else done with them.
+TEST_CASE("/flow/FlatBuffers/ArenaObjectReaderZeroCopy") {
+	const std::string large(1 << 20, 'v');
+	std::vector<Standalone<StringRef>> in = { Standalone<StringRef>(large), "small"_sr };
+	Standalone<StringRef> received = ObjectWriter::toValue(in, Unversioned());
+
+	std::vector<Standalone<StringRef>> out;
+	{
+		ArenaObjectReader reader(received.arena(), received, Unversioned());
+		reader.deserialize(out);
+	}
+	ASSERT(out.size() == in.size());
+	for (int i = 0; i < out.size(); ++i) {
+		ASSERT(out[i] == in[i]);
+		ASSERT(out[i].begin() >= received.begin() && out[i].end() <= received.end());
+		ASSERT(out[i].arena().sameArena(received.arena()));
+	}
+
+	// The values stay valid once the buffer's own reference is gone
+	received = Standalone<StringRef>();
+	ASSERT(out[0] == StringRef(large));
+	return Void();
+}
+
 // Meant to be run with valgrind or asan, to catch heap buffer overflows
 TEST_CASE("/flow/FlatBuffers/Void") {
 	Standalone<StringRef> msg = ObjectWriter::toValue(Void(), Unversioned());
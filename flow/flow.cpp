@@ -31,6 +31,7 @@
 
 #include "flow/DeterministicRandom.h"
 #include "flow/Error.h"
+#include "flow/FastRandom.h"
 #include "flow/Hostname.h"
 #include "flow/rte_memcpy.h"
 #include "flow/UnitTest.h"
@@ -110,6 +111,7 @@ bool noUnseed = false;
 void setThreadLocalDeterministicRandomSeed(uint32_t seed) {
 	seededRandom = Reference<IRandom>(new DeterministicRandom(seed, true));
 	seededDebugRandom = Reference<IRandom>(new DeterministicRandom(seed));
+	fastRandom().seed(seed);
 }
 
 Reference<IRandom> debugRandom() {
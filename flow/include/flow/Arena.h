@@ -34,6 +34,7 @@
 #include "flow/Traceable.h"
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <boost/functional/hash.hpp>
 #include <iterator>
 #include <stdint.h>
@@ -47,6 +48,11 @@
 #include <sstream>
 #include <string_view>
 #include <fmt/format.h>
+#if defined(__SSE2__) || defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 
 // TrackIt is a zero-size class for tracking constructions, destructions, and assignments of instances
 // of a class.  Just inherit TrackIt<T> from T to enable tracking of construction and destruction of
@@ -124,6 +130,8 @@ public:
 	// When fastInaccurateEstimate is false, all estimates in the block tree will be updated to
 	// be accurate.
 	size_t getSize(FastInaccurateEstimate = FastInaccurateEstimate::False) const;
+	// getSize(FastInaccurateEstimate::True) less the space still free in the block the next allocation comes from
+	size_t getUsedEstimate() const;
 
 	bool hasFree(size_t size, const void* address);
 
@@ -172,11 +180,12 @@ struct ArenaBlock : NonCopyable, ThreadSafeReferenceCounted<ArenaBlock> {
 		LARGE = 8193 // If size == used == LARGE, then use hugeSize, hugeUsed
 	};
 
-	enum { NOT_TINY = 127, TINY_HEADER = 6 };
+	enum { NOT_TINY = 127, NOT_TINY_SAMPLED = 255, TINY_HEADER = 6 };
 
 	// int32_t referenceCount;	  // 4 bytes (in ThreadSafeReferenceCounted)
 	bool secure : 1; // If this is set, block is zero-ed out after use
 	uint8_t tinySize : 7, tinyUsed; // If these == NOT_TINY, use bigSize, bigUsed instead
+	// tinyUsed is NOT_TINY_SAMPLED instead of NOT_TINY in blocks the arena profiler sampled
 	// if tinySize != NOT_TINY, following variables aren't used
 	uint32_t bigSize, bigUsed; // include block header
 	uint32_t nextBlockOffset;
@@ -209,6 +218,35 @@ struct ArenaBlock : NonCopyable, ThreadSafeReferenceCounted<ArenaBlock> {
 	static void* operator new(size_t s) = delete;
 };
 
+// Learns how much memory the arenas made at one call site end up holding, so that the first block of the next one is
+// big enough for all of it rather than growing block by block. Keep one per call site, in a static:
+//
+//   static AdaptiveArenaSize replyArenaSize;
+//   reply.arena = replyArenaSize.makeArena();
+//   ... fill reply.arena ...
+//   replyArenaSize.observe(reply.arena);
+//
+// The estimate rises quickly and falls slowly, so that it tracks the larger arenas made at the site. It stops at the
+// largest block that is not a huge block, past which doubling costs few allocations compared to the data copied.
+class AdaptiveArenaSize {
+public:
+	Arena makeArena() const { return Arena(estimate.load(std::memory_order_relaxed)); }
+
+	void observe(const Arena& arena) {
+		const int size = std::min<size_t>(arena.getUsedEstimate(), kMaxReserved);
+		int current = estimate.load(std::memory_order_relaxed);
+		// Lost updates from other threads only make the estimate a little less accurate
+		current += size > current ? (size - current + 3) / 4 : (size - current) / 64;
+		estimate.store(current, std::memory_order_relaxed);
+	}
+
+	int reserved() const { return estimate.load(std::memory_order_relaxed); }
+
+private:
+	static constexpr int kMaxReserved = ArenaBlock::LARGE - 1 - sizeof(ArenaBlock);
+	std::atomic<int> estimate = 0;
+};
+
 inline void* operator new(size_t size, Arena& p) {
 	UNSTOPPABLE_ASSERT(size < std::numeric_limits<int>::max());
 	return ArenaBlock::allocate(p.impl, (int)size);
@@ -822,10 +860,61 @@ inline bool operator>=(const StringRef& lhs, const StringRef& rhs) {
 	return !(lhs < rhs);
 }
 
+// Builds for x86 without AVX2 enabled still use it for long prefixes on CPUs that have it
+#if defined(__x86_64__) && !defined(__AVX2__) && (defined(__GNUC__) || defined(__clang__))
+#define FLOW_DISPATCH_AVX2 1
+extern const bool g_cpuHasAVX2;
+int commonPrefixLengthAVX2(uint8_t const* ap, uint8_t const* bp, int cl);
+#endif
+
 typedef uint64_t Word;
 // Get the number of prefix bytes that are the same between a and b, up to their common length of cl
+// Long prefixes are compared a vector at a time, the rest a word and then a byte at a time.
 static inline int commonPrefixLength(uint8_t const* ap, uint8_t const* bp, int cl) {
 	int i = 0;
+
+#if defined(FLOW_DISPATCH_AVX2)
+	// Short prefixes are compared faster inline than through a call
+	if (cl >= 64 && g_cpuHasAVX2) {
+		return commonPrefixLengthAVX2(ap, bp, cl);
+	}
+#elif defined(__AVX2__)
+	for (; i + 32 <= cl; i += 32) {
+		__m256i a = _mm256_loadu_si256((const __m256i*)ap);
+		__m256i b = _mm256_loadu_si256((const __m256i*)bp);
+		uint32_t diff = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b));
+		if (diff != 0) {
+			return i + ctzll(diff);
+		}
+		ap += 32;
+		bp += 32;
+	}
+#endif
+
+#if defined(__SSE2__)
+	for (; i + 16 <= cl; i += 16) {
+		__m128i a = _mm_loadu_si128((const __m128i*)ap);
+		__m128i b = _mm_loadu_si128((const __m128i*)bp);
+		uint32_t diff = ~(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) & 0xFFFF;
+		if (diff != 0) {
+			return i + ctzll(diff);
+		}
+		ap += 16;
+		bp += 16;
+	}
+#elif defined(__aarch64__)
+	for (; i + 16 <= cl; i += 16) {
+		uint8x16_t eq = vceqq_u8(vld1q_u8(ap), vld1q_u8(bp));
+		// Narrow each byte of the comparison result to 4 bits so that the mask fits in a 64 bit lane
+		uint64_t same = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+		if (same != ~(uint64_t)0) {
+			return i + ctzll(~same) / 4;
+		}
+		ap += 16;
+		bp += 16;
+	}
+#endif
+
 	const int wordEnd = cl - sizeof(Word) + 1;
 
 	for (; i < wordEnd; i += sizeof(Word)) {
@@ -0,0 +1,816 @@
+/*
+ * BTreeIndexedSet.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLOW_BTREEINDEXEDSET_H
+#define FLOW_BTREEINDEXEDSET_H
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "flow/IndexedSet.h"
+
+// An ordered set with the interface and metric semantics of IndexedSet, stored as a B+tree. The elements live in
+// arrays in linked leaves, so a search visits a few wide nodes rather than a path of separately allocated ones, and a
+// scan walks arrays. Every inner node keeps the metric total of each of its children, so sumTo() and index() take time
+// proportional to the height of the tree as they do in IndexedSet.
+//
+// Inner nodes hold no copies of elements as separators, since copying an element can be expensive or have side effects
+// (a Future or a Reference in the value of a Map). Each child is instead represented in its parent by the leftmost leaf
+// under it, and searches compare against the first element of that leaf.
+//
+// Unlike IndexedSet, inserting or erasing an element can move other elements, so it invalidates every iterator and
+// reference into the set other than the iterator it returns.
+template <class T, class Metric>
+class BTreeIndexedSet : NonCopyable {
+public:
+	typedef T value_type;
+	typedef T key_type;
+
+	static constexpr int LeafCapacity = std::max<int>(8, std::min<int>(64, 1024 / sizeof(T)));
+	static constexpr int InnerCapacity = 32;
+
+private:
+	struct Inner;
+
+	struct Node {
+		Inner* parent = nullptr;
+		const bool isLeaf;
+
+		explicit Node(bool isLeaf) : isLeaf(isLeaf) {}
+	};
+
+	struct Leaf : Node {
+		Leaf* prev = nullptr;
+		Leaf* next = nullptr;
+		int count = 0;
+		Metric metrics[LeafCapacity];
+		alignas(T) uint8_t slots[LeafCapacity * sizeof(T)];
+
+		Leaf() : Node(true) {}
+		~Leaf() {
+			for (int i = 0; i < count; ++i) {
+				at(i).~T();
+			}
+		}
+
+		T& at(int i) { return reinterpret_cast<T*>(slots)[i]; }
+		const T& at(int i) const { return reinterpret_cast<const T*>(slots)[i]; }
+
+		// Moves the element in src to the unconstructed slot dst
+		static void relocate(T& dst, T& src) {
+			new (&dst) T(std::move(src));
+			src.~T();
+		}
+
+		template <class T_>
+		void insertAt(int pos, T_&& data, Metric const& metric) {
+			for (int i = count; i > pos; --i) {
+				relocate(at(i), at(i - 1));
+				metrics[i] = metrics[i - 1];
+			}
+			new (&at(pos)) T(std::forward<T_>(data));
+			metrics[pos] = metric;
+			++count;
+		}
+
+		// Destroys the elements in [from, to) and returns their metric total
+		Metric eraseRange(int from, int to) {
+			Metric removed = Metric();
+			if (from == to) {
+				return removed;
+			}
+			for (int i = from; i < to; ++i) {
+				removed = removed + metrics[i];
+				at(i).~T();
+			}
+			for (int i = to; i < count; ++i) {
+				relocate(at(from + i - to), at(i));
+				metrics[from + i - to] = metrics[i];
+			}
+			count -= to - from;
+			return removed;
+		}
+
+		// Moves the elements from index from on to the end of dst and returns their metric total
+		Metric moveTo(Leaf* dst, int from) {
+			Metric moved = Metric();
+			for (int i = from; i < count; ++i) {
+				relocate(dst->at(dst->count), at(i));
+				dst->metrics[dst->count++] = metrics[i];
+				moved = moved + metrics[i];
+			}
+			count = from;
+			return moved;
+		}
+
+		// The first index whose element is not less than key, or greater than key if upper is true
+		template <class Key>
+		int search(const Key& key, bool upper) const {
+			int lo = 0, hi = count;
+			while (lo < hi) {
+				int mid = (lo + hi) / 2;
+				if (upper ? !(key < at(mid)) : at(mid) < key) {
+					lo = mid + 1;
+				} else {
+					hi = mid;
+				}
+			}
+			return lo;
+		}
+	};
+
+	struct Inner : Node {
+		int count = 0; // The number of children
+		Node* children[InnerCapacity];
+		Leaf* firsts[InnerCapacity]; // The leftmost leaf under each child, which holds its least element
+		Metric totals[InnerCapacity]; // The metric total of each child
+
+		Inner() : Node(false) {}
+
+		int indexOf(Node const* child) const {
+			for (int i = 0; i < count; ++i) {
+				if (children[i] == child) {
+					return i;
+				}
+			}
+			UNREACHABLE();
+		}
+
+		// The last child whose least element is not greater than key, or the first child
+		template <class Key>
+		int childIndex(const Key& key) const {
+			int lo = 1, hi = count;
+			while (lo < hi) {
+				int mid = (lo + hi) / 2;
+				if (key < firsts[mid]->at(0)) {
+					hi = mid;
+				} else {
+					lo = mid + 1;
+				}
+			}
+			return lo - 1;
+		}
+
+		void insertChild(int pos, Node* child, Leaf* first, Metric const& total) {
+			for (int i = count; i > pos; --i) {
+				children[i] = children[i - 1];
+				firsts[i] = firsts[i - 1];
+				totals[i] = totals[i - 1];
+			}
+			children[pos] = child;
+			firsts[pos] = first;
+			totals[pos] = total;
+			child->parent = this;
+			++count;
+		}
+
+		void removeChild(int pos) {
+			for (int i = pos + 1; i < count; ++i) {
+				children[i - 1] = children[i];
+				firsts[i - 1] = firsts[i];
+				totals[i - 1] = totals[i];
+			}
+			--count;
+		}
+	};
+
+	template <bool isConst>
+	class IteratorImpl {
+		using LeafT = std::conditional_t<isConst, const Leaf, Leaf>;
+
+	public:
+		IteratorImpl() = default;
+		explicit IteratorImpl(const IteratorImpl<!isConst>& nonConstIter)
+		  : leaf(nonConstIter.leaf), index(nonConstIter.index) {
+			static_assert(isConst);
+		}
+
+		std::conditional_t<isConst, const T, T>& operator*() const { return leaf->at(index); }
+		std::conditional_t<isConst, const T, T>* operator->() const { return &leaf->at(index); }
+
+		void operator++() {
+			if (++index == leaf->count) {
+				leaf = leaf->next;
+				index = 0;
+			}
+		}
+		// Like IndexedSet, the element before the first one is end()
+		void decrementNonEnd() {
+			if (index > 0) {
+				--index;
+			} else {
+				leaf = leaf->prev;
+				index = leaf ? leaf->count - 1 : 0;
+			}
+		}
+
+		bool operator==(const IteratorImpl& r) const { return leaf == r.leaf && index == r.index; }
+		bool operator!=(const IteratorImpl& r) const { return !(*this == r); }
+
+	private:
+		friend class BTreeIndexedSet;
+		friend class IteratorImpl<!isConst>;
+
+		IteratorImpl(LeafT* leaf, int index) : leaf(leaf), index(index) {}
+
+		LeafT* leaf = nullptr;
+		int index = 0;
+	};
+
+public:
+	using iterator = IteratorImpl<false>;
+	using const_iterator = IteratorImpl<true>;
+
+	BTreeIndexedSet() = default;
+	~BTreeIndexedSet() { clear(); }
+	BTreeIndexedSet(BTreeIndexedSet&& r) noexcept : root(r.root), first(r.first), last(r.last), total(r.total) {
+		r.root = nullptr;
+		r.first = r.last = nullptr;
+		r.total = Metric();
+	}
+	BTreeIndexedSet& operator=(BTreeIndexedSet&& r) noexcept {
+		clear();
+		swap(r);
+		return *this;
+	}
+
+	const_iterator begin() const { return const_iterator(first, 0); }
+	iterator begin() { return iterator(first, 0); }
+	const_iterator cbegin() const { return begin(); }
+
+	const_iterator end() const { return const_iterator(); }
+	iterator end() { return iterator(); }
+	const_iterator cend() const { return end(); }
+
+	const_iterator previous(const_iterator i) const {
+		if (i == end()) {
+			return lastItem();
+		}
+		i.decrementNonEnd();
+		return i;
+	}
+	const_iterator previous(iterator i) const { return previous(const_iterator{ i }); }
+	iterator previous(iterator i) {
+		if (i == end()) {
+			return lastItem();
+		}
+		i.decrementNonEnd();
+		return i;
+	}
+
+	const_iterator lastItem() const { return last ? const_iterator(last, last->count - 1) : end(); }
+	iterator lastItem() { return last ? iterator(last, last->count - 1) : end(); }
+
+	bool empty() const { return !root; }
+	void clear() {
+		if (root) {
+			destroyNode(root);
+		}
+		root = nullptr;
+		first = last = nullptr;
+		total = Metric();
+	}
+	void swap(BTreeIndexedSet& r) {
+		std::swap(root, r.root);
+		std::swap(first, r.first);
+		std::swap(last, r.last);
+		std::swap(total, r.total);
+	}
+
+	// Inserts data with the given metric, or if an equal element exists replaces it and its metric if replaceExisting
+	// is true. Returns the element.
+	template <class T_, class Metric_>
+	iterator insert(T_&& data, Metric_&& metric, bool replaceExisting = true) {
+		return insertImpl(std::forward<T_>(data), Metric(std::forward<Metric_>(metric)), replaceExisting).first;
+	}
+
+	// Inserts each element in data, returning the number inserted or replaced
+	int insert(const std::vector<std::pair<T, Metric>>& data, bool replaceExisting = true) {
+		int inserted = 0;
+		for (auto const& d : data) {
+			if (insertImpl(d.first, d.second, replaceExisting).second || replaceExisting) {
+				++inserted;
+			}
+		}
+		return inserted;
+	}
+
+	// Adds metric to the metric of data, inserting data if it is not present. Returns the new metric and the element.
+	template <class T_, class Metric_>
+	std::pair<Metric, iterator> addMetric(T_&& data, Metric_&& metric) {
+		auto i = find(data);
+		Metric m = i == end() ? Metric(metric) : metric + getMetric(i);
+		return { m, insert(std::forward<T_>(data), m) };
+	}
+
+	template <class Key>
+	void erase(const Key& key) {
+		erase(find(key));
+	}
+	void erase(iterator item) {
+		if (item == end()) {
+			return;
+		}
+		iterator next = item;
+		++next;
+		erase(item, next);
+	}
+	template <class Key>
+	void erase(const Key& begin, const Key& end) {
+		erase(lower_bound(begin), lower_bound(end));
+	}
+	void erase(iterator begin, iterator end);
+
+	template <class Key>
+	Future<Void> eraseAsync(const Key& begin, const Key& end) {
+		return eraseAsync(lower_bound(begin), lower_bound(end));
+	}
+	// Erasing everything frees the elements in batches in the background; other ranges are erased immediately.
+	Future<Void> eraseAsync(iterator begin, iterator end) {
+		if (begin == this->begin() && end == this->end() && !empty()) {
+			return uncancellable(ISEraseInBatches(new BTreeIndexedSet(std::move(*this))));
+		}
+		erase(begin, end);
+		return Void();
+	}
+
+	template <class Key>
+	int count(const Key& key) const {
+		return find(key) != end();
+	}
+
+	template <class Key>
+	const_iterator find(const Key& key) const {
+		auto i = lower_bound(key);
+		return i != end() && !(key < *i) ? i : end();
+	}
+	template <class Key>
+	iterator find(const Key& key) {
+		auto i = lower_bound(key);
+		return i != end() && !(key < *i) ? i : end();
+	}
+
+	// The first element not less than key, or end()
+	template <class Key>
+	const_iterator lower_bound(const Key& key) const {
+		return bound<true>(key, false);
+	}
+	template <class Key>
+	iterator lower_bound(const Key& key) {
+		return bound<false>(key, false);
+	}
+
+	// The first element greater than key, or end()
+	template <class Key>
+	const_iterator upper_bound(const Key& key) const {
+		return bound<true>(key, true);
+	}
+	template <class Key>
+	iterator upper_bound(const Key& key) {
+		return bound<false>(key, true);
+	}
+
+	// The last element not greater than key, or end()
+	template <class Key>
+	const_iterator lastLessOrEqual(const Key& key) const {
+		auto i = upper_bound(key);
+		return i == begin() ? end() : previous(i);
+	}
+	template <class Key>
+	iterator lastLessOrEqual(const Key& key) {
+		auto i = upper_bound(key);
+		return i == begin() ? end() : previous(i);
+	}
+
+	// The first element x such that metric < sumTo(x) + getMetric(x), or end()
+	template <class M>
+	const_iterator index(M const& metric) const {
+		auto [leaf, i] = indexImpl(metric);
+		return const_iterator(leaf, i);
+	}
+	template <class M>
+	iterator index(M const& metric) {
+		auto [leaf, i] = indexImpl(metric);
+		return iterator(leaf, i);
+	}
+
+	Metric getMetric(const_iterator x) const { return x.leaf->metrics[x.index]; }
+	Metric getMetric(iterator x) const { return getMetric(const_iterator{ x }); }
+
+	// The metric total of the elements before to
+	Metric sumTo(const_iterator to) const;
+	Metric sumTo(iterator to) const { return sumTo(const_iterator{ to }); }
+
+	Metric sumRange(const_iterator begin, const_iterator end) const { return sumTo(end) - sumTo(begin); }
+	Metric sumRange(iterator begin, iterator end) const {
+		return sumTo(const_iterator{ end }) - sumTo(const_iterator{ begin });
+	}
+	template <class Key>
+	Metric sumRange(const Key& begin, const Key& end) const {
+		return sumRange(lower_bound(begin), lower_bound(end));
+	}
+
+	// Per element memory: a slot and a metric in a leaf, which is typically around half full
+	constexpr static int getElementBytes() { return 2 * (sizeof(T) + sizeof(Metric)); }
+
+	// Checks the structure, order and metric totals of the tree
+	void testonly_assertValid() const;
+
+private:
+	Node* root = nullptr;
+	Leaf* first = nullptr;
+	Leaf* last = nullptr;
+	Metric total = Metric();
+
+	static Leaf* firstLeafOf(Node* node) {
+		return node->isLeaf ? static_cast<Leaf*>(node) : static_cast<Inner*>(node)->firsts[0];
+	}
+
+	template <class Key>
+	Leaf* findLeaf(const Key& key) const {
+		Node* node = root;
+		while (!node->isLeaf) {
+			Inner* inner = static_cast<Inner*>(node);
+			node = inner->children[inner->childIndex(key)];
+		}
+		return static_cast<Leaf*>(node);
+	}
+
+	template <bool isConst, class Key>
+	IteratorImpl<isConst> bound(const Key& key, bool upper) const {
+		if (!root) {
+			return IteratorImpl<isConst>();
+		}
+		Leaf* leaf = findLeaf(key);
+		int i = leaf->search(key, upper);
+		if (i < leaf->count) {
+			return IteratorImpl<isConst>(leaf, i);
+		}
+		return IteratorImpl<isConst>(leaf->next, 0);
+	}
+
+	template <class M>
+	std::pair<Leaf*, int> indexImpl(M m) const {
+		if (!root) {
+			return { nullptr, 0 };
+		}
+		Node* node = root;
+		while (!node->isLeaf) {
+			Inner* inner = static_cast<Inner*>(node);
+			int i = 0;
+			for (; i < inner->count && !(m < inner->totals[i]); ++i) {
+				m = m - inner->totals[i];
+			}
+			if (i == inner->count) {
+				return { nullptr, 0 };
+			}
+			node = inner->children[i];
+		}
+		Leaf* leaf = static_cast<Leaf*>(node);
+		for (int i = 0; i < leaf->count; ++i) {
+			if (m < leaf->metrics[i]) {
+				return { leaf, i };
+			}
+			m = m - leaf->metrics[i];
+		}
+		return { nullptr, 0 };
+	}
+
+	// Returns the element and whether it was inserted rather than already present
+	template <class T_>
+	std::pair<iterator, bool> insertImpl(T_&& data, Metric const& metric, bool replaceExisting);
+
+	void addToAncestors(Node* node, Metric const& delta) {
+		for (; node->parent; node = node->parent) {
+			Inner* parent = node->parent;
+			int i = parent->indexOf(node);
+			parent->totals[i] = parent->totals[i] + delta;
+		}
+		total = total + delta;
+	}
+	void subtractFromAncestors(Node* node, Metric const& delta) {
+		for (; node->parent; node = node->parent) {
+			Inner* parent = node->parent;
+			int i = parent->indexOf(node);
+			parent->totals[i] = parent->totals[i] - delta;
+		}
+		total = total - delta;
+	}
+
+	// Updates the leftmost leaves recorded for node by its ancestors after the first child of node changed
+	static void updateFirsts(Inner* node) {
+		for (Node* n = node; n->parent; n = n->parent) {
+			Inner* parent = n->parent;
+			int i = parent->indexOf(n);
+			parent->firsts[i] = firstLeafOf(n);
+			if (i != 0) {
+				break;
+			}
+		}
+	}
+
+	Leaf* splitLeaf(Leaf* leaf);
+	void splitInner(Inner* inner);
+	void insertAfter(Node* left, Node* right, Metric const& rightTotal);
+	void removeLeaf(Leaf* leaf);
+	void removeNode(Node* node);
+	void mergeIfUnderfull(Leaf* leaf);
+
+	static void destroyNode(Node* node) {
+		if (node->isLeaf) {
+			delete static_cast<Leaf*>(node);
+		} else {
+			Inner* inner = static_cast<Inner*>(node);
+			for (int i = 0; i < inner->count; ++i) {
+				destroyNode(inner->children[i]);
+			}
+			delete inner;
+		}
+	}
+
+	Metric assertValid(Node const* node, int depth, int& leafDepth, Leaf const*& prevLeaf) const;
+};
+
+/////////////////////// implementation //////////////////////////
+
+template <class T, class Metric>
+template <class T_>
+std::pair<typename BTreeIndexedSet<T, Metric>::iterator, bool>
+BTreeIndexedSet<T, Metric>::insertImpl(T_&& data, Metric const& metric, bool replaceExisting) {
+	if (!root) {
+		Leaf* leaf = new Leaf();
+		root = first = last = leaf;
+	}
+	Leaf* leaf = findLeaf(data);
+	int pos = leaf->search(data, false);
+	if (pos < leaf->count && !(data < leaf->at(pos))) {
+		if (replaceExisting) {
+			leaf->at(pos) = std::forward<T_>(data);
+			Metric delta = metric - leaf->metrics[pos];
+			leaf->metrics[pos] = metric;
+			addToAncestors(leaf, delta);
+		}
+		return { iterator(leaf, pos), false };
+	}
+
+	if (leaf->count == LeafCapacity) {
+		Leaf* right = splitLeaf(leaf);
+		if (pos >= leaf->count) {
+			pos -= leaf->count;
+			leaf = right;
+		}
+	}
+	leaf->insertAt(pos, std::forward<T_>(data), metric);
+	addToAncestors(leaf, metric);
+	return { iterator(leaf, pos), true };
+}
+
+template <class T, class Metric>
+void BTreeIndexedSet<T, Metric>::erase(iterator begin, iterator end) {
+	if (begin == end) {
+		return;
+	}
+	// Every leaf between the first and the last one touched is emptied and removed, so only those two can be left
+	// sparsely populated
+	Leaf* leaf = begin.leaf;
+	int from = begin.index;
+	Leaf* firstSurvivor = nullptr;
+	Leaf* lastSurvivor = nullptr;
+	while (true) {
+		bool lastLeaf = leaf == end.leaf;
+		Leaf* next = leaf->next;
+		subtractFromAncestors(leaf, leaf->eraseRange(from, lastLeaf ? end.index : leaf->count));
+		if (leaf->count == 0) {
+			removeLeaf(leaf);
+		} else if (!firstSurvivor) {
+			firstSurvivor = leaf;
+		} else {
+			lastSurvivor = leaf;
+		}
+		if (lastLeaf || !next) {
+			break;
+		}
+		leaf = next;
+		from = 0;
+	}
+	// Merging the last survivor can only free it or the leaf after it, never the first survivor
+	if (lastSurvivor) {
+		mergeIfUnderfull(lastSurvivor);
+	}
+	if (firstSurvivor) {
+		mergeIfUnderfull(firstSurvivor);
+	}
+}
+
+template <class T, class Metric>
+Metric BTreeIndexedSet<T, Metric>::sumTo(const_iterator to) const {
+	if (!to.leaf) {
+		return total;
+	}
+	Metric m = Metric();
+	for (int i = 0; i < to.index; ++i) {
+		m = m + to.leaf->metrics[i];
+	}
+	for (Node const* node = to.leaf; node->parent; node = node->parent) {
+		Inner const* parent = node->parent;
+		int n = parent->indexOf(node);
+		for (int i = 0; i < n; ++i) {
+			m = m + parent->totals[i];
+		}
+	}
+	return m;
+}
+
+// Moves the upper half of a full leaf into a new leaf following it, and returns the new leaf
+template <class T, class Metric>
+typename BTreeIndexedSet<T, Metric>::Leaf* BTreeIndexedSet<T, Metric>::splitLeaf(Leaf* leaf) {
+	Leaf* right = new Leaf();
+	Metric moved = leaf->moveTo(right, leaf->count / 2);
+
+	right->prev = leaf;
+	right->next = leaf->next;
+	if (leaf->next) {
+		leaf->next->prev = right;
+	} else {
+		last = right;
+	}
+	leaf->next = right;
+
+	insertAfter(leaf, right, moved);
+	return right;
+}
+
+template <class T, class Metric>
+void BTreeIndexedSet<T, Metric>::splitInner(Inner* inner) {
+	Inner* right = new Inner();
+	int half = inner->count / 2;
+	Metric moved = Metric();
+	for (int i = half; i < inner->count; ++i) {
+		right->insertChild(i - half, inner->children[i], inner->firsts[i], inner->totals[i]);
+		moved = moved + inner->totals[i];
+	}
+	inner->count = half;
+	insertAfter(inner, right, moved);
+}
+
+// Makes right, whose elements were just moved out of left, the next sibling of left
+template <class T, class Metric>
+void BTreeIndexedSet<T, Metric>::insertAfter(Node* left, Node* right, Metric const& rightTotal) {
+	if (!left->parent) {
+		Inner* inner = new Inner();
+		inner->insertChild(0, left, firstLeafOf(left), total);
+		root = inner;
+	}
+	if (left->parent->count == InnerCapacity) {
+		splitInner(left->parent);
+	}
+	Inner* parent = left->parent;
+	int i = parent->indexOf(left);
+	parent->totals[i] = parent->totals[i] - rightTotal;
+	parent->insertChild(i + 1, right, firstLeafOf(right), rightTotal);
+}
+
+// Unlinks and frees an empty leaf
+template <class T, class Metric>
+void BTreeIndexedSet<T, Metric>::removeLeaf(Leaf* leaf) {
+	if (leaf->prev) {
+		leaf->prev->next = leaf->next;
+	} else {
+		first = leaf->next;
+	}
+	if (leaf->next) {
+		leaf->next->prev = leaf->prev;
+	} else {
+		last = leaf->prev;
+	}
+	removeNode(leaf);
+}
+
+// Frees a node with no elements under it, along with any ancestors left without children, and shortens the tree while
+// the root has a single child
+template <class T, class Metric>
+void BTreeIndexedSet<T, Metric>::removeNode(Node* node) {
+	Inner* parent = node->parent;
+	int i = parent ? parent->indexOf(node) : 0;
+	if (node->isLeaf) {
+		delete static_cast<Leaf*>(node);
+	} else {
+		delete static_cast<Inner*>(node);
+	}
+	if (!parent) {
+		root = nullptr;
+		return;
+	}
+	parent->removeChild(i);
+	if (parent->count == 0) {
+		removeNode(parent);
+		return;
+	}
+	if (i == 0) {
+		updateFirsts(parent);
+	}
+	while (!root->isLeaf && static_cast<Inner*>(root)->count == 1) {
+		Inner* oldRoot = static_cast<Inner*>(root);
+		root = oldRoot->children[0];
+		root->parent = nullptr;
+		delete oldRoot;
+	}
+}
+
+// Folds a sparsely populated leaf into a neighbour under the same parent, so that erasing elements one at a time does
+// not leave the tree full of nearly empty leaves
+template <class T, class Metric>
+void BTreeIndexedSet<T, Metric>::mergeIfUnderfull(Leaf* leaf) {
+	if (leaf->count >= LeafCapacity / 4) {
+		return;
+	}
+	Leaf* left = leaf;
+	Leaf* right = leaf->next;
+	if (!right || right->parent != leaf->parent || leaf->count + right->count > LeafCapacity * 3 / 4) {
+		right = leaf;
+		left = leaf->prev;
+		if (!left || left->parent != leaf->parent || leaf->count + left->count > LeafCapacity * 3 / 4) {
+			return;
+		}
+	}
+	Metric moved = right->moveTo(left, 0);
+	Inner* parent = left->parent;
+	int i = parent->indexOf(left);
+	parent->totals[i] = parent->totals[i] + moved;
+	parent->totals[i + 1] = parent->totals[i + 1] - moved;
+	removeLeaf(right);
+}
+
+template <class T, class Metric>
+void BTreeIndexedSet<T, Metric>::testonly_assertValid() const {
+	if (!root) {
+		ASSERT(!first && !last);
+		return;
+	}
+	ASSERT(!root->parent);
+	ASSERT(first == firstLeafOf(root) && !first->prev);
+	int leafDepth = -1;
+	Leaf const* prevLeaf = nullptr;
+	Metric m = assertValid(root, 0, leafDepth, prevLeaf);
+	ASSERT(!(m < total) && !(total < m));
+	ASSERT(prevLeaf == last && !last->next);
+}
+
+// Returns the metric total of node, checking that its leaves are all at the same depth and linked in order
+template <class T, class Metric>
+Metric BTreeIndexedSet<T, Metric>::assertValid(Node const* node,
+                                               int depth,
+                                               int& leafDepth,
+                                               Leaf const*& prevLeaf) const {
+	Metric m = Metric();
+	if (node->isLeaf) {
+		Leaf const* leaf = static_cast<Leaf const*>(node);
+		ASSERT(leafDepth == -1 || leafDepth == depth);
+		leafDepth = depth;
+		ASSERT(leaf->count > 0 && leaf->count <= LeafCapacity);
+		ASSERT(leaf->prev == prevLeaf);
+		ASSERT(!prevLeaf || prevLeaf->next == leaf);
+		ASSERT(!prevLeaf || prevLeaf->at(prevLeaf->count - 1) < leaf->at(0));
+		for (int i = 0; i < leaf->count; ++i) {
+			ASSERT(i == 0 || leaf->at(i - 1) < leaf->at(i));
+			m = m + leaf->metrics[i];
+		}
+		prevLeaf = leaf;
+		return m;
+	}
+	Inner const* inner = static_cast<Inner const*>(node);
+	ASSERT(inner->count > 0 && inner->count <= InnerCapacity);
+	ASSERT(inner != root || inner->count > 1);
+	for (int i = 0; i < inner->count; ++i) {
+		ASSERT(inner->children[i]->parent == inner);
+		ASSERT(inner->firsts[i] == firstLeafOf(inner->children[i]));
+		Metric c = assertValid(inner->children[i], depth + 1, leafDepth, prevLeaf);
+		ASSERT(!(c < inner->totals[i]) && !(inner->totals[i] < c));
+		m = m + c;
+	}
+	return m;
+}
+
+#endif
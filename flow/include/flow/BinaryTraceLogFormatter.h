@@ -0,0 +1,43 @@
+/*
+ * BinaryTraceLogFormatter.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLOW_BINARY_TRACE_LOG_FORMATTER_H
+#define FLOW_BINARY_TRACE_LOG_FORMATTER_H
+#pragma once
+
+#include "flow/FastRef.h"
+#include "flow/Trace.h"
+
+// Writes trace files that are cheaper for the trace writer thread to produce than XML or JSON, since nothing is
+// escaped, and smaller. contrib/trace_binary_to_json.py turns them into JSON trace files.
+//
+// A file starts with the header "FDBTRACE1\n", followed by the events. An event is the number of its fields, then each
+// field's name and value; numbers are unsigned LEB128 varints, and strings a varint length followed by their bytes.
+struct BinaryTraceLogFormatter final : public ITraceLogFormatter, ReferenceCounted<BinaryTraceLogFormatter> {
+	const char* getExtension() const override;
+	const char* getHeader() const override; // Called when starting a new file
+	const char* getFooter() const override; // Called when ending a file
+	std::string formatEvent(const TraceEventFields&) const override; // Called for each event
+
+	void addref() override;
+	void delref() override;
+};
+
+#endif
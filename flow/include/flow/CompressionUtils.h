@@ -25,6 +25,7 @@
 #include "flow/Arena.h"
 
 #include <unordered_set>
+#include <vector>
 
 enum class CompressionFilter {
 	NONE,
@@ -32,11 +33,46 @@ enum class CompressionFilter {
 	LAST // Always the last member
 };
 
+// A zstd dictionary, trained from samples of small records that look alike, such as the values under one key prefix.
+// Records of a few hundred bytes compress poorly on their own; with a dictionary of what they have in common they
+// compress several times better. A record compressed with a dictionary can only be decompressed with the same one,
+// whose ID zstd writes into the record (see CompressionUtils::getDictionaryId).
+class CompressionDictionary : public ReferenceCounted<CompressionDictionary>, NonCopyable {
+public:
+	// Trains a dictionary of at most maxSize bytes, to compress at the given level. Returns an invalid reference if
+	// there are too few samples, or too little in common between them, to train one.
+	static Reference<CompressionDictionary> train(const std::vector<StringRef>& samples, int maxSize, int level);
+	// Loads a dictionary from the bytes() of one trained earlier
+	static Reference<CompressionDictionary> load(const StringRef& bytes, int level);
+
+	~CompressionDictionary();
+
+	uint32_t id() const { return dictId; }
+	// What to store to load the dictionary again
+	StringRef bytes() const { return content; }
+
+private:
+	friend struct CompressionUtils;
+	CompressionDictionary(const StringRef& content, int level);
+
+	Standalone<StringRef> content;
+	uint32_t dictId = 0;
+	// The dictionary digested for compressing and decompressing, a ZSTD_CDict and a ZSTD_DDict
+	void* cdict = nullptr;
+	void* ddict = nullptr;
+};
+
 struct CompressionUtils {
 	static StringRef compress(const CompressionFilter filter, const StringRef& data, Arena& arena);
 	static StringRef compress(const CompressionFilter filter, const StringRef& data, int level, Arena& arena);
 	static StringRef decompress(const CompressionFilter filter, const StringRef& data, Arena& arena);
 
+	// ZSTD with a dictionary, at the level the dictionary was made for
+	static StringRef compress(const CompressionDictionary& dictionary, const StringRef& data, Arena& arena);
+	static StringRef decompress(const CompressionDictionary& dictionary, const StringRef& data, Arena& arena);
+	// The ID of the dictionary data was compressed with, or 0 if it was compressed without one
+	static uint32_t getDictionaryId(const StringRef& data);
+
 	static int getDefaultCompressionLevel(CompressionFilter filter);
 	static CompressionFilter getRandomFilter();
 
@@ -87,13 +87,13 @@ struct GetFutureType<FutureStream<T> const&> {
 template <class F>
 inline constexpr FutureType GetFutureTypeV = GetFutureType<F>::value;
 
+// The SAV of a coroutine returning a Future. It lives in the coroutine's frame, which, like the object of an actor
+// compiled by the actor compiler, stays after the coroutine returns for as long as there are futures of it; destroying
+// the SAV destroys the frame.
 template <class T, bool IsCancellable>
 struct CoroActor final : Actor<std::conditional_t<std::is_void_v<T>, Void, T>> {
 	using ValType = std::conditional_t<std::is_void_v<T>, Void, T>;
 
-	static void* operator new(size_t s) { return allocateFast(int(s)); }
-	static void operator delete(void* p, size_t s) { freeFast(int(s), p); }
-
 	n_coroutine::coroutine_handle<> handle;
 
 	int8_t& waitState() { return Actor<ValType>::actor_wait_state; }
@@ -120,7 +120,7 @@ struct CoroActor final : Actor<std::conditional_t<std::is_void_v<T>, Void, T>> {
 		}
 	}
 
-	void destroy() override { delete this; }
+	void destroy() override { handle.destroy(); }
 };
 
 template <class U>
@@ -292,13 +292,13 @@ template <class T, class Promise>
 struct CoroReturn {
 	template <class U>
 	void return_value(U&& value) {
-		static_cast<Promise*>(this)->coroActor->set(std::forward<U>(value));
+		static_cast<Promise*>(this)->coroActor.set(std::forward<U>(value));
 	}
 };
 
 template <class Promise>
 struct CoroReturn<Void, Promise> {
-	void return_void() { static_cast<Promise*>(this)->coroActor->set(Void()); }
+	void return_void() { static_cast<Promise*>(this)->coroActor.set(Void()); }
 };
 
 template <class T, bool IsCancellable>
@@ -308,38 +308,41 @@ struct CoroPromise : CoroReturn<T, CoroPromise<T, IsCancellable>> {
 	using ReturnValue = std::conditional_t<std::is_void_v<T>, Void, T>;
 	using ReturnFutureType = Future<ReturnValue>;
 
-	ActorType* coroActor;
-
-	CoroPromise() : coroActor(new ActorType()) {}
+	ActorType coroActor;
 
 	n_coroutine::coroutine_handle<promise_type> handle() {
 		return n_coroutine::coroutine_handle<promise_type>::from_promise(*this);
 	}
 
-	static void* operator new(size_t s) { return allocateFast(int(s)); }
-	static void operator delete(void* p, size_t s) { freeFast(int(s), p); }
+	static void* operator new(size_t s) { return allocateFastFrame(int(s)); }
+	static void operator delete(void* p, size_t s) { freeFastFrame(int(s), p); }
 
-	ReturnFutureType get_return_object() noexcept { return ReturnFutureType(coroActor); }
+	ReturnFutureType get_return_object() noexcept {
+		coroActor.handle = handle();
+		return ReturnFutureType(&coroActor);
+	}
 
 	[[nodiscard]] n_coroutine::suspend_never initial_suspend() const noexcept { return {}; }
 
+	// The coroutine stays suspended at its end, and its frame is destroyed with its SAV, which may be by the time
+	// sending its result returns
 	auto final_suspend() noexcept {
 		struct FinalAwaitable {
 			ActorType* sav;
 			// for debugging output only
 			explicit FinalAwaitable(ActorType* sav) : sav(sav) {}
 
-			[[nodiscard]] bool await_ready() const noexcept { return true; }
-			void await_resume() const noexcept {
+			[[nodiscard]] bool await_ready() const noexcept { return false; }
+			void await_suspend(n_coroutine::coroutine_handle<>) const noexcept {
 				if (sav->isError()) {
 					sav->finishSendErrorAndDelPromiseRef();
 				} else {
 					sav->finishSendAndDelPromiseRef();
 				}
 			}
-			constexpr void await_suspend(n_coroutine::coroutine_handle<>) const noexcept {}
+			constexpr void await_resume() const noexcept {}
 		};
-		return FinalAwaitable(coroActor);
+		return FinalAwaitable(&coroActor);
 	}
 
 	void unhandled_exception() {
@@ -350,19 +353,19 @@ struct CoroPromise : CoroReturn<T, CoroPromise<T, IsCancellable>> {
 			// if (Actor<ReturnValue>::actor_wait_state == -1 && error.code() == error_code_operation_cancelled) {
 			// 	return;
 			// }
-			coroActor->setError(error);
+			coroActor.setError(error);
 			// SAV<ReturnValue>::sendErrorAndDelPromiseRef(error);
 		} catch (...) {
-			coroActor->setError(unknown_error());
+			coroActor.setError(unknown_error());
 			// SAV<ReturnValue>::sendErrorAndDelPromiseRef(unknown_error());
 		}
 	}
 
-	void setHandle(n_coroutine::coroutine_handle<> h) { coroActor->handle = h; }
+	void setHandle(n_coroutine::coroutine_handle<> h) { coroActor.handle = h; }
 
-	void resume() { coroActor->handle.resume(); }
+	void resume() { coroActor.handle.resume(); }
 
-	int8_t& waitState() { return coroActor->waitState(); }
+	int8_t& waitState() { return coroActor.waitState(); }
 
 	template <class U>
 	auto await_transform(const Future<U>& future) {
@@ -378,8 +381,8 @@ struct CoroPromise : CoroReturn<T, CoroPromise<T, IsCancellable>> {
 template <class T>
 struct GeneratorPromise {
 	using handle_type = n_coroutine::coroutine_handle<GeneratorPromise<T>>;
-	static void* operator new(size_t s) { return allocateFast(int(s)); }
-	static void operator delete(void* p, size_t s) { freeFast(int(s), p); }
+	static void* operator new(size_t s) { return allocateFastFrame(int(s)); }
+	static void operator delete(void* p, size_t s) { freeFastFrame(int(s), p); }
 
 	Error error;
 	std::optional<T> value;
@@ -422,8 +425,8 @@ template <class T>
 struct AsyncGeneratorPromise {
 	using promise_type = AsyncGeneratorPromise<T>;
 
-	static void* operator new(size_t s) { return allocateFast(int(s)); }
-	static void operator delete(void* p, size_t s) { freeFast(int(s), p); }
+	static void* operator new(size_t s) { return allocateFastFrame(int(s)); }
+	static void operator delete(void* p, size_t s) { freeFastFrame(int(s), p); }
 
 	n_coroutine::coroutine_handle<promise_type> handle() {
 		return n_coroutine::coroutine_handle<promise_type>::from_promise(*this);
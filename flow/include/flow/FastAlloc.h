@@ -103,6 +103,8 @@ void recordDeallocation(void* ptr);
 #endif
 
 inline constexpr auto kFastAllocMagazineBytes = 128 << 10;
+// With FAST_ALLOC_HUGE_PAGES, magazines are carved out of allocations this large
+inline constexpr auto kFastAllocHugePageBytes = 2 << 20;
 
 template <int Size>
 class FastAllocator {
@@ -168,11 +170,26 @@ private:
 	static void* freelist;
 
 	static void getMagazine();
+	// Threads the magazine_size items of a new magazine into a freelist
+	static void linkMagazine(void** block);
 	static void releaseMagazine(void*);
 };
 
 extern std::atomic<int64_t> g_hugeArenaMemory;
 void hugeArenaSample(int size);
+
+// Sampling profile of arena memory by where it was allocated from, on when ARENA_PROFILER_SAMPLE_BYTES is positive.
+// Roughly once every that many bytes of arena blocks, ArenaBlock::create records the backtrace of the allocation and
+// marks the block, so that its release is recorded too. logArenaProfile() traces the call sites holding and
+// allocating the most memory.
+extern thread_local int64_t g_arenaProfilerBytesUntilSample;
+inline bool arenaProfilerShouldSample(int size) {
+	return (g_arenaProfilerBytesUntilSample -= size) < 0;
+}
+// Returns whether block was sampled
+bool arenaProfilerRecordAllocation(const void* block);
+void arenaProfilerRecordRelease(const void* block);
+void logArenaProfile();
 void releaseAllThreadMagazines();
 int64_t getTotalUnusedAllocatedMemory();
 
@@ -281,6 +298,43 @@ public:
 	static void operator delete(void*, void*) {}
 };
 
+// The allocator the actor compiler gives generated actor classes. Like FastAllocated, except that frames of up to
+// 16KB also come from the thread's free list of their size class instead of malloc: actor frames often hold a few
+// hundred bytes of state variables, and a hot actor's frames are created and destroyed at the rate of its calls, which
+// is what the free lists are for. Larger frames are rare and go to malloc.
+template <class Object>
+class ActorAllocated {
+public:
+	// The size class of the frames, or 0 if they are too large for any
+	static constexpr int frameSize = sizeof(Object) <= 64      ? 64
+	                                 : sizeof(Object) <= 16384 ? nextFastAllocatedSize(sizeof(Object))
+	                                                           : 0;
+
+	[[nodiscard]] static void* operator new(size_t s) {
+		if (s != sizeof(Object))
+			abort();
+		INSTRUMENT_ALLOCATE(typeid(Object).name());
+
+		if constexpr (frameSize != 0) {
+			return FastAllocator<frameSize>::allocate();
+		} else {
+			return new uint8_t[sizeof(Object)];
+		}
+	}
+
+	static void operator delete(void* s) {
+		INSTRUMENT_RELEASE(typeid(Object).name());
+
+		if constexpr (frameSize != 0) {
+			FastAllocator<frameSize>::release(s);
+		} else {
+			delete[] reinterpret_cast<uint8_t*>(s);
+		}
+	}
+	static void* operator new(size_t, void* p) { return p; }
+	static void operator delete(void*, void*) {}
+};
+
 [[nodiscard]] inline void* allocateFast(int size) {
 	if (size <= 16)
 		return FastAllocator<16>::allocate();
@@ -313,6 +367,45 @@ inline void freeFast(int size, void* ptr) {
 	delete[] (uint8_t*)ptr;
 }
 
+// Like allocateFast, but sizes of up to 16KB all come from FastAllocator. For coroutine frames, which, like actor
+// frames (see ActorAllocated), are often larger than 256 bytes and short lived, and whose size is only known at run
+// time.
+[[nodiscard]] inline void* allocateFastFrame(int size) {
+	if (size <= 256)
+		return allocateFast(size);
+	if (size <= 512)
+		return FastAllocator<512>::allocate();
+	if (size <= 1024)
+		return FastAllocator<1024>::allocate();
+	if (size <= 2048)
+		return FastAllocator<2048>::allocate();
+	if (size <= 4096)
+		return FastAllocator<4096>::allocate();
+	if (size <= 8192)
+		return FastAllocator<8192>::allocate();
+	if (size <= 16384)
+		return FastAllocator<16384>::allocate();
+	return new uint8_t[size];
+}
+
+inline void freeFastFrame(int size, void* ptr) {
+	if (size <= 256)
+		return freeFast(size, ptr);
+	if (size <= 512)
+		return FastAllocator<512>::release(ptr);
+	if (size <= 1024)
+		return FastAllocator<1024>::release(ptr);
+	if (size <= 2048)
+		return FastAllocator<2048>::release(ptr);
+	if (size <= 4096)
+		return FastAllocator<4096>::release(ptr);
+	if (size <= 8192)
+		return FastAllocator<8192>::release(ptr);
+	if (size <= 16384)
+		return FastAllocator<16384>::release(ptr);
+	delete[] (uint8_t*)ptr;
+}
+
 // Allocate a block of memory aligned to 4096 bytes. Size must be a multiple of
 // 4096. Guaranteed not to return null. Use freeFast4kAligned to free.
 [[nodiscard]] inline void* allocateFast4kAligned(int size) {
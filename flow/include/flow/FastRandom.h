@@ -0,0 +1,117 @@
+/*
+ * FastRandom.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLOW_FAST_RANDOM_H
+#define FLOW_FAST_RANDOM_H
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "flow/Error.h"
+
+// A small, non-virtual random number generator (xoshiro256**) for code that draws many random numbers, such as
+// sampling, where the virtual calls and the Mersenne twister behind deterministicRandom() dominate. Its quality is
+// good for statistics and nothing else: never use it for keys, nonces or anything security sensitive.
+class FastRandom {
+public:
+	explicit FastRandom(uint64_t seed) { this->seed(seed); }
+
+	void seed(uint64_t seed) {
+		// splitmix64 spreads the seed over the whole state, which must not be all zeros
+		for (uint64_t& word : s) {
+			uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+			word = z ^ (z >> 31);
+		}
+	}
+
+	uint64_t randomUInt64() {
+		const uint64_t result = rotl(s[1] * 5, 7) * 9;
+		const uint64_t t = s[1] << 17;
+		s[2] ^= s[0];
+		s[3] ^= s[1];
+		s[1] ^= s[2];
+		s[0] ^= s[3];
+		s[2] ^= t;
+		s[3] = rotl(s[3], 45);
+		return result;
+	}
+
+	uint32_t randomUInt32() { return randomUInt64() >> 32; }
+
+	// Returns a value in [0, 1)
+	double random01() { return (randomUInt64() >> 11) * 0x1.0p-53; }
+
+	// Returns a value in [min, maxPlusOne), by multiplying rather than dividing. The bias is below range / 2^32.
+	int randomInt(int min, int maxPlusOne) {
+		ASSERT_LT(min, maxPlusOne);
+		const uint64_t range = uint32_t(maxPlusOne) - uint32_t(min);
+		return int(uint32_t(min) + uint32_t((randomUInt32() * range) >> 32));
+	}
+
+	// Returns a value in [min, maxPlusOne)
+	int64_t randomInt64(int64_t min, int64_t maxPlusOne) {
+		ASSERT_LT(min, maxPlusOne);
+		const uint64_t range = uint64_t(maxPlusOne) - uint64_t(min);
+		return int64_t(uint64_t(min) + randomUInt64() % range);
+	}
+
+	bool coinflip() { return int64_t(randomUInt64()) < 0; }
+
+	// Batch forms, for code that needs many numbers at once. They produce the same sequence as the single forms.
+	void randomUInt64s(uint64_t* out, int count) {
+		for (int i = 0; i < count; ++i) {
+			out[i] = randomUInt64();
+		}
+	}
+
+	void random01s(double* out, int count) {
+		for (int i = 0; i < count; ++i) {
+			out[i] = random01();
+		}
+	}
+
+	void randomBytes(uint8_t* buf, int length) {
+		for (int i = 0; i < length; i += sizeof(uint64_t)) {
+			const uint64_t val = randomUInt64();
+			memcpy(buf + i, &val, std::min<int>(sizeof(uint64_t), length - i));
+		}
+	}
+
+	// The seed of each thread's generator when setThreadLocalDeterministicRandomSeed() has not been called on it
+	static uint64_t unseeded();
+
+private:
+	static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+	uint64_t s[4];
+};
+
+// This thread's FastRandom. setThreadLocalDeterministicRandomSeed() seeds it along with deterministicRandom(), so it is
+// deterministic in simulation, and drawing from it does not change the sequence of deterministicRandom().
+inline FastRandom& fastRandom() {
+	static thread_local FastRandom random(FastRandom::unseeded());
+	return random;
+}
+
+#endif
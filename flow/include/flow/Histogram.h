@@ -23,14 +23,11 @@
 #pragma once
 
 #include <flow/Arena.h>
+#include <bit>
 #include <string>
 #include <map>
 #include <unordered_map>
 #include <iomanip>
-#ifdef _WIN32
-#include <intrin.h>
-#pragma intrinsic(_BitScanReverse)
-#endif
 
 class Histogram;
 
@@ -104,31 +101,15 @@ public:
 		}
 	}
 
+	// The bucket of a sample: floor(log_2(sample)), with 0 going in the same bucket as 1
+	static constexpr size_t bucketIndex(uint32_t sample) { return sample ? std::bit_width(sample) - 1 : 0; }
+
 	// This histogram buckets samples into powers of two.
-	inline void sample(uint32_t sample) {
-		size_t idx;
-#ifdef _WIN32
-		unsigned long index;
-		// _BitScanReverse sets index to the position of the first non-zero bit, so
-		// _BitScanReverse(sample) ~= log_2(sample).  _BitScanReverse returns false if
-		// sample is zero.
-		idx = _BitScanReverse(&index, sample) ? index : 0;
-#else
-		// __builtin_clz counts the leading zeros in its uint32_t argument.  So, 31-clz ~= log_2(sample).
-		// __builtin_clz(0) is undefined.
-		idx = sample ? (31 - __builtin_clz(sample)) : 0;
-#endif
-		ASSERT(idx < 32);
-		buckets[idx]++;
-	}
+	inline void sample(uint32_t sample) { buckets[bucketIndex(sample)]++; }
 
 	inline void sampleSeconds(double delta) {
-		uint64_t delta_usec = (delta * 1000000);
-		if (delta_usec > UINT32_MAX) {
-			sample(UINT32_MAX);
-		} else {
-			sample((uint32_t)(delta * 1000000)); // convert to microseconds and truncate to integer
-		}
+		uint64_t delta_usec = (delta * 1000000); // convert to microseconds and truncate to integer
+		sample(delta_usec > UINT32_MAX ? UINT32_MAX : (uint32_t)delta_usec);
 	}
 	// Histogram buckets samples into linear interval of size 4 percent.
 	inline void samplePercentage(double pct) {
@@ -30,6 +30,7 @@
 #include "flow/NetworkAddress.h"
 
 class Void;
+struct PacketBuffer;
 
 template <typename T>
 class Future;
@@ -69,6 +70,11 @@ public:
 	// the first buffer in the chain.
 	virtual int write(SendBuffer const* buffer, int limit = std::numeric_limits<int>::max()) = 0;
 
+	// Like write(), for a chain of PacketBuffers. Knowing that they are reference counted lets a connection send large
+	// writes without copying them into the socket buffer, holding references to them until the kernel is done with
+	// them. Connections that can't do that just write().
+	virtual int writePackets(PacketBuffer* buffer, int limit);
+
 	// Returns the network address and port of the other end of the connection.  In the case of an incoming connection,
 	// this may not be an address we can connect to!
 	virtual NetworkAddress getPeerAddress() const = 0;
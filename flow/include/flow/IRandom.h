@@ -195,7 +195,7 @@ public:
 
 extern FILE* randLog;
 
-// Sets the seed for the deterministic random number generator on the current thread
+// Sets the seed for the deterministic random number generator on the current thread, and for its fastRandom()
 void setThreadLocalDeterministicRandomSeed(uint32_t seed);
 
 // Returns the random number generator that can be seeded. This generator should only
@@ -56,12 +56,25 @@ struct ThreadAction {
 };
 typedef ThreadAction* PThreadAction;
 
+// Where and how urgently a posted action should run, for thread pools that schedule by it (see
+// createWorkStealingThreadPool). Other pools ignore it.
+struct ThreadActionHint {
+	enum class Priority { High = 0, Normal, Low };
+	static constexpr int kPriorities = 3;
+
+	// Actions with the same nonzero affinity, such as a pointer to what they read, are queued on the same thread, where
+	// that is more likely to be in cache. Another thread still takes them if that one is busy.
+	uint64_t affinity = 0;
+	Priority priority = Priority::Normal;
+};
+
 class IThreadPool {
 public:
 	virtual ~IThreadPool() {}
 	virtual Future<Void> getError() const = 0; // asynchronously throws an error if there is an internal error
 	virtual void addThread(IThreadPoolReceiver* userData, const char* name = nullptr) = 0;
 	virtual void post(PThreadAction action) = 0;
+	virtual void postWithHint(PThreadAction action, ThreadActionHint const& hint) { post(action); }
 	virtual Future<Void> stop(Error const& e = success()) = 0;
 	virtual bool isCoro() const { return false; }
 	virtual void addref() = 0;
@@ -146,6 +159,12 @@ private:
 
 Reference<IThreadPool> createGenericThreadPool(int stackSize = 0, int pri = 10);
 
+// A thread pool in which each thread has its own queues, one per ThreadActionHint priority, and takes from the others'
+// when its own are empty, so that posting and taking actions do not all contend on one lock. Actions are taken in
+// priority order, over all threads' queues, and in posting order within a queue. Every
+// WORK_STEALING_POOL_METRICS_INTERVAL seconds it traces WorkStealingThreadPoolMetrics with `name`.
+Reference<IThreadPool> createWorkStealingThreadPool(const char* name, int stackSize = 0, int pri = 10);
+
 class DummyThreadPool final : public IThreadPool, ReferenceCounted<DummyThreadPool> {
 public:
 	~DummyThreadPool() override {}
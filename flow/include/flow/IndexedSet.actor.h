@@ -71,5 +71,22 @@ ACTOR template <class Node>
 	return Void();
 }
 
+ACTOR template <class Set>
+[[flow_allow_discard]] Future<Void> ISEraseInBatches(Set* set) {
+	// Erases the elements of a set that has been detached from its owner a batch at a time, then frees the set
+	while (!set->empty()) {
+		{
+			auto end = set->begin();
+			for (int i = 0; i < 1000 && end != set->end(); ++i) {
+				++end;
+			}
+			set->erase(set->begin(), end);
+		}
+		wait(yield());
+	}
+	delete set;
+	return Void();
+}
+
 #include "flow/unactorcompiler.h"
 #endif
@@ -420,11 +420,17 @@ bool operator<(CompatibleWithKey const& l, MapPair<Key, Value> const& r) {
 	return l < r.key;
 }
 
-template <class Key, class Value, class Pair = MapPair<Key, Value>, class Metric = NoMetric>
+// Set is the ordered container of the pairs, which is IndexedSet unless another container with the same interface is
+// given
+template <class Key,
+          class Value,
+          class Pair = MapPair<Key, Value>,
+          class Metric = NoMetric,
+          class Set = IndexedSet<Pair, Metric>>
 class Map {
 public:
-	typedef typename IndexedSet<Pair, Metric>::iterator iterator;
-	typedef typename IndexedSet<Pair, Metric>::const_iterator const_iterator;
+	typedef typename Set::iterator iterator;
+	typedef typename Set::const_iterator const_iterator;
 
 	Map() {}
 	const_iterator begin() const { return set.begin(); }
@@ -529,7 +535,7 @@ public:
 		return set.sumRange(begin, end);
 	}
 
-	static int getElementBytes() { return IndexedSet<Pair, Metric>::getElementBytes(); }
+	static int getElementBytes() { return Set::getElementBytes(); }
 
 	Map(Map&& r) noexcept : set(std::move(r.set)) {}
 	void operator=(Map&& r) noexcept { set = std::move(r.set); }
@@ -540,7 +546,7 @@ private:
 	Map(Map<Key, Value, Pair> const&); // unimplemented
 	void operator=(Map<Key, Value, Pair> const&); // unimplemented
 
-	IndexedSet<Pair, Metric> set;
+	Set set;
 };
 
 /////////////////////// implementation //////////////////////////
@@ -1409,8 +1415,8 @@ Future<Void> IndexedSet<T, Metric>::eraseAsync(typename IndexedSet<T, Metric>::i
 	return uncancellable(ISFreeNodes(toFree, false));
 }
 
-template <class Key, class Value, class Pair, class Metric>
-Future<Void> Map<Key, Value, Pair, Metric>::clearAsync() {
+template <class Key, class Value, class Pair, class Metric, class Set>
+Future<Void> Map<Key, Value, Pair, Metric, Set>::clearAsync() {
 	return set.eraseAsync(set.begin(), set.end());
 }
 
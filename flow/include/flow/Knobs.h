@@ -131,8 +131,13 @@ public:
 
 	double FAST_ALLOC_LOGGING_BYTES;
 	bool FAST_ALLOC_ALLOW_GUARD_PAGES;
+	// Back FastAllocator magazines with transparent huge pages, 2 MiB at a time. Magazines are not guarded.
+	bool FAST_ALLOC_HUGE_PAGES;
 	double HUGE_ARENA_LOGGING_BYTES;
 	double HUGE_ARENA_LOGGING_INTERVAL;
+	// If positive, arena blocks are sampled about once every this many bytes for the ArenaProfile trace events
+	int64_t ARENA_PROFILER_SAMPLE_BYTES;
+	int ARENA_PROFILER_LOGGED_SITES; // Logged both by live bytes and by allocation rate
 	// This setting allows to let the fdbserver abort instead of exit to generate coredumps
 	// in case of a failure.
 	bool ABORT_ON_FAILURE;
@@ -147,6 +152,8 @@ public:
 	double TRACING_SAMPLE_RATE;
 	std::string TRACING_UDP_LISTENER_ADDR;
 	int TRACING_UDP_LISTENER_PORT;
+	double TRACING_SLOW_SPAN_THRESHOLD;
+	int TRACING_MAX_SPANS_PER_SECOND;
 
 	// Metrics
 	std::string METRICS_DATA_MODEL;
@@ -166,6 +173,8 @@ public:
 	double SATURATION_PROFILING_LOG_INTERVAL;
 	double SATURATION_PROFILING_MAX_LOG_INTERVAL;
 	double SATURATION_PROFILING_LOG_BACKOFF;
+	bool NETWORK_THREAD_SAMPLING_PROFILER_ENABLED;
+	int NETWORK_THREAD_SAMPLING_PROFILER_PERIOD;
 
 	// connectionMonitor
 	double CONNECTION_MONITOR_LOOP_TIME;
@@ -173,6 +182,7 @@ public:
 	double CONNECTION_MONITOR_IDLE_TIMEOUT;
 	double CONNECTION_MONITOR_INCOMING_IDLE_MULTIPLIER;
 	double CONNECTION_MONITOR_UNREFERENCED_CLOSE_DELAY;
+	int CONNECTION_MONITOR_MAX_SUPPRESSED_PINGS; // Consecutive pings skipped on connections that are receiving data
 
 	// FlowTransport
 	double CONNECTION_REJECTED_MESSAGE_DELAY;
@@ -187,6 +197,11 @@ public:
 	double INCOMPATIBLE_PEER_DELAY_BEFORE_LOGGING;
 	double PING_LOGGING_INTERVAL;
 	double PING_SKETCH_ACCURACY;
+	bool FLOW_TRANSPORT_BULK_LANE;
+	int FLOW_TRANSPORT_BULK_LANE_MIN_PACKET_BYTES;
+	bool FLOW_TRANSPORT_COMPRESSION; // Compress large replies to peers which accept it, e.g. across regions
+	int FLOW_TRANSPORT_COMPRESSION_MIN_BYTES;
+	int FLOW_TRANSPORT_COMPRESSION_LEVEL;
 
 	int TLS_CERT_REFRESH_DELAY_SECONDS;
 	double TLS_SERVER_CONNECTION_THROTTLE_TIMEOUT;
@@ -199,6 +214,8 @@ public:
 	int TLS_MALLOC_ARENA_MAX;
 	int TLS_HANDSHAKE_LIMIT;
 
+	double WORK_STEALING_POOL_METRICS_INTERVAL;
+
 	int NETWORK_TEST_CLIENT_COUNT;
 	int NETWORK_TEST_REPLY_SIZE;
 	int NETWORK_TEST_REQUEST_COUNT;
@@ -222,13 +239,14 @@ public:
 	int64_t BUGGIFY_SIM_PAGE_CACHE_4K;
 	int64_t BUGGIFY_SIM_PAGE_CACHE_64K;
 	int64_t BLOB_WORKER_PAGE_CACHE;
-	std::string CACHE_EVICTION_POLICY; // for now, "random", "lru", are supported
+	std::string CACHE_EVICTION_POLICY; // "random", "lru" or "clock"
 	int MAX_EVICT_ATTEMPTS;
 	double PAGE_CACHE_TRUNCATE_LOOKUP_FRACTION;
 	double TOO_MANY_CONNECTIONS_CLOSED_RESET_DELAY;
 	int TOO_MANY_CONNECTIONS_CLOSED_TIMEOUT;
 	int PEER_UNAVAILABLE_FOR_LONG_TIME_TIMEOUT;
 	int FLOW_CACHEDFILE_WRITE_IO_SIZE;
+	int FLOW_CACHEDFILE_MAX_COALESCED_WRITE; // Largest write of dirty pages at consecutive offsets, 0 to write each page
 
 	// AsyncFileEIO
 	int EIO_MAX_PARALLELISM;
@@ -244,10 +262,20 @@ public:
 	double SQLITE_DISK_METRIC_LOGGING_INTERVAL;
 	double KAIO_LATENCY_LOGGING_INTERVAL;
 	double KAIO_LATENCY_SKETCH_ACCURACY;
+	int KAIO_SUBMIT_BATCH; // While I/Os are outstanding, wait for this many to be queued before submitting more
+	double KAIO_SUBMIT_BATCH_DELAY; // ... or for the oldest queued I/O to have waited this long
+	bool KAIO_USERSPACE_REAP; // Collect completions from the mapped AIO ring instead of calling io_getevents
+	int KAIO_POLL_OUTSTANDING; // With this many I/Os outstanding, collect completions every run loop turn
+	bool KAIO_FILE_LATENCY_HISTOGRAMS; // Keep read and write latency histograms for each file
 
 	int PAGE_WRITE_CHECKSUM_HISTORY;
 	int DISABLE_POSIX_KERNEL_AIO;
 
+	// AsyncFileIOUring
+	bool ENABLE_IO_URING; // Use io_uring instead of kernel AIO for unbuffered files, if built with liburing
+	int IO_URING_QUEUE_DEPTH; // Submission queue entries, which also bounds the number of operations in flight
+	int IO_URING_FIXED_FILES; // Size of the ring's fixed file table, files opened beyond it are accessed by fd
+
 	// AsyncFileNonDurable
 	double NON_DURABLE_MAX_WRITE_DELAY;
 	double MAX_PRIOR_MODIFICATION_DELAY;
@@ -283,6 +311,14 @@ public:
 	int CERT_FILE_MAX_SIZE;
 	int READY_QUEUE_RESERVED_SIZE;
 	int TASKS_PER_REACTOR_CHECK;
+	// If not negative, the CPU to pin the network thread to
+	int NETWORK_THREAD_CPU;
+	// Seconds the network thread polls for work from other threads before it sleeps, so that a quick succession of
+	// thread pool completions does not wake it once each
+	double NETWORK_THREAD_SPIN_BEFORE_SLEEP;
+	// If positive, the run loop keeps timers in a hierarchical timing wheel with ticks this many seconds long, rather
+	// than in a heap
+	double TIMER_WHEEL_TICK;
 
 	// Network
 	int64_t PACKET_LIMIT;
@@ -293,6 +329,7 @@ public:
 	int MIN_PACKET_BUFFER_FREE_BYTES;
 	int FLOW_TCP_NODELAY;
 	int FLOW_TCP_QUICKACK;
+	int FLOW_TCP_ZERO_COPY_SEND_BYTES;
 	bool RESOLVE_PREFER_IPV4_ADDR;
 
 	// Sim2
@@ -338,6 +375,7 @@ public:
 	// Load Balancing
 	int LOAD_BALANCE_ZONE_ID_LOCALITY_ENABLED;
 	int LOAD_BALANCE_DC_ID_LOCALITY_ENABLED;
+	int LOAD_BALANCE_DATA_HALL_LOCALITY_ENABLED; // Prefer storage servers in the same data hall as the client
 	double LOAD_BALANCE_MAX_BACKOFF;
 	double LOAD_BALANCE_START_BACKOFF;
 	double LOAD_BALANCE_BACKOFF_RATE;
@@ -348,6 +386,17 @@ public:
 	double SECOND_REQUEST_MULTIPLIER_DECAY;
 	double SECOND_REQUEST_BUDGET_GROWTH;
 	double SECOND_REQUEST_MAX_BUDGET;
+	bool LOAD_BALANCE_HEDGE_BY_LATENCY; // Send the second request at a percentile of the first server's latency
+	double LOAD_BALANCE_HEDGE_PERCENTILE;
+	int LOAD_BALANCE_LATENCY_WINDOW; // Replies per server over which its latency percentiles are measured
+	double LOAD_BALANCE_LATENCY_SKETCH_ACCURACY;
+	// How much the read queue depth and the cache miss rate storage servers report weigh against the outstanding
+	// requests to them when choosing one, and the read queue depth at which one counts as bad
+	double LOAD_BALANCE_READ_QUEUE_WEIGHT;
+	double LOAD_BALANCE_CACHE_MISS_WEIGHT;
+	int LOAD_BALANCE_MAX_READ_QUEUE;
+	double LOAD_BALANCE_PENALTY_HALF_LIFE; // 0 keeps a storage server's penalty until its next reply
+	double LOAD_BALANCE_ADMISSION_WINDOW_EXPIRY; // Seconds a storage server's admission window holds for
 	double ALTERNATIVES_FAILURE_RESET_TIME;
 	double ALTERNATIVES_FAILURE_MIN_DELAY;
 	double ALTERNATIVES_FAILURE_DELAY_RATIO;
@@ -384,6 +433,7 @@ public:
 	// Encryption
 	int64_t ENCRYPT_CIPHER_KEY_CACHE_TTL;
 	int64_t ENCRYPT_KEY_REFRESH_INTERVAL;
+	double ENCRYPT_KEY_REFRESH_AHEAD;
 	int64_t ENCRYPT_KEY_HEALTH_CHECK_INTERVAL;
 	double EKP_HEALTH_CHECK_REQUEST_TIMEOUT;
 	bool ENCRYPT_KEY_CACHE_ENABLE_DETAIL_LOGGING;
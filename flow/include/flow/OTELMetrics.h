@@ -115,6 +115,12 @@ public:
 	OTELGauge() {}
 	OTELGauge(const std::string& n) : name{ n } {}
 	OTELGauge(const std::string& n, double v) : name{ n } { points.emplace_back(v); }
+	// Returns the approximate number of msgpack bytes needed to serialize this object, see OTELSum
+	uint32_t getMsgpackBytes() const {
+		uint32_t name_bytes = name.size() + 4;
+		uint32_t datapoint_bytes = points.size() * NumberDataPoint::MsgpackBytes;
+		return name_bytes + datapoint_bytes;
+	}
 };
 
 class HistogramDataPoint {
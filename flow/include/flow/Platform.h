@@ -313,6 +313,10 @@ void setMemoryQuota(size_t limit);
 
 void* allocate(size_t length, bool allowLargePages, bool includeGuardPages);
 
+// Allocates length bytes, aligned to length, which must be a power of two, and on Linux asks for them to be backed by
+// transparent huge pages
+void* allocateHugePageBacked(size_t length);
+
 void setAffinity(int proc);
 
 void threadSleep(double seconds);
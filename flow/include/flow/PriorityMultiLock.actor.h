@@ -29,6 +29,7 @@
 #define PRIORITYMULTILOCK_ACTOR_H
 
 #include "flow/flow.h"
+#include "flow/Histogram.h"
 #include <boost/intrusive/list.hpp>
 #include "flow/actorcompiler.h" // This must be the last #include.
 
@@ -62,6 +63,10 @@
 //   The total capacity of a priority to be considered when launching tasks is
 //     ceil(weights[n] / totalPendingWeights * concurrency)
 //
+// Weights can be changed while the lock is in use with setWeights().  With setMaxQueueTime(t), a waiter that has been
+// queued for longer than t is granted the next free slot ahead of the weights, oldest first, so that a low weight
+// priority is not starved while higher weight priorities stay busy.
+//
 // For improved memory locality the properties mentioned above are stored as priorities[n].<property>
 // in the actual implementation.
 //
@@ -88,7 +93,8 @@ public:
 	  : PriorityMultiLock(concurrency, parseStringToVector<int>(weights, ',')) {}
 
 	PriorityMultiLock(int concurrency, std::vector<int> weightsByPriority)
-	  : concurrency(concurrency), available(concurrency), waiting(0), totalPendingWeights(0), killed(false) {
+	  : concurrency(concurrency), available(concurrency), waiting(0), totalPendingWeights(0), maxQueueTime(0),
+	    killed(false) {
 
 		priorities.resize(weightsByPriority.size());
 		for (int i = 0; i < priorities.size(); ++i) {
@@ -119,6 +125,10 @@ public:
 				// Remove this priority's weight from the total since it will remain empty
 				totalPendingWeights -= p.weight;
 
+				if (p.queueWait.isValid()) {
+					p.queueWait->sample(0);
+				}
+
 				// Return a Lock to the caller
 				Lock lock;
 				addRunner(lock, &p);
@@ -132,12 +142,47 @@ public:
 		}
 
 		Waiter& w = q.emplace_back();
+		w.queuedAt = now();
 		++waiting;
 
 		pml_debug_printf("lock wait priority %d  %s\n", priority, toString().c_str());
 		return w.lockPromise.getFuture();
 	}
 
+	// Replaces the weights of all priorities.  Waiters already queued are scheduled by the new weights.
+	void setWeights(std::vector<int> weightsByPriority) {
+		ASSERT_EQ(weightsByPriority.size(), priorities.size());
+		for (int i = 0; i < priorities.size(); ++i) {
+			ASSERT_GT(weightsByPriority[i], 0);
+			Priority& p = priorities[i];
+			// Only priorities with waiters contribute to the pending weights
+			if (!p.queue.empty()) {
+				totalPendingWeights += weightsByPriority[i] - p.weight;
+			}
+			p.weight = weightsByPriority[i];
+		}
+
+		// Capacity may have moved to priorities that have waiters
+		if (waiting > 0) {
+			wakeRunner.trigger();
+		}
+	}
+
+	void setWeights(std::string weights) { setWeights(parseStringToVector<int>(weights, ',')); }
+
+	// Waiters queued for longer than this many seconds are granted the next free slot regardless of their priority's
+	// capacity.  0 disables aging.
+	void setMaxQueueTime(double seconds) { maxQueueTime = seconds; }
+
+	// Samples the time each lock waits in the queue into a histogram per priority, named <op>Priority<n> in 'group'.
+	// Locks granted without waiting are sampled as 0.
+	void enableQueueWaitHistograms(StringRef group, std::string const& op) {
+		for (auto& p : priorities) {
+			p.queueWait = Histogram::getHistogram(
+			    group, StringRef(format("%sPriority%d", op.c_str(), p.priority)), Histogram::Unit::milliseconds);
+		}
+	}
+
 	// Halt stops the PML from handing out any new locks but leaves waiters and runners alone.
 	// Existing and new waiters will not see an error, they will just never get a lock.
 	// Can be safely called multiple times.
@@ -205,6 +250,7 @@ public:
 private:
 	struct Waiter {
 		Promise<Lock> lockPromise;
+		double queuedAt;
 	};
 
 	// Total execution slots allowed across all priorities
@@ -215,6 +261,8 @@ private:
 	int waiting;
 	// Sum of weights for all priorities with 1 or more waiters
 	int totalPendingWeights;
+	// Queue time after which a waiter is granted a slot ahead of the weights, or 0
+	double maxQueueTime;
 
 	typedef Deque<Waiter> Queue;
 
@@ -229,6 +277,8 @@ private:
 		int weight;
 		// Priority number for convenience, matches *this's index in PML priorities vector
 		int priority;
+		// Time spent queued by the locks granted at this priority, if enabled
+		Reference<Histogram> queueWait;
 
 		std::string toString(const PriorityMultiLock* pml) const {
 			return format("priority=%d weight=%d run=%d wait=%d cap=%d",
@@ -287,6 +337,19 @@ private:
 		return ceil((float)weight / totalPendingWeights * concurrency);
 	}
 
+	// The priority whose first waiter has been queued the longest, if that is longer than maxQueueTime
+	Priority* agedPriority() {
+		const double queuedBefore = now() - maxQueueTime;
+		Priority* aged = nullptr;
+		for (auto& p : waitingPriorities) {
+			const double queuedAt = p.queue.front().queuedAt;
+			if (queuedAt <= queuedBefore && (aged == nullptr || queuedAt < aged->queue.front().queuedAt)) {
+				aged = &p;
+			}
+		}
+		return aged;
+	}
+
 	ACTOR static Future<Void> runner(PriorityMultiLock* self) {
 		state Future<Void> error = self->brokenOnDestruct.getFuture();
 
@@ -305,23 +368,34 @@ private:
 			while (self->available > 0 && self->waiting > 0) {
 				pml_debug_printf("  launch loop start  priority=%d  %s\n", p->priority, self->toString().c_str());
 
-				// Find the next priority with waiters and capacity.  There must be at least one.
-				loop {
-					if (p == self->waitingPriorities.end()) {
-						p = self->waitingPriorities.begin();
-					}
-
-					pml_debug_printf("    launch loop scan  priority=%d  %s\n", p->priority, self->toString().c_str());
-
-					if (!p->queue.empty() && p->runners < self->currentCapacity(p->weight)) {
-						break;
+				// A waiter queued for longer than maxQueueTime goes first.  Otherwise, find the next priority with
+				// waiters and capacity.  There must be at least one.
+				Priority* aged = self->maxQueueTime > 0 ? self->agedPriority() : nullptr;
+				if (aged != nullptr) {
+					p = self->waitingPriorities.iterator_to(*aged);
+					pml_debug_printf("    launch aged  priority=%d  %s\n", p->priority, self->toString().c_str());
+				} else {
+					loop {
+						if (p == self->waitingPriorities.end()) {
+							p = self->waitingPriorities.begin();
+						}
+
+						pml_debug_printf(
+						    "    launch loop scan  priority=%d  %s\n", p->priority, self->toString().c_str());
+
+						if (!p->queue.empty() && p->runners < self->currentCapacity(p->weight)) {
+							break;
+						}
+						++p;
 					}
-					++p;
 				}
 
 				Queue& queue = p->queue;
 				Waiter w = queue.front();
 				queue.pop_front();
+				if (p->queueWait.isValid()) {
+					p->queueWait->sampleSeconds(now() - w.queuedAt);
+				}
 
 				// If this priority is now empty, subtract its weight from the total pending weights an remove it
 				// from the waitingPriorities list
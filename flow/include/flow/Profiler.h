@@ -29,4 +29,13 @@ class INetwork;
 void startProfiling(INetwork* network, Optional<int> period = {}, Optional<StringRef> outputFile = {});
 void stopProfiling();
 
+// Continuous, in-memory sampling of the network thread every 'period' microseconds of its CPU time. Dumps write pprof
+// CPU profiles of everything sampled since the start or the last clear: all samples to 'outputFile', and the samples
+// taken while running each TaskPriority to 'outputFile'.<priority>. Only implemented on Linux.
+void startSamplingProfiler(INetwork* network, int period);
+void stopSamplingProfiler();
+bool isSamplingProfilerRunning();
+void clearSamplingProfile();
+void dumpSamplingProfile(std::string const& outputFile);
+
 #endif // _FDB_FLOW_PROFILER_H_
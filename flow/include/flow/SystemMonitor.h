@@ -64,6 +64,8 @@ struct NetworkData {
 	int64_t countReads;
 	int64_t countWouldBlock;
 	int64_t countWrites;
+	int64_t bytesSentZeroCopy;
+	int64_t countZeroCopySendsCopied;
 	int64_t countRunLoop;
 	int64_t countCantSleep;
 	int64_t countWontSleep;
@@ -106,6 +108,8 @@ struct NetworkData {
 		countReads = Int64Metric::getValueOrDefault("Net2.CountReads"_sr);
 		countWouldBlock = Int64Metric::getValueOrDefault("Net2.CountWouldBlock"_sr);
 		countWrites = Int64Metric::getValueOrDefault("Net2.CountWrites"_sr);
+		bytesSentZeroCopy = Int64Metric::getValueOrDefault("Net2.BytesSentZeroCopy"_sr);
+		countZeroCopySendsCopied = Int64Metric::getValueOrDefault("Net2.CountZeroCopySendsCopied"_sr);
 		countRunLoop = Int64Metric::getValueOrDefault("Net2.CountRunLoop"_sr);
 		countCantSleep = Int64Metric::getValueOrDefault("Net2.CountCantSleep"_sr);
 		countWontSleep = Int64Metric::getValueOrDefault("Net2.CountWontSleep"_sr);
@@ -22,24 +22,36 @@
 #define FLOW_TASK_QUEUE_H
 #pragma once
 
+#include <optional>
 #include <queue>
 #include <vector>
 #include "flow/TDMetric.actor.h"
 #include "flow/network.h"
 #include "flow/ThreadSafeQueue.h"
+#include "flow/TimerWheel.h"
 
 template <typename Task>
 // A queue of ordered tasks, both ready to execute, and delayed for later execution.
 // All functions must be called on the main thread, except for addReadyThreadSafe() which can be called from any thread.
 class TaskQueue {
 public:
-	TaskQueue() : tasksIssued(0), ready(FLOW_KNOBS->READY_QUEUE_RESERVED_SIZE) {}
+	// If timerWheelTick is positive, timers are kept in a TimerWheel with ticks that long rather than in a heap
+	explicit TaskQueue(double timerWheelTick = FLOW_KNOBS->TIMER_WHEEL_TICK)
+	  : tasksIssued(0), ready(FLOW_KNOBS->READY_QUEUE_RESERVED_SIZE) {
+		if (timerWheelTick > 0) {
+			timerWheel.emplace(timerWheelTick);
+		}
+	}
 
 	// Add a task that is ready to be executed.
 	void addReady(TaskPriority taskId, Task* t) { this->ready.push(OrderedTask(getFIFOPriority(taskId), taskId, t)); }
 	// Add a task to be executed at a given future time instant (a "timer").
 	void addTimer(double at, TaskPriority taskId, Task* t) {
-		this->timers.push(DelayedTask(at, getFIFOPriority(taskId), taskId, t));
+		if (timerWheel) {
+			timerWheel->add(DelayedTask(at, getFIFOPriority(taskId), taskId, t));
+		} else {
+			this->timers.push(DelayedTask(at, getFIFOPriority(taskId), taskId, t));
+		}
 	}
 	// Add a task that is ready to be executed, potentially called from a thread that is different from main.
 	// Returns true iff the main thread need to be woken up to execute this task.
@@ -66,6 +78,9 @@ public:
 	}
 	// Returns a time interval a caller should sleep from now until the next timer.
 	double getSleepTime(double now) const {
+		if (timerWheel) {
+			return timerWheel->empty() ? 0 : timerWheel->nextAt() - now;
+		}
 		if (!timers.empty()) {
 			return timers.top().at - now;
 		}
@@ -75,6 +90,13 @@ public:
 	// Moves all timers that are scheduled to be executed at or before now to the ready queue.
 	void processReadyTimers(double now) {
 		[[maybe_unused]] int numTimers = 0;
+		if (timerWheel) {
+			timerWheel->expire(now + INetwork::TIME_EPS, [&](DelayedTask const& t) {
+				++numTimers;
+				++countTimers;
+				ready.push(t);
+			});
+		}
 		while (!timers.empty() && timers.top().at <= now + INetwork::TIME_EPS) {
 			++numTimers;
 			++countTimers;
@@ -116,6 +138,9 @@ public:
 		ready.swap(_1);
 		decltype(timers) _2;
 		timers.swap(_2);
+		if (timerWheel) {
+			timerWheel->clear();
+		}
 	}
 
 private:
@@ -152,6 +177,7 @@ private:
 	ThreadSafeQueue<std::pair<TaskPriority, Task*>> threadReady;
 
 	std::priority_queue<DelayedTask, std::vector<DelayedTask>> timers;
+	std::optional<TimerWheel<DelayedTask>> timerWheel;
 
 	Int64MetricHandle countTimers;
 	Int64MetricHandle countCantSleep;
@@ -0,0 +1,183 @@
+/*
+ * TimerWheel.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLOW_TIMER_WHEEL_H
+#define FLOW_TIMER_WHEEL_H
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+// A hierarchical timing wheel: a set of timers, each due at a time T::at, from which the ones that are due can be
+// taken out. Adding a timer takes constant time, where a heap takes time logarithmic in the number of timers.
+//
+// Time is divided into ticks of tickSeconds. The wheel has kLevels levels of kSlots slots; a slot of level 0 holds the
+// timers due in one tick, and a slot of level L the timers due in kSlots^L ticks. A timer goes in the lowest level
+// whose slots cover both the current tick and its own, and moves down a level each time the current tick reaches the
+// start of its slot. Timers further away than the wheel covers wait in a heap.
+//
+// Timers are only compared with the current time at the tick they are due in, so the timers taken out at a given time
+// are exactly those a heap would give.
+template <class T>
+class TimerWheel {
+public:
+	explicit TimerWheel(double tickSeconds) : tickSeconds(tickSeconds) {}
+
+	bool empty() const { return count == 0; }
+	size_t size() const { return count; }
+
+	void add(T const& timer) {
+		const int64_t tick = toTick(timer.at);
+		if (count == 0) {
+			currentTick = tick;
+		}
+		++count;
+		// A timer already due goes with those of the current tick
+		insert(std::max(tick, currentTick), timer);
+	}
+
+	// The time the earliest timer is due. The wheel must not be empty.
+	double nextAt() const {
+		for (int level = 0; level < kLevels; ++level) {
+			if (levelCounts[level] == 0) {
+				continue;
+			}
+			const int64_t current = (currentTick >> (kBitsPerLevel * level)) & kSlotMask;
+			// Above level 0, the slot of the current tick has already been moved down
+			for (int64_t i = level == 0 ? current : current + 1; i < kSlots; ++i) {
+				auto const& slot = slots[level][i];
+				if (!slot.empty()) {
+					double at = slot[0].at;
+					for (auto const& timer : slot) {
+						at = std::min(at, timer.at);
+					}
+					return at;
+				}
+			}
+		}
+		return overflow.top().at;
+	}
+
+	// Removes every timer due at or before now, passing each to f, in no particular order
+	template <class F>
+	void expire(double now, F const& f) {
+		const int64_t nowTick = toTick(now);
+		while (count > 0) {
+			auto& slot = slots[0][currentTick & kSlotMask];
+			size_t kept = 0;
+			for (auto& timer : slot) {
+				// Only in the tick now is in can a timer not be due yet
+				if (currentTick < nowTick || timer.at <= now) {
+					f(timer);
+				} else {
+					slot[kept++] = timer;
+				}
+			}
+			count -= slot.size() - kept;
+			levelCounts[0] -= slot.size() - kept;
+			slot.erase(slot.begin() + kept, slot.end());
+			if (currentTick >= nowTick) {
+				break;
+			}
+			advance(nowTick);
+		}
+	}
+
+	void clear() {
+		for (auto& level : slots) {
+			for (auto& slot : level) {
+				slot.clear();
+			}
+		}
+		std::fill(std::begin(levelCounts), std::end(levelCounts), 0);
+		decltype(overflow) _;
+		overflow.swap(_);
+		count = 0;
+	}
+
+private:
+	static constexpr int kBitsPerLevel = 8;
+	static constexpr int kSlots = 1 << kBitsPerLevel;
+	static constexpr int64_t kSlotMask = kSlots - 1;
+	static constexpr int kLevels = 4;
+
+	struct Later {
+		bool operator()(T const& a, T const& b) const { return a.at > b.at; }
+	};
+
+	int64_t toTick(double at) const { return int64_t(std::floor(at / tickSeconds)); }
+
+	void insert(int64_t tick, T const& timer) {
+		int level = 0;
+		while (level < kLevels && (tick >> (kBitsPerLevel * (level + 1))) !=
+		                              (currentTick >> (kBitsPerLevel * (level + 1)))) {
+			++level;
+		}
+		if (level == kLevels) {
+			overflow.push(timer);
+			return;
+		}
+		slots[level][(tick >> (kBitsPerLevel * level)) & kSlotMask].push_back(timer);
+		++levelCounts[level];
+	}
+
+	// Moves the current tick forward by at least one, and at most to nowTick. Levels with no timers in them are skipped
+	// over up to the start of the next slot of the first level with timers, where they next have to be moved down.
+	void advance(int64_t nowTick) {
+		int emptyLevels = 0;
+		while (emptyLevels < kLevels && levelCounts[emptyLevels] == 0) {
+			++emptyLevels;
+		}
+		const int shift = kBitsPerLevel * emptyLevels;
+		currentTick = std::min(nowTick, ((currentTick >> shift) + 1) << shift);
+
+		const int wheelBits = kBitsPerLevel * kLevels;
+		if ((currentTick & ((int64_t(1) << wheelBits) - 1)) == 0) {
+			while (!overflow.empty() && (toTick(overflow.top().at) >> wheelBits) == (currentTick >> wheelBits)) {
+				insert(toTick(overflow.top().at), overflow.top());
+				overflow.pop();
+			}
+		}
+		// From the top down, so that timers moved into a slot starting at the current tick move on down with it
+		for (int level = kLevels - 1; level > 0; --level) {
+			if ((currentTick & ((int64_t(1) << (kBitsPerLevel * level)) - 1)) != 0) {
+				continue;
+			}
+			std::vector<T> moving;
+			moving.swap(slots[level][(currentTick >> (kBitsPerLevel * level)) & kSlotMask]);
+			levelCounts[level] -= moving.size();
+			for (auto const& timer : moving) {
+				insert(toTick(timer.at), timer);
+			}
+		}
+	}
+
+	const double tickSeconds;
+	int64_t currentTick = 0;
+	size_t count = 0;
+	std::vector<T> slots[kLevels][kSlots];
+	size_t levelCounts[kLevels] = {};
+	std::priority_queue<T, std::vector<T>, Later> overflow;
+};
+
+#endif /* FLOW_TIMER_WHEEL_H */
@@ -24,6 +24,7 @@
 
 #include <stdarg.h>
 #include <stdint.h>
+#include <charconv>
 #include <string>
 #include <string_view>
 #include <type_traits>
@@ -86,24 +87,34 @@ struct Traceable : std::false_type {};
 		static std::string toString(type value) { return format(fmt, value); }                                         \
 	}
 
+// Integers are in nearly every trace event, and std::to_chars formats them several times faster than format()
+#define INTEGER_TRACEABLE(type)                                                                                        \
+	template <>                                                                                                        \
+	struct Traceable<type> : std::true_type {                                                                          \
+		static std::string toString(type value) {                                                                      \
+			char buf[24];                                                                                              \
+			return std::string(buf, std::to_chars(buf, buf + sizeof(buf), value).ptr);                                 \
+		}                                                                                                              \
+	}
+
 FORMAT_TRACEABLE(bool, "%d");
-FORMAT_TRACEABLE(signed char, "%d");
-FORMAT_TRACEABLE(unsigned char, "%d");
-FORMAT_TRACEABLE(short, "%d");
-FORMAT_TRACEABLE(unsigned short, "%d");
-FORMAT_TRACEABLE(int, "%d");
-FORMAT_TRACEABLE(unsigned, "%u");
-FORMAT_TRACEABLE(long int, "%ld");
-FORMAT_TRACEABLE(unsigned long int, "%lu");
-FORMAT_TRACEABLE(long long int, "%lld");
-FORMAT_TRACEABLE(unsigned long long int, "%llu");
+INTEGER_TRACEABLE(signed char);
+INTEGER_TRACEABLE(unsigned char);
+INTEGER_TRACEABLE(short);
+INTEGER_TRACEABLE(unsigned short);
+INTEGER_TRACEABLE(int);
+INTEGER_TRACEABLE(unsigned);
+INTEGER_TRACEABLE(long int);
+INTEGER_TRACEABLE(unsigned long int);
+INTEGER_TRACEABLE(long long int);
+INTEGER_TRACEABLE(unsigned long long int);
 FORMAT_TRACEABLE(float, "%g");
 FORMAT_TRACEABLE(double, "%g");
 FORMAT_TRACEABLE(void*, "%p");
-FORMAT_TRACEABLE(volatile long, "%ld");
-FORMAT_TRACEABLE(volatile unsigned long, "%lu");
-FORMAT_TRACEABLE(volatile long long, "%lld");
-FORMAT_TRACEABLE(volatile unsigned long long, "%llu");
+INTEGER_TRACEABLE(volatile long);
+INTEGER_TRACEABLE(volatile unsigned long);
+INTEGER_TRACEABLE(volatile long long);
+INTEGER_TRACEABLE(volatile unsigned long long);
 FORMAT_TRACEABLE(volatile double, "%g");
 
 template <class Enum>
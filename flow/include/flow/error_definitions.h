@@ -153,6 +153,7 @@ ERROR( audit_storage_task_outdated, 1234, "Audit task is scheduled by an outdate
 ERROR( transaction_throttled_hot_shard, 1235, "Transaction throttled due to hot shard" )
 ERROR( storage_replica_comparison_error, 1236, "Storage replicas not consistent" )
 ERROR( unreachable_storage_replica, 1237, "Storage replica cannot be reached" )
+ERROR( please_rebuild_kv_store, 1238, "Need to rebuild the storage engine in place" )
 
 // 15xx Platform errors
 ERROR( platform_error, 1500, "Platform error" )
@@ -210,7 +211,7 @@ ERROR( transaction_invalid_version, 2020, "Transaction does not have a valid com
 ERROR( no_commit_version, 2021, "Transaction is read-only and therefore does not have a commit version" )
 ERROR( environment_variable_network_option_failed, 2022, "Environment variable network option could not be set" )
 ERROR( transaction_read_only, 2023, "Attempted to commit a transaction specified as read-only" )
-ERROR( invalid_cache_eviction_policy, 2024, "Invalid cache eviction policy, only random and lru are supported" )
+ERROR( invalid_cache_eviction_policy, 2024, "Invalid cache eviction policy, only random, lru and clock are supported" )
 ERROR( network_cannot_be_restarted, 2025, "Network can only be started once" )
 ERROR( blocked_from_network_thread, 2026, "Detected a deadlock in a callback called from the network thread" )
 ERROR( invalid_config_db_range_read, 2027, "Invalid configuration database range read" )
@@ -511,6 +511,7 @@ struct PrecomputeSize : Context {
 
 	template <class T>
 	std::enable_if_t<is_dynamic_size<T>, bool> visitDynamicSize(const T& t) {
+		variableLayout = true;
 		uint32_t size = dynamic_size_traits<T>::size(t, this->context());
 		if (size == 0 && emptyVector.value != -1) {
 			return true;
@@ -541,7 +542,12 @@ struct PrecomputeSize : Context {
 		return Noop{ size, writeToIndex };
 	}
 
+	// Called for every vector and union, whose size and layout differ from message to message
+	void noteVariableLayout() { variableLayout = true; }
+
 	int current_buffer_size = 0;
+	// Whether anything of variable size was visited. If not, every message of this root type has the same layout.
+	bool variableLayout = false;
 
 	const int buffer_length = -1; // Dummy, the value of this should not affect anything.
 	const int vtable_start = -1; // Dummy, the value of this should not affect anything.
@@ -600,6 +606,8 @@ struct WriteToBuffer : Context {
 		int size;
 	};
 
+	void noteVariableLayout() {}
+
 	MessageWriter getMessageWriter(int size, bool zeroed = false) {
 		MessageWriter m{ *this, *writeToOffsetsIter++, size };
 		if (zeroed) {
@@ -909,6 +917,7 @@ struct SaveVisitorLambda : Context {
 				    using VectorTraits = vector_like_traits<Member>;
 				    using T = typename VectorTraits::value_type;
 				    using UnionTraits = union_like_traits<T>;
+				    writer.noteVariableLayout();
 				    uint32_t num_entries = VectorTraits::num_entries(member, this->context());
 				    auto typeVectorWriter = writer.getMessageWriter(num_entries); // type tags are one byte
 				    auto offsetVectorWriter = writer.getMessageWriter(num_entries * sizeof(RelativeOffset));
@@ -945,6 +954,7 @@ struct SaveVisitorLambda : Context {
 				    self.write(&offsetVectorOffset, vtable[i++], sizeof(offsetVectorOffset));
 			    } else if constexpr (is_union_like<Member>) {
 				    using UnionTraits = union_like_traits<Member>;
+				    writer.noteVariableLayout();
 				    uint8_t type_tag = UnionTraits::index(member, this->context());
 				    uint8_t fb_type_tag =
 				        UnionTraits::empty(member, this->context()) ? 0 : type_tag + 1; // Flatbuffers indexes from 1.
@@ -1208,6 +1218,7 @@ struct LoadSaveHelper : Context {
 		using VectorTraits = vector_like_traits<VectorLike>;
 		using T = typename VectorTraits::value_type;
 		constexpr auto size = fb_size<T>;
+		writer.noteVariableLayout();
 		uint32_t num_entries = VectorTraits::num_entries(members, this->context());
 		if (num_entries == 0 && writer.emptyVector.value != -1) {
 			return writer.emptyVector;
@@ -1255,6 +1266,7 @@ struct LoadSaveHelper<std::vector<bool, Alloc>, Context> : Context {
 
 	template <class Writer>
 	RelativeOffset save(const std::vector<bool, Alloc>& members, Writer& writer, const VTableSet* vtables) {
+		writer.noteVariableLayout();
 		uint32_t len = members.size();
 		int padding = 0;
 		int start = RightAlign(writer.current_buffer_size + sizeof(uint32_t) + len, sizeof(uint32_t), &padding);
@@ -1307,12 +1319,41 @@ auto fake_root(Members&... members) {
 	return FakeRoot<Members...>(members...);
 }
 
+// What PrecomputeSize found for a message with a fixed layout
+struct FixedLayout {
+	bool known = false; // Whether a message of the root type has been saved yet
+	bool fixed = false;
+	int size = 0;
+	int vtable_start = 0;
+	std::vector<int> writeToOffsets;
+};
+
 template <class Context, class Root>
 uint8_t* save(Context& context, const Root& root, FileIdentifier file_identifier) {
 	const auto* vtableset = get_vtableset(root, context);
-	PrecomputeSize<Context> precompute_size(context);
+	// If the first message of this root type has nothing of variable size in it, no message of the type does, and
+	// what PrecomputeSize finds for it holds for all of them. Later messages are written straight away.
+	static thread_local FixedLayout fixedLayout;
 	int vtable_start;
+	if (fixedLayout.fixed) {
+		uint8_t* out = context.allocate(fixedLayout.size);
+		WriteToBuffer writeToBuffer{
+			context, fixedLayout.size, fixedLayout.vtable_start, out, fixedLayout.writeToOffsets.begin()
+		};
+		save_with_vtables(root, vtableset, writeToBuffer, &vtable_start, file_identifier, context);
+		return out;
+	}
+	PrecomputeSize<Context> precompute_size(context);
 	save_with_vtables(root, vtableset, precompute_size, &vtable_start, file_identifier, context);
+	if (!fixedLayout.known) {
+		fixedLayout.known = true;
+		if (!precompute_size.variableLayout) {
+			fixedLayout.fixed = true;
+			fixedLayout.size = precompute_size.current_buffer_size;
+			fixedLayout.vtable_start = vtable_start;
+			fixedLayout.writeToOffsets = precompute_size.writeToOffsets;
+		}
+	}
 	uint8_t* out = context.allocate(precompute_size.current_buffer_size);
 	WriteToBuffer writeToBuffer{
 		context, precompute_size.current_buffer_size, vtable_start, out, precompute_size.writeToOffsets.begin()
@@ -170,6 +170,7 @@ public:
 		enHistogram = 18,
 		enTokenCache = 19,
 		enMetrics = 20,
+		enBlobGranuleFileCache = 21,
 		COUNT // Add new fields before this enumerator
 	};
 
@@ -446,6 +446,14 @@ public:
 	int getLength() const { return size; }
 	Standalone<StringRef> toValue() const { return Standalone<StringRef>(StringRef(data, size), arena); }
 	StringRef toValue(Arena& arena) const { return StringRef(arena, StringRef(data, size)); }
+
+	// Makes room for `bytes` bytes in all, so that writing up to that much copies nothing already written
+	void reserve(int bytes) {
+		if (bytes > allocated) {
+			reallocate(bytes);
+		}
+	}
+
 	template <class VersionOptions>
 	explicit BinaryWriter(VersionOptions vo) : data(nullptr), size(0), allocated(0) {
 		vo.write(*this);
@@ -561,25 +569,30 @@ private:
 
 	void* writeBytes(int s) {
 		int p = size;
-		size += s;
-		if (size > allocated) {
-			if (size <= 512 - sizeof(ArenaBlock)) {
-				allocated = 512 - sizeof(ArenaBlock);
-			} else if (size <= 4096 - sizeof(ArenaBlock)) {
-				allocated = 4096 - sizeof(ArenaBlock);
+		int needed = size + s;
+		if (needed > allocated) {
+			if (needed <= 512 - sizeof(ArenaBlock)) {
+				reallocate(512 - sizeof(ArenaBlock));
+			} else if (needed <= 4096 - sizeof(ArenaBlock)) {
+				reallocate(4096 - sizeof(ArenaBlock));
 			} else {
-				allocated = std::max(allocated * 2, size);
+				reallocate(std::max(allocated * 2, needed));
 			}
-			Arena newArena;
-			uint8_t* newData = new (newArena) uint8_t[allocated];
-			if (p > 0) {
-				memcpy(newData, data, p);
-			}
-			arena = newArena;
-			data = newData;
 		}
+		size = needed;
 		return data + p;
 	}
+
+	void reallocate(int bytes) {
+		Arena newArena;
+		uint8_t* newData = new (newArena) uint8_t[bytes];
+		if (size > 0) {
+			memcpy(newData, data, size);
+		}
+		arena = newArena;
+		data = newData;
+		allocated = bytes;
+	}
 };
 
 // A known-length memory segment and an unknown-length memory segment which can be written to as a whole.
@@ -244,6 +244,10 @@ std::string formatIpPort(const IPAddress& ip, uint16_t port) {
 	return format(patt, ip.toString().c_str(), port);
 }
 
+int IConnection::writePackets(PacketBuffer* buffer, int limit) {
+	return write(buffer, limit);
+}
+
 Optional<std::vector<NetworkAddress>> DNSCache::find(const std::string& host, const std::string& service) {
 	auto it = hostnameToAddresses.find(host + ":" + service);
 	if (it != hostnameToAddresses.end()) {
@@ -126,3 +126,25 @@ TEST_CASE("flow/serialize/Downgrade/WriteNew") {
 	verifyData(writer.toStringRef(), numObjects);
 	return Void();
 }
+
+TEST_CASE("flow/serialize/BinaryWriter/reserve") {
+	BinaryWriter writer(Unversioned());
+	std::string expected;
+	writer.reserve(deterministicRandom()->randomInt(0, 1000));
+	for (int i = 0; i < 1000; i++) {
+		if (deterministicRandom()->random01() < 0.01) {
+			writer.reserve(writer.getLength() + deterministicRandom()->randomInt(0, 10000));
+		}
+		std::string bytes(deterministicRandom()->randomInt(0, 100), 'a' + i % 26);
+		writer.serializeBytes(StringRef(bytes));
+		expected += bytes;
+	}
+	ASSERT(writer.toValue() == StringRef(expected));
+
+	// Writing within what was reserved leaves the data where it is
+	writer.reserve(writer.getLength() + 100);
+	const void* data = writer.getData();
+	writer.serializeBytes(StringRef(std::string(100, 'z')));
+	ASSERT(writer.getData() == data);
+	return Void();
+}
@@ -66,3 +66,32 @@ static void bench_callback(benchmark::State& benchState) {
 BENCHMARK_TEMPLATE(bench_callback, 1)->Range(1, 1 << 8)->ReportAggregatesOnly(true);
 BENCHMARK_TEMPLATE(bench_callback, 32)->Range(1, 1 << 8)->ReportAggregatesOnly(true);
 BENCHMARK_TEMPLATE(bench_callback, 1024)->Range(1, 1 << 8)->ReportAggregatesOnly(true);
+
+// An actor whose data is already there: it returns without waiting, so its frame lives only as long as its future
+ACTOR template <size_t Size>
+static Future<uint32_t> readReady(Future<uint32_t> f) {
+	state std::array<uint8_t, Size> arr;
+	uint32_t value = wait(f);
+	benchmark::DoNotOptimize(arr);
+	return value + 1;
+}
+
+template <size_t Size>
+static void bench_ready_actor(benchmark::State& benchState) {
+	onMainThread([&benchState]() {
+		Future<uint32_t> ready = 1;
+		uint32_t sum = 0;
+		for (auto _ : benchState) {
+			sum += readReady<Size>(ready).get();
+		}
+		benchmark::DoNotOptimize(sum);
+		benchState.SetItemsProcessed(static_cast<long>(benchState.iterations()));
+		return Future<Void>(Void());
+	}).blockUntilReady();
+}
+
+// Frame sizes in and beyond the size classes FastAllocated serves from its free lists
+BENCHMARK_TEMPLATE(bench_ready_actor, 1)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_ready_actor, 256)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_ready_actor, 1024)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_ready_actor, 4096)->ReportAggregatesOnly(true);
@@ -0,0 +1,241 @@
+/*
+ * BenchCommitReplay.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include <fstream>
+#include <iterator>
+
+#include "fdbclient/BlobCipher.h"
+#include "fdbclient/CommitBatchRecording.h"
+#include "fdbclient/CommitTransaction.h"
+#include "fdbserver/ConflictSet.h"
+#include "flow/IRandom.h"
+#include "flow/Platform.h"
+
+// Replays commit batches through the stages of the commit pipeline, one benchmark per stage, so a change to a stage
+// can be measured against real traffic: conflict detection as the resolver does it, encryption of each mutation, and
+// serialization of the mutations into the messages for the tlogs after assigning them tags.
+//
+// The batches are read from the recording named by FLOWBENCH_COMMIT_RECORDING, which a commit proxy writes when
+// COMMIT_BATCH_RECORDING_FILE is set. Without one, synthetic batches of small transactions are replayed. Tag
+// assignment and LogPushData live in fdbserver proper, so they are approximated here by a lookup in a shard map of
+// random boundaries and by writing messages the way LogPushData does.
+
+static constexpr int kSyntheticBatches = 200;
+static constexpr int kSyntheticTransactionsPerBatch = 500;
+static constexpr Version kVersionsPerBatch = 10000;
+static constexpr Version kVersionWindow = 5000000; // MAX_WRITE_TRANSACTION_LIFE_VERSIONS
+static constexpr int kShards = 1000;
+static constexpr int kStorageServers = 30;
+static constexpr int kReplicas = 3;
+static constexpr int kLogs = 4;
+
+static KeyRef randomKey(Arena& arena) {
+	return StringRef(arena, deterministicRandom()->randomAlphaNumeric(16));
+}
+
+static Standalone<VectorRef<RecordedCommitBatchRef>> makeSyntheticBatches() {
+	Standalone<VectorRef<RecordedCommitBatchRef>> batches;
+	Arena& arena = batches.arena();
+	for (int b = 0; b < kSyntheticBatches; b++) {
+		RecordedCommitBatchRef batch;
+		batch.version = (b + 1) * kVersionsPerBatch;
+		batch.prevVersion = batch.version - kVersionsPerBatch;
+		for (int t = 0; t < kSyntheticTransactionsPerBatch; t++) {
+			CommitTransactionRef tr;
+			tr.read_snapshot = batch.prevVersion - deterministicRandom()->randomInt(0, 10) * kVersionsPerBatch;
+			for (int r = 0; r < 3; r++) {
+				tr.read_conflict_ranges.push_back(arena, singleKeyRange(randomKey(arena), arena));
+			}
+			for (int w = 0; w < 2; w++) {
+				KeyRef key = randomKey(arena);
+				tr.write_conflict_ranges.push_back(arena, singleKeyRange(key, arena));
+				StringRef value(arena, deterministicRandom()->randomAlphaNumeric(100));
+				tr.mutations.push_back(arena, MutationRef(MutationRef::SetValue, key, value));
+			}
+			batch.transactions.push_back(arena, tr);
+		}
+		batches.push_back(arena, batch);
+	}
+	return batches;
+}
+
+static Standalone<VectorRef<RecordedCommitBatchRef>> const& getBatches() {
+	static Standalone<VectorRef<RecordedCommitBatchRef>> batches = []() {
+		const char* path = getenv("FLOWBENCH_COMMIT_RECORDING");
+		if (path == nullptr) {
+			return makeSyntheticBatches();
+		}
+		std::ifstream file(path, std::ios::binary);
+		if (!file) {
+			fprintf(stderr, "Could not open commit recording %s\n", path);
+			exit(1);
+		}
+		std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		return decodeCommitBatchRecording(Standalone<StringRef>(StringRef(contents)));
+	}();
+	return batches;
+}
+
+static int64_t countTransactions(VectorRef<RecordedCommitBatchRef> batches) {
+	int64_t transactions = 0;
+	for (auto const& batch : batches) {
+		transactions += batch.transactions.size();
+	}
+	return transactions;
+}
+
+static void countMutations(VectorRef<RecordedCommitBatchRef> batches, int64_t& mutations, int64_t& bytes) {
+	mutations = bytes = 0;
+	for (auto const& batch : batches) {
+		for (auto const& tr : batch.transactions) {
+			mutations += tr.mutations.size();
+			bytes += tr.mutations.expectedSize();
+		}
+	}
+}
+
+static void bench_replay_conflicts(benchmark::State& state) {
+	auto const& batches = getBatches();
+	const int64_t transactions = countTransactions(batches);
+	for (auto _ : state) {
+		ConflictSet* cs = newConflictSet();
+		int64_t committedCount = 0;
+		for (auto const& batch : batches) {
+			const Version oldest = batch.version - kVersionWindow;
+			ConflictBatch conflictBatch(cs);
+			for (auto const& tr : batch.transactions) {
+				conflictBatch.addTransaction(tr, oldest);
+			}
+			std::vector<int> committed;
+			conflictBatch.detectConflicts(batch.version, oldest, committed);
+			committedCount += committed.size();
+		}
+		benchmark::DoNotOptimize(committedCount);
+		destroyConflictSet(cs);
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()) * transactions);
+	state.counters["batches"] = batches.size();
+}
+
+static void bench_replay_encrypt(benchmark::State& state) {
+	auto const& batches = getBatches();
+	int64_t mutations, bytes;
+	countMutations(batches, mutations, bytes);
+
+	Reference<BlobCipherKeyCache> cipherKeyCache = BlobCipherKeyCache::getInstance();
+	const EncryptCipherDomainId domainIds[] = { 1, ENCRYPT_HEADER_DOMAIN_ID };
+	for (EncryptCipherDomainId domainId : domainIds) {
+		uint8_t baseCipher[AES_256_KEY_LENGTH];
+		deterministicRandom()->randomBytes(baseCipher, AES_256_KEY_LENGTH);
+		cipherKeyCache->insertCipherKey(domainId,
+		                                1,
+		                                baseCipher,
+		                                AES_256_KEY_LENGTH,
+		                                Sha256KCV().computeKCV(baseCipher, AES_256_KEY_LENGTH),
+		                                std::numeric_limits<int64_t>::max(),
+		                                std::numeric_limits<int64_t>::max());
+	}
+	EncryptBlobCipherAes265Ctr cipher(cipherKeyCache->getLatestCipherKey(1),
+	                                  cipherKeyCache->getLatestCipherKey(ENCRYPT_HEADER_DOMAIN_ID),
+	                                  EncryptAuthTokenMode::ENCRYPT_HEADER_AUTH_TOKEN_MODE_SINGLE,
+	                                  EncryptAuthTokenAlgo::ENCRYPT_HEADER_AUTH_TOKEN_ALGO_AES_CMAC,
+	                                  BlobCipherMetrics::TEST);
+
+	for (auto _ : state) {
+		for (auto const& batch : batches) {
+			Arena arena;
+			for (auto const& tr : batch.transactions) {
+				for (auto const& m : tr.mutations) {
+					benchmark::DoNotOptimize(m.encrypt(cipher, arena));
+				}
+			}
+		}
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()) * mutations);
+	state.SetBytesProcessed(static_cast<long>(state.iterations()) * bytes);
+}
+
+static void bench_replay_log_push(benchmark::State& state) {
+	auto const& batches = getBatches();
+	int64_t mutations, bytes;
+	countMutations(batches, mutations, bytes);
+
+	// Shard boundaries and the storage teams of the shards, standing in for the proxy's keyInfo map
+	std::vector<Key> boundaries;
+	for (int s = 0; s < kShards - 1; s++) {
+		std::string boundary = deterministicRandom()->randomAlphaNumeric(deterministicRandom()->randomInt(1, 17));
+		boundaries.push_back(Key(StringRef(boundary)));
+	}
+	std::sort(boundaries.begin(), boundaries.end());
+	std::vector<std::vector<Tag>> teams(kShards);
+	for (auto& team : teams) {
+		for (int r = 0; r < kReplicas; r++) {
+			team.emplace_back(tagLocalityPrimary, deterministicRandom()->randomInt(0, kStorageServers));
+		}
+	}
+
+	for (auto _ : state) {
+		for (auto const& batch : batches) {
+			std::vector<BinaryWriter> messages;
+			for (int l = 0; l < kLogs; l++) {
+				messages.emplace_back(AssumeVersion(currentProtocolVersion()));
+			}
+			uint32_t subsequence = 1;
+			std::vector<int> locations;
+			for (auto const& tr : batch.transactions) {
+				for (auto const& m : tr.mutations) {
+					auto shard = std::upper_bound(boundaries.begin(), boundaries.end(), m.param1) - boundaries.begin();
+					const std::vector<Tag>& tags = teams[shard];
+					locations.clear();
+					for (const Tag& tag : tags) {
+						locations.push_back(tag.id % kLogs);
+					}
+					std::sort(locations.begin(), locations.end());
+					locations.erase(std::unique(locations.begin(), locations.end()), locations.end());
+
+					BinaryWriter bw(AssumeVersion(currentProtocolVersion()));
+					bw << m;
+					const uint32_t subseq = subsequence++;
+					const uint32_t msgsize =
+					    bw.getLength() + sizeof(subseq) + sizeof(uint16_t) + sizeof(Tag) * tags.size();
+					for (int loc : locations) {
+						BinaryWriter& wr = messages[loc];
+						wr << msgsize << subseq << uint16_t(tags.size());
+						for (const Tag& tag : tags) {
+							wr << tag;
+						}
+						wr.serializeBytes(bw.getData(), bw.getLength());
+					}
+				}
+			}
+			for (auto& wr : messages) {
+				benchmark::DoNotOptimize(wr.toValue());
+			}
+		}
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()) * mutations);
+	state.SetBytesProcessed(static_cast<long>(state.iterations()) * bytes);
+}
+
+BENCHMARK(bench_replay_conflicts)->Unit(benchmark::kMillisecond)->ReportAggregatesOnly(true);
+BENCHMARK(bench_replay_encrypt)->Unit(benchmark::kMillisecond)->ReportAggregatesOnly(true);
+BENCHMARK(bench_replay_log_push)->Unit(benchmark::kMillisecond)->ReportAggregatesOnly(true);
@@ -0,0 +1,116 @@
+/*
+ * BenchConflictSet.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "fdbclient/CommitTransaction.h"
+#include "fdbserver/ConflictSet.h"
+#include "flow/IRandom.h"
+#include "flow/Platform.h"
+
+// Drives ConflictBatch the way a resolver does, over the SkipList history and over VersionHistoryBTree.
+//
+// Transactions look like those of a typical OLTP workload: a few point reads and writes, and now and then a short
+// range read, against keys chosen at random from a fixed set. Keys are 8 random bytes, after a prefix shared by all of
+// them of state.range(0) bytes, standing in for a tenant or directory prefix.
+
+static constexpr int kTransactionsPerBatch = 500;
+static constexpr int kKeyCount = 1000000;
+static constexpr int kBatchesInWindow = 100; // Batches between the newest version and the oldest one kept
+
+enum class HistoryType { SkipList, BTree };
+
+static KeyRef makeKey(Arena& arena, int prefixBytes, uint64_t value) {
+	uint8_t* key = new (arena) uint8_t[prefixBytes + 8];
+	memset(key, '\x15', prefixBytes);
+	const uint64_t bytes = bigEndian64(value);
+	memcpy(key + prefixBytes, &bytes, 8);
+	return KeyRef(key, prefixBytes + 8);
+}
+
+// A multiplicative hash spreads neighbouring key indices across the keyspace
+static uint64_t keyValue(int i) {
+	return uint64_t(i) * 0x9E3779B97F4A7C15ULL;
+}
+
+// Transactions' read_snapshot holds how many versions behind the batch they read, to be filled in when resolving
+static Standalone<VectorRef<CommitTransactionRef>> makeBatch(int prefixBytes) {
+	Standalone<VectorRef<CommitTransactionRef>> batch;
+	Arena& arena = batch.arena();
+	for (int t = 0; t < kTransactionsPerBatch; t++) {
+		CommitTransactionRef tr;
+		tr.read_snapshot = deterministicRandom()->randomInt(1, kBatchesInWindow / 2);
+		for (int r = 0; r < 3; r++) {
+			KeyRef key = makeKey(arena, prefixBytes, keyValue(deterministicRandom()->randomInt(0, kKeyCount)));
+			tr.read_conflict_ranges.push_back(arena, singleKeyRange(key, arena));
+		}
+		if (deterministicRandom()->random01() < 0.1) {
+			// About 1/65536 of the keyspace, so a dozen or so keys
+			const uint64_t begin = keyValue(deterministicRandom()->randomInt(0, kKeyCount)) >> 1;
+			tr.read_conflict_ranges.push_back(
+			    arena, KeyRangeRef(makeKey(arena, prefixBytes, begin), makeKey(arena, prefixBytes, begin + (1ULL << 48))));
+		}
+		for (int w = 0; w < 2; w++) {
+			KeyRef key = makeKey(arena, prefixBytes, keyValue(deterministicRandom()->randomInt(0, kKeyCount)));
+			tr.write_conflict_ranges.push_back(arena, singleKeyRange(key, arena));
+		}
+		batch.push_back(arena, tr);
+	}
+	return batch;
+}
+
+template <HistoryType Type>
+static void bench_conflict_batch(benchmark::State& state) {
+	const int prefixBytes = state.range(0);
+	ConflictSet* cs = Type == HistoryType::BTree ? newBTreeConflictSet() : newConflictSet();
+
+	std::vector<Standalone<VectorRef<CommitTransactionRef>>> batches;
+	for (int b = 0; b < kBatchesInWindow; b++)
+		batches.push_back(makeBatch(prefixBytes));
+
+	Version version = kBatchesInWindow;
+	auto resolve = [&](const Standalone<VectorRef<CommitTransactionRef>>& batch) {
+		++version;
+		const Version oldest = version - kBatchesInWindow;
+		ConflictBatch conflictBatch(cs);
+		for (CommitTransactionRef tr : batch) {
+			tr.read_snapshot = version - tr.read_snapshot;
+			conflictBatch.addTransaction(tr, oldest);
+		}
+		std::vector<int> committed;
+		conflictBatch.detectConflicts(version, oldest, committed);
+		return committed.size();
+	};
+
+	// Fill the history as a resolver under steady load would have it before timing
+	for (int b = 0; b < kBatchesInWindow * 2; b++)
+		resolve(batches[b % batches.size()]);
+
+	int b = 0;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(resolve(batches[b]));
+		b = (b + 1) % batches.size();
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()) * kTransactionsPerBatch);
+	destroyConflictSet(cs);
+}
+
+BENCHMARK_TEMPLATE(bench_conflict_batch, HistoryType::SkipList)->Arg(0)->Arg(16)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_conflict_batch, HistoryType::BTree)->Arg(0)->Arg(16)->ReportAggregatesOnly(true);
@@ -0,0 +1,96 @@
+/*
+ * BenchCoroutine.actor.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include <vector>
+
+#include "fdbclient/Notified.h"
+#include "flow/Coroutines.h"
+#include "flow/flow.h"
+#include "flow/ThreadHelper.actor.h"
+
+#include "flow/actorcompiler.h" // This must be the last #include.
+
+// The same function compiled by the actor compiler and as a C++20 coroutine, to compare their overhead. It is the core
+// of the storage server's waitForVersionActor: most calls find the version already there and return at once, and the
+// rest wait for it to be set.
+
+enum class Impl { Actor, Coroutine };
+
+ACTOR static Future<Version> waitForVersionActor(NotifiedVersion* version, Version v) {
+	wait(version->whenAtLeast(v));
+	return version->get();
+}
+
+static Future<Version> waitForVersionCoroutine(NotifiedVersion* version, Version v) {
+	co_await version->whenAtLeast(v);
+	co_return version->get();
+}
+
+template <Impl I>
+static Future<Version> waitForVersion(NotifiedVersion* version, Version v) {
+	if constexpr (I == Impl::Actor) {
+		return waitForVersionActor(version, v);
+	} else {
+		return waitForVersionCoroutine(version, v);
+	}
+}
+
+template <Impl I>
+static void bench_wait_for_version_ready(benchmark::State& benchState) {
+	onMainThread([&benchState]() {
+		NotifiedVersion version(1);
+		Version sum = 0;
+		for (auto _ : benchState) {
+			sum += waitForVersion<I>(&version, 1).get();
+		}
+		benchmark::DoNotOptimize(sum);
+		benchState.SetItemsProcessed(static_cast<long>(benchState.iterations()));
+		return Future<Void>(Void());
+	}).blockUntilReady();
+}
+
+// benchState.range(0) calls wait, each for its own version, and are then all woken by setting the last one
+template <Impl I>
+static void bench_wait_for_version_blocked(benchmark::State& benchState) {
+	onMainThread([&benchState]() {
+		const int waiters = benchState.range(0);
+		NotifiedVersion version(0);
+		std::vector<Future<Version>> futures;
+		futures.reserve(waiters);
+		for (auto _ : benchState) {
+			futures.clear();
+			const Version base = version.get();
+			for (int i = 1; i <= waiters; ++i) {
+				futures.push_back(waitForVersion<I>(&version, base + i));
+			}
+			version.set(base + waiters);
+			benchmark::DoNotOptimize(futures.back().get());
+		}
+		benchState.SetItemsProcessed(waiters * static_cast<long>(benchState.iterations()));
+		return Future<Void>(Void());
+	}).blockUntilReady();
+}
+
+BENCHMARK_TEMPLATE(bench_wait_for_version_ready, Impl::Actor)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_wait_for_version_ready, Impl::Coroutine)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_wait_for_version_blocked, Impl::Actor)->Range(1, 1 << 8)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_wait_for_version_blocked, Impl::Coroutine)->Range(1, 1 << 8)->ReportAggregatesOnly(true);
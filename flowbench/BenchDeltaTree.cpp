@@ -0,0 +1,162 @@
+/*
+ * BenchDeltaTree.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include <set>
+
+#include "fdbserver/DeltaTree.h"
+#include "flow/Arena.h"
+#include "flow/IRandom.h"
+
+// A prefix compressed key, which is how Redwood stores the keys of its BTree pages
+struct BenchKey {
+	BenchKey() {}
+	explicit BenchKey(KeyRef key) : key(key) {}
+	BenchKey(Arena& arena, const BenchKey& toCopy) : key(arena, toCopy.key) {}
+
+	typedef KeyRef Partial;
+
+	void updateCache(Optional<Partial>& cache, Arena& arena) const { cache = KeyRef(arena, key); }
+
+#pragma pack(push, 1)
+	struct Delta {
+		uint8_t flags;
+		uint16_t prefixLen;
+		uint16_t suffixLen;
+
+		uint8_t* suffix() { return (uint8_t*)(this + 1); }
+
+		BenchKey apply(const Partial& cache) { return BenchKey(cache); }
+
+		BenchKey apply(Arena& arena, const Partial& base, Optional<Partial>& cache) {
+			uint8_t* buf = new (arena) uint8_t[prefixLen + suffixLen];
+			memcpy(buf, base.begin(), prefixLen);
+			memcpy(buf + prefixLen, suffix(), suffixLen);
+			cache = KeyRef(buf, prefixLen + suffixLen);
+			return BenchKey(cache.get());
+		}
+
+		BenchKey apply(Arena& arena, const BenchKey& base, Optional<Partial>& cache) {
+			return apply(arena, base.key, cache);
+		}
+
+		void setPrefixSource(bool val) { flags = val ? (flags | 1) : (flags & ~1); }
+		bool getPrefixSource() const { return flags & 1; }
+		void setDeleted(bool val) { flags = val ? (flags | 2) : (flags & ~2); }
+		bool getDeleted() const { return flags & 2; }
+
+		int size() const { return sizeof(Delta) + suffixLen; }
+		std::string toString() const { return format("{prefix=%d suffix=%d}", prefixLen, suffixLen); }
+	};
+#pragma pack(pop)
+
+	int getCommonPrefixLen(const BenchKey& other, int skipLen = 0) const {
+		return skipLen + commonPrefixLength(key, other.key, skipLen);
+	}
+
+	int compare(const BenchKey& rhs, int skipLen = 0) const {
+		return key.compareSuffix(rhs.key, std::min({ skipLen, key.size(), rhs.key.size() }));
+	}
+
+	int deltaSize(const BenchKey& base, int skipLen, bool worstCase) const {
+		return sizeof(Delta) + key.size() - getCommonPrefixLen(base, skipLen);
+	}
+
+	int writeDelta(Delta& d, const BenchKey& base, int commonPrefix = -1) const {
+		if (commonPrefix < 0) {
+			commonPrefix = getCommonPrefixLen(base, 0);
+		}
+		d.flags = 0;
+		d.prefixLen = commonPrefix;
+		d.suffixLen = key.size() - commonPrefix;
+		memcpy(d.suffix(), key.begin() + commonPrefix, d.suffixLen);
+		return d.size();
+	}
+
+	std::string toString() const { return key.printable(); }
+
+	KeyRef key;
+};
+
+// Keys share a long prefix, as keys within one BTree page usually do, and differ in a random suffix
+static std::vector<BenchKey> makeKeys(Arena& arena, int keySize, int count) {
+	std::string prefix(keySize / 2, 'p');
+	std::set<std::string> unique;
+	while (unique.size() < count) {
+		std::string key = prefix;
+		while (key.size() < keySize) {
+			key.push_back((char)deterministicRandom()->randomInt(0, 256));
+		}
+		unique.insert(key);
+	}
+	std::vector<BenchKey> keys;
+	for (auto const& k : unique) {
+		keys.emplace_back(KeyRef(arena, k));
+	}
+	return keys;
+}
+
+static void bench_delta_tree_seek(benchmark::State& state) {
+	const int keySize = state.range(0);
+	const bool reuseCache = state.range(1);
+	// Roughly the number of keys of this size that fit in a 64KB page
+	const int count = std::max(16, 64 * 1024 / (keySize + (int)sizeof(BenchKey::Delta) + 8));
+
+	Arena arena;
+	std::vector<BenchKey> keys = makeKeys(arena, keySize, count);
+	BenchKey lowerBound{ KeyRef() };
+	BenchKey upperBound(StringRef(arena, std::string(keySize + 1, '\xff')));
+
+	int bufferSize = count * (keySize + 32) + 1024;
+	std::vector<uint8_t> buffer(bufferSize);
+	auto* tree = (DeltaTree2<BenchKey>*)buffer.data();
+	tree->build(bufferSize, &keys.front(), &keys.back() + 1, &lowerBound, &upperBound);
+
+	auto cache = makeReference<DeltaTree2<BenchKey>::DecodeCache>(lowerBound, upperBound);
+	int i = 0;
+	for (auto _ : state) {
+		if (!reuseCache) {
+			// A page which was just read has nothing decoded yet
+			state.PauseTiming();
+			cache = makeReference<DeltaTree2<BenchKey>::DecodeCache>(lowerBound, upperBound);
+			state.ResumeTiming();
+		}
+		DeltaTree2<BenchKey>::Cursor cur(cache, tree);
+		benchmark::DoNotOptimize(cur.seekGreaterThanOrEqual(keys[i]));
+		i = (i + 1) % count;
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+static void bench_common_prefix_length(benchmark::State& state) {
+	const int size = state.range(0);
+	std::string a(size, 'k');
+	std::string b = a;
+	b.back() = 'x';
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(commonPrefixLength(StringRef(a), StringRef(b)));
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+	state.SetBytesProcessed(static_cast<long>(state.iterations()) * size);
+}
+
+BENCHMARK(bench_delta_tree_seek)->ArgsProduct({ { 16, 64, 256, 1024 }, { 0, 1 } })->ReportAggregatesOnly(true);
+BENCHMARK(bench_common_prefix_length)->Arg(8)->Arg(16)->Arg(64)->Arg(256)->Arg(1024)->ReportAggregatesOnly(true);
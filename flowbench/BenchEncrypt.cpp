@@ -235,3 +235,67 @@ static void blob_chipher_args(benchmark::internal::Benchmark* b) {
 
 BENCHMARK(blob_chipher_encrypt)->Apply(blob_chipher_args);
 BENCHMARK(blob_chipher_decrypt)->Apply(blob_chipher_args);
+
+// Encryption as the commit proxy does it per mutation (100 bytes) and Redwood per page (8000 bytes): with an encryptor
+// constructed for each buffer, or with one encryptor reused across buffers under a new IV each.
+static void blob_cipher_encrypt_reuse(benchmark::State& state) {
+	const EncryptCipherDomainId minDomainId = 1;
+	const int bufLen = state.range(0);
+	const EncryptAuthTokenAlgo authAlgo = static_cast<EncryptAuthTokenAlgo>(state.range(1));
+	const bool isReused = state.range(2);
+	const EncryptAuthTokenMode authMode = authAlgo == EncryptAuthTokenAlgo::ENCRYPT_HEADER_AUTH_TOKEN_ALGO_NONE
+	                                          ? EncryptAuthTokenMode::ENCRYPT_HEADER_AUTH_TOKEN_MODE_NONE
+	                                          : EncryptAuthTokenMode::ENCRYPT_HEADER_AUTH_TOKEN_MODE_SINGLE;
+
+	SetupEncryptCipher();
+
+	Reference<BlobCipherKeyCache> cipherKeyCache = BlobCipherKeyCache::getInstance();
+	Reference<BlobCipherKey> cipherKey = cipherKeyCache->getLatestCipherKey(minDomainId);
+	Reference<BlobCipherKey> headerCipherKey = cipherKeyCache->getLatestCipherKey(ENCRYPT_HEADER_DOMAIN_ID);
+	if (!headerCipherKey.isValid()) {
+		Reference<BaseCipher> headerBaseCipher = makeReference<BaseCipher>(
+		    ENCRYPT_HEADER_DOMAIN_ID, 1, std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::max());
+		headerCipherKey = cipherKeyCache->insertCipherKey(headerBaseCipher->domainId,
+		                                                  headerBaseCipher->keyId,
+		                                                  headerBaseCipher->key.get(),
+		                                                  headerBaseCipher->len,
+		                                                  headerBaseCipher->kcv,
+		                                                  headerBaseCipher->refreshAt,
+		                                                  headerBaseCipher->expireAt);
+	}
+	uint8_t orgData[bufLen];
+	deterministicRandom()->randomBytes(&orgData[0], bufLen);
+
+	EncryptBlobCipherAes265Ctr reused(cipherKey, headerCipherKey, authMode, authAlgo, BlobCipherMetrics::TEST);
+	for (auto _ : state) {
+		Arena arena;
+		uint8_t iv[AES_256_IV_LENGTH];
+		deterministicRandom()->randomBytes(&iv[0], AES_256_IV_LENGTH);
+		BlobCipherEncryptHeaderRef headerRef;
+		if (isReused) {
+			reused.resetIV(iv, AES_256_IV_LENGTH);
+			benchmark::DoNotOptimize(reused.encrypt(&orgData[0], bufLen, &headerRef, arena));
+		} else {
+			EncryptBlobCipherAes265Ctr encryptor(
+			    cipherKey, headerCipherKey, iv, AES_256_IV_LENGTH, authMode, authAlgo, BlobCipherMetrics::TEST);
+			benchmark::DoNotOptimize(encryptor.encrypt(&orgData[0], bufLen, &headerRef, arena));
+		}
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+	state.SetBytesProcessed(bufLen * static_cast<long>(state.iterations()));
+}
+
+static void blob_cipher_encrypt_reuse_args(benchmark::internal::Benchmark* b) {
+	for (int bufLen : { 100, 8000 }) {
+		for (int authAlgo : { EncryptAuthTokenAlgo::ENCRYPT_HEADER_AUTH_TOKEN_ALGO_NONE,
+		                      EncryptAuthTokenAlgo::ENCRYPT_HEADER_AUTH_TOKEN_ALGO_HMAC_SHA,
+		                      EncryptAuthTokenAlgo::ENCRYPT_HEADER_AUTH_TOKEN_ALGO_AES_CMAC }) {
+			for (bool isReused : { false, true }) {
+				b->Args({ bufLen, authAlgo, isReused });
+			}
+		}
+	}
+	b->ArgNames({ "bufLen", "authAlgo", "isReused" });
+}
+
+BENCHMARK(blob_cipher_encrypt_reuse)->Apply(blob_cipher_encrypt_reuse_args);
@@ -20,11 +20,14 @@
 
 #include "benchmark/benchmark.h"
 #include "crc32/crc32c.h"
+#include "fdbclient/CommitTransaction.h"
 #include "flow/Hash3.h"
 #include "flow/xxhash.h"
 #include "flowbench/GlobalData.h"
 
 #include <stdint.h>
+#include <string>
+#include <vector>
 
 enum class HashType {
 	HashLittle2,
@@ -64,6 +67,56 @@ static void bench_hash(benchmark::State& state) {
 	state.SetItemsProcessed(static_cast<long>(state.iterations()));
 }
 
+// The mutations of a commit batch with keys of state.range(0) bytes and values of state.range(1) bytes
+static Standalone<VectorRef<MutationRef>> getMutations(benchmark::State& state, int count) {
+	Standalone<VectorRef<MutationRef>> mutations;
+	for (int i = 0; i < count; i++) {
+		mutations.push_back_deep(mutations.arena(),
+		                         MutationRef(MutationRef::SetValue, getKey(state.range(0)), getKey(state.range(1))));
+	}
+	return mutations;
+}
+
+static constexpr int kMutationsPerBatch = 1000;
+
+// Checksums every mutation of a batch on its own, as populateChecksum() and validateChecksum() do
+static void bench_mutation_checksum(benchmark::State& state) {
+	auto mutations = getMutations(state, kMutationsPerBatch);
+	for (auto _ : state) {
+		for (auto const& m : mutations) {
+			benchmark::DoNotOptimize(m.calculateChecksum());
+		}
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()) * mutations.size());
+	state.SetBytesProcessed(static_cast<long>(state.iterations()) * mutations.expectedSize());
+}
+
+// Hashes the same mutations laid out contiguously, as they are in a serialized batch, in a single call
+template <HashType hashType>
+static void bench_mutation_batch_checksum(benchmark::State& state) {
+	auto mutations = getMutations(state, kMutationsPerBatch);
+	std::string buffer;
+	for (auto const& m : mutations) {
+		buffer.push_back(static_cast<char>(m.type));
+		buffer.append(reinterpret_cast<const char*>(m.param1.begin()), m.param1.size());
+		buffer.append(reinterpret_cast<const char*>(m.param2.begin()), m.param2.size());
+	}
+	KeyRef batch = StringRef(buffer);
+	for (auto _ : state) {
+		hash<hashType>(batch, batch.size());
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()) * mutations.size());
+	state.SetBytesProcessed(static_cast<long>(state.iterations()) * mutations.expectedSize());
+}
+
+static void mutationSizes(benchmark::internal::Benchmark* b) {
+	b->Args({ 16, 100 })->Args({ 32, 500 })->Args({ 64, 4000 });
+}
+
 BENCHMARK_TEMPLATE(bench_hash, HashType::CRC32C)->DenseRange(2, 18)->ReportAggregatesOnly(true);
 BENCHMARK_TEMPLATE(bench_hash, HashType::HashLittle2)->DenseRange(2, 18)->ReportAggregatesOnly(true);
 BENCHMARK_TEMPLATE(bench_hash, HashType::XXHash3)->DenseRange(2, 18)->ReportAggregatesOnly(true);
+
+BENCHMARK(bench_mutation_checksum)->Apply(mutationSizes)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_mutation_batch_checksum, HashType::CRC32C)->Apply(mutationSizes)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_mutation_batch_checksum, HashType::XXHash3)->Apply(mutationSizes)->ReportAggregatesOnly(true);
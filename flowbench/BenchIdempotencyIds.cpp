@@ -27,33 +27,63 @@ static bool getRuntimeFalse() {
 	return deterministicRandom()->randomInt(0, 2) == -1;
 }
 
+static std::vector<CommitTransactionRequest> makeTransactions(int numTransactions, int idSize) {
+	auto trs = std::vector<CommitTransactionRequest>(numTransactions);
+	for (auto& tr : trs) {
+		if (idSize > 0) {
+			auto id = makeString(idSize, tr.arena);
+			deterministicRandom()->randomBytes(mutateString(id), idSize);
+			tr.idempotencyId = IdempotencyIdRef(tr.arena, IdempotencyIdRef(id));
+		}
+	}
+	return trs;
+}
+
 static void bench_add_idempotency_ids(benchmark::State& state) {
 	auto numTransactions = state.range(0);
 	auto idSize = state.range(1);
-	auto trs = std::vector<CommitTransactionRequest>(numTransactions);
+	auto trs = makeTransactions(numTransactions, idSize);
 	IdempotencyIdKVBuilder idempotencyKVBuilder;
+	idempotencyKVBuilder.setCompactEncoding(state.range(2));
 	Version commitVersion = 0;
 	auto committed = std::vector<uint8_t>(numTransactions);
 	auto committedValue = 3;
 	for (auto& c : committed) {
 		c = deterministicRandom()->coinflip() ? committedValue : 0;
 	}
-	for (auto& tr : trs) {
-		if (idSize > 0) {
-			auto id = makeString(idSize, tr.arena);
-			deterministicRandom()->randomBytes(mutateString(id), idSize);
-			tr.idempotencyId = IdempotencyIdRef(tr.arena, IdempotencyIdRef(id));
-		}
-	}
 	bool locked = getRuntimeFalse();
+	int64_t bytes = 0;
 	for (auto _ : state) {
+		bytes = 0;
 		buildIdempotencyIdMutations(
-		    trs, idempotencyKVBuilder, commitVersion++, committed, committedValue, locked, [](const KeyValue&) {
-			    benchmark::DoNotOptimize(0);
+		    trs, idempotencyKVBuilder, commitVersion++, committed, committedValue, locked, [&](const KeyValue& kv) {
+			    bytes += kv.expectedSize();
 		    });
 	}
 	state.counters["TimePerTransaction"] = benchmark::Counter(
 	    state.iterations() * numTransactions, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+	state.counters["BytesPerTransaction"] = double(bytes) / numTransactions;
+}
+
+// Looks up an idempotency id in each of the kv pairs written for a commit batch, as a client does to learn whether its
+// transaction committed
+static void bench_find_idempotency_id(benchmark::State& state) {
+	auto numTransactions = state.range(0);
+	auto trs = makeTransactions(numTransactions, 16);
+	IdempotencyIdKVBuilder idempotencyKVBuilder;
+	idempotencyKVBuilder.setCompactEncoding(state.range(1));
+	auto committed = std::vector<uint8_t>(numTransactions, 1);
+	std::vector<KeyValue> kvs;
+	buildIdempotencyIdMutations(
+	    trs, idempotencyKVBuilder, 1, committed, 1, false, [&](const KeyValue& kv) { kvs.push_back(kv); });
+	int i = 0;
+	for (auto _ : state) {
+		const auto& id = trs[i++ % numTransactions].idempotencyId;
+		for (const auto& kv : kvs) {
+			benchmark::DoNotOptimize(kvContainsIdempotencyId(kv, id));
+		}
+	}
 }
 
-BENCHMARK(bench_add_idempotency_ids)->ArgsProduct({ benchmark::CreateRange(1, 16384, 4), { 0, 16, 255 } });
+BENCHMARK(bench_add_idempotency_ids)->ArgsProduct({ benchmark::CreateRange(1, 16384, 4), { 0, 16, 255 }, { 0, 1 } });
+BENCHMARK(bench_find_idempotency_id)->ArgsProduct({ benchmark::CreateRange(1, 4096, 4), { 0, 1 } });
@@ -0,0 +1,132 @@
+/*
+ * BenchKeyValueContainer.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "fdbserver/BTreeKeyValueContainer.h"
+#include "fdbserver/IKeyValueContainer.h"
+#include "fdbserver/RadixTree.h"
+#include "flow/IRandom.h"
+
+// Compares the containers KeyValueStoreMemory can hold its data in: the IndexedSet behind IKeyValueContainer, the radix
+// tree used by the memory-radixtree engine and BTreeKeyValueContainer.
+
+static constexpr int kRangeRows = 100;
+
+// Keys share a long prefix, as keys under a tenant or directory prefix do
+static std::vector<Key> makeContainerKeys(int count) {
+	std::vector<Key> keys;
+	keys.reserve(count);
+	for (int i = 0; i < count; ++i) {
+		int id = deterministicRandom()->randomInt(0, count * 4);
+		keys.push_back(Key(format("\x15\x01tenant/\x15\x02users/%012d", id)));
+	}
+	return keys;
+}
+
+template <class Container>
+static void fillContainer(Container& data, std::vector<Key> const& keys, ValueRef value) {
+	for (auto const& key : keys) {
+		data.insert(key, value);
+	}
+}
+
+template <class Container>
+static void bench_kv_container_insert(benchmark::State& state) {
+	const int count = state.range(0);
+	std::string valueBytes(state.range(1), 'v');
+	auto keys = makeContainerKeys(count);
+	for (auto _ : state) {
+		Container data;
+		fillContainer(data, keys, ValueRef(valueBytes));
+		state.PauseTiming();
+		data.clear();
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()) * count);
+}
+
+template <class Container>
+static void bench_kv_container_lookup(benchmark::State& state) {
+	const int count = state.range(0);
+	std::string valueBytes(state.range(1), 'v');
+	auto keys = makeContainerKeys(count);
+	Container data;
+	fillContainer(data, keys, ValueRef(valueBytes));
+	int i = 0;
+	for (auto _ : state) {
+		auto it = data.find(keys[i]);
+		benchmark::DoNotOptimize(it.getValue().size());
+		i = (i + 1) % count;
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+	data.clear();
+}
+
+template <class Container>
+static void bench_kv_container_range(benchmark::State& state) {
+	const int count = state.range(0);
+	std::string valueBytes(state.range(1), 'v');
+	auto keys = makeContainerKeys(count);
+	Container data;
+	fillContainer(data, keys, ValueRef(valueBytes));
+	// The radix tree rebuilds keys into a caller supplied buffer
+	std::vector<uint8_t> keyBuffer(1 << 16);
+	int i = 0;
+	for (auto _ : state) {
+		int64_t bytes = 0;
+		auto it = data.lower_bound(keys[i]);
+		for (int rows = 0; rows < kRangeRows && it != data.end(); ++rows, ++it) {
+			bytes += it.getKey(keyBuffer.data()).size() + it.getValue().size();
+		}
+		benchmark::DoNotOptimize(bytes);
+		i = (i + 1) % count;
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()) * kRangeRows);
+	data.clear();
+}
+
+BENCHMARK_TEMPLATE(bench_kv_container_insert, IKeyValueContainer)
+    ->ArgsProduct({ { 10000, 1000000 }, { 16, 256 } })
+    ->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_kv_container_insert, radix_tree)
+    ->ArgsProduct({ { 10000, 1000000 }, { 16, 256 } })
+    ->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_kv_container_insert, BTreeKeyValueContainer)
+    ->ArgsProduct({ { 10000, 1000000 }, { 16, 256 } })
+    ->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_kv_container_lookup, IKeyValueContainer)
+    ->ArgsProduct({ { 10000, 1000000 }, { 16, 256 } })
+    ->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_kv_container_lookup, radix_tree)
+    ->ArgsProduct({ { 10000, 1000000 }, { 16, 256 } })
+    ->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_kv_container_lookup, BTreeKeyValueContainer)
+    ->ArgsProduct({ { 10000, 1000000 }, { 16, 256 } })
+    ->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_kv_container_range, IKeyValueContainer)
+    ->ArgsProduct({ { 10000, 1000000 }, { 16, 256 } })
+    ->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_kv_container_range, radix_tree)
+    ->ArgsProduct({ { 10000, 1000000 }, { 16, 256 } })
+    ->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_kv_container_range, BTreeKeyValueContainer)
+    ->ArgsProduct({ { 10000, 1000000 }, { 16, 256 } })
+    ->ReportAggregatesOnly(true);
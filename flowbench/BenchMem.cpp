@@ -19,10 +19,16 @@
  */
 
 #include <cstring>
+#include <map>
 #include <memory>
+#include <vector>
 
 #include "benchmark/benchmark.h"
 
+#include "flow/FastAlloc.h"
+#include "flow/IRandom.h"
+#include "flow/Platform.h"
+
 static void bench_memcmp(benchmark::State& state) {
 	constexpr int kLength = 10000;
 	std::unique_ptr<char[]> b1{ new char[kLength] };
@@ -47,5 +53,46 @@ static void bench_memcpy(benchmark::State& state) {
 	}
 }
 
+// Random reads over state.range(0) MiB of FastAllocator magazines, the way PTree and arena-heavy code reads memory,
+// either mapped magazine by magazine or as with FAST_ALLOC_HUGE_PAGES. The difference is the cost of TLB misses.
+template <bool HugePages>
+static void bench_magazine_random_access(benchmark::State& state) {
+	const size_t bytes = size_t(state.range(0)) << 20;
+	// Like FastAllocator, never gives the memory back, but reuses it across repetitions
+	static std::map<size_t, std::vector<uint8_t*>> magazinesBySize;
+	std::vector<uint8_t*>& magazines = magazinesBySize[bytes];
+	for (size_t allocated = magazines.size() * kFastAllocMagazineBytes; allocated < bytes;) {
+		if (HugePages) {
+			uint8_t* hugePage = (uint8_t*)allocateHugePageBacked(kFastAllocHugePageBytes);
+			for (int m = 0; m < kFastAllocHugePageBytes / kFastAllocMagazineBytes; m++) {
+				magazines.push_back(hugePage + m * kFastAllocMagazineBytes);
+			}
+			allocated += kFastAllocHugePageBytes;
+		} else {
+			magazines.push_back((uint8_t*)allocate(kFastAllocMagazineBytes, false, false));
+			allocated += kFastAllocMagazineBytes;
+		}
+	}
+	for (auto magazine : magazines) {
+		memset(magazine, 1, kFastAllocMagazineBytes);
+	}
+
+	std::vector<std::pair<uint32_t, uint32_t>> offsets(1 << 16);
+	for (auto& [magazine, offset] : offsets) {
+		magazine = deterministicRandom()->randomInt(0, magazines.size());
+		offset = deterministicRandom()->randomInt(0, kFastAllocMagazineBytes);
+	}
+	int64_t sum = 0;
+	for (auto _ : state) {
+		for (auto [magazine, offset] : offsets) {
+			sum += magazines[magazine][offset];
+		}
+	}
+	benchmark::DoNotOptimize(sum);
+	state.SetItemsProcessed(static_cast<long>(state.iterations()) * offsets.size());
+}
+
 BENCHMARK(bench_memcmp);
 BENCHMARK(bench_memcpy);
+BENCHMARK_TEMPLATE(bench_magazine_random_access, false)->Arg(64)->Arg(1024)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_magazine_random_access, true)->Arg(64)->Arg(1024)->ReportAggregatesOnly(true);
@@ -20,6 +20,7 @@
 
 #include "benchmark/benchmark.h"
 
+#include "flow/IConnection.h"
 #include "flow/IRandom.h"
 #include "flow/flow.h"
 #include "flow/DeterministicRandom.h"
@@ -91,3 +92,81 @@ static void bench_delay(benchmark::State& benchState) {
 
 BENCHMARK_TEMPLATE(bench_delay, DELAY)->Range(0, 1 << 16)->ReportAggregatesOnly(true);
 BENCHMARK_TEMPLATE(bench_delay, YIELD)->Range(0, 1 << 16)->ReportAggregatesOnly(true);
+
+// Measures reading from a loopback TCP connection the way FlowTransport's connectionReader does: read until read()
+// returns 0, then wait for the socket to become readable again. Besides throughput, it reports per MB received how
+// many reads returned data, how many found nothing left to read, and how many readability probes were waited on, as
+// those are what a different reactor would change.
+
+class BenchSendBuffer : public SendBuffer {
+public:
+	BenchSendBuffer(uint8_t* data, int bytes) {
+		_data = data;
+		next = nullptr;
+		bytes_written = bytes;
+		bytes_sent = 0;
+	}
+};
+
+// Writes chunks of chunkBytes as fast as the connection takes them
+ACTOR static Future<Void> writeForever(Reference<IConnection> conn, int chunkBytes) {
+	state std::vector<uint8_t> data(chunkBytes, 'x');
+	state BenchSendBuffer buffer(data.data(), chunkBytes);
+	loop {
+		buffer.bytes_sent = 0;
+		while (buffer.bytes_unsent() > 0) {
+			int sent = conn->write(&buffer, buffer.bytes_unsent());
+			if (sent == 0) {
+				wait(conn->onWritable());
+			}
+			buffer.bytes_sent += sent;
+		}
+		wait(yield());
+	}
+}
+
+ACTOR static Future<Void> benchNet2ConnectionActor(benchmark::State* benchState) {
+	state NetworkAddress address(0x7f000001, nondeterministicRandom()->randomInt(20000, 60000));
+	state Reference<IListener> listener = INetworkConnections::net()->listen(address);
+	state Future<Reference<IConnection>> accepted = listener->accept();
+	state Reference<IConnection> client = wait(INetworkConnections::net()->connect(address));
+	state Reference<IConnection> server = wait(accepted);
+	state Future<Void> writer = writeForever(client, benchState->range(0));
+	state std::vector<uint8_t> buffer(FLOW_KNOBS->MAX_PACKET_SEND_BYTES);
+	state int64_t bytes = 0;
+	state int64_t reads = 0;
+	state int64_t emptyReads = 0;
+	state int64_t probes = 0;
+
+	while (benchState->KeepRunning()) {
+		loop {
+			int readBytes = server->read(buffer.data(), buffer.data() + buffer.size());
+			if (readBytes == 0) {
+				++emptyReads;
+				break;
+			}
+			++reads;
+			bytes += readBytes;
+		}
+		++probes;
+		wait(server->onReadable());
+		wait(delay(0, TaskPriority::ReadSocket));
+	}
+
+	double megabytes = std::max(bytes, int64_t(1)) / 1e6;
+	benchState->SetBytesProcessed(bytes);
+	benchState->counters["ReadsPerMB"] = reads / megabytes;
+	benchState->counters["EmptyReadsPerMB"] = emptyReads / megabytes;
+	benchState->counters["ReadProbesPerMB"] = probes / megabytes;
+	writer.cancel();
+	client->close();
+	server->close();
+	listener.clear();
+	return Void();
+}
+
+static void bench_net2_connection(benchmark::State& benchState) {
+	onMainThread([&benchState] { return benchNet2ConnectionActor(&benchState); }).blockUntilReady();
+}
+
+BENCHMARK(bench_net2_connection)->Arg(4096)->Arg(65536)->ReportAggregatesOnly(true);
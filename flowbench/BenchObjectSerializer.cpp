@@ -0,0 +1,149 @@
+/*
+ * BenchObjectSerializer.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "fdbclient/CommitProxyInterface.h"
+#include "fdbclient/StorageServerInterface.h"
+#include "fdbserver/TLogInterface.h"
+#include "flow/ObjectSerializer.h"
+
+// Serializes and deserializes replies of the busiest RPCs with ObjectWriter and ObjectReader, shaped as a storage
+// server, proxy or TLog sends them. ErrorOr<EnsureTable<T>> is how a reply goes over the wire.
+//
+// WatchValueReply and StorageMetrics have a fixed layout, so after the first message ObjectWriter skips working out
+// their size. The others have keys, values, vectors or optional fields and always take both passes. Requests are left
+// out: their ReplyPromise would register an endpoint with FlowTransport from the benchmark thread.
+
+template <class T>
+T makeMessage();
+
+template <>
+WatchValueReply makeMessage() {
+	return WatchValueReply(123456789);
+}
+
+template <>
+StorageMetrics makeMessage() {
+	StorageMetrics metrics;
+	metrics.bytes = 1e9;
+	metrics.bytesWrittenPerKSecond = 1e7;
+	metrics.bytesReadPerKSecond = 1e8;
+	return metrics;
+}
+
+template <>
+GetValueReply makeMessage() {
+	return GetValueReply(Value(std::string(100, 'v')), false);
+}
+
+template <>
+GetKeyReply makeMessage() {
+	return GetKeyReply(KeySelector(firstGreaterOrEqual("\x15\x01tenant/key"_sr)), false);
+}
+
+template <>
+GetKeyValuesReply makeMessage() {
+	GetKeyValuesReply reply;
+	for (int i = 0; i < 10; ++i) {
+		reply.data.push_back_deep(reply.arena,
+		                          KeyValueRef(StringRef(format("\x15\x01tenant/key%04d", i)), std::string(100, 'v')));
+	}
+	reply.version = 123456789;
+	return reply;
+}
+
+template <>
+GetReadVersionReply makeMessage() {
+	GetReadVersionReply reply;
+	reply.version = 123456789;
+	reply.midShardSize = 1e8;
+	reply.proxyId = UID(1, 2);
+	return reply;
+}
+
+template <>
+CommitID makeMessage() {
+	return CommitID(123456789, 3, Optional<Value>());
+}
+
+template <>
+TLogPeekReply makeMessage() {
+	TLogPeekReply reply;
+	reply.messages = StringRef(reply.arena, std::string(4000, 'm'));
+	reply.end = 123456789;
+	reply.maxKnownVersion = 123456789;
+	reply.minKnownCommittedVersion = 123456000;
+	return reply;
+}
+
+template <class T>
+static void bench_serialize_message(benchmark::State& state) {
+	const T message = makeMessage<T>();
+	size_t size = 0;
+	for (auto _ : state) {
+		ObjectWriter writer(AssumeVersion(g_network->protocolVersion()));
+		writer.serialize(message);
+		size = writer.toStringRef().size();
+		benchmark::DoNotOptimize(writer.toStringRef().begin());
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+	state.counters["Size"] = size;
+}
+
+template <class T>
+static void bench_deserialize_message(benchmark::State& state) {
+	const Standalone<StringRef> serialized =
+	    ObjectWriter::toValue(makeMessage<T>(), AssumeVersion(g_network->protocolVersion()));
+	for (auto _ : state) {
+		T message;
+		ObjectReader reader(serialized.begin(), AssumeVersion(g_network->protocolVersion()));
+		reader.deserialize(message);
+		benchmark::DoNotOptimize(message);
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+template <class T>
+static void bench_serialize_reply(benchmark::State& state) {
+	const ErrorOr<EnsureTable<T>> reply(makeMessage<T>());
+	for (auto _ : state) {
+		ObjectWriter writer(AssumeVersion(g_network->protocolVersion()));
+		writer.serialize(reply);
+		benchmark::DoNotOptimize(writer.toStringRef().begin());
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+BENCHMARK_TEMPLATE(bench_serialize_message, WatchValueReply)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_serialize_message, StorageMetrics)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_serialize_message, GetValueReply)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_serialize_message, GetKeyReply)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_serialize_message, GetKeyValuesReply)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_serialize_message, GetReadVersionReply)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_serialize_message, CommitID)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_serialize_message, TLogPeekReply)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_serialize_reply, WatchValueReply)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_serialize_reply, GetValueReply)->ReportAggregatesOnly(true);
+
+BENCHMARK_TEMPLATE(bench_deserialize_message, WatchValueReply)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_deserialize_message, GetValueReply)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_deserialize_message, GetKeyValuesReply)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_deserialize_message, TLogPeekReply)->ReportAggregatesOnly(true);
@@ -0,0 +1,80 @@
+/*
+ * BenchOnMainThread.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "fdbclient/IKnobCollection.h"
+#include "flow/Platform.h"
+#include "flow/ThreadHelper.actor.h"
+
+// Hands work to the network thread from other threads, as storage engine thread pools do with their completions.
+// Each of state.range(0) producer threads posts functors with onMainThreadVoid. Reports how many run per second, and
+// the mean time from being posted to running. state.range(1) sets NETWORK_THREAD_SPIN_BEFORE_SLEEP in microseconds.
+
+static constexpr int kPostsPerProducer = 10000;
+
+static void setSpinBeforeSleep(double seconds) {
+	onMainThread([seconds]() {
+		IKnobCollection::getMutableGlobalKnobCollection().setKnob("network_thread_spin_before_sleep",
+		                                                          KnobValueRef::create(double{ seconds }));
+		return Future<Void>(Void());
+	}).blockUntilReady();
+}
+
+static void bench_on_main_thread(benchmark::State& state) {
+	const int producerCount = state.range(0);
+	const int64_t total = int64_t(producerCount) * kPostsPerProducer;
+	setSpinBeforeSleep(state.range(1) / 1e6);
+
+	double totalLatency = 0;
+	for (auto _ : state) {
+		std::atomic<int64_t> done = 0;
+		// Only updated on the network thread, and read here once done says every functor has run
+		double latency = 0;
+		std::vector<std::thread> producers;
+		for (int p = 0; p < producerCount; ++p) {
+			producers.emplace_back([&]() {
+				for (int i = 0; i < kPostsPerProducer; ++i) {
+					onMainThreadVoid([&latency, &done, posted = timer_monotonic()]() {
+						latency += timer_monotonic() - posted;
+						done.fetch_add(1, std::memory_order_release);
+					});
+				}
+			});
+		}
+		for (auto& producer : producers) {
+			producer.join();
+		}
+		while (done.load(std::memory_order_acquire) < total) {
+			std::this_thread::yield();
+		}
+		totalLatency += latency;
+	}
+
+	setSpinBeforeSleep(0);
+	state.SetItemsProcessed(static_cast<long>(state.iterations()) * total);
+	state.counters["MeanLatencyUs"] = totalLatency * 1e6 / std::max<int64_t>(1, state.iterations() * total);
+}
+
+BENCHMARK(bench_on_main_thread)->ArgsProduct({ { 1, 4, 16 }, { 0, 50 } })->UseRealTime()->ReportAggregatesOnly(true);
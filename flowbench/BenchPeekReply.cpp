@@ -0,0 +1,99 @@
+/*
+ * BenchPeekReply.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+
+#include "fdbclient/CommitTransaction.h"
+#include "fdbclient/FDBTypes.h"
+#include "flow/Arena.h"
+#include "flow/serialize.h"
+
+// Measures how fast the messages of TLog peek replies are taken apart the way ServerPeekCursor and the storage server
+// do it: version headers, then for each message its tags and the mutation in it.
+//
+// By default replies are generated, shaped like those a storage server gets while catching up. To run over real
+// replies instead, set FLOWBENCH_PEEK_REPLIES to a file holding the messages of one or more TLogPeekReply, one after
+// another. The messages of a reply always start with a version header, so they can simply be concatenated.
+
+static Standalone<StringRef> makePeekReplies(int mutationsPerVersion, int valueBytes) {
+	BinaryWriter wr(AssumeVersion(g_network->protocolVersion()));
+	std::string value(valueBytes, 'v');
+	Tag tag(0, 1);
+	Version version = 1e9;
+	while (wr.getLength() < (10 << 20)) {
+		wr << VERSION_HEADER << version;
+		for (int i = 0; i < mutationsPerVersion; ++i) {
+			std::string key = format("\x15\x01tenant/\x15\x02users/%012d", i);
+			MutationRef m(MutationRef::SetValue, StringRef(key), StringRef(value));
+			// As LogPushData writes messages: length, subsequence, tags, then the mutation
+			int start = wr.getLength();
+			wr << uint32_t(0) << uint32_t(i + 1) << uint16_t(1) << tag << m;
+			*(uint32_t*)((uint8_t*)wr.getData() + start) = wr.getLength() - start - sizeof(uint32_t);
+		}
+		version += 1000;
+	}
+	return wr.toValue();
+}
+
+static Standalone<StringRef> loadPeekReplies(int mutationsPerVersion, int valueBytes) {
+	const char* path = std::getenv("FLOWBENCH_PEEK_REPLIES");
+	if (!path) {
+		return makePeekReplies(mutationsPerVersion, valueBytes);
+	}
+	std::ifstream file(path, std::ios::binary);
+	std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	return Standalone<StringRef>(StringRef(bytes));
+}
+
+static void bench_peek_reply_parse(benchmark::State& state) {
+	Standalone<StringRef> replies = loadPeekReplies(state.range(0), state.range(1));
+	int64_t messages = 0;
+	for (auto _ : state) {
+		ArenaReader rd(replies.arena(), replies, AssumeVersion(g_network->protocolVersion()));
+		TagsAndMessage messageAndTags;
+		Version version = invalidVersion;
+		uint32_t sub = 0;
+		int64_t bytes = 0;
+		messages = 0;
+		while (!rd.empty()) {
+			if (*(int32_t*)rd.peekBytes(4) == VERSION_HEADER) {
+				int32_t dummy;
+				rd >> dummy >> version;
+				continue;
+			}
+			messageAndTags.loadFromArena(&rd, &sub);
+			rd.rewind();
+			rd.readBytes(messageAndTags.getHeaderSize());
+			MutationRef m;
+			rd >> m;
+			bytes += version + sub + m.param1.size() + m.param2.size();
+			++messages;
+		}
+		benchmark::DoNotOptimize(bytes);
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()) * messages);
+	state.SetBytesProcessed(static_cast<long>(state.iterations()) * replies.size());
+}
+
+BENCHMARK(bench_peek_reply_parse)->ArgsProduct({ { 1, 100 }, { 16, 1000 } })->ReportAggregatesOnly(true);
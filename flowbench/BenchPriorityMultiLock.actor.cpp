@@ -27,7 +27,10 @@
 #include "flow/actorcompiler.h" // This must be the last #include.
 #include "fmt/printf.h"
 
-ACTOR static Future<Void> benchPriorityMultiLock(benchmark::State* benchState) {
+// Optional behaviours of the lock to measure the cost of
+enum class PMLOption { None, QueueWaitHistograms, Aging, SetWeights };
+
+ACTOR static Future<Void> benchPriorityMultiLock(benchmark::State* benchState, PMLOption option) {
 	// Arg1 is the number of active priorities to use
 	// Arg2 is the number of inactive priorities to use
 	state int active = benchState->range(0);
@@ -41,6 +44,12 @@ ACTOR static Future<Void> benchPriorityMultiLock(benchmark::State* benchState) {
 
 	state int concurrency = priorities.size() * 10;
 	state Reference<PriorityMultiLock> pml = makeReference<PriorityMultiLock>(concurrency, priorities);
+	if (option == PMLOption::QueueWaitHistograms) {
+		pml->enableQueueWaitHistograms("BenchPriorityMultiLock"_sr, "QueueWait");
+	} else if (option == PMLOption::Aging) {
+		// Every waiter has aged by the time it reaches the front, so every launch scans the waiting priorities
+		pml->setMaxQueueTime(1e-9);
+	}
 
 	// Clog the lock buy taking n=concurrency locks
 	state std::deque<Future<PriorityMultiLock::Lock>> lockFutures;
@@ -65,6 +74,12 @@ ACTOR static Future<Void> benchPriorityMultiLock(benchmark::State* benchState) {
 
 		PriorityMultiLock::Lock lock = wait(f);
 
+		// Reverse the weights every 1000 locks
+		if (option == PMLOption::SetWeights && benchState->iterations() % 1000 == 0) {
+			std::reverse(priorities.begin(), priorities.end());
+			pml->setWeights(priorities);
+		}
+
 		// Rotate to another priority
 		if (++p == active) {
 			p = 0;
@@ -81,8 +96,24 @@ ACTOR static Future<Void> benchPriorityMultiLock(benchmark::State* benchState) {
 	return Void();
 }
 
+template <PMLOption option>
 static void bench_priorityMultiLock(benchmark::State& benchState) {
-	onMainThread([&benchState]() { return benchPriorityMultiLock(&benchState); }).blockUntilReady();
+	onMainThread([&benchState]() { return benchPriorityMultiLock(&benchState, option); }).blockUntilReady();
 }
 
-BENCHMARK(bench_priorityMultiLock)->Args({ 5, 0 })->Ranges({ { 1, 64 }, { 0, 128 } })->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_priorityMultiLock, PMLOption::None)
+    ->Args({ 5, 0 })
+    ->Ranges({ { 1, 64 }, { 0, 128 } })
+    ->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_priorityMultiLock, PMLOption::QueueWaitHistograms)
+    ->Args({ 5, 0 })
+    ->Args({ 64, 0 })
+    ->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_priorityMultiLock, PMLOption::Aging)
+    ->Args({ 5, 0 })
+    ->Args({ 64, 0 })
+    ->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_priorityMultiLock, PMLOption::SetWeights)
+    ->Args({ 5, 0 })
+    ->Args({ 64, 0 })
+    ->ReportAggregatesOnly(true);
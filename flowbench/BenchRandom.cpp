@@ -20,6 +20,10 @@
 
 #include "benchmark/benchmark.h"
 
+#include <vector>
+
+#include "fdbrpc/ContinuousSample.h"
+#include "flow/FastRandom.h"
 #include "flow/IRandom.h"
 
 static void bench_random(benchmark::State& state) {
@@ -29,4 +33,50 @@ static void bench_random(benchmark::State& state) {
 	state.SetItemsProcessed(static_cast<long>(state.iterations()));
 }
 
+static void bench_random_int(benchmark::State& state) {
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(deterministicRandom()->randomInt(0, 3));
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+static void bench_fast_random(benchmark::State& state) {
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(fastRandom().random01());
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+static void bench_fast_random_int(benchmark::State& state) {
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(fastRandom().randomInt(0, 3));
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+static void bench_fast_random_batch(benchmark::State& state) {
+	std::vector<double> values(state.range(0));
+	for (auto _ : state) {
+		fastRandom().random01s(values.data(), values.size());
+		benchmark::DoNotOptimize(values.data());
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()) * values.size());
+}
+
+// A latency sample once it is full, where each new sample draws a random number
+static void bench_continuous_sample(benchmark::State& state) {
+	ContinuousSample<double> sample(1000);
+	double latency = 0;
+	for (auto _ : state) {
+		sample.addSample(latency);
+		latency += 1e-6;
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
 BENCHMARK(bench_random)->ReportAggregatesOnly(true);
+BENCHMARK(bench_random_int)->ReportAggregatesOnly(true);
+BENCHMARK(bench_fast_random)->ReportAggregatesOnly(true);
+BENCHMARK(bench_fast_random_int)->ReportAggregatesOnly(true);
+BENCHMARK(bench_fast_random_batch)->Arg(64)->Arg(1024)->ReportAggregatesOnly(true);
+BENCHMARK(bench_continuous_sample)->ReportAggregatesOnly(true);
@@ -0,0 +1,81 @@
+/*
+ * BenchStringRef.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "flow/Arena.h"
+#include "flow/IRandom.h"
+
+// Key comparisons as the in-memory structures make them: between neighbouring keys of a sorted set, which share a
+// prefix (a tenant, a table, an index) of state.range(0) bytes followed by 4 to 32 random bytes.
+
+static std::vector<Standalone<StringRef>> sortedKeys(int prefixLength) {
+	const std::string prefix(prefixLength, 'p');
+	std::vector<Standalone<StringRef>> keys;
+	for (int i = 0; i < 10000; ++i) {
+		keys.push_back(StringRef(prefix).withSuffix(deterministicRandom()->randomAlphaNumeric(
+		    deterministicRandom()->randomInt(4, 33))));
+	}
+	std::sort(keys.begin(), keys.end());
+	return keys;
+}
+
+static void bench_stringref_less(benchmark::State& state) {
+	auto keys = sortedKeys(state.range(0));
+	size_t i = 1;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(keys[i - 1] < keys[i]);
+		i = i + 1 < keys.size() ? i + 1 : 1;
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+static void bench_stringref_equal(benchmark::State& state) {
+	auto keys = sortedKeys(state.range(0));
+	// Equal keys in separate memory, as when a key read from the network is looked up
+	std::vector<Standalone<StringRef>> copies;
+	for (auto const& key : keys) {
+		copies.push_back(Standalone<StringRef>(key.contents()));
+	}
+	size_t i = 0;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(keys[i] == copies[i]);
+		i = i + 1 < keys.size() ? i + 1 : 0;
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+static void bench_stringref_common_prefix(benchmark::State& state) {
+	auto keys = sortedKeys(state.range(0));
+	size_t i = 1;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(commonPrefixLength(keys[i - 1], keys[i]));
+		i = i + 1 < keys.size() ? i + 1 : 1;
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+BENCHMARK(bench_stringref_less)->Arg(0)->Arg(8)->Arg(32)->Arg(128)->Arg(512)->ReportAggregatesOnly(true);
+BENCHMARK(bench_stringref_equal)->Arg(0)->Arg(8)->Arg(32)->Arg(128)->Arg(512)->ReportAggregatesOnly(true);
+BENCHMARK(bench_stringref_common_prefix)->Arg(0)->Arg(8)->Arg(32)->Arg(128)->Arg(512)->ReportAggregatesOnly(true);
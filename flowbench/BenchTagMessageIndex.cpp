@@ -0,0 +1,137 @@
+/*
+ * BenchTagMessageIndex.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include <deque>
+
+#include "fdbserver/TagMessageIndex.h"
+
+// Compares the TLog's per-tag message index with the std::deque<std::pair<Version, LengthPrefixedStringRef>> it
+// replaced, for memory per message and for peeking, which finds a version and then walks forward from it.
+
+static constexpr int kPeekMessages = 1000;
+
+static int64_t dequeAllocatedBytes = 0;
+
+template <class T>
+struct CountingAllocator : std::allocator<T> {
+	template <typename U>
+	struct rebind {
+		typedef CountingAllocator<U> other;
+	};
+
+	CountingAllocator() {}
+	template <typename U>
+	CountingAllocator(CountingAllocator<U> const& u) : std::allocator<T>(u) {}
+
+	T* allocate(std::size_t n) {
+		dequeAllocatedBytes += n * sizeof(T);
+		return std::allocator<T>::allocate(n);
+	}
+	void deallocate(T* p, std::size_t n) {
+		dequeAllocatedBytes -= n * sizeof(T);
+		std::allocator<T>::deallocate(p, n);
+	}
+};
+
+struct DequeMessages {
+	typedef std::pair<Version, LengthPrefixedStringRef> Entry;
+	std::deque<Entry, CountingAllocator<Entry>> messages;
+
+	void push_back(Version version, LengthPrefixedStringRef message) { messages.emplace_back(version, message); }
+	int64_t allocatedBytes() const { return dequeAllocatedBytes; }
+
+	int64_t peek(Version begin) const {
+		auto it = std::lower_bound(messages.begin(),
+		                           messages.end(),
+		                           std::make_pair(begin, LengthPrefixedStringRef()),
+		                           [](const auto& l, const auto& r) -> bool { return l.first < r.first; });
+		int64_t bytes = 0;
+		for (int i = 0; i < kPeekMessages && it != messages.end(); ++i, ++it) {
+			bytes += it->first + it->second.expectedSize();
+		}
+		return bytes;
+	}
+};
+
+struct IndexMessages {
+	TagMessageIndex messages;
+
+	void push_back(Version version, LengthPrefixedStringRef message) { messages.push_back(version, message); }
+	int64_t allocatedBytes() const { return messages.allocatedBytes(); }
+
+	int64_t peek(Version begin) const {
+		auto it = messages.lower_bound(begin);
+		int64_t bytes = 0;
+		for (int i = 0; i < kPeekMessages && it != messages.end(); ++i, ++it) {
+			bytes += it.version() + it.message().expectedSize();
+		}
+		return bytes;
+	}
+};
+
+// Messages for a tag arrive a few per version, and versions advance by about a million a second
+template <class Impl>
+static void fillMessages(Impl& data, int count, uint32_t* payload) {
+	Version version = 1e9;
+	for (int i = 0; i < count; ++i) {
+		if (i % 4 == 0) {
+			version += 1000;
+		}
+		data.push_back(version, LengthPrefixedStringRef(payload));
+	}
+}
+
+template <class Impl>
+static void bench_tag_messages_push(benchmark::State& state) {
+	const int count = state.range(0);
+	uint32_t payload = 100;
+	int64_t bytes = 0;
+	for (auto _ : state) {
+		Impl data;
+		fillMessages(data, count, &payload);
+		state.PauseTiming();
+		bytes = data.allocatedBytes();
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()) * count);
+	state.counters["BytesPerMessage"] = static_cast<double>(bytes) / count;
+}
+
+template <class Impl>
+static void bench_tag_messages_peek(benchmark::State& state) {
+	const int count = state.range(0);
+	uint32_t payload = 100;
+	Impl data;
+	fillMessages(data, count, &payload);
+	const int versions = count / 4;
+	int i = 0;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(data.peek(1e9 + int64_t(i) * 1000));
+		i = (i + 7919) % versions;
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()) * kPeekMessages);
+}
+
+BENCHMARK_TEMPLATE(bench_tag_messages_push, DequeMessages)->Arg(10000)->Arg(1000000)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_tag_messages_push, IndexMessages)->Arg(10000)->Arg(1000000)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_tag_messages_peek, DequeMessages)->Arg(10000)->Arg(1000000)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_tag_messages_peek, IndexMessages)->Arg(10000)->Arg(1000000)->ReportAggregatesOnly(true);
@@ -20,7 +20,9 @@
 
 #include "benchmark/benchmark.h"
 
+#include "flow/IRandom.h"
 #include "flow/Platform.h"
+#include "flow/TaskQueue.h"
 
 static void bench_timer(benchmark::State& state) {
 	for (auto _ : state) {
@@ -36,5 +38,41 @@ static void bench_timer_monotonic(benchmark::State& state) {
 	state.SetItemsProcessed(static_cast<long>(state.iterations()));
 }
 
+// The run loop's timers under a load like that of a busy proxy: state.range(0) outstanding delays of up to a second,
+// each renewed as it fires, while time moves on by 100us a loop. state.range(1) is the tick of the TimerWheel in
+// microseconds, or 0 for the heap.
+static void bench_task_queue_timers(benchmark::State& state) {
+	struct Task {};
+	const int outstanding = state.range(0);
+	TaskQueue<Task> taskQueue(state.range(1) / 1e6);
+	Task task;
+
+	std::vector<double> delays(1 << 16);
+	for (auto& delay : delays) {
+		delay = deterministicRandom()->random01();
+	}
+	size_t nextDelay = 0;
+	double now = 0;
+	for (int i = 0; i < outstanding; ++i) {
+		taskQueue.addTimer(now + delays[nextDelay++ % delays.size()], TaskPriority::DefaultDelay, &task);
+	}
+
+	int64_t fired = 0;
+	for (auto _ : state) {
+		now += 1e-4;
+		taskQueue.processReadyTimers(now);
+		while (taskQueue.hasReadyTask()) {
+			taskQueue.popReadyTask();
+			taskQueue.addTimer(now + delays[nextDelay++ % delays.size()], TaskPriority::DefaultDelay, &task);
+			++fired;
+		}
+		benchmark::DoNotOptimize(taskQueue.getSleepTime(now));
+	}
+	state.SetItemsProcessed(fired);
+}
+
 BENCHMARK(bench_timer)->ReportAggregatesOnly(true);
 BENCHMARK(bench_timer_monotonic)->ReportAggregatesOnly(true);
+BENCHMARK(bench_task_queue_timers)
+    ->ArgsProduct({ { 1000, 100000, 1000000 }, { 0, 100, 1000 } })
+    ->ReportAggregatesOnly(true);
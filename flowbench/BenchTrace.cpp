@@ -0,0 +1,106 @@
+/*
+ * BenchTrace.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "flow/BinaryTraceLogFormatter.h"
+#include "flow/JsonTraceLogFormatter.h"
+#include "flow/Trace.h"
+#include "flow/XmlTraceLogFormatter.h"
+
+// Events per second on one core for each half of tracing: building an event on the thread that traces it, and
+// formatting it on the trace writer thread. The event has the shape of a StorageMetrics event: mostly integers and
+// doubles, and a few short strings.
+
+static void addStorageMetricsDetails(TraceEventFields& fields) {
+	fields.addField("Severity", Traceable<int>::toString(10));
+	fields.addField("Time", Traceable<double>::toString(1714078437.123456));
+	fields.addField("Type", "StorageMetrics");
+	fields.addField("ID", "9e4f0bd2c6a5e7f1");
+	fields.addField("Elapsed", Traceable<double>::toString(5.00012));
+	fields.addField("QueryQueue", "12.4 8.1 61234567");
+	fields.addField("BytesInput", "1024.5 998.2 412345678901");
+	fields.addField("Version", Traceable<int64_t>::toString(412345678901234));
+	fields.addField("DurableVersion", Traceable<int64_t>::toString(412345673901234));
+	fields.addField("DesiredOldestVersion", Traceable<int64_t>::toString(412345668901234));
+	fields.addField("VersionLag", Traceable<int64_t>::toString(5000000));
+	fields.addField("LocalRate", Traceable<int>::toString(100));
+	fields.addField("BytesStored", Traceable<int64_t>::toString(987654321012));
+	fields.addField("KvstoreBytesUsed", Traceable<int64_t>::toString(1012345678901));
+	fields.addField("FetchKeysFetchActive", Traceable<int>::toString(3));
+	fields.addField("QueryQueueMax", Traceable<int>::toString(42));
+	fields.addField("ReadLatencyP99", Traceable<double>::toString(0.00412));
+	fields.addField("Machine", "10.0.4.17:4500");
+	fields.addField("LogGroup", "default");
+	fields.addField("Roles", "SS");
+}
+
+static void bench_trace_build(benchmark::State& state) {
+	for (auto _ : state) {
+		TraceEventFields fields;
+		addStorageMetricsDetails(fields);
+		benchmark::DoNotOptimize(fields);
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+// A whole TraceEvent, up to handing it to the trace log. With no trace file open, the log keeps the first events until
+// its pre-open buffer is full and drops the rest.
+static void bench_trace_event(benchmark::State& state) {
+	int64_t version = 412345678901234;
+	for (auto _ : state) {
+		TraceEvent("BenchStorageMetrics")
+		    .detail("Elapsed", 5.00012)
+		    .detail("QueryQueue", "12.4 8.1 61234567")
+		    .detail("BytesInput", "1024.5 998.2 412345678901")
+		    .detail("Version", version++)
+		    .detail("DurableVersion", version - 5000000)
+		    .detail("DesiredOldestVersion", version - 10000000)
+		    .detail("VersionLag", 5000000)
+		    .detail("LocalRate", 100)
+		    .detail("BytesStored", int64_t(987654321012))
+		    .detail("KvstoreBytesUsed", int64_t(1012345678901))
+		    .detail("FetchKeysFetchActive", 3)
+		    .detail("QueryQueueMax", 42)
+		    .detail("ReadLatencyP99", 0.00412);
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+template <class Formatter>
+static void bench_trace_format(benchmark::State& state) {
+	TraceEventFields fields;
+	addStorageMetricsDetails(fields);
+	Formatter formatter;
+	size_t bytes = 0;
+	for (auto _ : state) {
+		std::string event = formatter.formatEvent(fields);
+		bytes += event.size();
+		benchmark::DoNotOptimize(event);
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+	state.SetBytesProcessed(static_cast<long>(bytes));
+}
+
+BENCHMARK(bench_trace_build)->ReportAggregatesOnly(true);
+BENCHMARK(bench_trace_event)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_trace_format, XmlTraceLogFormatter)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_trace_format, JsonTraceLogFormatter)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_trace_format, BinaryTraceLogFormatter)->ReportAggregatesOnly(true);
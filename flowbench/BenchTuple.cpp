@@ -0,0 +1,89 @@
+/*
+ * BenchTuple.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "fdbclient/Tuple.h"
+
+// Packing and unpacking of a (string, int, string) key, with strings of state.range(0) bytes of which roughly one in
+// state.range(1) is a null that must be escaped (none if 0)
+
+static std::string makeString(int length, int nullEvery) {
+	std::string s(length, '\x00');
+	for (auto& c : s) {
+		c = nullEvery && deterministicRandom()->randomInt(0, nullEvery) == 0
+		        ? '\x00'
+		        : (char)deterministicRandom()->randomInt(1, 256);
+	}
+	return s;
+}
+
+static void bench_tuple_pack(benchmark::State& state) {
+	std::string str = makeString(state.range(0), state.range(1));
+	for (auto _ : state) {
+		Tuple t = Tuple::makeTuple(StringRef(str), 1234567, Tuple::UnicodeStr(StringRef(str)));
+		benchmark::DoNotOptimize(t.pack());
+	}
+	state.SetBytesProcessed(static_cast<long>(state.iterations()) * str.size() * 2);
+}
+
+static void bench_tuple_writer(benchmark::State& state) {
+	std::string str = makeString(state.range(0), state.range(1));
+	for (auto _ : state) {
+		Arena arena;
+		VectorRef<uint8_t> buffer;
+		TupleWriter writer(arena, buffer);
+		writer << StringRef(str) << 1234567 << Tuple::UnicodeStr(StringRef(str));
+		benchmark::DoNotOptimize(writer.packed());
+	}
+	state.SetBytesProcessed(static_cast<long>(state.iterations()) * str.size() * 2);
+}
+
+static void bench_tuple_unpack(benchmark::State& state) {
+	std::string str = makeString(state.range(0), state.range(1));
+	Standalone<StringRef> packed = Tuple::makeTuple(StringRef(str), 1234567, Tuple::UnicodeStr(StringRef(str))).pack();
+	for (auto _ : state) {
+		Tuple t = Tuple::unpack(packed);
+		benchmark::DoNotOptimize(t.getString(0));
+		benchmark::DoNotOptimize(t.getInt(1));
+		benchmark::DoNotOptimize(t.getString(2));
+	}
+	state.SetBytesProcessed(static_cast<long>(state.iterations()) * packed.size());
+}
+
+static void bench_tuple_reader(benchmark::State& state) {
+	std::string str = makeString(state.range(0), state.range(1));
+	Standalone<StringRef> packed = Tuple::makeTuple(StringRef(str), 1234567, Tuple::UnicodeStr(StringRef(str))).pack();
+	for (auto _ : state) {
+		Arena arena;
+		TupleReader reader(packed);
+		benchmark::DoNotOptimize(reader.getString(arena));
+		reader.next();
+		benchmark::DoNotOptimize(reader.getInt());
+		reader.next();
+		benchmark::DoNotOptimize(reader.getString(arena));
+	}
+	state.SetBytesProcessed(static_cast<long>(state.iterations()) * packed.size());
+}
+
+BENCHMARK(bench_tuple_pack)->ArgsProduct({ { 16, 256, 4096 }, { 0, 64 } })->ReportAggregatesOnly(true);
+BENCHMARK(bench_tuple_writer)->ArgsProduct({ { 16, 256, 4096 }, { 0, 64 } })->ReportAggregatesOnly(true);
+BENCHMARK(bench_tuple_unpack)->ArgsProduct({ { 16, 256, 4096 }, { 0, 64 } })->ReportAggregatesOnly(true);
+BENCHMARK(bench_tuple_reader)->ArgsProduct({ { 16, 256, 4096 }, { 0, 64 } })->ReportAggregatesOnly(true);
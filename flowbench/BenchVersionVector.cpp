@@ -21,11 +21,15 @@
 #include "benchmark/benchmark.h"
 #include "fdbclient/VersionVector.h"
 #include <cstdint>
+#include <set>
 
 static void bench_vv_getdelta(benchmark::State& benchState) {
 	int64_t tags = benchState.range(0);
 	Version version = 100000;
 	VersionVector vv(version);
+	if (benchState.range(2)) {
+		vv.trackChanges();
+	}
 
 	int i = 0;
 	for (int i = 0; i < tags; i++) {
@@ -45,7 +49,48 @@ static void bench_vv_getdelta(benchmark::State& benchState) {
 		}
 	}
 	benchState.SetItemsProcessed(numDeltas * static_cast<long>(benchState.iterations()));
-	benchState.counters.insert({ { "Tags", tags }, { "getDeltaTimes", numDeltas } });
+	benchState.counters.insert(
+	    { { "Tags", tags }, { "getDeltaTimes", numDeltas }, { "TrackChanges", benchState.range(2) } });
+}
+
+// A GRV proxy's cache applying the deltas of a sequencer whose commits each update a few tags, and taking the delta
+// for a client that is a few commits behind
+static void bench_vv_applydelta(benchmark::State& benchState) {
+	int64_t tags = benchState.range(0);
+	const int64_t tagsPerCommit = benchState.range(1);
+	Version version = 100000;
+	VersionVector sequencer(version), cache;
+	sequencer.trackChanges();
+	if (benchState.range(2)) {
+		cache.trackChanges();
+	}
+	for (int i = 0; i < tags; i++) {
+		sequencer.setVersion(Tag(0, i), ++version);
+	}
+
+	for (auto _ : benchState) {
+		std::set<Tag> written;
+		for (int j = 0; j < tagsPerCommit; j++) {
+			written.insert(Tag(0, deterministicRandom()->randomInt(0, tags)));
+		}
+		sequencer.setVersion(written, ++version);
+
+		VersionVector delta;
+		sequencer.getDelta(std::max(cache.getMaxVersion(), version - 10), delta);
+		cache.applyDelta(delta);
+
+		VersionVector clientDelta;
+		cache.getDelta(cache.getMaxVersion() - 5, clientDelta);
+		benchmark::DoNotOptimize(clientDelta);
+	}
+	benchState.SetItemsProcessed(static_cast<long>(benchState.iterations()));
+	benchState.counters.insert(
+	    { { "Tags", tags }, { "TagsPerCommit", tagsPerCommit }, { "TrackChanges", benchState.range(2) } });
 }
 
-BENCHMARK(bench_vv_getdelta)->Ranges({ { 1 << 4, 1 << 10 }, { 1, 1 << 10 } })->ReportAggregatesOnly(true);
+BENCHMARK(bench_vv_getdelta)
+    ->Ranges({ { 1 << 4, 1 << 10 }, { 1, 1 << 10 }, { 0, 1 } })
+    ->ReportAggregatesOnly(true);
+BENCHMARK(bench_vv_applydelta)
+    ->Ranges({ { 1 << 4, 1 << 12 }, { 1, 1 << 4 }, { 0, 1 } })
+    ->ReportAggregatesOnly(true);
@@ -0,0 +1,148 @@
+/*
+ * BenchVersionedMap.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include <unordered_set>
+
+#include "fdbclient/VersionedBatchMap.h"
+#include "fdbclient/VersionedMap.h"
+
+// Compares the storage server's VersionedMap (PTree) with VersionedBatchMap when holding a window of small values.
+
+static constexpr int kMutationsPerVersion = 100;
+
+struct PTreeVersionedData {
+	using Map = VersionedMap<KeyRef, ValueOrClearToRef>;
+	Map map;
+	Arena arena; // Like the storage server, the map references mutation bytes owned elsewhere
+
+	void createNewVersion(Version v) { map.createNewVersion(v); }
+	void insert(KeyRef key, ValueRef value) {
+		map.insert(KeyRef(arena, key), ValueOrClearToRef::value(ValueRef(arena, value)));
+	}
+	bool get(KeyRef key, Version v) const {
+		auto it = map.at(v).lastLessOrEqual(key);
+		return it && it.key() == key && it->isValue();
+	}
+
+	int64_t getBytes() const {
+		std::unordered_set<Map::PTreeT const*> nodes;
+		std::vector<Map::PTreeT const*> stack;
+		for (auto const& root : map.roots) {
+			if (root.second) {
+				stack.push_back(root.second.getPtr());
+			}
+		}
+		while (!stack.empty()) {
+			auto node = stack.back();
+			stack.pop_back();
+			if (!nodes.insert(node).second) {
+				continue;
+			}
+			for (auto const& child : node->pointer) {
+				if (child) {
+					stack.push_back(child.getPtr());
+				}
+			}
+		}
+		return nodes.size() * nextFastAllocatedSize(sizeof(Map::PTreeT)) + arena.getSize();
+	}
+};
+
+struct BatchVersionedData {
+	VersionedBatchMap map;
+
+	void createNewVersion(Version v) { map.createNewVersion(v); }
+	void insert(KeyRef key, ValueRef value) { map.insert(key, value); }
+	bool get(KeyRef key, Version v) const {
+		auto result = map.get(key, v);
+		return result.present() && result.get().present();
+	}
+	int64_t getBytes() const { return map.getBytes(); }
+};
+
+static std::vector<Key> makeKeys(int count) {
+	std::vector<Key> keys;
+	keys.reserve(count);
+	for (int i = 0; i < count; ++i) {
+		keys.push_back(Key(format("key/%012d", deterministicRandom()->randomInt(0, count * 4))));
+	}
+	return keys;
+}
+
+template <class Impl>
+static void fill(Impl& data, std::vector<Key> const& keys, ValueRef value) {
+	Version version = 0;
+	for (int i = 0; i < keys.size(); ++i) {
+		if (i % kMutationsPerVersion == 0) {
+			data.createNewVersion(++version);
+		}
+		data.insert(keys[i], value);
+	}
+}
+
+template <class Impl>
+static void bench_versioned_data_insert(benchmark::State& state) {
+	const int mutations = state.range(0);
+	std::string valueBytes(state.range(1), 'v');
+	ValueRef value(valueBytes);
+	auto keys = makeKeys(mutations);
+	int64_t bytes = 0;
+	for (auto _ : state) {
+		Impl data;
+		fill(data, keys, value);
+		state.PauseTiming();
+		bytes = data.getBytes();
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()) * mutations);
+	state.counters["BytesPerMutation"] = static_cast<double>(bytes) / mutations;
+}
+
+template <class Impl>
+static void bench_versioned_data_lookup(benchmark::State& state) {
+	const int mutations = state.range(0);
+	std::string valueBytes(state.range(1), 'v');
+	auto keys = makeKeys(mutations);
+	Impl data;
+	fill(data, keys, ValueRef(valueBytes));
+	// Reads are spread over the window, which is what a storage server serving recent read versions sees
+	const Version latest = mutations / kMutationsPerVersion;
+	int i = 0;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(data.get(keys[i], std::max<Version>(1, latest - (i % 100))));
+		i = (i + 1) % mutations;
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+BENCHMARK_TEMPLATE(bench_versioned_data_insert, PTreeVersionedData)
+    ->ArgsProduct({ { 10000, 100000 }, { 8, 32 } })
+    ->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_versioned_data_insert, BatchVersionedData)
+    ->ArgsProduct({ { 10000, 100000 }, { 8, 32 } })
+    ->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_versioned_data_lookup, PTreeVersionedData)
+    ->ArgsProduct({ { 10000, 100000 }, { 8, 32 } })
+    ->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_versioned_data_lookup, BatchVersionedData)
+    ->ArgsProduct({ { 10000, 100000 }, { 8, 32 } })
+    ->ReportAggregatesOnly(true);
@@ -0,0 +1,104 @@
+/*
+ * BenchWriteMap.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "fdbclient/WriteMap.h"
+
+// The write map of a read-your-writes transaction, at the sizes of large transactions
+
+static std::vector<Key> makeKeys(int count) {
+	std::vector<Key> keys;
+	keys.reserve(count);
+	for (int i = 0; i < count; ++i) {
+		keys.push_back(Key(format("key/%012d", deterministicRandom()->randomInt(0, count * 4))));
+	}
+	return keys;
+}
+
+static void bench_write_map_set(benchmark::State& state) {
+	const int mutations = state.range(0);
+	auto keys = makeKeys(mutations);
+	// Each write to a key already in the map replaces its entry
+	const int repeats = state.range(1);
+	for (auto _ : state) {
+		Arena arena;
+		WriteMap writes(&arena);
+		for (int r = 0; r < repeats; ++r) {
+			for (auto const& key : keys) {
+				writes.mutate(key, MutationRef::SetValue, "value"_sr, true);
+			}
+		}
+		benchmark::DoNotOptimize(writes.empty());
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()) * mutations * repeats);
+}
+
+static void bench_write_map_atomic(benchmark::State& state) {
+	const int mutations = state.range(0);
+	auto keys = makeKeys(mutations);
+	std::string operand(8, '\x01');
+	for (auto _ : state) {
+		Arena arena;
+		WriteMap writes(&arena);
+		for (auto const& key : keys) {
+			writes.mutate(key, MutationRef::AddValue, operand, true);
+		}
+		benchmark::DoNotOptimize(writes.empty());
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()) * mutations);
+}
+
+static void bench_write_map_clear(benchmark::State& state) {
+	const int mutations = state.range(0);
+	auto keys = makeKeys(mutations);
+	for (auto _ : state) {
+		Arena arena;
+		WriteMap writes(&arena);
+		for (auto const& key : keys) {
+			writes.clear(KeyRangeRef(key, keyAfter(key, arena)), true);
+		}
+		benchmark::DoNotOptimize(writes.empty());
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()) * mutations);
+}
+
+static void bench_write_map_iterate(benchmark::State& state) {
+	const int mutations = state.range(0);
+	auto keys = makeKeys(mutations);
+	Arena arena;
+	WriteMap writes(&arena);
+	for (auto const& key : keys) {
+		writes.mutate(key, MutationRef::SetValue, "value"_sr, true);
+	}
+	int64_t segments = 0;
+	for (auto _ : state) {
+		WriteMap::iterator it(&writes);
+		for (it.skip(allKeys.begin); it.beginKey() < allKeys.end; ++it) {
+			++segments;
+		}
+	}
+	state.SetItemsProcessed(segments);
+}
+
+BENCHMARK(bench_write_map_set)->ArgsProduct({ { 1000, 10000, 100000 }, { 1, 2 } })->ReportAggregatesOnly(true);
+BENCHMARK(bench_write_map_atomic)->Arg(1000)->Arg(10000)->Arg(100000)->ReportAggregatesOnly(true);
+BENCHMARK(bench_write_map_clear)->Arg(1000)->Arg(10000)->Arg(100000)->ReportAggregatesOnly(true);
+BENCHMARK(bench_write_map_iterate)->Arg(1000)->Arg(10000)->Arg(100000)->ReportAggregatesOnly(true);
@@ -19,6 +19,7 @@
  */
 
 #include "benchmark/benchmark.h"
+#include "flow/CompressionUtils.h"
 #include "flow/IRandom.h"
 #include "flow/DeterministicRandom.h"
 
@@ -216,6 +217,80 @@ static void bench_zstd_decompress_stream(benchmark::State& state) {
 	state.SetBytesProcessed(UNCOMPRESSED.size() * static_cast<long>(state.iterations()));
 }
 
+// Small records that share most of their structure, like JSON values under one key prefix, compressed one at a time
+static std::vector<Standalone<StringRef>> genRecords(int count) {
+	DeterministicRandom random(0x7654321, true);
+	std::vector<Standalone<StringRef>> records;
+	for (int i = 0; i < count; ++i) {
+		records.push_back(Standalone<StringRef>(
+		    format("{\"id\":%d,\"name\":\"user_%s\",\"status\":\"%s\",\"score\":%d,\"tags\":[\"%s\"]}",
+		           random.randomInt(0, 1000000),
+		           random.randomAlphaNumeric(8).c_str(),
+		           random.coinflip() ? "active" : "suspended",
+		           random.randomInt(0, 100),
+		           random.coinflip() ? "standard" : "premium")));
+	}
+	return records;
+}
+
+static Reference<CompressionDictionary> trainDictionary(int level) {
+	std::vector<Standalone<StringRef>> samples = genRecords(10000);
+	std::vector<StringRef> sampleRefs(samples.begin(), samples.end());
+	return CompressionDictionary::train(sampleRefs, 16 << 10, level);
+}
+
+static StringRef compressRecord(Reference<CompressionDictionary> const& dictionary,
+                                StringRef record,
+                                int level,
+                                Arena& arena) {
+	return dictionary ? CompressionUtils::compress(*dictionary, record, arena)
+	                  : CompressionUtils::compress(CompressionFilter::ZSTD, record, level, arena);
+}
+
+// state.range(0) is the compression level, and state.range(1) whether to use a dictionary
+static void bench_zstd_compress_records(benchmark::State& state) {
+	const int level = state.range(0);
+	Reference<CompressionDictionary> dictionary;
+	if (state.range(1)) {
+		dictionary = trainDictionary(level);
+	}
+	std::vector<Standalone<StringRef>> records = genRecords(1000);
+	size_t uncompressedSize = 0, compressedSize = 0;
+	for (auto _ : state) {
+		for (const auto& record : records) {
+			Arena arena;
+			StringRef compressed = compressRecord(dictionary, record, level, arena);
+			uncompressedSize += record.size();
+			compressedSize += compressed.size();
+		}
+	}
+	state.SetItemsProcessed(records.size() * static_cast<long>(state.iterations()));
+	state.SetBytesProcessed(uncompressedSize);
+	state.counters["compression_ratio"] = compressedSize * 1.0 / uncompressedSize;
+}
+
+static void bench_zstd_decompress_records(benchmark::State& state) {
+	const int level = state.range(0);
+	Reference<CompressionDictionary> dictionary;
+	if (state.range(1)) {
+		dictionary = trainDictionary(level);
+	}
+	Arena arena;
+	std::vector<StringRef> compressed;
+	for (const auto& record : genRecords(1000)) {
+		compressed.push_back(compressRecord(dictionary, record, level, arena));
+	}
+	for (auto _ : state) {
+		for (const auto& record : compressed) {
+			Arena decompressed;
+			benchmark::DoNotOptimize(dictionary
+			                             ? CompressionUtils::decompress(*dictionary, record, decompressed)
+			                             : CompressionUtils::decompress(CompressionFilter::ZSTD, record, decompressed));
+		}
+	}
+	state.SetItemsProcessed(compressed.size() * static_cast<long>(state.iterations()));
+}
+
 // chunk size from 4K to 1MB, compression level from 1, 3, 9
 BENCHMARK(bench_zstd_compress)
     ->Args({ 1 << 12, 1 })
@@ -249,4 +324,8 @@ BENCHMARK(bench_zstd_compress_stream)
 
 BENCHMARK(bench_zstd_decompress)->Arg(1)->Arg(3)->Arg(9);
 BENCHMARK(bench_zstd_decompress_stream)->Arg(1)->Arg(3)->Arg(9);
+
+// compression level 1 and 3, without and with a dictionary
+BENCHMARK(bench_zstd_compress_records)->ArgsProduct({ { 1, 3 }, { 0, 1 } });
+BENCHMARK(bench_zstd_decompress_records)->ArgsProduct({ { 1, 3 }, { 0, 1 } });
 #endif
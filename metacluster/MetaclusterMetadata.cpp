@@ -117,6 +117,12 @@ KeyBackedSet<Tuple>& clusterCapacityIndex() {
 	return instance;
 }
 
+KeyBackedObjectMap<ClusterName, DataClusterLoad, decltype(IncludeVersion())>& clusterLoad() {
+	static KeyBackedObjectMap<ClusterName, DataClusterLoad, decltype(IncludeVersion())> instance(
+	    "metacluster/dataCluster/load/"_sr, IncludeVersion());
+	return instance;
+}
+
 KeyBackedMap<ClusterName, int64_t, TupleCodec<ClusterName>, BinaryCodec<int64_t>>& clusterTenantCount() {
 	static KeyBackedMap<ClusterName, int64_t, TupleCodec<ClusterName>, BinaryCodec<int64_t>> instance(
 	    "metacluster/clusterTenantCount/"_sr);
@@ -20,9 +20,11 @@
 
 #include "fdbclient/DatabaseContext.h"
 #include "fdbclient/ReadYourWrites.h"
+#include "fdbclient/Status.h"
 
 #include "metacluster/Metacluster.h"
 #include "metacluster/MetaclusterMetrics.h"
+#include "metacluster/MetaclusterUtil.actor.h"
 
 #include "flow/actorcompiler.h" // has to be last include
 
@@ -70,9 +72,110 @@ ACTOR Future<MetaclusterMetrics> getMetaclusterMetricsImpl(Database db) {
 		}
 	}
 }
+
+ACTOR Future<DataClusterLoad> getDataClusterLoad(ClusterConnectionString connectionString) {
+	state Reference<IDatabase> db = wait(util::openDatabase(connectionString));
+	state Reference<ITransaction> tr = db->createTransaction();
+	loop {
+		try {
+			state ThreadFuture<Optional<Value>> statusFuture = tr->get("\xff\xff/status/json"_sr);
+			Optional<Value> statusValue = wait(safeThreadFutureToFuture(statusFuture));
+			if (!statusValue.present()) {
+				throw operation_failed();
+			}
+
+			StatusObjectReader status(readJSONStrictly(statusValue.get().toString()).get_obj());
+			DataClusterLoad load;
+			double readsPerSecond = 0;
+			double writesPerSecond = 0;
+			status.get("cluster.workload.operations.reads.hz", readsPerSecond);
+			status.get("cluster.workload.operations.writes.hz", writesPerSecond);
+			status.get("cluster.data.total_kv_size_bytes", load.storedBytes);
+			status.get("cluster.latency_probe.commit_seconds", load.commitLatency);
+			load.operationsPerSecond = readsPerSecond + writesPerSecond;
+			load.updatedAt = now();
+			return load;
+		} catch (Error& e) {
+			wait(safeThreadFutureToFuture(tr->onError(e)));
+		}
+	}
+}
+
+ACTOR Future<Optional<DataClusterLoad>> tryGetDataClusterLoad(ClusterName clusterName,
+                                                              ClusterConnectionString connectionString) {
+	try {
+		Optional<DataClusterLoad> load =
+		    wait(timeout(getDataClusterLoad(connectionString), CLIENT_KNOBS->METACLUSTER_LOAD_STATUS_TIMEOUT));
+		if (!load.present()) {
+			TraceEvent(SevWarn, "MetaclusterDataClusterLoadTimedOut").detail("ClusterName", clusterName);
+		}
+		return load;
+	} catch (Error& e) {
+		if (e.code() == error_code_actor_cancelled) {
+			throw;
+		}
+		TraceEvent(SevWarn, "MetaclusterDataClusterLoadError").error(e).detail("ClusterName", clusterName);
+		return Optional<DataClusterLoad>();
+	}
+}
+
+ACTOR Future<Void> updateDataClusterLoadsImpl(Database db) {
+	state Reference<ReadYourWritesTransaction> tr = db->createTransaction();
+	state std::map<ClusterName, DataClusterMetadata> clusters;
+	loop {
+		try {
+			tr->setOption(FDBTransactionOptions::READ_SYSTEM_KEYS);
+			wait(store(clusters,
+			           metacluster::listClustersTransaction(tr, ""_sr, "\xff"_sr, CLIENT_KNOBS->MAX_DATA_CLUSTERS)));
+			break;
+		} catch (Error& e) {
+			wait(tr->onError(e));
+		}
+	}
+
+	state std::vector<ClusterName> clusterNames;
+	state std::vector<Future<Optional<DataClusterLoad>>> loadFutures;
+	for (auto const& [clusterName, metadata] : clusters) {
+		clusterNames.push_back(clusterName);
+		loadFutures.push_back(tryGetDataClusterLoad(clusterName, metadata.connectionString));
+	}
+	state std::vector<Optional<DataClusterLoad>> loads = wait(getAll(loadFutures));
+
+	tr->reset();
+	loop {
+		try {
+			tr->setOption(FDBTransactionOptions::ACCESS_SYSTEM_KEYS);
+			tr->setOption(FDBTransactionOptions::RAW_ACCESS);
+			// Don't store loads for clusters that were removed while their status was read
+			std::vector<Future<Optional<DataClusterEntry>>> entries;
+			for (auto const& clusterName : clusterNames) {
+				entries.push_back(metadata::management::dataClusters().get(tr, clusterName));
+			}
+			state std::vector<Optional<DataClusterEntry>> currentEntries = wait(getAll(entries));
+			for (int i = 0; i < clusterNames.size(); ++i) {
+				if (loads[i].present() && currentEntries[i].present()) {
+					metadata::management::clusterLoad().set(tr, clusterNames[i], loads[i].get());
+					TraceEvent("MetaclusterDataClusterLoad")
+					    .detail("ClusterName", clusterNames[i])
+					    .detail("OperationsPerSecond", loads[i].get().operationsPerSecond)
+					    .detail("StoredBytes", loads[i].get().storedBytes)
+					    .detail("CommitLatency", loads[i].get().commitLatency);
+				}
+			}
+			wait(tr->commit());
+			return Void();
+		} catch (Error& e) {
+			wait(tr->onError(e));
+		}
+	}
+}
 } // namespace internal
 
 Future<MetaclusterMetrics> MetaclusterMetrics::getMetaclusterMetrics(Database db) {
 	return internal::getMetaclusterMetricsImpl(db);
 }
+
+Future<Void> updateDataClusterLoads(Database db) {
+	return internal::updateDataClusterLoadsImpl(db);
+}
 } // namespace metacluster
@@ -44,6 +44,38 @@ std::pair<ClusterUsage, ClusterUsage> metaclusterCapacity(std::map<ClusterName,
 	return { tenantGroupCapacity, tenantGroupsAllocated };
 }
 
+std::vector<ClusterName> orderClustersByLoad(std::vector<ClusterName> const& clusters,
+                                             std::map<ClusterName, DataClusterLoad> const& loads) {
+	DataClusterLoad maxLoad;
+	for (auto const& cluster : clusters) {
+		auto itr = loads.find(cluster);
+		if (itr == loads.end() || itr->second.isStale()) {
+			return clusters;
+		}
+		maxLoad.operationsPerSecond = std::max(maxLoad.operationsPerSecond, itr->second.operationsPerSecond);
+		maxLoad.storedBytes = std::max(maxLoad.storedBytes, itr->second.storedBytes);
+		maxLoad.commitLatency = std::max(maxLoad.commitLatency, itr->second.commitLatency);
+	}
+
+	auto relative = [](double value, double max) { return max > 0 ? value / max : 0.0; };
+	std::vector<std::pair<double, ClusterName>> scores;
+	for (auto const& cluster : clusters) {
+		DataClusterLoad const& load = loads.at(cluster);
+		scores.emplace_back(relative(load.operationsPerSecond, maxLoad.operationsPerSecond) +
+		                        relative(load.storedBytes, maxLoad.storedBytes) +
+		                        relative(load.commitLatency, maxLoad.commitLatency),
+		                    cluster);
+	}
+	// Clusters with the same load keep their order
+	std::stable_sort(scores.begin(), scores.end(), [](auto const& a, auto const& b) { return a.first < b.first; });
+
+	std::vector<ClusterName> ordered;
+	for (auto const& [score, cluster] : scores) {
+		ordered.push_back(cluster);
+	}
+	return ordered;
+}
+
 ACTOR Future<Reference<IDatabase>> openDatabase(ClusterConnectionString connectionString) {
 	if (g_network->isSimulated()) {
 		Reference<IClusterConnectionRecord> clusterFile =
@@ -190,6 +190,25 @@ struct CreateTenantImpl {
 			for (auto const& clusterTuple : availableClusters.results) {
 				dataClusterNames.push_back(clusterTuple.getString(1));
 			}
+
+			// Of the clusters with capacity, prefer the least loaded
+			if (CLIENT_KNOBS->METACLUSTER_LOAD_AWARE_ASSIGNMENT && dataClusterNames.size() > 1) {
+				state std::vector<Future<Optional<DataClusterLoad>>> loadFutures;
+				for (auto const& dataClusterName : dataClusterNames) {
+					loadFutures.push_back(metadata::management::clusterLoad().get(tr, dataClusterName));
+				}
+				wait(waitForAll(loadFutures));
+
+				std::map<ClusterName, DataClusterLoad> loads;
+				for (int i = 0; i < dataClusterNames.size(); ++i) {
+					if (loadFutures[i].get().present()) {
+						loads[dataClusterNames[i]] = loadFutures[i].get().get();
+					}
+				}
+				std::vector<ClusterName> orderedNames = util::orderClustersByLoad(dataClusterNames, loads);
+				CODE_PROBE(orderedNames != dataClusterNames, "Tenant assignment reordered clusters by load");
+				dataClusterNames = orderedNames;
+			}
 		}
 		for (auto const& dataClusterName : dataClusterNames) {
 			dataClusterDbs.push_back(util::getAndOpenDatabase(tr, dataClusterName));
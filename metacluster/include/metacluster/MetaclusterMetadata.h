@@ -111,6 +111,9 @@ dataClusterConnectionRecords();
 // A set of non-full clusters where the key is the tuple (num tenant groups allocated, cluster name).
 KeyBackedSet<Tuple>& clusterCapacityIndex();
 
+// A map from cluster name to the load last reported by the cluster
+KeyBackedObjectMap<ClusterName, DataClusterLoad, decltype(IncludeVersion())>& clusterLoad();
+
 // A map from cluster name to a count of tenants
 KeyBackedMap<ClusterName, int64_t, TupleCodec<ClusterName>, BinaryCodec<int64_t>>& clusterTenantCount();
 
@@ -38,6 +38,10 @@ struct MetaclusterMetrics {
 
 	static Future<MetaclusterMetrics> getMetaclusterMetrics(Database db);
 };
+
+// Reads the load of each data cluster from its status and stores it in the management cluster, where it is used to
+// place new tenants. Clusters whose status can't be read keep their last load until it becomes stale.
+Future<Void> updateDataClusterLoads(Database db);
 } // namespace metacluster
 
 #endif
\ No newline at end of file
@@ -26,6 +26,7 @@
 #include "fdbclient/FDBTypes.h"
 #include "fdbclient/json_spirit/json_spirit_value.h"
 #include "fdbclient/KeyBackedTypes.actor.h"
+#include "fdbclient/Knobs.h"
 #include "fdbclient/MetaclusterRegistration.h"
 #include "flow/flat_buffers.h"
 
@@ -132,6 +133,26 @@ struct DataClusterEntry {
 	}
 };
 
+// The load on a data cluster as last reported by its status, which is used to prefer less loaded clusters when
+// assigning tenants automatically
+struct DataClusterLoad {
+	constexpr static FileIdentifier file_identifier = 3904417;
+
+	double operationsPerSecond = 0; // reads and writes
+	int64_t storedBytes = 0;
+	double commitLatency = 0;
+	double updatedAt = 0; // the time the load was read from the data cluster's status
+
+	DataClusterLoad() = default;
+
+	bool isStale() const { return now() - updatedAt > CLIENT_KNOBS->METACLUSTER_LOAD_MAX_AGE; }
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, operationsPerSecond, storedBytes, commitLatency, updatedAt);
+	}
+};
+
 struct DataClusterMetadata {
 	constexpr static FileIdentifier file_identifier = 5573993;
 
@@ -45,6 +45,11 @@ FDB_BOOLEAN_PARAM(SkipMetaclusterCreation);
 // Helper function to compute metacluster capacity by passing the result of metacluster::listClusters
 std::pair<ClusterUsage, ClusterUsage> metaclusterCapacity(std::map<ClusterName, DataClusterMetadata> const& clusters);
 
+// Orders clusters from the least to the most loaded, weighing throughput, stored bytes and commit latency equally
+// relative to the most loaded of the clusters. Clusters are left in their order if any of them has no recent load.
+std::vector<ClusterName> orderClustersByLoad(std::vector<ClusterName> const& clusters,
+                                             std::map<ClusterName, DataClusterLoad> const& loads);
+
 ACTOR Future<Reference<IDatabase>> openDatabase(ClusterConnectionString connectionString);
 
 ACTOR template <class Transaction>
@@ -242,6 +242,7 @@ struct RemoveClusterImpl {
 		metadata::management::dataClusters().erase(tr, ctx.clusterName.get());
 		metadata::management::dataClusterConnectionRecords().erase(tr, ctx.clusterName.get());
 		metadata::management::clusterTenantCount().erase(tr, ctx.clusterName.get());
+		metadata::management::clusterLoad().erase(tr, ctx.clusterName.get());
 	}
 
 	// Removes the next set of metadata from the management cluster; returns true when all specified
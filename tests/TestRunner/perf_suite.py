@@ -0,0 +1,312 @@
+#!/usr/bin/env python3
+#
+# perf_suite.py
+#
+# This source file is part of the FoundationDB open source project
+#
+# Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+"""Runs the performance suite in tests/performance against local clusters and compares the results to a baseline.
+
+Each test file is run --repetitions times, each time on a new cluster of --process-number processes with
+--num-testers tester processes, so that the repetitions are independent samples. The metrics that the multitest
+reports for each test of a file are collected from its trace, along with the wall time of the test, into a JSON
+results file of the form {"<file>/<test title>": {"<metric>": [<value of each repetition>, ...]}}.
+
+    perf_suite.py run -b <build dir> -o results.json
+    perf_suite.py compare baseline.json results.json
+
+A baseline is the results file of a run of a known good build on the same machine; results from different machines
+are not comparable. compare flags a metric as regressed when it got worse by more than --min-change and the
+difference of the means is significant by Welch's t-test (|t| > --t-threshold), and exits with status 1 if any did.
+"""
+
+import argparse
+import glob
+import json
+import math
+import os
+import shutil
+import subprocess
+import sys
+import time
+from pathlib import Path
+
+PERF_TEST_DIR = Path(__file__).resolve().parent.parent.joinpath("performance")
+
+# Metrics where a larger value is better. All other metrics, such as latencies and wall times, are better smaller.
+HIGHER_IS_BETTER_SUFFIXES = ["/sec"]
+LOWER_IS_BETTER_METRICS = {"Conflicts/sec", "Retries/sec"}
+# Metrics that describe the run rather than measure it
+IGNORED_METRICS = {"Reporting Clients"}
+
+
+def higher_is_better(metric):
+    if metric in LOWER_IS_BETTER_METRICS:
+        return False
+    return any(metric.endswith(suffix) for suffix in HIGHER_IS_BETTER_SUFFIXES)
+
+
+def parse_trace_metrics(log_dir):
+    """Returns {test title: {metric: value}} from the JSON trace files of a multitest."""
+    events = []
+    for trace_file in glob.glob(os.path.join(log_dir, "trace.*.json")):
+        with open(trace_file) as f:
+            for line in f:
+                try:
+                    events.append(json.loads(line))
+                except json.JSONDecodeError:
+                    # the last line of a trace file of a process that was killed may be incomplete
+                    pass
+    events.sort(key=lambda e: float(e.get("Time", 0)))
+
+    results = {}
+    title = None
+    started = {}
+    for event in events:
+        event_type = event.get("Type")
+        if event_type == "TestRunning":
+            title = event["WorkloadTitle"]
+            started[title] = float(event["Time"])
+            results.setdefault(title, {})
+        elif event_type == "Metric" and title is not None:
+            if event["Name"] not in IGNORED_METRICS:
+                results[title][event["Name"]] = float(event["Value"])
+        elif event_type == "TestResults" and event.get("Workload") in started:
+            test = event["Workload"]
+            if event.get("Passed") != "1":
+                raise Exception("Test {} failed, see the traces in {}".format(test, log_dir))
+            results[test]["Wall Time (s)"] = float(event["Time"]) - started[test]
+    return results
+
+
+def run_test_file(args, test_file, repetition):
+    """Runs a test file on a new cluster and returns the metrics of each of its tests."""
+    # imported here so that comparing results does not need the dependencies of the cluster
+    from tmp_cluster import TempCluster
+
+    with TempCluster(args.build_dir, args.process_number, enable_tenants=True) as cluster:
+        fdbserver = cluster.fdbserver_binary
+        testers = []
+        log_dir = cluster.tmp_dir.joinpath("multitest")
+        log_dir.mkdir()
+        try:
+            for i in range(args.num_testers):
+                tester_dir = cluster.tmp_dir.joinpath("tester{}".format(i))
+                tester_dir.mkdir()
+                testers.append(
+                    subprocess.Popen(
+                        [
+                            str(fdbserver),
+                            "-C",
+                            str(cluster.cluster_file),
+                            "-p",
+                            "127.0.0.1:{}".format(cluster.port_provider.get_free_port()),
+                            "-c",
+                            "test",
+                            "-d",
+                            str(tester_dir),
+                            "-L",
+                            str(tester_dir),
+                        ],
+                        stdout=subprocess.DEVNULL,
+                        stderr=subprocess.DEVNULL,
+                    )
+                )
+            print(
+                "Running {} ({}/{})".format(test_file.name, repetition + 1, args.repetitions),
+                file=sys.stderr,
+            )
+            start = time.time()
+            subprocess.run(
+                [
+                    str(fdbserver),
+                    "-r",
+                    "multitest",
+                    "-f",
+                    str(test_file),
+                    "-C",
+                    str(cluster.cluster_file),
+                    "--num-testers",
+                    str(args.num_testers),
+                    "--trace-format",
+                    "json",
+                    "-L",
+                    str(log_dir),
+                ],
+                check=True,
+                stdout=subprocess.DEVNULL,
+                timeout=args.timeout,
+            )
+            print("  took {:.1f}s".format(time.time() - start), file=sys.stderr)
+            return parse_trace_metrics(log_dir)
+        finally:
+            for tester in testers:
+                tester.terminate()
+            for tester in testers:
+                tester.wait()
+            if args.keep_logs:
+                shutil.copytree(
+                    cluster.tmp_dir,
+                    Path(args.keep_logs).joinpath(
+                        "{}.{}".format(test_file.stem, repetition)
+                    ),
+                )
+
+
+def run(args):
+    test_files = [Path(f) for f in args.tests] if args.tests else sorted(PERF_TEST_DIR.glob("*.toml"))
+    results = {}
+    for test_file in test_files:
+        for repetition in range(args.repetitions):
+            for title, metrics in run_test_file(args, test_file, repetition).items():
+                test = results.setdefault("{}/{}".format(test_file.stem, title), {})
+                for metric, value in metrics.items():
+                    test.setdefault(metric, []).append(value)
+    with open(args.output, "w") as f:
+        json.dump(results, f, indent=2, sort_keys=True)
+    print("Results written to {}".format(args.output), file=sys.stderr)
+
+
+def mean_and_variance(values):
+    mean = sum(values) / len(values)
+    if len(values) < 2:
+        return mean, 0.0
+    return mean, sum((v - mean) ** 2 for v in values) / (len(values) - 1)
+
+
+def welch_t(baseline, current):
+    """Welch's t statistic of the difference of the means, or None if there are too few samples to judge."""
+    if len(baseline) < 2 or len(current) < 2:
+        return None
+    baseline_mean, baseline_var = mean_and_variance(baseline)
+    current_mean, current_var = mean_and_variance(current)
+    stderr = math.sqrt(baseline_var / len(baseline) + current_var / len(current))
+    if stderr == 0:
+        return math.inf if current_mean != baseline_mean else 0.0
+    return (current_mean - baseline_mean) / stderr
+
+
+def compare(args):
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    with open(args.results) as f:
+        results = json.load(f)
+
+    regressions = 0
+    rows = []
+    for test in sorted(results):
+        if test not in baseline:
+            print("{}: no baseline".format(test))
+            continue
+        for metric in sorted(results[test]):
+            if metric not in baseline[test]:
+                continue
+            base_values, values = baseline[test][metric], results[test][metric]
+            base_mean, _ = mean_and_variance(base_values)
+            mean, _ = mean_and_variance(values)
+            change = (mean - base_mean) / abs(base_mean) if base_mean != 0 else 0.0
+            worse = -change if higher_is_better(metric) else change
+            t = welch_t(base_values, values)
+            significant = t is None or abs(t) > args.t_threshold
+            if worse > args.min_change and significant:
+                verdict = "REGRESSED"
+                regressions += 1
+            elif -worse > args.min_change and significant:
+                verdict = "improved"
+            else:
+                verdict = ""
+            rows.append(
+                (
+                    test,
+                    metric,
+                    "{:.4g}".format(base_mean),
+                    "{:.4g}".format(mean),
+                    "{:+.1%}".format(change),
+                    "-" if t is None else "{:.2f}".format(t),
+                    verdict,
+                )
+            )
+
+    header = ("Test", "Metric", "Baseline", "Current", "Change", "t", "")
+    widths = [max(len(row[i]) for row in rows + [header]) for i in range(len(header))]
+    for row in [header] + rows:
+        print("  ".join(value.ljust(width) for value, width in zip(row, widths)).rstrip())
+    if regressions:
+        print("{} metrics regressed".format(regressions))
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter
+    )
+    subparsers = parser.add_subparsers(dest="command", required=True)
+
+    run_parser = subparsers.add_parser("run", help="Run the suite and write the results")
+    run_parser.add_argument(
+        "-b", "--build-dir", required=True, help="FDB build directory"
+    )
+    run_parser.add_argument(
+        "-o", "--output", required=True, help="File to write the results to"
+    )
+    run_parser.add_argument(
+        "--tests",
+        nargs="+",
+        help="Test files to run, by default all the files in tests/performance",
+    )
+    run_parser.add_argument(
+        "--repetitions",
+        type=int,
+        default=5,
+        help="Number of times to run each test file, each on a new cluster",
+    )
+    run_parser.add_argument(
+        "--process-number", type=int, default=4, help="Number of fdbserver processes"
+    )
+    run_parser.add_argument(
+        "--num-testers", type=int, default=2, help="Number of tester processes"
+    )
+    run_parser.add_argument(
+        "--timeout", type=int, default=3600, help="Timeout of a test file in seconds"
+    )
+    run_parser.add_argument(
+        "--keep-logs", help="Directory to copy the logs of each run to"
+    )
+
+    compare_parser = subparsers.add_parser(
+        "compare", help="Compare results to a baseline"
+    )
+    compare_parser.add_argument("baseline", help="Results of the baseline build")
+    compare_parser.add_argument("results", help="Results to compare")
+    compare_parser.add_argument(
+        "--min-change",
+        type=float,
+        default=0.05,
+        help="Smallest relative change of a mean that counts as a regression",
+    )
+    compare_parser.add_argument(
+        "--t-threshold",
+        type=float,
+        default=3.0,
+        help="Smallest Welch's t statistic that counts as significant",
+    )
+
+    args = parser.parse_args()
+    if args.command == "run":
+        run(args)
+    else:
+        compare(args)